@@ -381,15 +381,36 @@ void AdbConnectionState::SendDdmPacket(uint32_t id,
     { const_cast<uint8_t*>(data.data()), data.size() },
   };
   // now pkt_header has the header.
-  // use writev to send the actual data.
-  ssize_t res = TEMP_FAILURE_RETRY(writev(adb_connection_socket_, iovs, kIovSize));
-  if (static_cast<size_t>(res) != (kDdmPacketHeaderSize + data.size())) {
-    PLOG(ERROR) << StringPrintf("Failed to send DDMS packet %c%c%c%c to debugger (%zd of %zu)",
+  // use writev to send the actual data. Large chunks such as HPDS heap dumps may not fit in the
+  // socket buffer, so keep writing from where a partial write stopped.
+  size_t total = 0;
+  size_t first_iov = 0;
+  ssize_t res;
+  while (true) {
+    res = TEMP_FAILURE_RETRY(
+        writev(adb_connection_socket_, iovs + first_iov, kIovSize - first_iov));
+    if (res <= 0) {
+      break;
+    }
+    total += res;
+    size_t written = static_cast<size_t>(res);
+    while (first_iov != kIovSize && written >= iovs[first_iov].iov_len) {
+      written -= iovs[first_iov].iov_len;
+      ++first_iov;
+    }
+    if (first_iov == kIovSize) {
+      break;
+    }
+    iovs[first_iov].iov_base = reinterpret_cast<uint8_t*>(iovs[first_iov].iov_base) + written;
+    iovs[first_iov].iov_len -= written;
+  }
+  if (total != (kDdmPacketHeaderSize + data.size())) {
+    PLOG(ERROR) << StringPrintf("Failed to send DDMS packet %c%c%c%c to debugger (%zu of %zu)",
                                 static_cast<char>(type >> 24),
                                 static_cast<char>(type >> 16),
                                 static_cast<char>(type >> 8),
                                 static_cast<char>(type),
-                                res, data.size() + kDdmPacketHeaderSize);
+                                total, data.size() + kDdmPacketHeaderSize);
   } else {
     VLOG(jdwp) << StringPrintf("sent DDMS packet %c%c%c%c to debugger %zu",
                                static_cast<char>(type >> 24),
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+
+#include "jni.h"
+
+#include "art_method-inl.h"
+#include "base/time_utils.h"
+#include "entrypoints/runtime_asm_entrypoints.h"
+#include "jni_internal.h"
+#include "scoped_thread_state_change-inl.h"
+#ifdef CAPSTONE
+#include "binary_analyzer/binary_analyzer.h"
+#endif
+
+namespace art {
+
+namespace {
+
+// The corpus. Each function is declared twice in AutoFastJniBenchmark, with the same body, so
+// that one copy keeps the normal JNI transition while the other one is promoted.
+#define DEFINE_CORPUS_FUNCTION(name, body) \
+  extern "C" JNIEXPORT jint JNICALL Java_AutoFastJniBenchmark_ ## name( \
+      JNIEnv*, jclass, jint a) body \
+  extern "C" JNIEXPORT jint JNICALL Java_AutoFastJniBenchmark_ ## name ## Promoted( \
+      JNIEnv*, jclass, jint a) body
+
+// Leaf without control flow.
+DEFINE_CORPUS_FUNCTION(leaf, { return a * 3 + 1; })
+
+__attribute__((noinline)) static jint Callee(jint a) {
+  return a ^ 0x5a5a;
+}
+
+// Direct calls to a leaf callee.
+DEFINE_CORPUS_FUNCTION(callsLeaf, { return Callee(a) + Callee(a + 1); })
+
+__attribute__((noinline)) static jint Recurse(jint a) {
+  return (a <= 0) ? 0 : Recurse(a - 1) + 1;
+}
+
+// A callee with a cycle in the call graph.
+DEFINE_CORPUS_FUNCTION(recursive, { return Recurse(a & 0xf); })
+
+static std::atomic<jint> gCounter(0);
+
+// A lock user.
+DEFINE_CORPUS_FUNCTION(usesLock, { return gCounter.fetch_add(a, std::memory_order_seq_cst); })
+
+#undef DEFINE_CORPUS_FUNCTION
+
+ArtMethod* GetLinkedNativeMethod(const ScopedObjectAccess& soa, jobject method)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ArtMethod* m = jni::DecodeArtMethod(soa.Env()->FromReflectedMethod(method));
+  CHECK(m->IsNative()) << m->PrettyMethod();
+  // The benchmark calls every native once before analyzing it, so that it is linked.
+  CHECK(m->GetEntryPointFromJni() != GetJniDlsymLookupStub()) << m->PrettyMethod();
+  return m;
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_AutoFastJniBenchmark_analyze(JNIEnv* env,
+                                                                     jclass,
+                                                                     jobject method) {
+#ifdef CAPSTONE
+  ScopedObjectAccess soa(env);
+  ArtMethod* m = GetLinkedNativeMethod(soa, method);
+  uint64_t start = NanoTime();
+  // Bypass the verdict cache, to measure the analysis itself.
+  if (Runtime::Current()->GetInstructionSet() == InstructionSet::kArm64) {
+    arm64::AnalyzeMethod(m->GetDexMethodIndex(), *m->GetDexFile(), m->GetEntryPointFromJni());
+  } else {
+    x86::AnalyzeMethod(m->GetDexMethodIndex(), *m->GetDexFile(), m->GetEntryPointFromJni());
+  }
+  return static_cast<jlong>(NanoTime() - start);
+#else
+  UNUSED(env, method);
+  return -1;
+#endif
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_AutoFastJniBenchmark_promote(JNIEnv* env,
+                                                                        jclass,
+                                                                        jobject method) {
+#ifdef CAPSTONE
+  ScopedObjectAccess soa(env);
+  ArtMethod* m = GetLinkedNativeMethod(soa, method);
+  if (m->IsFastNative()) {
+    return JNI_TRUE;
+  }
+  // Same as the background detection task, see ArtMethod::RegisterNative. The corpus only takes
+  // and returns primitives, so it may also be called as @CriticalNative.
+  FastJniCache::Verdict verdict =
+      AnalyzeFastJNI(m->GetDexMethodIndex(), *m->GetDexFile(), m->GetEntryPointFromJni());
+  if (verdict == FastJniCache::Verdict::kNotFast) {
+    return JNI_FALSE;
+  }
+  m->SetAutoFastNative(verdict == FastJniCache::Verdict::kFastNoJniEnv);
+  return JNI_TRUE;
+#else
+  UNUSED(env, method);
+  return JNI_FALSE;
+#endif
+}
+
+}  // namespace
+
+}  // namespace art
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+
+public class AutoFastJniBenchmark {
+  // The corpus of native functions. The *Promoted copies are promoted to @FastNative when the
+  // autofast JNI analysis finds them fast, the others keep the normal JNI transition.
+  static native int leaf(int a);
+  static native int leafPromoted(int a);
+  static native int callsLeaf(int a);
+  static native int callsLeafPromoted(int a);
+  static native int recursive(int a);
+  static native int recursivePromoted(int a);
+  static native int usesLock(int a);
+  static native int usesLockPromoted(int a);
+
+  // Returns the time in nanoseconds of the binary analysis of the native code of `method`, or
+  // -1 if the runtime is built without autofast JNI.
+  static native long analyze(Method method);
+  // Promotes `method` if the analysis finds it fast. Returns whether it was promoted.
+  static native boolean promote(Method method);
+
+  private static final String[] CORPUS = { "leaf", "callsLeaf", "recursive", "usesLock" };
+
+  private static Method leafMethod;
+  private static Method callsLeafMethod;
+  private static Method recursiveMethod;
+  private static Method usesLockMethod;
+
+  public void timeAnalyzeLeaf(int N) {
+    for (int i = 0; i < N; i++) {
+      analyze(leafMethod);
+    }
+  }
+
+  public void timeAnalyzeCallsLeaf(int N) {
+    for (int i = 0; i < N; i++) {
+      analyze(callsLeafMethod);
+    }
+  }
+
+  public void timeAnalyzeRecursive(int N) {
+    for (int i = 0; i < N; i++) {
+      analyze(recursiveMethod);
+    }
+  }
+
+  public void timeAnalyzeUsesLock(int N) {
+    for (int i = 0; i < N; i++) {
+      analyze(usesLockMethod);
+    }
+  }
+
+  public void timeLeaf(int N) {
+    for (int i = 0; i < N; i++) {
+      leaf(i);
+    }
+  }
+
+  public void timeLeafPromoted(int N) {
+    for (int i = 0; i < N; i++) {
+      leafPromoted(i);
+    }
+  }
+
+  public void timeCallsLeaf(int N) {
+    for (int i = 0; i < N; i++) {
+      callsLeaf(i);
+    }
+  }
+
+  public void timeCallsLeafPromoted(int N) {
+    for (int i = 0; i < N; i++) {
+      callsLeafPromoted(i);
+    }
+  }
+
+  public void timeRecursive(int N) {
+    for (int i = 0; i < N; i++) {
+      recursive(i);
+    }
+  }
+
+  public void timeRecursivePromoted(int N) {
+    for (int i = 0; i < N; i++) {
+      recursivePromoted(i);
+    }
+  }
+
+  public void timeUsesLock(int N) {
+    for (int i = 0; i < N; i++) {
+      usesLock(i);
+    }
+  }
+
+  public void timeUsesLockPromoted(int N) {
+    for (int i = 0; i < N; i++) {
+      usesLockPromoted(i);
+    }
+  }
+
+  static {
+    System.loadLibrary("artbenchmark");
+    try {
+      // Link all the natives before analyzing them.
+      for (String name : CORPUS) {
+        AutoFastJniBenchmark.class.getDeclaredMethod(name, int.class).invoke(null, 1);
+        AutoFastJniBenchmark.class.getDeclaredMethod(name + "Promoted", int.class).invoke(null, 1);
+      }
+      leafMethod = AutoFastJniBenchmark.class.getDeclaredMethod("leaf", int.class);
+      callsLeafMethod = AutoFastJniBenchmark.class.getDeclaredMethod("callsLeaf", int.class);
+      recursiveMethod = AutoFastJniBenchmark.class.getDeclaredMethod("recursive", int.class);
+      usesLockMethod = AutoFastJniBenchmark.class.getDeclaredMethod("usesLock", int.class);
+
+      int promoted = 0;
+      for (String name : CORPUS) {
+        Method method = AutoFastJniBenchmark.class.getDeclaredMethod(name + "Promoted", int.class);
+        boolean isPromoted = promote(method);
+        System.out.println(name + (isPromoted ? " is" : " is not") + " promoted");
+        if (isPromoted) {
+          promoted++;
+        }
+      }
+      System.out.println("Promoted " + promoted + " of " + CORPUS.length + " natives");
+    } catch (ReflectiveOperationException e) {
+      throw new RuntimeException(e);
+    }
+  }
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <sstream>
+
+#include "jni.h"
+
+#include "gc/collector/garbage_collector.h"
+#include "gc/heap.h"
+#include "runtime.h"
+
+namespace art {
+
+namespace {
+
+// The resident set size of the process in bytes, or 0 if it cannot be read.
+size_t GetRss() {
+  FILE* statm = fopen("/proc/self/statm", "r");
+  if (statm == nullptr) {
+    return 0u;
+  }
+  size_t size_pages;
+  size_t rss_pages;
+  bool read = fscanf(statm, "%zu %zu", &size_pages, &rss_pages) == 2;
+  fclose(statm);
+  return read ? rss_pages * sysconf(_SC_PAGESIZE) : 0u;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_GcPatternsBenchmark_resetGcStats(JNIEnv*, jclass) {
+  Runtime::Current()->GetHeap()->ResetGcPerformanceInfo();
+}
+
+extern "C" JNIEXPORT jstring JNICALL Java_GcPatternsBenchmark_gcStats(JNIEnv* env, jclass) {
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  std::ostringstream os;
+  os << "collector " << heap->CurrentCollectorType() << ", rss " << GetRss() << "\n";
+  for (gc::collector::GarbageCollector* collector : heap->GetGarbageCollectors()) {
+    if (collector->NumberOfIterations() == 0) {
+      continue;
+    }
+    os << collector->GetName() << ": " << collector->NumberOfIterations() << " iterations"
+       << ", pause p50 " << collector->GetPausePercentileNs(0.5) << "ns"
+       << ", p90 " << collector->GetPausePercentileNs(0.9) << "ns"
+       << ", p99 " << collector->GetPausePercentileNs(0.99) << "ns"
+       << ", total pause " << collector->GetTotalPausedTimeNs() << "ns"
+       << ", throughput " << collector->GetEstimatedMeanThroughput() << "B/s\n";
+  }
+  return env->NewStringUTF(os.str().c_str());
+}
+
+}  // namespace
+
+}  // namespace art
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class GcPatternsBenchmark {
+  // Clears the pause histograms and timings of the collectors.
+  static native void resetGcStats();
+  // Returns the pause percentiles and throughput of each collector that ran since the last
+  // reset, and the RSS of the process.
+  static native String gcStats();
+
+  static {
+    System.loadLibrary("artbenchmark");
+  }
+
+  // The shape of the reference graph of the surviving objects.
+  enum Shape {
+    // The survivors are only referenced from the roots.
+    FLAT,
+    // Each survivor references the previous one.
+    LIST,
+    // Each survivor is referenced from a random earlier one, forming a tree.
+    TREE,
+  }
+
+  static class Node {
+    Node left;
+    Node right;
+    Object payload;
+  }
+
+  static class Pattern {
+    // Payload sizes in bytes, picked uniformly.
+    final int[] sizes;
+    // The fraction of the objects kept alive.
+    final double survivalRate;
+    final Shape shape;
+    final int threads;
+    // The number of survivors kept alive at a time, older ones are released.
+    final int liveObjects;
+
+    Pattern(int[] sizes, double survivalRate, Shape shape, int threads, int liveObjects) {
+      this.sizes = sizes;
+      this.survivalRate = survivalRate;
+      this.shape = shape;
+      this.threads = threads;
+      this.liveObjects = liveObjects;
+    }
+  }
+
+  private static final int[] SMALL = { 16, 32, 48 };
+  private static final int[] MIXED = { 16, 64, 256, 4096 };
+  // Above the large object threshold of 3 pages.
+  private static final int[] LARGE = { 16 * 1024, 64 * 1024 };
+
+  private static final int LIVE_OBJECTS = 16 * 1024;
+
+  public void timeShortLivedSmall(int N) throws Exception {
+    run(new Pattern(SMALL, 0.0, Shape.FLAT, 1, LIVE_OBJECTS), N);
+  }
+
+  public void timeMixedSizes(int N) throws Exception {
+    run(new Pattern(MIXED, 0.05, Shape.FLAT, 1, LIVE_OBJECTS), N);
+  }
+
+  public void timeLargeObjects(int N) throws Exception {
+    run(new Pattern(LARGE, 0.05, Shape.FLAT, 1, 64), N);
+  }
+
+  public void timeHighSurvival(int N) throws Exception {
+    run(new Pattern(SMALL, 0.5, Shape.FLAT, 1, LIVE_OBJECTS), N);
+  }
+
+  public void timeLinkedList(int N) throws Exception {
+    run(new Pattern(SMALL, 0.2, Shape.LIST, 1, LIVE_OBJECTS), N);
+  }
+
+  public void timeTree(int N) throws Exception {
+    run(new Pattern(SMALL, 0.2, Shape.TREE, 1, LIVE_OBJECTS), N);
+  }
+
+  public void timeFourThreads(int N) throws Exception {
+    run(new Pattern(MIXED, 0.05, Shape.FLAT, 4, LIVE_OBJECTS), N);
+  }
+
+  // Allocates N objects following `pattern`, split across its threads.
+  public static void run(final Pattern pattern, final int N) throws Exception {
+    Thread[] threads = new Thread[pattern.threads];
+    for (int t = 0; t < threads.length; t++) {
+      final int seed = t + 1;
+      threads[t] = new Thread() {
+        public void run() {
+          allocate(pattern, N / pattern.threads, seed);
+        }
+      };
+      threads[t].start();
+    }
+    for (Thread thread : threads) {
+      thread.join();
+    }
+  }
+
+  private static void allocate(Pattern pattern, int count, int seed) {
+    Node[] live = new Node[pattern.liveObjects];
+    int next = 0;
+    Node last = null;
+    // A linear congruential generator, so that the runs are reproducible and cheap.
+    int random = seed;
+    int survivalThreshold = (int) (pattern.survivalRate * 0x10000);
+    for (int i = 0; i < count; i++) {
+      random = random * 1103515245 + 12345;
+      int r = random >>> 8;
+      Node node = new Node();
+      node.payload = new byte[pattern.sizes[r % pattern.sizes.length]];
+      if ((r & 0xffff) >= survivalThreshold) {
+        continue;
+      }
+      switch (pattern.shape) {
+        case FLAT:
+          break;
+        case LIST: {
+          node.left = last;
+          // Release the oldest survivor, so that the list does not grow without bound.
+          Node second = live[(next + 1) % live.length];
+          if (second != null) {
+            second.left = null;
+          }
+          break;
+        }
+        case TREE: {
+          Node parent = live[r % live.length];
+          if (parent != null) {
+            if (parent.left == null) {
+              parent.left = node;
+            } else {
+              parent.right = node;
+            }
+          }
+          break;
+        }
+      }
+      live[next] = node;
+      next = (next + 1) % live.length;
+      last = node;
+    }
+  }
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class LoopKernelsBenchmark {
+    public static final int LENGTH = 1024;
+
+    private static final int[] ints = new int[LENGTH];
+    private static final int[] intsOut = new int[LENGTH];
+    private static final float[] floats = new float[LENGTH];
+    private static final byte[] bytes1 = new byte[LENGTH];
+    private static final byte[] bytes2 = new byte[LENGTH];
+
+    // The results of the kernels, so that they are not eliminated.
+    public static int intSink;
+    public static float floatSink;
+
+    static {
+        for (int i = 0; i < LENGTH; ++i) {
+            ints[i] = i * 31 - 7;
+            floats[i] = i * 0.5f;
+            bytes1[i] = (byte) (i * 7);
+            bytes2[i] = (byte) (i * 13 + 5);
+        }
+    }
+
+    public void timeSumInt(int count) {
+        for (int i = 0; i < count; ++i) {
+            intSink = $noinline$sumInt(ints);
+        }
+    }
+
+    public void timeDotFloat(int count) {
+        for (int i = 0; i < count; ++i) {
+            floatSink = $noinline$dotFloat(floats, floats);
+        }
+    }
+
+    public void timeStencil3(int count) {
+        for (int i = 0; i < count; ++i) {
+            $noinline$stencil3(ints, intsOut);
+        }
+    }
+
+    public void timeStrided2(int count) {
+        for (int i = 0; i < count; ++i) {
+            intSink = $noinline$sumStrided(ints, 2);
+        }
+    }
+
+    public void timeStrided4(int count) {
+        for (int i = 0; i < count; ++i) {
+            intSink = $noinline$sumStrided(ints, 4);
+        }
+    }
+
+    public void timeSadByte(int count) {
+        for (int i = 0; i < count; ++i) {
+            intSink = $noinline$sadByte(bytes1, bytes2);
+        }
+    }
+
+    public void timeTailRecursiveSum(int count) {
+        for (int i = 0; i < count; ++i) {
+            intSink = $noinline$tailRecursiveSum(ints, 0, 0);
+        }
+    }
+
+    private static int $noinline$sumInt(int[] a) {
+        int sum = 0;
+        for (int i = 0; i < a.length; ++i) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    private static float $noinline$dotFloat(float[] a, float[] b) {
+        float sum = 0.0f;
+        for (int i = 0; i < a.length; ++i) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    private static void $noinline$stencil3(int[] in, int[] out) {
+        for (int i = 1; i < in.length - 1; ++i) {
+            out[i] = in[i - 1] + 2 * in[i] + in[i + 1];
+        }
+    }
+
+    // Only reads `a.length / stride` elements.
+    private static int $noinline$sumStrided(int[] a, int stride) {
+        int sum = 0;
+        for (int i = 0; i < a.length; i += stride) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    private static int $noinline$sadByte(byte[] a, byte[] b) {
+        int sad = 0;
+        for (int i = 0; i < a.length; ++i) {
+            sad += Math.abs(a[i] - b[i]);
+        }
+        return sad;
+    }
+
+    // A loop once the tail recursion elimination has run.
+    private static int $noinline$tailRecursiveSum(int[] a, int i, int sum) {
+        if (i == a.length) {
+            return sum;
+        }
+        return $noinline$tailRecursiveSum(a, i + 1, sum + a[i]);
+    }
+}
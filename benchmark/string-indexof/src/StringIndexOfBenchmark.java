@@ -16,6 +16,9 @@
 
 public class StringIndexOfBenchmark {
     public static final String string36 = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";  // length = 36
+    public static final String logLine =
+        "10-14 09:12:01.345  1234  1290 I ActivityManager: Start proc 4321:com.example/u0a99 " +
+        "for activity com.example/.MainActivity E/ActivityMgr: ANR";
 
     public void timeIndexOf0(int count) {
         final char c = '0';
@@ -113,10 +116,68 @@ public class StringIndexOfBenchmark {
         }
     }
 
+    public void timeIndexOfString0(int count) {
+        final String sub = "012";
+        String s = string36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, sub);
+        }
+    }
+
+    public void timeIndexOfStringF(int count) {
+        final String sub = "FGH";
+        String s = string36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, sub);
+        }
+    }
+
+    public void timeIndexOfStringW(int count) {
+        final String sub = "WXYZ";
+        String s = string36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, sub);
+        }
+    }
+
+    public void timeIndexOfString_(int count) {
+        final String sub = "XY_";
+        String s = string36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, sub);
+        }
+    }
+
+    public void timeIndexOfStringAfter(int count) {
+        final String sub = "89";
+        String s = string36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, sub, 4);
+        }
+    }
+
+    public void timeIndexOfStringLog(int count) {
+        final String sub = "E/ActivityMgr";
+        String s = logLine;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, sub);
+        }
+    }
+
     static int $noinline$indexOf(String s, char c) {
         if (doThrow) { throw new Error(); }
         return s.indexOf(c);
     }
 
+    static int $noinline$indexOf(String s, String sub) {
+        if (doThrow) { throw new Error(); }
+        return s.indexOf(sub);
+    }
+
+    static int $noinline$indexOf(String s, String sub, int fromIndex) {
+        if (doThrow) { throw new Error(); }
+        return s.indexOf(sub, fromIndex);
+    }
+
     public static boolean doThrow = false;
 }
@@ -50,6 +50,27 @@ public class TypeCheckBenchmark {
         }
     }
 
+    public void timeCheckCastLevel1ToInterface1(int count) {
+        Object[] arr = arr1;
+        for (int i = 0; i < count; ++i) {
+            Interface1 i1 = (Interface1) arr[i & 1023];
+        }
+    }
+
+    public void timeCheckCastLevel9ToInterface1(int count) {
+        Object[] arr = arr9;
+        for (int i = 0; i < count; ++i) {
+            Interface1 i1 = (Interface1) arr[i & 1023];
+        }
+    }
+
+    public void timeCheckCastLevel9ToInterface9(int count) {
+        Object[] arr = arr9;
+        for (int i = 0; i < count; ++i) {
+            Interface9 i9 = (Interface9) arr[i & 1023];
+        }
+    }
+
     public void timeInstanceOfLevel1ToLevel1(int count) {
         int sum = 0;
         Object[] arr = arr1;
@@ -105,6 +126,50 @@ public class TypeCheckBenchmark {
         result = sum;
     }
 
+    public void timeInstanceOfLevel1ToInterface1(int count) {
+        int sum = 0;
+        Object[] arr = arr1;
+        for (int i = 0; i < count; ++i) {
+            if (arr[i & 1023] instanceof Interface1) {
+              ++sum;
+            }
+        }
+        result = sum;
+    }
+
+    public void timeInstanceOfLevel9ToInterface1(int count) {
+        int sum = 0;
+        Object[] arr = arr9;
+        for (int i = 0; i < count; ++i) {
+            if (arr[i & 1023] instanceof Interface1) {
+              ++sum;
+            }
+        }
+        result = sum;
+    }
+
+    public void timeInstanceOfLevel9ToInterface9(int count) {
+        int sum = 0;
+        Object[] arr = arr9;
+        for (int i = 0; i < count; ++i) {
+            if (arr[i & 1023] instanceof Interface9) {
+              ++sum;
+            }
+        }
+        result = sum;
+    }
+
+    public void timeInstanceOfLevel1ToInterface9(int count) {
+        int sum = 0;
+        Object[] arr = arr1;
+        for (int i = 0; i < count; ++i) {
+            if (arr[i & 1023] instanceof Interface9) {
+              ++sum;
+            }
+        }
+        result = sum;
+    }
+
     public static Object[] createArray(int level) {
         try {
             Class<?>[] ls = {
@@ -136,12 +201,22 @@ public class TypeCheckBenchmark {
     int result;
 }
 
-class Level1 { }
-class Level2 extends Level1 { }
-class Level3 extends Level2 { }
-class Level4 extends Level3 { }
-class Level5 extends Level4 { }
-class Level6 extends Level5 { }
-class Level7 extends Level6 { }
-class Level8 extends Level7 { }
-class Level9 extends Level8 { }
+interface Interface1 { }
+interface Interface2 { }
+interface Interface3 { }
+interface Interface4 { }
+interface Interface5 { }
+interface Interface6 { }
+interface Interface7 { }
+interface Interface8 { }
+interface Interface9 { }
+
+class Level1 implements Interface1 { }
+class Level2 extends Level1 implements Interface2 { }
+class Level3 extends Level2 implements Interface3 { }
+class Level4 extends Level3 implements Interface4 { }
+class Level5 extends Level4 implements Interface5 { }
+class Level6 extends Level5 implements Interface6 { }
+class Level7 extends Level6 implements Interface7 { }
+class Level8 extends Level7 implements Interface8 { }
+class Level9 extends Level8 implements Interface9 { }
@@ -438,6 +438,12 @@ struct XGcOption {
   // Do no measurements for kUseTableLookupReadBarrier to avoid test timeouts. b/31679493
   bool measure_ = kIsDebugBuild && !kUseTableLookupReadBarrier;
   bool gcstress_ = false;
+  // Split the region space across the NUMA nodes.
+  bool numa_ = false;
+  // Back the region space and the card table with transparent huge pages.
+  bool huge_pages_ = false;
+  // Run young collections between the full collections of the concurrent copying collector.
+  bool generational_cc_ = kEnableGenerationalCCByDefault;
 };
 
 template <>
@@ -481,6 +487,18 @@ struct CmdlineType<XGcOption> : CmdlineTypeParser<XGcOption> {
         xgc.gcstress_ = false;
       } else if (gc_option == "measure") {
         xgc.measure_ = true;
+      } else if (gc_option == "numa") {
+        xgc.numa_ = true;
+      } else if (gc_option == "nonuma") {
+        xgc.numa_ = false;
+      } else if (gc_option == "hugepages") {
+        xgc.huge_pages_ = true;
+      } else if (gc_option == "nohugepages") {
+        xgc.huge_pages_ = false;
+      } else if (gc_option == "generational_cc") {
+        xgc.generational_cc_ = true;
+      } else if (gc_option == "nogenerational_cc") {
+        xgc.generational_cc_ = false;
       } else if ((gc_option == "precise") ||
                  (gc_option == "noprecise") ||
                  (gc_option == "verifycardtable") ||
@@ -29,6 +29,7 @@
 #include "dex/verification_results.h"
 #include "driver/compiler_driver.h"
 #include "driver/compiler_options.h"
+#include "fault_handler.h"
 #include "interpreter/interpreter.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
@@ -113,6 +114,9 @@ void CommonCompilerTest::MakeExecutable(const void* code_start, size_t code_leng
   uintptr_t len = limit - base;
   int result = mprotect(reinterpret_cast<void*>(base), len, PROT_READ | PROT_WRITE | PROT_EXEC);
   CHECK_EQ(result, 0);
+  // The code may rely on implicit checks. The range is never removed, a stale range only makes
+  // the fault handler look for the method of more faults.
+  fault_manager.AddGeneratedCodeRange(reinterpret_cast<void*>(base), len);
 
   FlushInstructionCache(reinterpret_cast<char*>(base), reinterpret_cast<char*>(base + len));
 }
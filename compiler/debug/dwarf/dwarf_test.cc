@@ -150,6 +150,36 @@ TEST_F(DwarfTest, DebugFrame64) {
   CheckObjdumpOutput(is64bit, "-W");
 }
 
+// Test FDEs sharing the same encoded instructions.
+TEST_F(DwarfTest, DebugFrameSharedInstructions) {
+  constexpr bool is64bit = false;
+  DebugFrameOpCodeWriter<> initial_opcodes;
+  WriteCIE(is64bit, Reg(8),
+           initial_opcodes, kCFIFormat, &debug_frame_data_);
+  DebugFrameOpCodeWriter<> opcodes;
+  opcodes.AdvancePC(4);
+  opcodes.AdjustCFAOffset(16);
+  std::vector<uint8_t> instructions;
+  WriteFDEInstructions(is64bit, ArrayRef<const uint8_t>(*opcodes.data()), &instructions);
+  std::vector<uintptr_t> debug_frame_patches;
+  std::vector<uintptr_t> expected_patches = { 28, 48 };
+  WriteFDEWithInstructions(is64bit, 0, 0, 0x01000000, 0x100,
+                           ArrayRef<const uint8_t>(instructions),
+                           kCFIFormat, 0, &debug_frame_data_, &debug_frame_patches);
+  DW_CHECK("FDE cie=00000000 pc=01000000..01000100");
+  DW_CHECK_NEXT("DW_CFA_advance_loc: 4 to 01000004");
+  DW_CHECK_NEXT("DW_CFA_def_cfa_offset: 16");
+  WriteFDEWithInstructions(is64bit, 0, 0, 0x01000100, 0x200,
+                           ArrayRef<const uint8_t>(instructions),
+                           kCFIFormat, 0, &debug_frame_data_, &debug_frame_patches);
+  DW_CHECK("FDE cie=00000000 pc=01000100..01000300");
+  DW_CHECK_NEXT("DW_CFA_advance_loc: 4 to 01000104");
+  DW_CHECK_NEXT("DW_CFA_def_cfa_offset: 16");
+
+  EXPECT_EQ(expected_patches, debug_frame_patches);
+  CheckObjdumpOutput(is64bit, "-W");
+}
+
 // Test x86_64 register mapping. It is the only non-trivial architecture.
 // ARM, X86, and Mips have: dwarf_reg = art_reg + constant.
 TEST_F(DwarfTest, x86_64_RegisterMapping) {
@@ -75,18 +75,34 @@ void WriteCIE(bool is64bit,
   writer.UpdateUint32(cie_header_start_, writer.data()->size() - cie_header_start_ - 4);
 }
 
-// Write frame description entry (FDE) to .debug_frame or .eh_frame section.
+// Write the instructions of a frame description entry (FDE), that is the augmentation data
+// and the padded opcodes. They do not depend on the location of the FDE, so the FDEs of all
+// methods with the same opcodes can share them.
 inline
-void WriteFDE(bool is64bit,
-              uint64_t section_address,  // Absolute address of the section.
-              uint64_t cie_address,  // Absolute address of last CIE.
-              uint64_t code_address,
-              uint64_t code_size,
-              const ArrayRef<const uint8_t>& opcodes,
-              CFIFormat format,
-              uint64_t buffer_address,  // Address of buffer in linked application.
-              std::vector<uint8_t>* buffer,
-              std::vector<uintptr_t>* patch_locations) {
+void WriteFDEInstructions(bool is64bit,
+                          const ArrayRef<const uint8_t>& opcodes,
+                          std::vector<uint8_t>* instructions) {
+  DCHECK(instructions->empty());
+  Writer<> writer(instructions);
+  writer.PushUleb128(0);  // Augmentation data size.
+  writer.PushData(opcodes.data(), opcodes.size());
+  // The header of the FDE is a multiple of the alignment, so the whole FDE is padded.
+  writer.Pad(is64bit ? 8 : 4);
+}
+
+// Write frame description entry (FDE) to .debug_frame or .eh_frame section,
+// with instructions written by WriteFDEInstructions().
+inline
+void WriteFDEWithInstructions(bool is64bit,
+                              uint64_t section_address,  // Absolute address of the section.
+                              uint64_t cie_address,  // Absolute address of last CIE.
+                              uint64_t code_address,
+                              uint64_t code_size,
+                              const ArrayRef<const uint8_t>& instructions,
+                              CFIFormat format,
+                              uint64_t buffer_address,  // Address of buffer in linked application.
+                              std::vector<uint8_t>* buffer,
+                              std::vector<uintptr_t>* patch_locations) {
   CHECK_GE(cie_address, section_address);
   CHECK_GE(buffer_address, section_address);
 
@@ -116,12 +132,30 @@ void WriteFDE(bool is64bit,
     writer.PushUint32(code_address);
     writer.PushUint32(code_size);
   }
-  writer.PushUleb128(0);  // Augmentation data size.
-  writer.PushData(opcodes.data(), opcodes.size());
-  writer.Pad(is64bit ? 8 : 4);
+  writer.PushData(instructions.data(), instructions.size());
   writer.UpdateUint32(fde_header_start, writer.data()->size() - fde_header_start - 4);
 }
 
+// Write frame description entry (FDE) to .debug_frame or .eh_frame section.
+inline
+void WriteFDE(bool is64bit,
+              uint64_t section_address,  // Absolute address of the section.
+              uint64_t cie_address,  // Absolute address of last CIE.
+              uint64_t code_address,
+              uint64_t code_size,
+              const ArrayRef<const uint8_t>& opcodes,
+              CFIFormat format,
+              uint64_t buffer_address,  // Address of buffer in linked application.
+              std::vector<uint8_t>* buffer,
+              std::vector<uintptr_t>* patch_locations) {
+  std::vector<uint8_t> instructions;
+  WriteFDEInstructions(is64bit, opcodes, &instructions);
+  WriteFDEWithInstructions(is64bit, section_address, cie_address,
+                           code_address, code_size,
+                           ArrayRef<const uint8_t>(instructions), format,
+                           buffer_address, buffer, patch_locations);
+}
+
 // Write compilation unit (CU) to .debug_info section.
 template<typename Vector>
 void WriteDebugInfoCU(uint32_t debug_abbrev_offset,
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "arch/instruction_set.h"
+#include "base/globals.h"
 #include "debug/dwarf/debug_frame_opcode_writer.h"
 #include "debug/dwarf/dwarf_constants.h"
 #include "debug/dwarf/headers.h"
@@ -29,6 +30,9 @@
 namespace art {
 namespace debug {
 
+// The CFI section is written in chunks of about that size, rather than one entry at a time.
+static constexpr size_t kCFIWriteBatchSize = 64 * KB;
+
 static void WriteCIE(InstructionSet isa,
                      dwarf::CFIFormat format,
                      std::vector<uint8_t>* buffer) {
@@ -215,11 +219,13 @@ void WriteCFISection(linker::ElfBuilder<ElfTypes>* builder,
     const Elf_Addr cfi_address = (is_debug_frame ? 0 : cfi_section->GetAddress());
     const Elf_Addr cie_address = cfi_address;
     Elf_Addr buffer_address = cfi_address;
-    std::vector<uint8_t> buffer;  // Small temporary buffer.
+    std::vector<uint8_t> buffer;  // Temporary buffer, written to the section in batches.
     WriteCIE(builder->GetIsa(), format, &buffer);
-    cfi_section->WriteFully(buffer.data(), buffer.size());
-    buffer_address += buffer.size();
-    buffer.clear();
+    // Methods with the same frame layout and the same prologue and epilogue positions have the
+    // same opcodes, and the sorting above makes them adjacent. The instructions of their FDEs
+    // are therefore only encoded once.
+    std::vector<uint8_t> instructions;
+    ArrayRef<const uint8_t> instructions_cfi;
     for (const MethodDebugInfo* mi : sorted_method_infos) {
       DCHECK(!mi->deduped);
       DCHECK(!mi->cfi.empty());
@@ -227,16 +233,25 @@ void WriteCFISection(linker::ElfBuilder<ElfTypes>* builder,
           (mi->is_code_address_text_relative ? builder->GetText()->GetAddress() : 0);
       if (format == dwarf::DW_EH_FRAME_FORMAT) {
         binary_search_table.push_back(dchecked_integral_cast<uint32_t>(code_address));
-        binary_search_table.push_back(dchecked_integral_cast<uint32_t>(buffer_address));
+        binary_search_table.push_back(
+            dchecked_integral_cast<uint32_t>(buffer_address + buffer.size()));
+      }
+      if (instructions.empty() || mi->cfi != instructions_cfi) {
+        instructions.clear();
+        dwarf::WriteFDEInstructions(is64bit, mi->cfi, &instructions);
+        instructions_cfi = mi->cfi;
+      }
+      dwarf::WriteFDEWithInstructions(is64bit, cfi_address, cie_address,
+                                      code_address, mi->code_size,
+                                      ArrayRef<const uint8_t>(instructions), format,
+                                      buffer_address, &buffer, &patch_locations);
+      if (buffer.size() >= kCFIWriteBatchSize) {
+        cfi_section->WriteFully(buffer.data(), buffer.size());
+        buffer_address += buffer.size();
+        buffer.clear();
       }
-      WriteFDE(is64bit, cfi_address, cie_address,
-               code_address, mi->code_size,
-               mi->cfi, format, buffer_address, &buffer,
-               &patch_locations);
-      cfi_section->WriteFully(buffer.data(), buffer.size());
-      buffer_address += buffer.size();
-      buffer.clear();
     }
+    cfi_section->WriteFully(buffer.data(), buffer.size());
     cfi_section->End();
   }
 
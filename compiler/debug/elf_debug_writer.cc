@@ -157,13 +157,14 @@ static std::vector<uint8_t> MakeElfFileForJITInternal(
   builder->Start(false /* write_program_headers */);
   if (mini_debug_info) {
     if (method_infos.size() > 1) {
-      std::vector<uint8_t> mdi = MakeMiniDebugInfo(isa,
-                                                   features,
-                                                   min_address,
-                                                   max_address - min_address,
-                                                   /* dex_section_address */ 0,
-                                                   /* dex_section_size */ 0,
-                                                   debug_info);
+      std::vector<uint8_t> mdi = MakeMiniDebugInfoInternal<ElfTypes>(isa,
+                                                                     features,
+                                                                     min_address,
+                                                                     max_address - min_address,
+                                                                     /* dex_section_address */ 0,
+                                                                     /* dex_section_size */ 0,
+                                                                     debug_info,
+                                                                     kJitXzCompressionLevel);
       builder->WriteSection(".gnu_debugdata", &mdi);
     } else {
       // The compression is great help for multiple methods but it is not worth it for a
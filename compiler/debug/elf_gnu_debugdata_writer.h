@@ -17,6 +17,7 @@
 #ifndef ART_COMPILER_DEBUG_ELF_GNU_DEBUGDATA_WRITER_H_
 #define ART_COMPILER_DEBUG_ELF_GNU_DEBUGDATA_WRITER_H_
 
+#include <algorithm>
 #include <vector>
 
 #include "arch/instruction_set.h"
@@ -31,13 +32,26 @@
 namespace art {
 namespace debug {
 
-static void XzCompress(const std::vector<uint8_t>* src, std::vector<uint8_t>* dst) {
+// The compression level of the mini-debug-info of oat files. It is fast, and the higher levels
+// barely shrink the symbols and CFI further.
+static constexpr int kXzCompressionLevel = 1;
+
+// The compression level of the mini-debug-info of JITed code, which is compressed while the
+// application runs. The fastest level, with the smallest dictionary.
+static constexpr int kJitXzCompressionLevel = 0;
+
+static void XzCompress(const std::vector<uint8_t>* src,
+                       std::vector<uint8_t>* dst,
+                       int level = kXzCompressionLevel) {
   // Configure the compression library.
   CrcGenerateTable();
   Crc64GenerateTable();
   CLzma2EncProps lzma2Props;
   Lzma2EncProps_Init(&lzma2Props);
-  lzma2Props.lzmaProps.level = 1;  // Fast compression.
+  lzma2Props.lzmaProps.level = level;
+  // Let the encoder size its dictionary and hash tables for the data, rather than for the level.
+  // Most inputs are much smaller than the dictionary of the level.
+  lzma2Props.lzmaProps.reduceSize = std::min<size_t>(src->size(), 0xFFFFFFFFu);
   Lzma2EncProps_Normalize(&lzma2Props);
   CXzProps props;
   XzProps_Init(&props);
@@ -84,7 +98,8 @@ static std::vector<uint8_t> MakeMiniDebugInfoInternal(
     size_t text_section_size,
     typename ElfTypes::Addr dex_section_address,
     size_t dex_section_size,
-    const DebugInfo& debug_info) {
+    const DebugInfo& debug_info,
+    int compression_level = kXzCompressionLevel) {
   std::vector<uint8_t> buffer;
   buffer.reserve(KB);
   linker::VectorOutputStream out("Mini-debug-info ELF file", &buffer);
@@ -105,7 +120,7 @@ static std::vector<uint8_t> MakeMiniDebugInfoInternal(
   CHECK(builder->Good());
   std::vector<uint8_t> compressed_buffer;
   compressed_buffer.reserve(buffer.size() / 4);
-  XzCompress(&buffer, &compressed_buffer);
+  XzCompress(&buffer, &compressed_buffer, compression_level);
   return compressed_buffer;
 }
 
@@ -161,23 +161,38 @@ class CompiledMethodStorage::LengthPrefixedArrayAlloc {
   SwapSpace* const swap_space_;
 };
 
-CompiledMethodStorage::CompiledMethodStorage(int swap_fd)
+CompiledMethodStorage::CompiledMethodStorage(int swap_fd, size_t thread_count)
     : swap_space_(swap_fd == -1 ? nullptr : new SwapSpace(swap_fd, 10 * MB)),
       dedupe_enabled_(true),
-      dedupe_code_("dedupe code", LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get())),
+      dedupe_code_("dedupe code",
+                   LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get()),
+                   NumDedupeShards(thread_count)),
       dedupe_method_info_("dedupe method info",
-                          LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get())),
+                          LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get()),
+                          NumDedupeShards(thread_count)),
       dedupe_vmap_table_("dedupe vmap table",
-                         LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get())),
-      dedupe_cfi_info_("dedupe cfi info", LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get())),
-      dedupe_linker_patches_("dedupe cfi info",
-                             LengthPrefixedArrayAlloc<linker::LinkerPatch>(swap_space_.get())) {
+                         LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get()),
+                         NumDedupeShards(thread_count)),
+      dedupe_cfi_info_("dedupe cfi info",
+                       LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get()),
+                       NumDedupeShards(thread_count)),
+      dedupe_linker_patches_("dedupe linker patches",
+                             LengthPrefixedArrayAlloc<linker::LinkerPatch>(swap_space_.get()),
+                             NumDedupeShards(thread_count)),
+      jni_stubs_lock_("JNI stubs lock"),
+      jni_stubs_() {
 }
 
 CompiledMethodStorage::~CompiledMethodStorage() {
   // All done by member destructors.
 }
 
+void CompiledMethodStorage::ReleaseSwapSpacePages() {
+  if (swap_space_ != nullptr) {
+    swap_space_->ReleaseResidentPages();
+  }
+}
+
 void CompiledMethodStorage::DumpMemoryUsage(std::ostream& os, bool extended) const {
   if (swap_space_.get() != nullptr) {
     const size_t swap_size = swap_space_->GetSize();
@@ -237,4 +252,19 @@ void CompiledMethodStorage::ReleaseLinkerPatches(
   ReleaseArrayIfNotDeduplicated(linker_patches);
 }
 
+const CompiledMethod* CompiledMethodStorage::FindJniStub(const char* shorty,
+                                                         uint32_t access_flags) {
+  MutexLock mu(Thread::Current(), jni_stubs_lock_);
+  auto it = jni_stubs_.find(JniStubKey(shorty, access_flags));
+  return (it != jni_stubs_.end()) ? it->second : nullptr;
+}
+
+void CompiledMethodStorage::AddJniStub(const char* shorty,
+                                       uint32_t access_flags,
+                                       const CompiledMethod* stub) {
+  DCHECK(stub != nullptr);
+  MutexLock mu(Thread::Current(), jni_stubs_lock_);
+  jni_stubs_.FindOrAdd(JniStubKey(shorty, access_flags), stub);
+}
+
 }  // namespace art
@@ -17,12 +17,18 @@
 #ifndef ART_COMPILER_DRIVER_COMPILED_METHOD_STORAGE_H_
 #define ART_COMPILER_DRIVER_COMPILED_METHOD_STORAGE_H_
 
+#include <string.h>
+
+#include <algorithm>
 #include <iosfwd>
 #include <memory>
 
 #include "base/array_ref.h"
 #include "base/length_prefixed_array.h"
 #include "base/macros.h"
+#include "base/mutex.h"
+#include "base/safe_map.h"
+#include "dex/modifiers.h"
 #include "utils/dedupe_set.h"
 #include "utils/swap_space.h"
 
@@ -32,9 +38,13 @@ namespace linker {
 class LinkerPatch;
 }  // namespace linker
 
+class CompiledMethod;
+
 class CompiledMethodStorage {
  public:
-  explicit CompiledMethodStorage(int swap_fd);
+  // The dedupe sets get a number of shards that follows `thread_count`, the number of threads
+  // that add compiled methods concurrently.
+  CompiledMethodStorage(int swap_fd, size_t thread_count);
   ~CompiledMethodStorage();
 
   void DumpMemoryUsage(std::ostream& os, bool extended) const;
@@ -46,6 +56,9 @@ class CompiledMethodStorage {
     return dedupe_enabled_;
   }
 
+  // Release the memory of the swap space pages, if there is a swap space.
+  void ReleaseSwapSpacePages();
+
   SwapAllocator<void> GetSwapSpaceAllocator() {
     return SwapAllocator<void>(swap_space_.get());
   }
@@ -67,7 +80,40 @@ class CompiledMethodStorage {
       const ArrayRef<const linker::LinkerPatch>& linker_patches);
   void ReleaseLinkerPatches(const LengthPrefixedArray<linker::LinkerPatch>* linker_patches);
 
+  // The JNI stubs only depend on the shorty and on some of the access flags of their native
+  // method, so the native methods with the same shorty and flags can share the compilation of
+  // their stub. Return the stub compiled for `shorty` and `access_flags`, or null.
+  const CompiledMethod* FindJniStub(const char* shorty, uint32_t access_flags)
+      REQUIRES(!jni_stubs_lock_);
+
+  // Record `stub` as the stub of the native methods with `shorty` and `access_flags`, unless
+  // another thread recorded one first. The stub must live as long as the storage.
+  void AddJniStub(const char* shorty, uint32_t access_flags, const CompiledMethod* stub)
+      REQUIRES(!jni_stubs_lock_);
+
  private:
+  class JniStubKey {
+   public:
+    // The access flags that the code of a JNI stub depends on.
+    static constexpr uint32_t kAccessFlagsMask =
+        kAccStatic | kAccSynchronized | kAccFastNative | kAccCriticalNative;
+
+    JniStubKey(const char* shorty, uint32_t access_flags)
+        : shorty_(shorty), access_flags_(access_flags & kAccessFlagsMask) {}
+
+    bool operator<(const JniStubKey& rhs) const {
+      if (access_flags_ != rhs.access_flags_) {
+        return access_flags_ < rhs.access_flags_;
+      }
+      return strcmp(shorty_, rhs.shorty_) < 0;
+    }
+
+   private:
+    // Points to the data of a dex file, which outlives the compilation.
+    const char* shorty_;
+    uint32_t access_flags_;
+  };
+
   template <typename T, typename DedupeSetType>
   const LengthPrefixedArray<T>* AllocateOrDeduplicateArray(const ArrayRef<const T>& data,
                                                            DedupeSetType* dedupe_set);
@@ -87,8 +133,17 @@ class CompiledMethodStorage {
                                    LengthPrefixedArray<T>,
                                    LengthPrefixedArrayAlloc<T>,
                                    size_t,
-                                   DedupeHashFunc<const T>,
-                                   4>;
+                                   DedupeHashFunc<const T>>;
+
+  // The minimum number of shards of the dedupe sets, and the number of shards per thread that
+  // adds compiled methods. More shards than threads keep the chance of two threads contending
+  // for the lock of a shard low.
+  static constexpr size_t kMinDedupeShards = 4u;
+  static constexpr size_t kDedupeShardsPerThread = 2u;
+
+  static size_t NumDedupeShards(size_t thread_count) {
+    return std::max(kMinDedupeShards, kDedupeShardsPerThread * thread_count);
+  }
 
   // Swap pool and allocator used for native allocations. May be file-backed. Needs to be first
   // as other fields rely on this.
@@ -102,6 +157,9 @@ class CompiledMethodStorage {
   ArrayDedupeSet<uint8_t> dedupe_cfi_info_;
   ArrayDedupeSet<linker::LinkerPatch> dedupe_linker_patches_;
 
+  Mutex jni_stubs_lock_;
+  SafeMap<JniStubKey, const CompiledMethod*> jni_stubs_ GUARDED_BY(jni_stubs_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(CompiledMethodStorage);
 };
 
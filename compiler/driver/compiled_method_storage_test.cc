@@ -126,4 +126,52 @@ TEST(CompiledMethodStorage, Deduplicate) {
   }
 }
 
+TEST(CompiledMethodStorage, JniStubs) {
+  CompilerOptions compiler_options;
+  VerificationResults verification_results(&compiler_options);
+  CompilerDriver driver(&compiler_options,
+                        &verification_results,
+                        Compiler::kOptimizing,
+                        /* instruction_set_ */ InstructionSet::kNone,
+                        /* instruction_set_features */ nullptr,
+                        /* image_classes */ nullptr,
+                        /* compiled_classes */ nullptr,
+                        /* compiled_methods */ nullptr,
+                        /* thread_count */ 1u,
+                        /* swap_fd */ -1,
+                        /* profile_compilation_info */ nullptr);
+  CompiledMethodStorage* storage = driver.GetCompiledMethodStorage();
+
+  const uint8_t raw_code[] = { 1u, 2u, 3u };
+  CompiledMethod* stub1 = CompiledMethod::SwapAllocCompiledMethod(
+      &driver, InstructionSet::kNone, ArrayRef<const uint8_t>(raw_code), 0u, 0u, 0u,
+      ArrayRef<const uint8_t>(), ArrayRef<const uint8_t>(), ArrayRef<const uint8_t>(),
+      ArrayRef<const linker::LinkerPatch>());
+  CompiledMethod* stub2 = CompiledMethod::SwapAllocCompiledMethod(
+      &driver, InstructionSet::kNone, ArrayRef<const uint8_t>(raw_code), 0u, 0u, 0u,
+      ArrayRef<const uint8_t>(), ArrayRef<const uint8_t>(), ArrayRef<const uint8_t>(),
+      ArrayRef<const linker::LinkerPatch>());
+
+  // The shorties are compared by their contents.
+  const char shorty1[] = "IJ";
+  const char shorty2[] = "IJ";
+  const char other_shorty[] = "JI";
+  ASSERT_EQ(nullptr, storage->FindJniStub(shorty1, kAccNative | kAccStatic));
+  storage->AddJniStub(shorty1, kAccNative | kAccStatic, stub1);
+  ASSERT_EQ(stub1, storage->FindJniStub(shorty2, kAccNative | kAccStatic));
+  // The access flags that the stub does not depend on are ignored.
+  ASSERT_EQ(stub1, storage->FindJniStub(shorty2, kAccPublic | kAccFinal | kAccNative | kAccStatic));
+  ASSERT_EQ(nullptr, storage->FindJniStub(other_shorty, kAccNative | kAccStatic));
+  ASSERT_EQ(nullptr, storage->FindJniStub(shorty2, kAccNative));
+  ASSERT_EQ(nullptr, storage->FindJniStub(shorty2, kAccNative | kAccStatic | kAccSynchronized));
+  ASSERT_EQ(nullptr, storage->FindJniStub(shorty2, kAccNative | kAccStatic | kAccFastNative));
+  ASSERT_EQ(nullptr, storage->FindJniStub(shorty2, kAccNative | kAccStatic | kAccCriticalNative));
+  // The first stub recorded is kept.
+  storage->AddJniStub(shorty2, kAccNative | kAccStatic, stub2);
+  ASSERT_EQ(stub1, storage->FindJniStub(shorty1, kAccNative | kAccStatic));
+
+  CompiledMethod::ReleaseSwapAllocatedCompiledMethod(&driver, stub1);
+  CompiledMethod::ReleaseSwapAllocatedCompiledMethod(&driver, stub2);
+}
+
 }  // namespace art
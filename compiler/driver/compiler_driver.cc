@@ -17,6 +17,10 @@
 #include "compiler_driver.h"
 
 #include <unistd.h>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
 #include <unordered_set>
 #include <vector>
 
@@ -168,6 +172,7 @@ class CompilerDriver::AOTCompilationStats {
                  oss2.str().c_str());
       }
     }
+    DumpClassInitializationAborts();
   }
 
 // Allow lossy statistics in non-debug builds.
@@ -230,7 +235,41 @@ class CompilerDriver::AOTCompilationStats {
     not_safe_casts_++;
   }
 
+  // A class initializer run at compile time was aborted for `reason`.
+  void ClassInitializationAborted(const std::string& reason) REQUIRES(!stats_lock_) {
+    // Not lossy, the map is not safe for concurrent updates.
+    MutexLock mu(Thread::Current(), stats_lock_);
+    ++class_initialization_aborts_[reason];
+  }
+
  private:
+  // Dump the most frequent reasons for aborting class initializers, to find the missing
+  // UnstartedRuntime support that prevents more classes from being initialized in the image.
+  void DumpClassInitializationAborts() REQUIRES(!stats_lock_) {
+    static constexpr size_t kMaxDumpedReasons = 20u;
+    if (!VLOG_IS_ON(compiler)) {
+      return;
+    }
+    std::vector<std::pair<size_t, std::string>> reasons;
+    size_t total = 0u;
+    {
+      MutexLock mu(Thread::Current(), stats_lock_);
+      for (const auto& entry : class_initialization_aborts_) {
+        reasons.emplace_back(entry.second, entry.first);
+        total += entry.second;
+      }
+    }
+    if (total == 0u) {
+      return;
+    }
+    std::sort(reasons.begin(), reasons.end(), std::greater<std::pair<size_t, std::string>>());
+    VLOG(compiler) << total << " class initializations aborted, for " << reasons.size()
+                   << " reasons";
+    for (size_t i = 0; i != std::min(reasons.size(), kMaxDumpedReasons); ++i) {
+      VLOG(compiler) << "  " << reasons[i].first << " aborted: " << reasons[i].second;
+    }
+  }
+
   Mutex stats_lock_;
 
   size_t resolved_types_;
@@ -254,6 +293,9 @@ class CompilerDriver::AOTCompilationStats {
   size_t safe_casts_;
   size_t not_safe_casts_;
 
+  // The number of class initializers aborted at compile time, by reason.
+  std::map<std::string, size_t> class_initialization_aborts_ GUARDED_BY(stats_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(AOTCompilationStats);
 };
 
@@ -287,7 +329,7 @@ CompilerDriver::CompilerDriver(
       stats_(new AOTCompilationStats),
       compiler_context_(nullptr),
       support_boot_image_fixup_(true),
-      compiled_method_storage_(swap_fd),
+      compiled_method_storage_(swap_fd, thread_count),
       profile_compilation_info_(profile_compilation_info),
       max_arena_alloc_(0),
       dex_to_dex_compiler_(this) {
@@ -975,6 +1017,9 @@ bool CompilerDriver::IsClassToCompile(const char* descriptor) const {
 }
 
 bool CompilerDriver::IsMethodToCompile(const MethodReference& method_ref) const {
+  if (!IsMethodInCompileShard(method_ref)) {
+    return false;
+  }
   if (methods_to_compile_ == nullptr) {
     return true;
   }
@@ -983,6 +1028,17 @@ bool CompilerDriver::IsMethodToCompile(const MethodReference& method_ref) const
   return methods_to_compile_->find(tmp.c_str()) != methods_to_compile_->end();
 }
 
+bool CompilerDriver::IsMethodInCompileShard(const MethodReference& method_ref) const {
+  const size_t shard_count = compiler_options_->GetCompileShardCount();
+  if (shard_count == 1u) {
+    return true;
+  }
+  // Only use the inputs, so that the dex2oat invocations compiling the different shards agree
+  // on the partition.
+  const size_t hash = method_ref.dex_file->GetLocationChecksum() + method_ref.index;
+  return hash % shard_count == compiler_options_->GetCompileShardIndex();
+}
+
 bool CompilerDriver::ShouldCompileBasedOnProfile(const MethodReference& method_ref) const {
   // Profile compilation info may be null if no profile is passed.
   if (!CompilerFilter::DependsOnProfile(compiler_options_->GetCompilerFilter())) {
@@ -1910,11 +1966,14 @@ static void LoadAndUpdateStatus(const DexFile& dex_file,
 
 bool CompilerDriver::FastVerify(jobject jclass_loader,
                                 const std::vector<const DexFile*>& dex_files,
-                                TimingLogger* timings) {
+                                TimingLogger* timings,
+                                /*out*/ std::vector<const DexFile*>* dex_files_to_verify) {
+  DCHECK(dex_files_to_verify->empty());
   verifier::VerifierDeps* verifier_deps =
       Runtime::Current()->GetCompilerCallbacks()->GetVerifierDeps();
   // If there exist VerifierDeps that aren't the ones we just created to output, use them to verify.
   if (verifier_deps == nullptr || verifier_deps->OutputOnly()) {
+    *dex_files_to_verify = dex_files;
     return false;
   }
   TimingLogger::ScopedTiming t("Fast Verify", timings);
@@ -1922,8 +1981,22 @@ bool CompilerDriver::FastVerify(jobject jclass_loader,
   StackHandleScope<2> hs(soa.Self());
   Handle<mirror::ClassLoader> class_loader(
       hs.NewHandle(soa.Decode<mirror::ClassLoader>(jclass_loader)));
-  if (!verifier_deps->ValidateDependencies(class_loader, soa.Self())) {
-    return false;
+  // The dependencies are recorded per dex file, so a change in the classpath only requires
+  // verifying again the dex files that depend on it. Validate all the dependencies before loading
+  // any class below.
+  std::vector<const DexFile*> verified_dex_files;
+  for (const DexFile* dex_file : dex_files) {
+    if (verifier_deps->ValidateDependencies(class_loader, *dex_file, soa.Self())) {
+      verified_dex_files.push_back(dex_file);
+    } else {
+      // The dependencies will be recorded again by the verifier.
+      verifier_deps->ClearDependencies(*dex_file);
+      dex_files_to_verify->push_back(dex_file);
+    }
+  }
+  if (!dex_files_to_verify->empty()) {
+    VLOG(compiler) << "Dependencies changed for " << dex_files_to_verify->size() << " of "
+                   << dex_files.size() << " dex files, verifying them again";
   }
 
   bool compiler_only_verifies = !GetCompilerOptions().IsAnyCompilationEnabled();
@@ -1933,7 +2006,7 @@ bool CompilerDriver::FastVerify(jobject jclass_loader,
   // could not be fully verified; we could try again, but that would hurt verification
   // time. So instead we assume these classes still need to be verified at
   // runtime.
-  for (const DexFile* dex_file : dex_files) {
+  for (const DexFile* dex_file : verified_dex_files) {
     // Fetch the list of unverified classes.
     const std::set<dex::TypeIndex>& unverified_classes =
         verifier_deps->GetUnverifiedClasses(*dex_file);
@@ -1973,20 +2046,21 @@ bool CompilerDriver::FastVerify(jobject jclass_loader,
       }
     }
   }
-  return true;
+  return dex_files_to_verify->empty();
 }
 
 void CompilerDriver::Verify(jobject jclass_loader,
                             const std::vector<const DexFile*>& dex_files,
                             TimingLogger* timings) {
-  if (FastVerify(jclass_loader, dex_files, timings)) {
+  std::vector<const DexFile*> dex_files_to_verify;
+  if (FastVerify(jclass_loader, dex_files, timings, &dex_files_to_verify)) {
     return;
   }
 
   // If there is no existing `verifier_deps` (because of non-existing vdex), or
-  // the existing `verifier_deps` is not valid anymore, create a new one for
-  // non boot image compilation. The verifier will need it to record the new dependencies.
-  // Then dex2oat can update the vdex file with these new dependencies.
+  // the existing `verifier_deps` is not valid anymore for some of the dex files, use
+  // it for non boot image compilation. The verifier will need it to record the new
+  // dependencies. Then dex2oat can update the vdex file with these new dependencies.
   if (!GetCompilerOptions().IsBootImage()) {
     // Dex2oat creates the verifier deps.
     // Create the main VerifierDeps, and set it to this thread.
@@ -2006,7 +2080,7 @@ void CompilerDriver::Verify(jobject jclass_loader,
   ThreadPool* verify_thread_pool =
       force_determinism ? single_thread_pool_.get() : parallel_thread_pool_.get();
   size_t verify_thread_count = force_determinism ? 1U : parallel_thread_count_;
-  for (const DexFile* dex_file : dex_files) {
+  for (const DexFile* dex_file : dex_files_to_verify) {
     CHECK(dex_file != nullptr);
     VerifyDexFile(jclass_loader,
                   *dex_file,
@@ -2140,6 +2214,77 @@ class VerifyClassVisitor : public CompilationVisitor {
   const verifier::HardFailLogMode log_level_;
 };
 
+// Return the class defs of `dex_file` ordered by the depth of their hierarchy within the dex file,
+// so that the superclass and the interfaces of a class defined in the same dex file are verified
+// before it. ClassLinker::VerifyClass verifies the superclass first, and a thread picking a class
+// whose superclass is being verified by another thread would otherwise block on the class lock.
+static std::vector<uint32_t> GetClassDefVerificationOrder(const DexFile& dex_file) {
+  static constexpr uint32_t kUnknownDepth = std::numeric_limits<uint32_t>::max();
+  static constexpr uint32_t kInProgress = kUnknownDepth - 1u;
+  const uint32_t num_class_defs = dex_file.NumClassDefs();
+  std::vector<uint32_t> type_to_class_def(dex_file.NumTypeIds(), dex::kDexNoIndex);
+  for (uint32_t class_def_index = 0; class_def_index != num_class_defs; ++class_def_index) {
+    const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
+    // Keep the first definition of duplicate classes, like the class linker.
+    if (type_to_class_def[class_def.class_idx_.index_] == dex::kDexNoIndex) {
+      type_to_class_def[class_def.class_idx_.index_] = class_def_index;
+    }
+  }
+  std::vector<uint32_t> depths(num_class_defs, kUnknownDepth);
+  std::vector<uint32_t> worklist;
+  auto for_each_parent = [&](uint32_t class_def_index, auto&& fn) {
+    const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
+    auto visit = [&](dex::TypeIndex type_idx) {
+      if (type_idx.IsValid() && type_idx.index_ < type_to_class_def.size()) {
+        uint32_t parent = type_to_class_def[type_idx.index_];
+        if (parent != dex::kDexNoIndex) {
+          fn(parent);
+        }
+      }
+    };
+    visit(class_def.superclass_idx_);
+    const DexFile::TypeList* interfaces = dex_file.GetInterfacesList(class_def);
+    if (interfaces != nullptr) {
+      for (size_t i = 0; i != interfaces->Size(); ++i) {
+        visit(interfaces->GetTypeItem(i).type_idx_);
+      }
+    }
+  };
+  for (uint32_t start = 0; start != num_class_defs; ++start) {
+    if (depths[start] != kUnknownDepth) {
+      continue;
+    }
+    // Compute the depths with an explicit stack, the hierarchies of a dex file can be deep.
+    depths[start] = kInProgress;
+    worklist.push_back(start);
+    while (!worklist.empty()) {
+      uint32_t current = worklist.back();
+      bool pushed = false;
+      uint32_t depth = 0u;
+      for_each_parent(current, [&](uint32_t parent) {
+        if (depths[parent] == kUnknownDepth) {
+          depths[parent] = kInProgress;
+          worklist.push_back(parent);
+          pushed = true;
+        } else if (depths[parent] != kInProgress) {
+          depth = std::max(depth, depths[parent] + 1u);
+        }
+        // A parent in progress is a circular hierarchy, which fails verification anyway.
+      });
+      if (!pushed) {
+        depths[current] = depth;
+        worklist.pop_back();
+      }
+    }
+  }
+  std::vector<uint32_t> order(num_class_defs);
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(),
+                   order.end(),
+                   [&depths](uint32_t lhs, uint32_t rhs) { return depths[lhs] < depths[rhs]; });
+  return order;
+}
+
 void CompilerDriver::VerifyDexFile(jobject class_loader,
                                    const DexFile& dex_file,
                                    const std::vector<const DexFile*>& dex_files,
@@ -2156,7 +2301,24 @@ void CompilerDriver::VerifyDexFile(jobject class_loader,
                               ? verifier::HardFailLogMode::kLogInternalFatal
                               : verifier::HardFailLogMode::kLogWarning;
   VerifyClassVisitor visitor(&context, log_level);
-  context.ForAll(0, dex_file.NumClassDefs(), &visitor, thread_count);
+  std::vector<uint32_t> class_def_order = GetClassDefVerificationOrder(dex_file);
+  // The threads take the classes from a shared index, which balances the load between them.
+  // The CPU time they spend measures how much of the wall time they are not blocked.
+  Atomic<uint64_t> cpu_time_ns(0u);
+  auto verify = [&visitor, &class_def_order, &cpu_time_ns](size_t index) {
+    uint64_t start_ns = ThreadCpuNanoTime();
+    visitor.Visit(class_def_order[index]);
+    cpu_time_ns.FetchAndAddRelaxed(ThreadCpuNanoTime() - start_ns);
+  };
+  uint64_t start_ns = NanoTime();
+  context.ForAllLambda(0, class_def_order.size(), verify, thread_count);
+  uint64_t wall_time_ns = NanoTime() - start_ns;
+  if (wall_time_ns != 0u) {
+    VLOG(compiler) << "Verified " << class_def_order.size() << " classes of "
+                   << dex_file.GetLocation() << " in " << PrettyDuration(wall_time_ns) << " on "
+                   << thread_count << " threads, parallel efficiency "
+                   << (100u * cpu_time_ns.LoadRelaxed() / (wall_time_ns * thread_count)) << "%";
+  }
 }
 
 class SetVerifiedClassVisitor : public CompilationVisitor {
@@ -2320,11 +2482,18 @@ class InitializeClassVisitor : public CompilationVisitor {
             CHECK(is_app_image);
             // The boot image case doesn't need to recursively initialize the dependencies with
             // special logic since the class linker already does this.
+            // With --initialize-app-image-classes, the class initializer of the class itself
+            // runs, in a transaction that only lets it access the static fields of the class.
+            const bool initialize_app_image_classes =
+                manager_->GetCompiler()->GetCompilerOptions().InitializeAppImageClasses();
             can_init_static_fields =
-                ClassLinker::kAppImageMayContainStrings &&
+                (ClassLinker::kAppImageMayContainStrings || initialize_app_image_classes) &&
                 !soa.Self()->IsExceptionPending() &&
                 is_superclass_initialized &&
-                NoClinitInDependency(klass, soa.Self(), &class_loader);
+                NoClinitInDependency(klass,
+                                     soa.Self(),
+                                     &class_loader,
+                                     /* allow_own_clinit */ initialize_app_image_classes);
             // TODO The checking for clinit can be removed since it's already
             // checked when init superclass. Currently keep it because it contains
             // processing of intern strings. Will be removed later when intern strings
@@ -2359,6 +2528,7 @@ class InitializeClassVisitor : public CompilationVisitor {
                 mirror::Throwable* exception = soa.Self()->GetException();
                 VLOG(compiler) << "Initialization of " << descriptor << " aborted because of "
                                << exception->Dump();
+                manager_->GetCompiler()->RecordClassInitializationAbort(exception);
                 std::ostream* file_log = manager_->GetCompiler()->
                     GetCompilerOptions().GetInitFailureOutput();
                 if (file_log != nullptr) {
@@ -2550,11 +2720,12 @@ class InitializeClassVisitor : public CompilationVisitor {
   // clinit appears in kalss's super class chain and interfaces.
   bool NoClinitInDependency(const Handle<mirror::Class>& klass,
                             Thread* self,
-                            Handle<mirror::ClassLoader>* class_loader)
+                            Handle<mirror::ClassLoader>* class_loader,
+                            bool allow_own_clinit = false)
       REQUIRES_SHARED(Locks::mutator_lock_) {
     ArtMethod* clinit =
         klass->FindClassInitializer(manager_->GetClassLinker()->GetImagePointerSize());
-    if (clinit != nullptr) {
+    if (clinit != nullptr && !allow_own_clinit) {
       VLOG(compiler) << klass->PrettyClass() << ' ' << clinit->PrettyMethod(true);
       return false;
     }
@@ -2687,6 +2858,52 @@ void CompilerDriver::InitializeClasses(jobject class_loader,
   }
 }
 
+// Order in which to compile the classes of `dex_file`: first the classes with a large method,
+// largest first, then the other classes in dex file order. Large methods take the longest
+// to compile, starting them early keeps them from being the tail of the parallel compilation.
+static std::vector<uint32_t> GetClassDefCompilationOrder(const CompilerDriver* driver,
+                                                         const DexFile& dex_file) {
+  const CompilerOptions& compiler_options = driver->GetCompilerOptions();
+  std::vector<std::pair<uint32_t, uint32_t>> large_classes;  // Largest method size, class def.
+  std::vector<uint32_t> other_classes;
+  const uint32_t num_class_defs = dex_file.NumClassDefs();
+  other_classes.reserve(num_class_defs);
+  for (uint32_t class_def_index = 0; class_def_index != num_class_defs; ++class_def_index) {
+    const uint8_t* class_data = dex_file.GetClassData(dex_file.GetClassDef(class_def_index));
+    uint32_t largest_method_size = 0u;
+    if (class_data != nullptr) {
+      ClassDataItemIterator it(dex_file, class_data);
+      it.SkipAllFields();
+      for (; it.HasNextMethod(); it.Next()) {
+        const DexFile::CodeItem* code_item = it.GetMethodCodeItem();
+        if (code_item != nullptr) {
+          largest_method_size = std::max(
+              largest_method_size,
+              CodeItemInstructionAccessor(dex_file, code_item).InsnsSizeInCodeUnits());
+        }
+      }
+    }
+    if (compiler_options.IsLargeMethod(largest_method_size)) {
+      large_classes.emplace_back(largest_method_size, class_def_index);
+    } else {
+      other_classes.push_back(class_def_index);
+    }
+  }
+  std::stable_sort(large_classes.begin(),
+                   large_classes.end(),
+                   [](const std::pair<uint32_t, uint32_t>& lhs,
+                      const std::pair<uint32_t, uint32_t>& rhs) {
+                     return lhs.first > rhs.first;
+                   });
+  std::vector<uint32_t> order;
+  order.reserve(num_class_defs);
+  for (const std::pair<uint32_t, uint32_t>& large_class : large_classes) {
+    order.push_back(large_class.second);
+  }
+  order.insert(order.end(), other_classes.begin(), other_classes.end());
+  return order;
+}
+
 template <typename CompileFn>
 static void CompileDexFile(CompilerDriver* driver,
                            jobject class_loader,
@@ -2704,9 +2921,11 @@ static void CompileDexFile(CompilerDriver* driver,
                                      &dex_file,
                                      dex_files,
                                      thread_pool);
+  std::vector<uint32_t> class_def_order = GetClassDefCompilationOrder(driver, dex_file);
 
-  auto compile = [&context, &compile_fn](size_t class_def_index) {
+  auto compile = [&context, &compile_fn, &class_def_order](size_t index) {
     ScopedTrace trace(__FUNCTION__);
+    const uint32_t class_def_index = class_def_order[index];
     const DexFile& dex_file = *context.GetDexFile();
     const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
     ClassLinker* class_linker = context.GetClassLinker();
@@ -2783,7 +3002,7 @@ static void CompileDexFile(CompilerDriver* driver,
     }
     DCHECK(!it.HasNext());
   };
-  context.ForAllLambda(0, dex_file.NumClassDefs(), compile, thread_count);
+  context.ForAllLambda(0, class_def_order.size(), compile, thread_count);
 }
 
 void CompilerDriver::Compile(jobject class_loader,
@@ -2812,6 +3031,9 @@ void CompilerDriver::Compile(jobject class_loader,
     const size_t arena_alloc = arena_pool->GetBytesAllocated();
     max_arena_alloc_ = std::max(arena_alloc, max_arena_alloc_);
     Runtime::Current()->ReclaimArenaPoolMemory();
+    // The compiled methods are not used again until they are written, so that the resident memory
+    // is bounded by the compilation of one dex file rather than by the whole app.
+    compiled_method_storage_.ReleaseSwapSpacePages();
   }
 
   if (dex_to_dex_compiler_.NumCodeItemsToQuicken(Thread::Current()) > 0u) {
@@ -2872,6 +3094,19 @@ ClassStatus CompilerDriver::GetClassStatus(const ClassReference& ref) const {
   return status;
 }
 
+void CompilerDriver::RecordClassInitializationAbort(ObjPtr<mirror::Throwable> exception) {
+  // The aborted transactions say what the unstarted runtime does not support, other exceptions
+  // are thrown by the class initializers and only their class matters.
+  std::string reason = exception->GetClass()->PrettyDescriptor();
+  if (exception->GetClass()->DescriptorEquals(Transaction::kAbortExceptionSignature)) {
+    ObjPtr<mirror::String> message = exception->GetDetailMessage();
+    if (message != nullptr) {
+      reason = message->ToModifiedUtf8();
+    }
+  }
+  stats_->ClassInitializationAborted(reason);
+}
+
 void CompilerDriver::RecordClassStatus(const ClassReference& ref, ClassStatus status) {
   switch (status) {
     case ClassStatus::kErrorResolved:
@@ -51,6 +51,7 @@ namespace art {
 namespace mirror {
 class Class;
 class DexCache;
+class Throwable;
 }  // namespace mirror
 
 namespace verifier {
@@ -322,6 +323,10 @@ class CompilerDriver {
   // Checks whether the provided method should be compiled, i.e., is in method_to_compile_.
   bool IsMethodToCompile(const MethodReference& method_ref) const;
 
+  // Checks whether the provided method is in the shard compiled by this driver, see
+  // CompilerOptions::GetCompileShardIndex().
+  bool IsMethodInCompileShard(const MethodReference& method_ref) const;
+
   // Checks whether profile guided compilation is enabled and if the method should be compiled
   // according to the profile file.
   bool ShouldCompileBasedOnProfile(const MethodReference& method_ref) const;
@@ -332,6 +337,11 @@ class CompilerDriver {
 
   void RecordClassStatus(const ClassReference& ref, ClassStatus status);
 
+  // Record the reason why a class initializer run at compile time was aborted with `exception`,
+  // for the statistics.
+  void RecordClassInitializationAbort(ObjPtr<mirror::Throwable> exception)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void RecordClassMethodVerificationBitmap(ClassReference ref, BitVector* methods_verification_bitmap);
 
   // Checks if the specified method has been verified without failures. Returns
@@ -417,11 +427,13 @@ class CompilerDriver {
                       TimingLogger* timings)
       REQUIRES(!Locks::mutator_lock_);
 
-  // Do fast verification through VerifierDeps if possible. Return whether
-  // verification was successful.
+  // Do fast verification through VerifierDeps if possible. The dex files
+  // whose dependencies are not valid anymore are returned in
+  // `dex_files_to_verify`. Return whether all the dex files were verified.
   bool FastVerify(jobject class_loader,
                   const std::vector<const DexFile*>& dex_files,
-                  TimingLogger* timings);
+                  TimingLogger* timings,
+                  /*out*/ std::vector<const DexFile*>* dex_files_to_verify);
 
   void Verify(jobject class_loader,
               const std::vector<const DexFile*>& dex_files,
@@ -16,12 +16,19 @@
 
 #include "compiler_options.h"
 
+#include <string.h>
+
 #include <fstream>
 
+#include "android-base/parseint.h"
 #include "android-base/stringprintf.h"
+#include "android-base/strings.h"
 
 #include "base/runtime_debug.h"
 #include "base/variant_map.h"
+#include "optimizing/induction_var_analysis.h"
+#include "optimizing/load_store_analysis.h"
+#include "optimizing/side_effects_analysis.h"
 #include "cmdline_parser.h"
 #include "compiler_options_map-inl.h"
 #include "runtime.h"
@@ -36,6 +43,7 @@ CompilerOptions::CompilerOptions()
       small_method_threshold_(kDefaultSmallMethodThreshold),
       tiny_method_threshold_(kDefaultTinyMethodThreshold),
       num_dex_methods_threshold_(kDefaultNumDexMethodsThreshold),
+      large_graph_threshold_(kDefaultLargeGraphThreshold),
       inline_max_code_units_(kUnsetInlineMaxCodeUnits),
       no_inline_from_(nullptr),
       boot_image_(false),
@@ -58,13 +66,37 @@ CompilerOptions::CompilerOptions()
       init_failure_output_(nullptr),
       dump_cfg_file_name_(""),
       dump_cfg_append_(false),
+      dump_pass_trace_file_name_(""),
       force_determinism_(false),
       deduplicate_code_(true),
       count_hotness_in_compiled_code_(false),
+      loop_nest_optimization_(false),
+      initialize_app_image_classes_(false),
+      suspend_check_iteration_budget_(kDefaultSuspendCheckIterationBudget),
+      compile_shard_index_(0u),
+      compile_shard_count_(1u),
       register_allocation_strategy_(RegisterAllocator::kRegisterAllocatorDefault),
       passes_to_run_(nullptr) {
 }
 
+CompilerOptions::MethodOptions::MethodOptions()
+    : disabled_passes(),
+      has_register_allocation_strategy(false),
+      register_allocation_strategy(RegisterAllocator::kRegisterAllocatorDefault),
+      inline_max_code_units(kUnsetInlineMaxCodeUnits) {
+}
+
+bool CompilerOptions::MethodOptions::IsPassDisabled(const std::string& pass_name) const {
+  // The name of a pass is that of its optimization, optionally followed by '$' and a suffix.
+  std::string optimization_name = pass_name.substr(0, pass_name.find('$'));
+  for (const std::string& disabled_pass : disabled_passes) {
+    if (disabled_pass == pass_name || disabled_pass == optimization_name) {
+      return true;
+    }
+  }
+  return false;
+}
+
 CompilerOptions::~CompilerOptions() {
   // The destructor looks empty but it destroys a PassManagerOptions object. We keep it here
   // because we don't want to include the PassManagerOptions definition from the header file.
@@ -96,19 +128,82 @@ bool CompilerOptions::ParseDumpInitFailures(const std::string& option, std::stri
   return true;
 }
 
-bool CompilerOptions::ParseRegisterAllocationStrategy(const std::string& option,
-                                                      std::string* error_msg) {
+static bool ParseStrategy(const std::string& option,
+                          RegisterAllocator::Strategy* strategy,
+                          std::string* error_msg) {
   if (option == "linear-scan") {
-    register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorLinearScan;
+    *strategy = RegisterAllocator::Strategy::kRegisterAllocatorLinearScan;
   } else if (option == "graph-color") {
-    register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorGraphColor;
+    *strategy = RegisterAllocator::Strategy::kRegisterAllocatorGraphColor;
+  } else if (option == "auto") {
+    *strategy = RegisterAllocator::Strategy::kRegisterAllocatorAuto;
+  } else {
+    *error_msg = "Unrecognized register allocation strategy. Try linear-scan, graph-color, "
+                 "or auto.";
+    return false;
+  }
+  return true;
+}
+
+bool CompilerOptions::ParseRegisterAllocationStrategy(const std::string& option,
+                                                      std::string* error_msg) {
+  return ParseStrategy(option, &register_allocation_strategy_, error_msg);
+}
+
+static bool ParseMethodOption(const std::string& option,
+                              CompilerOptions::MethodOptions* method_options,
+                              std::string* error_msg) {
+  using android::base::StartsWith;
+  static constexpr const char* kDisable = "disable=";
+  static constexpr const char* kRegisterAllocationStrategy = "register-allocation-strategy=";
+  static constexpr const char* kInlineMaxCodeUnits = "inline-max-code-units=";
+  if (StartsWith(option, kDisable)) {
+    std::string pass_name = option.substr(strlen(kDisable));
+    // The passes which use an analysis take it from the last instance run before them.
+    if (pass_name == SideEffectsAnalysis::kSideEffectsAnalysisPassName ||
+        pass_name == HInductionVarAnalysis::kInductionPassName ||
+        pass_name == LoadStoreAnalysis::kLoadStoreAnalysisPassName) {
+      *error_msg = "Cannot disable the analysis " + pass_name;
+      return false;
+    }
+    method_options->disabled_passes.push_back(pass_name);
+  } else if (StartsWith(option, kRegisterAllocationStrategy)) {
+    method_options->has_register_allocation_strategy = true;
+    return ParseStrategy(option.substr(strlen(kRegisterAllocationStrategy)),
+                         &method_options->register_allocation_strategy,
+                         error_msg);
+  } else if (StartsWith(option, kInlineMaxCodeUnits)) {
+    std::string code_units = option.substr(strlen(kInlineMaxCodeUnits));
+    if (!android::base::ParseUint(code_units.c_str(), &method_options->inline_max_code_units)) {
+      *error_msg = "Invalid number of code units in " + option;
+      return false;
+    }
   } else {
-    *error_msg = "Unrecognized register allocation strategy. Try linear-scan, or graph-color.";
+    *error_msg = "Unrecognized method option " + option;
     return false;
   }
   return true;
 }
 
+bool CompilerOptions::ParseMethodOptions(const std::vector<std::string>& lines,
+                                         std::string* error_msg) {
+  for (const std::string& line : lines) {
+    size_t space = line.find(' ');
+    if (space == std::string::npos || space == 0u || space + 1u == line.size()) {
+      *error_msg = "Expected options and a method in '" + line + "'";
+      return false;
+    }
+    MethodOptions* method_options = &method_options_[line.substr(space + 1u)];
+    for (const std::string& option : android::base::Split(line.substr(0u, space), ",")) {
+      if (!ParseMethodOption(option, method_options, error_msg)) {
+        *error_msg += " for '" + line + "'";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wframe-larger-than="
 
@@ -19,6 +19,7 @@
 
 #include <ostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "base/macros.h"
@@ -43,11 +44,28 @@ class CompilerOptions FINAL {
   static const size_t kDefaultSmallMethodThreshold = 60;
   static const size_t kDefaultTinyMethodThreshold = 20;
   static const size_t kDefaultNumDexMethodsThreshold = 900;
+  static const size_t kDefaultLargeGraphThreshold = 20000;
   static constexpr double kDefaultTopKProfileThreshold = 90.0;
   static const bool kDefaultGenerateDebugInfo = false;
   static const bool kDefaultGenerateMiniDebugInfo = false;
   static const size_t kDefaultInlineMaxCodeUnits = 32;
   static constexpr size_t kUnsetInlineMaxCodeUnits = -1;
+  static const size_t kDefaultSuspendCheckIterationBudget = 128;
+
+  // Options of a single method which override the global ones, see ParseMethodOptions().
+  struct MethodOptions {
+    MethodOptions();
+
+    // Whether the pass `pass_name` is disabled, either by its name or by the name of its
+    // optimization, e.g. "GVN$after_arch" is disabled by "GVN$after_arch" and by "GVN".
+    bool IsPassDisabled(const std::string& pass_name) const;
+
+    std::vector<std::string> disabled_passes;
+    bool has_register_allocation_strategy;
+    RegisterAllocator::Strategy register_allocation_strategy;
+    // kUnsetInlineMaxCodeUnits if not overridden.
+    size_t inline_max_code_units;
+  };
 
   CompilerOptions();
   ~CompilerOptions();
@@ -124,9 +142,26 @@ class CompilerOptions FINAL {
     return num_dex_methods_threshold_;
   }
 
+  size_t GetLargeGraphThreshold() const {
+    return large_graph_threshold_;
+  }
+
+  // Whether a graph of `num_instructions` HInstructions only gets the optimizations
+  // the code generator relies on.
+  bool IsLargeGraph(size_t num_instructions) const {
+    return num_instructions > large_graph_threshold_;
+  }
+
   size_t GetInlineMaxCodeUnits() const {
     return inline_max_code_units_;
   }
+  // The inlining limit of a method whose overridden options are `method_options`, if any.
+  size_t GetInlineMaxCodeUnits(const MethodOptions* method_options) const {
+    return (method_options != nullptr &&
+            method_options->inline_max_code_units != kUnsetInlineMaxCodeUnits)
+        ? method_options->inline_max_code_units
+        : inline_max_code_units_;
+  }
   void SetInlineMaxCodeUnits(size_t units) {
     inline_max_code_units_ = units;
   }
@@ -250,6 +285,10 @@ class CompilerOptions FINAL {
     return dump_cfg_append_;
   }
 
+  const std::string& GetDumpPassTraceFileName() const {
+    return dump_pass_trace_file_name_;
+  }
+
   bool IsForceDeterminism() const {
     return force_determinism_;
   }
@@ -266,6 +305,25 @@ class CompilerOptions FINAL {
     return passes_to_run_;
   }
 
+  bool HasMethodOptions() const {
+    return !method_options_.empty();
+  }
+
+  // Returns the options overridden for the method `pretty_method`, as formatted by
+  // PrettyMethod() with the signature, or null if there are none.
+  const MethodOptions* GetMethodOptions(const std::string& pretty_method) const {
+    auto it = method_options_.find(pretty_method);
+    return (it != method_options_.end()) ? &it->second : nullptr;
+  }
+
+  // Parse the options of single methods, one method per line. A line is a comma-separated
+  // list of options, a space, and the method as formatted by PrettyMethod() with the
+  // signature, e.g. "disable=TRE,inline-max-code-units=64 int Foo.bar(int)". The options are
+  //   disable=<pass>: do not run the pass, or the optimization, named <pass>;
+  //   register-allocation-strategy=<strategy>: as --register-allocation-strategy;
+  //   inline-max-code-units=<n>: as --inline-max-code-units.
+  bool ParseMethodOptions(const std::vector<std::string>& lines, std::string* error_msg);
+
   bool GetDumpTimings() const {
     return dump_timings_;
   }
@@ -278,6 +336,26 @@ class CompilerOptions FINAL {
     return count_hotness_in_compiled_code_;
   }
 
+  bool GetLoopNestOptimization() const {
+    return loop_nest_optimization_;
+  }
+
+  bool InitializeAppImageClasses() const {
+    return initialize_app_image_classes_;
+  }
+
+  size_t GetSuspendCheckIterationBudget() const {
+    return suspend_check_iteration_budget_;
+  }
+
+  size_t GetCompileShardIndex() const {
+    return compile_shard_index_;
+  }
+
+  size_t GetCompileShardCount() const {
+    return compile_shard_count_;
+  }
+
  private:
   bool ParseDumpInitFailures(const std::string& option, std::string* error_msg);
   void ParseDumpCfgPasses(const StringPiece& option, UsageFn Usage);
@@ -295,6 +373,7 @@ class CompilerOptions FINAL {
   size_t small_method_threshold_;
   size_t tiny_method_threshold_;
   size_t num_dex_methods_threshold_;
+  size_t large_graph_threshold_;
   size_t inline_max_code_units_;
 
   // Dex files from which we should not inline code.
@@ -333,6 +412,9 @@ class CompilerOptions FINAL {
   std::string dump_cfg_file_name_;
   bool dump_cfg_append_;
 
+  // Binary trace of the time, instruction count and arena use of each optimizing pass.
+  std::string dump_pass_trace_file_name_;
+
   // Whether the compiler should trade performance for determinism to guarantee exactly reproducible
   // outcomes.
   bool force_determinism_;
@@ -344,6 +426,22 @@ class CompilerOptions FINAL {
   // won't be atomic for performance reasons, so we accept races, just like in interpreter.
   bool count_hotness_in_compiled_code_;
 
+  // Whether to interchange loop nests that walk two-dimensional arrays by column.
+  bool loop_nest_optimization_;
+
+  // Whether the app image may contain the classes initialized at compile time, along with the
+  // objects that their class initializers reach.
+  bool initialize_app_image_classes_;
+
+  // Maximum number of loop iterations, including those of nested loops, that may run
+  // without polling for suspension. Zero keeps the poll of every loop.
+  size_t suspend_check_iteration_budget_;
+
+  // The methods are partitioned in `compile_shard_count_` shards, only the methods of the shard
+  // `compile_shard_index_` are compiled.
+  size_t compile_shard_index_;
+  size_t compile_shard_count_;
+
   RegisterAllocator::Strategy register_allocation_strategy_;
 
   // If not null, specifies optimization passes which will be run instead of defaults.
@@ -354,6 +452,11 @@ class CompilerOptions FINAL {
   // compiler-dependant behavior.
   const std::vector<std::string>* passes_to_run_;
 
+  // Options overridden for single methods, keyed by the pretty name of the method. The
+  // disabled passes are not checked either, except that the analyses other passes depend on
+  // cannot be disabled.
+  std::unordered_map<std::string, MethodOptions> method_options_;
+
   friend class Dex2Oat;
   friend class DexToDexDecompilerTest;
   friend class CommonCompilerTest;
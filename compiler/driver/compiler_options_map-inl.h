@@ -51,6 +51,7 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   map.AssignIfExists(Base::SmallMethodMaxThreshold, &options->small_method_threshold_);
   map.AssignIfExists(Base::TinyMethodMaxThreshold, &options->tiny_method_threshold_);
   map.AssignIfExists(Base::NumDexMethodsThreshold, &options->num_dex_methods_threshold_);
+  map.AssignIfExists(Base::LargeGraphThreshold, &options->large_graph_threshold_);
   map.AssignIfExists(Base::InlineMaxCodeUnitsThreshold, &options->inline_max_code_units_);
   map.AssignIfExists(Base::GenerateDebugInfo, &options->generate_debug_info_);
   map.AssignIfExists(Base::GenerateMiniDebugInfo, &options->generate_mini_debug_info_);
@@ -70,6 +71,7 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   if (map.Exists(Base::DumpCFGAppend)) {
     options->dump_cfg_append_ = true;
   }
+  map.AssignIfExists(Base::DumpPassTrace, &options->dump_pass_trace_file_name_);
   if (map.Exists(Base::RegisterAllocationStrategy)) {
     if (!options->ParseRegisterAllocationStrategy(*map.Get(Base::DumpInitFailures), error_msg)) {
       return false;
@@ -80,6 +82,22 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   if (map.Exists(Base::CountHotnessInCompiledCode)) {
     options->count_hotness_in_compiled_code_ = true;
   }
+  if (map.Exists(Base::LoopNestOptimization)) {
+    options->loop_nest_optimization_ = true;
+  }
+  if (map.Exists(Base::InitializeAppImageClasses)) {
+    options->initialize_app_image_classes_ = true;
+  }
+  map.AssignIfExists(Base::SuspendCheckIterationBudget, &options->suspend_check_iteration_budget_);
+  map.AssignIfExists(Base::CompileShardIndex, &options->compile_shard_index_);
+  map.AssignIfExists(Base::CompileShardCount, &options->compile_shard_count_);
+  if (options->compile_shard_count_ == 0u ||
+      options->compile_shard_index_ >= options->compile_shard_count_) {
+    *error_msg = android::base::StringPrintf("Invalid --compile-shard-index=%zu for %zu shards",
+                                             options->compile_shard_index_,
+                                             options->compile_shard_count_);
+    return false;
+  }
 
   if (map.Exists(Base::DumpTimings)) {
     options->dump_timings_ = true;
@@ -120,6 +138,9 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
       .Define("--num-dex-methods=_")
           .template WithType<unsigned int>()
           .IntoKey(Map::NumDexMethodsThreshold)
+      .Define("--large-graph-max=_")
+          .template WithType<unsigned int>()
+          .IntoKey(Map::LargeGraphThreshold)
       .Define("--inline-max-code-units=_")
           .template WithType<unsigned int>()
           .IntoKey(Map::InlineMaxCodeUnitsThreshold)
@@ -143,6 +164,23 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
       .Define({"--count-hotness-in-compiled-code"})
           .IntoKey(Map::CountHotnessInCompiledCode)
 
+      .Define({"--loop-nest-optimization"})
+          .IntoKey(Map::LoopNestOptimization)
+
+      .Define({"--initialize-app-image-classes"})
+          .IntoKey(Map::InitializeAppImageClasses)
+
+      .Define("--suspend-check-iteration-budget=_")
+          .template WithType<unsigned int>()
+          .IntoKey(Map::SuspendCheckIterationBudget)
+
+      .Define("--compile-shard-index=_")
+          .template WithType<unsigned int>()
+          .IntoKey(Map::CompileShardIndex)
+      .Define("--compile-shard-count=_")
+          .template WithType<unsigned int>()
+          .IntoKey(Map::CompileShardCount)
+
       .Define({"--dump-timings"})
           .IntoKey(Map::DumpTimings)
 
@@ -172,6 +210,9 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
           .IntoKey(Map::DumpCFG)
       .Define("--dump-cfg-append")
           .IntoKey(Map::DumpCFGAppend)
+      .Define("--dump-pass-trace=_")
+          .template WithType<std::string>()
+          .IntoKey(Map::DumpPassTrace)
 
       .Define("--register-allocation-strategy=_")
           .template WithType<std::string>()
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compiler_options.h"
+
+#include <gtest/gtest.h>
+
+namespace art {
+
+TEST(CompilerOptions, ParseMethodOptions) {
+  CompilerOptions compiler_options;
+  EXPECT_FALSE(compiler_options.HasMethodOptions());
+
+  std::string error_msg;
+  ASSERT_TRUE(compiler_options.ParseMethodOptions(
+      {
+        "disable=TRE,disable=GVN$after_arch,inline-max-code-units=64 int Foo.bar(int, long)",
+        "register-allocation-strategy=graph-color void Foo.baz()",
+      },
+      &error_msg)) << error_msg;
+  EXPECT_TRUE(compiler_options.HasMethodOptions());
+  EXPECT_TRUE(compiler_options.GetMethodOptions("void Foo.qux()") == nullptr);
+
+  const CompilerOptions::MethodOptions* bar =
+      compiler_options.GetMethodOptions("int Foo.bar(int, long)");
+  ASSERT_TRUE(bar != nullptr);
+  EXPECT_TRUE(bar->IsPassDisabled("TRE"));
+  EXPECT_TRUE(bar->IsPassDisabled("TRE$after_inlining"));
+  EXPECT_TRUE(bar->IsPassDisabled("GVN$after_arch"));
+  EXPECT_FALSE(bar->IsPassDisabled("GVN"));
+  EXPECT_FALSE(bar->IsPassDisabled("BCE"));
+  EXPECT_FALSE(bar->has_register_allocation_strategy);
+  EXPECT_EQ(64u, compiler_options.GetInlineMaxCodeUnits(bar));
+
+  const CompilerOptions::MethodOptions* baz = compiler_options.GetMethodOptions("void Foo.baz()");
+  ASSERT_TRUE(baz != nullptr);
+  EXPECT_FALSE(baz->IsPassDisabled("TRE"));
+  EXPECT_TRUE(baz->has_register_allocation_strategy);
+  EXPECT_EQ(RegisterAllocator::kRegisterAllocatorGraphColor, baz->register_allocation_strategy);
+  EXPECT_EQ(compiler_options.GetInlineMaxCodeUnits(), compiler_options.GetInlineMaxCodeUnits(baz));
+}
+
+TEST(CompilerOptions, ParseInvalidMethodOptions) {
+  std::string error_msg;
+  EXPECT_FALSE(CompilerOptions().ParseMethodOptions({"disable=TRE"}, &error_msg));
+  EXPECT_FALSE(CompilerOptions().ParseMethodOptions({"unroll void Foo.baz()"}, &error_msg));
+  EXPECT_FALSE(CompilerOptions().ParseMethodOptions(
+      {"inline-max-code-units=many void Foo.baz()"}, &error_msg));
+  EXPECT_FALSE(CompilerOptions().ParseMethodOptions(
+      {"register-allocation-strategy=best void Foo.baz()"}, &error_msg));
+  // The passes which use an analysis expect it to have run.
+  EXPECT_FALSE(CompilerOptions().ParseMethodOptions(
+      {"disable=induction_var_analysis void Foo.baz()"}, &error_msg));
+}
+
+}  // namespace art
@@ -38,6 +38,7 @@
 #include "object_lock.h"
 #include "optimizing/register_allocator.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 
 namespace art {
 namespace jit {
@@ -61,11 +62,11 @@ extern "C" void jit_unload(void* handle) {
 }
 
 extern "C" bool jit_compile_method(
-    void* handle, ArtMethod* method, Thread* self, bool osr)
+    void* handle, ArtMethod* method, Thread* self, bool osr, bool baseline)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   auto* jit_compiler = reinterpret_cast<JitCompiler*>(handle);
   DCHECK(jit_compiler != nullptr);
-  return jit_compiler->CompileMethod(self, method, osr);
+  return jit_compiler->CompileMethod(self, method, osr, baseline);
 }
 
 extern "C" void jit_types_loaded(void* handle, mirror::Class** types, size_t count)
@@ -134,6 +135,17 @@ JitCompiler::JitCompiler() {
   }
   if (instruction_set_features_ == nullptr) {
     instruction_set_features_ = InstructionSetFeatures::FromCppDefines();
+    // JIT code only runs on this CPU, so on x86 let it use the extensions the CPU has beyond
+    // the baseline the runtime was built for, e.g. AVX2 vector loops when the boot image and
+    // the apps were compiled ahead of time for SSE4.1.
+    if (instruction_set == InstructionSet::kX86 || instruction_set == InstructionSet::kX86_64) {
+      std::unique_ptr<const InstructionSetFeatures> cpu_features =
+          InstructionSetFeatures::FromCpuInfo();
+      if (cpu_features->HasAtLeast(instruction_set_features_.get())) {
+        VLOG(compiler) << "JIT instruction set features " << cpu_features->GetFeatureString();
+        instruction_set_features_ = std::move(cpu_features);
+      }
+    }
   }
   compiler_driver_.reset(new CompilerDriver(
       compiler_options_.get(),
@@ -166,7 +178,7 @@ JitCompiler::~JitCompiler() {
   }
 }
 
-bool JitCompiler::CompileMethod(Thread* self, ArtMethod* method, bool osr) {
+bool JitCompiler::CompileMethod(Thread* self, ArtMethod* method, bool osr, bool baseline) {
   SCOPED_TRACE << "JIT compiling " << method->PrettyMethod();
 
   DCHECK(!method->IsProxyMethod());
@@ -183,7 +195,15 @@ bool JitCompiler::CompileMethod(Thread* self, ArtMethod* method, bool osr) {
     TimingLogger::ScopedTiming t2("Compiling", &logger);
     JitCodeCache* const code_cache = runtime->GetJit()->GetCodeCache();
     success = compiler_driver_->GetCompiler()->JitCompile(
-        self, code_cache, method, osr, jit_logger_.get());
+        self, code_cache, method, osr, baseline, jit_logger_.get());
+  }
+
+  // Write the jitdump records of the batch once no more compilations are queued.
+  if (jit_logger_ != nullptr) {
+    ThreadPool* thread_pool = runtime->GetJit()->GetThreadPool();
+    if (thread_pool == nullptr || thread_pool->GetTaskCount(self) == 0u) {
+      jit_logger_->Flush();
+    }
   }
 
   // Trim maps to reduce memory usage.
@@ -16,6 +16,9 @@
 
 #include "jit_logger.h"
 
+#include <algorithm>
+#include <tuple>
+
 #include "arch/instruction_set.h"
 #include "art_method-inl.h"
 #include "base/time_utils.h"
@@ -24,6 +27,9 @@
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "oat_file-inl.h"
+#include "oat_quick_method_header.h"
+#include "stack_map.h"
+#include "thread-current-inl.h"
 
 namespace art {
 namespace jit {
@@ -50,25 +56,22 @@ void JitLogger::OpenPerfMapLog() {
   }
 }
 
-void JitLogger::WritePerfMapLog(const void* ptr, size_t code_size, ArtMethod* method) {
+void JitLogger::WritePerfMapRecord(const void* code,
+                                   size_t code_size,
+                                   const std::string& method_name) {
   if (perf_file_ != nullptr) {
-    std::string method_name = method->PrettyMethod();
-
     std::ostringstream stream;
     stream << std::hex
-           << reinterpret_cast<uintptr_t>(ptr)
+           << reinterpret_cast<uintptr_t>(code)
            << " "
            << code_size
            << " "
            << method_name
            << std::endl;
     std::string str = stream.str();
-    bool res = perf_file_->WriteFully(str.c_str(), str.size());
-    if (!res) {
+    if (!perf_file_->WriteFully(str.c_str(), str.size())) {
       LOG(WARNING) << "Failed to write jitted method info in log: write failure.";
     }
-  } else {
-    LOG(WARNING) << "Failed to write jitted method info in log: log file doesn't exist.";
   }
 }
 
@@ -172,7 +175,8 @@ struct PerfJitCodeLoad : PerfJitBase {
 };
 
 // This structure is for source line/column mapping.
-// Currently this feature is not implemented in ART JIT yet.
+// In ART JIT, there is one entry for each safepoint of the jitted code, and the line is that of
+// the innermost method inlined at the safepoint.
 struct PerfJitDebugEntry {
   uint64_t address_;      // Code address which maps to the line/column in source.
   uint32_t line_number_;  // Source line number starting at 1.
@@ -182,13 +186,28 @@ struct PerfJitDebugEntry {
 
 // Logs debug line information (kDebugInfo).
 // This structure is for source line/column mapping.
-// Currently this feature is not implemented in ART JIT yet.
+// The 'perf inject' tool expects it before the kLoad event of the same code.
 struct PerfJitCodeDebugInfo : PerfJitBase {
   uint64_t address_;              // Starting code address which the debug info describes.
   uint64_t entry_count_;          // How many instances of PerfJitDebugEntry.
   PerfJitDebugEntry entries_[0];  // Followed by entry_count_ instances of PerfJitDebugEntry.
 };
 
+// The 'perf inject' tool puts the code of a method after the ELF header of its jitted-TID-CODEID.so
+// file, and expects the addresses of the debug entries to be offset by the size of that header.
+static constexpr uint64_t kPerfInjectElfHeaderSize = 0x40;
+
+template <typename T>
+static void AppendBytes(const T* data, size_t size, std::vector<uint8_t>* buffer) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  buffer->insert(buffer->end(), bytes, bytes + size);
+}
+
+template <typename T>
+static void AppendValue(const T& value, std::vector<uint8_t>* buffer) {
+  AppendBytes(&value, sizeof(value), buffer);
+}
+
 static uint32_t GetElfMach() {
 #if defined(__arm__)
   static const uint32_t kElfMachARM = 0x28;
@@ -225,8 +244,60 @@ void JitLogger::CloseMarkerFile() {
   }
 }
 
-void JitLogger::WriteJitDumpDebugInfo() {
-  // In the future, we can add java source file line/column mapping here.
+void JitLogger::EncodeJitDumpDebugEntries(const OatQuickMethodHeader* method_header,
+                                          ArtMethod* method,
+                                          /* out */ std::vector<uint8_t>* entries,
+                                          /* out */ uint64_t* entry_count) {
+  if (!method_header->IsOptimized()) {
+    // JNI stubs have no stack maps.
+    return;
+  }
+  CodeInfo code_info = method_header->GetOptimizedCodeInfo();
+  CodeInfoEncoding encoding = code_info.ExtractEncoding();
+  // (native pc offset, line, source file) of each safepoint.
+  std::vector<std::tuple<uint32_t, int32_t, const char*>> lines;
+  for (size_t i = 0, e = code_info.GetNumberOfStackMaps(encoding); i != e; ++i) {
+    StackMap stack_map = code_info.GetStackMapAt(i, encoding);
+    ArtMethod* frame_method = method;
+    uint32_t dex_pc = stack_map.GetDexPc(encoding.stack_map.encoding);
+    if (stack_map.HasInlineInfo(encoding.stack_map.encoding)) {
+      InlineInfo inline_info = code_info.GetInlineInfoOf(stack_map, encoding);
+      uint32_t depth = inline_info.GetDepth(encoding.inline_info.encoding) - 1u;
+      // The JIT always encodes the inlined methods, see EncodeArtMethodInInlineInfo.
+      if (!inline_info.EncodesArtMethodAtDepth(encoding.inline_info.encoding, depth)) {
+        continue;
+      }
+      frame_method = inline_info.GetArtMethodAtDepth(encoding.inline_info.encoding, depth);
+      dex_pc = inline_info.GetDexPcAtDepth(encoding.inline_info.encoding, depth);
+    }
+    int32_t line = frame_method->GetLineNumFromDexPC(dex_pc);
+    const char* source_file = frame_method->GetDeclaringClassSourceFile();
+    if (line <= 0 || source_file == nullptr) {
+      continue;
+    }
+    lines.emplace_back(stack_map.GetNativePcOffset(encoding.stack_map.encoding, kRuntimeISA),
+                       line,
+                       source_file);
+  }
+  std::sort(lines.begin(), lines.end());
+  lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+
+  uint64_t code_address = reinterpret_cast<uint64_t>(method_header->GetCode());
+  const char* previous_source_file = nullptr;
+  for (const auto& entry : lines) {
+    AppendValue<uint64_t>(code_address + std::get<0>(entry) + kPerfInjectElfHeaderSize, entries);
+    AppendValue<uint32_t>(static_cast<uint32_t>(std::get<1>(entry)), entries);
+    AppendValue<uint32_t>(0u, entries);  // Column.
+    const char* source_file = std::get<2>(entry);
+    if (previous_source_file != nullptr && strcmp(source_file, previous_source_file) == 0) {
+      static const char kSameName[] = "\xff";
+      AppendBytes(kSameName, sizeof(kSameName), entries);
+    } else {
+      AppendBytes(source_file, strlen(source_file) + 1, entries);
+    }
+    previous_source_file = source_file;
+  }
+  *entry_count = lines.size();
 }
 
 void JitLogger::WriteJitDumpHeader() {
@@ -267,33 +338,47 @@ void JitLogger::OpenJitDumpLog() {
   WriteJitDumpHeader();
 }
 
-void JitLogger::WriteJitDumpLog(const void* ptr, size_t code_size, ArtMethod* method) {
+void JitLogger::AppendJitDumpRecords(const void* code,
+                                     size_t code_size,
+                                     const std::string& method_name,
+                                     const std::vector<uint8_t>& debug_entries,
+                                     uint64_t debug_entry_count) {
   if (jit_dump_file_ != nullptr) {
-    std::string method_name = method->PrettyMethod();
+    uint64_t time_stamp = art::NanoTime();  // CLOCK_MONOTONIC clock is required.
+
+    if (debug_entry_count != 0u) {
+      PerfJitBase debug_info;
+      std::memset(&debug_info, 0, sizeof(debug_info));
+      debug_info.event_ = PerfJitBase::kDebugInfo;
+      debug_info.size_ = sizeof(PerfJitCodeDebugInfo) + debug_entries.size();
+      debug_info.time_stamp_ = time_stamp;
+      static_assert(sizeof(PerfJitCodeDebugInfo) == sizeof(PerfJitBase) + 2 * sizeof(uint64_t),
+                    "Unexpected PerfJitCodeDebugInfo layout");
+      AppendValue(debug_info, &jit_dump_buffer_);
+      AppendValue<uint64_t>(reinterpret_cast<uint64_t>(code), &jit_dump_buffer_);
+      AppendValue<uint64_t>(debug_entry_count, &jit_dump_buffer_);
+      AppendBytes(debug_entries.data(), debug_entries.size(), &jit_dump_buffer_);
+    }
 
     PerfJitCodeLoad jit_code;
     std::memset(&jit_code, 0, sizeof(jit_code));
     jit_code.event_ = PerfJitCodeLoad::kLoad;
     jit_code.size_ = sizeof(jit_code) + method_name.size() + 1 + code_size;
-    jit_code.time_stamp_ = art::NanoTime();    // CLOCK_MONOTONIC clock is required.
+    jit_code.time_stamp_ = time_stamp;
     jit_code.process_id_ = static_cast<uint32_t>(getpid());
     jit_code.thread_id_ = static_cast<uint32_t>(art::GetTid());
     jit_code.vma_ = 0x0;
-    jit_code.code_address_ = reinterpret_cast<uint64_t>(ptr);
+    jit_code.code_address_ = reinterpret_cast<uint64_t>(code);
     jit_code.code_size_ = code_size;
     jit_code.code_id_ = code_index_++;
 
-    // Write one complete jitted method info, including:
+    // Append one complete jitted method info, including:
     // - PerfJitCodeLoad structure
     // - Method name
     // - Complete generated code of this method
-    //
-    // Use UNUSED() here to avoid compiler warnings.
-    UNUSED(jit_dump_file_->WriteFully(reinterpret_cast<const char*>(&jit_code), sizeof(jit_code)));
-    UNUSED(jit_dump_file_->WriteFully(method_name.c_str(), method_name.size() + 1));
-    UNUSED(jit_dump_file_->WriteFully(ptr, code_size));
-
-    WriteJitDumpDebugInfo();
+    AppendValue(jit_code, &jit_dump_buffer_);
+    AppendBytes(method_name.c_str(), method_name.size() + 1, &jit_dump_buffer_);
+    AppendBytes(reinterpret_cast<const uint8_t*>(code), code_size, &jit_dump_buffer_);
   }
 }
 
@@ -305,5 +390,45 @@ void JitLogger::CloseJitDumpLog() {
   }
 }
 
+void JitLogger::WriteLog(const OatQuickMethodHeader* method_header, ArtMethod* method) {
+  const void* code = method_header->GetCode();
+  size_t code_size = method_header->GetCodeSize();
+  // Do the expensive work before taking the lock, so that the JIT threads only contend for
+  // the writes.
+  std::string method_name = method->PrettyMethod();
+  std::vector<uint8_t> debug_entries;
+  uint64_t debug_entry_count = 0u;
+  if (jit_dump_file_ != nullptr) {
+    EncodeJitDumpDebugEntries(method_header, method, &debug_entries, &debug_entry_count);
+  }
+
+  MutexLock mu(Thread::Current(), lock_);
+  WritePerfMapRecord(code, code_size, method_name);
+  AppendJitDumpRecords(code, code_size, method_name, debug_entries, debug_entry_count);
+  if (jit_dump_buffer_.size() >= kFlushThreshold) {
+    FlushBuffer();
+  }
+}
+
+void JitLogger::FlushBuffer() {
+  if (jit_dump_file_ != nullptr && !jit_dump_buffer_.empty()) {
+    if (!jit_dump_file_->WriteFully(jit_dump_buffer_.data(), jit_dump_buffer_.size())) {
+      LOG(WARNING) << "Failed to write profiling log. The 'perf inject' tool will not work.";
+    }
+    jit_dump_buffer_.clear();
+  }
+}
+
+void JitLogger::Flush() {
+  MutexLock mu(Thread::Current(), lock_);
+  FlushBuffer();
+}
+
+void JitLogger::CloseLog() {
+  Flush();
+  ClosePerfMapLog();
+  CloseJitDumpLog();
+}
+
 }  // namespace jit
 }  // namespace art
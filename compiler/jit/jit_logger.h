@@ -17,6 +17,10 @@
 #ifndef ART_COMPILER_JIT_JIT_LOGGER_H_
 #define ART_COMPILER_JIT_JIT_LOGGER_H_
 
+#include <string>
+#include <vector>
+
+#include "base/globals.h"
 #include "base/mutex.h"
 #include "compiled_method.h"
 #include "driver/compiler_driver.h"
@@ -25,6 +29,7 @@
 namespace art {
 
 class ArtMethod;
+class OatQuickMethodHeader;
 
 namespace jit {
 
@@ -84,48 +89,75 @@ namespace jit {
 //         Source code can also be displayed if the ELF file has debug symbols.
 //       - Make sure above small ELF files are available for 'perf annotate' tool to access,
 //         so that jitted code can be displayed in assembly view.
+//       - The source lines of the jitted code, including those of the inlined methods, are
+//         taken from the stack maps, so they are only known at the safepoints.
+//
+// The lines of perf-PID.map are written as soon as the code is committed, so that samples of a
+// runtime that aborts can still be mapped. The larger records of jit-PID.dump are appended to an
+// in-memory buffer, which is written to the file once it holds kFlushThreshold bytes, at the end
+// of each batch of compilations, see Flush(), and when the log is closed.
 //
 class JitLogger {
  public:
-    JitLogger() : code_index_(0), marker_address_(nullptr) {}
+    JitLogger()
+        : lock_("JIT logger lock", kGenericBottomLock),
+          code_index_(0),
+          marker_address_(nullptr) {}
 
     void OpenLog() {
       OpenPerfMapLog();
       OpenJitDumpLog();
     }
 
-    void WriteLog(const void* ptr, size_t code_size, ArtMethod* method)
-        REQUIRES_SHARED(Locks::mutator_lock_) {
-      WritePerfMapLog(ptr, code_size, method);
-      WriteJitDumpLog(ptr, code_size, method);
-    }
+    // Log the code of `method_header`, just committed to the code cache for `method`. May be
+    // called concurrently by the JIT threads.
+    void WriteLog(const OatQuickMethodHeader* method_header, ArtMethod* method)
+        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
 
-    void CloseLog() {
-      ClosePerfMapLog();
-      CloseJitDumpLog();
-    }
+    // Write the buffered records to the files. Called by the JIT once it has no more methods
+    // queued for compilation.
+    void Flush() REQUIRES(!lock_);
+
+    void CloseLog() REQUIRES(!lock_);
 
  private:
+    static constexpr size_t kFlushThreshold = 64 * KB;
+
     // For perf-map profiling
     void OpenPerfMapLog();
-    void WritePerfMapLog(const void* ptr, size_t code_size, ArtMethod* method)
-        REQUIRES_SHARED(Locks::mutator_lock_);
+    void WritePerfMapRecord(const void* code, size_t code_size, const std::string& method_name)
+        REQUIRES(lock_);
     void ClosePerfMapLog();
 
     // For perf-inject profiling
     void OpenJitDumpLog();
-    void WriteJitDumpLog(const void* ptr, size_t code_size, ArtMethod* method)
-        REQUIRES_SHARED(Locks::mutator_lock_);
+    void AppendJitDumpRecords(const void* code,
+                              size_t code_size,
+                              const std::string& method_name,
+                              const std::vector<uint8_t>& debug_entries,
+                              uint64_t debug_entry_count)
+        REQUIRES(lock_);
     void CloseJitDumpLog();
 
     void OpenMarkerFile();
     void CloseMarkerFile();
     void WriteJitDumpHeader();
-    void WriteJitDumpDebugInfo();
+    // Encode the line table of the code of `method_header` as PerfJitDebugEntry instances.
+    static void EncodeJitDumpDebugEntries(const OatQuickMethodHeader* method_header,
+                                          ArtMethod* method,
+                                          /* out */ std::vector<uint8_t>* entries,
+                                          /* out */ uint64_t* entry_count)
+        REQUIRES_SHARED(Locks::mutator_lock_);
+
+    void FlushBuffer() REQUIRES(lock_);
 
     std::unique_ptr<File> perf_file_;
     std::unique_ptr<File> jit_dump_file_;
-    uint64_t code_index_;
+
+    // Serializes the JIT threads writing to the files and appending to the buffer.
+    Mutex lock_;
+    std::vector<uint8_t> jit_dump_buffer_ GUARDED_BY(lock_);
+    uint64_t code_index_ GUARDED_BY(lock_);
     void* marker_address_;
 
     DISALLOW_COPY_AND_ASSIGN(JitLogger);
@@ -21,6 +21,7 @@
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 #include "induction_var_range.h"
+#include "load_store_analysis.h"
 #include "nodes.h"
 #include "side_effects_analysis.h"
 
@@ -509,7 +510,8 @@ class BCEVisitor : public HGraphVisitor {
 
   BCEVisitor(HGraph* graph,
              const SideEffectsAnalysis& side_effects,
-             HInductionVarAnalysis* induction_analysis)
+             HInductionVarAnalysis* induction_analysis,
+             const LoadStoreAnalysis* lsa)
       : HGraphVisitor(graph),
         allocator_(graph->GetArenaStack()),
         maps_(graph->GetBlocks().size(),
@@ -528,6 +530,7 @@ class BCEVisitor : public HGraphVisitor {
         initial_block_size_(graph->GetBlocks().size()),
         side_effects_(side_effects),
         induction_range_(induction_analysis),
+        lsa_(lsa),
         next_(nullptr) {}
 
   void VisitBasicBlock(HBasicBlock* block) OVERRIDE {
@@ -1508,6 +1511,8 @@ class BCEVisitor : public HGraphVisitor {
       //       if (min_lower >  max_lower) deoptimize;   unless min_c == max_c
       //       if (max_lower >  max_upper) deoptimize;
       //       if (max_upper >= a.length ) deoptimize;
+      ScopedArenaVector<HInstruction*> conditions(
+          allocator_.Adapter(kArenaAllocBoundsCheckElimination));
       if (base == nullptr) {
         // Constants only.
         DCHECK_GE(min_c, 0);
@@ -1518,8 +1523,7 @@ class BCEVisitor : public HGraphVisitor {
         if (min_c != max_c) {
           DCHECK(min_lower == nullptr && min_upper != nullptr &&
                  max_lower == nullptr && max_upper != nullptr);
-          InsertDeoptInLoop(
-              loop, block, new (GetGraph()->GetAllocator()) HAbove(min_upper, max_upper));
+          conditions.push_back(new (GetGraph()->GetAllocator()) HAbove(min_upper, max_upper));
         } else {
           DCHECK(min_lower == nullptr && min_upper == nullptr &&
                  max_lower == nullptr && max_upper != nullptr);
@@ -1529,22 +1533,128 @@ class BCEVisitor : public HGraphVisitor {
         if (min_c != max_c) {
           DCHECK(min_lower != nullptr && min_upper != nullptr &&
                  max_lower != nullptr && max_upper != nullptr);
-          InsertDeoptInLoop(
-              loop, block, new (GetGraph()->GetAllocator()) HAbove(min_lower, max_lower));
+          conditions.push_back(new (GetGraph()->GetAllocator()) HAbove(min_lower, max_lower));
         } else {
           DCHECK(min_lower == nullptr && min_upper == nullptr &&
                  max_lower != nullptr && max_upper != nullptr);
         }
-        InsertDeoptInLoop(
-            loop, block, new (GetGraph()->GetAllocator()) HAbove(max_lower, max_upper));
+        conditions.push_back(new (GetGraph()->GetAllocator()) HAbove(max_lower, max_upper));
+      }
+      conditions.push_back(
+          new (GetGraph()->GetAllocator()) HAboveOrEqual(max_upper, array_length));
+      // Guard the whole loop nest at once if the tests do not depend on outer loops.
+      HLoopInformation* target = loop;
+      if (block == loop->GetPreHeader()) {
+        target = HoistTestsToOuterLoop(loop, bounds_check, conditions);
+        if (target != loop) {
+          block = GetPreHeader(target, bounds_check);
+        }
+      }
+      for (HInstruction* condition : conditions) {
+        InsertDeoptInLoop(target, block, condition);
       }
-      InsertDeoptInLoop(
-          loop, block, new (GetGraph()->GetAllocator()) HAboveOrEqual(max_upper, array_length));
     } else {
       // TODO: if rejected, avoid doing this again for subsequent instructions in this set?
     }
   }
 
+  /**
+   * Returns whether `instruction`, used by the deoptimization tests placed in `block`,
+   * can be evaluated in front of `outer` instead. If so, adds the instructions of `block`
+   * that need to move along to `moved`.
+   */
+  bool IsInvariantForTests(HInstruction* instruction,
+                           HLoopInformation* outer,
+                           HBasicBlock* block,
+                           ScopedArenaSet<HInstruction*>* moved) {
+    if (outer->IsDefinedOutOfTheLoop(instruction) || moved->find(instruction) != moved->end()) {
+      return true;
+    }
+    // Only the side-effect free code generated for the tests in `block` may move.
+    if (instruction->GetBlock() != block ||
+        instruction->IsPhi() ||
+        instruction->HasEnvironment() ||
+        instruction->CanThrow() ||
+        instruction->HasSideEffects() ||
+        instruction->GetSideEffects().HasDependencies() ||
+        (instruction->IsArrayLength() && instruction->InputAt(0)->CanBeNull())) {
+      return false;
+    }
+    for (HInstruction* input : instruction->GetInputs()) {
+      if (!IsInvariantForTests(input, outer, block, moved)) {
+        return false;
+      }
+    }
+    moved->insert(instruction);
+    return true;
+  }
+
+  /**
+   * Moves the deoptimization tests on `conditions` of `loop` to the outermost enclosing
+   * loop entered in front of `loop` on every iteration, in which the tested values are
+   * invariant, so that a loop nest is guarded by a single set of tests. Returns the loop
+   * in front of which the tests must be placed. The preheader of `loop` must be executed on
+   * every iteration of that loop, so every loop in between must take its first iteration.
+   */
+  HLoopInformation* HoistTestsToOuterLoop(HLoopInformation* loop,
+                                          HInstruction* context,
+                                          const ScopedArenaVector<HInstruction*>& conditions) {
+    HBasicBlock* block = loop->GetPreHeader();
+    HLoopInformation* target = loop;
+    bool needs_taken_test = false;
+    ScopedArenaSet<HInstruction*> moved(allocator_.Adapter(kArenaAllocBoundsCheckElimination));
+    for (HLoopInformation* outer = block->GetLoopInformation();
+         outer != nullptr && DynamicBCESeemsProfitable(outer, target->GetPreHeader());
+         outer = outer->GetPreHeader()->GetLoopInformation()) {
+      // The preheader of `target` dominates all back edges of `outer`, but if `target` may
+      // skip all its iterations, the preheader of `loop` is not reached on every iteration.
+      if (needs_taken_test) {
+        break;
+      }
+      // The outer loop must be controlled by an induction, for the taken-test.
+      HInstruction* control = outer->GetHeader()->GetLastInstruction();
+      if (!control->IsIf() || !control->InputAt(0)->IsCondition()) {
+        break;
+      }
+      HInstruction* phi = control->InputAt(0)->InputAt(0);
+      bool needs_finite_test = false;
+      bool outer_needs_taken_test = false;
+      if (!phi->IsPhi() ||
+          phi->GetBlock() != outer->GetHeader() ||
+          !induction_range_.CanGenerateRange(
+              target->GetPreHeader()->GetLastInstruction(),
+              phi,
+              &needs_finite_test,
+              &outer_needs_taken_test)) {
+        break;
+      }
+      ScopedArenaSet<HInstruction*> outer_moved(moved);
+      bool invariant = true;
+      for (HInstruction* condition : conditions) {
+        for (HInstruction* input : condition->GetInputs()) {
+          invariant = invariant && IsInvariantForTests(input, outer, block, &outer_moved);
+        }
+      }
+      if (!invariant) {
+        break;
+      }
+      moved.swap(outer_moved);
+      target = outer;
+      needs_taken_test = outer_needs_taken_test;
+    }
+    if (target != loop) {
+      TransformLoopForDeoptimizationIfNeeded(target, needs_taken_test);
+      HBasicBlock* target_block = GetPreHeader(target, context);
+      // Keep the order of definitions of `block`.
+      for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+        if (moved.find(it.Current()) != moved.end()) {
+          it.Current()->MoveBefore(target_block->GetLastInstruction());
+        }
+      }
+    }
+    return target;
+  }
+
   /**
    * Returns true if heuristics indicate that dynamic bce may be profitable.
    */
@@ -1637,11 +1747,79 @@ class BCEVisitor : public HGraphVisitor {
         InsertDeoptInLoop(loop, block, cond, /* is_null_check */ true);
         ReplaceInstruction(check, array);
         return true;
+      } else if (IsInvariantFieldGet(loop, array)) {
+        // Generate: array = object.field; if (array == null) deoptimize;
+        TransformLoopForDeoptimizationIfNeeded(loop, needs_taken_test);
+        HoistToPreHeaderOrDeoptBlock(loop, array);
+        HBasicBlock* block = GetPreHeader(loop, check);
+        HInstruction* cond =
+            new (GetGraph()->GetAllocator()) HEqual(array, GetGraph()->GetNullConstant());
+        InsertDeoptInLoop(loop, block, cond, /* is_null_check */ true);
+        ReplaceInstruction(check, array);
+        return true;
       }
     }
     return false;
   }
 
+  /**
+   * Returns true if `instruction` loads, inside the given loop, a field of an object
+   * defined out of the loop that is not written by the loop, so that the load can be
+   * hoisted in front of the loop (e.g. an array held in a field of `this`).
+   */
+  bool IsInvariantFieldGet(HLoopInformation* loop, HInstruction* instruction) {
+    const FieldInfo* field_info = nullptr;
+    if (instruction->IsInstanceFieldGet()) {
+      field_info = &instruction->AsInstanceFieldGet()->GetFieldInfo();
+    } else if (instruction->IsStaticFieldGet()) {
+      field_info = &instruction->AsStaticFieldGet()->GetFieldInfo();
+    } else {
+      return false;
+    }
+    HInstruction* object = instruction->InputAt(0);
+    if (field_info->IsVolatile() ||
+        instruction->GetBlock()->GetLoopInformation() != loop ||
+        !loop->IsDefinedOutOfTheLoop(object) ||
+        object->CanBeNull()) {
+      return false;
+    }
+    SideEffects effects = instruction->GetSideEffects();
+    if (!effects.MayDependOn(side_effects_.GetLoopEffects(loop->GetHeader()))) {
+      return true;
+    }
+    // Otherwise, only field writes that do not alias the loaded field are allowed.
+    if (lsa_ == nullptr) {
+      return false;
+    }
+    const HeapLocationCollector& heap_locations = lsa_->GetHeapLocationCollector();
+    size_t location = heap_locations.GetFieldHeapLocation(object, field_info);
+    if (location == HeapLocationCollector::kHeapLocationNotFound) {
+      return false;
+    }
+    for (HBlocksInLoopIterator it_loop(*loop); !it_loop.Done(); it_loop.Advance()) {
+      HBasicBlock* block = it_loop.Current();
+      for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+        HInstruction* other = it.Current();
+        if (!effects.MayDependOn(other->GetSideEffects())) {
+          continue;
+        }
+        size_t other_location = HeapLocationCollector::kHeapLocationNotFound;
+        if (other->IsInstanceFieldSet()) {
+          other_location = heap_locations.GetFieldHeapLocation(
+              other->InputAt(0), &other->AsInstanceFieldSet()->GetFieldInfo());
+        } else if (other->IsStaticFieldSet()) {
+          other_location = heap_locations.GetFieldHeapLocation(
+              other->InputAt(0), &other->AsStaticFieldSet()->GetFieldInfo());
+        }
+        if (other_location == HeapLocationCollector::kHeapLocationNotFound ||
+            heap_locations.MayAlias(location, other_location)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
   /**
    * Returns true if compiler can apply dynamic bce to loops that may be infinite
    * (e.g. for (int i = 0; i <= U; i++) with U = MAX_INT), which would invalidate
@@ -1932,6 +2110,9 @@ class BCEVisitor : public HGraphVisitor {
   // Range analysis based on induction variables.
   InductionVarRange induction_range_;
 
+  // Heap locations, to disambiguate field accesses (may be null).
+  const LoadStoreAnalysis* lsa_;
+
   // Safe iteration.
   HInstruction* next_;
 
@@ -1948,7 +2129,7 @@ void BoundsCheckElimination::Run() {
   // be bounded by a range at one instruction, it must be true that all uses of
   // that value dominated by that instruction fits in that range. Range of that
   // value can be narrowed further down in the dominator tree.
-  BCEVisitor visitor(graph_, side_effects_, induction_analysis_);
+  BCEVisitor visitor(graph_, side_effects_, induction_analysis_, lsa_);
   for (size_t i = 0, size = graph_->GetReversePostOrder().size(); i != size; ++i) {
     HBasicBlock* current = graph_->GetReversePostOrder()[i];
     if (visitor.IsAddedBlock(current)) {
@@ -23,16 +23,19 @@ namespace art {
 
 class SideEffectsAnalysis;
 class HInductionVarAnalysis;
+class LoadStoreAnalysis;
 
 class BoundsCheckElimination : public HOptimization {
  public:
   BoundsCheckElimination(HGraph* graph,
                          const SideEffectsAnalysis& side_effects,
                          HInductionVarAnalysis* induction_analysis,
+                         const LoadStoreAnalysis* lsa = nullptr,
                          const char* name = kBoundsCheckEliminationPassName)
       : HOptimization(graph, name),
         side_effects_(side_effects),
-        induction_analysis_(induction_analysis) {}
+        induction_analysis_(induction_analysis),
+        lsa_(lsa) {}
 
   void Run() OVERRIDE;
 
@@ -41,6 +44,7 @@ class BoundsCheckElimination : public HOptimization {
  private:
   const SideEffectsAnalysis& side_effects_;
   HInductionVarAnalysis* induction_analysis_;
+  const LoadStoreAnalysis* lsa_;
 
   DISALLOW_COPY_AND_ASSIGN(BoundsCheckElimination);
 };
@@ -53,6 +53,7 @@
 #include "graph_visualizer.h"
 #include "intern_table.h"
 #include "intrinsics.h"
+#include "jit/jit_code_cache.h"
 #include "mirror/array-inl.h"
 #include "mirror/object_array-inl.h"
 #include "mirror/object_reference.h"
@@ -172,8 +173,12 @@ class CodeGenerator::CodeGenerationData : public DeletableArenaObject<kArenaAllo
   StackMapStream* GetStackMapStream() { return &stack_map_stream_; }
 
   void ReserveJitStringRoot(StringReference string_reference, Handle<mirror::String> string) {
-    jit_string_roots_.Overwrite(string_reference,
-                                reinterpret_cast64<uint64_t>(string.GetReference()));
+    // Do not let the null root of a JIT .bss entry replace the string of another load.
+    if (!IsNullJitRoot(string.GetReference()) ||
+        jit_string_roots_.find(string_reference) == jit_string_roots_.end()) {
+      jit_string_roots_.Overwrite(string_reference,
+                                  reinterpret_cast64<uint64_t>(string.GetReference()));
+    }
   }
 
   uint64_t GetJitStringRootIndex(StringReference string_reference) const {
@@ -185,7 +190,12 @@ class CodeGenerator::CodeGenerationData : public DeletableArenaObject<kArenaAllo
   }
 
   void ReserveJitClassRoot(TypeReference type_reference, Handle<mirror::Class> klass) {
-    jit_class_roots_.Overwrite(type_reference, reinterpret_cast64<uint64_t>(klass.GetReference()));
+    // Do not let the null root of a JIT .bss entry replace the class of another load.
+    if (!IsNullJitRoot(klass.GetReference()) ||
+        jit_class_roots_.find(type_reference) == jit_class_roots_.end()) {
+      jit_class_roots_.Overwrite(type_reference,
+                                 reinterpret_cast64<uint64_t>(klass.GetReference()));
+    }
   }
 
   uint64_t GetJitClassRootIndex(TypeReference type_reference) const {
@@ -200,10 +210,17 @@ class CodeGenerator::CodeGenerationData : public DeletableArenaObject<kArenaAllo
     return GetNumberOfJitStringRoots() + GetNumberOfJitClassRoots();
   }
 
-  void EmitJitRoots(Handle<mirror::ObjectArray<mirror::Object>> roots)
+  void EmitJitRoots(Handle<mirror::ObjectArray<mirror::Object>> roots,
+                    /*out*/ std::vector<jit::JitBssEntry>* bss_entries)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
  private:
+  // The string of a JIT .bss entry has no handle, and its class has a handle to null.
+  // Reading the reference does not need the mutator lock, as it cannot become null.
+  static bool IsNullJitRoot(const StackReference<mirror::Object>* reference) {
+    return reference == nullptr || reference->IsNull();
+  }
+
   CodeGenerationData(ScopedArenaAllocator&& allocator, InstructionSet instruction_set)
       : allocator_(std::move(allocator)),
         stack_map_stream_(&allocator_, instruction_set),
@@ -233,7 +250,8 @@ class CodeGenerator::CodeGenerationData : public DeletableArenaObject<kArenaAllo
 };
 
 void CodeGenerator::CodeGenerationData::EmitJitRoots(
-    Handle<mirror::ObjectArray<mirror::Object>> roots) {
+    Handle<mirror::ObjectArray<mirror::Object>> roots,
+    /*out*/ std::vector<jit::JitBssEntry>* bss_entries) {
   DCHECK_EQ(static_cast<size_t>(roots->GetLength()), GetNumberOfJitRoots());
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
   size_t index = 0;
@@ -241,21 +259,39 @@ void CodeGenerator::CodeGenerationData::EmitJitRoots(
     // Update the `roots` with the string, and replace the address temporarily
     // stored to the index in the table.
     uint64_t address = entry.second;
-    roots->Set(index, reinterpret_cast<StackReference<mirror::String>*>(address)->AsMirrorPtr());
-    DCHECK(roots->Get(index) != nullptr);
+    auto* reference = reinterpret_cast<StackReference<mirror::Object>*>(address);
+    if (IsNullJitRoot(reference)) {
+      // A JIT .bss entry, the root stays null until the string is resolved.
+      bss_entries->push_back(jit::JitBssEntry {
+          entry.first.dex_file,
+          entry.first.index,
+          /* is_string */ true,
+          dchecked_integral_cast<uint32_t>(index) });
+    } else {
+      roots->Set(index, reference->AsMirrorPtr());
+      // Ensure the string is strongly interned. This is a requirement on how the JIT
+      // handles strings. b/32995596
+      class_linker->GetInternTable()->InternStrong(
+          reinterpret_cast<mirror::String*>(roots->Get(index)));
+    }
     entry.second = index;
-    // Ensure the string is strongly interned. This is a requirement on how the JIT
-    // handles strings. b/32995596
-    class_linker->GetInternTable()->InternStrong(
-        reinterpret_cast<mirror::String*>(roots->Get(index)));
     ++index;
   }
   for (auto& entry : jit_class_roots_) {
     // Update the `roots` with the class, and replace the address temporarily
     // stored to the index in the table.
     uint64_t address = entry.second;
-    roots->Set(index, reinterpret_cast<StackReference<mirror::Class>*>(address)->AsMirrorPtr());
-    DCHECK(roots->Get(index) != nullptr);
+    auto* reference = reinterpret_cast<StackReference<mirror::Object>*>(address);
+    if (IsNullJitRoot(reference)) {
+      // A JIT .bss entry, the root stays null until the class is resolved.
+      bss_entries->push_back(jit::JitBssEntry {
+          entry.first.dex_file,
+          entry.first.index,
+          /* is_string */ false,
+          dchecked_integral_cast<uint32_t>(index) });
+    } else {
+      roots->Set(index, reference->AsMirrorPtr());
+    }
     entry.second = index;
     ++index;
   }
@@ -457,6 +493,10 @@ void CodeGenerator::InitializeCodeGeneration(size_t number_of_spill_slots,
   block_order_ = &block_order;
   DCHECK(!block_order.empty());
   DCHECK(block_order[0] == GetGraph()->GetEntryBlock());
+  if (GetGraph()->IsCompilingBaseline()) {
+    // The frame entry of baseline code calls the runtime, which finds the method in the frame.
+    MarkNotLeaf();
+  }
   ComputeSpillMask();
   first_register_slot_in_slow_path_ = RoundUp(
       (number_of_out_slots + number_of_spill_slots) * kVRegSize, GetPreferredSlotsAlignment());
@@ -1616,8 +1656,9 @@ void CodeGenerator::CreateSystemArrayCopyLocationSummary(HInvoke* invoke) {
 
 void CodeGenerator::EmitJitRoots(uint8_t* code,
                                  Handle<mirror::ObjectArray<mirror::Object>> roots,
-                                 const uint8_t* roots_data) {
-  code_generation_data_->EmitJitRoots(roots);
+                                 const uint8_t* roots_data,
+                                 /*out*/ std::vector<jit::JitBssEntry>* bss_entries) {
+  code_generation_data_->EmitJitRoots(roots, bss_entries);
   EmitJitRootPatches(code, roots_data);
 }
 
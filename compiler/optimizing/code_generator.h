@@ -64,6 +64,10 @@ class CompilerOptions;
 class StackMapStream;
 class ParallelMoveResolver;
 
+namespace jit {
+struct JitBssEntry;
+}  // namespace jit
+
 namespace linker {
 class LinkerPatch;
 }  // namespace linker
@@ -351,10 +355,12 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   size_t GetNumberOfJitRoots() const;
 
   // Fills the `literals` array with literals collected during code generation.
-  // Also emits literal patches.
+  // Also emits literal patches. The null roots of the JIT .bss entries are added
+  // to `bss_entries`.
   void EmitJitRoots(uint8_t* code,
                     Handle<mirror::ObjectArray<mirror::Object>> roots,
-                    const uint8_t* roots_data)
+                    const uint8_t* roots_data,
+                    /*out*/ std::vector<jit::JitBssEntry>* bss_entries)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool IsLeafMethod() const {
@@ -585,6 +591,10 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
         DCHECK(load->NeedsEnvironment());
         return LocationSummary::kCallOnMainOnly;
       case HLoadString::LoadKind::kJitTableAddress:
+        if (load->IsJitBssEntry()) {
+          DCHECK(load->NeedsEnvironment());
+          return LocationSummary::kCallOnSlowPath;
+        }
         DCHECK(!load->NeedsEnvironment());
         return kEmitCompilerReadBarrier
             ? LocationSummary::kCallOnSlowPath
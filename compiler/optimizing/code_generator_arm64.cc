@@ -1488,7 +1488,7 @@ void CodeGeneratorARM64::GenerateFrameEntry() {
   MacroAssembler* masm = GetVIXLAssembler();
   __ Bind(&frame_entry_label_);
 
-  if (GetCompilerOptions().CountHotnessInCompiledCode()) {
+  if (GetCompilerOptions().CountHotnessInCompiledCode() && !GetGraph()->IsCompilingBaseline()) {
     UseScratchRegisterScope temps(masm);
     Register temp = temps.AcquireX();
     __ Ldrh(temp, MemOperand(kArtMethodRegister, ArtMethod::HotnessCountOffset().Int32Value()));
@@ -1543,6 +1543,25 @@ void CodeGeneratorARM64::GenerateFrameEntry() {
     }
   }
 
+  if (GetGraph()->IsCompilingBaseline()) {
+    // Count the invocation and ask for the optimized code when the counter wraps around.
+    // The runtime does not suspend, so this needs no stack map.
+    vixl::aarch64::Label done;
+    {
+      UseScratchRegisterScope temps(masm);
+      Register temp = temps.AcquireW();
+      __ Ldrh(temp, MemOperand(kArtMethodRegister, ArtMethod::HotnessCountOffset().Int32Value()));
+      __ Add(temp, temp, 1);
+      __ Strh(temp, MemOperand(kArtMethodRegister, ArtMethod::HotnessCountOffset().Int32Value()));
+      __ Tbz(temp, 16, &done);
+    }
+    int32_t entry_point_offset =
+        GetThreadOffset<kArm64PointerSize>(kQuickCompileOptimized).Int32Value();
+    __ Ldr(lr, MemOperand(tr, entry_point_offset));
+    __ Blr(lr);
+    __ Bind(&done);
+  }
+
   MaybeGenerateMarkingRegisterCheck(/* code */ __LINE__);
 }
 
@@ -3516,7 +3535,7 @@ void InstructionCodeGeneratorARM64::HandleGoto(HInstruction* got, HBasicBlock* s
   HInstruction* previous = got->GetPrevious();
   HLoopInformation* info = block->GetLoopInformation();
 
-  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
+  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheckPoll()) {
     if (codegen_->GetCompilerOptions().CountHotnessInCompiledCode()) {
       UseScratchRegisterScope temps(GetVIXLAssembler());
       Register temp1 = temps.AcquireX();
@@ -4819,7 +4838,7 @@ void LocationsBuilderARM64::VisitLoadClass(HLoadClass* cls) {
     locations->SetInAt(0, Location::RequiresRegister());
   }
   locations->SetOut(Location::RequiresRegister());
-  if (cls->GetLoadKind() == HLoadClass::LoadKind::kBssEntry) {
+  if (cls->GetLoadKind() == HLoadClass::LoadKind::kBssEntry || cls->IsJitBssEntry()) {
     if (!kUseReadBarrier || kUseBakerReadBarrier) {
       // Rely on the type resolution or initialization and marking to save everything we need.
       RegisterSet caller_saves = RegisterSet::Empty();
@@ -4937,6 +4956,7 @@ void InstructionCodeGeneratorARM64::VisitLoadClass(HLoadClass* cls) NO_THREAD_SA
                               /* offset */ 0,
                               /* fixup_label */ nullptr,
                               read_barrier_option);
+      generate_null_check = cls->IsJitBssEntry();
       break;
     }
     case HLoadClass::LoadKind::kRuntimeCall:
@@ -5011,7 +5031,7 @@ void LocationsBuilderARM64::VisitLoadString(HLoadString* load) {
     locations->SetOut(calling_convention.GetReturnLocation(load->GetType()));
   } else {
     locations->SetOut(Location::RequiresRegister());
-    if (load->GetLoadKind() == HLoadString::LoadKind::kBssEntry) {
+    if (load->GetLoadKind() == HLoadString::LoadKind::kBssEntry || load->IsJitBssEntry()) {
       if (!kUseReadBarrier || kUseBakerReadBarrier) {
         // Rely on the pResolveString and marking to save everything we need.
         RegisterSet caller_saves = RegisterSet::Empty();
@@ -5104,6 +5124,14 @@ void InstructionCodeGeneratorARM64::VisitLoadString(HLoadString* load) NO_THREAD
                               /* offset */ 0,
                               /* fixup_label */ nullptr,
                               kCompilerReadBarrierOption);
+      if (load->IsJitBssEntry()) {
+        SlowPathCodeARM64* slow_path =
+            new (codegen_->GetScopedAllocator()) LoadStringSlowPathARM64(load);
+        codegen_->AddSlowPath(slow_path);
+        __ Cbz(out.X(), slow_path->GetEntryLabel());
+        __ Bind(slow_path->GetExitLabel());
+        codegen_->MaybeGenerateMarkingRegisterCheck(/* code */ __LINE__);
+      }
       return;
     }
     default:
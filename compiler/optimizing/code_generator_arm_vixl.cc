@@ -580,7 +580,8 @@ class LoadStringSlowPathARMVIXL : public SlowPathCodeARMVIXL {
 
   void EmitNativeCode(CodeGenerator* codegen) OVERRIDE {
     DCHECK(instruction_->IsLoadString());
-    DCHECK_EQ(instruction_->AsLoadString()->GetLoadKind(), HLoadString::LoadKind::kBssEntry);
+    DCHECK(instruction_->AsLoadString()->GetLoadKind() == HLoadString::LoadKind::kBssEntry ||
+           instruction_->AsLoadString()->IsJitBssEntry());
     LocationSummary* locations = instruction_->GetLocations();
     DCHECK(!locations->GetLiveRegisters()->ContainsCoreRegister(locations->Out().reg()));
     const dex::StringIndex string_index = instruction_->AsLoadString()->GetStringIndex();
@@ -2326,7 +2327,7 @@ vixl32::Label* CodeGeneratorARMVIXL::GetFinalLabel(HInstruction* instruction,
   // Avoid a branch to a branch.
   if (next->IsGoto() && (info == nullptr ||
                          !info->IsBackEdge(*block) ||
-                         !info->HasSuspendCheck())) {
+                         !info->HasSuspendCheckPoll())) {
     final_label = GetLabelOf(next->AsGoto()->GetSuccessor());
   }
 
@@ -2812,7 +2813,7 @@ void InstructionCodeGeneratorARMVIXL::HandleGoto(HInstruction* got, HBasicBlock*
   HInstruction* previous = got->GetPrevious();
   HLoopInformation* info = block->GetLoopInformation();
 
-  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
+  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheckPoll()) {
     if (codegen_->GetCompilerOptions().CountHotnessInCompiledCode()) {
       UseScratchRegisterScope temps(GetVIXLAssembler());
       vixl32::Register temp = temps.Acquire();
@@ -7073,7 +7074,7 @@ void LocationsBuilderARMVIXL::VisitLoadClass(HLoadClass* cls) {
     locations->SetInAt(0, Location::RequiresRegister());
   }
   locations->SetOut(Location::RequiresRegister());
-  if (load_kind == HLoadClass::LoadKind::kBssEntry) {
+  if (load_kind == HLoadClass::LoadKind::kBssEntry || cls->IsJitBssEntry()) {
     if (!kUseReadBarrier || kUseBakerReadBarrier) {
       // Rely on the type resolution or initialization and marking to save everything we need.
       RegisterSet caller_saves = RegisterSet::Empty();
@@ -7171,6 +7172,7 @@ void InstructionCodeGeneratorARMVIXL::VisitLoadClass(HLoadClass* cls) NO_THREAD_
                                                        cls->GetClass()));
       // /* GcRoot<mirror::Class> */ out = *out
       GenerateGcRootFieldLoad(cls, out_loc, out, /* offset */ 0, read_barrier_option);
+      generate_null_check = cls->IsJitBssEntry();
       break;
     }
     case HLoadClass::LoadKind::kRuntimeCall:
@@ -7262,7 +7264,7 @@ void LocationsBuilderARMVIXL::VisitLoadString(HLoadString* load) {
     locations->SetOut(LocationFrom(r0));
   } else {
     locations->SetOut(Location::RequiresRegister());
-    if (load_kind == HLoadString::LoadKind::kBssEntry) {
+    if (load_kind == HLoadString::LoadKind::kBssEntry || load->IsJitBssEntry()) {
       if (!kUseReadBarrier || kUseBakerReadBarrier) {
         // Rely on the pResolveString and marking to save everything we need, including temps.
         RegisterSet caller_saves = RegisterSet::Empty();
@@ -7271,7 +7273,10 @@ void LocationsBuilderARMVIXL::VisitLoadString(HLoadString* load) {
         // TODO: Add GetReturnLocation() to the calling convention so that we can DCHECK()
         // that the the kPrimNot result register is the same as the first argument register.
         locations->SetCustomSlowPathCallerSaves(caller_saves);
-        if (kUseBakerReadBarrier && kBakerReadBarrierLinkTimeThunksEnableForGcRoots) {
+        // The JIT does not use the link-time thunks.
+        if (kUseBakerReadBarrier &&
+            kBakerReadBarrierLinkTimeThunksEnableForGcRoots &&
+            load_kind == HLoadString::LoadKind::kBssEntry) {
           locations->AddTemp(Location::RegisterLocation(kBakerCcEntrypointRegister.GetCode()));
         }
       } else {
@@ -7332,6 +7337,14 @@ void InstructionCodeGeneratorARMVIXL::VisitLoadString(HLoadString* load) NO_THRE
                                                         load->GetString()));
       // /* GcRoot<mirror::String> */ out = *out
       GenerateGcRootFieldLoad(load, out_loc, out, /* offset */ 0, kCompilerReadBarrierOption);
+      if (load->IsJitBssEntry()) {
+        LoadStringSlowPathARMVIXL* slow_path =
+            new (codegen_->GetScopedAllocator()) LoadStringSlowPathARMVIXL(load);
+        codegen_->AddSlowPath(slow_path);
+        __ CompareAndBranchIfZero(out, slow_path->GetEntryLabel());
+        __ Bind(slow_path->GetExitLabel());
+        codegen_->MaybeGenerateMarkingRegisterCheck(/* code */ 23);
+      }
       return;
     }
     default:
@@ -287,7 +287,8 @@ class LoadStringSlowPathMIPS : public SlowPathCodeMIPS {
 
   void EmitNativeCode(CodeGenerator* codegen) OVERRIDE {
     DCHECK(instruction_->IsLoadString());
-    DCHECK_EQ(instruction_->AsLoadString()->GetLoadKind(), HLoadString::LoadKind::kBssEntry);
+    DCHECK(instruction_->AsLoadString()->GetLoadKind() == HLoadString::LoadKind::kBssEntry ||
+           instruction_->AsLoadString()->IsJitBssEntry());
     LocationSummary* locations = instruction_->GetLocations();
     DCHECK(!locations->GetLiveRegisters()->ContainsCoreRegister(locations->Out().reg()));
     const dex::StringIndex string_index = instruction_->AsLoadString()->GetStringIndex();
@@ -4226,7 +4227,7 @@ void InstructionCodeGeneratorMIPS::HandleGoto(HInstruction* got, HBasicBlock* su
   HInstruction* previous = got->GetPrevious();
   HLoopInformation* info = block->GetLoopInformation();
 
-  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
+  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheckPoll()) {
     if (codegen_->GetCompilerOptions().CountHotnessInCompiledCode()) {
       __ Lw(AT, SP, kCurrentMethodStackOffset);
       __ Lhu(TMP, AT, ArtMethod::HotnessCountOffset().Int32Value());
@@ -7975,7 +7976,7 @@ void LocationsBuilderMIPS::VisitLoadClass(HLoadClass* cls) {
       break;
   }
   locations->SetOut(Location::RequiresRegister());
-  if (load_kind == HLoadClass::LoadKind::kBssEntry) {
+  if (load_kind == HLoadClass::LoadKind::kBssEntry || cls->IsJitBssEntry()) {
     if (!kUseReadBarrier || kUseBakerReadBarrier) {
       // Rely on the type resolution or initialization and marking to save everything we need.
       RegisterSet caller_saves = RegisterSet::Empty();
@@ -8114,6 +8115,7 @@ void InstructionCodeGeneratorMIPS::VisitLoadClass(HLoadClass* cls) NO_THREAD_SAF
                               /* placeholder */ 0x5678,
                               read_barrier_option,
                               &info->low_label);
+      generate_null_check = cls->IsJitBssEntry();
       break;
     }
     case HLoadClass::LoadKind::kRuntimeCall:
@@ -8195,7 +8197,7 @@ void LocationsBuilderMIPS::VisitLoadString(HLoadString* load) {
     locations->SetOut(Location::RegisterLocation(calling_convention.GetRegisterAt(0)));
   } else {
     locations->SetOut(Location::RequiresRegister());
-    if (load_kind == HLoadString::LoadKind::kBssEntry) {
+    if (load_kind == HLoadString::LoadKind::kBssEntry || load->IsJitBssEntry()) {
       if (!kUseReadBarrier || kUseBakerReadBarrier) {
         // Rely on the pResolveString and marking to save everything we need.
         RegisterSet caller_saves = RegisterSet::Empty();
@@ -8308,6 +8310,13 @@ void InstructionCodeGeneratorMIPS::VisitLoadString(HLoadString* load) NO_THREAD_
                               /* placeholder */ 0x5678,
                               kCompilerReadBarrierOption,
                               &info->low_label);
+      if (load->IsJitBssEntry()) {
+        SlowPathCodeMIPS* slow_path =
+            new (codegen_->GetScopedAllocator()) LoadStringSlowPathMIPS(load);
+        codegen_->AddSlowPath(slow_path);
+        __ Beqz(out, slow_path->GetEntryLabel());
+        __ Bind(slow_path->GetExitLabel());
+      }
       return;
     }
     default:
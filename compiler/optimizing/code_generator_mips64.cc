@@ -240,7 +240,8 @@ class LoadStringSlowPathMIPS64 : public SlowPathCodeMIPS64 {
 
   void EmitNativeCode(CodeGenerator* codegen) OVERRIDE {
     DCHECK(instruction_->IsLoadString());
-    DCHECK_EQ(instruction_->AsLoadString()->GetLoadKind(), HLoadString::LoadKind::kBssEntry);
+    DCHECK(instruction_->AsLoadString()->GetLoadKind() == HLoadString::LoadKind::kBssEntry ||
+           instruction_->AsLoadString()->IsJitBssEntry());
     LocationSummary* locations = instruction_->GetLocations();
     DCHECK(!locations->GetLiveRegisters()->ContainsCoreRegister(locations->Out().reg()));
     const dex::StringIndex string_index = instruction_->AsLoadString()->GetStringIndex();
@@ -3551,7 +3552,7 @@ void InstructionCodeGeneratorMIPS64::HandleGoto(HInstruction* got, HBasicBlock*
   HInstruction* previous = got->GetPrevious();
   HLoopInformation* info = block->GetLoopInformation();
 
-  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
+  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheckPoll()) {
     if (codegen_->GetCompilerOptions().CountHotnessInCompiledCode()) {
       __ Ld(AT, SP, kCurrentMethodStackOffset);
       __ Lhu(TMP, AT, ArtMethod::HotnessCountOffset().Int32Value());
@@ -6045,7 +6046,7 @@ void LocationsBuilderMIPS64::VisitLoadClass(HLoadClass* cls) {
     locations->SetInAt(0, Location::RequiresRegister());
   }
   locations->SetOut(Location::RequiresRegister());
-  if (load_kind == HLoadClass::LoadKind::kBssEntry) {
+  if (load_kind == HLoadClass::LoadKind::kBssEntry || cls->IsJitBssEntry()) {
     if (!kUseReadBarrier || kUseBakerReadBarrier) {
       // Rely on the type resolution or initialization and marking to save everything we need.
       RegisterSet caller_saves = RegisterSet::Empty();
@@ -6151,6 +6152,7 @@ void InstructionCodeGeneratorMIPS64::VisitLoadClass(HLoadClass* cls) NO_THREAD_S
                                                           cls->GetTypeIndex(),
                                                           cls->GetClass()));
       GenerateGcRootFieldLoad(cls, out_loc, out, 0, read_barrier_option);
+      generate_null_check = cls->IsJitBssEntry();
       break;
     case HLoadClass::LoadKind::kRuntimeCall:
     case HLoadClass::LoadKind::kInvalid:
@@ -6206,7 +6208,7 @@ void LocationsBuilderMIPS64::VisitLoadString(HLoadString* load) {
     locations->SetOut(Location::RegisterLocation(calling_convention.GetRegisterAt(0)));
   } else {
     locations->SetOut(Location::RequiresRegister());
-    if (load_kind == HLoadString::LoadKind::kBssEntry) {
+    if (load_kind == HLoadString::LoadKind::kBssEntry || load->IsJitBssEntry()) {
       if (!kUseReadBarrier || kUseBakerReadBarrier) {
         // Rely on the pResolveString and marking to save everything we need.
         RegisterSet caller_saves = RegisterSet::Empty();
@@ -6285,6 +6287,13 @@ void InstructionCodeGeneratorMIPS64::VisitLoadString(HLoadString* load) NO_THREA
                                                            load->GetStringIndex(),
                                                            load->GetString()));
       GenerateGcRootFieldLoad(load, out_loc, out, 0, kCompilerReadBarrierOption);
+      if (load->IsJitBssEntry()) {
+        SlowPathCodeMIPS64* slow_path =
+            new (codegen_->GetScopedAllocator()) LoadStringSlowPathMIPS64(load);
+        codegen_->AddSlowPath(slow_path);
+        __ Beqzc(out, slow_path->GetEntryLabel());
+        __ Bind(slow_path->GetExitLabel());
+      }
       return;
     default:
       break;
@@ -268,6 +268,36 @@ void InstructionCodeGeneratorX86::VisitVecReduce(HVecReduce* instruction) {
   }
 }
 
+void LocationsBuilderX86::VisitVecAnyTrue(HVecAnyTrue* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type";
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorX86::VisitVecAnyTrue(HVecAnyTrue* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  Register dst = locations->Out().AsRegister<Register>();
+  // Collect the most significant bit of every byte of the mask, which is non-zero
+  // for any set component. Negating a non-zero 16-bit value sets the sign bit,
+  // which yields the boolean without needing a byte register for setcc.
+  __ pmovmskb(dst, src);
+  __ negl(dst);
+  __ shrl(dst, Immediate(31));
+}
+
 void LocationsBuilderX86::VisitVecCnv(HVecCnv* instruction) {
   CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
 }
@@ -374,6 +404,29 @@ void InstructionCodeGeneratorX86::VisitVecAbs(HVecAbs* instruction) {
   }
 }
 
+void LocationsBuilderX86::VisitVecSqrt(HVecSqrt* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86::VisitVecSqrt(HVecSqrt* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kFloat32:
+      DCHECK_EQ(4u, instruction->GetVectorLength());
+      __ sqrtps(dst, src);
+      break;
+    case DataType::Type::kFloat64:
+      DCHECK_EQ(2u, instruction->GetVectorLength());
+      __ sqrtpd(dst, src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type";
+      UNREACHABLE();
+  }
+}
+
 void LocationsBuilderX86::VisitVecNot(HVecNot* instruction) {
   CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
   // Boolean-not requires a temporary to construct the 16 x one.
@@ -953,6 +1006,106 @@ void InstructionCodeGeneratorX86::VisitVecUShr(HVecUShr* instruction) {
   }
 }
 
+void LocationsBuilderX86::VisitVecCondition(HVecCondition* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister(), Location::kOutputOverlap);
+      if (instruction->GetCondition() == kCondNE ||
+          instruction->GetCondition() == kCondLE ||
+          instruction->GetCondition() == kCondGE) {
+        locations->AddTemp(Location::RequiresFpuRegister());
+      }
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type";
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorX86::VisitVecCondition(HVecCondition* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister left = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister right = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  // SSE only compares for equality and signed greater than: less than swaps
+  // the operands, and the other conditions invert the mask of their negation.
+  IfCondition condition = instruction->GetCondition();
+  bool is_equality = false;
+  bool is_inverted = false;
+  switch (condition) {
+    case kCondEQ:
+      is_equality = true;
+      break;
+    case kCondNE:
+      is_equality = true;
+      is_inverted = true;
+      break;
+    case kCondLT:
+      std::swap(left, right);
+      break;
+    case kCondLE:
+      is_inverted = true;
+      break;
+    case kCondGT:
+      break;
+    case kCondGE:
+      std::swap(left, right);
+      is_inverted = true;
+      break;
+    default:
+      LOG(FATAL) << "Unexpected condition " << condition;
+      UNREACHABLE();
+  }
+  __ movaps(dst, left);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+      DCHECK_EQ(16u, instruction->GetVectorLength());
+      DCHECK(is_equality || instruction->GetPackedType() == DataType::Type::kInt8);
+      if (is_equality) {
+        __ pcmpeqb(dst, right);
+      } else {
+        __ pcmpgtb(dst, right);
+      }
+      break;
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      DCHECK_EQ(8u, instruction->GetVectorLength());
+      DCHECK(is_equality || instruction->GetPackedType() == DataType::Type::kInt16);
+      if (is_equality) {
+        __ pcmpeqw(dst, right);
+      } else {
+        __ pcmpgtw(dst, right);
+      }
+      break;
+    case DataType::Type::kInt32:
+      DCHECK_EQ(4u, instruction->GetVectorLength());
+      if (is_equality) {
+        __ pcmpeqd(dst, right);
+      } else {
+        __ pcmpgtd(dst, right);
+      }
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type";
+      UNREACHABLE();
+  }
+  if (is_inverted) {
+    XmmRegister ones = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+    __ pcmpeqb(ones, ones);
+    __ pxor(dst, ones);
+  }
+}
+
 void LocationsBuilderX86::VisitVecSetScalars(HVecSetScalars* instruction) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
 
@@ -1079,6 +1232,117 @@ void InstructionCodeGeneratorX86::VisitVecSADAccumulate(HVecSADAccumulate* instr
   LOG(FATAL) << "No SIMD for " << instruction->GetId();
 }
 
+void LocationsBuilderX86::VisitVecSumAccumulate(HVecSumAccumulate* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt32:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::RequiresFpuRegister());
+      locations->SetOut(Location::SameAsFirstInput());
+      locations->AddTemp(Location::RequiresFpuRegister());
+      locations->AddTemp(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type";
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorX86::VisitVecSumAccumulate(HVecSumAccumulate* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister acc = locations->Out().AsFpuRegister<XmmRegister>();
+  XmmRegister tmp1 = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  XmmRegister tmp2 = locations->GetTemp(1).AsFpuRegister<XmmRegister>();
+  DCHECK_EQ(DataType::Type::kInt32, instruction->GetPackedType());
+  DCHECK_EQ(4u, instruction->GetVectorLength());
+  // Handle all feasible acc_int += a_S type combinations.
+  HVecOperation* a = instruction->InputAt(1)->AsVecOperation();
+  switch (a->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+      DCHECK_EQ(16u, a->GetVectorLength());
+      // Extend the low and high bytes into words and add these pairwise.
+      __ movaps(tmp1, src);
+      __ punpcklbw(tmp1, tmp1);
+      __ movaps(tmp2, src);
+      __ punpckhbw(tmp2, tmp2);
+      if (a->GetPackedType() == DataType::Type::kUint8) {
+        __ psrlw(tmp1, Immediate(8));
+        __ psrlw(tmp2, Immediate(8));
+      } else {
+        __ psraw(tmp1, Immediate(8));
+        __ psraw(tmp2, Immediate(8));
+      }
+      __ paddw(tmp1, tmp2);
+      // Add adjacent words into doublewords by multiplying with ones.
+      __ pcmpeqw(tmp2, tmp2);
+      __ psrlw(tmp2, Immediate(15));
+      __ pmaddwd(tmp1, tmp2);
+      __ paddd(acc, tmp1);
+      break;
+    case DataType::Type::kUint16:
+      DCHECK_EQ(8u, a->GetVectorLength());
+      // Zero extend the low and high words into doublewords.
+      __ pxor(tmp2, tmp2);
+      __ movaps(tmp1, src);
+      __ punpcklwd(tmp1, tmp2);
+      __ paddd(acc, tmp1);
+      __ movaps(tmp1, src);
+      __ punpckhwd(tmp1, tmp2);
+      __ paddd(acc, tmp1);
+      break;
+    case DataType::Type::kInt16:
+      DCHECK_EQ(8u, a->GetVectorLength());
+      // Add adjacent words into doublewords by multiplying with ones.
+      __ pcmpeqw(tmp1, tmp1);
+      __ psrlw(tmp1, Immediate(15));
+      __ pmaddwd(tmp1, src);
+      __ paddd(acc, tmp1);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type";
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86::VisitVecSelect(HVecSelect* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::RequiresFpuRegister());
+      locations->SetInAt(2, Location::RequiresFpuRegister());
+      locations->SetOut(Location::SameAsFirstInput());
+      locations->AddTemp(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type";
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorX86::VisitVecSelect(HVecSelect* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  XmmRegister true_value = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister mask = locations->InAt(2).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  DCHECK_EQ(16u, instruction->GetVectorNumberOfBytes());
+  // Blend as false ^ ((true ^ false) & mask), since pblendvb takes its mask in XMM0.
+  __ movaps(tmp, true_value);
+  __ pxor(tmp, dst);
+  __ pand(tmp, mask);
+  __ pxor(dst, tmp);
+}
+
 // Helper to set up locations for vector memory operations.
 static void CreateVecMemLocations(ArenaAllocator* allocator,
                                   HVecMemoryOperation* instruction,
@@ -25,6 +25,13 @@ namespace x86_64 {
 // NOLINT on __ macro to suppress wrong warning/fix (misc-macro-parentheses) from clang-tidy.
 #define __ down_cast<X86_64Assembler*>(GetAssembler())->  // NOLINT
 
+// Returns true if the vector operation works on 256-bit (AVX2) vectors. The loop
+// optimizer only creates these when the target supports AVX2, in which case
+// XmmRegister operands of the VEX.256 assembler forms name the YMM registers.
+static bool IsWideVector(HVecOperation* instruction) {
+  return instruction->GetVectorNumberOfBytes() == 32u;
+}
+
 void LocationsBuilderX86_64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
   HInstruction* input = instruction->InputAt(0);
@@ -58,6 +65,52 @@ void InstructionCodeGeneratorX86_64::VisitVecReplicateScalar(HVecReplicateScalar
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
 
+  if (IsWideVector(instruction)) {
+    if (IsZeroBitPattern(instruction->InputAt(0))) {
+      __ vxorps(dst, dst, dst);
+      return;
+    }
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastb(dst, dst);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastw(dst, dst);
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastd(dst, dst);
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ true);
+        __ vpbroadcastq(dst, dst);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        DCHECK(locations->InAt(0).Equals(locations->Out()));
+        __ vbroadcastss(dst, dst);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        DCHECK(locations->InAt(0).Equals(locations->Out()));
+        __ vbroadcastsd(dst, dst);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
+
   // Shorthand for any type of zero.
   if (IsZeroBitPattern(instruction->InputAt(0))) {
     __ xorps(dst, dst);
@@ -143,17 +196,17 @@ void InstructionCodeGeneratorX86_64::VisitVecExtractScalar(HVecExtractScalar* in
       LOG(FATAL) << "Unsupported SIMD type";
       UNREACHABLE();
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(IsWideVector(instruction) ? 8u : 4u, instruction->GetVectorLength());
       __ movd(locations->Out().AsRegister<CpuRegister>(), src, /*64-bit*/ false);
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(IsWideVector(instruction) ? 4u : 2u, instruction->GetVectorLength());
       __ movd(locations->Out().AsRegister<CpuRegister>(), src, /*64-bit*/ true);
       break;
     case DataType::Type::kFloat32:
     case DataType::Type::kFloat64:
       DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 4u);
+      DCHECK_LE(instruction->GetVectorLength(), 8u);
       DCHECK(locations->InAt(0).Equals(locations->Out()));  // no code required
       break;
     default:
@@ -186,8 +239,9 @@ static void CreateVecUnOpLocations(ArenaAllocator* allocator, HVecUnaryOperation
 
 void LocationsBuilderX86_64::VisitVecReduce(HVecReduce* instruction) {
   CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
-  // Long reduction or min/max require a temporary.
-  if (instruction->GetPackedType() == DataType::Type::kInt64 ||
+  // Long reduction, min/max, or folding a 256-bit vector require a temporary.
+  if (IsWideVector(instruction) ||
+      instruction->GetPackedType() == DataType::Type::kInt64 ||
       instruction->GetKind() == HVecReduce::kMin ||
       instruction->GetKind() == HVecReduce::kMax) {
     instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
@@ -198,6 +252,32 @@ void InstructionCodeGeneratorX86_64::VisitVecReduce(HVecReduce* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    // Fold the upper 128-bit lane onto the lower one, then reduce as usual.
+    DCHECK_EQ(instruction->GetKind(), HVecReduce::kSum);
+    XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+    __ vextracti128(tmp, src, Immediate(1));
+    __ movaps(dst, src);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ paddd(dst, tmp);
+        __ phaddd(dst, dst);
+        __ phaddd(dst, dst);
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ paddq(dst, tmp);
+        __ movaps(tmp, dst);
+        __ punpckhqdq(tmp, tmp);
+        __ paddq(dst, tmp);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32:
       DCHECK_EQ(4u, instruction->GetVectorLength());
@@ -251,6 +331,36 @@ void InstructionCodeGeneratorX86_64::VisitVecReduce(HVecReduce* instruction) {
   }
 }
 
+void LocationsBuilderX86_64::VisitVecAnyTrue(HVecAnyTrue* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type";
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecAnyTrue(HVecAnyTrue* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(!IsWideVector(instruction));
+  XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  CpuRegister dst = locations->Out().AsRegister<CpuRegister>();
+  // Collect the most significant bit of every byte of the mask, which is non-zero
+  // for any set component. Negating a non-zero 16-bit value sets the sign bit.
+  __ pmovmskb(dst, src);
+  __ negl(dst);
+  __ shrl(dst, Immediate(31));
+}
+
 void LocationsBuilderX86_64::VisitVecCnv(HVecCnv* instruction) {
   CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
 }
@@ -262,6 +372,11 @@ void InstructionCodeGeneratorX86_64::VisitVecCnv(HVecCnv* instruction) {
   DataType::Type from = instruction->GetInputType();
   DataType::Type to = instruction->GetResultType();
   if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32) {
+    if (IsWideVector(instruction)) {
+      DCHECK_EQ(8u, instruction->GetVectorLength());
+      __ vcvtdq2ps(dst, src);
+      return;
+    }
     DCHECK_EQ(4u, instruction->GetVectorLength());
     __ cvtdq2ps(dst, src);
   } else {
@@ -277,6 +392,46 @@ void InstructionCodeGeneratorX86_64::VisitVecNeg(HVecNeg* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpxor(dst, dst, dst);
+        __ vpsubb(dst, dst, src);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpxor(dst, dst, dst);
+        __ vpsubw(dst, dst, src);
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpxor(dst, dst, dst);
+        __ vpsubd(dst, dst, src);
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpxor(dst, dst, dst);
+        __ vpsubq(dst, dst, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vxorps(dst, dst, dst);
+        __ vsubps(dst, dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vxorpd(dst, dst, dst);
+        __ vsubpd(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -328,6 +483,26 @@ void InstructionCodeGeneratorX86_64::VisitVecAbs(HVecAbs* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpcmpeqb(dst, dst, dst);  // all ones
+        __ vpsrld(dst, dst, Immediate(1));
+        __ vandps(dst, dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpcmpeqb(dst, dst, dst);  // all ones
+        __ vpsrlq(dst, dst, Immediate(1));
+        __ vandpd(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32: {
       DCHECK_EQ(4u, instruction->GetVectorLength());
@@ -357,9 +532,48 @@ void InstructionCodeGeneratorX86_64::VisitVecAbs(HVecAbs* instruction) {
   }
 }
 
+void LocationsBuilderX86_64::VisitVecSqrt(HVecSqrt* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecSqrt(HVecSqrt* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vsqrtps(dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vsqrtpd(dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kFloat32:
+      DCHECK_EQ(4u, instruction->GetVectorLength());
+      __ sqrtps(dst, src);
+      break;
+    case DataType::Type::kFloat64:
+      DCHECK_EQ(2u, instruction->GetVectorLength());
+      __ sqrtpd(dst, src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type";
+      UNREACHABLE();
+  }
+}
+
 void LocationsBuilderX86_64::VisitVecNot(HVecNot* instruction) {
   CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
-  // Boolean-not requires a temporary to construct the 16 x one.
+  // Boolean-not requires a temporary to construct the 16 (or 32) x one.
   if (instruction->GetPackedType() == DataType::Type::kBool) {
     instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
   }
@@ -369,6 +583,44 @@ void InstructionCodeGeneratorX86_64::VisitVecNot(HVecNot* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool: {  // special case boolean-not
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+        __ vpxor(dst, dst, dst);
+        __ vpcmpeqb(tmp, tmp, tmp);  // all ones
+        __ vpsubb(dst, dst, tmp);  // 32 x one
+        __ vpxor(dst, dst, src);
+        break;
+      }
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        DCHECK_LE(4u, instruction->GetVectorLength());
+        DCHECK_LE(instruction->GetVectorLength(), 32u);
+        __ vpcmpeqb(dst, dst, dst);  // all ones
+        __ vpxor(dst, dst, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpcmpeqb(dst, dst, dst);  // all ones
+        __ vxorps(dst, dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpcmpeqb(dst, dst, dst);  // all ones
+        __ vxorpd(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool: {  // special case boolean-not
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -438,6 +690,40 @@ void InstructionCodeGeneratorX86_64::VisitVecAdd(HVecAdd* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpaddb(dst, dst, src);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpaddw(dst, dst, src);
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpaddd(dst, dst, src);
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpaddq(dst, dst, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vaddps(dst, dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vaddpd(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -483,6 +769,22 @@ void InstructionCodeGeneratorX86_64::VisitVecHalvingAdd(HVecHalvingAdd* instruct
 
   DCHECK(instruction->IsRounded());
 
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpavgb(dst, dst, src);
+        break;
+      case DataType::Type::kUint16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpavgw(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -507,6 +809,40 @@ void InstructionCodeGeneratorX86_64::VisitVecSub(HVecSub* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        DCHECK_EQ(32u, instruction->GetVectorLength());
+        __ vpsubb(dst, dst, src);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpsubw(dst, dst, src);
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpsubd(dst, dst, src);
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpsubq(dst, dst, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vsubps(dst, dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vsubpd(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -549,6 +885,31 @@ void InstructionCodeGeneratorX86_64::VisitVecMul(HVecMul* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpmullw(dst, dst, src);
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpmulld(dst, dst, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vmulps(dst, dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vmulpd(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -582,6 +943,22 @@ void InstructionCodeGeneratorX86_64::VisitVecDiv(HVecDiv* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vdivps(dst, dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vdivpd(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kFloat32:
       DCHECK_EQ(4u, instruction->GetVectorLength());
@@ -704,6 +1081,33 @@ void InstructionCodeGeneratorX86_64::VisitVecAnd(HVecAnd* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        DCHECK_LE(4u, instruction->GetVectorLength());
+        DCHECK_LE(instruction->GetVectorLength(), 32u);
+        __ vpand(dst, dst, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vandps(dst, dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vandpd(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -739,6 +1143,33 @@ void InstructionCodeGeneratorX86_64::VisitVecAndNot(HVecAndNot* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        DCHECK_LE(4u, instruction->GetVectorLength());
+        DCHECK_LE(instruction->GetVectorLength(), 32u);
+        __ vpandn(dst, dst, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vandnps(dst, dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vandnpd(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -774,6 +1205,33 @@ void InstructionCodeGeneratorX86_64::VisitVecOr(HVecOr* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        DCHECK_LE(4u, instruction->GetVectorLength());
+        DCHECK_LE(instruction->GetVectorLength(), 32u);
+        __ vpor(dst, dst, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vorps(dst, dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vorpd(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -809,6 +1267,33 @@ void InstructionCodeGeneratorX86_64::VisitVecXor(HVecXor* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        DCHECK_LE(4u, instruction->GetVectorLength());
+        DCHECK_LE(instruction->GetVectorLength(), 32u);
+        __ vpxor(dst, dst, src);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vxorps(dst, dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vxorpd(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -862,6 +1347,27 @@ void InstructionCodeGeneratorX86_64::VisitVecShl(HVecShl* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpsllw(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpslld(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpsllq(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -891,6 +1397,23 @@ void InstructionCodeGeneratorX86_64::VisitVecShr(HVecShr* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpsraw(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpsrad(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -916,6 +1439,27 @@ void InstructionCodeGeneratorX86_64::VisitVecUShr(HVecUShr* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        DCHECK_EQ(16u, instruction->GetVectorLength());
+        __ vpsrlw(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vpsrld(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vpsrlq(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -936,6 +1480,107 @@ void InstructionCodeGeneratorX86_64::VisitVecUShr(HVecUShr* instruction) {
   }
 }
 
+void LocationsBuilderX86_64::VisitVecCondition(HVecCondition* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister(), Location::kOutputOverlap);
+      if (instruction->GetCondition() == kCondNE ||
+          instruction->GetCondition() == kCondLE ||
+          instruction->GetCondition() == kCondGE) {
+        locations->AddTemp(Location::RequiresFpuRegister());
+      }
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type";
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecCondition(HVecCondition* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(!IsWideVector(instruction));
+  XmmRegister left = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister right = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  // SSE only compares for equality and signed greater than: less than swaps
+  // the operands, and the other conditions invert the mask of their negation.
+  IfCondition condition = instruction->GetCondition();
+  bool is_equality = false;
+  bool is_inverted = false;
+  switch (condition) {
+    case kCondEQ:
+      is_equality = true;
+      break;
+    case kCondNE:
+      is_equality = true;
+      is_inverted = true;
+      break;
+    case kCondLT:
+      std::swap(left, right);
+      break;
+    case kCondLE:
+      is_inverted = true;
+      break;
+    case kCondGT:
+      break;
+    case kCondGE:
+      std::swap(left, right);
+      is_inverted = true;
+      break;
+    default:
+      LOG(FATAL) << "Unexpected condition " << condition;
+      UNREACHABLE();
+  }
+  __ movaps(dst, left);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+      DCHECK_EQ(16u, instruction->GetVectorLength());
+      DCHECK(is_equality || instruction->GetPackedType() == DataType::Type::kInt8);
+      if (is_equality) {
+        __ pcmpeqb(dst, right);
+      } else {
+        __ pcmpgtb(dst, right);
+      }
+      break;
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+      DCHECK_EQ(8u, instruction->GetVectorLength());
+      DCHECK(is_equality || instruction->GetPackedType() == DataType::Type::kInt16);
+      if (is_equality) {
+        __ pcmpeqw(dst, right);
+      } else {
+        __ pcmpgtw(dst, right);
+      }
+      break;
+    case DataType::Type::kInt32:
+      DCHECK_EQ(4u, instruction->GetVectorLength());
+      if (is_equality) {
+        __ pcmpeqd(dst, right);
+      } else {
+        __ pcmpgtd(dst, right);
+      }
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type";
+      UNREACHABLE();
+  }
+  if (is_inverted) {
+    XmmRegister ones = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+    __ pcmpeqb(ones, ones);
+    __ pxor(dst, ones);
+  }
+}
+
 void LocationsBuilderX86_64::VisitVecSetScalars(HVecSetScalars* instruction) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
 
@@ -974,8 +1619,13 @@ void InstructionCodeGeneratorX86_64::VisitVecSetScalars(HVecSetScalars* instruct
 
   DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
 
-  // Zero out all other elements first.
-  __ xorps(dst, dst);
+  // Zero out all other elements first. The legacy form would leave the upper
+  // lane of a 256-bit vector untouched.
+  if (IsWideVector(instruction)) {
+    __ vxorps(dst, dst, dst);
+  } else {
+    __ xorps(dst, dst);
+  }
 
   // Shorthand for any type of zero.
   if (IsZeroBitPattern(instruction->InputAt(0))) {
@@ -1052,6 +1702,119 @@ void InstructionCodeGeneratorX86_64::VisitVecSADAccumulate(HVecSADAccumulate* in
   LOG(FATAL) << "No SIMD for " << instruction->GetId();
 }
 
+void LocationsBuilderX86_64::VisitVecSumAccumulate(HVecSumAccumulate* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt32:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::RequiresFpuRegister());
+      locations->SetOut(Location::SameAsFirstInput());
+      locations->AddTemp(Location::RequiresFpuRegister());
+      locations->AddTemp(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type";
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecSumAccumulate(HVecSumAccumulate* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  DCHECK(!IsWideVector(instruction));
+  XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister acc = locations->Out().AsFpuRegister<XmmRegister>();
+  XmmRegister tmp1 = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  XmmRegister tmp2 = locations->GetTemp(1).AsFpuRegister<XmmRegister>();
+  DCHECK_EQ(DataType::Type::kInt32, instruction->GetPackedType());
+  DCHECK_EQ(4u, instruction->GetVectorLength());
+  // Handle all feasible acc_int += a_S type combinations.
+  HVecOperation* a = instruction->InputAt(1)->AsVecOperation();
+  switch (a->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+      DCHECK_EQ(16u, a->GetVectorLength());
+      // Extend the low and high bytes into words and add these pairwise.
+      __ movaps(tmp1, src);
+      __ punpcklbw(tmp1, tmp1);
+      __ movaps(tmp2, src);
+      __ punpckhbw(tmp2, tmp2);
+      if (a->GetPackedType() == DataType::Type::kUint8) {
+        __ psrlw(tmp1, Immediate(8));
+        __ psrlw(tmp2, Immediate(8));
+      } else {
+        __ psraw(tmp1, Immediate(8));
+        __ psraw(tmp2, Immediate(8));
+      }
+      __ paddw(tmp1, tmp2);
+      // Add adjacent words into doublewords by multiplying with ones.
+      __ pcmpeqw(tmp2, tmp2);
+      __ psrlw(tmp2, Immediate(15));
+      __ pmaddwd(tmp1, tmp2);
+      __ paddd(acc, tmp1);
+      break;
+    case DataType::Type::kUint16:
+      DCHECK_EQ(8u, a->GetVectorLength());
+      // Zero extend the low and high words into doublewords.
+      __ pxor(tmp2, tmp2);
+      __ movaps(tmp1, src);
+      __ punpcklwd(tmp1, tmp2);
+      __ paddd(acc, tmp1);
+      __ movaps(tmp1, src);
+      __ punpckhwd(tmp1, tmp2);
+      __ paddd(acc, tmp1);
+      break;
+    case DataType::Type::kInt16:
+      DCHECK_EQ(8u, a->GetVectorLength());
+      // Add adjacent words into doublewords by multiplying with ones.
+      __ pcmpeqw(tmp1, tmp1);
+      __ psrlw(tmp1, Immediate(15));
+      __ pmaddwd(tmp1, src);
+      __ paddd(acc, tmp1);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type";
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64::VisitVecSelect(HVecSelect* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::RequiresFpuRegister());
+      locations->SetInAt(2, Location::RequiresFpuRegister());
+      locations->SetOut(Location::SameAsFirstInput());
+      locations->AddTemp(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type";
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorX86_64::VisitVecSelect(HVecSelect* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  DCHECK(!IsWideVector(instruction));
+  XmmRegister true_value = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  XmmRegister mask = locations->InAt(2).AsFpuRegister<XmmRegister>();
+  XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  DCHECK_EQ(16u, instruction->GetVectorNumberOfBytes());
+  // Blend as false ^ ((true ^ false) & mask), since pblendvb takes its mask in XMM0.
+  __ movaps(tmp, true_value);
+  __ pxor(tmp, dst);
+  __ pand(tmp, mask);
+  __ pxor(dst, tmp);
+}
+
 // Helper to set up locations for vector memory operations.
 static void CreateVecMemLocations(ArenaAllocator* allocator,
                                   HVecMemoryOperation* instruction,
@@ -1113,6 +1876,35 @@ void InstructionCodeGeneratorX86_64::VisitVecLoad(HVecLoad* instruction) {
   Address address = VecAddress(locations, size, instruction->IsStringCharAt());
   XmmRegister reg = locations->Out().AsFpuRegister<XmmRegister>();
   bool is_aligned16 = instruction->GetAlignment().IsAlignedAt(16);
+  if (IsWideVector(instruction)) {
+    // The alignment analysis only guarantees 16-byte alignment, always use unaligned forms.
+    DCHECK(!instruction->IsStringCharAt());
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        DCHECK_LE(4u, instruction->GetVectorLength());
+        DCHECK_LE(instruction->GetVectorLength(), 32u);
+        __ vmovdqu(reg, address);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vmovups(reg, address);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vmovupd(reg, address);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
       DCHECK_EQ(8u, instruction->GetVectorLength());
@@ -1172,6 +1964,34 @@ void InstructionCodeGeneratorX86_64::VisitVecStore(HVecStore* instruction) {
   Address address = VecAddress(locations, size, /*is_string_char_at*/ false);
   XmmRegister reg = locations->InAt(2).AsFpuRegister<XmmRegister>();
   bool is_aligned16 = instruction->GetAlignment().IsAlignedAt(16);
+  if (IsWideVector(instruction)) {
+    // The alignment analysis only guarantees 16-byte alignment, always use unaligned forms.
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        DCHECK_LE(4u, instruction->GetVectorLength());
+        DCHECK_LE(instruction->GetVectorLength(), 32u);
+        __ vmovdqu(address, reg);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK_EQ(8u, instruction->GetVectorLength());
+        __ vmovups(address, reg);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK_EQ(4u, instruction->GetVectorLength());
+        __ vmovupd(address, reg);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
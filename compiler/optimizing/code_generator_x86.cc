@@ -1113,7 +1113,7 @@ void CodeGeneratorX86::GenerateFrameEntry() {
       IsLeafMethod() && !FrameNeedsStackCheck(GetFrameSize(), InstructionSet::kX86);
   DCHECK(GetCompilerOptions().GetImplicitStackOverflowChecks());
 
-  if (GetCompilerOptions().CountHotnessInCompiledCode()) {
+  if (GetCompilerOptions().CountHotnessInCompiledCode() && !GetGraph()->IsCompilingBaseline()) {
     __ addw(Address(kMethodRegisterArgument, ArtMethod::HotnessCountOffset().Int32Value()),
             Immediate(1));
   }
@@ -1151,6 +1151,17 @@ void CodeGeneratorX86::GenerateFrameEntry() {
     // Initialize should_deoptimize flag to 0.
     __ movl(Address(ESP, GetStackOffsetOfShouldDeoptimizeFlag()), Immediate(0));
   }
+
+  if (GetGraph()->IsCompilingBaseline()) {
+    // Count the invocation and ask for the optimized code when the counter wraps around.
+    // The runtime does not suspend, so this needs no stack map.
+    NearLabel done;
+    __ addw(Address(kMethodRegisterArgument, ArtMethod::HotnessCountOffset().Int32Value()),
+            Immediate(1));
+    __ j(kCarryClear, &done);
+    GenerateInvokeRuntime(GetThreadOffset<kX86PointerSize>(kQuickCompileOptimized).Int32Value());
+    __ Bind(&done);
+  }
 }
 
 void CodeGeneratorX86::GenerateFrameExit() {
@@ -1417,7 +1428,7 @@ void InstructionCodeGeneratorX86::HandleGoto(HInstruction* got, HBasicBlock* suc
   HInstruction* previous = got->GetPrevious();
 
   HLoopInformation* info = block->GetLoopInformation();
-  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
+  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheckPoll()) {
     if (codegen_->GetCompilerOptions().CountHotnessInCompiledCode()) {
       __ pushl(EAX);
       __ movl(EAX, Address(ESP, kX86WordSize));
@@ -6226,7 +6237,7 @@ void LocationsBuilderX86::VisitLoadClass(HLoadClass* cls) {
     locations->SetInAt(0, Location::RequiresRegister());
   }
   locations->SetOut(Location::RequiresRegister());
-  if (load_kind == HLoadClass::LoadKind::kBssEntry) {
+  if (load_kind == HLoadClass::LoadKind::kBssEntry || cls->IsJitBssEntry()) {
     if (!kUseReadBarrier || kUseBakerReadBarrier) {
       // Rely on the type resolution and/or initialization to save everything.
       RegisterSet caller_saves = RegisterSet::Empty();
@@ -6324,6 +6335,7 @@ void InstructionCodeGeneratorX86::VisitLoadClass(HLoadClass* cls) NO_THREAD_SAFE
           cls->GetDexFile(), cls->GetTypeIndex(), cls->GetClass());
       // /* GcRoot<mirror::Class> */ out = *address
       GenerateGcRootFieldLoad(cls, out_loc, address, fixup_label, read_barrier_option);
+      generate_null_check = cls->IsJitBssEntry();
       break;
     }
     case HLoadClass::LoadKind::kRuntimeCall:
@@ -6414,7 +6426,7 @@ void LocationsBuilderX86::VisitLoadString(HLoadString* load) {
     locations->SetOut(Location::RegisterLocation(EAX));
   } else {
     locations->SetOut(Location::RequiresRegister());
-    if (load_kind == HLoadString::LoadKind::kBssEntry) {
+    if (load_kind == HLoadString::LoadKind::kBssEntry || load->IsJitBssEntry()) {
       if (!kUseReadBarrier || kUseBakerReadBarrier) {
         // Rely on the pResolveString to save everything.
         RegisterSet caller_saves = RegisterSet::Empty();
@@ -6486,6 +6498,13 @@ void InstructionCodeGeneratorX86::VisitLoadString(HLoadString* load) NO_THREAD_S
           load->GetDexFile(), load->GetStringIndex(), load->GetString());
       // /* GcRoot<mirror::String> */ out = *address
       GenerateGcRootFieldLoad(load, out_loc, address, fixup_label, kCompilerReadBarrierOption);
+      if (load->IsJitBssEntry()) {
+        SlowPathCode* slow_path = new (codegen_->GetScopedAllocator()) LoadStringSlowPathX86(load);
+        codegen_->AddSlowPath(slow_path);
+        __ testl(out, out);
+        __ j(kEqual, slow_path->GetEntryLabel());
+        __ Bind(slow_path->GetExitLabel());
+      }
       return;
     }
     default:
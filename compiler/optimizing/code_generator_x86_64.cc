@@ -1215,7 +1215,9 @@ size_t CodeGeneratorX86_64::RestoreCoreRegister(size_t stack_index, uint32_t reg
 }
 
 size_t CodeGeneratorX86_64::SaveFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
-  if (GetGraph()->HasSIMD()) {
+  if (GetGraph()->HasWideSIMD()) {
+    __ vmovups(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
+  } else if (GetGraph()->HasSIMD()) {
     __ movups(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
   } else {
     __ movsd(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
@@ -1224,7 +1226,9 @@ size_t CodeGeneratorX86_64::SaveFloatingPointRegister(size_t stack_index, uint32
 }
 
 size_t CodeGeneratorX86_64::RestoreFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
-  if (GetGraph()->HasSIMD()) {
+  if (GetGraph()->HasWideSIMD()) {
+    __ vmovups(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
+  } else if (GetGraph()->HasSIMD()) {
     __ movups(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
   } else {
     __ movsd(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
@@ -1320,7 +1324,7 @@ void CodeGeneratorX86_64::GenerateFrameEntry() {
       && !FrameNeedsStackCheck(GetFrameSize(), InstructionSet::kX86_64);
   DCHECK(GetCompilerOptions().GetImplicitStackOverflowChecks());
 
-  if (GetCompilerOptions().CountHotnessInCompiledCode()) {
+  if (GetCompilerOptions().CountHotnessInCompiledCode() && !GetGraph()->IsCompilingBaseline()) {
     __ addw(Address(CpuRegister(kMethodRegisterArgument),
                     ArtMethod::HotnessCountOffset().Int32Value()),
             Immediate(1));
@@ -1371,6 +1375,19 @@ void CodeGeneratorX86_64::GenerateFrameEntry() {
     // Initialize should_deoptimize flag to 0.
     __ movl(Address(CpuRegister(RSP), GetStackOffsetOfShouldDeoptimizeFlag()), Immediate(0));
   }
+
+  if (GetGraph()->IsCompilingBaseline()) {
+    // Count the invocation and ask for the optimized code when the counter wraps around.
+    // The runtime does not suspend, so this needs no stack map.
+    NearLabel done;
+    __ addw(Address(CpuRegister(kMethodRegisterArgument),
+                    ArtMethod::HotnessCountOffset().Int32Value()),
+            Immediate(1));
+    __ j(kCarryClear, &done);
+    GenerateInvokeRuntime(
+        GetThreadOffset<kX86_64PointerSize>(kQuickCompileOptimized).Int32Value());
+    __ Bind(&done);
+  }
 }
 
 void CodeGeneratorX86_64::GenerateFrameExit() {
@@ -1399,6 +1416,10 @@ void CodeGeneratorX86_64::GenerateFrameExit() {
       }
     }
   }
+  if (GetGraph()->HasWideSIMD()) {
+    // Avoid the AVX to SSE transition penalty in the caller.
+    __ vzeroupper();
+  }
   __ ret();
   __ cfi().RestoreState();
   __ cfi().DefCFAOffset(GetFrameSize());
@@ -1436,7 +1457,11 @@ void CodeGeneratorX86_64::Move(Location destination, Location source) {
     if (source.IsRegister()) {
       __ movd(dest, source.AsRegister<CpuRegister>());
     } else if (source.IsFpuRegister()) {
-      __ movaps(dest, source.AsFpuRegister<XmmRegister>());
+      if (GetGraph()->HasWideSIMD()) {
+        __ vmovaps(dest, source.AsFpuRegister<XmmRegister>());
+      } else {
+        __ movaps(dest, source.AsFpuRegister<XmmRegister>());
+      }
     } else if (source.IsConstant()) {
       HConstant* constant = source.GetConstant();
       int64_t value = CodeGenerator::GetInt64ValueOf(constant);
@@ -1516,7 +1541,7 @@ void InstructionCodeGeneratorX86_64::HandleGoto(HInstruction* got, HBasicBlock*
   HInstruction* previous = got->GetPrevious();
 
   HLoopInformation* info = block->GetLoopInformation();
-  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
+  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheckPoll()) {
     if (codegen_->GetCompilerOptions().CountHotnessInCompiledCode()) {
       __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), 0));
       __ addw(Address(CpuRegister(TMP), ArtMethod::HotnessCountOffset().Int32Value()),
@@ -1585,12 +1610,9 @@ void InstructionCodeGeneratorX86_64::GenerateCompareTest(HCondition* condition)
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
     case DataType::Type::kInt32:
-    case DataType::Type::kReference: {
-      codegen_->GenerateIntCompare(left, right);
-      break;
-    }
+    case DataType::Type::kReference:
     case DataType::Type::kInt64: {
-      codegen_->GenerateLongCompare(left, right);
+      GenerateCompareWithSecondInput(condition, left, right);
       break;
     }
     case DataType::Type::kFloat32: {
@@ -1626,6 +1648,26 @@ void InstructionCodeGeneratorX86_64::GenerateCompareTest(HCondition* condition)
   }
 }
 
+void InstructionCodeGeneratorX86_64::GenerateCompareWithSecondInput(HInstruction* instruction,
+                                                                    Location lhs,
+                                                                    Location rhs) {
+  DataType::Type type = instruction->InputAt(0)->GetType();
+  HInstruction* second = instruction->InputAt(1);
+  if (CodeGeneratorX86_64::IsFoldedArrayGet(second)) {
+    Address address = CodeGeneratorX86_64::FoldedArrayGetAddress(second);
+    if (type == DataType::Type::kInt64) {
+      __ cmpq(lhs.AsRegister<CpuRegister>(), address);
+    } else {
+      __ cmpl(lhs.AsRegister<CpuRegister>(), address);
+    }
+    codegen_->MaybeRecordFoldedArrayGetNullCheck(second);
+  } else if (type == DataType::Type::kInt64) {
+    codegen_->GenerateLongCompare(lhs, rhs);
+  } else {
+    codegen_->GenerateIntCompare(lhs, rhs);
+  }
+}
+
 template<class LabelType>
 void InstructionCodeGeneratorX86_64::GenerateCompareTestAndBranch(HCondition* condition,
                                                                   LabelType* true_target_in,
@@ -1745,7 +1787,7 @@ void InstructionCodeGeneratorX86_64::GenerateTestAndBranch(HInstruction* instruc
 
     Location lhs = condition->GetLocations()->InAt(0);
     Location rhs = condition->GetLocations()->InAt(1);
-    codegen_->GenerateIntCompare(lhs, rhs);
+    GenerateCompareWithSecondInput(condition, lhs, rhs);
       if (true_target == nullptr) {
       __ j(X86_64IntegerCondition(condition->GetOppositeCondition()), false_target);
     } else {
@@ -1922,10 +1964,6 @@ void LocationsBuilderX86_64::HandleCondition(HCondition* cond) {
       new (GetGraph()->GetAllocator()) LocationSummary(cond, LocationSummary::kNoCall);
   // Handle the long/FP comparisons made in instruction simplification.
   switch (cond->InputAt(0)->GetType()) {
-    case DataType::Type::kInt64:
-      locations->SetInAt(0, Location::RequiresRegister());
-      locations->SetInAt(1, Location::Any());
-      break;
     case DataType::Type::kFloat32:
     case DataType::Type::kFloat64:
       locations->SetInAt(0, Location::RequiresFpuRegister());
@@ -1933,7 +1971,10 @@ void LocationsBuilderX86_64::HandleCondition(HCondition* cond) {
       break;
     default:
       locations->SetInAt(0, Location::RequiresRegister());
-      locations->SetInAt(1, Location::Any());
+      // A folded array load is addressed through its own inputs.
+      if (!CodeGeneratorX86_64::IsFoldedArrayGet(cond->InputAt(1))) {
+        locations->SetInAt(1, Location::Any());
+      }
       break;
   }
   if (!cond->IsEmittedAtUseSite()) {
@@ -1959,14 +2000,14 @@ void InstructionCodeGeneratorX86_64::HandleCondition(HCondition* cond) {
       // Clear output register: setcc only sets the low byte.
       __ xorl(reg, reg);
 
-      codegen_->GenerateIntCompare(lhs, rhs);
+      GenerateCompareWithSecondInput(cond, lhs, rhs);
       __ setcc(X86_64IntegerCondition(cond->GetCondition()), reg);
       return;
     case DataType::Type::kInt64:
       // Clear output register: setcc only sets the low byte.
       __ xorl(reg, reg);
 
-      codegen_->GenerateLongCompare(lhs, rhs);
+      GenerateCompareWithSecondInput(cond, lhs, rhs);
       __ setcc(X86_64IntegerCondition(cond->GetCondition()), reg);
       return;
     case DataType::Type::kFloat32: {
@@ -2103,7 +2144,9 @@ void LocationsBuilderX86_64::VisitCompare(HCompare* compare) {
     case DataType::Type::kInt32:
     case DataType::Type::kInt64: {
       locations->SetInAt(0, Location::RequiresRegister());
-      locations->SetInAt(1, Location::Any());
+      if (!CodeGeneratorX86_64::IsFoldedArrayGet(compare->InputAt(1))) {
+        locations->SetInAt(1, Location::Any());
+      }
       locations->SetOut(Location::RequiresRegister(), Location::kNoOutputOverlap);
       break;
     }
@@ -2135,12 +2178,9 @@ void InstructionCodeGeneratorX86_64::VisitCompare(HCompare* compare) {
     case DataType::Type::kInt8:
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-    case DataType::Type::kInt32: {
-      codegen_->GenerateIntCompare(left, right);
-      break;
-    }
+    case DataType::Type::kInt32:
     case DataType::Type::kInt64: {
-      codegen_->GenerateLongCompare(left, right);
+      GenerateCompareWithSecondInput(compare, left, right);
       break;
     }
     case DataType::Type::kFloat32: {
@@ -3074,6 +3114,11 @@ void InstructionCodeGeneratorX86_64::VisitTypeConversion(HTypeConversion* conver
 void LocationsBuilderX86_64::VisitAdd(HAdd* add) {
   LocationSummary* locations =
       new (GetGraph()->GetAllocator()) LocationSummary(add, LocationSummary::kNoCall);
+  if (CodeGeneratorX86_64::IsFoldedArrayGet(add->InputAt(1))) {
+    locations->SetInAt(0, Location::RequiresRegister());
+    locations->SetOut(Location::SameAsFirstInput());
+    return;
+  }
   switch (add->GetResultType()) {
     case DataType::Type::kInt32: {
       locations->SetInAt(0, Location::RequiresRegister());
@@ -3109,6 +3154,18 @@ void InstructionCodeGeneratorX86_64::VisitAdd(HAdd* add) {
   Location second = locations->InAt(1);
   Location out = locations->Out();
 
+  if (CodeGeneratorX86_64::IsFoldedArrayGet(add->InputAt(1))) {
+    DCHECK(first.Equals(out));
+    Address address = CodeGeneratorX86_64::FoldedArrayGetAddress(add->InputAt(1));
+    if (add->GetResultType() == DataType::Type::kInt64) {
+      __ addq(out.AsRegister<CpuRegister>(), address);
+    } else {
+      __ addl(out.AsRegister<CpuRegister>(), address);
+    }
+    codegen_->MaybeRecordFoldedArrayGetNullCheck(add->InputAt(1));
+    return;
+  }
+
   switch (add->GetResultType()) {
     case DataType::Type::kInt32: {
       if (second.IsRegister()) {
@@ -3198,6 +3255,11 @@ void InstructionCodeGeneratorX86_64::VisitAdd(HAdd* add) {
 void LocationsBuilderX86_64::VisitSub(HSub* sub) {
   LocationSummary* locations =
       new (GetGraph()->GetAllocator()) LocationSummary(sub, LocationSummary::kNoCall);
+  if (CodeGeneratorX86_64::IsFoldedArrayGet(sub->InputAt(1))) {
+    locations->SetInAt(0, Location::RequiresRegister());
+    locations->SetOut(Location::SameAsFirstInput());
+    return;
+  }
   switch (sub->GetResultType()) {
     case DataType::Type::kInt32: {
       locations->SetInAt(0, Location::RequiresRegister());
@@ -3228,6 +3290,16 @@ void InstructionCodeGeneratorX86_64::VisitSub(HSub* sub) {
   Location first = locations->InAt(0);
   Location second = locations->InAt(1);
   DCHECK(first.Equals(locations->Out()));
+  if (CodeGeneratorX86_64::IsFoldedArrayGet(sub->InputAt(1))) {
+    Address address = CodeGeneratorX86_64::FoldedArrayGetAddress(sub->InputAt(1));
+    if (sub->GetResultType() == DataType::Type::kInt64) {
+      __ subq(first.AsRegister<CpuRegister>(), address);
+    } else {
+      __ subl(first.AsRegister<CpuRegister>(), address);
+    }
+    codegen_->MaybeRecordFoldedArrayGetNullCheck(sub->InputAt(1));
+    return;
+  }
   switch (sub->GetResultType()) {
     case DataType::Type::kInt32: {
       if (second.IsRegister()) {
@@ -4325,11 +4397,20 @@ void CodeGeneratorX86_64::GenerateMemoryBarrier(MemBarrierKind kind) {
   }
 }
 
+// Returns whether the reference loaded by `instruction` needs no read barrier, see
+// ReadBarrierElimination.
+static bool IsReadBarrierFreeFieldGet(HInstruction* instruction) {
+  return instruction->IsInstanceFieldGet() &&
+      instruction->AsInstanceFieldGet()->IsReadBarrierFree();
+}
+
 void LocationsBuilderX86_64::HandleFieldGet(HInstruction* instruction) {
   DCHECK(instruction->IsInstanceFieldGet() || instruction->IsStaticFieldGet());
 
   bool object_field_get_with_read_barrier =
-      kEmitCompilerReadBarrier && (instruction->GetType() == DataType::Type::kReference);
+      kEmitCompilerReadBarrier &&
+      (instruction->GetType() == DataType::Type::kReference) &&
+      !IsReadBarrierFreeFieldGet(instruction);
   LocationSummary* locations =
       new (GetGraph()->GetAllocator()) LocationSummary(instruction,
                                                        object_field_get_with_read_barrier
@@ -4393,7 +4474,8 @@ void InstructionCodeGeneratorX86_64::HandleFieldGet(HInstruction* instruction,
 
     case DataType::Type::kReference: {
       // /* HeapReference<Object> */ out = *(base + offset)
-      if (kEmitCompilerReadBarrier && kUseBakerReadBarrier) {
+      bool read_barrier_free = IsReadBarrierFreeFieldGet(instruction);
+      if (kEmitCompilerReadBarrier && kUseBakerReadBarrier && !read_barrier_free) {
         // Note that a potential implicit null check is handled in this
         // CodeGeneratorX86_64::GenerateFieldLoadWithBakerReadBarrier call.
         codegen_->GenerateFieldLoadWithBakerReadBarrier(
@@ -4407,10 +4489,14 @@ void InstructionCodeGeneratorX86_64::HandleFieldGet(HInstruction* instruction,
         if (is_volatile) {
           codegen_->GenerateMemoryBarrier(MemBarrierKind::kLoadAny);
         }
-        // If read barriers are enabled, emit read barriers other than
-        // Baker's using a slow path (and also unpoison the loaded
-        // reference, if heap poisoning is enabled).
-        codegen_->MaybeGenerateReadBarrierSlow(instruction, out, out, base_loc, offset);
+        if (read_barrier_free) {
+          __ MaybeUnpoisonHeapReference(out.AsRegister<CpuRegister>());
+        } else {
+          // If read barriers are enabled, emit read barriers other than
+          // Baker's using a slow path (and also unpoison the loaded
+          // reference, if heap poisoning is enabled).
+          codegen_->MaybeGenerateReadBarrierSlow(instruction, out, out, base_loc, offset);
+        }
       }
       break;
     }
@@ -4725,8 +4811,43 @@ void LocationsBuilderX86_64::VisitNullCheck(HNullCheck* instruction) {
   locations->SetInAt(0, loc);
 }
 
+bool CodeGeneratorX86_64::CanMoveNullCheckToFoldedArrayGet(HNullCheck* null_check) {
+  // The user of a folded array load reads the element, so it faults on a null array if the
+  // address of the element falls in the first page.
+  HInstruction* next = null_check->GetNextDisregardingMoves();
+  if (next == nullptr ||
+      !IsFoldedArrayGet(next) ||
+      next->InputAt(0) != null_check->InputAt(0) ||
+      !next->InputAt(1)->IsIntConstant()) {
+    return false;
+  }
+  HArrayGet* array_get = next->AsArrayGet();
+  DCHECK(!array_get->GetUses().empty());
+  if (array_get->GetNextDisregardingMoves() != array_get->GetUses().front().GetUser()) {
+    return false;
+  }
+  int64_t index = array_get->GetIndex()->AsIntConstant()->GetValue();
+  int64_t offset =
+      GetArrayDataOffset(array_get) + index * DataType::Size(array_get->GetType());
+  return index >= 0 && art::CanDoImplicitNullCheckOn(static_cast<uintptr_t>(offset));
+}
+
+void CodeGeneratorX86_64::MaybeRecordFoldedArrayGetNullCheck(HInstruction* array_get) {
+  DCHECK(IsFoldedArrayGet(array_get));
+  if (!GetCompilerOptions().GetImplicitNullChecks()) {
+    return;
+  }
+  HInstruction* previous = array_get->GetPreviousDisregardingMoves();
+  if (previous != nullptr &&
+      previous->IsNullCheck() &&
+      CanMoveNullCheckToFoldedArrayGet(previous->AsNullCheck())) {
+    // Record the null check at the user, which has just emitted the faulting instruction.
+    RecordPcInfo(previous, previous->GetDexPc());
+  }
+}
+
 void CodeGeneratorX86_64::GenerateImplicitNullCheck(HNullCheck* instruction) {
-  if (CanMoveNullCheckToUser(instruction)) {
+  if (CanMoveNullCheckToUser(instruction) || CanMoveNullCheckToFoldedArrayGet(instruction)) {
     return;
   }
   LocationSummary* locations = instruction->GetLocations();
@@ -4762,7 +4883,9 @@ void InstructionCodeGeneratorX86_64::VisitNullCheck(HNullCheck* instruction) {
 
 void LocationsBuilderX86_64::VisitArrayGet(HArrayGet* instruction) {
   bool object_array_get_with_read_barrier =
-      kEmitCompilerReadBarrier && (instruction->GetType() == DataType::Type::kReference);
+      kEmitCompilerReadBarrier &&
+      (instruction->GetType() == DataType::Type::kReference) &&
+      !instruction->IsReadBarrierFree();
   LocationSummary* locations =
       new (GetGraph()->GetAllocator()) LocationSummary(instruction,
                                                        object_array_get_with_read_barrier
@@ -4773,6 +4896,10 @@ void LocationsBuilderX86_64::VisitArrayGet(HArrayGet* instruction) {
   }
   locations->SetInAt(0, Location::RequiresRegister());
   locations->SetInAt(1, Location::RegisterOrConstant(instruction->InputAt(1)));
+  if (instruction->IsEmittedAtUseSite()) {
+    // The element is read by the user, see FoldedArrayGetAddress().
+    return;
+  }
   if (DataType::IsFloatingPointType(instruction->GetType())) {
     locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
   } else {
@@ -4786,6 +4913,10 @@ void LocationsBuilderX86_64::VisitArrayGet(HArrayGet* instruction) {
 }
 
 void InstructionCodeGeneratorX86_64::VisitArrayGet(HArrayGet* instruction) {
+  if (instruction->IsEmittedAtUseSite()) {
+    return;
+  }
+
   LocationSummary* locations = instruction->GetLocations();
   Location obj_loc = locations->InAt(0);
   CpuRegister obj = obj_loc.AsRegister<CpuRegister>();
@@ -4848,7 +4979,7 @@ void InstructionCodeGeneratorX86_64::VisitArrayGet(HArrayGet* instruction) {
           "art::mirror::HeapReference<art::mirror::Object> and int32_t have different sizes.");
       // /* HeapReference<Object> */ out =
       //     *(obj + data_offset + index * sizeof(HeapReference<Object>))
-      if (kEmitCompilerReadBarrier && kUseBakerReadBarrier) {
+      if (kEmitCompilerReadBarrier && kUseBakerReadBarrier && !instruction->IsReadBarrierFree()) {
         // Note that a potential implicit null check is handled in this
         // CodeGeneratorX86_64::GenerateArrayLoadWithBakerReadBarrier call.
         codegen_->GenerateArrayLoadWithBakerReadBarrier(
@@ -4860,7 +4991,9 @@ void InstructionCodeGeneratorX86_64::VisitArrayGet(HArrayGet* instruction) {
         // If read barriers are enabled, emit read barriers other than
         // Baker's using a slow path (and also unpoison the loaded
         // reference, if heap poisoning is enabled).
-        if (index.IsConstant()) {
+        if (instruction->IsReadBarrierFree()) {
+          __ MaybeUnpoisonHeapReference(out);
+        } else if (index.IsConstant()) {
           uint32_t offset =
               (index.GetConstant()->AsIntConstant()->GetValue() << TIMES_4) + data_offset;
           codegen_->MaybeGenerateReadBarrierSlow(instruction, out_loc, out_loc, obj_loc, offset);
@@ -5419,16 +5552,23 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
       __ movq(Address(CpuRegister(RSP), destination.GetStackIndex()), CpuRegister(TMP));
     }
   } else if (source.IsSIMDStackSlot()) {
+    bool is_wide = codegen_->GetGraph()->HasWideSIMD();
     if (destination.IsFpuRegister()) {
-      __ movups(destination.AsFpuRegister<XmmRegister>(),
-                Address(CpuRegister(RSP), source.GetStackIndex()));
+      if (is_wide) {
+        __ vmovups(destination.AsFpuRegister<XmmRegister>(),
+                   Address(CpuRegister(RSP), source.GetStackIndex()));
+      } else {
+        __ movups(destination.AsFpuRegister<XmmRegister>(),
+                  Address(CpuRegister(RSP), source.GetStackIndex()));
+      }
     } else {
       DCHECK(destination.IsSIMDStackSlot());
-      size_t high = kX86_64WordSize;
-      __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex()));
-      __ movq(Address(CpuRegister(RSP), destination.GetStackIndex()), CpuRegister(TMP));
-      __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + high));
-      __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + high), CpuRegister(TMP));
+      size_t num_of_qwords = is_wide ? 4u : 2u;
+      for (size_t i = 0; i < num_of_qwords; ++i) {
+        size_t offset = i * kX86_64WordSize;
+        __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + offset));
+        __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + offset), CpuRegister(TMP));
+      }
     }
   } else if (source.IsConstant()) {
     HConstant* constant = source.GetConstant();
@@ -5476,7 +5616,11 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
     }
   } else if (source.IsFpuRegister()) {
     if (destination.IsFpuRegister()) {
-      __ movaps(destination.AsFpuRegister<XmmRegister>(), source.AsFpuRegister<XmmRegister>());
+      if (codegen_->GetGraph()->HasWideSIMD()) {
+        __ vmovaps(destination.AsFpuRegister<XmmRegister>(), source.AsFpuRegister<XmmRegister>());
+      } else {
+        __ movaps(destination.AsFpuRegister<XmmRegister>(), source.AsFpuRegister<XmmRegister>());
+      }
     } else if (destination.IsStackSlot()) {
       __ movss(Address(CpuRegister(RSP), destination.GetStackIndex()),
                source.AsFpuRegister<XmmRegister>());
@@ -5485,8 +5629,13 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
                source.AsFpuRegister<XmmRegister>());
     } else {
        DCHECK(destination.IsSIMDStackSlot());
-      __ movups(Address(CpuRegister(RSP), destination.GetStackIndex()),
-                source.AsFpuRegister<XmmRegister>());
+      if (codegen_->GetGraph()->HasWideSIMD()) {
+        __ vmovups(Address(CpuRegister(RSP), destination.GetStackIndex()),
+                   source.AsFpuRegister<XmmRegister>());
+      } else {
+        __ movups(Address(CpuRegister(RSP), destination.GetStackIndex()),
+                  source.AsFpuRegister<XmmRegister>());
+      }
     }
   }
 }
@@ -5530,6 +5679,15 @@ void ParallelMoveResolverX86_64::Exchange128(XmmRegister reg, int mem) {
   __ addq(CpuRegister(RSP), Immediate(extra_slot));
 }
 
+void ParallelMoveResolverX86_64::Exchange256(XmmRegister reg, int mem) {
+  size_t extra_slot = 4 * kX86_64WordSize;
+  __ subq(CpuRegister(RSP), Immediate(extra_slot));
+  __ vmovups(Address(CpuRegister(RSP), 0), XmmRegister(reg));
+  ExchangeMemory64(0, mem + extra_slot, 4);
+  __ vmovups(XmmRegister(reg), Address(CpuRegister(RSP), 0));
+  __ addq(CpuRegister(RSP), Immediate(extra_slot));
+}
+
 void ParallelMoveResolverX86_64::ExchangeMemory32(int mem1, int mem2) {
   ScratchRegisterScope ensure_scratch(
       this, TMP, RAX, codegen_->GetNumberOfCoreRegisters());
@@ -5582,6 +5740,14 @@ void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
     Exchange64(destination.AsRegister<CpuRegister>(), source.GetStackIndex());
   } else if (source.IsDoubleStackSlot() && destination.IsDoubleStackSlot()) {
     ExchangeMemory64(destination.GetStackIndex(), source.GetStackIndex(), 1);
+  } else if (source.IsFpuRegister() && destination.IsFpuRegister() &&
+             codegen_->GetGraph()->HasWideSIMD()) {
+    // Swap the full 256-bit registers in place.
+    XmmRegister reg1 = source.AsFpuRegister<XmmRegister>();
+    XmmRegister reg2 = destination.AsFpuRegister<XmmRegister>();
+    __ vxorps(reg1, reg1, reg2);
+    __ vxorps(reg2, reg2, reg1);
+    __ vxorps(reg1, reg1, reg2);
   } else if (source.IsFpuRegister() && destination.IsFpuRegister()) {
     __ movd(CpuRegister(TMP), source.AsFpuRegister<XmmRegister>());
     __ movaps(source.AsFpuRegister<XmmRegister>(), destination.AsFpuRegister<XmmRegister>());
@@ -5595,11 +5761,21 @@ void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
   } else if (source.IsDoubleStackSlot() && destination.IsFpuRegister()) {
     Exchange64(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
   } else if (source.IsSIMDStackSlot() && destination.IsSIMDStackSlot()) {
-    ExchangeMemory64(destination.GetStackIndex(), source.GetStackIndex(), 2);
+    ExchangeMemory64(destination.GetStackIndex(),
+                     source.GetStackIndex(),
+                     codegen_->GetGraph()->HasWideSIMD() ? 4 : 2);
   } else if (source.IsFpuRegister() && destination.IsSIMDStackSlot()) {
-    Exchange128(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
+    if (codegen_->GetGraph()->HasWideSIMD()) {
+      Exchange256(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
+    } else {
+      Exchange128(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
+    }
   } else if (destination.IsFpuRegister() && source.IsSIMDStackSlot()) {
-    Exchange128(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
+    if (codegen_->GetGraph()->HasWideSIMD()) {
+      Exchange256(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
+    } else {
+      Exchange128(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
+    }
   } else {
     LOG(FATAL) << "Unimplemented swap between " << source << " and " << destination;
   }
@@ -5677,7 +5853,7 @@ void LocationsBuilderX86_64::VisitLoadClass(HLoadClass* cls) {
     locations->SetInAt(0, Location::RequiresRegister());
   }
   locations->SetOut(Location::RequiresRegister());
-  if (load_kind == HLoadClass::LoadKind::kBssEntry) {
+  if (load_kind == HLoadClass::LoadKind::kBssEntry || cls->IsJitBssEntry()) {
     if (!kUseReadBarrier || kUseBakerReadBarrier) {
       // Rely on the type resolution and/or initialization to save everything.
       // Custom calling convention: RAX serves as both input and output.
@@ -5774,6 +5950,7 @@ void InstructionCodeGeneratorX86_64::VisitLoadClass(HLoadClass* cls) NO_THREAD_S
           codegen_->NewJitRootClassPatch(cls->GetDexFile(), cls->GetTypeIndex(), cls->GetClass());
       // /* GcRoot<mirror::Class> */ out = *address
       GenerateGcRootFieldLoad(cls, out_loc, address, fixup_label, read_barrier_option);
+      generate_null_check = cls->IsJitBssEntry();
       break;
     }
     default:
@@ -5841,7 +6018,7 @@ void LocationsBuilderX86_64::VisitLoadString(HLoadString* load) {
     locations->SetOut(Location::RegisterLocation(RAX));
   } else {
     locations->SetOut(Location::RequiresRegister());
-    if (load->GetLoadKind() == HLoadString::LoadKind::kBssEntry) {
+    if (load->GetLoadKind() == HLoadString::LoadKind::kBssEntry || load->IsJitBssEntry()) {
       if (!kUseReadBarrier || kUseBakerReadBarrier) {
         // Rely on the pResolveString to save everything.
         // Custom calling convention: RAX serves as both input and output.
@@ -5912,6 +6089,14 @@ void InstructionCodeGeneratorX86_64::VisitLoadString(HLoadString* load) NO_THREA
           load->GetDexFile(), load->GetStringIndex(), load->GetString());
       // /* GcRoot<mirror::String> */ out = *address
       GenerateGcRootFieldLoad(load, out_loc, address, fixup_label, kCompilerReadBarrierOption);
+      if (load->IsJitBssEntry()) {
+        SlowPathCode* slow_path =
+            new (codegen_->GetScopedAllocator()) LoadStringSlowPathX86_64(load);
+        codegen_->AddSlowPath(slow_path);
+        __ testl(out, out);
+        __ j(kEqual, slow_path->GetEntryLabel());
+        __ Bind(slow_path->GetExitLabel());
+      }
       return;
     }
     default:
@@ -5975,6 +6160,10 @@ static bool CheckCastTypeCheckNeedsATemporary(TypeCheckKind type_check_kind) {
 }
 
 static bool InstanceOfTypeCheckNeedsATemporary(TypeCheckKind type_check_kind) {
+  if (type_check_kind == TypeCheckKind::kInterfaceCheck) {
+    // We need a temporary for holding the iftable length.
+    return true;
+  }
   return kEmitCompilerReadBarrier &&
       !kUseBakerReadBarrier &&
       (type_check_kind == TypeCheckKind::kAbstractClassCheck ||
@@ -5996,9 +6185,13 @@ void LocationsBuilderX86_64::VisitInstanceOf(HInstanceOf* instruction) {
       baker_read_barrier_slow_path = kUseBakerReadBarrier && needs_read_barrier;
       break;
     }
+    case TypeCheckKind::kInterfaceCheck:
+      // Only the misses of the inline check need the runtime, under read barriers.
+      call_kind = kEmitCompilerReadBarrier ? LocationSummary::kCallOnSlowPath
+                                           : LocationSummary::kNoCall;
+      break;
     case TypeCheckKind::kArrayCheck:
     case TypeCheckKind::kUnresolvedCheck:
-    case TypeCheckKind::kInterfaceCheck:
       call_kind = LocationSummary::kCallOnSlowPath;
       break;
   }
@@ -6009,11 +6202,17 @@ void LocationsBuilderX86_64::VisitInstanceOf(HInstanceOf* instruction) {
     locations->SetCustomSlowPathCallerSaves(RegisterSet::Empty());  // No caller-save registers.
   }
   locations->SetInAt(0, Location::RequiresRegister());
-  locations->SetInAt(1, Location::Any());
+  if (type_check_kind == TypeCheckKind::kInterfaceCheck) {
+    // Require a register for the interface check since there is a loop that compares the class to
+    // a memory address.
+    locations->SetInAt(1, Location::RequiresRegister());
+  } else {
+    locations->SetInAt(1, Location::Any());
+  }
   // Note that TypeCheckSlowPathX86_64 uses this "out" register too.
   locations->SetOut(Location::RequiresRegister());
-  // When read barriers are enabled, we need a temporary register for
-  // some cases.
+  // We need a temporary register for the interface check, and when read
+  // barriers are enabled, for some other cases.
   if (InstanceOfTypeCheckNeedsATemporary(type_check_kind)) {
     locations->AddTemp(Location::RequiresRegister());
   }
@@ -6034,6 +6233,9 @@ void InstructionCodeGeneratorX86_64::VisitInstanceOf(HInstanceOf* instruction) {
   uint32_t super_offset = mirror::Class::SuperClassOffset().Int32Value();
   uint32_t component_offset = mirror::Class::ComponentTypeOffset().Int32Value();
   uint32_t primitive_offset = mirror::Class::PrimitiveTypeOffset().Int32Value();
+  uint32_t iftable_offset = mirror::Class::IfTableOffset().Uint32Value();
+  uint32_t array_length_offset = mirror::Array::LengthOffset().Uint32Value();
+  uint32_t object_array_data_offset = mirror::Array::DataOffset(kHeapReferenceSize).Uint32Value();
   SlowPathCode* slow_path = nullptr;
   NearLabel done, zero;
 
@@ -6208,11 +6410,63 @@ void InstructionCodeGeneratorX86_64::VisitInstanceOf(HInstanceOf* instruction) {
       break;
     }
 
-    case TypeCheckKind::kUnresolvedCheck:
     case TypeCheckKind::kInterfaceCheck: {
+      // Fast path for the interface check, as in VisitCheckCast. Try to avoid read barriers to
+      // improve the fast path. We can not get false positives by doing this, but without read
+      // barriers a miss can only be a negative answer.
+      CpuRegister temp = maybe_temp_loc.AsRegister<CpuRegister>();
+      CpuRegister cls_reg = cls.AsRegister<CpuRegister>();
+      // /* HeapReference<Class> */ out = obj->klass_
+      GenerateReferenceLoadTwoRegisters(instruction,
+                                        out_loc,
+                                        obj_loc,
+                                        class_offset,
+                                        kWithoutReadBarrier);
+      // /* HeapReference<Class> */ out = out->iftable_
+      GenerateReferenceLoadTwoRegisters(instruction,
+                                        out_loc,
+                                        out_loc,
+                                        iftable_offset,
+                                        kWithoutReadBarrier);
+      // Iftable is never null.
+      __ movl(temp, Address(out, array_length_offset));
+      // Maybe poison the `cls` for direct comparison with memory.
+      __ MaybePoisonHeapReference(cls_reg);
+      // Loop through the iftable and check if any class matches.
+      NearLabel start_loop, not_found;
+      __ Bind(&start_loop);
+      // Need to subtract first to handle the empty array case.
+      __ subl(temp, Immediate(2));
+      __ j(kNegative, &not_found);
+      // Go to next interface if the classes do not match.
+      __ cmpl(cls_reg,
+              CodeGeneratorX86_64::ArrayAddress(out,
+                                                maybe_temp_loc,
+                                                TIMES_4,
+                                                object_array_data_offset));
+      __ j(kNotEqual, &start_loop);
+      // If `cls` was poisoned above, unpoison it.
+      __ MaybeUnpoisonHeapReference(cls_reg);
+      __ movl(out, Immediate(1));
+      __ jmp(&done);
+      __ Bind(&not_found);
+      __ MaybeUnpoisonHeapReference(cls_reg);
+      if (kEmitCompilerReadBarrier) {
+        // The iftable may hold from-space references, let the runtime decide.
+        DCHECK(locations->OnlyCallsOnSlowPath());
+        slow_path = new (codegen_->GetScopedAllocator()) TypeCheckSlowPathX86_64(
+            instruction, /* is_fatal */ false);
+        codegen_->AddSlowPath(slow_path);
+        __ jmp(slow_path->GetEntryLabel());
+      } else {
+        __ jmp(&zero);
+      }
+      break;
+    }
+
+    case TypeCheckKind::kUnresolvedCheck: {
       // Note that we indeed only call on slow path, but we always go
-      // into the slow path for the unresolved and interface check
-      // cases.
+      // into the slow path for the unresolved check case.
       //
       // We cannot directly call the InstanceofNonTrivial runtime
       // entry point without resorting to a type checking slow path
@@ -6580,7 +6834,9 @@ void LocationsBuilderX86_64::HandleBitwiseOperation(HBinaryOperation* instructio
   DCHECK(instruction->GetResultType() == DataType::Type::kInt32
          || instruction->GetResultType() == DataType::Type::kInt64);
   locations->SetInAt(0, Location::RequiresRegister());
-  locations->SetInAt(1, Location::Any());
+  if (!CodeGeneratorX86_64::IsFoldedArrayGet(instruction->InputAt(1))) {
+    locations->SetInAt(1, Location::Any());
+  }
   locations->SetOut(Location::SameAsFirstInput());
 }
 
@@ -6602,6 +6858,33 @@ void InstructionCodeGeneratorX86_64::HandleBitwiseOperation(HBinaryOperation* in
   Location second = locations->InAt(1);
   DCHECK(first.Equals(locations->Out()));
 
+  if (CodeGeneratorX86_64::IsFoldedArrayGet(instruction->InputAt(1))) {
+    CpuRegister first_reg = first.AsRegister<CpuRegister>();
+    Address address = CodeGeneratorX86_64::FoldedArrayGetAddress(instruction->InputAt(1));
+    if (instruction->GetResultType() == DataType::Type::kInt32) {
+      if (instruction->IsAnd()) {
+        __ andl(first_reg, address);
+      } else if (instruction->IsOr()) {
+        __ orl(first_reg, address);
+      } else {
+        DCHECK(instruction->IsXor());
+        __ xorl(first_reg, address);
+      }
+    } else {
+      DCHECK_EQ(instruction->GetResultType(), DataType::Type::kInt64);
+      if (instruction->IsAnd()) {
+        __ andq(first_reg, address);
+      } else if (instruction->IsOr()) {
+        __ orq(first_reg, address);
+      } else {
+        DCHECK(instruction->IsXor());
+        __ xorq(first_reg, address);
+      }
+    }
+    codegen_->MaybeRecordFoldedArrayGetNullCheck(instruction->InputAt(1));
+    return;
+  }
+
   if (instruction->GetResultType() == DataType::Type::kInt32) {
     if (second.IsRegister()) {
       if (instruction->IsAnd()) {
@@ -7203,6 +7486,18 @@ Address CodeGeneratorX86_64::ArrayAddress(CpuRegister obj,
       Address(obj, index.AsRegister<CpuRegister>(), scale, data_offset);
 }
 
+Address CodeGeneratorX86_64::FoldedArrayGetAddress(HInstruction* instruction) {
+  DCHECK(IsFoldedArrayGet(instruction));
+  HArrayGet* array_get = instruction->AsArrayGet();
+  LocationSummary* locations = array_get->GetLocations();
+  DataType::Type type = array_get->GetType();
+  DCHECK(type == DataType::Type::kInt32 || type == DataType::Type::kInt64) << type;
+  return ArrayAddress(locations->InAt(0).AsRegister<CpuRegister>(),
+                      locations->InAt(1),
+                      type == DataType::Type::kInt64 ? TIMES_8 : TIMES_4,
+                      CodeGenerator::GetArrayDataOffset(array_get));
+}
+
 void CodeGeneratorX86_64::Store64BitValueToStack(Location dest, int64_t value) {
   DCHECK(dest.IsDoubleStackSlot());
   if (IsInt<32>(value)) {
@@ -47,6 +47,10 @@ static constexpr FloatRegister kRuntimeParameterFpuRegisters[] = { XMM0, XMM1 };
 static constexpr size_t kRuntimeParameterFpuRegistersLength =
     arraysize(kRuntimeParameterFpuRegisters);
 
+// Estimate of the average size of the code generated for an HInstruction, used to size the
+// assembler buffer before generating the code of a method.
+static constexpr size_t kEstimatedCodeSizePerInstruction = 8u;
+
 // These XMM registers are non-volatile in ART ABI, but volatile in native ABI.
 // If the ART ABI changes, this list must be updated.  It is used to ensure that
 // these are not clobbered by any direct call to native code (such as math intrinsics).
@@ -143,6 +147,7 @@ class ParallelMoveResolverX86_64 : public ParallelMoveResolverWithSwap {
   void Exchange64(CpuRegister reg, int mem);
   void Exchange64(XmmRegister reg, int mem);
   void Exchange128(XmmRegister reg, int mem);
+  void Exchange256(XmmRegister reg, int mem);
   void ExchangeMemory32(int mem1, int mem2);
   void ExchangeMemory64(int mem1, int mem2, int num_of_qwords);
 
@@ -268,6 +273,9 @@ class InstructionCodeGeneratorX86_64 : public InstructionCodeGenerator {
   void PushOntoFPStack(Location source, uint32_t temp_offset,
                        uint32_t stack_adjustment, bool is_float);
   void GenerateCompareTest(HCondition* condition);
+  // Compare `lhs` with the second input of the condition or compare `instruction`,
+  // which is either in `rhs` or a folded array load.
+  void GenerateCompareWithSecondInput(HInstruction* instruction, Location lhs, Location rhs);
   template<class LabelType>
   void GenerateTestAndBranch(HInstruction* instruction,
                              size_t condition_input_index,
@@ -330,6 +338,9 @@ class CodeGeneratorX86_64 : public CodeGenerator {
   }
 
   size_t GetFloatingPointSpillSlotSize() const OVERRIDE {
+    if (GetGraph()->HasWideSIMD()) {
+      return 4 * kX86_64WordSize;  // 32 bytes == 4 x86_64 words for each spill
+    }
     return GetGraph()->HasSIMD()
         ? 2 * kX86_64WordSize   // 16 bytes == 2 x86_64 words for each spill
         : 1 * kX86_64WordSize;  //  8 bytes == 1 x86_64 words for each spill
@@ -386,6 +397,9 @@ class CodeGeneratorX86_64 : public CodeGenerator {
 
   void Initialize() OVERRIDE {
     block_labels_ = CommonInitializeLabels<Label>();
+    // The instruction ids are an upper bound of the number of instructions.
+    assembler_.ReserveCodeSize(GetGraph()->GetCurrentInstructionId() *
+                               kEstimatedCodeSizePerInstruction);
   }
 
   bool NeedsTwoRegisters(DataType::Type type ATTRIBUTE_UNUSED) const OVERRIDE {
@@ -558,6 +572,23 @@ class CodeGeneratorX86_64 : public CodeGenerator {
                               ScaleFactor scale,
                               uint32_t data_offset);
 
+  // Whether `instruction` is an array load that X86MemoryOperandGeneration folded into
+  // its user, which then reads the element as a memory operand.
+  static bool IsFoldedArrayGet(HInstruction* instruction) {
+    return instruction->IsArrayGet() && instruction->IsEmittedAtUseSite();
+  }
+
+  // Construct address for a folded array load, from the locations of its inputs.
+  static Address FoldedArrayGetAddress(HInstruction* instruction);
+
+  // Whether the implicit `null_check` can be done by the user of the folded array load
+  // right after it.
+  bool CanMoveNullCheckToFoldedArrayGet(HNullCheck* null_check);
+
+  // Record the null check moved to the user of the folded `array_get`, which has just
+  // emitted the instruction reading the element.
+  void MaybeRecordFoldedArrayGetNullCheck(HInstruction* array_get);
+
   Address LiteralCaseTable(HPackedSwitch* switch_instr);
 
   // Store a 64 bit value into a DoubleStackSlot in the most efficient manner.
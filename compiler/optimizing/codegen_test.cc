@@ -820,6 +820,37 @@ TEST_F(CodegenTest, ARM64ParallelMoveResolverSIMD) {
   InternalCodeAllocator code_allocator;
   codegen.Finalize(&code_allocator);
 }
+
+// Check the instruction counts and cycle estimates of the ARM64 simulator on known code.
+TEST_F(CodegenTest, ARM64SimulatorInstructionCounting) {
+  CodeSimulatorContainer simulator(InstructionSet::kArm64);
+  if (!simulator.CanSimulate()) {
+    return;
+  }
+  static const uint32_t kCode[] = {
+    0x52800060u,  // movz w0, #3
+    0x11000800u,  // add w0, w0, #2
+    0x1b007c00u,  // mul w0, w0, w0
+    0xd65f03c0u,  // ret
+  };
+  simulator.Get()->RunFrom(reinterpret_cast<intptr_t>(kCode));
+  EXPECT_EQ(25, simulator.Get()->GetCReturnInt32());
+  // Counting is off by default.
+  EXPECT_EQ(0u, simulator.Get()->GetInstructionCount());
+  EXPECT_EQ(0u, simulator.Get()->GetEstimatedCycles());
+
+  simulator.Get()->EnableInstructionCounting();
+  simulator.Get()->RunFrom(reinterpret_cast<intptr_t>(kCode));
+  EXPECT_EQ(25, simulator.Get()->GetCReturnInt32());
+  EXPECT_EQ(4u, simulator.Get()->GetInstructionCount());
+  // One cycle each, but three for the multiply.
+  EXPECT_EQ(6u, simulator.Get()->GetEstimatedCycles());
+
+  // The counts add up across runs.
+  simulator.Get()->RunFrom(reinterpret_cast<intptr_t>(kCode));
+  EXPECT_EQ(8u, simulator.Get()->GetInstructionCount());
+  EXPECT_EQ(12u, simulator.Get()->GetEstimatedCycles());
+}
 #endif
 
 #ifdef ART_ENABLE_CODEGEN_mips
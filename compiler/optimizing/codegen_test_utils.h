@@ -246,7 +246,13 @@ static void VerifyGeneratedCode(InstructionSet target_isa,
   // Verify on simulator.
   CodeSimulatorContainer simulator(target_isa);
   if (simulator.CanSimulate()) {
+    if (VLOG_IS_ON(compiler)) {
+      simulator.Get()->EnableInstructionCounting();
+    }
     Expected result = SimulatorExecute<Expected>(simulator.Get(), f);
+    VLOG(compiler) << "Simulated " << simulator.Get()->GetInstructionCount()
+                   << " instructions, about " << simulator.Get()->GetEstimatedCycles()
+                   << " cycles";
     if (has_result) {
       ASSERT_EQ(expected, result);
     }
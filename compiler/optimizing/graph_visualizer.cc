@@ -418,6 +418,12 @@ class HGraphVisualizerPrinter : public HGraphDelegateVisitor {
   void VisitArrayGet(HArrayGet* array_get) OVERRIDE {
     StartAttributeStream("is_string_char_at") << std::boolalpha
         << array_get->IsStringCharAt() << std::noboolalpha;
+    if (array_get->IsReadBarrierFree()) {
+      StartAttributeStream("read_barrier_free") << "true";
+    }
+    if (array_get->IsEmittedAtUseSite()) {
+      StartAttributeStream("emitted_at_use") << "true";
+    }
   }
 
   void VisitArraySet(HArraySet* array_set) OVERRIDE {
@@ -480,6 +486,9 @@ class HGraphVisualizerPrinter : public HGraphDelegateVisitor {
         iget->GetFieldInfo().GetDexFile().PrettyField(iget->GetFieldInfo().GetFieldIndex(),
                                                       /* with type */ false);
     StartAttributeStream("field_type") << iget->GetFieldType();
+    if (iget->IsReadBarrierFree()) {
+      StartAttributeStream("read_barrier_free") << "true";
+    }
   }
 
   void VisitInstanceFieldSet(HInstanceFieldSet* iset) OVERRIDE {
@@ -527,6 +536,12 @@ class HGraphVisualizerPrinter : public HGraphDelegateVisitor {
     StartAttributeStream("kind") << deoptimize->GetKind();
   }
 
+  void VisitSuspendCheck(HSuspendCheck* suspend_check) OVERRIDE {
+    if (suspend_check->IsPollElided()) {
+      StartAttributeStream("poll_elided") << "true";
+    }
+  }
+
   void VisitVecOperation(HVecOperation* vec_operation) OVERRIDE {
     StartAttributeStream("packed_type") << vec_operation->GetPackedType();
   }
@@ -16,6 +16,7 @@
 
 #include "inliner.h"
 
+#include "art_field-inl.h"
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "builder.h"
@@ -35,6 +36,7 @@
 #include "jit/jit_code_cache.h"
 #include "mirror/class_loader.h"
 #include "mirror/dex_cache.h"
+#include "mirror/var_handle.h"
 #include "nodes.h"
 #include "optimizing_compiler.h"
 #include "reference_type_propagation.h"
@@ -63,9 +65,28 @@ static constexpr size_t kMaximumNumberOfCumulatedDexRegisters = 32;
 // much inlining compared to code locality.
 static constexpr size_t kMaximumNumberOfRecursiveCalls = 4;
 
+// Hot call sites get that many times the code item and dex register limits. Cold call
+// sites only inline methods no bigger than an invoke, so that the code size stays flat.
+static constexpr size_t kHotCallSiteBudgetFactor = 2;
+static constexpr size_t kMaximumNumberOfCodeUnitsForColdCallSite = 3;
+
+// Methods too big to inline as is are still considered, up to that many times the code item
+// limit, at hot call sites passing constant arguments. They are inlined only if constant folding
+// and dead code elimination bring the callee back within the code item limit, in
+// instructions, which specializes the callee on the constants of the call site.
+static constexpr size_t kSpecializationBudgetFactor = 4;
+
+// Minimum number of hits of the JIT inline cache for considering a call site hot.
+static constexpr uint32_t kMinimumHitsForHotCallSite = 1000;
+
 // Controls the use of inline caches in AOT mode.
 static constexpr bool kUseAOTInlineCaches = true;
 
+// Megamorphic calls inline the receivers that account for at least that share of the hits
+// of the inline cache, up to kMaximumNumberOfMegamorphicTargets of them.
+static constexpr size_t kMinimumMegamorphicTargetPercentage = 20;
+static constexpr size_t kMaximumNumberOfMegamorphicTargets = 3;
+
 // We check for line numbers to make sure the DepthString implementation
 // aligns the output nicely.
 #define LOG_INTERNAL(msg) \
@@ -135,6 +156,12 @@ void HInliner::Run() {
   // to HInliner::Run have already updated the instruction count.
   if (outermost_graph_ == graph_) {
     total_number_of_instructions_ = CountNumberOfInstructions(graph_);
+    const CompilerOptions& compiler_options = compiler_driver_->GetCompilerOptions();
+    const CompilerOptions::MethodOptions* method_options = compiler_options.HasMethodOptions()
+        ? compiler_options.GetMethodOptions(
+              graph_->GetDexFile().PrettyMethod(graph_->GetMethodIdx()))
+        : nullptr;
+    inline_max_code_units_ = compiler_options.GetInlineMaxCodeUnits(method_options);
   }
 
   UpdateInliningBudget();
@@ -445,13 +472,15 @@ static bool AlwaysThrows(CompilerDriver* const compiler_driver, ArtMethod* metho
 }
 
 bool HInliner::TryInline(HInvoke* invoke_instruction) {
-  if (invoke_instruction->IsInvokeUnresolved() ||
-      invoke_instruction->IsInvokePolymorphic()) {
-    return false;  // Don't bother to move further if we know the method is unresolved or an
-                   // invoke-polymorphic.
+  if (invoke_instruction->IsInvokeUnresolved()) {
+    return false;  // Don't bother to move further if we know the method is unresolved.
   }
 
   ScopedObjectAccess soa(Thread::Current());
+  if (invoke_instruction->IsInvokePolymorphic()) {
+    // There is no method to inline, but an access through a known VarHandle can be replaced.
+    return TryReplaceVarHandleAccess(invoke_instruction->AsInvokePolymorphic());
+  }
   uint32_t method_index = invoke_instruction->GetDexMethodIndex();
   const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
   LOG_TRY() << caller_dex_file.PrettyMethod(method_index);
@@ -572,9 +601,11 @@ bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
 
   StackHandleScope<1> hs(Thread::Current());
   Handle<mirror::ObjectArray<mirror::Class>> inline_cache;
+  // Offline profiles do not record hits.
+  uint16_t counts[InlineCache::kIndividualCacheSize] = {};
   InlineCacheType inline_cache_type = Runtime::Current()->IsAotCompiler()
       ? GetInlineCacheAOT(caller_dex_file, invoke_instruction, &hs, &inline_cache)
-      : GetInlineCacheJIT(invoke_instruction, &hs, &inline_cache);
+      : GetInlineCacheJIT(invoke_instruction, &hs, &inline_cache, counts);
 
   switch (inline_cache_type) {
     case kInlineCacheNoData: {
@@ -596,7 +627,8 @@ bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
     case kInlineCacheMonomorphic: {
       MaybeRecordStat(stats_, MethodCompilationStat::kMonomorphicCall);
       if (UseOnlyPolymorphicInliningWithNoDeopt()) {
-        return TryInlinePolymorphicCall(invoke_instruction, resolved_method, inline_cache);
+        return TryInlinePolymorphicCall(
+            invoke_instruction, resolved_method, inline_cache, /* megamorphic */ false);
       } else {
         return TryInlineMonomorphicCall(invoke_instruction, resolved_method, inline_cache);
       }
@@ -604,15 +636,19 @@ bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
 
     case kInlineCachePolymorphic: {
       MaybeRecordStat(stats_, MethodCompilationStat::kPolymorphicCall);
-      return TryInlinePolymorphicCall(invoke_instruction, resolved_method, inline_cache);
+      return TryInlinePolymorphicCall(
+          invoke_instruction, resolved_method, inline_cache, /* megamorphic */ false);
     }
 
     case kInlineCacheMegamorphic: {
+      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
+      if (TryInlineMegamorphicCall(invoke_instruction, resolved_method, inline_cache, counts)) {
+        return true;
+      }
       LOG_FAIL_NO_STAT()
           << "Interface or virtual call to "
           << caller_dex_file.PrettyMethod(invoke_instruction->GetDexMethodIndex())
           << " is megamorphic and not inlined";
-      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
       return false;
     }
 
@@ -630,7 +666,8 @@ bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
 HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
     HInvoke* invoke_instruction,
     StackHandleScope<1>* hs,
-    /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache)
+    /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache,
+    /*out*/uint16_t* counts)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   DCHECK(Runtime::Current()->UseJitCompilation());
 
@@ -651,11 +688,51 @@ HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
   } else {
     Runtime::Current()->GetJit()->GetCodeCache()->CopyInlineCacheInto(
         *profiling_info->GetInlineCache(invoke_instruction->GetDexPc()),
-        *inline_cache);
+        *inline_cache,
+        counts);
     return GetInlineCacheType(*inline_cache);
   }
 }
 
+HInliner::CallSiteHotness HInliner::GetCallSiteHotness(HInvoke* invoke_instruction,
+                                                       ArtMethod* method) {
+  if (Runtime::Current()->UseJitCompilation()) {
+    // Only virtual and interface calls have an inline cache.
+    if (!invoke_instruction->IsInvokeVirtual() && !invoke_instruction->IsInvokeInterface()) {
+      return kCallSiteHotnessUnknown;
+    }
+    ArtMethod* caller = graph_->GetArtMethod();
+    DCHECK(caller != nullptr);
+    ScopedProfilingInfoInlineUse spiis(caller, Thread::Current());
+    ProfilingInfo* profiling_info = spiis.GetProfilingInfo();
+    if (profiling_info == nullptr) {
+      return kCallSiteHotnessUnknown;
+    }
+    uint32_t hits = profiling_info->GetInlineCache(invoke_instruction->GetDexPc())->GetTotalCount();
+    if (hits == 0u) {
+      return kCallSiteCold;  // not executed since the caller became warm
+    }
+    return (hits >= kMinimumHitsForHotCallSite) ? kCallSiteHot : kCallSiteHotnessUnknown;
+  }
+  if (!Runtime::Current()->IsAotCompiler()) {
+    return kCallSiteHotnessUnknown;
+  }
+  const ProfileCompilationInfo* pci = compiler_driver_->GetProfileCompilationInfo();
+  if (pci == nullptr) {
+    return kCallSiteHotnessUnknown;
+  }
+  ProfileCompilationInfo::MethodHotness hotness =
+      pci->GetMethodHotness(MethodReference(method->GetDexFile(), method->GetDexMethodIndex()));
+  if (hotness.IsHot()) {
+    return kCallSiteHot;
+  }
+  // Methods only run during startup are not worth growing their hot callers for.
+  if (hotness.IsStartup() && !hotness.IsPostStartup()) {
+    return kCallSiteCold;
+  }
+  return kCallSiteHotnessUnknown;
+}
+
 HInliner::InlineCacheType HInliner::GetInlineCacheAOT(
     const DexFile& caller_dex_file,
     HInvoke* invoke_instruction,
@@ -869,6 +946,42 @@ bool HInliner::TryInlineMonomorphicCall(HInvoke* invoke_instruction,
   return true;
 }
 
+HInvokeStaticOrDirect* HInliner::BuildDirectInvokeForCHA(HInvoke* invoke_instruction,
+                                                         ArtMethod* method) {
+  DCHECK(!invoke_instruction->IsInvokeStaticOrDirect());
+  DCHECK(!method->IsAbstract());
+  HInvokeStaticOrDirect::DispatchInfo dispatch_info = {
+      HInvokeStaticOrDirect::MethodLoadKind::kRuntimeCall,
+      HInvokeStaticOrDirect::CodePtrLocation::kCallArtMethod,
+      0u
+  };
+  // The receiver is an instance of the class of `method`, which is thus initialized. Keep the
+  // dex method index of the invoke, as `method` may not be referenced by the caller's dex file.
+  // It is only used by the kRuntimeCall load kind, which sharpening replaces below.
+  HInvokeStaticOrDirect* new_invoke = new (graph_->GetAllocator()) HInvokeStaticOrDirect(
+      graph_->GetAllocator(),
+      invoke_instruction->GetNumberOfArguments(),
+      invoke_instruction->GetType(),
+      invoke_instruction->GetDexPc(),
+      invoke_instruction->GetDexMethodIndex(),
+      method,
+      dispatch_info,
+      kDirect,
+      MethodReference(method->GetDexFile(), method->GetDexMethodIndex()),
+      HInvokeStaticOrDirect::ClinitCheckRequirement::kNone);
+  for (size_t index = 0; index != invoke_instruction->GetNumberOfArguments(); ++index) {
+    new_invoke->SetArgumentAt(index, invoke_instruction->InputAt(index));
+  }
+  new_invoke->SetArgumentAt(new_invoke->GetSpecialInputIndex(), graph_->GetCurrentMethod());
+  invoke_instruction->GetBlock()->InsertInstructionBefore(new_invoke, invoke_instruction);
+  new_invoke->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+  if (invoke_instruction->GetType() == DataType::Type::kReference) {
+    new_invoke->SetReferenceTypeInfo(invoke_instruction->GetReferenceTypeInfo());
+  }
+  HSharpening::SharpenInvokeStaticOrDirect(new_invoke, codegen_, compiler_driver_);
+  return new_invoke;
+}
+
 void HInliner::AddCHAGuard(HInstruction* invoke_instruction,
                            uint32_t dex_pc,
                            HInstruction* cursor,
@@ -968,13 +1081,51 @@ HInstruction* HInliner::AddTypeGuard(HInstruction* receiver,
   return compare;
 }
 
+bool HInliner::TryInlineMegamorphicCall(HInvoke* invoke_instruction,
+                                        ArtMethod* resolved_method,
+                                        Handle<mirror::ObjectArray<mirror::Class>> classes,
+                                        const uint16_t* counts) {
+  uint32_t total_count = 0u;
+  for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+    total_count += counts[i];
+  }
+  if (total_count == 0u) {
+    // No hits recorded, for instance with an offline profile.
+    return false;
+  }
+  size_t number_of_targets = 0;
+  while (number_of_targets < kMaximumNumberOfMegamorphicTargets &&
+         classes->Get(number_of_targets) != nullptr &&
+         counts[number_of_targets] * 100u >= total_count * kMinimumMegamorphicTargetPercentage) {
+    ++number_of_targets;
+  }
+  if (number_of_targets == 0) {
+    return false;
+  }
+  // Drop the other receivers, they go through the original invoke.
+  for (size_t i = number_of_targets; i < InlineCache::kIndividualCacheSize; ++i) {
+    classes->Set(i, nullptr);
+  }
+  LOG_NOTE() << "Megamorphic call to " << ArtMethod::PrettyMethod(resolved_method)
+             << " has " << number_of_targets << " frequent receivers";
+  if (!TryInlinePolymorphicCall(
+          invoke_instruction, resolved_method, classes, /* megamorphic */ true)) {
+    return false;
+  }
+  MaybeRecordStat(stats_, MethodCompilationStat::kInlinedMegamorphicCall);
+  return true;
+}
+
 bool HInliner::TryInlinePolymorphicCall(HInvoke* invoke_instruction,
                                         ArtMethod* resolved_method,
-                                        Handle<mirror::ObjectArray<mirror::Class>> classes) {
+                                        Handle<mirror::ObjectArray<mirror::Class>> classes,
+                                        bool megamorphic) {
   DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
       << invoke_instruction->DebugName();
 
-  if (TryInlinePolymorphicCallToSameTarget(invoke_instruction, resolved_method, classes)) {
+  // The same target guard deoptimizes for the receivers not in `classes`.
+  if (!megamorphic &&
+      TryInlinePolymorphicCallToSameTarget(invoke_instruction, resolved_method, classes)) {
     return true;
   }
 
@@ -1022,6 +1173,7 @@ bool HInliner::TryInlinePolymorphicCall(HInvoke* invoke_instruction,
       // If we have inlined all targets before, and this receiver is the last seen,
       // we deoptimize instead of keeping the original invoke instruction.
       bool deoptimize = !UseOnlyPolymorphicInliningWithNoDeopt() &&
+          !megamorphic &&
           all_targets_inlined &&
           (i != InlineCache::kIndividualCacheSize - 1) &&
           (classes->Get(i + 1) == nullptr);
@@ -1315,7 +1467,14 @@ bool HInliner::TryInlineAndReplace(HInvoke* invoke_instruction,
       // invoke_instruction is intrinsified and stays.
     }
   } else if (!TryBuildAndInline(invoke_instruction, method, receiver_type, &return_replacement)) {
-    if (invoke_instruction->IsInvokeInterface()) {
+    if (cha_devirtualize && !method->IsDefaultConflicting()) {
+      // The CHA guard deoptimizes once `method` stops being the single implementation, so
+      // call it directly instead of going through the vtable or the IMT.
+      return_replacement = BuildDirectInvokeForCHA(invoke_instruction, method);
+      MaybeRecordStat(stats_, MethodCompilationStat::kCHADirectCall);
+      // invoke_instruction is replaced with the direct invoke.
+      should_remove_invoke_instruction = true;
+    } else if (invoke_instruction->IsInvokeInterface()) {
       DCHECK(!method->IsProxyMethod());
       // Turn an invoke-interface into an invoke-virtual. An invoke-virtual is always
       // better than an invoke-interface because:
@@ -1403,6 +1562,16 @@ size_t HInliner::CountRecursiveCallsOf(ArtMethod* method) const {
   return count;
 }
 
+// Returns whether `invoke_instruction` passes a constant for one of the arguments.
+static bool HasConstantArguments(HInvoke* invoke_instruction) {
+  for (size_t i = 0, e = invoke_instruction->GetNumberOfArguments(); i != e; ++i) {
+    if (invoke_instruction->InputAt(i)->IsConstant()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool HInliner::TryBuildAndInline(HInvoke* invoke_instruction,
                                  ArtMethod* method,
                                  ReferenceTypeInfo receiver_type,
@@ -1450,8 +1619,31 @@ bool HInliner::TryBuildAndInline(HInvoke* invoke_instruction,
     return false;
   }
 
-  size_t inline_max_code_units = compiler_driver_->GetCompilerOptions().GetInlineMaxCodeUnits();
-  if (accessor.InsnsSizeInCodeUnits() > inline_max_code_units) {
+  size_t inline_max_code_units = inline_max_code_units_;
+  CallSiteHotness hotness = GetCallSiteHotness(invoke_instruction, method);
+  if (hotness == kCallSiteHot) {
+    inline_max_code_units *= kHotCallSiteBudgetFactor;
+  } else if (hotness == kCallSiteCold) {
+    inline_max_code_units =
+        std::min(inline_max_code_units, kMaximumNumberOfCodeUnitsForColdCallSite);
+  }
+  size_t specialization_budget = 0u;
+  if (accessor.InsnsSizeInCodeUnits() > inline_max_code_units &&
+      hotness == kCallSiteHot &&
+      HasConstantArguments(invoke_instruction) &&
+      accessor.InsnsSizeInCodeUnits() <= inline_max_code_units * kSpecializationBudgetFactor) {
+    // Try to specialize the callee on the constant arguments, checked once it is built.
+    specialization_budget = inline_max_code_units;
+  } else if (accessor.InsnsSizeInCodeUnits() > inline_max_code_units) {
+    if (hotness == kCallSiteCold) {
+      LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedColdCallSite)
+          << "Method " << method->PrettyMethod()
+          << " is not inlined because the call site is cold and its code item is too big: "
+          << accessor.InsnsSizeInCodeUnits()
+          << " > "
+          << inline_max_code_units;
+      return false;
+    }
     LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedCodeItem)
         << "Method " << method->PrettyMethod()
         << " is not inlined because its code item is too big: "
@@ -1492,13 +1684,24 @@ bool HInliner::TryBuildAndInline(HInvoke* invoke_instruction,
     return false;
   }
 
-  if (!TryBuildAndInlineHelper(
-          invoke_instruction, method, receiver_type, same_dex_file, return_replacement)) {
+  if (!TryBuildAndInlineHelper(invoke_instruction,
+                               method,
+                               receiver_type,
+                               same_dex_file,
+                               hotness,
+                               specialization_budget,
+                               return_replacement)) {
     return false;
   }
 
   LOG_SUCCESS() << method->PrettyMethod();
   MaybeRecordStat(stats_, MethodCompilationStat::kInlinedInvoke);
+  if (hotness == kCallSiteHot) {
+    MaybeRecordStat(stats_, MethodCompilationStat::kInlinedHotCallSite);
+  }
+  if (specialization_budget != 0u) {
+    MaybeRecordStat(stats_, MethodCompilationStat::kInlinedSpecializedOnConstants);
+  }
   return true;
 }
 
@@ -1699,6 +1902,328 @@ HInstanceFieldSet* HInliner::CreateInstanceFieldSet(uint32_t field_index,
   return iput;
 }
 
+// Return whether the type `type_index` of the caller's dex file resolves to `klass`.
+static bool IsResolvedTypeOf(const DexCompilationUnit& compilation_unit,
+                             dex::TypeIndex type_index,
+                             ObjPtr<mirror::Class> klass)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ObjPtr<mirror::Class> resolved = compilation_unit.GetClassLinker()->LookupResolvedType(
+      type_index, compilation_unit.GetDexCache().Get(), compilation_unit.GetClassLoader().Get());
+  return resolved != nullptr && resolved == klass;
+}
+
+// Return the method of sun.misc.Unsafe that performs the atomic update `access_mode` of a field
+// of type `type`, or null if there is none.
+static ArtMethod* FindUnsafeMethodForVarHandleAccess(ObjPtr<mirror::Class> unsafe_class,
+                                                     mirror::VarHandle::AccessMode access_mode,
+                                                     DataType::Type type,
+                                                     PointerSize pointer_size)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  const char* name = nullptr;
+  const char* signature = nullptr;
+  switch (access_mode) {
+    case mirror::VarHandle::AccessMode::kCompareAndSet:
+    case mirror::VarHandle::AccessMode::kWeakCompareAndSet:
+    case mirror::VarHandle::AccessMode::kWeakCompareAndSetPlain:
+    case mirror::VarHandle::AccessMode::kWeakCompareAndSetAcquire:
+    case mirror::VarHandle::AccessMode::kWeakCompareAndSetRelease:
+      // A strong compare-and-swap is a valid implementation of the weak ones.
+      if (type == DataType::Type::kInt32) {
+        name = "compareAndSwapInt";
+        signature = "(Ljava/lang/Object;JII)Z";
+      } else if (type == DataType::Type::kInt64) {
+        name = "compareAndSwapLong";
+        signature = "(Ljava/lang/Object;JJJ)Z";
+      } else if (type == DataType::Type::kReference) {
+        name = "compareAndSwapObject";
+        signature = "(Ljava/lang/Object;JLjava/lang/Object;Ljava/lang/Object;)Z";
+      }
+      break;
+    case mirror::VarHandle::AccessMode::kGetAndSet:
+    case mirror::VarHandle::AccessMode::kGetAndSetAcquire:
+    case mirror::VarHandle::AccessMode::kGetAndSetRelease:
+      if (type == DataType::Type::kInt32) {
+        name = "getAndSetInt";
+        signature = "(Ljava/lang/Object;JI)I";
+      } else if (type == DataType::Type::kInt64) {
+        name = "getAndSetLong";
+        signature = "(Ljava/lang/Object;JJ)J";
+      } else if (type == DataType::Type::kReference) {
+        name = "getAndSetObject";
+        signature = "(Ljava/lang/Object;JLjava/lang/Object;)Ljava/lang/Object;";
+      }
+      break;
+    case mirror::VarHandle::AccessMode::kGetAndAdd:
+    case mirror::VarHandle::AccessMode::kGetAndAddAcquire:
+    case mirror::VarHandle::AccessMode::kGetAndAddRelease:
+      if (type == DataType::Type::kInt32) {
+        name = "getAndAddInt";
+        signature = "(Ljava/lang/Object;JI)I";
+      } else if (type == DataType::Type::kInt64) {
+        name = "getAndAddLong";
+        signature = "(Ljava/lang/Object;JJ)J";
+      }
+      break;
+    default:
+      break;
+  }
+  return (name != nullptr) ? unsafe_class->FindClassMethod(name, signature, pointer_size)
+                           : nullptr;
+}
+
+bool HInliner::TryReplaceVarHandleAccess(HInvokePolymorphic* invoke_instruction) {
+  // The VarHandle must be known at compile time, and fixed.
+  if (!Runtime::Current()->UseJitCompilation()) {
+    return false;
+  }
+  const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
+  const DexFile::MethodId& method_id =
+      caller_dex_file.GetMethodId(invoke_instruction->GetDexMethodIndex());
+  mirror::VarHandle::AccessMode access_mode;
+  if (strcmp(caller_dex_file.GetMethodDeclaringClassDescriptor(method_id),
+             "Ljava/lang/invoke/VarHandle;") != 0 ||
+      !mirror::VarHandle::GetAccessModeByMethodName(caller_dex_file.GetMethodName(method_id),
+                                                    &access_mode)) {
+    return false;
+  }
+  // The plain accesses keep the ordering of the field, the others are made volatile, which is
+  // stronger than the opaque, acquire and release orderings. The atomic updates are done by the
+  // methods of sun.misc.Unsafe, which are volatile too.
+  bool is_get = false;
+  bool is_set = false;
+  bool is_compare_and_set = false;
+  bool is_volatile = true;
+  switch (access_mode) {
+    case mirror::VarHandle::AccessMode::kGet:
+      is_get = true;
+      is_volatile = false;
+      break;
+    case mirror::VarHandle::AccessMode::kSet:
+      is_set = true;
+      is_volatile = false;
+      break;
+    case mirror::VarHandle::AccessMode::kGetVolatile:
+    case mirror::VarHandle::AccessMode::kGetAcquire:
+    case mirror::VarHandle::AccessMode::kGetOpaque:
+      is_get = true;
+      break;
+    case mirror::VarHandle::AccessMode::kSetVolatile:
+    case mirror::VarHandle::AccessMode::kSetRelease:
+    case mirror::VarHandle::AccessMode::kSetOpaque:
+      is_set = true;
+      break;
+    case mirror::VarHandle::AccessMode::kCompareAndSet:
+    case mirror::VarHandle::AccessMode::kWeakCompareAndSet:
+    case mirror::VarHandle::AccessMode::kWeakCompareAndSetPlain:
+    case mirror::VarHandle::AccessMode::kWeakCompareAndSetAcquire:
+    case mirror::VarHandle::AccessMode::kWeakCompareAndSetRelease:
+      is_compare_and_set = true;
+      break;
+    case mirror::VarHandle::AccessMode::kGetAndSet:
+    case mirror::VarHandle::AccessMode::kGetAndSetAcquire:
+    case mirror::VarHandle::AccessMode::kGetAndSetRelease:
+    case mirror::VarHandle::AccessMode::kGetAndAdd:
+    case mirror::VarHandle::AccessMode::kGetAndAddAcquire:
+    case mirror::VarHandle::AccessMode::kGetAndAddRelease:
+      break;
+    default:
+      // The compare-and-exchange and bitwise updates stay with the runtime: the Unsafe
+      // intrinsics have no equivalent that returns the witness value or applies a bitwise op.
+      return false;
+  }
+  // The VarHandle must be the value of a static final field of an initialized class.
+  HInstruction* var_handle_input = invoke_instruction->InputAt(0);
+  if (!var_handle_input->IsStaticFieldGet()) {
+    return false;
+  }
+  ArtField* var_handle_field = var_handle_input->AsStaticFieldGet()->GetFieldInfo().GetField();
+  if (var_handle_field == nullptr ||
+      !var_handle_field->IsFinal() ||
+      !var_handle_field->GetDeclaringClass()->IsInitialized()) {
+    return false;
+  }
+  ObjPtr<mirror::Object> var_handle_object =
+      var_handle_field->GetObject(var_handle_field->GetDeclaringClass());
+  if (var_handle_object == nullptr ||
+      var_handle_object->GetClass() != mirror::FieldVarHandle::StaticClass()) {
+    return false;
+  }
+  ObjPtr<mirror::FieldVarHandle> var_handle =
+      ObjPtr<mirror::FieldVarHandle>::DownCast(var_handle_object);
+  ArtField* field = var_handle->GetField();
+  if (!var_handle->IsAccessModeSupported(access_mode) || field->IsStatic()) {
+    // Static fields stay with the runtime: the Unsafe intrinsics take an object and an offset,
+    // and the replacement does not emit the class initialization check of the declaring class.
+    return false;
+  }
+
+  // The call site must take the receiver and pass or return the values with the exact types of
+  // the field, so that no conversion is needed.
+  const Instruction& instruction =
+      caller_compilation_unit_.GetCodeItemAccessor().InstructionAt(invoke_instruction->GetDexPc());
+  const DexFile::ProtoId& proto_id = caller_dex_file.GetProtoId(instruction.VRegH());
+  const DexFile::TypeList* parameters = caller_dex_file.GetProtoParameters(proto_id);
+  ObjPtr<mirror::Class> field_type = field->LookupResolvedType();
+  size_t number_of_values = is_get ? 0u : (is_compare_and_set ? 2u : 1u);
+  if (parameters == nullptr ||
+      parameters->Size() != 1u + number_of_values ||
+      field_type == nullptr ||
+      !IsResolvedTypeOf(caller_compilation_unit_,
+                        parameters->GetTypeItem(0).type_idx_,
+                        field->GetDeclaringClass())) {
+    return false;
+  }
+  for (size_t i = 1; i != parameters->Size(); ++i) {
+    if (!IsResolvedTypeOf(caller_compilation_unit_,
+                          parameters->GetTypeItem(i).type_idx_,
+                          field_type)) {
+      return false;
+    }
+  }
+  if (is_set) {
+    if (caller_dex_file.GetReturnTypeDescriptor(proto_id)[0] != 'V') {
+      return false;
+    }
+  } else if (is_compare_and_set) {
+    if (caller_dex_file.GetReturnTypeDescriptor(proto_id)[0] != 'Z') {
+      return false;
+    }
+  } else if (!IsResolvedTypeOf(caller_compilation_unit_, proto_id.return_type_idx_, field_type)) {
+    return false;
+  }
+
+  // The atomic updates call the method of sun.misc.Unsafe, which the code generators intrinsify,
+  // on its singleton. Unsafe is initialized in the boot image, so loading the singleton needs
+  // neither a class initialization check nor a reference from the caller's dex file.
+  DataType::Type type = DataType::FromShorty(field->GetTypeDescriptor()[0]);
+  uint32_t dex_pc = invoke_instruction->GetDexPc();
+  ArtMethod* unsafe_method = nullptr;
+  HLoadClass* unsafe_class_load = nullptr;
+  ArtField* unsafe_field = nullptr;
+  if (!is_get && !is_set) {
+    ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
+    ObjPtr<mirror::Class> unsafe_class =
+        class_linker->LookupClass(Thread::Current(), "Lsun/misc/Unsafe;", nullptr);
+    if (unsafe_class == nullptr || !unsafe_class->IsInitialized()) {
+      return false;
+    }
+    unsafe_method = FindUnsafeMethodForVarHandleAccess(
+        unsafe_class, access_mode, type, class_linker->GetImagePointerSize());
+    unsafe_field = unsafe_class->FindDeclaredStaticField("THE_ONE", "Lsun/misc/Unsafe;");
+    if (unsafe_method == nullptr ||
+        unsafe_field == nullptr ||
+        unsafe_field->GetObject(unsafe_class) == nullptr) {
+      return false;
+    }
+    Handle<mirror::Class> unsafe_class_handle = handles_->NewHandle(unsafe_class);
+    unsafe_class_load = new (graph_->GetAllocator()) HLoadClass(graph_->GetCurrentMethod(),
+                                                                unsafe_class->GetDexTypeIndex(),
+                                                                unsafe_class->GetDexFile(),
+                                                                unsafe_class_handle,
+                                                                /* is_referrers_class */ false,
+                                                                dex_pc,
+                                                                /* needs_access_check */ false);
+    HLoadClass::LoadKind kind = HSharpening::ComputeLoadClassKind(
+        unsafe_class_load, codegen_, compiler_driver_, caller_compilation_unit_);
+    if (kind == HLoadClass::LoadKind::kInvalid) {
+      return false;
+    }
+    // Load kind must be set before inserting the instruction into the graph.
+    unsafe_class_load->SetLoadKind(kind);
+  }
+
+  HInstruction* receiver = invoke_instruction->InputAt(1);
+  HNullCheck* null_check = new (graph_->GetAllocator()) HNullCheck(receiver, dex_pc);
+  null_check->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+  null_check->SetReferenceTypeInfo(receiver->GetReferenceTypeInfo());
+  invoke_instruction->GetBlock()->InsertInstructionBefore(null_check, invoke_instruction);
+  is_volatile = is_volatile || field->IsVolatile();
+  uint16_t class_def_index = field->GetDeclaringClass()->GetDexClassDefIndex();
+  if (is_get) {
+    HInstanceFieldGet* iget = new (graph_->GetAllocator()) HInstanceFieldGet(
+        null_check,
+        field,
+        type,
+        field->GetOffset(),
+        is_volatile,
+        field->GetDexFieldIndex(),
+        class_def_index,
+        *field->GetDexFile(),
+        dex_pc);
+    invoke_instruction->GetBlock()->InsertInstructionBefore(iget, invoke_instruction);
+    if (type == DataType::Type::kReference) {
+      Handle<mirror::DexCache> dex_cache = handles_->NewHandle(field->GetDexCache());
+      ReferenceTypePropagation rtp(graph_,
+                                   outer_compilation_unit_.GetClassLoader(),
+                                   dex_cache,
+                                   handles_,
+                                   /* is_first_run */ false);
+      rtp.Visit(iget);
+    }
+    invoke_instruction->ReplaceWith(iget);
+  } else if (is_set) {
+    HInstanceFieldSet* iput = new (graph_->GetAllocator()) HInstanceFieldSet(
+        null_check,
+        invoke_instruction->InputAt(2),
+        field,
+        type,
+        field->GetOffset(),
+        is_volatile,
+        field->GetDexFieldIndex(),
+        class_def_index,
+        *field->GetDexFile(),
+        dex_pc);
+    invoke_instruction->GetBlock()->InsertInstructionBefore(iput, invoke_instruction);
+  } else {
+    if (unsafe_class_load->NeedsEnvironment()) {
+      unsafe_class_load->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+    }
+    invoke_instruction->GetBlock()->InsertInstructionBefore(unsafe_class_load, invoke_instruction);
+    HStaticFieldGet* unsafe = new (graph_->GetAllocator()) HStaticFieldGet(
+        unsafe_class_load,
+        unsafe_field,
+        DataType::Type::kReference,
+        unsafe_field->GetOffset(),
+        unsafe_field->IsVolatile(),
+        unsafe_field->GetDexFieldIndex(),
+        unsafe_field->GetDeclaringClass()->GetDexClassDefIndex(),
+        *unsafe_field->GetDexFile(),
+        dex_pc);
+    unsafe->SetReferenceTypeInfo(
+        ReferenceTypeInfo::Create(unsafe_class_load->GetClass(), /* is_exact */ true));
+    invoke_instruction->GetBlock()->InsertInstructionBefore(unsafe, invoke_instruction);
+    // The Unsafe method takes the Unsafe, the object, the offset and the values.
+    HInvokeVirtual* unsafe_invoke = new (graph_->GetAllocator()) HInvokeVirtual(
+        graph_->GetAllocator(),
+        /* number_of_arguments */ 3u + number_of_values,
+        invoke_instruction->GetType(),
+        dex_pc,
+        unsafe_method->GetDexMethodIndex(),
+        unsafe_method,
+        unsafe_method->GetMethodIndex());
+    unsafe_invoke->SetArgumentAt(0u, unsafe);
+    unsafe_invoke->SetArgumentAt(1u, null_check);
+    unsafe_invoke->SetArgumentAt(2u, graph_->GetLongConstant(field->GetOffset().Int32Value()));
+    for (size_t i = 0; i != number_of_values; ++i) {
+      unsafe_invoke->SetArgumentAt(3u + i, invoke_instruction->InputAt(2u + i));
+    }
+    invoke_instruction->GetBlock()->InsertInstructionBefore(unsafe_invoke, invoke_instruction);
+    unsafe_invoke->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+    if (unsafe_invoke->GetType() == DataType::Type::kReference) {
+      unsafe_invoke->SetReferenceTypeInfo(invoke_instruction->GetReferenceTypeInfo());
+    }
+    bool wrong_invoke_type = false;
+    if (IntrinsicsRecognizer::Recognize(unsafe_invoke, unsafe_method, &wrong_invoke_type)) {
+      MaybeRecordStat(stats_, MethodCompilationStat::kIntrinsicRecognized);
+    }
+    invoke_instruction->ReplaceWith(unsafe_invoke);
+  }
+  invoke_instruction->GetBlock()->RemoveInstruction(invoke_instruction);
+  LOG_SUCCESS() << "Replaced VarHandle access to " << field->PrettyField();
+  MaybeRecordStat(stats_, MethodCompilationStat::kReplacedVarHandleAccess);
+  return true;
+}
+
 template <typename T>
 static inline Handle<T> NewHandleIfDifferent(T* object,
                                              Handle<T> hint,
@@ -1711,6 +2236,8 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
                                        ArtMethod* resolved_method,
                                        ReferenceTypeInfo receiver_type,
                                        bool same_dex_file,
+                                       CallSiteHotness hotness,
+                                       size_t specialization_budget,
                                        HInstruction** return_replacement) {
   DCHECK(!(resolved_method->IsStatic() && receiver_type.IsValid()));
   ScopedObjectAccess soa(Thread::Current());
@@ -1755,6 +2282,7 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
       invoke_type,
       graph_->IsDebuggable(),
       /* osr */ false,
+      /* baseline */ false,
       caller_instruction_counter);
   callee_graph->SetArtMethod(resolved_method);
 
@@ -1887,6 +2415,9 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
   }
 
   size_t number_of_instructions = 0;
+  size_t dex_registers_budget = (hotness == kCallSiteHot)
+      ? kMaximumNumberOfCumulatedDexRegisters * kHotCallSiteBudgetFactor
+      : kMaximumNumberOfCumulatedDexRegisters;
   // Skip the entry block, it does not contain instructions that prevent inlining.
   for (HBasicBlock* block : callee_graph->GetReversePostOrderSkipEntryBlock()) {
     if (block->IsLoopHeader()) {
@@ -1921,7 +2452,7 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
       }
       HInstruction* current = instr_it.Current();
       if (current->NeedsEnvironment() &&
-          (total_number_of_dex_registers_ >= kMaximumNumberOfCumulatedDexRegisters)) {
+          (total_number_of_dex_registers_ >= dex_registers_budget)) {
         LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedEnvironmentBudget)
             << "Method " << callee_dex_file.PrettyMethod(method_index)
             << " is not inlined because its caller has reached"
@@ -1964,6 +2495,14 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
   DCHECK_EQ(caller_instruction_counter, graph_->GetCurrentInstructionId())
       << "No instructions can be added to the outer graph while inner graph is being built";
 
+  if (specialization_budget != 0u && number_of_instructions > specialization_budget) {
+    LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedSpecializationTooBig)
+        << "Method " << callee_dex_file.PrettyMethod(method_index)
+        << " is not inlined because it is still too big once specialized on its constant"
+        << " arguments: " << number_of_instructions << " > " << specialization_budget;
+    return false;
+  }
+
   // Inline the callee graph inside the caller graph.
   const int32_t callee_instruction_counter = callee_graph->GetCurrentInstructionId();
   graph_->SetCurrentInstructionId(callee_instruction_counter);
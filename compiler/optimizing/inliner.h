@@ -56,6 +56,7 @@ class HInliner : public HOptimization {
         total_number_of_instructions_(total_number_of_instructions),
         parent_(parent),
         depth_(depth),
+        inline_max_code_units_(parent != nullptr ? parent->inline_max_code_units_ : 0u),
         inlining_budget_(0),
         handles_(handles),
         inline_stats_(nullptr) {}
@@ -74,6 +75,13 @@ class HInliner : public HOptimization {
     kInlineCacheMissingTypes = 5
   };
 
+  // Hotness of a call site, from the JIT inline caches or the AOT profile.
+  enum CallSiteHotness {
+    kCallSiteHotnessUnknown,
+    kCallSiteCold,
+    kCallSiteHot
+  };
+
   bool TryInline(HInvoke* invoke_instruction);
 
   // Try to inline `resolved_method` in place of `invoke_instruction`. `do_rtp` is whether
@@ -97,8 +105,16 @@ class HInliner : public HOptimization {
                                ArtMethod* resolved_method,
                                ReferenceTypeInfo receiver_type,
                                bool same_dex_file,
+                               CallSiteHotness hotness,
+                               size_t specialization_budget,
                                HInstruction** return_replacement);
 
+  // Estimate the hotness of the call to `method` by `invoke_instruction`. The JIT uses the
+  // hits of the inline cache of virtual and interface calls, and AOT uses the hotness of
+  // `method` in the profile.
+  CallSiteHotness GetCallSiteHotness(HInvoke* invoke_instruction, ArtMethod* method)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Run simple optimizations on `callee_graph`.
   void RunOptimizations(HGraph* callee_graph,
                         const DexFile::CodeItem* code_item,
@@ -111,6 +127,11 @@ class HInliner : public HOptimization {
                               HInstruction** return_replacement)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Try to replace an access through a VarHandle held in a static final field with the
+  // access to its field.
+  bool TryReplaceVarHandleAccess(HInvokePolymorphic* invoke_instruction)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Create a new HInstanceFieldGet.
   HInstanceFieldGet* CreateInstanceFieldGet(uint32_t field_index,
                                             ArtMethod* referrer,
@@ -131,11 +152,13 @@ class HInliner : public HOptimization {
 
   // Try getting the inline cache from JIT code cache.
   // Return true if the inline cache was successfully allocated and the
-  // invoke info was found in the profile info.
+  // invoke info was found in the profile info. The classes are sorted by
+  // decreasing hits, which are stored in `counts`.
   InlineCacheType GetInlineCacheJIT(
       HInvoke* invoke_instruction,
       StackHandleScope<1>* hs,
-      /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache)
+      /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache,
+      /*out*/uint16_t* counts)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Try getting the inline cache from AOT offline profile.
@@ -170,10 +193,20 @@ class HInliner : public HOptimization {
                                 Handle<mirror::ObjectArray<mirror::Class>> classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Try to inline targets of a polymorphic call.
+  // Try to inline targets of a polymorphic call. For a `megamorphic` call, `classes` only
+  // holds the receivers worth inlining, and the original invoke stays as the fallback.
   bool TryInlinePolymorphicCall(HInvoke* invoke_instruction,
                                 ArtMethod* resolved_method,
-                                Handle<mirror::ObjectArray<mirror::Class>> classes)
+                                Handle<mirror::ObjectArray<mirror::Class>> classes,
+                                bool megamorphic)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Try to inline the most frequent targets of a megamorphic call, given the hits `counts`
+  // of the receivers in `classes`, in decreasing order.
+  bool TryInlineMegamorphicCall(HInvoke* invoke_instruction,
+                                ArtMethod* resolved_method,
+                                Handle<mirror::ObjectArray<mirror::Class>> classes,
+                                const uint16_t* counts)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool TryInlinePolymorphicCallToSameTarget(HInvoke* invoke_instruction,
@@ -190,6 +223,11 @@ class HInliner : public HOptimization {
   ArtMethod* TryCHADevirtualization(ArtMethod* resolved_method)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Replace a CHA-based devirtualized call that could not be inlined with a direct
+  // call to `method`, and return the new invoke. The caller adds the CHA guard.
+  HInvokeStaticOrDirect* BuildDirectInvokeForCHA(HInvoke* invoke_instruction, ArtMethod* method)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Add a CHA guard for a CHA-based devirtualized call. A CHA guard checks a
   // should_deoptimize flag and if it's true, does deoptimization.
   void AddCHAGuard(HInstruction* invoke_instruction,
@@ -289,6 +327,10 @@ class HInliner : public HOptimization {
   const HInliner* const parent_;
   const size_t depth_;
 
+  // The maximum number of code units of a method to inline, which may be overridden for the
+  // method being compiled. Set by the outermost inliner and inherited by the nested ones.
+  size_t inline_max_code_units_;
+
   // The budget left for inlining, in number of instructions.
   size_t inlining_budget_;
   VariableSizedHandleScope* const handles_;
@@ -24,6 +24,7 @@
 #include "driver/compiler_driver.h"
 #include "driver/compiler_options.h"
 #include "mirror/dex_cache-inl.h"
+#include "mirror/reference-inl.h"
 #include "nodes.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
@@ -325,4 +326,46 @@ IntrinsicVisitor::IntegerValueOfInfo IntrinsicVisitor::ComputeIntegerValueOfInfo
   return info;
 }
 
+void IntrinsicVisitor::CreateReferenceGetReferentLocations(HInvoke* invoke,
+                                                           CodeGenerator* codegen) {
+  if (Runtime::Current()->IsAotCompiler()) {
+    if (codegen->GetCompilerOptions().IsBootImage() ||
+        codegen->GetCompilerOptions().GetCompilePic()) {
+      // The address of java.lang.ref.Reference is only known when it is in a non-PIC boot image.
+      return;
+    }
+  }
+
+  ReferenceGetReferentInfo info = ComputeReferenceGetReferentInfo();
+  if (info.reference == nullptr) {
+    return;
+  }
+
+  // The intrinsic falls back to the @FastNative Reference.getReferent() when the
+  // reference processor needs to see the access.
+  LocationSummary* locations = new (invoke->GetBlock()->GetGraph()->GetAllocator()) LocationSummary(
+      invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  // The output overlaps with read barriers: we do not want the load to overwrite
+  // the reference's location, as we need it to emit the read barrier.
+  locations->SetOut(Location::RequiresRegister(),
+                    kEmitCompilerReadBarrier ? Location::kOutputOverlap
+                                             : Location::kNoOutputOverlap);
+}
+
+IntrinsicVisitor::ReferenceGetReferentInfo IntrinsicVisitor::ComputeReferenceGetReferentInfo() {
+  ScopedObjectAccess soa(Thread::Current());
+  ReferenceGetReferentInfo info;
+  ObjPtr<mirror::Class> reference = mirror::Reference::GetJavaLangRefReference();
+  if (reference == nullptr ||
+      !Runtime::Current()->GetHeap()->ObjectIsInBootImageSpace(reference)) {
+    // Optimization only works if the class is in the boot image.
+    return info;
+  }
+  info.reference = reference.Ptr();
+  info.disable_intrinsic_offset = reference->GetDisableIntrinsicFlagOffset().Uint32Value();
+  info.slow_path_offset = reference->GetSlowPathFlagOffset().Uint32Value();
+  return info;
+}
+
 }  // namespace art
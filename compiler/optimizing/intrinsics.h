@@ -154,6 +154,27 @@ class IntrinsicVisitor : public ValueObject {
 
   static IntegerValueOfInfo ComputeIntegerValueOfInfo();
 
+  static void CreateReferenceGetReferentLocations(HInvoke* invoke, CodeGenerator* codegen);
+
+  // Temporary data structure for holding Reference.getReferent useful data. We only
+  // use it if java.lang.ref.Reference is in the boot image, so it is fine to keep a raw
+  // mirror::Class pointer in this structure.
+  struct ReferenceGetReferentInfo {
+    ReferenceGetReferentInfo()
+        : reference(nullptr),
+          disable_intrinsic_offset(0),
+          slow_path_offset(0) {}
+
+    // The java.lang.ref.Reference class.
+    mirror::Class* reference;
+    // The offset of the static java.lang.ref.Reference.disableIntrinsic.
+    uint32_t disable_intrinsic_offset;
+    // The offset of the static java.lang.ref.Reference.slowPathEnabled.
+    uint32_t slow_path_offset;
+  };
+
+  static ReferenceGetReferentInfo ComputeReferenceGetReferentInfo();
+
  protected:
   IntrinsicVisitor() {}
 
@@ -3055,6 +3055,14 @@ void IntrinsicCodeGeneratorARM64::VisitReachabilityFence(HInvoke* invoke ATTRIBU
 
 UNIMPLEMENTED_INTRINSIC(ARM64, ReferenceGetReferent)
 
+UNIMPLEMENTED_INTRINSIC(ARM64, Adler32UpdateBytes)
+UNIMPLEMENTED_INTRINSIC(ARM64, Adler32UpdateByteBuffer)
+UNIMPLEMENTED_INTRINSIC(ARM64, CRC32UpdateBytes)
+UNIMPLEMENTED_INTRINSIC(ARM64, CRC32UpdateByteBuffer)
+UNIMPLEMENTED_INTRINSIC(ARM64, ArraysEqualsByte)
+UNIMPLEMENTED_INTRINSIC(ARM64, ArraysFillByte)
+UNIMPLEMENTED_INTRINSIC(ARM64, ArraysFillInt)
+
 UNIMPLEMENTED_INTRINSIC(ARM64, StringStringIndexOf);
 UNIMPLEMENTED_INTRINSIC(ARM64, StringStringIndexOfAfter);
 UNIMPLEMENTED_INTRINSIC(ARM64, StringBufferAppend);
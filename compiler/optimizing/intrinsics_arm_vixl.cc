@@ -3376,6 +3376,14 @@ UNIMPLEMENTED_INTRINSIC(ARMVIXL, UnsafeCASLong)     // High register pressure.
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, SystemArrayCopyChar)
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, ReferenceGetReferent)
 
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, Adler32UpdateBytes)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, Adler32UpdateByteBuffer)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, CRC32UpdateBytes)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, CRC32UpdateByteBuffer)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysEqualsByte)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysFillByte)
+UNIMPLEMENTED_INTRINSIC(ARMVIXL, ArraysFillInt)
+
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, StringStringIndexOf);
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, StringStringIndexOfAfter);
 UNIMPLEMENTED_INTRINSIC(ARMVIXL, StringBufferAppend);
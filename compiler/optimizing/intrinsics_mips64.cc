@@ -2633,6 +2633,14 @@ void IntrinsicCodeGeneratorMIPS64::VisitReachabilityFence(HInvoke* invoke ATTRIB
 UNIMPLEMENTED_INTRINSIC(MIPS64, ReferenceGetReferent)
 UNIMPLEMENTED_INTRINSIC(MIPS64, SystemArrayCopy)
 
+UNIMPLEMENTED_INTRINSIC(MIPS64, Adler32UpdateBytes)
+UNIMPLEMENTED_INTRINSIC(MIPS64, Adler32UpdateByteBuffer)
+UNIMPLEMENTED_INTRINSIC(MIPS64, CRC32UpdateBytes)
+UNIMPLEMENTED_INTRINSIC(MIPS64, CRC32UpdateByteBuffer)
+UNIMPLEMENTED_INTRINSIC(MIPS64, ArraysEqualsByte)
+UNIMPLEMENTED_INTRINSIC(MIPS64, ArraysFillByte)
+UNIMPLEMENTED_INTRINSIC(MIPS64, ArraysFillInt)
+
 UNIMPLEMENTED_INTRINSIC(MIPS64, StringStringIndexOf);
 UNIMPLEMENTED_INTRINSIC(MIPS64, StringStringIndexOfAfter);
 UNIMPLEMENTED_INTRINSIC(MIPS64, StringBufferAppend);
@@ -938,6 +938,81 @@ void IntrinsicCodeGeneratorX86::VisitMathRoundFloat(HInvoke* invoke) {
   __ Bind(&done);
 }
 
+void IntrinsicLocationsBuilderX86::VisitMathRoundDouble(HInvoke* invoke) {
+  // Do we have instruction support? Otherwise leave it to the Java implementation.
+  if (!codegen_->GetInstructionSetFeatures().HasSSE4_1()) {
+    return;
+  }
+
+  // The conversion to a long is only done inline for results in the int range.
+  HInvokeStaticOrDirect* static_or_direct = invoke->AsInvokeStaticOrDirect();
+  DCHECK(static_or_direct != nullptr);
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  if (static_or_direct->HasSpecialInput() &&
+      invoke->InputAt(
+          static_or_direct->GetSpecialInputIndex())->IsX86ComputeBaseMethodAddress()) {
+    locations->SetInAt(1, Location::RequiresRegister());
+  }
+  locations->SetOut(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+void IntrinsicCodeGeneratorX86::VisitMathRoundDouble(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  XmmRegister in = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister t1 = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  XmmRegister t2 = locations->GetTemp(1).AsFpuRegister<XmmRegister>();
+  Register out_lo = locations->Out().AsRegisterPairLow<Register>();
+  Register out_hi = locations->Out().AsRegisterPairHigh<Register>();
+  NearLabel skip_incr;
+  X86Assembler* assembler = GetAssembler();
+
+  SlowPathCode* slow_path = new (GetAllocator()) IntrinsicSlowPathX86(invoke);
+  codegen_->AddSlowPath(slow_path);
+
+  // Same as Math.round(float):
+  //  result = floor(in);
+  //  if (in - result >= 0.5)
+  //    result = result + 1.0;
+  __ movsd(t2, in);
+  __ roundsd(t1, in, Immediate(1));
+  __ subsd(t2, t1);
+  if (locations->GetInputCount() == 2 && locations->InAt(1).IsValid()) {
+    // Direct constant area available.
+    HX86ComputeBaseMethodAddress* method_address =
+        invoke->InputAt(1)->AsX86ComputeBaseMethodAddress();
+    Register constant_area = locations->InAt(1).AsRegister<Register>();
+    __ comisd(t2, codegen_->LiteralDoubleAddress(0.5, method_address, constant_area));
+    __ j(kBelow, &skip_incr);
+    __ addsd(t1, codegen_->LiteralDoubleAddress(1.0, method_address, constant_area));
+    __ Bind(&skip_incr);
+  } else {
+    // No constant area: go through stack.
+    __ pushl(Immediate(High32Bits(bit_cast<int64_t, double>(0.5))));
+    __ pushl(Immediate(Low32Bits(bit_cast<int64_t, double>(0.5))));
+    __ pushl(Immediate(High32Bits(bit_cast<int64_t, double>(1.0))));
+    __ pushl(Immediate(Low32Bits(bit_cast<int64_t, double>(1.0))));
+    __ comisd(t2, Address(ESP, 8));
+    __ j(kBelow, &skip_incr);
+    __ addsd(t1, Address(ESP, 0));
+    __ Bind(&skip_incr);
+    __ addl(ESP, Immediate(16));
+  }
+
+  // Final conversion to a long. There is no 64-bit conversion on x86, so only results
+  // that fit an int are converted inline. CVTTSD2SI returns 0x80000000 for NaN and for
+  // out of range values, which the Java implementation handles along with Integer.MIN_VALUE.
+  __ cvttsd2si(out_lo, t1);
+  __ cmpl(out_lo, Immediate(kPrimIntMin));
+  __ j(kEqual, slow_path->GetEntryLabel());
+  __ movl(out_hi, out_lo);
+  __ sarl(out_hi, Immediate(31));
+  __ Bind(slow_path->GetExitLabel());
+}
+
 static void CreateFPToFPCallLocations(ArenaAllocator* allocator, HInvoke* invoke) {
   LocationSummary* locations =
       new (allocator) LocationSummary(invoke, LocationSummary::kCallOnMainOnly, kIntrinsified);
@@ -1665,6 +1740,219 @@ void IntrinsicCodeGeneratorX86::VisitStringIndexOfAfter(HInvoke* invoke) {
   GenerateStringIndexOf(invoke, GetAssembler(), codegen_, /* start_at_zero */ false);
 }
 
+static void CreateStringStringIndexOfLocations(HInvoke* invoke,
+                                               ArenaAllocator* allocator,
+                                               CodeGeneratorX86* codegen,
+                                               bool start_at_zero) {
+  // The search needs pcmpestri. Without it, just call the method.
+  if (!codegen->GetInstructionSetFeatures().HasSSE4_2()) {
+    return;
+  }
+  LocationSummary* locations = new (allocator) LocationSummary(invoke,
+                                                               LocationSummary::kCallOnSlowPath,
+                                                               kIntrinsified);
+  // The slow path calls the method with the original arguments, so they are not clobbered.
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  if (!start_at_zero) {
+    locations->SetInAt(2, Location::RequiresRegister());          // The starting index.
+  }
+  // pcmpestri returns the index of the first match in ECX, which we then use for the result.
+  locations->SetOut(Location::RegisterLocation(ECX));
+  // pcmpestri takes the length of the substring in EAX and the length of the string in EDX.
+  locations->AddTemp(Location::RegisterLocation(EAX));
+  locations->AddTemp(Location::RegisterLocation(EDX));
+  // Address of the string data being searched.
+  locations->AddTemp(Location::RequiresRegister());
+  // The substring data.
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+// Search the string for a substring whose data fits in one XMM register. Both strings are
+// compressed, with one byte per char, or both are uncompressed. On entry, `substring_length`
+// and `remaining` hold the count fields of the substring and of the string. Branches to `found`
+// with the number of chars left in the string from the match in `remaining`.
+static void GenerateStringStringIndexOfSearch(HInvoke* invoke,
+                                              X86Assembler* assembler,
+                                              SlowPathCode* slow_path,
+                                              bool start_at_zero,
+                                              bool compressed,
+                                              Label* found,
+                                              Label* not_found) {
+  LocationSummary* locations = invoke->GetLocations();
+  Register string_obj = locations->InAt(0).AsRegister<Register>();
+  Register substring_obj = locations->InAt(1).AsRegister<Register>();
+  Register index = locations->Out().AsRegister<Register>();
+  Register substring_length = locations->GetTemp(0).AsRegister<Register>();
+  Register remaining = locations->GetTemp(1).AsRegister<Register>();
+  Register data = locations->GetTemp(2).AsRegister<Register>();
+  XmmRegister substring_data = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+
+  int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+  const ScaleFactor scale = compressed ? ScaleFactor::TIMES_1 : ScaleFactor::TIMES_2;
+  constexpr int32_t kVectorSize = 16;
+  const int32_t chars_per_vector = compressed ? kVectorSize : kVectorSize / 2;
+  // Equal ordered aggregation of unsigned bytes or words: the result is the index of the first
+  // position where the substring matches, or where a prefix of it ends the vector.
+  const Immediate mode(compressed ? 0x0C : 0x0D);
+
+  if (mirror::kUseStringCompression) {
+    // Mask out the compression flags.
+    __ shrl(substring_length, Immediate(1));
+    __ shrl(remaining, Immediate(1));
+  }
+  // Empty and long substrings are left to the slow path.
+  __ testl(substring_length, substring_length);
+  __ j(kEqual, slow_path->GetEntryLabel());
+  __ cmpl(substring_length, Immediate(chars_per_vector));
+  __ j(kAbove, slow_path->GetEntryLabel());
+
+  if (start_at_zero) {
+    __ leal(data, Address(string_obj, value_offset));
+  } else {
+    Register start_index = locations->InAt(2).AsRegister<Register>();
+    // Ensure we have a start index >= 0.
+    __ xorl(index, index);
+    __ cmpl(start_index, Immediate(0));
+    __ cmovl(kGreater, index, start_index);
+    __ subl(remaining, index);
+    __ leal(data, Address(string_obj, index, scale, value_offset));
+  }
+  __ cmpl(remaining, substring_length);
+  __ j(kLess, not_found);
+
+  // Whole vectors are loaded, past the end of the data if it is shorter. Such a load is only
+  // safe if it does not cross into the next page, otherwise take the slow path.
+  __ leal(index, Address(substring_obj, value_offset));
+  __ andl(index, Immediate(kPageSize - 1));
+  __ cmpl(index, Immediate(kPageSize - kVectorSize));
+  __ j(kAbove, slow_path->GetEntryLabel());
+  __ movdqu(substring_data, Address(substring_obj, value_offset));
+
+  NearLabel loop, load, next_vector;
+  __ Bind(&loop);
+  __ cmpl(remaining, Immediate(chars_per_vector));
+  __ j(kGreaterEqual, &load);
+  __ movl(index, data);
+  __ andl(index, Immediate(kPageSize - 1));
+  __ cmpl(index, Immediate(kPageSize - kVectorSize));
+  __ j(kAbove, slow_path->GetEntryLabel());
+  __ Bind(&load);
+  __ pcmpestri(substring_data, Address(data, 0), mode);
+  __ j(kCarryClear, &next_vector);
+  // The substring fits in the vector, so a match at its start is complete.
+  __ testl(index, index);
+  __ j(kEqual, found);
+  // Otherwise the match may be partial, continue from it.
+  __ subl(remaining, index);
+  __ leal(data, Address(data, index, scale, 0));
+  __ cmpl(remaining, substring_length);
+  __ j(kGreaterEqual, &loop);
+  __ jmp(not_found);
+
+  __ Bind(&next_vector);
+  __ subl(remaining, Immediate(chars_per_vector));
+  __ addl(data, Immediate(kVectorSize));
+  __ cmpl(remaining, substring_length);
+  __ j(kGreaterEqual, &loop);
+  __ jmp(not_found);
+}
+
+static void GenerateStringStringIndexOf(HInvoke* invoke,
+                                        X86Assembler* assembler,
+                                        CodeGeneratorX86* codegen,
+                                        bool start_at_zero) {
+  LocationSummary* locations = invoke->GetLocations();
+  Register string_obj = locations->InAt(0).AsRegister<Register>();
+  Register substring_obj = locations->InAt(1).AsRegister<Register>();
+  Register out = locations->Out().AsRegister<Register>();
+  Register substring_length = locations->GetTemp(0).AsRegister<Register>();
+  Register remaining = locations->GetTemp(1).AsRegister<Register>();
+
+  // Check our assumptions for registers.
+  DCHECK_EQ(out, ECX);
+  DCHECK_EQ(substring_length, EAX);
+  DCHECK_EQ(remaining, EDX);
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86(invoke);
+  codegen->AddSlowPath(slow_path);
+
+  // The slow path throws the NullPointerException for a null substring.
+  if (invoke->InputAt(1)->CanBeNull()) {
+    __ testl(substring_obj, substring_obj);
+    __ j(kEqual, slow_path->GetEntryLabel());
+  }
+
+  // Location of count within the String object.
+  int32_t count_offset = mirror::String::CountOffset().Int32Value();
+
+  // Load the count fields containing the lengths and compression flags.
+  __ movl(remaining, Address(string_obj, count_offset));
+  __ movl(substring_length, Address(substring_obj, count_offset));
+
+  Label found, not_found, done;
+  if (mirror::kUseStringCompression) {
+    NearLabel same_compression, uncompressed;
+    __ movl(out, remaining);
+    __ xorl(out, substring_length);
+    __ testl(out, Immediate(1));
+    __ j(kZero, &same_compression);
+    // Compressed strings only contain ASCII chars, so they cannot contain an uncompressed
+    // substring. Searching for a compressed substring in an uncompressed string is left to the
+    // slow path.
+    __ testl(substring_length, Immediate(1));
+    __ j(kNotZero, &not_found);
+    __ jmp(slow_path->GetEntryLabel());
+
+    __ Bind(&same_compression);
+    __ testl(remaining, Immediate(1));
+    __ j(kNotZero, &uncompressed);
+    GenerateStringStringIndexOfSearch(
+        invoke, assembler, slow_path, start_at_zero, /* compressed */ true, &found, &not_found);
+    __ Bind(&uncompressed);
+    GenerateStringStringIndexOfSearch(
+        invoke, assembler, slow_path, start_at_zero, /* compressed */ false, &found, &not_found);
+  } else {
+    GenerateStringStringIndexOfSearch(
+        invoke, assembler, slow_path, start_at_zero, /* compressed */ false, &found, &not_found);
+  }
+
+  // The index of the match is the length of the string minus the chars left from it.
+  __ Bind(&found);
+  __ movl(out, Address(string_obj, count_offset));
+  if (mirror::kUseStringCompression) {
+    __ shrl(out, Immediate(1));
+  }
+  __ subl(out, remaining);
+  __ jmp(&done);
+
+  // Failed to match; return -1.
+  __ Bind(&not_found);
+  __ movl(out, Immediate(-1));
+
+  __ Bind(&done);
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderX86::VisitStringStringIndexOf(HInvoke* invoke) {
+  CreateStringStringIndexOfLocations(invoke, allocator_, codegen_, /* start_at_zero */ true);
+}
+
+void IntrinsicCodeGeneratorX86::VisitStringStringIndexOf(HInvoke* invoke) {
+  GenerateStringStringIndexOf(invoke, GetAssembler(), codegen_, /* start_at_zero */ true);
+}
+
+void IntrinsicLocationsBuilderX86::VisitStringStringIndexOfAfter(HInvoke* invoke) {
+  CreateStringStringIndexOfLocations(invoke, allocator_, codegen_, /* start_at_zero */ false);
+}
+
+void IntrinsicCodeGeneratorX86::VisitStringStringIndexOfAfter(HInvoke* invoke) {
+  GenerateStringStringIndexOf(invoke, GetAssembler(), codegen_, /* start_at_zero */ false);
+}
+
 void IntrinsicLocationsBuilderX86::VisitStringNewStringFromBytes(HInvoke* invoke) {
   LocationSummary* locations = new (allocator_) LocationSummary(
       invoke, LocationSummary::kCallOnMainAndSlowPath, kIntrinsified);
@@ -2810,6 +3098,246 @@ void IntrinsicCodeGeneratorX86::VisitLongNumberOfTrailingZeros(HInvoke* invoke)
   GenTrailingZeros(GetAssembler(), codegen_, invoke, /* is_long */ true);
 }
 
+static void CreateOneBitLocations(ArenaAllocator* allocator,
+                                  CodeGeneratorX86* codegen,
+                                  HInvoke* invoke,
+                                  bool is_high,
+                                  bool is_long) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  bool use_bmi = !is_high && codegen->GetInstructionSetFeatures().HasAVX2();
+  if (is_long || use_bmi) {
+    locations->SetInAt(0, Location::RequiresRegister());
+  } else {
+    locations->SetInAt(0, Location::Any());
+  }
+  // The low word of a long result is written before the high word of the input is read.
+  locations->SetOut(Location::RequiresRegister(),
+                    is_long ? Location::kOutputOverlap : Location::kNoOutputOverlap);
+  if (is_high) {
+    locations->AddTemp(Location::RegisterLocation(ECX));  // needs CL
+  } else if (!is_long && !use_bmi) {
+    locations->AddTemp(Location::RequiresRegister());  // any will do
+  }
+}
+
+// Set `out` to 1 << bsr(`src`), or 0 if `src` is zero. Needs ECX as `tmp`.
+static void GenHighestOneBit32(X86Assembler* assembler,
+                               Register out,
+                               Register tmp,
+                               const Location& src) {
+  DCHECK_EQ(tmp, ECX);
+  if (src.IsRegister()) {
+    __ bsrl(tmp, src.AsRegister<Register>());
+  } else {
+    DCHECK(src.IsStackSlot());
+    __ bsrl(tmp, Address(ESP, src.GetStackIndex()));
+  }
+  // BSR sets ZF if the input was zero.
+  NearLabel is_zero, done;
+  __ j(kEqual, &is_zero);
+  __ movl(out, Immediate(1));
+  __ shll(out, tmp);
+  __ jmp(&done);
+  __ Bind(&is_zero);
+  __ xorl(out, out);
+  __ Bind(&done);
+}
+
+static void GenOneBit(X86Assembler* assembler,
+                      CodeGeneratorX86* codegen,
+                      HInvoke* invoke,
+                      bool is_high,
+                      bool is_long) {
+  LocationSummary* locations = invoke->GetLocations();
+  Location src = locations->InAt(0);
+  Location out_loc = locations->Out();
+  Register out = is_long ? out_loc.AsRegisterPairLow<Register>() : out_loc.AsRegister<Register>();
+
+  if (invoke->InputAt(0)->IsConstant()) {
+    // Evaluate this at compile time.
+    int64_t value = Int64FromConstant(invoke->InputAt(0)->AsConstant());
+    if (value != 0) {
+      if (is_high) {
+        value = is_long ? 63 - CLZ(static_cast<uint64_t>(value))
+                        : 31 - CLZ(static_cast<uint32_t>(value));
+      } else {
+        value = is_long ? CTZ(static_cast<uint64_t>(value))
+                        : CTZ(static_cast<uint32_t>(value));
+      }
+      value = is_long ? static_cast<int64_t>(UINT64_C(1) << value)
+                      : static_cast<int64_t>(UINT32_C(1) << value);
+    }
+    codegen->Load32BitValue(out, Low32Bits(value));
+    if (is_long) {
+      codegen->Load32BitValue(out_loc.AsRegisterPairHigh<Register>(), High32Bits(value));
+    }
+    return;
+  }
+
+  // Handle the non-constant cases.
+  bool use_bmi = !is_high && codegen->GetInstructionSetFeatures().HasAVX2();
+  if (!is_long) {
+    if (is_high) {
+      GenHighestOneBit32(assembler, out, locations->GetTemp(0).AsRegister<Register>(), src);
+    } else if (use_bmi) {
+      __ blsi(out, src.AsRegister<Register>());
+    } else {
+      // Copy input into temporary.
+      Register tmp = locations->GetTemp(0).AsRegister<Register>();
+      if (src.IsRegister()) {
+        __ movl(tmp, src.AsRegister<Register>());
+      } else {
+        DCHECK(src.IsStackSlot());
+        __ movl(tmp, Address(ESP, src.GetStackIndex()));
+      }
+      // Do the bit twiddling: basically tmp & -tmp;
+      __ movl(out, tmp);
+      __ negl(tmp);
+      __ andl(out, tmp);
+    }
+    return;
+  }
+
+  // 64 bit case needs to worry about both parts of the register.
+  DCHECK(src.IsRegisterPair());
+  Register src_lo = src.AsRegisterPairLow<Register>();
+  Register src_hi = src.AsRegisterPairHigh<Register>();
+  Register out_hi = out_loc.AsRegisterPairHigh<Register>();
+  NearLabel handle_other, done;
+  if (is_high) {
+    // If the high word is not zero, the result is in the high word.
+    __ testl(src_hi, src_hi);
+    __ j(kEqual, &handle_other);
+    GenHighestOneBit32(assembler,
+                       out_hi,
+                       locations->GetTemp(0).AsRegister<Register>(),
+                       Location::RegisterLocation(src_hi));
+    __ xorl(out, out);
+    __ jmp(&done);
+    __ Bind(&handle_other);
+    GenHighestOneBit32(assembler,
+                       out,
+                       locations->GetTemp(0).AsRegister<Register>(),
+                       Location::RegisterLocation(src_lo));
+    __ xorl(out_hi, out_hi);
+  } else {
+    // If the low word is not zero, the result is in the low word.
+    if (use_bmi) {
+      // BLSI sets ZF if the result is zero.
+      __ blsi(out, src_lo);
+      __ j(kEqual, &handle_other);
+    } else {
+      __ movl(out, src_lo);
+      __ negl(out);  // sets ZF if the input was zero, and leaves it zero
+      __ j(kEqual, &handle_other);
+      __ andl(out, src_lo);
+    }
+    __ xorl(out_hi, out_hi);
+    __ jmp(&done);
+    __ Bind(&handle_other);
+    if (use_bmi) {
+      __ blsi(out_hi, src_hi);
+    } else {
+      __ movl(out_hi, src_hi);
+      __ negl(out_hi);
+      __ andl(out_hi, src_hi);
+    }
+  }
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86::VisitIntegerHighestOneBit(HInvoke* invoke) {
+  CreateOneBitLocations(allocator_, codegen_, invoke, /* is_high */ true, /* is_long */ false);
+}
+
+void IntrinsicCodeGeneratorX86::VisitIntegerHighestOneBit(HInvoke* invoke) {
+  GenOneBit(GetAssembler(), codegen_, invoke, /* is_high */ true, /* is_long */ false);
+}
+
+void IntrinsicLocationsBuilderX86::VisitLongHighestOneBit(HInvoke* invoke) {
+  CreateOneBitLocations(allocator_, codegen_, invoke, /* is_high */ true, /* is_long */ true);
+}
+
+void IntrinsicCodeGeneratorX86::VisitLongHighestOneBit(HInvoke* invoke) {
+  GenOneBit(GetAssembler(), codegen_, invoke, /* is_high */ true, /* is_long */ true);
+}
+
+void IntrinsicLocationsBuilderX86::VisitIntegerLowestOneBit(HInvoke* invoke) {
+  CreateOneBitLocations(allocator_, codegen_, invoke, /* is_high */ false, /* is_long */ false);
+}
+
+void IntrinsicCodeGeneratorX86::VisitIntegerLowestOneBit(HInvoke* invoke) {
+  GenOneBit(GetAssembler(), codegen_, invoke, /* is_high */ false, /* is_long */ false);
+}
+
+void IntrinsicLocationsBuilderX86::VisitLongLowestOneBit(HInvoke* invoke) {
+  CreateOneBitLocations(allocator_, codegen_, invoke, /* is_high */ false, /* is_long */ true);
+}
+
+void IntrinsicCodeGeneratorX86::VisitLongLowestOneBit(HInvoke* invoke) {
+  GenOneBit(GetAssembler(), codegen_, invoke, /* is_high */ false, /* is_long */ true);
+}
+
+static void CreateIsInfiniteLocations(ArenaAllocator* allocator, HInvoke* invoke, bool is64bit) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister());
+  if (is64bit) {
+    locations->AddTemp(Location::RequiresFpuRegister());
+    locations->AddTemp(Location::RequiresRegister());
+  }
+}
+
+static void GenIsInfinite(X86Assembler* assembler, HInvoke* invoke, bool is64bit) {
+  LocationSummary* locations = invoke->GetLocations();
+  XmmRegister in = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  Register out = locations->Out().AsRegister<Register>();
+  NearLabel done;
+
+  // The value is infinite if, ignoring the sign, its exponent is all ones and
+  // its mantissa is zero.
+  if (is64bit) {
+    XmmRegister xmm_temp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+    Register low = locations->GetTemp(1).AsRegister<Register>();
+    __ movd(low, in);
+    __ movsd(xmm_temp, in);
+    __ psrlq(xmm_temp, Immediate(32));
+    __ movd(out, xmm_temp);
+    __ shll(out, Immediate(1));
+    __ cmpl(out, Immediate(static_cast<int32_t>(0xffe00000u)));
+    __ movl(out, Immediate(0));  // does not change flags
+    __ j(kNotEqual, &done);
+    __ testl(low, low);
+    __ j(kNotEqual, &done);
+  } else {
+    __ movd(out, in);
+    __ shll(out, Immediate(1));
+    __ cmpl(out, Immediate(static_cast<int32_t>(0xff000000u)));
+    __ movl(out, Immediate(0));  // does not change flags
+    __ j(kNotEqual, &done);
+  }
+  __ movl(out, Immediate(1));
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86::VisitFloatIsInfinite(HInvoke* invoke) {
+  CreateIsInfiniteLocations(allocator_, invoke, /* is64bit */ false);
+}
+
+void IntrinsicCodeGeneratorX86::VisitFloatIsInfinite(HInvoke* invoke) {
+  GenIsInfinite(GetAssembler(), invoke, /* is64bit */ false);
+}
+
+void IntrinsicLocationsBuilderX86::VisitDoubleIsInfinite(HInvoke* invoke) {
+  CreateIsInfiniteLocations(allocator_, invoke, /* is64bit */ true);
+}
+
+void IntrinsicCodeGeneratorX86::VisitDoubleIsInfinite(HInvoke* invoke) {
+  GenIsInfinite(GetAssembler(), invoke, /* is64bit */ true);
+}
+
 static bool IsSameInput(HInstruction* instruction, size_t input0, size_t input1) {
   return instruction->InputAt(input0) == instruction->InputAt(input1);
 }
@@ -3359,6 +3887,59 @@ void IntrinsicCodeGeneratorX86::VisitThreadInterrupted(HInvoke* invoke) {
   __ Bind(&done);
 }
 
+void IntrinsicLocationsBuilderX86::VisitReferenceGetReferent(HInvoke* invoke) {
+  IntrinsicVisitor::CreateReferenceGetReferentLocations(invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86::VisitReferenceGetReferent(HInvoke* invoke) {
+  IntrinsicVisitor::ReferenceGetReferentInfo info =
+      IntrinsicVisitor::ComputeReferenceGetReferentInfo();
+  LocationSummary* locations = invoke->GetLocations();
+  X86Assembler* assembler = GetAssembler();
+
+  Location obj_loc = locations->InAt(0);
+  Register obj = obj_loc.AsRegister<Register>();
+  Location out_loc = locations->Out();
+  Register out = out_loc.AsRegister<Register>();
+
+  SlowPathCode* slow_path = new (GetAllocator()) IntrinsicSlowPathX86(invoke);
+  codegen_->AddSlowPath(slow_path);
+
+  if (kEmitCompilerReadBarrier) {
+    // The concurrent copying collector blocks weak reference accesses while it processes them.
+    int32_t offset = Thread::WeakRefAccessEnabledOffset<kX86PointerSize>().Int32Value();
+    __ fs()->cmpl(Address::Absolute(offset), Immediate(0));
+    __ j(kEqual, slow_path->GetEntryLabel());
+  }
+
+  // Check the static java.lang.ref.Reference.{disableIntrinsic,slowPathEnabled} flags,
+  // together if they are adjacent. The class is in the boot image, so its address is
+  // a 32-bit constant.
+  uint32_t address = dchecked_integral_cast<uint32_t>(reinterpret_cast<uintptr_t>(info.reference));
+  Address disable_intrinsic = Address::Absolute(address + info.disable_intrinsic_offset);
+  if (info.slow_path_offset == info.disable_intrinsic_offset + 1u) {
+    __ cmpw(disable_intrinsic, Immediate(0));
+    __ j(kNotEqual, slow_path->GetEntryLabel());
+  } else {
+    __ cmpb(disable_intrinsic, Immediate(0));
+    __ j(kNotEqual, slow_path->GetEntryLabel());
+    __ cmpb(Address::Absolute(address + info.slow_path_offset), Immediate(0));
+    __ j(kNotEqual, slow_path->GetEntryLabel());
+  }
+
+  // Fast path: load the referent. It is volatile, but x86 loads need no fence.
+  uint32_t referent_offset = mirror::Reference::ReferentOffset().Uint32Value();
+  if (kEmitCompilerReadBarrier && kUseBakerReadBarrier) {
+    codegen_->GenerateFieldLoadWithBakerReadBarrier(
+        invoke, out_loc, obj, referent_offset, /* needs_null_check */ false);
+  } else {
+    __ movl(out, Address(obj, referent_offset));
+    __ MaybeUnpoisonHeapReference(out);
+    codegen_->MaybeGenerateReadBarrierSlow(invoke, out_loc, out_loc, obj_loc, referent_offset);
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
 void IntrinsicLocationsBuilderX86::VisitReachabilityFence(HInvoke* invoke) {
   LocationSummary* locations =
       new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
@@ -3367,17 +3948,14 @@ void IntrinsicLocationsBuilderX86::VisitReachabilityFence(HInvoke* invoke) {
 
 void IntrinsicCodeGeneratorX86::VisitReachabilityFence(HInvoke* invoke ATTRIBUTE_UNUSED) { }
 
-UNIMPLEMENTED_INTRINSIC(X86, MathRoundDouble)
-UNIMPLEMENTED_INTRINSIC(X86, ReferenceGetReferent)
-UNIMPLEMENTED_INTRINSIC(X86, FloatIsInfinite)
-UNIMPLEMENTED_INTRINSIC(X86, DoubleIsInfinite)
-UNIMPLEMENTED_INTRINSIC(X86, IntegerHighestOneBit)
-UNIMPLEMENTED_INTRINSIC(X86, LongHighestOneBit)
-UNIMPLEMENTED_INTRINSIC(X86, IntegerLowestOneBit)
-UNIMPLEMENTED_INTRINSIC(X86, LongLowestOneBit)
-
-UNIMPLEMENTED_INTRINSIC(X86, StringStringIndexOf);
-UNIMPLEMENTED_INTRINSIC(X86, StringStringIndexOfAfter);
+UNIMPLEMENTED_INTRINSIC(X86, Adler32UpdateBytes)
+UNIMPLEMENTED_INTRINSIC(X86, Adler32UpdateByteBuffer)
+UNIMPLEMENTED_INTRINSIC(X86, CRC32UpdateBytes)
+UNIMPLEMENTED_INTRINSIC(X86, CRC32UpdateByteBuffer)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysEqualsByte)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysFillByte)
+UNIMPLEMENTED_INTRINSIC(X86, ArraysFillInt)
+
 UNIMPLEMENTED_INTRINSIC(X86, StringBufferAppend);
 UNIMPLEMENTED_INTRINSIC(X86, StringBufferLength);
 UNIMPLEMENTED_INTRINSIC(X86, StringBufferToString);
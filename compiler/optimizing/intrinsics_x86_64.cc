@@ -921,6 +921,245 @@ void IntrinsicCodeGeneratorX86_64::VisitMathNextAfter(HInvoke* invoke) {
   GenFPToFPCall(invoke, codegen_, kQuickNextAfter);
 }
 
+// Arrays of at least this many bytes are filled with non-temporal stores, which do not pull the
+// destination into the caches. This is about the size of the L2 cache, past which nothing
+// written by the fill would be left in there for the following code anyway.
+static constexpr int32_t kArraysFillNonTemporalThreshold = 512 * KB;
+// The size of the AVX2 vector registers.
+static constexpr int32_t kAVX2VectorSize = 32;
+
+static void CreateArraysFillLocations(ArenaAllocator* allocator,
+                                      HInvoke* invoke,
+                                      CodeGeneratorX86_64* codegen) {
+  // Only the AVX2 version is worth it over the loop of the library.
+  if (!codegen->GetInstructionSetFeatures().HasAVX2()) {
+    return;
+  }
+
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+static void GenArraysFill(HInvoke* invoke, CodeGeneratorX86_64* codegen, DataType::Type type) {
+  X86_64Assembler* assembler = down_cast<X86_64Assembler*>(codegen->GetAssembler());
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister array = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister value = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister length = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister ptr = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister end = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister pattern = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+
+  const size_t element_size = DataType::Size(type);
+  const ScaleFactor scale = static_cast<ScaleFactor>(DataType::SizeShift(type));
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(element_size).Uint32Value();
+
+  // The library method throws the NullPointerException.
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+  __ testl(array, array);
+  __ j(kEqual, slow_path->GetEntryLabel());
+
+  __ movl(length, Address(array, length_offset));
+  __ leaq(ptr, Address(array, data_offset));
+  __ leaq(end, Address(ptr, length, scale, 0));
+
+  // Store the elements of arrays shorter than a vector one at a time.
+  NearLabel vector_fill, scalar_loop, done;
+  __ cmpl(length, Immediate(kAVX2VectorSize / element_size));
+  __ j(kGreaterEqual, &vector_fill);
+  __ Bind(&scalar_loop);
+  __ cmpq(ptr, end);
+  __ j(kAboveEqual, &done);
+  if (type == DataType::Type::kInt8) {
+    __ movb(Address(ptr, 0), value);
+  } else {
+    DCHECK_EQ(type, DataType::Type::kInt32);
+    __ movl(Address(ptr, 0), value);
+  }
+  __ addq(ptr, Immediate(element_size));
+  __ jmp(&scalar_loop);
+
+  __ Bind(&vector_fill);
+  __ movd(pattern, value, /* is64bit */ false);
+  if (type == DataType::Type::kInt8) {
+    __ vpbroadcastb(pattern, pattern);
+  } else {
+    __ vpbroadcastd(pattern, pattern);
+  }
+  // Store the last vector at the end of the array, where it may overlap the one before it, so
+  // that the loops below only store full vectors starting at or below `end`.
+  __ vmovdqu(Address(end, -kAVX2VectorSize), pattern);
+  __ subq(end, Immediate(kAVX2VectorSize));
+
+  NearLabel non_temporal, vector_loop, non_temporal_loop, vector_done;
+  __ cmpl(length, Immediate(kArraysFillNonTemporalThreshold / element_size));
+  __ j(kGreaterEqual, &non_temporal);
+  __ Bind(&vector_loop);
+  __ vmovdqu(Address(ptr, 0), pattern);
+  __ addq(ptr, Immediate(kAVX2VectorSize));
+  __ cmpq(ptr, end);
+  __ j(kBelowEqual, &vector_loop);
+  __ jmp(&vector_done);
+
+  // The non-temporal stores need an aligned address. Store the first vector unaligned and
+  // continue from the next aligned address after `ptr`.
+  __ Bind(&non_temporal);
+  __ vmovdqu(Address(ptr, 0), pattern);
+  __ addq(ptr, Immediate(kAVX2VectorSize));
+  __ andq(ptr, Immediate(-kAVX2VectorSize));
+  __ Bind(&non_temporal_loop);
+  __ vmovntdq(Address(ptr, 0), pattern);
+  __ addq(ptr, Immediate(kAVX2VectorSize));
+  __ cmpq(ptr, end);
+  __ j(kBelowEqual, &non_temporal_loop);
+  // Order the weakly ordered non-temporal stores before any later store, like the publication
+  // of the array.
+  __ sfence();
+
+  __ Bind(&vector_done);
+  // Avoid the penalty of mixing the VEX.256 instructions with the legacy SSE ones of the
+  // compiled code.
+  __ vzeroupper();
+  __ Bind(&done);
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysFillByte(HInvoke* invoke) {
+  CreateArraysFillLocations(allocator_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysFillByte(HInvoke* invoke) {
+  GenArraysFill(invoke, codegen_, DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysFillInt(HInvoke* invoke) {
+  CreateArraysFillLocations(allocator_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysFillInt(HInvoke* invoke) {
+  GenArraysFill(invoke, codegen_, DataType::Type::kInt32);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysEqualsByte(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  // The output is used as a temporary before the result is known.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysEqualsByte(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister a = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister b = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister length = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister index = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister vector_a = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister vector_b = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(sizeof(int8_t)).Uint32Value();
+
+  NearLabel end, return_true, return_false;
+
+  // Return true for the same array, or two nulls, and false if only one is null.
+  __ cmpl(a, b);
+  __ j(kEqual, &return_true);
+  __ testl(a, a);
+  __ j(kEqual, &return_false);
+  __ testl(b, b);
+  __ j(kEqual, &return_false);
+
+  __ movl(length, Address(a, length_offset));
+  __ cmpl(length, Address(b, length_offset));
+  __ j(kNotEqual, &return_false);
+  __ xorl(index, index);
+
+  // Compare a vector at a time, 32 bytes with AVX2 and 16 bytes with SSE2.
+  const bool use_avx2 = codegen_->GetInstructionSetFeatures().HasAVX2();
+  const int32_t vector_size = use_avx2 ? kAVX2VectorSize : 16;
+  NearLabel vector_loop, vector_done, vector_not_equal, word_loop, byte_loop;
+  __ Bind(&vector_loop);
+  __ leal(temp, Address(index, vector_size));
+  __ cmpl(temp, length);
+  __ j(kGreater, &vector_done);
+  if (use_avx2) {
+    __ vmovdqu(vector_a, Address(a, index, TIMES_1, data_offset));
+    __ vmovdqu(vector_b, Address(b, index, TIMES_1, data_offset));
+    __ vpcmpeqb(vector_a, vector_a, vector_b);
+    __ vpmovmskb(temp, vector_a);
+    __ cmpl(temp, Immediate(-1));
+  } else {
+    __ movdqu(vector_a, Address(a, index, TIMES_1, data_offset));
+    __ movdqu(vector_b, Address(b, index, TIMES_1, data_offset));
+    __ pcmpeqb(vector_a, vector_b);
+    __ pmovmskb(temp, vector_a);
+    __ cmpl(temp, Immediate(0xffff));
+  }
+  __ j(kNotEqual, &vector_not_equal);
+  __ addl(index, Immediate(vector_size));
+  __ jmp(&vector_loop);
+
+  __ Bind(&vector_done);
+  if (use_avx2) {
+    // Avoid the penalty of mixing the VEX.256 instructions with the legacy SSE ones of the
+    // compiled code.
+    __ vzeroupper();
+  }
+
+  // Compare the remaining bytes eight, then one at a time.
+  __ Bind(&word_loop);
+  __ leal(temp, Address(index, 8));
+  __ cmpl(temp, length);
+  __ j(kGreater, &byte_loop);
+  __ movq(temp, Address(a, index, TIMES_1, data_offset));
+  __ cmpq(temp, Address(b, index, TIMES_1, data_offset));
+  __ j(kNotEqual, &return_false);
+  __ addl(index, Immediate(8));
+  __ jmp(&word_loop);
+
+  __ Bind(&byte_loop);
+  __ cmpl(index, length);
+  __ j(kGreaterEqual, &return_true);
+  __ movzxb(temp, Address(a, index, TIMES_1, data_offset));
+  __ movzxb(out, Address(b, index, TIMES_1, data_offset));
+  __ cmpl(temp, out);
+  __ j(kNotEqual, &return_false);
+  __ addl(index, Immediate(1));
+  __ jmp(&byte_loop);
+
+  __ Bind(&vector_not_equal);
+  if (use_avx2) {
+    __ vzeroupper();
+  }
+  __ Bind(&return_false);
+  __ xorl(out, out);
+  __ jmp(&end);
+
+  __ Bind(&return_true);
+  __ movl(out, Immediate(1));
+  __ Bind(&end);
+}
+
 void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
   // Check to see if we have known failures that will cause us to have to bail out
   // to the runtime, and just generate the runtime call directly.
@@ -1540,11 +1779,14 @@ void IntrinsicLocationsBuilderX86_64::VisitStringEquals(HInvoke* invoke) {
   locations->SetInAt(0, Location::RequiresRegister());
   locations->SetInAt(1, Location::RequiresRegister());
 
-  // Request temporary registers, RCX and RDI needed for repe_cmpsq instruction.
+  // Request temporary registers, RCX needed for jrcxz instruction.
   locations->AddTemp(Location::RegisterLocation(RCX));
   locations->AddTemp(Location::RegisterLocation(RDI));
+  // Temporaries to compare 16 bytes at a time.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
 
-  // Set output, RSI needed for repe_cmpsq instruction anyways.
   locations->SetOut(Location::RegisterLocation(RSI), Location::kOutputOverlap);
 }
 
@@ -1557,6 +1799,9 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
   CpuRegister rcx = locations->GetTemp(0).AsRegister<CpuRegister>();
   CpuRegister rdi = locations->GetTemp(1).AsRegister<CpuRegister>();
   CpuRegister rsi = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister xmm_str = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister xmm_arg = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
 
   NearLabel end, return_true, return_false;
 
@@ -1613,7 +1858,7 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
     __ shrl(rcx, Immediate(1));
     __ Bind(&string_uncompressed);
   }
-  // Load starting addresses of string values into RSI/RDI as required for repe_cmpsq instruction.
+  // Load starting addresses of string values into RSI/RDI.
   __ leal(rsi, Address(str, value_offset));
   __ leal(rdi, Address(arg, value_offset));
 
@@ -1626,9 +1871,28 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
   DCHECK_ALIGNED(value_offset, 8);
   static_assert(IsAligned<8>(kObjectAlignment), "String is not zero padded");
 
-  // Loop to compare strings four characters at a time starting at the beginning of the string.
-  __ repe_cmpsq();
-  // If strings are not equal, zero flag will be cleared.
+  // RCX holds the number of 8-byte words to compare, at least one. The padding of the strings
+  // only covers the last word, so compare pairs of words with SSE2 and the last odd word alone.
+  NearLabel loop, last_word;
+  __ subl(rcx, Immediate(2));
+  __ j(kLess, &last_word);
+  __ Bind(&loop);
+  __ movdqu(xmm_str, Address(rsi, 0));
+  __ movdqu(xmm_arg, Address(rdi, 0));
+  __ pcmpeqb(xmm_str, xmm_arg);
+  __ pmovmskb(temp, xmm_str);
+  __ cmpl(temp, Immediate(0xffff));
+  __ j(kNotEqual, &return_false);
+  __ addq(rsi, Immediate(16));
+  __ addq(rdi, Immediate(16));
+  __ subl(rcx, Immediate(2));
+  __ j(kGreaterEqual, &loop);
+  // RCX is now -1 if one word is left, -2 otherwise.
+  __ Bind(&last_word);
+  __ cmpl(rcx, Immediate(-1));
+  __ j(kNotEqual, &return_true);
+  __ movq(temp, Address(rsi, 0));
+  __ cmpq(temp, Address(rdi, 0));
   __ j(kNotEqual, &return_false);
 
   // Return true and exit the function.
@@ -1826,6 +2090,219 @@ void IntrinsicCodeGeneratorX86_64::VisitStringIndexOfAfter(HInvoke* invoke) {
   GenerateStringIndexOf(invoke, GetAssembler(), codegen_, /* start_at_zero */ false);
 }
 
+static void CreateStringStringIndexOfLocations(HInvoke* invoke,
+                                               ArenaAllocator* allocator,
+                                               CodeGeneratorX86_64* codegen,
+                                               bool start_at_zero) {
+  // The search needs pcmpestri. Without it, just call the method.
+  if (!codegen->GetInstructionSetFeatures().HasSSE4_2()) {
+    return;
+  }
+  LocationSummary* locations = new (allocator) LocationSummary(invoke,
+                                                               LocationSummary::kCallOnSlowPath,
+                                                               kIntrinsified);
+  // The slow path calls the method with the original arguments, so they are not clobbered.
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  if (!start_at_zero) {
+    locations->SetInAt(2, Location::RequiresRegister());          // The starting index.
+  }
+  // pcmpestri returns the index of the first match in RCX, which we then use for the result.
+  locations->SetOut(Location::RegisterLocation(RCX));
+  // pcmpestri takes the length of the substring in RAX and the length of the string in RDX.
+  locations->AddTemp(Location::RegisterLocation(RAX));
+  locations->AddTemp(Location::RegisterLocation(RDX));
+  // Address of the string data being searched.
+  locations->AddTemp(Location::RequiresRegister());
+  // The substring data.
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+// Search the string for a substring whose data fits in one XMM register. Both strings are
+// compressed, with one byte per char, or both are uncompressed. On entry, `substring_length`
+// and `remaining` hold the count fields of the substring and of the string. Branches to `found`
+// with the number of chars left in the string from the match in `remaining`.
+static void GenerateStringStringIndexOfSearch(HInvoke* invoke,
+                                              X86_64Assembler* assembler,
+                                              SlowPathCode* slow_path,
+                                              bool start_at_zero,
+                                              bool compressed,
+                                              Label* found,
+                                              Label* not_found) {
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister string_obj = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister substring_obj = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister index = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister substring_length = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister remaining = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister data = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister substring_data = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+
+  int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+  const ScaleFactor scale = compressed ? ScaleFactor::TIMES_1 : ScaleFactor::TIMES_2;
+  constexpr int32_t kVectorSize = 16;
+  const int32_t chars_per_vector = compressed ? kVectorSize : kVectorSize / 2;
+  // Equal ordered aggregation of unsigned bytes or words: the result is the index of the first
+  // position where the substring matches, or where a prefix of it ends the vector.
+  const Immediate mode(compressed ? 0x0C : 0x0D);
+
+  if (mirror::kUseStringCompression) {
+    // Mask out the compression flags.
+    __ shrl(substring_length, Immediate(1));
+    __ shrl(remaining, Immediate(1));
+  }
+  // Empty and long substrings are left to the slow path.
+  __ testl(substring_length, substring_length);
+  __ j(kEqual, slow_path->GetEntryLabel());
+  __ cmpl(substring_length, Immediate(chars_per_vector));
+  __ j(kAbove, slow_path->GetEntryLabel());
+
+  if (start_at_zero) {
+    __ leaq(data, Address(string_obj, value_offset));
+  } else {
+    CpuRegister start_index = locations->InAt(2).AsRegister<CpuRegister>();
+    // Ensure we have a start index >= 0.
+    __ xorl(index, index);
+    __ cmpl(start_index, Immediate(0));
+    __ cmov(kGreater, index, start_index, /* is64bit */ false);  // 32-bit copy is enough.
+    __ subl(remaining, index);
+    __ leaq(data, Address(string_obj, index, scale, value_offset));
+  }
+  __ cmpl(remaining, substring_length);
+  __ j(kLess, not_found);
+
+  // Whole vectors are loaded, past the end of the data if it is shorter. Such a load is only
+  // safe if it does not cross into the next page, otherwise take the slow path.
+  __ leal(index, Address(substring_obj, value_offset));
+  __ andl(index, Immediate(kPageSize - 1));
+  __ cmpl(index, Immediate(kPageSize - kVectorSize));
+  __ j(kAbove, slow_path->GetEntryLabel());
+  __ movdqu(substring_data, Address(substring_obj, value_offset));
+
+  NearLabel loop, load, next_vector;
+  __ Bind(&loop);
+  __ cmpl(remaining, Immediate(chars_per_vector));
+  __ j(kGreaterEqual, &load);
+  __ movl(index, data);
+  __ andl(index, Immediate(kPageSize - 1));
+  __ cmpl(index, Immediate(kPageSize - kVectorSize));
+  __ j(kAbove, slow_path->GetEntryLabel());
+  __ Bind(&load);
+  __ pcmpestri(substring_data, Address(data, 0), mode);
+  __ j(kCarryClear, &next_vector);
+  // The substring fits in the vector, so a match at its start is complete.
+  __ testl(index, index);
+  __ j(kEqual, found);
+  // Otherwise the match may be partial, continue from it.
+  __ subl(remaining, index);
+  __ leaq(data, Address(data, index, scale, 0));
+  __ cmpl(remaining, substring_length);
+  __ j(kGreaterEqual, &loop);
+  __ jmp(not_found);
+
+  __ Bind(&next_vector);
+  __ subl(remaining, Immediate(chars_per_vector));
+  __ addq(data, Immediate(kVectorSize));
+  __ cmpl(remaining, substring_length);
+  __ j(kGreaterEqual, &loop);
+  __ jmp(not_found);
+}
+
+static void GenerateStringStringIndexOf(HInvoke* invoke,
+                                        X86_64Assembler* assembler,
+                                        CodeGeneratorX86_64* codegen,
+                                        bool start_at_zero) {
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister string_obj = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister substring_obj = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister substring_length = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister remaining = locations->GetTemp(1).AsRegister<CpuRegister>();
+
+  // Check our assumptions for registers.
+  DCHECK_EQ(out.AsRegister(), RCX);
+  DCHECK_EQ(substring_length.AsRegister(), RAX);
+  DCHECK_EQ(remaining.AsRegister(), RDX);
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+
+  // The slow path throws the NullPointerException for a null substring.
+  if (invoke->InputAt(1)->CanBeNull()) {
+    __ testl(substring_obj, substring_obj);
+    __ j(kEqual, slow_path->GetEntryLabel());
+  }
+
+  // Location of count within the String object.
+  int32_t count_offset = mirror::String::CountOffset().Int32Value();
+
+  // Load the count fields containing the lengths and compression flags.
+  __ movl(remaining, Address(string_obj, count_offset));
+  __ movl(substring_length, Address(substring_obj, count_offset));
+
+  Label found, not_found, done;
+  if (mirror::kUseStringCompression) {
+    NearLabel same_compression, uncompressed;
+    __ movl(out, remaining);
+    __ xorl(out, substring_length);
+    __ testl(out, Immediate(1));
+    __ j(kZero, &same_compression);
+    // Compressed strings only contain ASCII chars, so they cannot contain an uncompressed
+    // substring. Searching for a compressed substring in an uncompressed string is left to the
+    // slow path.
+    __ testl(substring_length, Immediate(1));
+    __ j(kNotZero, &not_found);
+    __ jmp(slow_path->GetEntryLabel());
+
+    __ Bind(&same_compression);
+    __ testl(remaining, Immediate(1));
+    __ j(kNotZero, &uncompressed);
+    GenerateStringStringIndexOfSearch(
+        invoke, assembler, slow_path, start_at_zero, /* compressed */ true, &found, &not_found);
+    __ Bind(&uncompressed);
+    GenerateStringStringIndexOfSearch(
+        invoke, assembler, slow_path, start_at_zero, /* compressed */ false, &found, &not_found);
+  } else {
+    GenerateStringStringIndexOfSearch(
+        invoke, assembler, slow_path, start_at_zero, /* compressed */ false, &found, &not_found);
+  }
+
+  // The index of the match is the length of the string minus the chars left from it.
+  __ Bind(&found);
+  __ movl(out, Address(string_obj, count_offset));
+  if (mirror::kUseStringCompression) {
+    __ shrl(out, Immediate(1));
+  }
+  __ subl(out, remaining);
+  __ jmp(&done);
+
+  // Failed to match; return -1.
+  __ Bind(&not_found);
+  __ movl(out, Immediate(-1));
+
+  __ Bind(&done);
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitStringStringIndexOf(HInvoke* invoke) {
+  CreateStringStringIndexOfLocations(invoke, allocator_, codegen_, /* start_at_zero */ true);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitStringStringIndexOf(HInvoke* invoke) {
+  GenerateStringStringIndexOf(invoke, GetAssembler(), codegen_, /* start_at_zero */ true);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitStringStringIndexOfAfter(HInvoke* invoke) {
+  CreateStringStringIndexOfLocations(invoke, allocator_, codegen_, /* start_at_zero */ false);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitStringStringIndexOfAfter(HInvoke* invoke) {
+  GenerateStringStringIndexOf(invoke, GetAssembler(), codegen_, /* start_at_zero */ false);
+}
+
 void IntrinsicLocationsBuilderX86_64::VisitStringNewStringFromBytes(HInvoke* invoke) {
   LocationSummary* locations = new (allocator_) LocationSummary(
       invoke, LocationSummary::kCallOnMainAndSlowPath, kIntrinsified);
@@ -2529,6 +3006,147 @@ void IntrinsicCodeGeneratorX86_64::VisitUnsafeCASObject(HInvoke* invoke) {
   GenCAS(DataType::Type::kReference, invoke, codegen_);
 }
 
+static void CreateUnsafeGetAndUpdateLocations(ArenaAllocator* allocator,
+                                              DataType::Type type,
+                                              HInvoke* invoke) {
+  bool can_call = kEmitCompilerReadBarrier &&
+      kUseBakerReadBarrier &&
+      (invoke->GetIntrinsic() == Intrinsics::kUnsafeGetAndSetObject);
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke,
+                                      can_call
+                                          ? LocationSummary::kCallOnSlowPath
+                                          : LocationSummary::kNoCall,
+                                      kIntrinsified);
+  locations->SetInAt(0, Location::NoLocation());        // Unused receiver.
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+  // The new value is copied to the output, which is then exchanged with the field.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+  if (type == DataType::Type::kReference) {
+    // Need temporary registers for card-marking, and possibly for
+    // (Baker) read barrier.
+    locations->AddTemp(Location::RequiresRegister());
+    locations->AddTemp(Location::RequiresRegister());
+  }
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitUnsafeGetAndAddInt(HInvoke* invoke) {
+  CreateUnsafeGetAndUpdateLocations(allocator_, DataType::Type::kInt32, invoke);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitUnsafeGetAndAddLong(HInvoke* invoke) {
+  CreateUnsafeGetAndUpdateLocations(allocator_, DataType::Type::kInt64, invoke);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitUnsafeGetAndSetInt(HInvoke* invoke) {
+  CreateUnsafeGetAndUpdateLocations(allocator_, DataType::Type::kInt32, invoke);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitUnsafeGetAndSetLong(HInvoke* invoke) {
+  CreateUnsafeGetAndUpdateLocations(allocator_, DataType::Type::kInt64, invoke);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitUnsafeGetAndSetObject(HInvoke* invoke) {
+  // As for UnsafeCASObject, the only read barrier implementation
+  // supported is the Baker-style read barriers.
+  if (kEmitCompilerReadBarrier && !kUseBakerReadBarrier) {
+    return;
+  }
+
+  CreateUnsafeGetAndUpdateLocations(allocator_, DataType::Type::kReference, invoke);
+}
+
+// LOCK XADD and XCHG (which is implicitly locked with a memory operand) have full
+// barrier semantics, as required for these volatile accesses.
+static void GenUnsafeGetAndUpdate(DataType::Type type,
+                                  bool is_add,
+                                  HInvoke* invoke,
+                                  CodeGeneratorX86_64* codegen) {
+  X86_64Assembler* assembler = down_cast<X86_64Assembler*>(codegen->GetAssembler());
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister base = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister offset = locations->InAt(2).AsRegister<CpuRegister>();
+  CpuRegister value = locations->InAt(3).AsRegister<CpuRegister>();
+  Location out_loc = locations->Out();
+  CpuRegister out = out_loc.AsRegister<CpuRegister>();
+
+  // The address of the field within the holding object.
+  Address field_addr(base, offset, ScaleFactor::TIMES_1, 0);
+
+  if (type == DataType::Type::kReference) {
+    DCHECK(!is_add);
+    DCHECK(!kEmitCompilerReadBarrier || kUseBakerReadBarrier);
+
+    CpuRegister temp1 = locations->GetTemp(0).AsRegister<CpuRegister>();
+    CpuRegister temp2 = locations->GetTemp(1).AsRegister<CpuRegister>();
+
+    // Mark card for object as the new value is stored.
+    bool value_can_be_null = true;  // TODO: Worth finding out this information?
+    codegen->MarkGCCard(temp1, temp2, base, value, value_can_be_null);
+
+    if (kEmitCompilerReadBarrier && kUseBakerReadBarrier) {
+      // The old reference is returned, so make sure the field holds a to-space
+      // one before the exchange. Other threads only store to-space references.
+      codegen->GenerateReferenceLoadWithBakerReadBarrier(
+          invoke,
+          out_loc,  // Unused, used only as a "temporary" within the read barrier.
+          base,
+          field_addr,
+          /* needs_null_check */ false,
+          /* always_update_field */ true,
+          &temp1,
+          &temp2);
+    }
+
+    __ movl(out, value);
+    __ MaybePoisonHeapReference(out);
+    __ xchgl(out, field_addr);
+    __ MaybeUnpoisonHeapReference(out);
+  } else if (type == DataType::Type::kInt32) {
+    __ movl(out, value);
+    if (is_add) {
+      __ LockXaddl(field_addr, out);
+    } else {
+      __ xchgl(out, field_addr);
+    }
+  } else {
+    DCHECK_EQ(type, DataType::Type::kInt64);
+    __ movq(out, value);
+    if (is_add) {
+      __ LockXaddq(field_addr, out);
+    } else {
+      __ xchgq(out, field_addr);
+    }
+  }
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitUnsafeGetAndAddInt(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(DataType::Type::kInt32, /* is_add */ true, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitUnsafeGetAndAddLong(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(DataType::Type::kInt64, /* is_add */ true, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitUnsafeGetAndSetInt(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(DataType::Type::kInt32, /* is_add */ false, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitUnsafeGetAndSetLong(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(DataType::Type::kInt64, /* is_add */ false, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitUnsafeGetAndSetObject(HInvoke* invoke) {
+  // As for UnsafeCASObject, the only read barrier implementation
+  // supported is the Baker-style read barriers.
+  DCHECK(!kEmitCompilerReadBarrier || kUseBakerReadBarrier);
+
+  GenUnsafeGetAndUpdate(DataType::Type::kReference, /* is_add */ false, invoke, codegen_);
+}
+
 void IntrinsicLocationsBuilderX86_64::VisitIntegerReverse(HInvoke* invoke) {
   LocationSummary* locations =
       new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
@@ -2807,6 +3425,57 @@ void IntrinsicCodeGeneratorX86_64::VisitLongLowestOneBit(HInvoke* invoke) {
   GenOneBit(GetAssembler(), codegen_, invoke, /* is_high */ false, /* is_long */ true);
 }
 
+static void CreateIsInfiniteLocations(ArenaAllocator* allocator, HInvoke* invoke, bool is64bit) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister());
+  if (is64bit) {
+    locations->AddTemp(Location::RequiresRegister());
+  }
+}
+
+static void GenIsInfinite(X86_64Assembler* assembler,
+                          CodeGeneratorX86_64* codegen,
+                          HInvoke* invoke,
+                          bool is64bit) {
+  LocationSummary* locations = invoke->GetLocations();
+  XmmRegister in = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  // The value is infinite if, ignoring the sign, its exponent is all ones and
+  // its mantissa is zero.
+  if (is64bit) {
+    CpuRegister temp = locations->GetTemp(0).AsRegister<CpuRegister>();
+    __ movd(out, in, /* is64bit */ true);
+    __ shlq(out, Immediate(1));
+    codegen->Load64BitValue(temp, static_cast<int64_t>(UINT64_C(0xffe0000000000000)));
+    __ cmpq(out, temp);
+  } else {
+    __ movd(out, in, /* is64bit */ false);
+    __ shll(out, Immediate(1));
+    __ cmpl(out, Immediate(static_cast<int32_t>(0xff000000u)));
+  }
+  __ setcc(kEqual, out);
+  __ movzxb(out, out);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitFloatIsInfinite(HInvoke* invoke) {
+  CreateIsInfiniteLocations(allocator_, invoke, /* is64bit */ false);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitFloatIsInfinite(HInvoke* invoke) {
+  GenIsInfinite(GetAssembler(), codegen_, invoke, /* is64bit */ false);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitDoubleIsInfinite(HInvoke* invoke) {
+  CreateIsInfiniteLocations(allocator_, invoke, /* is64bit */ true);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitDoubleIsInfinite(HInvoke* invoke) {
+  GenIsInfinite(GetAssembler(), codegen_, invoke, /* is64bit */ true);
+}
+
 static void CreateLeadingZeroLocations(ArenaAllocator* allocator, HInvoke* invoke) {
   LocationSummary* locations =
       new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
@@ -3035,6 +3704,60 @@ void IntrinsicCodeGeneratorX86_64::VisitThreadInterrupted(HInvoke* invoke) {
   __ Bind(&done);
 }
 
+void IntrinsicLocationsBuilderX86_64::VisitReferenceGetReferent(HInvoke* invoke) {
+  IntrinsicVisitor::CreateReferenceGetReferentLocations(invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitReferenceGetReferent(HInvoke* invoke) {
+  IntrinsicVisitor::ReferenceGetReferentInfo info =
+      IntrinsicVisitor::ComputeReferenceGetReferentInfo();
+  LocationSummary* locations = invoke->GetLocations();
+  X86_64Assembler* assembler = GetAssembler();
+
+  Location obj_loc = locations->InAt(0);
+  CpuRegister obj = obj_loc.AsRegister<CpuRegister>();
+  Location out_loc = locations->Out();
+  CpuRegister out = out_loc.AsRegister<CpuRegister>();
+
+  SlowPathCode* slow_path = new (GetAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen_->AddSlowPath(slow_path);
+
+  if (kEmitCompilerReadBarrier) {
+    // The concurrent copying collector blocks weak reference accesses while it processes them.
+    int32_t offset = Thread::WeakRefAccessEnabledOffset<kX86_64PointerSize>().Int32Value();
+    __ gs()->cmpl(Address::Absolute(offset, /* no_rip */ true), Immediate(0));
+    __ j(kEqual, slow_path->GetEntryLabel());
+  }
+
+  // Check the static java.lang.ref.Reference.{disableIntrinsic,slowPathEnabled} flags,
+  // together if they are adjacent. The class is in the boot image, so its address is
+  // a 32-bit constant.
+  uint32_t address = dchecked_integral_cast<uint32_t>(reinterpret_cast<uintptr_t>(info.reference));
+  Address disable_intrinsic =
+      Address::Absolute(address + info.disable_intrinsic_offset, /* no_rip */ true);
+  if (info.slow_path_offset == info.disable_intrinsic_offset + 1u) {
+    __ cmpw(disable_intrinsic, Immediate(0));
+    __ j(kNotEqual, slow_path->GetEntryLabel());
+  } else {
+    __ cmpb(disable_intrinsic, Immediate(0));
+    __ j(kNotEqual, slow_path->GetEntryLabel());
+    __ cmpb(Address::Absolute(address + info.slow_path_offset, /* no_rip */ true), Immediate(0));
+    __ j(kNotEqual, slow_path->GetEntryLabel());
+  }
+
+  // Fast path: load the referent. It is volatile, but x86 loads need no fence.
+  uint32_t referent_offset = mirror::Reference::ReferentOffset().Uint32Value();
+  if (kEmitCompilerReadBarrier && kUseBakerReadBarrier) {
+    codegen_->GenerateFieldLoadWithBakerReadBarrier(
+        invoke, out_loc, obj, referent_offset, /* needs_null_check */ false);
+  } else {
+    __ movl(out, Address(obj, referent_offset));
+    __ MaybeUnpoisonHeapReference(out);
+    codegen_->MaybeGenerateReadBarrierSlow(invoke, out_loc, out_loc, obj_loc, referent_offset);
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
 void IntrinsicLocationsBuilderX86_64::VisitReachabilityFence(HInvoke* invoke) {
   LocationSummary* locations =
       new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
@@ -3043,12 +3766,450 @@ void IntrinsicLocationsBuilderX86_64::VisitReachabilityFence(HInvoke* invoke) {
 
 void IntrinsicCodeGeneratorX86_64::VisitReachabilityFence(HInvoke* invoke ATTRIBUTE_UNUSED) { }
 
-UNIMPLEMENTED_INTRINSIC(X86_64, ReferenceGetReferent)
-UNIMPLEMENTED_INTRINSIC(X86_64, FloatIsInfinite)
-UNIMPLEMENTED_INTRINSIC(X86_64, DoubleIsInfinite)
+// The checksum intrinsics take the checksum so far, the data, which is either a byte[] or the
+// address of the memory of a direct ByteBuffer, an offset into the data and the length. The
+// callers in libcore have checked the bounds.
+static void CreateChecksumLocations(ArenaAllocator* allocator,
+                                    HInvoke* invoke,
+                                    size_t num_temps,
+                                    size_t num_fp_temps) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RegisterOrConstant(invoke->InputAt(2)));
+  locations->SetInAt(3, Location::RequiresRegister());
+  for (size_t i = 0; i != num_temps; ++i) {
+    locations->AddTemp(Location::RequiresRegister());
+  }
+  for (size_t i = 0; i != num_fp_temps; ++i) {
+    locations->AddTemp(Location::RequiresFpuRegister());
+  }
+  // The output holds the checksum while it is computed.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+// Load the address of the first byte of the data of a checksum intrinsic into `ptr`.
+static void GenChecksumDataAddress(X86_64Assembler* assembler,
+                                   LocationSummary* locations,
+                                   bool is_byte_buffer,
+                                   CpuRegister ptr) {
+  CpuRegister data = locations->InAt(1).AsRegister<CpuRegister>();
+  Location offset = locations->InAt(2);
+  if (is_byte_buffer) {
+    if (offset.IsConstant()) {
+      __ leaq(ptr, Address(data, offset.GetConstant()->AsIntConstant()->GetValue()));
+    } else {
+      __ movsxd(ptr, offset.AsRegister<CpuRegister>());
+      __ addq(ptr, data);
+    }
+  } else {
+    const uint32_t data_offset = mirror::Array::DataOffset(sizeof(int8_t)).Uint32Value();
+    if (offset.IsConstant()) {
+      __ leal(ptr, Address(data, offset.GetConstant()->AsIntConstant()->GetValue() + data_offset));
+    } else {
+      __ leal(ptr, Address(data, offset.AsRegister<CpuRegister>(), TIMES_1, data_offset));
+    }
+  }
+}
+
+// Load the 128-bit constant `high`:`low` into `dst`.
+static void LoadConstant128(X86_64Assembler* assembler,
+                            XmmRegister dst,
+                            uint64_t high,
+                            uint64_t low,
+                            CpuRegister temp,
+                            XmmRegister xmm_temp) {
+  __ movq(temp, Immediate(static_cast<int64_t>(low)));
+  __ movd(dst, temp);
+  __ movq(temp, Immediate(static_cast<int64_t>(high)));
+  __ movd(xmm_temp, temp);
+  __ punpcklqdq(dst, xmm_temp);
+}
+
+// The constants of the CRC32 folding and Barrett reduction with PCLMULQDQ, for the reflected
+// polynomial 0xEDB88320 of java.util.zip.CRC32, see "Fast CRC Computation for Generic
+// Polynomials Using PCLMULQDQ Instruction" by Gopal et al. Each pair is the high and the low
+// quadword of a constant.
+static constexpr uint64_t kCRC32FoldBy4[] = { UINT64_C(0x1c6e41596), UINT64_C(0x154442bd4) };
+static constexpr uint64_t kCRC32FoldBy1[] = { UINT64_C(0x0ccaa009e), UINT64_C(0x1751997d0) };
+static constexpr uint64_t kCRC32Fold64To32 = UINT64_C(0x163cd6124);
+static constexpr uint64_t kCRC32Barrett[] = { UINT64_C(0x1f7011641), UINT64_C(0x1db710641) };
+
+// Set `x` to the carry-less products of its quadwords by those of `constant`, xored together.
+// This moves the 128 bits in `x` 128 or 512 bits further in the message, depending on the
+// constant, so that they can be xored with the data there.
+static void GenCRC32Fold(X86_64Assembler* assembler,
+                         XmmRegister x,
+                         XmmRegister constant,
+                         XmmRegister temp) {
+  __ movdqa(temp, x);
+  __ pclmulqdq(x, constant, Immediate(0x00));
+  __ pclmulqdq(temp, constant, Immediate(0x11));
+  __ pxor(x, temp);
+}
+
+// Clear all the bits of `x` but the low 32 ones.
+static void GenClearHigh96Bits(X86_64Assembler* assembler, XmmRegister x, CpuRegister temp) {
+  __ movd(temp, x, /* is64bit */ false);
+  __ movd(x, temp, /* is64bit */ false);
+}
+
+// Reduce the 64 bits in the low quadword of `x` to the 32-bit CRC in `out`, with the Barrett
+// reduction.
+static void GenCRC32BarrettReduction(X86_64Assembler* assembler,
+                                     CpuRegister out,
+                                     XmmRegister x,
+                                     XmmRegister constant,
+                                     XmmRegister temp) {
+  __ movdqa(temp, x);
+  GenClearHigh96Bits(assembler, x, out);
+  __ pclmulqdq(x, constant, Immediate(0x10));
+  GenClearHigh96Bits(assembler, x, out);
+  __ pclmulqdq(x, constant, Immediate(0x00));
+  __ pxor(x, temp);
+  __ pshufd(x, x, Immediate(1));
+  __ movd(out, x, /* is64bit */ false);
+}
+
+// Update the CRC in `crc` with the `length` (1, 2 or 4) bytes at `ptr`.
+static void GenCRC32UpdateSmall(X86_64Assembler* assembler,
+                                size_t length,
+                                CpuRegister crc,
+                                CpuRegister ptr,
+                                CpuRegister temp,
+                                XmmRegister x,
+                                XmmRegister constant,
+                                XmmRegister xmm_temp) {
+  if (length == 4u) {
+    __ movl(temp, Address(ptr, 0));
+    __ xorl(temp, crc);
+  } else {
+    if (length == 2u) {
+      __ movzxw(temp, Address(ptr, 0));
+    } else {
+      DCHECK_EQ(length, 1u);
+      __ movzxb(temp, Address(ptr, 0));
+    }
+    __ xorl(temp, crc);
+    __ andl(temp, Immediate((1 << (length * kBitsPerByte)) - 1));
+    __ shll(temp, Immediate(32 - length * kBitsPerByte));
+    __ shrl(crc, Immediate(length * kBitsPerByte));
+  }
+  __ movd(x, temp, /* is64bit */ false);
+  GenCRC32BarrettReduction(assembler, temp, x, constant, xmm_temp);
+  if (length == 4u) {
+    __ movl(crc, temp);
+  } else {
+    __ xorl(crc, temp);
+  }
+  __ addq(ptr, Immediate(length));
+}
+
+static void CreateCRC32Locations(ArenaAllocator* allocator,
+                                 HInvoke* invoke,
+                                 CodeGeneratorX86_64* codegen) {
+  // The instruction set features do not track PCLMULQDQ, which all the x86 processors with AVX
+  // support.
+  if (!codegen->GetInstructionSetFeatures().HasAVX()) {
+    return;
+  }
+  CreateChecksumLocations(allocator, invoke, /* num_temps */ 3u, /* num_fp_temps */ 8u);
+}
+
+static void GenCRC32Update(HInvoke* invoke, CodeGeneratorX86_64* codegen, bool is_byte_buffer) {
+  X86_64Assembler* assembler = down_cast<X86_64Assembler*>(codegen->GetAssembler());
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister crc_in = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister length = locations->InAt(3).AsRegister<CpuRegister>();
+  CpuRegister ptr = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister remaining = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister x1 = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister x2 = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+  XmmRegister x3 = locations->GetTemp(5).AsFpuRegister<XmmRegister>();
+  XmmRegister x4 = locations->GetTemp(6).AsFpuRegister<XmmRegister>();
+  XmmRegister fold_by_4 = locations->GetTemp(7).AsFpuRegister<XmmRegister>();
+  XmmRegister fold_by_1 = locations->GetTemp(8).AsFpuRegister<XmmRegister>();
+  XmmRegister barrett = locations->GetTemp(9).AsFpuRegister<XmmRegister>();
+  XmmRegister xmm_temp = locations->GetTemp(10).AsFpuRegister<XmmRegister>();
+  CpuRegister crc = locations->Out().AsRegister<CpuRegister>();
+
+  GenChecksumDataAddress(assembler, locations, is_byte_buffer, ptr);
+  __ movl(remaining, length);
+  // The CRC of java.util.zip.CRC32 is inverted before and after the update.
+  __ movl(crc, crc_in);
+  __ notl(crc);
+  LoadConstant128(assembler, barrett, kCRC32Barrett[0], kCRC32Barrett[1], temp, xmm_temp);
+
+  Label fold_by_1_loop, fold_by_1_done, small;
+  __ cmpl(remaining, Immediate(16));
+  __ j(kLess, &small);
+  LoadConstant128(assembler, fold_by_1, kCRC32FoldBy1[0], kCRC32FoldBy1[1], temp, xmm_temp);
+  __ movdqu(x1, Address(ptr, 0));
+  __ movd(xmm_temp, crc, /* is64bit */ false);
+  __ pxor(x1, xmm_temp);
+  __ addq(ptr, Immediate(16));
+  __ subl(remaining, Immediate(16));
+
+  // With at least 64 bytes, fold four blocks of 16 bytes at a time, which hides the latency of
+  // PCLMULQDQ, then fold the four blocks into one.
+  __ cmpl(remaining, Immediate(48));
+  __ j(kLess, &fold_by_1_loop);
+  __ movdqu(x2, Address(ptr, 0));
+  __ movdqu(x3, Address(ptr, 16));
+  __ movdqu(x4, Address(ptr, 32));
+  __ addq(ptr, Immediate(48));
+  __ subl(remaining, Immediate(48));
+  XmmRegister blocks[] = { x1, x2, x3, x4 };
+  Label fold_by_4_loop, fold_by_4_done;
+  __ cmpl(remaining, Immediate(64));
+  __ j(kLess, &fold_by_4_done);
+  LoadConstant128(assembler, fold_by_4, kCRC32FoldBy4[0], kCRC32FoldBy4[1], temp, xmm_temp);
+  __ Bind(&fold_by_4_loop);
+  for (size_t i = 0; i != arraysize(blocks); ++i) {
+    GenCRC32Fold(assembler, blocks[i], fold_by_4, xmm_temp);
+    __ movdqu(xmm_temp, Address(ptr, static_cast<int32_t>(i * 16)));
+    __ pxor(blocks[i], xmm_temp);
+  }
+  __ addq(ptr, Immediate(64));
+  __ subl(remaining, Immediate(64));
+  __ cmpl(remaining, Immediate(64));
+  __ j(kGreaterEqual, &fold_by_4_loop);
+  __ Bind(&fold_by_4_done);
+  for (size_t i = 1; i != arraysize(blocks); ++i) {
+    GenCRC32Fold(assembler, x1, fold_by_1, xmm_temp);
+    __ pxor(x1, blocks[i]);
+  }
+
+  // Fold the remaining blocks of 16 bytes one at a time.
+  __ Bind(&fold_by_1_loop);
+  __ cmpl(remaining, Immediate(16));
+  __ j(kLess, &fold_by_1_done);
+  GenCRC32Fold(assembler, x1, fold_by_1, xmm_temp);
+  __ movdqu(xmm_temp, Address(ptr, 0));
+  __ pxor(x1, xmm_temp);
+  __ addq(ptr, Immediate(16));
+  __ subl(remaining, Immediate(16));
+  __ jmp(&fold_by_1_loop);
+
+  // Fold the 128 bits into 64, then reduce them to the CRC.
+  __ Bind(&fold_by_1_done);
+  __ movdqa(xmm_temp, fold_by_1);
+  __ pclmulqdq(xmm_temp, x1, Immediate(0x01));
+  __ psrldq(x1, Immediate(8));
+  __ pxor(x1, xmm_temp);
+  __ movdqa(x2, x1);
+  __ psrldq(x2, Immediate(4));
+  GenClearHigh96Bits(assembler, x1, temp);
+  __ movq(temp, Immediate(static_cast<int64_t>(kCRC32Fold64To32)));
+  __ movd(x3, temp);
+  __ pclmulqdq(x1, x3, Immediate(0x00));
+  __ pxor(x1, x2);
+  GenCRC32BarrettReduction(assembler, crc, x1, barrett, xmm_temp);
+
+  // Update the CRC with the last 15 bytes or less, four, two and one at a time.
+  Label small_loop, small_2, small_1, done;
+  __ Bind(&small);
+  __ Bind(&small_loop);
+  __ cmpl(remaining, Immediate(4));
+  __ j(kLess, &small_2);
+  GenCRC32UpdateSmall(assembler, 4u, crc, ptr, temp, x1, barrett, xmm_temp);
+  __ subl(remaining, Immediate(4));
+  __ jmp(&small_loop);
+  __ Bind(&small_2);
+  __ testl(remaining, Immediate(2));
+  __ j(kEqual, &small_1);
+  GenCRC32UpdateSmall(assembler, 2u, crc, ptr, temp, x1, barrett, xmm_temp);
+  __ Bind(&small_1);
+  __ testl(remaining, Immediate(1));
+  __ j(kEqual, &done);
+  GenCRC32UpdateSmall(assembler, 1u, crc, ptr, temp, x1, barrett, xmm_temp);
+  __ Bind(&done);
+  __ notl(crc);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitCRC32UpdateBytes(HInvoke* invoke) {
+  CreateCRC32Locations(allocator_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitCRC32UpdateBytes(HInvoke* invoke) {
+  GenCRC32Update(invoke, codegen_, /* is_byte_buffer */ false);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitCRC32UpdateByteBuffer(HInvoke* invoke) {
+  CreateCRC32Locations(allocator_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitCRC32UpdateByteBuffer(HInvoke* invoke) {
+  GenCRC32Update(invoke, codegen_, /* is_byte_buffer */ true);
+}
+
+// The modulus of the Adler-32 sums.
+static constexpr int32_t kAdler32Base = 65521;
+// The largest number of blocks of 16 bytes that can be summed before the sums may overflow 32
+// bits, the NMAX of zlib divided by 16.
+static constexpr int32_t kAdler32MaxBlocks = 5552 / 16;
+
+// Reduce the sum in `value` modulo kAdler32Base. As 65536 is 15 modulo kAdler32Base, the high
+// half of the value is folded into the low one twice, which leaves a value below
+// 2 * kAdler32Base.
+static void GenAdler32Reduce(X86_64Assembler* assembler, CpuRegister value, CpuRegister temp) {
+  for (size_t i = 0; i != 2u; ++i) {
+    __ movl(temp, value);
+    __ shrl(temp, Immediate(16));
+    __ andl(value, Immediate(0xffff));
+    __ imull(temp, temp, Immediate(15));
+    __ addl(value, temp);
+  }
+  __ leal(temp, Address(value, -kAdler32Base));
+  __ cmpl(value, Immediate(kAdler32Base));
+  __ cmov(kAboveEqual, value, temp, /* is64bit */ false);
+}
+
+// Add the four 32-bit elements of `x` together into the low one.
+static void GenHorizontalAdd(X86_64Assembler* assembler, XmmRegister x, XmmRegister temp) {
+  __ pshufd(temp, x, Immediate(0x4e));
+  __ paddd(x, temp);
+  __ pshufd(temp, x, Immediate(0xb1));
+  __ paddd(x, temp);
+}
+
+static void CreateAdler32Locations(ArenaAllocator* allocator,
+                                   HInvoke* invoke,
+                                   CodeGeneratorX86_64* codegen) {
+  // PMADDUBSW is a SSSE3 instruction.
+  if (!codegen->GetInstructionSetFeatures().HasSSSE3()) {
+    return;
+  }
+  CreateChecksumLocations(allocator, invoke, /* num_temps */ 5u, /* num_fp_temps */ 8u);
+}
+
+static void GenAdler32Update(HInvoke* invoke, CodeGeneratorX86_64* codegen, bool is_byte_buffer) {
+  X86_64Assembler* assembler = down_cast<X86_64Assembler*>(codegen->GetAssembler());
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister adler = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister length = locations->InAt(3).AsRegister<CpuRegister>();
+  CpuRegister ptr = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister remaining = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(2).AsRegister<CpuRegister>();
+  CpuRegister count = locations->GetTemp(3).AsRegister<CpuRegister>();
+  // The Adler-32 checksum is made of two sums modulo kAdler32Base: s1 of the bytes, in the low
+  // half, and s2 of the values of s1 after each byte, in the high half.
+  CpuRegister s2 = locations->GetTemp(4).AsRegister<CpuRegister>();
+  XmmRegister weights = locations->GetTemp(5).AsFpuRegister<XmmRegister>();
+  XmmRegister zero = locations->GetTemp(6).AsFpuRegister<XmmRegister>();
+  XmmRegister ones = locations->GetTemp(7).AsFpuRegister<XmmRegister>();
+  XmmRegister vector_s1 = locations->GetTemp(8).AsFpuRegister<XmmRegister>();
+  XmmRegister vector_s2 = locations->GetTemp(9).AsFpuRegister<XmmRegister>();
+  XmmRegister previous_s1 = locations->GetTemp(10).AsFpuRegister<XmmRegister>();
+  XmmRegister data = locations->GetTemp(11).AsFpuRegister<XmmRegister>();
+  XmmRegister xmm_temp = locations->GetTemp(12).AsFpuRegister<XmmRegister>();
+  CpuRegister s1 = locations->Out().AsRegister<CpuRegister>();
+
+  GenChecksumDataAddress(assembler, locations, is_byte_buffer, ptr);
+  __ movl(remaining, length);
+  __ movl(s1, adler);
+  __ andl(s1, Immediate(0xffff));
+  __ movl(s2, adler);
+  __ shrl(s2, Immediate(16));
+
+  // Each block of 16 bytes adds the sum of its bytes to s1, and the sum of its bytes weighted
+  // by 16 down to 1 to s2, plus 16 times the value of s1 before the block.
+  LoadConstant128(assembler,
+                  weights,
+                  UINT64_C(0x0102030405060708),
+                  UINT64_C(0x090a0b0c0d0e0f10),
+                  temp,
+                  xmm_temp);
+  LoadConstant128(assembler,
+                  ones,
+                  UINT64_C(0x0001000100010001),
+                  UINT64_C(0x0001000100010001),
+                  temp,
+                  xmm_temp);
+  __ pxor(zero, zero);
+
+  Label chunk_loop, block_loop, small, small_loop, done;
+  // Sum chunks of as many blocks as possible without overflowing 32 bits, and reduce the sums
+  // after each chunk.
+  __ Bind(&chunk_loop);
+  __ cmpl(remaining, Immediate(16));
+  __ j(kLess, &small);
+  __ movl(count, remaining);
+  __ shrl(count, Immediate(4));
+  __ movl(temp, Immediate(kAdler32MaxBlocks));
+  __ cmpl(count, temp);
+  __ cmov(kGreater, count, temp, /* is64bit */ false);
+  __ movl(temp, count);
+  __ shll(temp, Immediate(4));
+  __ subl(remaining, temp);
+  // The s1 of the chunk starts at 0 and the initial s1 is added to s2 once for every block.
+  __ movl(temp, s1);
+  __ imull(temp, count);
+  __ movd(previous_s1, temp, /* is64bit */ false);
+  __ movd(vector_s2, s2, /* is64bit */ false);
+  __ pxor(vector_s1, vector_s1);
+  __ Bind(&block_loop);
+  __ movdqu(data, Address(ptr, 0));
+  __ paddd(previous_s1, vector_s1);
+  __ movdqa(xmm_temp, data);
+  __ psadbw(xmm_temp, zero);
+  __ paddd(vector_s1, xmm_temp);
+  __ pmaddubsw(data, weights);
+  __ pmaddwd(data, ones);
+  __ paddd(vector_s2, data);
+  __ addq(ptr, Immediate(16));
+  __ subl(count, Immediate(1));
+  __ j(kNotEqual, &block_loop);
+  __ pslld(previous_s1, Immediate(4));
+  __ paddd(vector_s2, previous_s1);
+  GenHorizontalAdd(assembler, vector_s1, xmm_temp);
+  GenHorizontalAdd(assembler, vector_s2, xmm_temp);
+  __ movd(temp, vector_s1, /* is64bit */ false);
+  __ addl(s1, temp);
+  __ movd(s2, vector_s2, /* is64bit */ false);
+  GenAdler32Reduce(assembler, s1, temp);
+  GenAdler32Reduce(assembler, s2, temp);
+  __ jmp(&chunk_loop);
+
+  // Sum the last 15 bytes or less one at a time.
+  __ Bind(&small);
+  __ testl(remaining, remaining);
+  __ j(kEqual, &done);
+  __ Bind(&small_loop);
+  __ movzxb(temp, Address(ptr, 0));
+  __ addl(s1, temp);
+  __ addl(s2, s1);
+  __ addq(ptr, Immediate(1));
+  __ subl(remaining, Immediate(1));
+  __ j(kNotEqual, &small_loop);
+  GenAdler32Reduce(assembler, s1, temp);
+  GenAdler32Reduce(assembler, s2, temp);
+
+  __ Bind(&done);
+  __ shll(s2, Immediate(16));
+  __ orl(s1, s2);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitAdler32UpdateBytes(HInvoke* invoke) {
+  CreateAdler32Locations(allocator_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitAdler32UpdateBytes(HInvoke* invoke) {
+  GenAdler32Update(invoke, codegen_, /* is_byte_buffer */ false);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitAdler32UpdateByteBuffer(HInvoke* invoke) {
+  CreateAdler32Locations(allocator_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitAdler32UpdateByteBuffer(HInvoke* invoke) {
+  GenAdler32Update(invoke, codegen_, /* is_byte_buffer */ true);
+}
 
-UNIMPLEMENTED_INTRINSIC(X86_64, StringStringIndexOf);
-UNIMPLEMENTED_INTRINSIC(X86_64, StringStringIndexOfAfter);
 UNIMPLEMENTED_INTRINSIC(X86_64, StringBufferAppend);
 UNIMPLEMENTED_INTRINSIC(X86_64, StringBufferLength);
 UNIMPLEMENTED_INTRINSIC(X86_64, StringBufferToString);
@@ -3056,13 +4217,6 @@ UNIMPLEMENTED_INTRINSIC(X86_64, StringBuilderAppend);
 UNIMPLEMENTED_INTRINSIC(X86_64, StringBuilderLength);
 UNIMPLEMENTED_INTRINSIC(X86_64, StringBuilderToString);
 
-// 1.8.
-UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndAddInt)
-UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndAddLong)
-UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndSetInt)
-UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndSetLong)
-UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndSetObject)
-
 UNREACHABLE_INTRINSICS(X86_64)
 
 #undef __
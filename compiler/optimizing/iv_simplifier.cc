@@ -1,324 +1,234 @@
 #include "iv_simplifier.h"
-#include<tuple>
 
-namespace art{
+namespace art {
 
-
-typedef std::tuple<HInstruction*,HConstant*, HConstant* > triple;
 //
 // public methods
 //
 InductionVarSimplification::InductionVarSimplification(HInductionVarAnalysis* induction_analysis)
-    : induction_analysis_(induction_analysis),
-      biv_increment_(nullptr) {
+    : induction_analysis_(induction_analysis) {
   DCHECK(induction_analysis != nullptr);
 }
 
 /*Helper Functions*/
-static HConstant* GetNewConstant(HInstruction::InstructionKind kind, HConstant* cst1, HConstant* cst2) {
-   DataType::Type type = cst1->GetType();
-   HConstant* new_cst = nullptr;
-   HGraph* graph = cst1->GetBlock()->GetGraph();
-   if (DataType::IsIntegralType(type)) {
-     int64_t new_val = 0;
-     switch (kind) {
-      case HInstruction::kAdd :
-      new_val = Int64FromConstant(cst1) + Int64FromConstant(cst2);
+static bool IsLoopHeaderPhi(HLoopInformation* loop, HInstruction* instruction) {
+  return instruction->IsPhi() && instruction->GetBlock() == loop->GetHeader();
+}
+
+bool InductionVarSimplification::GenerateInvariant(HLoopInformation* loop,
+                                                   HInductionVarAnalysis::InductionInfo* info,
+                                                   HBasicBlock* block,
+                                                   /*out*/ HInstruction** result) {
+  if (info == nullptr || info->induction_class != HInductionVarAnalysis::kInvariant) {
+    return false;
+  }
+  DataType::Type type = info->type;
+  HGraph* graph = loop->GetHeader()->GetGraph();
+  HInstruction* opa = nullptr;
+  HInstruction* opb = nullptr;
+  switch (info->operation) {
+    case HInductionVarAnalysis::kFetch: {
+      HInstruction* fetch = info->fetch;
+      if (!loop->IsDefinedOutOfTheLoop(fetch)) {
+        return false;
+      }
+      if (fetch->GetType() != type) {
+        // Implicit conversion is only handled for constants.
+        if (!fetch->IsIntConstant() && !fetch->IsLongConstant()) {
+          return false;
+        }
+        if (block != nullptr) {
+          *result = graph->GetConstant(type, Int64FromConstant(fetch->AsConstant()));
+        }
+        return true;
+      }
+      if (block != nullptr) {
+        *result = fetch;
+      }
+      return true;
+    }
+    case HInductionVarAnalysis::kAdd:
+    case HInductionVarAnalysis::kSub:
+    case HInductionVarAnalysis::kMul:
+      if (!GenerateInvariant(loop, info->op_a, block, &opa) ||
+          !GenerateInvariant(loop, info->op_b, block, &opb)) {
+        return false;
+      }
       break;
-      case HInstruction::kSub: 
-      new_val = Int64FromConstant(cst1) - Int64FromConstant(cst2);
+    case HInductionVarAnalysis::kNeg:
+      if (!GenerateInvariant(loop, info->op_b, block, &opb)) {
+        return false;
+      }
       break;
-      case HInstruction::kMul:
-       new_val = Int64FromConstant(cst1) * Int64FromConstant(cst2);
-       break;
-      default :
-       UNREACHABLE();
-     }
-      new_cst = graph->GetConstant(type, new_val);
-      return new_cst;
-    } else if (cst1->IsDoubleConstant()) {
-      double new_val =0.0;
-      switch (kind){
-        case HInstruction::kAdd:
-        new_val = cst1->AsDoubleConstant()->GetValue() + cst2->AsDoubleConstant()->GetValue();
-        break;
-        case HInstruction::kSub:
-        new_val = cst1->AsDoubleConstant()->GetValue() - (cst2->AsDoubleConstant()->GetValue());
-        break;
-        case HInstruction::kMul:
-        new_val = cst1->AsDoubleConstant()->GetValue() * cst2->AsDoubleConstant()->GetValue();
+    default:
+      // Division, remainder, xor and trip-counts are not reduced.
+      return false;
+  }
+  if (block != nullptr) {
+    ArenaAllocator* allocator = graph->GetAllocator();
+    HInstruction* operation = nullptr;
+    switch (info->operation) {
+      case HInductionVarAnalysis::kAdd:
+        operation = new (allocator) HAdd(type, opa, opb);
         break;
-        default :
-          UNREACHABLE();
-      }
-      new_cst = graph->GetDoubleConstant(new_val);
-      return new_cst;
-    } else if (cst1->IsFloatConstant()) {
-      float new_val = 0.0;
-      switch (kind) {
-       case HInstruction::kAdd:
-        new_val = cst1->AsFloatConstant()->GetValue() + cst2->AsFloatConstant()->GetValue();
+      case HInductionVarAnalysis::kSub:
+        operation = new (allocator) HSub(type, opa, opb);
         break;
-       case HInstruction::kSub:
-        new_val = cst1->AsFloatConstant()->GetValue() - cst2->AsFloatConstant()->GetValue();
+      case HInductionVarAnalysis::kMul:
+        operation = new (allocator) HMul(type, opa, opb);
         break;
-       case HInstruction::kMul:
-        new_val = cst1->AsFloatConstant()->GetValue() * cst2->AsFloatConstant()->GetValue();
+      case HInductionVarAnalysis::kNeg:
+        operation = new (allocator) HNeg(type, opb);
         break;
-        default:
-          UNREACHABLE();
-      }
-      new_cst = graph->GetFloatConstant( new_val);
-      return new_cst;
+      default:
+        LOG(FATAL) << "Unexpected invariant operation";
+        UNREACHABLE();
     }
-    return nullptr;
+    block->InsertInstructionBefore(operation, block->GetLastInstruction());
+    *result = operation;
+  }
+  return true;
 }
-static HConstant* GetConstant(HGraph* graph, DataType::Type type, int64_t value){
-   HConstant * cst = nullptr;
-   if (DataType::IsIntegralType(type)) {
-      cst = graph->GetConstant(type, value);
-   } else if (type == DataType::Type::kFloat32) {
-     float val = static_cast<float>(value);
-     cst = graph->GetFloatConstant(val);
-   } else if (type == DataType::Type::kFloat64) {
-     double val = static_cast<double>(value);
-     cst = graph->GetDoubleConstant(val);
-   }
-   return cst;
+
+HPhi* InductionVarSimplification::PerformReduction(HLoopInformation* loop,
+                                                  HInductionVarAnalysis::InductionInfo* info) {
+  DCHECK_EQ(info->induction_class, HInductionVarAnalysis::kLinear);
+  HBasicBlock* header = loop->GetHeader();
+  HBasicBlock* preheader = loop->GetPreHeader();
+  HBasicBlock* back_edge = loop->GetBackEdges()[0];
+  ArenaAllocator* allocator = header->GetGraph()->GetAllocator();
+  HInstruction* stride = nullptr;
+  HInstruction* initial = nullptr;
+  bool generated = GenerateInvariant(loop, info->op_a, preheader, &stride) &&
+                   GenerateInvariant(loop, info->op_b, preheader, &initial);
+  DCHECK(generated);
+  // j = phi(b, j + a) computes a * i + b for the i-th iteration.
+  HPhi* new_phi = new (allocator) HPhi(allocator, kNoRegNumber, 0, info->type);
+  header->AddPhi(new_phi);
+  new_phi->AddInput(initial);
+  HAdd* increment = new (allocator) HAdd(info->type, new_phi, stride);
+  back_edge->InsertInstructionBefore(increment, back_edge->GetLastInstruction());
+  new_phi->AddInput(increment);
+  return new_phi;
 }
 
-static HConstant* GetNegativeConstant(HGraph* graph, DataType::Type type, HConstant* input) {
-  HConstant* cst = nullptr;
-  if (DataType::IsIntegralType(type)) {
-        int64_t val = Int64FromConstant(input);
-        cst = GetConstant(graph, type, -1*val);
-  } else if (type ==DataType::Type::kFloat32){
-    float val = input->AsFloatConstant()->GetValue();
-    cst = GetConstant(graph, type, -1.0f*val);
-  } else if (type == DataType::Type::kFloat64){
-     double val = input->AsDoubleConstant()->GetValue();
-     cst = GetConstant(graph, type, -1.0f*val);
+bool InductionVarSimplification::IsCandidateForReduction(
+    HLoopInformation* loop,
+    HInstruction* to_check,
+    const std::set<HInstruction*>& candidates) {
+  DataType::Type type = to_check->GetType();
+  if (type != DataType::Type::kInt32 && type != DataType::Type::kInt64) {
+    return false;
   }
-  return cst;
+  if (to_check->IsAdd() || to_check->IsSub()) {
+    // An addition is only worth reducing when it is built on top of a multiplication.
+    if (candidates.find(to_check->InputAt(0)) == candidates.end() &&
+        candidates.find(to_check->InputAt(1)) == candidates.end()) {
+      return false;
+    }
+  } else if (!to_check->IsMul() && !to_check->IsShl()) {
+    return false;
+  }
+  HInductionVarAnalysis::InductionInfo* info = induction_analysis_->LookupInfo(loop, to_check);
+  if (info == nullptr ||
+      info->induction_class != HInductionVarAnalysis::kLinear ||
+      info->type != type) {
+    return false;
+  }
+  return GenerateInvariant(loop, info->op_a, nullptr, nullptr) &&
+         GenerateInvariant(loop, info->op_b, nullptr, nullptr);
 }
 
-HInstruction* GetOutOfLoopInput(HLoopInformation* loop, HPhi* phi) {
- HInputsRef inputs = phi->GetInputs();
- for (size_t i = 0; i < inputs.size(); ++i) {
-   HInstruction* input = inputs[i];
-   if (input->GetBlock()->GetLoopInformation() != loop) {
-    return input;
-   }
- }
- return nullptr;
+bool InductionVarSimplification::NeedsInduction(HLoopInformation* loop,
+                                                HInstruction* instruction,
+                                                const std::set<HInstruction*>& candidates) {
+  for (const HUseListNode<HInstruction*>& use : instruction->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (loop->Contains(*user->GetBlock()) &&
+        !IsLoopHeaderPhi(loop, user) &&
+        candidates.find(user) == candidates.end()) {
+      return true;
+    }
+  }
+  for (const HUseListNode<HEnvironment*>& use : instruction->GetEnvUses()) {
+    if (loop->Contains(*use.GetUser()->GetHolder()->GetBlock())) {
+      return true;
+    }
+  }
+  return false;
 }
 
-bool InductionVarSimplification::IsCandidatePhi(HLoopInformation* loop, HPhi* phi) {
-  HInputsRef inputs = phi->GetInputs();
-  if (inputs.size() != 2 )
+bool InductionVarSimplification::SimplifyLoop(HLoopInformation* loop) {
+  if (loop->GetPreHeader() == nullptr ||
+      loop->NumberOfBackEdges() != 1 ||
+      loop->IsIrreducible()) {
     return false;
-  HInstruction* control = loop->GetHeader()->GetLastInstruction();
-  HInductionVarAnalysis::InductionInfo* phi_info = induction_analysis_->LookupInfo(loop, phi);
-  if (control->IsIf()) {
-    HIf* ifs = control->AsIf();
-    HInstruction* if_expr = ifs->InputAt(0);
-    // Determine if loop has following structure in header.
-    // loop-header: ....
-    //              if (condition) goto X
-    if (if_expr->IsCondition()) {
-      HCondition* condition = if_expr->AsCondition();
-      HInductionVarAnalysis::InductionInfo* a = induction_analysis_->LookupInfo(loop, condition->InputAt(0));
-      HInductionVarAnalysis::InductionInfo* b = induction_analysis_->LookupInfo(loop, condition->InputAt(1));
-      if (HInductionVarAnalysis::InductionEqual(a,phi_info) || HInductionVarAnalysis::InductionEqual(b, phi_info)) {
-       // check if it is incremented by a constant amount 
-       ArenaSet<HInstruction*>* set = induction_analysis_->LookupCycle(phi);
-       for (HInstruction* ins : *set) {
-          if (ins->IsAdd()) { 
-            HBinaryOperation* op = ins->AsAdd();
-            HConstant* cst = op->GetConstantRight();
-            if (cst != nullptr) {
-               biv_increment_=op;
-              return true;
-            }
-        }
-      }
+  }
+
+  // Collect candidates in reverse post order, so that operands are seen before their users.
+  std::set<HInstruction*> candidates;
+  std::vector<HInstruction*> order;
+  for (HBlocksInLoopReversePostOrderIterator it(*loop); !it.Done(); it.Advance()) {
+    for (HInstructionIterator it1(it.Current()->GetInstructions()); !it1.Done(); it1.Advance()) {
+      HInstruction* to_check = it1.Current();
+      if (IsCandidateForReduction(loop, to_check, candidates)) {
+        candidates.insert(to_check);
+        order.push_back(to_check);
       }
     }
   }
-  return false;
-}
 
-void InductionVarSimplification::PerformReduction(HLoopInformation* loop, HInstruction* derived_var,
-                  std::tuple<HInstruction*, HConstant*, HConstant*> val) {
-    DCHECK(biv_increment_ != nullptr);
-    HInstruction* var = std::get<0>(val);
-    HPhi* phi = var->AsPhi();
-    DCHECK(phi != nullptr);
-    HInstruction* input = GetOutOfLoopInput(loop, phi);
-    // Create two new instructions mul and add
-    ArenaAllocator* allocator = derived_var->GetBlock()->GetGraph()->GetAllocator();
-    HInstruction* new_mul =  new (allocator) HMul(derived_var->GetType(), input, std::get<1>(val), derived_var->GetDexPc());
-    loop->GetPreHeader()->InsertInstructionBefore(new_mul, loop->GetPreHeader()->GetLastInstruction());
-    HInstruction* new_add = new (allocator) HAdd(new_mul->GetType(), new_mul,std::get<2>(val), derived_var->GetDexPc());
-    loop->GetPreHeader()->InsertInstructionBefore(new_add, loop->GetPreHeader()->GetLastInstruction());
-    HPhi* new_phi = new (allocator) HPhi(allocator, kNoRegNumber, 0, phi->GetType());
-    phi->GetBlock()->InsertPhiAfter(new_phi, phi);
-    new_phi->AddInput(new_add);
-    HConstant* biv_inc_cst = biv_increment_->GetConstantRight();
-    HConstant* biv_cst = GetNewConstant(HInstruction::InstructionKind::kMul, biv_inc_cst, std::get<1>(val));
-    DCHECK(biv_cst != nullptr);
-    HAdd* biv_add = new (allocator) HAdd(biv_inc_cst->GetType(), new_phi, biv_cst);
-    biv_increment_->GetBlock()->InsertInstructionAfter(biv_add, biv_increment_);
-    new_phi->AddInput(biv_add);
-    // Replace uses of new add within the loop with new_phi
+  // Replace the uses in the loop with new induction variables. Candidates with an
+  // equal induction share the same phi. Uses after the loop still see the original.
+  std::vector<std::pair<HInductionVarAnalysis::InductionInfo*, HPhi*>> inductions;
+  for (HInstruction* derived_var : order) {
+    if (!NeedsInduction(loop, derived_var, candidates)) {
+      continue;
+    }
+    HInductionVarAnalysis::InductionInfo* info = induction_analysis_->LookupInfo(loop, derived_var);
+    HPhi* new_phi = nullptr;
+    for (const std::pair<HInductionVarAnalysis::InductionInfo*, HPhi*>& induction : inductions) {
+      if (HInductionVarAnalysis::InductionEqual(induction.first, info)) {
+        new_phi = induction.second;
+        break;
+      }
+    }
+    if (new_phi == nullptr) {
+      new_phi = PerformReduction(loop, info);
+      inductions.push_back(std::make_pair(info, new_phi));
+    }
     const HUseList<HInstruction*>& uses = derived_var->GetUses();
     for (auto it = uses.begin(), end = uses.end(); it != end;) {
       HInstruction* user = it->GetUser();
       size_t input_index = it->GetIndex();
-      ++it;
-      user->ReplaceInput(new_phi, input_index);
+      ++it;  // increment prior to potential removal
+      if (loop->Contains(*user->GetBlock()) &&
+          !IsLoopHeaderPhi(loop, user) &&
+          candidates.find(user) == candidates.end()) {
+        user->ReplaceInput(new_phi, input_index);
+      }
     }
     const HUseList<HEnvironment*>& env_uses = derived_var->GetEnvUses();
     for (auto it = env_uses.begin(), end = env_uses.end(); it != end;) {
       HEnvironment* user = it->GetUser();
       size_t index = it->GetIndex();
       ++it;  // increment prior to potential removal
-      user->RemoveAsUserOfInput(index);
-      user->SetRawEnvAt(index, new_phi);
-      new_phi->AddEnvUseAt(user, index);
-    } 
-    DCHECK(!derived_var->HasUses());
-}
-
-bool InductionVarSimplification::IsCandidateForReduction (
-       HLoopInformation* loop, HPhi* biv, HBinaryOperation* to_check,
-       std::map<HBinaryOperation*, triple>* candidate) {
-
-  HInductionVarAnalysis::InductionInfo* ind_info = induction_analysis_->LookupInfo(loop, to_check);
-  HInductionVarAnalysis::InductionInfo* biv_ind_info = induction_analysis_->LookupInfo(loop, biv);
-  if (ind_info == nullptr)
-    return false;
-  // TODO: Handle Add and Shl is pending
-  DataType::Type type = to_check->GetType();
-  HGraph* graph = to_check->GetBlock()->GetGraph();
-  if (to_check->IsMul()) {
-    HConstant* cst = to_check->GetConstantRight();
-    if (cst == nullptr)
-      return false;
-    HInstruction* left_ins = to_check->InputAt(0);
-    HInstruction* right_ins = to_check->InputAt(1);
-    HInductionVarAnalysis::InductionInfo* left_ins_info = induction_analysis_->LookupInfo(loop, left_ins);
-    HInductionVarAnalysis::InductionInfo* right_ins_info = induction_analysis_->LookupInfo(loop, right_ins);
-    if (HInductionVarAnalysis::InductionEqual(biv_ind_info, left_ins_info)){
-      if (right_ins_info->induction_class == HInductionVarAnalysis::kInvariant) {
-        HConstant * zero = GetConstant(graph, type, 0);
-        candidate->insert(std::pair<HBinaryOperation*, triple>(to_check, std::make_tuple(biv, cst, zero)));
-        return true;
-      }
-    }
-    if (HInductionVarAnalysis::InductionEqual(biv_ind_info, right_ins_info) &&
-        left_ins_info->induction_class == HInductionVarAnalysis::kInvariant) {
-      HConstant* zero = GetConstant(graph, type, 0);
-      candidate->insert(std::pair<HBinaryOperation*, triple>(to_check, std::make_tuple(biv, cst, zero)));
-      return true;
-    }
-  } else if (to_check ->IsAdd() || to_check->IsSub()) {
-    HInstruction* left = to_check->InputAt(0);
-    HInstruction* right = to_check->InputAt(1);
-    HConstant* cst = to_check->GetConstantRight();
-    if (cst == nullptr)
-     return false;
-    if (to_check->IsSub()) {
-     cst = GetNegativeConstant(graph, type, cst);
-    }
-    HInductionVarAnalysis::InductionInfo* left_ins_info = induction_analysis_->LookupInfo(loop,left);
-    HInductionVarAnalysis::InductionInfo* right_ins_info = induction_analysis_->LookupInfo(loop, right);
-    // check for a derived  induction variable
-    if (!HInductionVarAnalysis::InductionEqual(left_ins_info, biv_ind_info) &&
-        !HInductionVarAnalysis::InductionEqual(right_ins_info, biv_ind_info)) {
-      bool found = false;
-      for (auto it : *candidate) {
-        HInductionVarAnalysis::InductionInfo* info = induction_analysis_->LookupInfo(loop, it.first);
-        if (HInductionVarAnalysis::InductionEqual(left_ins_info, info) &&
-            right_ins_info->induction_class == HInductionVarAnalysis::kInvariant) {
-          HConstant * one = GetConstant(graph, type, 1);
-          candidate->insert(std::pair<HBinaryOperation*, triple>(to_check, std::make_tuple( it.first,one, cst)));
-          found = true;
-          break;
-        } else if (HInductionVarAnalysis::InductionEqual(right_ins_info, info)
-                   && left_ins_info->induction_class == HInductionVarAnalysis::kInvariant) {
-          HConstant* one = GetConstant(graph, type, 1);
-          candidate->insert(std::pair<HBinaryOperation*, triple>(to_check, std::make_tuple(it.first, one, cst)));
-          found = true;
-          break;
-        }
+      if (loop->Contains(*user->GetHolder()->GetBlock())) {
+        user->RemoveAsUserOfInput(index);
+        user->SetRawEnvAt(index, new_phi);
+        new_phi->AddEnvUseAt(user, index);
       }
-      if (found == true)
-        return true;
     }
   }
-  return false;
-}
 
-bool InductionVarSimplification::SimplifyLoop(HLoopInformation* loop) {
-  bool did_reduction = false;
-  HBasicBlock* header = loop->GetHeader();
-  /*HGraph* gr = header->GetGraph();
-  std::string cur_name = gr->GetDexFile().PrettyMethod(gr->GetMethodIdx());
-  std::cout << "method="<< cur_name <<std::endl;*/
-  std::map<HBinaryOperation*, std::tuple< HInstruction*,HConstant*, HConstant*>> candidate;
-  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
-    HInstruction* cur = it.Current();
-    HPhi* phi = cur->AsPhi();
-    if (IsCandidatePhi(loop, phi)) {
-      for (HBlocksInLoopIterator it1(*loop); !it1.Done(); it1.Advance()) {
-        HBasicBlock* block = it1.Current();
-        for (HInstructionIterator it2(block->GetInstructions()); !it2.Done(); it2.Advance()) {
-          HInstruction* to_check = it2.Current();
-          if (to_check->IsBinaryOperation())
-           IsCandidateForReduction(loop, phi, to_check->AsBinaryOperation(), &candidate);
-        }
-      }
-    for (auto itr = candidate.cbegin(); itr != candidate.cend(); itr++) {
-      HBinaryOperation* derived_var = itr->first;
-      HInstruction::InstructionKind kind = derived_var->GetKind();
-      triple val = itr->second;
-      HInstruction* var = std::get<0>(val);
-      if (var->GetId() != phi->GetId()) {
-        HBinaryOperation* var_bin = var->AsBinaryOperation();
-       if (derived_var->IsAdd() || derived_var->IsSub()) {
-         DCHECK(var->IsBinaryOperation());
-         HConstant* new_cst = GetNewConstant(kind, std::get<2>(val), std::get<2>(candidate[var_bin]));
-         DCHECK(new_cst != nullptr);
-         std::get<0>(val) = std::get<0>(candidate[var_bin]);
-         std::get<1>(val) = std::get<1>(candidate[var_bin]);
-         std::get<2>(val) = new_cst;
-         candidate[derived_var] = val;
-       } else if(derived_var->IsMul()) {
-         HConstant* new_cst1 = GetNewConstant(kind, std::get<2>(val), std::get<1>(candidate[var_bin]));
-         HConstant* new_cst2 = GetNewConstant(kind, std::get<2>(val), std::get<2>(candidate[var_bin]));
-         DCHECK(new_cst1 != nullptr);
-         DCHECK(new_cst2 != nullptr);
-         std::get<0>(val) = std::get<0>(candidate[var_bin]);
-         std::get<1>(val) = new_cst1;
-         std::get<2>(val) = new_cst2;
-         candidate[derived_var] = val;
-        }
+  // Remove the candidates that became dead, users first.
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    HInstruction* derived_var = *it;
+    if (!derived_var->HasUses()) {
+      derived_var->GetBlock()->RemoveInstruction(derived_var);
     }
   }
-  // Perform strength Reduction
-  for (auto cur1 = candidate.begin(); cur1 != candidate.end(); cur1++ ) {
-    PerformReduction(loop, cur1->first, cur1->second);
-  }
-  
- }
- // clear the candidate map now
- if (!did_reduction && !candidate.empty()) {
- did_reduction = true;
- candidate.clear();
- }
-}
-  return did_reduction;
+  return !inductions.empty();
 }
 
-} // namespace art
+}  // namespace art
@@ -1,59 +1,83 @@
 /*
  * Copyright (C) 2018 The Android Open Source Project
- * Header file for tail recursion elimination compiler optimization
+ * Header file for induction variable simplification compiler optimization
  */
 
 #ifndef ART_COMPILER_OPTIMIZING_INDUCTION_VAR_SIMPLIFICATION_H_
 #define ART_COMPILER_OPTIMIZING_INDUCTION_VAR_SIMPLIFICATION_H_
 
+#include <set>
+#include <vector>
+
 #include "nodes.h"
 #include "induction_var_analysis.h"
-#include <tuple>
 
 namespace art {
 
+/**
+ * Strength reduction of derived induction variables. Every multiplication (or shift) in an
+ * inner loop that the induction analysis classifies as a linear induction a * i + b, with
+ * loop-invariant a and b, is replaced by a new loop phi that starts at b and is incremented
+ * by a on every iteration. Additions and subtractions built on top of a reduced value are
+ * folded into the same phi, and candidates with equal induction share one phi.
+ */
 class InductionVarSimplification {
  public:
   explicit  InductionVarSimplification(HInductionVarAnalysis* analysis);
-  
+
   /**
    * @brief Performs Simplification on the loop
    * @param loop The input loop in the graph.
    */
   bool SimplifyLoop(HLoopInformation* loop);
+
+ private:
   /**
-   * @brief Checks if the phi is a basic induction variable
-   *        the loop
-   * @param loop The loop to be checked.
-   * @param phi The phi to be checked.
+   * @brief Checks if an instruction is a derived induction variable suitable for
+   *        strength reduction
+   * @param loop The loop to be simplified.
+   * @param to_check The instruction in the loop to be checked
+   * @param candidates Candidates found so far, an addition or subtraction is only
+   *        a candidate when built on top of another candidate
    */
-  bool IsCandidatePhi(HLoopInformation* loop, HPhi* phi);
- private:
+  bool IsCandidateForReduction(HLoopInformation* loop,
+                               HInstruction* to_check,
+                               const std::set<HInstruction*>& candidates);
+
   /**
-   * @brief Performs Strength Reduction to eliminate multplication and
-   *        replace with equivalent addition
+   * @brief Checks if a candidate has a use in the loop that is not another candidate,
+   *        i.e. if its value has to be provided by a new induction variable
    * @param loop The loop to be simplified.
-   * @param derived_var The derived induction variable upon which
-   *        simplification is applied
-   * @param candidate The mapping of derived induction variables.
+   * @param instruction The candidate to be checked.
+   * @param candidates All candidates of the loop.
    */
-  void PerformReduction(HLoopInformation* loop, HInstruction* derived_var,   
-                  std::tuple<HInstruction*, HConstant*, HConstant*> val);
-   /**
-   * @brief Checks if an instruction is suitable candidate to perform
-   *         strength reducion 
+  bool NeedsInduction(HLoopInformation* loop,
+                      HInstruction* instruction,
+                      const std::set<HInstruction*>& candidates);
+
+  /**
+   * @brief Generates code for a loop-invariant induction in the given block, or only
+   *        checks that code can be generated when the block is null
    * @param loop The loop to be simplified.
-   * @param to_check The instruction in the loop to be checked
-   * @param candidate A mapping from biv to corresponding 
-   *        derived induction variables
-   *        Stores an induction of the form j = a*i +b where i is biv,
-   *        as an entry [j, <i, a, b>]
+   * @param info The loop-invariant induction.
+   * @param block The block to generate code in (normally the loop pre-header), or null.
+   * @param result The generated instruction (only when block is not null).
+   */
+  bool GenerateInvariant(HLoopInformation* loop,
+                         HInductionVarAnalysis::InductionInfo* info,
+                         HBasicBlock* block,
+                         /*out*/ HInstruction** result);
+
+  /**
+   * @brief Performs Strength Reduction to eliminate multplication and
+   *        replace with equivalent addition
+   * @param loop The loop to be simplified.
+   * @param info The linear induction a * i + b to be computed by the new phi.
+   * @return The new phi.
    */
-  bool IsCandidateForReduction(HLoopInformation* loop, HPhi* biv, HBinaryOperation* to_check,
-                                std::map<HBinaryOperation*, std::tuple<HInstruction*,HConstant*, HConstant*>>* candidate);
+  HPhi* PerformReduction(HLoopInformation* loop, HInductionVarAnalysis::InductionInfo* info);
 
   HInductionVarAnalysis* induction_analysis_;
-  HBinaryOperation* biv_increment_;
   /* Results of induction var analysis */
   friend class HInductionVarAnalysis;
 
@@ -16,6 +16,8 @@
 
 #include "linear_order.h"
 
+#include "base/arena_bit_vector.h"
+#include "base/bit_vector-inl.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 
@@ -54,6 +56,60 @@ static void AddToListForLinearization(ScopedArenaVector<HBasicBlock*>* worklist,
   worklist->insert(insert_pos.base(), block);
 }
 
+// Helper method to move the blocks from which all paths end with a throw, and the exit
+// block, after the other blocks of the linear order. We do not profile branches, so like
+// code sinking we use throws as an indicator of uncommon code, which this keeps out of the
+// instruction cache lines of the common paths.
+//
+// Successors of uncommon blocks are uncommon blocks or the exit block, which keeps the
+// order a reverse post order. Loop blocks are never uncommon, as their back edges are
+// visited before the loop headers, so loops stay contiguous.
+static void MoveUncommonBlocksLast(const HGraph* graph,
+                                   ScopedArenaAllocator* allocator,
+                                   ArrayRef<HBasicBlock*> linear_order) {
+  if (graph->HasTryCatch() || graph->HasIrreducibleLoops()) {
+    return;
+  }
+  ArenaBitVector uncommon_blocks(
+      allocator, graph->GetBlocks().size(), /* expandable */ false, kArenaAllocLinearOrder);
+  bool has_uncommon_blocks = false;
+  for (HBasicBlock* block : graph->GetPostOrder()) {
+    if (block->IsExitBlock()) {
+      continue;
+    }
+    bool is_uncommon = block->GetLastInstruction()->IsThrow() ||
+        std::all_of(block->GetSuccessors().begin(),
+                    block->GetSuccessors().end(),
+                    [&](HBasicBlock* successor) {
+                      return uncommon_blocks.IsBitSet(successor->GetBlockId());
+                    });
+    if (is_uncommon) {
+      uncommon_blocks.SetBit(block->GetBlockId());
+      has_uncommon_blocks = true;
+    }
+  }
+  if (!has_uncommon_blocks || uncommon_blocks.IsBitSet(graph->GetEntryBlock()->GetBlockId())) {
+    return;
+  }
+  ScopedArenaVector<HBasicBlock*> uncommon_order(allocator->Adapter(kArenaAllocLinearOrder));
+  HBasicBlock* exit_block = nullptr;
+  size_t num_common = 0u;
+  for (HBasicBlock* block : linear_order) {
+    if (block->IsExitBlock()) {
+      exit_block = block;
+    } else if (uncommon_blocks.IsBitSet(block->GetBlockId())) {
+      uncommon_order.push_back(block);
+    } else {
+      linear_order[num_common] = block;
+      ++num_common;
+    }
+  }
+  std::copy(uncommon_order.begin(), uncommon_order.end(), linear_order.begin() + num_common);
+  if (exit_block != nullptr) {
+    linear_order[linear_order.size() - 1u] = exit_block;
+  }
+}
+
 // Helper method to validate linear order.
 static bool IsLinearOrderWellFormed(const HGraph* graph, ArrayRef<HBasicBlock*> linear_order) {
   for (HBasicBlock* header : graph->GetBlocks()) {
@@ -87,7 +143,8 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   DCHECK_EQ(linear_order.size(), graph->GetReversePostOrder().size());
   // Create a reverse post ordering with the following properties:
   // - Blocks in a loop are consecutive,
-  // - Back-edge is the last block before loop exits.
+  // - Back-edge is the last block before loop exits,
+  // - Blocks only leading to a throw come last.
   //
   // (1): Record the number of forward predecessors for each block. This is to
   //      ensure the resulting order is reverse post order. We could use the
@@ -127,6 +184,9 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   } while (!worklist.empty());
   DCHECK_EQ(num_added, linear_order.size());
 
+  // (3): Move the uncommon blocks after the others.
+  MoveUncommonBlocksLast(graph, &allocator, linear_order);
+
   DCHECK(graph->HasIrreducibleLoops() || IsLinearOrderWellFormed(graph, linear_order));
 }
 
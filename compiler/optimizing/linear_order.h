@@ -27,7 +27,8 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
 
 // Linearizes the 'graph' such that:
 // (1): a block is always after its dominator,
-// (2): blocks of loops are contiguous.
+// (2): blocks of loops are contiguous,
+// (3): blocks from which all paths throw are after the other blocks.
 //
 // Storage is obtained through 'allocator' and the linear order it computed
 // into 'linear_order'. Once computed, iteration can be expressed as:
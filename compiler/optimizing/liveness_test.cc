@@ -57,15 +57,22 @@ void LivenessTest::TestCode(const std::vector<uint16_t>& data, const char* expec
   liveness.Analyze();
 
   std::ostringstream buffer;
+  size_t ssa_values = liveness.GetNumberOfSsaValues();
+  ArenaBitVector live_out(GetAllocator(), ssa_values, false);
+  ArenaBitVector kill(GetAllocator(), ssa_values, false);
   for (HBasicBlock* block : graph->GetBlocks()) {
     buffer << "Block " << block->GetBlockId() << std::endl;
-    size_t ssa_values = liveness.GetNumberOfSsaValues();
     BitVector* live_in = liveness.GetLiveInSet(*block);
     DumpBitVector(live_in, buffer, ssa_values, "  live in: ");
-    BitVector* live_out = liveness.GetLiveOutSet(*block);
-    DumpBitVector(live_out, buffer, ssa_values, "  live out: ");
-    BitVector* kill = liveness.GetKillSet(*block);
-    DumpBitVector(kill, buffer, ssa_values, "  kill: ");
+    liveness.ComputeLiveOutSet(*block, &live_out);
+    DumpBitVector(&live_out, buffer, ssa_values, "  live out: ");
+    kill.ClearAllBits();
+    for (size_t i = 0; i < ssa_values; ++i) {
+      if (liveness.IsInKillSet(*block, i)) {
+        kill.SetBit(i);
+      }
+    }
+    DumpBitVector(&kill, buffer, ssa_values, "  kill: ");
   }
   ASSERT_STREQ(expected, buffer.str().c_str());
 }
@@ -16,6 +16,10 @@
 
 #include "loop_analysis.h"
 
+#include <algorithm>
+
+#include "arch/x86/instruction_set_features_x86.h"
+#include "base/bit_utils.h"
 #include "base/bit_vector-inl.h"
 #include "induction_var_range.h"
 #include <iostream>
@@ -71,4 +75,148 @@ int64_t LoopAnalysis::GetLoopTripCount(HLoopInformation* loop_info,
   }
   return trip_count;
 }
+
+// Default maximum number of instructions of a fully unrolled loop (the loop-body size times
+// the number of iterations).
+static constexpr size_t kFullUnrollingMaxInstructions = 60;
+// Default maximum size of a loop peeled to eliminate its loop-invariant exits.
+static constexpr size_t kScalarPeelingMaxBodySizeInstructions = 17;
+static constexpr size_t kScalarPeelingMaxBodySizeBlocks = 6;
+
+bool ArchLoopHelper::IsLoopTooBigForFullUnrolling(LoopAnalysisInfo* loop_analysis_info) const {
+  return loop_analysis_info->GetNumberOfInstructions() * loop_analysis_info->GetTripCount() >
+      kFullUnrollingMaxInstructions;
+}
+
+bool ArchLoopHelper::IsLoopTooBigForPeeling(LoopAnalysisInfo* loop_analysis_info) const {
+  return loop_analysis_info->GetNumberOfInstructions() > kScalarPeelingMaxBodySizeInstructions ||
+      loop_analysis_info->GetNumberOfBasicBlocks() > kScalarPeelingMaxBodySizeBlocks;
+}
+
+// Custom implementation of loop helper for arm64 target.
+class Arm64LoopHelper : public ArchLoopHelper {
+ public:
+  uint32_t GetSIMDUnrollingFactor(HBasicBlock* block,
+                                  int64_t trip_count,
+                                  uint32_t max_peel,
+                                  uint32_t vector_length) const OVERRIDE {
+    // Don't unroll with insufficient iterations.
+    // TODO: Unroll loops with unknown trip count.
+    DCHECK_NE(vector_length, 0u);
+    if (trip_count < (2 * vector_length + max_peel)) {
+      return LoopAnalysisInfo::kNoUnrollingFactor;
+    }
+    // Don't unroll for large loop body size.
+    uint32_t instruction_count = block->GetInstructions().CountSize();
+    if (instruction_count >= kArm64SimdHeuristicMaxBodySizeInstr) {
+      return LoopAnalysisInfo::kNoUnrollingFactor;
+    }
+    // Find a beneficial unroll factor with the following restrictions:
+    //  - At least one iteration of the transformed loop should be executed.
+    //  - The loop body shouldn't be "too big" (heuristic).
+    uint32_t uf1 = kArm64SimdHeuristicMaxBodySizeInstr / instruction_count;
+    uint32_t uf2 = (trip_count - max_peel) / vector_length;
+    uint32_t unroll_factor =
+        TruncToPowerOfTwo(std::min({uf1, uf2, kArm64SimdMaxUnrollFactor}));
+    DCHECK_GE(unroll_factor, 1u);
+    return unroll_factor;
+  }
+
+ private:
+  static constexpr uint32_t kArm64SimdMaxUnrollFactor = 8;
+  static constexpr uint32_t kArm64SimdHeuristicMaxBodySizeInstr = 50;
+};
+
+// Front-end properties of a class of x86 cores, which bound the size of the loops worth
+// unrolling: a loop that no longer fits the loop stream detector (or the decoded uop cache
+// of the big cores) is fetched and decoded again on every iteration. The sizes are in HIR
+// instructions, which are roughly one and a half uops each on average.
+struct X86LoopProfile {
+  // Maximum size of a loop-body that is still streamed from the loop buffer.
+  size_t max_loop_body_instructions;
+  // Maximum size of the straight-line code replacing a fully unrolled loop.
+  size_t max_full_unrolling_instructions;
+  // Maximum unrolling factor of a vector loop.
+  uint32_t max_simd_unrolling_factor;
+};
+
+// Silvermont and Goldmont: a 28 uop loop buffer, no decoded uop cache, and the narrower
+// out-of-order window does not gain much from more independent iterations.
+static constexpr X86LoopProfile kX86SilvermontProfile = { 18u, 40u, 2u };
+// Skylake and later big cores: a 64 uop loop stream detector behind a 1.5K uop cache.
+static constexpr X86LoopProfile kX86SkylakeProfile = { 40u, 120u, 4u };
+
+// Custom implementation of loop helper for x86 and x86-64 targets.
+class X86LoopHelper : public ArchLoopHelper {
+ public:
+  X86LoopHelper(const X86LoopProfile& profile, bool is_64bit)
+      : profile_(profile), is_64bit_(is_64bit) {}
+
+  bool IsLoopTooBigForFullUnrolling(LoopAnalysisInfo* loop_analysis_info) const OVERRIDE {
+    return loop_analysis_info->GetNumberOfInstructions() * loop_analysis_info->GetTripCount() >
+        GetMaxFullUnrollingInstructions(loop_analysis_info);
+  }
+
+  bool IsLoopTooBigForPeeling(LoopAnalysisInfo* loop_analysis_info) const OVERRIDE {
+    // Peeling does not grow the loop, but the loop should still fit the loop buffer
+    // for the peeled copy to be worth its code size.
+    return loop_analysis_info->GetNumberOfInstructions() > profile_.max_loop_body_instructions ||
+        loop_analysis_info->GetNumberOfBasicBlocks() > kScalarPeelingMaxBodySizeBlocks;
+  }
+
+  uint32_t GetSIMDUnrollingFactor(HBasicBlock* block,
+                                  int64_t trip_count,
+                                  uint32_t max_peel,
+                                  uint32_t vector_length) const OVERRIDE {
+    // Don't unroll with insufficient iterations.
+    DCHECK_NE(vector_length, 0u);
+    if (trip_count < (2 * vector_length + max_peel)) {
+      return LoopAnalysisInfo::kNoUnrollingFactor;
+    }
+    // Don't unroll loops that would no longer be streamed from the loop buffer.
+    uint32_t instruction_count = block->GetInstructions().CountSize();
+    if (2 * instruction_count > profile_.max_loop_body_instructions) {
+      return LoopAnalysisInfo::kNoUnrollingFactor;
+    }
+    uint32_t uf1 = profile_.max_loop_body_instructions / instruction_count;
+    uint32_t uf2 = (trip_count - max_peel) / vector_length;
+    uint32_t unroll_factor =
+        TruncToPowerOfTwo(std::min({uf1, uf2, profile_.max_simd_unrolling_factor}));
+    DCHECK_GE(unroll_factor, 1u);
+    return unroll_factor;
+  }
+
+ private:
+  size_t GetMaxFullUnrollingInstructions(LoopAnalysisInfo* loop_analysis_info) const {
+    // On 32-bit x86 each long value takes a pair of the few core registers, so the
+    // unrolled code is likely to be spilled.
+    return (!is_64bit_ && loop_analysis_info->HasLongTypeInstructions())
+        ? profile_.max_full_unrolling_instructions / 2
+        : profile_.max_full_unrolling_instructions;
+  }
+
+  const X86LoopProfile& profile_;
+  const bool is_64bit_;
+};
+
+ArchLoopHelper* ArchLoopHelper::Create(InstructionSet isa,
+                                       const InstructionSetFeatures* features,
+                                       ArenaAllocator* allocator) {
+  if (features != nullptr) {
+    switch (isa) {
+      case InstructionSet::kArm64:
+        return new (allocator) Arm64LoopHelper();
+      case InstructionSet::kX86:
+      case InstructionSet::kX86_64:
+        return new (allocator) X86LoopHelper(
+            features->AsX86InstructionSetFeatures()->HasAVX2() ? kX86SkylakeProfile
+                                                               : kX86SilvermontProfile,
+            isa == InstructionSet::kX86_64);
+      default:
+        break;
+    }
+  }
+  return new (allocator) ArchLoopHelper();
+}
+
 }  // namespace art
@@ -17,11 +17,13 @@
 #ifndef ART_COMPILER_OPTIMIZING_LOOP_ANALYSIS_H_
 #define ART_COMPILER_OPTIMIZING_LOOP_ANALYSIS_H_
 
+#include "arch/instruction_set.h"
 #include "nodes.h"
 
 namespace art {
 
 class InductionVarRange;
+class InstructionSetFeatures;
 class LoopAnalysis;
 
 // Class to hold cached information on properties of the loop.
@@ -123,5 +125,43 @@ class LoopAnalysis : public ValueObject {
         instruction->IsInvoke());
   }
 };
-}
+
+//
+// Helper class which holds target-dependent methods and constants needed for loop optimizations.
+//
+// To support peeling/unrolling for a new architecture one needs to create new helper class,
+// inherit it from this and add implementation for the following methods.
+//
+class ArchLoopHelper : public ArenaObject<kArenaAllocOptimization> {
+ public:
+  virtual ~ArchLoopHelper() {}
+
+  // Creates an instance of specialised helper for the given target; the default helper,
+  // which preserves the target-independent heuristics, is used for a null `features`.
+  static ArchLoopHelper* Create(InstructionSet isa,
+                                const InstructionSetFeatures* features,
+                                ArenaAllocator* allocator);
+
+  // Returns whether the loop is too big for full unrolling, given the number of its
+  // iterations held in 'loop_analysis_info'.
+  virtual bool IsLoopTooBigForFullUnrolling(LoopAnalysisInfo* loop_analysis_info) const;
+
+  // Returns whether the loop is too big for the loop peeling.
+  virtual bool IsLoopTooBigForPeeling(LoopAnalysisInfo* loop_analysis_info) const;
+
+  // Returns optimal SIMD unrolling factor for the loop body `block`, with `max_peel`
+  // iterations peeled for alignment and the given vector length.
+  //
+  // Returns kNoUnrollingFactor by default, should be overridden by particular target loop
+  // helper.
+  virtual uint32_t GetSIMDUnrollingFactor(HBasicBlock* block ATTRIBUTE_UNUSED,
+                                          int64_t trip_count ATTRIBUTE_UNUSED,
+                                          uint32_t max_peel ATTRIBUTE_UNUSED,
+                                          uint32_t vector_length ATTRIBUTE_UNUSED) const {
+    return LoopAnalysisInfo::kNoUnrollingFactor;
+  }
+};
+
+}  // namespace art
+
 #endif  // ART_COMPILER_OPTIMIZING_LOOP_ANALYSIS_H_
@@ -0,0 +1,604 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "loop_nest_optimization.h"
+
+#include "arch/x86/instruction_set_features_x86.h"
+#include "base/scoped_arena_allocator.h"
+#include "base/stl_util.h"
+#include "driver/compiler_driver.h"
+#include "driver/compiler_options.h"
+
+namespace art {
+
+// Size of the cache lines of all supported targets.
+static constexpr size_t kCacheLineSize = 64;
+
+// Size of the level 1 data cache of the target core, which holds the cache lines of the
+// rows touched by the inner loop when it walks a column.
+static size_t GetL1DataCacheSize(const CompilerDriver* compiler_driver) {
+  switch (compiler_driver->GetInstructionSet()) {
+    case InstructionSet::kX86:
+    case InstructionSet::kX86_64:
+      // The Silvermont and Goldmont cores have a 24KB data cache, the big cores 32KB.
+      return compiler_driver->GetInstructionSetFeatures()->AsX86InstructionSetFeatures()->HasAVX2()
+          ? 32 * KB
+          : 24 * KB;
+    default:
+      return 32 * KB;
+  }
+}
+
+// Insert an instruction before the last instruction of the block.
+static HInstruction* Insert(HBasicBlock* block, HInstruction* instruction) {
+  block->InsertInstructionBefore(instruction, block->GetLastInstruction());
+  return instruction;
+}
+
+// Returns whether the instruction has regular or environment uses outside the loop.
+static bool HasUsesOutsideLoop(HInstruction* instruction, HLoopInformation* loop) {
+  for (const HUseListNode<HInstruction*>& use : instruction->GetUses()) {
+    if (!loop->Contains(*use.GetUser()->GetBlock())) {
+      return true;
+    }
+  }
+  for (const HUseListNode<HEnvironment*>& use : instruction->GetEnvUses()) {
+    if (!loop->Contains(*use.GetUser()->GetHolder()->GetBlock())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Replace the regular and environment uses of `instruction` outside the loop.
+static void ReplaceUsesOutsideLoop(HInstruction* instruction,
+                                   HInstruction* replacement,
+                                   HLoopInformation* loop) {
+  const HUseList<HInstruction*>& uses = instruction->GetUses();
+  for (auto it = uses.begin(), end = uses.end(); it != end;) {
+    HInstruction* user = it->GetUser();
+    size_t index = it->GetIndex();
+    ++it;  // increment before replacing
+    if (!loop->Contains(*user->GetBlock())) {
+      user->ReplaceInput(replacement, index);
+    }
+  }
+  const HUseList<HEnvironment*>& env_uses = instruction->GetEnvUses();
+  for (auto it = env_uses.begin(), end = env_uses.end(); it != end;) {
+    HEnvironment* user = it->GetUser();
+    size_t index = it->GetIndex();
+    ++it;  // increment before replacing
+    if (!loop->Contains(*user->GetHolder()->GetBlock())) {
+      user->RemoveAsUserOfInput(index);
+      user->SetRawEnvAt(index, replacement);
+      replacement->AddEnvUseAt(user, index);
+    }
+  }
+}
+
+// Exchange the regular and environment uses of `a` and `b` inside the loop, except
+// for the uses by the given loop control instructions.
+static void SwapUsesInLoop(HInstruction* a,
+                           HInstruction* b,
+                           HLoopInformation* loop,
+                           HInstruction* condition,
+                           HInstruction* increment) {
+  ScopedArenaAllocator allocator(a->GetBlock()->GetGraph()->GetArenaStack());
+  ScopedArenaVector<std::pair<HInstruction*, size_t>> uses(
+      allocator.Adapter(kArenaAllocLoopOptimization));
+  ScopedArenaVector<std::pair<HEnvironment*, size_t>> env_uses(
+      allocator.Adapter(kArenaAllocLoopOptimization));
+  // Collect all uses first, since replacing updates the use lists.
+  HInstruction* values[] = { a, b };
+  size_t num_uses[] = { 0u, 0u };
+  size_t num_env_uses[] = { 0u, 0u };
+  for (size_t k = 0; k < 2; ++k) {
+    for (const HUseListNode<HInstruction*>& use : values[k]->GetUses()) {
+      HInstruction* user = use.GetUser();
+      if (user != condition && user != increment && loop->Contains(*user->GetBlock())) {
+        uses.push_back(std::make_pair(user, use.GetIndex()));
+        ++num_uses[k];
+      }
+    }
+    for (const HUseListNode<HEnvironment*>& use : values[k]->GetEnvUses()) {
+      if (loop->Contains(*use.GetUser()->GetHolder()->GetBlock())) {
+        env_uses.push_back(std::make_pair(use.GetUser(), use.GetIndex()));
+        ++num_env_uses[k];
+      }
+    }
+  }
+  for (size_t i = 0; i < uses.size(); ++i) {
+    HInstruction* replacement = i < num_uses[0] ? b : a;
+    uses[i].first->ReplaceInput(replacement, uses[i].second);
+  }
+  for (size_t i = 0; i < env_uses.size(); ++i) {
+    HInstruction* replacement = i < num_env_uses[0] ? b : a;
+    HEnvironment* user = env_uses[i].first;
+    size_t index = env_uses[i].second;
+    user->RemoveAsUserOfInput(index);
+    user->SetRawEnvAt(index, replacement);
+    replacement->AddEnvUseAt(user, index);
+  }
+}
+
+HLoopNestOptimization::HLoopNestOptimization(HGraph* graph,
+                                             const CompilerDriver* compiler_driver,
+                                             HInductionVarAnalysis* induction_analysis,
+                                             OptimizingCompilerStats* stats,
+                                             const char* name)
+    : HOptimization(graph, name, stats),
+      compiler_driver_(compiler_driver),
+      induction_range_(induction_analysis) {
+}
+
+void HLoopNestOptimization::Run() {
+  // Skip if not enabled, if there is no loop, or if the graph has try-catch/irreducible
+  // loops. The values of the induction variables seen by a debugger would not match the
+  // source, and an osr method must not deoptimize.
+  if (compiler_driver_ == nullptr ||
+      !compiler_driver_->GetCompilerOptions().GetLoopNestOptimization() ||
+      !graph_->HasLoops() ||
+      graph_->HasTryCatch() ||
+      graph_->HasIrreducibleLoops() ||
+      graph_->IsDebuggable() ||
+      graph_->IsCompilingOsr()) {
+    return;
+  }
+  // Collect the loops first, since the transformation adds blocks.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HLoopInformation*> loops(allocator.Adapter(kArenaAllocLoopOptimization));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    if (block->IsLoopHeader()) {
+      loops.push_back(block->GetLoopInformation());
+    }
+  }
+  for (HLoopInformation* loop : loops) {
+    if (TryInterchange(loop)) {
+      MaybeRecordStat(stats_, MethodCompilationStat::kLoopInterchanged);
+    }
+  }
+}
+
+bool HLoopNestOptimization::MatchLoopControl(HLoopInformation* loop,
+                                             HLoopInformation* nest,
+                                             /*out*/ LoopControl* control) {
+  // The header consists of the suspend check, the condition, and the exit test.
+  HBasicBlock* header = loop->GetHeader();
+  HInstruction* suspend = header->GetFirstInstruction();
+  if (loop->IsIrreducible() ||
+      loop->NumberOfBackEdges() != 1 ||
+      suspend != loop->GetSuspendCheck() ||
+      !suspend->GetNext()->IsCondition() ||
+      !suspend->GetNext()->GetNext()->IsIf() ||
+      suspend->GetNext()->GetNext()->InputAt(0) != suspend->GetNext() ||
+      !suspend->GetNext()->HasOnlyOneNonEnvironmentUse()) {
+    return false;
+  }
+  HCondition* condition = suspend->GetNext()->AsCondition();
+  HIf* exit_if = condition->GetNext()->AsIf();
+  bool exit_on_true = !loop->Contains(*exit_if->IfTrueSuccessor());
+  control->body = exit_on_true ? exit_if->IfFalseSuccessor() : exit_if->IfTrueSuccessor();
+  control->exit = exit_on_true ? exit_if->IfTrueSuccessor() : exit_if->IfFalseSuccessor();
+  if (!loop->Contains(*control->body) || loop->Contains(*control->exit)) {
+    return false;
+  }
+  // Normalize to the condition that stays in the loop, either phi < hi or hi > phi.
+  IfCondition stay = exit_on_true ? condition->GetOppositeCondition() : condition->GetCondition();
+  size_t phi_index = 0u;
+  if (stay == kCondLT) {
+    phi_index = 0u;
+  } else if (stay == kCondGT) {
+    phi_index = 1u;
+  } else {
+    return false;
+  }
+  HInstruction* phi = condition->InputAt(phi_index);
+  if (!phi->IsPhi() ||
+      phi->GetBlock() != header ||
+      phi->GetType() != DataType::Type::kInt32 ||
+      phi->InputCount() != 2u) {
+    return false;
+  }
+  control->phi = phi->AsPhi();
+  control->lo = phi->InputAt(0);
+  control->hi = condition->InputAt(1u - phi_index);
+  control->condition = condition;
+  control->increment = phi->InputAt(1);
+  // Bounds must be defined before the nest, and the stride must be one.
+  HInstruction* increment = control->increment;
+  if (!nest->IsDefinedOutOfTheLoop(control->lo) ||
+      !nest->IsDefinedOutOfTheLoop(control->hi) ||
+      !increment->IsAdd() ||
+      increment->GetBlock() != loop->GetBackEdges()[0] ||
+      !increment->HasOnlyOneNonEnvironmentUse()) {
+    return false;
+  }
+  HInstruction* stride = increment->InputAt(0) == phi ? increment->InputAt(1)
+                                                      : increment->InputAt(0);
+  return (increment->InputAt(0) == phi || increment->InputAt(1) == phi) &&
+         stride->IsIntConstant() &&
+         stride->AsIntConstant()->GetValue() == 1;
+}
+
+bool HLoopNestOptimization::IsReduction(HPhi* phi, HPhi* outer_phi, HLoopInformation* outer) {
+  HInstruction* update = phi->InputAt(1);
+  if (!DataType::IsIntegralType(phi->GetType()) ||
+      phi->InputAt(0) != outer_phi ||
+      !(update->IsAdd() || update->IsSub() || update->IsAnd() || update->IsOr() ||
+        update->IsXor()) ||
+      update->GetType() != phi->GetType() ||
+      !update->HasOnlyOneNonEnvironmentUse()) {
+    return false;
+  }
+  // Integral add, and, or, and xor are associative and commutative, and so is subtracting
+  // from the accumulated value.
+  HInstruction* operand = nullptr;
+  if (update->InputAt(0) == phi) {
+    operand = update->InputAt(1);
+  } else if (update->InputAt(1) == phi && !update->IsSub()) {
+    operand = update->InputAt(0);
+  }
+  if (operand == nullptr || operand == phi) {
+    return false;
+  }
+  // The value must not be used in the nest before it is complete.
+  for (const HUseListNode<HInstruction*>& use : phi->GetUses()) {
+    if (use.GetUser() != update && use.GetUser() != outer_phi) {
+      return false;
+    }
+  }
+  for (const HUseListNode<HInstruction*>& use : outer_phi->GetUses()) {
+    if (use.GetUser() != phi && outer->Contains(*use.GetUser()->GetBlock())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool HLoopNestOptimization::ColumnFitsCache(HLoopInformation* inner) {
+  int64_t trip_count = 0;
+  return induction_range_.HasKnownTripCount(inner, &trip_count) &&
+         trip_count <= static_cast<int64_t>(GetL1DataCacheSize(compiler_driver_) / kCacheLineSize);
+}
+
+bool HLoopNestOptimization::TryInterchange(HLoopInformation* outer) {
+  LoopControl outer_control;
+  if (!MatchLoopControl(outer, outer, &outer_control)) {
+    return false;
+  }
+  // The outer loop body directly enters the inner loop through an empty preheader.
+  HBasicBlock* inner_preheader = outer_control.body;
+  if (!inner_preheader->GetPhis().IsEmpty() ||
+      !inner_preheader->GetFirstInstruction()->IsGoto() ||
+      !inner_preheader->GetSingleSuccessor()->IsLoopHeader()) {
+    return false;
+  }
+  HLoopInformation* inner = inner_preheader->GetSingleSuccessor()->GetLoopInformation();
+  LoopControl inner_control;
+  if (inner->GetPreHeader() != inner_preheader ||
+      !MatchLoopControl(inner, outer, &inner_control)) {
+    return false;
+  }
+  // The inner loop exits to the outer back edge, which only increments the outer induction,
+  // and its body is straight-line code.
+  HBasicBlock* outer_latch = outer->GetBackEdges()[0];
+  if (inner_control.exit != outer_latch ||
+      outer_latch->GetPredecessors().size() != 1u ||
+      !outer_latch->GetPhis().IsEmpty() ||
+      outer_latch->GetFirstInstruction() != outer_control.increment ||
+      !outer_control.increment->GetNext()->IsGoto() ||
+      outer->GetBlocks().NumSetBits() != inner->GetBlocks().NumSetBits() + 3u) {
+    return false;
+  }
+  // All other phis carry reductions around both loops.
+  HPhi* p = outer_control.phi;
+  HPhi* q = inner_control.phi;
+  size_t num_reductions = 0;
+  for (HInstructionIterator it(outer->GetHeader()->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* phi = it.Current()->AsPhi();
+    if (phi != p) {
+      HInstruction* inner_phi = phi->InputAt(1);
+      if (!inner_phi->IsPhi() ||
+          inner_phi->GetBlock() != inner->GetHeader() ||
+          !IsReduction(inner_phi->AsPhi(), phi, outer)) {
+        return false;
+      }
+      ++num_reductions;
+    }
+  }
+  size_t num_inner_phis = 0;
+  for (HInstructionIterator it(inner->GetHeader()->GetPhis()); !it.Done(); it.Advance()) {
+    ++num_inner_phis;
+  }
+  if (num_inner_phis != num_reductions + 1u) {
+    return false;
+  }
+  // Inspect the inner loop body. Only arithmetic and array accesses are allowed, where the
+  // elements of two-dimensional arrays are indexed by one of the inductions, and only the
+  // null and bounds checks on the rows of columns walks may remain.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HInstruction*> checks(allocator.Adapter(kArenaAllocLoopOptimization));
+  ScopedArenaVector<HInstruction*> bases(allocator.Adapter(kArenaAllocLoopOptimization));
+  // Per element size: accesses indexed by p, by q, by anything else, and stores.
+  size_t num_by_p[DataType::Size(DataType::Type::kInt64) + 1u] = {};
+  size_t num_by_q[DataType::Size(DataType::Type::kInt64) + 1u] = {};
+  size_t num_by_other[DataType::Size(DataType::Type::kInt64) + 1u] = {};
+  size_t num_stores[DataType::Size(DataType::Type::kInt64) + 1u] = {};
+  size_t num_columns = 0;
+  size_t num_rows = 0;
+  for (HBlocksInLoopIterator it_loop(*inner); !it_loop.Done(); it_loop.Advance()) {
+    HBasicBlock* block = it_loop.Current();
+    if (block == inner->GetHeader()) {
+      continue;
+    }
+    if (!block->GetPhis().IsEmpty() || !block->GetLastInstruction()->IsGoto()) {
+      return false;
+    }
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->IsGoto() || instruction->IsArrayLength()) {
+        continue;
+      } else if (instruction->IsNullCheck() || instruction->IsBoundsCheck()) {
+        checks.push_back(instruction);  // verified with the accesses below
+        continue;
+      } else if (!instruction->IsArrayGet() && !instruction->IsArraySet()) {
+        if ((instruction->IsBinaryOperation() ||
+             instruction->IsUnaryOperation() ||
+             instruction->IsTypeConversion() ||
+             instruction->IsSelect()) &&
+            !instruction->CanThrow() &&
+            !instruction->HasEnvironment()) {
+          continue;
+        }
+        return false;
+      }
+      DataType::Type type = instruction->IsArrayGet()
+          ? instruction->GetType()
+          : instruction->AsArraySet()->GetComponentType();
+      HInstruction* array = instruction->InputAt(0);
+      HInstruction* index = instruction->InputAt(1);
+      if (type == DataType::Type::kReference) {
+        // A row of a two-dimensional array, usable by the element accesses below.
+        if (instruction->IsArraySet() ||
+            !outer->IsDefinedOutOfTheLoop(array) ||
+            !(array->IsNullCheck() || !array->CanBeNull()) ||
+            (index != p && index != q)) {
+          return false;
+        }
+        continue;
+      }
+      // Look through the checks of the access.
+      HInstruction* bounds_check = nullptr;
+      HInstruction* null_check = nullptr;
+      if (index->IsBoundsCheck()) {
+        bounds_check = index;
+        index = bounds_check->InputAt(0);
+        if (!bounds_check->InputAt(1)->IsArrayLength() ||
+            bounds_check->InputAt(1)->InputAt(0) != array) {
+          return false;
+        }
+      }
+      if (array->IsNullCheck()) {
+        null_check = array;
+        array = null_check->InputAt(0);
+      }
+      size_t size = DataType::Size(type);
+      if (index == p) {
+        ++num_by_p[size];
+      } else if (index == q) {
+        ++num_by_q[size];
+      } else {
+        ++num_by_other[size];
+      }
+      if (instruction->IsArraySet()) {
+        ++num_stores[size];
+      }
+      if (outer->IsDefinedOutOfTheLoop(array)) {
+        // One-dimensional array, its accesses must be free of checks.
+        if (bounds_check != nullptr || null_check != nullptr) {
+          return false;
+        }
+      } else if (array->IsArrayGet() &&
+                 array->GetType() == DataType::Type::kReference &&
+                 inner->Contains(*array->GetBlock())) {
+        // Element of a two-dimensional array.
+        HInstruction* row_index = array->InputAt(1);
+        bool is_column = row_index == q && index == p;
+        if (is_column) {
+          ++num_columns;
+        } else if (row_index == p && index == q) {
+          ++num_rows;
+        } else if (bounds_check != nullptr || null_check != nullptr) {
+          return false;
+        }
+      } else {
+        return false;
+      }
+    }
+  }
+  // Only the checks on the rows of column walks may remain: the null checks of the rows and
+  // the bounds checks of the outer induction against the length of the rows, with uses by
+  // the element accesses only. These are covered by the scan of the rows.
+  for (HInstruction* check : checks) {
+    HInstruction* row = check->InputAt(0);
+    if (check->IsBoundsCheck()) {
+      // The scan only checks the upper bound.
+      row = check->InputAt(1)->InputAt(0);
+      if (check->InputAt(0) != p ||
+          !outer_control.lo->IsIntConstant() ||
+          outer_control.lo->AsIntConstant()->GetValue() < 0) {
+        return false;
+      }
+      for (const HUseListNode<HInstruction*>& use : check->GetUses()) {
+        if (!(use.GetUser()->IsArrayGet() || use.GetUser()->IsArraySet()) ||
+            use.GetIndex() != 1u) {
+          return false;
+        }
+      }
+    } else {
+      for (const HUseListNode<HInstruction*>& use : check->GetUses()) {
+        if (!(use.GetUser()->IsArrayGet() ||
+              use.GetUser()->IsArraySet() ||
+              use.GetUser()->IsArrayLength()) ||
+            use.GetIndex() != 0u) {
+          return false;
+        }
+      }
+    }
+    if (row->IsNullCheck()) {
+      row = row->InputAt(0);
+    }
+    if (!row->IsArrayGet() ||
+        row->GetType() != DataType::Type::kReference ||
+        !inner->Contains(*row->GetBlock()) ||
+        row->InputAt(1) != q) {
+      return false;
+    }
+    if (!ContainsElement(bases, row->InputAt(0))) {
+      bases.push_back(row->InputAt(0));
+    }
+  }
+  if (!checks.empty() && !outer->GetSuspendCheck()->HasEnvironment()) {
+    return false;  // cannot deoptimize
+  }
+  // Interchange changes the order of the iterations. Accesses of possibly aliasing elements
+  // of which one is a store must then be indexed by the same induction, so that they only
+  // depend on iterations with the same value of that induction, whose order is kept.
+  for (size_t size = 0; size < arraysize(num_stores); ++size) {
+    if (num_stores[size] != 0u &&
+        (num_by_other[size] != 0u || (num_by_p[size] != 0u && num_by_q[size] != 0u))) {
+      return false;
+    }
+  }
+  // Interchange if that makes all element accesses walk rows, unless the rows of a column
+  // stay cached anyway until the next column reuses them.
+  if (num_columns == 0u || num_rows != 0u || ColumnFitsCache(inner)) {
+    return false;
+  }
+  // The value of the outer induction after the nest must be preserved.
+  bool has_uses_after_nest = HasUsesOutsideLoop(p, outer);
+  if (has_uses_after_nest && !induction_range_.CanGenerateLastValue(p)) {
+    return false;
+  }
+
+  // Transform the nest.
+  if (has_uses_after_nest) {
+    HInstruction* last_value = induction_range_.GenerateLastValue(p, graph_, outer->GetPreHeader());
+    ReplaceUsesOutsideLoop(p, last_value, outer);
+  }
+  HLoopInformation* scan = nullptr;
+  if (!checks.empty()) {
+    scan = GenerateRowScan(outer, outer_control, inner_control, bases);
+    // Remove the bounds checks before the null checks of the lengths they use.
+    for (HInstruction* check : checks) {
+      if (check->IsBoundsCheck()) {
+        check->ReplaceWith(check->InputAt(0));
+        check->GetBlock()->RemoveInstruction(check);
+      }
+    }
+    for (HInstruction* check : checks) {
+      if (check->IsNullCheck()) {
+        check->ReplaceWith(check->InputAt(0));
+        check->GetBlock()->RemoveInstruction(check);
+      }
+    }
+  }
+  // The body now sees p where it saw q and vice versa, while the loops exchange bounds:
+  //   for (p = lo_p; p < hi_p; p++)        for (p = lo_q; p < hi_q; p++)
+  //     for (q = lo_q; q < hi_q; q++)  =>    for (q = lo_p; q < hi_p; q++)
+  //       body(p, q)                           body(q, p)
+  SwapUsesInLoop(p, q, inner, inner_control.condition, inner_control.increment);
+  outer_control.condition->ReplaceInput(
+      inner_control.hi, outer_control.condition->InputAt(0) == p ? 1u : 0u);
+  inner_control.condition->ReplaceInput(
+      outer_control.hi, inner_control.condition->InputAt(0) == q ? 1u : 0u);
+  p->ReplaceInput(inner_control.lo, 0u);
+  q->ReplaceInput(outer_control.lo, 0u);
+  // Update the induction information of the nest and the loop of the scan, if any.
+  induction_range_.ReVisit(outer);
+  induction_range_.ReVisit(inner);
+  if (scan != nullptr) {
+    induction_range_.ReVisit(scan);
+  }
+  return true;
+}
+
+HLoopInformation* HLoopNestOptimization::GenerateRowScan(HLoopInformation* outer,
+                                            const LoopControl& outer_control,
+                                            const LoopControl& inner_control,
+                                            const ScopedArenaVector<HInstruction*>& bases) {
+  ArenaAllocator* allocator = graph_->GetAllocator();
+  HBasicBlock* preheader = outer->GetPreHeader();
+  HSuspendCheck* suspend = outer->GetSuspendCheck();
+  // The rows are only known to exist if the nest runs at all:
+  // lim = lo_p < hi_p ? hi_q : lo_q;
+  HInstruction* taken = Insert(preheader, new (allocator) HLessThan(
+      outer_control.lo, outer_control.hi));
+  HInstruction* limit_value = Insert(preheader, new (allocator) HSelect(
+      taken, inner_control.hi, inner_control.lo, kNoDexPc));
+  // Generate a scan that stops at the first unsuitable row, by making the limit the
+  // current index:
+  // for (k = lo_q; k < lim; ) {
+  //   bad = base[k] == null || base[k].length < hi_p;  // for each base
+  //   lim = bad ? k : lim;
+  //   k = bad ? k : k + 1;
+  // }
+  // deoptimize if k < lim;
+  HBasicBlock* header = graph_->TransformLoopForSkipAhead(outer->GetHeader());
+  HBasicBlock* exit = header->GetSuccessors()[0];
+  HBasicBlock* body = header->GetSuccessors()[1];
+  HPhi* index = new (allocator) HPhi(allocator, kNoRegNumber, 0, DataType::Type::kInt32);
+  HPhi* limit = new (allocator) HPhi(allocator, kNoRegNumber, 0, DataType::Type::kInt32);
+  header->AddPhi(index);
+  header->AddPhi(limit);
+  HInstruction* control = new (allocator) HGreaterThanOrEqual(index, limit);
+  header->AddInstruction(control);
+  header->AddInstruction(new (allocator) HIf(control));
+  HInstruction* bad = nullptr;
+  for (HInstruction* base : bases) {
+    // A null row is replaced by the base, which is not null, to load a length.
+    HInstruction* row = Insert(body, new (allocator) HArrayGet(
+        base, index, DataType::Type::kReference, kNoDexPc));
+    HInstruction* is_null = Insert(body, new (allocator) HEqual(row, graph_->GetNullConstant()));
+    HInstruction* safe_row = Insert(body, new (allocator) HSelect(is_null, base, row, kNoDexPc));
+    HInstruction* length = Insert(body, new (allocator) HArrayLength(safe_row, kNoDexPc));
+    HInstruction* is_short = Insert(body, new (allocator) HLessThan(length, outer_control.hi));
+    HInstruction* row_bad = Insert(body, new (allocator) HSelect(
+        is_null, graph_->GetIntConstant(1), is_short, kNoDexPc));
+    bad = (bad == nullptr)
+        ? row_bad
+        : Insert(body, new (allocator) HOr(DataType::Type::kInt32, bad, row_bad));
+  }
+  HInstruction* stop = Insert(body, new (allocator) HNotEqual(bad, graph_->GetIntConstant(0)));
+  HInstruction* next = Insert(body, new (allocator) HAdd(
+      DataType::Type::kInt32, index, graph_->GetIntConstant(1)));
+  HInstruction* new_limit = Insert(body, new (allocator) HSelect(stop, index, limit, kNoDexPc));
+  HInstruction* new_index = Insert(body, new (allocator) HSelect(stop, index, next, kNoDexPc));
+  index->AddInput(inner_control.lo);
+  index->AddInput(new_index);
+  limit->AddInput(limit_value);
+  limit->AddInput(new_limit);
+  // Deoptimize with the state at the nest entry, for the interpreter to run the nest.
+  HInstruction* failed = Insert(exit, new (allocator) HLessThan(index, limit_value));
+  HDeoptimize* deoptimize = new (allocator) HDeoptimize(
+      allocator, failed, DeoptimizationKind::kLoopBoundsBCE, suspend->GetDexPc());
+  Insert(exit, deoptimize);
+  deoptimize->CopyEnvironmentFromWithLoopPhiAdjustment(
+      suspend->GetEnvironment(), outer->GetHeader());
+  return header->GetLoopInformation();
+}
+
+}  // namespace art
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_LOOP_NEST_OPTIMIZATION_H_
+#define ART_COMPILER_OPTIMIZING_LOOP_NEST_OPTIMIZATION_H_
+
+#include "base/scoped_arena_containers.h"
+#include "induction_var_range.h"
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+class CompilerDriver;
+
+/**
+ * Optional loop nest optimization, enabled with --loop-nest-optimization. Interchanges
+ * perfectly nested loops that walk two-dimensional arrays column by column, so that the
+ * inner loop walks along the rows, where consecutive elements share cache lines.
+ *
+ * The null and bounds checks on the rows are replaced by a scan of the rows in front of
+ * the nest, which deoptimizes if any row is null or too short. The interpreter then
+ * runs the nest in its original order, so that exceptions are thrown where they should.
+ */
+class HLoopNestOptimization : public HOptimization {
+ public:
+  HLoopNestOptimization(HGraph* graph,
+                        const CompilerDriver* compiler_driver,
+                        HInductionVarAnalysis* induction_analysis,
+                        OptimizingCompilerStats* stats,
+                        const char* name = kLoopNestOptimizationPassName);
+
+  void Run() OVERRIDE;
+
+  static constexpr const char* kLoopNestOptimizationPassName = "loop_nest_optimization";
+
+ private:
+  // Control of a loop for (phi = lo; phi < hi; phi++), with bounds defined before the nest.
+  struct LoopControl {
+    HPhi* phi;
+    HInstruction* lo;
+    HInstruction* hi;
+    HCondition* condition;
+    HInstruction* increment;
+    HBasicBlock* body;  // successor of the header in the loop
+    HBasicBlock* exit;  // successor of the header out of the loop
+  };
+
+  // Try to interchange the loops of the nest with the given outer loop.
+  bool TryInterchange(HLoopInformation* outer);
+
+  // Match the loop control of `loop`, which is `nest` or inside `nest`.
+  bool MatchLoopControl(HLoopInformation* loop,
+                        HLoopInformation* nest,
+                        /*out*/ LoopControl* control);
+
+  // Returns whether `phi` in the inner loop header accumulates an integral value that is
+  // carried around the outer loop by `outer_phi`, in any order of the iterations.
+  bool IsReduction(HPhi* phi, HPhi* outer_phi, HLoopInformation* outer);
+
+  // Returns whether the inner loop touches so few rows per column that they stay cached.
+  bool ColumnFitsCache(HLoopInformation* inner);
+
+  // Generate, in front of the nest, a scan of the rows base[inner index] for each base of
+  // `bases`, which deoptimizes if a row is null or shorter than the outer loop upper bound.
+  // Returns the loop of the scan.
+  HLoopInformation* GenerateRowScan(HLoopInformation* outer,
+                                    const LoopControl& outer_control,
+                                    const LoopControl& inner_control,
+                                    const ScopedArenaVector<HInstruction*>& bases);
+
+  // Compiler driver (to query the options and the target).
+  const CompilerDriver* compiler_driver_;
+
+  // Range information based on prior induction variable analysis.
+  InductionVarRange induction_range_;
+
+  DISALLOW_COPY_AND_ASSIGN(HLoopNestOptimization);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_LOOP_NEST_OPTIMIZATION_H_
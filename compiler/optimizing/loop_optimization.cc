@@ -24,6 +24,7 @@
 #include "arch/x86/instruction_set_features_x86.h"
 #include "arch/x86_64/instruction_set_features_x86_64.h"
 #include "driver/compiler_driver.h"
+#include "driver/compiler_options.h"
 #include "linear_order.h"
 #include "mirror/array-inl.h"
 #include "mirror/string.h"
@@ -34,13 +35,55 @@ namespace art {
 // Enables vectorization (SIMDization) in the loop optimizer.
 static constexpr bool kEnableVectorization = true;
 
+// Enables 256-bit vectorization on targets that support it (x86-64 with AVX2).
+static constexpr bool kEnableWideVectorization = true;
+
+// Enables a narrower vector epilogue loop for the remainder iterations of a
+// 256-bit vector loop, which otherwise run in the scalar cleanup loop.
+static constexpr bool kEnableVectorEpilogue = true;
+
+// Minimum number of 256-bit vector iterations of a loop with known trip count
+// before the wider vectors are preferred over 128-bit vectors.
+static constexpr int64_t kMinWideVectorIterations = 4;
+
 // No loop unrolling factor (just one copy of the loop-body).
 static constexpr uint32_t kNoUnrollingFactor = 1;
 
+// Maximum number of instructions in either branch of a loop-body converted into selects.
+static constexpr size_t kIfConversionMaxBranchInstructions = 4;
+
 //
 // Static helpers.
 //
 
+// The condition of an HIf is known in the blocks dominated by either of its successors, if
+// they are only reached through the HIf. Replace the uses of the condition in these blocks
+// with its value there.
+static void TryToEvaluateIfCondition(HIf* instruction, HGraph* graph) {
+  HInstruction* cond = instruction->InputAt(0);
+  HBasicBlock* if_block = instruction->GetBlock();
+  HBasicBlock* true_succ = instruction->IfTrueSuccessor();
+  HBasicBlock* false_succ = instruction->IfFalseSuccessor();
+  if (true_succ->GetPredecessors().size() != 1u ||
+      false_succ->GetPredecessors().size() != 1u) {
+    return;
+  }
+  DCHECK_EQ(true_succ->GetSinglePredecessor(), if_block);
+  DCHECK_EQ(false_succ->GetSinglePredecessor(), if_block);
+  const HUseList<HInstruction*>& uses = cond->GetUses();
+  for (auto it = uses.begin(), end = uses.end(); it != end; /* ++it below */) {
+    HInstruction* user = it->GetUser();
+    size_t index = it->GetIndex();
+    // Increment `it` now because `*it` may disappear thanks to user->ReplaceInput().
+    ++it;
+    if (true_succ->Dominates(user->GetBlock())) {
+      user->ReplaceInput(graph->GetIntConstant(1), index);
+    } else if (false_succ->Dominates(user->GetBlock())) {
+      user->ReplaceInput(graph->GetIntConstant(0), index);
+    }
+  }
+}
+
 // Base alignment for arrays/strings guaranteed by the Android runtime.
 static uint32_t BaseAlignment() {
   return kObjectAlignment;
@@ -74,6 +117,60 @@ static bool IsGotoBlock(HBasicBlock* block, /*out*/ HBasicBlock** succ) {
   return false;
 }
 
+// Detect a block with a single predecessor and successor that only computes values that
+// are safe to compute regardless of the branch taken, and sets succ to the single successor.
+static bool IsSpeculatableBlock(HBasicBlock* block, /*out*/ HBasicBlock** succ) {
+  if (block->GetPredecessors().size() != 1 ||
+      block->GetSuccessors().size() != 1 ||
+      !block->GetPhis().IsEmpty()) {
+    return false;
+  }
+  size_t num_instructions = 0;
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (instruction->IsGoto()) {
+      break;
+    }
+    // Memory reads and divisions could depend on the condition to be safe, e.g. after
+    // bounds check elimination or with the zero check on the divisor.
+    if (!instruction->CanBeMoved() ||
+        instruction->HasSideEffects() ||
+        instruction->GetSideEffects().DoesAnyRead() ||
+        instruction->CanThrow() ||
+        instruction->IsDiv() ||
+        instruction->IsRem() ||
+        ++num_instructions > kIfConversionMaxBranchInstructions) {
+      return false;
+    }
+  }
+  *succ = block->GetSingleSuccessor();
+  return true;
+}
+
+// Detect an update of a value in a branch, viz. x + y or x - y, used only by the merging
+// phi. Returns the index of the input y on success.
+static bool IsBranchUpdate(HInstruction* update,
+                           HInstruction* value,
+                           HBasicBlock* branch,
+                           /*out*/ size_t* index) {
+  if (update->GetBlock() != branch ||
+      !DataType::IsIntegralType(update->GetType()) ||
+      !update->HasOnlyOneNonEnvironmentUse() ||
+      update->HasEnvironmentUses()) {
+    return false;
+  }
+  if (update->IsAdd() && update->InputAt(1) == value && update->InputAt(0) != value) {
+    *index = 0;
+    return true;
+  } else if ((update->IsAdd() || update->IsSub()) &&
+             update->InputAt(0) == value &&
+             update->InputAt(1) != value) {
+    *index = 1;
+    return true;
+  }
+  return false;
+}
+
 // Detect an early exit loop.
 static bool IsEarlyExit(HLoopInformation* loop_info) {
   HBlocksInLoopReversePostOrderIterator it_loop(*loop_info);
@@ -263,6 +360,29 @@ static bool IsNarrowerOperand(HInstruction* a,
   return false;
 }
 
+// As above, for the operand of a widening sum, where a selection between
+// two same-extension narrower values counts as a narrower operand too.
+static bool IsNarrowerSumOperand(HInstruction* a,
+                                 DataType::Type type,
+                                 /*out*/ HInstruction** r,
+                                 /*out*/ bool* is_unsigned) {
+  if (a->IsSelect()) {
+    HInstruction* t = nullptr;
+    HInstruction* f = nullptr;
+    if (IsNarrowerOperands(a->AsSelect()->GetTrueValue(),
+                           a->AsSelect()->GetFalseValue(),
+                           type,
+                           &t,
+                           &f,
+                           is_unsigned)) {
+      *r = a;  // the selection itself is vectorized in the narrower type
+      return true;
+    }
+    return false;
+  }
+  return IsNarrowerOperand(a, type, r, is_unsigned);
+}
+
 // Compute relative vector length based on type difference.
 static uint32_t GetOtherVL(DataType::Type other_type, DataType::Type vector_type, uint32_t vl) {
   DCHECK(DataType::IsIntegralType(other_type));
@@ -364,7 +484,10 @@ static bool HasReductionFormat(HInstruction* reduction, HInstruction* phi) {
 
 // Translates vector operation to reduction kind.
 static HVecReduce::ReductionKind GetReductionKind(HVecOperation* reduction) {
-  if (reduction->IsVecAdd() || reduction->IsVecSub() || reduction->IsVecSADAccumulate()) {
+  if (reduction->IsVecAdd() ||
+      reduction->IsVecSub() ||
+      reduction->IsVecSADAccumulate() ||
+      reduction->IsVecSumAccumulate()) {
     return HVecReduce::kSum;
   } else if (reduction->IsVecMin()) {
     return HVecReduce::kMin;
@@ -413,6 +536,10 @@ HLoopOptimization::HLoopOptimization(HGraph* graph,
                                      const char* name)
     : HOptimization(graph, name, stats),
       compiler_driver_(compiler_driver),
+      arch_loop_helper_(ArchLoopHelper::Create(
+          compiler_driver != nullptr ? compiler_driver->GetInstructionSet() : InstructionSet::kNone,
+          compiler_driver != nullptr ? compiler_driver->GetInstructionSetFeatures() : nullptr,
+          graph->GetAllocator())),
       induction_range_(induction_analysis),
       induction_var_sim_(induction_analysis),
       loop_allocator_(nullptr),
@@ -423,11 +550,14 @@ HLoopOptimization::HLoopOptimization(HGraph* graph,
       reductions_(nullptr),
       simplified_(false),
       vector_length_(0),
+      vector_wide_(false),
+      vector_epilogue_length_(0),
       vector_refs_(nullptr),
       vector_static_peeling_factor_(0),
       vector_dynamic_peeling_candidate_(nullptr),
-      vector_runtime_test_a_(nullptr),
-      vector_runtime_test_b_(nullptr),
+      vector_runtime_test_a_(),
+      vector_runtime_test_b_(),
+      vector_num_runtime_tests_(0),
       vector_map_(nullptr),
       vector_permanent_map_(nullptr),
       vector_mode_(kSequential),
@@ -497,6 +627,15 @@ void HLoopOptimization::LocalRun() {
     vector_permanent_map_ = &perm;
     // Traverse.
     TraverseLoopsInnerToOuter(top_loop_);
+    // Once the loops have their final shape, drop the polls of the short counted loops.
+    int64_t budget = (compiler_driver_ != nullptr && !graph_->IsCompilingOsr())
+        ? compiler_driver_->GetCompilerOptions().GetSuspendCheckIterationBudget()
+        : 0;
+    if (budget != 0) {
+      for (LoopNode* node = top_loop_; node != nullptr; node = node->next) {
+        ElideSuspendCheckPolls(node, budget);
+      }
+    }
     // Detach.
     iset_ = nullptr;
     reductions_ = nullptr;
@@ -570,14 +709,43 @@ bool HLoopOptimization::TraverseLoopsInnerToOuter(LoopNode* node) {
       SimplifyBlocks(node);
       changed = simplified_ || changed;
     } while (simplified_);
-    // Optimize inner loop.
+    // Optimize inner loop, after removing any control flow from its body
+    // that stands in the way of vectorization.
     if (node->inner == nullptr) {
+      if (kEnableVectorization && TryIfConversion(node)) {
+        changed = true;
+      }
       changed = OptimizeInnerLoop(node) || changed;
     }
   }
   return changed;
 }
 
+int64_t HLoopOptimization::ElideSuspendCheckPolls(LoopNode* node, int64_t budget) {
+  int64_t inner_iterations = 0;
+  for (LoopNode* inner = node->inner; inner != nullptr; inner = inner->next) {
+    inner_iterations += ElideSuspendCheckPolls(inner, budget);
+  }
+  HLoopInformation* loop_info = node->loop_info;
+  int64_t trip_count = LoopAnalysis::GetLoopTripCount(loop_info, &induction_range_);
+  // Each iteration runs the nested loops without a poll to completion.
+  if (trip_count == LoopAnalysisInfo::kUnknownTripCount ||
+      trip_count > budget / (1 + inner_iterations)) {
+    return 0;
+  }
+  // Calls take long enough that the poll does not matter, and may loop without polling.
+  for (HBlocksInLoopIterator it(*loop_info); !it.Done(); it.Advance()) {
+    for (HInstructionIterator i(it.Current()->GetInstructions()); !i.Done(); i.Advance()) {
+      if (i.Current()->IsInvoke()) {
+        return 0;
+      }
+    }
+  }
+  loop_info->GetSuspendCheck()->SetPollElided();
+  MaybeRecordStat(stats_, MethodCompilationStat::kSuspendCheckPollElided);
+  return trip_count * (1 + inner_iterations);
+}
+
 //
 // Optimization.
 //
@@ -646,6 +814,315 @@ void HLoopOptimization::SimplifyBlocks(LoopNode* node) {
   }
 }
 
+bool HLoopOptimization::TryIfConversion(LoopNode* node) {
+  HLoopInformation* loop_info = node->loop_info;
+  HBasicBlock* header = loop_info->GetHeader();
+  // Ensure the loop is finite, and the loop-body (besides the header) is a diamond
+  // entered from the header that merges into the back edge.
+  int64_t trip_count = 0;
+  if (!induction_range_.IsFinite(loop_info, &trip_count) ||
+      header->GetSuccessors().size() != 2) {
+    return false;
+  }
+  size_t num_blocks = 0;
+  for (HBlocksInLoopIterator it(*loop_info); !it.Done(); it.Advance()) {
+    ++num_blocks;
+  }
+  HBasicBlock* block = loop_info->Contains(*header->GetSuccessors()[0])
+      ? header->GetSuccessors()[0]
+      : header->GetSuccessors()[1];
+  if (num_blocks != 5 ||
+      block->GetPredecessors().size() != 1 ||
+      !block->GetPhis().IsEmpty() ||
+      !block->EndsWithIf()) {
+    return false;
+  }
+  HIf* if_instruction = block->GetLastInstruction()->AsIf();
+  HBasicBlock* true_block = if_instruction->IfTrueSuccessor();
+  HBasicBlock* false_block = if_instruction->IfFalseSuccessor();
+  HBasicBlock* merge0 = nullptr;
+  HBasicBlock* merge1 = nullptr;
+  if (!IsSpeculatableBlock(true_block, &merge0) ||
+      !IsSpeculatableBlock(false_block, &merge1) ||
+      merge0 != merge1 ||
+      merge0->GetPredecessors().size() != 2 ||
+      merge0->GetSingleSuccessor() != header) {
+    return false;
+  }
+  HBasicBlock* merge_block = merge0;
+  size_t true_index = merge_block->GetPredecessorIndexOf(true_block);
+  size_t false_index = merge_block->GetPredecessorIndexOf(false_block);
+  bool has_select = false;
+  for (HInstructionIterator it(merge_block->GetPhis()); !it.Done(); it.Advance()) {
+    HInstruction* phi = it.Current();
+    has_select = has_select || phi->InputAt(true_index) != phi->InputAt(false_index);
+  }
+  if (!has_select) {
+    return false;
+  }
+  // Convert each conditional update of a value, viz. c ? x + y : x, into the unconditional
+  // update of a selected operand, viz. x + (c ? y : 0), which keeps the form of reductions.
+  HInstruction* condition = if_instruction->InputAt(0);
+  uint32_t dex_pc = if_instruction->GetDexPc();
+  for (HInstructionIterator it(merge_block->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* phi = it.Current()->AsPhi();
+    HInstruction* true_value = phi->InputAt(true_index);
+    HInstruction* false_value = phi->InputAt(false_index);
+    size_t index = 0;
+    if (IsBranchUpdate(true_value, false_value, true_block, &index)) {
+      HInstruction* operand = true_value->InputAt(index);
+      HInstruction* zero = graph_->GetConstant(true_value->GetType(), 0);
+      HSelect* select = new (global_allocator_) HSelect(condition, operand, zero, dex_pc);
+      true_block->InsertInstructionBefore(select, true_value);
+      true_value->ReplaceInput(select, index);
+      phi->ReplaceInput(true_value, false_index);
+    } else if (IsBranchUpdate(false_value, true_value, false_block, &index)) {
+      HInstruction* operand = false_value->InputAt(index);
+      HInstruction* zero = graph_->GetConstant(false_value->GetType(), 0);
+      HSelect* select = new (global_allocator_) HSelect(condition, zero, operand, dex_pc);
+      false_block->InsertInstructionBefore(select, false_value);
+      false_value->ReplaceInput(select, index);
+      phi->ReplaceInput(false_value, true_index);
+    }
+  }
+  // Move the instructions of both branches in front of the If.
+  while (!true_block->IsSingleGoto()) {
+    true_block->GetFirstInstruction()->MoveBefore(if_instruction);
+  }
+  while (!false_block->IsSingleGoto()) {
+    false_block->GetFirstInstruction()->MoveBefore(if_instruction);
+  }
+  // Select all other values that differ.
+  for (HInstructionIterator it(merge_block->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* phi = it.Current()->AsPhi();
+    HInstruction* true_value = phi->InputAt(true_index);
+    HInstruction* false_value = phi->InputAt(false_index);
+    if (true_value != false_value) {
+      HSelect* select = new (global_allocator_) HSelect(condition, true_value, false_value, dex_pc);
+      if (phi->GetType() == DataType::Type::kReference) {
+        select->SetReferenceTypeInfo(phi->GetReferenceTypeInfo());
+      }
+      block->InsertInstructionBefore(select, if_instruction);
+      phi->ReplaceInput(select, false_index);
+    }
+  }
+  // Remove the true branch, which leaves the phis with a single input to be
+  // replaced, and merge the remaining blocks that are now connected by gotos.
+  true_block->DisconnectAndDelete();
+  block->MergeWith(false_block);
+  block->MergeWith(merge_block);
+  induction_range_.ReVisit(loop_info);
+  MaybeRecordStat(stats_, MethodCompilationStat::kSelectGenerated);
+  return true;
+}
+
+bool HLoopOptimization::TryVectorizeSearchLoop(LoopNode* node) {
+  HLoopInformation* loop_info = node->loop_info;
+  HBasicBlock* header = loop_info->GetHeader();
+  HBasicBlock* preheader = loop_info->GetPreHeader();
+  // Ensure loop header logic is finite, and only carries the main induction.
+  int64_t trip_count = 0;
+  HPhi* main_phi = nullptr;
+  if (!kEnableVectorization ||
+      !induction_range_.IsFinite(loop_info, &trip_count) ||
+      loop_info->NumberOfBackEdges() != 1 ||
+      !TrySetSimpleLoopHeader(header, &main_phi) ||
+      !reductions_->empty() ||
+      main_phi->GetType() != DataType::Type::kInt32) {
+    return false;
+  }
+  // Ensure the loop-body consists of a block that exits the loop on a comparison,
+  // followed by the back edge that only increments the main induction.
+  size_t num_blocks = 0;
+  for (HBlocksInLoopIterator it(*loop_info); !it.Done(); it.Advance()) {
+    ++num_blocks;
+  }
+  HBasicBlock* body = loop_info->Contains(*header->GetSuccessors()[0])
+      ? header->GetSuccessors()[0]
+      : header->GetSuccessors()[1];
+  HBasicBlock* latch = loop_info->GetBackEdges()[0];
+  if (num_blocks != 3 ||
+      body == latch ||
+      body->GetPredecessors().size() != 1 ||
+      !body->GetPhis().IsEmpty() ||
+      !body->EndsWithIf() ||
+      latch->GetPredecessors().size() != 1 ||
+      latch->GetSinglePredecessor() != body ||
+      latch->GetFirstInstruction() != main_phi->InputAt(1) ||
+      !latch->GetFirstInstruction()->GetNext()->IsGoto()) {
+    return false;
+  }
+  HIf* exit_if = body->GetLastInstruction()->AsIf();
+  HInstruction* cond = exit_if->InputAt(0);
+  if (!cond->IsCondition() ||
+      cond->GetBlock() != body ||
+      !cond->GetUses().HasExactlyOneElement() ||
+      cond->HasEnvironmentUses() ||
+      (cond->AsCondition()->GetCondition() != kCondEQ &&
+       cond->AsCondition()->GetCondition() != kCondNE)) {
+    return false;
+  }
+  // Besides the comparison, the block may only load its operands and compute their indices.
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (instruction == cond || instruction == exit_if) {
+      continue;
+    } else if (instruction->IsArrayGet()) {
+      if (instruction != cond->InputAt(0) && instruction != cond->InputAt(1)) {
+        return false;
+      }
+    } else if (instruction->IsAdd() || instruction->IsSub()) {
+      if (instruction->HasEnvironmentUses()) {
+        return false;
+      }
+      for (const HUseListNode<HInstruction*>& use : instruction->GetUses()) {
+        HInstruction* user = use.GetUser();
+        if (!user->IsArrayGet() || user->GetBlock() != body || use.GetIndex() != 1) {
+          return false;
+        }
+      }
+    } else {
+      return false;
+    }
+  }
+  // Accept a comparison of unit stride array references a[i + x], with the same
+  // component type and loop-invariant bases, or of such a reference and a loop-invariant
+  // value that is exactly representable in the element type. The bounds checks must
+  // have been eliminated for the whole range of the loop header logic, so that all
+  // references of the vector loop are known to be within bounds.
+  DataType::Type type = DataType::Type::kVoid;
+  HInstruction* offsets[2] = { nullptr, nullptr };
+  for (size_t k = 0; k < 2; ++k) {
+    HInstruction* operand = cond->InputAt(k);
+    if (operand->IsArrayGet()) {
+      HInstruction* base = operand->InputAt(0);
+      HInstruction* index = operand->InputAt(1);
+      if (operand->AsArrayGet()->IsStringCharAt() ||
+          index->IsBoundsCheck() ||
+          !loop_info->IsDefinedOutOfTheLoop(base) ||
+          !induction_range_.IsUnitStride(operand, index, graph_, &offsets[k])) {
+        return false;
+      } else if (type == DataType::Type::kVoid) {
+        type = operand->GetType();
+      } else if (type != operand->GetType()) {
+        // Elements of the same size may still differ once extended, e.g. short and char.
+        return false;
+      }
+    } else if (!loop_info->IsDefinedOutOfTheLoop(operand)) {
+      return false;
+    }
+  }
+  if (type == DataType::Type::kVoid) {
+    return false;
+  }
+  for (size_t k = 0; k < 2; ++k) {
+    HInstruction* operand = cond->InputAt(k);
+    int64_t value = 0;
+    if (offsets[k] == nullptr &&
+        (IsInt64AndGet(operand, &value)
+             ? !DataType::IsTypeConversionImplicit(value, type)
+             : !DataType::IsTypeConversionImplicit(operand->GetType(), type))) {
+      return false;
+    }
+  }
+  HInstruction* phi_offset = nullptr;
+  if (!induction_range_.IsUnitStride(cond, main_phi, graph_, &phi_offset)) {
+    return false;
+  }
+  // Deal with vector restrictions, and skip loops that are known to be short.
+  uint64_t restrictions = kNone;
+  vector_length_ = 0;
+  vector_wide_ = false;
+  if (!TrySetVectorType(type, &restrictions) ||
+      HasVectorRestrictions(restrictions, kNoSelect) ||
+      (trip_count > 0 && trip_count < 2 * vector_length_)) {
+    return false;
+  }
+  HInstruction* stc = induction_range_.GenerateTripCount(loop_info, graph_, preheader);
+  if (stc == nullptr) {
+    return false;
+  }
+  // Generate loop control in the preheader:
+  // vtc = stc - stc % VL;
+  DataType::Type induc_type = main_phi->GetType();
+  HInstruction* rem = Insert(
+      preheader, new (global_allocator_) HAnd(induc_type,
+                                              stc,
+                                              graph_->GetConstant(induc_type, vector_length_ - 1)));
+  HInstruction* vtc = Insert(preheader, new (global_allocator_) HSub(induc_type, stc, rem));
+  // Generate the vector loop, which exits on the first vector with a component that
+  // would exit the original loop, by making the limit the current index:
+  // for (j = 0, lim = vtc; j < lim; ) {
+  //   m = any(<vector-comparison>(j));
+  //   lim = m ? j : lim;
+  //   j = m ? j : j + VL;
+  // }
+  HBasicBlock* new_header = graph_->TransformLoopForSkipAhead(header);
+  HBasicBlock* new_preheader = new_header->GetSuccessors()[0];
+  HBasicBlock* new_body = new_header->GetSuccessors()[1];
+  HPhi* index = new (global_allocator_) HPhi(
+      global_allocator_, kNoRegNumber, 0, HPhi::ToPhiType(induc_type));
+  HPhi* limit = new (global_allocator_) HPhi(
+      global_allocator_, kNoRegNumber, 0, HPhi::ToPhiType(induc_type));
+  new_header->AddPhi(index);
+  new_header->AddPhi(limit);
+  HInstruction* control = new (global_allocator_) HAboveOrEqual(index, limit);
+  new_header->AddInstruction(control);
+  new_header->AddInstruction(new (global_allocator_) HIf(control));
+  uint32_t dex_pc = cond->GetDexPc();
+  HInstruction* vectors[2] = { nullptr, nullptr };
+  for (size_t k = 0; k < 2; ++k) {
+    HInstruction* operand = cond->InputAt(k);
+    if (offsets[k] != nullptr) {
+      HInstruction* subscript = index;
+      int64_t value = 0;
+      if (!IsInt64AndGet(offsets[k], &value) || value != 0) {
+        subscript = Insert(new_body, new (global_allocator_) HAdd(induc_type, index, offsets[k]));
+      }
+      HVecLoad* load = new (global_allocator_) HVecLoad(global_allocator_,
+                                                        operand->InputAt(0),
+                                                        subscript,
+                                                        type,
+                                                        operand->GetSideEffects(),
+                                                        vector_length_,
+                                                        /* is_string_char_at */ false,
+                                                        operand->GetDexPc());
+      load->SetAlignment(ComputeAlignment(offsets[k], type, /* is_string_char_at */ false));
+      vectors[k] = Insert(new_body, load);
+    } else {
+      vectors[k] = Insert(preheader, new (global_allocator_) HVecReplicateScalar(
+          global_allocator_, operand, type, vector_length_, kNoDexPc));
+    }
+  }
+  IfCondition exit_cond = loop_info->Contains(*exit_if->IfTrueSuccessor())
+      ? cond->AsCondition()->GetOppositeCondition()
+      : cond->AsCondition()->GetCondition();
+  HInstruction* mask = Insert(new_body, new (global_allocator_) HVecCondition(
+      global_allocator_, vectors[0], vectors[1], type, vector_length_, exit_cond, dex_pc));
+  HInstruction* any = Insert(new_body, new (global_allocator_) HVecAnyTrue(
+      global_allocator_, mask, type, vector_length_, dex_pc));
+  HInstruction* next = Insert(new_body, new (global_allocator_) HAdd(
+      induc_type, index, graph_->GetConstant(induc_type, vector_length_)));
+  HInstruction* new_limit =
+      Insert(new_body, new (global_allocator_) HSelect(any, index, limit, kNoDexPc));
+  HInstruction* new_index =
+      Insert(new_body, new (global_allocator_) HSelect(any, index, next, kNoDexPc));
+  index->AddInput(graph_->GetConstant(induc_type, 0));
+  index->AddInput(new_index);
+  limit->AddInput(vtc);
+  limit->AddInput(new_limit);
+  // Continue the original loop where the vector loop stopped.
+  HInstruction* start = index;
+  int64_t value = 0;
+  if (!IsInt64AndGet(phi_offset, &value) || value != 0) {
+    start = Insert(new_preheader, new (global_allocator_) HAdd(induc_type, index, phi_offset));
+  }
+  main_phi->ReplaceInput(start, 0);
+  graph_->SetHasSIMD(true);  // flag SIMD usage
+  MaybeRecordStat(stats_, MethodCompilationStat::kLoopVectorizedIdiom);
+  return true;
+}
+
 bool HLoopOptimization::TryOptimizeInnerLoopFinite(LoopNode* node) {
   HBasicBlock* header = node->loop_info->GetHeader();
   HBasicBlock* preheader = node->loop_info->GetPreHeader();
@@ -710,6 +1187,9 @@ bool HLoopOptimization::TryOptimizeInnerLoopFinite(LoopNode* node) {
       TryAssignLastValue(node->loop_info, main_phi, preheader, /*collect_loop_uses*/ true)) {
     Vectorize(node, body, exit, trip_count);
     graph_->SetHasSIMD(true);  // flag SIMD usage
+    if (vector_wide_) {
+      graph_->SetHasWideSIMD(true);  // flag 256-bit SIMD usage
+    }
     MaybeRecordStat(stats_, MethodCompilationStat::kLoopVectorized);
     return true;
   }
@@ -718,7 +1198,10 @@ bool HLoopOptimization::TryOptimizeInnerLoopFinite(LoopNode* node) {
 
 bool HLoopOptimization::OptimizeInnerLoop(LoopNode* node) {
   return (TryOptimizeInnerLoopFinite(node) ||
-          TryFullUnrolling(node) || TryInductionVarSimplification(node));
+          TryVectorizeSearchLoop(node) ||
+          TryFullUnrolling(node) ||
+          TryPeelingForLoopInvariantExitsElimination(node) ||
+          TryInductionVarSimplification(node));
 
 }
 
@@ -763,7 +1246,7 @@ bool HLoopOptimization::TryFullUnrolling(LoopNode* node) {
     return false;
   }
 
-  if ((analysis_info.GetNumberOfInstructions() * trip_count) > 60 ) {
+  if (arch_loop_helper_->IsLoopTooBigForFullUnrolling(&analysis_info)) {
     return false;
   }
 
@@ -785,6 +1268,37 @@ bool HLoopOptimization::TryFullUnrolling(LoopNode* node) {
 
 }
 
+bool HLoopOptimization::TryPeelingForLoopInvariantExitsElimination(LoopNode* node) {
+  HLoopInformation* loop_info = node->loop_info;
+  int64_t trip_count = LoopAnalysis::GetLoopTripCount(loop_info, &induction_range_);
+  LoopAnalysisInfo analysis_info(loop_info);
+  LoopAnalysis::CalculateLoopBasicProperties(loop_info, &analysis_info, trip_count);
+  if (analysis_info.GetNumberOfInvariantExits() == 0 ||
+      analysis_info.HasInstructionsPreventingScalarPeeling() ||
+      arch_loop_helper_->IsLoopTooBigForPeeling(&analysis_info)) {
+    return false;
+  }
+  LoopPeelingHelper helper(loop_info);
+  if (!helper.IsLoopClonable()) {
+    return false;
+  }
+  helper.DoPeeling();
+
+  // The loop-invariant exits of the peeled iteration dominate the remaining iterations, which
+  // are only reached when these exits are not taken. Their copies in the loop are folded by
+  // dead code elimination.
+  for (const auto& entry : *helper.GetInstructionMap()) {
+    HInstruction* orig = entry.first;
+    HInstruction* copy = entry.second;
+    // A loop-invariant condition is shared by the original and the copy.
+    if (copy->IsIf() && copy->InputAt(0) == orig->InputAt(0)) {
+      TryToEvaluateIfCondition(copy->AsIf(), graph_);
+    }
+  }
+  MaybeRecordStat(stats_, MethodCompilationStat::kLoopPeeledForInvariantExits);
+  return true;
+}
+
 //
 // Loop vectorization. The implementation is based on the book by Aart J.C. Bik:
 // "The Software Vectorization Handbook. Applying Multimedia Extensions for Maximum Performance."
@@ -792,13 +1306,38 @@ bool HLoopOptimization::TryFullUnrolling(LoopNode* node) {
 //
 
 bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int64_t trip_count) {
+  // Try 256-bit vectors first, if supported, and fall back to 128-bit vectors
+  // for loops that use operations or have trip counts not suited to the wider form.
+  vector_epilogue_length_ = 0;
+  if (kEnableWideVectorization && SupportsWideVectors()) {
+    vector_wide_ = true;
+    if (ShouldVectorizeWithCurrentWidth(node, block, trip_count)) {
+      // Every operation accepted for 256-bit vectors is accepted for 128-bit vectors
+      // too, and both share the same alignment analysis, so the remainder iterations
+      // can run in a 128-bit vector epilogue. Reductions would need their partial
+      // results narrowed between the two loops, so they keep the scalar cleanup.
+      const InstructionSetFeatures* features = compiler_driver_->GetInstructionSetFeatures();
+      if (kEnableVectorEpilogue &&
+          reductions_->empty() &&
+          features->AsX86InstructionSetFeatures()->HasSSE4_1()) {
+        vector_epilogue_length_ = vector_length_ / 2;
+      }
+      return true;
+    }
+  }
+  vector_wide_ = false;
+  return ShouldVectorizeWithCurrentWidth(node, block, trip_count);
+}
+
+bool HLoopOptimization::ShouldVectorizeWithCurrentWidth(LoopNode* node,
+                                                        HBasicBlock* block,
+                                                        int64_t trip_count) {
   // Reset vector bookkeeping.
   vector_length_ = 0;
   vector_refs_->clear();
   vector_static_peeling_factor_ = 0;
   vector_dynamic_peeling_candidate_ = nullptr;
-  vector_runtime_test_a_ =
-  vector_runtime_test_b_ = nullptr;
+  vector_num_runtime_tests_ = 0;
 
   // Phis in the loop-body prevent vectorization.
   if (!block->GetPhis().IsEmpty()) {
@@ -814,7 +1353,9 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
   }
 
   // Prepare alignment analysis:
-  // (1) find desired alignment (SIMD vector size in bytes).
+  // (1) find desired alignment (SIMD vector size in bytes). For 256-bit vectors,
+  //     this remains 16 bytes: the runtime does not guarantee a stronger base
+  //     alignment, and the wide memory operations never require alignment.
   // (2) initialize static loop peeling votes (peeling factor that will
   //     make one particular reference aligned), never to exceed (1).
   // (3) variable to record how many references share same alignment.
@@ -857,14 +1398,19 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
           // Conservatively assume a potential loop-carried data dependence otherwise, avoided by
           // generating an explicit a != b disambiguation runtime test on the two references.
           if (x != y) {
-            // To avoid excessive overhead, we only accept one a != b test.
-            if (vector_runtime_test_a_ == nullptr) {
-              // First test found.
-              vector_runtime_test_a_ = a;
-              vector_runtime_test_b_ = b;
-            } else if ((vector_runtime_test_a_ != a || vector_runtime_test_b_ != b) &&
-                       (vector_runtime_test_a_ != b || vector_runtime_test_b_ != a)) {
-              return false;  // second test would be needed
+            bool has_test = false;
+            for (size_t t = 0; t < vector_num_runtime_tests_ && !has_test; ++t) {
+              has_test = (vector_runtime_test_a_[t] == a && vector_runtime_test_b_[t] == b) ||
+                         (vector_runtime_test_a_[t] == b && vector_runtime_test_b_[t] == a);
+            }
+            if (!has_test) {
+              // To avoid excessive overhead, we only accept a few a != b tests.
+              if (vector_num_runtime_tests_ == kMaxNumberOfRuntimeTests) {
+                return false;  // another test would be needed
+              }
+              vector_runtime_test_a_[vector_num_runtime_tests_] = a;
+              vector_runtime_test_b_[vector_num_runtime_tests_] = b;
+              ++vector_num_runtime_tests_;
             }
           }
         }
@@ -993,15 +1539,47 @@ void HLoopOptimization::Vectorize(LoopNode* node,
   }
   vector_index_ = graph_->GetConstant(induc_type, 0);
 
-  // Generate runtime disambiguation test:
+  // Generate loop control for the vector epilogue, if needed:
+  // etc = stc - (stc - ptc) % epilogue;
+  uint32_t epilogue = needs_cleanup ? vector_epilogue_length_ : 0u;
+  if (epilogue != 0 &&
+      trip_count > 0 &&
+      vector_dynamic_peeling_candidate_ == nullptr &&
+      vector_num_runtime_tests_ == 0 &&
+      ((trip_count - vector_static_peeling_factor_) % chunk) < epilogue) {
+    epilogue = 0;  // known remainder too small for the epilogue
+  }
+  HInstruction* etc = nullptr;
+  if (epilogue != 0) {
+    DCHECK(IsPowerOfTwo(epilogue));
+    DCHECK_LT(epilogue, chunk);
+    HInstruction* diff = stc;
+    if (ptc != nullptr) {
+      diff = Insert(preheader, new (global_allocator_) HSub(induc_type, stc, ptc));
+    }
+    HInstruction* rem = Insert(
+        preheader, new (global_allocator_) HAnd(induc_type,
+                                                diff,
+                                                graph_->GetConstant(induc_type, epilogue - 1)));
+    etc = Insert(preheader, new (global_allocator_) HSub(induc_type, stc, rem));
+  }
+
+  // Generate runtime disambiguation tests, so that the scalar cleanup loop runs all
+  // iterations when any two references may alias:
   // vtc = a != b ? vtc : 0;
-  if (vector_runtime_test_a_ != nullptr) {
+  // etc = a != b ? etc : 0;
+  for (size_t t = 0; t < vector_num_runtime_tests_; ++t) {
     HInstruction* rt = Insert(
         preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
+        new (global_allocator_) HNotEqual(vector_runtime_test_a_[t], vector_runtime_test_b_[t]));
     vtc = Insert(preheader,
                  new (global_allocator_)
                  HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
+    if (etc != nullptr) {
+      etc = Insert(preheader,
+                   new (global_allocator_)
+                   HSelect(rt, etc, graph_->GetConstant(induc_type, 0), kNoDexPc));
+    }
     needs_cleanup = true;
   }
 
@@ -1036,6 +1614,27 @@ void HLoopOptimization::Vectorize(LoopNode* node,
                   unroll);
   HLoopInformation* vloop = vector_header_->GetLoopInformation();
 
+  // Generate vector epilogue loop at the narrower vector length, if needed:
+  // for ( ; i < etc; i += epilogue)
+  //    <vectorized-loop-body>
+  if (etc != nullptr) {
+    uint32_t vector_length = vector_length_;
+    bool vector_wide = vector_wide_;
+    vector_length_ = epilogue;
+    vector_wide_ = false;
+    vector_mode_ = kVector;
+    GenerateNewLoop(node,
+                    block,
+                    graph_->TransformLoopForVectorization(vector_header_, vector_body_, exit),
+                    vector_index_,
+                    etc,
+                    graph_->GetConstant(induc_type, epilogue),
+                    kNoUnrollingFactor);
+    vector_length_ = vector_length;
+    vector_wide_ = vector_wide;
+    MaybeRecordStat(stats_, MethodCompilationStat::kLoopVectorizedEpilogue);
+  }
+
   // Generate cleanup loop, if needed:
   // for ( ; i < stc; i += 1)
   //    <loop-body>
@@ -1048,6 +1647,8 @@ void HLoopOptimization::Vectorize(LoopNode* node,
                     stc,
                     graph_->GetConstant(induc_type, 1),
                     kNoUnrollingFactor);
+  } else {
+    MaybeRecordStat(stats_, MethodCompilationStat::kLoopVectorizedWithoutCleanup);
   }
 
   // Link reductions to their final uses.
@@ -1174,8 +1775,9 @@ bool HLoopOptimization::VectorizeDef(LoopNode* node,
   auto redit = reductions_->find(instruction);
   if (redit != reductions_->end()) {
     DataType::Type type = instruction->GetType();
-    // Recognize SAD idiom or direct reduction.
+    // Recognize SAD idiom, widening sum idiom, or direct reduction.
     if (VectorizeSADIdiom(node, instruction, generate_code, type, restrictions) ||
+        VectorizeWideningSumIdiom(node, instruction, generate_code, type, restrictions) ||
         (TrySetVectorType(type, &restrictions) &&
          VectorizeUse(node, instruction, generate_code, type, restrictions))) {
       if (generate_code) {
@@ -1369,6 +1971,69 @@ bool HLoopOptimization::VectorizeUse(LoopNode* node,
         return true;
       }
     }
+  } else if (instruction->IsSelect()) {
+    // Deal with vector restrictions.
+    if (!DataType::IsIntegralType(type) || HasVectorRestrictions(restrictions, kNoSelect)) {
+      return false;
+    }
+    // Accept a selection on a comparison in the loop-body, which yields the mask of the
+    // selection. The comparison must be exact in the vector type: narrower operands must
+    // be same-extension narrower, and zero-extension narrower operands only test equality.
+    HSelect* select = instruction->AsSelect();
+    HInstruction* condition = select->GetCondition();
+    if (!condition->IsCondition() || node->loop_info->IsDefinedOutOfTheLoop(condition)) {
+      return false;
+    }
+    IfCondition cond = condition->AsCondition()->GetCondition();
+    HInstruction* opa = condition->InputAt(0);
+    HInstruction* opb = condition->InputAt(1);
+    HInstruction* r = opa;
+    HInstruction* s = opb;
+    bool is_unsigned = false;
+    if (cond > kCondGE ||
+        !DataType::IsIntegralType(opa->GetType()) ||
+        !DataType::IsIntegralType(opb->GetType())) {
+      return false;
+    } else if (DataType::Size(type) < DataType::Size(DataType::Type::kInt32)) {
+      if (!IsNarrowerOperands(opa, opb, type, &r, &s, &is_unsigned)) {
+        return false;  // reject, unless all operands are same-extension narrower
+      }
+    } else if (DataType::Size(opa->GetType()) > DataType::Size(type) ||
+               DataType::Size(opb->GetType()) > DataType::Size(type)) {
+      return false;
+    }
+    if (is_unsigned && cond != kCondEQ && cond != kCondNE) {
+      return false;
+    }
+    // Accept SELECT(x cond y, t, f) for vectorizable operands.
+    DCHECK(r != nullptr);
+    DCHECK(s != nullptr);
+    if (generate_code && vector_mode_ != kVector) {  // de-idiom
+      r = opa;
+      s = opb;
+    }
+    HInstruction* opt = select->GetTrueValue();
+    HInstruction* opf = select->GetFalseValue();
+    if (VectorizeUse(node, r, generate_code, type, restrictions) &&
+        VectorizeUse(node, s, generate_code, type, restrictions) &&
+        VectorizeUse(node, opt, generate_code, type, restrictions) &&
+        VectorizeUse(node, opf, generate_code, type, restrictions)) {
+      if (generate_code) {
+        if (vector_map_->find(condition) == vector_map_->end()) {
+          GenerateVecCondition(condition->AsCondition(),
+                               vector_map_->Get(r),
+                               vector_map_->Get(s),
+                               HVecOperation::ToProperType(type, is_unsigned));
+        }
+        GenerateVecSelect(select,
+                          vector_map_->Get(condition),
+                          vector_map_->Get(opt),
+                          vector_map_->Get(opf),
+                          type);
+      }
+      return true;
+    }
+    return false;
   } else if (instruction->IsInvokeStaticOrDirect()) {
     // Accept particular intrinsics.
     HInvokeStaticOrDirect* invoke = instruction->AsInvokeStaticOrDirect();
@@ -1403,6 +2068,21 @@ bool HLoopOptimization::VectorizeUse(LoopNode* node,
         }
         return false;
       }
+      case Intrinsics::kMathSqrt: {
+        // Deal with vector restrictions.
+        HInstruction* opa = instruction->InputAt(0);
+        if (type != DataType::Type::kFloat64 || HasVectorRestrictions(restrictions, kNoSqrt)) {
+          return false;
+        }
+        // Accept SQRT(x) for vectorizable operand.
+        if (VectorizeUse(node, opa, generate_code, type, restrictions)) {
+          if (generate_code) {
+            GenerateVecOp(instruction, vector_map_->Get(opa), nullptr, type);
+          }
+          return true;
+        }
+        return false;
+      }
       case Intrinsics::kMathMinIntInt:
       case Intrinsics::kMathMinLongLong:
       case Intrinsics::kMathMinFloatFloat:
@@ -1447,6 +2127,16 @@ bool HLoopOptimization::VectorizeUse(LoopNode* node,
   return false;
 }
 
+bool HLoopOptimization::SupportsWideVectors() {
+  // AVX-512 targets are vectorized with 256-bit vectors too. The back end has no EVEX
+  // encodings, and on Skylake-SP the 512-bit instructions lower the core frequency for
+  // long enough that short loops run slower than with 256-bit vectors.
+  if (compiler_driver_->GetInstructionSet() == InstructionSet::kX86_64) {
+    return compiler_driver_->GetInstructionSetFeatures()->AsX86InstructionSetFeatures()->HasAVX2();
+  }
+  return false;
+}
+
 uint32_t HLoopOptimization::GetVectorSizeInBytes() {
   switch (compiler_driver_->GetInstructionSet()) {
     case InstructionSet::kArm:
@@ -1464,6 +2154,7 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
     case InstructionSet::kThumb2:
       // Allow vectorization for all ARM devices, because Android assumes that
       // ARM 32-bit always supports advanced SIMD (64-bit SIMD).
+      *restrictions |= kNoSelect | kNoWideningSum | kNoSqrt;
       switch (type) {
         case DataType::Type::kBool:
         case DataType::Type::kUint8:
@@ -1484,6 +2175,7 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
     case InstructionSet::kArm64:
       // Allow vectorization for all ARM devices, because Android assumes that
       // ARMv8 AArch64 always supports advanced SIMD (128-bit SIMD).
+      *restrictions |= kNoSelect | kNoWideningSum | kNoSqrt;
       switch (type) {
         case DataType::Type::kBool:
         case DataType::Type::kUint8:
@@ -1511,6 +2203,40 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
       }
     case InstructionSet::kX86:
     case InstructionSet::kX86_64:
+      // Allow 256-bit vectorization for AVX2-enabled X86-64 devices, restricted to
+      // the operations with a VEX.256 code generator implementation.
+      if (vector_wide_) {
+        DCHECK(SupportsWideVectors());
+        *restrictions |= kNoSelect | kNoWideningSum;
+        switch (type) {
+          case DataType::Type::kBool:
+          case DataType::Type::kUint8:
+          case DataType::Type::kInt8:
+            *restrictions |= kNoMul | kNoDiv | kNoShift | kNoAbs | kNoMinMax |
+                             kNoSignedHAdd | kNoUnroundedHAdd | kNoSAD;
+            return TrySetVectorLength(32);
+          case DataType::Type::kUint16:
+          case DataType::Type::kInt16:
+            *restrictions |= kNoDiv | kNoAbs | kNoMinMax | kNoSignedHAdd | kNoUnroundedHAdd |
+                             kNoStringCharAt | kNoSAD;
+            return TrySetVectorLength(16);
+          case DataType::Type::kInt32:
+            *restrictions |= kNoDiv | kNoAbs | kNoMinMax | kNoSAD;
+            return TrySetVectorLength(8);
+          case DataType::Type::kInt64:
+            *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoMinMax | kNoSAD;
+            return TrySetVectorLength(4);
+          case DataType::Type::kFloat32:
+            *restrictions |= kNoMinMax | kNoReduction;
+            return TrySetVectorLength(8);
+          case DataType::Type::kFloat64:
+            *restrictions |= kNoMinMax | kNoReduction;
+            return TrySetVectorLength(4);
+          default:
+            break;
+        }  // switch type
+        return false;
+      }
       // Allow vectorization for SSE4.1-enabled X86 devices only (128-bit SIMD).
       if (features->AsX86InstructionSetFeatures()->HasSSE4_1()) {
         switch (type) {
@@ -1528,7 +2254,7 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
             *restrictions |= kNoDiv | kNoSAD;
             return TrySetVectorLength(4);
           case DataType::Type::kInt64:
-            *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoMinMax | kNoSAD;
+            *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoMinMax | kNoSAD | kNoSelect;
             return TrySetVectorLength(2);
           case DataType::Type::kFloat32:
             *restrictions |= kNoMinMax | kNoReduction;  // minmax: -0.0 vs +0.0
@@ -1543,6 +2269,7 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
       return false;
     case InstructionSet::kMips:
       if (features->AsMipsInstructionSetFeatures()->HasMsa()) {
+        *restrictions |= kNoSelect | kNoWideningSum | kNoSqrt;
         switch (type) {
           case DataType::Type::kBool:
           case DataType::Type::kUint8:
@@ -1572,6 +2299,7 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
       return false;
     case InstructionSet::kMips64:
       if (features->AsMips64InstructionSetFeatures()->HasMsa()) {
+        *restrictions |= kNoSelect | kNoWideningSum | kNoSqrt;
         switch (type) {
           case DataType::Type::kBool:
           case DataType::Type::kUint8:
@@ -1805,6 +2533,40 @@ HInstruction* HLoopOptimization::ReduceAndExtractIfNeeded(HInstruction* instruct
   return instruction;
 }
 
+void HLoopOptimization::GenerateVecCondition(HCondition* org,
+                                             HInstruction* opa,
+                                             HInstruction* opb,
+                                             DataType::Type type) {
+  HInstruction* vector = nullptr;
+  if (vector_mode_ == kVector) {
+    vector = new (global_allocator_) HVecCondition(
+        global_allocator_, opa, opb, type, vector_length_, org->GetCondition(), org->GetDexPc());
+  } else {
+    // In scalar code, simply clone the comparison with the new operands.
+    DCHECK(vector_mode_ == kSequential);
+    vector = org->Clone(global_allocator_);
+    vector->SetRawInputAt(0, opa);
+    vector->SetRawInputAt(1, opb);
+  }
+  vector_map_->Put(org, vector);
+}
+
+void HLoopOptimization::GenerateVecSelect(HSelect* org,
+                                          HInstruction* opm,
+                                          HInstruction* opt,
+                                          HInstruction* opf,
+                                          DataType::Type type) {
+  HInstruction* vector = nullptr;
+  if (vector_mode_ == kVector) {
+    vector = new (global_allocator_) HVecSelect(
+        global_allocator_, opm, opt, opf, type, vector_length_, org->GetDexPc());
+  } else {
+    DCHECK(vector_mode_ == kSequential);
+    vector = new (global_allocator_) HSelect(opm, opt, opf, org->GetDexPc());
+  }
+  vector_map_->Put(org, vector);
+}
+
 #define GENERATE_VEC(x, y) \
   if (vector_mode_ == kVector) { \
     vector = (x); \
@@ -1895,6 +2657,11 @@ void HLoopOptimization::GenerateVecOp(HInstruction* org,
             vector = new (global_allocator_)
                 HVecAbs(global_allocator_, opa, type, vector_length_, dex_pc);
             break;
+          case Intrinsics::kMathSqrt:
+            DCHECK(opb == nullptr);
+            vector = new (global_allocator_)
+                HVecSqrt(global_allocator_, opa, type, vector_length_, dex_pc);
+            break;
           case Intrinsics::kMathMinIntInt:
           case Intrinsics::kMathMinLongLong:
           case Intrinsics::kMathMinFloatFloat:
@@ -2147,6 +2914,69 @@ bool HLoopOptimization::VectorizeSADIdiom(LoopNode* node,
   return false;
 }
 
+// Method recognizes the following idiom:
+//   q += a for a narrower operand a
+// Provided that the operand is a sign or zero extension of a byte or short value,
+// possibly selected on a condition. Since this involves a vector length change,
+// the idiom is handled by going directly to a sum-accumulate node that widens the
+// packed operands while adding them into the wider accumulator.
+bool HLoopOptimization::VectorizeWideningSumIdiom(LoopNode* node,
+                                                  HInstruction* instruction,
+                                                  bool generate_code,
+                                                  DataType::Type reduction_type,
+                                                  uint64_t restrictions) {
+  // Filter integral "q += a;" reduction into an int accumulator.
+  if (!instruction->IsAdd() || reduction_type != DataType::Type::kInt32) {
+    return false;
+  }
+  HInstruction* q = instruction->InputAt(0);
+  HInstruction* v = instruction->InputAt(1);
+  if (!q->IsPhi()) {
+    std::swap(q, v);
+  }
+  // Pick the narrowest type in which the operand is exact.
+  HInstruction* r = nullptr;
+  bool is_unsigned = false;
+  DataType::Type sub_type = DataType::Type::kInt8;
+  if (!IsNarrowerSumOperand(v, sub_type, &r, &is_unsigned)) {
+    sub_type = DataType::Type::kInt16;
+    if (!IsNarrowerSumOperand(v, sub_type, &r, &is_unsigned)) {
+      return false;
+    }
+  }
+  sub_type = HVecOperation::ToProperType(sub_type, is_unsigned);
+  // Try narrower type and deal with vector restrictions.
+  if (!TrySetVectorType(sub_type, &restrictions) ||
+      HasVectorRestrictions(restrictions, kNoWideningSum)) {
+    return false;
+  }
+  // Accept widening sum idiom for vectorizable operands. Vectorized code uses the
+  // shorthand idiomatic operation. Sequential code uses the original scalar expressions.
+  DCHECK(r != nullptr);
+  if (generate_code && vector_mode_ != kVector) {  // de-idiom
+    r = v;
+  }
+  if (VectorizeUse(node, q, generate_code, sub_type, restrictions) &&
+      VectorizeUse(node, r, generate_code, sub_type, restrictions)) {
+    if (generate_code) {
+      if (vector_mode_ == kVector) {
+        vector_map_->Put(instruction, new (global_allocator_) HVecSumAccumulate(
+            global_allocator_,
+            vector_map_->Get(q),
+            vector_map_->Get(r),
+            reduction_type,
+            GetOtherVL(reduction_type, sub_type, vector_length_),
+            kNoDexPc));
+        MaybeRecordStat(stats_, MethodCompilationStat::kLoopVectorizedIdiom);
+      } else {
+        GenerateVecOp(instruction, vector_map_->Get(q), vector_map_->Get(v), reduction_type);
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
 //
 // Vectorization heuristics.
 //
@@ -2202,43 +3032,16 @@ bool HLoopOptimization::IsVectorizationProfitable(int64_t trip_count) {
     return false;  // guard against non-taken/large
   } else if ((0 < trip_count) && (trip_count < (vector_length_ + max_peel))) {
     return false;  // insufficient iterations
+  } else if (vector_wide_ && (0 < trip_count) &&
+             (trip_count < (kMinWideVectorIterations * vector_length_ + max_peel))) {
+    return false;  // short loop, prefer 128-bit vectors with a shorter cleanup loop
   }
   return true;
 }
 
-static constexpr uint32_t ARM64_SIMD_MAXIMUM_UNROLL_FACTOR = 8;
-static constexpr uint32_t ARM64_SIMD_HEURISTIC_MAX_BODY_SIZE = 50;
-
 uint32_t HLoopOptimization::GetUnrollingFactor(HBasicBlock* block, int64_t trip_count) {
-  uint32_t max_peel = MaxNumberPeeled();
-  switch (compiler_driver_->GetInstructionSet()) {
-    case InstructionSet::kArm64: {
-      // Don't unroll with insufficient iterations.
-      // TODO: Unroll loops with unknown trip count.
-      DCHECK_NE(vector_length_, 0u);
-      if (trip_count < (2 * vector_length_ + max_peel)) {
-        return kNoUnrollingFactor;
-      }
-      // Don't unroll for large loop body size.
-      uint32_t instruction_count = block->GetInstructions().CountSize();
-      if (instruction_count >= ARM64_SIMD_HEURISTIC_MAX_BODY_SIZE) {
-        return kNoUnrollingFactor;
-      }
-      // Find a beneficial unroll factor with the following restrictions:
-      //  - At least one iteration of the transformed loop should be executed.
-      //  - The loop body shouldn't be "too big" (heuristic).
-      uint32_t uf1 = ARM64_SIMD_HEURISTIC_MAX_BODY_SIZE / instruction_count;
-      uint32_t uf2 = (trip_count - max_peel) / vector_length_;
-      uint32_t unroll_factor =
-          TruncToPowerOfTwo(std::min({uf1, uf2, ARM64_SIMD_MAXIMUM_UNROLL_FACTOR}));
-      DCHECK_GE(unroll_factor, 1u);
-      return unroll_factor;
-    }
-    case InstructionSet::kX86:
-    case InstructionSet::kX86_64:
-    default:
-      return kNoUnrollingFactor;
-  }
+  return arch_loop_helper_->GetSIMDUnrollingFactor(
+      block, trip_count, MaxNumberPeeled(), vector_length_);
 }
 
 //
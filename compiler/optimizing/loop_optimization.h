@@ -83,6 +83,9 @@ class HLoopOptimization : public HOptimization {
     kNoReduction     = 1 << 10,  // no reduction
     kNoSAD           = 1 << 11,  // no sum of absolute differences (SAD)
     kNoWideSAD       = 1 << 12,  // no sum of absolute differences (SAD) with operand widening
+    kNoSelect        = 1 << 13,  // no comparison and selection
+    kNoWideningSum   = 1 << 14,  // no sum with operand widening
+    kNoSqrt          = 1 << 15,  // no square root
   };
 
   /*
@@ -130,6 +133,12 @@ class HLoopOptimization : public HOptimization {
   // Returns true if loops nested inside current loop (node) have changed.
   bool TraverseLoopsInnerToOuter(LoopNode* node);
 
+  // Elides the suspend check poll of the loop (node) and of its nested loops when their
+  // known trip counts are small enough that all their iterations, including those of the
+  // nested loops without a poll, fit `budget`. Returns the number of iterations the loop
+  // runs without polling, zero if it polls.
+  int64_t ElideSuspendCheckPolls(LoopNode* node, int64_t budget);
+
   //
   // Optimization.
   //
@@ -137,6 +146,10 @@ class HLoopOptimization : public HOptimization {
   void SimplifyInduction(LoopNode* node);
   void SimplifyBlocks(LoopNode* node);
 
+  // Converts a diamond that is the only control flow in the body of an inner loop
+  // into selects, so that the loop-body can be vectorized. Returns true on success.
+  bool TryIfConversion(LoopNode* node);
+
   // Performs optimizations specific to inner loop (empty loop removal,
   // unrolling, vectorization). Returns true if anything changed.
   bool OptimizeInnerLoop(LoopNode* node);
@@ -144,6 +157,15 @@ class HLoopOptimization : public HOptimization {
   bool TryOptimizeInnerLoopFinite(LoopNode* node);
   
   bool TryFullUnrolling(LoopNode* node);
+
+  // Adds a vector loop in front of an inner loop that exits early on an (in)equality of
+  // array elements, which skips ahead over the vectors of elements that do not exit.
+  // The original loop then finds the exact exit, if any, in the remaining elements.
+  bool TryVectorizeSearchLoop(LoopNode* node);
+
+  // Peels the first iteration of a loop with loop-invariant exits, so that these exits are
+  // known not to be taken in the remaining iterations.
+  bool TryPeelingForLoopInvariantExitsElimination(LoopNode* node);
   
   bool TryInductionVarSimplification(LoopNode* node);
 
@@ -152,6 +174,8 @@ class HLoopOptimization : public HOptimization {
   //
 
   bool ShouldVectorize(LoopNode* node, HBasicBlock* block, int64_t trip_count);
+  bool ShouldVectorizeWithCurrentWidth(LoopNode* node, HBasicBlock* block, int64_t trip_count);
+  bool SupportsWideVectors();
   void Vectorize(LoopNode* node, HBasicBlock* block, HBasicBlock* exit, int64_t trip_count);
   void GenerateNewLoop(LoopNode* node,
                        HBasicBlock* block,
@@ -179,6 +203,15 @@ class HLoopOptimization : public HOptimization {
   void GenerateVecReductionPhi(HPhi* phi);
   void GenerateVecReductionPhiInputs(HPhi* phi, HInstruction* reduction);
   HInstruction* ReduceAndExtractIfNeeded(HInstruction* instruction);
+  void GenerateVecCondition(HCondition* org,
+                            HInstruction* opa,
+                            HInstruction* opb,
+                            DataType::Type type);
+  void GenerateVecSelect(HSelect* org,
+                         HInstruction* opm,
+                         HInstruction* opt,
+                         HInstruction* opf,
+                         DataType::Type type);
   void GenerateVecOp(HInstruction* org,
                      HInstruction* opa,
                      HInstruction* opb,
@@ -196,6 +229,11 @@ class HLoopOptimization : public HOptimization {
                          bool generate_code,
                          DataType::Type type,
                          uint64_t restrictions);
+  bool VectorizeWideningSumIdiom(LoopNode* node,
+                                 HInstruction* instruction,
+                                 bool generate_code,
+                                 DataType::Type type,
+                                 uint64_t restrictions);
 
   // Vectorization heuristics.
   Alignment ComputeAlignment(HInstruction* offset,
@@ -239,6 +277,9 @@ class HLoopOptimization : public HOptimization {
   // Compiler driver (to query ISA features).
   const CompilerDriver* compiler_driver_;
 
+  // Target-dependent heuristics of the loop unrolling and peeling.
+  const ArchLoopHelper* arch_loop_helper_;
+
   // Range information based on prior induction variable analysis.
   InductionVarRange induction_range_;
 
@@ -274,6 +315,13 @@ class HLoopOptimization : public HOptimization {
   // Number of "lanes" for selected packed type.
   uint32_t vector_length_;
 
+  // Flag that tracks if the current vectorization attempt uses 256-bit vectors.
+  bool vector_wide_;
+
+  // Number of "lanes" of the narrower vector epilogue loop that runs the
+  // remainder iterations of the vector loop, or 0 if there is none.
+  uint32_t vector_epilogue_length_;
+
   // Set of array references in the vector loop.
   // Contents reside in phase-local heap memory.
   ScopedArenaSet<ArrayReference>* vector_refs_;
@@ -282,9 +330,12 @@ class HLoopOptimization : public HOptimization {
   uint32_t vector_static_peeling_factor_;
   const ArrayReference* vector_dynamic_peeling_candidate_;
 
-  // Dynamic data dependence test of the form a != b.
-  HInstruction* vector_runtime_test_a_;
-  HInstruction* vector_runtime_test_b_;
+  // Dynamic data dependence tests of the form a != b, which must all hold for the
+  // vector loop to run.
+  static constexpr size_t kMaxNumberOfRuntimeTests = 3;
+  HInstruction* vector_runtime_test_a_[kMaxNumberOfRuntimeTests];
+  HInstruction* vector_runtime_test_b_[kMaxNumberOfRuntimeTests];
+  size_t vector_num_runtime_tests_;
 
   // Mapping used during vectorization synthesis for both the scalar peeling/cleanup
   // loop (mode is kSequential) and the actual vector loop (mode is kVector). The data
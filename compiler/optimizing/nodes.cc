@@ -880,6 +880,10 @@ HBasicBlock* HLoopInformation::GetPreHeader() const {
   return block;
 }
 
+bool HLoopInformation::HasSuspendCheckPoll() const {
+  return HasSuspendCheck() && !GetSuspendCheck()->IsPollElided();
+}
+
 bool HLoopInformation::Contains(const HBasicBlock& block) const {
   return blocks_.IsBitSet(block.GetBlockId());
 }
@@ -2738,6 +2742,75 @@ HBasicBlock* HGraph::TransformLoopForVectorization(HBasicBlock* header,
   return new_pre_header;
 }
 
+/*
+ * Loop will be transformed to:
+ *       old_pre_header
+ *             |
+ *        new_header <---
+ *           /    \      |
+ *  new_pre_header new_body
+ *             |
+ *           header
+ */
+HBasicBlock* HGraph::TransformLoopForSkipAhead(HBasicBlock* header) {
+  DCHECK(header->IsLoopHeader());
+  HLoopInformation* loop = header->GetLoopInformation();
+  HBasicBlock* old_pre_header = loop->GetPreHeader();
+
+  // Add new loop blocks.
+  HBasicBlock* new_header = new (allocator_) HBasicBlock(this, header->GetDexPc());
+  HBasicBlock* new_body = new (allocator_) HBasicBlock(this, header->GetDexPc());
+  HBasicBlock* new_pre_header = new (allocator_) HBasicBlock(this, header->GetDexPc());
+  AddBlock(new_header);
+  AddBlock(new_body);
+  AddBlock(new_pre_header);
+
+  // Set up control flow, keeping the predecessor index of the old preheader.
+  header->ReplacePredecessor(old_pre_header, new_pre_header);
+  old_pre_header->AddSuccessor(new_header);
+  new_header->AddSuccessor(new_pre_header);
+  new_header->AddSuccessor(new_body);
+  new_body->AddSuccessor(new_header);
+
+  // Set up dominators.
+  old_pre_header->ReplaceDominatedBlock(header, new_header);
+  new_header->SetDominator(old_pre_header);
+  new_header->dominated_blocks_.push_back(new_body);
+  new_body->SetDominator(new_header);
+  new_header->dominated_blocks_.push_back(new_pre_header);
+  new_pre_header->SetDominator(new_header);
+  new_pre_header->dominated_blocks_.push_back(header);
+  header->SetDominator(new_pre_header);
+
+  // Fix reverse post order.
+  size_t index_of_header = IndexOfElement(reverse_post_order_, header);
+  MakeRoomFor(&reverse_post_order_, 3, index_of_header - 1);
+  reverse_post_order_[index_of_header++] = new_header;
+  reverse_post_order_[index_of_header++] = new_body;
+  reverse_post_order_[index_of_header++] = new_pre_header;
+
+  // Add gotos and suspend check (client must add conditional in header).
+  HSuspendCheck* suspend_check = new (allocator_) HSuspendCheck(header->GetDexPc());
+  new_header->AddInstruction(suspend_check);
+  new_body->AddInstruction(new (allocator_) HGoto());
+  new_pre_header->AddInstruction(new (allocator_) HGoto());
+  suspend_check->CopyEnvironmentFromWithLoopPhiAdjustment(
+      loop->GetSuspendCheck()->GetEnvironment(), header);
+
+  // Update loop information.
+  new_header->AddBackEdge(new_body);
+  new_header->GetLoopInformation()->SetSuspendCheck(suspend_check);
+  new_header->GetLoopInformation()->Populate();
+  UpdateLoopAndTryInformationOfNewBlock(
+      new_pre_header, old_pre_header, /* replace_if_back_edge */ false);
+  HLoopInformationOutwardIterator it(*new_header);
+  for (it.Advance(); !it.Done(); it.Advance()) {
+    it.Current()->Add(new_header);
+    it.Current()->Add(new_body);
+  }
+  return new_header;
+}
+
 static void CheckAgainstUpperBound(ReferenceTypeInfo rti, ReferenceTypeInfo upper_bound_rti)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   if (rti.IsValid()) {
@@ -2924,9 +2997,14 @@ bool HLoadClass::InstructionDataEquals(const HInstruction* other) const {
     return false;
   }
   switch (GetLoadKind()) {
+    case LoadKind::kJitTableAddress:
+      if (IsJitBssEntry()) {
+        // The class is not resolved yet, compare the type references.
+        return IsSameDexFile(GetDexFile(), other_load_class->GetDexFile());
+      }
+      FALLTHROUGH_INTENDED;
     case LoadKind::kBootImageAddress:
-    case LoadKind::kBootImageClassTable:
-    case LoadKind::kJitTableAddress: {
+    case LoadKind::kBootImageClassTable: {
       ScopedObjectAccess soa(Thread::Current());
       return GetClass().Get() == other_load_class->GetClass().Get();
     }
@@ -2967,9 +3045,14 @@ bool HLoadString::InstructionDataEquals(const HInstruction* other) const {
     return false;
   }
   switch (GetLoadKind()) {
+    case LoadKind::kJitTableAddress:
+      if (IsJitBssEntry()) {
+        // There is no string yet, compare the string references.
+        return IsSameDexFile(GetDexFile(), other_load_string->GetDexFile());
+      }
+      FALLTHROUGH_INTENDED;
     case LoadKind::kBootImageAddress:
-    case LoadKind::kBootImageInternTable:
-    case LoadKind::kJitTableAddress: {
+    case LoadKind::kBootImageInternTable: {
       ScopedObjectAccess soa(Thread::Current());
       return GetString().Get() == other_load_string->GetString().Get();
     }
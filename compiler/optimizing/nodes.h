@@ -315,6 +315,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
          InvokeType invoke_type = kInvalidInvokeType,
          bool debuggable = false,
          bool osr = false,
+         bool baseline = false,
          int start_instruction_id = 0)
       : allocator_(allocator),
         arena_stack_(arena_stack),
@@ -330,6 +331,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         has_bounds_checks_(false),
         has_try_catch_(false),
         has_simd_(false),
+        has_wide_simd_(false),
         has_loops_(false),
         has_irreducible_loops_(false),
         debuggable_(debuggable),
@@ -350,6 +352,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         art_method_(nullptr),
         inexact_object_rti_(ReferenceTypeInfo::CreateInvalid()),
         osr_(osr),
+        baseline_(baseline),
         cha_single_implementation_list_(allocator->Adapter(kArenaAllocCHA)) {
     blocks_.reserve(kDefaultNumberOfBlocks);
   }
@@ -413,6 +416,10 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
                                              HBasicBlock* body,
                                              HBasicBlock* exit);
 
+  // Adds a new loop directly before the loop with the given header, which gets
+  // a new preheader. Returns the header of the new loop.
+  HBasicBlock* TransformLoopForSkipAhead(HBasicBlock* header);
+
   // Removes `block` from the graph. Assumes `block` has been disconnected from
   // other blocks and has no instructions or phis.
   void DeleteDeadEmptyBlock(HBasicBlock* block);
@@ -574,6 +581,8 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
 
   bool IsCompilingOsr() const { return osr_; }
 
+  bool IsCompilingBaseline() const { return baseline_; }
+
   ArenaSet<ArtMethod*>& GetCHASingleImplementationList() {
     return cha_single_implementation_list_;
   }
@@ -592,6 +601,9 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   bool HasSIMD() const { return has_simd_; }
   void SetHasSIMD(bool value) { has_simd_ = value; }
 
+  bool HasWideSIMD() const { return has_wide_simd_; }
+  void SetHasWideSIMD(bool value) { has_wide_simd_ = value; }
+
   bool HasLoops() const { return has_loops_; }
   void SetHasLoops(bool value) { has_loops_ = value; }
 
@@ -693,6 +705,10 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // contents of SIMD registers.
   bool has_simd_;
 
+  // Flag whether 256-bit SIMD instructions appear in the graph. Implies `has_simd_`.
+  // If true, every SIMD value is treated as 32 bytes wide for spilling and moves.
+  bool has_wide_simd_;
+
   // Flag whether there are any loops in the graph. We can skip loop
   // optimization if it's false. It's only best effort to keep it up
   // to date in the presence of code elimination so there might be false
@@ -758,6 +774,11 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // compiled code entries which the interpreter can directly jump to.
   const bool osr_;
 
+  // Whether we are compiling baseline code for the JIT: this skips most of the optimizations
+  // and makes the code count its invocations, so that the method gets recompiled with all
+  // the optimizations once it is hot.
+  const bool baseline_;
+
   // List of methods that are assumed to have single implementation.
   ArenaSet<ArtMethod*> cha_single_implementation_list_;
 
@@ -800,6 +821,9 @@ class HLoopInformation : public ArenaObject<kArenaAllocLoopInfo> {
   HSuspendCheck* GetSuspendCheck() const { return suspend_check_; }
   void SetSuspendCheck(HSuspendCheck* check) { suspend_check_ = check; }
   bool HasSuspendCheck() const { return suspend_check_ != nullptr; }
+  // Whether the back edges poll for suspension, which is not the case when the loop has
+  // so few iterations that HLoopOptimization elided the poll of its suspend check.
+  bool HasSuspendCheckPoll() const;
 
   void AddBackEdge(HBasicBlock* back_edge) {
     back_edges_.push_back(back_edge);
@@ -1429,9 +1453,11 @@ class HLoopInformationOutwardIterator : public ValueObject {
   M(VecReplicateScalar, VecUnaryOperation)                              \
   M(VecExtractScalar, VecUnaryOperation)                                \
   M(VecReduce, VecUnaryOperation)                                       \
+  M(VecAnyTrue, VecUnaryOperation)                                      \
   M(VecCnv, VecUnaryOperation)                                          \
   M(VecNeg, VecUnaryOperation)                                          \
   M(VecAbs, VecUnaryOperation)                                          \
+  M(VecSqrt, VecUnaryOperation)                                         \
   M(VecNot, VecUnaryOperation)                                          \
   M(VecAdd, VecBinaryOperation)                                         \
   M(VecHalvingAdd, VecBinaryOperation)                                  \
@@ -1447,9 +1473,12 @@ class HLoopInformationOutwardIterator : public ValueObject {
   M(VecShl, VecBinaryOperation)                                         \
   M(VecShr, VecBinaryOperation)                                         \
   M(VecUShr, VecBinaryOperation)                                        \
+  M(VecCondition, VecBinaryOperation)                                   \
   M(VecSetScalars, VecOperation)                                        \
   M(VecMultiplyAccumulate, VecOperation)                                \
   M(VecSADAccumulate, VecOperation)                                     \
+  M(VecSumAccumulate, VecOperation)                                     \
+  M(VecSelect, VecOperation)                                            \
   M(VecLoad, VecMemoryOperation)                                        \
   M(VecStore, VecMemoryOperation)                                       \
 
@@ -5625,6 +5654,14 @@ class HInstanceFieldGet FINAL : public HExpression<1> {
   DataType::Type GetFieldType() const { return field_info_.GetFieldType(); }
   bool IsVolatile() const { return field_info_.IsVolatile(); }
 
+  // Whether the loaded reference is known to be a to-space reference, which
+  // does not need a read barrier (see ReadBarrierElimination).
+  bool IsReadBarrierFree() const { return GetPackedFlag<kFlagIsReadBarrierFree>(); }
+  void SetReadBarrierFree() {
+    DCHECK_EQ(GetType(), DataType::Type::kReference);
+    SetPackedFlag<kFlagIsReadBarrierFree>(true);
+  }
+
   void SetType(DataType::Type new_type) {
     DCHECK(DataType::IsIntegralType(GetType()));
     DCHECK(DataType::IsIntegralType(new_type));
@@ -5638,6 +5675,11 @@ class HInstanceFieldGet FINAL : public HExpression<1> {
   DEFAULT_COPY_CONSTRUCTOR(InstanceFieldGet);
 
  private:
+  static constexpr size_t kFlagIsReadBarrierFree = kNumberOfExpressionPackedBits;
+  static constexpr size_t kNumberOfInstanceFieldGetPackedBits = kFlagIsReadBarrierFree + 1;
+  static_assert(kNumberOfInstanceFieldGetPackedBits <= HInstruction::kMaxNumberOfPackedBits,
+                "Too many packed fields.");
+
   const FieldInfo field_info_;
 };
 
@@ -5760,6 +5802,14 @@ class HArrayGet FINAL : public HExpression<2> {
 
   bool IsStringCharAt() const { return GetPackedFlag<kFlagIsStringCharAt>(); }
 
+  // Whether the loaded reference is known to be a to-space reference, which
+  // does not need a read barrier (see ReadBarrierElimination).
+  bool IsReadBarrierFree() const { return GetPackedFlag<kFlagIsReadBarrierFree>(); }
+  void SetReadBarrierFree() {
+    DCHECK_EQ(GetType(), DataType::Type::kReference);
+    SetPackedFlag<kFlagIsReadBarrierFree>(true);
+  }
+
   HInstruction* GetArray() const { return InputAt(0); }
   HInstruction* GetIndex() const { return InputAt(1); }
 
@@ -5782,7 +5832,8 @@ class HArrayGet FINAL : public HExpression<2> {
   // of the input but that requires holding the mutator lock, so we prefer to use
   // a flag, so that code generators don't need to do the locking.
   static constexpr size_t kFlagIsStringCharAt = kNumberOfExpressionPackedBits;
-  static constexpr size_t kNumberOfArrayGetPackedBits = kFlagIsStringCharAt + 1;
+  static constexpr size_t kFlagIsReadBarrierFree = kFlagIsStringCharAt + 1;
+  static constexpr size_t kNumberOfArrayGetPackedBits = kFlagIsReadBarrierFree + 1;
   static_assert(kNumberOfArrayGetPackedBits <= HInstruction::kMaxNumberOfPackedBits,
                 "Too many packed fields.");
 };
@@ -5998,12 +6049,22 @@ class HSuspendCheck FINAL : public HTemplateInstruction<0> {
   void SetSlowPath(SlowPathCode* slow_path) { slow_path_ = slow_path; }
   SlowPathCode* GetSlowPath() const { return slow_path_; }
 
+  // Whether the back edges of the loop of this suspend check do not poll for suspension.
+  // The suspend check is kept for its environment.
+  bool IsPollElided() const { return GetPackedFlag<kFlagIsPollElided>(); }
+  void SetPollElided() { SetPackedFlag<kFlagIsPollElided>(true); }
+
   DECLARE_INSTRUCTION(SuspendCheck);
 
  protected:
   DEFAULT_COPY_CONSTRUCTOR(SuspendCheck);
 
  private:
+  static constexpr size_t kFlagIsPollElided = kNumberOfGenericPackedBits;
+  static constexpr size_t kNumberOfSuspendCheckPackedBits = kFlagIsPollElided + 1;
+  static_assert(kNumberOfSuspendCheckPackedBits <= HInstruction::kMaxNumberOfPackedBits,
+                "Too many packed fields.");
+
   // Only used for code generation, in order to share the same slow path between back edges
   // of a same loop.
   SlowPathCode* slow_path_;
@@ -6057,6 +6118,7 @@ class HLoadClass FINAL : public HInstruction {
     kBssEntry,
 
     // Load from the root table associated with the JIT compiled method.
+    // See also IsJitBssEntry().
     kJitTableAddress,
 
     // Load using a simple runtime call. This is the fall-back load kind when
@@ -6088,6 +6150,7 @@ class HLoadClass FINAL : public HInstruction {
     SetPackedFlag<kFlagNeedsAccessCheck>(needs_access_check);
     SetPackedFlag<kFlagIsInBootImage>(false);
     SetPackedFlag<kFlagGenerateClInitCheck>(false);
+    SetPackedFlag<kFlagIsJitBssEntry>(false);
   }
 
   bool IsClonable() const OVERRIDE { return true; }
@@ -6121,7 +6184,8 @@ class HLoadClass FINAL : public HInstruction {
     return NeedsAccessCheck() ||
            MustGenerateClinitCheck() ||
            GetLoadKind() == LoadKind::kRuntimeCall ||
-           GetLoadKind() == LoadKind::kBssEntry;
+           GetLoadKind() == LoadKind::kBssEntry ||
+           IsJitBssEntry();
   }
 
   bool CanThrow() const OVERRIDE {
@@ -6131,7 +6195,8 @@ class HLoadClass FINAL : public HInstruction {
            // This keeps CanThrow() consistent between non-PIC (using kBootImageAddress) and
            // PIC and subsequently avoids a DCE behavior dependency on the PIC option.
            ((GetLoadKind() == LoadKind::kRuntimeCall ||
-             GetLoadKind() == LoadKind::kBssEntry) &&
+             GetLoadKind() == LoadKind::kBssEntry ||
+             IsJitBssEntry()) &&
             !IsInBootImage());
   }
 
@@ -6161,10 +6226,22 @@ class HLoadClass FINAL : public HInstruction {
   bool IsInBootImage() const { return GetPackedFlag<kFlagIsInBootImage>(); }
   bool MustGenerateClinitCheck() const { return GetPackedFlag<kFlagGenerateClInitCheck>(); }
 
+  // Whether the JIT root table entry of a kJitTableAddress load is null until the class
+  // is resolved by the slow path, like a kBssEntry.
+  bool IsJitBssEntry() const {
+    return GetLoadKind() == LoadKind::kJitTableAddress && GetPackedFlag<kFlagIsJitBssEntry>();
+  }
+
   void MarkInBootImage() {
     SetPackedFlag<kFlagIsInBootImage>(true);
   }
 
+  // Must be called before SetLoadKind(), which computes the side effects.
+  void MarkJitBssEntry() {
+    DCHECK(GetBlock() == nullptr);
+    SetPackedFlag<kFlagIsJitBssEntry>(true);
+  }
+
   void AddSpecialInput(HInstruction* special_input);
 
   using HInstruction::GetInputRecords;  // Keep the const version visible.
@@ -6192,7 +6269,8 @@ class HLoadClass FINAL : public HInstruction {
   // Whether this instruction must generate the initialization check.
   // Used for code generation.
   static constexpr size_t kFlagGenerateClInitCheck = kFlagIsInBootImage + 1;
-  static constexpr size_t kFieldLoadKind           = kFlagGenerateClInitCheck + 1;
+  static constexpr size_t kFlagIsJitBssEntry       = kFlagGenerateClInitCheck + 1;
+  static constexpr size_t kFieldLoadKind           = kFlagIsJitBssEntry + 1;
   static constexpr size_t kFieldLoadKindSize =
       MinimumBitsToStore(static_cast<size_t>(LoadKind::kLast));
   static constexpr size_t kNumberOfLoadClassPackedBits = kFieldLoadKind + kFieldLoadKindSize;
@@ -6294,6 +6372,7 @@ class HLoadString FINAL : public HInstruction {
         string_index_(string_index),
         dex_file_(dex_file) {
     SetPackedField<LoadKindField>(LoadKind::kRuntimeCall);
+    SetPackedFlag<kFlagIsJitBssEntry>(false);
   }
 
   bool IsClonable() const OVERRIDE { return true; }
@@ -6320,6 +6399,18 @@ class HLoadString FINAL : public HInstruction {
     string_ = str;
   }
 
+  // Whether the JIT root table entry of a kJitTableAddress load is null until the string
+  // is resolved by the slow path, like a kBssEntry. There is no string then.
+  bool IsJitBssEntry() const {
+    return GetLoadKind() == LoadKind::kJitTableAddress && GetPackedFlag<kFlagIsJitBssEntry>();
+  }
+
+  // Must be called before SetLoadKind(), which computes the side effects.
+  void MarkJitBssEntry() {
+    DCHECK(GetBlock() == nullptr);
+    SetPackedFlag<kFlagIsJitBssEntry>(true);
+  }
+
   bool CanBeMoved() const OVERRIDE { return true; }
 
   bool InstructionDataEquals(const HInstruction* other) const OVERRIDE;
@@ -6333,7 +6424,7 @@ class HLoadString FINAL : public HInstruction {
     if (load_kind == LoadKind::kBootImageLinkTimePcRelative ||
         load_kind == LoadKind::kBootImageAddress ||
         load_kind == LoadKind::kBootImageInternTable ||
-        load_kind == LoadKind::kJitTableAddress) {
+        (load_kind == LoadKind::kJitTableAddress && !IsJitBssEntry())) {
       return false;
     }
     return true;
@@ -6368,7 +6459,8 @@ class HLoadString FINAL : public HInstruction {
   DEFAULT_COPY_CONSTRUCTOR(LoadString);
 
  private:
-  static constexpr size_t kFieldLoadKind = kNumberOfGenericPackedBits;
+  static constexpr size_t kFlagIsJitBssEntry = kNumberOfGenericPackedBits;
+  static constexpr size_t kFieldLoadKind = kFlagIsJitBssEntry + 1;
   static constexpr size_t kFieldLoadKindSize =
       MinimumBitsToStore(static_cast<size_t>(LoadKind::kLast));
   static constexpr size_t kNumberOfLoadStringPackedBits = kFieldLoadKind + kFieldLoadKindSize;
@@ -416,6 +416,33 @@ class HVecReduce FINAL : public HVecUnaryOperation {
   const ReductionKind kind_;
 };
 
+// Tests whether any component of the given mask vector is set,
+// viz. any[ m1, .. , mn ] = m1 || .. || mn, as a scalar boolean.
+class HVecAnyTrue FINAL : public HVecUnaryOperation {
+ public:
+  HVecAnyTrue(ArenaAllocator* allocator,
+              HInstruction* input,
+              DataType::Type packed_type,
+              size_t vector_length,
+              uint32_t dex_pc)
+      : HVecUnaryOperation(kVecAnyTrue, allocator, input, packed_type, vector_length, dex_pc) {
+    DCHECK(input->IsVecCondition());
+    DCHECK(HasConsistentPackedTypes(input, packed_type));
+  }
+
+  // Yields a scalar boolean.
+  DataType::Type GetType() const OVERRIDE {
+    return DataType::Type::kBool;
+  }
+
+  bool CanBeMoved() const OVERRIDE { return true; }
+
+  DECLARE_INSTRUCTION(VecAnyTrue);
+
+ protected:
+  DEFAULT_COPY_CONSTRUCTOR(VecAnyTrue);
+};
+
 // Converts every component in the vector,
 // viz. cnv[ x1, .. , xn ]  = [ cnv(x1), .. , cnv(xn) ].
 class HVecCnv FINAL : public HVecUnaryOperation {
@@ -484,6 +511,29 @@ class HVecAbs FINAL : public HVecUnaryOperation {
   DEFAULT_COPY_CONSTRUCTOR(VecAbs);
 };
 
+// Takes the square root of every component in the vector,
+// viz. sqrt[ x1, .. , xn ]  = [ sqrt(x1), .. , sqrt(xn) ]
+// for floating-point operand x.
+class HVecSqrt FINAL : public HVecUnaryOperation {
+ public:
+  HVecSqrt(ArenaAllocator* allocator,
+           HInstruction* input,
+           DataType::Type packed_type,
+           size_t vector_length,
+           uint32_t dex_pc)
+      : HVecUnaryOperation(kVecSqrt, allocator, input, packed_type, vector_length, dex_pc) {
+    DCHECK(HasConsistentPackedTypes(input, packed_type));
+    DCHECK(DataType::IsFloatingPointType(packed_type));
+  }
+
+  bool CanBeMoved() const OVERRIDE { return true; }
+
+  DECLARE_INSTRUCTION(VecSqrt);
+
+ protected:
+  DEFAULT_COPY_CONSTRUCTOR(VecSqrt);
+};
+
 // Bitwise- or boolean-nots every component in the vector,
 // viz. not[ x1, .. , xn ]  = [ ~x1, .. , ~xn ], or
 //      not[ x1, .. , xn ]  = [ !x1, .. , !xn ] for boolean.
@@ -847,6 +897,46 @@ class HVecUShr FINAL : public HVecBinaryOperation {
   DEFAULT_COPY_CONSTRUCTOR(VecUShr);
 };
 
+// Compares every component in the two vectors, yielding a mask with all bits set in the
+// components for which the condition holds and all bits cleared in the other components,
+// viz. [ x1, .. , xn ] cond [ y1, .. , yn ] = [ x1 cond y1 ? -1 : 0, .. , xn cond yn ? -1 : 0 ]
+// for either both signed or both unsigned operands x, y (reflected in packed_type).
+class HVecCondition FINAL : public HVecBinaryOperation {
+ public:
+  HVecCondition(ArenaAllocator* allocator,
+                HInstruction* left,
+                HInstruction* right,
+                DataType::Type packed_type,
+                size_t vector_length,
+                IfCondition condition,
+                uint32_t dex_pc)
+      : HVecBinaryOperation(
+            kVecCondition, allocator, left, right, packed_type, vector_length, dex_pc),
+        condition_(condition) {
+    DCHECK(HasConsistentPackedTypes(left, packed_type));
+    DCHECK(HasConsistentPackedTypes(right, packed_type));
+    DCHECK(condition >= kCondEQ && condition <= kCondGE);
+  }
+
+  IfCondition GetCondition() const { return condition_; }
+
+  bool CanBeMoved() const OVERRIDE { return true; }
+
+  bool InstructionDataEquals(const HInstruction* other) const OVERRIDE {
+    DCHECK(other->IsVecCondition());
+    const HVecCondition* o = other->AsVecCondition();
+    return HVecOperation::InstructionDataEquals(o) && GetCondition() == o->GetCondition();
+  }
+
+  DECLARE_INSTRUCTION(VecCondition);
+
+ protected:
+  DEFAULT_COPY_CONSTRUCTOR(VecCondition);
+
+ private:
+  const IfCondition condition_;
+};
+
 //
 // Definitions of concrete miscellaneous vector operations in HIR.
 //
@@ -971,6 +1061,81 @@ class HVecSADAccumulate FINAL : public HVecOperation {
   DEFAULT_COPY_CONSTRUCTOR(VecSADAccumulate);
 };
 
+// Adds the components of a vector to wider-precision components in the accumulator,
+// viz. SUM([ a1, .. , am ], [ x1, .. , xn ]) = [ a1 + sum xi, .. , am + sum xj ],
+//      for m < n, non-overlapping sums, and either signed or unsigned operand x.
+class HVecSumAccumulate FINAL : public HVecOperation {
+ public:
+  HVecSumAccumulate(ArenaAllocator* allocator,
+                    HInstruction* accumulator,
+                    HInstruction* sum_operand,
+                    DataType::Type packed_type,
+                    size_t vector_length,
+                    uint32_t dex_pc)
+      : HVecOperation(kVecSumAccumulate,
+                      allocator,
+                      packed_type,
+                      SideEffects::None(),
+                      /* number_of_inputs */ 2,
+                      vector_length,
+                      dex_pc) {
+    DCHECK(HasConsistentPackedTypes(accumulator, packed_type));
+    DCHECK(sum_operand->IsVecOperation());
+    DCHECK_LT(DataType::Size(sum_operand->AsVecOperation()->GetPackedType()),
+              DataType::Size(packed_type));
+    SetRawInputAt(0, accumulator);
+    SetRawInputAt(1, sum_operand);
+  }
+
+  DECLARE_INSTRUCTION(VecSumAccumulate);
+
+ protected:
+  DEFAULT_COPY_CONSTRUCTOR(VecSumAccumulate);
+};
+
+// Selects, for every component, the component of the first vector where the mask
+// has all bits set and the component of the second vector where it has all bits cleared,
+// viz. SELECT([ m1, .. , mn ], [ x1, .. , xn ], [ y1, .. , yn ]) =
+//          [ m1 ? x1 : y1, .. , mn ? xn : yn ].
+// As for the scalar select, the false vector is the first input.
+class HVecSelect FINAL : public HVecOperation {
+ public:
+  HVecSelect(ArenaAllocator* allocator,
+             HInstruction* mask,
+             HInstruction* true_value,
+             HInstruction* false_value,
+             DataType::Type packed_type,
+             size_t vector_length,
+             uint32_t dex_pc)
+      : HVecOperation(kVecSelect,
+                      allocator,
+                      packed_type,
+                      SideEffects::None(),
+                      /* number_of_inputs */ 3,
+                      vector_length,
+                      dex_pc) {
+    DCHECK(mask->IsVecCondition());
+    DCHECK_EQ(DataType::Size(mask->AsVecOperation()->GetPackedType()),
+              DataType::Size(packed_type));
+    DCHECK(HasConsistentPackedTypes(true_value, packed_type));
+    DCHECK(HasConsistentPackedTypes(false_value, packed_type));
+    SetRawInputAt(0, false_value);
+    SetRawInputAt(1, true_value);
+    SetRawInputAt(2, mask);
+  }
+
+  HInstruction* GetFalseValue() const { return InputAt(0); }
+  HInstruction* GetTrueValue() const { return InputAt(1); }
+  HInstruction* GetMask() const { return InputAt(2); }
+
+  bool CanBeMoved() const OVERRIDE { return true; }
+
+  DECLARE_INSTRUCTION(VecSelect);
+
+ protected:
+  DEFAULT_COPY_CONSTRUCTOR(VecSelect);
+};
+
 // Loads a vector from memory, viz. load(mem, 1)
 // yield the vector [ mem(1), .. , mem(n) ].
 class HVecLoad FINAL : public HVecMemoryOperation {
@@ -53,7 +53,11 @@
 #include "licm.h"
 #include "load_store_analysis.h"
 #include "load_store_elimination.h"
+#include "loop_nest_optimization.h"
 #include "loop_optimization.h"
+#include "partial_escape.h"
+#include "partial_redundancy_elimination.h"
+#include "read_barrier_elimination.h"
 #include "scheduler.h"
 #include "select_generator.h"
 #include "sharpening.h"
@@ -76,6 +80,8 @@ const char* OptimizationPassName(OptimizationPass pass) {
       return GVNOptimization::kGlobalValueNumberingPassName;
     case OptimizationPass::kInvariantCodeMotion:
       return LICM::kLoopInvariantCodeMotionPassName;
+    case OptimizationPass::kLoopNestOptimization:
+      return HLoopNestOptimization::kLoopNestOptimizationPassName;
     case OptimizationPass::kLoopOptimization:
       return HLoopOptimization::kLoopOptimizationPassName;
     case OptimizationPass::kBoundsCheckElimination:
@@ -100,6 +106,12 @@ const char* OptimizationPassName(OptimizationPass pass) {
       return CHAGuardOptimization::kCHAGuardOptimizationPassName;
     case OptimizationPass::kCodeSinking:
       return CodeSinking::kCodeSinkingPassName;
+    case OptimizationPass::kPartialEscapeMaterialization:
+      return PartialEscapeMaterialization::kPartialEscapeMaterializationPassName;
+    case OptimizationPass::kPartialRedundancyElimination:
+      return PartialRedundancyElimination::kPartialRedundancyEliminationPassName;
+    case OptimizationPass::kReadBarrierElimination:
+      return ReadBarrierElimination::kReadBarrierEliminationPassName;
     case OptimizationPass::kConstructorFenceRedundancyElimination:
       return ConstructorFenceRedundancyElimination::kCFREPassName;
     case OptimizationPass::kScheduling:
@@ -154,7 +166,11 @@ OptimizationPass OptimizationPassByName(const std::string& name) {
   X(OptimizationPass::kInvariantCodeMotion);
   X(OptimizationPass::kLoadStoreAnalysis);
   X(OptimizationPass::kLoadStoreElimination);
+  X(OptimizationPass::kLoopNestOptimization);
   X(OptimizationPass::kLoopOptimization);
+  X(OptimizationPass::kPartialEscapeMaterialization);
+  X(OptimizationPass::kPartialRedundancyElimination);
+  X(OptimizationPass::kReadBarrierElimination);
   X(OptimizationPass::kScheduling);
   X(OptimizationPass::kSelectGenerator);
   X(OptimizationPass::kSharpening);
@@ -232,6 +248,11 @@ ArenaVector<HOptimization*> ConstructOptimizations(
         CHECK(most_recent_side_effects != nullptr);
         opt = new (allocator) LICM(graph, *most_recent_side_effects, stats, name);
         break;
+      case OptimizationPass::kLoopNestOptimization:
+        CHECK(most_recent_induction != nullptr);
+        opt = new (allocator) HLoopNestOptimization(
+            graph, driver, most_recent_induction, stats, name);
+        break;
       case OptimizationPass::kLoopOptimization:
         CHECK(most_recent_induction != nullptr);
         opt = new (allocator) HLoopOptimization(graph, driver, most_recent_induction, stats, name);
@@ -239,7 +260,7 @@ ArenaVector<HOptimization*> ConstructOptimizations(
       case OptimizationPass::kBoundsCheckElimination:
         CHECK(most_recent_side_effects != nullptr && most_recent_induction != nullptr);
         opt = new (allocator) BoundsCheckElimination(
-            graph, *most_recent_side_effects, most_recent_induction, name);
+            graph, *most_recent_side_effects, most_recent_induction, most_recent_lsa, name);
         break;
       case OptimizationPass::kLoadStoreElimination:
         CHECK(most_recent_side_effects != nullptr && most_recent_induction != nullptr);
@@ -291,6 +312,15 @@ ArenaVector<HOptimization*> ConstructOptimizations(
       case OptimizationPass::kCodeSinking:
         opt = new (allocator) CodeSinking(graph, stats, name);
         break;
+      case OptimizationPass::kPartialEscapeMaterialization:
+        opt = new (allocator) PartialEscapeMaterialization(graph, stats, name);
+        break;
+      case OptimizationPass::kPartialRedundancyElimination:
+        opt = new (allocator) PartialRedundancyElimination(graph, stats, name);
+        break;
+      case OptimizationPass::kReadBarrierElimination:
+        opt = new (allocator) ReadBarrierElimination(graph, stats, name);
+        break;
       case OptimizationPass::kConstructorFenceRedundancyElimination:
         opt = new (allocator) ConstructorFenceRedundancyElimination(graph, stats, name);
         break;
@@ -80,7 +80,11 @@ enum class OptimizationPass {
   kInvariantCodeMotion,
   kLoadStoreAnalysis,
   kLoadStoreElimination,
+  kLoopNestOptimization,
   kLoopOptimization,
+  kPartialEscapeMaterialization,
+  kPartialRedundancyElimination,
+  kReadBarrierElimination,
   kScheduling,
   kSelectGenerator,
   kSharpening,
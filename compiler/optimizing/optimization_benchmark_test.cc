@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "optimization.h"
+
+#include "base/arena_allocator.h"
+#include "base/time_utils.h"
+#include "builder.h"
+#include "dex/dex_instruction.h"
+#include "driver/dex_compilation_unit.h"
+#include "handle_scope-inl.h"
+#include "nodes.h"
+#include "optimizing_unit_test.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+
+// Times the optimization passes of the optimizing compiler one at a time, on a small corpus of
+// methods, and reports the time and the arena memory kept by each pass. The memory of the scoped
+// arena allocators is released at the end of a pass and is not counted. The passes mutate the
+// graph, so it is rebuilt for every run. The analyses a pass depends on are run before it, outside
+// of the measurement.
+class OptimizationBenchmarkTest : public OptimizingUnitTest {
+ protected:
+  static constexpr size_t kIterations = 20;
+
+  struct PassStats {
+    uint64_t time_ns = 0u;
+    size_t arena_bytes = 0u;
+  };
+
+  // Run `definitions` on the graph of `data` and add the cost of the last pass to `stats`.
+  void RunPasses(const std::vector<uint16_t>& data,
+                 const OptimizationDef definitions[],
+                 size_t length,
+                 /* inout */ PassStats* stats) {
+    ResetPoolAndAllocator();
+    HGraph* graph = CreateCFG(data);
+    ASSERT_TRUE(graph != nullptr);
+
+    ScopedObjectAccess soa(Thread::Current());
+    VariableSizedHandleScope handles(soa.Self());
+    // None of the benchmarked passes looks at the compilation unit, only the inliner does.
+    DexCompilationUnit dex_compilation_unit(
+        handles.NewHandle<mirror::ClassLoader>(nullptr),
+        /* class_linker */ nullptr,
+        graph->GetDexFile(),
+        /* code_item */ nullptr,
+        /* class_def_index */ DexFile::kDexNoIndex16,
+        /* method_idx */ dex::kDexNoIndex,
+        /* access_flags */ 0u,
+        /* verified_method */ nullptr,
+        handles.NewHandle<mirror::DexCache>(nullptr));
+    ArenaVector<HOptimization*> optimizations = ConstructOptimizations(definitions,
+                                                                       length,
+                                                                       graph->GetAllocator(),
+                                                                       graph,
+                                                                       /* stats */ nullptr,
+                                                                       /* codegen */ nullptr,
+                                                                       compiler_driver_.get(),
+                                                                       dex_compilation_unit,
+                                                                       &handles);
+    ASSERT_EQ(length, optimizations.size());
+    for (size_t i = 0; i + 1u < length; ++i) {
+      optimizations[i]->Run();
+    }
+
+    size_t bytes_before = GetAllocator()->BytesUsed();
+    uint64_t start_ns = NanoTime();
+    optimizations.back()->Run();
+    stats->time_ns += NanoTime() - start_ns;
+    stats->arena_bytes += GetAllocator()->BytesUsed() - bytes_before;
+  }
+
+  template <size_t kLength>
+  void BenchmarkPass(const OptimizationDef (&definitions)[kLength]) {
+    const char* pass_name = (definitions[kLength - 1u].second != nullptr)
+        ? definitions[kLength - 1u].second
+        : OptimizationPassName(definitions[kLength - 1u].first);
+    PassStats stats;
+    for (size_t i = 0; i != kIterations; ++i) {
+      for (const std::vector<uint16_t>& data : Corpus()) {
+        RunPasses(data, definitions, kLength, &stats);
+        if (HasFatalFailure()) {
+          return;
+        }
+      }
+    }
+    size_t runs = kIterations * Corpus().size();
+    LOG(INFO) << pass_name << ": " << (stats.time_ns / runs) << "ns, "
+              << (stats.arena_bytes / runs) << " arena bytes per method";
+  }
+
+  static const std::vector<std::vector<uint16_t>>& Corpus() {
+    static const std::vector<std::vector<uint16_t>> corpus = {
+      // Straight-line arithmetic on constants.
+      TWO_REGISTERS_CODE_ITEM(
+        Instruction::CONST_4 | 0 << 8 | 3 << 12,
+        Instruction::CONST_4 | 1 << 8 | 4 << 12,
+        Instruction::ADD_INT_2ADDR | 0 << 8 | 1 << 12,
+        Instruction::MUL_INT_2ADDR | 0 << 8 | 1 << 12,
+        Instruction::SUB_INT_2ADDR | 1 << 8 | 0 << 12,
+        Instruction::RETURN | 1 << 8),
+      // Diamond with a phi at the join.
+      ONE_REGISTER_CODE_ITEM(
+        Instruction::CONST_4 | 0 | 0,
+        Instruction::IF_EQ, 4,
+        Instruction::CONST_4 | 4 << 12 | 0,
+        Instruction::GOTO | 0x200,
+        Instruction::CONST_4 | 5 << 12 | 0,
+        Instruction::RETURN | 0 << 8),
+      // Counted loop with a reduction.
+      TWO_REGISTERS_CODE_ITEM(
+        Instruction::CONST_4 | 0 << 8 | 0 << 12,
+        Instruction::CONST_4 | 1 << 8 | 5 << 12,
+        Instruction::IF_EQZ | 1 << 8, 6,
+        Instruction::ADD_INT_2ADDR | 0 << 8 | 1 << 12,
+        Instruction::ADD_INT_LIT8 | 1 << 8, 1 | 0xFF << 8,
+        Instruction::GOTO | 0xFB00,
+        Instruction::RETURN | 0 << 8),
+      // Loop nest with a reduction in the inner loop.
+      THREE_REGISTERS_CODE_ITEM(
+        Instruction::CONST_4 | 0 << 8 | 0 << 12,
+        Instruction::CONST_4 | 1 << 8 | 4 << 12,
+        Instruction::IF_EQZ | 1 << 8, 12,
+        Instruction::CONST_4 | 2 << 8 | 4 << 12,
+        Instruction::IF_EQZ | 2 << 8, 6,
+        Instruction::ADD_INT_2ADDR | 0 << 8 | 2 << 12,
+        Instruction::ADD_INT_LIT8 | 2 << 8, 2 | 0xFF << 8,
+        Instruction::GOTO | 0xFB00,
+        Instruction::ADD_INT_LIT8 | 1 << 8, 1 | 0xFF << 8,
+        Instruction::GOTO | 0xF500,
+        Instruction::RETURN | 0 << 8),
+    };
+    return corpus;
+  }
+};
+
+// The passes below are those of the optimizing compiler that need neither a code generator nor
+// a real compilation unit. The instruction simplifiers, the sharpening, the inliner, the select
+// generator and the scheduler are left out.
+
+TEST_F(OptimizationBenchmarkTest, ConstantFolding) {
+  BenchmarkPass({ OptDef(OptimizationPass::kConstantFolding) });
+}
+
+TEST_F(OptimizationBenchmarkTest, TailRecursionElimination) {
+  BenchmarkPass({ OptDef(OptimizationPass::kTailRecursionElimination) });
+}
+
+TEST_F(OptimizationBenchmarkTest, DeadCodeElimination) {
+  BenchmarkPass({ OptDef(OptimizationPass::kDeadCodeElimination) });
+}
+
+TEST_F(OptimizationBenchmarkTest, SideEffectsAnalysis) {
+  BenchmarkPass({ OptDef(OptimizationPass::kSideEffectsAnalysis) });
+}
+
+TEST_F(OptimizationBenchmarkTest, GlobalValueNumbering) {
+  BenchmarkPass({
+    OptDef(OptimizationPass::kSideEffectsAnalysis),
+    OptDef(OptimizationPass::kGlobalValueNumbering)
+  });
+}
+
+TEST_F(OptimizationBenchmarkTest, PartialRedundancyElimination) {
+  BenchmarkPass({ OptDef(OptimizationPass::kPartialRedundancyElimination) });
+}
+
+TEST_F(OptimizationBenchmarkTest, InvariantCodeMotion) {
+  BenchmarkPass({
+    OptDef(OptimizationPass::kSideEffectsAnalysis),
+    OptDef(OptimizationPass::kInvariantCodeMotion)
+  });
+}
+
+TEST_F(OptimizationBenchmarkTest, InductionVarAnalysis) {
+  BenchmarkPass({ OptDef(OptimizationPass::kInductionVarAnalysis) });
+}
+
+TEST_F(OptimizationBenchmarkTest, BoundsCheckElimination) {
+  BenchmarkPass({
+    OptDef(OptimizationPass::kSideEffectsAnalysis),
+    OptDef(OptimizationPass::kInductionVarAnalysis),
+    OptDef(OptimizationPass::kLoadStoreAnalysis),
+    OptDef(OptimizationPass::kBoundsCheckElimination)
+  });
+}
+
+TEST_F(OptimizationBenchmarkTest, LoopOptimization) {
+  BenchmarkPass({
+    OptDef(OptimizationPass::kInductionVarAnalysis),
+    OptDef(OptimizationPass::kLoopOptimization)
+  });
+}
+
+TEST_F(OptimizationBenchmarkTest, PartialEscapeMaterialization) {
+  BenchmarkPass({ OptDef(OptimizationPass::kPartialEscapeMaterialization) });
+}
+
+TEST_F(OptimizationBenchmarkTest, LoadStoreAnalysis) {
+  BenchmarkPass({ OptDef(OptimizationPass::kLoadStoreAnalysis) });
+}
+
+TEST_F(OptimizationBenchmarkTest, LoadStoreElimination) {
+  BenchmarkPass({
+    OptDef(OptimizationPass::kSideEffectsAnalysis),
+    OptDef(OptimizationPass::kInductionVarAnalysis),
+    OptDef(OptimizationPass::kLoadStoreAnalysis),
+    OptDef(OptimizationPass::kLoadStoreElimination)
+  });
+}
+
+TEST_F(OptimizationBenchmarkTest, CHAGuardOptimization) {
+  BenchmarkPass({ OptDef(OptimizationPass::kCHAGuardOptimization) });
+}
+
+TEST_F(OptimizationBenchmarkTest, CodeSinking) {
+  BenchmarkPass({ OptDef(OptimizationPass::kCodeSinking) });
+}
+
+TEST_F(OptimizationBenchmarkTest, ConstructorFenceRedundancyElimination) {
+  BenchmarkPass({ OptDef(OptimizationPass::kConstructorFenceRedundancyElimination) });
+}
+
+}  // namespace art
@@ -16,9 +16,12 @@
 
 #include "optimizing_compiler.h"
 
+#include <algorithm>
 #include <fstream>
 #include <memory>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include <stdint.h>
 
@@ -29,6 +32,7 @@
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "base/scoped_arena_allocator.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "builder.h"
 #include "code_generator.h"
@@ -49,10 +53,12 @@
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "jit/jit_logger.h"
+#include "jit/profile_compilation_info.h"
 #include "jni/quick/jni_compiler.h"
 #include "linker/linker_patch.h"
 #include "nodes.h"
 #include "oat_quick_method_header.h"
+#include "pass_trace.h"
 #include "prepare_for_register_allocation.h"
 #include "reference_type_propagation.h"
 #include "register_allocator_linear_scan.h"
@@ -73,6 +79,9 @@ namespace art {
 
 static constexpr size_t kArenaAllocatorMemoryReportThreshold = 8 * MB;
 
+// Largest graph for which the `auto` register allocation strategy picks graph coloring.
+static constexpr size_t kMaximumNumberOfInstructionsForGraphColoring = 3000;
+
 static constexpr const char* kPassNameSeparator = "$";
 
 /**
@@ -114,6 +123,7 @@ class PassObserver : public ValueObject {
   PassObserver(HGraph* graph,
                CodeGenerator* codegen,
                std::ostream* visualizer_output,
+               PassTraceWriter* pass_trace_writer,
                CompilerDriver* compiler_driver,
                Mutex& dump_mutex)
       : graph_(graph),
@@ -126,10 +136,14 @@ class PassObserver : public ValueObject {
         visualizer_enabled_(!compiler_driver->GetCompilerOptions().GetDumpCfgFileName().empty()),
         visualizer_(&visualizer_oss_, graph, *codegen),
         visualizer_dump_mutex_(dump_mutex),
+        pass_trace_writer_(pass_trace_writer),
+        pass_trace_enabled_(pass_trace_writer != nullptr),
+        pass_trace_starts_(),
+        pass_trace_(),
         graph_in_bad_state_(false) {
-    if (timing_logger_enabled_ || visualizer_enabled_) {
+    if (timing_logger_enabled_ || visualizer_enabled_ || pass_trace_enabled_) {
       if (!IsVerboseMethod(compiler_driver, GetMethodName())) {
-        timing_logger_enabled_ = visualizer_enabled_ = false;
+        timing_logger_enabled_ = visualizer_enabled_ = pass_trace_enabled_ = false;
       }
       if (visualizer_enabled_) {
         visualizer_.PrintHeader(GetMethodName());
@@ -143,6 +157,9 @@ class PassObserver : public ValueObject {
       LOG(INFO) << "TIMINGS " << GetMethodName();
       LOG(INFO) << Dumpable<TimingLogger>(timing_logger_);
     }
+    if (pass_trace_enabled_ && !pass_trace_.empty()) {
+      pass_trace_writer_->WriteMethod(GetMethodName(), pass_trace_);
+    }
     DCHECK(visualizer_oss_.str().empty());
   }
 
@@ -174,6 +191,21 @@ class PassObserver : public ValueObject {
     if (timing_logger_enabled_) {
       timing_logger_.StartTiming(pass_name);
     }
+    if (pass_trace_enabled_) {
+      pass_trace_starts_.push_back(
+          { CountInstructions(), graph_->GetAllocator()->BytesUsed(), NanoTime() });
+    }
+  }
+
+  // Number of instructions and phis currently in the graph, for the pass trace.
+  size_t CountInstructions() const {
+    size_t count = 0u;
+    for (HBasicBlock* block : graph_->GetBlocks()) {
+      if (block != nullptr) {
+        count += block->GetPhis().CountSize() + block->GetInstructions().CountSize();
+      }
+    }
+    return count;
   }
 
   void FlushVisualizer() REQUIRES(!visualizer_dump_mutex_) {
@@ -189,6 +221,17 @@ class PassObserver : public ValueObject {
     if (timing_logger_enabled_) {
       timing_logger_.EndTiming();
     }
+    if (pass_trace_enabled_) {
+      uint64_t end_ns = NanoTime();
+      DCHECK(!pass_trace_starts_.empty());
+      const PassTraceStart& start = pass_trace_starts_.back();
+      pass_trace_.push_back({
+          pass_name,
+          end_ns - start.time_ns,
+          static_cast<int32_t>(CountInstructions()) - static_cast<int32_t>(start.instructions),
+          static_cast<uint32_t>(graph_->GetAllocator()->BytesUsed() - start.arena_bytes) });
+      pass_trace_starts_.pop_back();
+    }
     if (visualizer_enabled_) {
       visualizer_.DumpGraph(pass_name, /* is_after_pass */ true, graph_in_bad_state_);
       FlushVisualizer();
@@ -238,6 +281,18 @@ class PassObserver : public ValueObject {
   HGraphVisualizer visualizer_;
   Mutex& visualizer_dump_mutex_;
 
+  // State of the passes currently running, innermost last, for the pass trace.
+  struct PassTraceStart {
+    size_t instructions;
+    size_t arena_bytes;
+    uint64_t time_ns;
+  };
+
+  PassTraceWriter* const pass_trace_writer_;
+  bool pass_trace_enabled_;
+  std::vector<PassTraceStart> pass_trace_starts_;
+  std::vector<PassTraceWriter::PassEntry> pass_trace_;
+
   // Flag to be set by the compiler if the pass failed and the graph is not
   // expected to validate.
   bool graph_in_bad_state_;
@@ -299,6 +354,7 @@ class OptimizingCompiler FINAL : public Compiler {
                   jit::JitCodeCache* code_cache,
                   ArtMethod* method,
                   bool osr,
+                  bool baseline,
                   jit::JitLogger* jit_logger)
       OVERRIDE
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -323,8 +379,15 @@ class OptimizingCompiler FINAL : public Compiler {
         dex_compilation_unit,
         handles);
     DCHECK_EQ(length, optimizations.size());
+    const CompilerOptions::MethodOptions* method_options = GetMethodOptions(pass_observer);
     // Run the optimization passes one by one.
     for (size_t i = 0; i < length; ++i) {
+      if (method_options != nullptr &&
+          method_options->IsPassDisabled(optimizations[i]->GetPassName())) {
+        VLOG(compiler) << "Skipping pass " << optimizations[i]->GetPassName() << " for "
+                       << pass_observer->GetMethodName();
+        continue;
+      }
       PassScope scope(optimizations[i]->GetPassName(), pass_observer);
       optimizations[i]->Run();
     }
@@ -348,6 +411,15 @@ class OptimizingCompiler FINAL : public Compiler {
                         VariableSizedHandleScope* handles) const;
 
  private:
+  // Returns the compiler options overridden for the method compiled with `pass_observer`,
+  // or null if there are none.
+  const CompilerOptions::MethodOptions* GetMethodOptions(PassObserver* pass_observer) const {
+    const CompilerOptions& compiler_options = GetCompilerDriver()->GetCompilerOptions();
+    return compiler_options.HasMethodOptions()
+        ? compiler_options.GetMethodOptions(pass_observer->GetMethodName())
+        : nullptr;
+  }
+
   // Create a 'CompiledMethod' for an optimized graph.
   CompiledMethod* Emit(ArenaAllocator* allocator,
                        CodeVectorAllocator* code_allocator,
@@ -359,7 +431,9 @@ class OptimizingCompiler FINAL : public Compiler {
   // This method:
   // 1) Builds the graph. Returns null if it failed to build it.
   // 2) Transforms the graph to SSA. Returns null if it failed.
-  // 3) Runs optimizations on the graph, including register allocator.
+  // 3) Runs optimizations on the graph, including register allocator. A `baseline`
+  //    compilation, or that of a large graph, only runs the passes the code generator
+  //    depends on.
   // 4) Generates code with the `code_allocator` provided.
   CodeGenerator* TryCompile(ArenaAllocator* allocator,
                             ArenaStack* arena_stack,
@@ -367,6 +441,7 @@ class OptimizingCompiler FINAL : public Compiler {
                             const DexCompilationUnit& dex_compilation_unit,
                             ArtMethod* method,
                             bool osr,
+                            bool baseline,
                             VariableSizedHandleScope* handles) const;
 
   CodeGenerator* TryCompileIntrinsic(ArenaAllocator* allocator,
@@ -388,13 +463,42 @@ class OptimizingCompiler FINAL : public Compiler {
                             PassObserver* pass_observer,
                             VariableSizedHandleScope* handles) const;
 
+  void RunBaselineOptimizations(HGraph* graph,
+                                CodeGenerator* codegen,
+                                const DexCompilationUnit& dex_compilation_unit,
+                                PassObserver* pass_observer,
+                                VariableSizedHandleScope* handles) const;
+
+  // Resolve the `auto` register allocation strategy for the compilation of `graph`.
+  RegisterAllocator::Strategy ChooseRegisterAllocationStrategy(
+      HGraph* graph,
+      const DexCompilationUnit& dex_compilation_unit) const;
+
   void GenerateJitDebugInfo(ArtMethod* method, debug::MethodDebugInfo method_debug_info)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Replace the ELF files of the JITed methods selected by the debugger interface by one ELF
+  // file describing all of them.
+  void RepackJitDebugInfo(bool mini_debug_info) REQUIRES(Locks::native_debug_interface_lock_);
+
+  // The debug info of a JITed method, kept to repack it with that of other methods. The CFI is
+  // copied, the other data it refers to lives as long as the code.
+  struct JitMethodDebugInfo {
+    debug::MethodDebugInfo info;
+    std::vector<uint8_t> cfi;
+  };
+
   std::unique_ptr<OptimizingCompilerStats> compilation_stats_;
 
+  // The debug info of the JITed methods, by code address. The entries of freed code are only
+  // removed when repacking.
+  std::unordered_map<const void*, JitMethodDebugInfo> jit_debug_infos_
+      GUARDED_BY(Locks::native_debug_interface_lock_);
+
   std::unique_ptr<std::ostream> visualizer_output_;
 
+  std::unique_ptr<PassTraceWriter> pass_trace_writer_;
+
   mutable Mutex dump_mutex_;  // To synchronize visualizer writing.
 
   DISALLOW_COPY_AND_ASSIGN(OptimizingCompiler);
@@ -416,6 +520,11 @@ void OptimizingCompiler::Init() {
         driver->GetCompilerOptions().GetDumpCfgAppend() ? std::ofstream::app : std::ofstream::out;
     visualizer_output_.reset(new std::ofstream(cfg_file_name, cfg_file_mode));
   }
+  const std::string& pass_trace_file_name =
+      driver->GetCompilerOptions().GetDumpPassTraceFileName();
+  if (!pass_trace_file_name.empty()) {
+    pass_trace_writer_.reset(new PassTraceWriter(pass_trace_file_name));
+  }
   if (driver->GetCompilerOptions().GetDumpStats()) {
     compilation_stats_.reset(new OptimizingCompilerStats());
   }
@@ -451,7 +560,8 @@ void OptimizingCompiler::MaybeRunInliner(HGraph* graph,
                                          PassObserver* pass_observer,
                                          VariableSizedHandleScope* handles) const {
   const CompilerOptions& compiler_options = GetCompilerDriver()->GetCompilerOptions();
-  bool should_inline = (compiler_options.GetInlineMaxCodeUnits() > 0);
+  bool should_inline =
+      (compiler_options.GetInlineMaxCodeUnits(GetMethodOptions(pass_observer)) > 0);
   if (!should_inline) {
     return;
   }
@@ -546,7 +656,8 @@ void OptimizingCompiler::RunArchOptimizations(HGraph* graph,
         OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
         OptDef(OptimizationPass::kPcRelativeFixupsX86),
         OptDef(OptimizationPass::kX86MemoryOperandGeneration),
-        OptDef(OptimizationPass::kInstructionSimplifierX86)
+        OptDef(OptimizationPass::kInstructionSimplifierX86),
+        OptDef(OptimizationPass::kScheduling)
       };
       RunOptimizations(graph,
                        codegen,
@@ -562,8 +673,12 @@ void OptimizingCompiler::RunArchOptimizations(HGraph* graph,
       OptimizationDef x86_64_optimizations[] = {
         OptDef(OptimizationPass::kSideEffectsAnalysis),
         OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
+        OptDef(OptimizationPass::kInstructionSimplifierX86_64),
+        // After the simplifier, which may replace the users of folded array loads.
         OptDef(OptimizationPass::kX86MemoryOperandGeneration),
-        OptDef(OptimizationPass::kInstructionSimplifierX86_64)
+        OptDef(OptimizationPass::kScheduling),
+        // Last, so that no GC point moves between an allocation and the loads it marks.
+        OptDef(OptimizationPass::kReadBarrierElimination)
       };
       RunOptimizations(graph,
                        codegen,
@@ -579,6 +694,82 @@ void OptimizingCompiler::RunArchOptimizations(HGraph* graph,
   }
 }
 
+void OptimizingCompiler::RunBaselineOptimizations(HGraph* graph,
+                                                  CodeGenerator* codegen,
+                                                  const DexCompilationUnit& dex_compilation_unit,
+                                                  PassObserver* pass_observer,
+                                                  VariableSizedHandleScope* handles) const {
+  // Only the passes which are cheap and which the code generator relies on: direct calls,
+  // the simplifications the code generator assumes, see RunOptimizations(), and the
+  // mandatory architecture fixups, see RunArchOptimizations().
+  OptimizationDef baseline_optimizations[] = {
+    OptDef(OptimizationPass::kSharpening),
+    OptDef(OptimizationPass::kInstructionSimplifier, "instruction_simplifier$before_codegen")
+  };
+  RunOptimizations(graph,
+                   codegen,
+                   dex_compilation_unit,
+                   pass_observer,
+                   handles,
+                   baseline_optimizations);
+
+  // The code generators of these ISAs expect the base of the PC-relative loads.
+  switch (GetCompilerDriver()->GetInstructionSet()) {
+#ifdef ART_ENABLE_CODEGEN_mips
+    case InstructionSet::kMips: {
+      OptimizationDef mips_optimizations[] = {
+        OptDef(OptimizationPass::kPcRelativeFixupsMips)
+      };
+      RunOptimizations(graph,
+                       codegen,
+                       dex_compilation_unit,
+                       pass_observer,
+                       handles,
+                       mips_optimizations);
+      break;
+    }
+#endif
+#ifdef ART_ENABLE_CODEGEN_x86
+    case InstructionSet::kX86: {
+      OptimizationDef x86_optimizations[] = {
+        OptDef(OptimizationPass::kPcRelativeFixupsX86)
+      };
+      RunOptimizations(graph,
+                       codegen,
+                       dex_compilation_unit,
+                       pass_observer,
+                       handles,
+                       x86_optimizations);
+      break;
+    }
+#endif
+    default:
+      break;
+  }
+}
+
+RegisterAllocator::Strategy OptimizingCompiler::ChooseRegisterAllocationStrategy(
+    HGraph* graph,
+    const DexCompilationUnit& dex_compilation_unit) const {
+  // Graph coloring mostly pays off by keeping loop values in registers, and its cost
+  // grows faster than linear scan's with the size of the graph.
+  if (!graph->HasLoops() ||
+      graph->GetCurrentInstructionId() > kMaximumNumberOfInstructionsForGraphColoring) {
+    return RegisterAllocator::kRegisterAllocatorLinearScan;
+  }
+  if (!Runtime::Current()->IsAotCompiler()) {
+    // The JIT only compiles methods which got hot.
+    return RegisterAllocator::kRegisterAllocatorGraphColor;
+  }
+  const ProfileCompilationInfo* profile = GetCompilerDriver()->GetProfileCompilationInfo();
+  MethodReference method_ref(dex_compilation_unit.GetDexFile(),
+                             dex_compilation_unit.GetDexMethodIndex());
+  if (profile != nullptr && profile->GetMethodHotness(method_ref).IsHot()) {
+    return RegisterAllocator::kRegisterAllocatorGraphColor;
+  }
+  return RegisterAllocator::kRegisterAllocatorLinearScan;
+}
+
 NO_INLINE  // Avoid increasing caller's frame size by large stack-allocated objects.
 static void AllocateRegisters(HGraph* graph,
                               CodeGenerator* codegen,
@@ -665,13 +856,19 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
     OptDef(OptimizationPass::kDeadCodeElimination,   "dead_code_elimination$after_inlining"),
     OptDef(OptimizationPass::kSideEffectsAnalysis,   "side_effects$before_gvn"),
     OptDef(OptimizationPass::kGlobalValueNumbering),
+    OptDef(OptimizationPass::kPartialRedundancyElimination),
     OptDef(OptimizationPass::kInvariantCodeMotion),
     OptDef(OptimizationPass::kInductionVarAnalysis),
+    OptDef(OptimizationPass::kLoadStoreAnalysis,     "load_store_analysis$before_bce"),
     OptDef(OptimizationPass::kBoundsCheckElimination),
+    // Only runs with --loop-nest-optimization.
+    OptDef(OptimizationPass::kLoopNestOptimization),
     OptDef(OptimizationPass::kLoopOptimization),
     // Evaluates code generated by dynamic bce.
     OptDef(OptimizationPass::kConstantFolding,       "constant_folding$after_bce"),
     OptDef(OptimizationPass::kInstructionSimplifier, "instruction_simplifier$after_bce"),
+    // Makes singletons of allocations escaping on uncommon branches, for LSE to remove.
+    OptDef(OptimizationPass::kPartialEscapeMaterialization),
     OptDef(OptimizationPass::kSideEffectsAnalysis,   "side_effects$before_lse"),
     OptDef(OptimizationPass::kLoadStoreAnalysis),
     OptDef(OptimizationPass::kLoadStoreElimination),
@@ -749,6 +946,7 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
                                               const DexCompilationUnit& dex_compilation_unit,
                                               ArtMethod* method,
                                               bool osr,
+                                              bool baseline,
                                               VariableSizedHandleScope* handles) const {
   MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kAttemptBytecodeCompilation);
   CompilerDriver* compiler_driver = GetCompilerDriver();
@@ -793,7 +991,8 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
       compiler_driver->GetInstructionSet(),
       kInvalidInvokeType,
       compiler_driver->GetCompilerOptions().GetDebuggable(),
-      osr);
+      osr,
+      baseline);
 
   ArrayRef<const uint8_t> interpreter_metadata;
   // For AOT compilation, we may not get a method, for example if its class is erroneous.
@@ -821,6 +1020,7 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   PassObserver pass_observer(graph,
                              codegen.get(),
                              visualizer_output_.get(),
+                             pass_trace_writer_.get(),
                              compiler_driver,
                              dump_mutex_);
 
@@ -867,14 +1067,38 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
     }
   }
 
-  RunOptimizations(graph,
-                   codegen.get(),
-                   dex_compilation_unit,
-                   &pass_observer,
-                   handles);
-
   RegisterAllocator::Strategy regalloc_strategy =
     compiler_options.GetRegisterAllocationStrategy();
+  // The optimizations and the graph coloring register allocator do not scale to huge
+  // generated methods, which would then dominate the compilation time.
+  bool large_graph = compiler_options.IsLargeGraph(graph->GetCurrentInstructionId());
+  if (large_graph && !baseline) {
+    VLOG(compiler) << "Reduced optimizations for the large graph of "
+                   << pass_observer.GetMethodName() << ": "
+                   << graph->GetCurrentInstructionId() << " instructions";
+    MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kLargeGraphNotOptimized);
+  }
+  if (baseline || large_graph) {
+    RunBaselineOptimizations(graph,
+                             codegen.get(),
+                             dex_compilation_unit,
+                             &pass_observer,
+                             handles);
+    regalloc_strategy = RegisterAllocator::kRegisterAllocatorLinearScan;
+  } else {
+    RunOptimizations(graph,
+                     codegen.get(),
+                     dex_compilation_unit,
+                     &pass_observer,
+                     handles);
+    const CompilerOptions::MethodOptions* method_options = GetMethodOptions(&pass_observer);
+    if (method_options != nullptr && method_options->has_register_allocation_strategy) {
+      regalloc_strategy = method_options->register_allocation_strategy;
+    }
+    if (regalloc_strategy == RegisterAllocator::kRegisterAllocatorAuto) {
+      regalloc_strategy = ChooseRegisterAllocationStrategy(graph, dex_compilation_unit);
+    }
+  }
   AllocateRegisters(graph,
                     codegen.get(),
                     &pass_observer,
@@ -939,6 +1163,7 @@ CodeGenerator* OptimizingCompiler::TryCompileIntrinsic(
   PassObserver pass_observer(graph,
                              codegen.get(),
                              visualizer_output_.get(),
+                             pass_trace_writer_.get(),
                              compiler_driver,
                              dump_mutex_);
 
@@ -972,10 +1197,15 @@ CodeGenerator* OptimizingCompiler::TryCompileIntrinsic(
 
   RunArchOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer, handles);
 
+  RegisterAllocator::Strategy regalloc_strategy =
+      compiler_driver->GetCompilerOptions().GetRegisterAllocationStrategy();
+  if (regalloc_strategy == RegisterAllocator::kRegisterAllocatorAuto) {
+    regalloc_strategy = ChooseRegisterAllocationStrategy(graph, dex_compilation_unit);
+  }
   AllocateRegisters(graph,
                     codegen.get(),
                     &pass_observer,
-                    compiler_driver->GetCompilerOptions().GetRegisterAllocationStrategy(),
+                    regalloc_strategy,
                     compilation_stats_.get());
   if (!codegen->IsLeafMethod()) {
     VLOG(compiler) << "Intrinsic method is not leaf: " << method->GetIntrinsic()
@@ -1052,6 +1282,7 @@ CompiledMethod* OptimizingCompiler::Compile(const DexFile::CodeItem* code_item,
                        dex_compilation_unit,
                        method,
                        /* osr */ false,
+                       /* baseline */ false,
                        &handles));
       }
     }
@@ -1147,10 +1378,29 @@ CompiledMethod* OptimizingCompiler::JniCompile(uint32_t access_flags,
     }
   }
 
+  MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kCompiledNativeStub);
+  // Reuse the stub compiled for another native method with the same shorty and flags.
+  CompiledMethodStorage* storage = GetCompilerDriver()->GetCompiledMethodStorage();
+  const char* shorty = dex_file.GetMethodShorty(dex_file.GetMethodId(method_idx));
+  const CompiledMethod* stub = storage->FindJniStub(shorty, access_flags);
+  if (stub != nullptr) {
+    MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kSharedNativeStub);
+    return CompiledMethod::SwapAllocCompiledMethod(
+        GetCompilerDriver(),
+        stub->GetInstructionSet(),
+        stub->GetQuickCode(),
+        stub->GetFrameSizeInBytes(),
+        stub->GetCoreSpillMask(),
+        stub->GetFpSpillMask(),
+        /* method_info */ ArrayRef<const uint8_t>(),
+        /* vmap_table */ ArrayRef<const uint8_t>(),
+        stub->GetCFIInfo(),
+        /* patches */ ArrayRef<const linker::LinkerPatch>());
+  }
+
   JniCompiledMethod jni_compiled_method = ArtQuickJniCompileMethod(
       GetCompilerDriver(), access_flags, method_idx, dex_file);
-  MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kCompiledNativeStub);
-  return CompiledMethod::SwapAllocCompiledMethod(
+  CompiledMethod* compiled_method = CompiledMethod::SwapAllocCompiledMethod(
       GetCompilerDriver(),
       jni_compiled_method.GetInstructionSet(),
       jni_compiled_method.GetCode(),
@@ -1161,6 +1411,8 @@ CompiledMethod* OptimizingCompiler::JniCompile(uint32_t access_flags,
       /* vmap_table */ ArrayRef<const uint8_t>(),
       jni_compiled_method.GetCfi(),
       /* patches */ ArrayRef<const linker::LinkerPatch>());
+  storage->AddJniStub(shorty, access_flags, compiled_method);
+  return compiled_method;
 }
 
 Compiler* CreateOptimizingCompiler(CompilerDriver* driver) {
@@ -1215,6 +1467,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                                     jit::JitCodeCache* code_cache,
                                     ArtMethod* method,
                                     bool osr,
+                                    bool baseline,
                                     jit::JitLogger* jit_logger) {
   StackHandleScope<3> hs(self);
   Handle<mirror::ClassLoader> class_loader(hs.NewHandle(
@@ -1250,7 +1503,9 @@ bool OptimizingCompiler::JitCompile(Thread* self,
         jni_compiled_method.GetCode().size(),
         /* data_size */ 0u,
         osr,
+        /* baseline */ false,
         roots,
+        /* bss_entries */ std::vector<jit::JitBssEntry>(),
         /* has_should_deoptimize_flag */ false,
         cha_single_implementation_list);
     if (code == nullptr) {
@@ -1283,7 +1538,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
 
     Runtime::Current()->GetJit()->AddMemoryUsage(method, allocator.BytesUsed());
     if (jit_logger != nullptr) {
-      jit_logger->WriteLog(code, jni_compiled_method.GetCode().size(), method);
+      jit_logger->WriteLog(reinterpret_cast<const OatQuickMethodHeader*>(code), method);
     }
     return true;
   }
@@ -1313,6 +1568,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                    dex_compilation_unit,
                    method,
                    osr,
+                   baseline,
                    &handles));
     if (codegen.get() == nullptr) {
       return false;
@@ -1355,7 +1611,8 @@ bool OptimizingCompiler::JitCompile(Thread* self,
   codegen->BuildStackMaps(MemoryRegion(stack_map_data, stack_map_size),
                           MemoryRegion(method_info_data, method_info_size),
                           code_item);
-  codegen->EmitJitRoots(code_allocator.GetData(), roots, roots_data);
+  std::vector<jit::JitBssEntry> bss_entries;
+  codegen->EmitJitRoots(code_allocator.GetData(), roots, roots_data, &bss_entries);
 
   const void* code = code_cache->CommitCode(
       self,
@@ -1370,7 +1627,9 @@ bool OptimizingCompiler::JitCompile(Thread* self,
       code_allocator.GetSize(),
       data_size,
       osr,
+      codegen->GetGraph()->IsCompilingBaseline(),
       roots,
+      bss_entries,
       codegen->GetGraph()->HasShouldDeoptimizeFlag(),
       codegen->GetGraph()->GetCHASingleImplementationList());
 
@@ -1384,7 +1643,8 @@ bool OptimizingCompiler::JitCompile(Thread* self,
    {
       std::string method_name = method->PrettyMethod();
       const auto* method_header = reinterpret_cast<const OatQuickMethodHeader*>(code);
-      //const void* code_info_ptr = method_header->IsOptimized() ? method_header->GetOptimizedCodeInfoPtr() : nullptr;
+      const void* code_info_ptr =
+          method_header->IsOptimized() ? method_header->GetOptimizedCodeInfoPtr() : nullptr;
       const char* class_descriptor = method->GetDeclaringClassDescriptor();
       //std::string class_name = PrettyDescriptor(class_descriptor);
       std::string class_name(PrettyDescriptor(class_descriptor));
@@ -1399,8 +1659,9 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                         class_name.c_str(),
                         file_name.c_str(),
                         method->GetDexFile(),
-			method->GetDexMethodIndex(),
-                        method->GetCodeItem());
+                        method->GetDexMethodIndex(),
+                        method->GetCodeItem(),
+                        code_info_ptr);
    }
 #endif
 
@@ -1435,7 +1696,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
 
   Runtime::Current()->GetJit()->AddMemoryUsage(method, allocator.BytesUsed());
   if (jit_logger != nullptr) {
-    jit_logger->WriteLog(code, code_allocator.GetSize(), method);
+    jit_logger->WriteLog(reinterpret_cast<const OatQuickMethodHeader*>(code), method);
   }
 
   if (kArenaAllocatorCountAllocations) {
@@ -1468,7 +1729,14 @@ void OptimizingCompiler::GenerateJitDebugInfo(ArtMethod* method, debug::MethodDe
       mini_debug_info,
       ArrayRef<const debug::MethodDebugInfo>(&info, 1));
   MutexLock mu(Thread::Current(), *Locks::native_debug_interface_lock_);
-  AddNativeDebugInfoForJit(reinterpret_cast<const void*>(info.code_address), elf_file);
+  const void* code_ptr = reinterpret_cast<const void*>(info.code_address);
+  AddNativeDebugInfoForJit(code_ptr, elf_file);
+  // This replaces the debug info of code freed at the same address, if any.
+  JitMethodDebugInfo& method_debug_info = jit_debug_infos_[code_ptr];
+  method_debug_info.info = info;
+  method_debug_info.cfi.assign(info.cfi.begin(), info.cfi.end());
+  method_debug_info.info.cfi = ArrayRef<const uint8_t>();
+  RepackJitDebugInfo(mini_debug_info);
 
   VLOG(jit)
       << "JIT mini-debug-info added for " << ArtMethod::PrettyMethod(method)
@@ -1476,4 +1744,39 @@ void OptimizingCompiler::GenerateJitDebugInfo(ArtMethod* method, debug::MethodDe
       << " total_size=" << PrettySize(GetJitNativeDebugInfoMemUsage());
 }
 
+void OptimizingCompiler::RepackJitDebugInfo(bool mini_debug_info) {
+  std::vector<const void*> code_ptrs = GetNativeDebugInfoForJitToRepack();
+  if (code_ptrs.empty()) {
+    return;
+  }
+  // Forget the debug info of the code freed since the last repacking.
+  for (auto it = jit_debug_infos_.begin(); it != jit_debug_infos_.end(); ) {
+    if (HasNativeDebugInfoForJit(it->first)) {
+      ++it;
+    } else {
+      it = jit_debug_infos_.erase(it);
+    }
+  }
+
+  std::sort(code_ptrs.begin(), code_ptrs.end());
+  std::vector<debug::MethodDebugInfo> infos;
+  infos.reserve(code_ptrs.size());
+  for (const void* code_ptr : code_ptrs) {
+    auto it = jit_debug_infos_.find(code_ptr);
+    DCHECK(it != jit_debug_infos_.end());
+    infos.push_back(it->second.info);
+    infos.back().cfi = ArrayRef<const uint8_t>(it->second.cfi);
+  }
+  std::vector<uint8_t> elf_file = debug::MakeElfFileForJIT(
+      GetCompilerDriver()->GetInstructionSet(),
+      GetCompilerDriver()->GetInstructionSetFeatures(),
+      mini_debug_info,
+      ArrayRef<const debug::MethodDebugInfo>(infos));
+  RepackNativeDebugInfoForJit(ArrayRef<const void* const>(code_ptrs), elf_file);
+
+  VLOG(jit)
+      << "JIT mini-debug-info repacked for " << code_ptrs.size() << " methods"
+      << " size=" << PrettySize(elf_file.size());
+}
+
 }  // namespace art
@@ -32,9 +32,12 @@ enum class MethodCompilationStat {
   kAttemptBytecodeCompilation = 0,
   kAttemptIntrinsicCompilation,
   kCompiledNativeStub,
+  kSharedNativeStub,
   kCompiledIntrinsic,
   kCompiledBytecode,
+  kLargeGraphNotOptimized,
   kCHAInline,
+  kCHADirectCall,
   kInlinedInvoke,
   kReplacedInvokeWithSimplePattern,
   kInstructionSimplifications,
@@ -61,6 +64,7 @@ enum class MethodCompilationStat {
   kNotCompiledVerifyAtRuntime,
   kInlinedMonomorphicCall,
   kInlinedPolymorphicCall,
+  kInlinedMegamorphicCall,
   kMonomorphicCall,
   kPolymorphicCall,
   kMegamorphicCall,
@@ -69,6 +73,11 @@ enum class MethodCompilationStat {
   kLoopInvariantMoved,
   kLoopVectorized,
   kLoopVectorizedIdiom,
+  kLoopVectorizedEpilogue,
+  kLoopVectorizedWithoutCleanup,
+  kLoopPeeledForInvariantExits,
+  kLoopInterchanged,
+  kPartiallyRedundantInstructionRemoved,
   kSelectGenerated,
   kRemovedInstanceOf,
   kInlinedInvokeVirtualOrInterface,
@@ -77,6 +86,7 @@ enum class MethodCompilationStat {
   kSimplifyIf,
   kSimplifyThrowingInvoke,
   kInstructionSunk,
+  kPartialEscapeMaterialized,
   kNotInlinedUnresolvedEntrypoint,
   kNotInlinedDexCache,
   kNotInlinedStackMaps,
@@ -94,6 +104,13 @@ enum class MethodCompilationStat {
   kNotInlinedWont,
   kNotInlinedRecursiveBudget,
   kNotInlinedProxy,
+  kNotInlinedColdCallSite,
+  kInlinedHotCallSite,
+  kNotInlinedSpecializationTooBig,
+  kInlinedSpecializedOnConstants,
+  kReplacedVarHandleAccess,
+  kReadBarrierRemoved,
+  kSuspendCheckPollElided,
   kConstructorFenceGeneratedNew,
   kConstructorFenceGeneratedFinal,
   kConstructorFenceRemovedLSE,
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_escape.h"
+
+#include "base/arena_bit_vector.h"
+#include "base/bit_vector-inl.h"
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+
+namespace art {
+
+// Whether `user` is an access to a field of `new_instance` which load-store elimination
+// can remove, or a constructor fence, once `new_instance` is a singleton.
+static bool IsRemovableFieldAccess(HNewInstance* new_instance, HInstruction* user) {
+  if (user->IsInstanceFieldGet()) {
+    return !user->AsInstanceFieldGet()->IsVolatile();
+  } else if (user->IsInstanceFieldSet()) {
+    return user->InputAt(0) == new_instance &&
+        user->InputAt(1) != new_instance &&
+        !user->AsInstanceFieldSet()->IsVolatile();
+  }
+  return user->IsConstructorFence();
+}
+
+void PartialEscapeMaterialization::Run() {
+  if (graph_->IsDebuggable() || graph_->HasTryCatch() || graph_->HasSIMD()) {
+    // Load-store elimination skips these graphs, so the copies would only add allocations.
+    return;
+  }
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  size_t number_of_blocks = graph_->GetBlocks().size();
+
+  // Find the uncommon blocks, from which all paths end with a throw. Like code sinking,
+  // we do not profile branches yet. Blocks are visited before their predecessors, except
+  // for back edges, whose loops are conservatively considered common.
+  ArenaBitVector uncommon_blocks(
+      &allocator, number_of_blocks, /* expandable */ false, kArenaAllocMisc);
+  for (HBasicBlock* block : graph_->GetPostOrder()) {
+    if (block->IsExitBlock()) {
+      continue;
+    }
+    bool is_uncommon = block->GetLastInstruction()->IsThrow();
+    if (!is_uncommon) {
+      is_uncommon = std::all_of(block->GetSuccessors().begin(),
+                                block->GetSuccessors().end(),
+                                [&](HBasicBlock* successor) {
+                                  return uncommon_blocks.IsBitSet(successor->GetBlockId());
+                                });
+    }
+    if (is_uncommon) {
+      uncommon_blocks.SetBit(block->GetBlockId());
+    }
+  }
+
+  // Uncommon blocks form regions, each dominated by an entry whose dominator is common.
+  // A copy at the entry stands for the allocation in the whole region if the region is
+  // entered once, straight from common code: control never flows back from uncommon
+  // code to common code.
+  ScopedArenaVector<HBasicBlock*> region_entries(
+      number_of_blocks, nullptr, allocator.Adapter(kArenaAllocMisc));
+  ArenaBitVector materializable_entries(
+      &allocator, number_of_blocks, /* expandable */ false, kArenaAllocMisc);
+  bool has_uncommon_regions = false;
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    if (!uncommon_blocks.IsBitSet(block->GetBlockId())) {
+      continue;
+    }
+    HBasicBlock* dominator = block->GetDominator();
+    if (dominator != nullptr && uncommon_blocks.IsBitSet(dominator->GetBlockId())) {
+      region_entries[block->GetBlockId()] = region_entries[dominator->GetBlockId()];
+      continue;
+    }
+    region_entries[block->GetBlockId()] = block;
+    if (dominator != nullptr &&
+        !block->IsInLoop() &&
+        std::none_of(block->GetPredecessors().begin(),
+                     block->GetPredecessors().end(),
+                     [&](HBasicBlock* predecessor) {
+                       return uncommon_blocks.IsBitSet(predecessor->GetBlockId());
+                     })) {
+      materializable_entries.SetBit(block->GetBlockId());
+      has_uncommon_regions = true;
+    }
+  }
+  if (!has_uncommon_regions) {
+    return;
+  }
+
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    if (uncommon_blocks.IsBitSet(block->GetBlockId())) {
+      continue;
+    }
+    // Only uncommon blocks are modified, so iterating over common ones is safe.
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->IsNewInstance() &&
+          TryMaterialize(instruction->AsNewInstance(), materializable_entries, region_entries)) {
+        MaybeRecordStat(stats_, MethodCompilationStat::kPartialEscapeMaterialized);
+      }
+    }
+  }
+}
+
+bool PartialEscapeMaterialization::TryMaterialize(
+    HNewInstance* new_instance,
+    const ArenaBitVector& materializable_entries,
+    const ScopedArenaVector<HBasicBlock*>& region_entries) {
+  if (new_instance->IsFinalizable() ||
+      new_instance->NeedsChecks() ||
+      new_instance->IsStringAlloc()) {
+    // Load-store elimination keeps these allocations.
+    return false;
+  }
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<std::pair<HInstruction*, size_t>> uncommon_uses(
+      allocator.Adapter(kArenaAllocMisc));
+  ScopedArenaVector<std::pair<HEnvironment*, size_t>> uncommon_env_uses(
+      allocator.Adapter(kArenaAllocMisc));
+  // One store per field written in common code, whose value the copies need.
+  ScopedArenaVector<HInstanceFieldSet*> stores(allocator.Adapter(kArenaAllocMisc));
+  bool has_common_field_access = false;
+  bool has_common_fence = false;
+
+  for (const HUseListNode<HInstruction*>& use : new_instance->GetUses()) {
+    HInstruction* user = use.GetUser();
+    HBasicBlock* entry = region_entries[user->GetBlock()->GetBlockId()];
+    if (entry != nullptr && !user->IsPhi()) {
+      if (!materializable_entries.IsBitSet(entry->GetBlockId())) {
+        return false;
+      }
+      uncommon_uses.push_back(std::make_pair(user, use.GetIndex()));
+    } else if (IsRemovableFieldAccess(new_instance, user)) {
+      if (user->IsConstructorFence()) {
+        has_common_fence = true;
+        continue;
+      }
+      has_common_field_access = true;
+      if (user->IsInstanceFieldSet()) {
+        HInstanceFieldSet* store = user->AsInstanceFieldSet();
+        MemberOffset offset = store->GetFieldOffset();
+        if (std::none_of(stores.begin(),
+                         stores.end(),
+                         [offset](HInstanceFieldSet* other) {
+                           return other->GetFieldOffset().SizeValue() == offset.SizeValue();
+                         })) {
+          stores.push_back(store);
+        }
+      }
+    } else {
+      // The allocation escapes, or is aliased, in common code.
+      return false;
+    }
+  }
+  for (const HUseListNode<HEnvironment*>& use : new_instance->GetEnvUses()) {
+    HInstruction* holder = use.GetUser()->GetHolder();
+    HBasicBlock* entry = region_entries[holder->GetBlock()->GetBlockId()];
+    if (entry != nullptr) {
+      if (!materializable_entries.IsBitSet(entry->GetBlockId())) {
+        return false;
+      }
+      uncommon_env_uses.push_back(std::make_pair(use.GetUser(), use.GetIndex()));
+    } else if (holder->IsDeoptimize()) {
+      // Deoptimization needs the object, so load-store elimination would keep it.
+      return false;
+    }
+  }
+  if (!has_common_field_access || uncommon_uses.empty()) {
+    // Nothing to scalar-replace, or nothing escaping: code sinking and load-store
+    // elimination already handle these.
+    return false;
+  }
+
+  ScopedArenaVector<HInstruction*> copies(
+      graph_->GetBlocks().size(), nullptr, allocator.Adapter(kArenaAllocMisc));
+  auto get_copy = [&](HBasicBlock* block) {
+    HBasicBlock* entry = region_entries[block->GetBlockId()];
+    HInstruction*& copy = copies[entry->GetBlockId()];
+    if (copy == nullptr) {
+      copy = Materialize(new_instance, stores, has_common_fence, entry);
+    }
+    return copy;
+  };
+  for (const std::pair<HInstruction*, size_t>& use : uncommon_uses) {
+    use.first->ReplaceInput(get_copy(use.first->GetBlock()), use.second);
+  }
+  for (const std::pair<HEnvironment*, size_t>& use : uncommon_env_uses) {
+    HEnvironment* user = use.first;
+    HInstruction* copy = get_copy(user->GetHolder()->GetBlock());
+    user->RemoveAsUserOfInput(use.second);
+    user->SetRawEnvAt(use.second, copy);
+    copy->AddEnvUseAt(user, use.second);
+  }
+  return true;
+}
+
+HInstruction* PartialEscapeMaterialization::Materialize(
+    HNewInstance* new_instance,
+    const ScopedArenaVector<HInstanceFieldSet*>& stores,
+    bool needs_fence,
+    HBasicBlock* entry) {
+  ArenaAllocator* allocator = graph_->GetAllocator();
+  HInstruction* cursor = entry->GetFirstInstruction();
+  HInstruction* copy = new_instance->Clone(allocator);
+  entry->InsertInstructionBefore(copy, cursor);
+  // Like a sunk allocation, the copy keeps the environment of the original.
+  copy->CopyEnvironmentFrom(new_instance->GetEnvironment());
+  for (HInstanceFieldSet* store : stores) {
+    const FieldInfo& info = store->GetFieldInfo();
+    // Load-store elimination replaces this load with the value of the field at the entry.
+    HInstanceFieldGet* load = new (allocator) HInstanceFieldGet(new_instance,
+                                                                info.GetField(),
+                                                                info.GetFieldType(),
+                                                                info.GetFieldOffset(),
+                                                                info.IsVolatile(),
+                                                                info.GetFieldIndex(),
+                                                                info.GetDeclaringClassDefIndex(),
+                                                                info.GetDexFile(),
+                                                                new_instance->GetDexPc());
+    if (info.GetFieldType() == DataType::Type::kReference) {
+      load->SetReferenceTypeInfo(graph_->GetInexactObjectRti());
+    }
+    entry->InsertInstructionBefore(load, cursor);
+    HInstanceFieldSet* copy_store = new (allocator) HInstanceFieldSet(
+        copy,
+        load,
+        info.GetField(),
+        info.GetFieldType(),
+        info.GetFieldOffset(),
+        info.IsVolatile(),
+        info.GetFieldIndex(),
+        info.GetDeclaringClassDefIndex(),
+        info.GetDexFile(),
+        new_instance->GetDexPc());
+    entry->InsertInstructionBefore(copy_store, cursor);
+  }
+  if (needs_fence) {
+    // The copy is published in the uncommon region, after its final fields are set.
+    entry->InsertInstructionBefore(
+        new (allocator) HConstructorFence(copy, new_instance->GetDexPc(), allocator), cursor);
+  }
+  return copy;
+}
+
+}  // namespace art
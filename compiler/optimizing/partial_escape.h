@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_PARTIAL_ESCAPE_H_
+#define ART_COMPILER_OPTIMIZING_PARTIAL_ESCAPE_H_
+
+#include "base/scoped_arena_containers.h"
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+class ArenaBitVector;
+
+/**
+ * Optimization pass giving allocations which only escape in uncommon branches a copy
+ * of their own in those branches, materialized from the field values of the original
+ * at the branch entry. The original allocation is then a singleton, which load-store
+ * elimination scalar-replaces on the common path, so that the object is only
+ * allocated when the uncommon branch is taken.
+ */
+class PartialEscapeMaterialization : public HOptimization {
+ public:
+  PartialEscapeMaterialization(HGraph* graph,
+                               OptimizingCompilerStats* stats,
+                               const char* name = kPartialEscapeMaterializationPassName)
+      : HOptimization(graph, name, stats) {}
+
+  void Run() OVERRIDE;
+
+  static constexpr const char* kPartialEscapeMaterializationPassName =
+      "partial_escape_materialization";
+
+ private:
+  // Try to replace the uses of `new_instance` in uncommon regions with copies at the
+  // region entries. `region_entries` maps uncommon blocks to the entry of their region,
+  // and common blocks to null. Only entries in `materializable_entries` can hold a copy.
+  bool TryMaterialize(HNewInstance* new_instance,
+                      const ArenaBitVector& materializable_entries,
+                      const ScopedArenaVector<HBasicBlock*>& region_entries);
+
+  // Insert a copy of `new_instance` at the start of `entry`, with the fields written by
+  // `stores` copied from it.
+  HInstruction* Materialize(HNewInstance* new_instance,
+                            const ScopedArenaVector<HInstanceFieldSet*>& stores,
+                            bool needs_fence,
+                            HBasicBlock* entry);
+
+  DISALLOW_COPY_AND_ASSIGN(PartialEscapeMaterialization);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_PARTIAL_ESCAPE_H_
@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_redundancy_elimination.h"
+
+#include "optimizing_compiler_stats.h"
+
+namespace art {
+
+// Returns the value of `input` of an instruction of `block` at the end of the
+// predecessor `predecessor_index`.
+static HInstruction* TranslateInput(HInstruction* input,
+                                    HBasicBlock* block,
+                                    size_t predecessor_index) {
+  return (input->IsPhi() && input->GetBlock() == block)
+      ? input->InputAt(predecessor_index)
+      : input;
+}
+
+// Returns whether `input` of an instruction of `block` is available at the end of
+// the predecessors of `block`.
+static bool IsAvailableAtPredecessors(HInstruction* input, HBasicBlock* block) {
+  return (input->IsPhi() && input->GetBlock() == block) ||
+         (input->GetBlock() != block && input->GetBlock()->Dominates(block));
+}
+
+static bool CanMoveToPredecessors(HInstruction* instruction, HBasicBlock* block) {
+  for (HInstruction* input : instruction->GetInputs()) {
+    if (!IsAvailableAtPredecessors(input, block)) {
+      return false;
+    }
+  }
+  for (HEnvironment* environment = instruction->GetEnvironment();
+       environment != nullptr;
+       environment = environment->GetParent()) {
+    for (size_t i = 0, e = environment->Size(); i < e; ++i) {
+      HInstruction* value = environment->GetInstructionAt(i);
+      if (value != nullptr && !IsAvailableAtPredecessors(value, block)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Returns an instruction at the end of the predecessor `predecessor_index` of the block
+// of `instruction` that computes the same value, or null if there is none.
+static HInstruction* FindValueAtEndOfPredecessor(HInstruction* instruction,
+                                                 size_t predecessor_index) {
+  HBasicBlock* block = instruction->GetBlock();
+  HBasicBlock* predecessor = block->GetPredecessors()[predecessor_index];
+  for (HInstruction* current = predecessor->GetLastInstruction();
+       current != nullptr;
+       current = current->GetPrevious()) {
+    if (current->GetKind() == instruction->GetKind() &&
+        current->GetType() == instruction->GetType() &&
+        current->CanBeMoved() &&
+        current->InstructionDataEquals(instruction)) {
+      bool same_inputs = true;
+      for (size_t i = 0, e = instruction->InputCount(); i < e; ++i) {
+        if (current->InputAt(i) !=
+            TranslateInput(instruction->InputAt(i), block, predecessor_index)) {
+          same_inputs = false;
+          break;
+        }
+      }
+      if (same_inputs) {
+        return current;
+      }
+    }
+    if (instruction->GetSideEffects().MayDependOn(current->GetSideEffects())) {
+      return nullptr;  // killed by a later write
+    }
+  }
+  return nullptr;
+}
+
+void PartialRedundancyElimination::Run() {
+  // Cloning throwing instructions into other blocks would need the catch
+  // information updated, and irreducible loops have no single entry to merge.
+  if (graph_->HasTryCatch() || graph_->HasIrreducibleLoops()) {
+    return;
+  }
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    // Critical edges are split, so both predecessors only flow into `block`,
+    // unless one of them is `block` itself.
+    if (block->GetPredecessors().size() == 2u &&
+        block->GetPredecessors()[0] != block &&
+        block->GetPredecessors()[1] != block) {
+      DCHECK_EQ(block->GetPredecessors()[0]->GetSingleSuccessor(), block);
+      DCHECK_EQ(block->GetPredecessors()[1]->GetSingleSuccessor(), block);
+      VisitMergeBlock(block);
+    }
+  }
+}
+
+void PartialRedundancyElimination::VisitMergeBlock(HBasicBlock* block) {
+  SideEffects skipped = SideEffects::None();
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (TryReplaceWithPhi(instruction, skipped)) {
+      MaybeRecordStat(stats_, MethodCompilationStat::kPartiallyRedundantInstructionRemoved);
+      continue;
+    }
+    // Later instructions cannot be moved above one that throws or writes.
+    if (instruction->CanThrow() || instruction->DoesAnyWrite()) {
+      return;
+    }
+    skipped = skipped.Union(instruction->GetSideEffects());
+  }
+}
+
+bool PartialRedundancyElimination::TryReplaceWithPhi(HInstruction* instruction,
+                                                     SideEffects skipped) {
+  HBasicBlock* block = instruction->GetBlock();
+  if (!instruction->CanBeMoved() ||
+      !instruction->IsClonable() ||
+      instruction->GetType() == DataType::Type::kVoid ||
+      instruction->GetSideEffects().MayDependOn(skipped) ||
+      skipped.MayDependOn(instruction->GetSideEffects()) ||
+      !CanMoveToPredecessors(instruction, block)) {
+    return false;
+  }
+  HInstruction* values[2] = {
+      FindValueAtEndOfPredecessor(instruction, 0u),
+      FindValueAtEndOfPredecessor(instruction, 1u)
+  };
+  if (values[0] == nullptr && values[1] == nullptr) {
+    return false;
+  }
+  // Compute the value at the end of the path where it is missing.
+  for (size_t k = 0; k < 2u; ++k) {
+    if (values[k] != nullptr) {
+      continue;
+    }
+    HBasicBlock* predecessor = block->GetPredecessors()[k];
+    HInstruction* copy = instruction->Clone(graph_->GetAllocator());
+    for (size_t i = 0, e = copy->InputCount(); i < e; ++i) {
+      copy->SetRawInputAt(i, TranslateInput(instruction->InputAt(i), block, k));
+    }
+    predecessor->InsertInstructionBefore(copy, predecessor->GetLastInstruction());
+    if (instruction->HasEnvironment()) {
+      copy->CopyEnvironmentFrom(instruction->GetEnvironment());
+      for (HEnvironment* environment = copy->GetEnvironment();
+           environment != nullptr;
+           environment = environment->GetParent()) {
+        for (size_t i = 0, e = environment->Size(); i < e; ++i) {
+          HInstruction* value = environment->GetInstructionAt(i);
+          if (value != nullptr && value->IsPhi() && value->GetBlock() == block) {
+            environment->RemoveAsUserOfInput(i);
+            environment->SetRawEnvAt(i, value->InputAt(k));
+            value->InputAt(k)->AddEnvUseAt(environment, i);
+          }
+        }
+      }
+    }
+    values[k] = copy;
+  }
+  if (instruction->HasUses()) {
+    ArenaAllocator* allocator = graph_->GetAllocator();
+    HPhi* phi = new (allocator) HPhi(allocator,
+                                     kNoRegNumber,
+                                     0,
+                                     HPhi::ToPhiType(instruction->GetType()));
+    phi->AddInput(values[0]);
+    phi->AddInput(values[1]);
+    if (instruction->GetType() == DataType::Type::kReference) {
+      phi->SetReferenceTypeInfo(instruction->GetReferenceTypeInfo());
+      phi->SetCanBeNull(instruction->CanBeNull());
+    }
+    block->AddPhi(phi);
+    instruction->ReplaceWith(phi);
+  }
+  block->RemoveInstruction(instruction);
+  return true;
+}
+
+}  // namespace art
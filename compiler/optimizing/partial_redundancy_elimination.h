@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_PARTIAL_REDUNDANCY_ELIMINATION_H_
+#define ART_COMPILER_OPTIMIZING_PARTIAL_REDUNDANCY_ELIMINATION_H_
+
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+/**
+ * Optimization pass removing instructions of a merge block that are already computed
+ * on one of its two incoming paths, as with a class load or a field load on one side of
+ * a diamond, or at the end of a loop body for the next iteration. The instruction is
+ * computed at the end of the other path instead, and replaced by a phi of both values.
+ * This complements GVN, which only removes fully redundant instructions.
+ */
+class PartialRedundancyElimination : public HOptimization {
+ public:
+  PartialRedundancyElimination(HGraph* graph,
+                               OptimizingCompilerStats* stats,
+                               const char* name = kPartialRedundancyEliminationPassName)
+      : HOptimization(graph, name, stats) {}
+
+  void Run() OVERRIDE;
+
+  static constexpr const char* kPartialRedundancyEliminationPassName =
+      "partial_redundancy_elimination";
+
+ private:
+  // Try to remove the partially redundant instructions at the start of `block`.
+  void VisitMergeBlock(HBasicBlock* block);
+
+  // Try to replace `instruction` of the merge block by a phi of its values on both paths.
+  // `skipped` holds the side effects of the instructions left before it in the block.
+  bool TryReplaceWithPhi(HInstruction* instruction, SideEffects skipped);
+
+  DISALLOW_COPY_AND_ASSIGN(PartialRedundancyElimination);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_PARTIAL_REDUNDANCY_ELIMINATION_H_
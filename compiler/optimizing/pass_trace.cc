@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pass_trace.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "base/logging.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+static constexpr char kPassTraceMagic[] = { 'A', 'R', 'T', 'P', 'T', 'R', 'C', '1' };
+
+template <typename T>
+static void AppendLE(std::string* record, T value) {
+  for (size_t i = 0; i != sizeof(T); ++i) {
+    record->push_back(static_cast<char>(static_cast<uint64_t>(value) >> (8 * i)));
+  }
+}
+
+static void AppendString(std::string* record, const std::string& str) {
+  size_t length = std::min<size_t>(str.size(), std::numeric_limits<uint16_t>::max());
+  AppendLE<uint16_t>(record, length);
+  record->append(str, 0u, length);
+}
+
+PassTraceWriter::PassTraceWriter(const std::string& file_name)
+    : lock_("pass trace lock"),
+      output_(file_name, std::ofstream::out | std::ofstream::binary) {
+  if (!output_) {
+    LOG(WARNING) << "Could not open pass trace file " << file_name;
+  }
+  output_.write(kPassTraceMagic, sizeof(kPassTraceMagic));
+}
+
+uint16_t PassTraceWriter::GetPassId(const char* pass_name, /*inout*/ std::string* record) {
+  auto it = pass_ids_.find(pass_name);
+  if (it != pass_ids_.end()) {
+    return it->second;
+  }
+  DCHECK_LT(pass_ids_.size(), std::numeric_limits<uint16_t>::max());
+  uint16_t id = static_cast<uint16_t>(pass_ids_.size());
+  pass_ids_.emplace(pass_name, id);
+  record->push_back(static_cast<char>(kPassNameRecord));
+  AppendLE<uint16_t>(record, id);
+  AppendString(record, pass_name);
+  return id;
+}
+
+void PassTraceWriter::WriteMethod(const std::string& method_name,
+                                  const std::vector<PassEntry>& passes) {
+  // Build the record outside of the lock, except for the pass ids.
+  std::string method_record;
+  method_record.push_back(static_cast<char>(kMethodRecord));
+  AppendString(&method_record, method_name);
+  size_t num_passes = std::min<size_t>(passes.size(), std::numeric_limits<uint16_t>::max());
+  AppendLE<uint16_t>(&method_record, num_passes);
+
+  MutexLock mu(Thread::Current(), lock_);
+  std::string record;
+  for (size_t i = 0; i != num_passes; ++i) {
+    const PassEntry& entry = passes[i];
+    AppendLE<uint16_t>(&method_record, GetPassId(entry.pass_name, &record));
+    AppendLE<uint64_t>(&method_record, entry.time_ns);
+    AppendLE<int32_t>(&method_record, entry.instruction_delta);
+    AppendLE<uint32_t>(&method_record, entry.arena_bytes);
+  }
+  // Pass names are defined before the method record using them.
+  record += method_record;
+  output_.write(record.data(), record.size());
+}
+
+}  // namespace art
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_PASS_TRACE_H_
+#define ART_COMPILER_OPTIMIZING_PASS_TRACE_H_
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art {
+
+/**
+ * Writer of the compact binary trace of the optimizing passes requested with
+ * --dump-pass-trace. Unlike --dump-cfg, only a few numbers are recorded per pass, so the
+ * trace can be collected for every method of a full dex2oat run.
+ *
+ * The file starts with the magic "ARTPTRC1", followed by records starting with a one byte
+ * tag. All integers are little-endian.
+ *  - kPassNameRecord: u16 pass id, u16 length, name. Defines a pass id, once per file.
+ *  - kMethodRecord: u16 length, method name, u16 number of passes, then for each pass in
+ *    the order the passes ended: u16 pass id, u64 wall time in nanoseconds, s32 change of
+ *    the number of instructions and phis in the graph, u32 bytes allocated in the graph
+ *    arena.
+ *
+ * tools/pass_trace_summary.py aggregates the trace.
+ */
+class PassTraceWriter {
+ public:
+  struct PassEntry {
+    const char* pass_name;
+    uint64_t time_ns;
+    int32_t instruction_delta;
+    uint32_t arena_bytes;
+  };
+
+  explicit PassTraceWriter(const std::string& file_name);
+
+  // Append the passes run for `method_name`. Called once per compiled method.
+  void WriteMethod(const std::string& method_name, const std::vector<PassEntry>& passes)
+      REQUIRES(!lock_);
+
+ private:
+  static constexpr uint8_t kPassNameRecord = 1u;
+  static constexpr uint8_t kMethodRecord = 2u;
+
+  // Return the id of `pass_name`, appending its definition to `record` the first time.
+  uint16_t GetPassId(const char* pass_name, /*inout*/ std::string* record) REQUIRES(lock_);
+
+  Mutex lock_;
+  std::ofstream output_ GUARDED_BY(lock_);
+  std::map<std::string, uint16_t> pass_ids_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(PassTraceWriter);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_PASS_TRACE_H_
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "read_barrier_elimination.h"
+
+#include "optimizing_compiler_stats.h"
+
+namespace art {
+
+// Returns whether the thread may be suspended for a collection at `instruction`.
+static bool IsGcPoint(HInstruction* instruction) {
+  if (instruction->IsNullCheck() ||
+      instruction->IsBoundsCheck() ||
+      instruction->IsDivZeroCheck()) {
+    // Only call the runtime to throw, and the code that follows is then not executed.
+    return false;
+  }
+  return instruction->GetSideEffects().Includes(SideEffects::CanTriggerGC()) ||
+         instruction->NeedsEnvironment() ||
+         instruction->IsInvoke() ||
+         instruction->IsSuspendCheck();
+}
+
+void ReadBarrierElimination::Run() {
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    // Allocations are GC points themselves, so there is at most one object allocated
+    // since the last GC point of the block.
+    HInstruction* allocated = nullptr;
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->GetType() == DataType::Type::kReference &&
+          allocated != nullptr &&
+          instruction->InputCount() != 0u &&
+          instruction->InputAt(0) == allocated) {
+        if (instruction->IsInstanceFieldGet()) {
+          instruction->AsInstanceFieldGet()->SetReadBarrierFree();
+          MaybeRecordStat(stats_, MethodCompilationStat::kReadBarrierRemoved);
+        } else if (instruction->IsArrayGet()) {
+          instruction->AsArrayGet()->SetReadBarrierFree();
+          MaybeRecordStat(stats_, MethodCompilationStat::kReadBarrierRemoved);
+        }
+      }
+      if (IsGcPoint(instruction)) {
+        allocated = (instruction->IsNewInstance() || instruction->IsNewArray())
+            ? instruction
+            : nullptr;
+      }
+    }
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_READ_BARRIER_ELIMINATION_H_
+#define ART_COMPILER_OPTIMIZING_READ_BARRIER_ELIMINATION_H_
+
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+/**
+ * Optimization pass marking the reference loads that do not need a read barrier, because
+ * they read from an object allocated in the same block with no GC point in between. No
+ * collection can start before the next GC point, so the object is in the to-space and not
+ * gray, and its reference fields only hold null or to-space references stored since.
+ *
+ * The pass must run after all the passes that move instructions, as moving a GC point
+ * between the allocation and the load would break this property.
+ */
+class ReadBarrierElimination : public HOptimization {
+ public:
+  ReadBarrierElimination(HGraph* graph,
+                         OptimizingCompilerStats* stats,
+                         const char* name = kReadBarrierEliminationPassName)
+      : HOptimization(graph, name, stats) {}
+
+  void Run() OVERRIDE;
+
+  static constexpr const char* kReadBarrierEliminationPassName = "read_barrier_elimination";
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ReadBarrierElimination);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_READ_BARRIER_ELIMINATION_H_
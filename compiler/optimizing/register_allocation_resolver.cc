@@ -306,7 +306,10 @@ void RegisterAllocationResolver::ConnectSiblings(LiveInterval* interval) {
     switch (interval->NumberOfSpillSlotsNeeded()) {
       case 1: loc = Location::StackSlot(interval->GetParent()->GetSpillSlot()); break;
       case 2: loc = Location::DoubleStackSlot(interval->GetParent()->GetSpillSlot()); break;
-      case 4: loc = Location::SIMDStackSlot(interval->GetParent()->GetSpillSlot()); break;
+      case 4:
+      case LiveInterval::kWideSIMDSpillSlots:
+        loc = Location::SIMDStackSlot(interval->GetParent()->GetSpillSlot());
+        break;
       default: LOG(FATAL) << "Unexpected number of spill slots"; UNREACHABLE();
     }
     InsertMoveAfter(interval->GetDefinedBy(), interval->ToLocation(), loc);
@@ -469,7 +472,10 @@ void RegisterAllocationResolver::ConnectSplitSiblings(LiveInterval* interval,
       switch (parent->NumberOfSpillSlotsNeeded()) {
         case 1: location_source = Location::StackSlot(parent->GetSpillSlot()); break;
         case 2: location_source = Location::DoubleStackSlot(parent->GetSpillSlot()); break;
-        case 4: location_source = Location::SIMDStackSlot(parent->GetSpillSlot()); break;
+        case 4:
+        case LiveInterval::kWideSIMDSpillSlots:
+          location_source = Location::SIMDStackSlot(parent->GetSpillSlot());
+          break;
         default: LOG(FATAL) << "Unexpected number of spill slots"; UNREACHABLE();
       }
     }
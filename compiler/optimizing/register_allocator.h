@@ -40,7 +40,10 @@ class RegisterAllocator : public DeletableArenaObject<kArenaAllocRegisterAllocat
  public:
   enum Strategy {
     kRegisterAllocatorLinearScan,
-    kRegisterAllocatorGraphColor
+    kRegisterAllocatorGraphColor,
+    // Graph coloring for the loops of hot methods, linear scan otherwise. Resolved by the
+    // compiler for each method, before creating the allocator.
+    kRegisterAllocatorAuto
   };
 
   static constexpr Strategy kRegisterAllocatorDefault = kRegisterAllocatorLinearScan;
@@ -72,11 +72,20 @@ static size_t LoopDepthAt(HBasicBlock* block) {
   return depth;
 }
 
+// Whether `block` only runs when an exception is thrown, so that moves there are nearly free
+// even inside loops.
+static bool IsExceptionalBlock(HBasicBlock* block) {
+  return block->IsCatchBlock() || block->GetLastInstruction()->IsThrow();
+}
+
 // Return the runtime cost of inserting a move instruction at the specified location.
 static size_t CostForMoveAt(size_t position, const SsaLivenessAnalysis& liveness) {
   HBasicBlock* block = liveness.GetBlockFromPosition(position / 2);
   DCHECK(block != nullptr);
   size_t cost = 1;
+  if (IsExceptionalBlock(block)) {
+    return cost;
+  }
   if (block->IsSingleJump()) {
     cost *= kSingleJumpBlockWeightMultiplier;
   }
@@ -31,6 +31,15 @@
 #include "scheduler_arm.h"
 #endif
 
+#ifdef ART_ENABLE_CODEGEN_x86
+#include "code_generator_x86.h"
+#include "scheduler_x86.h"
+#endif
+
+#ifdef ART_ENABLE_CODEGEN_x86_64
+#include "code_generator_x86_64.h"
+#endif
+
 namespace art {
 
 void SchedulingGraph::AddDependency(SchedulingNode* node,
@@ -773,7 +782,8 @@ bool HScheduler::IsSchedulingBarrier(const HInstruction* instr) const {
 
 void HInstructionScheduling::Run(bool only_optimize_loop_blocks,
                                  bool schedule_randomly) {
-#if defined(ART_ENABLE_CODEGEN_arm64) || defined(ART_ENABLE_CODEGEN_arm)
+#if defined(ART_ENABLE_CODEGEN_arm64) || defined(ART_ENABLE_CODEGEN_arm) || \
+    defined(ART_ENABLE_CODEGEN_x86)
   // Phase-local allocator that allocates scheduler internal data structures like
   // scheduling nodes, internel nodes map, dependencies, etc.
   ScopedArenaAllocator allocator(graph_->GetArenaStack());
@@ -807,6 +817,28 @@ void HInstructionScheduling::Run(bool only_optimize_loop_blocks,
       scheduler.Schedule(graph_);
       break;
     }
+#endif
+#if defined(ART_ENABLE_CODEGEN_x86)
+    case InstructionSet::kX86: {
+      const X86InstructionSetFeatures* features = (codegen_ == nullptr)
+          ? nullptr
+          : &down_cast<x86::CodeGeneratorX86*>(codegen_)->GetInstructionSetFeatures();
+      x86::HSchedulerX86 scheduler(&allocator, selector, features);
+      scheduler.SetOnlyOptimizeLoopBlocks(only_optimize_loop_blocks);
+      scheduler.Schedule(graph_);
+      break;
+    }
+#endif
+#if defined(ART_ENABLE_CODEGEN_x86_64)
+    case InstructionSet::kX86_64: {
+      const X86InstructionSetFeatures* features = (codegen_ == nullptr)
+          ? nullptr
+          : &down_cast<x86_64::CodeGeneratorX86_64*>(codegen_)->GetInstructionSetFeatures();
+      x86::HSchedulerX86 scheduler(&allocator, selector, features);
+      scheduler.SetOnlyOptimizeLoopBlocks(only_optimize_loop_blocks);
+      scheduler.Schedule(graph_);
+      break;
+    }
 #endif
     default:
       break;
@@ -34,6 +34,10 @@
 #include "scheduler_arm.h"
 #endif
 
+#ifdef ART_ENABLE_CODEGEN_x86
+#include "scheduler_x86.h"
+#endif
+
 namespace art {
 
 // Return all combinations of ISA and code generator that are executable on
@@ -379,6 +383,37 @@ TEST_F(SchedulerTest, ArrayAccessAliasingARM) {
 }
 #endif
 
+#if defined(ART_ENABLE_CODEGEN_x86)
+TEST_F(SchedulerTest, DependencyGraphAndSchedulerX86) {
+  CriticalPathSchedulingNodeSelector critical_path_selector;
+  x86::HSchedulerX86 scheduler(GetScopedAllocator(),
+                               &critical_path_selector,
+                               /*features*/ nullptr);
+  TestBuildDependencyGraphAndSchedule(&scheduler);
+}
+
+TEST_F(SchedulerTest, ArrayAccessAliasingX86) {
+  CriticalPathSchedulingNodeSelector critical_path_selector;
+  x86::HSchedulerX86 scheduler(GetScopedAllocator(),
+                               &critical_path_selector,
+                               /*features*/ nullptr);
+  TestDependencyGraphOnAliasingArrayAccesses(&scheduler);
+}
+
+TEST_F(SchedulerTest, LatencyTableSelectionX86) {
+  std::string error_msg;
+  std::unique_ptr<const X86InstructionSetFeatures> silvermont(
+      X86InstructionSetFeatures::FromVariant("silvermont", &error_msg));
+  ASSERT_TRUE(silvermont != nullptr) << error_msg;
+  std::unique_ptr<const X86InstructionSetFeatures> kabylake(
+      X86InstructionSetFeatures::FromVariant("kabylake", &error_msg));
+  ASSERT_TRUE(kabylake != nullptr) << error_msg;
+  EXPECT_EQ(&x86::kX86AtomLatencies, &x86::GetX86SchedulingLatencies(silvermont.get()));
+  EXPECT_EQ(&x86::kX86CoreLatencies, &x86::GetX86SchedulingLatencies(kabylake.get()));
+  EXPECT_EQ(&x86::kX86CoreLatencies, &x86::GetX86SchedulingLatencies(nullptr));
+}
+#endif
+
 TEST_F(SchedulerTest, RandomScheduling) {
   //
   // Java source: crafted code to make sure (random) scheduling should get correct result.
@@ -0,0 +1,452 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scheduler_x86.h"
+
+#include "code_generator_utils.h"
+#include "mirror/string.h"
+
+namespace art {
+namespace x86 {
+
+// Atom-class cores (Bonnell, Silvermont, Goldmont). Loads have a long
+// load-to-use latency, and the integer and floating point dividers are slow
+// and not pipelined, so spacing their uses pays off the most here.
+const X86SchedulingLatencies kX86AtomLatencies = {
+  /* memory_load */ 4,
+  /* memory_store */ 3,
+  /* call_internal */ 10,
+  /* call */ 5,
+  /* integer_op */ 1,
+  /* floating_point_op */ 3,
+  /* mul_integer */ 3,
+  /* mul_long_extra */ 2,
+  /* mul_floating_point */ 5,
+  /* div_integer */ 25,
+  /* div_long_extra */ 20,
+  /* div_float */ 19,
+  /* div_double */ 34,
+  /* load_string_internal */ 7,
+  /* type_conversion_floating_point_integer */ 5,
+  /* simd_integer_op */ 2,
+  /* simd_floating_point_op */ 3,
+  /* simd_mul_integer */ 11,
+  /* simd_mul_floating_point */ 5,
+  /* simd_div_float */ 39,
+  /* simd_div_double */ 69,
+  /* simd_memory_load */ 4,
+  /* simd_memory_store */ 3,
+  /* simd_replicate_op */ 4,
+  /* simd_type_conversion */ 5,
+};
+
+// Core-class cores (Haswell and later). Out-of-order execution hides most of
+// the short latencies; the dividers and multiplies still matter.
+const X86SchedulingLatencies kX86CoreLatencies = {
+  /* memory_load */ 5,
+  /* memory_store */ 1,
+  /* call_internal */ 10,
+  /* call */ 5,
+  /* integer_op */ 1,
+  /* floating_point_op */ 4,
+  /* mul_integer */ 3,
+  /* mul_long_extra */ 0,
+  /* mul_floating_point */ 4,
+  /* div_integer */ 26,
+  /* div_long_extra */ 16,
+  /* div_float */ 11,
+  /* div_double */ 14,
+  /* load_string_internal */ 7,
+  /* type_conversion_floating_point_integer */ 5,
+  /* simd_integer_op */ 1,
+  /* simd_floating_point_op */ 4,
+  /* simd_mul_integer */ 10,
+  /* simd_mul_floating_point */ 4,
+  /* simd_div_float */ 11,
+  /* simd_div_double */ 14,
+  /* simd_memory_load */ 6,
+  /* simd_memory_store */ 1,
+  /* simd_replicate_op */ 3,
+  /* simd_type_conversion */ 4,
+};
+
+// Select the latency table matching the microarchitecture described by `features`.
+// None of the Atom-class cores implement AVX, so its presence is used to tell
+// the two families apart. Without features information, assume a Core-class CPU.
+const X86SchedulingLatencies& GetX86SchedulingLatencies(
+    const X86InstructionSetFeatures* features) {
+  if (features == nullptr || features->HasAVX() || features->HasAVX2()) {
+    return kX86CoreLatencies;
+  }
+  return kX86AtomLatencies;
+}
+
+void SchedulingLatencyVisitorX86::VisitBinaryOperation(HBinaryOperation* instr) {
+  last_visited_latency_ = DataType::IsFloatingPointType(instr->GetResultType())
+      ? latencies_.floating_point_op
+      : latencies_.integer_op;
+}
+
+void SchedulingLatencyVisitorX86::VisitAndNot(HAndNot* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.integer_op;
+}
+
+void SchedulingLatencyVisitorX86::VisitAndNeg(HAndNeg* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.integer_op;
+}
+
+void SchedulingLatencyVisitorX86::VisitBitwiseAddRight(HBitwiseAddRight* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.integer_op;
+}
+
+void SchedulingLatencyVisitorX86::VisitX86BoundsCheckMemory(
+    HX86BoundsCheckMemory* ATTRIBUTE_UNUSED) {
+  // The array length is read as part of the compare.
+  last_visited_internal_latency_ = latencies_.memory_load;
+  // Users do not use any data results.
+  last_visited_latency_ = 0;
+}
+
+#ifdef ART_ENABLE_CODEGEN_x86
+void SchedulingLatencyVisitorX86::VisitX86LoadFromConstantTable(
+    HX86LoadFromConstantTable* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorX86::VisitX86FPNeg(HX86FPNeg* ATTRIBUTE_UNUSED) {
+  // The sign mask is loaded from the constant area.
+  last_visited_internal_latency_ = latencies_.memory_load;
+  last_visited_latency_ = latencies_.floating_point_op;
+}
+#endif
+
+void SchedulingLatencyVisitorX86::VisitArrayGet(HArrayGet* ATTRIBUTE_UNUSED) {
+  // x86 folds the scaled index into the addressing mode.
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorX86::VisitArrayLength(HArrayLength* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorX86::VisitArraySet(HArraySet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.memory_store;
+}
+
+void SchedulingLatencyVisitorX86::VisitBoundsCheck(HBoundsCheck* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = latencies_.integer_op;
+  // Users do not use any data results.
+  last_visited_latency_ = 0;
+}
+
+void SchedulingLatencyVisitorX86::HandleDivRemConstant(HBinaryOperation* instruction) {
+  // Follow the code path used by code generation.
+  int64_t imm = Int64FromConstant(instruction->GetRight()->AsConstant());
+  if (imm == 0) {
+    last_visited_internal_latency_ = 0;
+    last_visited_latency_ = 0;
+  } else if (imm == 1 || imm == -1) {
+    last_visited_internal_latency_ = 0;
+    last_visited_latency_ = latencies_.integer_op;
+  } else if (IsPowerOfTwo(AbsOrMin(imm))) {
+    last_visited_internal_latency_ = 3 * latencies_.integer_op;
+    last_visited_latency_ = latencies_.integer_op;
+  } else {
+    DCHECK(imm <= -2 || imm >= 2);
+    // Multiplication by the magic number followed by shifts and corrections.
+    last_visited_internal_latency_ = latencies_.mul_integer + 3 * latencies_.integer_op;
+    last_visited_latency_ = latencies_.integer_op;
+  }
+  if (IsWideIntegerType(instruction->GetResultType())) {
+    last_visited_internal_latency_ += latencies_.mul_long_extra;
+  }
+}
+
+void SchedulingLatencyVisitorX86::VisitDiv(HDiv* instr) {
+  DataType::Type type = instr->GetResultType();
+  switch (type) {
+    case DataType::Type::kFloat32:
+      last_visited_latency_ = latencies_.div_float;
+      break;
+    case DataType::Type::kFloat64:
+      last_visited_latency_ = latencies_.div_double;
+      break;
+    default:
+      if (instr->GetRight()->IsConstant()) {
+        HandleDivRemConstant(instr);
+      } else {
+        last_visited_latency_ = latencies_.div_integer;
+        if (IsWideIntegerType(type)) {
+          last_visited_latency_ += latencies_.div_long_extra;
+        }
+      }
+      break;
+  }
+}
+
+void SchedulingLatencyVisitorX86::VisitRem(HRem* instruction) {
+  DataType::Type type = instruction->GetResultType();
+  if (DataType::IsFloatingPointType(type)) {
+    // Floating point remainder is computed with an x87 `fprem` loop.
+    last_visited_internal_latency_ = latencies_.call_internal;
+    last_visited_latency_ = latencies_.call;
+  } else if (instruction->GetRight()->IsConstant()) {
+    HandleDivRemConstant(instruction);
+    // The remainder is recovered from the quotient.
+    last_visited_internal_latency_ += latencies_.mul_integer;
+  } else {
+    // `idiv` produces the remainder together with the quotient.
+    last_visited_latency_ = latencies_.div_integer;
+    if (IsWideIntegerType(type)) {
+      last_visited_latency_ += latencies_.div_long_extra;
+    }
+  }
+}
+
+void SchedulingLatencyVisitorX86::VisitInstanceFieldGet(HInstanceFieldGet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorX86::VisitInstanceOf(HInstanceOf* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = latencies_.call_internal;
+  last_visited_latency_ = latencies_.integer_op;
+}
+
+void SchedulingLatencyVisitorX86::VisitInvoke(HInvoke* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = latencies_.call_internal;
+  last_visited_latency_ = latencies_.call;
+}
+
+void SchedulingLatencyVisitorX86::VisitLoadString(HLoadString* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = latencies_.load_string_internal;
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorX86::VisitMul(HMul* instr) {
+  DataType::Type type = instr->GetResultType();
+  if (DataType::IsFloatingPointType(type)) {
+    last_visited_latency_ = latencies_.mul_floating_point;
+  } else {
+    last_visited_latency_ = latencies_.mul_integer;
+    if (IsWideIntegerType(type)) {
+      last_visited_latency_ += latencies_.mul_long_extra;
+    }
+  }
+}
+
+void SchedulingLatencyVisitorX86::VisitNewArray(HNewArray* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = latencies_.integer_op + latencies_.call_internal;
+  last_visited_latency_ = latencies_.call;
+}
+
+void SchedulingLatencyVisitorX86::VisitNewInstance(HNewInstance* instruction) {
+  if (instruction->IsStringAlloc()) {
+    last_visited_internal_latency_ = 2 + latencies_.memory_load + latencies_.call_internal;
+  } else {
+    last_visited_internal_latency_ = latencies_.call_internal;
+  }
+  last_visited_latency_ = latencies_.call;
+}
+
+void SchedulingLatencyVisitorX86::VisitStaticFieldGet(HStaticFieldGet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorX86::VisitSuspendCheck(HSuspendCheck* instruction) {
+  HBasicBlock* block = instruction->GetBlock();
+  DCHECK((block->GetLoopInformation() != nullptr) ||
+         (block->IsEntryBlock() && instruction->GetNext()->IsGoto()));
+  // Users do not use any data results.
+  last_visited_latency_ = 0;
+}
+
+void SchedulingLatencyVisitorX86::VisitTypeConversion(HTypeConversion* instr) {
+  if (DataType::IsFloatingPointType(instr->GetResultType()) ||
+      DataType::IsFloatingPointType(instr->GetInputType())) {
+    last_visited_latency_ = latencies_.type_conversion_floating_point_integer;
+  } else {
+    last_visited_latency_ = latencies_.integer_op;
+  }
+}
+
+void SchedulingLatencyVisitorX86::HandleSimpleArithmeticSIMD(HVecOperation* instr) {
+  if (DataType::IsFloatingPointType(instr->GetPackedType())) {
+    last_visited_latency_ = latencies_.simd_floating_point_op;
+  } else {
+    last_visited_latency_ = latencies_.simd_integer_op;
+  }
+}
+
+void SchedulingLatencyVisitorX86::VisitVecReplicateScalar(
+    HVecReplicateScalar* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_replicate_op;
+}
+
+void SchedulingLatencyVisitorX86::VisitVecExtractScalar(HVecExtractScalar* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86::VisitVecReduce(HVecReduce* instr) {
+  // Reductions are emitted as a sequence of horizontal operations.
+  HandleSimpleArithmeticSIMD(instr);
+  last_visited_internal_latency_ = 2 * last_visited_latency_;
+}
+
+void SchedulingLatencyVisitorX86::VisitVecAnyTrue(HVecAnyTrue* instr ATTRIBUTE_UNUSED) {
+  // The byte mask is moved to a core register and then turned into a boolean.
+  last_visited_internal_latency_ = latencies_.simd_integer_op;
+  last_visited_latency_ = 2 * latencies_.integer_op;
+}
+
+void SchedulingLatencyVisitorX86::VisitVecCnv(HVecCnv* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_type_conversion;
+}
+
+void SchedulingLatencyVisitorX86::VisitVecNeg(HVecNeg* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86::VisitVecAbs(HVecAbs* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86::VisitVecSqrt(HVecSqrt* instr) {
+  // The square root runs on the divider.
+  if (instr->GetPackedType() == DataType::Type::kFloat32) {
+    last_visited_latency_ = latencies_.simd_div_float;
+  } else {
+    DCHECK(instr->GetPackedType() == DataType::Type::kFloat64);
+    last_visited_latency_ = latencies_.simd_div_double;
+  }
+}
+
+void SchedulingLatencyVisitorX86::VisitVecNot(HVecNot* instr) {
+  if (instr->GetPackedType() == DataType::Type::kBool) {
+    last_visited_internal_latency_ = latencies_.simd_integer_op;
+  }
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorX86::VisitVecAdd(HVecAdd* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86::VisitVecHalvingAdd(HVecHalvingAdd* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86::VisitVecSub(HVecSub* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86::VisitVecMul(HVecMul* instr) {
+  if (DataType::IsFloatingPointType(instr->GetPackedType())) {
+    last_visited_latency_ = latencies_.simd_mul_floating_point;
+  } else {
+    last_visited_latency_ = latencies_.simd_mul_integer;
+  }
+}
+
+void SchedulingLatencyVisitorX86::VisitVecDiv(HVecDiv* instr) {
+  if (instr->GetPackedType() == DataType::Type::kFloat32) {
+    last_visited_latency_ = latencies_.simd_div_float;
+  } else {
+    DCHECK(instr->GetPackedType() == DataType::Type::kFloat64);
+    last_visited_latency_ = latencies_.simd_div_double;
+  }
+}
+
+void SchedulingLatencyVisitorX86::VisitVecMin(HVecMin* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86::VisitVecMax(HVecMax* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86::VisitVecAnd(HVecAnd* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorX86::VisitVecAndNot(HVecAndNot* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorX86::VisitVecOr(HVecOr* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorX86::VisitVecXor(HVecXor* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorX86::VisitVecShl(HVecShl* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86::VisitVecShr(HVecShr* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86::VisitVecUShr(HVecUShr* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86::VisitVecCondition(HVecCondition* instr) {
+  // The first operand is copied to the result, which may also be inverted.
+  last_visited_internal_latency_ = latencies_.simd_integer_op;
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86::VisitVecSetScalars(HVecSetScalars* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86::VisitVecSelect(HVecSelect* instr ATTRIBUTE_UNUSED) {
+  // Blended with a sequence of three dependent logical operations.
+  last_visited_internal_latency_ = 2 * latencies_.simd_integer_op;
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorX86::HandleVecAddress(HVecMemoryOperation* instruction) {
+  HInstruction* index = instruction->InputAt(1);
+  if (!index->IsConstant()) {
+    // The index is folded into the addressing mode, which costs an extra
+    // cycle of address generation on Atom-class cores.
+    last_visited_internal_latency_ += latencies_.integer_op;
+  }
+}
+
+void SchedulingLatencyVisitorX86::VisitVecLoad(HVecLoad* instr) {
+  last_visited_internal_latency_ = 0;
+  if (instr->GetPackedType() == DataType::Type::kUint16
+      && mirror::kUseStringCompression
+      && instr->IsStringCharAt()) {
+    // Set latencies for the uncompressed case.
+    last_visited_internal_latency_ += latencies_.memory_load + latencies_.integer_op;
+  }
+  HandleVecAddress(instr);
+  last_visited_latency_ = latencies_.simd_memory_load;
+}
+
+void SchedulingLatencyVisitorX86::VisitVecStore(HVecStore* instr) {
+  last_visited_internal_latency_ = 0;
+  HandleVecAddress(instr);
+  last_visited_latency_ = latencies_.simd_memory_store;
+}
+
+}  // namespace x86
+}  // namespace art
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_SCHEDULER_X86_H_
+#define ART_COMPILER_OPTIMIZING_SCHEDULER_X86_H_
+
+#include "arch/x86/instruction_set_features_x86.h"
+#include "scheduler.h"
+
+namespace art {
+namespace x86 {
+
+// Instruction latencies for one x86 microarchitecture family.
+// The scheduler is shared between x86 and x86-64, so the tables describe the
+// 32-bit forms; 64-bit forms of multiplication and division are accounted for
+// in the visitor.
+struct X86SchedulingLatencies {
+  uint32_t memory_load;
+  uint32_t memory_store;
+  uint32_t call_internal;
+  uint32_t call;
+  uint32_t integer_op;
+  uint32_t floating_point_op;
+  uint32_t mul_integer;
+  uint32_t mul_long_extra;
+  uint32_t mul_floating_point;
+  uint32_t div_integer;
+  uint32_t div_long_extra;
+  uint32_t div_float;
+  uint32_t div_double;
+  uint32_t load_string_internal;
+  uint32_t type_conversion_floating_point_integer;
+  uint32_t simd_integer_op;
+  uint32_t simd_floating_point_op;
+  uint32_t simd_mul_integer;
+  uint32_t simd_mul_floating_point;
+  uint32_t simd_div_float;
+  uint32_t simd_div_double;
+  uint32_t simd_memory_load;
+  uint32_t simd_memory_store;
+  uint32_t simd_replicate_op;
+  uint32_t simd_type_conversion;
+};
+
+// Atom-class cores (Bonnell, Silvermont, Goldmont).
+extern const X86SchedulingLatencies kX86AtomLatencies;
+// Core-class cores (Haswell and later).
+extern const X86SchedulingLatencies kX86CoreLatencies;
+
+// Select the latency table matching the microarchitecture described by `features`.
+const X86SchedulingLatencies& GetX86SchedulingLatencies(const X86InstructionSetFeatures* features);
+
+class SchedulingLatencyVisitorX86 : public SchedulingLatencyVisitor {
+ public:
+  explicit SchedulingLatencyVisitorX86(const X86InstructionSetFeatures* features)
+      : latencies_(GetX86SchedulingLatencies(features)) {}
+
+  // Default visitor for instructions not handled specifically below.
+  void VisitInstruction(HInstruction* ATTRIBUTE_UNUSED) {
+    last_visited_latency_ = latencies_.integer_op;
+  }
+
+// We add a second unused parameter to be able to use this macro like the others
+// defined in `nodes.h`.
+#define FOR_EACH_SCHEDULED_X86_COMMON_INSTRUCTION(M) \
+  M(ArrayGet             , unused)                   \
+  M(ArrayLength          , unused)                   \
+  M(ArraySet             , unused)                   \
+  M(BinaryOperation      , unused)                   \
+  M(BoundsCheck          , unused)                   \
+  M(Div                  , unused)                   \
+  M(InstanceFieldGet     , unused)                   \
+  M(InstanceOf           , unused)                   \
+  M(Invoke               , unused)                   \
+  M(LoadString           , unused)                   \
+  M(Mul                  , unused)                   \
+  M(NewArray             , unused)                   \
+  M(NewInstance          , unused)                   \
+  M(Rem                  , unused)                   \
+  M(StaticFieldGet       , unused)                   \
+  M(SuspendCheck         , unused)                   \
+  M(TypeConversion       , unused)                   \
+  M(VecReplicateScalar   , unused)                   \
+  M(VecExtractScalar     , unused)                   \
+  M(VecReduce            , unused)                   \
+  M(VecAnyTrue           , unused)                   \
+  M(VecCnv               , unused)                   \
+  M(VecNeg               , unused)                   \
+  M(VecAbs               , unused)                   \
+  M(VecSqrt              , unused)                   \
+  M(VecNot               , unused)                   \
+  M(VecAdd               , unused)                   \
+  M(VecHalvingAdd        , unused)                   \
+  M(VecSub               , unused)                   \
+  M(VecMul               , unused)                   \
+  M(VecDiv               , unused)                   \
+  M(VecMin               , unused)                   \
+  M(VecMax               , unused)                   \
+  M(VecAnd               , unused)                   \
+  M(VecAndNot            , unused)                   \
+  M(VecOr                , unused)                   \
+  M(VecXor               , unused)                   \
+  M(VecShl               , unused)                   \
+  M(VecShr               , unused)                   \
+  M(VecUShr              , unused)                   \
+  M(VecCondition         , unused)                   \
+  M(VecSetScalars        , unused)                   \
+  M(VecSelect            , unused)                   \
+  M(VecLoad              , unused)                   \
+  M(VecStore             , unused)
+
+// `HX86ComputeBaseMethodAddress` is deliberately left out: it is only inserted
+// in the entry block and its position matters for the call/pop sequence.
+#define FOR_EACH_SCHEDULED_X86_INSTRUCTION(M)        \
+  M(AndNot               , unused)                   \
+  M(AndNeg               , unused)                   \
+  M(BitwiseAddRight      , unused)                   \
+  M(X86BoundsCheckMemory , unused)
+
+#ifdef ART_ENABLE_CODEGEN_x86
+#define FOR_EACH_SCHEDULED_X86_32_INSTRUCTION(M)     \
+  M(X86LoadFromConstantTable, unused)                \
+  M(X86FPNeg             , unused)
+#else
+#define FOR_EACH_SCHEDULED_X86_32_INSTRUCTION(M)
+#endif
+
+#define DECLARE_VISIT_INSTRUCTION(type, unused)  \
+  void Visit##type(H##type* instruction) OVERRIDE;
+
+  FOR_EACH_SCHEDULED_X86_COMMON_INSTRUCTION(DECLARE_VISIT_INSTRUCTION)
+  FOR_EACH_SCHEDULED_X86_INSTRUCTION(DECLARE_VISIT_INSTRUCTION)
+  FOR_EACH_SCHEDULED_X86_32_INSTRUCTION(DECLARE_VISIT_INSTRUCTION)
+
+#undef DECLARE_VISIT_INSTRUCTION
+
+ private:
+  bool IsWideIntegerType(DataType::Type type) const {
+    return type == DataType::Type::kInt64 || type == DataType::Type::kUint64;
+  }
+  void HandleDivRemConstant(HBinaryOperation* instruction);
+  void HandleSimpleArithmeticSIMD(HVecOperation* instr);
+  void HandleVecAddress(HVecMemoryOperation* instruction);
+
+  const X86SchedulingLatencies& latencies_;
+};
+
+class HSchedulerX86 : public HScheduler {
+ public:
+  HSchedulerX86(ScopedArenaAllocator* allocator,
+                SchedulingNodeSelector* selector,
+                const X86InstructionSetFeatures* features)
+      : HScheduler(allocator, &x86_latency_visitor_, selector),
+        x86_latency_visitor_(features) {}
+  ~HSchedulerX86() OVERRIDE {}
+
+  bool IsSchedulable(const HInstruction* instruction) const OVERRIDE {
+#define CASE_INSTRUCTION_KIND(type, unused) case \
+  HInstruction::InstructionKind::k##type:
+    switch (instruction->GetKind()) {
+      FOR_EACH_SCHEDULED_X86_INSTRUCTION(CASE_INSTRUCTION_KIND)
+        return true;
+      FOR_EACH_SCHEDULED_X86_32_INSTRUCTION(CASE_INSTRUCTION_KIND)
+        return true;
+      FOR_EACH_SCHEDULED_X86_COMMON_INSTRUCTION(CASE_INSTRUCTION_KIND)
+        return true;
+      default:
+        return HScheduler::IsSchedulable(instruction);
+    }
+#undef CASE_INSTRUCTION_KIND
+  }
+
+  // None of the XMM registers are callee saved, so every live vector value
+  // has to be spilled around a call. As on ARM64, do not reorder the vector
+  // instructions whose live ranges exceed the vectorized loop boundaries.
+  // An array load folded into its user reads memory at the user, so keep
+  // both in place: a store must not be moved between them.
+  bool IsSchedulingBarrier(const HInstruction* instr) const OVERRIDE {
+    return HScheduler::IsSchedulingBarrier(instr) ||
+           IsFoldedArrayLoadOrUser(instr) ||
+           instr->IsVecReduce() ||
+           instr->IsVecExtractScalar() ||
+           instr->IsVecSetScalars() ||
+           instr->IsVecReplicateScalar();
+  }
+
+ private:
+  static bool IsFoldedArrayLoadOrUser(const HInstruction* instr) {
+    if (instr->IsArrayGet() && instr->IsEmittedAtUseSite()) {
+      return true;
+    }
+    for (const HInstruction* input : instr->GetInputs()) {
+      if (input->IsArrayGet() && input->IsEmittedAtUseSite()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  SchedulingLatencyVisitorX86 x86_latency_visitor_;
+  DISALLOW_COPY_AND_ASSIGN(HSchedulerX86);
+};
+
+}  // namespace x86
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_SCHEDULER_X86_H_
@@ -200,9 +200,9 @@ HLoadClass::LoadKind HSharpening::ComputeLoadClassKind(
         } else {
           // Class not loaded yet. This happens when the dex code requesting
           // this `HLoadClass` hasn't been executed in the interpreter.
-          // Fallback to the dex cache.
-          // TODO(ngeoffray): Generate HDeoptimize instead.
-          desired_load_kind = HLoadClass::LoadKind::kRuntimeCall;
+          // Use a JIT root table entry that the slow path fills in on first use.
+          load_class->MarkJitBssEntry();
+          desired_load_kind = HLoadClass::LoadKind::kJitTableAddress;
         }
       } else if (is_in_boot_image) {
         // AOT app compilation, boot image class.
@@ -226,7 +226,8 @@ HLoadClass::LoadKind HSharpening::ComputeLoadClassKind(
 
   if (!IsSameDexFile(load_class->GetDexFile(), *dex_compilation_unit.GetDexFile())) {
     if ((load_kind == HLoadClass::LoadKind::kRuntimeCall) ||
-        (load_kind == HLoadClass::LoadKind::kBssEntry)) {
+        (load_kind == HLoadClass::LoadKind::kBssEntry) ||
+        (load_kind == HLoadClass::LoadKind::kJitTableAddress && load_class->IsJitBssEntry())) {
       // We actually cannot reference this class, we're forced to bail.
       // We cannot reference this class with Bss, as the entrypoint will lookup the class
       // in the caller's dex file, but that dex file does not reference the class.
@@ -281,7 +282,9 @@ void HSharpening::ProcessLoadString(
           desired_load_kind = HLoadString::LoadKind::kJitTableAddress;
         }
       } else {
-        desired_load_kind = HLoadString::LoadKind::kRuntimeCall;
+        // Use a JIT root table entry that the slow path fills in on first use.
+        load_string->MarkJitBssEntry();
+        desired_load_kind = HLoadString::LoadKind::kJitTableAddress;
       }
     } else {
       // AOT app compilation. Try to lookup the string without allocating if not found.
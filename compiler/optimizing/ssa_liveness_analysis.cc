@@ -140,8 +140,8 @@ void SsaLivenessAnalysis::ComputeLiveRanges() {
   // Do a post order visit, adding inputs of instructions live in the block where
   // that instruction is defined, and killing instructions that are being visited.
   for (HBasicBlock* block : ReverseRange(graph_->GetLinearOrder())) {
-    BitVector* kill = GetKillSet(*block);
-    BitVector* live_in = GetLiveInSet(*block);
+    BlockInfo* block_info = block_infos_[block->GetBlockId()];
+    BitVector* live_in = &block_info->live_in_;
 
     // Set phi inputs of successors of this block corresponding to this block
     // as live_in.
@@ -181,7 +181,7 @@ void SsaLivenessAnalysis::ComputeLiveRanges() {
       HInstruction* current = back_it.Current();
       if (current->HasSsaIndex()) {
         // Kill the instruction and shorten its interval.
-        kill->SetBit(current->GetSsaIndex());
+        block_info->AddToKillSet(current->GetSsaIndex());
         live_in->ClearBit(current->GetSsaIndex());
         current->GetLiveInterval()->SetFrom(current->GetLifetimePosition());
       }
@@ -227,7 +227,7 @@ void SsaLivenessAnalysis::ComputeLiveRanges() {
     for (HInstructionIterator inst_it(block->GetPhis()); !inst_it.Done(); inst_it.Advance()) {
       HInstruction* current = inst_it.Current();
       if (current->HasSsaIndex()) {
-        kill->SetBit(current->GetSsaIndex());
+        block_info->AddToKillSet(current->GetSsaIndex());
         live_in->ClearBit(current->GetSsaIndex());
         LiveInterval* interval = current->GetLiveInterval();
         DCHECK((interval->GetFirstRange() == nullptr)
@@ -252,15 +252,16 @@ void SsaLivenessAnalysis::ComputeLiveRanges() {
 }
 
 void SsaLivenessAnalysis::ComputeLiveInAndLiveOutSets() {
+  // The live_out sets are not stored, a single bit vector is reused for all blocks.
+  ArenaBitVector live_out(allocator_, number_of_ssa_values_, false, kArenaAllocSsaLiveness);
   bool changed;
   do {
     changed = false;
 
     for (const HBasicBlock* block : graph_->GetPostOrder()) {
       // The live_in set depends on the kill set (which does not
-      // change in this loop), and the live_out set.  If the live_out
-      // set does not change, there is no need to update the live_in set.
-      if (UpdateLiveOut(*block) && UpdateLiveIn(*block)) {
+      // change in this loop), and the live_out set.
+      if (UpdateLiveIn(*block, &live_out)) {
         if (kIsDebugBuild) {
           CheckNoLiveInIrreducibleLoop(*block);
         }
@@ -270,27 +271,24 @@ void SsaLivenessAnalysis::ComputeLiveInAndLiveOutSets() {
   } while (changed);
 }
 
-bool SsaLivenessAnalysis::UpdateLiveOut(const HBasicBlock& block) {
-  BitVector* live_out = GetLiveOutSet(block);
-  bool changed = false;
+void SsaLivenessAnalysis::ComputeLiveOutSet(const HBasicBlock& block, BitVector* live_out) const {
   // The live_out set of a block is the union of live_in sets of its successors.
+  live_out->ClearAllBits();
   for (HBasicBlock* successor : block.GetSuccessors()) {
-    if (live_out->Union(GetLiveInSet(*successor))) {
-      changed = true;
-    }
+    live_out->Union(GetLiveInSet(*successor));
   }
-  return changed;
 }
 
-
-bool SsaLivenessAnalysis::UpdateLiveIn(const HBasicBlock& block) {
-  BitVector* live_out = GetLiveOutSet(block);
-  BitVector* kill = GetKillSet(block);
-  BitVector* live_in = GetLiveInSet(block);
+bool SsaLivenessAnalysis::UpdateLiveIn(const HBasicBlock& block, BitVector* live_out) {
+  ComputeLiveOutSet(block, live_out);
   // If live_out is updated (because of backward branches), we need to make
   // sure instructions in live_out are also in live_in, unless they are killed
   // by this block.
-  return live_in->UnionIfNotIn(live_out, kill);
+  const BlockInfo* block_info = block_infos_[block.GetBlockId()];
+  for (uint32_t idx = block_info->kill_start_; idx != block_info->kill_end_; ++idx) {
+    live_out->ClearBit(idx);
+  }
+  return block_info->live_in_.Union(live_out);
 }
 
 void LiveInterval::DumpWithContext(std::ostream& stream,
@@ -478,6 +476,11 @@ size_t LiveInterval::NumberOfSpillSlotsNeeded() const {
     if (definition->IsPhi()) {
       definition = definition->InputAt(1);  // SIMD always appears on back-edge
     }
+    // Once 256-bit vectors appear in the graph, the code generator moves and
+    // spills full vector registers, so every SIMD value needs the wide slot.
+    if (definition->GetBlock()->GetGraph()->HasWideSIMD()) {
+      return kWideSIMDSpillSlots;
+    }
     return definition->AsVecOperation()->GetVectorNumberOfBytes() / kVRegSize;
   }
   // Return number of needed spill slots based on type.
@@ -508,7 +511,8 @@ Location LiveInterval::ToLocation() const {
       switch (NumberOfSpillSlotsNeeded()) {
         case 1: return Location::StackSlot(GetParent()->GetSpillSlot());
         case 2: return Location::DoubleStackSlot(GetParent()->GetSpillSlot());
-        case 4: return Location::SIMDStackSlot(GetParent()->GetSpillSlot());
+        case 4:
+        case kWideSIMDSpillSlots: return Location::SIMDStackSlot(GetParent()->GetSpillSlot());
         default: LOG(FATAL) << "Unexpected number of spill slots"; UNREACHABLE();
       }
     } else {
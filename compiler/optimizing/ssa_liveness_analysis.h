@@ -17,6 +17,7 @@
 #ifndef ART_COMPILER_OPTIMIZING_SSA_LIVENESS_ANALYSIS_H_
 #define ART_COMPILER_OPTIMIZING_SSA_LIVENESS_ANALYSIS_H_
 
+#include <algorithm>
 #include <iostream>
 
 #include "base/iteration_range.h"
@@ -32,24 +33,40 @@ class SsaLivenessAnalysis;
 
 static constexpr int kNoRegister = -1;
 
+// Only the live_in set of a block is kept as a bit vector. The live_out set is the union of the
+// live_in sets of the successors and is recomputed when needed. The kill set is the values
+// defined by the block, which have consecutive SSA indices (see
+// SsaLivenessAnalysis::NumberInstructions), and is kept as the range [kill_start_, kill_end_).
 class BlockInfo : public ArenaObject<kArenaAllocSsaLiveness> {
  public:
   BlockInfo(ScopedArenaAllocator* allocator, const HBasicBlock& block, size_t number_of_ssa_values)
       : block_(block),
         live_in_(allocator, number_of_ssa_values, false, kArenaAllocSsaLiveness),
-        live_out_(allocator, number_of_ssa_values, false, kArenaAllocSsaLiveness),
-        kill_(allocator, number_of_ssa_values, false, kArenaAllocSsaLiveness) {
+        kill_start_(0u),
+        kill_end_(0u) {
     UNUSED(block_);
     live_in_.ClearAllBits();
-    live_out_.ClearAllBits();
-    kill_.ClearAllBits();
+  }
+
+  void AddToKillSet(uint32_t ssa_index) {
+    if (kill_start_ == kill_end_) {
+      kill_start_ = ssa_index;
+      kill_end_ = ssa_index + 1u;
+    } else {
+      kill_start_ = std::min(kill_start_, ssa_index);
+      kill_end_ = std::max(kill_end_, ssa_index + 1u);
+    }
+  }
+
+  bool IsInKillSet(uint32_t ssa_index) const {
+    return kill_start_ <= ssa_index && ssa_index < kill_end_;
   }
 
  private:
   const HBasicBlock& block_;
   ArenaBitVector live_in_;
-  ArenaBitVector live_out_;
-  ArenaBitVector kill_;
+  uint32_t kill_start_;
+  uint32_t kill_end_;
 
   friend class SsaLivenessAnalysis;
 
@@ -427,9 +444,12 @@ class LiveInterval : public ArenaObject<kArenaAllocSsaLiveness> {
       after_loop = after_loop->GetNext();
     }
     if (after_loop == nullptr) {
-      // Uses are only in the loop.
-      first_range_ = last_range_ = range_search_start_ =
-          new (allocator_) LiveRange(start, end, nullptr);
+      // Uses are only in the loop. Reuse the last range rather than allocating a new one.
+      DCHECK(last_in_loop != nullptr);
+      first_range_ = last_range_ = range_search_start_ = last_in_loop;
+      first_range_->start_ = start;
+      first_range_->end_ = end;
+      first_range_->next_ = nullptr;
     } else if (after_loop->GetStart() <= end) {
       first_range_ = range_search_start_ = after_loop;
       // There are uses after the loop.
@@ -782,6 +802,9 @@ class LiveInterval : public ArenaObject<kArenaAllocSsaLiveness> {
   // Returns kNoRegister otherwise.
   int FindHintAtDefinition() const;
 
+  // Number of spill slots used by every SIMD value of a graph with 256-bit vectors.
+  static constexpr size_t kWideSIMDSpillSlots = 32u / kVRegSize;
+
   // Returns the number of required spilling slots (measured as a multiple of the
   // Dex virtual register size `kVRegSize`).
   size_t NumberOfSpillSlotsNeeded() const;
@@ -1180,12 +1203,12 @@ class SsaLivenessAnalysis : public ValueObject {
     return &block_infos_[block.GetBlockId()]->live_in_;
   }
 
-  BitVector* GetLiveOutSet(const HBasicBlock& block) const {
-    return &block_infos_[block.GetBlockId()]->live_out_;
-  }
+  // Compute the live_out set of `block` in `live_out`, which must have room for all the SSA
+  // values.
+  void ComputeLiveOutSet(const HBasicBlock& block, BitVector* live_out) const;
 
-  BitVector* GetKillSet(const HBasicBlock& block) const {
-    return &block_infos_[block.GetBlockId()]->kill_;
+  bool IsInKillSet(const HBasicBlock& block, uint32_t ssa_index) const {
+    return block_infos_[block.GetBlockId()]->IsInKillSet(ssa_index);
   }
 
   HInstruction* GetInstructionFromSsaIndex(size_t index) const {
@@ -1250,11 +1273,9 @@ class SsaLivenessAnalysis : public ValueObject {
   // backwards branches.
   void ComputeLiveInAndLiveOutSets();
 
-  // Update the live_in set of the block and returns whether it has changed.
-  bool UpdateLiveIn(const HBasicBlock& block);
-
-  // Update the live_out set of the block and returns whether it has changed.
-  bool UpdateLiveOut(const HBasicBlock& block);
+  // Update the live_in set of the block and returns whether it has changed. `live_out` is
+  // scratch storage for the live_out set of the block.
+  bool UpdateLiveIn(const HBasicBlock& block, BitVector* live_out);
 
   // Returns whether `instruction` in an HEnvironment held by `env_holder`
   // should be kept live by the HEnvironment.
@@ -977,6 +977,199 @@ TEST(StackMapTest, TestDeduplicateStackMask) {
             stack_map2.GetStackMaskIndex(encoding.stack_map.encoding));
 }
 
+TEST(StackMapTest, TestLookupManyStackMaps) {
+  ArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+  StackMapStream stream(&allocator, kRuntimeISA);
+
+  // Enough stack maps for lookups by native PC to go through the stack map index cache.
+  constexpr uint32_t kNumberOfStackMaps = 64;
+  ArenaBitVector sp_mask(&allocator, 0, true);
+  for (uint32_t i = 0; i < kNumberOfStackMaps; ++i) {
+    stream.BeginStackMapEntry(i, (i + 1) * 16, 0x3, &sp_mask, 0, 0);
+    stream.EndStackMapEntry();
+  }
+
+  size_t size = stream.PrepareForFillIn();
+  void* memory = allocator.Alloc(size, kArenaAllocMisc);
+  MemoryRegion region(memory, size);
+  stream.FillInCodeInfo(region);
+
+  CodeInfo code_info(region);
+  CodeInfoEncoding encoding = code_info.ExtractEncoding();
+  ASSERT_EQ(kNumberOfStackMaps, code_info.GetNumberOfStackMaps(encoding));
+
+  // Look up twice, so that the second round hits in the cache.
+  for (size_t round = 0; round < 2; ++round) {
+    for (uint32_t i = 0; i < kNumberOfStackMaps; ++i) {
+      StackMap stack_map = code_info.GetStackMapForNativePcOffset((i + 1) * 16, encoding);
+      ASSERT_TRUE(stack_map.IsValid());
+      EXPECT_EQ(i, stack_map.GetDexPc(encoding.stack_map.encoding));
+      EXPECT_EQ((i + 1) * 16,
+                stack_map.GetNativePcOffset(encoding.stack_map.encoding, kRuntimeISA));
+    }
+    EXPECT_FALSE(code_info.GetStackMapForNativePcOffset(8, encoding).IsValid());
+  }
+}
+
+TEST(StackMapTest, TestGetDexRegisterLocations) {
+  ArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+  StackMapStream stream(&allocator, kRuntimeISA);
+
+  ArenaBitVector sp_mask(&allocator, 0, false);
+  uint32_t number_of_dex_registers = 5;
+  stream.BeginStackMapEntry(0, 64, 0x3, &sp_mask, number_of_dex_registers, 0);
+  stream.AddDexRegisterEntry(Kind::kInStack, 0);          // Short location.
+  stream.AddDexRegisterEntry(Kind::kNone, 0);             // No location.
+  stream.AddDexRegisterEntry(Kind::kConstant, -2);        // Large location.
+  stream.AddDexRegisterEntry(Kind::kInRegister, 3);       // Short location.
+  stream.AddDexRegisterEntry(Kind::kInStack, 1024);       // Large location.
+  stream.EndStackMapEntry();
+  stream.BeginStackMapEntry(1, 128, 0x3, &sp_mask, number_of_dex_registers, 0);
+  stream.AddDexRegisterEntry(Kind::kInStack, 1024);       // Large location.
+  stream.AddDexRegisterEntry(Kind::kInFpuRegister, 2);    // Short location.
+  stream.AddDexRegisterEntry(Kind::kNone, 0);             // No location.
+  stream.AddDexRegisterEntry(Kind::kNone, 0);             // No location.
+  stream.AddDexRegisterEntry(Kind::kConstant, -2);        // Large location.
+  stream.EndStackMapEntry();
+
+  size_t size = stream.PrepareForFillIn();
+  void* memory = allocator.Alloc(size, kArenaAllocMisc);
+  MemoryRegion region(memory, size);
+  stream.FillInCodeInfo(region);
+
+  CodeInfo code_info(region);
+  CodeInfoEncoding encoding = code_info.ExtractEncoding();
+  ASSERT_EQ(2u, code_info.GetNumberOfStackMaps(encoding));
+  ASSERT_EQ(5u, code_info.GetNumberOfLocationCatalogEntries(encoding));
+
+  std::vector<DexRegisterLocation> locations;
+  for (size_t i = 0; i < 2u; ++i) {
+    StackMap stack_map = code_info.GetStackMapAt(i, encoding);
+    DexRegisterMap dex_register_map =
+        code_info.GetDexRegisterMapOf(stack_map, encoding, number_of_dex_registers);
+    dex_register_map.GetDexRegisterLocations(
+        number_of_dex_registers, code_info, encoding, &locations);
+    ASSERT_EQ(number_of_dex_registers, locations.size());
+    for (uint16_t vreg = 0; vreg < number_of_dex_registers; ++vreg) {
+      EXPECT_EQ(dex_register_map.GetDexRegisterLocation(
+                    vreg, number_of_dex_registers, code_info, encoding),
+                locations[vreg]);
+    }
+  }
+
+  StackMap stack_map = code_info.GetStackMapAt(1, encoding);
+  DexRegisterMap dex_register_map =
+      code_info.GetDexRegisterMapOf(stack_map, encoding, number_of_dex_registers);
+  dex_register_map.GetDexRegisterLocations(
+      number_of_dex_registers, code_info, encoding, &locations);
+  EXPECT_EQ(Kind::kInStack, locations[0].GetKind());
+  EXPECT_EQ(1024, locations[0].GetValue());
+  EXPECT_EQ(Kind::kInFpuRegister, locations[1].GetKind());
+  EXPECT_EQ(2, locations[1].GetValue());
+  EXPECT_EQ(Kind::kNone, locations[2].GetKind());
+  EXPECT_EQ(Kind::kNone, locations[3].GetKind());
+  EXPECT_EQ(Kind::kConstant, locations[4].GetKind());
+  EXPECT_EQ(-2, locations[4].GetValue());
+}
+
+TEST(StackMapTest, TestGetDexRegisterLocationsSingleEntryCatalog) {
+  ArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+  StackMapStream stream(&allocator, kRuntimeISA);
+
+  ArenaBitVector sp_mask(&allocator, 0, false);
+  uint32_t number_of_dex_registers = 2;
+  stream.BeginStackMapEntry(0, 64, 0x3, &sp_mask, number_of_dex_registers, 0);
+  stream.AddDexRegisterEntry(Kind::kNone, 0);            // No location.
+  stream.AddDexRegisterEntry(Kind::kConstant, -2);       // Large location.
+  stream.EndStackMapEntry();
+
+  size_t size = stream.PrepareForFillIn();
+  void* memory = allocator.Alloc(size, kArenaAllocMisc);
+  MemoryRegion region(memory, size);
+  stream.FillInCodeInfo(region);
+
+  CodeInfo code_info(region);
+  CodeInfoEncoding encoding = code_info.ExtractEncoding();
+  ASSERT_EQ(1u, code_info.GetNumberOfLocationCatalogEntries(encoding));
+
+  StackMap stack_map = code_info.GetStackMapAt(0, encoding);
+  DexRegisterMap dex_register_map =
+      code_info.GetDexRegisterMapOf(stack_map, encoding, number_of_dex_registers);
+  std::vector<DexRegisterLocation> locations;
+  dex_register_map.GetDexRegisterLocations(
+      number_of_dex_registers, code_info, encoding, &locations);
+  ASSERT_EQ(2u, locations.size());
+  EXPECT_EQ(Kind::kNone, locations[0].GetKind());
+  EXPECT_EQ(Kind::kConstant, locations[1].GetKind());
+  EXPECT_EQ(Kind::kConstantLargeValue, locations[1].GetInternalKind());
+  EXPECT_EQ(-2, locations[1].GetValue());
+}
+
+// Fill `memory` with a CodeInfo of `number_of_stack_maps` stack maps, the first at
+// `native_pc_offset` and the next ones 16 bytes apart, plus a last one at `last_native_pc_offset`.
+static size_t FillStackMaps(void* memory,
+                            size_t memory_size,
+                            uint32_t number_of_stack_maps,
+                            uint32_t native_pc_offset,
+                            uint32_t last_native_pc_offset) {
+  ArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+  StackMapStream stream(&allocator, kRuntimeISA);
+  ArenaBitVector sp_mask(&allocator, 0, true);
+  for (uint32_t i = 0; i + 1u < number_of_stack_maps; ++i) {
+    stream.BeginStackMapEntry(i, native_pc_offset + i * 16, 0x3, &sp_mask, 0, 0);
+    stream.EndStackMapEntry();
+  }
+  ArenaBitVector last_sp_mask(&allocator, 0, true);
+  last_sp_mask.SetBit(1);
+  stream.BeginStackMapEntry(
+      number_of_stack_maps - 1u, last_native_pc_offset, 0x3, &last_sp_mask, 0, 0);
+  stream.EndStackMapEntry();
+
+  size_t size = stream.PrepareForFillIn();
+  CHECK_LE(size, memory_size);
+  stream.FillInCodeInfo(MemoryRegion(memory, size));
+  return size;
+}
+
+TEST(StackMapTest, TestLookupSharedNativePcAfterReuse) {
+  constexpr uint32_t kNumberOfStackMaps = 16;
+  constexpr uint32_t kSharedNativePc = 2000;
+  constexpr size_t kMemorySize = 4 * KB;
+  std::unique_ptr<uint8_t[]> memory(new uint8_t[kMemorySize]);
+
+  // The last stack map is the only one at the shared native PC, and its index is cached.
+  size_t size = FillStackMaps(memory.get(), kMemorySize, kNumberOfStackMaps, 1000, kSharedNativePc);
+  {
+    CodeInfo code_info(MemoryRegion(memory.get(), size));
+    CodeInfoEncoding encoding = code_info.ExtractEncoding();
+    StackMap stack_map = code_info.GetStackMapForNativePcOffset(kSharedNativePc, encoding);
+    ASSERT_TRUE(stack_map.IsValid());
+    EXPECT_EQ(kNumberOfStackMaps - 1u, stack_map.GetDexPc(encoding.stack_map.encoding));
+  }
+
+  // The memory is reused for a CodeInfo where the last stack map shares the native PC of the
+  // first one, like a catch stack map sharing the return address of a call. The first one must
+  // be found, as the code freeing the first CodeInfo invalidates the cache.
+  CodeInfo::InvalidateStackMapIndexCache();
+  size = FillStackMaps(
+      memory.get(), kMemorySize, kNumberOfStackMaps, kSharedNativePc, kSharedNativePc);
+  CodeInfo code_info(MemoryRegion(memory.get(), size));
+  CodeInfoEncoding encoding = code_info.ExtractEncoding();
+  for (size_t round = 0; round < 2; ++round) {
+    StackMap stack_map = code_info.GetStackMapForNativePcOffset(kSharedNativePc, encoding);
+    ASSERT_TRUE(stack_map.IsValid());
+    EXPECT_EQ(0u, stack_map.GetDexPc(encoding.stack_map.encoding));
+  }
+}
+
 TEST(StackMapTest, TestInvokeInfo) {
   ArenaPool pool;
   ArenaStack arena_stack(&pool);
@@ -1044,5 +1044,23 @@ void FullUnrollHelper::DoFullUnrolling () {
   return;
 }
 
+HBasicBlock* LoopPeelingHelper::DoPeeling() {
+  HBasicBlock* header = loop_info_->GetHeader();
+  ArenaAllocator* allocator = header->GetGraph()->GetAllocator();
+  SuperblockCloner::HEdgeSet remap_orig_internal(allocator->Adapter(kArenaAllocSuperblockCloner));
+  SuperblockCloner::HEdgeSet remap_copy_internal(allocator->Adapter(kArenaAllocSuperblockCloner));
+  SuperblockCloner::HEdgeSet remap_incoming(allocator->Adapter(kArenaAllocSuperblockCloner));
+
+  // The copy is entered from the preheader and its back edges continue into the original loop.
+  for (HBasicBlock* back_edge_block : loop_info_->GetBackEdges()) {
+    remap_copy_internal.Insert(HEdge(back_edge_block, header));
+  }
+  remap_incoming.Insert(HEdge(loop_info_->GetPreHeader(), header));
+
+  cloner_.SetSuccessorRemappingInfo(&remap_orig_internal, &remap_copy_internal, &remap_incoming);
+  cloner_.Run();
+  cloner_.CleanUp();
+  return cloner_.GetBlockCopy(header);
+}
 
 }  // namespace art
@@ -378,6 +378,41 @@ class FullUnrollHelper : public ValueObject {
   DISALLOW_COPY_AND_ASSIGN(FullUnrollHelper);
 };
 
+// Helper class to peel the first iteration of a natural loop with the SuperblockCloner: the
+// loop blocks are copied, the preheader is redirected to the copy and the back edges of the
+// copy to the original header, so that the original loop runs the remaining iterations.
+class LoopPeelingHelper : public ValueObject {
+ public:
+  explicit LoopPeelingHelper(HLoopInformation* info)
+      : loop_info_(info),
+        bb_map_(std::less<HBasicBlock*>(),
+                info->GetHeader()->GetGraph()->GetAllocator()->Adapter(
+                    kArenaAllocSuperblockCloner)),
+        hir_map_(std::less<HInstruction*>(),
+                 info->GetHeader()->GetGraph()->GetAllocator()->Adapter(
+                     kArenaAllocSuperblockCloner)),
+        cloner_(info->GetHeader()->GetGraph(), &info->GetBlocks(), &bb_map_, &hir_map_) {
+    DCHECK(!info->IsIrreducible());
+  }
+
+  // Returns whether the loop can be peeled.
+  bool IsLoopClonable() const { return cloner_.IsSubgraphClonable(); }
+
+  // Peels the first iteration of the loop and returns the entry of the peeled iteration.
+  HBasicBlock* DoPeeling();
+
+  // Correspondence between the loop instructions and their copies in the peeled iteration.
+  const SuperblockCloner::HInstructionMap* GetInstructionMap() const { return &hir_map_; }
+
+ private:
+  HLoopInformation* loop_info_;
+  SuperblockCloner::HBasicBlockMap bb_map_;
+  SuperblockCloner::HInstructionMap hir_map_;
+  SuperblockCloner cloner_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopPeelingHelper);
+};
+
 }  // namespace art
 
 namespace std {
@@ -11,61 +11,70 @@
 
 namespace art {
 
+/* A recursive call in tail position. The call either directly feeds the return (or a phi that
+ * only feeds the return), or is combined with one other value by the accumulator operation.
+ */
+struct TRETailCall {
+  // the self-recursive invoke
+  HInvoke* invoke_;
+
+  // the return instruction consuming the (accumulated) invoke result
+  HInstruction* ret_;
+
+  // accumulator operation combining the invoke result with `acc_value_`, or null
+  HBinaryOperation* acc_op_;
+
+  // value accumulated at this call site, or null
+  HInstruction* acc_value_;
+
+  // phi merging the invoke result into the return block, or null
+  HPhi* ret_phi_;
+};
+
 /* The purpose of this class is to contain all variables which are required to convert
  * current tail-recursive method to iterative. With this, we also take care of thread safety.
  */
 class TREContext {
-public:
+ public:
   // return type of method
   DataType::Type ret_type_;
 
-  // whether recursion deciding if condition exiting in true or false case
-  bool if_true_exit_;
-
-  // method parameter whose change in value impact recursion (will become induction var of loop)
-  HInstruction* imp_param_;
-
-  // method parameter which act as accumulator variable i.e. hold result of recursive method
-  HInstruction* acc_param_;
+  // kind of the accumulator operation shared by all accumulating tail calls,
+  // or HInstruction::kLastInstructionKind if there is none
+  HInstruction::InstructionKind acc_kind_;
 
-  // recursion deciding if condition
-  HIf* inst_if_exit_;
-
-  // input of return instruction
-  HInstruction* ret_op_;
+  // method parameters, in order
+  std::vector<HInstruction*> param_list_;
 
-  // vector which contains recursive invoke instructions
-  std::map<HBasicBlock*,std::vector<HInvoke*>> recursive_invoke_map_;
-  std::vector<HInvoke*> recursive_invoke_instr_;
+  // recursive calls in tail position
+  std::vector<TRETailCall> tail_calls_;
 
-  // vector which keeps checked instructions during identification of tail-recursive method (avoid deadlock)
-  std::vector<HInstruction*> checked_instr_for_name_;
+  // returns that are not recursive tail calls (base cases)
+  std::vector<HInstruction*> base_returns_;
 
-  // method parameter list
-  std::vector<HInstruction*> param_list_;
+  TREContext() : ret_type_(DataType::Type::kLast),
+                 acc_kind_(HInstruction::kLastInstructionKind) {}
 
-  TREContext(): ret_type_(DataType::Type::kLast), if_true_exit_(false),
-      imp_param_(nullptr), acc_param_(nullptr), inst_if_exit_(nullptr),
-      ret_op_(nullptr), recursive_invoke_map_()  {}
+  bool HasAccumulator() const { return acc_kind_ != HInstruction::kLastInstructionKind; }
 };
 
 /*
- * This optimization pass performs tail recursion elimination. It identify tail-recursive methods & convert 
- * identified methods to iterative (i.e. eliminates recursion). Please find below method selection criteria.
- * - Return instruction of method should contain (or refer to) invoke to same method (i.e. tail-recursive).
- * - Method shouldn't have loop or try-catch.
- * - First successor of entry block should have last instruction as "IF".
- * - There should be single predecessor of exit block.
- * - Method should have only one incoming parameter which impact recursion.
- * - Method should not contain 2 or more recursive invokes in same block with different 
- *   induction variable operations as input.
- * - Method should not contain more than 1 accumulator input parameter (parameter which is modified inside
- *   method and included in method output i.e. return).
+ * This optimization pass performs tail recursion elimination. It identifies self-recursive calls
+ * in tail position and converts them into a loop (i.e. eliminates recursion). The method entry
+ * becomes the loop header, with one phi per method parameter that receives the call arguments
+ * on each back edge. Selection criteria:
+ * - The callee is identified by its resolved method (or dex method index), not by name, and is
+ *   a static or direct call (so that it cannot dispatch to an override).
+ * - Every such call either feeds the method return directly, or is combined with a single other
+ *   value by an associative and commutative integral operation (+, *, &, |, ^). All accumulating
+ *   calls must use the same operation, which is then carried in an extra accumulator phi.
+ * - Method shouldn't have try-catch and shouldn't be debuggable.
+ * Only self recursion is handled: mutually recursive methods live in separate graphs.
  */
 class TailRecursionElimination : public HOptimization {
  public:
   TailRecursionElimination(HGraph* graph,
-                         const char* name = kTailRecursionEliminationPassName)
+                           const char* name = kTailRecursionEliminationPassName)
       : HOptimization(graph, name) {}
 
   void Run() OVERRIDE;
@@ -73,10 +82,11 @@ class TailRecursionElimination : public HOptimization {
   static constexpr const char* kTailRecursionEliminationPassName = "TRE";
 
  private:
-  bool CheckTailRecursive(HInstruction* instr, const char* method_name, TREContext& trec);
-  bool IdentifyTailRecursion(HInstruction* intsr, const char* method_name, TREContext& trec);
-  bool TransformMethodGraph(HBasicBlock* exit_blk, HBasicBlock* first_blk, TREContext& trec);
-  bool IdentifyIfRetBlkMainParam(HBasicBlock* exit_blk, HBasicBlock* first_blk, TREContext& trec);
+  bool IsSelfRecursiveCall(HInstruction* instr) const;
+  bool CollectReturn(HInstruction* ret, TREContext& trec);
+  bool MatchTailCall(HInstruction* value, HInstruction* next, TRETailCall* call);
+  bool TransformMethodGraph(TREContext& trec);
+  HInstruction* GetAccIdentity(TREContext& trec);
   HInstruction* GetAccInstruction(HInstruction* val1, HInstruction* val2, TREContext& trec);
 
   DISALLOW_COPY_AND_ASSIGN(TailRecursionElimination);
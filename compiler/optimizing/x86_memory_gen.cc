@@ -26,10 +26,105 @@ namespace x86 {
  */
 class MemoryOperandVisitor : public HGraphVisitor {
  public:
-  MemoryOperandVisitor(HGraph* graph, bool do_implicit_null_checks)
-      : HGraphVisitor(graph), do_implicit_null_checks_(do_implicit_null_checks) {}
+  MemoryOperandVisitor(HGraph* graph, bool do_implicit_null_checks, bool fold_array_loads)
+      : HGraphVisitor(graph),
+        do_implicit_null_checks_(do_implicit_null_checks),
+        fold_array_loads_(fold_array_loads) {}
 
  private:
+  // Maximum number of instructions between an array load and the user it is folded into.
+  static constexpr size_t kMaxFoldDistance = 4;
+
+  // Can `user` read its input at `index` directly from memory?
+  static bool CanFoldInto(HInstruction* user, size_t index, DataType::Type type) {
+    if (user->IsAdd() || user->IsAnd() || user->IsOr() || user->IsXor()) {
+      // Commutative, the load is moved to the right hand side.
+      return user->GetType() == type;
+    } else if (user->IsSub()) {
+      return index == 1u && user->GetType() == type;
+    } else if (user->IsCondition() || user->IsCompare()) {
+      return index == 1u && user->InputAt(0)->GetType() == type;
+    }
+    return false;
+  }
+
+  // Folding keeps the array and index alive until `user`. Only allow this when
+  // they are live there anyway, so that register pressure cannot grow.
+  static bool IsLiveAt(HInstruction* value, HInstruction* user) {
+    // Checks are replaced by their input before register allocation.
+    while (value->IsBoundsCheck() || value->IsNullCheck()) {
+      value = value->InputAt(0);
+    }
+    if (value->IsConstant()) {
+      return true;
+    }
+    HLoopInformation* loop = user->GetBlock()->GetLoopInformation();
+    if (loop != nullptr &&
+        (loop->IsDefinedOutOfTheLoop(value) ||
+         (value->IsPhi() && value->GetBlock() == loop->GetHeader()))) {
+      // Live around the back edge.
+      return true;
+    }
+    for (const HUseListNode<HInstruction*>& use : value->GetUses()) {
+      if (user->StrictlyDominates(use.GetUser())) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Is it safe and profitable to read the element for `array_get` at `user` instead?
+  bool CanMoveLoadTo(HArrayGet* array_get, HInstruction* user) {
+    if (array_get->GetNextDisregardingMoves() == user) {
+      // Adjacent: no live range is extended.
+      return true;
+    }
+    if (array_get->InputAt(0)->IsNullCheck() && do_implicit_null_checks_) {
+      // The implicit null check must fault right after the null check.
+      return false;
+    }
+    size_t distance = 0;
+    for (HInstruction* current = array_get->GetNext();
+         current != user;
+         current = current->GetNext()) {
+      if (++distance > kMaxFoldDistance ||
+          current->GetSideEffects().DoesAnyWrite() ||
+          current->CanThrow() ||
+          current->NeedsEnvironment()) {
+        return false;
+      }
+    }
+    return IsLiveAt(array_get->InputAt(0), user) && IsLiveAt(array_get->InputAt(1), user);
+  }
+
+  void VisitArrayGet(HArrayGet* array_get) OVERRIDE {
+    // Fold int and long array loads into ALU and compare instructions,
+    // e.g. `add reg, [array + index * scale + data_offset]`.
+    DataType::Type type = array_get->GetType();
+    if (!fold_array_loads_ ||
+        (type != DataType::Type::kInt32 && type != DataType::Type::kInt64) ||
+        array_get->IsStringCharAt() ||
+        array_get->HasEnvironmentUses() ||
+        !array_get->HasOnlyOneNonEnvironmentUse()) {
+      return;
+    }
+    const HUseListNode<HInstruction*>& use = array_get->GetUses().front();
+    HInstruction* user = use.GetUser();
+    size_t index = use.GetIndex();
+    if (user->GetBlock() != array_get->GetBlock() ||
+        !CanFoldInto(user, index, type) ||
+        user->InputAt(1 - index)->IsEmittedAtUseSite() ||
+        !CanMoveLoadTo(array_get, user)) {
+      return;
+    }
+    if (index == 0u) {
+      HInstruction* other = user->InputAt(1);
+      user->ReplaceInput(other, 0);
+      user->ReplaceInput(array_get, 1);
+    }
+    array_get->MarkEmittedAtUseSite();
+  }
+
   void VisitBoundsCheck(HBoundsCheck* check) OVERRIDE {
     // Replace the length by the array itself, so that we can do compares to memory.
     HArrayLength* array_len = check->InputAt(1)->AsArrayLength();
@@ -75,17 +170,19 @@ class MemoryOperandVisitor : public HGraphVisitor {
   }
 
   bool do_implicit_null_checks_;
+  bool fold_array_loads_;
 };
 
 X86MemoryOperandGeneration::X86MemoryOperandGeneration(HGraph* graph,
                                                        CodeGenerator* codegen,
                                                        OptimizingCompilerStats* stats)
     : HOptimization(graph, kX86MemoryOperandGenerationPassName, stats),
-      do_implicit_null_checks_(codegen->GetCompilerOptions().GetImplicitNullChecks()) {
+      do_implicit_null_checks_(codegen->GetCompilerOptions().GetImplicitNullChecks()),
+      fold_array_loads_(codegen->GetInstructionSet() == InstructionSet::kX86_64) {
 }
 
 void X86MemoryOperandGeneration::Run() {
-  MemoryOperandVisitor visitor(graph_, do_implicit_null_checks_);
+  MemoryOperandVisitor visitor(graph_, do_implicit_null_checks_, fold_array_loads_);
   visitor.VisitInsertionOrder();
 }
 
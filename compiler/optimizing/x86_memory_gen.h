@@ -38,6 +38,8 @@ class X86MemoryOperandGeneration : public HOptimization {
 
  private:
   bool do_implicit_null_checks_;
+  // Whether array loads may be folded into their users (x86-64 only).
+  bool fold_array_loads_;
 };
 
 }  // namespace x86
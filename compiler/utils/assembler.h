@@ -104,6 +104,14 @@ class AssemblerBuffer {
     cursor_ += sizeof(T);
   }
 
+  // Emit `kSize` bytes with a single update of the cursor. The stores of single bytes may alias
+  // the cursor, so the compiler cannot merge the updates of a sequence of Emit<uint8_t>().
+  template<size_t kSize> void EmitBytes(const uint8_t* data) {
+    CHECK(HasEnsuredCapacity());
+    memcpy(cursor_, data, kSize);
+    cursor_ += kSize;
+  }
+
   template<typename T> T Load(size_t position) {
     CHECK_LE(position, Size() - static_cast<int>(sizeof(T)));
     return *reinterpret_cast<T*>(contents_ + position);
@@ -114,6 +122,15 @@ class AssemblerBuffer {
     *reinterpret_cast<T*>(contents_ + position) = value;
   }
 
+  // Make room for `size` more bytes ahead of time, so that the buffer does not grow repeatedly,
+  // copying what was emitted so far, while they are emitted.
+  void Reserve(size_t size) {
+    size_t min_capacity = Size() + size + kMinimumGap;
+    if (min_capacity > Capacity()) {
+      ExtendCapacity(min_capacity);
+    }
+  }
+
   void Resize(size_t new_size) {
     if (new_size > Capacity()) {
       ExtendCapacity(new_size);
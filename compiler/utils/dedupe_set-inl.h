@@ -26,7 +26,7 @@
 
 #include "android-base/stringprintf.h"
 
-#include "base/hash_set.h"
+#include "base/swiss_hash_set.h"
 #include "base/mutex.h"
 #include "base/stl_util.h"
 #include "base/time_utils.h"
@@ -37,9 +37,8 @@ template <typename InKey,
           typename StoreKey,
           typename Alloc,
           typename HashType,
-          typename HashFunc,
-          HashType kShard>
-struct DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Stats {
+          typename HashFunc>
+struct DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc>::Stats {
   size_t collision_sum = 0u;
   size_t collision_max = 0u;
   size_t total_probe_distance = 0u;
@@ -50,9 +49,8 @@ template <typename InKey,
           typename StoreKey,
           typename Alloc,
           typename HashType,
-          typename HashFunc,
-          HashType kShard>
-class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
+          typename HashFunc>
+class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc>::Shard {
  public:
   Shard(const Alloc& alloc, const std::string& lock_name)
       : alloc_(alloc),
@@ -82,7 +80,7 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
   }
 
   void UpdateStats(Thread* self, Stats* global_stats) REQUIRES(!lock_) {
-    // HashSet<> doesn't keep entries ordered by hash, so we actually allocate memory
+    // SwissHashSet<> doesn't keep entries ordered by hash, so we actually allocate memory
     // for bookkeeping while collecting the stats.
     std::unordered_map<HashType, size_t> stats;
     {
@@ -177,16 +175,15 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
   Alloc alloc_;
   const std::string lock_name_;
   Mutex lock_;
-  HashSet<HashedKey<StoreKey>, ShardEmptyFn, ShardHashFn, ShardPred> keys_ GUARDED_BY(lock_);
+  SwissHashSet<HashedKey<StoreKey>, ShardEmptyFn, ShardHashFn, ShardPred> keys_ GUARDED_BY(lock_);
 };
 
 template <typename InKey,
           typename StoreKey,
           typename Alloc,
           typename HashType,
-          typename HashFunc,
-          HashType kShard>
-const StoreKey* DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Add(
+          typename HashFunc>
+const StoreKey* DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc>::Add(
     Thread* self, const InKey& key) {
   uint64_t hash_start;
   if (kIsDebugBuild) {
@@ -197,8 +194,8 @@ const StoreKey* DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::A
     uint64_t hash_end = NanoTime();
     hash_time_ += hash_end - hash_start;
   }
-  HashType shard_hash = raw_hash / kShard;
-  HashType shard_bin = raw_hash % kShard;
+  HashType shard_hash = raw_hash / num_shards_;
+  HashType shard_bin = raw_hash % num_shards_;
   return shards_[shard_bin]->Add(self, shard_hash, key);
 }
 
@@ -206,12 +203,15 @@ template <typename InKey,
           typename StoreKey,
           typename Alloc,
           typename HashType,
-          typename HashFunc,
-          HashType kShard>
-DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::DedupeSet(const char* set_name,
-                                                                         const Alloc& alloc)
-    : hash_time_(0) {
-  for (HashType i = 0; i < kShard; ++i) {
+          typename HashFunc>
+DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc>::DedupeSet(const char* set_name,
+                                                                 const Alloc& alloc,
+                                                                 size_t num_shards)
+    : num_shards_(num_shards),
+      shards_(new std::unique_ptr<Shard>[num_shards]),
+      hash_time_(0) {
+  DCHECK_NE(num_shards, 0u);
+  for (size_t i = 0; i < num_shards_; ++i) {
     std::ostringstream oss;
     oss << set_name << " lock " << i;
     shards_[i].reset(new Shard(alloc, oss.str()));
@@ -222,9 +222,8 @@ template <typename InKey,
           typename StoreKey,
           typename Alloc,
           typename HashType,
-          typename HashFunc,
-          HashType kShard>
-DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::~DedupeSet() {
+          typename HashFunc>
+DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc>::~DedupeSet() {
   // Everything done by member destructors.
 }
 
@@ -232,12 +231,11 @@ template <typename InKey,
           typename StoreKey,
           typename Alloc,
           typename HashType,
-          typename HashFunc,
-          HashType kShard>
-std::string DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::DumpStats(
+          typename HashFunc>
+std::string DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc>::DumpStats(
     Thread* self) const {
   Stats stats;
-  for (HashType shard = 0; shard < kShard; ++shard) {
+  for (size_t shard = 0; shard < num_shards_; ++shard) {
     shards_[shard]->UpdateStats(self, &stats);
   }
   return android::base::StringPrintf("%zu collisions, %zu max hash collisions, "
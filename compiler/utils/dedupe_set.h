@@ -29,19 +29,19 @@ class Thread;
 
 // A set of Keys that support a HashFunc returning HashType. Used to find duplicates of Key in the
 // Add method. The data-structure is thread-safe through the use of internal locks, it also
-// supports the lock being sharded.
+// supports the lock being sharded. The number of shards is chosen at construction, so that it can
+// follow the number of threads adding keys concurrently.
 template <typename InKey,
           typename StoreKey,
           typename Alloc,
           typename HashType,
-          typename HashFunc,
-          HashType kShard = 1>
+          typename HashFunc>
 class DedupeSet {
  public:
   // Add a new key to the dedupe set if not present. Return the equivalent deduplicated stored key.
   const StoreKey* Add(Thread* self, const InKey& key);
 
-  DedupeSet(const char* set_name, const Alloc& alloc);
+  DedupeSet(const char* set_name, const Alloc& alloc, size_t num_shards = 1u);
 
   ~DedupeSet();
 
@@ -51,7 +51,8 @@ class DedupeSet {
   struct Stats;
   class Shard;
 
-  std::unique_ptr<Shard> shards_[kShard];
+  const size_t num_shards_;
+  std::unique_ptr<std::unique_ptr<Shard>[]> shards_;
   uint64_t hash_time_;
 
   DISALLOW_COPY_AND_ASSIGN(DedupeSet);
@@ -88,4 +88,29 @@ TEST(DedupeSetTest, Test) {
   }
 }
 
+TEST(DedupeSetTest, Shards) {
+  Thread* self = Thread::Current();
+  DedupeSetTestAlloc alloc;
+  DedupeSet<ArrayRef<const uint8_t>,
+            std::vector<uint8_t>,
+            DedupeSetTestAlloc,
+            size_t,
+            DedupeSetTestHashFunc> deduplicator("test", alloc, /* num_shards */ 7u);
+  // The keys hash to all the shards, and each is deduplicated in its own shard.
+  std::vector<const std::vector<uint8_t>*> arrays;
+  for (uint8_t i = 0u; i != 32u; ++i) {
+    uint8_t raw_test[] = { i, 20u, 30u };
+    ArrayRef<const uint8_t> test(raw_test);
+    const std::vector<uint8_t>* array = deduplicator.Add(self, test);
+    ASSERT_NE(array, nullptr);
+    ASSERT_TRUE(std::equal(test.begin(), test.end(), array->begin()));
+    ASSERT_TRUE(std::find(arrays.begin(), arrays.end(), array) == arrays.end());
+    arrays.push_back(array);
+  }
+  for (uint8_t i = 0u; i != 32u; ++i) {
+    uint8_t raw_test[] = { i, 20u, 30u };
+    ASSERT_EQ(arrays[i], deduplicator.Add(self, ArrayRef<const uint8_t>(raw_test)));
+  }
+}
+
 }  // namespace art
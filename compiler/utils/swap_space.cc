@@ -178,6 +178,7 @@ SwapSpace::SpaceChunk SwapSpace::NewFileChunk(size_t min_size) {
   }
   size_ += next_part;
   SpaceChunk new_chunk = {ptr, next_part};
+  maps_.push_back(new_chunk);
   return new_chunk;
 #else
   UNUSED(min_size, kMininumMapSize);
@@ -186,6 +187,17 @@ SwapSpace::SpaceChunk SwapSpace::NewFileChunk(size_t min_size) {
 #endif
 }
 
+void SwapSpace::ReleaseResidentPages() {
+  MutexLock lock(Thread::Current(), lock_);
+  for (const SpaceChunk& map : maps_) {
+    // The mappings are shared, the contents of the pages are kept in the file.
+    if (madvise(map.ptr, map.size, MADV_DONTNEED) != 0) {
+      PLOG(WARNING) << "Failed to release swap space chunk at "
+          << static_cast<const void*>(map.ptr) << " size=" << map.size;
+    }
+  }
+}
+
 // TODO: Full coalescing.
 void SwapSpace::Free(void* ptr, size_t size) {
   MutexLock lock(Thread::Current(), lock_);
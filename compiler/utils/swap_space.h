@@ -43,6 +43,11 @@ class SwapSpace {
     return size_;
   }
 
+  // Drop the pages of the swap file from the address space. The data stays in the file and is
+  // paged back in when accessed, so the kernel can write back and reclaim the memory of the data
+  // left alone until the oat file is written, such as the code of the methods compiled so far.
+  void ReleaseResidentPages() REQUIRES(!lock_);
+
  private:
   // Chunk of space.
   struct SpaceChunk {
@@ -100,6 +105,8 @@ class SwapSpace {
   // NOTE: Boost.Bimap would be useful for the two following members.
 
   // Map start of a free chunk to its size.
+  // The chunks mapped from the file, which may be split or merged in the free lists.
+  std::vector<SpaceChunk> maps_ GUARDED_BY(lock_);
   FreeByStartSet free_by_start_ GUARDED_BY(lock_);
   // Free chunks ordered by size.
   FreeBySizeSet free_by_size_ GUARDED_BY(lock_);
@@ -80,4 +80,32 @@ TEST_F(SwapSpaceTest, Swap) {
   SwapTest(true);
 }
 
+TEST_F(SwapSpaceTest, ReleaseResidentPages) {
+  ScratchFile scratch;
+  int fd = scratch.GetFd();
+  unlink(scratch.GetFilename().c_str());
+
+  SwapSpace pool(fd, 1 * MB);
+  SwapAllocator<void> alloc(&pool);
+  SwapVector<int32_t> v(alloc);
+  for (int32_t i = 0; i < 1000000; ++i) {
+    v.push_back(i);
+  }
+  // The contents are read back from the file.
+  pool.ReleaseResidentPages();
+  for (int32_t i = 0; i < 1000000; ++i) {
+    EXPECT_EQ(i, v[i]);
+  }
+  // And the pages can be written again.
+  for (int32_t i = 0; i < 1000000; ++i) {
+    v[i] = -i;
+  }
+  pool.ReleaseResidentPages();
+  for (int32_t i = 0; i < 1000000; ++i) {
+    EXPECT_EQ(-i, v[i]);
+  }
+
+  scratch.Close();
+}
+
 }  // namespace art
@@ -390,6 +390,7 @@ class X86Assembler FINAL : public Assembler {
 
   void movd(XmmRegister dst, Register src);
   void movd(Register dst, XmmRegister src);
+  void pmovmskb(Register dst, XmmRegister src);
 
   void addss(XmmRegister dst, XmmRegister src);
   void addss(XmmRegister dst, const Address& src);
@@ -404,6 +405,7 @@ class X86Assembler FINAL : public Assembler {
   void subps(XmmRegister dst, XmmRegister src);
   void mulps(XmmRegister dst, XmmRegister src);
   void divps(XmmRegister dst, XmmRegister src);
+  void sqrtps(XmmRegister dst, XmmRegister src);
 
   void movapd(XmmRegister dst, XmmRegister src);     // move
   void movapd(XmmRegister dst, const Address& src);  // load aligned
@@ -431,6 +433,7 @@ class X86Assembler FINAL : public Assembler {
   void subpd(XmmRegister dst, XmmRegister src);
   void mulpd(XmmRegister dst, XmmRegister src);
   void divpd(XmmRegister dst, XmmRegister src);
+  void sqrtpd(XmmRegister dst, XmmRegister src);
 
   void movdqa(XmmRegister dst, XmmRegister src);     // move
   void movdqa(XmmRegister dst, const Address& src);  // load aligned
@@ -546,6 +549,9 @@ class X86Assembler FINAL : public Assembler {
   void pcmpgtd(XmmRegister dst, XmmRegister src);
   void pcmpgtq(XmmRegister dst, XmmRegister src);  // SSE4.2
 
+  void pcmpestri(XmmRegister dst, XmmRegister src, const Immediate& imm);  // SSE4.2
+  void pcmpestri(XmmRegister dst, const Address& src, const Immediate& imm);  // SSE4.2
+
   void shufpd(XmmRegister dst, XmmRegister src, const Immediate& imm);
   void shufps(XmmRegister dst, XmmRegister src, const Immediate& imm);
   void pshufd(XmmRegister dst, XmmRegister src, const Immediate& imm);
@@ -560,6 +560,14 @@ TEST_F(AssemblerX86Test, DivPD) {
   DriverStr(RepeatFF(&x86::X86Assembler::divpd, "divpd %{reg2}, %{reg1}"), "divpd");
 }
 
+TEST_F(AssemblerX86Test, SqrtPS) {
+  DriverStr(RepeatFF(&x86::X86Assembler::sqrtps, "sqrtps %{reg2}, %{reg1}"), "sqrtps");
+}
+
+TEST_F(AssemblerX86Test, SqrtPD) {
+  DriverStr(RepeatFF(&x86::X86Assembler::sqrtpd, "sqrtpd %{reg2}, %{reg1}"), "sqrtpd");
+}
+
 TEST_F(AssemblerX86Test, PAddB) {
   DriverStr(RepeatFF(&x86::X86Assembler::paddb, "paddb %{reg2}, %{reg1}"), "paddb");
 }
@@ -664,6 +672,10 @@ TEST_F(AssemblerX86Test, PMAddWD) {
   DriverStr(RepeatFF(&x86::X86Assembler::pmaddwd, "pmaddwd %{reg2}, %{reg1}"), "pmaddwd");
 }
 
+TEST_F(AssemblerX86Test, PMovMskB) {
+  DriverStr(RepeatRF(&x86::X86Assembler::pmovmskb, "pmovmskb %{reg2}, %{reg1}"), "pmovmskb");
+}
+
 TEST_F(AssemblerX86Test, PHAddW) {
   DriverStr(RepeatFF(&x86::X86Assembler::phaddw, "phaddw %{reg2}, %{reg1}"), "phaddw");
 }
@@ -792,6 +804,11 @@ TEST_F(AssemblerX86Test, PCmpgtQ) {
   DriverStr(RepeatFF(&x86::X86Assembler::pcmpgtq, "pcmpgtq %{reg2}, %{reg1}"), "cmpgtq");
 }
 
+TEST_F(AssemblerX86Test, PCmpestri) {
+  DriverStr(RepeatFFI(&x86::X86Assembler::pcmpestri, 1, "pcmpestri ${imm}, %{reg2}, %{reg1}"),
+            "pcmpestri");
+}
+
 TEST_F(AssemblerX86Test, ShufPS) {
   DriverStr(RepeatFFI(&x86::X86Assembler::shufps, 1, "shufps ${imm}, %{reg2}, %{reg1}"), "shufps");
 }
@@ -522,6 +522,15 @@ void X86_64Assembler::movd(CpuRegister dst, XmmRegister src, bool is64bit) {
   EmitOperand(src.LowBits(), Operand(dst));
 }
 
+void X86_64Assembler::pmovmskb(CpuRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x66);
+  EmitOptionalRex32(dst, src);
+  EmitUint8(0x0F);
+  EmitUint8(0xD7);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+}
+
 
 void X86_64Assembler::addss(XmmRegister dst, XmmRegister src) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
@@ -639,6 +648,15 @@ void X86_64Assembler::divps(XmmRegister dst, XmmRegister src) {
 }
 
 
+void X86_64Assembler::sqrtps(XmmRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitOptionalRex32(dst, src);
+  EmitUint8(0x0F);
+  EmitUint8(0x51);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+}
+
+
 void X86_64Assembler::flds(const Address& src) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0xD9);
@@ -860,6 +878,16 @@ void X86_64Assembler::divpd(XmmRegister dst, XmmRegister src) {
 }
 
 
+void X86_64Assembler::sqrtpd(XmmRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x66);
+  EmitOptionalRex32(dst, src);
+  EmitUint8(0x0F);
+  EmitUint8(0x51);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+}
+
+
 void X86_64Assembler::movdqa(XmmRegister dst, XmmRegister src) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0x66);
@@ -1504,6 +1532,27 @@ void X86_64Assembler::pmaddwd(XmmRegister dst, XmmRegister src) {
   EmitXmmRegisterOperand(dst.LowBits(), src);
 }
 
+void X86_64Assembler::pmaddubsw(XmmRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x66);
+  EmitOptionalRex32(dst, src);
+  EmitUint8(0x0F);
+  EmitUint8(0x38);
+  EmitUint8(0x04);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+}
+
+void X86_64Assembler::pclmulqdq(XmmRegister dst, XmmRegister src, const Immediate& imm) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x66);
+  EmitOptionalRex32(dst, src);
+  EmitUint8(0x0F);
+  EmitUint8(0x3A);
+  EmitUint8(0x44);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+  EmitUint8(imm.value());
+}
+
 void X86_64Assembler::phaddw(XmmRegister dst, XmmRegister src) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0x66);
@@ -1804,6 +1853,28 @@ void X86_64Assembler::pcmpgtq(XmmRegister dst, XmmRegister src) {
   EmitXmmRegisterOperand(dst.LowBits(), src);
 }
 
+void X86_64Assembler::pcmpestri(XmmRegister dst, XmmRegister src, const Immediate& imm) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x66);
+  EmitOptionalRex32(dst, src);
+  EmitUint8(0x0F);
+  EmitUint8(0x3A);
+  EmitUint8(0x61);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+  EmitUint8(imm.value());
+}
+
+void X86_64Assembler::pcmpestri(XmmRegister dst, const Address& src, const Immediate& imm) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x66);
+  EmitOptionalRex32(dst, src);
+  EmitUint8(0x0F);
+  EmitUint8(0x3A);
+  EmitUint8(0x61);
+  EmitOperand(dst.LowBits(), src);
+  EmitUint8(imm.value());
+}
+
 void X86_64Assembler::shufpd(XmmRegister dst, XmmRegister src, const Immediate& imm) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0x66);
@@ -2197,6 +2268,14 @@ void X86_64Assembler::xchgl(CpuRegister reg, const Address& address) {
 }
 
 
+void X86_64Assembler::xchgq(CpuRegister reg, const Address& address) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitRex64(reg, address);
+  EmitUint8(0x87);
+  EmitOperand(reg.LowBits(), address);
+}
+
+
 void X86_64Assembler::cmpb(const Address& address, const Immediate& imm) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   CHECK(imm.is_int32());
@@ -3154,6 +3233,24 @@ void X86_64Assembler::cmpxchgq(const Address& address, CpuRegister reg) {
 }
 
 
+void X86_64Assembler::xaddl(const Address& address, CpuRegister reg) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitOptionalRex32(reg, address);
+  EmitUint8(0x0F);
+  EmitUint8(0xC1);
+  EmitOperand(reg.LowBits(), address);
+}
+
+
+void X86_64Assembler::xaddq(const Address& address, CpuRegister reg) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitRex64(reg, address);
+  EmitUint8(0x0F);
+  EmitUint8(0xC1);
+  EmitOperand(reg.LowBits(), address);
+}
+
+
 void X86_64Assembler::mfence() {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0x0F);
@@ -3162,6 +3259,14 @@ void X86_64Assembler::mfence() {
 }
 
 
+void X86_64Assembler::sfence() {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x0F);
+  EmitUint8(0xAE);
+  EmitUint8(0xF8);
+}
+
+
 X86_64Assembler* X86_64Assembler::gs() {
   // TODO: gs is a prefix and not an instruction
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
@@ -3427,16 +3532,30 @@ void X86_64Assembler::Bind(NearLabel* label) {
 
 
 void X86_64Assembler::EmitOperand(uint8_t reg_or_opcode, const Operand& operand) {
-  CHECK_GE(reg_or_opcode, 0);
-  CHECK_LT(reg_or_opcode, 8);
-  const int length = operand.length_;
-  CHECK_GT(length, 0);
-  // Emit the ModRM byte updated with the given reg value.
-  CHECK_EQ(operand.encoding_[0] & 0x38, 0);
-  EmitUint8(operand.encoding_[0] + (reg_or_opcode << 3));
-  // Emit the rest of the encoded operand.
-  for (int i = 1; i < length; i++) {
-    EmitUint8(operand.encoding_[i]);
+  DCHECK_LT(reg_or_opcode, 8);
+  DCHECK_EQ(operand.encoding_[0] & 0x38, 0);
+  // Emit the ModRM byte updated with the given reg value, and the rest of the encoded operand.
+  // The encoding is a register (1 byte), optionally followed by a SIB byte and a disp8 (2 or
+  // 3 bytes) or a disp32 (5 or 6 bytes).
+  switch (operand.length_) {
+    case 1:
+      EmitUint8(operand.encoding_[0] + (reg_or_opcode << 3));
+      break;
+    case 2:
+      EmitOperandOfLength<2>(reg_or_opcode, operand);
+      break;
+    case 3:
+      EmitOperandOfLength<3>(reg_or_opcode, operand);
+      break;
+    case 5:
+      EmitOperandOfLength<5>(reg_or_opcode, operand);
+      break;
+    case 6:
+      EmitOperandOfLength<6>(reg_or_opcode, operand);
+      break;
+    default:
+      LOG(FATAL) << "Unexpected operand length " << static_cast<int>(operand.length_);
+      UNREACHABLE();
   }
   AssemblerFixup* fixup = operand.GetFixup();
   if (fixup != nullptr) {
@@ -3461,8 +3580,7 @@ void X86_64Assembler::EmitComplex(uint8_t reg_or_opcode,
                                   const Operand& operand,
                                   const Immediate& immediate,
                                   bool is_16_op) {
-  CHECK_GE(reg_or_opcode, 0);
-  CHECK_LT(reg_or_opcode, 8);
+  DCHECK_LT(reg_or_opcode, 8);
   if (immediate.is_int8()) {
     // Use sign-extended 8-bit immediate.
     EmitUint8(0x83);
@@ -3779,6 +3897,381 @@ uint8_t X86_64Assembler::EmitVexByte2(bool w, int l, X86_64ManagedRegister opera
   return vex_prefix;
 }
 
+void X86_64Assembler::EmitVex256(int pp, int mmmmm, uint8_t opcode,
+                                 XmmRegister reg, XmmRegister vvvv, XmmRegister rm, bool w) {
+  uint8_t byte_zero = EmitVexByteZero(false /*is_two_byte*/);
+  uint8_t byte_one = EmitVexByte1(reg.NeedsRex(), false, rm.NeedsRex(), mmmmm);
+  uint8_t byte_two = EmitVexByte2(w, 256,
+                                  X86_64ManagedRegister::FromXmmRegister(vvvv.AsFloatRegister()),
+                                  pp);
+  EmitUint8(byte_zero);
+  EmitUint8(byte_one);
+  EmitUint8(byte_two);
+  EmitUint8(opcode);
+  EmitXmmRegisterOperand(reg.LowBits(), rm);
+}
+
+void X86_64Assembler::EmitVex256(int pp, int mmmmm, uint8_t opcode,
+                                 XmmRegister reg, XmmRegister vvvv, const Address& address,
+                                 bool w) {
+  uint8_t rex = address.rex();
+  uint8_t byte_zero = EmitVexByteZero(false /*is_two_byte*/);
+  uint8_t byte_one = EmitVexByte1(reg.NeedsRex(), (rex & 2) != 0, (rex & 1) != 0, mmmmm);
+  uint8_t byte_two = EmitVexByte2(w, 256,
+                                  X86_64ManagedRegister::FromXmmRegister(vvvv.AsFloatRegister()),
+                                  pp);
+  EmitUint8(byte_zero);
+  EmitUint8(byte_one);
+  EmitUint8(byte_two);
+  EmitUint8(opcode);
+  EmitOperand(reg.LowBits(), address);
+}
+
+void X86_64Assembler::vmovaps(XmmRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(0, 1, 0x28, dst, XmmRegister(XMM0), src);
+}
+
+void X86_64Assembler::vmovdqu(XmmRegister dst, const Address& src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(2, 1, 0x6F, dst, XmmRegister(XMM0), src);
+}
+
+void X86_64Assembler::vmovdqu(const Address& dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(2, 1, 0x7F, src, XmmRegister(XMM0), dst);
+}
+
+void X86_64Assembler::vmovups(XmmRegister dst, const Address& src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(0, 1, 0x10, dst, XmmRegister(XMM0), src);
+}
+
+void X86_64Assembler::vmovups(const Address& dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(0, 1, 0x11, src, XmmRegister(XMM0), dst);
+}
+
+void X86_64Assembler::vmovupd(XmmRegister dst, const Address& src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0x10, dst, XmmRegister(XMM0), src);
+}
+
+void X86_64Assembler::vmovupd(const Address& dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0x11, src, XmmRegister(XMM0), dst);
+}
+
+void X86_64Assembler::vmovntdq(const Address& dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xE7, src, XmmRegister(XMM0), dst);
+}
+
+void X86_64Assembler::vpaddb(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xFC, dst, src1, src2);
+}
+
+void X86_64Assembler::vpaddw(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xFD, dst, src1, src2);
+}
+
+void X86_64Assembler::vpaddd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xFE, dst, src1, src2);
+}
+
+void X86_64Assembler::vpaddq(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xD4, dst, src1, src2);
+}
+
+void X86_64Assembler::vpsubb(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xF8, dst, src1, src2);
+}
+
+void X86_64Assembler::vpsubw(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xF9, dst, src1, src2);
+}
+
+void X86_64Assembler::vpsubd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xFA, dst, src1, src2);
+}
+
+void X86_64Assembler::vpsubq(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xFB, dst, src1, src2);
+}
+
+void X86_64Assembler::vpmullw(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xD5, dst, src1, src2);
+}
+
+void X86_64Assembler::vpmulld(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 2, 0x40, dst, src1, src2);
+}
+
+void X86_64Assembler::vpavgb(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xE0, dst, src1, src2);
+}
+
+void X86_64Assembler::vpavgw(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xE3, dst, src1, src2);
+}
+
+void X86_64Assembler::vpcmpeqb(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0x74, dst, src1, src2);
+}
+
+void X86_64Assembler::vpmovmskb(CpuRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // The general purpose destination is encoded in ModRM.reg like an XMM register.
+  EmitVex256(1, 1, 0xD7, XmmRegister(dst.AsRegister()), XmmRegister(XMM0), src);
+}
+
+void X86_64Assembler::vpand(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xDB, dst, src1, src2);
+}
+
+void X86_64Assembler::vpandn(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xDF, dst, src1, src2);
+}
+
+void X86_64Assembler::vpor(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xEB, dst, src1, src2);
+}
+
+void X86_64Assembler::vpxor(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0xEF, dst, src1, src2);
+}
+
+void X86_64Assembler::vaddps(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(0, 1, 0x58, dst, src1, src2);
+}
+
+void X86_64Assembler::vaddpd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0x58, dst, src1, src2);
+}
+
+void X86_64Assembler::vsubps(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(0, 1, 0x5C, dst, src1, src2);
+}
+
+void X86_64Assembler::vsubpd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0x5C, dst, src1, src2);
+}
+
+void X86_64Assembler::vmulps(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(0, 1, 0x59, dst, src1, src2);
+}
+
+void X86_64Assembler::vmulpd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0x59, dst, src1, src2);
+}
+
+void X86_64Assembler::vdivps(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(0, 1, 0x5E, dst, src1, src2);
+}
+
+void X86_64Assembler::vdivpd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0x5E, dst, src1, src2);
+}
+
+void X86_64Assembler::vsqrtps(XmmRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(0, 1, 0x51, dst, XmmRegister(XMM0), src);
+}
+
+void X86_64Assembler::vsqrtpd(XmmRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0x51, dst, XmmRegister(XMM0), src);
+}
+
+void X86_64Assembler::vfmadd231ps(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 2, 0xB8, dst, src1, src2, /* w */ false);
+}
+
+void X86_64Assembler::vfmadd231pd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 2, 0xB8, dst, src1, src2, /* w */ true);
+}
+
+void X86_64Assembler::vandps(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(0, 1, 0x54, dst, src1, src2);
+}
+
+void X86_64Assembler::vandpd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0x54, dst, src1, src2);
+}
+
+void X86_64Assembler::vandnps(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(0, 1, 0x55, dst, src1, src2);
+}
+
+void X86_64Assembler::vandnpd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0x55, dst, src1, src2);
+}
+
+void X86_64Assembler::vorps(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(0, 1, 0x56, dst, src1, src2);
+}
+
+void X86_64Assembler::vorpd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0x56, dst, src1, src2);
+}
+
+void X86_64Assembler::vxorps(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(0, 1, 0x57, dst, src1, src2);
+}
+
+void X86_64Assembler::vxorpd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 1, 0x57, dst, src1, src2);
+}
+
+void X86_64Assembler::vcvtdq2ps(XmmRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(0, 1, 0x5B, dst, XmmRegister(XMM0), src);
+}
+
+void X86_64Assembler::vpsllw(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // The destination is encoded in VEX.vvvv, the ModRM.reg field holds the opcode extension.
+  EmitVex256(1, 1, 0x71, XmmRegister(XMM6), dst, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpslld(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // The destination is encoded in VEX.vvvv, the ModRM.reg field holds the opcode extension.
+  EmitVex256(1, 1, 0x72, XmmRegister(XMM6), dst, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsllq(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // The destination is encoded in VEX.vvvv, the ModRM.reg field holds the opcode extension.
+  EmitVex256(1, 1, 0x73, XmmRegister(XMM6), dst, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsraw(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // The destination is encoded in VEX.vvvv, the ModRM.reg field holds the opcode extension.
+  EmitVex256(1, 1, 0x71, XmmRegister(XMM4), dst, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrad(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // The destination is encoded in VEX.vvvv, the ModRM.reg field holds the opcode extension.
+  EmitVex256(1, 1, 0x72, XmmRegister(XMM4), dst, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrlw(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // The destination is encoded in VEX.vvvv, the ModRM.reg field holds the opcode extension.
+  EmitVex256(1, 1, 0x71, XmmRegister(XMM2), dst, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrld(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // The destination is encoded in VEX.vvvv, the ModRM.reg field holds the opcode extension.
+  EmitVex256(1, 1, 0x72, XmmRegister(XMM2), dst, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrlq(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // The destination is encoded in VEX.vvvv, the ModRM.reg field holds the opcode extension.
+  EmitVex256(1, 1, 0x73, XmmRegister(XMM2), dst, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpbroadcastb(XmmRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 2, 0x78, dst, XmmRegister(XMM0), src);
+}
+
+void X86_64Assembler::vpbroadcastw(XmmRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 2, 0x79, dst, XmmRegister(XMM0), src);
+}
+
+void X86_64Assembler::vpbroadcastd(XmmRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 2, 0x58, dst, XmmRegister(XMM0), src);
+}
+
+void X86_64Assembler::vpbroadcastq(XmmRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 2, 0x59, dst, XmmRegister(XMM0), src);
+}
+
+void X86_64Assembler::vbroadcastss(XmmRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 2, 0x18, dst, XmmRegister(XMM0), src);
+}
+
+void X86_64Assembler::vbroadcastsd(XmmRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256(1, 2, 0x19, dst, XmmRegister(XMM0), src);
+}
+
+void X86_64Assembler::vextracti128(XmmRegister dst, XmmRegister src, const Immediate& imm) {
+  DCHECK(imm.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // The source YMM register is encoded in ModRM.reg, the destination in ModRM.rm.
+  EmitVex256(1, 3, 0x39, src, XmmRegister(XMM0), dst);
+  EmitUint8(imm.value());
+}
+
+void X86_64Assembler::vzeroupper() {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0xC5);
+  EmitUint8(0xF8);
+  EmitUint8(0x77);
+}
+
 void X86_64Assembler::AddConstantArea() {
   ArrayRef<const int32_t> area = constant_area_.GetBuffer();
   for (size_t i = 0, e = area.size(); i < e; i++) {
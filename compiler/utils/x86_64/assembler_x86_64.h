@@ -426,6 +426,7 @@ class X86_64Assembler FINAL : public Assembler {
   void movd(CpuRegister dst, XmmRegister src);  // Note: this is the r64 version, formally movq.
   void movd(XmmRegister dst, CpuRegister src, bool is64bit);
   void movd(CpuRegister dst, XmmRegister src, bool is64bit);
+  void pmovmskb(CpuRegister dst, XmmRegister src);
 
   void addss(XmmRegister dst, XmmRegister src);
   void addss(XmmRegister dst, const Address& src);
@@ -440,6 +441,7 @@ class X86_64Assembler FINAL : public Assembler {
   void subps(XmmRegister dst, XmmRegister src);
   void mulps(XmmRegister dst, XmmRegister src);
   void divps(XmmRegister dst, XmmRegister src);
+  void sqrtps(XmmRegister dst, XmmRegister src);
 
   void movapd(XmmRegister dst, XmmRegister src);     // move
   void movapd(XmmRegister dst, const Address& src);  // load aligned
@@ -464,6 +466,7 @@ class X86_64Assembler FINAL : public Assembler {
   void subpd(XmmRegister dst, XmmRegister src);
   void mulpd(XmmRegister dst, XmmRegister src);
   void divpd(XmmRegister dst, XmmRegister src);
+  void sqrtpd(XmmRegister dst, XmmRegister src);
 
   void movdqa(XmmRegister dst, XmmRegister src);     // move
   void movdqa(XmmRegister dst, const Address& src);  // load aligned
@@ -547,6 +550,10 @@ class X86_64Assembler FINAL : public Assembler {
   void pavgw(XmmRegister dst, XmmRegister src);
   void psadbw(XmmRegister dst, XmmRegister src);
   void pmaddwd(XmmRegister dst, XmmRegister src);
+  void pmaddubsw(XmmRegister dst, XmmRegister src);
+  // Carry-less multiplication of the quadwords of `dst` and `src` selected by bits 0 and 4
+  // of `imm`.
+  void pclmulqdq(XmmRegister dst, XmmRegister src, const Immediate& imm);
   void phaddw(XmmRegister dst, XmmRegister src);
   void phaddd(XmmRegister dst, XmmRegister src);
   void haddps(XmmRegister dst, XmmRegister src);
@@ -585,6 +592,9 @@ class X86_64Assembler FINAL : public Assembler {
   void pcmpgtd(XmmRegister dst, XmmRegister src);
   void pcmpgtq(XmmRegister dst, XmmRegister src);  // SSE4.2
 
+  void pcmpestri(XmmRegister dst, XmmRegister src, const Immediate& imm);  // SSE4.2
+  void pcmpestri(XmmRegister dst, const Address& src, const Immediate& imm);  // SSE4.2
+
   void shufpd(XmmRegister dst, XmmRegister src, const Immediate& imm);
   void shufps(XmmRegister dst, XmmRegister src, const Immediate& imm);
   void pshufd(XmmRegister dst, XmmRegister src, const Immediate& imm);
@@ -612,6 +622,87 @@ class X86_64Assembler FINAL : public Assembler {
   void psrlq(XmmRegister reg, const Immediate& shift_count);
   void psrldq(XmmRegister reg, const Immediate& shift_count);
 
+  //
+  // AVX2 256-bit forms, all VEX encoded. XmmRegister operands name the
+  // corresponding YMM register. Note that, unlike their legacy SSE
+  // counterparts, these forms write all 256 bits of the destination.
+  //
+
+  void vmovaps(XmmRegister dst, XmmRegister src);
+  void vmovdqu(XmmRegister dst, const Address& src);  // load unaligned
+  void vmovdqu(const Address& dst, XmmRegister src);  // store unaligned
+  void vmovups(XmmRegister dst, const Address& src);  // load unaligned
+  void vmovups(const Address& dst, XmmRegister src);  // store unaligned
+  void vmovupd(XmmRegister dst, const Address& src);  // load unaligned
+  void vmovupd(const Address& dst, XmmRegister src);  // store unaligned
+  void vmovntdq(const Address& dst, XmmRegister src);  // store non-temporal, 32-byte aligned
+
+  void vpaddb(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpaddw(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpaddd(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpaddq(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpsubb(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpsubw(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpsubd(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpsubq(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpmullw(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpmulld(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpavgb(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpavgw(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpcmpeqb(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpmovmskb(CpuRegister dst, XmmRegister src);
+
+  void vpand(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpandn(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpor(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpxor(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+
+  void vaddps(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vaddpd(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vsubps(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vsubpd(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vmulps(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vmulpd(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vdivps(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vdivpd(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vsqrtps(XmmRegister dst, XmmRegister src);
+  void vsqrtpd(XmmRegister dst, XmmRegister src);
+  // FMA3: dst = src1 * src2 + dst, with a single rounding.
+  void vfmadd231ps(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vfmadd231pd(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vandps(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vandpd(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vandnps(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vandnpd(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vorps(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vorpd(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vxorps(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vxorpd(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+
+  void vcvtdq2ps(XmmRegister dst, XmmRegister src);
+
+  void vpsllw(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+  void vpslld(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+  void vpsllq(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+  void vpsraw(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+  void vpsrad(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+  void vpsrlw(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+  void vpsrld(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+  void vpsrlq(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+
+  // Broadcast the lowest element of the XMM register `src` to all elements of `dst`.
+  void vpbroadcastb(XmmRegister dst, XmmRegister src);
+  void vpbroadcastw(XmmRegister dst, XmmRegister src);
+  void vpbroadcastd(XmmRegister dst, XmmRegister src);
+  void vpbroadcastq(XmmRegister dst, XmmRegister src);
+  void vbroadcastss(XmmRegister dst, XmmRegister src);
+  void vbroadcastsd(XmmRegister dst, XmmRegister src);
+
+  // Extract the 128-bit lane `imm` of `src` into the XMM register `dst`.
+  void vextracti128(XmmRegister dst, XmmRegister src, const Immediate& imm);
+
+  void vzeroupper();
+
   void flds(const Address& src);
   void fstps(const Address& dst);
   void fsts(const Address& dst);
@@ -643,6 +734,7 @@ class X86_64Assembler FINAL : public Assembler {
   void xchgl(CpuRegister dst, CpuRegister src);
   void xchgq(CpuRegister dst, CpuRegister src);
   void xchgl(CpuRegister reg, const Address& address);
+  void xchgq(CpuRegister reg, const Address& address);
 
   void cmpb(const Address& address, const Immediate& imm);
   void cmpw(const Address& address, const Immediate& imm);
@@ -773,8 +865,11 @@ class X86_64Assembler FINAL : public Assembler {
   X86_64Assembler* lock();
   void cmpxchgl(const Address& address, CpuRegister reg);
   void cmpxchgq(const Address& address, CpuRegister reg);
+  void xaddl(const Address& address, CpuRegister reg);
+  void xaddq(const Address& address, CpuRegister reg);
 
   void mfence();
+  void sfence();
 
   X86_64Assembler* gs();
 
@@ -835,11 +930,23 @@ class X86_64Assembler FINAL : public Assembler {
     lock()->cmpxchgq(address, reg);
   }
 
+  void LockXaddl(const Address& address, CpuRegister reg) {
+    lock()->xaddl(address, reg);
+  }
+
+  void LockXaddq(const Address& address, CpuRegister reg) {
+    lock()->xaddq(address, reg);
+  }
+
   //
   // Misc. functionality
   //
   int PreferredLoopAlignment() { return 16; }
   void Align(int alignment, int offset);
+  // Make room in the buffer for `size` more bytes of code.
+  void ReserveCodeSize(size_t size) {
+    buffer_.Reserve(size);
+  }
   void Bind(Label* label) OVERRIDE;
   void Jump(Label* label) OVERRIDE {
     jmp(label);
@@ -910,6 +1017,8 @@ class X86_64Assembler FINAL : public Assembler {
   void EmitOperandSizeOverride();
 
   void EmitOperand(uint8_t rm, const Operand& operand);
+  template <int kLength>
+  void EmitOperandOfLength(uint8_t rm, const Operand& operand);
   void EmitImmediate(const Immediate& imm, bool is_16_op = false);
   void EmitComplex(
       uint8_t rm, const Operand& operand, const Immediate& immediate, bool is_16_op = false);
@@ -952,6 +1061,14 @@ class X86_64Assembler FINAL : public Assembler {
   uint8_t EmitVexByte1(bool r, bool x, bool b, int mmmmm);
   uint8_t EmitVexByte2(bool w , int l , X86_64ManagedRegister operand, int pp);
 
+  // Emit a VEX.256 encoded instruction. `vvvv` is the additional source operand,
+  // or XMM0 when the instruction does not use one (VEX.vvvv = 1111b). `w` is VEX.W,
+  // which selects the double precision form of the FMA instructions.
+  void EmitVex256(int pp, int mmmmm, uint8_t opcode,
+                  XmmRegister reg, XmmRegister vvvv, XmmRegister rm, bool w = false);
+  void EmitVex256(int pp, int mmmmm, uint8_t opcode,
+                  XmmRegister reg, XmmRegister vvvv, const Address& address, bool w = false);
+
   ConstantArea constant_area_;
 
   DISALLOW_COPY_AND_ASSIGN(X86_64Assembler);
@@ -974,11 +1091,19 @@ inline void X86_64Assembler::EmitInt64(int64_t value) {
 }
 
 inline void X86_64Assembler::EmitRegisterOperand(uint8_t rm, uint8_t reg) {
-  CHECK_GE(rm, 0);
-  CHECK_LT(rm, 8);
+  DCHECK_LT(rm, 8);
   buffer_.Emit<uint8_t>((0xC0 | (reg & 7)) + (rm << 3));
 }
 
+// Emit the ModRM byte, updated with `rm`, and the rest of an operand encoding of `kLength` bytes,
+// which is not a register. The copy of the rest of the encoding has a fixed size.
+template <int kLength>
+inline void X86_64Assembler::EmitOperandOfLength(uint8_t rm, const Operand& operand) {
+  DCHECK_EQ(operand.length_, kLength);
+  EmitUint8(operand.encoding_[0] + (rm << 3));
+  buffer_.EmitBytes<kLength - 1>(&operand.encoding_[1]);
+}
+
 inline void X86_64Assembler::EmitXmmRegisterOperand(uint8_t rm, XmmRegister reg) {
   EmitRegisterOperand(rm, static_cast<uint8_t>(reg.AsFloatRegister()));
 }
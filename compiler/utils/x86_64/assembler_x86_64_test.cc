@@ -942,6 +942,20 @@ TEST_F(AssemblerX86_64Test, LockCmpxchgq) {
                      "lock cmpxchg %{reg}, {mem}"), "lock_cmpxchg");
 }
 
+TEST_F(AssemblerX86_64Test, LockXaddl) {
+  DriverStr(RepeatAr(&x86_64::X86_64Assembler::LockXaddl, "lock xaddl %{reg}, {mem}"),
+            "lock_xaddl");
+}
+
+TEST_F(AssemblerX86_64Test, LockXaddq) {
+  DriverStr(RepeatAR(&x86_64::X86_64Assembler::LockXaddq, "lock xaddq %{reg}, {mem}"),
+            "lock_xaddq");
+}
+
+TEST_F(AssemblerX86_64Test, XchgqAddress) {
+  DriverStr(RepeatRA(&x86_64::X86_64Assembler::xchgq, "xchgq %{reg}, {mem}"), "xchgq_address");
+}
+
 TEST_F(AssemblerX86_64Test, MovqStore) {
   DriverStr(RepeatAR(&x86_64::X86_64Assembler::movq, "movq %{reg}, {mem}"), "movq_s");
 }
@@ -1242,6 +1256,14 @@ TEST_F(AssemblerX86_64Test, Divpd) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::divpd, "divpd %{reg2}, %{reg1}"), "divpd");
 }
 
+TEST_F(AssemblerX86_64Test, Sqrtps) {
+  DriverStr(RepeatFF(&x86_64::X86_64Assembler::sqrtps, "sqrtps %{reg2}, %{reg1}"), "sqrtps");
+}
+
+TEST_F(AssemblerX86_64Test, Sqrtpd) {
+  DriverStr(RepeatFF(&x86_64::X86_64Assembler::sqrtpd, "sqrtpd %{reg2}, %{reg1}"), "sqrtpd");
+}
+
 TEST_F(AssemblerX86_64Test, Paddb) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::paddb, "paddb %{reg2}, %{reg1}"), "paddb");
 }
@@ -1422,6 +1444,20 @@ TEST_F(AssemblerX86_64Test, Pmaddwd) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::pmaddwd, "pmaddwd %{reg2}, %{reg1}"), "pmadwd");
 }
 
+TEST_F(AssemblerX86_64Test, Pmaddubsw) {
+  DriverStr(RepeatFF(&x86_64::X86_64Assembler::pmaddubsw, "pmaddubsw %{reg2}, %{reg1}"),
+            "pmaddubsw");
+}
+
+TEST_F(AssemblerX86_64Test, Pclmulqdq) {
+  DriverStr(RepeatFFI(&x86_64::X86_64Assembler::pclmulqdq, /*imm_bytes*/ 1U,
+                      "pclmulqdq ${imm}, %{reg2}, %{reg1}"), "pclmulqdq");
+}
+
+TEST_F(AssemblerX86_64Test, Pmovmskb) {
+  DriverStr(RepeatrF(&x86_64::X86_64Assembler::pmovmskb, "pmovmskb %{reg2}, %{reg1}"), "pmovmskb");
+}
+
 TEST_F(AssemblerX86_64Test, Phaddw) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::phaddw, "phaddw %{reg2}, %{reg1}"), "phaddw");
 }
@@ -1550,6 +1586,22 @@ TEST_F(AssemblerX86_64Test, PCmpgtq) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::pcmpgtq, "pcmpgtq %{reg2}, %{reg1}"), "pcmpgtq");
 }
 
+TEST_F(AssemblerX86_64Test, PCmpestri) {
+  DriverStr(RepeatFFI(&x86_64::X86_64Assembler::pcmpestri, /*imm_bytes*/ 1U,
+                      "pcmpestri ${imm}, %{reg2}, %{reg1}"), "pcmpestri");
+}
+
+TEST_F(AssemblerX86_64Test, PCmpestriAddress) {
+  GetAssembler()->pcmpestri(x86_64::XmmRegister(x86_64::XMM0),
+                            x86_64::Address(x86_64::CpuRegister(x86_64::RDI), 0),
+                            x86_64::Immediate(0x0C));
+  GetAssembler()->pcmpestri(x86_64::XmmRegister(x86_64::XMM9),
+                            x86_64::Address(x86_64::CpuRegister(x86_64::R10), 16),
+                            x86_64::Immediate(0x0D));
+  DriverStr("pcmpestri $0xc, (%rdi), %xmm0\n"
+            "pcmpestri $0xd, 0x10(%r10), %xmm9\n", "pcmpestri_address");
+}
+
 TEST_F(AssemblerX86_64Test, Shufps) {
   DriverStr(RepeatFFI(&x86_64::X86_64Assembler::shufps, /*imm_bytes*/ 1U,
                       "shufps ${imm}, %{reg2}, %{reg1}"), "shufps");
@@ -1668,6 +1720,113 @@ TEST_F(AssemblerX86_64Test, Psrldq) {
             "psrldq $2, %xmm15\n", "psrldqi");
 }
 
+TEST_F(AssemblerX86_64Test, Vpaddd) {
+  GetAssembler()->vpaddd(x86_64::XmmRegister(x86_64::XMM0),
+                         x86_64::XmmRegister(x86_64::XMM1),
+                         x86_64::XmmRegister(x86_64::XMM2));
+  GetAssembler()->vpaddd(x86_64::XmmRegister(x86_64::XMM8),
+                         x86_64::XmmRegister(x86_64::XMM9),
+                         x86_64::XmmRegister(x86_64::XMM15));
+  DriverStr("vpaddd %ymm2, %ymm1, %ymm0\n"
+            "vpaddd %ymm15, %ymm9, %ymm8\n", "vpaddd");
+}
+
+TEST_F(AssemblerX86_64Test, Vmulps) {
+  GetAssembler()->vmulps(x86_64::XmmRegister(x86_64::XMM3),
+                         x86_64::XmmRegister(x86_64::XMM12),
+                         x86_64::XmmRegister(x86_64::XMM5));
+  DriverStr("vmulps %ymm5, %ymm12, %ymm3\n", "vmulps");
+}
+
+TEST_F(AssemblerX86_64Test, Vsqrt) {
+  GetAssembler()->vsqrtps(x86_64::XmmRegister(x86_64::XMM0), x86_64::XmmRegister(x86_64::XMM9));
+  GetAssembler()->vsqrtpd(x86_64::XmmRegister(x86_64::XMM14), x86_64::XmmRegister(x86_64::XMM10));
+  DriverStr("vsqrtps %ymm9, %ymm0\n"
+            "vsqrtpd %ymm10, %ymm14\n", "vsqrt");
+}
+
+TEST_F(AssemblerX86_64Test, Vfmadd231) {
+  GetAssembler()->vfmadd231ps(x86_64::XmmRegister(x86_64::XMM1),
+                              x86_64::XmmRegister(x86_64::XMM2),
+                              x86_64::XmmRegister(x86_64::XMM3));
+  GetAssembler()->vfmadd231pd(x86_64::XmmRegister(x86_64::XMM8),
+                              x86_64::XmmRegister(x86_64::XMM13),
+                              x86_64::XmmRegister(x86_64::XMM15));
+  DriverStr("vfmadd231ps %ymm3, %ymm2, %ymm1\n"
+            "vfmadd231pd %ymm15, %ymm13, %ymm8\n", "vfmadd231");
+}
+
+TEST_F(AssemblerX86_64Test, Vpmulld) {
+  GetAssembler()->vpmulld(x86_64::XmmRegister(x86_64::XMM1),
+                          x86_64::XmmRegister(x86_64::XMM2),
+                          x86_64::XmmRegister(x86_64::XMM11));
+  DriverStr("vpmulld %ymm11, %ymm2, %ymm1\n", "vpmulld");
+}
+
+TEST_F(AssemblerX86_64Test, VmovdquLoadStore) {
+  GetAssembler()->vmovdqu(x86_64::XmmRegister(x86_64::XMM0),
+                          x86_64::Address(x86_64::CpuRegister(x86_64::RSP), 32));
+  GetAssembler()->vmovdqu(x86_64::XmmRegister(x86_64::XMM9),
+                          x86_64::Address(x86_64::CpuRegister(x86_64::R9),
+                                          x86_64::CpuRegister(x86_64::R10),
+                                          x86_64::TIMES_4,
+                                          16));
+  GetAssembler()->vmovdqu(x86_64::Address(x86_64::CpuRegister(x86_64::RAX), 0),
+                          x86_64::XmmRegister(x86_64::XMM14));
+  DriverStr("vmovdqu 0x20(%rsp), %ymm0\n"
+            "vmovdqu 0x10(%r9,%r10,4), %ymm9\n"
+            "vmovdqu %ymm14, (%rax)\n", "vmovdqu");
+}
+
+TEST_F(AssemblerX86_64Test, Vmovntdq) {
+  GetAssembler()->vmovntdq(x86_64::Address(x86_64::CpuRegister(x86_64::RDI), 64),
+                           x86_64::XmmRegister(x86_64::XMM1));
+  GetAssembler()->vmovntdq(x86_64::Address(x86_64::CpuRegister(x86_64::R11),
+                                           x86_64::CpuRegister(x86_64::R12),
+                                           x86_64::TIMES_1,
+                                           0),
+                           x86_64::XmmRegister(x86_64::XMM13));
+  DriverStr("vmovntdq %ymm1, 0x40(%rdi)\n"
+            "vmovntdq %ymm13, (%r11,%r12,1)\n", "vmovntdq");
+}
+
+TEST_F(AssemblerX86_64Test, Vpmovmskb) {
+  GetAssembler()->vpmovmskb(x86_64::CpuRegister(x86_64::RAX), x86_64::XmmRegister(x86_64::XMM3));
+  GetAssembler()->vpmovmskb(x86_64::CpuRegister(x86_64::R10), x86_64::XmmRegister(x86_64::XMM15));
+  DriverStr("vpmovmskb %ymm3, %eax\n"
+            "vpmovmskb %ymm15, %r10d\n", "vpmovmskb");
+}
+
+TEST_F(AssemblerX86_64Test, VectorShiftsImm) {
+  GetAssembler()->vpslld(x86_64::XmmRegister(x86_64::XMM1),
+                         x86_64::XmmRegister(x86_64::XMM2),
+                         x86_64::Immediate(3));
+  GetAssembler()->vpsraw(x86_64::XmmRegister(x86_64::XMM10),
+                         x86_64::XmmRegister(x86_64::XMM13),
+                         x86_64::Immediate(1));
+  GetAssembler()->vpsrlq(x86_64::XmmRegister(x86_64::XMM0),
+                         x86_64::XmmRegister(x86_64::XMM8),
+                         x86_64::Immediate(7));
+  DriverStr("vpslld $3, %ymm2, %ymm1\n"
+            "vpsraw $1, %ymm13, %ymm10\n"
+            "vpsrlq $7, %ymm8, %ymm0\n", "vshifts");
+}
+
+TEST_F(AssemblerX86_64Test, BroadcastExtractAndZeroUpper) {
+  GetAssembler()->vpbroadcastd(x86_64::XmmRegister(x86_64::XMM0),
+                               x86_64::XmmRegister(x86_64::XMM9));
+  GetAssembler()->vbroadcastsd(x86_64::XmmRegister(x86_64::XMM12),
+                               x86_64::XmmRegister(x86_64::XMM1));
+  GetAssembler()->vextracti128(x86_64::XmmRegister(x86_64::XMM11),
+                               x86_64::XmmRegister(x86_64::XMM2),
+                               x86_64::Immediate(1));
+  GetAssembler()->vzeroupper();
+  DriverStr("vpbroadcastd %xmm9, %ymm0\n"
+            "vbroadcastsd %xmm1, %ymm12\n"
+            "vextracti128 $1, %ymm2, %xmm11\n"
+            "vzeroupper\n", "vbroadcast");
+}
+
 std::string x87_fn(AssemblerX86_64Test::Base* assembler_test ATTRIBUTE_UNUSED,
                    x86_64::X86_64Assembler* assembler) {
   std::ostringstream str;
@@ -1470,8 +1470,9 @@ TEST_F(VerifierDepsTest, CompilerDriver) {
       VerifyWithCompilerDriver(&decoded_deps);
 
       if (verify_failure) {
+        // The tainted dependencies were dropped and recorded again.
         ASSERT_FALSE(verifier_deps_ == nullptr);
-        ASSERT_FALSE(verifier_deps_->Equals(decoded_deps));
+        ASSERT_TRUE(verifier_deps_->Equals(decoded_deps));
       } else {
         VerifyClassStatus(decoded_deps);
       }
@@ -1492,6 +1493,45 @@ TEST_F(VerifierDepsTest, MultiDexVerification) {
   ASSERT_FALSE(buffer.empty());
 }
 
+TEST_F(VerifierDepsTest, MultiDexValidation) {
+  VerifyDexFile("MultiDex");
+  ASSERT_EQ(NumberOfCompiledDexFiles(), 2u);
+
+  std::vector<uint8_t> buffer;
+  verifier_deps_->Encode(dex_files_, &buffer);
+  ASSERT_FALSE(buffer.empty());
+
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<1> hs(soa.Self());
+  MutableHandle<mirror::ClassLoader> new_class_loader(hs.NewHandle<mirror::ClassLoader>(nullptr));
+  VerifierDeps decoded_deps(dex_files_, ArrayRef<const uint8_t>(buffer));
+  // Taint the dependencies of the primary dex file only.
+  VerifierDeps::DexFileDeps* deps = decoded_deps.GetDexFileDeps(*primary_dex_file_);
+  bool found = false;
+  for (const auto& entry : deps->classes_) {
+    if (entry.IsResolved()) {
+      deps->classes_.insert(VerifierDeps::ClassResolution(
+          entry.GetDexTypeIndex(), VerifierDeps::kUnresolvedMarker));
+      found = true;
+      break;
+    }
+  }
+  ASSERT_TRUE(found);
+  const DexFile* secondary_dex_file = dex_files_[1];
+  new_class_loader.Assign(
+      soa.Decode<mirror::ClassLoader>(LoadMultiDex("VerifierDeps", "MultiDex")));
+  ASSERT_FALSE(decoded_deps.ValidateDependencies(new_class_loader, soa.Self()));
+  ASSERT_FALSE(decoded_deps.ValidateDependencies(new_class_loader, *primary_dex_file_, soa.Self()));
+  ASSERT_TRUE(decoded_deps.ValidateDependencies(new_class_loader, *secondary_dex_file, soa.Self()));
+
+  decoded_deps.ClearDependencies(*primary_dex_file_);
+  deps = decoded_deps.GetDexFileDeps(*primary_dex_file_);
+  ASSERT_TRUE(deps->classes_.empty());
+  ASSERT_TRUE(deps->unverified_classes_.empty());
+  ASSERT_TRUE(decoded_deps.GetDexFileDeps(*secondary_dex_file)->Equals(
+      *verifier_deps_->GetDexFileDeps(*secondary_dex_file)));
+}
+
 TEST_F(VerifierDepsTest, NotAssignable_InterfaceWithClassInBoot) {
   ASSERT_TRUE(TestAssignabilityRecording(/* dst */ "Ljava/lang/Exception;",
                                          /* src */ "LIface;",
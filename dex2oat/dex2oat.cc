@@ -340,6 +340,12 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("      Example: --num-dex-method=%d", CompilerOptions::kDefaultNumDexMethodsThreshold);
   UsageError("      Default: %d", CompilerOptions::kDefaultNumDexMethodsThreshold);
   UsageError("");
+  UsageError("  --large-graph-max=<instruction-count>: threshold size of the optimizing");
+  UsageError("      compiler graph of a method, above which only the optimizations the code");
+  UsageError("      generator relies on are run, to bound the compilation time of the method.");
+  UsageError("      Example: --large-graph-max=%d", CompilerOptions::kDefaultLargeGraphThreshold);
+  UsageError("      Default: %d", CompilerOptions::kDefaultLargeGraphThreshold);
+  UsageError("");
   UsageError("  --inline-max-code-units=<code-units-count>: the maximum code units that a method");
   UsageError("      can have to be considered for inlining. A zero value will disable inlining.");
   UsageError("      Honored only by Optimizing. Has priority over the --compiler-filter option.");
@@ -348,6 +354,14 @@ NO_RETURN static void Usage(const char* fmt, ...) {
              CompilerOptions::kDefaultInlineMaxCodeUnits);
   UsageError("      Default: %d", CompilerOptions::kDefaultInlineMaxCodeUnits);
   UsageError("");
+  UsageError("  --method-options=<file>: overrides compiler options for single methods. Each");
+  UsageError("      line of the file is a comma-separated list of options, a space, and the");
+  UsageError("      method with its signature, e.g. \"int Foo.bar(int)\". The options are");
+  UsageError("      disable=<pass>, register-allocation-strategy=<strategy> and");
+  UsageError("      inline-max-code-units=<code-units-count>.");
+  UsageError("      Honored only by Optimizing. Intended for development/experimental use.");
+  UsageError("      Example: --method-options=/path/to/options.txt");
+  UsageError("");
   UsageError("  --dump-timings: display a breakdown of where time was spent");
   UsageError("");
   UsageError("  -g");
@@ -423,6 +437,11 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("      the default behavior). This option is only meaningful when used with");
   UsageError("      --dump-cfg.");
   UsageError("");
+  UsageError("  --dump-pass-trace=<trace-file>: record the wall time, instruction count change");
+  UsageError("      and arena bytes of each optimizing pass of each method into a compact binary");
+  UsageError("      trace. Summarize it with tools/pass_trace_summary.py.");
+  UsageError("      Example: --dump-pass-trace=passes.trace");
+  UsageError("");
   UsageError("  --classpath-dir=<directory-path>: directory used to resolve relative class paths.");
   UsageError("");
   UsageError("  --class-loader-context=<string spec>: a string specifying the intended");
@@ -465,6 +484,30 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("  --deduplicate-code=true|false: enable|disable code deduplication. Deduplicated");
   UsageError("      code will have an arbitrary symbol tagged with [DEDUPED].");
   UsageError("");
+  UsageError("  --loop-nest-optimization: interchange loop nests that walk two-dimensional");
+  UsageError("      arrays by column, so that the inner loop walks along the rows.");
+  UsageError("");
+  UsageError("  --initialize-app-image-classes: run the class initializers of the app image");
+  UsageError("      classes at compile time, and store the initialized classes and the objects");
+  UsageError("      that their initializers reach in the app image. The processes that load the");
+  UsageError("      app image start with these classes initialized.");
+  UsageError("");
+  UsageError("  --suspend-check-iteration-budget=<iteration-count>: the maximum number of");
+  UsageError("      iterations of a counted loop, including those of its nested loops, that run");
+  UsageError("      without polling for thread suspension. A zero value polls in every loop.");
+  UsageError("      Example: --suspend-check-iteration-budget=%zu",
+             CompilerOptions::kDefaultSuspendCheckIterationBudget);
+  UsageError("      Default: %zu", CompilerOptions::kDefaultSuspendCheckIterationBudget);
+  UsageError("");
+  UsageError("  --compile-shard-count=<count>: partition the methods in <count> shards, which");
+  UsageError("      only depend on the input dex files, and compile the methods of one of them.");
+  UsageError("      Example: --compile-shard-count=4");
+  UsageError("      Default: 1");
+  UsageError("");
+  UsageError("  --compile-shard-index=<index>: the shard to compile, below the shard count.");
+  UsageError("      Example: --compile-shard-index=2");
+  UsageError("      Default: 0");
+  UsageError("");
   UsageError("  --copy-dex-files=true|false: enable|disable copying the dex files into the");
   UsageError("      output vdex.");
   UsageError("");
@@ -634,6 +677,7 @@ class Dex2Oat FINAL {
       compiled_methods_zip_filename_(nullptr),
       compiled_methods_filename_(nullptr),
       passes_to_run_filename_(nullptr),
+      method_options_filename_(nullptr),
       dirty_image_objects_filename_(nullptr),
       multi_image_(false),
       is_host_(false),
@@ -977,6 +1021,20 @@ class Dex2Oat FINAL {
       }
     }
     compiler_options_->passes_to_run_ = passes_to_run_.get();
+
+    if (method_options_filename_ != nullptr) {
+      std::unique_ptr<std::vector<std::string>> method_options(
+          ReadCommentedInputFromFile<std::vector<std::string>>(
+              method_options_filename_,
+              nullptr));         // No post-processing.
+      if (method_options == nullptr) {
+        Usage("Failed to read the method options.");
+      }
+      std::string error_msg;
+      if (!compiler_options_->ParseMethodOptions(*method_options, &error_msg)) {
+        Usage("Failed to parse the method options: %s", error_msg.c_str());
+      }
+    }
   }
 
   static bool SupportsDeterministicCompilation() {
@@ -1217,6 +1275,7 @@ class Dex2Oat FINAL {
     AssignIfExists(args, M::CompiledMethods, &compiled_methods_filename_);
     AssignIfExists(args, M::CompiledMethodsZip, &compiled_methods_zip_filename_);
     AssignIfExists(args, M::Passes, &passes_to_run_filename_);
+    AssignIfExists(args, M::MethodOptions, &method_options_filename_);
     AssignIfExists(args, M::BootImage, &parser_options->boot_image_filename);
     AssignIfExists(args, M::AndroidRoot, &android_root_);
     AssignIfExists(args, M::Profile, &profile_file_);
@@ -1811,6 +1870,16 @@ class Dex2Oat FINAL {
         !CompilerFilter::IsAotCompilationEnabled(compiler_options_->GetCompilerFilter());
   }
 
+  // Whether the code items of the different dex files in a vdex file may be deduplicated. The dex
+  // files compiled individually unload the classes of the ones compiled before them, and would
+  // then verify again the code items quickened for them. Unlike ShouldCompileDexFilesIndividually,
+  // this is decided before the dex files are opened, so it does not depend on their number.
+  bool CanDedupeCodeItemsAcrossDexFiles() const {
+    return IsImage() ||
+        update_input_vdex_ ||
+        CompilerFilter::IsAotCompilationEnabled(compiler_options_->GetCompilerFilter());
+  }
+
   // Set up and create the compiler driver and then invoke it to compile all the dex files.
   jobject Compile() {
     ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
@@ -2136,16 +2205,21 @@ class Dex2Oat FINAL {
         }
       }
 
+      // We need to mirror the layout of the ELF file in the compressed debug-info.
+      // Therefore PrepareDebugInfo() relies on the SetLoadedSectionSizes() call further above.
+      // Prepare the debug info of all the oat files before writing any of them, so that the
+      // compression of the debug info of each oat file also overlaps with the writing of the
+      // oat files before it.
+      for (size_t i = 0, size = oat_files_.size(); i != size; ++i) {
+        // Processes the data on background thread.
+        elf_writers_[i]->PrepareDebugInfo(oat_writers_[i]->GetDebugInfo());
+      }
+
       for (size_t i = 0, size = oat_files_.size(); i != size; ++i) {
         std::unique_ptr<File>& oat_file = oat_files_[i];
         std::unique_ptr<linker::ElfWriter>& elf_writer = elf_writers_[i];
         std::unique_ptr<linker::OatWriter>& oat_writer = oat_writers_[i];
 
-        // We need to mirror the layout of the ELF file in the compressed debug-info.
-        // Therefore PrepareDebugInfo() relies on the SetLoadedSectionSizes() call further above.
-        debug::DebugInfo debug_info = oat_writer->GetDebugInfo();  // Keep the variable alive.
-        elf_writer->PrepareDebugInfo(debug_info);  // Processes the data on background thread.
-
         linker::OutputStream*& rodata = rodata_[i];
         DCHECK(rodata != nullptr);
         if (!oat_writer->WriteRodata(rodata)) {
@@ -2556,7 +2630,8 @@ class Dex2Oat FINAL {
           IsBootImage(),
           timings_,
           do_oat_writer_layout ? profile_compilation_info_.get() : nullptr,
-          compact_dex_level_));
+          compact_dex_level_,
+          CanDedupeCodeItemsAcrossDexFiles()));
     }
   }
 
@@ -2914,6 +2989,7 @@ class Dex2Oat FINAL {
   const char* compiled_methods_zip_filename_;
   const char* compiled_methods_filename_;
   const char* passes_to_run_filename_;
+  const char* method_options_filename_;
   const char* dirty_image_objects_filename_;
   std::unique_ptr<std::unordered_set<std::string>> image_classes_;
   std::unique_ptr<std::unordered_set<std::string>> compiled_classes_;
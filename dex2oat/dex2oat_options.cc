@@ -172,6 +172,9 @@ static void AddCompilerMappings(Builder& builder) {
       .Define("--run-passes=_")
           .WithType<std::string>()
           .IntoKey(M::Passes)
+      .Define("--method-options=_")
+          .WithType<std::string>()
+          .IntoKey(M::MethodOptions)
       .Define("--profile-file=_")
           .WithType<std::string>()
           .IntoKey(M::Profile)
@@ -89,7 +89,9 @@ class DebugInfoTask : public Task {
   size_t text_section_size_;
   uint64_t dex_section_address_;
   size_t dex_section_size_;
-  const debug::DebugInfo& debug_info_;
+  // A copy, so that the caller does not need to keep the debug info alive. It only references the
+  // data of the methods and dex files.
+  const debug::DebugInfo debug_info_;
   std::vector<uint8_t> result_;
 };
 
@@ -249,7 +249,8 @@ inline void CompilationHelper::Compile(CompilerDriver* driver,
         oat_writers.emplace_back(new OatWriter(/*compiling_boot_image*/true,
                                                &timings,
                                                /*profile_compilation_info*/nullptr,
-                                               CompactDexLevel::kCompactDexLevelNone));
+                                               CompactDexLevel::kCompactDexLevelNone,
+                                               /*dedupe_code_items_across_dex_files*/true));
       }
 
       std::vector<OutputStream*> rodata;
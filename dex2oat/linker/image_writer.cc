@@ -20,6 +20,7 @@
 #include <lz4hc.h>
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
 #include <unordered_set>
@@ -27,6 +28,7 @@
 
 #include "art_field-inl.h"
 #include "art_method-inl.h"
+#include "base/array_ref.h"
 #include "base/callee_save_type.h"
 #include "base/enums.h"
 #include "base/logging.h"  // For VLOG.
@@ -36,6 +38,7 @@
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_types.h"
 #include "driver/compiler_driver.h"
+#include "driver/compiler_options.h"
 #include "elf_file.h"
 #include "elf_utils.h"
 #include "gc/accounting/card_table-inl.h"
@@ -49,9 +52,11 @@
 #include "gc/verification.h"
 #include "globals.h"
 #include "handle_scope-inl.h"
+#include "identity_hash_table.h"
 #include "image.h"
 #include "imt_conflict_table.h"
 #include "subtype_check.h"
+#include "jit/profile_compilation_info.h"
 #include "jni_internal.h"
 #include "linear_alloc.h"
 #include "lock_word.h"
@@ -72,6 +77,7 @@
 #include "oat_file_manager.h"
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_pool.h"
 #include "utils/dex_cache_arrays_layout-inl.h"
 #include "well_known_classes.h"
 
@@ -87,6 +93,9 @@ namespace linker {
 // Separate objects into multiple bins to optimize dirty memory use.
 static constexpr bool kBinObjects = true;
 
+// The minimum number of objects copied by a task of CopyAndFixupObjects.
+static constexpr size_t kMinObjectsPerCopyTask = 4096u;
+
 // Return true if an object is already in an image space.
 bool ImageWriter::IsInBootImage(const void* obj) const {
   gc::Heap* const heap = Runtime::Current()->GetHeap();
@@ -194,8 +203,8 @@ bool ImageWriter::Write(int image_fd,
     // TODO: heap validation can't handle these fix up passes.
     ScopedObjectAccess soa(Thread::Current());
     Runtime::Current()->GetHeap()->DisableObjectValidation();
-    CopyAndFixupObjects();
   }
+  CopyAndFixupObjects();
 
   for (size_t i = 0; i < image_filenames.size(); ++i) {
     const char* image_filename = image_filenames[i];
@@ -412,9 +421,19 @@ void ImageWriter::SetImageBinSlot(mirror::Object* object, BinSlot bin_slot) {
       LOG(FATAL) << oss.str();
       break;
     }
-    case LockWord::kUnlocked:
-      // No hash, don't need to save it.
+    case LockWord::kUnlocked: {
+      // The hash code of an object hashed while thin locked is still in the side table.
+      IdentityHashTable* table = Runtime::Current()->GetIdentityHashTable();
+      Thread* self = Thread::Current();
+      if (table->MayHaveEntryFor(self, object)) {
+        int32_t hash_code = table->Lookup(self, object);
+        if (hash_code != 0) {
+          DCHECK(saved_hashcode_map_.find(object) == saved_hashcode_map_.end());
+          saved_hashcode_map_.emplace(object, static_cast<uint32_t>(hash_code));
+        }
+      }
       break;
+    }
     case LockWord::kHashCode:
       DCHECK(saved_hashcode_map_.find(object) == saved_hashcode_map_.end());
       saved_hashcode_map_.emplace(object, lw.GetHashCode());
@@ -608,6 +627,10 @@ void ImageWriter::AssignImageBinSlot(mirror::Object* object, size_t oat_index) {
             bin = Bin::kClassInitializedFinalStatics;
           }
         }
+      } else if (IsClassInProfile(klass)) {
+        // The classes used at startup are initialized, and so dirtied, by every process. Keep
+        // the pages of the other verified classes clean in the processes that don't use them.
+        bin = Bin::kClassVerifiedInProfile;
       }
     } else if (object->GetClass<kVerifyNone>()->IsStringClass()) {
       bin = Bin::kString;  // Strings are almost always immutable (except for object header).
@@ -653,6 +676,14 @@ bool ImageWriter::WillMethodBeDirty(ArtMethod* m) const {
   return declaring_class == nullptr || declaring_class->GetStatus() != ClassStatus::kInitialized;
 }
 
+bool ImageWriter::IsClassInProfile(mirror::Class* klass) const {
+  const ProfileCompilationInfo* profile = compiler_driver_.GetProfileCompilationInfo();
+  if (profile == nullptr || klass->IsArrayClass() || klass->IsPrimitive() || klass->IsProxyClass()) {
+    return false;
+  }
+  return profile->ContainsClass(klass->GetDexFile(), klass->GetDexTypeIndex());
+}
+
 bool ImageWriter::IsImageBinSlotAssigned(mirror::Object* object) const {
   DCHECK(object != nullptr);
 
@@ -1963,6 +1994,9 @@ void ImageWriter::CreateHeader(size_t oat_index) {
   gc::Heap* const heap = Runtime::Current()->GetHeap();
   heap->GetBootImagesSize(&boot_image_begin, &boot_image_end, &boot_oat_begin, &boot_oat_end);
 
+  const bool has_initialized_classes =
+      compile_app_image_ && compiler_driver_.GetCompilerOptions().InitializeAppImageClasses();
+
   // Create the header, leave 0 for data size since we will fill this in as we are writing the
   // image.
   new (image_info.image_->Begin()) ImageHeader(PointerToLowMemUInt32(image_info.image_begin_),
@@ -1981,6 +2015,7 @@ void ImageWriter::CreateHeader(size_t oat_index) {
                                                static_cast<uint32_t>(target_ptr_size_),
                                                compile_pic_,
                                                /*is_pic*/compile_app_image_,
+                                               has_initialized_classes,
                                                image_storage_mode_,
                                                /*data_size*/0u);
 }
@@ -2157,12 +2192,72 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
   }
 }
 
+class ImageWriter::CopyAndFixupObjectsTask FINAL : public Task {
+ public:
+  CopyAndFixupObjectsTask(ImageWriter* image_writer, ArrayRef<Object* const> objects)
+      : image_writer_(image_writer), objects_(objects) {}
+
+  void Run(Thread* self) OVERRIDE {
+    ScopedObjectAccess soa(self);
+    // Held by the heap visit that used to copy the objects.
+    ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
+    for (Object* obj : objects_) {
+      image_writer_->CopyAndFixupObject(obj);
+    }
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  ImageWriter* const image_writer_;
+  const ArrayRef<Object* const> objects_;
+};
+
 void ImageWriter::CopyAndFixupObjects() {
-  auto visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
-    DCHECK(obj != nullptr);
-    CopyAndFixupObject(obj);
-  };
-  Runtime::Current()->GetHeap()->VisitObjects(visitor);
+  Thread* self = Thread::Current();
+  // Copy the objects in the order of their image addresses, so that each task writes a range of
+  // the image, within the same bins.
+  std::vector<Object*> objects;
+  {
+    ScopedObjectAccess soa(self);
+    auto visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+      DCHECK(obj != nullptr);
+      if (!IsInBootImage(obj)) {
+        objects.push_back(obj);
+      }
+    };
+    Runtime::Current()->GetHeap()->VisitObjects(visitor);
+    std::sort(objects.begin(),
+              objects.end(),
+              [this](Object* lhs, Object* rhs) REQUIRES_SHARED(Locks::mutator_lock_) {
+                return GetImageAddress(lhs) < GetImageAddress(rhs);
+              });
+  }
+  // The objects are only read, and the copies are written at distinct addresses. The image bitmap
+  // is updated atomically.
+  const size_t thread_count = compiler_driver_.GetThreadCount();
+  if (thread_count > 1u && objects.size() >= 2u * kMinObjectsPerCopyTask) {
+    ThreadPool thread_pool("Image writer thread pool", thread_count - 1u);
+    // A few tasks per thread, to balance the bins whose objects are slower to fix up.
+    const size_t objects_per_task =
+        std::max(kMinObjectsPerCopyTask, objects.size() / (4u * thread_count));
+    ArrayRef<Object* const> remaining(objects);
+    while (!remaining.empty()) {
+      const size_t count = std::min(objects_per_task, remaining.size());
+      thread_pool.AddTask(self, new CopyAndFixupObjectsTask(this, remaining.SubArray(0u, count)));
+      remaining = remaining.SubArray(count);
+    }
+    thread_pool.StartWorkers(self);
+    thread_pool.Wait(self, /* do_work */ true, /* may_hold_locks */ false);
+    thread_pool.StopWorkers(self);
+  } else {
+    CopyAndFixupObjectsTask task(this, ArrayRef<Object* const>(objects));
+    task.Run(self);
+  }
+
+  ScopedObjectAccess soa(self);
   // Fix up the object previously had hash codes.
   for (const auto& hash_pair : saved_hashcode_map_) {
     Object* obj = hash_pair.first;
@@ -2217,7 +2312,9 @@ void ImageWriter::CopyAndFixupObject(Object* obj) {
   DCHECK_LT(offset, image_info.image_end_);
   const auto* src = reinterpret_cast<const uint8_t*>(obj);
 
-  image_info.image_bitmap_->Set(dst);  // Mark the obj as live.
+  // Mark the obj as live. Atomically, as objects are copied in parallel.
+  bool was_marked = image_info.image_bitmap_->AtomicTestAndSet(dst);
+  DCHECK(!was_marked);
 
   const size_t n = obj->SizeOf();
   DCHECK_LE(offset + n, image_info.image_->Size());
@@ -2392,9 +2489,9 @@ void ImageWriter::FixupObject(Object* orig, Object* copy) {
     // Is this a native pointer array?
     auto it = pointer_arrays_.find(down_cast<mirror::PointerArray*>(orig));
     if (it != pointer_arrays_.end()) {
-      // Should only need to fixup every pointer array exactly once.
+      // Every pointer array is fixed up exactly once, as every object is copied once. The map is
+      // not updated, the objects are copied in parallel.
       FixupPointerArray(copy, down_cast<mirror::PointerArray*>(orig), klass, it->second);
-      pointer_arrays_.erase(it);
       return;
     }
   }
@@ -165,6 +165,7 @@ class ImageWriter FINAL {
   enum class Bin {
     kKnownDirty,                  // Known dirty objects from --dirty-image-objects list
     kMiscDirty,                   // Dex caches, object locks, etc...
+    kClassVerifiedInProfile,      // Class verified and in the profile, initialized at startup
     kClassVerified,               // Class verified, but initializers haven't been run
     // Unknown mix of clean/dirty:
     kRegular,
@@ -458,7 +459,7 @@ class ImageWriter FINAL {
 
   // Creates the contiguous image in memory and adjusts pointers.
   void CopyAndFixupNativeData(size_t oat_index) REQUIRES_SHARED(Locks::mutator_lock_);
-  void CopyAndFixupObjects() REQUIRES_SHARED(Locks::mutator_lock_);
+  void CopyAndFixupObjects() REQUIRES(!Locks::mutator_lock_);
   void CopyAndFixupObject(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_);
   void CopyAndFixupMethod(ArtMethod* orig, ArtMethod* copy, const ImageInfo& image_info)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -486,6 +487,9 @@ class ImageWriter FINAL {
   // Return true if a method is likely to be dirtied at runtime.
   bool WillMethodBeDirty(ArtMethod* m) const REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return true if a class is in the profile, and so likely used by every process.
+  bool IsClassInProfile(mirror::Class* klass) const REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Assign the offset for an ArtMethod.
   void AssignMethodOffset(ArtMethod* method,
                           NativeObjectRelocationType type,
@@ -644,6 +648,7 @@ class ImageWriter FINAL {
   const std::unordered_set<std::string>* dirty_image_objects_;
 
   class ComputeLazyFieldsForClassesVisitor;
+  class CopyAndFixupObjectsTask;
   class FixupClassVisitor;
   class FixupRootVisitor;
   class FixupVisitor;
@@ -376,7 +376,8 @@ class OatWriter::OatDexFile {
 OatWriter::OatWriter(bool compiling_boot_image,
                      TimingLogger* timings,
                      ProfileCompilationInfo* info,
-                     CompactDexLevel compact_dex_level)
+                     CompactDexLevel compact_dex_level,
+                     bool dedupe_code_items_across_dex_files)
   : write_state_(WriteState::kAddingDexFileSources),
     timings_(timings),
     raw_dex_files_(),
@@ -458,7 +459,8 @@ OatWriter::OatWriter(bool compiling_boot_image,
     relative_patcher_(nullptr),
     absolute_patch_locations_(),
     profile_compilation_info_(info),
-    compact_dex_level_(compact_dex_level) {
+    compact_dex_level_(compact_dex_level),
+    dedupe_code_items_across_dex_files_(dedupe_code_items_across_dex_files) {
   // If we have a profile, always use at least the default compact dex level. The reason behind
   // this is that CompactDex conversion is not more expensive than normal dexlayout.
   if (info != nullptr && compact_dex_level_ == CompactDexLevel::kCompactDexLevelNone) {
@@ -1028,17 +1030,14 @@ struct OatWriter::OrderedMethodData {
 
   // Bin each method according to the profile flags.
   //
-  // Groups by e.g.
-  //  -- not hot at all
-  //  -- hot
-  //  -- hot and startup
+  // Groups by
+  //  -- hot and startup (and maybe post-startup)
+  //  -- startup (and maybe post-startup)
   //  -- hot and post-startup
-  //  -- hot and startup and poststartup
-  //  -- startup
-  //  -- startup and post-startup
   //  -- post-startup
+  //  -- not in the profile
   //
-  // (See MethodHotness enum definition for up-to-date binning order.)
+  // (See GetMethodHotnessOrder.)
   bool operator<(const OrderedMethodData& other) const {
     if (kOatWriterForceOatCodeLayout) {
       // Development flag: Override default behavior by sorting by name.
@@ -1061,24 +1060,6 @@ struct OatWriter::OrderedMethodData {
   // Used to determine relative order for OAT code layout when determining
   // binning.
   size_t GetMethodHotnessOrder() const {
-    bool hotness[] = {
-      method_hotness.IsHot(),
-      method_hotness.IsStartup(),
-      method_hotness.IsPostStartup()
-    };
-
-
-    // Note: Bin-to-bin order does not matter. If the kernel does or does not read-ahead
-    // any memory, it only goes into the buffer cache and does not grow the PSS until the first
-    // time that memory is referenced in the process.
-
-    size_t hotness_bits = 0;
-    for (size_t i = 0; i < arraysize(hotness); ++i) {
-      if (hotness[i]) {
-        hotness_bits |= (1 << i);
-      }
-    }
-
     if (kIsDebugBuild) {
       // Check for bins that are always-empty given a real profile.
       if (method_hotness.IsHot() &&
@@ -1090,7 +1071,16 @@ struct OatWriter::OrderedMethodData {
       }
     }
 
-    return hotness_bits;
+    // The startup methods are packed together at the start of the code, so that startup touches
+    // as few pages as possible, and the methods which are not in the profile go at the end. Each
+    // page that is referenced grows the PSS, even if most of its code is cold.
+    if (method_hotness.IsStartup()) {
+      return method_hotness.IsHot() ? 0u : 1u;
+    }
+    if (method_hotness.IsPostStartup()) {
+      return method_hotness.IsHot() ? 2u : 3u;
+    }
+    return 4u;
   }
 };
 
@@ -1226,6 +1216,9 @@ class OatWriter::LayoutCodeMethodVisitor : public OatDexMethodVisitor {
       // Since most methods will have the same ordering criteria,
       // we preserve the original insertion order within the same sort order.
       std::stable_sort(ordered_methods_.begin(), ordered_methods_.end());
+      if (!kOatWriterForceOatCodeLayout) {
+        PlaceCalleesAfterCallers();
+      }
     } else {
       // The profile-less behavior is as if every method had 0 hotness
       // associated with it.
@@ -1239,6 +1232,54 @@ class OatWriter::LayoutCodeMethodVisitor : public OatDexMethodVisitor {
   }
 
  private:
+  // Move the methods right after the first caller that calls them directly, in the order of the
+  // calls, so that the code of a call chain shares pages and the relative calls stay short. The
+  // direct calls are those with a relative call patch. A callee is only moved within the
+  // hotness bin of its caller, so that the bins stay packed together.
+  void PlaceCalleesAfterCallers() {
+    SafeMap<MethodReference, size_t> method_indexes;
+    for (size_t i = 0, size = ordered_methods_.size(); i != size; ++i) {
+      method_indexes.FindOrAdd(ordered_methods_[i].method_reference, i);
+    }
+
+    OrderedMethodList placed_methods;
+    placed_methods.reserve(ordered_methods_.size());
+    std::vector<bool> placed(ordered_methods_.size(), false);
+    std::vector<size_t> worklist;
+    for (size_t i = 0, size = ordered_methods_.size(); i != size; ++i) {
+      if (placed[i]) {
+        continue;
+      }
+      placed[i] = true;
+      worklist.push_back(i);
+      while (!worklist.empty()) {
+        const OrderedMethodData& caller = ordered_methods_[worklist.back()];
+        worklist.pop_back();
+        placed_methods.push_back(caller);
+        // Push the callees in reverse, so that they are placed in the order of their calls.
+        ArrayRef<const LinkerPatch> patches = caller.compiled_method->GetPatches();
+        for (auto it = patches.rbegin(), end = patches.rend(); it != end; ++it) {
+          if (it->GetType() != LinkerPatch::Type::kCallRelative) {
+            continue;
+          }
+          auto callee_it = method_indexes.find(it->TargetMethod());
+          if (callee_it == method_indexes.end() || placed[callee_it->second]) {
+            continue;
+          }
+          const OrderedMethodData& callee = ordered_methods_[callee_it->second];
+          if (caller < callee || callee < caller) {
+            continue;  // Not in the same hotness bin.
+          }
+          placed[callee_it->second] = true;
+          worklist.push_back(callee_it->second);
+        }
+      }
+    }
+    DCHECK_EQ(placed_methods.size(), ordered_methods_.size());
+    DCHECK(std::is_sorted(placed_methods.begin(), placed_methods.end()));
+    ordered_methods_ = std::move(placed_methods);
+  }
+
   // List of compiled methods, later to be sorted by order defined in OrderedMethodData.
   // Methods can be inserted more than once in case of duplicated methods.
   OrderedMethodList ordered_methods_;
@@ -3605,8 +3646,14 @@ bool OatWriter::LayoutAndWriteDexFile(OutputStream* out, OatDexFile* oat_dex_fil
   const ArtDexFileLoader dex_file_loader;
   if (oat_dex_file->source_.IsZipEntry()) {
     ZipEntry* zip_entry = oat_dex_file->source_.GetZipEntry();
-    std::unique_ptr<MemMap> mem_map(
-        zip_entry->ExtractToMemMap(location.c_str(), "classes.dex", &error_msg));
+    std::unique_ptr<MemMap> mem_map;
+    if (zip_entry->IsUncompressed() && zip_entry->IsAlignedToDexHeader()) {
+      // Map stored entries as file-backed instead of copying them to anonymous memory.
+      mem_map.reset(zip_entry->MapDirectlyFromFile(location.c_str(), &error_msg));
+    }
+    if (mem_map == nullptr) {
+      mem_map.reset(zip_entry->ExtractToMemMap(location.c_str(), "classes.dex", &error_msg));
+    }
     if (mem_map == nullptr) {
       LOG(ERROR) << "Failed to extract dex file to mem map for layout: " << error_msg;
       return false;
@@ -3656,6 +3703,7 @@ bool OatWriter::LayoutAndWriteDexFile(OutputStream* out, OatDexFile* oat_dex_fil
   Options options;
   options.compact_dex_level_ = compact_dex_level_;
   options.update_checksum_ = true;
+  options.dedupe_code_items_across_dex_files_ = dedupe_code_items_across_dex_files_;
   DexLayout dex_layout(options, profile_compilation_info_, /*file*/ nullptr, /*header*/ nullptr);
   const uint8_t* dex_src = nullptr;
   if (dex_layout.ProcessDexFile(location.c_str(), dex_file.get(), 0, &dex_container_, &error_msg)) {
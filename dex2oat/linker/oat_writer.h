@@ -121,7 +121,8 @@ class OatWriter {
   OatWriter(bool compiling_boot_image,
             TimingLogger* timings,
             ProfileCompilationInfo* info,
-            CompactDexLevel compact_dex_level);
+            CompactDexLevel compact_dex_level,
+            bool dedupe_code_items_across_dex_files);
 
   // To produce a valid oat file, the user must first add sources with any combination of
   //   - AddDexFileSource(),
@@ -525,6 +526,9 @@ class OatWriter {
   // Compact dex level that is generated.
   CompactDexLevel compact_dex_level_;
 
+  // Whether the compact dex files share their identical code items in the shared data section.
+  const bool dedupe_code_items_across_dex_files_;
+
   using OrderedMethodList = std::vector<OrderedMethodData>;
 
   // List of compiled methods, sorted by the order defined in OrderedMethodData.
@@ -126,7 +126,8 @@ class OatTest : public CommonCompilerTest {
     OatWriter oat_writer(/*compiling_boot_image*/false,
                          &timings,
                          /*profile_compilation_info*/nullptr,
-                         CompactDexLevel::kCompactDexLevelNone);
+                         CompactDexLevel::kCompactDexLevelNone,
+                         /*dedupe_code_items_across_dex_files*/true);
     for (const DexFile* dex_file : dex_files) {
       ArrayRef<const uint8_t> raw_dex_file(
           reinterpret_cast<const uint8_t*>(&dex_file->GetHeader()),
@@ -150,7 +151,8 @@ class OatTest : public CommonCompilerTest {
     OatWriter oat_writer(/*compiling_boot_image*/false,
                          &timings,
                          profile_compilation_info,
-                         CompactDexLevel::kCompactDexLevelNone);
+                         CompactDexLevel::kCompactDexLevelNone,
+                         /*dedupe_code_items_across_dex_files*/true);
     for (const char* dex_filename : dex_filenames) {
       if (!oat_writer.AddDexFileSource(dex_filename, dex_filename)) {
         return false;
@@ -169,7 +171,8 @@ class OatTest : public CommonCompilerTest {
     OatWriter oat_writer(/*compiling_boot_image*/false,
                          &timings,
                          /*profile_compilation_info*/nullptr,
-                         CompactDexLevel::kCompactDexLevelNone);
+                         CompactDexLevel::kCompactDexLevelNone,
+                         /*dedupe_code_items_across_dex_files*/true);
     if (!oat_writer.AddZippedDexFilesSource(std::move(zip_fd), location)) {
       return false;
     }
@@ -34,15 +34,23 @@
 
 #include "dexdump.h"
 
+#include <fcntl.h>
 #include <inttypes.h>
 #include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <sstream>
+#include <thread>
 #include <vector>
 
-#include "android-base/file.h"
 #include "android-base/logging.h"
+#include "android-base/scopeguard.h"
 #include "android-base/stringprintf.h"
 
 #include "dex/code_item_accessors-inl.h"
@@ -61,9 +69,10 @@ namespace art {
 struct Options gOptions;
 
 /*
- * Output file. Defaults to stdout.
+ * Output file. Defaults to stdout. The threads decoding classes in parallel write to their own
+ * memory streams.
  */
-FILE* gOutFile = stdout;
+thread_local FILE* gOutFile = stdout;
 
 /*
  * Data types that match the definitions in the VM specification.
@@ -1821,6 +1830,65 @@ static void dumpCallSite(const DexFile* pDexFile, u4 idx) {
   }
 }
 
+/*
+ * Runs work(0) to work(count - 1) on up to numThreads threads, including the calling one.
+ */
+static void parallelFor(u4 count, u4 numThreads, const std::function<void(u4)>& work) {
+  numThreads = std::max<u4>(std::min(numThreads, count), 1u);
+  std::atomic<u4> nextIndex(0u);
+  auto run = [&]() {
+    for (u4 i = nextIndex.fetch_add(1u, std::memory_order_relaxed);
+         i < count;
+         i = nextIndex.fetch_add(1u, std::memory_order_relaxed)) {
+      work(i);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (u4 i = 1; i != numThreads; ++i) {
+    threads.emplace_back(run);
+  }
+  run();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+/*
+ * Number of classes decoded in parallel before their output is written, which bounds the memory
+ * holding it.
+ */
+static const u4 kClassesPerBatch = 256;
+
+/*
+ * Dumps all classes of the dex file, decoding them in parallel in batches and writing their
+ * output in order. Only for the plain output, as the XML one groups classes by package.
+ */
+static void dumpClassesInParallel(const DexFile* pDexFile) {
+  const u4 classDefsSize = pDexFile->GetHeader().class_defs_size_;
+  std::vector<char*> outputs(kClassesPerBatch);
+  std::vector<size_t> outputSizes(kClassesPerBatch);
+  for (u4 start = 0; start < classDefsSize; start += kClassesPerBatch) {
+    const u4 count = std::min(kClassesPerBatch, classDefsSize - start);
+    parallelFor(count, gOptions.numThreads, [&](u4 i) {
+      FILE* outFile = gOutFile;
+      outputs[i] = nullptr;
+      outputSizes[i] = 0u;
+      gOutFile = open_memstream(&outputs[i], &outputSizes[i]);
+      if (gOutFile == nullptr) {
+        PLOG(FATAL) << "Can't open memory stream";
+      }
+      char* package = nullptr;
+      dumpClass(pDexFile, start + i, &package);
+      fclose(gOutFile);
+      gOutFile = outFile;
+    });
+    for (u4 i = 0; i < count; i++) {
+      fwrite(outputs[i], 1, outputSizes[i], gOutFile);
+      free(outputs[i]);
+    }  // for
+  }  // for
+}
+
 /*
  * Dumps the requested sections of the file.
  */
@@ -1848,9 +1916,13 @@ static void processDexFile(const char* fileName,
   // Iterate over all classes.
   char* package = nullptr;
   const u4 classDefsSize = pDexFile->GetHeader().class_defs_size_;
-  for (u4 i = 0; i < classDefsSize; i++) {
-    dumpClass(pDexFile, i, &package);
-  }  // for
+  if (gOptions.numThreads > 1 && gOptions.outputFormat == OUTPUT_PLAIN) {
+    dumpClassesInParallel(pDexFile);
+  } else {
+    for (u4 i = 0; i < classDefsSize; i++) {
+      dumpClass(pDexFile, i, &package);
+    }  // for
+  }
 
   // Iterate over all method handles.
   for (u4 i = 0; i < pDexFile->NumMethodHandles(); ++i) {
@@ -1884,19 +1956,33 @@ int processFile(const char* fileName) {
 
   const bool kVerifyChecksum = !gOptions.ignoreBadChecksum;
   const bool kVerify = !gOptions.disableVerifier;
-  std::string content;
-  // If the file is not a .dex file, the function tries .zip/.jar/.apk files,
-  // all of which are Zip archives with "classes.dex" inside.
-  // TODO: add an api to android::base to read a std::vector<uint8_t>.
-  if (!android::base::ReadFileToString(fileName, &content)) {
-    LOG(ERROR) << "ReadFileToString failed";
+  // Map the file rather than read it, so that the dex files stored uncompressed in
+  // .zip/.jar/.apk files are used in place, and only the pages dumped are loaded.
+  const int fd = open(fileName, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    PLOG(ERROR) << "Can't open " << fileName;
+    return -1;
+  }
+  auto closeFd = android::base::make_scope_guard([fd]() { close(fd); });
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(u4))) {
+    LOG(ERROR) << "Can't read " << fileName;
     return -1;
   }
+  const size_t size = static_cast<size_t>(st.st_size);
+  void* content = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (content == MAP_FAILED) {
+    PLOG(ERROR) << "Can't map " << fileName;
+    return -1;
+  }
+  auto unmap = android::base::make_scope_guard([content, size]() { munmap(content, size); });
+  // If the file is not a .dex file, the function tries .zip/.jar/.apk files,
+  // all of which are Zip archives with "classes.dex" inside.
   const DexFileLoader dex_file_loader;
   std::string error_msg;
   std::vector<std::unique_ptr<const DexFile>> dex_files;
-  if (!dex_file_loader.OpenAll(reinterpret_cast<const uint8_t*>(content.data()),
-                               content.size(),
+  if (!dex_file_loader.OpenAll(reinterpret_cast<const uint8_t*>(content),
+                               size,
                                fileName,
                                kVerify,
                                kVerifyChecksum,
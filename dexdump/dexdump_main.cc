@@ -25,6 +25,7 @@
 #include "dexdump.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -40,7 +41,7 @@ static const char* gProgName = "dexdump";
 static void usage(void) {
   LOG(ERROR) << "Copyright (C) 2007 The Android Open Source Project\n";
   LOG(ERROR) << gProgName << ": [-a] [-c] [-d] [-e] [-f] [-h] [-i] [-j] [-l layout] [-o outfile]"
-                  " dexfile...\n";
+                  " [-t threads] dexfile...\n";
   LOG(ERROR) << " -a : display annotations";
   LOG(ERROR) << " -c : verify checksum and exit";
   LOG(ERROR) << " -d : disassemble code sections";
@@ -52,6 +53,7 @@ static void usage(void) {
   LOG(ERROR) << " -j : disable dex file verification";
   LOG(ERROR) << " -l : output layout, either 'plain' or 'xml'";
   LOG(ERROR) << " -o : output file name (defaults to stdout)";
+  LOG(ERROR) << " -t : number of threads decoding the classes of the plain layout (defaults to 1)";
 }
 
 /*
@@ -65,7 +67,7 @@ int dexdumpDriver(int argc, char** argv) {
 
   // Parse all arguments.
   while (1) {
-    const int ic = getopt(argc, argv, "acdefghijl:o:");
+    const int ic = getopt(argc, argv, "acdefghijl:o:t:");
     if (ic < 0) {
       break;  // done
     }
@@ -110,6 +112,13 @@ int dexdumpDriver(int argc, char** argv) {
       case 'o':  // output file
         gOptions.outputFileName = optarg;
         break;
+      case 't':  // number of threads
+        if (atoi(optarg) > 0) {
+          gOptions.numThreads = atoi(optarg);
+        } else {
+          wantUsage = true;
+        }
+        break;
       default:
         wantUsage = true;
         break;
@@ -21,6 +21,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "android-base/file.h"
+
 #include "arch/instruction_set.h"
 #include "base/os.h"
 #include "base/utils.h"
@@ -72,6 +74,23 @@ TEST_F(DexDumpTest, FullPlainOutput) {
     dex_file_}, &error_msg)) << error_msg;
 }
 
+TEST_F(DexDumpTest, ParallelPlainOutput) {
+  std::string error_msg;
+  ScratchFile serial_output;
+  ScratchFile parallel_output;
+  ASSERT_TRUE(Exec({"-d", "-l", "plain", "-o", serial_output.GetFilename(),
+    dex_file_}, &error_msg)) << error_msg;
+  ASSERT_TRUE(Exec({"-d", "-l", "plain", "-t", "4", "-o", parallel_output.GetFilename(),
+    dex_file_}, &error_msg)) << error_msg;
+  std::string serial_content;
+  std::string parallel_content;
+  ASSERT_TRUE(android::base::ReadFileToString(serial_output.GetFilename(), &serial_content));
+  ASSERT_TRUE(android::base::ReadFileToString(parallel_output.GetFilename(), &parallel_content));
+  // The classes are decoded in parallel, but dumped in order.
+  EXPECT_FALSE(serial_content.empty());
+  EXPECT_TRUE(serial_content == parallel_content);
+}
+
 TEST_F(DexDumpTest, XMLOutput) {
   std::string error_msg;
   ASSERT_TRUE(Exec({"-l", "xml", "-o", "/dev/null",
@@ -529,7 +529,9 @@ bool CompactDexWriter::Write(DexContainer* output, std::string* error_msg)  {
   // Clear the dedupe to prevent interdex code item deduping. This does not currently work well with
   // dex2oat's class unloading. The issue is that verification encounters quickened opcodes after
   // the first dex gets unloaded.
-  code_item_dedupe_->Clear();
+  if (!dex_layout_->GetOptions().dedupe_code_items_across_dex_files_) {
+    code_item_dedupe_->Clear();
+  }
 
   return true;
 }
@@ -26,7 +26,9 @@
 #include <stdio.h>
 #include <sys/mman.h>  // For the PROT_* and MAP_* constants.
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <vector>
@@ -1611,22 +1613,30 @@ void DexLayout::LayoutClassDefsAndClassData(const DexFile* dex_file) {
 void DexLayout::LayoutStringData(const DexFile* dex_file) {
   const size_t num_strings = header_->GetCollections().StringIds().size();
   std::vector<bool> is_shorty(num_strings, false);
-  std::vector<bool> from_hot_method(num_strings, false);
+  // The index of the first class referencing each string from its hot methods, so that the strings
+  // used together by a class are laid out together.
+  static constexpr uint32_t kNotHot = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> first_hot_class(num_strings, kNotHot);
+  uint32_t class_index = 0u;
+  auto mark_hot = [&](const dex_ir::StringId* id) {
+    first_hot_class[id->GetIndex()] = std::min(first_hot_class[id->GetIndex()], class_index);
+  };
   for (std::unique_ptr<dex_ir::ClassDef>& class_def : header_->GetCollections().ClassDefs()) {
+    ++class_index;
     // A name of a profile class is probably going to get looked up by ClassTable::Lookup, mark it
     // as hot. Add its super class and interfaces as well, which can be used during initialization.
     const bool is_profile_class =
         info_->ContainsClass(*dex_file, dex::TypeIndex(class_def->ClassType()->GetIndex()));
     if (is_profile_class) {
-      from_hot_method[class_def->ClassType()->GetStringId()->GetIndex()] = true;
+      mark_hot(class_def->ClassType()->GetStringId());
       const dex_ir::TypeId* superclass = class_def->Superclass();
       if (superclass != nullptr) {
-        from_hot_method[superclass->GetStringId()->GetIndex()] = true;
+        mark_hot(superclass->GetStringId());
       }
       const dex_ir::TypeList* interfaces = class_def->Interfaces();
       if (interfaces != nullptr) {
         for (const dex_ir::TypeId* interface_type : *interfaces->GetTypeList()) {
-          from_hot_method[interface_type->GetStringId()->GetIndex()] = true;
+          mark_hot(interface_type->GetStringId());
         }
       }
     }
@@ -1656,20 +1666,20 @@ void DexLayout::LayoutStringData(const DexFile* dex_file) {
         }
         // Add const-strings.
         for (dex_ir::StringId* id : fixups->StringIds()) {
-          from_hot_method[id->GetIndex()] = true;
+          mark_hot(id);
         }
         // Add field classes, names, and types.
         for (dex_ir::FieldId* id : fixups->FieldIds()) {
           // TODO: Only visit field ids from static getters and setters.
-          from_hot_method[id->Class()->GetStringId()->GetIndex()] = true;
-          from_hot_method[id->Name()->GetIndex()] = true;
-          from_hot_method[id->Type()->GetStringId()->GetIndex()] = true;
+          mark_hot(id->Class()->GetStringId());
+          mark_hot(id->Name());
+          mark_hot(id->Type()->GetStringId());
         }
         // For clinits, add referenced method classes, names, and protos.
         if (is_clinit) {
           for (dex_ir::MethodId* id : fixups->MethodIds()) {
-            from_hot_method[id->Class()->GetStringId()->GetIndex()] = true;
-            from_hot_method[id->Name()->GetIndex()] = true;
+            mark_hot(id->Class()->GetStringId());
+            mark_hot(id->Name());
             is_shorty[id->Proto()->Shorty()->GetIndex()] = true;
           }
         }
@@ -1683,13 +1693,19 @@ void DexLayout::LayoutStringData(const DexFile* dex_file) {
   }
   std::sort(string_ids.begin(),
             string_ids.end(),
-            [&is_shorty, &from_hot_method](const dex_ir::StringId* a,
+            [&is_shorty, &first_hot_class](const dex_ir::StringId* a,
                                            const dex_ir::StringId* b) {
-    const bool a_is_hot = from_hot_method[a->GetIndex()];
-    const bool b_is_hot = from_hot_method[b->GetIndex()];
+    const uint32_t a_hot_class = first_hot_class[a->GetIndex()];
+    const uint32_t b_hot_class = first_hot_class[b->GetIndex()];
+    const bool a_is_hot = a_hot_class != kNotHot;
+    const bool b_is_hot = b_hot_class != kNotHot;
     if (a_is_hot != b_is_hot) {
       return a_is_hot < b_is_hot;
     }
+    // Group the hot strings by the first class using them.
+    if (a_hot_class != b_hot_class) {
+      return a_hot_class < b_hot_class;
+    }
     // After hot methods are partitioned, subpartition shorties.
     const bool a_is_shorty = is_shorty[a->GetIndex()];
     const bool b_is_shorty = is_shorty[b->GetIndex()];
@@ -1778,6 +1794,22 @@ void DexLayout::LayoutCodeItems(const DexFile* dex_file) {
     }
   }
 
+  // Cluster the code items of each category by class, in the new order of the class data. The
+  // methods of a class executed together then share pages.
+  std::unordered_map<dex_ir::CodeItem*, size_t> code_item_class_order;
+  size_t class_order = 0u;
+  for (const std::unique_ptr<dex_ir::ClassData>& class_data :
+       header_->GetCollections().ClassDatas()) {
+    for (size_t i = 0; i < 2; ++i) {
+      for (auto& method : *(i == 0 ? class_data->DirectMethods() : class_data->VirtualMethods())) {
+        if (method->GetCodeItem() != nullptr) {
+          code_item_class_order.emplace(method->GetCodeItem(), class_order);
+        }
+      }
+    }
+    ++class_order;
+  }
+
   dex_ir::CollectionVector<dex_ir::CodeItem>::Vector& code_items =
         header_->GetCollections().CodeItems();
   if (VLOG_IS_ON(dex)) {
@@ -1804,7 +1836,17 @@ void DexLayout::LayoutCodeItems(const DexFile* dex_file) {
     DCHECK(it_b != code_item_layout.end());
     const LayoutType layout_type_a = it_a->second;
     const LayoutType layout_type_b = it_b->second;
-    return layout_type_a < layout_type_b;
+    if (layout_type_a != layout_type_b) {
+      return layout_type_a < layout_type_b;
+    }
+    // Code items without a method, if any, keep their place after the clustered ones.
+    auto order_a = code_item_class_order.find(a.get());
+    auto order_b = code_item_class_order.find(b.get());
+    const size_t class_order_a =
+        (order_a != code_item_class_order.end()) ? order_a->second : class_order;
+    const size_t class_order_b =
+        (order_b != code_item_class_order.end()) ? order_b->second : class_order;
+    return class_order_a < class_order_b;
   });
 }
 
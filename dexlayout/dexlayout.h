@@ -66,6 +66,9 @@ class Options {
   bool update_checksum_ = false;
   CompactDexLevel compact_dex_level_ = CompactDexLevel::kCompactDexLevelNone;
   bool dedupe_code_items_ = true;
+  // Whether the code items of a dex file may be deduplicated against the code items of the dex
+  // files written before to the same container.
+  bool dedupe_code_items_across_dex_files_ = false;
   OutputFormat output_format_ = kOutputPlain;
   const char* output_dex_directory_ = nullptr;
   const char* output_file_name_ = nullptr;
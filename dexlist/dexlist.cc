@@ -23,12 +23,16 @@
  * List all methods in all concrete classes in one or more DEX files.
  */
 
+#include <fcntl.h>
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-#include <android-base/file.h>
 #include <android-base/logging.h>
+#include <android-base/scopeguard.h>
 
 #include "dex/code_item_accessors-inl.h"
 #include "dex/dex_file-inl.h"
@@ -173,17 +177,31 @@ static int processFile(const char* fileName) {
   // If the file is not a .dex file, the function tries .zip/.jar/.apk files,
   // all of which are Zip archives with "classes.dex" inside.
   static constexpr bool kVerifyChecksum = true;
-  std::string content;
-  // TODO: add an api to android::base to read a std::vector<uint8_t>.
-  if (!android::base::ReadFileToString(fileName, &content)) {
-    LOG(ERROR) << "ReadFileToString failed";
+  // Map the file rather than read it, so that the dex files stored uncompressed are used in
+  // place, and only the pages listed are loaded.
+  const int fd = open(fileName, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    PLOG(ERROR) << "Can't open " << fileName;
     return -1;
   }
+  auto closeFd = android::base::make_scope_guard([fd]() { close(fd); });
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(u4))) {
+    LOG(ERROR) << "Can't read " << fileName;
+    return -1;
+  }
+  const size_t size = static_cast<size_t>(st.st_size);
+  void* content = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (content == MAP_FAILED) {
+    PLOG(ERROR) << "Can't map " << fileName;
+    return -1;
+  }
+  auto unmap = android::base::make_scope_guard([content, size]() { munmap(content, size); });
   std::vector<std::unique_ptr<const DexFile>> dex_files;
   std::string error_msg;
   const DexFileLoader dex_file_loader;
-  if (!dex_file_loader.OpenAll(reinterpret_cast<const uint8_t*>(content.data()),
-                               content.size(),
+  if (!dex_file_loader.OpenAll(reinterpret_cast<const uint8_t*>(content),
+                               size,
                                fileName,
                                /*verify*/ true,
                                kVerifyChecksum,
@@ -1275,98 +1275,100 @@ class ImgDiagDumper {
     return DumpImageDiffMap();
   }
 
-  bool ComputeDirtyBytes(const uint8_t* image_begin, MappingData* mapping_data /*out*/) {
+  bool ComputeDirtyBytes(MappingData* mapping_data /*out*/) {
     std::ostream& os = *os_;
 
-    size_t virtual_page_idx = 0;   // Virtual page number (for an absolute memory address)
-    size_t page_idx = 0;           // Page index relative to 0
-    size_t previous_page_idx = 0;  // Previous page index relative to 0
-
+    // We treat the image header as part of the memory map for now
+    // If we wanted to change this, we could pass base=start+sizeof(ImageHeader)
+    // But it might still be interesting to see if any of the ImageHeader data mutated
+    const uint8_t* local_begin = reinterpret_cast<const uint8_t*>(&image_header_);
+
+    // Read the page frame numbers of the whole mapping up front, one pread per pagemap file
+    // rather than two per page. Boot map begin/end already implicitly aligned.
+    size_t remote_virtual_page_begin = boot_map_.start / kPageSize;
+    size_t num_pages = (boot_map_.end - boot_map_.start) / kPageSize;
+    size_t local_virtual_page_begin = reinterpret_cast<uintptr_t>(local_begin) / kPageSize;
+    size_t local_virtual_page_end =
+        (reinterpret_cast<uintptr_t>(local_begin) + (boot_map_.end - boot_map_.start) - 1u) /
+        kPageSize + 1u;
+    std::vector<uint64_t> page_frame_numbers;
+    std::vector<uint64_t> clean_page_frame_numbers;
+    std::string error_msg;
+    if (!GetPageFrameNumbers(&pagemap_file_,  // Image-diff-pid procmap
+                             remote_virtual_page_begin,
+                             num_pages,
+                             &page_frame_numbers,
+                             &error_msg) ||
+        !GetPageFrameNumbers(&clean_pagemap_file_,  // Self procmap
+                             local_virtual_page_begin,
+                             local_virtual_page_end - local_virtual_page_begin,
+                             &clean_page_frame_numbers,
+                             &error_msg)) {
+      os << error_msg;
+      return false;
+    }
 
-    // Iterate through one page at a time. Boot map begin/end already implicitly aligned.
-    for (uintptr_t begin = boot_map_.start; begin != boot_map_.end; begin += kPageSize) {
-      ptrdiff_t offset = begin - boot_map_.start;
+    std::vector<size_t> private_dirty_pages_for_section(ImageHeader::kSectionCount, 0u);
 
-      // We treat the image header as part of the memory map for now
-      // If we wanted to change this, we could pass base=start+sizeof(ImageHeader)
-      // But it might still be interesting to see if any of the ImageHeader data mutated
-      const uint8_t* local_ptr = reinterpret_cast<const uint8_t*>(&image_header_) + offset;
+    // Iterate through one page at a time, and only look at the bytes of pages that differ.
+    for (size_t page = 0; page != num_pages; ++page) {
+      ptrdiff_t offset = page * kPageSize;
+      const uint8_t* local_ptr = local_begin + offset;
       uint8_t* remote_ptr = &remote_contents_[offset];
 
       if (memcmp(local_ptr, remote_ptr, kPageSize) != 0) {
         mapping_data->different_pages++;
 
-        // Count the number of 32-bit integers that are different.
+        // Count the number of 32-bit integers and bytes that are different.
+        const uint32_t* remote_ptr_int32 = reinterpret_cast<const uint32_t*>(remote_ptr);
+        const uint32_t* local_ptr_int32 = reinterpret_cast<const uint32_t*>(local_ptr);
         for (size_t i = 0; i < kPageSize / sizeof(uint32_t); ++i) {
-          uint32_t* remote_ptr_int32 = reinterpret_cast<uint32_t*>(remote_ptr);
-          const uint32_t* local_ptr_int32 = reinterpret_cast<const uint32_t*>(local_ptr);
-
           if (remote_ptr_int32[i] != local_ptr_int32[i]) {
             mapping_data->different_int32s++;
+            for (size_t j = i * sizeof(uint32_t); j != (i + 1u) * sizeof(uint32_t); ++j) {
+              if (local_ptr[j] != remote_ptr[j]) {
+                // Track number of bytes that are different
+                mapping_data->different_bytes++;
+              }
+            }
           }
         }
       }
-    }
-
-    std::vector<size_t> private_dirty_pages_for_section(ImageHeader::kSectionCount, 0u);
-
-    // Iterate through one byte at a time.
-    ptrdiff_t page_off_begin = image_header_.GetImageBegin() - image_begin;
-    for (uintptr_t begin = boot_map_.start; begin != boot_map_.end; ++begin) {
-      previous_page_idx = page_idx;
-      ptrdiff_t offset = begin - boot_map_.start;
-
-      // We treat the image header as part of the memory map for now
-      // If we wanted to change this, we could pass base=start+sizeof(ImageHeader)
-      // But it might still be interesting to see if any of the ImageHeader data mutated
-      const uint8_t* local_ptr = reinterpret_cast<const uint8_t*>(&image_header_) + offset;
-      uint8_t* remote_ptr = &remote_contents_[offset];
-
-      virtual_page_idx = reinterpret_cast<uintptr_t>(local_ptr) / kPageSize;
-
-      // Calculate the page index, relative to the 0th page where the image begins
-      page_idx = (offset + page_off_begin) / kPageSize;
-      if (*local_ptr != *remote_ptr) {
-        // Track number of bytes that are different
-        mapping_data->different_bytes++;
-      }
 
       // Independently count the # of dirty pages on the remote side
-      size_t remote_virtual_page_idx = begin / kPageSize;
-      if (previous_page_idx != page_idx) {
-        uint64_t page_count = 0xC0FFEE;
-        // TODO: virtual_page_idx needs to be from the same process
-        std::string error_msg;
-        int dirtiness = (IsPageDirty(&pagemap_file_,           // Image-diff-pid procmap
-                                     &clean_pagemap_file_,     // Self procmap
-                                     &kpageflags_file_,
-                                     &kpagecount_file_,
-                                     remote_virtual_page_idx,  // potentially "dirty" page
-                                     virtual_page_idx,         // true "clean" page
-                                     &page_count,
-                                     &error_msg));
-        if (dirtiness < 0) {
-          os << error_msg;
-          return false;
-        } else if (dirtiness > 0) {
-          mapping_data->dirty_pages++;
-          mapping_data->dirty_page_set.insert(mapping_data->dirty_page_set.end(), virtual_page_idx);
-        }
+      size_t virtual_page_idx = reinterpret_cast<uintptr_t>(local_ptr) / kPageSize;
+      uint64_t page_count = 0xC0FFEE;
+      // TODO: virtual_page_idx needs to be from the same process
+      int dirtiness = (IsPageDirty(&kpageflags_file_,
+                                   &kpagecount_file_,
+                                   // potentially "dirty" page
+                                   page_frame_numbers[page],
+                                   // true "clean" page
+                                   clean_page_frame_numbers[virtual_page_idx -
+                                                            local_virtual_page_begin],
+                                   &page_count,
+                                   &error_msg));
+      if (dirtiness < 0) {
+        os << error_msg;
+        return false;
+      } else if (dirtiness > 0) {
+        mapping_data->dirty_pages++;
+        mapping_data->dirty_page_set.insert(mapping_data->dirty_page_set.end(), virtual_page_idx);
+      }
 
-        bool is_dirty = dirtiness > 0;
-        bool is_private = page_count == 1;
+      bool is_dirty = dirtiness > 0;
+      bool is_private = page_count == 1;
 
-        if (page_count == 1) {
-          mapping_data->private_pages++;
-        }
+      if (page_count == 1) {
+        mapping_data->private_pages++;
+      }
 
-        if (is_dirty && is_private) {
-          mapping_data->private_dirty_pages++;
-          for (size_t i = 0; i < ImageHeader::kSectionCount; ++i) {
-            const ImageHeader::ImageSections section = static_cast<ImageHeader::ImageSections>(i);
-            if (image_header_.GetImageSection(section).Contains(offset)) {
-              ++private_dirty_pages_for_section[i];
-            }
+      if (is_dirty && is_private) {
+        mapping_data->private_dirty_pages++;
+        for (size_t i = 0; i < ImageHeader::kSectionCount; ++i) {
+          const ImageHeader::ImageSections section = static_cast<ImageHeader::ImageSections>(i);
+          if (image_header_.GetImageSection(section).Contains(offset)) {
+            ++private_dirty_pages_for_section[i];
           }
         }
       }
@@ -1430,7 +1432,7 @@ class ImgDiagDumper {
 
     os << "Mapping at [" << reinterpret_cast<void*>(boot_map_.start) << ", "
        << reinterpret_cast<void*>(boot_map_.end) << ") had:\n  ";
-    if (!ComputeDirtyBytes(image_begin, &mapping_data)) {
+    if (!ComputeDirtyBytes(&mapping_data)) {
       return false;
     }
     RemoteProcesses remotes;
@@ -1466,51 +1468,43 @@ class ImgDiagDumper {
     return true;
   }
 
-  static bool GetPageFrameNumber(File* page_map_file,
-                                size_t virtual_page_index,
-                                uint64_t* page_frame_number,
-                                std::string* error_msg) {
+  // Reads the physical page frame numbers of `num_pages` pages starting at `virtual_page_index`.
+  static bool GetPageFrameNumbers(File* page_map_file,
+                                  size_t virtual_page_index,
+                                  size_t num_pages,
+                                  std::vector<uint64_t>* page_frame_numbers,
+                                  std::string* error_msg) {
     CHECK(page_map_file != nullptr);
-    CHECK(page_frame_number != nullptr);
+    CHECK(page_frame_numbers != nullptr);
     CHECK(error_msg != nullptr);
 
     constexpr size_t kPageMapEntrySize = sizeof(uint64_t);
     constexpr uint64_t kPageFrameNumberMask = (1ULL << 55) - 1;  // bits 0-54 [in /proc/$pid/pagemap]
-    constexpr uint64_t kPageSoftDirtyMask = (1ULL << 55);  // bit 55 [in /proc/$pid/pagemap]
 
-    uint64_t page_map_entry = 0;
+    page_frame_numbers->resize(num_pages);
 
-    // Read 64-bit entry from /proc/$pid/pagemap to get the physical page frame number
-    if (!page_map_file->PreadFully(&page_map_entry, kPageMapEntrySize,
-                                  virtual_page_index * kPageMapEntrySize)) {
-      *error_msg = StringPrintf("Failed to read the virtual page index entry from %s",
+    // Read 64-bit entries from /proc/$pid/pagemap to get the physical page frame numbers
+    if (!page_map_file->PreadFully(page_frame_numbers->data(),
+                                   num_pages * kPageMapEntrySize,
+                                   virtual_page_index * kPageMapEntrySize)) {
+      *error_msg = StringPrintf("Failed to read the virtual page index entries from %s",
                                 page_map_file->GetPath().c_str());
       return false;
     }
 
-    // TODO: seems useless, remove this.
-    bool soft_dirty = (page_map_entry & kPageSoftDirtyMask) != 0;
-    if ((false)) {
-      LOG(VERBOSE) << soft_dirty;  // Suppress unused warning
-      UNREACHABLE();
+    for (uint64_t& page_frame_number : *page_frame_numbers) {
+      page_frame_number &= kPageFrameNumberMask;
     }
 
-    *page_frame_number = page_map_entry & kPageFrameNumberMask;
-
     return true;
   }
 
-  static int IsPageDirty(File* page_map_file,
-                         File* clean_pagemap_file,
-                         File* kpageflags_file,
+  static int IsPageDirty(File* kpageflags_file,
                          File* kpagecount_file,
-                         size_t virtual_page_idx,
-                         size_t clean_virtual_page_idx,
+                         uint64_t page_frame_number,
+                         uint64_t page_frame_number_clean,
                          // Out parameters:
                          uint64_t* page_count, std::string* error_msg) {
-    CHECK(page_map_file != nullptr);
-    CHECK(clean_pagemap_file != nullptr);
-    CHECK_NE(page_map_file, clean_pagemap_file);
     CHECK(kpageflags_file != nullptr);
     CHECK(kpagecount_file != nullptr);
     CHECK(page_count != nullptr);
@@ -1524,17 +1518,6 @@ class ImgDiagDumper {
     constexpr uint64_t kPageFlagsNoPageMask = (1ULL << 20);  // in /proc/kpageflags
     constexpr uint64_t kPageFlagsMmapMask = (1ULL << 11);  // in /proc/kpageflags
 
-    uint64_t page_frame_number = 0;
-    if (!GetPageFrameNumber(page_map_file, virtual_page_idx, &page_frame_number, error_msg)) {
-      return -1;
-    }
-
-    uint64_t page_frame_number_clean = 0;
-    if (!GetPageFrameNumber(clean_pagemap_file, clean_virtual_page_idx, &page_frame_number_clean,
-                            error_msg)) {
-      return -1;
-    }
-
     // Read 64-bit entry from /proc/kpageflags to get the dirty bit for a page
     uint64_t kpage_flags_entry = 0;
     if (!kpageflags_file->PreadFully(&kpage_flags_entry,
@@ -16,6 +16,7 @@
 
 #include "hash_set.h"
 
+#include <chrono>
 #include <forward_list>
 #include <map>
 #include <sstream>
@@ -25,6 +26,7 @@
 
 #include <gtest/gtest.h>
 #include "hash_map.h"
+#include "swiss_hash_set.h"
 
 namespace art {
 
@@ -354,4 +356,160 @@ TEST_F(HashSetTest, TestReserve) {
   CHECK_GE(hash_set.ElementsUntilExpand(), size);
 }
 
+TEST_F(HashSetTest, TestSwissIterator) {
+  SwissHashSet<std::string, IsEmptyFnString> hash_set;
+  ASSERT_TRUE(hash_set.begin() == hash_set.end());
+  static constexpr size_t count = 1000;
+  std::vector<std::string> strings;
+  for (size_t i = 0; i < count; ++i) {
+    strings.push_back(RandomString(10));
+    hash_set.Insert(strings[i]);
+  }
+  ASSERT_EQ(hash_set.Verify(), 0U);
+  // Make sure we visit each string exactly once.
+  std::map<std::string, size_t> found_count;
+  for (const std::string& s : hash_set) {
+    ++found_count[s];
+  }
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_EQ(found_count[strings[i]], 1U);
+  }
+  found_count.clear();
+  // Remove all the elements with iterator erase.
+  for (auto it = hash_set.begin(); it != hash_set.end();) {
+    ++found_count[*it];
+    it = hash_set.Erase(it);
+    ASSERT_EQ(hash_set.Verify(), 0U);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_EQ(found_count[strings[i]], 1U);
+  }
+}
+
+TEST_F(HashSetTest, TestSwissStress) {
+  SwissHashSet<std::string, IsEmptyFnString> hash_set;
+  std::unordered_multiset<std::string> std_set;
+  std::vector<std::string> strings;
+  static constexpr size_t string_count = 2000;
+  static constexpr size_t operations = 100000;
+  static constexpr size_t target_size = 5000;
+  for (size_t i = 0; i < string_count; ++i) {
+    strings.push_back(RandomString(i % 10 + 1));
+  }
+  const size_t seed = time(nullptr);
+  SetSeed(seed);
+  LOG(INFO) << "Starting stress test with seed " << seed;
+  for (size_t i = 0; i < operations; ++i) {
+    ASSERT_EQ(hash_set.Size(), std_set.size());
+    size_t delta = std::abs(static_cast<ssize_t>(target_size) -
+                            static_cast<ssize_t>(hash_set.Size()));
+    size_t n = PRand();
+    if (n % target_size == 0) {
+      hash_set.Clear();
+      std_set.clear();
+      ASSERT_TRUE(hash_set.Empty());
+    } else  if (n % target_size < delta) {
+      // Skew towards adding elements until we are at the desired size.
+      const std::string& s = strings[PRand() % string_count];
+      hash_set.Insert(s);
+      std_set.insert(s);
+      ASSERT_EQ(*hash_set.Find(s), *std_set.find(s));
+    } else {
+      const std::string& s = strings[PRand() % string_count];
+      auto it1 = hash_set.Find(s);
+      auto it2 = std_set.find(s);
+      ASSERT_EQ(it1 == hash_set.end(), it2 == std_set.end());
+      if (it1 != hash_set.end()) {
+        ASSERT_EQ(*it1, *it2);
+        hash_set.Erase(it1);
+        std_set.erase(it2);
+      }
+    }
+  }
+  ASSERT_EQ(hash_set.Verify(), 0U);
+}
+
+TEST_F(HashSetTest, TestSwissWriteAndRead) {
+  // Aligned values, the index and the control bytes must not come from the low bits alone.
+  SwissHashSet<uint64_t> hash_set;
+  static constexpr size_t count = 3000;
+  for (uint64_t i = 1; i <= count; ++i) {
+    hash_set.Insert(i * 8u);
+  }
+  ASSERT_EQ(hash_set.Verify(), 0U);
+  std::vector<uint64_t> buffer(hash_set.WriteToMemory(nullptr) / sizeof(uint64_t));
+  uint8_t* data = reinterpret_cast<uint8_t*>(buffer.data());
+  EXPECT_EQ(buffer.size() * sizeof(uint64_t), hash_set.WriteToMemory(data));
+  for (bool make_copy_of_data : {false, true}) {
+    size_t read_count;
+    SwissHashSet<uint64_t> read_set(data, make_copy_of_data, &read_count);
+    EXPECT_EQ(buffer.size() * sizeof(uint64_t), read_count);
+    EXPECT_EQ(make_copy_of_data, read_set.OwnsData());
+    EXPECT_EQ(hash_set.Size(), read_set.Size());
+    EXPECT_EQ(read_set.Verify(), 0U);
+    for (uint64_t i = 1; i <= count; ++i) {
+      EXPECT_NE(read_set.end(), read_set.Find(i * 8u));
+      EXPECT_EQ(read_set.end(), read_set.Find(i * 8u + 1u));
+    }
+  }
+}
+
+TEST_F(HashSetTest, TestSwissLookupByAlternateKeyType) {
+  SwissHashSet<std::vector<int>, IsEmptyFnVectorInt, VectorIntHashEquals, VectorIntHashEquals>
+      hash_set;
+  hash_set.Insert(std::vector<int>({1, 2, 3, 4}));
+  hash_set.Insert(std::vector<int>({4, 2}));
+  ASSERT_EQ(hash_set.end(), hash_set.Find(std::vector<int>({1, 1, 1, 1})));
+  ASSERT_NE(hash_set.end(), hash_set.Find(std::vector<int>({1, 2, 3, 4})));
+  ASSERT_EQ(hash_set.end(), hash_set.Find(std::forward_list<int>({1, 1, 1, 1})));
+  ASSERT_NE(hash_set.end(), hash_set.Find(std::forward_list<int>({1, 2, 3, 4})));
+}
+
+template <typename HashSetType>
+static uint64_t TimeFind(const HashSetType& hash_set,
+                         const std::vector<std::string>& strings,
+                         size_t* found) {
+  auto start = std::chrono::steady_clock::now();
+  for (const std::string& s : strings) {
+    if (hash_set.Find(s) != hash_set.end()) {
+      ++*found;
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+// Compare the lookups of HashSet and SwissHashSet, with strings sharing a long prefix as in class
+// descriptors. Run with --gtest_also_run_disabled_tests.
+TEST_F(HashSetTest, DISABLED_BenchmarkFind) {
+  static constexpr size_t kStringCount = 100000;
+  static constexpr size_t kRounds = 10;
+  const std::string prefix = "Landroid/content/pm/PackageManager$";
+  std::vector<std::string> present;
+  std::vector<std::string> absent;
+  for (size_t i = 0; i < kStringCount; ++i) {
+    present.push_back(prefix + RandomString(8));
+    absent.push_back(prefix + RandomString(8));
+  }
+  HashSet<std::string, IsEmptyFnString> hash_set;
+  SwissHashSet<std::string, IsEmptyFnString> swiss_hash_set;
+  for (const std::string& s : present) {
+    hash_set.Insert(s);
+    swiss_hash_set.Insert(s);
+  }
+  uint64_t hash_set_us = 0u;
+  uint64_t swiss_hash_set_us = 0u;
+  size_t hash_set_found = 0u;
+  size_t swiss_hash_set_found = 0u;
+  for (size_t round = 0; round < kRounds; ++round) {
+    hash_set_us += TimeFind(hash_set, present, &hash_set_found);
+    hash_set_us += TimeFind(hash_set, absent, &hash_set_found);
+    swiss_hash_set_us += TimeFind(swiss_hash_set, present, &swiss_hash_set_found);
+    swiss_hash_set_us += TimeFind(swiss_hash_set, absent, &swiss_hash_set_found);
+  }
+  EXPECT_EQ(kRounds * kStringCount, hash_set_found);
+  EXPECT_EQ(kRounds * kStringCount, swiss_hash_set_found);
+  LOG(INFO) << "HashSet: " << hash_set_us << "us, SwissHashSet: " << swiss_hash_set_us << "us";
+}
+
 }  // namespace art
@@ -57,6 +57,10 @@ template <class Value> class Histogram {
   double Mean() const;
   double Variance() const;
   double Percentile(double per, const CumulativeData& data) const;
+  // The percentile in the unit of the values added with AdjustAndAddValue.
+  double AdjustedPercentile(double per, const CumulativeData& data) const {
+    return Percentile(per, data) * kAdjust;
+  }
   void PrintConfidenceIntervals(std::ostream& os, double interval,
                                 const CumulativeData& data) const;
   void PrintMemoryUse(std::ostream& os) const;
@@ -0,0 +1,769 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_LIBARTBASE_BASE_SWISS_HASH_SET_H_
+#define ART_LIBARTBASE_BASE_SWISS_HASH_SET_H_
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <stdint.h>
+
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <android-base/logging.h>
+
+#include "base/bit_utils.h"
+#include "base/hash_set.h"
+#include "base/macros.h"
+
+namespace art {
+
+// A hash set with the same interface as HashSet, which also keeps one control byte per slot. The
+// control byte of a slot holds 7 bits of the hash of its element, or kEmpty. A lookup compares the
+// control bytes of 16 consecutive slots with the hash at once, and only calls Pred on the slots
+// that match, which helps when the elements are expensive to compare, such as strings.
+//
+// Like HashSet, this uses linear probing and moves the following elements back when erasing, so
+// there are no tombstones: a slot is empty if and only if no element was probed past it. The
+// number of buckets is a power of two, and the index and the control byte are taken from the high
+// bits of the hash multiplied by a large odd constant, so that weak hashes, like those of aligned
+// pointers, still spread. EmptyFn is still used for the elements of the empty slots, so that the
+// serialized data is self-contained.
+template <class T, class EmptyFn = DefaultEmptyFn<T>, class HashFn = std::hash<T>,
+    class Pred = std::equal_to<T>, class Alloc = std::allocator<T>>
+class SwissHashSet {
+  template <class Elem, class HashSetType>
+  class BaseIterator : std::iterator<std::forward_iterator_tag, Elem> {
+   public:
+    BaseIterator(const BaseIterator&) = default;
+    BaseIterator(BaseIterator&&) = default;
+    BaseIterator(HashSetType* hash_set, size_t index) : index_(index), hash_set_(hash_set) {
+    }
+    BaseIterator& operator=(const BaseIterator&) = default;
+    BaseIterator& operator=(BaseIterator&&) = default;
+
+    bool operator==(const BaseIterator& other) const {
+      return hash_set_ == other.hash_set_ && this->index_ == other.index_;
+    }
+
+    bool operator!=(const BaseIterator& other) const {
+      return !(*this == other);
+    }
+
+    BaseIterator operator++() {  // Value after modification.
+      this->index_ = hash_set_->NextNonEmptySlot(this->index_);
+      return *this;
+    }
+
+    BaseIterator operator++(int) {
+      BaseIterator temp = *this;
+      this->index_ = hash_set_->NextNonEmptySlot(this->index_);
+      return temp;
+    }
+
+    Elem& operator*() const {
+      DCHECK(!hash_set_->IsFreeSlot(this->index_));
+      return hash_set_->ElementForIndex(this->index_);
+    }
+
+    Elem* operator->() const {
+      return &**this;
+    }
+
+   private:
+    size_t index_;
+    HashSetType* hash_set_;
+
+    friend class SwissHashSet;
+  };
+
+ public:
+  using value_type = T;
+  using allocator_type = Alloc;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = BaseIterator<T, SwissHashSet>;
+  using const_iterator = BaseIterator<const T, const SwissHashSet>;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+
+  static constexpr double kDefaultMinLoadFactor = 0.4;
+  static constexpr double kDefaultMaxLoadFactor = 0.7;
+  static constexpr size_t kMinBuckets = 1024;
+
+  // If we don't own the data, this will create a new array which owns the data.
+  void Clear() {
+    DeallocateStorage();
+    num_elements_ = 0;
+    elements_until_expand_ = 0;
+  }
+
+  SwissHashSet() : SwissHashSet(kDefaultMinLoadFactor, kDefaultMaxLoadFactor) {}
+
+  SwissHashSet(double min_load_factor, double max_load_factor) noexcept
+      : num_elements_(0u),
+        num_buckets_(0u),
+        elements_until_expand_(0u),
+        owns_data_(false),
+        data_(nullptr),
+        control_(nullptr),
+        min_load_factor_(min_load_factor),
+        max_load_factor_(max_load_factor) {
+    DCHECK_GT(min_load_factor, 0.0);
+    DCHECK_LT(max_load_factor, 1.0);
+  }
+
+  explicit SwissHashSet(const allocator_type& alloc) noexcept
+      : allocfn_(alloc),
+        hashfn_(),
+        emptyfn_(),
+        pred_(),
+        num_elements_(0u),
+        num_buckets_(0u),
+        elements_until_expand_(0u),
+        owns_data_(false),
+        data_(nullptr),
+        control_(nullptr),
+        min_load_factor_(kDefaultMinLoadFactor),
+        max_load_factor_(kDefaultMaxLoadFactor) {
+  }
+
+  SwissHashSet(const SwissHashSet& other) noexcept
+      : allocfn_(other.allocfn_),
+        hashfn_(other.hashfn_),
+        emptyfn_(other.emptyfn_),
+        pred_(other.pred_),
+        num_elements_(other.num_elements_),
+        num_buckets_(0),
+        elements_until_expand_(other.elements_until_expand_),
+        owns_data_(false),
+        data_(nullptr),
+        control_(nullptr),
+        min_load_factor_(other.min_load_factor_),
+        max_load_factor_(other.max_load_factor_) {
+    AllocateStorage(other.NumBuckets());
+    for (size_t i = 0; i < num_buckets_; ++i) {
+      ElementForIndex(i) = other.data_[i];
+    }
+    if (num_buckets_ != 0u) {
+      memcpy(control_, other.control_, ControlSize(num_buckets_));
+    }
+  }
+
+  // noexcept required so that the move constructor is used instead of copy constructor.
+  SwissHashSet(SwissHashSet&& other) noexcept
+      : allocfn_(std::move(other.allocfn_)),
+        hashfn_(std::move(other.hashfn_)),
+        emptyfn_(std::move(other.emptyfn_)),
+        pred_(std::move(other.pred_)),
+        num_elements_(other.num_elements_),
+        num_buckets_(other.num_buckets_),
+        elements_until_expand_(other.elements_until_expand_),
+        owns_data_(other.owns_data_),
+        data_(other.data_),
+        control_(other.control_),
+        min_load_factor_(other.min_load_factor_),
+        max_load_factor_(other.max_load_factor_) {
+    other.num_elements_ = 0u;
+    other.num_buckets_ = 0u;
+    other.elements_until_expand_ = 0u;
+    other.owns_data_ = false;
+    other.data_ = nullptr;
+    other.control_ = nullptr;
+  }
+
+  // Construct from existing data.
+  // Read from a block of memory, if make_copy_of_data is false, then data_ and control_ point to
+  // within the passed in ptr_.
+  SwissHashSet(const uint8_t* ptr, bool make_copy_of_data, size_t* read_count) noexcept
+      : control_(nullptr) {
+    uint64_t temp;
+    size_t offset = 0;
+    offset = ReadFromBytes(ptr, offset, &temp);
+    num_elements_ = static_cast<uint64_t>(temp);
+    offset = ReadFromBytes(ptr, offset, &temp);
+    num_buckets_ = static_cast<uint64_t>(temp);
+    CHECK_LE(num_elements_, num_buckets_);
+    CHECK(num_buckets_ == 0u || IsPowerOfTwo(num_buckets_));
+    offset = ReadFromBytes(ptr, offset, &temp);
+    elements_until_expand_ = static_cast<uint64_t>(temp);
+    offset = ReadFromBytes(ptr, offset, &min_load_factor_);
+    offset = ReadFromBytes(ptr, offset, &max_load_factor_);
+    if (!make_copy_of_data) {
+      owns_data_ = false;
+      data_ = const_cast<T*>(reinterpret_cast<const T*>(ptr + offset));
+      offset += sizeof(*data_) * num_buckets_;
+      control_ = const_cast<uint8_t*>(ptr + offset);
+      offset += ControlSize(num_buckets_);
+    } else {
+      AllocateStorage(num_buckets_);
+      // Read elements, note that this may not be safe for cross compilation if the elements are
+      // pointer sized.
+      for (size_t i = 0; i < num_buckets_; ++i) {
+        offset = ReadFromBytes(ptr, offset, &data_[i]);
+      }
+      if (num_buckets_ != 0u) {
+        memcpy(control_, ptr + offset, ControlSize(num_buckets_));
+      }
+      offset += ControlSize(num_buckets_);
+    }
+    offset = RoundUp(offset, sizeof(uint64_t));
+    // Caller responsible for aligning.
+    *read_count = offset;
+  }
+
+  // Returns how large the table is after being written. If target is null, then no writing happens
+  // but the size is still returned. Target must be 8 byte aligned.
+  size_t WriteToMemory(uint8_t* ptr) const {
+    size_t offset = 0;
+    offset = WriteToBytes(ptr, offset, static_cast<uint64_t>(num_elements_));
+    offset = WriteToBytes(ptr, offset, static_cast<uint64_t>(num_buckets_));
+    offset = WriteToBytes(ptr, offset, static_cast<uint64_t>(elements_until_expand_));
+    offset = WriteToBytes(ptr, offset, min_load_factor_);
+    offset = WriteToBytes(ptr, offset, max_load_factor_);
+    // Write elements, note that this may not be safe for cross compilation if the elements are
+    // pointer sized.
+    for (size_t i = 0; i < num_buckets_; ++i) {
+      offset = WriteToBytes(ptr, offset, data_[i]);
+    }
+    if (ptr != nullptr && num_buckets_ != 0u) {
+      memcpy(ptr + offset, control_, ControlSize(num_buckets_));
+    }
+    offset += ControlSize(num_buckets_);
+    // Keep the data of a following table aligned.
+    size_t aligned_offset = RoundUp(offset, sizeof(uint64_t));
+    if (ptr != nullptr) {
+      memset(ptr + offset, 0, aligned_offset - offset);
+    }
+    // Caller responsible for aligning.
+    return aligned_offset;
+  }
+
+  ~SwissHashSet() {
+    DeallocateStorage();
+  }
+
+  SwissHashSet& operator=(SwissHashSet&& other) noexcept {
+    SwissHashSet(std::move(other)).swap(*this);  // NOLINT [runtime/explicit] [5]
+    return *this;
+  }
+
+  SwissHashSet& operator=(const SwissHashSet& other) noexcept {
+    SwissHashSet(other).swap(*this);  // NOLINT(runtime/explicit) - a case of lint gone mad.
+    return *this;
+  }
+
+  // Lower case for c++11 for each.
+  iterator begin() {
+    iterator ret(this, 0);
+    if (num_buckets_ != 0 && IsFreeSlot(ret.index_)) {
+      ++ret;  // Skip all the empty slots.
+    }
+    return ret;
+  }
+
+  // Lower case for c++11 for each. const version.
+  const_iterator begin() const {
+    const_iterator ret(this, 0);
+    if (num_buckets_ != 0 && IsFreeSlot(ret.index_)) {
+      ++ret;  // Skip all the empty slots.
+    }
+    return ret;
+  }
+
+  // Lower case for c++11 for each.
+  iterator end() {
+    return iterator(this, NumBuckets());
+  }
+
+  // Lower case for c++11 for each. const version.
+  const_iterator end() const {
+    return const_iterator(this, NumBuckets());
+  }
+
+  bool Empty() const {
+    return Size() == 0;
+  }
+
+  // Return true if the hash set has ownership of the underlying data.
+  bool OwnsData() const {
+    return owns_data_;
+  }
+
+  // Erase algorithm, as in HashSet:
+  // Make an empty slot where the iterator is pointing.
+  // Scan forwards until we hit another empty slot.
+  // If an element in between doesn't rehash to the range from the current empty slot to the
+  // iterator. It must be before the empty slot, in that case we can move it to the empty slot
+  // and set the empty slot to be the location we just moved from.
+  iterator Erase(iterator it) {
+    // empty_index is the index that will become empty.
+    size_t empty_index = it.index_;
+    DCHECK(!IsFreeSlot(empty_index));
+    size_t next_index = empty_index;
+    bool filled = false;  // True if we filled the empty index.
+    while (true) {
+      next_index = NextIndex(next_index);
+      // If the next slot is empty, we are done. Make sure to clear the current empty index.
+      if (IsFreeSlot(next_index)) {
+        emptyfn_.MakeEmpty(ElementForIndex(empty_index));
+        SetControl(empty_index, kEmpty);
+        break;
+      }
+      // Otherwise try to see if the next element can fill the current empty index. If its ideal
+      // index is within empty_index + 1 to next_index then there is nothing we can do.
+      size_t next_ideal_index = IndexForHash(hashfn_(ElementForIndex(next_index)));
+      size_t distance_to_next = (next_index - empty_index) & (NumBuckets() - 1u);
+      size_t distance_to_ideal = (next_ideal_index - empty_index) & (NumBuckets() - 1u);
+      if (distance_to_ideal == 0u || distance_to_ideal > distance_to_next) {
+        // If the ideal index isn't within our current range it must have been probed from before
+        // the empty index.
+        ElementForIndex(empty_index) = std::move(ElementForIndex(next_index));
+        SetControl(empty_index, control_[next_index]);
+        filled = true;
+        empty_index = next_index;
+      }
+    }
+    --num_elements_;
+    // If we didn't fill the slot then we need go to the next non free slot.
+    if (!filled) {
+      ++it;
+    }
+    return it;
+  }
+
+  // Find an element, returns end() if not found.
+  // Allows custom key (K) types, see HashSet::Find.
+  template <typename K>
+  iterator Find(const K& key) {
+    return FindWithHash(key, hashfn_(key));
+  }
+
+  template <typename K>
+  const_iterator Find(const K& key) const {
+    return FindWithHash(key, hashfn_(key));
+  }
+
+  template <typename K>
+  iterator FindWithHash(const K& key, size_t hash) {
+    return iterator(this, FindIndex(key, hash));
+  }
+
+  template <typename K>
+  const_iterator FindWithHash(const K& key, size_t hash) const {
+    return const_iterator(this, FindIndex(key, hash));
+  }
+
+  // Insert an element, allows duplicates.
+  template <typename U, typename = typename std::enable_if<std::is_convertible<U, T>::value>::type>
+  void Insert(U&& element) {
+    InsertWithHash(std::forward<U>(element), hashfn_(element));
+  }
+
+  template <typename U, typename = typename std::enable_if<std::is_convertible<U, T>::value>::type>
+  void InsertWithHash(U&& element, size_t hash) {
+    DCHECK_EQ(hash, hashfn_(element));
+    if (num_elements_ >= elements_until_expand_) {
+      Expand();
+      DCHECK_LT(num_elements_, elements_until_expand_);
+    }
+    const size_t index = FirstAvailableSlot(IndexForHash(hash));
+    data_[index] = std::forward<U>(element);
+    SetControl(index, ControlForHash(hash));
+    ++num_elements_;
+  }
+
+  size_t Size() const {
+    return num_elements_;
+  }
+
+  void swap(SwissHashSet& other) {
+    // Use argument-dependent lookup with fall-back to std::swap() for function objects.
+    using std::swap;
+    swap(allocfn_, other.allocfn_);
+    swap(hashfn_, other.hashfn_);
+    swap(emptyfn_, other.emptyfn_);
+    swap(pred_, other.pred_);
+    std::swap(data_, other.data_);
+    std::swap(control_, other.control_);
+    std::swap(num_buckets_, other.num_buckets_);
+    std::swap(num_elements_, other.num_elements_);
+    std::swap(elements_until_expand_, other.elements_until_expand_);
+    std::swap(min_load_factor_, other.min_load_factor_);
+    std::swap(max_load_factor_, other.max_load_factor_);
+    std::swap(owns_data_, other.owns_data_);
+  }
+
+  allocator_type get_allocator() const {
+    return allocfn_;
+  }
+
+  void ShrinkToMaximumLoad() {
+    Resize(Size() / max_load_factor_);
+  }
+
+  // Reserve enough room to insert until Size() == num_elements without requiring to grow the hash
+  // set. No-op if the hash set is already large enough to do this.
+  void Reserve(size_t num_elements) {
+    size_t num_buckets = num_elements / max_load_factor_;
+    // Deal with rounding errors. Add one for rounding.
+    while (static_cast<size_t>(num_buckets * max_load_factor_) <= num_elements + 1u) {
+      ++num_buckets;
+    }
+    if (num_buckets > NumBuckets()) {
+      Resize(num_buckets);
+    }
+  }
+
+  // To distance that inserted elements were probed. Used for measuring how good hash functions
+  // are.
+  size_t TotalProbeDistance() const {
+    size_t total = 0;
+    for (size_t i = 0; i < NumBuckets(); ++i) {
+      if (!IsFreeSlot(i)) {
+        size_t ideal_location = IndexForHash(hashfn_(ElementForIndex(i)));
+        total += (i - ideal_location) & (NumBuckets() - 1u);
+      }
+    }
+    return total;
+  }
+
+  // Calculate the current load factor and return it.
+  double CalculateLoadFactor() const {
+    return static_cast<double>(Size()) / static_cast<double>(NumBuckets());
+  }
+
+  // Make sure that every element is reachable from its ideal slot and has the right control
+  // byte. Returns the number of errors.
+  size_t Verify() NO_THREAD_SAFETY_ANALYSIS {
+    size_t errors = 0;
+    for (size_t i = 0; i < num_buckets_; ++i) {
+      if (IsFreeSlot(i)) {
+        continue;
+      }
+      const size_t hash = hashfn_(ElementForIndex(i));
+      if (control_[i] != ControlForHash(hash)) {
+        LOG(ERROR) << "Element " << i << " has the wrong control byte";
+        ++errors;
+      }
+      for (size_t index = IndexForHash(hash); index != i; index = NextIndex(index)) {
+        if (IsFreeSlot(index)) {
+          LOG(ERROR) << "Element " << i << " is past the empty slot " << index;
+          ++errors;
+          break;
+        }
+      }
+    }
+    for (size_t i = 0; i + 1u < kGroupSize && i < num_buckets_; ++i) {
+      if (control_[num_buckets_ + i] != control_[i]) {
+        LOG(ERROR) << "Control byte " << i << " is not mirrored";
+        ++errors;
+      }
+    }
+    return errors;
+  }
+
+  double GetMinLoadFactor() const {
+    return min_load_factor_;
+  }
+
+  double GetMaxLoadFactor() const {
+    return max_load_factor_;
+  }
+
+  // Change the load factor of the hash set. If the current load factor is greater than the max
+  // specified, then we resize the hash table storage.
+  void SetLoadFactor(double min_load_factor, double max_load_factor) {
+    DCHECK_LT(min_load_factor, max_load_factor);
+    DCHECK_GT(min_load_factor, 0.0);
+    DCHECK_LT(max_load_factor, 1.0);
+    min_load_factor_ = min_load_factor;
+    max_load_factor_ = max_load_factor;
+    elements_until_expand_ = NumBuckets() * max_load_factor_;
+    // If the current load factor isn't in the range, then resize to the mean of the minimum and
+    // maximum load factor.
+    const double load_factor = CalculateLoadFactor();
+    if (load_factor > max_load_factor_) {
+      Resize(Size() / ((min_load_factor_ + max_load_factor_) * 0.5));
+    }
+  }
+
+  // The hash set expands when Size() reaches ElementsUntilExpand().
+  size_t ElementsUntilExpand() const {
+    return elements_until_expand_;
+  }
+
+  size_t NumBuckets() const {
+    return num_buckets_;
+  }
+
+ private:
+  // The number of control bytes compared at once.
+  static constexpr size_t kGroupSize = 16u;
+  // The control byte of an empty slot. The control bytes of the other slots have the high bit
+  // clear.
+  static constexpr uint8_t kEmpty = 0x80u;
+  static constexpr uint64_t kHashMultiplier = UINT64_C(0x9e3779b97f4a7c15);
+
+  // The control bytes of the first slots are mirrored after the last one, so that the 16 control
+  // bytes starting at any slot can be loaded at once.
+  static size_t ControlSize(size_t num_buckets) {
+    return (num_buckets != 0u) ? num_buckets + kGroupSize - 1u : 0u;
+  }
+
+  T& ElementForIndex(size_t index) {
+    DCHECK_LT(index, NumBuckets());
+    DCHECK(data_ != nullptr);
+    return data_[index];
+  }
+
+  const T& ElementForIndex(size_t index) const {
+    DCHECK_LT(index, NumBuckets());
+    DCHECK(data_ != nullptr);
+    return data_[index];
+  }
+
+  uint64_t MixHash(size_t hash) const {
+    return static_cast<uint64_t>(hash) * kHashMultiplier;
+  }
+
+  size_t IndexForHash(size_t hash) const {
+    // Protect against undefined behavior (shift by the width of the type).
+    if (UNLIKELY(num_buckets_ <= 1u)) {
+      return 0;
+    }
+    return static_cast<size_t>(MixHash(hash) >> (64u - WhichPowerOf2(num_buckets_)));
+  }
+
+  // The 7 bits below those of the index.
+  uint8_t ControlForHash(size_t hash) const {
+    return static_cast<uint8_t>(MixHash(hash) >> (64u - 7u - WhichPowerOf2(num_buckets_))) & 0x7fu;
+  }
+
+  size_t NextIndex(size_t index) const {
+    return (index + 1u) & (NumBuckets() - 1u);
+  }
+
+  bool IsFreeSlot(size_t index) const {
+    DCHECK_LT(index, NumBuckets());
+    return control_[index] == kEmpty;
+  }
+
+  size_t NextNonEmptySlot(size_t index) const {
+    const size_t num_buckets = NumBuckets();
+    DCHECK_LT(index, num_buckets);
+    do {
+      ++index;
+    } while (index < num_buckets && IsFreeSlot(index));
+    return index;
+  }
+
+  void SetControl(size_t index, uint8_t value) {
+    control_[index] = value;
+    if (index + 1u < kGroupSize) {
+      control_[num_buckets_ + index] = value;
+    }
+  }
+
+  // Return a mask with the bit `i` set if the control byte of the slot `index + i` is `value`.
+  uint32_t MatchGroup(size_t index, uint8_t value) const {
+    const uint8_t* control = control_ + index;
+#if defined(__SSE2__)
+    __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+    __m128i match = _mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(value)));
+    return static_cast<uint32_t>(_mm_movemask_epi8(match));
+#else
+    return MatchWord(control, value) | (MatchWord(control + sizeof(uint64_t), value) << 8);
+#endif
+  }
+
+  // Return a mask with the bit `i` set if the byte `i` of the 8 bytes at `control` is `value`.
+  static uint32_t MatchWord(const uint8_t* control, uint8_t value) {
+    static constexpr uint64_t kLowBits = UINT64_C(0x7f7f7f7f7f7f7f7f);
+    uint64_t word;
+    memcpy(&word, control, sizeof(word));
+    uint64_t x = word ^ (UINT64_C(0x0101010101010101) * value);
+    // Set the high bit of the bytes of `x` that are zero, and only of those.
+    uint64_t zero = ~(((x & kLowBits) + kLowBits) | x | kLowBits);
+    // Gather the high bits into the top byte.
+    return static_cast<uint32_t>(((zero >> 7) * UINT64_C(0x0102040810204080)) >> 56);
+  }
+
+  // Find the hash table slot for an element, or return NumBuckets() if not found.
+  // This value for not found is important so that iterator(this, FindIndex(...)) == end().
+  template <typename K>
+  size_t FindIndex(const K& element, size_t hash) const {
+    // Guard against failing to get an element for a non-existing index.
+    if (UNLIKELY(NumBuckets() == 0)) {
+      return 0;
+    }
+    DCHECK_EQ(hashfn_(element), hash);
+    const uint8_t control = ControlForHash(hash);
+    size_t index = IndexForHash(hash);
+    while (true) {
+      uint32_t match = MatchGroup(index, control);
+      uint32_t empty = MatchGroup(index, kEmpty);
+      if (empty != 0u) {
+        // The element cannot be past the first empty slot.
+        match &= (empty & -empty) - 1u;
+      }
+      for (; match != 0u; match &= match - 1u) {
+        size_t slot = (index + CTZ(match)) & (NumBuckets() - 1u);
+        if (pred_(ElementForIndex(slot), element)) {
+          return slot;
+        }
+      }
+      if (empty != 0u) {
+        return NumBuckets();
+      }
+      index = (index + kGroupSize) & (NumBuckets() - 1u);
+    }
+  }
+
+  // Allocate a number of buckets.
+  void AllocateStorage(size_t num_buckets) {
+    DCHECK(num_buckets == 0u || IsPowerOfTwo(num_buckets));
+    num_buckets_ = num_buckets;
+    data_ = allocfn_.allocate(num_buckets_);
+    control_ = (num_buckets_ != 0u) ? new uint8_t[ControlSize(num_buckets_)] : nullptr;
+    owns_data_ = true;
+    for (size_t i = 0; i < num_buckets_; ++i) {
+      allocfn_.construct(allocfn_.address(data_[i]));
+      emptyfn_.MakeEmpty(data_[i]);
+    }
+    if (num_buckets_ != 0u) {
+      memset(control_, kEmpty, ControlSize(num_buckets_));
+    }
+  }
+
+  void DeallocateStorage() {
+    if (owns_data_) {
+      for (size_t i = 0; i < NumBuckets(); ++i) {
+        allocfn_.destroy(allocfn_.address(data_[i]));
+      }
+      if (data_ != nullptr) {
+        allocfn_.deallocate(data_, NumBuckets());
+      }
+      delete[] control_;
+      owns_data_ = false;
+    }
+    data_ = nullptr;
+    control_ = nullptr;
+    num_buckets_ = 0;
+  }
+
+  // Expand the set based on the load factors.
+  void Expand() {
+    size_t min_index = static_cast<size_t>(Size() / min_load_factor_);
+    // Resize based on the minimum load factor.
+    Resize(min_index);
+  }
+
+  // Expand / shrink the table to the new specified size, rounded up to a power of two.
+  void Resize(size_t new_size) {
+    if (new_size < kMinBuckets) {
+      new_size = kMinBuckets;
+    }
+    new_size = RoundUpToPowerOfTwo(new_size);
+    DCHECK_GE(new_size, Size());
+    T* const old_data = data_;
+    uint8_t* const old_control = control_;
+    size_t old_num_buckets = num_buckets_;
+    // Reinsert all of the old elements.
+    const bool owned_data = owns_data_;
+    AllocateStorage(new_size);
+    for (size_t i = 0; i < old_num_buckets; ++i) {
+      T& element = old_data[i];
+      if (old_control[i] != kEmpty) {
+        const size_t hash = hashfn_(element);
+        const size_t index = FirstAvailableSlot(IndexForHash(hash));
+        data_[index] = std::move(element);
+        SetControl(index, ControlForHash(hash));
+      }
+      if (owned_data) {
+        allocfn_.destroy(allocfn_.address(element));
+      }
+    }
+    if (owned_data) {
+      allocfn_.deallocate(old_data, old_num_buckets);
+      delete[] old_control;
+    }
+
+    // When we hit elements_until_expand_, we are at the max load factor and must expand again.
+    elements_until_expand_ = NumBuckets() * max_load_factor_;
+  }
+
+  ALWAYS_INLINE size_t FirstAvailableSlot(size_t index) const {
+    DCHECK_LT(index, NumBuckets());  // Don't try to get a slot out of range.
+    while (true) {
+      uint32_t empty = MatchGroup(index, kEmpty);
+      if (empty != 0u) {
+        return (index + CTZ(empty)) & (NumBuckets() - 1u);
+      }
+      index = (index + kGroupSize) & (NumBuckets() - 1u);
+    }
+  }
+
+  // Return new offset.
+  template <typename Elem>
+  static size_t WriteToBytes(uint8_t* ptr, size_t offset, Elem n) {
+    DCHECK_ALIGNED(ptr + offset, sizeof(n));
+    if (ptr != nullptr) {
+      *reinterpret_cast<Elem*>(ptr + offset) = n;
+    }
+    return offset + sizeof(n);
+  }
+
+  template <typename Elem>
+  static size_t ReadFromBytes(const uint8_t* ptr, size_t offset, Elem* out) {
+    DCHECK(ptr != nullptr);
+    DCHECK_ALIGNED(ptr + offset, sizeof(*out));
+    *out = *reinterpret_cast<const Elem*>(ptr + offset);
+    return offset + sizeof(*out);
+  }
+
+  Alloc allocfn_;  // Allocator function.
+  HashFn hashfn_;  // Hashing function.
+  EmptyFn emptyfn_;  // MakeEmpty function.
+  Pred pred_;  // Equals function.
+  size_t num_elements_;  // Number of inserted elements.
+  size_t num_buckets_;  // Number of hash table buckets, a power of two.
+  size_t elements_until_expand_;  // Maximum number of elements until we expand the table.
+  bool owns_data_;  // If we own data_ and control_ and are responsible for freeing them.
+  T* data_;  // Backing storage.
+  uint8_t* control_;  // The control bytes, ControlSize(num_buckets_) of them.
+  double min_load_factor_;
+  double max_load_factor_;
+};
+
+template <class T, class EmptyFn, class HashFn, class Pred, class Alloc>
+void swap(SwissHashSet<T, EmptyFn, HashFn, Pred, Alloc>& lhs,
+          SwissHashSet<T, EmptyFn, HashFn, Pred, Alloc>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace art
+
+#endif  // ART_LIBARTBASE_BASE_SWISS_HASH_SET_H_
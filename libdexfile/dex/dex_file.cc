@@ -33,6 +33,7 @@
 #include "base/stl_util.h"
 #include "descriptors_names.h"
 #include "dex_file-inl.h"
+#include "dex_file_verifier.h"
 #include "standard_dex_file.h"
 #include "utf-inl.h"
 
@@ -122,7 +123,8 @@ DexFile::DexFile(const uint8_t* base,
       oat_dex_file_(oat_dex_file),
       container_(std::move(container)),
       is_compact_dex_(is_compact_dex),
-      is_platform_dex_(false) {
+      is_platform_dex_(false),
+      deferred_verification_(DeferredVerification::kNone) {
   CHECK(begin_ != nullptr) << GetLocation();
   CHECK_GT(size_, 0U) << GetLocation();
   // Check base (=header) alignment.
@@ -133,6 +135,21 @@ DexFile::DexFile(const uint8_t* base,
   InitializeSectionsFromMapList();
 }
 
+bool DexFile::VerifyDeferred(std::string* error_msg) const {
+  DeferredVerification state = deferred_verification_.load(std::memory_order_acquire);
+  if (state == DeferredVerification::kPending) {
+    bool verified = DexFileVerifier::Verify(this,
+                                            Begin(),
+                                            Size(),
+                                            location_.c_str(),
+                                            /* verify_checksum */ true,
+                                            error_msg);
+    state = verified ? DeferredVerification::kNone : DeferredVerification::kFailed;
+    deferred_verification_.store(state, std::memory_order_release);
+  }
+  return state == DeferredVerification::kNone;
+}
+
 DexFile::~DexFile() {
   // We don't call DeleteGlobalRef on dex_object_ because we're only called by DestroyJavaVM, and
   // that's only called after DetachCurrentThread, which means there's no JNIEnv. We could
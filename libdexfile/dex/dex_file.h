@@ -17,6 +17,7 @@
 #ifndef ART_LIBDEXFILE_DEX_DEX_FILE_H_
 #define ART_LIBDEXFILE_DEX_DEX_FILE_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -959,6 +960,22 @@ class DexFile {
     oat_dex_file_ = oat_dex_file;
   }
 
+  // Defer the verification of a dex file opened without it, checksum included, to the first call
+  // of VerifyIfDeferred. Opening the dex file then does not read all its pages.
+  void DeferVerification() const {
+    deferred_verification_.store(DeferredVerification::kPending, std::memory_order_release);
+  }
+
+  // Run the verification deferred by DeferVerification, if it has not run yet. Return whether the
+  // dex file passed it. Only the call that ran the failed verification sets `error_msg`.
+  bool VerifyIfDeferred(std::string* error_msg) const {
+    if (LIKELY(deferred_verification_.load(std::memory_order_acquire) ==
+               DeferredVerification::kNone)) {
+      return true;
+    }
+    return VerifyDeferred(error_msg);
+  }
+
   // Read MapItems and validate/set remaining offsets.
   const DexFile::MapList* GetMapList() const {
     return reinterpret_cast<const DexFile::MapList*>(DataBegin() + header_->map_off_);
@@ -1105,6 +1122,18 @@ class DexFile {
   // If the dex file is located in /system/framework/.
   bool is_platform_dex_;
 
+  enum class DeferredVerification : uint8_t {
+    kNone,
+    kPending,
+    kFailed,
+  };
+
+  bool VerifyDeferred(std::string* error_msg) const;
+
+  // The state of the verification deferred by DeferVerification. Threads racing on the first
+  // lookups may all run the verification, which has the same result for each of them.
+  mutable std::atomic<DeferredVerification> deferred_verification_;
+
   friend class DexFileLoader;
   friend class DexFileVerifierTest;
   friend class OatWriter;
@@ -18,6 +18,7 @@
 
 #include "android-base/stringprintf.h"
 
+#include "base/bit_utils.h"
 #include "base/stl_util.h"
 #include "compact_dex_file.h"
 #include "dex_file.h"
@@ -94,15 +95,36 @@ class DexZipEntry {
     return zip_entry_->crc32;
   }
 
+  // Return the data of the entry in the memory of the archive if it is stored uncompressed and
+  // aligned for a dex file, so that it can be used in place. Return null otherwise.
+  const uint8_t* GetStoredData() {
+    if (zip_entry_->method != kCompressStored ||
+        zip_entry_->offset < 0 ||
+        static_cast<uint64_t>(zip_entry_->offset) + zip_entry_->uncompressed_length >
+            archive_size_) {
+      return nullptr;
+    }
+    const uint8_t* data = archive_base_ + zip_entry_->offset;
+    return IsAlignedParam(data, alignof(DexFile::Header)) ? data : nullptr;
+  }
+
  private:
   DexZipEntry(ZipArchiveHandle handle,
               ::ZipEntry* zip_entry,
-           const std::string& entry_name)
-    : handle_(handle), zip_entry_(zip_entry), entry_name_(entry_name) {}
+              const std::string& entry_name,
+              const uint8_t* archive_base,
+              size_t archive_size)
+    : handle_(handle),
+      zip_entry_(zip_entry),
+      entry_name_(entry_name),
+      archive_base_(archive_base),
+      archive_size_(archive_size) {}
 
   ZipArchiveHandle handle_;
   ::ZipEntry* const zip_entry_;
   std::string const entry_name_;
+  const uint8_t* const archive_base_;
+  const size_t archive_size_;
 
   friend class DexZipArchive;
   DISALLOW_COPY_AND_ASSIGN(DexZipEntry);
@@ -120,7 +142,7 @@ class DexZipArchive {
       CloseArchive(handle);
       return nullptr;
     }
-    return new DexZipArchive(handle);
+    return new DexZipArchive(handle, base, size);
   }
 
   DexZipEntry* Find(const char* name, std::string* error_msg) const {
@@ -132,7 +154,7 @@ class DexZipArchive {
       *error_msg = std::string(ErrorCodeString(error));
       return nullptr;
     }
-    return new DexZipEntry(handle_, zip_entry.release(), name);
+    return new DexZipEntry(handle_, zip_entry.release(), name, base_, size_);
   }
 
   ~DexZipArchive() {
@@ -141,8 +163,12 @@ class DexZipArchive {
 
 
  private:
-  explicit DexZipArchive(ZipArchiveHandle handle) : handle_(handle) {}
+  DexZipArchive(ZipArchiveHandle handle, const uint8_t* base, size_t size)
+      : handle_(handle), base_(base), size_(size) {}
   ZipArchiveHandle handle_;
+  // The memory the archive was opened from.
+  const uint8_t* const base_;
+  const size_t size_;
 
   friend class DexZipEntry;
   DISALLOW_COPY_AND_ASSIGN(DexZipArchive);
@@ -401,27 +427,46 @@ std::unique_ptr<const DexFile> DexFileLoader::OpenOneDexFileFromZip(
     return nullptr;
   }
 
-  std::vector<uint8_t> map(zip_entry->Extract(error_msg));
-  if (map.size() == 0) {
-    *error_msg = StringPrintf("Failed to extract '%s' from '%s': %s", entry_name, location.c_str(),
-                              error_msg->c_str());
-    *error_code = ZipOpenErrorCode::kExtractToMemoryError;
-    return nullptr;
-  }
   VerifyResult verify_result;
-  std::unique_ptr<const DexFile> dex_file = OpenCommon(
-      map.data(),
-      map.size(),
-      /*data_base*/ nullptr,
-      /*data_size*/ 0u,
-      location,
-      zip_entry->GetCrc32(),
-      /*oat_dex_file*/ nullptr,
-      verify,
-      verify_checksum,
-      error_msg,
-      std::make_unique<VectorContainer>(std::move(map)),
-      &verify_result);
+  std::unique_ptr<const DexFile> dex_file;
+  const uint8_t* stored_data = zip_entry->GetStoredData();
+  if (stored_data != nullptr) {
+    // Use the dex file in the memory of the archive, which the caller keeps alive.
+    dex_file = OpenCommon(stored_data,
+                          zip_entry->GetUncompressedLength(),
+                          /*data_base*/ nullptr,
+                          /*data_size*/ 0u,
+                          location,
+                          zip_entry->GetCrc32(),
+                          /*oat_dex_file*/ nullptr,
+                          verify,
+                          verify_checksum,
+                          error_msg,
+                          /*container*/ nullptr,
+                          &verify_result);
+  } else {
+    std::vector<uint8_t> map(zip_entry->Extract(error_msg));
+    if (map.size() == 0) {
+      *error_msg = StringPrintf("Failed to extract '%s' from '%s': %s",
+                                entry_name,
+                                location.c_str(),
+                                error_msg->c_str());
+      *error_code = ZipOpenErrorCode::kExtractToMemoryError;
+      return nullptr;
+    }
+    dex_file = OpenCommon(map.data(),
+                          map.size(),
+                          /*data_base*/ nullptr,
+                          /*data_size*/ 0u,
+                          location,
+                          zip_entry->GetCrc32(),
+                          /*oat_dex_file*/ nullptr,
+                          verify,
+                          verify_checksum,
+                          error_msg,
+                          std::make_unique<VectorContainer>(std::move(map)),
+                          &verify_result);
+  }
   if (dex_file == nullptr) {
     if (verify_result == VerifyResult::kVerifyNotAttempted) {
       *error_code = ZipOpenErrorCode::kDexFileError;
@@ -136,7 +136,8 @@ class DexFileLoader {
 
 
   // Opens all .dex files found in the memory map, guessing the container format based on file
-  // extension.
+  // extension. The dex files stored uncompressed in a zip archive are used in place, so the
+  // memory must outlive them, as for a single .dex file.
   virtual bool OpenAll(const uint8_t* base,
                        size_t size,
                        const std::string& location,
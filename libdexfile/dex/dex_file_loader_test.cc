@@ -140,6 +140,28 @@ static const char kRawZipClassesDexPresent[] =
   "AgAACwAYAAAAAAAAAAAAoIEAAAAAY2xhc3Nlcy5kZXhVVAUAAwFj5Vd1eAsAAQTkAwEABIgTAABQ"
   "SwUGAAAAAAEAAQBRAAAAdgEAAAAA";
 
+// A zip archive with kRawDex stored uncompressed as classes.dex, at offset 48.
+static const char kRawZipClassesDexStored[] =
+  "UEsDBBQAAAAAAAAAIUz4CtPziAMAAIgDAAALAAcAY2xhc3Nlcy5kZXj+ygMAAAAAZGV4CjAzNQAQ"
+  "edgAe7gM1B/WHsWJ6L7lGAISGC7yjD2IAwAAcAAAAHhWNBIAAAAAAAAAAMQCAAAPAAAAcAAAAAcA"
+  "AACsAAAAAgAAAMgAAAABAAAA4AAAAAMAAADoAAAAAgAAAAABAABIAgAAQAEAAK4BAAC2AQAAvQEA"
+  "AM0BAADXAQAA+wEAABsCAAA+AgAAUgIAAF8CAABiAgAAZgIAAHMCAAB5AgAAgQIAAAIAAAADAAAA"
+  "BAAAAAUAAAAGAAAABwAAAAkAAAAJAAAABgAAAAAAAAAKAAAABgAAAKgBAAAAAAEADQAAAAAAAQAA"
+  "AAAAAQAAAAAAAAAFAAAAAAAAAAAAAAAAAAAABQAAAAAAAAAIAAAAiAEAAKsCAAAAAAAAAQAAAAAA"
+  "AAAFAAAAAAAAAAgAAACYAQAAuAIAAAAAAAACAAAAlAIAAJoCAAABAAAAowIAAAIAAgABAAAAiAIA"
+  "AAYAAABbAQAAcBACAAAADgABAAEAAQAAAI4CAAAEAAAAcBACAAAADgBAAQAAAAAAAAAAAAAAAAAA"
+  "TAEAAAAAAAAAAAAAAAAAAAEAAAABAAY8aW5pdD4ABUlubmVyAA5MTmVzdGVkJElubmVyOwAITE5l"
+  "c3RlZDsAIkxkYWx2aWsvYW5ub3RhdGlvbi9FbmNsb3NpbmdDbGFzczsAHkxkYWx2aWsvYW5ub3Rh"
+  "dGlvbi9Jbm5lckNsYXNzOwAhTGRhbHZpay9hbm5vdGF0aW9uL01lbWJlckNsYXNzZXM7ABJMamF2"
+  "YS9sYW5nL09iamVjdDsAC05lc3RlZC5qYXZhAAFWAAJWTAALYWNjZXNzRmxhZ3MABG5hbWUABnRo"
+  "aXMkMAAFdmFsdWUAAgEABw4AAQAHDjwAAgIBDhgBAgMCCwQADBcBAgQBDhwBGAAAAQEAAJAgAICA"
+  "BNQCAAABAAGAgATwAgAAEAAAAAAAAAABAAAAAAAAAAEAAAAPAAAAcAAAAAIAAAAHAAAArAAAAAMA"
+  "AAACAAAAyAAAAAQAAAABAAAA4AAAAAUAAAADAAAA6AAAAAYAAAACAAAAAAEAAAMQAAACAAAAQAEA"
+  "AAEgAAACAAAAVAEAAAYgAAACAAAAiAEAAAEQAAABAAAAqAEAAAIgAAAPAAAArgEAAAMgAAACAAAA"
+  "iAIAAAQgAAADAAAAlAIAAAAgAAACAAAAqwIAAAAQAAABAAAAxAIAAFBLAQIUAxQAAAAAAAAAIUz4"
+  "CtPziAMAAIgDAAALAAcAAAAAAAAAAACAAQAAAABjbGFzc2VzLmRleP7KAwAAAABQSwUGAAAAAAEA"
+  "AQBAAAAAuAMAAAAA";
+
 static const char kRawZipClassesDexAbsent[] =
   "UEsDBBQAAAAIANVRN0ms99lIMQEAACACAAAOABwAbm90Y2xhc3Nlcy5kZXhVVAkAAwFj5VcUY+VX"
   "dXgLAAEE5AMBAASIEwAAS0mt4DIwtmDYYdV9csrcks83lpxZN2vD8f/1p1beWX3vabQCEwNDAQMD"
@@ -421,6 +443,20 @@ TEST_F(DexFileLoaderTest, ZipOpenClassesPresent) {
   EXPECT_EQ(dex_files.size(), 1u);
 }
 
+TEST_F(DexFileLoaderTest, ZipOpenClassesStoredInPlace) {
+  std::vector<uint8_t> dex_bytes;
+  std::vector<std::unique_ptr<const DexFile>> dex_files;
+  std::string error_msg;
+  ASSERT_TRUE(OpenDexFilesBase64(kRawZipClassesDexStored,
+                                 kLocationString,
+                                 &dex_bytes,
+                                 &dex_files,
+                                 &error_msg)) << error_msg;
+  ASSERT_EQ(dex_files.size(), 1u);
+  // The uncompressed dex file is not extracted.
+  EXPECT_EQ(dex_files[0]->Begin(), dex_bytes.data() + 48);
+}
+
 TEST_F(DexFileLoaderTest, ZipOpenClassesAbsent) {
   std::vector<uint8_t> dex_bytes;
   std::vector<std::unique_ptr<const DexFile>> dex_files;
@@ -456,6 +492,47 @@ TEST_F(DexFileLoaderTest, OpenDexBadMapOffset) {
   EXPECT_EQ(raw, nullptr);
 }
 
+static std::unique_ptr<const DexFile> OpenDexFileWithDeferredVerification(
+    const std::vector<uint8_t>& dex_bytes) {
+  std::string error_message;
+  const DexFileLoader dex_file_loader;
+  std::unique_ptr<const DexFile> dex_file(dex_file_loader.Open(dex_bytes.data(),
+                                                               dex_bytes.size(),
+                                                               kLocationString,
+                                                               0x00d87910U,
+                                                               /* oat_dex_file */ nullptr,
+                                                               /* verify */ false,
+                                                               /* verify_checksum */ false,
+                                                               &error_message));
+  CHECK(dex_file != nullptr) << error_message;
+  dex_file->DeferVerification();
+  return dex_file;
+}
+
+TEST_F(DexFileLoaderTest, DeferredVerification) {
+  std::vector<uint8_t> dex_bytes;
+  DecodeDexFile(kRawDex, &dex_bytes);
+  std::unique_ptr<const DexFile> raw = OpenDexFileWithDeferredVerification(dex_bytes);
+  std::string error_msg;
+  EXPECT_TRUE(raw->VerifyIfDeferred(&error_msg)) << error_msg;
+  EXPECT_TRUE(raw->VerifyIfDeferred(&error_msg)) << error_msg;
+}
+
+TEST_F(DexFileLoaderTest, DeferredVerificationBadChecksum) {
+  std::vector<uint8_t> dex_bytes;
+  DecodeDexFile(kRawDex, &dex_bytes);
+  // Opening does not check the checksum, which the deferred verification then rejects.
+  dex_bytes[offsetof(DexFile::Header, checksum_)] ^= 0xffu;
+  std::unique_ptr<const DexFile> raw = OpenDexFileWithDeferredVerification(dex_bytes);
+  std::string error_msg;
+  EXPECT_FALSE(raw->VerifyIfDeferred(&error_msg));
+  EXPECT_FALSE(error_msg.empty());
+  // The failure is remembered, and only reported once.
+  error_msg.clear();
+  EXPECT_FALSE(raw->VerifyIfDeferred(&error_msg));
+  EXPECT_TRUE(error_msg.empty());
+}
+
 TEST_F(DexFileLoaderTest, GetStringWithNoIndex) {
   std::vector<uint8_t> dex_bytes;
   std::unique_ptr<const DexFile> raw(OpenDexFileBase64(kRawDex, kLocationString, &dex_bytes));
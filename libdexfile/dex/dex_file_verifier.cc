@@ -18,8 +18,11 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
+#include <atomic>
 #include <limits>
 #include <memory>
+#include <thread>
 
 #include "android-base/stringprintf.h"
 
@@ -37,6 +40,11 @@ using android::base::StringPrintf;
 
 static constexpr uint32_t kTypeIdLimit = std::numeric_limits<uint16_t>::max();
 
+// The references between the sections of dex files at least this large are checked on several
+// threads. Starting the threads costs more than checking smaller dex files.
+static constexpr size_t kMinFileSizeForParallelInterSection = 4 * 1024 * 1024;
+static constexpr size_t kMaxInterSectionThreads = 4;
+
 static bool IsValidOrNoTypeId(uint16_t low, uint16_t high) {
   return (high == 0) || ((high == 0xffffU) && (low == 0xffffU));
 }
@@ -1962,8 +1970,9 @@ bool DexFileVerifier::CheckIntraSection() {
 
 bool DexFileVerifier::CheckOffsetToTypeMap(size_t offset, uint16_t type) {
   DCHECK_NE(offset, 0u);
-  auto it = offset_to_type_map_.Find(offset);
-  if (UNLIKELY(it == offset_to_type_map_.end())) {
+  const auto& offset_to_type_map = main_verifier_->offset_to_type_map_;
+  auto it = offset_to_type_map.Find(offset);
+  if (UNLIKELY(it == offset_to_type_map.end())) {
     ErrorStringPrintf("No data map entry found @ %zx; expected %x", offset, type);
     return false;
   }
@@ -2807,11 +2816,11 @@ bool DexFileVerifier::CheckInterSection() {
   uint32_t count = map->size_;
 
   // Cross check the items listed in the map.
-  while (count--) {
-    uint32_t section_offset = item->offset_;
-    uint32_t section_count = item->size_;
+  std::vector<const DexFile::MapItem*> sections;
+  bool found = true;
+  while (found && count--) {
     DexFile::MapItemType type = static_cast<DexFile::MapItemType>(item->type_);
-    bool found = false;
+    found = false;
 
     switch (type) {
       case DexFile::kDexTypeHeaderItem:
@@ -2836,25 +2845,83 @@ bool DexFileVerifier::CheckInterSection() {
       case DexFile::kDexTypeAnnotationSetItem:
       case DexFile::kDexTypeClassDataItem:
       case DexFile::kDexTypeAnnotationsDirectoryItem: {
-        if (!CheckInterSectionIterate(section_offset, section_count, type)) {
-          return false;
-        }
+        sections.push_back(item);
         found = true;
         break;
       }
     }
 
-    if (!found) {
-      ErrorStringPrintf("Unknown map item type %x", item->type_);
+    if (found) {
+      item++;
+    }
+  }
+
+  // The sections only read the structure checked before, and `defined_classes_` is only used by
+  // the class definitions, so they can be checked independently.
+  size_t num_threads = std::min<size_t>(std::thread::hardware_concurrency(), sections.size());
+  num_threads = std::min(num_threads, kMaxInterSectionThreads);
+  if (header_->file_size_ >= kMinFileSizeForParallelInterSection && num_threads > 1u) {
+    if (!CheckInterSectionsInParallel(sections, num_threads)) {
       return false;
     }
+  } else {
+    for (const DexFile::MapItem* section : sections) {
+      if (!CheckInterSectionIterate(section->offset_,
+                                    section->size_,
+                                    static_cast<DexFile::MapItemType>(section->type_))) {
+        return false;
+      }
+    }
+  }
 
-    item++;
+  // Report an unknown map item after the failures of the sections before it.
+  if (!found) {
+    ErrorStringPrintf("Unknown map item type %x", item->type_);
+    return false;
   }
 
   return true;
 }
 
+bool DexFileVerifier::CheckInterSectionsInParallel(
+    const std::vector<const DexFile::MapItem*>& sections,
+    size_t num_threads) {
+  std::vector<std::unique_ptr<DexFileVerifier>> verifiers;
+  verifiers.reserve(sections.size());
+  for (size_t i = 0; i != sections.size(); ++i) {
+    verifiers.emplace_back(new DexFileVerifier(this));
+  }
+  std::unique_ptr<bool[]> results(new bool[sections.size()]);
+  std::atomic<size_t> next_section(0u);
+  auto check_sections = [&]() {
+    for (size_t i = next_section.fetch_add(1u, std::memory_order_relaxed);
+         i < sections.size();
+         i = next_section.fetch_add(1u, std::memory_order_relaxed)) {
+      const DexFile::MapItem* section = sections[i];
+      results[i] = verifiers[i]->CheckInterSectionIterate(
+          section->offset_, section->size_, static_cast<DexFile::MapItemType>(section->type_));
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1u);
+  for (size_t i = 1; i != num_threads; ++i) {
+    threads.emplace_back(check_sections);
+  }
+  check_sections();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  // Report the failure of the first section in the map, as checking them in order would.
+  for (size_t i = 0; i != sections.size(); ++i) {
+    if (!results[i]) {
+      failure_reason_ = verifiers[i]->FailureReason();
+      return false;
+    }
+  }
+  return true;
+}
+
 bool DexFileVerifier::Verify() {
   // Check the header.
   if (!CheckHeader()) {
@@ -18,6 +18,7 @@
 #define ART_LIBDEXFILE_DEX_DEX_FILE_VERIFIER_H_
 
 #include <unordered_set>
+#include <vector>
 
 #include "base/hash_map.h"
 #include "base/safe_map.h"
@@ -52,7 +53,20 @@ class DexFileVerifier {
         verify_checksum_(verify_checksum),
         header_(&dex_file->GetHeader()),
         ptr_(nullptr),
-        previous_item_(nullptr)  {
+        previous_item_(nullptr),
+        main_verifier_(this) {
+  }
+
+  // Create a verifier checking the references of some sections of the dex file of
+  // `main_verifier`, after it checked the structure of all the sections. It shares the map of the
+  // data section items of `main_verifier`.
+  explicit DexFileVerifier(const DexFileVerifier* main_verifier)
+      : DexFileVerifier(main_verifier->dex_file_,
+                        main_verifier->begin_,
+                        main_verifier->size_,
+                        main_verifier->location_,
+                        main_verifier->verify_checksum_) {
+    main_verifier_ = main_verifier;
   }
 
   bool Verify();
@@ -151,6 +165,9 @@ class DexFileVerifier {
 
   bool CheckInterSectionIterate(size_t offset, uint32_t count, DexFile::MapItemType type);
   bool CheckInterSection();
+  // Check the references of `sections` on several threads, each section with its own verifier.
+  bool CheckInterSectionsInParallel(const std::vector<const DexFile::MapItem*>& sections,
+                                    size_t num_threads);
 
   // Load a string by (type) index. Checks whether the index is in bounds, printing the error if
   // not. If there is an error, null is returned.
@@ -237,6 +254,10 @@ class DexFileVerifier {
 
   std::string failure_reason_;
 
+  // The verifier that checked the structure of the sections and owns `offset_to_type_map_`. This
+  // verifier, unless it only checks the references of some sections.
+  const DexFileVerifier* main_verifier_;
+
   // Set of type ids for which there are ClassDef elements in the dex file.
   std::unordered_set<decltype(DexFile::ClassDef::class_idx_)> defined_classes_;
 };
@@ -85,6 +85,12 @@ static constexpr uint32_t kAccCompileDontBother =     0x02000000;  // method (ru
 
 // Set by the verifier for a method that could not be verified to follow structured locking.
 static constexpr uint32_t kAccMustCountLocks =        0x04000000;  // method (runtime)
+// Set by the autofast JNI detection, together with kAccFastNative, on a static native method
+// with a primitive-only signature whose native code reads neither the JNIEnv* nor the jclass.
+// The method keeps the normal JNI calling convention but, like a @CriticalNative method, does
+// not need a local reference frame. Reuses the value of kAccMustCountLocks which is not used
+// for native methods.
+static constexpr uint32_t kAccAutoCriticalNative =    0x04000000;  // method (runtime; native only)
 
 // Set by the class linker for a method that has only one implementation for a
 // virtual call.
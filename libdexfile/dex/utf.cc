@@ -28,6 +28,21 @@ namespace art {
 using android::base::StringAppendF;
 using android::base::StringPrintf;
 
+// Return the first byte at or after `utf8` that may not be ASCII, checking eight bytes at a time.
+// The bytes left before `end` that do not fill a whole word are not checked.
+static inline const char* SkipAsciiWords(const char* utf8, const char* end) {
+  static constexpr uint64_t kHighBits = UINT64_C(0x8080808080808080);
+  while (static_cast<size_t>(end - utf8) >= sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, utf8, sizeof(word));
+    if ((word & kHighBits) != 0u) {
+      break;
+    }
+    utf8 += sizeof(uint64_t);
+  }
+  return utf8;
+}
+
 // This is used only from debugger and test code.
 size_t CountModifiedUtf8Chars(const char* utf8) {
   return CountModifiedUtf8Chars(utf8, strlen(utf8));
@@ -53,6 +68,12 @@ size_t CountModifiedUtf8Chars(const char* utf8, size_t byte_count) {
   size_t len = 0;
   const char* end = utf8 + byte_count;
   for (; utf8 < end; ++utf8) {
+    const char* ascii_end = SkipAsciiWords(utf8, end);
+    len += ascii_end - utf8;
+    utf8 = ascii_end;
+    if (utf8 == end) {
+      break;
+    }
     int ic = *utf8;
     len++;
     if (LIKELY((ic & 0x80) == 0)) {
@@ -111,6 +132,13 @@ void ConvertModifiedUtf8ToUtf16(uint16_t* utf16_data_out, size_t out_chars,
 
   // String contains non-ASCII characters.
   for (const char *p = in_start; p < in_end;) {
+    // Widen the runs of ASCII characters without decoding them.
+    for (const char* ascii_end = SkipAsciiWords(p, in_end); p < ascii_end; ++p) {
+      *out_p++ = static_cast<uint16_t>(*p);
+    }
+    if (p == in_end) {
+      break;
+    }
     const uint32_t ch = GetUtf16FromUtf8(&p);
     const uint16_t leading = GetLeadingUtf16Char(ch);
     const uint16_t trailing = GetTrailingUtf16Char(ch);
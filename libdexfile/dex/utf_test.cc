@@ -17,6 +17,7 @@
 #include "utf.h"
 
 #include <map>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -378,4 +379,30 @@ TEST_F(UtfTest, ExhaustiveBidirectionalCodePointCheck) {
   }
 }
 
+// The ASCII characters are checked a word at a time, test runs of all lengths around a word
+// before, between and after characters of each encoding.
+TEST_F(UtfTest, CountAndConvertModifiedUtf8_AsciiRuns) {
+  const std::vector<std::string> kNonAscii = {
+      "\xc4\x81",          // Two byte encoding.
+      "\xed\xbb\xb0",      // Three byte encoding.
+      "\xf0\x90\xa0\x82",  // Four byte encoding.
+  };
+  for (const std::string& non_ascii : kNonAscii) {
+    for (size_t before = 0; before <= 17; ++before) {
+      for (size_t after = 0; after <= 17; ++after) {
+        std::string utf8 = std::string(before, 'a') + non_ascii + std::string(after, 'b') +
+            non_ascii + std::string(before, 'c');
+        size_t expected_chars = CountModifiedUtf8Chars_reference(utf8.c_str());
+        ASSERT_EQ(expected_chars, CountModifiedUtf8Chars(utf8.c_str(), utf8.size()));
+
+        std::vector<uint16_t> expected(expected_chars);
+        ConvertModifiedUtf8ToUtf16(expected.data(), utf8.c_str());
+        std::vector<uint16_t> output(expected_chars);
+        ConvertModifiedUtf8ToUtf16(output.data(), expected_chars, utf8.c_str(), utf8.size());
+        EXPECT_EQ(expected, output);
+      }
+    }
+  }
+}
+
 }  // namespace art
@@ -391,6 +391,7 @@ class OatDumper {
       oat_dex_files_(oat_file.GetOatDexFiles()),
       options_(options),
       resolved_addr2instr_(0),
+      addr2instr_method_(nullptr),
       instruction_set_(oat_file_.GetOatHeader().GetInstructionSet()),
       disassembler_(Disassembler::Create(instruction_set_,
                                          new DisassemblerOptions(
@@ -511,6 +512,10 @@ class OatDumper {
       resolved_addr2instr_ = options_.addr2instr_ + oat_header.GetExecutableOffset();
       os << "SEARCH ADDRESS (executable offset + input):\n";
       os << StringPrintf("0x%08x\n\n", resolved_addr2instr_);
+      addr2instr_method_ = FindMethodCode(resolved_addr2instr_);
+      if (addr2instr_method_ == nullptr) {
+        os << "No compiled method contains the search address.\n\n";
+      }
     }
 
     // Dumping the dex file overview is compact enough to do even if header only.
@@ -911,7 +916,12 @@ class OatDumper {
           it.SkipAllFields();
           uint32_t class_method_index = 0;
           while (it.HasNextMethod()) {
-            AddOffsets(oat_class.GetOatMethod(class_method_index++));
+            const OatFile::OatMethod oat_method = oat_class.GetOatMethod(class_method_index);
+            AddOffsets(oat_method);
+            if (options_.addr2instr_ != 0) {
+              AddMethodCode(oat_method, i, class_def_index, class_method_index);
+            }
+            class_method_index++;
             it.Next();
           }
         }
@@ -937,6 +947,41 @@ class OatDumper {
     offsets_.insert(oat_method.GetVmapTableOffset());
   }
 
+  // The location of the compiled code of a method, for looking up the method containing an
+  // address without disassembling all the methods before it.
+  struct MethodCode {
+    size_t oat_dex_file_index;
+    uint32_t class_def_index;
+    uint32_t class_method_index;
+    uint32_t code_size;
+  };
+
+  void AddMethodCode(const OatFile::OatMethod& oat_method,
+                     size_t oat_dex_file_index,
+                     uint32_t class_def_index,
+                     uint32_t class_method_index) {
+    uint32_t code_size = oat_method.GetQuickCodeSize();
+    if (code_size == 0) {
+      return;
+    }
+    // Methods sharing deduplicated code keep the first entry.
+    method_code_.emplace(AlignCodeOffset(oat_method.GetCodeOffset()),
+                         MethodCode { oat_dex_file_index,
+                                      class_def_index,
+                                      class_method_index,
+                                      code_size });
+  }
+
+  // Returns the method whose code contains `offset`, or null if there is none.
+  const MethodCode* FindMethodCode(uint32_t offset) const {
+    auto it = method_code_.upper_bound(offset);
+    if (it == method_code_.begin()) {
+      return nullptr;
+    }
+    --it;
+    return (offset < it->first + it->second.code_size) ? &it->second : nullptr;
+  }
+
   // Dex file data, may be for multiple different dex files.
   class DexFileData {
    public:
@@ -1105,6 +1150,14 @@ class OatDumper {
         continue;
       }
 
+      // Only the class holding the searched code is dumped, see FindMethodCode.
+      if (resolved_addr2instr_ != 0 &&
+          (addr2instr_method_ == nullptr ||
+           oat_dex_files_[addr2instr_method_->oat_dex_file_index] != &oat_dex_file ||
+           addr2instr_method_->class_def_index != class_def_index)) {
+        continue;
+      }
+
       uint32_t oat_class_offset = oat_dex_file.GetOatClassOffset(class_def_index);
       const OatFile::OatClass oat_class = oat_dex_file.GetOatClass(class_def_index);
       os << StringPrintf("%zd: %s (offset=0x%08x) (type_idx=%d)",
@@ -1306,6 +1359,13 @@ class OatDumper {
       return success;
     }
 
+    if (resolved_addr2instr_ != 0) {
+      if (class_method_index != addr2instr_method_->class_method_index) {
+        return success;
+      }
+      *addr_found = true;  // stop analyzing file at next iteration
+    }
+
     std::string pretty_method = dex_file.PrettyMethod(dex_method_idx, true);
     vios->Stream() << StringPrintf("%d: %s (dex_method_idx=%d)\n",
                                    class_method_index, pretty_method.c_str(),
@@ -1319,13 +1379,6 @@ class OatDumper {
     const OatFile::OatMethod oat_method = oat_class.GetOatMethod(class_method_index);
     uint32_t code_offset = oat_method.GetCodeOffset();
     uint32_t code_size = oat_method.GetQuickCodeSize();
-    if (resolved_addr2instr_ != 0) {
-      if (resolved_addr2instr_ > code_offset + code_size) {
-        return success;
-      } else {
-        *addr_found = true;  // stop analyzing file at next iteration
-      }
-    }
 
     // Everything below is indented at least once.
     ScopedIndentation indent1(vios);
@@ -1965,8 +2018,11 @@ class OatDumper {
   const std::vector<const OatFile::OatDexFile*> oat_dex_files_;
   const OatDumperOptions& options_;
   uint32_t resolved_addr2instr_;
+  const MethodCode* addr2instr_method_;
   const InstructionSet instruction_set_;
   std::set<uintptr_t> offsets_;
+  // Code offset to method, only filled for --addr2instr.
+  std::map<uint32_t, MethodCode> method_code_;
   Disassembler* disassembler_;
   Stats stats_;
 };
@@ -3748,7 +3804,8 @@ struct OatdumpArgs : public CmdlineArgs {
         "      Example: --export-dex-to=/data/local/tmp\n"
         "\n"
         "  --addr2instr=<address>: output matching method disassembled code from relative\n"
-        "                          address (e.g. PC from crash dump)\n"
+        "                          address (e.g. PC from crash dump). Only the method whose\n"
+        "                          code contains the address is dumped.\n"
         "      Example: --addr2instr=0x00001a3b\n"
         "\n"
         "  --dump-imt=<file.txt>: output IMT collisions (if any) for the given receiver\n"
@@ -61,6 +61,12 @@ TEST_F(OatDumpTest, TestListMethodsStatic) {
   ASSERT_TRUE(Exec(kStatic, kModeArt, {"--list-methods"}, kListOnly, &error_msg)) << error_msg;
 }
 
+TEST_F(OatDumpTest, TestAddr2Instr) {
+  std::string error_msg;
+  ASSERT_TRUE(Exec(kDynamic, kModeOat, {"--addr2instr=0x1000"}, kListOnly, &error_msg))
+      << error_msg;
+}
+
 TEST_F(OatDumpTest, TestSymbolize) {
   std::string error_msg;
   ASSERT_TRUE(Exec(kDynamic, kModeSymbolize, {}, kListOnly, &error_msg)) << error_msg;
@@ -1309,6 +1309,7 @@ class JvmtiFunctions {
     ArtJvmTiEnv* tienv = ArtJvmTiEnv::AsArtJvmTiEnv(env);
     gEventHandler->RemoveArtJvmTiEnv(tienv);
     art::Runtime::Current()->RemoveSystemWeakHolder(tienv->object_tag_table.get());
+    MethodUtil::DeleteMethodEventFilter(tienv);
     ThreadUtil::RemoveEnvironment(tienv);
     delete tienv;
     return OK;
@@ -1487,6 +1488,8 @@ ArtJvmTiEnv::ArtJvmTiEnv(art::JavaVMExt* runtime, EventHandler* event_handler, j
       local_data(nullptr),
       ti_version(version),
       capabilities(),
+      has_method_event_filter(false),
+      method_events_deoptimized_all(false),
       event_info_mutex_("jvmtiEnv_EventInfoMutex") {
   object_tag_table = std::unique_ptr<ObjectTagTable>(new ObjectTagTable(event_handler, this));
   functions = &gJvmtiInterface;
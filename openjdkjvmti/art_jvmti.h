@@ -99,6 +99,15 @@ struct ArtJvmTiEnv : public jvmtiEnv {
   std::unordered_set<Breakpoint> breakpoints GUARDED_BY(event_info_mutex_);
   std::unordered_set<const art::ShadowFrame*> notify_frames GUARDED_BY(event_info_mutex_);
 
+  // If set, the MethodEntry and MethodExit events of this jvmtiEnv are only sent for the methods of
+  // method_event_filter, and only they are deoptimized when the events are enabled.
+  bool has_method_event_filter GUARDED_BY(event_info_mutex_);
+  // The filtered methods, each with a weak global of its declaring class. The weak global is
+  // cleared once the method is unloaded, so that it is never used again.
+  std::unordered_map<art::ArtMethod*, jweak> method_event_filter GUARDED_BY(event_info_mutex_);
+  // Whether the method events of this jvmtiEnv are enabled with a full deoptimization.
+  bool method_events_deoptimized_all GUARDED_BY(event_info_mutex_);
+
   // RW lock to protect access to all of the event data.
   art::ReaderWriterMutex event_info_mutex_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
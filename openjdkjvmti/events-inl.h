@@ -120,7 +120,8 @@ class ScopedEventDispatchEnvironment FINAL : public art::ValueObject {
   fn(GarbageCollectionFinish, ArtJvmtiEvent::kGarbageCollectionFinish)               \
   fn(ObjectFree,              ArtJvmtiEvent::kObjectFree)                            \
   fn(VMObjectAlloc,           ArtJvmtiEvent::kVmObjectAlloc)                         \
-  fn(DdmPublishChunk,         ArtJvmtiEvent::kDdmPublishChunk)
+  fn(DdmPublishChunk,         ArtJvmtiEvent::kDdmPublishChunk)                       \
+  fn(SampledObjectAlloc,      ArtJvmtiEvent::kSampledObjectAlloc)
 
 template <ArtJvmtiEvent kEvent>
 struct EventFnType {
@@ -328,7 +329,8 @@ inline void EventHandler::ExecuteCallback(impl::EventHandlerFunc<kEvent> handler
 }
 
 // Events that need custom logic for if we send the event but are otherwise normal. This includes
-// the kBreakpoint, kFramePop, kFieldAccess, and kFieldModification events.
+// the kBreakpoint, kFramePop, kMethodEntry, kMethodExit, kFieldAccess, and kFieldModification
+// events.
 
 // Need to give custom specializations for Breakpoint since it needs to filter out which particular
 // methods/dex_pcs agents get notified on.
@@ -362,6 +364,36 @@ inline bool EventHandler::ShouldDispatch<ArtJvmtiEvent::kFramePop>(
       ShouldDispatchOnThread<ArtJvmtiEvent::kFramePop>(env, thread);
 }
 
+// Need to give custom specializations for MethodEntry and MethodExit since agents may restrict them
+// to some methods.
+template <>
+inline bool EventHandler::ShouldDispatch<ArtJvmtiEvent::kMethodEntry>(
+    ArtJvmTiEnv* env,
+    art::Thread* thread,
+    JNIEnv* jnienv ATTRIBUTE_UNUSED,
+    jthread jni_thread ATTRIBUTE_UNUSED,
+    jmethodID jmethod) const {
+  art::Thread* self = art::Thread::Current();
+  art::ReaderMutexLock lk(self, env->event_info_mutex_);
+  return ShouldDispatchOnThread<ArtJvmtiEvent::kMethodEntry>(env, thread) &&
+      IsInMethodEventFilter(env, self, jmethod);
+}
+
+template <>
+inline bool EventHandler::ShouldDispatch<ArtJvmtiEvent::kMethodExit>(
+    ArtJvmTiEnv* env,
+    art::Thread* thread,
+    JNIEnv* jnienv ATTRIBUTE_UNUSED,
+    jthread jni_thread ATTRIBUTE_UNUSED,
+    jmethodID jmethod,
+    jboolean was_popped_by_exception ATTRIBUTE_UNUSED,
+    jvalue val ATTRIBUTE_UNUSED) const {
+  art::Thread* self = art::Thread::Current();
+  art::ReaderMutexLock lk(self, env->event_info_mutex_);
+  return ShouldDispatchOnThread<ArtJvmtiEvent::kMethodExit>(env, thread) &&
+      IsInMethodEventFilter(env, self, jmethod);
+}
+
 // Need to give custom specializations for FieldAccess and FieldModification since they need to
 // filter out which particular fields agents want to get notified on.
 // TODO The spec allows us to do shortcuts like only allow one agent to ever set these watches. This
@@ -77,6 +77,9 @@ jvmtiError ArtJvmtiEventCallbacks::Set(jint index, jvmtiExtensionEvent cb) {
     case static_cast<jint>(ArtJvmtiEvent::kDdmPublishChunk):
       DdmPublishChunk = reinterpret_cast<ArtJvmtiEventDdmPublishChunk>(cb);
       return OK;
+    case static_cast<jint>(ArtJvmtiEvent::kSampledObjectAlloc):
+      SampledObjectAlloc = reinterpret_cast<ArtJvmtiEventSampledObjectAlloc>(cb);
+      return OK;
     default:
       return ERR(ILLEGAL_ARGUMENT);
   }
@@ -92,6 +95,7 @@ bool IsExtensionEvent(jint e) {
 bool IsExtensionEvent(ArtJvmtiEvent e) {
   switch (e) {
     case ArtJvmtiEvent::kDdmPublishChunk:
+    case ArtJvmtiEvent::kSampledObjectAlloc:
       return true;
     default:
       return false;
@@ -316,6 +320,29 @@ class JvmtiAllocationListener : public art::gc::AllocationListener {
     }
   }
 
+  void ObjectSampled(art::Thread* self, art::ObjPtr<art::mirror::Object>* obj, size_t byte_count)
+      OVERRIDE REQUIRES_SHARED(art::Locks::mutator_lock_) {
+    DCHECK_EQ(self, art::Thread::Current());
+
+    if (handler_->IsEventEnabledAnywhere(ArtJvmtiEvent::kSampledObjectAlloc)) {
+      art::StackHandleScope<1> hs(self);
+      auto h = hs.NewHandleWrapper(obj);
+      // The parameters are the same as for jvmtiEventVMObjectAlloc.
+      art::JNIEnvExt* jni_env = self->GetJniEnv();
+      ScopedLocalRef<jobject> object(
+          jni_env, jni_env->AddLocalReference<jobject>(*obj));
+      ScopedLocalRef<jclass> klass(
+          jni_env, jni_env->AddLocalReference<jclass>(obj->Ptr()->GetClass()));
+
+      RunEventCallback<ArtJvmtiEvent::kSampledObjectAlloc>(handler_,
+                                                           self,
+                                                           jni_env,
+                                                           object.get(),
+                                                           klass.get(),
+                                                           static_cast<jlong>(byte_count));
+    }
+  }
+
  private:
   EventHandler* handler_;
 };
@@ -886,11 +913,13 @@ static bool EventNeedsFullDeopt(ArtJvmtiEvent event) {
     case ArtJvmtiEvent::kBreakpoint:
     case ArtJvmtiEvent::kException:
       return false;
+    // The method events are deoptimized for each env, see HandleMethodEventsChanged.
+    case ArtJvmtiEvent::kMethodEntry:
+    case ArtJvmtiEvent::kMethodExit:
+      return false;
     // TODO We should support more of these or at least do something to make them discriminate by
     // thread.
-    case ArtJvmtiEvent::kMethodEntry:
     case ArtJvmtiEvent::kExceptionCatch:
-    case ArtJvmtiEvent::kMethodExit:
     case ArtJvmtiEvent::kFieldModification:
     case ArtJvmtiEvent::kFieldAccess:
     case ArtJvmtiEvent::kSingleStep:
@@ -1008,7 +1037,13 @@ void EventHandler::HandleEventType(ArtJvmtiEvent event, bool enable) {
       SetupDdmTracking(ddm_listener_.get(), enable);
       return;
     case ArtJvmtiEvent::kVmObjectAlloc:
-      SetupObjectAllocationTracking(alloc_listener_.get(), enable);
+    case ArtJvmtiEvent::kSampledObjectAlloc:
+      // Both events share the allocation listener.
+      if (!IsEventEnabledAnywhere(event == ArtJvmtiEvent::kVmObjectAlloc
+                                      ? ArtJvmtiEvent::kSampledObjectAlloc
+                                      : ArtJvmtiEvent::kVmObjectAlloc)) {
+        SetupObjectAllocationTracking(alloc_listener_.get(), enable);
+      }
       return;
 
     case ArtJvmtiEvent::kGarbageCollectionStart:
@@ -1136,12 +1171,15 @@ jvmtiError EventHandler::SetEvent(ArtJvmTiEnv* env,
 
   bool old_state;
   bool new_state;
+  bool old_method_events = false;
+  bool new_method_events = false;
 
   {
     // Change the event masks atomically.
     art::Thread* self = art::Thread::Current();
     art::WriterMutexLock mu(self, envs_lock_);
     art::WriterMutexLock mu_env_info(self, env->event_info_mutex_);
+    old_method_events = HasMethodEvents(env);
     old_state = global_mask.Test(event);
     if (mode == JVMTI_ENABLE) {
       env->event_masks.EnableEvent(env, thread, event);
@@ -1154,16 +1192,95 @@ jvmtiError EventHandler::SetEvent(ArtJvmTiEnv* env,
       RecalculateGlobalEventMaskLocked(event);
       new_state = global_mask.Test(event);
     }
+    new_method_events = HasMethodEvents(env);
   }
 
+  // Release the deoptimization of the method events before the listener goes away, and request it
+  // after the listener is added.
+  if (old_method_events && !new_method_events) {
+    HandleMethodEventsChanged(env, /* enabled */ false);
+  }
   // Handle any special work required for the event type.
   if (new_state != old_state) {
     HandleEventType(event, mode == JVMTI_ENABLE);
   }
+  if (!old_method_events && new_method_events) {
+    HandleMethodEventsChanged(env, /* enabled */ true);
+  }
 
   return ERR(NONE);
 }
 
+bool EventHandler::HasMethodEvents(ArtJvmTiEnv* env) {
+  return env->event_masks.IsEnabledAnywhere(ArtJvmtiEvent::kMethodEntry) ||
+      env->event_masks.IsEnabledAnywhere(ArtJvmtiEvent::kMethodExit);
+}
+
+bool EventHandler::IsInMethodEventFilter(ArtJvmTiEnv* env, art::Thread* self, jmethodID method) {
+  env->event_info_mutex_.AssertSharedHeld(self);
+  if (!env->has_method_event_filter) {
+    return true;
+  }
+  auto it = env->method_event_filter.find(art::jni::DecodeArtMethod(method));
+  if (it == env->method_event_filter.end()) {
+    return false;
+  }
+  art::Locks::mutator_lock_->AssertSharedHeld(self);
+  return !self->IsJWeakCleared(it->second);
+}
+
+// An env without a method event filter needs everything to be interpreted to see all the method
+// entries and exits. Otherwise only the methods of its filter are deoptimized, like for
+// breakpoints, and the rest stays compiled.
+void EventHandler::HandleMethodEventsChanged(ArtJvmTiEnv* env, bool enabled) {
+  art::Thread* self = art::Thread::Current();
+  art::ScopedObjectAccess soa(self);
+  std::vector<art::ArtMethod*> methods;
+  std::vector<jweak> unloaded_methods;
+  bool deoptimize_all;
+  {
+    art::WriterMutexLock mu(self, env->event_info_mutex_);
+    if (enabled) {
+      env->method_events_deoptimized_all = !env->has_method_event_filter;
+    }
+    deoptimize_all = env->method_events_deoptimized_all;
+    // Drop the unloaded methods, their memory may be reused. If they were deoptimized, the request
+    // is left behind like the breakpoints of unloaded methods.
+    for (auto it = env->method_event_filter.begin(); it != env->method_event_filter.end(); ) {
+      if (self->IsJWeakCleared(it->second)) {
+        unloaded_methods.push_back(it->second);
+        it = env->method_event_filter.erase(it);
+      } else {
+        methods.push_back(it->first);
+        ++it;
+      }
+    }
+  }
+  for (jweak weak : unloaded_methods) {
+    env->art_vm->DeleteWeakGlobalRef(self, weak);
+  }
+  DeoptManager* deopt_manager = DeoptManager::Get();
+  if (enabled) {
+    deopt_manager->AddDeoptimizationRequester();
+    if (deoptimize_all) {
+      deopt_manager->AddDeoptimizeAllMethods();
+    } else {
+      for (art::ArtMethod* method : methods) {
+        deopt_manager->AddMethodBreakpoint(method);
+      }
+    }
+  } else {
+    if (deoptimize_all) {
+      deopt_manager->RemoveDeoptimizeAllMethods();
+    } else {
+      for (art::ArtMethod* method : methods) {
+        deopt_manager->RemoveMethodBreakpoint(method);
+      }
+    }
+    deopt_manager->RemoveDeoptimizationRequester();
+  }
+}
+
 void EventHandler::HandleBreakpointEventsChanged(bool added) {
   if (added) {
     DeoptManager::Get()->AddDeoptimizationRequester();
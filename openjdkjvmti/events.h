@@ -73,7 +73,8 @@ enum class ArtJvmtiEvent : jint {
     kVmObjectAlloc = JVMTI_EVENT_VM_OBJECT_ALLOC,
     kClassFileLoadHookRetransformable = JVMTI_MAX_EVENT_TYPE_VAL + 1,
     kDdmPublishChunk = JVMTI_MAX_EVENT_TYPE_VAL + 2,
-    kMaxEventTypeVal = kDdmPublishChunk,
+    kSampledObjectAlloc = JVMTI_MAX_EVENT_TYPE_VAL + 3,
+    kMaxEventTypeVal = kSampledObjectAlloc,
 };
 
 using ArtJvmtiEventDdmPublishChunk = void (*)(jvmtiEnv *jvmti_env,
@@ -82,8 +83,15 @@ using ArtJvmtiEventDdmPublishChunk = void (*)(jvmtiEnv *jvmti_env,
                                               jint data_len,
                                               const jbyte* data);
 
+using ArtJvmtiEventSampledObjectAlloc = void (*)(jvmtiEnv *jvmti_env,
+                                                 JNIEnv* jni_env,
+                                                 jthread thread,
+                                                 jobject object,
+                                                 jclass object_klass,
+                                                 jlong size);
+
 struct ArtJvmtiEventCallbacks : jvmtiEventCallbacks {
-  ArtJvmtiEventCallbacks() : DdmPublishChunk(nullptr) {
+  ArtJvmtiEventCallbacks() : DdmPublishChunk(nullptr), SampledObjectAlloc(nullptr) {
     memset(this, 0, sizeof(jvmtiEventCallbacks));
   }
 
@@ -94,6 +102,7 @@ struct ArtJvmtiEventCallbacks : jvmtiEventCallbacks {
   jvmtiError Set(jint index, jvmtiExtensionEvent cb);
 
   ArtJvmtiEventDdmPublishChunk DdmPublishChunk;
+  ArtJvmtiEventSampledObjectAlloc SampledObjectAlloc;
 };
 
 bool IsExtensionEvent(jint e);
@@ -202,6 +211,15 @@ class EventHandler {
                       jvmtiEventMode mode)
       REQUIRES(!envs_lock_);
 
+  // Whether the env has the MethodEntry or MethodExit event enabled, globally or for any thread.
+  // The event info mutex of the env must be held.
+  static bool HasMethodEvents(ArtJvmTiEnv* env);
+
+  // Whether the method events of the env are sent for the method. The filter entry of an unloaded
+  // method never matches, not even the method allocated at the same address next. The event info
+  // mutex of the env and the mutator lock must be held.
+  static bool IsInMethodEventFilter(ArtJvmTiEnv* env, art::Thread* self, jmethodID method);
+
   // Dispatch event to all registered environments. Since this one doesn't have a JNIEnv* it doesn't
   // matter if it has the mutator_lock.
   template <ArtJvmtiEvent kEvent, typename ...Args>
@@ -301,6 +319,10 @@ class EventHandler {
   void HandleEventType(ArtJvmtiEvent event, bool enable);
   void HandleLocalAccessCapabilityAdded();
   void HandleBreakpointEventsChanged(bool enable);
+  // Deoptimize what the method events of the env need, when the env enables its first method event
+  // or disables its last one.
+  void HandleMethodEventsChanged(ArtJvmTiEnv* env, bool enabled)
+      REQUIRES(!art::Locks::mutator_lock_);
 
   bool OtherMonitorEventsEnabledAnywhere(ArtJvmtiEvent event);
 
@@ -170,6 +170,7 @@ bool JvmtiWeakTable<T>::SetLocked(art::Thread* self, art::mirror::Object* obj, T
   }
 
   // New element.
+  AddToFilter(obj);
   auto insert_it = tagged_objects_.emplace(art::GcRoot<art::mirror::Object>(obj), new_tag);
   DCHECK(insert_it.second);
   return false;
@@ -210,6 +211,13 @@ void JvmtiWeakTable<T>::SweepImpl(art::IsMarkedVisitor* visitor) {
 template <typename T>
 template <typename Updater, typename JvmtiWeakTable<T>::TableUpdateNullTarget kTargetNull>
 ALWAYS_INLINE inline void JvmtiWeakTable<T>::UpdateTableWith(Updater& updater) {
+  // The keys change, rebuild the filter. The lock-free readers take the lock meanwhile.
+  filter_sequence_.fetch_add(1u, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (std::atomic<uint64_t>& word : filter_) {
+    word.store(0u, std::memory_order_relaxed);
+  }
+
   // We optimistically hope that elements will still be well-distributed when re-inserting them.
   // So play with the map mechanics, and postpone rehashing. This avoids the need of a side
   // vector and two passes.
@@ -242,6 +250,11 @@ ALWAYS_INLINE inline void JvmtiWeakTable<T>::UpdateTableWith(Updater& updater) {
 
   tagged_objects_.max_load_factor(original_max_load_factor);
   // TODO: consider rehash here.
+
+  for (const auto& entry : tagged_objects_) {
+    AddToFilter(entry.first.template Read<art::kWithoutReadBarrier>());
+  }
+  filter_sequence_.fetch_add(1u, std::memory_order_release);
 }
 
 template <typename T>
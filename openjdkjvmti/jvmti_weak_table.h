@@ -32,6 +32,7 @@
 #ifndef ART_OPENJDKJVMTI_JVMTI_WEAK_TABLE_H_
 #define ART_OPENJDKJVMTI_JVMTI_WEAK_TABLE_H_
 
+#include <atomic>
 #include <unordered_map>
 
 #include "base/macros.h"
@@ -55,7 +56,11 @@ class JvmtiWeakTable : public art::gc::SystemWeakHolder {
  public:
   JvmtiWeakTable()
       : art::gc::SystemWeakHolder(art::kTaggingLockLevel),
-        update_since_last_sweep_(false) {
+        update_since_last_sweep_(false),
+        filter_sequence_(0u) {
+    for (std::atomic<uint64_t>& word : filter_) {
+      word.store(0u, std::memory_order_relaxed);
+    }
   }
 
   // Remove the mapping for the given object, returning whether such a mapping existed (and the old
@@ -82,6 +87,10 @@ class JvmtiWeakTable : public art::gc::SystemWeakHolder {
       REQUIRES_SHARED(art::Locks::mutator_lock_)
       REQUIRES(!allow_disallow_lock_) {
     art::Thread* self = art::Thread::Current();
+    // Most lookups are for untagged objects, answer them without the lock.
+    if (!MayBeTagged(self, obj)) {
+      return false;
+    }
     art::MutexLock mu(self, allow_disallow_lock_);
     Wait(self);
 
@@ -192,6 +201,43 @@ class JvmtiWeakTable : public art::gc::SystemWeakHolder {
       REQUIRES_SHARED(art::Locks::mutator_lock_)
       REQUIRES(allow_disallow_lock_);
 
+  // The filter is a bitmap over the hashes of the addresses of the objects in the table. It may
+  // have bits for objects that are not in the table anymore, but never misses one that is, except
+  // while the table is rebuilt by UpdateTableWith, which makes `filter_sequence_` odd.
+  static constexpr size_t kFilterWords = 1024;
+  static constexpr size_t kFilterBits = kFilterWords * 64;
+
+  static size_t FilterBit(art::mirror::Object* obj) {
+    static_assert((kFilterBits & (kFilterBits - 1)) == 0, "Filter size must be a power of two");
+    uint64_t hash = (reinterpret_cast<uintptr_t>(obj) >> art::kObjectAlignmentShift) *
+                    UINT64_C(0x9e3779b97f4a7c15);
+    return static_cast<size_t>(hash >> 48);
+  }
+
+  void AddToFilter(art::mirror::Object* obj) REQUIRES(allow_disallow_lock_) {
+    size_t bit = FilterBit(obj);
+    filter_[bit / 64].fetch_or(UINT64_C(1) << (bit % 64), std::memory_order_relaxed);
+  }
+
+  // Lock-free check of the filter. Returns true if `obj` may have a tag, including whenever the
+  // table may still hold from-space references.
+  bool MayBeTagged(art::Thread* self, art::mirror::Object* obj) const {
+    if (art::kUseReadBarrier && self != nullptr && self->GetIsGcMarking()) {
+      return true;
+    }
+    uint32_t sequence = filter_sequence_.load(std::memory_order_acquire);
+    if ((sequence & 1u) != 0u) {
+      return true;
+    }
+    size_t bit = FilterBit(obj);
+    uint64_t word = filter_[bit / 64].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (filter_sequence_.load(std::memory_order_relaxed) != sequence) {
+      return true;
+    }
+    return (word & (UINT64_C(1) << (bit % 64))) != 0u;
+  }
+
   template <typename Storage, class Allocator = JvmtiAllocator<T>>
   struct ReleasableContainer;
 
@@ -220,6 +266,9 @@ class JvmtiWeakTable : public art::gc::SystemWeakHolder {
       GUARDED_BY(art::Locks::mutator_lock_);
   // To avoid repeatedly scanning the whole table, remember if we did that since the last sweep.
   bool update_since_last_sweep_;
+
+  std::atomic<uint64_t> filter_[kFilterWords];
+  std::atomic<uint32_t> filter_sequence_;
 };
 
 }  // namespace openjdkjvmti
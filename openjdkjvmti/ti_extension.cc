@@ -39,6 +39,8 @@
 #include "ti_class.h"
 #include "ti_ddms.h"
 #include "ti_heap.h"
+#include "ti_method.h"
+#include "ti_monitor.h"
 #include "thread-inl.h"
 
 namespace openjdkjvmti {
@@ -191,6 +193,81 @@ jvmtiError ExtensionUtil::GetExtensionFunctions(jvmtiEnv* env,
     return error;
   }
 
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(HeapExtensions::IterateThroughHeapParallel),
+      "com.android.art.heap.iterate_through_heap_parallel",
+      "Iterate through a heap, reporting the objects from up to num_threads threads. This is"
+      " equivalent to com.android.art.heap.iterate_through_heap_ext, except that the callback"
+      " runs concurrently on threads that are not attached to the runtime, in no particular"
+      " order, and must not call JNI or JVMTI functions. The tags set by the callback are"
+      " applied when all objects have been reported. Only the heap_iteration_callback is"
+      " supported, the other callbacks must be null.",
+      {
+          { "heap_filter", JVMTI_KIND_IN, JVMTI_TYPE_JINT, false},
+          { "klass", JVMTI_KIND_IN, JVMTI_TYPE_JCLASS, true},
+          { "callbacks", JVMTI_KIND_IN_PTR, JVMTI_TYPE_CVOID, false},
+          { "user_data", JVMTI_KIND_IN_PTR, JVMTI_TYPE_CVOID, true},
+          { "num_threads", JVMTI_KIND_IN, JVMTI_TYPE_JINT, false}
+      },
+      {
+          ERR(MUST_POSSESS_CAPABILITY),
+          ERR(INVALID_CLASS),
+          ERR(NULL_POINTER),
+          ERR(ILLEGAL_ARGUMENT),
+      });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(HeapExtensions::SetHeapSamplingInterval),
+      "com.android.art.heap.set_heap_sampling_interval",
+      "Sets the mean number of bytes allocated by a thread between two allocations reported by"
+      " the com.android.art.heap.sampled_object_alloc event. The intervals are random, so that"
+      " the samples follow a Poisson process over the allocated bytes. A sampling_interval of 0"
+      " reports every allocation. The interval is global and also applies to the allocation"
+      " tracking of DDMS.",
+      {
+          { "sampling_interval", JVMTI_KIND_IN, JVMTI_TYPE_JINT, false},
+      },
+      { ERR(ILLEGAL_ARGUMENT) });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(MonitorUtil::SetContentionProfiling),
+      "com.android.art.monitor.set_contention_profiling",
+      "Starts or stops collecting the contention statistics of the inflated monitors, by the"
+      " place where the owner acquired the contended lock. While enabled, the wait times are"
+      " also exported as ATrace counters.",
+      {
+          { "enable", JVMTI_KIND_IN, JVMTI_TYPE_JBOOLEAN, false},
+      },
+      { });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(MonitorUtil::GetContentionProfile),
+      "com.android.art.monitor.get_contention_profile",
+      "Returns the contention statistics of the inflated monitors, clearing them if 'reset'."
+      " Each of the site_count_out sites is described by 6 jlongs of sites_out: the jmethodID"
+      " and the jlocation where the owner acquired the lock (0 if unknown), the number of"
+      " contended acquisitions, their total and maximum wait times in nanoseconds, and the"
+      " highest number of threads waiting at once. The sites are sorted by decreasing total"
+      " wait time. The sites_out buffer must be deallocated by the caller.",
+      {
+          { "reset", JVMTI_KIND_IN, JVMTI_TYPE_JBOOLEAN, false},
+          { "site_count_out", JVMTI_KIND_OUT, JVMTI_TYPE_JINT, false},
+          { "sites_out", JVMTI_KIND_ALLOC_BUF, JVMTI_TYPE_JLONG, false},
+      },
+      { ERR(NULL_POINTER), ERR(OUT_OF_MEMORY) });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
   error = add_extension(
       reinterpret_cast<jvmtiExtensionFunction>(AllocUtil::GetGlobalJvmtiAllocationState),
       "com.android.art.alloc.get_global_jvmti_allocation_state",
@@ -227,6 +304,30 @@ jvmtiError ExtensionUtil::GetExtensionFunctions(jvmtiEnv* env,
     return error;
   }
 
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(MethodUtil::SetMethodEventFilter),
+      "com.android.art.method.set_method_event_filter",
+      "Restricts the MethodEntry and MethodExit events of this environment to the given methods."
+      " Only these methods are deoptimized when the events are enabled, the rest of the code keeps"
+      " running compiled. A method_count of 0 removes the filter, and the events then deoptimize"
+      " all methods. The filter can only be changed while neither event is enabled for this"
+      " environment. Methods redefined by this environment or unloaded are removed from the"
+      " filter. Native methods are not supported.",
+      {
+        { "method_count", JVMTI_KIND_IN, JVMTI_TYPE_JINT, false },
+        { "methods", JVMTI_KIND_IN_BUF, JVMTI_TYPE_JMETHODID, true },
+      },
+      {
+        ERR(MUST_POSSESS_CAPABILITY),
+        ERR(NULL_POINTER),
+        ERR(ILLEGAL_ARGUMENT),
+        ERR(INVALID_METHODID),
+        ERR(NATIVE_METHOD),
+      });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
   // GetClassLoaderClassDescriptors extension
   error = add_extension(
       reinterpret_cast<jvmtiExtensionFunction>(ClassUtil::GetClassLoaderClassDescriptors),
@@ -357,6 +458,23 @@ jvmtiError ExtensionUtil::GetExtensionEvents(jvmtiEnv* env,
   if (error != OK) {
     return error;
   }
+  error = add_extension(
+      ArtJvmtiEvent::kSampledObjectAlloc,
+      "com.android.art.heap.sampled_object_alloc",
+      "Called for the allocations sampled at the interval given to"
+      " com.android.art.heap.set_heap_sampling_interval, with the same parameters as the"
+      " VMObjectAlloc event. The agent can get the stack trace of the allocation with"
+      " GetStackTrace on 'thread'.",
+      {
+        { "jni_env", JVMTI_KIND_IN_PTR, JVMTI_TYPE_JNIENV, false },
+        { "thread", JVMTI_KIND_IN, JVMTI_TYPE_JTHREAD, false },
+        { "object", JVMTI_KIND_IN, JVMTI_TYPE_JOBJECT, false },
+        { "klass", JVMTI_KIND_IN, JVMTI_TYPE_JCLASS, false },
+        { "size", JVMTI_KIND_IN, JVMTI_TYPE_JLONG, false },
+      });
+  if (error != OK) {
+    return error;
+  }
 
   // Copy into output buffer.
 
@@ -16,6 +16,10 @@
 
 #include "ti_heap.h"
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "art_field-inl.h"
 #include "art_jvmti.h"
 #include "base/macros.h"
@@ -24,6 +28,7 @@
 #include "dex/primitive.h"
 #include "gc/heap-visit-objects-inl.h"
 #include "gc/heap.h"
+#include "gc/scoped_gc_critical_section.h"
 #include "gc_root-inl.h"
 #include "java_frame_root_info.h"
 #include "jni_env_ext.h"
@@ -1519,4 +1524,126 @@ jvmtiError HeapExtensions::IterateThroughHeapExt(jvmtiEnv* env,
                               user_data);
 }
 
+jvmtiError HeapExtensions::IterateThroughHeapParallel(jvmtiEnv* env,
+                                                      jint heap_filter_int,
+                                                      jclass klass,
+                                                      const jvmtiHeapCallbacks* callbacks,
+                                                      const void* user_data,
+                                                      jint num_threads) {
+  if (ArtJvmTiEnv::AsArtJvmTiEnv(env)->capabilities.can_tag_objects != 1) {
+    return ERR(MUST_POSSESS_CAPABILITY);
+  }
+  if (callbacks == nullptr) {
+    return ERR(NULL_POINTER);
+  }
+  // Only the iteration callback can run outside of the heap walk, the other callbacks need to
+  // read the objects.
+  if (num_threads < 1 ||
+      callbacks->heap_iteration_callback == nullptr ||
+      callbacks->string_primitive_value_callback != nullptr ||
+      callbacks->array_primitive_value_callback != nullptr ||
+      callbacks->primitive_field_callback != nullptr) {
+    return ERR(ILLEGAL_ARGUMENT);
+  }
+
+  struct Item {
+    art::mirror::Object* obj;
+    jlong tag;
+    jlong class_tag;
+    jlong size;
+    jint length;
+    jint heap_id;
+  };
+  std::vector<Item> items;
+
+  art::Thread* self = art::Thread::Current();
+  ObjectTagTable* tag_table = ArtJvmTiEnv::AsArtJvmTiEnv(env)->object_tag_table.get();
+  // The objects must not move or die between the walk and the tag updates.
+  art::gc::ScopedGCCriticalSection gcs(self,
+                                       art::gc::kGcCauseDebugger,
+                                       art::gc::kCollectorTypeDebugger);
+  art::ScopedObjectAccess soa(self);
+
+  // Collect the reported objects with their tags on this thread, the callbacks run on the
+  // workers without touching the heap.
+  const HeapFilter heap_filter(heap_filter_int);
+  art::ObjPtr<art::mirror::Class> filter_klass = soa.Decode<art::mirror::Class>(klass);
+  auto visitor = [&](art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
+    art::ScopedAssertNoThreadSuspension no_suspension("IterateThroughHeapParallel");
+    art::ObjPtr<art::mirror::Class> obj_klass = obj->GetClass();
+    if (filter_klass != nullptr && filter_klass != obj_klass) {
+      return;
+    }
+    jlong tag = 0;
+    tag_table->GetTag(obj, &tag);
+    jlong class_tag = 0;
+    tag_table->GetTag(obj_klass.Ptr(), &class_tag);
+    if (!heap_filter.ShouldReportByHeapFilter(tag, class_tag)) {
+      return;
+    }
+    jint length = obj->IsArrayInstance() ? obj->AsArray()->GetLength() : -1;
+    items.push_back(Item { obj, tag, class_tag, obj->SizeOf(), length, GetHeapId(obj) });
+  };
+  art::Runtime::Current()->GetHeap()->VisitObjects(visitor);
+
+  // Each worker reports a contiguous range of the objects, and records the indices of the tags
+  // changed by the callback, to apply them under the table lock once all workers are done.
+  using ArtExtensionAPI = jint (*)(jlong, jlong, jlong*, jint length, void*, jint);
+  ArtExtensionAPI callback = reinterpret_cast<ArtExtensionAPI>(callbacks->heap_iteration_callback);
+  size_t worker_count = std::min<size_t>(static_cast<size_t>(num_threads),
+                                         std::max<size_t>(items.size(), 1u));
+  size_t chunk_size = (items.size() + worker_count - 1) / worker_count;
+  std::vector<std::vector<size_t>> changed_tags(worker_count);
+  std::atomic<bool> stop_reports(false);
+  auto report_range = [&](size_t worker) {
+    size_t end = std::min(items.size(), (worker + 1) * chunk_size);
+    for (size_t i = worker * chunk_size; i < end; ++i) {
+      if (stop_reports.load(std::memory_order_relaxed)) {
+        return;
+      }
+      Item& item = items[i];
+      jlong saved_tag = item.tag;
+      jint ret = callback(item.class_tag,
+                          item.size,
+                          &item.tag,
+                          item.length,
+                          const_cast<void*>(user_data),
+                          item.heap_id);
+      if (item.tag != saved_tag) {
+        changed_tags[worker].push_back(i);
+      }
+      if ((ret & JVMTI_VISIT_ABORT) != 0) {
+        stop_reports.store(true, std::memory_order_relaxed);
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  for (size_t worker = 1; worker < worker_count; ++worker) {
+    workers.emplace_back(report_range, worker);
+  }
+  report_range(0u);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  tag_table->Lock();
+  for (const std::vector<size_t>& indices : changed_tags) {
+    for (size_t i : indices) {
+      tag_table->SetLocked(items[i].obj, items[i].tag);
+    }
+  }
+  tag_table->Unlock();
+  return ERR(NONE);
+}
+
+jvmtiError HeapExtensions::SetHeapSamplingInterval(jvmtiEnv* env ATTRIBUTE_UNUSED,
+                                                   jint sampling_interval) {
+  if (sampling_interval < 0) {
+    return ERR(ILLEGAL_ARGUMENT);
+  }
+  art::Runtime::Current()->GetHeap()->SetAllocSamplingInterval(
+      static_cast<size_t>(sampling_interval));
+  return ERR(NONE);
+}
+
 }  // namespace openjdkjvmti
@@ -66,6 +66,15 @@ class HeapExtensions {
                                                   jclass klass,
                                                   const jvmtiHeapCallbacks* callbacks,
                                                   const void* user_data);
+
+  static jvmtiError JNICALL IterateThroughHeapParallel(jvmtiEnv* env,
+                                                       jint heap_filter,
+                                                       jclass klass,
+                                                       const jvmtiHeapCallbacks* callbacks,
+                                                       const void* user_data,
+                                                       jint num_threads);
+
+  static jvmtiError JNICALL SetHeapSamplingInterval(jvmtiEnv* env, jint sampling_interval);
 };
 
 }  // namespace openjdkjvmti
@@ -32,6 +32,8 @@
 #include "ti_method.h"
 
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #include "art_jvmti.h"
 #include "art_method-inl.h"
@@ -307,6 +309,102 @@ jvmtiError MethodUtil::GetMaxLocals(jvmtiEnv* env ATTRIBUTE_UNUSED,
   return ERR(NONE);
 }
 
+jvmtiError MethodUtil::SetMethodEventFilter(jvmtiEnv* env,
+                                            jint method_count,
+                                            const jmethodID* methods) {
+  ArtJvmTiEnv* art_env = ArtJvmTiEnv::AsArtJvmTiEnv(env);
+  if (art_env->capabilities.can_generate_method_entry_events != 1 &&
+      art_env->capabilities.can_generate_method_exit_events != 1) {
+    return ERR(MUST_POSSESS_CAPABILITY);
+  }
+  if (method_count < 0) {
+    return ERR(ILLEGAL_ARGUMENT);
+  }
+  if (method_count > 0 && methods == nullptr) {
+    return ERR(NULL_POINTER);
+  }
+
+  art::Thread* self = art::Thread::Current();
+  art::ScopedObjectAccess soa(self);
+  std::unordered_map<art::ArtMethod*, jweak> filter;
+  jvmtiError error = ERR(NONE);
+  for (jint i = 0; i != method_count; ++i) {
+    if (methods[i] == nullptr) {
+      error = ERR(INVALID_METHODID);
+      break;
+    }
+    art::ArtMethod* art_method = art::jni::DecodeArtMethod(methods[i]);
+    if (art_method->IsNative()) {
+      error = ERR(NATIVE_METHOD);
+      break;
+    }
+    if (!art_method->IsInvokable() || art_method->IsProxyMethod()) {
+      error = ERR(ILLEGAL_ARGUMENT);
+      break;
+    }
+    if (filter.find(art_method) == filter.end()) {
+      filter.emplace(art_method,
+                     art_env->art_vm->AddWeakGlobalRef(self, art_method->GetDeclaringClass()));
+    }
+  }
+
+  if (error == ERR(NONE)) {
+    // The deoptimized methods are chosen when the events are enabled, so the filter cannot change
+    // while they are.
+    art::WriterMutexLock mu(self, art_env->event_info_mutex_);
+    if (EventHandler::HasMethodEvents(art_env)) {
+      error = ERR(ILLEGAL_ARGUMENT);
+    } else {
+      art_env->has_method_event_filter = (method_count != 0);
+      art_env->method_event_filter.swap(filter);
+    }
+  }
+  // Delete the weak globals of the old filter, or of the new one if it could not be set.
+  for (const auto& entry : filter) {
+    art_env->art_vm->DeleteWeakGlobalRef(self, entry.second);
+  }
+  return error;
+}
+
+void MethodUtil::RemoveMethodEventFilterInClass(ArtJvmTiEnv* env, art::mirror::Class* klass) {
+  art::Thread* self = art::Thread::Current();
+  std::vector<std::pair<art::ArtMethod*, jweak>> to_remove;
+  bool deoptimized;
+  {
+    art::WriterMutexLock lk(self, env->event_info_mutex_);
+    for (auto it = env->method_event_filter.begin(); it != env->method_event_filter.end(); ) {
+      // The declaring class of an unloaded method must not be read.
+      if (!self->IsJWeakCleared(it->second) && it->first->GetDeclaringClass() == klass) {
+        to_remove.push_back(*it);
+        it = env->method_event_filter.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    // The filtered methods are deoptimized while the method events are enabled.
+    deoptimized = EventHandler::HasMethodEvents(env) && !env->method_events_deoptimized_all;
+  }
+  DeoptManager* deopt = DeoptManager::Get();
+  for (const auto& entry : to_remove) {
+    env->art_vm->DeleteWeakGlobalRef(self, entry.second);
+    if (deoptimized) {
+      deopt->RemoveMethodBreakpoint(entry.first);
+    }
+  }
+}
+
+void MethodUtil::DeleteMethodEventFilter(ArtJvmTiEnv* env) {
+  art::Thread* self = art::Thread::Current();
+  std::unordered_map<art::ArtMethod*, jweak> filter;
+  {
+    art::WriterMutexLock mu(self, env->event_info_mutex_);
+    env->method_event_filter.swap(filter);
+  }
+  for (const auto& entry : filter) {
+    env->art_vm->DeleteWeakGlobalRef(self, entry.second);
+  }
+}
+
 jvmtiError MethodUtil::GetMethodName(jvmtiEnv* env,
                                      jmethodID method,
                                      char** name_ptr,
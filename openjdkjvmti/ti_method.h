@@ -32,12 +32,20 @@
 #ifndef ART_OPENJDKJVMTI_TI_METHOD_H_
 #define ART_OPENJDKJVMTI_TI_METHOD_H_
 
+#include "base/mutex.h"
 #include "dex/primitive.h"
 #include "jni.h"
 #include "jvmti.h"
 
+namespace art {
+namespace mirror {
+class Class;
+}  // namespace mirror
+}  // namespace art
+
 namespace openjdkjvmti {
 
+struct ArtJvmTiEnv;
 class EventHandler;
 
 class MethodUtil {
@@ -94,6 +102,16 @@ class MethodUtil {
 
   static jvmtiError GetLocalInstance(jvmtiEnv* env, jthread thread, jint depth, jobject* data);
 
+  // Extension to send the MethodEntry and MethodExit events only for the given methods.
+  static jvmtiError SetMethodEventFilter(jvmtiEnv* env,
+                                         jint method_count,
+                                         const jmethodID* methods);
+  // Used by class redefinition to remove the redefined methods from the method event filter.
+  static void RemoveMethodEventFilterInClass(ArtJvmTiEnv* env, art::mirror::Class* klass)
+      REQUIRES_SHARED(art::Locks::mutator_lock_);
+  // Deletes the method event filter of a disposed environment.
+  static void DeleteMethodEventFilter(ArtJvmTiEnv* env);
+
  private:
   static jvmtiError SetLocalVariableGeneric(jvmtiEnv* env,
                                             jthread thread,
@@ -38,7 +38,9 @@
 
 #include "art_jvmti.h"
 #include "gc_root-inl.h"
+#include "jni_internal.h"
 #include "monitor.h"
+#include "monitor_contention_profile.h"
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
@@ -416,4 +418,39 @@ jvmtiError MonitorUtil::GetCurrentContendedMonitor(jvmtiEnv* env ATTRIBUTE_UNUSE
   return OK;
 }
 
+jvmtiError MonitorUtil::SetContentionProfiling(jvmtiEnv* env ATTRIBUTE_UNUSED, jboolean enable) {
+  art::Runtime::Current()->GetMonitorContentionProfile()->SetEnabled(enable == JNI_TRUE);
+  return OK;
+}
+
+jvmtiError MonitorUtil::GetContentionProfile(jvmtiEnv* env,
+                                             jboolean reset,
+                                             jint* site_count_ptr,
+                                             jlong** sites_ptr) {
+  if (site_count_ptr == nullptr || sites_ptr == nullptr) {
+    return ERR(NULL_POINTER);
+  }
+  std::vector<art::MonitorContentionProfile::Site> sites =
+      art::Runtime::Current()->GetMonitorContentionProfile()->GetSites(reset == JNI_TRUE);
+  jvmtiError error = OK;
+  JvmtiUniquePtr<jlong[]> data =
+      AllocJvmtiUniquePtr<jlong[]>(env, sites.size() * kContentionSiteFields, &error);
+  if (error != OK) {
+    return error;
+  }
+  for (size_t i = 0; i != sites.size(); ++i) {
+    jlong* fields = data.get() + i * kContentionSiteFields;
+    fields[0] = static_cast<jlong>(reinterpret_cast<uintptr_t>(
+        art::jni::EncodeArtMethod(sites[i].owner_method)));
+    fields[1] = static_cast<jlong>(sites[i].owner_dex_pc);
+    fields[2] = static_cast<jlong>(sites[i].contentions);
+    fields[3] = static_cast<jlong>(sites[i].total_wait_ns);
+    fields[4] = static_cast<jlong>(sites[i].max_wait_ns);
+    fields[5] = static_cast<jlong>(sites[i].max_waiters);
+  }
+  *site_count_ptr = static_cast<jint>(sites.size());
+  *sites_ptr = data.release();
+  return OK;
+}
+
 }  // namespace openjdkjvmti
@@ -54,6 +54,17 @@ class MonitorUtil {
   static jvmtiError RawMonitorNotifyAll(jvmtiEnv* env, jrawMonitorID monitor);
 
   static jvmtiError GetCurrentContendedMonitor(jvmtiEnv* env, jthread thr, jobject* monitor);
+
+  // Number of jlongs describing a site of com.android.art.monitor.get_contention_profile.
+  static constexpr size_t kContentionSiteFields = 6u;
+
+  // Extension functions of the monitor contention profile.
+  static jvmtiError SetContentionProfiling(jvmtiEnv* env, jboolean enable);
+
+  static jvmtiError GetContentionProfile(jvmtiEnv* env,
+                                         jboolean reset,
+                                         jint* site_count_ptr,
+                                         jlong** sites_ptr);
 };
 
 }  // namespace openjdkjvmti
@@ -65,6 +65,7 @@
 
 namespace openjdkjvmti {
 
+struct CallbackCtx;
 class RedefinitionDataHolder;
 class RedefinitionDataIter;
 
@@ -152,7 +153,9 @@ class Redefiner {
         /*out*/RedefinitionDataIter* cur_data)
           REQUIRES_SHARED(art::Locks::mutator_lock_);
 
-    void FindAndAllocateObsoleteMethods(art::mirror::Class* art_klass)
+    // Adds the declared methods of `art_klass` to the methods that the stack walk of
+    // Redefiner::FindAndAllocateObsoleteMethods makes obsolete.
+    void CollectObsoleteMethods(art::mirror::Class* art_klass, CallbackCtx* ctx)
         REQUIRES(art::Locks::mutator_lock_);
 
     // Checks that the dex file contains only the single expected class and that the top-level class
@@ -251,6 +254,10 @@ class Redefiner {
       REQUIRES_SHARED(art::Locks::mutator_lock_);
   void ReleaseAllDexFiles() REQUIRES_SHARED(art::Locks::mutator_lock_);
   void UnregisterAllBreakpoints() REQUIRES_SHARED(art::Locks::mutator_lock_);
+  // Allocates the obsolete methods of all the redefined classes running on a thread stack, and
+  // updates the stack frames to use them.
+  void FindAndAllocateObsoleteMethods(RedefinitionDataHolder& holder)
+      REQUIRES(art::Locks::mutator_lock_);
   // Restores the old obsolete methods maps if it turns out they weren't needed (ie there were no
   // new obsolete methods).
   void RestoreObsoleteMethodMapsIfUnneeded(RedefinitionDataHolder& holder)
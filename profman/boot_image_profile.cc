@@ -14,8 +14,10 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
-#include <set>
+#include <thread>
 
 #include "boot_image_profile.h"
 #include "dex/dex_file-inl.h"
@@ -27,19 +29,77 @@ namespace art {
 
 using Hotness = ProfileCompilationInfo::MethodHotness;
 
-void GenerateBootImageProfile(
-    const std::vector<std::unique_ptr<const DexFile>>& dex_files,
-    const std::vector<std::unique_ptr<const ProfileCompilationInfo>>& profiles,
-    const BootImageOptions& options,
-    bool verbose,
-    ProfileCompilationInfo* out_profile) {
-  for (const std::unique_ptr<const ProfileCompilationInfo>& profile : profiles) {
+namespace {
+
+// The number of input profiles using each class and method of the dex files, and the union of
+// the methods of the profiles. The profiles can be counted separately and the counts merged.
+class BootImageProfileCounts {
+ public:
+  explicit BootImageProfileCounts(const std::vector<std::unique_ptr<const DexFile>>& dex_files)
+      : dex_files_(dex_files),
+        method_counts_(dex_files.size()),
+        class_counts_(dex_files.size()) {
+    for (size_t i = 0; i != dex_files.size(); ++i) {
+      method_counts_[i].resize(dex_files[i]->NumMethodIds(), 0u);
+      class_counts_[i].resize(dex_files[i]->NumClassDefs(), 0u);
+    }
+  }
+
+  void AddProfile(const ProfileCompilationInfo& profile) {
     // Avoid merging classes since we may want to only add classes that fit a certain criteria.
     // If we merged the classes, every single class in each profile would be in the out_profile,
     // but we want to only included classes that are in at least a few profiles.
-    out_profile->MergeWith(*profile, /*merge_classes*/ false);
+    merged_profile_.MergeWith(profile, /*merge_classes*/ false);
+    for (size_t dex_index = 0; dex_index != dex_files_.size(); ++dex_index) {
+      const DexFile* dex_file = dex_files_[dex_index].get();
+      // Inferred classes are classes inferred from method samples.
+      std::vector<bool> inferred_classes(dex_file->NumTypeIds(), false);
+      for (size_t i = 0; i < dex_file->NumMethodIds(); ++i) {
+        MethodReference ref(dex_file, i);
+        if (profile.GetMethodHotness(ref).IsInProfile()) {
+          ++method_counts_[dex_index][i];
+          inferred_classes[ref.GetMethodId().class_idx_.index_] = true;
+        }
+      }
+      for (size_t i = 0; i < dex_file->NumClassDefs(); ++i) {
+        dex::TypeIndex type_index = dex_file->GetClassDef(i).class_idx_;
+        if (inferred_classes[type_index.index_] || profile.ContainsClass(*dex_file, type_index)) {
+          ++class_counts_[dex_index][i];
+        }
+      }
+    }
   }
 
+  void Merge(const BootImageProfileCounts& other) {
+    DCHECK_EQ(&dex_files_, &other.dex_files_);
+    merged_profile_.MergeWith(other.merged_profile_, /*merge_classes*/ false);
+    for (size_t dex_index = 0; dex_index != dex_files_.size(); ++dex_index) {
+      for (size_t i = 0; i != method_counts_[dex_index].size(); ++i) {
+        method_counts_[dex_index][i] += other.method_counts_[dex_index][i];
+      }
+      for (size_t i = 0; i != class_counts_[dex_index].size(); ++i) {
+        class_counts_[dex_index][i] += other.class_counts_[dex_index][i];
+      }
+    }
+  }
+
+  // Add the classes and methods that meet the options to the out_profile.
+  void Finish(const BootImageOptions& options, bool verbose, ProfileCompilationInfo* out_profile);
+
+ private:
+  const std::vector<std::unique_ptr<const DexFile>>& dex_files_;
+  std::vector<std::vector<uint32_t>> method_counts_;
+  std::vector<std::vector<uint32_t>> class_counts_;
+  // The union of the methods of the profiles, with all their hotness flags.
+  ProfileCompilationInfo merged_profile_;
+};
+
+void BootImageProfileCounts::Finish(const BootImageOptions& options,
+                                    bool verbose,
+                                    ProfileCompilationInfo* out_profile) {
+  // All the methods of the profiles, with their flags, are in the out_profile.
+  out_profile->MergeWith(merged_profile_, /*merge_classes*/ false);
+
   // Image classes that were added because they are commonly used.
   size_t class_count = 0;
   // Image classes that were only added because they were clean.
@@ -49,34 +109,22 @@ void GenerateBootImageProfile(
   // Total dirty classes.
   size_t dirty_count = 0;
 
-  for (const std::unique_ptr<const DexFile>& dex_file : dex_files) {
-    // Inferred classes are classes inferred from method samples.
-    std::set<std::pair<const ProfileCompilationInfo*, dex::TypeIndex>> inferred_classes;
+  for (size_t dex_index = 0; dex_index != dex_files_.size(); ++dex_index) {
+    const DexFile* dex_file = dex_files_[dex_index].get();
     for (size_t i = 0; i < dex_file->NumMethodIds(); ++i) {
-      MethodReference ref(dex_file.get(), i);
-      // This counter is how many profiles contain the method as sampled or hot.
-      size_t counter = 0;
-      for (const std::unique_ptr<const ProfileCompilationInfo>& profile : profiles) {
-        Hotness hotness = profile->GetMethodHotness(ref);
-        if (hotness.IsInProfile()) {
-          ++counter;
-          out_profile->AddMethodHotness(ref, hotness);
-          inferred_classes.emplace(profile.get(), ref.GetMethodId().class_idx_);
-        }
-      }
       // If the counter is greater or equal to the compile threshold, mark the method as hot.
       // Note that all hot methods are also marked as hot in the out profile during the merging
       // process.
-      if (counter >= options.compiled_method_threshold) {
+      if (method_counts_[dex_index][i] >= options.compiled_method_threshold) {
         Hotness hotness;
         hotness.AddFlag(Hotness::kFlagHot);
-        out_profile->AddMethodHotness(ref, hotness);
+        out_profile->AddMethodHotness(MethodReference(dex_file, i), hotness);
       }
     }
     // Walk all of the classes and add them to the profile if they meet the requirements.
     for (size_t i = 0; i < dex_file->NumClassDefs(); ++i) {
       const DexFile::ClassDef& class_def = dex_file->GetClassDef(i);
-      TypeReference ref(dex_file.get(), class_def.class_idx_);
+      TypeReference ref(dex_file, class_def.class_idx_);
       bool is_clean = true;
       const uint8_t* class_data = dex_file->GetClassData(class_def);
       if (class_data != nullptr) {
@@ -108,14 +156,7 @@ void GenerateBootImageProfile(
       }
       ++(is_clean ? clean_count : dirty_count);
       // This counter is how many profiles contain the class.
-      size_t counter = 0;
-      for (const std::unique_ptr<const ProfileCompilationInfo>& profile : profiles) {
-        auto it = inferred_classes.find(std::make_pair(profile.get(), ref.TypeIndex()));
-        if (it != inferred_classes.end() ||
-            profile->ContainsClass(*ref.dex_file, ref.TypeIndex())) {
-          ++counter;
-        }
-      }
+      const uint32_t counter = class_counts_[dex_index][i];
       if (counter == 0) {
         continue;
       }
@@ -135,4 +176,64 @@ void GenerateBootImageProfile(
   }
 }
 
+}  // namespace
+
+void GenerateBootImageProfile(
+    const std::vector<std::unique_ptr<const DexFile>>& dex_files,
+    const std::vector<std::unique_ptr<const ProfileCompilationInfo>>& profiles,
+    const BootImageOptions& options,
+    bool verbose,
+    ProfileCompilationInfo* out_profile) {
+  BootImageProfileCounts counts(dex_files);
+  for (const std::unique_ptr<const ProfileCompilationInfo>& profile : profiles) {
+    counts.AddProfile(*profile);
+  }
+  counts.Finish(options, verbose, out_profile);
+}
+
+bool GenerateBootImageProfile(
+    const std::vector<std::unique_ptr<const DexFile>>& dex_files,
+    size_t num_profiles,
+    const std::function<std::unique_ptr<const ProfileCompilationInfo>(size_t)>& load_profile,
+    size_t num_threads,
+    const BootImageOptions& options,
+    bool verbose,
+    ProfileCompilationInfo* out_profile) {
+  num_threads = std::max<size_t>(std::min(num_threads, num_profiles), 1u);
+  std::vector<std::unique_ptr<BootImageProfileCounts>> thread_counts;
+  for (size_t i = 0; i != num_threads; ++i) {
+    thread_counts.emplace_back(new BootImageProfileCounts(dex_files));
+  }
+  std::atomic<size_t> next_profile(0u);
+  std::atomic<bool> success(true);
+  auto count_profiles = [&](BootImageProfileCounts* counts) {
+    for (size_t i = next_profile.fetch_add(1u, std::memory_order_relaxed);
+         i < num_profiles && success.load(std::memory_order_relaxed);
+         i = next_profile.fetch_add(1u, std::memory_order_relaxed)) {
+      std::unique_ptr<const ProfileCompilationInfo> profile = load_profile(i);
+      if (profile == nullptr) {
+        success.store(false, std::memory_order_relaxed);
+        break;
+      }
+      counts->AddProfile(*profile);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i != num_threads; ++i) {
+    threads.emplace_back(count_profiles, thread_counts[i].get());
+  }
+  count_profiles(thread_counts[0].get());
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  if (!success.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  for (size_t i = 1; i != num_threads; ++i) {
+    thread_counts[0]->Merge(*thread_counts[i]);
+  }
+  thread_counts[0]->Finish(options, verbose, out_profile);
+  return true;
+}
+
 }  // namespace art
@@ -17,6 +17,7 @@
 #ifndef ART_PROFMAN_BOOT_IMAGE_PROFILE_H_
 #define ART_PROFMAN_BOOT_IMAGE_PROFILE_H_
 
+#include <functional>
 #include <limits>
 #include <memory>
 #include <vector>
@@ -51,6 +52,19 @@ void GenerateBootImageProfile(
     bool verbose,
     ProfileCompilationInfo* out_profile);
 
+// Same as above, but only keeps the numbers of profiles using each class and method in memory,
+// instead of all the profiles. `load_profile` loads the profile of the given index, or returns
+// null if it cannot. The profiles are loaded and counted on `num_threads` threads. Returns false
+// if a profile could not be loaded.
+bool GenerateBootImageProfile(
+    const std::vector<std::unique_ptr<const DexFile>>& dex_files,
+    size_t num_profiles,
+    const std::function<std::unique_ptr<const ProfileCompilationInfo>(size_t)>& load_profile,
+    size_t num_threads,
+    const BootImageOptions& options,
+    bool verbose,
+    ProfileCompilationInfo* out_profile);
+
 }  // namespace art
 
 #endif  // ART_PROFMAN_BOOT_IMAGE_PROFILE_H_
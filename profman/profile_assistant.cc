@@ -46,15 +46,12 @@ ProfileAssistant::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
   uint32_t number_of_methods = info.GetNumberOfMethods();
   uint32_t number_of_classes = info.GetNumberOfResolvedClasses();
 
-  // Merge all current profiles.
+  // Merge all current profiles. Loading a profile merges it into the loaded data, after checking
+  // that the checksums of the dex files match. Merging them as they are read avoids building a
+  // separate profile for each of them.
   for (size_t i = 0; i < profile_files.size(); i++) {
-    ProfileCompilationInfo cur_info;
-    if (!cur_info.Load(profile_files[i]->Fd(), /*merge_classes*/ true, filter_fn)) {
-      LOG(WARNING) << "Could not load profile file at index " << i;
-      return kErrorBadProfiles;
-    }
-    if (!info.MergeWith(cur_info)) {
-      LOG(WARNING) << "Could not merge profile file at index " << i;
+    if (!info.Load(profile_files[i]->Fd(), /*merge_classes*/ true, filter_fn)) {
+      LOG(WARNING) << "Could not load and merge profile file at index " << i;
       return kErrorBadProfiles;
     }
   }
@@ -839,6 +839,21 @@ TEST_F(ProfileAssistantTest, TestBootImageProfile) {
   // Multi method is in at least two profiles, it should become hot.
   EXPECT_NE(output_file_contents.find("HP" + kMultiMethod), std::string::npos)
       << output_file_contents;
+
+  // Counting the profiles on several threads generates the same boot profile.
+  ScratchFile threaded_out_profile;
+  for (std::string& arg : args) {
+    if (arg == "--reference-profile-file=" + out_profile.GetFilename()) {
+      arg = "--reference-profile-file=" + threaded_out_profile.GetFilename();
+    }
+  }
+  args.push_back("--boot-image-profile-threads=2");
+  EXPECT_EQ(ExecAndReturnCode(args, &error), 0) << error;
+  ASSERT_EQ(0, threaded_out_profile.GetFile()->Flush());
+  std::string threaded_output_file_contents;
+  EXPECT_TRUE(DumpClassesAndMethods(threaded_out_profile.GetFilename(),
+                                    &threaded_output_file_contents));
+  EXPECT_EQ(output_file_contents, threaded_output_file_contents);
 }
 
 TEST_F(ProfileAssistantTest, TestProfileCreationOneNotMatched) {
@@ -152,6 +152,8 @@ NO_RETURN static void Usage(const char *fmt, ...) {
   UsageError("  --boot-image-sampled-method-threshold=<value>: minimum number of profiles a");
   UsageError("      non-hot method needs to be in order to be hot in the output profile. The");
   UsageError("      default is max int.");
+  UsageError("  --boot-image-profile-threads=<count>: number of threads loading and counting the");
+  UsageError("      input profiles of --generate-boot-image-profile. Default is 1.");
   UsageError("  --copy-and-update-profile-key: if present, profman will copy the profile from");
   UsageError("      the file passed with --profile-fd(file) to the profile passed with");
   UsageError("      --reference-profile-fd(file) and update at the same time the profile-key");
@@ -189,6 +191,7 @@ class ProfMan FINAL {
       dump_classes_and_methods_(false),
       generate_boot_image_profile_(false),
       dump_output_to_fd_(kInvalidFd),
+      boot_image_profile_threads_(1u),
       test_profile_num_dex_(kDefaultTestProfileNumDex),
       test_profile_method_percerntage_(kDefaultTestProfileMethodPercentage),
       test_profile_class_percentage_(kDefaultTestProfileClassPercentage),
@@ -246,6 +249,11 @@ class ProfMan FINAL {
                         "--boot-image-sampled-method-threshold",
                         &boot_image_options_.compiled_method_threshold,
                         Usage);
+      } else if (option.starts_with("--boot-image-profile-threads=")) {
+        ParseUintOption(option,
+                        "--boot-image-profile-threads",
+                        &boot_image_profile_threads_,
+                        Usage);
       } else if (option.starts_with("--profile-file=")) {
         profile_files_.push_back(option.substr(strlen("--profile-file=")).ToString());
       } else if (option.starts_with("--profile-file-fd=")) {
@@ -479,7 +487,11 @@ class ProfMan FINAL {
       }
     }
     std::unique_ptr<ProfileCompilationInfo> info(new ProfileCompilationInfo);
-    if (!info->Load(fd)) {
+    bool loaded = info->Load(fd);
+    if (!filename.empty()) {
+      close(fd);
+    }
+    if (!loaded) {
       LOG(ERROR) << "Cannot load profile info from fd=" << fd << "\n";
       return nullptr;
     }
@@ -1091,32 +1103,22 @@ class ProfMan FINAL {
       PLOG(ERROR) << "Expected dex files for creating boot profile";
       return -2;
     }
-    // Open the input profiles.
-    std::vector<std::unique_ptr<const ProfileCompilationInfo>> profiles;
-    if (!profile_files_fd_.empty()) {
-      for (int profile_file_fd : profile_files_fd_) {
-        std::unique_ptr<const ProfileCompilationInfo> profile(LoadProfile("", profile_file_fd));
-        if (profile == nullptr) {
-          return -3;
-        }
-        profiles.emplace_back(std::move(profile));
-      }
-    }
-    if (!profile_files_.empty()) {
-      for (const std::string& profile_file : profile_files_) {
-        std::unique_ptr<const ProfileCompilationInfo> profile(LoadProfile(profile_file, kInvalidFd));
-        if (profile == nullptr) {
-          return -4;
-        }
-        profiles.emplace_back(std::move(profile));
-      }
-    }
+    // Load the input profiles one at a time, only their counts are kept.
+    auto load_profile = [&](size_t index) {
+      return (index < profile_files_fd_.size())
+          ? LoadProfile("", profile_files_fd_[index])
+          : LoadProfile(profile_files_[index - profile_files_fd_.size()], kInvalidFd);
+    };
     ProfileCompilationInfo out_profile;
-    GenerateBootImageProfile(dex_files,
-                             profiles,
-                             boot_image_options_,
-                             VLOG_IS_ON(profiler),
-                             &out_profile);
+    if (!GenerateBootImageProfile(dex_files,
+                                  profile_files_fd_.size() + profile_files_.size(),
+                                  load_profile,
+                                  boot_image_profile_threads_,
+                                  boot_image_options_,
+                                  VLOG_IS_ON(profiler),
+                                  &out_profile)) {
+      return -3;
+    }
     out_profile.Save(reference_fd);
     close(reference_fd);
     return 0;
@@ -1257,6 +1259,7 @@ class ProfMan FINAL {
   bool generate_boot_image_profile_;
   int dump_output_to_fd_;
   BootImageOptions boot_image_options_;
+  uint32_t boot_image_profile_threads_;
   std::string test_profile_;
   std::string create_profile_from_file_;
   uint16_t test_profile_num_dex_;
@@ -24,6 +24,7 @@
 #include <android-base/strings.h>
 
 #include "arch/x86_64/instruction_set_features_x86_64.h"
+#include "base/logging.h"  // For VLOG.
 
 namespace art {
 
@@ -36,38 +37,64 @@ static constexpr const char* x86_known_variants[] = {
     "sandybridge",
     "silvermont",
     "kabylake",
+    "skylake-avx512",
+    "icelake-server",
 };
 
 static constexpr const char* x86_variants_with_ssse3[] = {
     "atom",
     "sandybridge",
     "silvermont",
+    "skylake-avx512",
+    "icelake-server",
 };
 
 static constexpr const char* x86_variants_with_sse4_1[] = {
     "sandybridge",
     "silvermont",
     "kabylake",
+    "skylake-avx512",
+    "icelake-server",
 };
 
 static constexpr const char* x86_variants_with_sse4_2[] = {
     "sandybridge",
     "silvermont",
     "kabylake",
+    "skylake-avx512",
+    "icelake-server",
 };
 
 static constexpr const char* x86_variants_with_popcnt[] = {
     "sandybridge",
     "silvermont",
     "kabylake",
+    "skylake-avx512",
+    "icelake-server",
 };
 
 static constexpr const char* x86_variants_with_avx[] = {
     "kabylake",
+    "skylake-avx512",
+    "icelake-server",
 };
 
 static constexpr const char* x86_variants_with_avx2[] = {
     "kabylake",
+    "skylake-avx512",
+    "icelake-server",
+};
+
+static constexpr const char* x86_variants_with_fma[] = {
+    "kabylake",
+    "skylake-avx512",
+    "icelake-server",
+};
+
+// Skylake-SP and later server parts. They have AVX-512 F, BW and VL.
+static constexpr const char* x86_variants_with_avx512[] = {
+    "skylake-avx512",
+    "icelake-server",
 };
 
 
@@ -77,6 +104,10 @@ X86FeaturesUniquePtr X86InstructionSetFeatures::Create(bool x86_64,
                                                        bool has_SSE4_2,
                                                        bool has_AVX,
                                                        bool has_AVX2,
+                                                       bool has_FMA,
+                                                       bool has_AVX512F,
+                                                       bool has_AVX512BW,
+                                                       bool has_AVX512VL,
                                                        bool has_POPCNT) {
   if (x86_64) {
     return X86FeaturesUniquePtr(new X86_64InstructionSetFeatures(has_SSSE3,
@@ -84,6 +115,10 @@ X86FeaturesUniquePtr X86InstructionSetFeatures::Create(bool x86_64,
                                                                  has_SSE4_2,
                                                                  has_AVX,
                                                                  has_AVX2,
+                                                                 has_FMA,
+                                                                 has_AVX512F,
+                                                                 has_AVX512BW,
+                                                                 has_AVX512VL,
                                                                  has_POPCNT));
   } else {
     return X86FeaturesUniquePtr(new X86InstructionSetFeatures(has_SSSE3,
@@ -91,6 +126,10 @@ X86FeaturesUniquePtr X86InstructionSetFeatures::Create(bool x86_64,
                                                               has_SSE4_2,
                                                               has_AVX,
                                                               has_AVX2,
+                                                              has_FMA,
+                                                              has_AVX512F,
+                                                              has_AVX512BW,
+                                                              has_AVX512VL,
                                                               has_POPCNT));
   }
 }
@@ -112,6 +151,15 @@ X86FeaturesUniquePtr X86InstructionSetFeatures::FromVariant(
   bool has_AVX2 = FindVariantInArray(x86_variants_with_avx2,
                                     arraysize(x86_variants_with_avx2),
                                     variant);
+  bool has_FMA = FindVariantInArray(x86_variants_with_fma,
+                                    arraysize(x86_variants_with_fma),
+                                    variant);
+  bool has_AVX512 = FindVariantInArray(x86_variants_with_avx512,
+                                       arraysize(x86_variants_with_avx512),
+                                       variant);
+  bool has_AVX512F = has_AVX512;
+  bool has_AVX512BW = has_AVX512;
+  bool has_AVX512VL = has_AVX512;
 
   bool has_POPCNT = FindVariantInArray(x86_variants_with_popcnt,
                                        arraysize(x86_variants_with_popcnt),
@@ -124,7 +172,8 @@ X86FeaturesUniquePtr X86InstructionSetFeatures::FromVariant(
     LOG(WARNING) << "Unexpected CPU variant for X86 using defaults: " << variant;
   }
 
-  return Create(x86_64, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX, has_AVX2, has_POPCNT);
+  return Create(x86_64, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX, has_AVX2, has_FMA,
+                has_AVX512F, has_AVX512BW, has_AVX512VL, has_POPCNT);
 }
 
 X86FeaturesUniquePtr X86InstructionSetFeatures::FromBitmap(uint32_t bitmap, bool x86_64) {
@@ -132,9 +181,14 @@ X86FeaturesUniquePtr X86InstructionSetFeatures::FromBitmap(uint32_t bitmap, bool
   bool has_SSE4_1 = (bitmap & kSse4_1Bitfield) != 0;
   bool has_SSE4_2 = (bitmap & kSse4_2Bitfield) != 0;
   bool has_AVX = (bitmap & kAvxBitfield) != 0;
-  bool has_AVX2 = (bitmap & kAvxBitfield) != 0;
+  bool has_AVX2 = (bitmap & kAvx2Bitfield) != 0;
+  bool has_FMA = (bitmap & kFmaBitfield) != 0;
+  bool has_AVX512F = (bitmap & kAvx512fBitfield) != 0;
+  bool has_AVX512BW = (bitmap & kAvx512bwBitfield) != 0;
+  bool has_AVX512VL = (bitmap & kAvx512vlBitfield) != 0;
   bool has_POPCNT = (bitmap & kPopCntBitfield) != 0;
-  return Create(x86_64, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX, has_AVX2, has_POPCNT);
+  return Create(x86_64, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX, has_AVX2, has_FMA,
+                has_AVX512F, has_AVX512BW, has_AVX512VL, has_POPCNT);
 }
 
 X86FeaturesUniquePtr X86InstructionSetFeatures::FromCppDefines(bool x86_64) {
@@ -168,13 +222,38 @@ X86FeaturesUniquePtr X86InstructionSetFeatures::FromCppDefines(bool x86_64) {
   const bool has_AVX2 = true;
 #endif
 
+#ifndef __FMA__
+  const bool has_FMA = false;
+#else
+  const bool has_FMA = true;
+#endif
+
+#ifndef __AVX512F__
+  const bool has_AVX512F = false;
+#else
+  const bool has_AVX512F = true;
+#endif
+
+#ifndef __AVX512BW__
+  const bool has_AVX512BW = false;
+#else
+  const bool has_AVX512BW = true;
+#endif
+
+#ifndef __AVX512VL__
+  const bool has_AVX512VL = false;
+#else
+  const bool has_AVX512VL = true;
+#endif
+
 #ifndef __POPCNT__
   const bool has_POPCNT = false;
 #else
   const bool has_POPCNT = true;
 #endif
 
-  return Create(x86_64, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX, has_AVX2, has_POPCNT);
+  return Create(x86_64, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX, has_AVX2, has_FMA,
+                has_AVX512F, has_AVX512BW, has_AVX512VL, has_POPCNT);
 }
 
 X86FeaturesUniquePtr X86InstructionSetFeatures::FromCpuInfo(bool x86_64) {
@@ -185,6 +264,10 @@ X86FeaturesUniquePtr X86InstructionSetFeatures::FromCpuInfo(bool x86_64) {
   bool has_SSE4_2 = false;
   bool has_AVX = false;
   bool has_AVX2 = false;
+  bool has_FMA = false;
+  bool has_AVX512F = false;
+  bool has_AVX512BW = false;
+  bool has_AVX512VL = false;
   bool has_POPCNT = false;
 
   std::ifstream in("/proc/cpuinfo");
@@ -193,9 +276,9 @@ X86FeaturesUniquePtr X86InstructionSetFeatures::FromCpuInfo(bool x86_64) {
       std::string line;
       std::getline(in, line);
       if (!in.eof()) {
-        LOG(INFO) << "cpuinfo line: " << line;
+        VLOG(compiler) << "cpuinfo line: " << line;
         if (line.find("flags") != std::string::npos) {
-          LOG(INFO) << "found flags";
+          VLOG(compiler) << "found flags";
           if (line.find("ssse3") != std::string::npos) {
             has_SSSE3 = true;
           }
@@ -211,6 +294,19 @@ X86FeaturesUniquePtr X86InstructionSetFeatures::FromCpuInfo(bool x86_64) {
           if (line.find("avx2") != std::string::npos) {
             has_AVX2 = true;
           }
+          // Match the whole flag, "fma4" is the unrelated AMD extension.
+          if (line.find(" fma ") != std::string::npos) {
+            has_FMA = true;
+          }
+          if (line.find(" avx512f ") != std::string::npos) {
+            has_AVX512F = true;
+          }
+          if (line.find(" avx512bw ") != std::string::npos) {
+            has_AVX512BW = true;
+          }
+          if (line.find(" avx512vl ") != std::string::npos) {
+            has_AVX512VL = true;
+          }
           if (line.find("popcnt") != std::string::npos) {
             has_POPCNT = true;
           }
@@ -221,7 +317,8 @@ X86FeaturesUniquePtr X86InstructionSetFeatures::FromCpuInfo(bool x86_64) {
   } else {
     LOG(ERROR) << "Failed to open /proc/cpuinfo";
   }
-  return Create(x86_64, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX, has_AVX2, has_POPCNT);
+  return Create(x86_64, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX, has_AVX2, has_FMA,
+                has_AVX512F, has_AVX512BW, has_AVX512VL, has_POPCNT);
 }
 
 X86FeaturesUniquePtr X86InstructionSetFeatures::FromHwcap(bool x86_64) {
@@ -244,6 +341,10 @@ bool X86InstructionSetFeatures::Equals(const InstructionSetFeatures* other) cons
       (has_SSE4_2_ == other_as_x86->has_SSE4_2_) &&
       (has_AVX_ == other_as_x86->has_AVX_) &&
       (has_AVX2_ == other_as_x86->has_AVX2_) &&
+      (has_FMA_ == other_as_x86->has_FMA_) &&
+      (has_AVX512F_ == other_as_x86->has_AVX512F_) &&
+      (has_AVX512BW_ == other_as_x86->has_AVX512BW_) &&
+      (has_AVX512VL_ == other_as_x86->has_AVX512VL_) &&
       (has_POPCNT_ == other_as_x86->has_POPCNT_);
 }
 
@@ -257,6 +358,10 @@ bool X86InstructionSetFeatures::HasAtLeast(const InstructionSetFeatures* other)
       (has_SSE4_2_ || !other_as_x86->has_SSE4_2_) &&
       (has_AVX_ || !other_as_x86->has_AVX_) &&
       (has_AVX2_ || !other_as_x86->has_AVX2_) &&
+      (has_FMA_ || !other_as_x86->has_FMA_) &&
+      (has_AVX512F_ || !other_as_x86->has_AVX512F_) &&
+      (has_AVX512BW_ || !other_as_x86->has_AVX512BW_) &&
+      (has_AVX512VL_ || !other_as_x86->has_AVX512VL_) &&
       (has_POPCNT_ || !other_as_x86->has_POPCNT_);
 }
 
@@ -266,6 +371,10 @@ uint32_t X86InstructionSetFeatures::AsBitmap() const {
       (has_SSE4_2_ ? kSse4_2Bitfield : 0) |
       (has_AVX_ ? kAvxBitfield : 0) |
       (has_AVX2_ ? kAvx2Bitfield : 0) |
+      (has_FMA_ ? kFmaBitfield : 0) |
+      (has_AVX512F_ ? kAvx512fBitfield : 0) |
+      (has_AVX512BW_ ? kAvx512bwBitfield : 0) |
+      (has_AVX512VL_ ? kAvx512vlBitfield : 0) |
       (has_POPCNT_ ? kPopCntBitfield : 0);
 }
 
@@ -296,6 +405,26 @@ std::string X86InstructionSetFeatures::GetFeatureString() const {
   } else {
     result += ",-avx2";
   }
+  if (has_FMA_) {
+    result += ",fma";
+  } else {
+    result += ",-fma";
+  }
+  if (has_AVX512F_) {
+    result += ",avx512f";
+  } else {
+    result += ",-avx512f";
+  }
+  if (has_AVX512BW_) {
+    result += ",avx512bw";
+  } else {
+    result += ",-avx512bw";
+  }
+  if (has_AVX512VL_) {
+    result += ",avx512vl";
+  } else {
+    result += ",-avx512vl";
+  }
   if (has_POPCNT_) {
     result += ",popcnt";
   } else {
@@ -312,6 +441,10 @@ std::unique_ptr<const InstructionSetFeatures> X86InstructionSetFeatures::AddFeat
   bool has_SSE4_2 = has_SSE4_2_;
   bool has_AVX = has_AVX_;
   bool has_AVX2 = has_AVX2_;
+  bool has_FMA = has_FMA_;
+  bool has_AVX512F = has_AVX512F_;
+  bool has_AVX512BW = has_AVX512BW_;
+  bool has_AVX512VL = has_AVX512VL_;
   bool has_POPCNT = has_POPCNT_;
   for (auto i = features.begin(); i != features.end(); i++) {
     std::string feature = android::base::Trim(*i);
@@ -335,18 +468,33 @@ std::unique_ptr<const InstructionSetFeatures> X86InstructionSetFeatures::AddFeat
       has_AVX2 = true;
     } else if (feature == "-avx2") {
       has_AVX2 = false;
+    } else if (feature == "fma") {
+      has_FMA = true;
+    } else if (feature == "-fma") {
+      has_FMA = false;
+    } else if (feature == "avx512f") {
+      has_AVX512F = true;
+    } else if (feature == "-avx512f") {
+      has_AVX512F = false;
+    } else if (feature == "avx512bw") {
+      has_AVX512BW = true;
+    } else if (feature == "-avx512bw") {
+      has_AVX512BW = false;
+    } else if (feature == "avx512vl") {
+      has_AVX512VL = true;
+    } else if (feature == "-avx512vl") {
+      has_AVX512VL = false;
     } else if (feature == "popcnt") {
       has_POPCNT = true;
     } else if (feature == "-popcnt") {
       has_POPCNT = false;
-    } else if (feature == "-fma") {
-
     } else {
       *error_msg = StringPrintf("Unknown instruction set feature: '%s'", feature.c_str());
       return nullptr;
     }
   }
-  return Create(x86_64, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX, has_AVX2, has_POPCNT);
+  return Create(x86_64, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX, has_AVX2, has_FMA,
+                has_AVX512F, has_AVX512BW, has_AVX512VL, has_POPCNT);
 }
 
 }  // namespace art
@@ -63,12 +63,26 @@ class X86InstructionSetFeatures : public InstructionSetFeatures {
 
   virtual ~X86InstructionSetFeatures() {}
 
+  bool HasSSSE3() const { return has_SSSE3_; }
+
   bool HasSSE4_1() const { return has_SSE4_1_; }
 
+  bool HasSSE4_2() const { return has_SSE4_2_; }
+
   bool HasPopCnt() const { return has_POPCNT_; }
 
+  bool HasAVX() const { return has_AVX_; }
+
   bool HasAVX2() const { return has_AVX2_; }
 
+  bool HasFMA() const { return has_FMA_; }
+
+  bool HasAVX512F() const { return has_AVX512F_; }
+
+  bool HasAVX512BW() const { return has_AVX512BW_; }
+
+  bool HasAVX512VL() const { return has_AVX512VL_; }
+
  protected:
   // Parse a string of the form "ssse3" adding these to a new InstructionSetFeatures.
   virtual std::unique_ptr<const InstructionSetFeatures>
@@ -87,6 +101,10 @@ class X86InstructionSetFeatures : public InstructionSetFeatures {
                             bool has_SSE4_2,
                             bool has_AVX,
                             bool has_AVX2,
+                            bool has_FMA,
+                            bool has_AVX512F,
+                            bool has_AVX512BW,
+                            bool has_AVX512VL,
                             bool has_POPCNT)
       : InstructionSetFeatures(),
         has_SSSE3_(has_SSSE3),
@@ -94,6 +112,10 @@ class X86InstructionSetFeatures : public InstructionSetFeatures {
         has_SSE4_2_(has_SSE4_2),
         has_AVX_(has_AVX),
         has_AVX2_(has_AVX2),
+        has_FMA_(has_FMA),
+        has_AVX512F_(has_AVX512F),
+        has_AVX512BW_(has_AVX512BW),
+        has_AVX512VL_(has_AVX512VL),
         has_POPCNT_(has_POPCNT) {
   }
 
@@ -103,6 +125,10 @@ class X86InstructionSetFeatures : public InstructionSetFeatures {
                                      bool has_SSE4_2,
                                      bool has_AVX,
                                      bool has_AVX2,
+                                     bool has_FMA,
+                                     bool has_AVX512F,
+                                     bool has_AVX512BW,
+                                     bool has_AVX512VL,
                                      bool has_POPCNT);
 
  private:
@@ -114,14 +140,22 @@ class X86InstructionSetFeatures : public InstructionSetFeatures {
     kAvxBitfield = 1 << 3,
     kAvx2Bitfield = 1 << 4,
     kPopCntBitfield = 1 << 5,
+    kFmaBitfield = 1 << 6,
+    kAvx512fBitfield = 1 << 7,
+    kAvx512bwBitfield = 1 << 8,
+    kAvx512vlBitfield = 1 << 9,
   };
 
-  const bool has_SSSE3_;   // x86 128bit SIMD - Supplemental SSE.
-  const bool has_SSE4_1_;  // x86 128bit SIMD SSE4.1.
-  const bool has_SSE4_2_;  // x86 128bit SIMD SSE4.2.
-  const bool has_AVX_;     // x86 256bit SIMD AVX.
-  const bool has_AVX2_;    // x86 256bit SIMD AVX 2.0.
-  const bool has_POPCNT_;  // x86 population count
+  const bool has_SSSE3_;     // x86 128bit SIMD - Supplemental SSE.
+  const bool has_SSE4_1_;    // x86 128bit SIMD SSE4.1.
+  const bool has_SSE4_2_;    // x86 128bit SIMD SSE4.2.
+  const bool has_AVX_;       // x86 256bit SIMD AVX.
+  const bool has_AVX2_;      // x86 256bit SIMD AVX 2.0.
+  const bool has_FMA_;       // x86 fused multiply-add FMA3.
+  const bool has_AVX512F_;   // x86 512bit SIMD AVX-512 foundation.
+  const bool has_AVX512BW_;  // x86 512bit SIMD AVX-512 byte and word elements.
+  const bool has_AVX512VL_;  // x86 AVX-512 instructions on 128bit and 256bit vectors.
+  const bool has_POPCNT_;    // x86 population count
 
   DISALLOW_COPY_AND_ASSIGN(X86InstructionSetFeatures);
 };
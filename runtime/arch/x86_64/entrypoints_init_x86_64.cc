@@ -139,6 +139,9 @@ void InitEntryPoints(JniEntryPoints* jpoints, QuickEntryPoints* qpoints) {
   qpoints->pReadBarrierMarkReg29 = nullptr;
   qpoints->pReadBarrierSlow = art_quick_read_barrier_slow;
   qpoints->pReadBarrierForRootSlow = art_quick_read_barrier_for_root_slow;
+
+  // JIT
+  qpoints->pCompileOptimized = art_quick_compile_optimized;
 #endif  // __APPLE__
 }
 
@@ -79,9 +79,14 @@ class X86_64InstructionSetFeatures FINAL : public X86InstructionSetFeatures {
                                bool has_SSE4_2,
                                bool has_AVX,
                                bool has_AVX2,
+                               bool has_FMA,
+                               bool has_AVX512F,
+                               bool has_AVX512BW,
+                               bool has_AVX512VL,
                                bool has_POPCNT)
       : X86InstructionSetFeatures(has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX,
-                                  has_AVX2, has_POPCNT) {
+                                  has_AVX2, has_FMA, has_AVX512F, has_AVX512BW,
+                                  has_AVX512VL, has_POPCNT) {
   }
 
   static X86_64FeaturesUniquePtr Convert(X86FeaturesUniquePtr&& in) {
@@ -27,9 +27,66 @@ TEST(X86_64InstructionSetFeaturesTest, X86Features) {
   ASSERT_TRUE(x86_64_features.get() != nullptr) << error_msg;
   EXPECT_EQ(x86_64_features->GetInstructionSet(), InstructionSet::kX86_64);
   EXPECT_TRUE(x86_64_features->Equals(x86_64_features.get()));
-  EXPECT_STREQ("-ssse3,-sse4.1,-sse4.2,-avx,-avx2,-popcnt",
+  EXPECT_STREQ("-ssse3,-sse4.1,-sse4.2,-avx,-avx2,-fma,-avx512f,-avx512bw,-avx512vl,-popcnt",
                x86_64_features->GetFeatureString().c_str());
   EXPECT_EQ(x86_64_features->AsBitmap(), 0U);
 }
 
+TEST(X86_64InstructionSetFeaturesTest, X86FeaturesFromKabylakeVariant) {
+  std::string error_msg;
+  std::unique_ptr<const InstructionSetFeatures> x86_64_features(
+      InstructionSetFeatures::FromVariant(InstructionSet::kX86_64, "kabylake", &error_msg));
+  ASSERT_TRUE(x86_64_features.get() != nullptr) << error_msg;
+  EXPECT_STREQ("-ssse3,sse4.1,sse4.2,avx,avx2,fma,-avx512f,-avx512bw,-avx512vl,popcnt",
+               x86_64_features->GetFeatureString().c_str());
+  EXPECT_EQ(x86_64_features->AsBitmap(), 126U);
+  EXPECT_TRUE(x86_64_features->AsX86InstructionSetFeatures()->HasFMA());
+
+  // The bitmap stored in the oat header must round-trip.
+  std::unique_ptr<const InstructionSetFeatures> bitmap_features(
+      InstructionSetFeatures::FromBitmap(InstructionSet::kX86_64, x86_64_features->AsBitmap()));
+  EXPECT_TRUE(x86_64_features->Equals(bitmap_features.get()));
+
+  std::unique_ptr<const InstructionSetFeatures> no_fma_features(
+      x86_64_features->AddFeaturesFromString("-fma", &error_msg));
+  ASSERT_TRUE(no_fma_features.get() != nullptr) << error_msg;
+  EXPECT_FALSE(no_fma_features->AsX86InstructionSetFeatures()->HasFMA());
+  EXPECT_TRUE(x86_64_features->HasAtLeast(no_fma_features.get()));
+  EXPECT_FALSE(no_fma_features->HasAtLeast(x86_64_features.get()));
+}
+
+TEST(X86_64InstructionSetFeaturesTest, X86FeaturesFromSkylakeAvx512Variant) {
+  std::string error_msg;
+  std::unique_ptr<const InstructionSetFeatures> x86_64_features(
+      InstructionSetFeatures::FromVariant(InstructionSet::kX86_64, "skylake-avx512", &error_msg));
+  ASSERT_TRUE(x86_64_features.get() != nullptr) << error_msg;
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,avx,avx2,fma,avx512f,avx512bw,avx512vl,popcnt",
+               x86_64_features->GetFeatureString().c_str());
+  EXPECT_EQ(x86_64_features->AsBitmap(), 1023U);
+  const X86InstructionSetFeatures* x86_features = x86_64_features->AsX86InstructionSetFeatures();
+  EXPECT_TRUE(x86_features->HasAVX512F());
+  EXPECT_TRUE(x86_features->HasAVX512BW());
+  EXPECT_TRUE(x86_features->HasAVX512VL());
+
+  std::unique_ptr<const InstructionSetFeatures> bitmap_features(
+      InstructionSetFeatures::FromBitmap(InstructionSet::kX86_64, x86_64_features->AsBitmap()));
+  EXPECT_TRUE(x86_64_features->Equals(bitmap_features.get()));
+}
+
+TEST(X86_64InstructionSetFeaturesTest, X86AddAvx512FeaturesFromString) {
+  std::string error_msg;
+  std::unique_ptr<const InstructionSetFeatures> base_features(
+      InstructionSetFeatures::FromVariant(InstructionSet::kX86_64, "kabylake", &error_msg));
+  ASSERT_TRUE(base_features.get() != nullptr) << error_msg;
+  std::unique_ptr<const InstructionSetFeatures> x86_64_features(
+      base_features->AddFeaturesFromString("avx512f,avx512vl", &error_msg));
+  ASSERT_TRUE(x86_64_features.get() != nullptr) << error_msg;
+  const X86InstructionSetFeatures* x86_features = x86_64_features->AsX86InstructionSetFeatures();
+  EXPECT_TRUE(x86_features->HasAVX512F());
+  EXPECT_FALSE(x86_features->HasAVX512BW());
+  EXPECT_TRUE(x86_features->HasAVX512VL());
+  EXPECT_TRUE(x86_64_features->HasAtLeast(base_features.get()));
+  EXPECT_FALSE(base_features->HasAtLeast(x86_64_features.get()));
+}
+
 }  // namespace art
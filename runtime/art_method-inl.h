@@ -397,6 +397,14 @@ inline HiddenApiAccessFlags::ApiList ArtMethod::GetHiddenApiAccessFlags()
         // whitelisted, e.g. in the core image (b/77733081). As a result, we
         // might print warnings but we won't change the semantics.
         return HiddenApiAccessFlags::kLightGreylist;
+      case Intrinsics::kAdler32UpdateBytes:
+      case Intrinsics::kAdler32UpdateByteBuffer:
+      case Intrinsics::kCRC32UpdateBytes:
+      case Intrinsics::kCRC32UpdateByteBuffer:
+        // These intrinsics are private native methods of the checksums, which are on
+        // the blacklist like the other private methods of the core libraries. The same
+        // note about the DCHECK in SetIntrinsic() applies.
+        return HiddenApiAccessFlags::kBlacklist;
       case Intrinsics::kVarHandleFullFence:
       case Intrinsics::kVarHandleAcquireFence:
       case Intrinsics::kVarHandleReleaseFence:
@@ -16,6 +16,7 @@
 
 #include "art_method.h"
 
+#include <algorithm>
 #include <cstddef>
 
 #include "android-base/stringprintf.h"
@@ -29,6 +30,7 @@
 #include "class_linker-inl.h"
 #include "debugger.h"
 #include "dex/descriptors_names.h"
+#include "dex/dex_file_annotations.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_exception_helpers.h"
 #include "dex/dex_instruction.h"
@@ -49,6 +51,7 @@
 #include "quicken_info.h"
 #include "runtime_callbacks.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_pool.h"
 #include "vdex_file.h"
 #include "well_known_classes.h"
 
@@ -402,7 +405,7 @@ void ArtMethod::Invoke(Thread* self, uint32_t* args, uint32_t args_size, JValue*
 
 #ifdef CAPSTONE
 
-class AutoFastJniDetectTask FINAL : public jit::JniTask {
+class AutoFastJniDetectTask FINAL : public Task {
  public:
   AutoFastJniDetectTask(ArtMethod* method, const void* native_method)
       : method_(method), native_method_(native_method) { }
@@ -411,10 +414,18 @@ class AutoFastJniDetectTask FINAL : public jit::JniTask {
 
   void Run(Thread* self) OVERRIDE {
     ScopedObjectAccess soa(self);
-    bool is_fast = IsFastJNI(method_->GetDexMethodIndex(), *method_->GetDexFile(), native_method_);
-    if (is_fast) {
-      method_->SetAccessFlags(method_->GetAccessFlags() | kAccFastNative);
+    if (method_->GetEntryPointFromJni() != native_method_) {
+      // Registered again, or unregistered, since the task was queued.
+      return;
     }
+    FastJniCache::Verdict verdict =
+        AnalyzeFastJNI(method_->GetDexMethodIndex(), *method_->GetDexFile(), native_method_);
+    if (verdict == FastJniCache::Verdict::kNotFast ||
+        method_->GetEntryPointFromJni() != native_method_) {
+      return;
+    }
+    method_->SetAutoFastNative(
+        verdict == FastJniCache::Verdict::kFastNoJniEnv && IsAutoCriticalCandidate());
   }
 
   void Finalize() OVERRIDE {
@@ -422,6 +433,17 @@ class AutoFastJniDetectTask FINAL : public jit::JniTask {
   }
 
  private:
+  // Like for @CriticalNative, the method must be static, not synchronized, and take and
+  // return only primitives, so that a local reference frame is never needed.
+  bool IsAutoCriticalCandidate() REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (!method_->IsStatic() || method_->IsSynchronized()) {
+      return false;
+    }
+    uint32_t shorty_len = 0;
+    const char* shorty = method_->GetShorty(&shorty_len);
+    return std::find(shorty, shorty + shorty_len, 'L') == shorty + shorty_len;
+  }
+
   ArtMethod* const method_;
   const void* native_method_;
 
@@ -430,23 +452,38 @@ class AutoFastJniDetectTask FINAL : public jit::JniTask {
 
 #endif // #ifdef CAPSTONE
 
+void ArtMethod::ClearAutoFastNative() {
+  DCHECK(IsNative());
+  if (!IsFastNative()) {
+    return;
+  }
+  // Both @FastNative from the annotation and the autofast JNI detection set kAccFastNative.
+  const bool annotated_fast_native =
+      (annotations::GetNativeMethodAnnotationAccessFlags(
+          *GetDexFile(), GetClassDef(), GetDexMethodIndex()) & kAccFastNative) != 0u;
+  uint32_t old_access_flags;
+  uint32_t new_access_flags;
+  do {
+    old_access_flags = access_flags_.load(std::memory_order_relaxed);
+    new_access_flags = old_access_flags;
+    if (!annotated_fast_native) {
+      new_access_flags &= ~kAccFastNative;
+    }
+    if ((old_access_flags & kAccIntrinsic) == 0) {
+      // kAccAutoCriticalNative overlaps with kAccIntrinsicBits.
+      new_access_flags &= ~kAccAutoCriticalNative;
+    }
+  } while (!access_flags_.compare_exchange_weak(old_access_flags, new_access_flags));
+}
+
 const void* ArtMethod::RegisterNative(const void* native_method) {
   CHECK(IsNative()) << PrettyMethod();
   CHECK(native_method != nullptr) << PrettyMethod();
 
 #ifdef CAPSTONE
-  const bool not_going_to_unregister = (native_method != GetJniDlsymLookupStub());
-  if (Runtime::Current()->IsAutoFastDetect() && not_going_to_unregister) {
-    jit::Jit* jit = Runtime::Current()->GetJit();
-    if (jit != nullptr) {
-      jit->AddJniTask(Thread::Current(), new AutoFastJniDetectTask(this, native_method));
-    } else {
-      // If we can't use JIT's thread pool it's better to disable auto fast JNI detection because
-      // if we run it in main thread it causes ~20% app launch time regression, so we decided to
-      // disable it as app launch time much more important than this optimization. Now auto fast
-      // JNI detection doesn't work in AOT at all. In JIT mode it doesn't work too but only between
-      // process startup and JIT creation.
-    }
+  if (Runtime::Current()->IsAutoFastDetect()) {
+    // The verdict of an earlier detection does not hold for the new native code.
+    ClearAutoFastNative();
   }
 #endif
   void* new_native_method = nullptr;
@@ -454,11 +491,30 @@ const void* ArtMethod::RegisterNative(const void* native_method) {
                                                                   native_method,
                                                                   /*out*/&new_native_method);
   SetEntryPointFromJni(new_native_method);
+#ifdef CAPSTONE
+  const bool not_going_to_unregister = (new_native_method != GetJniDlsymLookupStub());
+  if (Runtime::Current()->IsAutoFastDetect() && not_going_to_unregister) {
+    // Running the detection on this thread, often the main thread in System.loadLibrary(),
+    // causes a ~20% app launch time regression. The method uses the normal JNI transition
+    // until the background task upgrades it. Queue the task only once the code it analyzes,
+    // which a RegisterNativeMethod callback may have replaced, is installed, as the task
+    // checks that it is still the JNI entrypoint.
+    AutoFastJniDetectTask* task = new AutoFastJniDetectTask(this, new_native_method);
+    if (!Runtime::Current()->AddAutoFastTask(Thread::Current(), task)) {
+      delete task;
+    }
+  }
+#endif
   return new_native_method;
 }
 
 void ArtMethod::UnregisterNative() {
   CHECK(IsNative()) << PrettyMethod();
+#ifdef CAPSTONE
+  if (Runtime::Current()->IsAutoFastDetect()) {
+    ClearAutoFastNative();
+  }
+#endif
   // restore stub to lookup native pointer via dlsym
   SetEntryPointFromJni(GetJniDlsymLookupStub());
 }
@@ -280,6 +280,41 @@ class ArtMethod FINAL {
     return (GetAccessFlags() & mask) == mask;
   }
 
+  // Atomically mark a native method as @FastNative after the autofast JNI detection, and as
+  // kAccAutoCriticalNative if `auto_critical` is true.
+  void SetAutoFastNative(bool auto_critical) {
+    DCHECK(IsNative());
+    uint32_t old_access_flags;
+    uint32_t new_access_flags;
+    do {
+      old_access_flags = access_flags_.load(std::memory_order_relaxed);
+      new_access_flags = old_access_flags | kAccFastNative;
+      if ((old_access_flags & kAccIntrinsic) == 0) {
+        // kAccAutoCriticalNative overlaps with kAccIntrinsicBits. Clear it in case the method
+        // was registered before with other native code.
+        new_access_flags &= ~kAccAutoCriticalNative;
+        if (auto_critical) {
+          new_access_flags |= kAccAutoCriticalNative;
+        }
+      }
+    } while (!access_flags_.compare_exchange_weak(old_access_flags, new_access_flags));
+  }
+
+  // Undo SetAutoFastNative() before other native code is registered for this method, keeping
+  // the kAccFastNative flag if the method is annotated with @FastNative.
+  void ClearAutoFastNative() REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Checks to see if the autofast JNI detection found that the native code of this @FastNative
+  // method never uses its JNIEnv* and jclass arguments, see kAccAutoCriticalNative.
+  bool IsAutoCriticalNative() {
+    if (IsIntrinsic()) {
+      // kAccAutoCriticalNative overlaps with kAccIntrinsicBits.
+      return false;
+    }
+    constexpr uint32_t mask = kAccAutoCriticalNative | kAccFastNative | kAccNative;
+    return (GetAccessFlags() & mask) == mask;
+  }
+
   template <ReadBarrierOption kReadBarrierOption = kWithReadBarrier>
   bool IsAbstract() {
     return (GetAccessFlags<kReadBarrierOption>() & kAccAbstract) != 0;
@@ -26,6 +26,7 @@
 #include <android-base/logging.h>
 
 #include "base/systrace.h"
+#include "base/utils.h"
 #include "mem_map.h"
 #include "mutex.h"
 #include "thread-current-inl.h"
@@ -281,8 +282,6 @@ void Arena::Reset() {
 
 ArenaPool::ArenaPool(bool use_malloc, bool low_4gb, const char* name)
     : use_malloc_(use_malloc),
-      lock_("Arena pool lock", kArenaPoolLock),
-      free_arenas_(nullptr),
       low_4gb_(low_4gb),
       name_(name) {
   if (low_4gb) {
@@ -297,27 +296,50 @@ ArenaPool::~ArenaPool() {
   ReclaimMemory();
 }
 
+size_t ArenaPool::FreeListIndexForCurrentThread() {
+  Thread* self = Thread::Current();
+  pid_t tid = (self != nullptr) ? self->GetTid() : GetTid();
+  return static_cast<size_t>(tid) % kNumFreeLists;
+}
+
 void ArenaPool::ReclaimMemory() {
-  while (free_arenas_ != nullptr) {
-    Arena* arena = free_arenas_;
-    free_arenas_ = free_arenas_->next_;
-    delete arena;
+  for (FreeList& free_list : free_lists_) {
+    while (free_list.arenas != nullptr) {
+      Arena* arena = free_list.arenas;
+      free_list.arenas = free_list.arenas->next_;
+      delete arena;
+    }
   }
 }
 
 void ArenaPool::LockReclaimMemory() {
-  MutexLock lock(Thread::Current(), lock_);
-  ReclaimMemory();
+  Thread* self = Thread::Current();
+  for (FreeList& free_list : free_lists_) {
+    Arena* arenas;
+    {
+      MutexLock lock(self, free_list.lock);
+      arenas = free_list.arenas;
+      free_list.arenas = nullptr;
+    }
+    while (arenas != nullptr) {
+      Arena* arena = arenas;
+      arenas = arenas->next_;
+      delete arena;
+    }
+  }
 }
 
 Arena* ArenaPool::AllocArena(size_t size) {
   Thread* self = Thread::Current();
   Arena* ret = nullptr;
-  {
-    MutexLock lock(self, lock_);
-    if (free_arenas_ != nullptr && LIKELY(free_arenas_->Size() >= size)) {
-      ret = free_arenas_;
-      free_arenas_ = free_arenas_->next_;
+  // Look in the free list of this thread first, then in the others.
+  const size_t first_index = FreeListIndexForCurrentThread();
+  for (size_t i = 0; i != kNumFreeLists && ret == nullptr; ++i) {
+    FreeList& free_list = free_lists_[(first_index + i) % kNumFreeLists];
+    MutexLock lock(self, free_list.lock);
+    if (free_list.arenas != nullptr && LIKELY(free_list.arenas->Size() >= size)) {
+      ret = free_list.arenas;
+      free_list.arenas = free_list.arenas->next_;
     }
   }
   if (ret == nullptr) {
@@ -332,18 +354,37 @@ void ArenaPool::TrimMaps() {
   if (!use_malloc_) {
     ScopedTrace trace(__PRETTY_FUNCTION__);
     // Doesn't work for malloc.
-    MutexLock lock(Thread::Current(), lock_);
-    for (Arena* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
+    Thread* self = Thread::Current();
+    // Take all the free arenas at once and madvise them without holding the locks, so that
+    // the compiler threads are not blocked for the whole trim.
+    Arena* first = nullptr;
+    for (FreeList& free_list : free_lists_) {
+      MutexLock lock(self, free_list.lock);
+      if (free_list.arenas != nullptr) {
+        Arena* last = free_list.arenas;
+        while (last->next_ != nullptr) {
+          last = last->next_;
+        }
+        last->next_ = first;
+        first = free_list.arenas;
+        free_list.arenas = nullptr;
+      }
+    }
+    for (Arena* arena = first; arena != nullptr; arena = arena->next_) {
       arena->Release();
     }
+    FreeArenaChain(first);
   }
 }
 
 size_t ArenaPool::GetBytesAllocated() const {
   size_t total = 0;
-  MutexLock lock(Thread::Current(), lock_);
-  for (Arena* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
-    total += arena->GetBytesAllocated();
+  Thread* self = Thread::Current();
+  for (const FreeList& free_list : free_lists_) {
+    MutexLock lock(self, free_list.lock);
+    for (Arena* arena = free_list.arenas; arena != nullptr; arena = arena->next_) {
+      total += arena->GetBytesAllocated();
+    }
   }
   return total;
 }
@@ -370,10 +411,11 @@ void ArenaPool::FreeArenaChain(Arena* first) {
     while (last->next_ != nullptr) {
       last = last->next_;
     }
+    FreeList& free_list = free_lists_[FreeListIndexForCurrentThread()];
     Thread* self = Thread::Current();
-    MutexLock lock(self, lock_);
-    last->next_ = free_arenas_;
-    free_arenas_ = first;
+    MutexLock lock(self, free_list.lock);
+    last->next_ = free_list.arenas;
+    free_list.arenas = first;
   }
 }
 
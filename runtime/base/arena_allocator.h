@@ -247,25 +247,39 @@ class Arena {
   DISALLOW_COPY_AND_ASSIGN(Arena);
 };
 
+// The free arenas are kept in several lists, each with its own lock, and a thread returns arenas
+// to and takes arenas from the list selected by its tid first, so that the compiler threads of
+// dex2oat and the JIT rarely contend on the same lock.
 class ArenaPool {
  public:
   explicit ArenaPool(bool use_malloc = true,
                      bool low_4gb = false,
                      const char* name = "LinearAlloc");
   ~ArenaPool();
-  Arena* AllocArena(size_t size) REQUIRES(!lock_);
-  void FreeArenaChain(Arena* first) REQUIRES(!lock_);
-  size_t GetBytesAllocated() const REQUIRES(!lock_);
+  Arena* AllocArena(size_t size);
+  void FreeArenaChain(Arena* first);
+  size_t GetBytesAllocated() const;
   void ReclaimMemory() NO_THREAD_SAFETY_ANALYSIS;
-  void LockReclaimMemory() REQUIRES(!lock_);
+  void LockReclaimMemory();
   // Trim the maps in arenas by madvising, used by JIT to reduce memory usage. This only works
   // use_malloc is false.
-  void TrimMaps() REQUIRES(!lock_);
+  void TrimMaps();
 
  private:
+  static constexpr size_t kNumFreeLists = 8u;
+
+  struct FreeList {
+    FreeList() : lock("Arena pool lock", kArenaPoolLock), arenas(nullptr) {}
+
+    mutable Mutex lock DEFAULT_MUTEX_ACQUIRED_AFTER;
+    Arena* arenas GUARDED_BY(lock);
+  };
+
+  // The index of the free list the current thread uses first.
+  static size_t FreeListIndexForCurrentThread();
+
   const bool use_malloc_;
-  mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
-  Arena* free_arenas_ GUARDED_BY(lock_);
+  FreeList free_lists_[kNumFreeLists];
   const bool low_4gb_;
   const char* name_;
   DISALLOW_COPY_AND_ASSIGN(ArenaPool);
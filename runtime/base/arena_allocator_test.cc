@@ -15,6 +15,9 @@
  */
 
 #include "base/arena_allocator-inl.h"
+
+#include <thread>
+
 #include "base/arena_bit_vector.h"
 #include "base/memory_tool.h"
 #include "gtest/gtest.h"
@@ -64,6 +67,20 @@ TEST_F(ArenaAllocatorTest, MakeDefined) {
   }
 }
 
+TEST_F(ArenaAllocatorTest, ReuseArenaFreedByAnotherThread) {
+  // The arenas freed by a thread go to its own free list, but other threads still reuse them.
+  ArenaPool pool;
+  Arena* arena = pool.AllocArena(arena_allocator::kArenaDefaultSize);
+  ASSERT_TRUE(arena != nullptr);
+  std::thread freeing_thread([&pool, arena]() { pool.FreeArenaChain(arena); });
+  freeing_thread.join();
+  if (!arena_allocator::kArenaAllocatorPreciseTracking) {
+    Arena* reused = pool.AllocArena(arena_allocator::kArenaDefaultSize);
+    EXPECT_EQ(arena, reused);
+    pool.FreeArenaChain(reused);
+  }
+}
+
 TEST_F(ArenaAllocatorTest, LargeAllocations) {
   if (arena_allocator::kArenaAllocatorPreciseTracking) {
     printf("WARNING: TEST DISABLED FOR precise arena tracking\n");
@@ -72,6 +72,8 @@ enum LockLevel {
   kRosAllocGlobalLock,
   kRosAllocBracketLock,
   kRosAllocBulkFreeLock,
+  kIdentityHashTableLock,
+  kStartupTimingsLock,
   kTaggingLockLevel,
   kTransactionLogLock,
   kJniFunctionTableLock,
@@ -84,6 +86,7 @@ enum LockLevel {
   kReferenceQueueClearedReferencesLock,
   kReferenceProcessorLock,
   kJitDebugInterfaceLock,
+  kLargeObjectSizeClassLock,
   kAllocSpaceLock,
   kArenaPoolLock,
   kInternTableLock,
@@ -19,7 +19,9 @@
 
 #include <cstdint>
 
+#include "binary_analyzer_arm64.h"
 #include "binary_analyzer_x86.h"
+#include "fast_jni_cache.h"
 #include "dex/dex_file.h"
 #include "runtime.h"
 //#include "utils.h"
@@ -33,32 +35,49 @@ using namespace capstone;
 
 namespace art {
 
-static bool IsFastJNI(uint32_t method_idx, const DexFile& dex_file, const void* fn_ptr) {
-  bool is_fast = false;
+// Returns whether the native code at `fn_ptr` can be called as @FastNative, and if so,
+// whether it uses its JNIEnv* and jclass arguments.
+static FastJniCache::Verdict AnalyzeFastJNI(uint32_t method_idx,
+                                            const DexFile& dex_file,
+                                            const void* fn_ptr) {
   InstructionSet instruction_set = Runtime::Current()->GetInstructionSet();
   switch (instruction_set) {
     case InstructionSet::kX86:
-    case InstructionSet::kX86_64: {
-      x86::AnalysisResult result = x86::AnalyzeMethod(method_idx, dex_file, fn_ptr);
-      if (result == x86::AnalysisResult::kFast) {
-        is_fast = true;
-        VLOG(autofast_jni) <<  dex_file.PrettyMethod(method_idx) << " is a fast JNI Method";
-      } else {
-        VLOG(autofast_jni) <<  dex_file.PrettyMethod(method_idx) << " is not a fast JNI Method: "
-                           << x86::AnalysisResultToStr(result);
-      }
+    case InstructionSet::kX86_64:
+    case InstructionSet::kArm64:
       break;
-    }
     case InstructionSet::kArm:
-    case InstructionSet::kArm64:
     case InstructionSet::kMips:
     case InstructionSet::kMips64:
-      break;
+      return FastJniCache::Verdict::kNotFast;
     default:
       LOG(ERROR) << "Unsupported ISA!";
-      break;
+      return FastJniCache::Verdict::kNotFast;
+  }
+  FastJniCache* cache = FastJniCache::GetInstance();
+  FastJniCache::Verdict verdict = FastJniCache::Verdict::kNotFast;
+  if (cache->Lookup(dex_file, fn_ptr, &verdict)) {
+    VLOG(autofast_jni) << dex_file.PrettyMethod(method_idx) << " is "
+                       << (verdict != FastJniCache::Verdict::kNotFast ? "" : "not ")
+                       << "a fast JNI Method (cached)";
+    return verdict;
+  }
+  binary_analyzer::AnalysisResult result = (instruction_set == InstructionSet::kArm64)
+      ? arm64::AnalyzeMethod(method_idx, dex_file, fn_ptr)
+      : x86::AnalyzeMethod(method_idx, dex_file, fn_ptr);
+  if (result == binary_analyzer::AnalysisResult::kFast ||
+      result == binary_analyzer::AnalysisResult::kFastNoJniEnv) {
+    verdict = (result == binary_analyzer::AnalysisResult::kFastNoJniEnv)
+        ? FastJniCache::Verdict::kFastNoJniEnv
+        : FastJniCache::Verdict::kFast;
+    VLOG(autofast_jni) <<  dex_file.PrettyMethod(method_idx) << " is a fast JNI Method: "
+                       << binary_analyzer::AnalysisResultToStr(result);
+  } else {
+    VLOG(autofast_jni) <<  dex_file.PrettyMethod(method_idx) << " is not a fast JNI Method: "
+                       << binary_analyzer::AnalysisResultToStr(result);
   }
-  return is_fast;
+  cache->Insert(dex_file, fn_ptr, verdict);
+  return verdict;
 }
 
 }  // namespace art
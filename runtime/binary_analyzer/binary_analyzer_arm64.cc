@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "binary_analyzer_arm64.h"
+
+#include "base/logging.h"
+
+// TODO(VIXL): Make VIXL compile with -Wshadow.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wshadow"
+#include "aarch64/decoder-aarch64.h"
+#include "aarch64/disasm-aarch64.h"
+#pragma GCC diagnostic pop
+
+namespace art {
+namespace arm64 {
+
+using vixl::aarch64::Instruction;
+using binary_analyzer::MachineBlock;
+using binary_analyzer::MachineInstruction;
+
+// LSE atomic memory operations (LDADD, SWP, ...), encoded as:
+//   size 111 V=0 00 A R 1 Rs o3 opc 00 Rn Rt
+static constexpr uint32_t kAtomicMemoryFMask = 0x3f200c00;
+static constexpr uint32_t kAtomicMemoryFixed = 0x38200000;
+
+/**
+ * VIXL disassembler which also records whether the decoder found an unallocated or
+ * unimplemented encoding.
+ */
+class AnalyzerDisassembler FINAL : public vixl::aarch64::Disassembler {
+ public:
+  AnalyzerDisassembler() : vixl::aarch64::Disassembler(), is_unknown_(false) {}
+
+  void VisitUnallocated(const Instruction* instr) OVERRIDE {
+    is_unknown_ = true;
+    vixl::aarch64::Disassembler::VisitUnallocated(instr);
+  }
+
+  void VisitUnimplemented(const Instruction* instr) OVERRIDE {
+    is_unknown_ = true;
+    vixl::aarch64::Disassembler::VisitUnimplemented(instr);
+  }
+
+  bool IsUnknown() const {
+    return is_unknown_;
+  }
+
+  void ResetUnknown() {
+    is_unknown_ = false;
+  }
+
+ private:
+  bool is_unknown_;
+};
+
+/**
+ * @brief Analyze how instruction affects control flow (see binary_analyzer::ControlTransferType)
+ * @param instr_ptr - The instruction pointer.
+ * @param curr_bb - Pointer to the Current Basic Block.
+ * @param is_bb_end - Does the instruction mark the end of Basic Block.
+ * @param target - Adress for direct jump/call.
+ * @param decoder - Decoder to be used for instruction decoding.
+ * @param disasm - Disassembler visitor registered with the decoder.
+ * @return Size of analyzed instruction in bytes.
+ */
+static ptrdiff_t AnalyzeInstruction(const uint8_t* instr_ptr,
+                                    MachineBlock* curr_bb,
+                                    int32_t* is_bb_end,
+                                    const uint8_t** target,
+                                    vixl::aarch64::Decoder* decoder,
+                                    AnalyzerDisassembler* disasm) {
+  const Instruction* instr = reinterpret_cast<const Instruction*>(instr_ptr);
+  disasm->ResetUnknown();
+  decoder->Decode(instr);
+  *is_bb_end = binary_analyzer::kNone;
+  *target = instr_ptr + vixl::aarch64::kInstructionSize;
+
+  if (disasm->IsUnknown()) {
+    *is_bb_end = binary_analyzer::kUnknown;
+  } else if (instr->IsUncondBranchImm()) {
+    // B and BL.
+    *is_bb_end = (instr->Mask(vixl::aarch64::UnconditionalBranchMask) == vixl::aarch64::BL)
+        ? binary_analyzer::kCall
+        : binary_analyzer::kUnconditionalBranch;
+    *target = reinterpret_cast<const uint8_t*>(instr->GetImmPCOffsetTarget());
+  } else if (instr->IsCondBranchImm() || instr->IsCompareBranch() || instr->IsTestBranch()) {
+    // B.cond, CBZ/CBNZ and TBZ/TBNZ.
+    *is_bb_end = binary_analyzer::kConditionalBranch;
+    *target = reinterpret_cast<const uint8_t*>(instr->GetImmPCOffsetTarget());
+  } else if (instr->Mask(vixl::aarch64::UnconditionalBranchToRegisterFMask) ==
+             vixl::aarch64::UnconditionalBranchToRegisterFixed) {
+    switch (instr->Mask(vixl::aarch64::UnconditionalBranchToRegisterMask)) {
+      case vixl::aarch64::RET:
+        *is_bb_end = binary_analyzer::kReturn;
+        break;
+      case vixl::aarch64::BLR:
+        *is_bb_end = binary_analyzer::kIndirectCall;
+        break;
+      default:
+        *is_bb_end = binary_analyzer::kIndirectJump;
+        break;
+    }
+  } else if (instr->Mask(vixl::aarch64::ExceptionFMask) == vixl::aarch64::ExceptionFixed) {
+    // SVC, HVC, SMC, BRK, HLT and DCPS.
+    *is_bb_end = binary_analyzer::kInterrupt;
+  } else if (instr->Mask(vixl::aarch64::LoadStoreExclusiveFMask) ==
+                 vixl::aarch64::LoadStoreExclusiveFixed ||
+             instr->Mask(kAtomicMemoryFMask) == kAtomicMemoryFixed) {
+    // Exclusive, acquire/release and atomic memory accesses are the equivalent of
+    // the x86 lock prefix.
+    *is_bb_end = binary_analyzer::kLock;
+  }
+
+  MachineInstruction* ir = new MachineInstruction(std::string(disasm->GetOutput()),
+                                                  vixl::aarch64::kInstructionSize,
+                                                  instr_ptr);
+  MachineInstruction* prev_ir = curr_bb->GetLastInstruction();
+  ir->SetPrevInstruction(prev_ir);
+  if (prev_ir != nullptr) {
+    prev_ir->SetNextInstruction(ir);
+  }
+  curr_bb->AddInstruction(ir);
+  return vixl::aarch64::kInstructionSize;
+}
+
+binary_analyzer::AnalysisResult AnalyzeMethod(uint32_t method_idx,
+                                              const DexFile& dex_file,
+                                              const void* fn_ptr) {
+  vixl::aarch64::Decoder decoder;
+  AnalyzerDisassembler disasm;
+  decoder.AppendVisitor(&disasm);
+  auto analyze_instruction = [&decoder, &disasm](const uint8_t* instr,
+                                                 MachineBlock* curr_bb,
+                                                 int32_t* is_bb_end,
+                                                 const uint8_t** target) {
+    return AnalyzeInstruction(instr, curr_bb, is_bb_end, target, &decoder, &disasm);
+  };
+  return binary_analyzer::AnalyzeCFG(reinterpret_cast<const uint8_t*>(fn_ptr),
+                                     dex_file.PrettyMethod(method_idx),
+                                     analyze_instruction);
+}
+
+}  // namespace arm64
+}  // namespace art
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_BINARY_ANALYZER_BINARY_ANALYZER_ARM64_H_
+#define ART_RUNTIME_BINARY_ANALYZER_BINARY_ANALYZER_ARM64_H_
+
+#include "dex/dex_file.h"
+#include "machine_cfg.h"
+
+namespace art {
+namespace arm64 {
+
+/**
+ * @brief Analyze an ARM64 method and determine whether it can be marked fast or not.
+ * The CFG construction, the budgetary constraints and the call graph cycle detection are
+ * shared with the other ISAs, only the instruction decoding is done with VIXL.
+ * @param method_idx - dex method Index.
+ * @param dex_file - dex File.
+ * @param fn_ptr - Function pointer of method to be analyzed.
+ * @return the analysis result for the method.
+ */
+binary_analyzer::AnalysisResult AnalyzeMethod(uint32_t method_idx,
+                                              const DexFile& dex_file,
+                                              const void* fn_ptr);
+
+}  // namespace arm64
+}  // namespace art
+
+#endif  // ART_RUNTIME_BINARY_ANALYZER_BINARY_ANALYZER_ARM64_H_
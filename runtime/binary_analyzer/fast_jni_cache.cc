@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fast_jni_cache.h"
+
+#include <fcntl.h>
+#include <link.h>
+#include <unistd.h>
+
+#include <cinttypes>
+#include <cstring>
+#include <vector>
+
+#include <android-base/stringprintf.h>
+
+#include "base/bit_utils.h"
+#include "base/file_utils.h"
+#include "base/logging.h"
+#include "base/utils.h"
+#include "dex/dex_file.h"
+#include "oat_file.h"
+#include "runtime.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+namespace {
+
+constexpr char kGnuNoteName[] = "GNU";
+
+struct BuildIdSearch {
+  uintptr_t address;
+  uintptr_t base;
+  std::string build_id;
+};
+
+// dl_iterate_phdr() callback: find the library containing `address` and read its build-id
+// from the NT_GNU_BUILD_ID note, which the loader maps with the rest of the library.
+int FindBuildId(struct dl_phdr_info* info, size_t size ATTRIBUTE_UNUSED, void* data) {
+  BuildIdSearch* search = reinterpret_cast<BuildIdSearch*>(data);
+  bool contains = false;
+  for (ElfW(Half) i = 0; i < info->dlpi_phnum && !contains; ++i) {
+    const ElfW(Phdr)& phdr = info->dlpi_phdr[i];
+    uintptr_t start = info->dlpi_addr + phdr.p_vaddr;
+    contains = phdr.p_type == PT_LOAD &&
+               search->address >= start &&
+               search->address < start + phdr.p_memsz;
+  }
+  if (!contains) {
+    return 0;  // Continue with the next library.
+  }
+  search->base = info->dlpi_addr;
+  for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i) {
+    const ElfW(Phdr)& phdr = info->dlpi_phdr[i];
+    if (phdr.p_type != PT_NOTE) {
+      continue;
+    }
+    const uint8_t* note = reinterpret_cast<const uint8_t*>(info->dlpi_addr + phdr.p_vaddr);
+    const uint8_t* end = note + phdr.p_memsz;
+    while (note + sizeof(ElfW(Nhdr)) <= end) {
+      const ElfW(Nhdr)* nhdr = reinterpret_cast<const ElfW(Nhdr)*>(note);
+      const uint8_t* name = note + sizeof(ElfW(Nhdr));
+      const uint8_t* desc = name + RoundUp(nhdr->n_namesz, 4u);
+      if (desc + nhdr->n_descsz > end) {
+        break;
+      }
+      if (nhdr->n_type == NT_GNU_BUILD_ID &&
+          nhdr->n_namesz == sizeof(kGnuNoteName) &&
+          memcmp(name, kGnuNoteName, sizeof(kGnuNoteName)) == 0) {
+        for (size_t j = 0; j < nhdr->n_descsz; ++j) {
+          search->build_id += android::base::StringPrintf("%02x", desc[j]);
+        }
+        return 1;
+      }
+      note = desc + RoundUp(nhdr->n_descsz, 4u);
+    }
+  }
+  return 1;  // Found the library, but it has no build-id.
+}
+
+}  // namespace
+
+FastJniCache* FastJniCache::GetInstance() {
+  static FastJniCache* instance = new FastJniCache();
+  return instance;
+}
+
+FastJniCache::FastJniCache() : lock_("fast JNI cache lock") {}
+
+bool FastJniCache::GetKey(const void* fn_ptr, /*out*/ std::string* key) {
+  BuildIdSearch search = { reinterpret_cast<uintptr_t>(fn_ptr), 0u, std::string() };
+  dl_iterate_phdr(FindBuildId, &search);
+  if (search.build_id.empty()) {
+    return false;
+  }
+  *key = android::base::StringPrintf("%s@%" PRIxPTR,
+                                     search.build_id.c_str(),
+                                     search.address - search.base);
+  return true;
+}
+
+std::string FastJniCache::GetCacheFileLocation(const DexFile& dex_file) {
+  if (!Runtime::Current()->IsAutoFastPersist()) {
+    return std::string();
+  }
+  const OatDexFile* oat_dex_file = dex_file.GetOatDexFile();
+  if (oat_dex_file == nullptr || oat_dex_file->GetOatFile() == nullptr) {
+    return std::string();
+  }
+  return ReplaceFileExtension(oat_dex_file->GetOatFile()->GetLocation(), "fjni");
+}
+
+void FastJniCache::MaybeLoad(const std::string& location) {
+  if (location.empty() || !loaded_locations_.insert(location).second) {
+    return;
+  }
+  std::string content;
+  if (!ReadFileToString(location, &content)) {
+    return;
+  }
+  std::vector<std::string> lines;
+  Split(content, '\n', &lines);
+  for (const std::string& line : lines) {
+    std::vector<std::string> fields;
+    Split(line, ' ', &fields);
+    if (fields.size() != 2u ||
+        fields[1].size() != 1u ||
+        fields[1][0] < '0' ||
+        fields[1][0] > '0' + static_cast<char>(Verdict::kFastNoJniEnv)) {
+      // Skip a line truncated by a concurrent or interrupted write.
+      continue;
+    }
+    verdicts_.emplace(fields[0], static_cast<Verdict>(fields[1][0] - '0'));
+  }
+  VLOG(autofast_jni) << "Loaded fast JNI verdicts from " << location;
+}
+
+bool FastJniCache::Lookup(const DexFile& dex_file,
+                          const void* fn_ptr,
+                          /*out*/ Verdict* verdict) {
+  std::string key;
+  if (!GetKey(fn_ptr, &key)) {
+    return false;
+  }
+  std::string location = GetCacheFileLocation(dex_file);
+  MutexLock mu(Thread::Current(), lock_);
+  MaybeLoad(location);
+  auto it = verdicts_.find(key);
+  if (it == verdicts_.end()) {
+    return false;
+  }
+  *verdict = it->second;
+  return true;
+}
+
+void FastJniCache::Insert(const DexFile& dex_file, const void* fn_ptr, Verdict verdict) {
+  std::string key;
+  if (!GetKey(fn_ptr, &key)) {
+    return;
+  }
+  std::string location = GetCacheFileLocation(dex_file);
+  MutexLock mu(Thread::Current(), lock_);
+  if (!verdicts_.emplace(key, verdict).second ||
+      location.empty() ||
+      unwritable_locations_.find(location) != unwritable_locations_.end()) {
+    return;
+  }
+  // Append a single line, so that an interrupted write only loses this verdict.
+  std::string line = android::base::StringPrintf("%s %d\n",
+                                                 key.c_str(),
+                                                 static_cast<int>(verdict));
+  int fd = TEMP_FAILURE_RETRY(
+      open(location.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0600));
+  bool written = false;
+  if (fd >= 0) {
+    written = TEMP_FAILURE_RETRY(write(fd, line.data(), line.size())) ==
+              static_cast<ssize_t>(line.size());
+    close(fd);
+  }
+  if (!written) {
+    VLOG(autofast_jni) << "Cannot persist fast JNI verdicts to " << location;
+    unwritable_locations_.insert(location);
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_BINARY_ANALYZER_FAST_JNI_CACHE_H_
+#define ART_RUNTIME_BINARY_ANALYZER_FAST_JNI_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art {
+
+class DexFile;
+
+// Cache of the autofast JNI analysis verdicts.
+//
+// A native method is identified by the GNU build-id of the library containing its entry
+// point and the offset of the entry point in that library, so a verdict stays valid for
+// as long as the library is unchanged. A fast verdict never depends on other libraries:
+// calls through the PLT are indirect jumps, which the analysis rejects.
+//
+// When enabled by the runtime, verdicts are also persisted next to the oat file of the
+// dex file declaring the method, one "<build-id>@<offset> <0|1|2>" line per verdict, so
+// that later launches of the same app skip the analysis.
+class FastJniCache {
+ public:
+  // Verdict of the analysis of some native code. The values are the persisted ones.
+  enum class Verdict : uint8_t {
+    kNotFast = 0,       // Needs the normal JNI transition.
+    kFast = 1,          // Can be called as @FastNative.
+    kFastNoJniEnv = 2,  // Can be called as @FastNative and uses neither JNIEnv* nor jclass.
+  };
+
+  static FastJniCache* GetInstance();
+
+  // Look up the verdict for the native code at `fn_ptr`. Returns false if there is none.
+  bool Lookup(const DexFile& dex_file, const void* fn_ptr, /*out*/ Verdict* verdict)
+      REQUIRES(!lock_);
+
+  // Record the verdict for the native code at `fn_ptr`.
+  void Insert(const DexFile& dex_file, const void* fn_ptr, Verdict verdict) REQUIRES(!lock_);
+
+ private:
+  FastJniCache();
+
+  // Compute the cache key of `fn_ptr`. Fails if the containing library has no build-id.
+  static bool GetKey(const void* fn_ptr, /*out*/ std::string* key);
+
+  // Location of the persisted cache for `dex_file`, or empty if not persisted.
+  static std::string GetCacheFileLocation(const DexFile& dex_file);
+
+  void MaybeLoad(const std::string& location) REQUIRES(lock_);
+
+  Mutex lock_;
+  std::unordered_map<std::string, Verdict> verdicts_ GUARDED_BY(lock_);
+  // Persisted caches already read, and those that could not be written.
+  std::unordered_set<std::string> loaded_locations_ GUARDED_BY(lock_);
+  std::unordered_set<std::string> unwritable_locations_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(FastJniCache);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_BINARY_ANALYZER_FAST_JNI_CACHE_H_
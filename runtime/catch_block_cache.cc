@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "catch_block_cache.h"
+
+#include <atomic>
+
+#include "art_method-inl.h"
+#include "base/atomic.h"
+#include "base/bit_utils.h"
+#include "mirror/class-inl.h"
+
+namespace art {
+
+// An entry is written under a sequence lock: `sequence` is odd while a writer updates the
+// other fields, which readers check by reading `sequence` before and after them.
+struct CatchBlockCacheEntry {
+  Atomic<uint32_t> sequence;
+  Atomic<uint32_t> epoch;
+  Atomic<uintptr_t> method;
+  Atomic<uintptr_t> code_item;
+  Atomic<uintptr_t> exception_dex_file;
+  Atomic<uint32_t> exception_type;
+  Atomic<uint32_t> dex_pc;
+  Atomic<uint32_t> handler_dex_pc;
+  Atomic<bool> has_no_move_exception;
+};
+
+static constexpr size_t kCatchBlockCacheSize = 256;
+static CatchBlockCacheEntry gCatchBlockCache[kCatchBlockCacheSize];
+
+// Bumped when methods are freed, since their memory may be reused for other methods.
+// Entries of older epochs are stale.
+static Atomic<uint32_t> gCatchBlockCacheEpoch(0u);
+
+static CatchBlockCacheEntry* GetEntry(ArtMethod* method, uint32_t dex_pc) {
+  static_assert(IsPowerOfTwo(kCatchBlockCacheSize), "Cache size must be a power of two");
+  uintptr_t key = (reinterpret_cast<uintptr_t>(method) >> 3) ^ (dex_pc * 0x9e3779b1u);
+  return &gCatchBlockCache[(key ^ (key >> 12)) & (kCatchBlockCacheSize - 1)];
+}
+
+// Classes may be moved by the GC, so an exception class is not keyed on its address but on the
+// dex file and type index defining it. These name a single class if the class comes from the
+// boot class path or from the class loader of the method, which the key records.
+static bool IsCacheable(ArtMethod* method, ObjPtr<mirror::Class> exception_class)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (exception_class->GetDexCache() == nullptr) {
+    return false;
+  }
+  ObjPtr<mirror::ClassLoader> class_loader = exception_class->GetClassLoader();
+  return class_loader == nullptr || class_loader == method->GetClassLoader();
+}
+
+static uintptr_t GetExceptionDexFile(ObjPtr<mirror::Class> exception_class)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  return reinterpret_cast<uintptr_t>(&exception_class->GetDexFile());
+}
+
+// The type index of the exception class, and whether the class is from the boot class path.
+static uint32_t GetExceptionType(ObjPtr<mirror::Class> exception_class)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  static_assert(sizeof(dex::TypeIndex::index_) == sizeof(uint16_t), "Type indexes are 16 bits");
+  uint32_t boot_bit = (exception_class->GetClassLoader() == nullptr) ? (1u << 16) : 0u;
+  return exception_class->GetDexTypeIndex().index_ | boot_bit;
+}
+
+bool CatchBlockCache::Lookup(ArtMethod* method,
+                             uint32_t dex_pc,
+                             ObjPtr<mirror::Class> exception_class,
+                             /*out*/ uint32_t* handler_dex_pc,
+                             /*out*/ bool* has_no_move_exception) {
+  if (!IsCacheable(method, exception_class)) {
+    return false;
+  }
+  CatchBlockCacheEntry* entry = GetEntry(method, dex_pc);
+  uint32_t sequence = entry->sequence.LoadAcquire();
+  if ((sequence & 1u) != 0u) {
+    return false;
+  }
+  // The code item changes when the method is redefined.
+  uintptr_t code_item = reinterpret_cast<uintptr_t>(method->GetCodeItem());
+  bool hit =
+      entry->epoch.LoadRelaxed() == gCatchBlockCacheEpoch.LoadAcquire() &&
+      entry->method.LoadRelaxed() == reinterpret_cast<uintptr_t>(method) &&
+      entry->code_item.LoadRelaxed() == code_item &&
+      entry->exception_dex_file.LoadRelaxed() == GetExceptionDexFile(exception_class) &&
+      entry->exception_type.LoadRelaxed() == GetExceptionType(exception_class) &&
+      entry->dex_pc.LoadRelaxed() == dex_pc;
+  uint32_t found_dex_pc = entry->handler_dex_pc.LoadRelaxed();
+  bool no_move_exception = entry->has_no_move_exception.LoadRelaxed();
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (!hit || entry->sequence.LoadRelaxed() != sequence) {
+    return false;
+  }
+  *handler_dex_pc = found_dex_pc;
+  *has_no_move_exception = no_move_exception;
+  return true;
+}
+
+void CatchBlockCache::Insert(ArtMethod* method,
+                             uint32_t dex_pc,
+                             ObjPtr<mirror::Class> exception_class,
+                             uint32_t handler_dex_pc,
+                             bool has_no_move_exception) {
+  if (!IsCacheable(method, exception_class)) {
+    return;
+  }
+  CatchBlockCacheEntry* entry = GetEntry(method, dex_pc);
+  uint32_t sequence = entry->sequence.LoadRelaxed();
+  // Leave the entry alone if another thread is updating it.
+  if ((sequence & 1u) != 0u ||
+      !entry->sequence.CompareAndExchangeStrongAcquire(&sequence, sequence + 1u)) {
+    return;
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+  entry->epoch.StoreRelaxed(gCatchBlockCacheEpoch.LoadAcquire());
+  entry->method.StoreRelaxed(reinterpret_cast<uintptr_t>(method));
+  entry->code_item.StoreRelaxed(reinterpret_cast<uintptr_t>(method->GetCodeItem()));
+  entry->exception_dex_file.StoreRelaxed(GetExceptionDexFile(exception_class));
+  entry->exception_type.StoreRelaxed(GetExceptionType(exception_class));
+  entry->dex_pc.StoreRelaxed(dex_pc);
+  entry->handler_dex_pc.StoreRelaxed(handler_dex_pc);
+  entry->has_no_move_exception.StoreRelaxed(has_no_move_exception);
+  entry->sequence.StoreRelease(sequence + 2u);
+}
+
+void CatchBlockCache::Invalidate() {
+  gCatchBlockCacheEpoch.FetchAndAddSequentiallyConsistent(1u);
+}
+
+}  // namespace art
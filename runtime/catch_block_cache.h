@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_CATCH_BLOCK_CACHE_H_
+#define ART_RUNTIME_CATCH_BLOCK_CACHE_H_
+
+#include <stdint.h>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "obj_ptr.h"
+
+namespace art {
+
+class ArtMethod;
+
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+// Global cache of the catch handlers found for a thrown exception class at a dex pc of
+// a method, in front of ArtMethod::FindCatchBlock, for code using exceptions for control
+// flow. The exception classes are keyed on their dex file and type index, as the GC may
+// move them. The cache is lock free: lookups may miss under concurrent updates, but never
+// return the handler of another entry.
+class CatchBlockCache {
+ public:
+  // Look up the handler of `method` at `dex_pc` for exceptions of class `exception_class`.
+  // Returns whether it is in the cache, and then sets `handler_dex_pc` (which may be
+  // dex::kDexNoIndex if there is no handler) and `has_no_move_exception`.
+  static bool Lookup(ArtMethod* method,
+                     uint32_t dex_pc,
+                     ObjPtr<mirror::Class> exception_class,
+                     /*out*/ uint32_t* handler_dex_pc,
+                     /*out*/ bool* has_no_move_exception)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Record the result of ArtMethod::FindCatchBlock for the given arguments.
+  static void Insert(ArtMethod* method,
+                     uint32_t dex_pc,
+                     ObjPtr<mirror::Class> exception_class,
+                     uint32_t handler_dex_pc,
+                     bool has_no_move_exception)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Invalidate all entries, before the methods of a class loader are freed.
+  static void Invalidate();
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(CatchBlockCache);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_CATCH_BLOCK_CACHE_H_
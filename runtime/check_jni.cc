@@ -2724,8 +2724,7 @@ class CheckJNI {
     JniValueType args[2] = {{.E = env}, {.L = buf}};
     if (sc.Check(soa, true, "EL", args)) {
       JniValueType result;
-      // Note: this is implemented in the base environment by a GetLongField which will sanity
-      // check the type of buf in GetLongField above.
+      // Note: the base environment returns null if buf is not a direct buffer.
       result.p = baseEnv(env)->GetDirectBufferAddress(env, buf);
       if (sc.Check(soa, false, "p", &result)) {
         return const_cast<void*>(result.p);
@@ -2741,8 +2740,7 @@ class CheckJNI {
     JniValueType args[2] = {{.E = env}, {.L = buf}};
     if (sc.Check(soa, true, "EL", args)) {
       JniValueType result;
-      // Note: this is implemented in the base environment by a GetIntField which will sanity
-      // check the type of buf in GetIntField above.
+      // Note: the base environment returns -1 if buf is not a direct buffer.
       result.J = baseEnv(env)->GetDirectBufferCapacity(env, buf);
       if (sc.Check(soa, false, "J", &result)) {
         return result.J;
@@ -48,11 +48,13 @@
 #include "base/unix_file/fd_file.h"
 #include "base/utils.h"
 #include "base/value_object.h"
+#include "catch_block_cache.h"
 #include "cha.h"
 #include "class_linker-inl.h"
 #include "class_loader_utils.h"
 #include "class_table-inl.h"
 #include "compiler_callbacks.h"
+#include "compiler_filter.h"
 #include "debug_print.h"
 #include "debugger.h"
 #include "dex/descriptors_names.h"
@@ -79,6 +81,7 @@
 #include "imtable-inl.h"
 #include "intern_table.h"
 #include "interpreter/interpreter.h"
+#include "interpreter/interpreter_cache.h"
 #include "java_vm_ext.h"
 #include "jit/debugger_interface.h"
 #include "jit/jit.h"
@@ -116,9 +119,12 @@
 #include "oat_file_assistant.h"
 #include "oat_file_manager.h"
 #include "object_lock.h"
+#include "reflective_access_cache.h"
 #include "runtime.h"
 #include "runtime_callbacks.h"
 #include "scoped_thread_state_change-inl.h"
+#include "stack_map.h"
+#include "startup_timings.h"
 #include "thread-inl.h"
 #include "thread_list.h"
 #include "trace.h"
@@ -126,6 +132,10 @@
 #include "verifier/method_verifier.h"
 #include "well_known_classes.h"
 
+#ifdef VTUNE_ART
+#include "vtune_tasks.h"
+#endif
+
 namespace art {
 
 using android::base::StringPrintf;
@@ -1338,13 +1348,12 @@ void AppImageClassLoadersAndDexCachesHelper::Update(
       }
     }
   }
-  if (ClassLinker::kAppImageMayContainStrings) {
+  if (ClassLinker::kAppImageMayContainStrings || header.HasInitializedClasses()) {
     // Fixup all the literal strings happens at app images which are supposed to be interned.
     ScopedTrace timing("Fixup String Intern in image and dex_cache");
-    const auto& image_header = space->GetImageHeader();
     const auto bitmap = space->GetMarkBitmap();  // bitmap of objects
     const uint8_t* target_base = space->GetMemMap()->Begin();
-    const ImageSection& objects_section = image_header.GetObjectsSection();
+    const ImageSection& objects_section = header.GetObjectsSection();
 
     uintptr_t objects_begin = reinterpret_cast<uintptr_t>(target_base + objects_section.Offset());
     uintptr_t objects_end = reinterpret_cast<uintptr_t>(target_base + objects_section.End());
@@ -2193,6 +2202,14 @@ void ClassLinker::DeleteClassLoader(Thread* self, const ClassLoaderData& data, b
   Runtime* const runtime = Runtime::Current();
   JavaVMExt* const vm = runtime->GetJavaVM();
   vm->DeleteWeakGlobalRef(self, data.weak_root);
+  // The methods about to be freed may be cached with their catch handlers, the fields and
+  // methods by the interpreter, the methods with their reflective access checks, and the
+  // methods and their code by the stack walks.
+  CatchBlockCache::Invalidate();
+  interpreter::InterpreterCache::InvalidateAll();
+  ReflectiveAccessCache::InvalidateAll();
+  FrameInfoCache::InvalidateAll();
+  CodeInfo::InvalidateStackMapIndexCache();
   // Notify the JIT that we need to remove the methods and/or profiling info.
   if (runtime->GetJit() != nullptr) {
     jit::JitCodeCache* code_cache = runtime->GetJit()->GetCodeCache();
@@ -2470,11 +2487,26 @@ ObjPtr<mirror::Class> ClassLinker::FindClassInBaseDexClassLoaderClassPath(
   DCHECK(IsPathOrDexClassLoader(soa, class_loader) || IsDelegateLastClassLoader(soa, class_loader))
       << "Unexpected class loader for descriptor " << descriptor;
 
+  // Skip the dex files if they are known not to define the class. The dex elements array is
+  // replaced when dex files are added to the class loader, which drops the known missing classes.
+  ClassTable* const class_table = ClassTableForClassLoader(class_loader.Get());
+  ObjPtr<mirror::ObjectArray<mirror::Object>> dex_elements =
+      GetClassLoaderDexElements(class_loader);
+  const size_t num_dex_elements = (dex_elements != nullptr) ? dex_elements->GetLength() : 0u;
+  if (class_table != nullptr &&
+      class_table->IsKnownMissingClass(descriptor, hash, dex_elements, num_dex_elements)) {
+    return nullptr;
+  }
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::ObjectArray<mirror::Object>> h_dex_elements(hs.NewHandle(dex_elements));
+
   ObjPtr<mirror::Class> ret;
+  bool found_class_def = false;
   auto define_class = [&](const DexFile* cp_dex_file) REQUIRES_SHARED(Locks::mutator_lock_) {
     const DexFile::ClassDef* dex_class_def =
         OatDexFile::FindClassDef(*cp_dex_file, descriptor, hash);
     if (dex_class_def != nullptr) {
+      found_class_def = true;
       ObjPtr<mirror::Class> klass = DefineClass(soa.Self(),
                                                 descriptor,
                                                 hash,
@@ -2493,6 +2525,11 @@ ObjPtr<mirror::Class> ClassLinker::FindClassInBaseDexClassLoaderClassPath(
   };
 
   VisitClassLoaderDexFiles(soa, class_loader, define_class);
+  // Only record the misses of all the dex files. A failure to define the class is not cached,
+  // the erroneous class is found in the class table, or the definition retried.
+  if (!found_class_def && class_table != nullptr) {
+    class_table->AddKnownMissingClass(descriptor, hash, h_dex_elements.Get(), num_dex_elements);
+  }
   return ret;
 }
 
@@ -2673,6 +2710,7 @@ mirror::Class* ClassLinker::DefineClass(Thread* self,
                                         Handle<mirror::ClassLoader> class_loader,
                                         const DexFile& dex_file,
                                         const DexFile::ClassDef& dex_class_def) {
+  ScopedStartupTiming timing(StartupTimings::kClassLoading, descriptor);
   StackHandleScope<3> hs(self);
   auto klass = hs.NewHandle<mirror::Class>(nullptr);
 
@@ -3112,7 +3150,7 @@ LengthPrefixedArray<ArtField>* ClassLinker::AllocArtFieldArray(Thread* self,
   // If the ArtField alignment changes, review all uses of LengthPrefixedArray<ArtField>.
   static_assert(alignof(ArtField) == 4, "ArtField alignment is expected to be 4.");
   size_t storage_size = LengthPrefixedArray<ArtField>::ComputeSize(length);
-  void* array_storage = allocator->Alloc(self, storage_size);
+  void* array_storage = allocator->Alloc(self, storage_size, kLinearAllocArtFieldArray);
   auto* ret = new(array_storage) LengthPrefixedArray<ArtField>(length);
   CHECK(ret != nullptr);
   std::uninitialized_fill_n(&ret->At(0), length, ArtField());
@@ -3129,7 +3167,7 @@ LengthPrefixedArray<ArtMethod>* ClassLinker::AllocArtMethodArray(Thread* self,
   const size_t method_size = ArtMethod::Size(image_pointer_size_);
   const size_t storage_size =
       LengthPrefixedArray<ArtMethod>::ComputeSize(length, method_size, method_alignment);
-  void* array_storage = allocator->Alloc(self, storage_size);
+  void* array_storage = allocator->Alloc(self, storage_size, kLinearAllocArtMethodArray);
   auto* ret = new (array_storage) LengthPrefixedArray<ArtMethod>(length);
   CHECK(ret != nullptr);
   for (size_t i = 0; i < length; ++i) {
@@ -3489,6 +3527,24 @@ void ClassLinker::RegisterExistingDexCache(ObjPtr<mirror::DexCache> dex_cache,
   }
 }
 
+// Return true if the dex cache of `dex_file` gets large string and type caches. The dex files
+// compiled with a profile are those of the apps used enough to have one, and the ids of a large
+// dex file collide in the default caches, which sends the compiled code to the resolution
+// entrypoints. The AOT compiler keeps the default sizes, which are those of the image dex caches.
+static bool UseLargeDexCaches(const DexFile& dex_file) {
+  if (Runtime::Current()->IsAotCompiler()) {
+    return false;
+  }
+  if (dex_file.NumStringIds() <= mirror::DexCache::kDexCacheStringCacheSize &&
+      dex_file.NumTypeIds() <= mirror::DexCache::kDexCacheTypeCacheSize) {
+    return false;
+  }
+  const OatDexFile* oat_dex_file = dex_file.GetOatDexFile();
+  return oat_dex_file != nullptr &&
+      oat_dex_file->GetOatFile() != nullptr &&
+      CompilerFilter::DependsOnProfile(oat_dex_file->GetOatFile()->GetCompilerFilter());
+}
+
 ObjPtr<mirror::DexCache> ClassLinker::RegisterDexFile(const DexFile& dex_file,
                                                       ObjPtr<mirror::ClassLoader> class_loader) {
   Thread* self = Thread::Current();
@@ -3531,7 +3587,8 @@ ObjPtr<mirror::DexCache> ClassLinker::RegisterDexFile(const DexFile& dex_file,
                                            h_location.Get(),
                                            &dex_file,
                                            linear_alloc,
-                                           image_pointer_size_);
+                                           image_pointer_size_,
+                                           UseLargeDexCaches(dex_file));
       RegisterDexFileLocked(dex_file, h_dex_cache.Get(), h_class_loader.Get());
     }
   }
@@ -4230,6 +4287,8 @@ verifier::FailureKind ClassLinker::PerformClassVerification(Thread* self,
                                                             verifier::HardFailLogMode log_level,
                                                             std::string* error_msg) {
   Runtime* const runtime = Runtime::Current();
+  std::string temp;
+  ScopedStartupTiming timing(StartupTimings::kClassVerification, klass->GetDescriptor(&temp));
   return verifier::MethodVerifier::VerifyClass(self,
                                                klass.Get(),
                                                runtime->GetCompilerCallbacks(),
@@ -4657,6 +4716,9 @@ bool ClassLinker::InitializeClass(Thread* self, Handle<mirror::Class> klass,
     return false;
   }
 
+#ifdef VTUNE_ART
+  ScopedVTuneTask vtune_task(VTuneTask::kClassInitialization);
+#endif
   self->AllowThreadSuspension();
   uint64_t t0;
   {
@@ -4879,6 +4941,8 @@ bool ClassLinker::InitializeClass(Thread* self, Handle<mirror::Class> klass,
     ArtMethod* clinit = klass->FindClassInitializer(image_pointer_size_);
     if (clinit != nullptr) {
       CHECK(can_init_statics);
+      std::string temp;
+      ScopedStartupTiming timing(StartupTimings::kClassInitialization, klass->GetDescriptor(&temp));
       JValue result;
       clinit->Invoke(self, nullptr, 0, &result, "V");
     }
@@ -5374,8 +5438,8 @@ bool ClassLinker::LinkClass(Thread* self,
     }
     if (imt == nullptr) {
       LinearAlloc* allocator = GetAllocatorForClassLoader(klass->GetClassLoader());
-      imt = reinterpret_cast<ImTable*>(
-          allocator->Alloc(self, ImTable::SizeInBytes(image_pointer_size_)));
+      imt = reinterpret_cast<ImTable*>(allocator->Alloc(
+          self, ImTable::SizeInBytes(image_pointer_size_), kLinearAllocImTable));
       if (imt == nullptr) {
         return false;
       }
@@ -6156,8 +6220,9 @@ ArtMethod* ClassLinker::AddMethodToConflictTable(ObjPtr<mirror::Class> klass,
   // Allocate a new table. Note that we will leak this table at the next conflict,
   // but that's a tradeoff compared to making the table fixed size.
   void* data = linear_alloc->Alloc(
-      Thread::Current(), ImtConflictTable::ComputeSizeWithOneMoreEntry(current_table,
-                                                                       image_pointer_size_));
+      Thread::Current(),
+      ImtConflictTable::ComputeSizeWithOneMoreEntry(current_table, image_pointer_size_),
+      kLinearAllocImtConflictTable);
   if (data == nullptr) {
     LOG(ERROR) << "Failed to allocate conflict table";
     return conflict_method;
@@ -6309,8 +6374,8 @@ ImtConflictTable* ClassLinker::CreateImtConflictTable(size_t count,
                                                       LinearAlloc* linear_alloc,
                                                       PointerSize image_pointer_size) {
   void* data = linear_alloc->Alloc(Thread::Current(),
-                                   ImtConflictTable::ComputeSize(count,
-                                                                 image_pointer_size));
+                                   ImtConflictTable::ComputeSize(count, image_pointer_size),
+                                   kLinearAllocImtConflictTable);
   return (data != nullptr) ? new (data) ImtConflictTable(count, image_pointer_size) : nullptr;
 }
 
@@ -7024,7 +7089,7 @@ void ClassLinker::LinkInterfaceMethodsHelper::ReallocMethods() {
   const size_t old_methods_ptr_size = (old_methods != nullptr) ? old_size : 0;
   auto* methods = reinterpret_cast<LengthPrefixedArray<ArtMethod>*>(
       class_linker_->GetAllocatorForClassLoader(klass_->GetClassLoader())->Realloc(
-          self_, old_methods, old_methods_ptr_size, new_size));
+          self_, old_methods, old_methods_ptr_size, new_size, kLinearAllocArtMethodArray));
   CHECK(methods != nullptr);  // Native allocation failure aborts.
 
   PointerSize pointer_size = class_linker_->GetImagePointerSize();
@@ -7744,6 +7809,22 @@ void ClassLinker::CreateReferenceInstanceOffsets(Handle<mirror::Class> klass) {
   klass->SetReferenceInstanceOffsets(reference_offsets);
 }
 
+void ClassLinker::RecordStringDexCacheMiss(ObjPtr<mirror::DexCache> dex_cache,
+                                           dex::StringIndex string_idx) {
+  string_dex_cache_misses_.FetchAndAddRelaxed(1u);
+  if (dex_cache->IsStringSlotTaken(string_idx)) {
+    string_dex_cache_collisions_.FetchAndAddRelaxed(1u);
+  }
+}
+
+void ClassLinker::RecordTypeDexCacheMiss(ObjPtr<mirror::DexCache> dex_cache,
+                                         dex::TypeIndex type_idx) {
+  type_dex_cache_misses_.FetchAndAddRelaxed(1u);
+  if (dex_cache->IsTypeSlotTaken(type_idx)) {
+    type_dex_cache_collisions_.FetchAndAddRelaxed(1u);
+  }
+}
+
 ObjPtr<mirror::String> ClassLinker::ResolveString(dex::StringIndex string_idx,
                                                   Handle<mirror::DexCache> dex_cache) {
   DCHECK(dex_cache != nullptr);
@@ -7752,6 +7833,7 @@ ObjPtr<mirror::String> ClassLinker::ResolveString(dex::StringIndex string_idx,
   if (resolved != nullptr) {
     return resolved;
   }
+  RecordStringDexCacheMiss(dex_cache.Get(), string_idx);
   const DexFile& dex_file = *dex_cache->GetDexFile();
   uint32_t utf16_length;
   const char* utf8_data = dex_file.StringDataAndUtf16LengthByIdx(string_idx, &utf16_length);
@@ -7769,6 +7851,7 @@ ObjPtr<mirror::String> ClassLinker::LookupString(dex::StringIndex string_idx,
   if (resolved != nullptr) {
     return resolved;
   }
+  RecordStringDexCacheMiss(dex_cache, string_idx);
   const DexFile& dex_file = *dex_cache->GetDexFile();
   uint32_t utf16_length;
   const char* utf8_data = dex_file.StringDataAndUtf16LengthByIdx(string_idx, &utf16_length);
@@ -7783,6 +7866,7 @@ ObjPtr<mirror::String> ClassLinker::LookupString(dex::StringIndex string_idx,
 ObjPtr<mirror::Class> ClassLinker::DoLookupResolvedType(dex::TypeIndex type_idx,
                                                         ObjPtr<mirror::DexCache> dex_cache,
                                                         ObjPtr<mirror::ClassLoader> class_loader) {
+  RecordTypeDexCacheMiss(dex_cache, type_idx);
   const DexFile& dex_file = *dex_cache->GetDexFile();
   const char* descriptor = dex_file.StringByTypeIdx(type_idx);
   DCHECK_NE(*descriptor, '\0') << "descriptor is empty string";
@@ -7811,6 +7895,7 @@ ObjPtr<mirror::Class> ClassLinker::DoLookupResolvedType(dex::TypeIndex type_idx,
 ObjPtr<mirror::Class> ClassLinker::DoResolveType(dex::TypeIndex type_idx,
                                                  Handle<mirror::DexCache> dex_cache,
                                                  Handle<mirror::ClassLoader> class_loader) {
+  RecordTypeDexCacheMiss(dex_cache.Get(), type_idx);
   Thread* self = Thread::Current();
   const char* descriptor = dex_cache->GetDexFile()->StringByTypeIdx(type_idx);
   ObjPtr<mirror::Class> resolved = FindClass(self, descriptor, class_loader);
@@ -8590,6 +8675,26 @@ void ClassLinker::DumpForSigQuit(std::ostream& os) {
   ReaderMutexLock mu(soa.Self(), *Locks::classlinker_classes_lock_);
   os << "Zygote loaded classes=" << NumZygoteClasses() << " post zygote classes="
      << NumNonZygoteClasses() << "\n";
+  // A collision is a miss finding the slot of the index holding another index.
+  auto dump_dex_cache_stats = [&os](const char* kind, uint64_t misses, uint64_t collisions) {
+    os << "Dex cache " << kind << " misses=" << misses << " collisions=" << collisions;
+    if (misses != 0u) {
+      os << " (" << (collisions * 100u / misses) << "%)";
+    }
+    os << "\n";
+  };
+  dump_dex_cache_stats("string",
+                       string_dex_cache_misses_.LoadRelaxed(),
+                       string_dex_cache_collisions_.LoadRelaxed());
+  dump_dex_cache_stats("type",
+                       type_dex_cache_misses_.LoadRelaxed(),
+                       type_dex_cache_collisions_.LoadRelaxed());
+  os << "Boot class loader linear alloc:\n";
+  Runtime::Current()->GetLinearAlloc()->DumpMemoryStats(os);
+  for (const ClassLoaderData& data : class_loaders_) {
+    os << "Class loader " << data.weak_root << " linear alloc:\n";
+    data.allocator->DumpMemoryStats(os);
+  }
 }
 
 class CountClassesVisitor : public ClassLoaderVisitor {
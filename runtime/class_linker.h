@@ -24,6 +24,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/atomic.h"
 #include "base/enums.h"
 #include "base/macros.h"
 #include "base/mutex.h"
@@ -926,6 +927,12 @@ class ClassLinker {
                                              ObjPtr<mirror::ClassLoader> class_loader)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Count a dex cache miss of `string_idx` or `type_idx` for the SIGQUIT dump.
+  void RecordStringDexCacheMiss(ObjPtr<mirror::DexCache> dex_cache, dex::StringIndex string_idx)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  void RecordTypeDexCacheMiss(ObjPtr<mirror::DexCache> dex_cache, dex::TypeIndex type_idx)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Implementation of ResolveType() called when the type was not found in the dex cache.
   ObjPtr<mirror::Class> DoResolveType(dex::TypeIndex type_idx,
                                       Handle<mirror::DexCache> dex_cache,
@@ -1299,6 +1306,13 @@ class ClassLinker {
   std::list<ClassLoaderData> class_loaders_
       GUARDED_BY(Locks::classlinker_classes_lock_);
 
+  // The string and type dex cache misses of the resolution, and those of them that found the slot
+  // holding another index.
+  Atomic<uint64_t> string_dex_cache_misses_;
+  Atomic<uint64_t> string_dex_cache_collisions_;
+  Atomic<uint64_t> type_dex_cache_misses_;
+  Atomic<uint64_t> type_dex_cache_collisions_;
+
   // Boot class path table. Since the class loader for this is null.
   std::unique_ptr<ClassTable> boot_class_table_ GUARDED_BY(Locks::classlinker_classes_lock_);
 
@@ -49,6 +49,25 @@ inline bool IsDelegateLastClassLoader(ScopedObjectAccessAlreadyRunnable& soa,
       soa.Decode<mirror::Class>(WellKnownClasses::dalvik_system_DelegateLastClassLoader);
 }
 
+// Returns the dexElements array of the DexPathList of the given classloader, an array of
+// DexPathList$Element which each contain a dex file, or null if there is none. Adding dex files
+// to the classloader replaces the array.
+// This function assumes that the given classloader is a subclass of BaseDexClassLoader!
+inline ObjPtr<mirror::ObjectArray<mirror::Object>> GetClassLoaderDexElements(
+    Handle<mirror::ClassLoader> class_loader)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ObjPtr<mirror::Object> dex_path_list =
+      jni::DecodeArtField(WellKnownClasses::dalvik_system_BaseDexClassLoader_pathList)->
+          GetObject(class_loader.Get());
+  if (dex_path_list == nullptr) {
+    return nullptr;
+  }
+  ObjPtr<mirror::Object> dex_elements_obj =
+      jni::DecodeArtField(WellKnownClasses::dalvik_system_DexPathList_dexElements)->
+          GetObject(dex_path_list);
+  return dex_elements_obj == nullptr ? nullptr : dex_elements_obj->AsObjectArray<mirror::Object>();
+}
+
 // Visit the DexPathList$Element instances in the given classloader with the given visitor.
 // Constraints on the visitor:
 //   * The visitor should return true to continue visiting more Elements.
@@ -66,16 +85,13 @@ inline RetType VisitClassLoaderDexElements(ScopedObjectAccessAlreadyRunnable& so
       jni::DecodeArtField(WellKnownClasses::dalvik_system_BaseDexClassLoader_pathList)->
           GetObject(class_loader.Get());
   if (dex_path_list != nullptr) {
-    // DexPathList has an array dexElements of Elements[] which each contain a dex file.
-    ObjPtr<mirror::Object> dex_elements_obj =
-        jni::DecodeArtField(WellKnownClasses::dalvik_system_DexPathList_dexElements)->
-            GetObject(dex_path_list);
     // Loop through each dalvik.system.DexPathList$Element's dalvik.system.DexFile and look
     // at the mCookie which is a DexFile vector.
+    ObjPtr<mirror::ObjectArray<mirror::Object>> dex_elements_obj =
+        GetClassLoaderDexElements(class_loader);
     if (dex_elements_obj != nullptr) {
       StackHandleScope<1> hs(self);
-      Handle<mirror::ObjectArray<mirror::Object>> dex_elements =
-          hs.NewHandle(dex_elements_obj->AsObjectArray<mirror::Object>());
+      Handle<mirror::ObjectArray<mirror::Object>> dex_elements = hs.NewHandle(dex_elements_obj);
       for (int32_t i = 0; i < dex_elements->GetLength(); ++i) {
         ObjPtr<mirror::Object> element = dex_elements->GetWithoutChecks(i);
         if (element == nullptr) {
@@ -32,9 +32,15 @@ void ClassTable::VisitRoots(Visitor& visitor) {
       table_slot.VisitRoot(visitor);
     }
   }
+  for (TableSlot& cache_slot : lookup_cache_) {
+    if (!cache_slot.IsNull()) {
+      cache_slot.VisitRoot(visitor);
+    }
+  }
   for (GcRoot<mirror::Object>& root : strong_roots_) {
     visitor.VisitRoot(root.AddressWithoutBarrier());
   }
+  visitor.VisitRootIfNonNull(missing_classes_dex_elements_.AddressWithoutBarrier());
   for (const OatFile* oat_file : oat_files_) {
     for (GcRoot<mirror::Object>& root : oat_file->GetBssGcRoots()) {
       visitor.VisitRootIfNonNull(root.AddressWithoutBarrier());
@@ -50,9 +56,15 @@ void ClassTable::VisitRoots(const Visitor& visitor) {
       table_slot.VisitRoot(visitor);
     }
   }
+  for (TableSlot& cache_slot : lookup_cache_) {
+    if (!cache_slot.IsNull()) {
+      cache_slot.VisitRoot(visitor);
+    }
+  }
   for (GcRoot<mirror::Object>& root : strong_roots_) {
     visitor.VisitRoot(root.AddressWithoutBarrier());
   }
+  visitor.VisitRootIfNonNull(missing_classes_dex_elements_.AddressWithoutBarrier());
   for (const OatFile* oat_file : oat_files_) {
     for (GcRoot<mirror::Object>& root : oat_file->GetBssGcRoots()) {
       visitor.VisitRootIfNonNull(root.AddressWithoutBarrier());
@@ -22,7 +22,9 @@
 
 namespace art {
 
-ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock) {
+ClassTable::ClassTable()
+    : lock_("Class loader classes", kClassLoaderClassesLock),
+      missing_classes_num_dex_files_(0u) {
   Runtime* const runtime = Runtime::Current();
   classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
                               runtime->GetHashTableMaxLoadFactor()));
@@ -85,6 +87,7 @@ mirror::Class* ClassTable::UpdateClass(const char* descriptor, mirror::Class* kl
   // Update the element in the hash set with the new class. This is safe to do since the descriptor
   // doesn't change.
   *existing_it = TableSlot(klass, hash);
+  ClearLookupCacheSlot(hash);
   return existing;
 }
 
@@ -131,16 +134,57 @@ size_t ClassTable::NumReferencedNonZygoteClasses() const {
 
 mirror::Class* ClassTable::Lookup(const char* descriptor, size_t hash) {
   DescriptorHashPair pair(descriptor, hash);
+  TableSlot& cache_slot = LookupCacheSlot(hash);
+  const TableSlot cached = cache_slot.LoadAcquire();
+  if (!cached.IsNull() && ClassDescriptorHashEquals()(cached, pair)) {
+    return cached.Read();
+  }
   ReaderMutexLock mu(Thread::Current(), lock_);
   for (ClassSet& class_set : classes_) {
     auto it = class_set.FindWithHash(pair, hash);
     if (it != class_set.end()) {
-      return it->Read();
+      mirror::Class* klass = it->Read();
+      // Publish the class read through the read barrier, so that a concurrent root visit never
+      // misses the to-space reference.
+      cache_slot.StoreRelease(TableSlot(klass, hash));
+      return klass;
     }
   }
   return nullptr;
 }
 
+size_t ClassTable::MissingClassHashEquals::operator()(const std::string& descriptor) const {
+  return ComputeModifiedUtf8Hash(descriptor.c_str());
+}
+
+bool ClassTable::IsKnownMissingClass(const char* descriptor,
+                                     size_t hash,
+                                     ObjPtr<mirror::Object> dex_elements,
+                                     size_t num_dex_files) {
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  if (missing_classes_dex_elements_.Read() != dex_elements ||
+      missing_classes_num_dex_files_ != num_dex_files) {
+    return false;
+  }
+  DescriptorHashPair pair(descriptor, hash);
+  return missing_classes_.FindWithHash(pair, hash) != missing_classes_.end();
+}
+
+void ClassTable::AddKnownMissingClass(const char* descriptor,
+                                      size_t hash,
+                                      ObjPtr<mirror::Object> dex_elements,
+                                      size_t num_dex_files) {
+  WriterMutexLock mu(Thread::Current(), lock_);
+  if (missing_classes_dex_elements_.Read() != dex_elements ||
+      missing_classes_num_dex_files_ != num_dex_files ||
+      missing_classes_.Size() >= kMaxKnownMissingClasses) {
+    missing_classes_.Clear();
+    missing_classes_dex_elements_ = GcRoot<mirror::Object>(dex_elements);
+    missing_classes_num_dex_files_ = num_dex_files;
+  }
+  missing_classes_.InsertWithHash(std::string(descriptor), hash);
+}
+
 ObjPtr<mirror::Class> ClassTable::TryInsert(ObjPtr<mirror::Class> klass) {
   TableSlot slot(klass);
   WriterMutexLock mu(Thread::Current(), lock_);
@@ -190,6 +234,7 @@ bool ClassTable::Remove(const char* descriptor) {
     auto it = class_set.Find(pair);
     if (it != class_set.end()) {
       class_set.Erase(it);
+      ClearLookupCacheSlot(pair.second);
       return true;
     }
   }
@@ -290,6 +335,10 @@ size_t ClassTable::ReadFromMemory(uint8_t* ptr) {
 void ClassTable::AddClassSet(ClassSet&& set) {
   WriterMutexLock mu(Thread::Current(), lock_);
   classes_.insert(classes_.begin(), std::move(set));
+  // The new set comes first, and may shadow the cached classes.
+  for (TableSlot& cache_slot : lookup_cache_) {
+    cache_slot.StoreRelease(TableSlot());
+  }
 }
 
 void ClassTable::ClearStrongRoots() {
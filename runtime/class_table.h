@@ -83,6 +83,17 @@ class ClassTable {
     static uint32_t HashDescriptor(ObjPtr<mirror::Class> klass)
         REQUIRES_SHARED(Locks::mutator_lock_);
 
+    // Accessors of the lookup cache slots, which are read without the lock.
+    TableSlot LoadAcquire() const {
+      TableSlot slot;
+      slot.data_.StoreRelaxed(data_.LoadAcquire());
+      return slot;
+    }
+
+    void StoreRelease(const TableSlot& slot) {
+      data_.StoreRelease(slot.data_.LoadRelaxed());
+    }
+
     template<ReadBarrierOption kReadBarrierOption = kWithReadBarrier>
     mirror::Class* Read() const REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -264,6 +275,25 @@ class ClassTable {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return true if the dex files of the class loader are known not to define `descriptor`.
+  // `dex_elements` and `num_dex_files` identify the dex files of the class loader, the known
+  // missing classes are dropped when they change.
+  bool IsKnownMissingClass(const char* descriptor,
+                           size_t hash,
+                           ObjPtr<mirror::Object> dex_elements,
+                           size_t num_dex_files)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Record that none of the dex files identified by `dex_elements` and `num_dex_files` defines
+  // `descriptor`.
+  void AddKnownMissingClass(const char* descriptor,
+                            size_t hash,
+                            ObjPtr<mirror::Object> dex_elements,
+                            size_t num_dex_files)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   ReaderWriterMutex& GetLock() {
     return lock_;
   }
@@ -283,6 +313,39 @@ class ClassTable {
       REQUIRES(lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // The lookup cache slot of a descriptor hash. The low bits of the hash are already stored in
+  // the slots, use the next ones for the index.
+  TableSlot& LookupCacheSlot(size_t hash) {
+    return lookup_cache_[(hash / kObjectAlignment) % kLookupCacheSize];
+  }
+
+  // Clear the lookup cache slot of a class being removed or replaced.
+  void ClearLookupCacheSlot(size_t hash) REQUIRES(lock_) {
+    LookupCacheSlot(hash).StoreRelease(TableSlot());
+  }
+
+  static constexpr size_t kLookupCacheSize = 256;
+
+  class MissingClassHashEquals {
+   public:
+    size_t operator()(const std::string& descriptor) const;
+    bool operator()(const std::string& a, const std::string& b) const {
+      return a == b;
+    }
+    bool operator()(const std::string& a, const DescriptorHashPair& b) const {
+      return a == b.first;
+    }
+  };
+
+  using MissingClassSet = HashSet<std::string,
+                                  DefaultEmptyFn<std::string>,
+                                  MissingClassHashEquals,
+                                  MissingClassHashEquals>;
+
+  // The known missing classes are dropped when there are more, to bound the memory used by
+  // class loaders probed with many names.
+  static constexpr size_t kMaxKnownMissingClasses = 1024;
+
   // Lock to guard inserting and removing.
   mutable ReaderWriterMutex lock_;
   // We have a vector to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
@@ -293,6 +356,21 @@ class ClassTable {
   std::vector<GcRoot<mirror::Object>> strong_roots_ GUARDED_BY(lock_);
   // Keep track of oat files with GC roots associated with dex caches in `strong_roots_`.
   std::vector<const OatFile*> oat_files_ GUARDED_BY(lock_);
+  // Direct-mapped cache of the classes found by Lookup, read without the lock so that the hot
+  // lookups of a class loader do not contend on `lock_`. The slots are only published while
+  // holding `lock_` for reading, with the class as read through the read barrier, and cleared
+  // while holding it for writing, when their class is removed or replaced. A lookup racing with
+  // the removal may still return the class, as if it had run first. Visited as roots, but
+  // always a subset of `classes_`.
+  TableSlot lookup_cache_[kLookupCacheSize];
+  // Descriptors that none of the dex files of the class loader defines, so that the misses of
+  // the class loader chains do not look in all their dex files every time. Valid for the dex
+  // elements array of the DexPathList of the class loader, or for the number of boot class path
+  // dex files for the boot class loader, recorded below. Adding dex files to a class loader
+  // replaces its dex elements array, which is held here so that its address cannot be reused.
+  MissingClassSet missing_classes_ GUARDED_BY(lock_);
+  GcRoot<mirror::Object> missing_classes_dex_elements_ GUARDED_BY(lock_);
+  size_t missing_classes_num_dex_files_ GUARDED_BY(lock_);
 
   friend class linker::ImageWriter;  // for InsertWithoutLocks.
   friend class linker::OatWriter;  // for boot class TableSlot address lookup.
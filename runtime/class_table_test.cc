@@ -140,9 +140,16 @@ TEST_F(ClassTableTest, ClassTable) {
   });
   EXPECT_EQ(classes.size(), 1u);
 
+  // Test that repeated lookups hit, from the lookup cache.
+  EXPECT_EQ(table.Lookup(descriptor_y, ComputeModifiedUtf8Hash(descriptor_y)), h_Y.Get());
+  EXPECT_EQ(table.Lookup(descriptor_y, ComputeModifiedUtf8Hash(descriptor_y)), h_Y.Get());
+
   // Test remove.
+  EXPECT_EQ(table.Lookup(descriptor_x, ComputeModifiedUtf8Hash(descriptor_x)), h_X.Get());
   table.Remove(descriptor_x);
   EXPECT_FALSE(table.Contains(h_X.Get()));
+  // The removed class is not returned by the lookup cache either.
+  EXPECT_EQ(table.Lookup(descriptor_x, ComputeModifiedUtf8Hash(descriptor_x)), nullptr);
 
   // Test that WriteToMemory and ReadFromMemory work.
   table.Insert(h_X.Get());
@@ -156,6 +163,21 @@ TEST_F(ClassTableTest, ClassTable) {
   EXPECT_TRUE(table2.Contains(h_X.Get()));
   EXPECT_TRUE(table2.Contains(h_Y.Get()));
 
+  // Test the known missing classes, which are only valid for the dex files they were recorded for.
+  const char* descriptor_z = "LZ;";
+  const size_t hash_z = ComputeModifiedUtf8Hash(descriptor_z);
+  EXPECT_FALSE(table.IsKnownMissingClass(descriptor_z, hash_z, obj_X.Get(), 1u));
+  table.AddKnownMissingClass(descriptor_z, hash_z, obj_X.Get(), 1u);
+  EXPECT_TRUE(table.IsKnownMissingClass(descriptor_z, hash_z, obj_X.Get(), 1u));
+  EXPECT_FALSE(table.IsKnownMissingClass(descriptor_y, ComputeModifiedUtf8Hash(descriptor_y),
+                                         obj_X.Get(), 1u));
+  EXPECT_FALSE(table.IsKnownMissingClass(descriptor_z, hash_z, obj_X.Get(), 2u));
+  EXPECT_FALSE(table.IsKnownMissingClass(descriptor_z, hash_z, h_Y.Get(), 1u));
+  // Recording a miss for other dex files drops the previous ones.
+  table.AddKnownMissingClass(descriptor_y, ComputeModifiedUtf8Hash(descriptor_y), h_Y.Get(), 1u);
+  EXPECT_FALSE(table.IsKnownMissingClass(descriptor_z, hash_z, obj_X.Get(), 1u));
+  EXPECT_FALSE(table.IsKnownMissingClass(descriptor_z, hash_z, h_Y.Get(), 1u));
+
   // TODO: Add tests for UpdateClass, InsertOatFile.
 }
 
@@ -77,6 +77,39 @@ using android::base::StringPrintf;
 // The key identifying the debugger to update instrumentation.
 static constexpr const char* kDbgInstrumentationKey = "Debugger";
 
+// The key identifying the debugger to install the method entry and exit stubs, which report the
+// method events of compiled code when the runtime is Java debuggable.
+static constexpr const char* kDbgMethodEventsInstrumentationKey = "DebuggerMethodEvents";
+
+static constexpr uint32_t kMethodEnterExitEvents =
+    instrumentation::Instrumentation::kMethodEntered |
+    instrumentation::Instrumentation::kMethodExited;
+
+// Whether the method events are reported through the entry and exit stubs rather than by
+// deoptimizing everything. Java debuggable code is compiled without inlining and calls other
+// methods through their entrypoints, so the stubs see every call and return.
+static bool UsesMethodEventStubs() {
+  return Dbg::RequiresDeoptimization() && Runtime::Current()->IsJavaDebuggable();
+}
+
+// Installs or removes the method entry and exit stubs when the debugger starts or stops
+// listening to method events.
+static void UpdateMethodEventStubs(uint32_t old_events, uint32_t new_events)
+    REQUIRES(Locks::mutator_lock_, Roles::uninterruptible_) {
+  bool had_method_events = (old_events & kMethodEnterExitEvents) != 0;
+  bool has_method_events = (new_events & kMethodEnterExitEvents) != 0;
+  if (had_method_events == has_method_events || !UsesMethodEventStubs()) {
+    return;
+  }
+  instrumentation::Instrumentation* instrumentation = Runtime::Current()->GetInstrumentation();
+  if (has_method_events) {
+    instrumentation->EnableMethodTracing(kDbgMethodEventsInstrumentationKey,
+                                         /* needs_interpreter */ false);
+  } else {
+    instrumentation->DisableMethodTracing(kDbgMethodEventsInstrumentationKey);
+  }
+}
+
 // Limit alloc_record_count to the 2BE value (64k-1) that is the limit of the current protocol.
 static uint16_t CappedAllocRecordCount(size_t alloc_record_count) {
   const size_t cap = 0xffff;
@@ -732,6 +765,7 @@ void Dbg::Disconnected() {
       if (instrumentation_events_ != 0) {
         runtime->GetInstrumentation()->RemoveListener(&gDebugInstrumentationListener,
                                                       instrumentation_events_);
+        UpdateMethodEventStubs(instrumentation_events_, 0u);
         instrumentation_events_ = 0;
       }
       if (RequiresDeoptimization()) {
@@ -3240,6 +3274,8 @@ void Dbg::ProcessDeoptimizationRequest(const DeoptimizationRequest& request) {
       VLOG(jdwp) << StringPrintf("Add debugger as listener for instrumentation event 0x%x",
                                  request.InstrumentationEvent());
       instrumentation->AddListener(&gDebugInstrumentationListener, request.InstrumentationEvent());
+      UpdateMethodEventStubs(instrumentation_events_,
+                             instrumentation_events_ | request.InstrumentationEvent());
       instrumentation_events_ |= request.InstrumentationEvent();
       break;
     case DeoptimizationRequest::kUnregisterForEvent:
@@ -3247,6 +3283,8 @@ void Dbg::ProcessDeoptimizationRequest(const DeoptimizationRequest& request) {
                                  request.InstrumentationEvent());
       instrumentation->RemoveListener(&gDebugInstrumentationListener,
                                       request.InstrumentationEvent());
+      UpdateMethodEventStubs(instrumentation_events_,
+                             instrumentation_events_ & ~request.InstrumentationEvent());
       instrumentation_events_ &= ~request.InstrumentationEvent();
       break;
     case DeoptimizationRequest::kFullDeoptimization:
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "debugger.h"
+
+#include "art_method-inl.h"
+#include "base/enums.h"
+#include "class_linker-inl.h"
+#include "common_runtime_test.h"
+#include "gc/scoped_gc_critical_section.h"
+#include "instrumentation.h"
+#include "jvalue.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-inl.h"
+#include "thread_list.h"
+
+namespace art {
+
+// Counts the entries and exits of one method.
+class MethodEventCounter FINAL : public instrumentation::InstrumentationListener {
+ public:
+  explicit MethodEventCounter(ArtMethod* method) : method_(method), entries_(0u), exits_(0u) {}
+
+  void MethodEntered(Thread* thread ATTRIBUTE_UNUSED,
+                     Handle<mirror::Object> this_object ATTRIBUTE_UNUSED,
+                     ArtMethod* method,
+                     uint32_t dex_pc ATTRIBUTE_UNUSED)
+      OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (method == method_) {
+      ++entries_;
+    }
+  }
+
+  void MethodExited(Thread* thread ATTRIBUTE_UNUSED,
+                    Handle<mirror::Object> this_object ATTRIBUTE_UNUSED,
+                    ArtMethod* method,
+                    uint32_t dex_pc ATTRIBUTE_UNUSED,
+                    const JValue& return_value ATTRIBUTE_UNUSED)
+      OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (method == method_) {
+      ++exits_;
+    }
+  }
+
+  void MethodUnwind(Thread* thread ATTRIBUTE_UNUSED,
+                    Handle<mirror::Object> this_object ATTRIBUTE_UNUSED,
+                    ArtMethod* method ATTRIBUTE_UNUSED,
+                    uint32_t dex_pc ATTRIBUTE_UNUSED)
+      OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_) {}
+
+  void DexPcMoved(Thread* thread ATTRIBUTE_UNUSED,
+                  Handle<mirror::Object> this_object ATTRIBUTE_UNUSED,
+                  ArtMethod* method ATTRIBUTE_UNUSED,
+                  uint32_t new_dex_pc ATTRIBUTE_UNUSED)
+      OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_) {}
+
+  void FieldRead(Thread* thread ATTRIBUTE_UNUSED,
+                 Handle<mirror::Object> this_object ATTRIBUTE_UNUSED,
+                 ArtMethod* method ATTRIBUTE_UNUSED,
+                 uint32_t dex_pc ATTRIBUTE_UNUSED,
+                 ArtField* field ATTRIBUTE_UNUSED)
+      OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_) {}
+
+  void FieldWritten(Thread* thread ATTRIBUTE_UNUSED,
+                    Handle<mirror::Object> this_object ATTRIBUTE_UNUSED,
+                    ArtMethod* method ATTRIBUTE_UNUSED,
+                    uint32_t dex_pc ATTRIBUTE_UNUSED,
+                    ArtField* field ATTRIBUTE_UNUSED,
+                    const JValue& field_value ATTRIBUTE_UNUSED)
+      OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_) {}
+
+  void ExceptionThrown(Thread* thread ATTRIBUTE_UNUSED,
+                       Handle<mirror::Throwable> exception_object ATTRIBUTE_UNUSED)
+      OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_) {}
+
+  void ExceptionHandled(Thread* self ATTRIBUTE_UNUSED,
+                        Handle<mirror::Throwable> throwable ATTRIBUTE_UNUSED)
+      OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_) {}
+
+  void Branch(Thread* thread ATTRIBUTE_UNUSED,
+              ArtMethod* method ATTRIBUTE_UNUSED,
+              uint32_t dex_pc ATTRIBUTE_UNUSED,
+              int32_t dex_pc_offset ATTRIBUTE_UNUSED)
+      OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_) {}
+
+  void InvokeVirtualOrInterface(Thread* thread ATTRIBUTE_UNUSED,
+                                Handle<mirror::Object> this_object ATTRIBUTE_UNUSED,
+                                ArtMethod* caller ATTRIBUTE_UNUSED,
+                                uint32_t dex_pc ATTRIBUTE_UNUSED,
+                                ArtMethod* callee ATTRIBUTE_UNUSED)
+      OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_) {}
+
+  void WatchedFramePop(Thread* thread ATTRIBUTE_UNUSED,
+                       const ShadowFrame& frame ATTRIBUTE_UNUSED)
+      OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_) {}
+
+  size_t GetEntries() const {
+    return entries_;
+  }
+
+  size_t GetExits() const {
+    return exits_;
+  }
+
+ private:
+  ArtMethod* const method_;
+  size_t entries_;
+  size_t exits_;
+
+  DISALLOW_COPY_AND_ASSIGN(MethodEventCounter);
+};
+
+class DebuggerTest : public CommonRuntimeTest {
+ protected:
+  static void SetDeoptimizationEnabled(Thread* self, bool enabled)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    instrumentation::Instrumentation* instrumentation = Runtime::Current()->GetInstrumentation();
+    ScopedThreadSuspension sts(self, kSuspended);
+    gc::ScopedGCCriticalSection gcs(self,
+                                    gc::kGcCauseInstrumentation,
+                                    gc::kCollectorTypeInstrumentation);
+    ScopedSuspendAll ssa(__FUNCTION__);
+    if (enabled) {
+      instrumentation->EnableDeoptimization();
+    } else {
+      instrumentation->DisableDeoptimization("Debugger");
+    }
+  }
+
+  static void UpdateListener(Thread* self, MethodEventCounter* listener, bool add)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    instrumentation::Instrumentation* instrumentation = Runtime::Current()->GetInstrumentation();
+    ScopedThreadSuspension sts(self, kSuspended);
+    ScopedSuspendAll ssa(__FUNCTION__);
+    uint32_t events = instrumentation::Instrumentation::kMethodEntered |
+                      instrumentation::Instrumentation::kMethodExited;
+    if (add) {
+      instrumentation->AddListener(listener, events);
+    } else {
+      instrumentation->RemoveListener(listener, events);
+    }
+  }
+
+  static void RequestMethodEvents(bool listen) REQUIRES_SHARED(Locks::mutator_lock_) {
+    for (uint32_t event : { instrumentation::Instrumentation::kMethodEntered,
+                            instrumentation::Instrumentation::kMethodExited }) {
+      DeoptimizationRequest req;
+      req.SetKind(listen ? DeoptimizationRequest::kRegisterForEvent
+                         : DeoptimizationRequest::kUnregisterForEvent);
+      req.SetInstrumentationEvent(event);
+      Dbg::RequestDeoptimization(req);
+    }
+    Dbg::ManageDeoptimization();
+  }
+};
+
+// The method events the debugger listens to on a Java debuggable runtime are reported by the
+// instrumentation stubs, which compiled code calls into, rather than by deoptimizing everything.
+TEST_F(DebuggerTest, MethodEventsFromCompiledCode) {
+  Runtime* const runtime = Runtime::Current();
+  instrumentation::Instrumentation* instrumentation = runtime->GetInstrumentation();
+  if (!Dbg::RequiresDeoptimization()) {
+    // Everything runs in the interpreter.
+    return;
+  }
+  runtime->SetJavaDebuggable(true);
+
+  ScopedObjectAccess soa(Thread::Current());
+  ObjPtr<mirror::Class> integer_class =
+      class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Integer;");
+  ASSERT_TRUE(integer_class != nullptr);
+  ArtMethod* method = integer_class->FindClassMethod("reverse", "(I)I", kRuntimePointerSize);
+  ASSERT_TRUE(method != nullptr);
+  ASSERT_TRUE(method->IsStatic());
+  MethodEventCounter listener(method);
+
+  SetDeoptimizationEnabled(soa.Self(), true);
+  RequestMethodEvents(/* listen */ true);
+  EXPECT_TRUE(instrumentation->AreExitStubsInstalled());
+  EXPECT_FALSE(instrumentation->AreAllMethodsDeoptimized());
+
+  UpdateListener(soa.Self(), &listener, /* add */ true);
+  uint32_t args[] = { 1u };
+  JValue result;
+  method->Invoke(soa.Self(), args, sizeof(args), &result, "II");
+  ASSERT_FALSE(soa.Self()->IsExceptionPending());
+  EXPECT_EQ(INT32_MIN, result.GetI());
+  EXPECT_EQ(1u, listener.GetEntries());
+  EXPECT_EQ(1u, listener.GetExits());
+  UpdateListener(soa.Self(), &listener, /* add */ false);
+
+  RequestMethodEvents(/* listen */ false);
+  EXPECT_FALSE(instrumentation->AreExitStubsInstalled());
+  SetDeoptimizationEnabled(soa.Self(), false);
+  runtime->SetJavaDebuggable(false);
+}
+
+}  // namespace art
@@ -23,6 +23,7 @@
 
 #include "base/file_magic.h"
 #include "base/file_utils.h"
+#include "base/logging.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
 #include "base/unix_file/fd_file.h"
@@ -385,9 +386,14 @@ std::unique_ptr<const DexFile> ArtDexFileLoader::OpenOneDexFileFromZip(
     }
   }
 
-  if (map == nullptr) {
+  if (map != nullptr) {
+    VLOG(class_linker) << "Mapped dex file " << location << "!" << entry_name << " directly";
+  } else {
     // Default path for compressed ZIP entries,
     // and fallback for stored ZIP entries.
+    VLOG(class_linker) << "Extracting dex file " << location << "!" << entry_name
+                       << (zip_entry->IsUncompressed() ? " stored" : " compressed")
+                       << " in the zip file";
     map.reset(zip_entry->ExtractToMemMap(location.c_str(), entry_name, error_msg));
   }
 
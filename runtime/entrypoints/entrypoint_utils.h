@@ -129,6 +129,17 @@ inline ArtMethod* FindMethodFromCode(uint32_t method_idx,
     REQUIRES_SHARED(Locks::mutator_lock_)
     REQUIRES(!Roles::uninterruptible_);
 
+// The second half of FindMethodFromCode: the null check of `this_object` and the dispatch of the
+// method `resolved_method` resolved for `method_idx`.
+template<InvokeType type, bool access_check>
+inline ArtMethod* FindMethodToCall(uint32_t method_idx,
+                                   ArtMethod* resolved_method,
+                                   ObjPtr<mirror::Object>* this_object,
+                                   ArtMethod* referrer,
+                                   Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_)
+    REQUIRES(!Roles::uninterruptible_);
+
 // Fast path field resolution that can't initialize classes or throw exceptions.
 inline ArtField* FindFieldFast(uint32_t field_idx,
                                ArtMethod* referrer,
@@ -185,6 +196,8 @@ ArtMethod* GetCalleeSaveMethodCaller(ArtMethod** sp,
 struct CallerAndOuterMethod {
   ArtMethod* caller;
   ArtMethod* outer_method;
+  // The return pc in the code of `outer_method`.
+  uintptr_t caller_pc;
 };
 
 CallerAndOuterMethod GetCalleeSaveMethodCallerAndOuterMethod(Thread* self, CalleeSaveType type)
@@ -22,6 +22,7 @@
 #include "callee_save_frame.h"
 #include "dex/dex_file_types.h"
 #include "entrypoints/entrypoint_utils-inl.h"
+#include "entrypoints/quick/quick_entrypoint_counters.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "mirror/object_array-inl.h"
@@ -58,6 +59,8 @@ static ALWAYS_INLINE inline mirror::Object* artAllocObjectFromCode(
       }
     }
   }
+  QuickEntrypointCounters::CountCallFromCode(
+      QuickEntrypointCounters::kAllocObject, self, CalleeSaveType::kSaveRefsOnly);
   if (kInitialized) {
     return AllocObjectFromCodeInitialized<kInstrumented>(klass, self, allocator_type);
   } else if (!kFinalize) {
@@ -87,6 +90,8 @@ extern "C" mirror::Array* artAllocArrayFromCodeResolved##suffix##suffix2( \
     mirror::Class* klass, int32_t component_count, Thread* self) \
     REQUIRES_SHARED(Locks::mutator_lock_) { \
   ScopedQuickEntrypointChecks sqec(self); \
+  QuickEntrypointCounters::CountCallFromCode( \
+      QuickEntrypointCounters::kAllocArray, self, CalleeSaveType::kSaveRefsOnly); \
   return AllocArrayFromCodeResolved<instrumented_bool>(klass, component_count, self, \
                                                        allocator_type); \
 } \
@@ -119,6 +119,9 @@ extern "C" void art_quick_invoke_polymorphic(uint32_t, void*);
 // Thread entrypoints.
 extern "C" void art_quick_test_suspend();
 
+// JIT entrypoints, only implemented where the JIT supports baseline compilation.
+extern "C" void art_quick_compile_optimized();
+
 // Throw entrypoints.
 extern "C" void art_quick_deliver_exception(art::mirror::Object*);
 extern "C" void art_quick_throw_array_bounds(int32_t index, int32_t limit);
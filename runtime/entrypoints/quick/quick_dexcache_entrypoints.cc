@@ -22,7 +22,10 @@
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_types.h"
 #include "entrypoints/entrypoint_utils-inl.h"
+#include "entrypoints/quick/quick_entrypoint_counters.h"
 #include "gc/heap.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
 #include "mirror/object-inl.h"
@@ -129,6 +132,26 @@ static ALWAYS_INLINE bool CanReferenceBss(ArtMethod* outer_method, ArtMethod* ca
   return outer_method->GetDexFile() == caller->GetDexFile();
 }
 
+// Store `object` in the JIT .bss entry of the JIT code of `caller_and_outer`, if the code has one.
+// Unlike the .bss of AOT code, the entries are keyed by the dex file of the caller, so they can
+// also be filled from inlined code.
+static inline void StoreInJitBss(const CallerAndOuterMethod& caller_and_outer,
+                                 uint32_t index,
+                                 bool is_string,
+                                 ObjPtr<mirror::Object> object)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit != nullptr &&
+      jit->GetCodeCache()->ContainsPc(reinterpret_cast<const void*>(caller_and_outer.caller_pc))) {
+    jit->GetCodeCache()->StoreJitBssEntry(caller_and_outer.outer_method,
+                                          caller_and_outer.caller_pc,
+                                          caller_and_outer.caller->GetDexFile(),
+                                          index,
+                                          is_string,
+                                          object);
+  }
+}
+
 extern "C" mirror::Class* artInitializeStaticStorageFromCode(uint32_t type_idx, Thread* self)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   // Called to ensure static storage base is initialized for direct static field reads and writes.
@@ -138,13 +161,17 @@ extern "C" mirror::Class* artInitializeStaticStorageFromCode(uint32_t type_idx,
   auto caller_and_outer = GetCalleeSaveMethodCallerAndOuterMethod(
       self, CalleeSaveType::kSaveEverythingForClinit);
   ArtMethod* caller = caller_and_outer.caller;
+  QuickEntrypointCounters::CountCall(QuickEntrypointCounters::kInitializeStaticStorage, caller);
   ObjPtr<mirror::Class> result = ResolveVerifyAndClinit(dex::TypeIndex(type_idx),
                                                         caller,
                                                         self,
                                                         /* can_run_clinit */ true,
                                                         /* verify_access */ false);
-  if (LIKELY(result != nullptr) && CanReferenceBss(caller_and_outer.outer_method, caller)) {
-    StoreTypeInBss(caller_and_outer.outer_method, dex::TypeIndex(type_idx), result);
+  if (LIKELY(result != nullptr)) {
+    StoreInJitBss(caller_and_outer, type_idx, /* is_string */ false, result);
+    if (CanReferenceBss(caller_and_outer.outer_method, caller)) {
+      StoreTypeInBss(caller_and_outer.outer_method, dex::TypeIndex(type_idx), result);
+    }
   }
   return result.Ptr();
 }
@@ -156,13 +183,17 @@ extern "C" mirror::Class* artInitializeTypeFromCode(uint32_t type_idx, Thread* s
   auto caller_and_outer = GetCalleeSaveMethodCallerAndOuterMethod(
       self, CalleeSaveType::kSaveEverythingForClinit);
   ArtMethod* caller = caller_and_outer.caller;
+  QuickEntrypointCounters::CountCall(QuickEntrypointCounters::kInitializeType, caller);
   ObjPtr<mirror::Class> result = ResolveVerifyAndClinit(dex::TypeIndex(type_idx),
                                                         caller,
                                                         self,
                                                         /* can_run_clinit */ false,
                                                         /* verify_access */ false);
-  if (LIKELY(result != nullptr) && CanReferenceBss(caller_and_outer.outer_method, caller)) {
-    StoreTypeInBss(caller_and_outer.outer_method, dex::TypeIndex(type_idx), result);
+  if (LIKELY(result != nullptr)) {
+    StoreInJitBss(caller_and_outer, type_idx, /* is_string */ false, result);
+    if (CanReferenceBss(caller_and_outer.outer_method, caller)) {
+      StoreTypeInBss(caller_and_outer.outer_method, dex::TypeIndex(type_idx), result);
+    }
   }
   return result.Ptr();
 }
@@ -190,8 +221,11 @@ extern "C" mirror::String* artResolveStringFromCode(int32_t string_idx, Thread*
                                                                   CalleeSaveType::kSaveEverything);
   ArtMethod* caller = caller_and_outer.caller;
   ObjPtr<mirror::String> result = ResolveStringFromCode(caller, dex::StringIndex(string_idx));
-  if (LIKELY(result != nullptr) && CanReferenceBss(caller_and_outer.outer_method, caller)) {
-    StoreStringInBss(caller_and_outer.outer_method, dex::StringIndex(string_idx), result);
+  if (LIKELY(result != nullptr)) {
+    StoreInJitBss(caller_and_outer, string_idx, /* is_string */ true, result);
+    if (CanReferenceBss(caller_and_outer.outer_method, caller)) {
+      StoreStringInBss(caller_and_outer.outer_method, dex::StringIndex(string_idx), result);
+    }
   }
   return result.Ptr();
 }
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "quick_entrypoint_counters.h"
+
+#include <algorithm>
+#include <ostream>
+
+#include "art_method-inl.h"
+#include "entrypoints/entrypoint_utils.h"
+#include "runtime.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+std::atomic<bool> QuickEntrypointCounters::enabled_(false);
+
+QuickEntrypointCounters::QuickEntrypointCounters()
+    : lock_("quick entrypoint counters lock", kDefaultMutexLevel),
+      totals_() {}
+
+void QuickEntrypointCounters::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void QuickEntrypointCounters::Count(Kind kind, ArtMethod* caller) {
+  DCHECK_LT(kind, kNumKinds);
+  MutexLock mu(Thread::Current(), lock_);
+  ++totals_[kind];
+  auto key = std::make_pair(caller, kind);
+  auto it = counts_.find(key);
+  if (it == counts_.end()) {
+    if (counts_.size() >= kMaxEntries) {
+      key = std::make_pair(nullptr, kind);
+    }
+    it = counts_.FindOrAdd(key, 0u);
+  }
+  ++it->second;
+}
+
+void QuickEntrypointCounters::CountCallSlow(Kind kind, ArtMethod* caller) {
+  Runtime::Current()->GetQuickEntrypointCounters()->Count(kind, caller);
+}
+
+void QuickEntrypointCounters::CountCallFromCodeSlow(Kind kind,
+                                                    Thread* self,
+                                                    CalleeSaveType type) {
+  ArtMethod** sp = self->GetManagedStack()->GetTopQuickFrameKnownNotTagged();
+  CountCallSlow(kind, GetCalleeSaveMethodCaller(sp, type));
+}
+
+std::vector<QuickEntrypointCounters::Entry> QuickEntrypointCounters::GetEntries(bool reset) {
+  std::vector<Entry> entries;
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    entries.reserve(counts_.size());
+    for (const auto& entry : counts_) {
+      entries.push_back(Entry { entry.first.second, entry.first.first, entry.second });
+    }
+    if (reset) {
+      counts_.clear();
+      std::fill_n(totals_, kNumKinds, 0u);
+    }
+  }
+  std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+    return lhs.count > rhs.count;
+  });
+  return entries;
+}
+
+void QuickEntrypointCounters::Dump(std::ostream& os) {
+  if (!IsEnabled()) {
+    return;
+  }
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    os << "Entrypoint slow path calls:";
+    for (size_t kind = 0; kind != kNumKinds; ++kind) {
+      os << " " << static_cast<Kind>(kind) << "=" << totals_[kind];
+    }
+    os << "\n";
+  }
+  std::vector<Entry> entries = GetEntries(/* reset */ false);
+  for (size_t i = 0, size = std::min(entries.size(), kMaxDumpedEntries); i != size; ++i) {
+    const Entry& entry = entries[i];
+    os << "  " << entry.count << " " << entry.kind << " from "
+       << (entry.caller != nullptr ? entry.caller->PrettyMethod() : std::string("<unknown>"))
+       << "\n";
+  }
+}
+
+std::ostream& operator<<(std::ostream& os, const QuickEntrypointCounters::Kind& kind) {
+  switch (kind) {
+    case QuickEntrypointCounters::kInitializeType:
+      return os << "InitializeType";
+    case QuickEntrypointCounters::kInitializeStaticStorage:
+      return os << "InitializeStaticStorage";
+    case QuickEntrypointCounters::kResolutionTrampoline:
+      return os << "ResolutionTrampoline";
+    case QuickEntrypointCounters::kAllocObject:
+      return os << "AllocObject";
+    case QuickEntrypointCounters::kAllocArray:
+      return os << "AllocArray";
+    case QuickEntrypointCounters::kLockObject:
+      return os << "LockObject";
+    case QuickEntrypointCounters::kNumKinds:
+      break;
+  }
+  return os << "Unknown";
+}
+
+}  // namespace art
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_ENTRYPOINTS_QUICK_QUICK_ENTRYPOINT_COUNTERS_H_
+#define ART_RUNTIME_ENTRYPOINTS_QUICK_QUICK_ENTRYPOINT_COUNTERS_H_
+
+#include <atomic>
+#include <iosfwd>
+#include <utility>
+#include <vector>
+
+#include "base/callee_save_type.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "base/safe_map.h"
+
+namespace art {
+
+class ArtMethod;
+class Thread;
+
+// Counts the calls of compiled code to the slow paths of the runtime entrypoints, by calling
+// method, to find the type resolutions, class initialization checks, method resolutions,
+// allocations and lock acquisitions that the compiled code could not handle by itself. Enabled
+// with -XX:EntrypointCounters:true and dumped on SIGQUIT.
+class QuickEntrypointCounters {
+ public:
+  enum Kind {
+    kInitializeType,
+    kInitializeStaticStorage,
+    kResolutionTrampoline,
+    kAllocObject,
+    kAllocArray,
+    kLockObject,
+    kNumKinds,
+  };
+
+  struct Entry {
+    Kind kind;
+    // The method of the call, after inlining. Null if unknown.
+    ArtMethod* caller;
+    uint64_t count;
+  };
+
+  QuickEntrypointCounters();
+
+  static bool IsEnabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  void SetEnabled(bool enabled);
+
+  void Count(Kind kind, ArtMethod* caller) REQUIRES(!lock_);
+
+  // Count a call from `caller` if enabled.
+  ALWAYS_INLINE static void CountCall(Kind kind, ArtMethod* caller) {
+    if (UNLIKELY(IsEnabled())) {
+      CountCallSlow(kind, caller);
+    }
+  }
+
+  // Count a call from the compiled code below the callee-save frame of `type` of `self` if
+  // enabled.
+  ALWAYS_INLINE static void CountCallFromCode(Kind kind, Thread* self, CalleeSaveType type)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (UNLIKELY(IsEnabled())) {
+      CountCallFromCodeSlow(kind, self, type);
+    }
+  }
+
+  // Return the counts, in decreasing order. Clear them if `reset`.
+  std::vector<Entry> GetEntries(bool reset) REQUIRES(!lock_);
+
+  void Dump(std::ostream& os) REQUIRES(!lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  // The calls of new methods past this many are counted without a method.
+  static constexpr size_t kMaxEntries = 16 * 1024;
+  // The number of entries dumped on SIGQUIT.
+  static constexpr size_t kMaxDumpedEntries = 100;
+
+  static void CountCallSlow(Kind kind, ArtMethod* caller);
+  static void CountCallFromCodeSlow(Kind kind, Thread* self, CalleeSaveType type)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  static std::atomic<bool> enabled_;
+
+  Mutex lock_;
+  SafeMap<std::pair<ArtMethod*, Kind>, uint64_t> counts_ GUARDED_BY(lock_);
+  uint64_t totals_[kNumKinds] GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(QuickEntrypointCounters);
+};
+
+std::ostream& operator<<(std::ostream& os, const QuickEntrypointCounters::Kind& kind);
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_ENTRYPOINTS_QUICK_QUICK_ENTRYPOINT_COUNTERS_H_
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "quick_entrypoint_counters.h"
+
+#include "common_runtime_test.h"
+
+namespace art {
+
+class QuickEntrypointCountersTest : public CommonRuntimeTest {};
+
+TEST_F(QuickEntrypointCountersTest, CountsByCallerAndKind) {
+  QuickEntrypointCounters counters;
+  ArtMethod* method_a = reinterpret_cast<ArtMethod*>(0x1000);
+  ArtMethod* method_b = reinterpret_cast<ArtMethod*>(0x2000);
+  counters.Count(QuickEntrypointCounters::kAllocObject, method_a);
+  counters.Count(QuickEntrypointCounters::kAllocObject, method_a);
+  counters.Count(QuickEntrypointCounters::kAllocObject, method_a);
+  counters.Count(QuickEntrypointCounters::kLockObject, method_a);
+  counters.Count(QuickEntrypointCounters::kInitializeType, method_b);
+  counters.Count(QuickEntrypointCounters::kInitializeType, method_b);
+
+  std::vector<QuickEntrypointCounters::Entry> entries = counters.GetEntries(/* reset */ true);
+  ASSERT_EQ(3u, entries.size());
+  // Sorted by decreasing count.
+  EXPECT_EQ(method_a, entries[0].caller);
+  EXPECT_EQ(QuickEntrypointCounters::kAllocObject, entries[0].kind);
+  EXPECT_EQ(3u, entries[0].count);
+  EXPECT_EQ(method_b, entries[1].caller);
+  EXPECT_EQ(QuickEntrypointCounters::kInitializeType, entries[1].kind);
+  EXPECT_EQ(2u, entries[1].count);
+  EXPECT_EQ(method_a, entries[2].caller);
+  EXPECT_EQ(QuickEntrypointCounters::kLockObject, entries[2].kind);
+  EXPECT_EQ(1u, entries[2].count);
+
+  EXPECT_TRUE(counters.GetEntries(/* reset */ false).empty());
+}
+
+}  // namespace art
@@ -72,6 +72,14 @@ extern mirror::Object* JniMethodFastEndWithReference(jobject result,
                                                      Thread* self)
     NO_THREAD_SAFETY_ANALYSIS HOT_ATTR;
 
+// The generic JNI trampoline saves the decisions it made at the start of the native call with
+// the cookie, so that GenericJniMethodEnd() does not depend on the access flags of the method,
+// which the autofast JNI detection may change while the call is in progress.
+// Marks a call that pushed no local reference frame and did no state transition.
+static constexpr uint32_t kGenericJniNoLocalRefFrameCookie = 0xffffffffu;
+// Marks a @FastNative call, which did no state transition. Local reference cookies never use
+// this bit as the indirect reference table is much smaller than 2^31 entries.
+static constexpr uint32_t kGenericJniFastNativeCookieBit = 0x80000000u;
 
 extern mirror::Object* JniMethodEndWithReferenceSynchronized(jobject result,
                                                              uint32_t saved_local_ref_cookie,
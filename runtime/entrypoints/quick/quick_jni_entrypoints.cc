@@ -197,9 +197,13 @@ extern uint64_t GenericJniMethodEnd(Thread* self,
                                     HandleScope* handle_scope)
     // TODO: NO_THREAD_SAFETY_ANALYSIS as GoToRunnable() is NO_THREAD_SAFETY_ANALYSIS
     NO_THREAD_SAFETY_ANALYSIS {
-  bool critical_native = called->IsCriticalNative();
-  bool fast_native = called->IsFastNative();
-  bool normal_native = !critical_native && !fast_native;
+  // Use the decisions artQuickGenericJniTrampoline() saved with the cookie rather than the
+  // access flags of the method, which may have changed since the start of the call.
+  bool has_local_ref_frame = (saved_local_ref_cookie != kGenericJniNoLocalRefFrameCookie);
+  bool fast_native =
+      !has_local_ref_frame || (saved_local_ref_cookie & kGenericJniFastNativeCookieBit) != 0u;
+  bool normal_native = !fast_native;
+  saved_local_ref_cookie &= ~kGenericJniFastNativeCookieBit;
 
   // @Fast and @CriticalNative do not do a state transition.
   if (LIKELY(normal_native)) {
@@ -221,7 +225,8 @@ extern uint64_t GenericJniMethodEnd(Thread* self,
       DCHECK(normal_native) << " @FastNative and synchronize is not supported";
       UnlockJniSynchronizedMethod(locked, self);  // Must decode before pop.
     }
-    if (LIKELY(!critical_native)) {
+    // No local reference frame was pushed for @CriticalNative and auto-critical calls.
+    if (LIKELY(has_local_ref_frame)) {
       PopLocalReferences(saved_local_ref_cookie, self);
     }
     switch (return_shorty_char) {
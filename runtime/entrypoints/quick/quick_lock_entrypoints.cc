@@ -16,6 +16,7 @@
 
 #include "callee_save_frame.h"
 #include "common_throws.h"
+#include "entrypoints/quick/quick_entrypoint_counters.h"
 #include "mirror/object-inl.h"
 
 namespace art {
@@ -25,6 +26,8 @@ extern "C" int artLockObjectFromCode(mirror::Object* obj, Thread* self)
     REQUIRES(!Roles::uninterruptible_)
     REQUIRES_SHARED(Locks::mutator_lock_) /* EXCLUSIVE_LOCK_FUNCTION(Monitor::monitor_lock_) */ {
   ScopedQuickEntrypointChecks sqec(self);
+  QuickEntrypointCounters::CountCallFromCode(
+      QuickEntrypointCounters::kLockObject, self, CalleeSaveType::kSaveRefsOnly);
   if (UNLIKELY(obj == nullptr)) {
     ThrowNullPointerException("Null reference used for synchronization (monitor-enter)");
     return -1;  // Failure.
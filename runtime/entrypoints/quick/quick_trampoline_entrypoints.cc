@@ -26,6 +26,7 @@
 #include "dex/dex_instruction-inl.h"
 #include "dex/method_reference.h"
 #include "entrypoints/entrypoint_utils-inl.h"
+#include "entrypoints/quick/quick_entrypoint_counters.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
 #include "gc/accounting/card_table-inl.h"
 #include "imt_conflict_table.h"
@@ -33,6 +34,7 @@
 #include "index_bss_mapping.h"
 #include "instrumentation.h"
 #include "interpreter/interpreter.h"
+#include "interpreter/interpreter_cache.h"
 #include "jit/jit.h"
 #include "linear_alloc.h"
 #include "method_handles.h"
@@ -1297,6 +1299,10 @@ extern "C" const void* artQuickResolutionTrampoline(
   ScopedObjectAccessUnchecked soa(env);
   ScopedJniEnvLocalRefState env_state(env);
   const char* old_cause = self->StartAssertNoThreadSuspension("Quick method resolution set up");
+  if (UNLIKELY(QuickEntrypointCounters::IsEnabled())) {
+    QuickEntrypointCounters::CountCall(QuickEntrypointCounters::kResolutionTrampoline,
+                                       QuickArgumentVisitor::GetCallingMethod(sp));
+  }
 
   // Compute details about the called method (avoid GCs)
   ClassLinker* linker = Runtime::Current()->GetClassLinker();
@@ -2049,7 +2055,17 @@ class ComputeGenericJniFrameSize FINAL : public ComputeNativeCallFrameSize {
                          HandleScope** handle_scope, uintptr_t** start_stack, uintptr_t** start_gpr,
                          uint32_t** start_fpr)
       REQUIRES_SHARED(Locks::mutator_lock_) {
-    Walk(shorty, shorty_len);
+    if (kCanCountArguments) {
+      CountArguments(shorty, shorty_len);
+      if (kIsDebugBuild) {
+        ComputeGenericJniFrameSize fsc(critical_native_);
+        fsc.Walk(shorty, shorty_len);
+        DCHECK_EQ(num_stack_entries_, fsc.num_stack_entries_) << shorty;
+        DCHECK_EQ(num_handle_scope_references_, fsc.num_handle_scope_references_) << shorty;
+      }
+    } else {
+      Walk(shorty, shorty_len);
+    }
 
     // JNI part.
     uint8_t* sp8 = LayoutJNISaveFrame(self, m, reinterpret_cast<void*>(*m), handle_scope);
@@ -2067,6 +2083,43 @@ class ComputeGenericJniFrameSize FINAL : public ComputeNativeCallFrameSize {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
  private:
+  using StateMachine = BuildNativeCallFrameStateMachine<ComputeNativeCallFrameSize>;
+
+  // With a hard float ABI where each argument takes a single register or stack slot, without
+  // alignment, the frame size only depends on the number of core and floating point arguments.
+  static constexpr bool kCanCountArguments =
+      !StateMachine::kNativeSoftFloatAbi &&
+      StateMachine::kRegistersNeededForLong == 1u &&
+      StateMachine::kRegistersNeededForDouble == 1u;
+
+  // Compute the same sizes as Walk() with a single scan of the shorty, instead of running the
+  // state machine for each argument.
+  void CountArguments(const char* shorty, uint32_t shorty_len) {
+    DCHECK(kCanCountArguments);
+    // The JNIEnv* and the jclass or this are always passed in core registers, and have no
+    // character in the shorty.
+    uint32_t num_gpr_args = critical_native_ ? 0u : 2u;
+    uint32_t num_fpr_args = 0u;
+    num_handle_scope_references_ = critical_native_ ? 0u : 1u;
+    for (uint32_t i = 1; i < shorty_len; ++i) {
+      if (shorty[i] == 'F' || shorty[i] == 'D') {
+        ++num_fpr_args;
+      } else {
+        ++num_gpr_args;
+        if (shorty[i] == 'L') {
+          ++num_handle_scope_references_;
+        }
+      }
+    }
+    uint32_t num_gpr_stack_entries = (num_gpr_args > StateMachine::kNumNativeGprArgs)
+        ? num_gpr_args - StateMachine::kNumNativeGprArgs
+        : 0u;
+    uint32_t num_fpr_stack_entries = (num_fpr_args > StateMachine::kNumNativeFprArgs)
+        ? num_fpr_args - StateMachine::kNumNativeFprArgs
+        : 0u;
+    num_stack_entries_ = num_gpr_stack_entries + num_fpr_stack_entries;
+  }
+
   uint32_t num_handle_scope_references_;
   const bool critical_native_;
 };
@@ -2365,6 +2418,8 @@ extern "C" TwoWordReturn artQuickGenericJniTrampoline(Thread* self, ArtMethod**
   bool critical_native = called->IsCriticalNative();
   bool fast_native = called->IsFastNative();
   bool normal_native = !critical_native && !fast_native;
+  // Native code which never uses its JNIEnv* cannot create local references.
+  bool needs_local_ref_frame = !critical_native && !called->IsAutoCriticalNative();
 
   // Run the visitor and update sp.
   BuildGenericJniFrameVisitor visitor(self,
@@ -2385,10 +2440,9 @@ extern "C" TwoWordReturn artQuickGenericJniTrampoline(Thread* self, ArtMethod**
 
   self->VerifyStack();
 
-  uint32_t cookie;
-  uint32_t* sp32;
-  // Skip calling JniMethodStart for @CriticalNative.
-  if (LIKELY(!critical_native)) {
+  uint32_t cookie = kGenericJniNoLocalRefFrameCookie;
+  // Skip calling JniMethodStart for @CriticalNative and when no local reference frame is needed.
+  if (LIKELY(needs_local_ref_frame)) {
     // Start JNI, save the cookie.
     if (called->IsSynchronized()) {
       DCHECK(normal_native) << " @FastNative and synchronize is not supported";
@@ -2406,9 +2460,13 @@ extern "C" TwoWordReturn artQuickGenericJniTrampoline(Thread* self, ArtMethod**
         cookie = JniMethodStart(self);
       }
     }
-    sp32 = reinterpret_cast<uint32_t*>(sp);
-    *(sp32 - 1) = cookie;
+    DCHECK_EQ(cookie & kGenericJniFastNativeCookieBit, 0u);
   }
+  // Save the cookie, with the decisions made above, for artQuickGenericJniEndTrampoline().
+  uint32_t* sp32 = reinterpret_cast<uint32_t*>(sp);
+  *(sp32 - 1) = (fast_native && needs_local_ref_frame)
+      ? (cookie | kGenericJniFastNativeCookieBit)
+      : cookie;
 
   // Retrieve the stored native code.
   void const* nativeCode = called->GetEntryPointFromJni();
@@ -2430,7 +2488,7 @@ extern "C" TwoWordReturn artQuickGenericJniTrampoline(Thread* self, ArtMethod**
       DCHECK(self->IsExceptionPending());    // There should be an exception pending now.
 
       // @CriticalNative calls do not need to call back into JniMethodEnd.
-      if (LIKELY(!critical_native)) {
+      if (LIKELY(needs_local_ref_frame)) {
         // End JNI, as the assembly will move to deliver the exception.
         jobject lock = called->IsSynchronized() ? visitor.GetFirstHandleScopeJObject() : nullptr;
         if (shorty[0] == 'L') {
@@ -2777,10 +2835,19 @@ extern "C" uintptr_t artInvokePolymorphic(
   raw_receiver = nullptr;
   self->EndAssertNoThreadSuspension(old_cause);
 
-  // Resolve method.
+  // Resolve method, or find it in the cache like DoInvokePolymorphic.
   ClassLinker* linker = Runtime::Current()->GetClassLinker();
-  ArtMethod* resolved_method = linker->ResolveMethod<ClassLinker::ResolveMode::kCheckICCEAndIAE>(
-      self, inst.VRegB(), caller_method, kVirtual);
+  interpreter::InterpreterCache* cache = self->GetInterpreterCache();
+  ArtMethod* resolved_method;
+  if (!cache->Get(&inst, &resolved_method)) {
+    resolved_method = linker->ResolveMethod<ClassLinker::ResolveMode::kCheckICCEAndIAE>(
+        self, inst.VRegB(), caller_method, kVirtual);
+    if (UNLIKELY(resolved_method == nullptr)) {
+      DCHECK(self->IsExceptionPending());
+      return static_cast<uintptr_t>('V');
+    }
+    cache->Set(&inst, resolved_method);
+  }
 
   if (UNLIKELY(receiver_handle.IsNull())) {
     ThrowNullPointerExceptionForMethodAccess(resolved_method, InvokeType::kVirtual);
@@ -2859,4 +2926,14 @@ extern "C" uintptr_t artInvokePolymorphic(
   return static_cast<uintptr_t>(shorty[0]);
 }
 
+// Called by the frame entry of baseline code once the method is hot.
+extern "C" void artCompileOptimized(ArtMethod* method, Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ScopedQuickEntrypointChecks sqec(self);
+  // The caller has no stack map for its frame entry, so its frame cannot be visited: only
+  // post the request here, the JIT queues the compilation later.
+  ScopedAssertNoThreadSuspension sants("Requesting optimized compilation");
+  Runtime::Current()->GetJit()->RequestOptimizedCompilation(method);
+}
+
 }  // namespace art
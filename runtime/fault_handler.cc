@@ -21,6 +21,8 @@
 #include <sys/mman.h>
 #include <sys/ucontext.h>
 
+#include <algorithm>
+
 #include "art_method-inl.h"
 #include "base/logging.h"  // For VLOG
 #include "base/safe_copy.h"
@@ -124,11 +126,81 @@ static bool SafeVerifyClassClass(mirror::Class* cls) REQUIRES_SHARED(Locks::muta
 #endif
 
 
-FaultManager::FaultManager() : initialized_(false) {
+FaultManager::FaultManager()
+    : initialized_(false),
+      generated_code_ranges_lock_("Generated code ranges lock", kGenericBottomLock),
+      published_ranges_(nullptr),
+      range_lookups_in_flight_(0u) {
   sigaction(SIGSEGV, nullptr, &oldaction_);
 }
 
 FaultManager::~FaultManager() {
+  delete published_ranges_.LoadRelaxed();
+  STLDeleteElements(&retired_ranges_);
+}
+
+void FaultManager::AddGeneratedCodeRange(const void* start, size_t size) {
+  uintptr_t begin = reinterpret_cast<uintptr_t>(start);
+  MutexLock mu(Thread::Current(), generated_code_ranges_lock_);
+  generated_code_ranges_.push_back({ begin, begin + size });
+  UpdatePublishedRanges();
+}
+
+void FaultManager::RemoveGeneratedCodeRange(const void* start, size_t size) {
+  uintptr_t begin = reinterpret_cast<uintptr_t>(start);
+  MutexLock mu(Thread::Current(), generated_code_ranges_lock_);
+  auto it = std::find_if(generated_code_ranges_.begin(),
+                         generated_code_ranges_.end(),
+                         [begin, size](const GeneratedCodeRange& range) {
+                           return range.start == begin && range.end == begin + size;
+                         });
+  CHECK(it != generated_code_ranges_.end()) << "Removing unknown generated code range " << start;
+  generated_code_ranges_.erase(it);
+  UpdatePublishedRanges();
+}
+
+void FaultManager::UpdatePublishedRanges() {
+  GeneratedCodeRanges sorted = generated_code_ranges_;
+  std::sort(sorted.begin(),
+            sorted.end(),
+            [](const GeneratedCodeRange& lhs, const GeneratedCodeRange& rhs) {
+              return lhs.start < rhs.start;
+            });
+  GeneratedCodeRanges* ranges = new GeneratedCodeRanges();
+  for (const GeneratedCodeRange& range : sorted) {
+    if (!ranges->empty() && range.start <= ranges->back().end) {
+      ranges->back().end = std::max(ranges->back().end, range.end);
+    } else {
+      ranges->push_back(range);
+    }
+  }
+  const GeneratedCodeRanges* old_ranges = published_ranges_.ExchangeSequentiallyConsistent(ranges);
+  if (old_ranges != nullptr) {
+    retired_ranges_.push_back(old_ranges);
+  }
+  // A lookup loads the ranges after announcing itself, so if none is in flight after the
+  // exchange, the later ones all see the new ranges.
+  if (range_lookups_in_flight_.LoadSequentiallyConsistent() == 0u) {
+    STLDeleteElements(&retired_ranges_);
+  }
+}
+
+bool FaultManager::IsInGeneratedCodeRange(uintptr_t pc) {
+  range_lookups_in_flight_.FetchAndAddSequentiallyConsistent(1u);
+  const GeneratedCodeRanges* ranges = published_ranges_.LoadSequentiallyConsistent();
+  bool result = true;  // Without registered ranges, look for the method of all the pcs.
+  if (ranges != nullptr) {
+    // The last range starting before `pc`. The return pc of a fault can be the end of the code.
+    auto it = std::lower_bound(ranges->begin(),
+                               ranges->end(),
+                               pc,
+                               [](const GeneratedCodeRange& range, uintptr_t value) {
+                                 return range.start < value;
+                               });
+    result = (it != ranges->begin()) && pc <= (it - 1)->end;
+  }
+  range_lookups_in_flight_.FetchAndSubSequentiallyConsistent(1u);
+  return result;
 }
 
 void FaultManager::Init() {
@@ -297,6 +369,12 @@ bool FaultManager::IsInGeneratedCode(siginfo_t* siginfo, void* context, bool che
   // are in architecture specific files in arch/<arch>/fault_handler_<arch>.
   GetMethodAndReturnPcAndSp(siginfo, context, &method_obj, &return_pc, &sp);
 
+  // Reject the faults outside of the generated code before looking at the potential method.
+  if (!IsInGeneratedCodeRange(return_pc)) {
+    VLOG(signals) << "not in a generated code range";
+    return false;
+  }
+
   // If we don't have a potential method, we're outta here.
   VLOG(signals) << "potential method: " << method_obj;
   // TODO: Check linear alloc and image.
@@ -24,7 +24,8 @@
 
 #include <vector>
 
-#include "base/mutex.h"  // For annotalysis.
+#include "base/atomic.h"
+#include "base/mutex.h"
 
 namespace art {
 
@@ -61,7 +62,28 @@ class FaultManager {
   bool IsInGeneratedCode(siginfo_t* siginfo, void *context, bool check_dex_pc)
                          NO_THREAD_SAFETY_ANALYSIS;
 
+  // Register the memory [start, start + size) holding generated code, which stays valid until it
+  // is removed. Once a range is registered, the faults at pcs outside of all the ranges are not
+  // considered to be in generated code, without looking for their method.
+  void AddGeneratedCodeRange(const void* start, size_t size)
+      REQUIRES(!generated_code_ranges_lock_);
+  void RemoveGeneratedCodeRange(const void* start, size_t size)
+      REQUIRES(!generated_code_ranges_lock_);
+
+  // Return false if `pc` is known not to be in generated code. Called in the signal handler,
+  // reads the ranges without locks.
+  bool IsInGeneratedCodeRange(uintptr_t pc);
+
  private:
+  struct GeneratedCodeRange {
+    uintptr_t start;
+    uintptr_t end;
+  };
+  using GeneratedCodeRanges = std::vector<GeneratedCodeRange>;
+
+  // Publish the union of `generated_code_ranges_` for the signal handler.
+  void UpdatePublishedRanges() REQUIRES(generated_code_ranges_lock_);
+
   // The HandleFaultByOtherHandlers function is only called by HandleFault function for generated code.
   bool HandleFaultByOtherHandlers(int sig, siginfo_t* info, void* context)
                                   NO_THREAD_SAFETY_ANALYSIS;
@@ -70,6 +92,17 @@ class FaultManager {
   std::vector<FaultHandler*> other_handlers_;
   struct sigaction oldaction_;
   bool initialized_;
+
+  Mutex generated_code_ranges_lock_;
+  // The registered ranges, possibly overlapping.
+  GeneratedCodeRanges generated_code_ranges_ GUARDED_BY(generated_code_ranges_lock_);
+  // Sorted disjoint union of the registered ranges, read by the signal handler. Each change
+  // publishes a new copy, the previous one is retired and freed once no lookup is in flight,
+  // like the PC index of the JIT code cache.
+  Atomic<const GeneratedCodeRanges*> published_ranges_;
+  Atomic<size_t> range_lookups_in_flight_;
+  std::vector<const GeneratedCodeRanges*> retired_ranges_ GUARDED_BY(generated_code_ranges_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(FaultManager);
 };
 
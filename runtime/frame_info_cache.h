@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_FRAME_INFO_CACHE_H_
+#define ART_RUNTIME_FRAME_INFO_CACHE_H_
+
+#include <array>
+#include <limits>
+
+#include "base/atomic.h"
+#include "base/bit_utils.h"
+#include "base/macros.h"
+
+namespace art {
+
+class ArtMethod;
+class OatQuickMethodHeader;
+
+// A small direct-mapped cache of what the stack walks of a thread decode for a quick frame: the
+// method header containing the PC of the frame and the number of frames inlined at that PC. The
+// entries are keyed by the PC and the method of the frame, and a header is only read for frames
+// on the stack, whose code is alive. The JIT code cache calls InvalidateAll before freeing code,
+// and the class linker before unloading a class loader, and each cache is then cleared on its
+// next use.
+class FrameInfoCache {
+ public:
+  // Power of two, so that computing the index is cheap.
+  static constexpr size_t kSize = 64;
+
+  // The inline depth of an entry not yet visited by a walk of the inlined frames.
+  static constexpr uint32_t kUnknownInlineDepth = std::numeric_limits<uint32_t>::max();
+
+  struct Entry {
+    uintptr_t pc;
+    ArtMethod* method;
+    const OatQuickMethodHeader* header;
+    uint32_t inline_depth;
+  };
+
+  FrameInfoCache();
+
+  // Return the entry for the frame of `method` at `pc`, or null if there is none.
+  ALWAYS_INLINE Entry* Find(ArtMethod* method, uintptr_t pc) {
+    if (UNLIKELY(epoch_ != global_epoch_.LoadAcquire())) {
+      Clear();
+      return nullptr;
+    }
+    Entry* entry = &entries_[IndexOf(pc)];
+    return (entry->pc == pc && entry->method == method) ? entry : nullptr;
+  }
+
+  ALWAYS_INLINE Entry* Add(ArtMethod* method,
+                           uintptr_t pc,
+                           const OatQuickMethodHeader* header) {
+    Entry* entry = &entries_[IndexOf(pc)];
+    *entry = Entry{pc, method, header, kUnknownInlineDepth};
+    return entry;
+  }
+
+  void Clear();
+
+  // Invalidate the caches of all the threads, before compiled code or the methods of a class
+  // loader are freed.
+  static void InvalidateAll();
+
+ private:
+  static size_t IndexOf(uintptr_t pc) {
+    static_assert(IsPowerOfTwo(kSize), "Size must be a power of two");
+    // Mix in the higher bits, the return PCs of calls are often a few bytes apart.
+    return (pc ^ (pc >> 6)) & (kSize - 1);
+  }
+
+  static Atomic<uint32_t> global_epoch_;
+
+  // The value of `global_epoch_` when the cache was last cleared. The cache is stale when they
+  // differ.
+  uint32_t epoch_;
+  std::array<Entry, kSize> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameInfoCache);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_FRAME_INFO_CACHE_H_
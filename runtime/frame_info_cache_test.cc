@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_info_cache.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+TEST(FrameInfoCache, FindAdd) {
+  std::unique_ptr<FrameInfoCache> cache(new FrameInfoCache());
+  uint64_t methods[2];
+  ArtMethod* method = reinterpret_cast<ArtMethod*>(&methods[0]);
+  ArtMethod* other_method = reinterpret_cast<ArtMethod*>(&methods[1]);
+  uint64_t code[4];
+  const OatQuickMethodHeader* header = reinterpret_cast<const OatQuickMethodHeader*>(&code[0]);
+  uintptr_t pc = reinterpret_cast<uintptr_t>(&code[2]);
+
+  EXPECT_TRUE(cache->Find(method, pc) == nullptr);
+  FrameInfoCache::Entry* entry = cache->Add(method, pc, header);
+  EXPECT_EQ(FrameInfoCache::kUnknownInlineDepth, entry->inline_depth);
+  entry->inline_depth = 2u;
+
+  entry = cache->Find(method, pc);
+  ASSERT_TRUE(entry != nullptr);
+  EXPECT_EQ(header, entry->header);
+  EXPECT_EQ(2u, entry->inline_depth);
+  // The entries are specific to the method and to the PC.
+  EXPECT_TRUE(cache->Find(other_method, pc) == nullptr);
+  EXPECT_TRUE(cache->Find(method, pc + 4u) == nullptr);
+
+  // Frames without a method header are cached too.
+  cache->Add(other_method, pc, nullptr);
+  entry = cache->Find(other_method, pc);
+  ASSERT_TRUE(entry != nullptr);
+  EXPECT_TRUE(entry->header == nullptr);
+
+  cache->Clear();
+  EXPECT_TRUE(cache->Find(other_method, pc) == nullptr);
+}
+
+TEST(FrameInfoCache, InvalidateAll) {
+  std::unique_ptr<FrameInfoCache> cache(new FrameInfoCache());
+  uint64_t methods[1];
+  ArtMethod* method = reinterpret_cast<ArtMethod*>(&methods[0]);
+  uint64_t code[2];
+  const OatQuickMethodHeader* header = reinterpret_cast<const OatQuickMethodHeader*>(&code[0]);
+  uintptr_t pc = reinterpret_cast<uintptr_t>(&code[1]);
+  cache->Add(method, pc, header);
+  ASSERT_TRUE(cache->Find(method, pc) != nullptr);
+  FrameInfoCache::InvalidateAll();
+  EXPECT_TRUE(cache->Find(method, pc) == nullptr);
+  // The cache can be used again after it was cleared.
+  cache->Add(method, pc, header);
+  EXPECT_TRUE(cache->Find(method, pc) != nullptr);
+}
+
+}  // namespace art
@@ -91,7 +91,7 @@ CardTable* CardTable::Create(const uint8_t* heap_begin, size_t heap_capacity) {
 }
 
 CardTable::CardTable(MemMap* mem_map, uint8_t* biased_begin, size_t offset)
-    : mem_map_(mem_map), biased_begin_(biased_begin), offset_(offset) {
+    : mem_map_(mem_map), biased_begin_(biased_begin), offset_(offset), use_huge_pages_(false) {
 }
 
 CardTable::~CardTable() {
@@ -109,7 +109,16 @@ void CardTable::ClearCardRange(uint8_t* start, uint8_t* end) {
   static_assert(kCardClean == 0, "kCardClean must be 0");
   uint8_t* start_card = CardFromAddr(start);
   uint8_t* end_card = CardFromAddr(end);
-  ZeroAndReleasePages(start_card, end_card - start_card);
+  if (use_huge_pages_) {
+    ZeroAndReleaseHugePages(start_card, end_card - start_card);
+  } else {
+    ZeroAndReleasePages(start_card, end_card - start_card);
+  }
+}
+
+void CardTable::UseHugePages() {
+  mem_map_->MadviseHugePages();
+  use_huge_pages_ = true;
 }
 
 bool CardTable::AddrIsInCardTable(const void* addr) const {
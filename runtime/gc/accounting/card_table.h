@@ -124,6 +124,10 @@ class CardTable {
   // Clear a range of cards that covers start to end, start and end must be aligned to kCardSize.
   void ClearCardRange(uint8_t* start, uint8_t* end);
 
+  // Back the card table with transparent huge pages. ClearCardRange then only releases whole
+  // huge pages.
+  void UseHugePages();
+
   // Returns the first address in the heap which maps to this card.
   void* AddrFromCard(const uint8_t *card_addr) const ALWAYS_INLINE;
 
@@ -151,6 +155,9 @@ class CardTable {
   // to allow the byte value of biased_begin_ to equal GC_CARD_DIRTY
   const size_t offset_;
 
+  // Whether the card table is backed with transparent huge pages, see UseHugePages.
+  bool use_huge_pages_;
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(CardTable);
 };
 
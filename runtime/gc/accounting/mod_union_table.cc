@@ -541,6 +541,17 @@ void ModUnionTableCardCache::ClearTable() {
 
 // Mark all references to the alloc space(s).
 void ModUnionTableCardCache::UpdateAndMarkReferences(MarkObjectVisitor* visitor) {
+  UpdateAndMarkReferencesInRange(visitor,
+                                 space_->Begin(),
+                                 AlignUp(space_->End(), CardTable::kCardSize));
+}
+
+void ModUnionTableCardCache::UpdateAndMarkReferencesInRange(MarkObjectVisitor* visitor,
+                                                            uint8_t* begin,
+                                                            uint8_t* end) {
+  DCHECK_LE(space_->Begin(), begin);
+  DCHECK_LE(begin, end);
+  DCHECK_LE(end, AlignUp(space_->End(), CardTable::kCardSize));
   // TODO: Needs better support for multi-images? b/26317072
   space::ImageSpace* image_space =
       heap_->GetBootImageSpaces().empty() ? nullptr : heap_->GetBootImageSpaces()[0];
@@ -548,8 +559,9 @@ void ModUnionTableCardCache::UpdateAndMarkReferences(MarkObjectVisitor* visitor)
   // space_ instead of image_space to avoid a null check in ModUnionUpdateObjectReferencesVisitor.
   CardBitVisitor bit_visitor(visitor, space_, image_space != nullptr ? image_space : space_,
       card_bitmap_.get());
-  card_bitmap_->VisitSetBits(
-      0, RoundUp(space_->Size(), CardTable::kCardSize) / CardTable::kCardSize, bit_visitor);
+  card_bitmap_->VisitSetBits((begin - space_->Begin()) / CardTable::kCardSize,
+                             (end - space_->Begin()) / CardTable::kCardSize,
+                             bit_visitor);
 }
 
 void ModUnionTableCardCache::VisitObjects(ObjectCallback callback, void* arg) {
@@ -79,6 +79,20 @@ class ModUnionTable {
   // references to other spaces which are stored in the mod-union table.
   virtual void UpdateAndMarkReferences(MarkObjectVisitor* visitor) = 0;
 
+  // Returns the alignment of the ranges of the space for UpdateAndMarkReferencesInRange(), or 0
+  // if the table only supports UpdateAndMarkReferences().
+  virtual size_t GetRangeAlignment() const {
+    return 0;
+  }
+
+  // Same as UpdateAndMarkReferences() for the cards of [begin, end) only. Calls for disjoint
+  // ranges may run in parallel, with visitors which mark atomically.
+  virtual void UpdateAndMarkReferencesInRange(MarkObjectVisitor* visitor ATTRIBUTE_UNUSED,
+                                              uint8_t* begin ATTRIBUTE_UNUSED,
+                                              uint8_t* end ATTRIBUTE_UNUSED) {
+    LOG(FATAL) << "Unsupported UpdateAndMarkReferencesInRange for " << name_;
+  }
+
   // Visit all of the objects that may contain references to other spaces.
   virtual void VisitObjects(ObjectCallback callback, void* arg) = 0;
 
@@ -179,6 +193,17 @@ class ModUnionTableCardCache : public ModUnionTable {
       REQUIRES(Locks::heap_bitmap_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // The ranges cover whole words of the card bitmap, whose bits are cleared non-atomically.
+  virtual size_t GetRangeAlignment() const OVERRIDE {
+    return CardTable::kCardSize * sizeof(uintptr_t) * kBitsPerByte;
+  }
+
+  virtual void UpdateAndMarkReferencesInRange(MarkObjectVisitor* visitor,
+                                              uint8_t* begin,
+                                              uint8_t* end) OVERRIDE
+      REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   virtual void VisitObjects(ObjectCallback callback, void* arg) OVERRIDE
       REQUIRES(Locks::heap_bitmap_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
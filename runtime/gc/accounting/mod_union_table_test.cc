@@ -64,7 +64,7 @@ class ModUnionTableTest : public CommonRuntimeTest {
   void ResetClass() {
     java_lang_object_array_ = nullptr;
   }
-  void RunTest(ModUnionTableFactory::TableType type);
+  void RunTest(ModUnionTableFactory::TableType type, bool in_ranges = false);
 
  private:
   mirror::Class* GetObjectArrayClass(Thread* self, space::ContinuousMemMapAllocSpace* space)
@@ -170,11 +170,32 @@ TEST_F(ModUnionTableTest, TestCardCache) {
   RunTest(ModUnionTableFactory::kTableTypeCardCache);
 }
 
+TEST_F(ModUnionTableTest, TestCardCacheInRanges) {
+  RunTest(ModUnionTableFactory::kTableTypeCardCache, /* in_ranges */ true);
+}
+
 TEST_F(ModUnionTableTest, TestReferenceCache) {
   RunTest(ModUnionTableFactory::kTableTypeReferenceCache);
 }
 
-void ModUnionTableTest::RunTest(ModUnionTableFactory::TableType type) {
+// Update the table, range by range of the space as by the parallel GC workers if `in_ranges`.
+static void UpdateAndMarkReferences(ModUnionTable* table,
+                                    MarkObjectVisitor* visitor,
+                                    bool in_ranges) REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (!in_ranges) {
+    table->UpdateAndMarkReferences(visitor);
+    return;
+  }
+  const size_t alignment = table->GetRangeAlignment();
+  ASSERT_NE(alignment, 0u);
+  space::ContinuousSpace* space = table->GetSpace();
+  uint8_t* end = AlignUp(space->End(), CardTable::kCardSize);
+  for (uint8_t* begin = space->Begin(); begin < end; begin += alignment) {
+    table->UpdateAndMarkReferencesInRange(visitor, begin, std::min(begin + alignment, end));
+  }
+}
+
+void ModUnionTableTest::RunTest(ModUnionTableFactory::TableType type, bool in_ranges) {
   Thread* const self = Thread::Current();
   ScopedObjectAccess soa(self);
   Runtime* const runtime = Runtime::Current();
@@ -218,7 +239,7 @@ void ModUnionTableTest::RunTest(ModUnionTableFactory::TableType type) {
   table->ProcessCards();
   std::set<mirror::Object*> visited_before;
   CollectVisitedVisitor collector_before(&visited_before);
-  table->UpdateAndMarkReferences(&collector_before);
+  UpdateAndMarkReferences(table.get(), &collector_before, in_ranges);
   // Check that we visited all the references in other spaces only.
   ASSERT_GE(visited_before.size(), 2u);
   ASSERT_TRUE(visited_before.find(other_space_ref1) != visited_before.end());
@@ -250,7 +271,7 @@ void ModUnionTableTest::RunTest(ModUnionTableFactory::TableType type) {
   // Visit again and make sure the cards got cleared back to their sane state.
   std::set<mirror::Object*> visited_after;
   CollectVisitedVisitor collector_after(&visited_after);
-  table->UpdateAndMarkReferences(&collector_after);
+  UpdateAndMarkReferences(table.get(), &collector_after, in_ranges);
   // Check that we visited a superset after.
   for (auto* obj : visited_before) {
     ASSERT_TRUE(visited_after.find(obj) != visited_after.end()) << obj;
@@ -68,7 +68,8 @@ SpaceBitmap<kAlignment>::SpaceBitmap(const std::string& name,
       bitmap_size_(bitmap_size),
       heap_begin_(reinterpret_cast<uintptr_t>(heap_begin)),
       heap_limit_(reinterpret_cast<uintptr_t>(heap_begin) + heap_capacity),
-      name_(name) {
+      name_(name),
+      use_huge_pages_(false) {
   CHECK(bitmap_begin_ != nullptr);
   CHECK_NE(bitmap_size, 0U);
 }
@@ -134,8 +135,19 @@ void SpaceBitmap<kAlignment>::ClearRange(const mirror::Object* begin, const mirr
   // Bitmap word boundaries.
   const uintptr_t start_index = OffsetToIndex(begin_offset);
   const uintptr_t end_index = OffsetToIndex(end_offset);
-  ZeroAndReleasePages(reinterpret_cast<uint8_t*>(&bitmap_begin_[start_index]),
-                      (end_index - start_index) * sizeof(*bitmap_begin_));
+  uint8_t* const clear_begin = reinterpret_cast<uint8_t*>(&bitmap_begin_[start_index]);
+  const size_t clear_size = (end_index - start_index) * sizeof(*bitmap_begin_);
+  if (use_huge_pages_) {
+    ZeroAndReleaseHugePages(clear_begin, clear_size);
+  } else {
+    ZeroAndReleasePages(clear_begin, clear_size);
+  }
+}
+
+template<size_t kAlignment>
+void SpaceBitmap<kAlignment>::UseHugePages() {
+  mem_map_->MadviseHugePages();
+  use_huge_pages_ = true;
 }
 
 template<size_t kAlignment>
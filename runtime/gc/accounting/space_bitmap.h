@@ -105,6 +105,9 @@ class SpaceBitmap {
   // Clear a range covered by the bitmap using madvise if possible.
   void ClearRange(const mirror::Object* begin, const mirror::Object* end);
 
+  // Back the bitmap with transparent huge pages. ClearRange then only releases whole huge pages.
+  void UseHugePages();
+
   // Test whether `obj` is part of the bitmap (i.e. return whether the bit
   // corresponding to `obj` has been set in the bitmap).
   //
@@ -244,6 +247,9 @@ class SpaceBitmap {
 
   // Name of this bitmap.
   std::string name_;
+
+  // Whether the bitmap is backed with transparent huge pages, see UseHugePages.
+  bool use_huge_pages_;
 };
 
 typedef SpaceBitmap<kObjectAlignment> ContinuousSpaceBitmap;
@@ -92,6 +92,19 @@ void AllocRecordObjectMap::SetProperties() {
       max_stack_depth_ = value;
     }
   }
+  // Check whether there's a system property asking to only record a sample of the allocations.
+  propertyName = "dalvik.vm.allocTrackerSampleInterval";
+  char sampleIntervalString[PROPERTY_VALUE_MAX];
+  if (property_get(propertyName, sampleIntervalString, "") > 0) {
+    char* end;
+    size_t value = strtoul(sampleIntervalString, &end, 10);
+    if (*end != '\0') {
+      LOG(ERROR) << "Ignoring  " << propertyName << " '" << sampleIntervalString
+                 << "' --- invalid";
+    } else {
+      Runtime::Current()->GetHeap()->SetAllocSamplingInterval(value);
+    }
+  }
 #endif  // ART_TARGET_ANDROID
 }
 
@@ -237,9 +250,13 @@ void AllocRecordObjectMap::SetAllocTrackingEnabled(bool enable) {
       }
       size_t sz = sizeof(AllocRecordStackTraceElement) * records->max_stack_depth_ +
                   sizeof(AllocRecord) + sizeof(AllocRecordStackTrace);
+      const size_t sampling_interval = heap->GetAllocSamplingInterval();
       LOG(INFO) << "Enabling alloc tracker (" << records->alloc_record_max_ << " entries of "
                 << records->max_stack_depth_ << " frames, taking up to "
-                << PrettySize(sz * records->alloc_record_max_) << ")";
+                << PrettySize(sz * records->alloc_record_max_) << ", "
+                << (sampling_interval == 0u
+                        ? std::string("all allocations")
+                        : "one sample every " + PrettySize(sampling_interval)) << ")";
     }
     Runtime::Current()->GetInstrumentation()->InstrumentQuickAllocEntryPoints();
     {
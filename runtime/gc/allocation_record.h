@@ -209,7 +209,8 @@ class AllocRecordObjectMap {
   typedef std::list<EntryPair> EntryList;
 
   // Caller needs to check that it is enabled before calling since we read the stack trace before
-  // checking the enabled boolean.
+  // checking the enabled boolean. Only the allocations sampled by Heap::IsAllocationSampled are
+  // recorded.
   void RecordAllocation(Thread* self,
                         ObjPtr<mirror::Object>* obj,
                         size_t byte_count)
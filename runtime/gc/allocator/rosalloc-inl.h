@@ -99,6 +99,36 @@ inline void* RosAlloc::AllocFromThreadLocalRun(Thread* self, size_t size,
   return slot_addr;
 }
 
+inline size_t RosAlloc::AllocFromThreadLocalRun(Thread* self,
+                                                size_t size,
+                                                size_t count,
+                                                void** slots,
+                                                size_t* bracket_size) {
+  DCHECK(bracket_size != nullptr);
+  if (UNLIKELY(!IsSizeForThreadLocal(size))) {
+    return 0u;
+  }
+  size_t idx = SizeToIndexAndBracketSize(size, bracket_size);
+  Run* thread_local_run = reinterpret_cast<Run*>(self->GetRosAllocRun(idx));
+  if (kIsDebugBuild) {
+    // Need the lock to prevent race conditions.
+    MutexLock mu(self, *size_bracket_locks_[idx]);
+    CHECK(non_full_runs_[idx].find(thread_local_run) == non_full_runs_[idx].end());
+    CHECK(full_runs_[idx].find(thread_local_run) == full_runs_[idx].end());
+  }
+  DCHECK(thread_local_run != nullptr);
+  DCHECK(thread_local_run->IsThreadLocal() || thread_local_run == dedicated_full_run_);
+  size_t allocated = 0u;
+  for (; allocated < count; ++allocated) {
+    void* slot_addr = thread_local_run->AllocSlot();
+    if (slot_addr == nullptr) {
+      break;
+    }
+    slots[allocated] = slot_addr;
+  }
+  return allocated;
+}
+
 inline size_t RosAlloc::MaxBytesBulkAllocatedFor(size_t size) {
   if (UNLIKELY(!IsSizeForThreadLocal(size))) {
     return size;
@@ -16,6 +16,7 @@
 
 #include "rosalloc.h"
 
+#include <limits>
 #include <list>
 #include <map>
 #include <sstream>
@@ -87,6 +88,10 @@ RosAlloc::RosAlloc(void* base, size_t capacity, size_t max_capacity,
     size_bracket_locks_[i] = new Mutex(size_bracket_lock_names_[i].c_str(), kRosAllocBracketLock);
     current_runs_[i] = dedicated_full_run_;
   }
+  for (size_t i = 0; i < kNumThreadLocalSizeBrackets; i++) {
+    free_run_stacks_[i].StoreRelaxed(0u);
+    num_free_runs_[i].StoreRelaxed(0u);
+  }
   DCHECK_EQ(footprint_, capacity_);
   size_t num_of_pages = footprint_ / kPageSize;
   size_t max_num_of_pages = max_capacity_ / kPageSize;
@@ -677,39 +682,53 @@ void* RosAlloc::AllocFromRun(Thread* self, size_t size, size_t* bytes_allocated,
     if (UNLIKELY(slot_addr == nullptr)) {
       // The run got full. Try to free slots.
       DCHECK(thread_local_run->IsFull());
-      MutexLock mu(self, *size_bracket_locks_[idx]);
-      bool is_all_free_after_merge;
-      // This is safe to do for the dedicated_full_run_ since the bitmaps are empty.
-      if (thread_local_run->MergeThreadLocalFreeListToFreeList(&is_all_free_after_merge)) {
-        DCHECK_NE(thread_local_run, dedicated_full_run_);
-        // Some slot got freed. Keep it.
-        DCHECK(!thread_local_run->IsFull());
-        DCHECK_EQ(is_all_free_after_merge, thread_local_run->IsAllFree());
-      } else {
-        // No slots got freed. Try to refill the thread-local run.
-        DCHECK(thread_local_run->IsFull());
-        if (thread_local_run != dedicated_full_run_) {
-          thread_local_run->SetIsThreadLocal(false);
-          if (kIsDebugBuild) {
-            full_runs_[idx].insert(thread_local_run);
-            if (kTraceRosAlloc) {
-              LOG(INFO) << "RosAlloc::AllocFromRun() : Inserted run 0x" << std::hex
-                        << reinterpret_cast<intptr_t>(thread_local_run)
-                        << " into full_runs_[" << std::dec << idx << "]";
+      bool needs_refill = false;
+      {
+        MutexLock mu(self, *size_bracket_locks_[idx]);
+        bool is_all_free_after_merge;
+        // This is safe to do for the dedicated_full_run_ since the bitmaps are empty.
+        if (thread_local_run->MergeThreadLocalFreeListToFreeList(&is_all_free_after_merge)) {
+          DCHECK_NE(thread_local_run, dedicated_full_run_);
+          // Some slot got freed. Keep it.
+          DCHECK(!thread_local_run->IsFull());
+          DCHECK_EQ(is_all_free_after_merge, thread_local_run->IsAllFree());
+        } else {
+          // No slots got freed. Give the run up and refill the thread-local run.
+          DCHECK(thread_local_run->IsFull());
+          if (thread_local_run != dedicated_full_run_) {
+            thread_local_run->SetIsThreadLocal(false);
+            if (kIsDebugBuild) {
+              full_runs_[idx].insert(thread_local_run);
+              if (kTraceRosAlloc) {
+                LOG(INFO) << "RosAlloc::AllocFromRun() : Inserted run 0x" << std::hex
+                          << reinterpret_cast<intptr_t>(thread_local_run)
+                          << " into full_runs_[" << std::dec << idx << "]";
+              }
             }
+            DCHECK(non_full_runs_[idx].find(thread_local_run) == non_full_runs_[idx].end());
+            DCHECK(full_runs_[idx].find(thread_local_run) != full_runs_[idx].end());
           }
-          DCHECK(non_full_runs_[idx].find(thread_local_run) == non_full_runs_[idx].end());
-          DCHECK(full_runs_[idx].find(thread_local_run) != full_runs_[idx].end());
-        }
-
-        thread_local_run = RefillRun(self, idx);
-        if (UNLIKELY(thread_local_run == nullptr)) {
           self->SetRosAllocRun(idx, dedicated_full_run_);
-          return nullptr;
+          needs_refill = true;
+        }
+      }
+      if (needs_refill) {
+        // A completely free run has no slot that other threads may free, so it can become the
+        // thread-local run without the bracket lock.
+        thread_local_run = PopFreeRun(idx);
+        if (thread_local_run == nullptr) {
+          MutexLock mu(self, *size_bracket_locks_[idx]);
+          thread_local_run = RefillRun(self, idx);
+          if (UNLIKELY(thread_local_run == nullptr)) {
+            return nullptr;
+          }
+          DCHECK(non_full_runs_[idx].find(thread_local_run) == non_full_runs_[idx].end());
+          DCHECK(full_runs_[idx].find(thread_local_run) == full_runs_[idx].end());
+          // Under the lock, as FreeFromRun() checks it for the slots of a non-full run.
+          thread_local_run->SetIsThreadLocal(true);
+        } else {
+          thread_local_run->SetIsThreadLocal(true);
         }
-        DCHECK(non_full_runs_[idx].find(thread_local_run) == non_full_runs_[idx].end());
-        DCHECK(full_runs_[idx].find(thread_local_run) == full_runs_[idx].end());
-        thread_local_run->SetIsThreadLocal(true);
         self->SetRosAllocRun(idx, thread_local_run);
         DCHECK(!thread_local_run->IsFull());
       }
@@ -799,11 +818,7 @@ size_t RosAlloc::FreeFromRun(Thread* self, void* ptr, Run* run) {
     }
     DCHECK(non_full_runs_[idx].find(run) == non_full_runs_[idx].end());
     DCHECK(full_runs_[idx].find(run) == full_runs_[idx].end());
-    run->ZeroHeaderAndSlotHeaders();
-    {
-      MutexLock lock_mu(self, lock_);
-      FreePages(self, run, true);
-    }
+    FreeRun(self, idx, run);
   } else {
     // It is not completely free. If it wasn't the current run or
     // already in the non-full run set (i.e., it was full) insert it
@@ -1186,9 +1201,7 @@ size_t RosAlloc::BulkFree(Thread* self, void** ptrs, size_t num_ptrs) {
           DCHECK(non_full_runs->find(run) == non_full_runs->end());
         }
         if (!run_was_current) {
-          run->ZeroHeaderAndSlotHeaders();
-          MutexLock lock_mu(self, lock_);
-          FreePages(self, run, true);
+          FreeRun(self, idx, run);
         }
       } else {
         // It is not completely free. If it wasn't the current run or
@@ -1371,6 +1384,8 @@ size_t RosAlloc::UsableSize(const void* ptr) {
 
 bool RosAlloc::Trim() {
   MutexLock mu(Thread::Current(), lock_);
+  // Give back the runs kept for the thread local run refills, so that they can be trimmed too.
+  FreeAllFreeRuns(Thread::Current());
   FreePageRun* last_free_page_run;
   DCHECK_EQ(footprint_ % kPageSize, static_cast<size_t>(0));
   auto it = free_page_runs_.rbegin();
@@ -1578,9 +1593,7 @@ void RosAlloc::RevokeRun(Thread* self, size_t idx, Run* run) {
       }
     }
   } else if (run->IsAllFree()) {
-    run->ZeroHeaderAndSlotHeaders();
-    MutexLock mu(self, lock_);
-    FreePages(self, run, true);
+    FreeRun(self, idx, run);
   } else {
     non_full_runs_[idx].insert(run);
     DCHECK(non_full_runs_[idx].find(run) != non_full_runs_[idx].end());
@@ -1592,6 +1605,86 @@ void RosAlloc::RevokeRun(Thread* self, size_t idx, Run* run) {
   }
 }
 
+void RosAlloc::FreeRun(Thread* self, size_t idx, Run* run) {
+  DCHECK(run->IsAllFree());
+  DCHECK(!run->IsThreadLocal());
+  if (idx < kNumThreadLocalSizeBrackets && PushFreeRun(idx, run)) {
+    return;
+  }
+  run->ZeroHeaderAndSlotHeaders();
+  MutexLock mu(self, lock_);
+  FreePages(self, run, true);
+}
+
+bool RosAlloc::PushFreeRun(size_t idx, Run* run) {
+  DCHECK_LT(idx, kNumThreadLocalSizeBrackets);
+  DCHECK_EQ(run->size_bracket_idx_, idx);
+  if (num_free_runs_[idx].FetchAndAddRelaxed(1) >= kMaxFreeRunsPerBracket) {
+    num_free_runs_[idx].FetchAndSubRelaxed(1);
+    return false;
+  }
+  const uint64_t top = ToPageMapIndex(run) + 1;
+  DCHECK_LE(top, std::numeric_limits<uint32_t>::max());
+  uint64_t old_head;
+  do {
+    old_head = free_run_stacks_[idx].LoadRelaxed();
+    run->next_free_run_.StoreRelaxed(static_cast<uint32_t>(old_head));
+  } while (!free_run_stacks_[idx].CompareAndSetWeakRelease(
+      old_head, (((old_head >> 32) + 1) << 32) | top));
+  return true;
+}
+
+RosAlloc::Run* RosAlloc::PopFreeRun(size_t idx) {
+  DCHECK_LT(idx, kNumThreadLocalSizeBrackets);
+  uint64_t old_head;
+  Run* run;
+  do {
+    old_head = free_run_stacks_[idx].LoadAcquire();
+    const uint32_t top = static_cast<uint32_t>(old_head);
+    if (top == 0u) {
+      return nullptr;
+    }
+    run = reinterpret_cast<Run*>(base_ + (top - 1) * kPageSize);
+    // The run may be popped and reused concurrently, in which case the update counter makes the
+    // CAS fail and the link read here is discarded.
+    const uint64_t next = run->next_free_run_.LoadRelaxed();
+    if (free_run_stacks_[idx].CompareAndSetWeakAcquire(
+        old_head, (((old_head >> 32) + 1) << 32) | next)) {
+      break;
+    }
+  } while (true);
+  num_free_runs_[idx].FetchAndSubRelaxed(1);
+  run->next_free_run_.StoreRelaxed(0u);
+  DCHECK_EQ(run->magic_num_, kMagicNum);
+  DCHECK_EQ(run->size_bracket_idx_, idx);
+  DCHECK(run->IsAllFree());
+  return run;
+}
+
+void RosAlloc::FreeAllFreeRuns(Thread* self) {
+  for (size_t idx = 0; idx < kNumThreadLocalSizeBrackets; ++idx) {
+    for (Run* run = PopFreeRun(idx); run != nullptr; run = PopFreeRun(idx)) {
+      run->ZeroHeaderAndSlotHeaders();
+      FreePages(self, run, true);
+    }
+  }
+}
+
+bool RosAlloc::IsOnFreeRunStack(size_t idx, Run* run) {
+  if (idx >= kNumThreadLocalSizeBrackets) {
+    return false;
+  }
+  uint32_t top = static_cast<uint32_t>(free_run_stacks_[idx].LoadAcquire());
+  while (top != 0u) {
+    Run* cur = reinterpret_cast<Run*>(base_ + (top - 1) * kPageSize);
+    if (cur == run) {
+      return true;
+    }
+    top = cur->next_free_run_.LoadRelaxed();
+  }
+  return false;
+}
+
 void RosAlloc::RevokeThreadUnsafeCurrentRuns() {
   // Revoke the current runs which share the same idx as thread local runs.
   Thread* self = Thread::Current();
@@ -1949,9 +2042,12 @@ void RosAlloc::Run::Verify(Thread* self, RosAlloc* rosalloc, bool running_on_mem
     if (!is_current_run) {
       MutexLock mu(self, rosalloc->lock_);
       auto& non_full_runs = rosalloc->non_full_runs_[idx];
-      // If it's all free, it must be a free page run rather than a run.
-      CHECK(!IsAllFree()) << "A free run must be in a free page run set " << Dump();
-      if (!IsFull()) {
+      // If it's all free, it must be a free page run rather than a run, or be kept on the free
+      // run stack of its bracket.
+      if (IsAllFree()) {
+        CHECK(rosalloc->IsOnFreeRunStack(idx, this))
+            << "A free run must be in a free page run set or a free run stack " << Dump();
+      } else if (!IsFull()) {
         // If it's not full, it must in the non-full run set.
         CHECK(non_full_runs.find(this) != non_full_runs.end())
             << "A non-full run isn't in the non-full run set " << Dump();
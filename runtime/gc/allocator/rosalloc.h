@@ -29,6 +29,7 @@
 #include <android-base/logging.h>
 
 #include "base/allocator.h"
+#include "base/atomic.h"
 #include "base/bit_utils.h"
 #include "base/mutex.h"
 #include "globals.h"
@@ -354,7 +355,8 @@ class RosAlloc {
     uint8_t size_bracket_idx_;          // The index of the size bracket of this run.
     uint8_t is_thread_local_;           // True if this run is used as a thread-local run.
     uint8_t to_be_bulk_freed_;          // Used within BulkFree() to flag a run that's involved with a bulk free.
-    uint32_t padding_ ATTRIBUTE_UNUSED;
+    // The link in a free run stack: the page map index plus one of the next run, 0 for none.
+    Atomic<uint32_t> next_free_run_;
     // Use a tailless free list for free_list_ so that the alloc fast path does not manage the tail.
     SlotFreeList<false> free_list_;
     SlotFreeList<true> bulk_free_list_;
@@ -661,6 +663,10 @@ class RosAlloc {
   // The default value for page_release_size_threshold_.
   static constexpr size_t kDefaultPageReleaseSizeThreshold = 4 * MB;
 
+  // The maximum number of completely free runs kept for the refills of the thread local runs of
+  // each bracket.
+  static constexpr size_t kMaxFreeRunsPerBracket = 8;
+
   // We use thread-local runs for the size brackets whose indexes
   // are less than this index. We use shared (current) runs for the rest.
   // Sync this with the length of Thread::rosalloc_runs_.
@@ -735,6 +741,13 @@ class RosAlloc {
   Mutex* size_bracket_locks_[kNumOfSizeBrackets];
   // Bracket lock names (since locks only have char* names).
   std::string size_bracket_lock_names_[kNumOfSizeBrackets];
+  // Lock-free stacks of the completely free runs of the thread local size brackets, from which
+  // the thread local runs are refilled without taking lock_. The low 32 bits of a head are the
+  // page map index plus one of the top run, or 0 if the stack is empty, and the high 32 bits
+  // count the updates, against ABA.
+  Atomic<uint64_t> free_run_stacks_[kNumThreadLocalSizeBrackets];
+  // The number of runs in each free run stack, at most kMaxFreeRunsPerBracket.
+  Atomic<size_t> num_free_runs_[kNumThreadLocalSizeBrackets];
   // The types of page map entries.
   enum PageMapKind {
     kPageMapReleased = 0,     // Zero and released back to the OS.
@@ -819,6 +832,21 @@ class RosAlloc {
   // Revoke a run by adding it to non_full_runs_ or freeing the pages.
   void RevokeRun(Thread* self, size_t idx, Run* run) REQUIRES(!lock_);
 
+  // Free the completely free run `run` of bracket `idx`, keeping it on the free run stack of the
+  // bracket if there is room, or freeing its pages.
+  void FreeRun(Thread* self, size_t idx, Run* run) REQUIRES(!lock_);
+  // Push the completely free run `run` onto the free run stack of thread local bracket `idx`.
+  // Returns false if the stack is full.
+  bool PushFreeRun(size_t idx, Run* run);
+  // Pop a completely free run from the free run stack of thread local bracket `idx`. Returns
+  // null if the stack is empty.
+  Run* PopFreeRun(size_t idx);
+  // Free the pages of the runs of all the free run stacks.
+  void FreeAllFreeRuns(Thread* self) REQUIRES(lock_);
+  // Returns whether `run` is on the free run stack of bracket `idx`. The free run stacks must not
+  // change, for Verify().
+  bool IsOnFreeRunStack(size_t idx, Run* run);
+
   // Revoke the current runs which share an index with the thread local runs.
   void RevokeThreadUnsafeCurrentRuns() REQUIRES(!lock_);
 
@@ -865,6 +893,13 @@ class RosAlloc {
   // Allocate the given allocation request in an existing thread local
   // run without allocating a new run.
   ALWAYS_INLINE void* AllocFromThreadLocalRun(Thread* self, size_t size, size_t* bytes_allocated);
+  // Allocate up to `count` slots of the given size in an existing thread local run, without
+  // allocating a new run. Returns the number of slots stored in `slots`.
+  ALWAYS_INLINE size_t AllocFromThreadLocalRun(Thread* self,
+                                               size_t size,
+                                               size_t count,
+                                               /*out*/ void** slots,
+                                               /*out*/ size_t* bracket_size);
   // Free object in thread local run.
   // Used for parallel copy in GSS.
   bool FreeFromThreadLocalRun(Thread* self, size_t size, void* addr);
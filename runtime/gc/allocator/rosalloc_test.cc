@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rosalloc-inl.h"
+
+#include <vector>
+
+#include "gc/space/rosalloc_space.h"
+#include "gc/space/space_test.h"
+#include "thread_list.h"
+#include "thread_pool.h"
+
+namespace art {
+namespace gc {
+namespace allocator {
+
+class RosAllocTest : public space::SpaceTest<CommonRuntimeTest> {
+ public:
+  static constexpr size_t kInitialSize = 4 * MB;
+
+  // Creates a RosAlloc space that the heap knows of, so that it can grow and trim.
+  space::RosAllocSpace* CreateRosAllocSpace() {
+    space::RosAllocSpace* space = space::RosAllocSpace::Create("rosalloc space",
+                                                               kInitialSize,
+                                                               8 * MB,
+                                                               16 * MB,
+                                                               nullptr,
+                                                               /* low_memory_mode */ false,
+                                                               /* can_move_objects */ false);
+    CHECK(space != nullptr);
+    AddSpace(space);
+    return space;
+  }
+
+  // Returns the number of pages of the initial footprint that hold runs or large objects.
+  static size_t CountUsedPages(RosAlloc* rosalloc) {
+    size_t num_used_pages = 0;
+    for (size_t i = 0; i < kInitialSize / kPageSize; ++i) {
+      if (!rosalloc->IsFreePage(i)) {
+        ++num_used_pages;
+      }
+    }
+    return num_used_pages;
+  }
+};
+
+// Allocates and frees slots of the thread local size brackets from a thread pool worker,
+// revoking the thread local runs after each round as the collections do.
+class RosAllocTask : public Task {
+ public:
+  static constexpr size_t kNumRounds = 64;
+  static constexpr size_t kNumSlots = 256;
+
+  RosAllocTask(uint8_t id, RosAlloc* rosalloc) : id_(id), rosalloc_(rosalloc) {}
+
+  void Run(Thread* self) OVERRIDE {
+    std::vector<uint8_t*> slots(kNumSlots);
+    for (size_t round = 0; round < kNumRounds; ++round) {
+      for (size_t i = 0; i < kNumSlots; ++i) {
+        size_t bytes_allocated;
+        size_t usable_size;
+        size_t bytes_tl_bulk_allocated;
+        slots[i] = reinterpret_cast<uint8_t*>(rosalloc_->Alloc(self,
+                                                               SlotSize(i),
+                                                               &bytes_allocated,
+                                                               &usable_size,
+                                                               &bytes_tl_bulk_allocated));
+        CHECK(slots[i] != nullptr);
+        memset(slots[i], id_, SlotSize(i));
+      }
+      for (size_t i = 0; i < kNumSlots; ++i) {
+        for (size_t j = 0; j < SlotSize(i); ++j) {
+          CHECK_EQ(id_, slots[i][j]) << "round " << round << " slot " << i;
+        }
+      }
+      // The runs the thread gave up on become all free here, its thread local runs once revoked.
+      for (size_t i = 0; i < kNumSlots; ++i) {
+        rosalloc_->Free(self, slots[i]);
+      }
+      rosalloc_->RevokeThreadLocalRuns(self);
+    }
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  // The slot sizes cycle through the thread local size brackets.
+  static size_t SlotSize(size_t i) {
+    return (i % (RosAlloc::kMaxThreadLocalBracketSize / 16) + 1) * 16;
+  }
+
+  const uint8_t id_;
+  RosAlloc* const rosalloc_;
+};
+
+// A run that becomes all free is kept for the next refill of a thread local run of its bracket,
+// rather than going back to the free pages.
+TEST_F(RosAllocTest, AllFreeRunRefillsThreadLocalRun) {
+  space::RosAllocSpace* space = CreateRosAllocSpace();
+  RosAlloc* rosalloc = space->GetRosAlloc();
+  Thread* self = Thread::Current();
+  size_t bytes_allocated;
+  size_t usable_size;
+  size_t bytes_tl_bulk_allocated;
+  void* slot = rosalloc->Alloc(self, 16, &bytes_allocated, &usable_size, &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(slot != nullptr);
+  const size_t num_used_pages = CountUsedPages(rosalloc);
+  EXPECT_NE(0u, num_used_pages);
+  rosalloc->RevokeThreadLocalRuns(self);
+  rosalloc->Free(self, slot);
+  EXPECT_EQ(num_used_pages, CountUsedPages(rosalloc));
+
+  slot = rosalloc->Alloc(self, 16, &bytes_allocated, &usable_size, &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(slot != nullptr);
+  EXPECT_EQ(num_used_pages, CountUsedPages(rosalloc));
+  rosalloc->Free(self, slot);
+  rosalloc->RevokeThreadLocalRuns(self);
+}
+
+TEST_F(RosAllocTest, ConcurrentThreadLocalRunRefills) {
+  static constexpr size_t kNumThreads = 4;
+  space::RosAllocSpace* space = CreateRosAllocSpace();
+  RosAlloc* rosalloc = space->GetRosAlloc();
+  Thread* self = Thread::Current();
+  {
+    ThreadPool thread_pool("RosAlloc test thread pool", kNumThreads);
+    for (size_t i = 0; i < kNumThreads; ++i) {
+      thread_pool.AddTask(self, new RosAllocTask(static_cast<uint8_t>(i + 1u), rosalloc));
+    }
+    thread_pool.StartWorkers(self);
+    thread_pool.Wait(self, /* do_work */ true, /* may_hold_locks */ false);
+  }
+  {
+    // All the runs left are all free, on the free run stacks.
+    ScopedSuspendAll ssa(__FUNCTION__);
+    rosalloc->Verify();
+  }
+  // Trimming gives the free run stacks back to the free pages.
+  space->Trim();
+  EXPECT_EQ(0u, CountUsedPages(rosalloc));
+}
+
+}  // namespace allocator
+}  // namespace gc
+}  // namespace art
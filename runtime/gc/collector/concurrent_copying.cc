@@ -16,6 +16,8 @@
 
 #include "concurrent_copying.h"
 
+#include <sched.h>
+
 #include "art_field-inl.h"
 #include "base/enums.h"
 #include "base/file_utils.h"
@@ -42,8 +44,13 @@
 #include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 
+#ifdef VTUNE_ART
+#include "vtune_tasks.h"
+#endif
+
 namespace art {
 namespace gc {
 namespace collector {
@@ -63,6 +70,7 @@ static constexpr size_t kReadBarrierMarkStackSize = 512 * KB;
 static constexpr bool kVerifyNoMissingCardMarks = kIsDebugBuild;
 
 ConcurrentCopying::ConcurrentCopying(Heap* heap,
+                                     bool young_gen,
                                      const std::string& name_prefix,
                                      bool measure_read_barrier_slow_path)
     : GarbageCollector(heap,
@@ -77,6 +85,8 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
                                                          kReadBarrierMarkStackSize)),
       rb_mark_bit_stack_full_(false),
       mark_stack_lock_("concurrent copying mark stack lock", kMarkSweepMarkStackLock),
+      parallel_marking_busy_threads_(0),
+      is_parallel_marking_(false),
       thread_running_gc_(nullptr),
       is_marking_(false),
       is_using_read_barrier_entrypoints_(false),
@@ -103,7 +113,12 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
       force_evacuate_all_(false),
       gc_grays_immune_objects_(false),
       immune_gray_stack_lock_("concurrent copying immune gray stack lock",
-                              kMarkSweepMarkStackLock) {
+                              kMarkSweepMarkStackLock),
+      use_generational_cc_(heap->GetUseGenerationalCC()),
+      young_gen_(young_gen) {
+  // The generational mode relies on the Baker read barrier to gray old objects.
+  DCHECK(!use_generational_cc_ || kUseBakerReadBarrier);
+  DCHECK(!young_gen || use_generational_cc_);
   static_assert(space::RegionSpace::kRegionSize == accounting::ReadBarrierTable::kRegionSize,
                 "The region space size and the read barrier table region size must match");
   Thread* self = Thread::Current();
@@ -174,6 +189,12 @@ void ConcurrentCopying::RunPhases() {
     // the pause.
     ReaderMutexLock mu(self, *Locks::mutator_lock_);
     GrayAllDirtyImmuneObjects();
+    if (use_generational_cc_) {
+      AgeCards();
+      if (young_gen_) {
+        GrayAllDirtyOldObjects();
+      }
+    }
   }
   FlipThreadRoots();
   {
@@ -267,10 +288,23 @@ void ConcurrentCopying::BindBitmaps() {
       CHECK(space->IsZygoteSpace() || space->IsImageSpace());
       immune_spaces_.AddSpace(space);
     } else if (space == region_space_) {
-      // It is OK to clear the bitmap with mutators running since the only place it is read is
-      // VisitObjects which has exclusion with CC.
       region_space_bitmap_ = region_space_->GetMarkBitmap();
-      region_space_bitmap_->Clear();
+      // A young collection keeps the marks of the old objects, which it does not trace.
+      if (!young_gen_) {
+        // It is OK to clear the bitmap with mutators running since the only place it is read is
+        // VisitObjects which has exclusion with CC.
+        region_space_bitmap_->Clear();
+      }
+    } else if (young_gen_ && space->IsContinuousMemMapAllocSpace()) {
+      // As in the sticky mark sweep collector, binding the bitmaps considers the old objects of
+      // the non-moving space marked.
+      space->AsContinuousMemMapAllocSpace()->BindLiveToMarkBitmap();
+    }
+  }
+  if (young_gen_) {
+    for (const auto& space : heap_->GetDiscontinuousSpaces()) {
+      CHECK(space->IsLargeObjectSpace());
+      space->AsLargeObjectSpace()->CopyLiveToMarked();
     }
   }
 }
@@ -421,7 +455,17 @@ class ConcurrentCopying::FlipCallback : public Closure {
     Locks::mutator_lock_->AssertExclusiveHeld(self);
     {
       TimingLogger::ScopedTiming split2("(Paused)SetFromSpace", cc->GetTimings());
-      cc->region_space_->SetFromSpace(cc->rb_table_, cc->force_evacuate_all_);
+      space::RegionSpace::EvacMode evac_mode =
+          space::RegionSpace::EvacMode::kEvacModeLivePercentNewlyAllocated;
+      if (cc->young_gen_) {
+        evac_mode = space::RegionSpace::EvacMode::kEvacModeNewlyAllocated;
+      } else if (cc->force_evacuate_all_) {
+        evac_mode = space::RegionSpace::EvacMode::kEvacModeForceAll;
+      }
+      // A young collection does not recompute the live bytes of the regions it keeps.
+      cc->region_space_->SetFromSpace(cc->rb_table_,
+                                      evac_mode,
+                                      /* clear_live_bytes */ !cc->young_gen_);
     }
     cc->SwapStacks();
     if (ConcurrentCopying::kEnableFromSpaceAccountingCheck) {
@@ -446,6 +490,9 @@ class ConcurrentCopying::FlipCallback : public Closure {
         cc->VerifyGrayImmuneObjects();
       }
     }
+    if (cc->young_gen_) {
+      cc->GrayAllNewlyDirtyOldObjects();
+    }
     // May be null during runtime creation, in this case leave java_lang_Object null.
     // This is safe since single threaded behavior should mean FillDummyObject does not
     // happen when java_lang_Object_ is null.
@@ -731,6 +778,138 @@ void ConcurrentCopying::GrayAllNewlyDirtyImmuneObjects() {
   updated_all_immune_objects_.StoreRelaxed(true);
 }
 
+void ConcurrentCopying::AgeCards() {
+  TimingLogger::ScopedTiming split("AgeCards", GetTimings());
+  accounting::CardTable* const card_table = heap_->GetCardTable();
+  auto age_card = [](uint8_t card) {
+    return (card != gc::accounting::CardTable::kCardClean)
+        ? gc::accounting::CardTable::kCardAged
+        : card;
+  };
+  space::ContinuousSpace* const non_moving_space = heap_->GetNonMovingSpace();
+  card_table->ModifyCardsAtomic(
+      region_space_->Begin(), region_space_->Limit(), age_card, VoidFunctor());
+  card_table->ModifyCardsAtomic(
+      non_moving_space->Begin(), non_moving_space->Limit(), age_card, VoidFunctor());
+}
+
+void ConcurrentCopying::ClearAgedCards() {
+  TimingLogger::ScopedTiming split("ClearAgedCards", GetTimings());
+  accounting::CardTable* const card_table = heap_->GetCardTable();
+  // The references stored since the cards were aged, which may point to objects allocated
+  // after the flip, keep their cards dirty until the next collection.
+  auto clear_aged_card = [](uint8_t card) {
+    return (card == gc::accounting::CardTable::kCardAged)
+        ? gc::accounting::CardTable::kCardClean
+        : card;
+  };
+  space::ContinuousSpace* const non_moving_space = heap_->GetNonMovingSpace();
+  card_table->ModifyCardsAtomic(
+      region_space_->Begin(), region_space_->Limit(), clear_aged_card, VoidFunctor());
+  card_table->ModifyCardsAtomic(
+      non_moving_space->Begin(), non_moving_space->Limit(), clear_aged_card, VoidFunctor());
+}
+
+template <bool kConcurrent>
+class ConcurrentCopying::GrayOldObjectVisitor {
+ public:
+  explicit GrayOldObjectVisitor(ConcurrentCopying* collector) : collector_(collector) {}
+
+  ALWAYS_INLINE void operator()(mirror::Object* obj) const REQUIRES_SHARED(Locks::mutator_lock_) {
+    // Only the GC grays the old objects, so a gray object was already recorded.
+    if (obj->GetReadBarrierState() == ReadBarrier::WhiteState()) {
+      if (kConcurrent) {
+        // Mutators may concurrently change the lock word of the object.
+        if (!obj->AtomicSetReadBarrierState(ReadBarrier::WhiteState(), ReadBarrier::GrayState())) {
+          return;
+        }
+      } else {
+        obj->SetReadBarrierState(ReadBarrier::GrayState());
+      }
+      collector_->old_gray_stack_.push_back(obj);
+    }
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+};
+
+template <bool kConcurrent>
+void ConcurrentCopying::GrayOldObjectsOnCards(uint8_t minimum_age) {
+  accounting::CardTable* const card_table = heap_->GetCardTable();
+  GrayOldObjectVisitor<kConcurrent> visitor(this);
+  // The objects allocated since the previous collection are not in these bitmaps: the young
+  // regions are evacuated, and the young objects of the non-moving and large object spaces
+  // are marked from the live stack by ScanDirtyOldObjects().
+  card_table->Scan</* kClearCard */ false>(region_space_bitmap_,
+                                           region_space_->Begin(),
+                                           region_space_->Limit(),
+                                           visitor,
+                                           minimum_age);
+  space::ContinuousSpace* const non_moving_space = heap_->GetNonMovingSpace();
+  card_table->Scan</* kClearCard */ false>(non_moving_space->GetMarkBitmap(),
+                                           non_moving_space->Begin(),
+                                           non_moving_space->End(),
+                                           visitor,
+                                           minimum_age);
+}
+
+void ConcurrentCopying::GrayAllDirtyOldObjects() {
+  TimingLogger::ScopedTiming split("GrayAllDirtyOldObjects", GetTimings());
+  DCHECK(young_gen_);
+  WriterMutexLock mu(Thread::Current(), *Locks::heap_bitmap_lock_);
+  DCHECK(old_gray_stack_.empty());
+  // The cards were just aged by AgeCards().
+  GrayOldObjectsOnCards</* kConcurrent */ true>(gc::accounting::CardTable::kCardAged);
+}
+
+void ConcurrentCopying::GrayAllNewlyDirtyOldObjects() {
+  TimingLogger::ScopedTiming split("(Paused)GrayAllNewlyDirtyOldObjects", GetTimings());
+  DCHECK(young_gen_);
+  WriterMutexLock mu(Thread::Current(), *Locks::heap_bitmap_lock_);
+  // Mutators may have dirtied cards since GrayAllDirtyOldObjects(). Once the objects on these
+  // cards are gray too, a mutator can only read references to young objects from old objects
+  // through the read barrier slow path.
+  GrayOldObjectsOnCards</* kConcurrent */ false>(gc::accounting::CardTable::kCardDirty);
+}
+
+void ConcurrentCopying::ScanDirtyOldObjects() {
+  TimingLogger::ScopedTiming split("ScanDirtyOldObjects", GetTimings());
+  DCHECK(young_gen_);
+  {
+    // Keep all the objects allocated in the non-moving and large object spaces since the
+    // previous collection, which a young collection does not sweep. Their references to young
+    // objects are updated when they are scanned.
+    accounting::ObjectStack* live_stack = heap_->GetLiveStack();
+    for (StackReference<mirror::Object>* it = live_stack->Begin(); it != live_stack->End(); ++it) {
+      mirror::Object* obj = it->AsMirrorPtr();
+      if (obj != nullptr) {
+        Mark</* kGrayImmuneObject */ false, /* kFromGCThread */ true>(obj);
+      }
+    }
+  }
+  if (kVerboseMode) {
+    LOG(INFO) << "old gray stack size=" << old_gray_stack_.size();
+  }
+  for (mirror::Object* obj : old_gray_stack_) {
+    DCHECK(obj->GetReadBarrierState() == ReadBarrier::GrayState());
+    Scan(obj);
+    // As in ProcessMarkStackRef(), leave a reference with an unmarked referent gray so that
+    // GetReferent() triggers a read barrier. It is whitened when dequeued.
+    mirror::Object* referent = nullptr;
+    if (obj->GetClass<kVerifyNone, kWithoutReadBarrier>()->IsTypeOfReferenceClass() &&
+        (referent = obj->AsReference()->GetReferent<kWithoutReadBarrier>()) != nullptr &&
+        !IsInToSpace(referent)) {
+      continue;
+    }
+    bool success = obj->AtomicSetReadBarrierState</* kCasRelease */ true>(
+        ReadBarrier::GrayState(),
+        ReadBarrier::WhiteState());
+    DCHECK(success);
+  }
+  old_gray_stack_.clear();
+}
+
 void ConcurrentCopying::SwapStacks() {
   heap_->SwapStacks();
 }
@@ -780,6 +959,9 @@ class ConcurrentCopying::ImmuneSpaceScanObjVisitor {
 // Concurrently mark roots that are guarded by read barriers and process the mark stack.
 void ConcurrentCopying::MarkingPhase() {
   TimingLogger::ScopedTiming split("MarkingPhase", GetTimings());
+#ifdef VTUNE_ART
+  ScopedVTuneTask vtune_task(VTuneTask::kGcMarkingPhase);
+#endif
   if (kVerboseMode) {
     LOG(INFO) << "GC MarkingPhase";
   }
@@ -836,6 +1018,9 @@ void ConcurrentCopying::MarkingPhase() {
     }
     immune_gray_stack_.clear();
   }
+  if (young_gen_) {
+    ScanDirtyOldObjects();
+  }
 
   {
     TimingLogger::ScopedTiming split2("VisitConcurrentRoots", GetTimings());
@@ -1088,19 +1273,7 @@ void ConcurrentCopying::PushOntoMarkStack(mirror::Object* to_ref) {
       if (UNLIKELY(tl_mark_stack == nullptr || tl_mark_stack->IsFull())) {
         MutexLock mu(self, mark_stack_lock_);
         // Get a new thread local mark stack.
-        accounting::AtomicStack<mirror::Object>* new_tl_mark_stack;
-        if (!pooled_mark_stacks_.empty()) {
-          // Use a pooled mark stack.
-          new_tl_mark_stack = pooled_mark_stacks_.back();
-          pooled_mark_stacks_.pop_back();
-        } else {
-          // None pooled. Create a new one.
-          new_tl_mark_stack =
-              accounting::AtomicStack<mirror::Object>::Create(
-                  "thread local mark stack", 4 * KB, 4 * KB);
-        }
-        DCHECK(new_tl_mark_stack != nullptr);
-        DCHECK(new_tl_mark_stack->IsEmpty());
+        accounting::AtomicStack<mirror::Object>* new_tl_mark_stack = AllocateMarkStack();
         new_tl_mark_stack->PushBack(to_ref);
         self->SetThreadLocalMarkStack(new_tl_mark_stack);
         if (tl_mark_stack != nullptr) {
@@ -1414,15 +1587,21 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
   size_t count = 0;
   MarkStackMode mark_stack_mode = mark_stack_mode_.LoadRelaxed();
   if (mark_stack_mode == kMarkStackModeThreadLocal) {
-    // Process the thread-local mark stacks and the GC mark stack.
-    count += ProcessThreadLocalMarkStacks(/* disable_weak_ref_access */ false,
-                                          /* checkpoint_callback */ nullptr);
-    while (!gc_mark_stack_->IsEmpty()) {
-      mirror::Object* to_ref = gc_mark_stack_->PopBack();
-      ProcessMarkStackRef(to_ref);
-      ++count;
+    size_t thread_count = GetParallelMarkingThreadCount();
+    if (thread_count > 1) {
+      // Process the thread-local mark stacks and the GC mark stack in parallel.
+      count += ProcessMarkStacksParallel(thread_count);
+    } else {
+      // Process the thread-local mark stacks and the GC mark stack.
+      count += ProcessThreadLocalMarkStacks(/* disable_weak_ref_access */ false,
+                                            /* checkpoint_callback */ nullptr);
+      while (!gc_mark_stack_->IsEmpty()) {
+        mirror::Object* to_ref = gc_mark_stack_->PopBack();
+        ProcessMarkStackRef(to_ref);
+        ++count;
+      }
+      gc_mark_stack_->Reset();
     }
-    gc_mark_stack_->Reset();
   } else if (mark_stack_mode == kMarkStackModeShared) {
     // Do an empty checkpoint to avoid a race with a mutator preempted in the middle of a read
     // barrier but before pushing onto the mark stack. b/32508093. Note the weak ref access is
@@ -1492,19 +1671,204 @@ size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_acc
     }
     {
       MutexLock mu(Thread::Current(), mark_stack_lock_);
-      if (pooled_mark_stacks_.size() >= kMarkStackPoolSize) {
-        // The pool has enough. Delete it.
-        delete mark_stack;
-      } else {
-        // Otherwise, put it into the pool for later reuse.
-        mark_stack->Reset();
-        pooled_mark_stacks_.push_back(mark_stack);
+      RecycleMarkStack(mark_stack);
+    }
+  }
+  return count;
+}
+
+accounting::ObjectStack* ConcurrentCopying::AllocateMarkStack() {
+  accounting::ObjectStack* mark_stack;
+  if (!pooled_mark_stacks_.empty()) {
+    // Use a pooled mark stack.
+    mark_stack = pooled_mark_stacks_.back();
+    pooled_mark_stacks_.pop_back();
+  } else {
+    // None pooled. Create a new one.
+    mark_stack = accounting::ObjectStack::Create("thread local mark stack", 4 * KB, 4 * KB);
+  }
+  DCHECK(mark_stack != nullptr);
+  DCHECK(mark_stack->IsEmpty());
+  return mark_stack;
+}
+
+void ConcurrentCopying::RecycleMarkStack(accounting::ObjectStack* mark_stack) {
+  if (pooled_mark_stacks_.size() >= kMarkStackPoolSize) {
+    // The pool has enough. Delete it.
+    delete mark_stack;
+  } else {
+    // Otherwise, put it into the pool for later reuse.
+    mark_stack->Reset();
+    pooled_mark_stacks_.push_back(mark_stack);
+  }
+}
+
+size_t ConcurrentCopying::GetParallelMarkingThreadCount() const {
+  // Like MarkSweep::GetThreadCount(), use a single thread in a background state (non jank
+  // perceptible) to leave more CPU time for the foreground apps.
+  if (heap_->GetThreadPool() == nullptr || !Runtime::Current()->InJankPerceptibleProcessState()) {
+    return 1;
+  }
+  return heap_->GetConcGCThreadCount() + 1;
+}
+
+bool ConcurrentCopying::IsMarkingThread(Thread* self) const {
+  if (self == thread_running_gc_) {
+    return true;
+  }
+  if (is_parallel_marking_.LoadRelaxed()) {
+    for (ThreadPoolWorker* worker : heap_->GetThreadPool()->GetWorkers()) {
+      if (worker->GetThread() == self) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+class ConcurrentCopying::ParallelMarkTask : public SelfDeletingTask {
+ public:
+  ParallelMarkTask(ConcurrentCopying* collector, Atomic<size_t>* count)
+      : collector_(collector), count_(count) {}
+
+  // No thread safety analysis since the workers run on behalf of the GC-running thread, which
+  // holds the mutator lock until they are done.
+  void Run(Thread* self) OVERRIDE NO_THREAD_SAFETY_ANALYSIS {
+    {
+      MutexLock mu(self, collector_->mark_stack_lock_);
+      ++collector_->parallel_marking_busy_threads_;
+    }
+    count_->FetchAndAddSequentiallyConsistent(collector_->ParallelMarkWorker(self));
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+  Atomic<size_t>* const count_;
+};
+
+size_t ConcurrentCopying::ProcessMarkStacksParallel(size_t thread_count) {
+  Thread* self = Thread::Current();
+  DCHECK_GT(thread_count, 1u);
+  DCHECK_EQ(static_cast<uint32_t>(mark_stack_mode_.LoadRelaxed()),
+            static_cast<uint32_t>(kMarkStackModeThreadLocal));
+  // Collect the thread-local mark stacks. No other thread revokes mark stacks until the workers
+  // are done, so that they own their thread-local mark stack in the meantime.
+  RevokeThreadLocalMarkStacks(/* disable_weak_ref_access */ false,
+                              /* checkpoint_callback */ nullptr);
+  {
+    // The GC-running thread is busy with the GC mark stack from the start.
+    MutexLock mu(self, mark_stack_lock_);
+    parallel_marking_busy_threads_ = 1;
+  }
+  is_parallel_marking_.StoreSequentiallyConsistent(true);
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  Atomic<size_t> count(0);
+  for (size_t i = 0; i < thread_count - 1; ++i) {
+    thread_pool->AddTask(self, new ParallelMarkTask(this, &count));
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  count.FetchAndAddSequentiallyConsistent(ParallelMarkWorker(self));
+  // The workers starting late find nothing left to do.
+  thread_pool->Wait(self, /* do_work */ false, /* may_hold_locks */ true);
+  thread_pool->StopWorkers(self);
+  is_parallel_marking_.StoreSequentiallyConsistent(false);
+  return count.LoadSequentiallyConsistent();
+}
+
+size_t ConcurrentCopying::ParallelMarkWorker(Thread* self) {
+  size_t count = DrainOwnMarkStack(self);
+  {
+    MutexLock mu(self, mark_stack_lock_);
+    --parallel_marking_busy_threads_;
+  }
+  while (true) {
+    bool done = false;
+    accounting::ObjectStack* mark_stack = StealMarkStack(self, &done);
+    if (mark_stack == nullptr) {
+      if (done) {
+        break;
+      }
+      // Another thread may still publish a mark stack.
+      sched_yield();
+      continue;
+    }
+    for (StackReference<mirror::Object>* p = mark_stack->Begin(); p != mark_stack->End(); ++p) {
+      ProcessMarkStackRef</*kParallel*/ true>(p->AsMirrorPtr());
+      ++count;
+    }
+    count += DrainOwnMarkStack(self);
+    MutexLock mu(self, mark_stack_lock_);
+    RecycleMarkStack(mark_stack);
+    --parallel_marking_busy_threads_;
+  }
+  if (self != thread_running_gc_) {
+    // Give back the (empty) thread-local mark stack of the worker.
+    accounting::ObjectStack* tl_mark_stack = self->GetThreadLocalMarkStack();
+    if (tl_mark_stack != nullptr) {
+      MutexLock mu(self, mark_stack_lock_);
+      RecycleMarkStack(tl_mark_stack);
+      self->SetThreadLocalMarkStack(nullptr);
+    }
+  }
+  return count;
+}
+
+size_t ConcurrentCopying::DrainOwnMarkStack(Thread* self) {
+  size_t count = 0;
+  if (self == thread_running_gc_) {
+    // The GC-running thread pushes onto the GC mark stack, which initially holds the bulk of the
+    // work. Share it with the other threads.
+    while (!gc_mark_stack_->IsEmpty()) {
+      if (gc_mark_stack_->Size() >= 2 * kParallelMarkStackSegmentSize) {
+        PublishGcMarkStackSegment(self);
       }
+      ProcessMarkStackRef</*kParallel*/ true>(gc_mark_stack_->PopBack());
+      ++count;
+    }
+    gc_mark_stack_->Reset();
+  } else {
+    // A worker pushes onto its thread-local mark stack. PushOntoMarkStack() publishes it to the
+    // revoked mark stacks whenever it gets full.
+    for (accounting::ObjectStack* tl_mark_stack = self->GetThreadLocalMarkStack();
+         tl_mark_stack != nullptr && !tl_mark_stack->IsEmpty();
+         tl_mark_stack = self->GetThreadLocalMarkStack()) {
+      ProcessMarkStackRef</*kParallel*/ true>(tl_mark_stack->PopBack());
+      ++count;
     }
   }
   return count;
 }
 
+void ConcurrentCopying::PublishGcMarkStackSegment(Thread* self) {
+  accounting::ObjectStack* segment;
+  {
+    MutexLock mu(self, mark_stack_lock_);
+    segment = AllocateMarkStack();
+  }
+  StackReference<mirror::Object>* end = gc_mark_stack_->End();
+  for (StackReference<mirror::Object>* p = end - kParallelMarkStackSegmentSize; p != end; ++p) {
+    segment->PushBack(p->AsMirrorPtr());
+  }
+  gc_mark_stack_->PopBackCount(kParallelMarkStackSegmentSize);
+  MutexLock mu(self, mark_stack_lock_);
+  revoked_mark_stacks_.push_back(segment);
+}
+
+accounting::ObjectStack* ConcurrentCopying::StealMarkStack(Thread* self, bool* done) {
+  MutexLock mu(self, mark_stack_lock_);
+  if (revoked_mark_stacks_.empty()) {
+    // The busy threads may still publish a mark stack.
+    *done = parallel_marking_busy_threads_ == 0;
+    return nullptr;
+  }
+  accounting::ObjectStack* mark_stack = revoked_mark_stacks_.back();
+  revoked_mark_stacks_.pop_back();
+  ++parallel_marking_busy_threads_;
+  return mark_stack;
+}
+
+template <bool kParallel>
 inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   DCHECK(!region_space_->IsInFromSpace(to_ref));
   if (kUseBakerReadBarrier) {
@@ -1514,13 +1878,17 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   }
   bool add_to_live_bytes = false;
   if (region_space_->IsInUnevacFromSpace(to_ref)) {
-    // Mark the bitmap only in the GC thread here so that we don't need a CAS.
-    if (!kUseBakerReadBarrier || !region_space_bitmap_->Set(to_ref)) {
+    // Mark the bitmap only in the GC thread here so that we don't need a CAS, unless other
+    // threads mark in parallel.
+    if (!kUseBakerReadBarrier ||
+        !(kParallel ? region_space_bitmap_->AtomicTestAndSet(to_ref)
+                    : region_space_bitmap_->Set(to_ref))) {
       // It may be already marked if we accidentally pushed the same object twice due to the racy
       // bitmap read in MarkUnevacFromSpaceRegion.
       Scan(to_ref);
-      // Only add to the live bytes if the object was not already marked.
-      add_to_live_bytes = true;
+      // Only add to the live bytes if the object was not already marked. A young collection
+      // does not count the live bytes of the old regions.
+      add_to_live_bytes = !young_gen_;
     }
   } else {
     Scan(to_ref);
@@ -1556,12 +1924,16 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
 #endif
 
   if (add_to_live_bytes) {
-    // Add to the live bytes per unevacuated from-space. Note this code is always run by the
-    // GC-running thread (no synchronization required).
+    // Add to the live bytes per unevacuated from-space. Note this code is run by the GC-running
+    // thread (no synchronization required), unless other threads mark in parallel.
     DCHECK(region_space_bitmap_->Test(to_ref));
     size_t obj_size = to_ref->SizeOf<kDefaultVerifyFlags>();
     size_t alloc_size = RoundUp(obj_size, space::RegionSpace::kAlignment);
-    region_space_->AddLiveBytes(to_ref, alloc_size);
+    if (kParallel) {
+      region_space_->AtomicAddLiveBytes(to_ref, alloc_size);
+    } else {
+      region_space_->AddLiveBytes(to_ref, alloc_size);
+    }
   }
   if (ReadBarrier::kEnableToSpaceInvariantChecks) {
     CHECK(to_ref != nullptr);
@@ -1676,6 +2048,11 @@ void ConcurrentCopying::Sweep(bool swap_bitmaps) {
     live_stack->Reset();
   }
   CheckEmptyMarkStack();
+  if (young_gen_) {
+    // A young collection marks all the objects allocated since the previous collection in the
+    // non-moving and large object spaces, and considers the older ones marked: nothing to sweep.
+    return;
+  }
   TimingLogger::ScopedTiming split("Sweep", GetTimings());
   for (const auto& space : GetHeap()->GetContinuousSpaces()) {
     if (space->IsContinuousMemMapAllocSpace()) {
@@ -1723,6 +2100,9 @@ void ConcurrentCopying::SweepLargeObjects(bool swap_bitmaps) {
 
 void ConcurrentCopying::ReclaimPhase() {
   TimingLogger::ScopedTiming split("ReclaimPhase", GetTimings());
+#ifdef VTUNE_ART
+  ScopedVTuneTask vtune_task(VTuneTask::kGcReclaimPhase);
+#endif
   if (kVerboseMode) {
     LOG(INFO) << "GC ReclaimPhase";
   }
@@ -1768,7 +2148,11 @@ void ConcurrentCopying::ReclaimPhase() {
     uint64_t cleared_objects;
     {
       TimingLogger::ScopedTiming split4("ClearFromSpace", GetTimings());
-      region_space_->ClearFromSpace(&cleared_bytes, &cleared_objects);
+      // The generational mode keeps the marks of the old objects for the young collections.
+      region_space_->ClearFromSpace(
+          &cleared_bytes,
+          &cleared_objects,
+          /* clear_bitmap */ !use_generational_cc_);
       // `cleared_bytes` and `cleared_objects` may be greater than the from space equivalents since
       // RegionSpace::ClearFromSpace may clear empty unevac regions.
       CHECK_GE(cleared_bytes, from_bytes);
@@ -1802,7 +2186,7 @@ void ConcurrentCopying::ReclaimPhase() {
     SwapBitmaps();
     heap_->UnBindBitmaps();
 
-    // The bitmap was cleared at the start of the GC, there is nothing we need to do here.
+    // The bitmap was cleared at the start of the (full) GC, there is nothing we need to do here.
     DCHECK(region_space_bitmap_ != nullptr);
     region_space_bitmap_ = nullptr;
   }
@@ -2039,7 +2423,7 @@ void ConcurrentCopying::AssertToSpaceInvariantInNonMovingSpace(mirror::Object* o
   if (immune_spaces_.ContainsObject(ref)) {
     if (kUseBakerReadBarrier) {
       // Immune object may not be gray if called from the GC.
-      if (Thread::Current() == thread_running_gc_ && !gc_grays_immune_objects_) {
+      if (IsMarkingThread(Thread::Current()) && !gc_grays_immune_objects_) {
         return;
       }
       bool updated_all_immune_objects = updated_all_immune_objects_.LoadSequentiallyConsistent();
@@ -2114,7 +2498,7 @@ inline void ConcurrentCopying::Scan(mirror::Object* to_ref) {
     Thread::Current()->ModifyDebugDisallowReadBarrier(1);
   }
   DCHECK(!region_space_->IsInFromSpace(to_ref));
-  DCHECK_EQ(Thread::Current(), thread_running_gc_);
+  DCHECK(IsMarkingThread(Thread::Current()));
   RefFieldsVisitor visitor(this);
   // Disable the read barrier for a performance reason.
   to_ref->VisitReferences</*kVisitNativeRoots*/true, kDefaultVerifyFlags, kWithoutReadBarrier>(
@@ -2125,7 +2509,7 @@ inline void ConcurrentCopying::Scan(mirror::Object* to_ref) {
 }
 
 inline void ConcurrentCopying::Process(mirror::Object* obj, MemberOffset offset) {
-  DCHECK_EQ(Thread::Current(), thread_running_gc_);
+  DCHECK(IsMarkingThread(Thread::Current()));
   mirror::Object* ref = obj->GetFieldObject<
       mirror::Object, kVerifyNone, kWithoutReadBarrier, false>(offset);
   mirror::Object* to_ref = Mark</*kGrayImmuneObject*/false, /*kFromGCThread*/true>(
@@ -2482,6 +2866,11 @@ mirror::Object* ConcurrentCopying::Copy(mirror::Object* from_ref,
       bytes_moved_.FetchAndAddRelaxed(region_space_alloc_size);
       if (LIKELY(!fall_back_to_non_moving)) {
         DCHECK(region_space_->IsInToSpace(to_ref));
+        if (use_generational_cc_) {
+          // The copy is old for the next young collection, which considers it marked. The
+          // bitmap words of a region are only shared with objects of the same region.
+          region_space_bitmap_->AtomicTestAndSet(to_ref);
+        }
       } else {
         DCHECK(heap_->non_moving_space_->HasAddress(to_ref));
         DCHECK_EQ(bytes_allocated, non_moving_space_bytes_allocated);
@@ -2659,9 +3048,12 @@ void ConcurrentCopying::FinishPhase() {
     MutexLock mu(self, mark_stack_lock_);
     CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
   }
-  // kVerifyNoMissingCardMarks relies on the region space cards not being cleared to avoid false
-  // positives.
-  if (!kVerifyNoMissingCardMarks) {
+  if (use_generational_cc_) {
+    ReaderMutexLock mu(self, *Locks::mutator_lock_);
+    ClearAgedCards();
+  } else if (!kVerifyNoMissingCardMarks) {
+    // kVerifyNoMissingCardMarks relies on the region space cards not being cleared to avoid false
+    // positives.
     TimingLogger::ScopedTiming split("ClearRegionSpaceCards", GetTimings());
     // We do not currently use the region space cards at all, madvise them away to save ram.
     heap_->GetCardTable()->ClearCardRange(region_space_->Begin(), region_space_->Limit());
@@ -65,9 +65,14 @@ class ConcurrentCopying : public GarbageCollector {
   // pages.
   static constexpr bool kGrayDirtyImmuneObjects = true;
 
-  explicit ConcurrentCopying(Heap* heap,
-                             const std::string& name_prefix = "",
-                             bool measure_read_barrier_slow_path = false);
+  // A young collection (`young_gen`) only evacuates the regions allocated since the previous
+  // collection. The older objects, in the other regions and in the non-moving and large object
+  // spaces, are considered live, and only those on dirty or aged cards are scanned to find the
+  // references to the young objects (see Heap::GetUseGenerationalCC()).
+  ConcurrentCopying(Heap* heap,
+                    bool young_gen,
+                    const std::string& name_prefix = "",
+                    bool measure_read_barrier_slow_path = false);
   ~ConcurrentCopying();
 
   virtual void RunPhases() OVERRIDE
@@ -87,7 +92,7 @@ class ConcurrentCopying : public GarbageCollector {
   void BindBitmaps() REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::heap_bitmap_lock_);
   virtual GcType GetGcType() const OVERRIDE {
-    return kGcTypePartial;
+    return young_gen_ ? kGcTypeSticky : kGcTypePartial;
   }
   virtual CollectorType GetCollectorType() const OVERRIDE {
     return kCollectorTypeCC;
@@ -175,14 +180,63 @@ class ConcurrentCopying : public GarbageCollector {
   virtual void ProcessMarkStack() OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
   bool ProcessMarkStackOnce() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
+  // `kParallel` is true when running on one of the threads of ProcessMarkStacksParallel(), which
+  // need to update the region space bitmap and live bytes atomically.
+  template <bool kParallel = false>
   void ProcessMarkStackRef(mirror::Object* to_ref) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
+  // Parallel marking: the number of threads draining the mark stacks in the thread-local mark
+  // stack mode, the GC-running thread included. More than one with -XX:ConcGCThreads.
+  size_t GetParallelMarkingThreadCount() const;
+  // Drain the thread-local mark stacks and the GC mark stack with the GC-running thread and
+  // `thread_count - 1` workers of the heap thread pool. The threads push onto their own mark
+  // stack (the GC mark stack or a thread-local one), publish segments of it to the revoked mark
+  // stacks when it is large, and steal from the revoked mark stacks when it is empty. Returns the
+  // number of refs processed.
+  size_t ProcessMarkStacksParallel(size_t thread_count) REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  // Run by each thread of ProcessMarkStacksParallel(). Returns the number of refs processed.
+  size_t ParallelMarkWorker(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  size_t DrainOwnMarkStack(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  // Move the top segment of the GC mark stack to the revoked mark stacks for the other threads.
+  void PublishGcMarkStackSegment(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  // Remove a revoked mark stack for the calling thread to process, or return null if there is
+  // none. `done` is set when there is none and no thread may publish one anymore.
+  accounting::ObjectStack* StealMarkStack(Thread* self, bool* done)
+      REQUIRES(!mark_stack_lock_);
+  accounting::ObjectStack* AllocateMarkStack() REQUIRES(mark_stack_lock_);
+  void RecycleMarkStack(accounting::ObjectStack* mark_stack) REQUIRES(mark_stack_lock_);
+  // Returns whether `self` marks on behalf of the GC: the GC-running thread, or a heap thread
+  // pool worker during ProcessMarkStacksParallel().
+  bool IsMarkingThread(Thread* self) const;
   void GrayAllDirtyImmuneObjects()
       REQUIRES(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
   void GrayAllNewlyDirtyImmuneObjects()
       REQUIRES(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
+  // Generational mode: age the cards of the region and non-moving spaces before the flip; the
+  // cards still aged at the end of the collection are cleared by ClearAgedCards().
+  void AgeCards() REQUIRES_SHARED(Locks::mutator_lock_);
+  void ClearAgedCards() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Young collections: gray the old objects on aged cards (concurrently) and on dirty cards (in
+  // the pause), as these may reference young objects, then scan them after the flip.
+  template <bool kConcurrent>
+  void GrayOldObjectsOnCards(uint8_t minimum_age)
+      REQUIRES(Locks::mutator_lock_, Locks::heap_bitmap_lock_)
+      REQUIRES(!mark_stack_lock_);
+  void GrayAllDirtyOldObjects()
+      REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  void GrayAllNewlyDirtyOldObjects()
+      REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  void ScanDirtyOldObjects()
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_, !skipped_blocks_lock_, !immune_gray_stack_lock_);
   void VerifyGrayImmuneObjects()
       REQUIRES(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
@@ -303,6 +357,12 @@ class ConcurrentCopying : public GarbageCollector {
   static constexpr size_t kMarkStackPoolSize = 256;
   std::vector<accounting::ObjectStack*> pooled_mark_stacks_
       GUARDED_BY(mark_stack_lock_);
+  // The size of the segments of the GC mark stack published by PublishGcMarkStackSegment().
+  static constexpr size_t kParallelMarkStackSegmentSize = 1 * KB;
+  // The number of threads of ProcessMarkStacksParallel() that may still publish mark stacks.
+  size_t parallel_marking_busy_threads_ GUARDED_BY(mark_stack_lock_);
+  // True during ProcessMarkStacksParallel().
+  Atomic<bool> is_parallel_marking_;
   Thread* thread_running_gc_;
   bool is_marking_;                       // True while marking is ongoing.
   // True while we might dispatch on the read barrier entrypoints.
@@ -364,6 +424,15 @@ class ConcurrentCopying : public GarbageCollector {
   Mutex immune_gray_stack_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   std::vector<mirror::Object*> immune_gray_stack_ GUARDED_BY(immune_gray_stack_lock_);
 
+  // True if the heap runs young collections; the full collections then keep the marks of old
+  // objects and age the cards for them.
+  const bool use_generational_cc_;
+  // True for the young collector of the generational mode.
+  const bool young_gen_;
+  // The old objects grayed by GrayOldObjectsOnCards(), scanned and whitened by
+  // ScanDirtyOldObjects(). Only accessed by the GC thread.
+  std::vector<mirror::Object*> old_gray_stack_;
+
   // Class of java.lang.Object. Filled in from WellKnownClasses in FlipCallback. Must
   // be filled in before flipping thread roots so that FillDummyObject can run. Not
   // ObjPtr since the GC may transition to suspended and runnable between phases.
@@ -380,8 +449,10 @@ class ConcurrentCopying : public GarbageCollector {
   class DisableWeakRefAccessCallback;
   class FlipCallback;
   template <bool kConcurrent> class GrayImmuneObjectVisitor;
+  template <bool kConcurrent> class GrayOldObjectVisitor;
   class ImmuneSpaceScanObjVisitor;
   class LostCopyVisitor;
+  class ParallelMarkTask;
   class RefFieldsVisitor;
   class RevokeThreadLocalMarkStackCheckpoint;
   class ScopedGcGraysImmuneObjects;
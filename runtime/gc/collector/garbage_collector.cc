@@ -36,6 +36,10 @@
 #include "thread-current-inl.h"
 #include "thread_list.h"
 
+#ifdef VTUNE_ART
+#include "vtune_tasks.h"
+#endif
+
 namespace art {
 namespace gc {
 namespace collector {
@@ -86,6 +90,9 @@ void GarbageCollector::ResetCumulativeStatistics() {
 
 void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
   ScopedTrace trace(android::base::StringPrintf("%s %s GC", PrettyCause(gc_cause), GetName()));
+#ifdef VTUNE_ART
+  ScopedVTuneTask vtune_task(VTuneTask::kGcRun);
+#endif
   Thread* self = Thread::Current();
   uint64_t start_time = NanoTime();
   Iteration* current_iteration = GetCurrentIteration();
@@ -165,7 +172,13 @@ void GarbageCollector::ResetMeasurements() {
 }
 
 GarbageCollector::ScopedPause::ScopedPause(GarbageCollector* collector, bool with_reporting)
-    : start_time_(NanoTime()), collector_(collector), with_reporting_(with_reporting) {
+    : start_time_(NanoTime()),
+      collector_(collector),
+      with_reporting_(with_reporting)
+#ifdef VTUNE_ART
+      , vtune_task_(VTuneTask::kGcPause)
+#endif
+{
   Runtime* runtime = Runtime::Current();
   runtime->GetThreadList()->SuspendAll(__FUNCTION__);
   if (with_reporting) {
@@ -210,6 +223,16 @@ uint64_t GarbageCollector::GetTotalPausedTimeNs() {
   return pause_histogram_.AdjustedSum();
 }
 
+uint64_t GarbageCollector::GetPausePercentileNs(double per) {
+  MutexLock mu(Thread::Current(), pause_histogram_lock_);
+  if (pause_histogram_.SampleSize() == 0) {
+    return 0u;
+  }
+  Histogram<uint64_t>::CumulativeData cumulative_data;
+  pause_histogram_.CreateHistogram(&cumulative_data);
+  return static_cast<uint64_t>(pause_histogram_.AdjustedPercentile(per, cumulative_data));
+}
+
 void GarbageCollector::DumpPerformanceInfo(std::ostream& os) {
   const CumulativeLogger& logger = GetCumulativeTimings();
   const size_t iterations = logger.GetIterations();
@@ -31,6 +31,10 @@
 #include "object_byte_pair.h"
 #include "object_callbacks.h"
 
+#ifdef VTUNE_ART
+#include "vtune_tasks.h"
+#endif
+
 namespace art {
 
 namespace mirror {
@@ -57,6 +61,10 @@ class GarbageCollector : public RootVisitor, public IsMarkedVisitor, public Mark
     const uint64_t start_time_;
     GarbageCollector* const collector_;
     bool with_reporting_;
+#ifdef VTUNE_ART
+    // Covers the suspension and resumption of the threads too.
+    ScopedVTuneTask vtune_task_;
+#endif
   };
 
   GarbageCollector(Heap* heap, const std::string& name);
@@ -82,6 +90,9 @@ class GarbageCollector : public RootVisitor, public IsMarkedVisitor, public Mark
       REQUIRES(Locks::heap_bitmap_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
   uint64_t GetTotalPausedTimeNs() REQUIRES(!pause_histogram_lock_);
+  // Returns the pause time below which the fraction `per` of the pauses fall, or 0 if there was
+  // no pause.
+  uint64_t GetPausePercentileNs(double per) REQUIRES(!pause_histogram_lock_);
   int64_t GetTotalFreedBytes() const {
     return total_freed_bytes_;
   }
@@ -129,6 +129,7 @@ class ImmuneSpacesTest : public CommonRuntimeTest {
         /*pointer_size*/sizeof(void*),
         /*compile_pic*/false,
         /*is_pic*/false,
+        /*has_initialized_classes*/false,
         ImageHeader::kStorageModeUncompressed,
         /*storage_size*/0u);
     return new DummyImageSpace(map.release(),
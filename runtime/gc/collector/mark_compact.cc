@@ -37,6 +37,10 @@
 #include "thread-current-inl.h"
 #include "thread_list.h"
 
+#ifdef VTUNE_ART
+#include "vtune_tasks.h"
+#endif
+
 namespace art {
 namespace gc {
 namespace collector {
@@ -161,6 +165,9 @@ inline mirror::Object* MarkCompact::MarkObject(mirror::Object* obj) {
 
 void MarkCompact::MarkingPhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+#ifdef VTUNE_ART
+  ScopedVTuneTask vtune_task(VTuneTask::kGcMarkingPhase);
+#endif
   Thread* self = Thread::Current();
   // Bitmap which describes which objects we have to move.
   objects_before_forwarding_.reset(accounting::ContinuousSpaceBitmap::Create(
@@ -239,6 +246,9 @@ void MarkCompact::MarkReachableObjects() {
 
 void MarkCompact::ReclaimPhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+#ifdef VTUNE_ART
+  ScopedVTuneTask vtune_task(VTuneTask::kGcReclaimPhase);
+#endif
   WriterMutexLock mu(Thread::Current(), *Locks::heap_bitmap_lock_);
   // Reclaim unmarked objects.
   Sweep(false);
@@ -48,6 +48,10 @@
 #include "thread-current-inl.h"
 #include "thread_list.h"
 
+#ifdef VTUNE_ART
+#include "vtune_tasks.h"
+#endif
+
 namespace art {
 namespace gc {
 namespace collector {
@@ -60,6 +64,7 @@ static constexpr bool kPreCleanCards = true;
 
 // Parallelism options.
 static constexpr bool kParallelCardScan = true;
+static constexpr bool kParallelModUnionUpdate = true;
 static constexpr bool kParallelRecursiveMark = true;
 // Don't attempt to parallelize mark stack processing unless the mark stack is at least n
 // elements. This is temporary until we reduce the overhead caused by allocating tasks, etc.. Not
@@ -1094,6 +1099,9 @@ void MarkSweep::RevokeAllThreadLocalAllocationStacks(Thread* self) {
 
 void MarkSweep::MarkingPhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+#ifdef VTUNE_ART
+  ScopedVTuneTask vtune_task(VTuneTask::kGcMarkingPhase);
+#endif
   Thread* self = Thread::Current();
   BindBitmaps();
   FindDefaultSpaceBitmap();
@@ -1156,6 +1164,9 @@ class MarkSweep::ScanObjectVisitor {
 };
 
 void MarkSweep::UpdateAndMarkModUnion() {
+  const bool paused = !IsConcurrent();
+  const size_t thread_count = GetThreadCount(paused);
+  DCHECK(!updating_reference_);
   for (const auto& space : immune_spaces_.GetSpaces()) {
     const char* name = space->IsZygoteSpace()
         ? "UpdateAndMarkZygoteModUnionTable"
@@ -1163,7 +1174,32 @@ void MarkSweep::UpdateAndMarkModUnion() {
     DCHECK(space->IsZygoteSpace() || space->IsImageSpace()) << *space;
     TimingLogger::ScopedTiming t(name, GetTimings());
     accounting::ModUnionTable* mod_union_table = heap_->FindModUnionTableFromSpace(space);
-    if (mod_union_table != nullptr) {
+    if (mod_union_table != nullptr &&
+        kParallelModUnionUpdate &&
+        thread_count > 1 &&
+        mod_union_table->GetRangeAlignment() != 0) {
+      Thread* self = Thread::Current();
+      ThreadPool* thread_pool = heap_->GetThreadPool();
+      uint8_t* begin = space->Begin();
+      uint8_t* end = AlignUp(space->End(), accounting::CardTable::kCardSize);
+      // Split the cards of the space among the workers, each pushing onto its own mark stack.
+      const size_t delta = RoundUp((end - begin) / thread_count + 1,
+                                   mod_union_table->GetRangeAlignment());
+      while (begin != end) {
+        uint8_t* range_end = begin + std::min(delta, static_cast<size_t>(end - begin));
+        thread_pool->AddTask(self, new ModUnionUpdateTask(thread_pool,
+                                                          this,
+                                                          mod_union_table,
+                                                          begin,
+                                                          range_end,
+                                                          paused));
+        begin = range_end;
+      }
+      thread_pool->SetMaxActiveWorkers(thread_count - 1);
+      thread_pool->StartWorkers(self);
+      thread_pool->Wait(self, true, true);
+      thread_pool->StopWorkers(self);
+    } else if (mod_union_table != nullptr) {
       mod_union_table->UpdateAndMarkReferences(this);
     } else {
       // No mod-union table, scan all the live bits. This can only occur for app images.
@@ -1182,6 +1218,9 @@ void MarkSweep::MarkReachableObjects() {
 
 void MarkSweep::ReclaimPhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+#ifdef VTUNE_ART
+  ScopedVTuneTask vtune_task(VTuneTask::kGcReclaimPhase);
+#endif
   Thread* const self = Thread::Current();
   Runtime* const runtime = Runtime::Current();
   if (!IsCopying()) {
@@ -1492,7 +1531,14 @@ void MarkSweep::MarkRoots(Thread* self) {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   if (Locks::mutator_lock_->IsExclusiveHeld(self)) {
     // If we exclusively hold the mutator lock, all threads must be suspended.
-    Runtime::Current()->VisitRoots(this);
+    const size_t thread_count = GetThreadCount(/* paused */ true);
+    if (thread_count > 1) {
+      MarkThreadRootsParallel(thread_count - 1);
+      MarkNonThreadRoots();
+      MarkConcurrentRoots(kVisitRootFlagAllRoots);
+    } else {
+      Runtime::Current()->VisitRoots(this);
+    }
     RevokeAllThreadLocalAllocationStacks(self);
   } else {
     MarkRootsCheckpoint(self, kRevokeRosAllocThreadLocalBuffersAtCheckpoint);
@@ -1739,6 +1785,62 @@ class MarkSweep::CardScanTask : public MarkStackTask<false> {
   }
 };
 
+class MarkSweep::ModUnionUpdateTask : public MarkStackTask<false> {
+ public:
+  ModUnionUpdateTask(ThreadPool* thread_pool,
+                     MarkSweep* mark_sweep,
+                     accounting::ModUnionTable* mod_union_table,
+                     uint8_t* begin,
+                     uint8_t* end,
+                     bool paused)
+      : MarkStackTask<false>(thread_pool, mark_sweep, 0, nullptr, paused),
+        mod_union_table_(mod_union_table),
+        begin_(begin),
+        end_(end) {}
+
+ protected:
+  // Marks the references of the mod-union table onto the local mark stack of the task.
+  class MarkReferenceVisitor : public MarkObjectVisitor {
+   public:
+    explicit MarkReferenceVisitor(ModUnionUpdateTask* task) : task_(task) {}
+
+    mirror::Object* MarkObject(mirror::Object* obj) OVERRIDE NO_THREAD_SAFETY_ANALYSIS {
+      Mark(obj);
+      return obj;
+    }
+
+    void MarkHeapReference(mirror::HeapReference<mirror::Object>* ref,
+                           bool do_atomic_update ATTRIBUTE_UNUSED) OVERRIDE
+        NO_THREAD_SAFETY_ANALYSIS {
+      Mark(ref->AsMirrorPtr());
+    }
+
+   private:
+    void Mark(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (obj != nullptr && task_->mark_sweep_->MarkObjectParallel(obj)) {
+        task_->MarkStackPush(obj);
+      }
+    }
+
+    ModUnionUpdateTask* const task_;
+  };
+
+  accounting::ModUnionTable* const mod_union_table_;
+  uint8_t* const begin_;
+  uint8_t* const end_;
+
+  virtual void Finalize() {
+    delete this;
+  }
+
+  virtual void Run(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
+    MarkReferenceVisitor visitor(this);
+    mod_union_table_->UpdateAndMarkReferencesInRange(&visitor, begin_, end_);
+    // Finish by emptying our local mark stack.
+    MarkStackTask::Run(self);
+  }
+};
+
 size_t MarkSweep::GetThreadCount(bool paused) const {
   // Use less threads if we are in a background state (non jank perceptible) since we want to leave
   // more CPU time for the foreground apps.
@@ -2036,10 +2138,12 @@ void MarkSweep::VerifySystemWeaks() {
 class MarkSweep::CheckpointMarkThreadRoots : public Closure, public RootVisitor {
  public:
   CheckpointMarkThreadRoots(MarkSweep* mark_sweep,
-                            bool revoke_ros_alloc_thread_local_buffers_at_checkpoint)
+                            bool revoke_ros_alloc_thread_local_buffers_at_checkpoint,
+                            bool pass_barrier = true)
       : mark_sweep_(mark_sweep),
         revoke_ros_alloc_thread_local_buffers_at_checkpoint_(
-            revoke_ros_alloc_thread_local_buffers_at_checkpoint) {
+            revoke_ros_alloc_thread_local_buffers_at_checkpoint),
+        pass_barrier_(pass_barrier) {
   }
 
   void VisitRoots(mirror::Object*** roots, size_t count, const RootInfo& info ATTRIBUTE_UNUSED)
@@ -2073,12 +2177,16 @@ class MarkSweep::CheckpointMarkThreadRoots : public Closure, public RootVisitor
     }
     // If thread is a running mutator, then act on behalf of the garbage collector.
     // See the code in ThreadList::RunCheckpoint.
-    mark_sweep_->GetBarrier().Pass(self);
+    if (pass_barrier_) {
+      mark_sweep_->GetBarrier().Pass(self);
+    }
   }
 
  private:
   MarkSweep* const mark_sweep_;
   const bool revoke_ros_alloc_thread_local_buffers_at_checkpoint_;
+  // Whether the requester waits on the barrier, false when the threads are suspended.
+  const bool pass_barrier_;
 };
 
 void MarkSweep::MarkRootsCheckpoint(Thread* self,
@@ -2105,6 +2213,16 @@ void MarkSweep::MarkRootsCheckpoint(Thread* self,
   Locks::heap_bitmap_lock_->ExclusiveLock(self);
 }
 
+void MarkSweep::MarkThreadRootsParallel(size_t num_workers) {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  // The thread-local allocation stacks and buffers are revoked after the roots are marked.
+  CheckpointMarkThreadRoots visitor(this,
+                                    /* revoke_ros_alloc_thread_local_buffers_at_checkpoint */ false,
+                                    /* pass_barrier */ false);
+  Runtime::Current()->GetThreadList()->RunClosureOnSuspendedThreads(
+      &visitor, GetHeap()->GetThreadPool(), num_workers);
+}
+
 void MarkSweep::SweepArray(accounting::ObjectStack* allocations, bool swap_bitmaps) {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   Thread* self = Thread::Current();
@@ -135,6 +135,13 @@ class MarkSweep : public GarbageCollector {
       REQUIRES(!mark_stack_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Marks the roots of the suspended threads, on the calling thread and up to `num_workers`
+  // workers of the heap thread pool.
+  void MarkThreadRootsParallel(size_t num_workers)
+      REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES(!mark_stack_lock_)
+      REQUIRES(Locks::mutator_lock_);
+
   // Builds a mark stack and recursively mark until it empties.
   void RecursiveMark()
       REQUIRES(Locks::heap_bitmap_lock_)
@@ -485,6 +492,7 @@ class MarkSweep : public GarbageCollector {
   class DelayReferenceReferentVisitor;
   template<bool kUseFinger> class MarkStackTask;
   class MarkObjectSlowPath;
+  class ModUnionUpdateTask;
   class RecursiveMarkTask;
   class ScanObjectParallelVisitor;
   class ScanObjectVisitor;
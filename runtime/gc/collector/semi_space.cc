@@ -51,6 +51,10 @@
 #include "thread-inl.h"
 #include "thread_list.h"
 
+#ifdef VTUNE_ART
+#include "vtune_tasks.h"
+#endif
+
 using ::art::mirror::Object;
 
 namespace art {
@@ -281,6 +285,9 @@ void SemiSpace::ProcessReferences(Thread* self) {
 
 void SemiSpace::MarkingPhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+#ifdef VTUNE_ART
+  ScopedVTuneTask vtune_task(VTuneTask::kGcMarkingPhase);
+#endif
   CHECK(Locks::mutator_lock_->IsExclusiveHeld(self_));
   if (kStoreStackTraces) {
     Locks::mutator_lock_->AssertExclusiveHeld(self_);
@@ -552,6 +559,9 @@ void SemiSpace::MarkReachableObjects() {
 
 void SemiSpace::ReclaimPhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+#ifdef VTUNE_ART
+  ScopedVTuneTask vtune_task(VTuneTask::kGcReclaimPhase);
+#endif
   WriterMutexLock mu(self_, *Locks::heap_bitmap_lock_);
   // Reclaim unmarked objects.
   Sweep(false);
@@ -66,6 +66,8 @@ enum CollectorType {
   kCollectorTypeGetObjectsAllocated,
   // Fake collector type for ScopedGCCriticalSection
   kCollectorTypeCriticalSection,
+  // Card refinement fake collector, doesn't do any actual collecting.
+  kCollectorTypeCardRefinement,
 };
 std::ostream& operator<<(std::ostream& os, const CollectorType& collector_type);
 
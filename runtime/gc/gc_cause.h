@@ -62,6 +62,8 @@ enum GcCause {
   kGcCauseGetObjectsAllocated,
   // GC cause for the profile saver.
   kGcCauseProfileSaver,
+  // Not a real GC cause, used when we refine the dirty cards between GCs.
+  kGcCauseCardRefinement,
 };
 
 const char* PrettyCause(GcCause cause);
@@ -189,17 +189,24 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
     DCHECK(!Runtime::Current()->HasStatsEnabled());
   }
   if (kInstrumented) {
-    if (IsAllocTrackingEnabled()) {
+    const bool alloc_tracking_enabled = IsAllocTrackingEnabled();
+    AllocationListener* l = alloc_listener_.LoadSequentiallyConsistent();
+    // Draw the sample once for both the allocation records and the listener.
+    const bool sampled =
+        (alloc_tracking_enabled || l != nullptr) && IsAllocationSampled(self, bytes_allocated);
+    if (alloc_tracking_enabled && sampled) {
       // allocation_records_ is not null since it never becomes null after allocation tracking is
       // enabled.
       DCHECK(allocation_records_ != nullptr);
       allocation_records_->RecordAllocation(self, &obj, bytes_allocated);
     }
-    AllocationListener* l = alloc_listener_.LoadSequentiallyConsistent();
     if (l != nullptr) {
       // Same as above. We assume that a listener that was once stored will never be deleted.
       // Otherwise we'd have to perform this under a lock.
       l->ObjectAllocated(self, &obj, bytes_allocated);
+      if (sampled) {
+        l->ObjectSampled(self, &obj, bytes_allocated);
+      }
     }
   } else {
     DCHECK(!IsAllocTrackingEnabled());
@@ -223,6 +230,73 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
   return obj.Ptr();
 }
 
+template <typename PreFenceVisitor>
+inline size_t Heap::AllocObjectsThreadLocal(Thread* self,
+                                            ObjPtr<mirror::Class> klass,
+                                            size_t byte_count,
+                                            size_t count,
+                                            AllocatorType allocator,
+                                            mirror::Object** objects,
+                                            const PreFenceVisitor& pre_fence_visitor) {
+  if (kIsDebugBuild) {
+    CheckPreconditionsForAllocObject(klass, byte_count);
+    CHECK_EQ(self->GetState(), kRunnable);
+    self->AssertNoPendingException();
+  }
+  // The instrumented paths record each object, leave them to AllocObjectWithAllocator.
+  if (UNLIKELY(Runtime::Current()->HasStatsEnabled() ||
+               IsAllocTrackingEnabled() ||
+               alloc_listener_.LoadRelaxed() != nullptr ||
+               gc_stress_mode_ ||
+               is_running_on_memory_tool_) ||
+      ShouldAllocLargeObject(klass, byte_count)) {
+    return 0u;
+  }
+  size_t usable_size;
+  size_t allocated;
+  if (IsTLABAllocator(allocator)) {
+    byte_count = RoundUp(byte_count, space::BumpPointerSpace::kAlignment);
+    allocated = std::min(count, self->TlabSize() / byte_count);
+    if (allocated == 0u) {
+      return 0u;
+    }
+    uint8_t* pos = reinterpret_cast<uint8_t*>(self->AllocTlabObjects(byte_count, allocated));
+    for (size_t i = 0; i != allocated; ++i) {
+      objects[i] = reinterpret_cast<mirror::Object*>(pos + i * byte_count);
+    }
+    usable_size = byte_count;
+  } else if (allocator == kAllocatorTypeRosAlloc) {
+    // Make sure the allocation stack can't fill up, as refilling it may GC.
+    if (!kUseThreadLocalAllocationStack) {
+      return 0u;
+    }
+    count = std::min(count, self->GetThreadLocalAllocationStackRoom());
+    allocated = rosalloc_space_->AllocThreadLocal(self, byte_count, count, objects, &usable_size);
+    if (allocated == 0u) {
+      return 0u;
+    }
+  } else {
+    return 0u;
+  }
+  for (size_t i = 0; i != allocated; ++i) {
+    ObjPtr<mirror::Object> obj = objects[i];
+    obj->SetClass(klass);
+    if (kUseBakerReadBarrier) {
+      obj->AssertReadBarrierState();
+    }
+    if (AllocatorHasAllocationStack(allocator)) {
+      bool pushed = self->PushOnThreadLocalAllocationStack(obj.Ptr());
+      DCHECK(pushed);
+    }
+    pre_fence_visitor(&obj, usable_size);
+  }
+  QuasiAtomic::ThreadFenceForConstructor();
+  for (size_t i = 0; i != allocated; ++i) {
+    VerifyObject(objects[i]);
+  }
+  return allocated;
+}
+
 // The size of a thread-local allocation stack in the number of references.
 static constexpr size_t kThreadLocalAllocationStackSize = 128;
 
@@ -391,6 +465,24 @@ inline bool Heap::ShouldAllocLargeObject(ObjPtr<mirror::Class> c, size_t byte_co
   return byte_count >= large_object_threshold_ && (c->IsPrimitiveArray() || c->IsStringClass());
 }
 
+inline bool Heap::IsAllocationSampled(Thread* self, size_t byte_count) {
+  const size_t interval = GetAllocSamplingInterval();
+  if (interval == 0u) {
+    return true;
+  }
+  Thread::AllocSampling* sampling = self->GetAllocSampling();
+  if (UNLIKELY(sampling->random_state == 0u)) {
+    // Do not sample the first allocation of each thread.
+    sampling->bytes_until_sample = NextAllocSamplingInterval(self, interval);
+  }
+  if (LIKELY(byte_count < sampling->bytes_until_sample)) {
+    sampling->bytes_until_sample -= byte_count;
+    return false;
+  }
+  sampling->bytes_until_sample = NextAllocSamplingInterval(self, interval);
+  return true;
+}
+
 inline bool Heap::IsOutOfMemoryOnAllocation(AllocatorType allocator_type,
                                             size_t alloc_size,
                                             bool grow) {
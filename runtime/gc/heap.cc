@@ -16,6 +16,7 @@
 
 #include "heap.h"
 
+#include <cmath>
 #include <limits>
 #include <memory>
 #include <vector>
@@ -86,6 +87,7 @@
 #include "reflection.h"
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
+#include "stats_region.h"
 #include "thread_list.h"
 #include "verify_object-inl.h"
 #include "well_known_classes.h"
@@ -147,6 +149,22 @@ static constexpr bool kLogAllGCs = false;
 static constexpr size_t kPartialTlabSize = 16 * KB;
 static constexpr bool kUsePartialTlabs = true;
 
+// If true, the TLAB refill size (the partial TLAB size with the region space, the TLAB size with
+// the bump pointer space) adapts to the allocation rate of each thread, see GetTlabRefillSize.
+static constexpr bool kUseAdaptiveTlabSizing = true;
+
+// The weight of the last GC in the moving average of the fraction of the time spent in GC, and
+// the most that -XX:GcCpuBudget lets the heap grow by on top of the growth multiplier.
+static constexpr double kGcCpuFractionWeight = 0.25;
+static constexpr double kMaxGcCpuBudgetGrowthAdjustment = 4.0;
+// The most that -XX:GcPauseTarget moves the start of the concurrent GCs sooner by.
+static constexpr double kMaxConcurrentStartScale = 8.0;
+// The number of TLAB refills per GC that the adaptive TLAB sizing aims for, and the bounds of
+// the refill size.
+static constexpr size_t kTlabRefillsPerGc = 32;
+static constexpr size_t kMinTlabRefillSize = 4 * KB;
+static constexpr size_t kMaxTlabRefillSize = 256 * KB;
+
 #if defined(__LP64__) || !defined(ADDRESS_SANITIZER)
 // 300 MB (0x12c00000) - (default non-moving space capacity).
 uint8_t* const Heap::kPreferredAllocSpaceBegin =
@@ -184,6 +202,8 @@ Heap::Heap(size_t initial_size,
            bool low_memory_mode,
            size_t long_pause_log_threshold,
            size_t long_gc_log_threshold,
+           uint64_t gc_pause_target,
+           double gc_cpu_budget,
            bool ignore_max_footprint,
            bool use_tlab,
            bool verify_pre_gc_heap,
@@ -198,8 +218,14 @@ Heap::Heap(size_t initial_size,
            size_t tenure_threshold,
            size_t bump_space_capacity,
            bool measure_gc_performance,
+           bool use_numa,
+           bool use_huge_pages,
+           bool use_generational_cc,
            bool use_homogeneous_space_compaction_for_oom,
-           uint64_t min_interval_homogeneous_space_compaction_by_oom)
+           uint64_t min_interval_homogeneous_space_compaction_by_oom,
+           double fragmentation_compaction_threshold,
+           uint64_t min_interval_fragmentation_compaction,
+           uint64_t card_refinement_interval)
     : non_moving_space_(nullptr),
       rosalloc_space_(nullptr),
       dlmalloc_space_(nullptr),
@@ -214,6 +240,11 @@ Heap::Heap(size_t initial_size,
       low_memory_mode_(low_memory_mode),
       long_pause_log_threshold_(long_pause_log_threshold),
       long_gc_log_threshold_(long_gc_log_threshold),
+      gc_pause_target_(gc_pause_target),
+      gc_cpu_budget_(gc_cpu_budget),
+      gc_cpu_fraction_(0.0),
+      last_gc_end_time_(NanoTime()),
+      concurrent_start_scale_(1.0),
       ignore_max_footprint_(ignore_max_footprint),
       zygote_creation_lock_("zygote creation lock", kZygoteCreationLock),
       zygote_space_(nullptr),
@@ -272,14 +303,23 @@ Heap::Heap(size_t initial_size,
       semi_space_collector_(nullptr),
       mark_compact_collector_(nullptr),
       concurrent_copying_collector_(nullptr),
+      young_concurrent_copying_collector_(nullptr),
+      active_concurrent_copying_collector_(nullptr),
       is_running_on_memory_tool_(Runtime::Current()->IsRunningOnMemoryTool()),
       use_tlab_(use_tlab),
+      use_generational_cc_(kUseBakerReadBarrier && use_generational_cc),
       main_space_backup_(nullptr),
       min_interval_homogeneous_space_compaction_by_oom_(
           min_interval_homogeneous_space_compaction_by_oom),
       last_time_homogeneous_space_compaction_by_oom_(NanoTime()),
+      fragmentation_compaction_threshold_(fragmentation_compaction_threshold),
+      min_interval_fragmentation_compaction_(min_interval_fragmentation_compaction),
+      last_time_fragmentation_compaction_(NanoTime()),
+      card_refinement_interval_(card_refinement_interval),
+      card_refinements_since_gc_(0u),
       pending_collector_transition_(nullptr),
       pending_heap_trim_(nullptr),
+      pending_card_refinement_(nullptr),
       use_homogeneous_space_compaction_for_oom_(use_homogeneous_space_compaction_for_oom),
       running_collection_is_blocking_(false),
       blocking_gc_count_(0U),
@@ -291,7 +331,12 @@ Heap::Heap(size_t initial_size,
       gc_count_rate_histogram_("gc count rate histogram", 1U, kGcCountRateMaxBucketCount),
       blocking_gc_count_rate_histogram_("blocking gc count rate histogram", 1U,
                                         kGcCountRateMaxBucketCount),
+      gcs_completed_(0U),
+      tlab_refill_count_(0U),
+      tlab_refill_bytes_(0U),
+      tlab_waste_bytes_(0U),
       alloc_tracking_enabled_(false),
+      alloc_sampling_interval_(0U),
       backtrace_lock_(nullptr),
       seen_backtrace_count_(0u),
       unique_backtrace_count_(0u),
@@ -475,9 +520,13 @@ Heap::Heap(size_t initial_size,
     // Reserve twice the capacity, to allow evacuating every region for explicit GCs.
     MemMap* region_space_mem_map = space::RegionSpace::CreateMemMap(kRegionSpaceName,
                                                                     capacity_ * 2,
-                                                                    request_begin);
+                                                                    request_begin,
+                                                                    use_huge_pages);
     CHECK(region_space_mem_map != nullptr) << "No region space mem map";
-    region_space_ = space::RegionSpace::Create(kRegionSpaceName, region_space_mem_map);
+    region_space_ = space::RegionSpace::Create(kRegionSpaceName,
+                                               region_space_mem_map,
+                                               use_numa,
+                                               use_huge_pages);
     AddSpace(region_space_);
   } else if (IsMovingGc(foreground_collector_type_) &&
       foreground_collector_type_ != kCollectorTypeGSS &&
@@ -565,6 +614,9 @@ Heap::Heap(size_t initial_size,
   card_table_.reset(accounting::CardTable::Create(reinterpret_cast<uint8_t*>(kMinHeapAddress),
                                                   4 * GB - kMinHeapAddress));
   CHECK(card_table_.get() != nullptr) << "Failed to create card table";
+  if (use_huge_pages) {
+    card_table_->UseHugePages();
+  }
   if (foreground_collector_type_ == kCollectorTypeCC && kUseTableLookupReadBarrier) {
     rb_table_.reset(new accounting::ReadBarrierTable());
     DCHECK(rb_table_->IsAllCleared());
@@ -649,11 +701,22 @@ Heap::Heap(size_t initial_size,
     }
     if (MayUseCollector(kCollectorTypeCC)) {
       concurrent_copying_collector_ = new collector::ConcurrentCopying(this,
+                                                                       /* young_gen */ false,
                                                                        "",
                                                                        measure_gc_performance);
       DCHECK(region_space_ != nullptr);
       concurrent_copying_collector_->SetRegionSpace(region_space_);
       garbage_collectors_.push_back(concurrent_copying_collector_);
+      if (use_generational_cc_) {
+        young_concurrent_copying_collector_ = new collector::ConcurrentCopying(
+            this,
+            /* young_gen */ true,
+            "young",
+            measure_gc_performance);
+        young_concurrent_copying_collector_->SetRegionSpace(region_space_);
+        garbage_collectors_.push_back(young_concurrent_copying_collector_);
+      }
+      active_concurrent_copying_collector_ = concurrent_copying_collector_;
     }
     if (MayUseCollector(kCollectorTypeMC)) {
       mark_compact_collector_ = new collector::MarkCompact(this);
@@ -837,6 +900,18 @@ void Heap::DecrementDisableMovingGC(Thread* self) {
   --disable_moving_gc_count_;
 }
 
+bool Heap::PinRegionSpaceObject(ObjPtr<mirror::Object> obj) {
+  return region_space_ != nullptr &&
+      region_space_->HasAddress(obj.Ptr()) &&
+      region_space_->PinRegion(obj.Ptr());
+}
+
+bool Heap::UnpinRegionSpaceObject(ObjPtr<mirror::Object> obj) {
+  return region_space_ != nullptr &&
+      region_space_->HasAddress(obj.Ptr()) &&
+      region_space_->UnpinRegion(obj.Ptr());
+}
+
 void Heap::IncrementDisableThreadFlip(Thread* self) {
   // Supposed to be called by mutators. If thread_flip_running_ is true, block. Otherwise, go ahead.
   CHECK(kUseReadBarrier);
@@ -1100,6 +1175,15 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
   os << "Total GC time: " << PrettyDuration(GetGcTime()) << "\n";
   os << "Total blocking GC count: " << GetBlockingGcCount() << "\n";
   os << "Total blocking GC time: " << PrettyDuration(GetBlockingGcTime()) << "\n";
+  if (gc_cpu_budget_ != 0.0) {
+    os << "GC time fraction: " << gc_cpu_fraction_ << " of budget " << gc_cpu_budget_ << "\n";
+  }
+  const uint64_t tlab_refill_count = tlab_refill_count_.LoadRelaxed();
+  if (tlab_refill_count != 0U) {
+    os << "Total TLAB refills: " << tlab_refill_count
+       << " of " << PrettySize(tlab_refill_bytes_.LoadRelaxed())
+       << ", wasted " << PrettySize(tlab_waste_bytes_.LoadRelaxed()) << "\n";
+  }
 
   {
     MutexLock mu(Thread::Current(), *gc_complete_lock_);
@@ -1138,6 +1222,9 @@ void Heap::ResetGcPerformanceInfo() {
   blocking_gc_time_ = 0;
   gc_count_last_window_ = 0;
   blocking_gc_count_last_window_ = 0;
+  tlab_refill_count_.StoreRelaxed(0U);
+  tlab_refill_bytes_.StoreRelaxed(0U);
+  tlab_waste_bytes_.StoreRelaxed(0U);
   last_update_time_gc_count_rate_histograms_ =  // Round down by the window duration.
       (NanoTime() / kGcCountRateHistogramWindowDuration) * kGcCountRateHistogramWindowDuration;
   {
@@ -1451,6 +1538,31 @@ void Heap::TrimSpaces(Thread* self) {
   VLOG(heap) << "Heap trim of managed (duration=" << PrettyDuration(gc_heap_end_ns - start_ns)
       << ", advised=" << PrettySize(managed_reclaimed) << ") heap. Managed heap utilization of "
       << static_cast<int>(100 * managed_utilization) << "%.";
+  // Freed objects leave holes in the RosAlloc runs which trimming cannot return to the OS
+  // since they are interleaved with live objects. Long running processes which never go
+  // to the background would keep them forever, so compact when they take too much space.
+  if (ShouldCompactForFragmentation(managed_utilization, total_alloc_space_size)) {
+    VLOG(heap) << "Compacting the main space for fragmentation of "
+        << static_cast<int>(100 * (1.0f - managed_utilization)) << "%";
+    PerformHomogeneousSpaceCompact();
+  }
+}
+
+bool Heap::ShouldCompactForFragmentation(float utilization, uint64_t footprint) {
+  // Compacting a small heap does not save enough to pay for the pause.
+  static constexpr uint64_t kMinFootprint = 16 * MB;
+  if (fragmentation_compaction_threshold_ == 0.0 ||
+      !SupportHomogeneousSpaceCompactAndCollectorTransitions() ||
+      footprint < kMinFootprint ||
+      1.0 - utilization < fragmentation_compaction_threshold_) {
+    return false;
+  }
+  const uint64_t current_time = NanoTime();
+  if (current_time - last_time_fragmentation_compaction_ < min_interval_fragmentation_compaction_) {
+    return false;
+  }
+  last_time_fragmentation_compaction_ = current_time;
+  return true;
 }
 
 bool Heap::IsValidObjectAddress(const void* addr) const {
@@ -2263,6 +2375,9 @@ void Heap::ChangeCollector(CollectorType collector_type) {
     gc_plan_.clear();
     switch (collector_type_) {
       case kCollectorTypeCC: {
+        if (use_generational_cc_) {
+          gc_plan_.push_back(collector::kGcTypeSticky);
+        }
         gc_plan_.push_back(collector::kGcTypeFull);
         if (use_tlab_) {
           ChangeAllocator(kAllocatorTypeRegionTLAB);
@@ -2746,7 +2861,15 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
         }
         break;
       case kCollectorTypeCC:
-        collector = concurrent_copying_collector_;
+        // Sticky collections only collect the regions allocated since the previous collection.
+        if (use_generational_cc_ &&
+            gc_type == collector::kGcTypeSticky &&
+            !clear_soft_references) {
+          active_concurrent_copying_collector_ = young_concurrent_copying_collector_;
+        } else {
+          active_concurrent_copying_collector_ = concurrent_copying_collector_;
+        }
+        collector = active_concurrent_copying_collector_;
         break;
       case kCollectorTypeMC:
         mark_compact_collector_->SetSpace(bump_pointer_space_);
@@ -2755,7 +2878,9 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
       default:
         LOG(FATAL) << "Invalid collector type " << static_cast<size_t>(collector_type_);
     }
-    if (collector != mark_compact_collector_ && collector != concurrent_copying_collector_) {
+    if (collector != mark_compact_collector_ &&
+        collector != concurrent_copying_collector_ &&
+        collector != young_concurrent_copying_collector_) {
       temp_space_->GetMemMap()->Protect(PROT_READ | PROT_WRITE);
       if (kIsDebugBuild) {
         // Try to read each page of the memory map in case mprotect didn't work properly b/19894268.
@@ -2763,7 +2888,8 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
       }
       CHECK(temp_space_->IsEmpty());
     }
-    if (collector_type_ != kCollectorTypeGenCopying) {
+    if (collector_type_ != kCollectorTypeGenCopying &&
+        collector != young_concurrent_copying_collector_) {
       gc_type = collector::kGcTypeFull;  // TODO: Not hard code this in.
     }
   } else if (current_allocator_ == kAllocatorTypeRosAlloc ||
@@ -2787,11 +2913,13 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
   total_objects_freed_ever_ += GetCurrentGcIteration()->GetFreedObjects();
   total_bytes_freed_ever_ += GetCurrentGcIteration()->GetFreedBytes();
   RequestTrim(self);
+  RequestCardRefinement(self, /* after_gc */ true);
   // Enqueue cleared references.
   reference_processor_->EnqueueClearedReferences(self);
   // Grow the heap so that we know when to perform the next GC.
   GrowForUtilization(collector, bytes_allocated_before_gc);
   LogGC(gc_cause, collector);
+  PublishGC(gc_cause, collector);
   FinishGC(self, gc_type);
   // Inform DDMS that a GC completed.
   Dbg::GcDidFinish();
@@ -2839,6 +2967,24 @@ void Heap::LogGC(GcCause gc_cause, collector::GarbageCollector* collector) {
   }
 }
 
+void Heap::PublishGC(GcCause gc_cause, collector::GarbageCollector* collector) {
+  StatsRegion* stats_region = Runtime::Current()->GetStatsRegion();
+  if (stats_region == nullptr) {
+    return;
+  }
+  const collector::Iteration* iteration = GetCurrentGcIteration();
+  stats_region->PublishGc(gc_cause,
+                          collector->GetGcType(),
+                          iteration->GetDurationNs(),
+                          iteration->GetPauseTimes(),
+                          iteration->GetFreedBytes() + iteration->GetFreedLargeObjectBytes(),
+                          GetBytesAllocated(),
+                          GetTotalMemory(),
+                          GetMaxMemory(),
+                          GetBytesAllocatedEver(),
+                          GetBytesFreedEver());
+}
+
 /* The wait for GC can be triggered in the following phases of concurrent GC cycle.
  * 1. In the initialization or marking phase:
  *    The solution is to wake mutators after pause phase or interleave young GC with old GC.
@@ -2866,6 +3012,7 @@ void Heap::FinishGC(Thread* self, collector::GcType gc_type) {
 
     // Update stats.
     ++gc_count_last_window_;
+    gcs_completed_.FetchAndAddRelaxed(1U);
     if (running_collection_is_blocking_) {
       // If the currently running collection was a blocking one,
       // increment the counters and reset the flag.
@@ -3671,8 +3818,17 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
   TraceHeapSize(bytes_allocated);
   uint64_t target_size;
   collector::GcType gc_type = collector_ran->GetGcType();
-  // Use the multiplier to grow more for foreground.
-  const double multiplier = HeapGrowthMultiplier();
+  // Record the longest pause that the mutators saw. A GC for alloc blocks the allocating thread
+  // for its whole duration.
+  const collector::Iteration* iteration = GetCurrentGcIteration();
+  uint64_t gc_pause =
+      (iteration->GetGcCause() == kGcCauseForAlloc) ? iteration->GetDurationNs() : 0u;
+  for (uint64_t pause : iteration->GetPauseTimes()) {
+    gc_pause = std::max(gc_pause, pause);
+  }
+  last_gc_pause_[gc_type] = gc_pause;
+  // Use the multiplier to grow more for foreground, and to meet the GC CPU budget.
+  const double multiplier = HeapGrowthMultiplier() * GcCpuBudgetGrowthAdjustment();
   const uint64_t adjusted_min_free = static_cast<uint64_t>(min_free_ * multiplier);
   const uint64_t adjusted_max_free = static_cast<uint64_t>(max_free_ * multiplier);
   if (gc_type != collector::kGcTypeSticky) {
@@ -3688,13 +3844,22 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
     collector::GcType non_sticky_gc_type = NonStickyGcType();
     // Find what the next non sticky collector will be.
     collector::GarbageCollector* non_sticky_collector = FindCollectorByGcType(non_sticky_gc_type);
+    if (collector_type_ == kCollectorTypeCC) {
+      // The full concurrent copying collector reports a partial GC type.
+      non_sticky_collector = concurrent_copying_collector_;
+    }
     // If the throughput of the current sticky GC >= throughput of the non sticky collector, then
     // do another sticky collection next.
     // We also check that the bytes allocated aren't over the footprint limit in order to prevent a
     // pathological case where dead objects which aren't reclaimed by sticky could get accumulated
     // if the sticky GC throughput always remained >= the full/partial throughput.
-    if (current_gc_iteration_.GetEstimatedThroughput() * kStickyGcThroughputAdjustment >=
-        non_sticky_collector->GetEstimatedMeanThroughput() &&
+    // With a pause target, also do another sticky collection if only the non sticky collector
+    // misses the target.
+    const bool sticky_meets_pause_target = gc_pause_target_ != 0u &&
+        last_gc_pause_[collector::kGcTypeSticky] <= gc_pause_target_ &&
+        last_gc_pause_[non_sticky_gc_type] > gc_pause_target_;
+    if ((current_gc_iteration_.GetEstimatedThroughput() * kStickyGcThroughputAdjustment >=
+         non_sticky_collector->GetEstimatedMeanThroughput() || sticky_meets_pause_target) &&
         non_sticky_collector->NumberOfIterations() > 0 &&
         bytes_allocated <= max_allowed_footprint_) {
       next_gc_type_ = collector::kGcTypeSticky;
@@ -3724,6 +3889,17 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
       size_t remaining_bytes = bytes_allocated_during_gc;
       remaining_bytes = std::min(remaining_bytes, kMaxConcurrentRemainingBytes);
       remaining_bytes = std::max(remaining_bytes, kMinConcurrentRemainingBytes);
+      if (gc_pause_target_ != 0u) {
+        // A GC for alloc means that the concurrent GC started too late for the allocation rate.
+        // If it missed the pause target, start the next ones sooner, then back off slowly.
+        if (iteration->GetGcCause() == kGcCauseForAlloc && gc_pause > gc_pause_target_) {
+          concurrent_start_scale_ = std::min(concurrent_start_scale_ * 2.0,
+                                             kMaxConcurrentStartScale);
+        } else {
+          concurrent_start_scale_ = std::max(concurrent_start_scale_ * 0.75, 1.0);
+        }
+        remaining_bytes = static_cast<size_t>(remaining_bytes * concurrent_start_scale_);
+      }
       if (UNLIKELY(remaining_bytes > max_allowed_footprint_)) {
         // A never going to happen situation that from the estimated allocation rate we will exceed
         // the applications entire footprint with the given estimated allocation rate. Schedule
@@ -3741,6 +3917,29 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
   }
 }
 
+double Heap::GcCpuBudgetGrowthAdjustment() {
+  if (gc_cpu_budget_ == 0.0) {
+    return 1.0;
+  }
+  // Sample the fraction of the time since the end of the previous GC that this GC ran for.
+  const uint64_t now = NanoTime();
+  const uint64_t interval = std::max(now - last_gc_end_time_, static_cast<uint64_t>(1u));
+  const double fraction = std::min(
+      static_cast<double>(GetCurrentGcIteration()->GetDurationNs()) / interval, 1.0);
+  last_gc_end_time_ = now;
+  gc_cpu_fraction_ = gc_cpu_fraction_ * (1.0 - kGcCpuFractionWeight) +
+      fraction * kGcCpuFractionWeight;
+  // Over the budget, let the heap grow more so that the GC runs less often. Well under it, grow
+  // less to give the memory back.
+  const double ratio = gc_cpu_fraction_ / gc_cpu_budget_;
+  if (ratio > 1.0) {
+    return std::min(ratio, kMaxGcCpuBudgetGrowthAdjustment);
+  } else if (ratio < 0.5) {
+    return std::max(2.0 * ratio, 0.5);
+  }
+  return 1.0;
+}
+
 void Heap::GrowForUtilizationGenCopying(collector::GarbageCollector* collector_ran) {
   // We know what our utilization is at this moment.
   // This doesn't actually resize any memory. It just lets the heap grow more when necessary.
@@ -4021,6 +4220,70 @@ void Heap::RequestTrim(Thread* self) {
   task_processor_->AddTask(self, added_task);
 }
 
+class Heap::CardRefinementTask : public HeapTask {
+ public:
+  explicit CardRefinementTask(uint64_t delta_time) : HeapTask(NanoTime() + delta_time) { }
+  virtual void Run(Thread* self) OVERRIDE {
+    gc::Heap* heap = Runtime::Current()->GetHeap();
+    heap->RefineCards(self);
+    heap->ClearPendingCardRefinement(self);
+    heap->RequestCardRefinement(self, /* after_gc */ false);
+  }
+};
+
+void Heap::ClearPendingCardRefinement(Thread* self) {
+  MutexLock mu(self, *pending_task_lock_);
+  pending_card_refinement_ = nullptr;
+}
+
+void Heap::RequestCardRefinement(Thread* self, bool after_gc) {
+  // The concurrent copying collector scans the cards of the immune spaces by itself.
+  if (card_refinement_interval_ == 0u ||
+      collector_type_ == kCollectorTypeCC ||
+      !CanAddHeapTask(self)) {
+    return;
+  }
+  CardRefinementTask* added_task = nullptr;
+  {
+    MutexLock mu(self, *pending_task_lock_);
+    if (after_gc) {
+      card_refinements_since_gc_ = 0u;
+    }
+    if (pending_card_refinement_ != nullptr ||
+        card_refinements_since_gc_ == kMaxCardRefinementsBetweenGcs) {
+      return;
+    }
+    ++card_refinements_since_gc_;
+    added_task = new CardRefinementTask(card_refinement_interval_);
+    pending_card_refinement_ = added_task;
+  }
+  task_processor_->AddTask(self, added_task);
+}
+
+void Heap::RefineCards(Thread* self) {
+  ScopedTrace trace(__FUNCTION__);
+  // Exclude the GC, which owns the mod-union tables and remembered sets while it runs. The
+  // mutators keep running: the cards are aged atomically, and any card they dirty again is
+  // drained again, by the next refinement or by the GC.
+  ScopedGCCriticalSection gcs(self, kGcCauseCardRefinement, kCollectorTypeCardRefinement);
+  ScopedObjectAccess soa(self);
+  for (const auto& space : continuous_spaces_) {
+    accounting::ModUnionTable* table = FindModUnionTableFromSpace(space);
+    accounting::RememberedSet* rem_set = FindRememberedSetFromSpace(space);
+    if (table != nullptr) {
+      table->ProcessCards();
+    } else if (rem_set != nullptr &&
+               collector::SemiSpace::kUseRememberedSet &&
+               (collector_type_ == kCollectorTypeGSS ||
+                collector_type_ == kCollectorTypeGenCopying) &&
+               (space->IsRosAllocSpace() || space == GetNonMovingSpace())) {
+      rem_set->ClearCards();
+    }
+    // The cards of the other spaces have no table to be drained into. Aging them here could
+    // clean the cards a sticky GC still has to scan.
+  }
+}
+
 void Heap::RevokeThreadLocalBuffers(Thread* thread, bool record_free) {
   if (rosalloc_space_ != nullptr) {
     size_t freed_bytes_revoke = rosalloc_space_->RevokeThreadLocalBuffers(thread);
@@ -4335,17 +4598,19 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     const size_t min_expand_size = alloc_size - self->TlabSize();
     const size_t expand_bytes = std::max(
         min_expand_size,
-        std::min(self->TlabRemainingCapacity() - self->TlabSize(), kPartialTlabSize));
+        std::min(self->TlabRemainingCapacity() - self->TlabSize(),
+                 GetTlabRefillSize(self, kPartialTlabSize)));
     if (UNLIKELY(IsOutOfMemoryOnAllocation(allocator_type, expand_bytes, grow))) {
       return nullptr;
     }
     *bytes_tl_bulk_allocated = expand_bytes;
     self->ExpandTlab(expand_bytes);
+    RecordTlabRefill(self, expand_bytes, /* wasted_bytes */ 0u);
     DCHECK_LE(alloc_size, self->TlabSize());
   } else if (allocator_type == kAllocatorTypeTLAB) {
     DCHECK(bump_pointer_space_ != nullptr);
     const bool bypass_tlab = tlab_alloc_threshold_ < alloc_size;
-    size_t new_tlab_size = alloc_size + (bypass_tlab ? 0u : tlab_size_);
+    size_t new_tlab_size = alloc_size + (bypass_tlab ? 0u : GetTlabRefillSize(self, tlab_size_));
     if (UNLIKELY(GetBytesAllocated() + new_tlab_size > growth_limit_)) {
       size_t max_bytes_available = GetFreeMemoryUntilOOME();
       if (max_bytes_available >= alloc_size) {
@@ -4366,6 +4631,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
       }
       return ret;
     } else {
+      const size_t wasted_bytes = self->TlabRemainingCapacity();
       // Try allocating a new thread local buffer, if the allocation fails the space must be
       // full so return null.
       if (!bump_pointer_space_->AllocNewTlab(self, new_tlab_size)) {
@@ -4387,6 +4653,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
         }
       }
       *bytes_tl_bulk_allocated = new_tlab_size;
+      RecordTlabRefill(self, new_tlab_size, wasted_bytes);
     }
   } else {
     DCHECK(allocator_type == kAllocatorTypeRegionTLAB);
@@ -4397,8 +4664,9 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
                                             space::RegionSpace::kRegionSize,
                                             grow))) {
         const size_t new_tlab_size = kUsePartialTlabs
-            ? std::max(alloc_size, kPartialTlabSize)
+            ? std::max(alloc_size, GetTlabRefillSize(self, kPartialTlabSize))
             : gc::space::RegionSpace::kRegionSize;
+        const size_t wasted_bytes = self->TlabRemainingCapacity();
         // Try to allocate a tlab.
         if (!region_space_->AllocNewTlab(self, new_tlab_size)) {
           // Failed to allocate a tlab. Try non-tlab.
@@ -4408,6 +4676,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
                                                        bytes_tl_bulk_allocated);
         }
         *bytes_tl_bulk_allocated = new_tlab_size;
+        RecordTlabRefill(self, new_tlab_size, wasted_bytes);
         // Fall-through to using the TLAB below.
       } else {
         // Check OOME for a non-tlab allocation.
@@ -4439,6 +4708,55 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
   return ret;
 }
 
+size_t Heap::GetTlabRefillSize(Thread* self, size_t default_size) {
+  if (!kUseAdaptiveTlabSizing) {
+    return default_size;
+  }
+  Thread::TlabSizing* sizing = self->GetTlabSizing();
+  const uint32_t gcs_completed = gcs_completed_.LoadRelaxed();
+  if (sizing->refill_size == 0u) {
+    sizing->refill_size = default_size;
+    sizing->refill_bytes = 0u;
+    sizing->gc_count = gcs_completed;
+  } else if (sizing->gc_count != gcs_completed) {
+    // Average the previous size with the one for the allocation rate since the last resize,
+    // to smooth out the variations of the rate between GCs.
+    const size_t num_gcs = gcs_completed - sizing->gc_count;
+    const size_t rate_size = sizing->refill_bytes / num_gcs / kTlabRefillsPerGc;
+    const size_t new_size = (sizing->refill_size + rate_size) / 2;
+    sizing->refill_size = RoundUp(std::min(std::max(new_size, kMinTlabRefillSize),
+                                           kMaxTlabRefillSize),
+                                  kObjectAlignment);
+    sizing->refill_bytes = 0u;
+    sizing->gc_count = gcs_completed;
+  }
+  return sizing->refill_size;
+}
+
+void Heap::RecordTlabRefill(Thread* self, size_t refill_bytes, size_t wasted_bytes) {
+  self->GetTlabSizing()->refill_bytes += refill_bytes;
+  tlab_refill_count_.FetchAndAddRelaxed(1U);
+  tlab_refill_bytes_.FetchAndAddRelaxed(refill_bytes);
+  tlab_waste_bytes_.FetchAndAddRelaxed(wasted_bytes);
+}
+
+size_t Heap::NextAllocSamplingInterval(Thread* self, size_t interval) {
+  Thread::AllocSampling* sampling = self->GetAllocSampling();
+  if (sampling->random_state == 0u) {
+    sampling->random_state = (NanoTime() ^ reinterpret_cast<uintptr_t>(self)) | 1u;
+  }
+  // Draw a uniform value in (0, 1] with xorshift64*, and invert the exponential distribution.
+  uint64_t x = sampling->random_state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  sampling->random_state = x;
+  const double uniform = static_cast<double>((x * UINT64_C(2685821657736338717)) >> 11) + 1.0;
+  const double next = -std::log(uniform / static_cast<double>(UINT64_C(1) << 53)) * interval;
+  return static_cast<size_t>(
+      std::min(next, static_cast<double>(std::numeric_limits<size_t>::max() / 2)));
+}
+
 const Verification* Heap::GetVerification() const {
   return verification_.get();
 }
@@ -165,6 +165,8 @@ class Heap {
 
   // How often we allow heap trimming to happen (nanoseconds).
   static constexpr uint64_t kHeapTrimWait = MsToNs(5000);
+  // How many card refinements may run between two GCs, so that an idle heap stops refining.
+  static constexpr size_t kMaxCardRefinementsBetweenGcs = 16;
   // How long we wait after a transition request to perform a collector transition (nanoseconds).
   static constexpr uint64_t kCollectorTransitionWait = MsToNs(5000);
   // Whether the transition-wait applies or not. Zero wait will stress the
@@ -193,6 +195,8 @@ class Heap {
        bool low_memory_mode,
        size_t long_pause_threshold,
        size_t long_gc_threshold,
+       uint64_t gc_pause_target,
+       double gc_cpu_budget,
        bool ignore_max_footprint,
        bool use_tlab,
        bool verify_pre_gc_heap,
@@ -207,8 +211,14 @@ class Heap {
        size_t tenure_threshold,
        size_t bump_space_capacity,
        bool measure_gc_performance,
+       bool use_numa,
+       bool use_huge_pages,
+       bool use_generational_cc,
        bool use_homogeneous_space_compaction,
-       uint64_t min_interval_homogeneous_space_compaction_by_oom);
+       uint64_t min_interval_homogeneous_space_compaction_by_oom,
+       double fragmentation_compaction_threshold,
+       uint64_t min_interval_fragmentation_compaction,
+       uint64_t card_refinement_interval);
 
   ~Heap();
 
@@ -259,6 +269,22 @@ class Heap {
                !*backtrace_lock_,
                !Roles::uninterruptible_);
 
+  // Allocate up to `count` objects of `klass` of `byte_count` bytes each from the thread local
+  // buffer of `self`, with a single bump of the TLAB or from the thread local run of RosAlloc.
+  // The headers are initialized in one loop, followed by a single constructor fence. Never
+  // suspends. Returns the number of objects stored in `objects`, which is less than `count`
+  // (possibly 0) when the thread local buffer runs out or the allocation is instrumented; the
+  // caller allocates the remaining objects with AllocObjectWithAllocator.
+  template <typename PreFenceVisitor>
+  ALWAYS_INLINE size_t AllocObjectsThreadLocal(Thread* self,
+                                               ObjPtr<mirror::Class> klass,
+                                               size_t byte_count,
+                                               size_t count,
+                                               AllocatorType allocator,
+                                               /*out*/ mirror::Object** objects,
+                                               const PreFenceVisitor& pre_fence_visitor)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   AllocatorType GetCurrentAllocator() const {
     return current_allocator_;
   }
@@ -332,6 +358,12 @@ class Heap {
   void IncrementDisableMovingGC(Thread* self) REQUIRES(!*gc_complete_lock_);
   void DecrementDisableMovingGC(Thread* self) REQUIRES(!*gc_complete_lock_);
 
+  // Pin the region of a region space object for a JNI critical call, instead of disabling the
+  // thread flips. Returns false if the object is not in the region space or its region cannot be
+  // pinned. UnpinRegionSpaceObject returns false for the same objects.
+  bool PinRegionSpaceObject(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
+  bool UnpinRegionSpaceObject(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Temporarily disable thread flip for JNI critical calls.
   void IncrementDisableThreadFlip(Thread* self) REQUIRES(!*thread_flip_lock_);
   void DecrementDisableThreadFlip(Thread* self) REQUIRES(!*thread_flip_lock_);
@@ -721,6 +753,10 @@ class Heap {
       REQUIRES(!*gc_complete_lock_);
   void ResetGcPerformanceInfo() REQUIRES(!*gc_complete_lock_);
 
+  const std::vector<collector::GarbageCollector*>& GetGarbageCollectors() const {
+    return garbage_collectors_;
+  }
+
   // Thread pool.
   void CreateThreadPool();
   void DeleteThreadPool();
@@ -758,14 +794,21 @@ class Heap {
     return zygote_space_ != nullptr;
   }
 
+  // Return the concurrent copying collector of the running (or last) collection, the full or
+  // the young one.
   collector::ConcurrentCopying* ConcurrentCopyingCollector() {
-    return concurrent_copying_collector_;
+    return active_concurrent_copying_collector_;
   }
 
   CollectorType CurrentCollectorType() {
     return collector_type_;
   }
 
+  // Whether the concurrent copying collector runs young collections.
+  bool GetUseGenerationalCC() const {
+    return use_generational_cc_;
+  }
+
   bool IsGcConcurrentAndMoving() const {
     if (IsGcConcurrent() && IsMovingGc(collector_type_)) {
       // Assume no transition when a concurrent moving collector is used.
@@ -783,6 +826,15 @@ class Heap {
   // Request an asynchronous trim.
   void RequestTrim(Thread* self) REQUIRES(!*pending_task_lock_);
 
+  // Request an asynchronous drain of the dirty cards into the mod-union tables and remembered
+  // sets, if -XX:CardRefinementIntervalMs is set. `after_gc` restarts the count of refinements
+  // allowed before the next GC.
+  void RequestCardRefinement(Thread* self, bool after_gc) REQUIRES(!*pending_task_lock_);
+
+  // Drain the dirty cards into the mod-union tables and remembered sets while the mutators run,
+  // so that less card processing is left for the GC pauses.
+  void RefineCards(Thread* self) REQUIRES(!*gc_complete_lock_, !Locks::mutator_lock_);
+
   // Request asynchronous GC.
   void RequestConcurrentGC(Thread* self, GcCause cause, bool force_full)
       REQUIRES(!*pending_task_lock_);
@@ -813,6 +865,17 @@ class Heap {
     alloc_tracking_enabled_.StoreRelaxed(enabled);
   }
 
+  // The mean number of bytes allocated between two sampled allocations, 0 to sample all the
+  // allocations. Allocation tracking only records the sampled allocations, and the allocation
+  // listener is told about them with ObjectSampled.
+  size_t GetAllocSamplingInterval() const {
+    return alloc_sampling_interval_.LoadRelaxed();
+  }
+
+  void SetAllocSamplingInterval(size_t interval) {
+    alloc_sampling_interval_.StoreRelaxed(interval);
+  }
+
   AllocRecordObjectMap* GetAllocationRecords() const
       REQUIRES(Locks::alloc_tracker_lock_) {
     return allocation_records_.get();
@@ -875,6 +938,7 @@ class Heap {
   class ConcurrentGCTask;
   class CollectorTransitionTask;
   class HeapTrimTask;
+  class CardRefinementTask;
 
   // Compact source space to target space. Returns the collector used.
   collector::GarbageCollector* Compact(space::ContinuousMemMapAllocSpace* target_space,
@@ -883,6 +947,8 @@ class Heap {
       REQUIRES(Locks::mutator_lock_);
 
   void LogGC(GcCause gc_cause, collector::GarbageCollector* collector);
+  // Publish the GC that just finished in the runtime stats region, if any.
+  void PublishGC(GcCause gc_cause, collector::GarbageCollector* collector);
   void StartGC(Thread* self, GcCause cause, CollectorType collector_type)
       REQUIRES(!*gc_complete_lock_);
   void FinishGC(Thread* self, collector::GcType gc_type) REQUIRES(!*gc_complete_lock_);
@@ -988,6 +1054,23 @@ class Heap {
                                    size_t* bytes_tl_bulk_allocated)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Returns the TLAB refill size of `self`, `default_size` until its first resize. The size is
+  // resized on the first refill after a GC, so that the thread refills about
+  // kTlabRefillsPerGc times between GCs at its allocation rate since the last resize.
+  size_t GetTlabRefillSize(Thread* self, size_t default_size);
+  // Account a TLAB refill of `refill_bytes` for `self`, which left `wasted_bytes` of its
+  // previous TLAB unused.
+  void RecordTlabRefill(Thread* self, size_t refill_bytes, size_t wasted_bytes);
+
+  // Returns whether the allocation of `byte_count` bytes by `self` is sampled. The bytes between
+  // the sampled allocations of a thread follow an exponential distribution, so that the samples
+  // form a Poisson process over the allocated bytes, and an allocation is sampled with a
+  // probability that grows with its size.
+  ALWAYS_INLINE bool IsAllocationSampled(Thread* self, size_t byte_count);
+
+  // Draws the number of bytes that `self` allocates until its next sampled allocation.
+  size_t NextAllocSamplingInterval(Thread* self, size_t interval);
+
   void ThrowOutOfMemoryError(Thread* self, size_t byte_count, AllocatorType allocator_type)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -1050,10 +1133,14 @@ class Heap {
                                                   bool can_move_objects);
 
   void GrowForUtilizationGenCopying(collector::GarbageCollector* collector_ran);
+  // Returns how much more the heap should grow after the current GC to meet the GC CPU budget,
+  // 1.0 without a budget. Samples the time spent in the current GC.
+  double GcCpuBudgetGrowthAdjustment();
   // Given the current contents of the alloc space, increase the allowed heap footprint to match
   // the target utilization ratio.  This should only be called immediately after a full garbage
   // collection. bytes_allocated_before_gc is used to measure bytes / second for the period which
-  // the GC was run.
+  // the GC was run. With -XX:GcPauseTarget and -XX:GcCpuBudget, also adjust the choice of the next
+  // GC type, the concurrent start bytes, and the heap growth toward these goals.
   void GrowForUtilization(collector::GarbageCollector* collector_ran,
                           uint64_t bytes_allocated_before_gc = 0);
 
@@ -1084,6 +1171,7 @@ class Heap {
 
   void ClearConcurrentGCRequest();
   void ClearPendingTrim(Thread* self) REQUIRES(!*pending_task_lock_);
+  void ClearPendingCardRefinement(Thread* self) REQUIRES(!*pending_task_lock_);
   void ClearPendingCollectorTransition(Thread* self) REQUIRES(!*pending_task_lock_);
 
   // What kind of concurrency behavior is the runtime after? Currently true for concurrent mark
@@ -1098,6 +1186,10 @@ class Heap {
   // Trim the managed and native spaces by releasing unused memory back to the OS.
   void TrimSpaces(Thread* self) REQUIRES(!*gc_complete_lock_);
 
+  // Returns whether the main space is fragmented enough, given the `utilization` of the
+  // `footprint` bytes of the malloc spaces, to be compacted at the end of a heap trim.
+  bool ShouldCompactForFragmentation(float utilization, uint64_t footprint);
+
   // Trim 0 pages at the end of reference tables.
   void TrimIndirectReferenceTables(Thread* self);
 
@@ -1203,6 +1295,20 @@ class Heap {
   // If we get a GC longer than long GC log threshold, then we print out the GC after it finishes.
   const size_t long_gc_log_threshold_;
 
+  // The goals of the GC ergonomics, 0 when not set: the longest pause that the mutators should
+  // see, and the fraction of the time that the GC should run for. See GrowForUtilization.
+  const uint64_t gc_pause_target_;
+  const double gc_cpu_budget_;
+  // The moving average of the fraction of the time that the GC runs for, and the end time of the
+  // last GC it is sampled from.
+  double gc_cpu_fraction_;
+  uint64_t last_gc_end_time_;
+  // The longest pause that the mutators saw in the last GC of each type.
+  uint64_t last_gc_pause_[collector::kGcTypeMax] = {};
+  // How much sooner than the allocation rate predicts to start the concurrent GCs, raised when a
+  // GC for alloc misses the pause target.
+  double concurrent_start_scale_;
+
   // If we ignore the max footprint it lets the heap grow until it hits the heap capacity, this is
   // useful for benchmarking since it reduces time spent in GC to a low %.
   bool ignore_max_footprint_;
@@ -1404,9 +1510,14 @@ class Heap {
   collector::SemiSpace* semi_space_collector_;
   collector::MarkCompact* mark_compact_collector_;
   collector::ConcurrentCopying* concurrent_copying_collector_;
+  // Null unless use_generational_cc_.
+  collector::ConcurrentCopying* young_concurrent_copying_collector_;
+  collector::ConcurrentCopying* active_concurrent_copying_collector_;
 
   const bool is_running_on_memory_tool_;
   const bool use_tlab_;
+  // True if the concurrent copying collector runs young collections, with the Baker read barrier.
+  const bool use_generational_cc_;
 
   // Pointer to the space which becomes the new main space when we do homogeneous space compaction.
   // Use unique_ptr since the space is only added during the homogeneous compaction phase.
@@ -1418,6 +1529,22 @@ class Heap {
   // Times of the last homogeneous space compaction caused by OOM.
   uint64_t last_time_homogeneous_space_compaction_by_oom_;
 
+  // Fraction of the malloc spaces footprint left free above which a heap trim compacts the
+  // main space, or 0 if fragmentation never triggers a homogeneous space compaction.
+  const double fragmentation_compaction_threshold_;
+
+  // Minimal interval allowed between two homogeneous space compactions caused by fragmentation.
+  const uint64_t min_interval_fragmentation_compaction_;
+
+  // Time of the last homogeneous space compaction caused by fragmentation.
+  uint64_t last_time_fragmentation_compaction_;
+
+  // Interval between two card refinements, or 0 if the cards are only processed by the GC.
+  const uint64_t card_refinement_interval_;
+
+  // Card refinements run since the last GC.
+  size_t card_refinements_since_gc_ GUARDED_BY(pending_task_lock_);
+
   // Saved OOMs by homogeneous space compaction.
   Atomic<size_t> count_delayed_oom_;
 
@@ -1436,6 +1563,7 @@ class Heap {
   // Active tasks which we can modify (change target time, desired collector type, etc..).
   CollectorTransitionTask* pending_collector_transition_ GUARDED_BY(pending_task_lock_);
   HeapTrimTask* pending_heap_trim_ GUARDED_BY(pending_task_lock_);
+  CardRefinementTask* pending_card_refinement_ GUARDED_BY(pending_task_lock_);
 
   // Threshold for promoting old enough objects to old generation space.
   // This is for Generational Copying collector.
@@ -1465,10 +1593,21 @@ class Heap {
   // The histogram of the number of blocking GC invocations per window duration.
   Histogram<uint64_t> blocking_gc_count_rate_histogram_ GUARDED_BY(gc_complete_lock_);
 
+  // The number of completed GC runs, for the adaptive TLAB sizing.
+  Atomic<uint32_t> gcs_completed_;
+  // The number of TLAB refills, their total size, and the total unused size of the TLABs they
+  // replaced.
+  Atomic<uint64_t> tlab_refill_count_;
+  Atomic<uint64_t> tlab_refill_bytes_;
+  Atomic<uint64_t> tlab_waste_bytes_;
+
   // Allocation tracking support
   Atomic<bool> alloc_tracking_enabled_;
   std::unique_ptr<AllocRecordObjectMap> allocation_records_;
 
+  // The mean number of bytes between sampled allocations, 0 when sampling all the allocations.
+  Atomic<size_t> alloc_sampling_interval_;
+
   // GC stress related data structures.
   Mutex* backtrace_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   // Debugging variables, seen backtraces vs unique backtraces.
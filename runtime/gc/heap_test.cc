@@ -18,11 +18,14 @@
 #include "common_runtime_test.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/space_bitmap-inl.h"
+#include "gc/allocation_record.h"
 #include "handle_scope-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
+#include "mirror/array-inl.h"
 #include "mirror/object_array-inl.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_pool.h"
 
 namespace art {
 namespace gc {
@@ -96,6 +99,98 @@ TEST_F(HeapTest, DumpGCPerformanceOnShutdown) {
   Runtime::Current()->SetDumpGCPerformanceOnShutdown(true);
 }
 
+TEST_F(HeapTest, AllocTrackingSamplesAllocations) {
+  static constexpr size_t kSamplingInterval = 64 * KB;
+  static constexpr size_t kArrayLength = 1 * KB;
+  static constexpr size_t kNumArrays = 4 * KB;
+  Heap* heap = Runtime::Current()->GetHeap();
+  ScopedObjectAccess soa(Thread::Current());
+  heap->SetAllocSamplingInterval(kSamplingInterval);
+  {
+    ScopedThreadSuspension sts(soa.Self(), ThreadState::kSuspended);
+    AllocRecordObjectMap::SetAllocTrackingEnabled(true);
+  }
+  for (size_t i = 0; i < kNumArrays; ++i) {
+    ASSERT_TRUE(mirror::ByteArray::Alloc(soa.Self(), kArrayLength) != nullptr);
+  }
+  size_t num_records;
+  {
+    MutexLock mu(soa.Self(), *Locks::alloc_tracker_lock_);
+    num_records = heap->GetAllocationRecords()->Size();
+  }
+  {
+    ScopedThreadSuspension sts(soa.Self(), ThreadState::kSuspended);
+    AllocRecordObjectMap::SetAllocTrackingEnabled(false);
+  }
+  heap->SetAllocSamplingInterval(0u);
+  // About 4MB were allocated, for a mean of 64 samples.
+  EXPECT_GT(num_records, 16u);
+  EXPECT_LT(num_records, 256u);
+}
+
+// Allocates arrays from a thread pool worker, and records the TLAB refill size the thread ended
+// up with.
+class TlabAllocTask : public Task {
+ public:
+  static constexpr size_t kNumArrays = 16 * KB;
+  static constexpr size_t kArrayLength = 64;
+
+  explicit TlabAllocTask(size_t* refill_size) : refill_size_(refill_size) {}
+
+  void Run(Thread* self) OVERRIDE {
+    ScopedObjectAccess soa(self);
+    for (size_t i = 0; i < kNumArrays; ++i) {
+      ObjPtr<mirror::IntArray> array = mirror::IntArray::Alloc(self, kArrayLength);
+      CHECK(array != nullptr);
+      array->Set(0, static_cast<int32_t>(i));
+      CHECK_EQ(static_cast<int32_t>(i), array->Get(0));
+    }
+    *refill_size_ = self->GetTlabSizing()->refill_size;
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  size_t* const refill_size_;
+};
+
+// Each thread resizes its TLAB refills on its own slow path, while the collections bump the GC
+// count concurrently.
+TEST_F(HeapTest, AdaptiveTlabSizingWithConcurrentGcs) {
+  static constexpr size_t kNumThreads = 4;
+  // The bounds of the adaptive TLAB sizing in heap.cc.
+  static constexpr size_t kMinTlabRefillSize = 4 * KB;
+  static constexpr size_t kMaxTlabRefillSize = 256 * KB;
+  Heap* heap = Runtime::Current()->GetHeap();
+  AllocatorType allocator_type = heap->GetCurrentAllocator();
+  if (allocator_type != kAllocatorTypeTLAB && allocator_type != kAllocatorTypeRegionTLAB) {
+    return;
+  }
+  heap->ResetGcPerformanceInfo();
+  Thread* self = Thread::Current();
+  size_t refill_sizes[kNumThreads] = {};
+  ThreadPool thread_pool("Heap test thread pool", kNumThreads);
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    thread_pool.AddTask(self, new TlabAllocTask(&refill_sizes[i]));
+  }
+  thread_pool.StartWorkers(self);
+  for (size_t i = 0; i < 4; ++i) {
+    heap->CollectGarbage(/* clear_soft_references */ false);
+  }
+  thread_pool.Wait(self, /* do_work */ false, /* may_hold_locks */ false);
+
+  for (size_t refill_size : refill_sizes) {
+    EXPECT_GE(refill_size, kMinTlabRefillSize);
+    EXPECT_LE(refill_size, kMaxTlabRefillSize);
+    EXPECT_TRUE(IsAligned<kObjectAlignment>(refill_size));
+  }
+  std::ostringstream oss;
+  heap->DumpGcPerformanceInfo(oss);
+  EXPECT_NE(std::string::npos, oss.str().find("Total TLAB refills: ")) << oss.str();
+}
+
 class ZygoteHeapTest : public CommonRuntimeTest {
   void SetUpRuntimeOptions(RuntimeOptions* options) {
     CommonRuntimeTest::SetUpRuntimeOptions(options);
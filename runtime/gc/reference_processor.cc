@@ -19,6 +19,7 @@
 #include "base/time_utils.h"
 #include "base/utils.h"
 #include "collector/garbage_collector.h"
+#include "heap.h"
 #include "java_vm_ext.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
@@ -27,6 +28,7 @@
 #include "object_callbacks.h"
 #include "reference_processor-inl.h"
 #include "reflection.h"
+#include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "task_processor.h"
 #include "well_known_classes.h"
@@ -165,8 +167,8 @@ void ReferenceProcessor::ProcessReferences(bool concurrent,
     }
   }
   // Clear all remaining soft and weak references with white referents.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
+  ClearWhiteReferences(&soft_reference_queue_, collector, concurrent);
+  ClearWhiteReferences(&weak_reference_queue_, collector, concurrent);
   {
     TimingLogger::ScopedTiming t2(concurrent ? "EnqueueFinalizerReferences" :
         "(Paused)EnqueueFinalizerReferences", timings);
@@ -181,10 +183,18 @@ void ReferenceProcessor::ProcessReferences(bool concurrent,
     }
   }
   // Clear all finalizer referent reachable soft and weak references with white referents.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
+  ClearWhiteReferences(&soft_reference_queue_, collector, concurrent);
+  ClearWhiteReferences(&weak_reference_queue_, collector, concurrent);
+  if (!kUseReadBarrier && concurrent) {
+    // All the referents that Reference.get() can return are final now: PhantomReference.get()
+    // always returns null. Disable the slow path and broadcast to the waiters before clearing
+    // the phantom references. Without a read barrier, the concurrent collector does not move
+    // objects, so it does not write the phantom referents that a racing clear() could null.
+    MutexLock mu(self, *Locks::reference_processor_lock_);
+    DisableSlowPath(self);
+  }
   // Clear all phantom references with white referents.
-  phantom_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
+  ClearWhiteReferences(&phantom_reference_queue_, collector, concurrent);
   // At this point all reference queues other than the cleared references should be empty.
   DCHECK(soft_reference_queue_.IsEmpty());
   DCHECK(weak_reference_queue_.IsEmpty());
@@ -197,10 +207,22 @@ void ReferenceProcessor::ProcessReferences(bool concurrent,
     // starts since there is a small window of time where slow_path_enabled_ is enabled but the
     // callback isn't yet set.
     collector_ = nullptr;
-    if (!kUseReadBarrier && concurrent) {
-      // Done processing, disable the slow path and broadcast to the waiters.
-      DisableSlowPath(self);
-    }
+  }
+}
+
+void ReferenceProcessor::ClearWhiteReferences(ReferenceQueue* queue,
+                                              collector::GarbageCollector* collector,
+                                              bool concurrent) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  ThreadPool* thread_pool = heap->GetThreadPool();
+  const size_t num_workers = (thread_pool == nullptr) ? 0u : std::min(
+      concurrent ? heap->GetConcGCThreadCount() : heap->GetParallelGCThreadCount(),
+      thread_pool->GetThreadCount());
+  // In transaction mode, ClearReferent has to be recorded by the calling thread.
+  if (num_workers == 0u || collector->IsTransactionActive()) {
+    queue->ClearWhiteReferences(&cleared_references_, collector);
+  } else {
+    queue->ClearWhiteReferencesParallel(&cleared_references_, collector, thread_pool, num_workers);
   }
 }
 
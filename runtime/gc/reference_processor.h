@@ -87,6 +87,12 @@ class ReferenceProcessor {
   // referents.
   void StartPreservingReferences(Thread* self) REQUIRES(!Locks::reference_processor_lock_);
   void StopPreservingReferences(Thread* self) REQUIRES(!Locks::reference_processor_lock_);
+  // Clear the references of `queue` with white referents into cleared_references_, in parallel
+  // on the heap thread pool when there is one.
+  void ClearWhiteReferences(ReferenceQueue* queue,
+                            collector::GarbageCollector* collector,
+                            bool concurrent)
+      REQUIRES_SHARED(Locks::mutator_lock_);
   // Wait until reference processing is done.
   void WaitUntilDoneProcessingReferences(Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_)
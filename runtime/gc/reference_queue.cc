@@ -16,7 +16,10 @@
 
 #include "reference_queue.h"
 
+#include <memory>
+
 #include "accounting/card_table-inl.h"
+#include "base/bit_utils.h"
 #include "collector/concurrent_copying.h"
 #include "heap.h"
 #include "mirror/class-inl.h"
@@ -129,26 +132,119 @@ size_t ReferenceQueue::GetLength() const {
   return count;
 }
 
+void ReferenceQueue::ClearWhiteReference(ObjPtr<mirror::Reference> ref,
+                                         ReferenceQueue* cleared_references,
+                                         collector::GarbageCollector* collector) {
+  mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
+  // do_atomic_update is false because this happens during the reference processing phase where
+  // Reference.clear() would block.
+  if (!collector->IsNullOrMarkedHeapReference(referent_addr, /*do_atomic_update*/false)) {
+    // Referent is white, clear it.
+    if (Runtime::Current()->IsActiveTransaction()) {
+      ref->ClearReferent<true>();
+    } else {
+      ref->ClearReferent<false>();
+    }
+    cleared_references->EnqueueReference(ref);
+  }
+  // Delay disabling the read barrier until here so that the ClearReferent call above in
+  // transaction mode will trigger the read barrier.
+  DisableReadBarrierForReference(ref);
+}
+
 void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
                                           collector::GarbageCollector* collector) {
   while (!IsEmpty()) {
-    ObjPtr<mirror::Reference> ref = DequeuePendingReference();
-    mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
-    // do_atomic_update is false because this happens during the reference processing phase where
-    // Reference.clear() would block.
-    if (!collector->IsNullOrMarkedHeapReference(referent_addr, /*do_atomic_update*/false)) {
-      // Referent is white, clear it.
-      if (Runtime::Current()->IsActiveTransaction()) {
-        ref->ClearReferent<true>();
-      } else {
-        ref->ClearReferent<false>();
-      }
-      cleared_references->EnqueueReference(ref);
+    ClearWhiteReference(DequeuePendingReference(), cleared_references, collector);
+  }
+}
+
+// Clears the white referents of a slice of the dequeued references, into a queue of its own.
+class ReferenceQueue::ClearWhiteReferencesTask : public Task {
+ public:
+  ClearWhiteReferencesTask(ReferenceQueue* queue,
+                           collector::GarbageCollector* collector,
+                           mirror::Reference* const* begin,
+                           mirror::Reference* const* end)
+      : queue_(queue),
+        collector_(collector),
+        begin_(begin),
+        end_(end),
+        cleared_references_(nullptr) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) OVERRIDE NO_THREAD_SAFETY_ANALYSIS {
+    for (mirror::Reference* const* it = begin_; it != end_; ++it) {
+      queue_->ClearWhiteReference(*it, &cleared_references_, collector_);
     }
-    // Delay disabling the read barrier until here so that the ClearReferent call above in
-    // transaction mode will trigger the read barrier.
-    DisableReadBarrierForReference(ref);
   }
+
+  ReferenceQueue* GetClearedReferences() {
+    return &cleared_references_;
+  }
+
+ private:
+  ReferenceQueue* const queue_;
+  collector::GarbageCollector* const collector_;
+  mirror::Reference* const* const begin_;
+  mirror::Reference* const* const end_;
+  ReferenceQueue cleared_references_;
+};
+
+void ReferenceQueue::ClearWhiteReferencesParallel(ReferenceQueue* cleared_references,
+                                                  collector::GarbageCollector* collector,
+                                                  ThreadPool* thread_pool,
+                                                  size_t num_workers) {
+  // Only hand references to the workers in slices large enough to pay for their wake up.
+  static constexpr size_t kMinReferencesPerTask = 1024;
+  Thread* self = Thread::Current();
+  // Walking the list is inherently sequential, unlike visiting the referents.
+  std::vector<mirror::Reference*> refs;
+  while (!IsEmpty()) {
+    refs.push_back(DequeuePendingReference().Ptr());
+  }
+  num_workers = std::min(num_workers, refs.size() / kMinReferencesPerTask);
+  const size_t num_tasks = num_workers + 1;
+  const size_t task_size = RoundUp(refs.size(), num_tasks) / num_tasks;
+  std::vector<std::unique_ptr<ClearWhiteReferencesTask>> tasks;
+  for (size_t i = 0; i < num_tasks; ++i) {
+    const size_t begin = std::min(i * task_size, refs.size());
+    const size_t end = std::min(begin + task_size, refs.size());
+    tasks.emplace_back(new ClearWhiteReferencesTask(this,
+                                                    collector,
+                                                    refs.data() + begin,
+                                                    refs.data() + end));
+    if (i != 0) {
+      thread_pool->AddTask(self, tasks.back().get());
+    }
+  }
+  if (num_workers != 0) {
+    thread_pool->SetMaxActiveWorkers(num_workers);
+    thread_pool->StartWorkers(self);
+  }
+  tasks[0]->Run(self);
+  if (num_workers != 0) {
+    thread_pool->Wait(self, /* do_work */ true, /* may_hold_locks */ true);
+    thread_pool->StopWorkers(self);
+  }
+  for (const std::unique_ptr<ClearWhiteReferencesTask>& task : tasks) {
+    cleared_references->EnqueueQueue(task->GetClearedReferences());
+  }
+}
+
+void ReferenceQueue::EnqueueQueue(ReferenceQueue* other) {
+  if (other->IsEmpty()) {
+    return;
+  }
+  if (IsEmpty()) {
+    list_ = other->list_;
+  } else {
+    // Join the two cycles after their tails.
+    ObjPtr<mirror::Reference> head = list_->GetPendingNext<kWithoutReadBarrier>();
+    ObjPtr<mirror::Reference> other_head = other->list_->GetPendingNext<kWithoutReadBarrier>();
+    list_->SetPendingNext(other_head);
+    other->list_->SetPendingNext(head);
+  }
+  other->Clear();
 }
 
 void ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
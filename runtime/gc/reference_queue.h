@@ -92,6 +92,19 @@ class ReferenceQueue {
                             collector::GarbageCollector* collector)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Like ClearWhiteReferences, with the references split across the calling thread and up to
+  // `num_workers` workers of `thread_pool`. The collector must support IsNullOrMarkedHeapReference
+  // calls from the workers, and not be in transaction mode.
+  void ClearWhiteReferencesParallel(ReferenceQueue* cleared_references,
+                                    collector::GarbageCollector* collector,
+                                    ThreadPool* thread_pool,
+                                    size_t num_workers)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Move all the references of `other` to this queue, in constant time.
+  // Not thread safe, like EnqueueReference.
+  void EnqueueQueue(ReferenceQueue* other) REQUIRES_SHARED(Locks::mutator_lock_);
+
   void Dump(std::ostream& os) const REQUIRES_SHARED(Locks::mutator_lock_);
   size_t GetLength() const REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -110,6 +123,15 @@ class ReferenceQueue {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
  private:
+  class ClearWhiteReferencesTask;
+
+  // Clear the referent of the dequeued `ref` if it is white, and then enqueue `ref` to
+  // `cleared_references`.
+  void ClearWhiteReference(ObjPtr<mirror::Reference> ref,
+                           ReferenceQueue* cleared_references,
+                           collector::GarbageCollector* collector)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Lock, used for parallel GC reference enqueuing. It allows for multiple threads simultaneously
   // calling AtomicEnqueueIfNotEnqueued.
   Mutex* const lock_;
@@ -61,6 +61,46 @@ TEST_F(ReferenceQueueTest, EnqueueDequeue) {
   ASSERT_EQ(refs, dequeued);
 }
 
+TEST_F(ReferenceQueueTest, EnqueueQueue) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<20> hs(self);
+  Mutex lock("Reference queue lock");
+  ReferenceQueue queue(&lock);
+  ReferenceQueue other(&lock);
+  auto ref_class = hs.NewHandle(
+      Runtime::Current()->GetClassLinker()->FindClass(self, "Ljava/lang/ref/WeakReference;",
+                                                      ScopedNullHandle<mirror::ClassLoader>()));
+  ASSERT_TRUE(ref_class != nullptr);
+  auto ref1(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+  ASSERT_TRUE(ref1 != nullptr);
+  auto ref2(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+  ASSERT_TRUE(ref2 != nullptr);
+  auto ref3(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+  ASSERT_TRUE(ref3 != nullptr);
+  // Moving an empty queue.
+  queue.EnqueueQueue(&other);
+  ASSERT_TRUE(queue.IsEmpty());
+  // Moving into an empty queue.
+  other.EnqueueReference(ref1.Get());
+  queue.EnqueueQueue(&other);
+  ASSERT_TRUE(other.IsEmpty());
+  ASSERT_EQ(queue.GetLength(), 1U);
+  // Joining two queues.
+  other.EnqueueReference(ref2.Get());
+  other.EnqueueReference(ref3.Get());
+  queue.EnqueueQueue(&other);
+  ASSERT_TRUE(other.IsEmpty());
+  ASSERT_EQ(queue.GetLength(), 3U);
+
+  std::set<mirror::Reference*> refs = {ref1.Get(), ref2.Get(), ref3.Get()};
+  std::set<mirror::Reference*> dequeued;
+  while (!queue.IsEmpty()) {
+    dequeued.insert(queue.DequeuePendingReference().Ptr());
+  }
+  ASSERT_EQ(refs, dequeued);
+}
+
 TEST_F(ReferenceQueueTest, Dump) {
   Thread* self = Thread::Current();
   ScopedObjectAccess soa(self);
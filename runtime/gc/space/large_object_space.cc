@@ -161,10 +161,10 @@ mirror::Object* LargeObjectMapSpace::Alloc(Thread* self, size_t num_bytes,
   }
   DCHECK(bytes_tl_bulk_allocated != nullptr);
   *bytes_tl_bulk_allocated = allocation_size;
-  num_bytes_allocated_ += allocation_size;
-  total_bytes_allocated_ += allocation_size;
-  ++num_objects_allocated_;
-  ++total_objects_allocated_;
+  num_bytes_allocated_.FetchAndAddRelaxed(allocation_size);
+  total_bytes_allocated_.FetchAndAddRelaxed(allocation_size);
+  num_objects_allocated_.FetchAndAddRelaxed(1);
+  total_objects_allocated_.FetchAndAddRelaxed(1);
   return obj;
 }
 
@@ -192,10 +192,10 @@ size_t LargeObjectMapSpace::Free(Thread* self, mirror::Object* ptr) {
   }
   MemMap* mem_map = it->second.mem_map;
   const size_t map_size = mem_map->BaseSize();
-  DCHECK_GE(num_bytes_allocated_, map_size);
+  DCHECK_GE(num_bytes_allocated_.LoadRelaxed(), map_size);
   size_t allocation_size = map_size;
-  num_bytes_allocated_ -= allocation_size;
-  --num_objects_allocated_;
+  num_bytes_allocated_.FetchAndSubRelaxed(allocation_size);
+  num_objects_allocated_.FetchAndSubRelaxed(1);
   delete mem_map;
   large_objects_.erase(it);
   return allocation_size;
@@ -274,6 +274,15 @@ class AllocationInfo {
   bool IsZygoteObject() const {
     return (alloc_size_ & kFlagZygote) != 0;
   }
+  // Returns true if the block is cached in a FreeListSpace size class.
+  bool IsCached() const {
+    return (alloc_size_ & kFlagCached) != 0;
+  }
+  // Mark the block as cached in a size class, which clears the zygote flag. The block is not
+  // free either way, for the neighbours that read it while coalescing.
+  void SetCached() {
+    alloc_size_ = AlignSize() | kFlagCached;
+  }
   // Change the object to be a zygote object.
   void SetZygoteObject() {
     alloc_size_ |= kFlagZygote;
@@ -314,7 +323,9 @@ class AllocationInfo {
  private:
   static constexpr uint32_t kFlagFree = 0x80000000;  // If block is free.
   static constexpr uint32_t kFlagZygote = 0x40000000;  // If the large object is a zygote object.
-  static constexpr uint32_t kFlagsMask = ~(kFlagFree | kFlagZygote);  // Combined flags for masking.
+  static constexpr uint32_t kFlagCached = 0x20000000;  // If the block is in a size class.
+  // Combined flags for masking.
+  static constexpr uint32_t kFlagsMask = ~(kFlagFree | kFlagZygote | kFlagCached);
   // Contains the size of the previous free block with kAlignment as the unit. If 0 then the
   // allocation before us is not free.
   // These variables are undefined in the middle of allocations / free blocks.
@@ -346,6 +357,9 @@ inline bool FreeListSpace::SortByPrevFree::operator()(const AllocationInfo* a,
   return reinterpret_cast<uintptr_t>(a) < reinterpret_cast<uintptr_t>(b);
 }
 
+// At most 1/8th of the space is kept in the size class caches.
+static constexpr size_t kMaxCachedBytesDivisor = 8;
+
 FreeListSpace* FreeListSpace::Create(const std::string& name, uint8_t* requested_begin, size_t size) {
   CHECK_EQ(size % kAlignment, 0U);
   std::string error_msg;
@@ -358,7 +372,9 @@ FreeListSpace* FreeListSpace::Create(const std::string& name, uint8_t* requested
 FreeListSpace::FreeListSpace(const std::string& name, MemMap* mem_map, uint8_t* begin, uint8_t* end)
     : LargeObjectSpace(name, begin, end),
       mem_map_(mem_map),
-      lock_("free list space lock", kAllocSpaceLock) {
+      lock_("free list space lock", kAllocSpaceLock),
+      cached_bytes_(0u),
+      max_cached_bytes_((end - begin) / kMaxCachedBytesDivisor) {
   const size_t space_capacity = end - begin;
   free_end_ = space_capacity;
   CHECK_ALIGNED(space_capacity, kAlignment);
@@ -381,7 +397,7 @@ void FreeListSpace::Walk(DlMallocSpace::WalkCallback callback, void* arg) {
   AllocationInfo* cur_info = &allocation_info_[0];
   const AllocationInfo* end_info = GetAllocationInfoForAddress(free_end_start);
   while (cur_info < end_info) {
-    if (!cur_info->IsFree()) {
+    if (!cur_info->IsFree() && !cur_info->IsCached()) {
       size_t alloc_size = cur_info->ByteSize();
       uint8_t* byte_start = reinterpret_cast<uint8_t*>(GetAddressForAllocationInfo(cur_info));
       uint8_t* byte_end = byte_start + alloc_size;
@@ -402,15 +418,90 @@ void FreeListSpace::RemoveFreePrev(AllocationInfo* info) {
 }
 
 size_t FreeListSpace::Free(Thread* self, mirror::Object* obj) {
-  MutexLock mu(self, lock_);
   DCHECK(Contains(obj)) << reinterpret_cast<void*>(Begin()) << " " << obj << " "
                         << reinterpret_cast<void*>(End());
   DCHECK_ALIGNED(obj, kAlignment);
   AllocationInfo* info = GetAllocationInfoForAddress(reinterpret_cast<uintptr_t>(obj));
   DCHECK(!info->IsFree());
+  DCHECK(!info->IsCached());
   const size_t allocation_size = info->ByteSize();
   DCHECK_GT(allocation_size, 0U);
   DCHECK_ALIGNED(allocation_size, kAlignment);
+  DCHECK_LE(allocation_size, num_bytes_allocated_.LoadRelaxed());
+  num_objects_allocated_.FetchAndSubRelaxed(1);
+  num_bytes_allocated_.FetchAndSubRelaxed(allocation_size);
+  // Release the pages while the block is still ours, no other thread can reuse it yet.
+  madvise(obj, allocation_size, MADV_DONTNEED);
+  if (kIsDebugBuild) {
+    // Can't disallow reads since we use them to find next chunks during coalescing.
+    CheckedCall(mprotect, __FUNCTION__, obj, allocation_size, PROT_READ);
+  }
+  if (!FreeToSizeClass(self, info)) {
+    MutexLock mu(self, lock_);
+    FreeLocked(info);
+  }
+  return allocation_size;
+}
+
+bool FreeListSpace::FreeToSizeClass(Thread* self, AllocationInfo* info) {
+  const size_t allocation_size = info->ByteSize();
+  const size_t index = allocation_size / kAlignment - 1;
+  if (index >= kNumSizeClasses) {
+    return false;
+  }
+  if (cached_bytes_.FetchAndAddRelaxed(allocation_size) + allocation_size > max_cached_bytes_) {
+    cached_bytes_.FetchAndSubRelaxed(allocation_size);
+    return false;
+  }
+  SizeClass& size_class = size_classes_[index];
+  MutexLock mu(self, size_class.lock);
+  info->SetCached();
+  size_class.blocks.push_back(info);
+  return true;
+}
+
+AllocationInfo* FreeListSpace::AllocFromSizeClass(Thread* self, size_t allocation_size) {
+  const size_t index = allocation_size / kAlignment - 1;
+  if (index >= kNumSizeClasses) {
+    return nullptr;
+  }
+  SizeClass& size_class = size_classes_[index];
+  AllocationInfo* info;
+  {
+    MutexLock mu(self, size_class.lock);
+    if (size_class.blocks.empty()) {
+      return nullptr;
+    }
+    info = size_class.blocks.back();
+    size_class.blocks.pop_back();
+    DCHECK(info->IsCached());
+    DCHECK_EQ(info->ByteSize(), allocation_size);
+    info->SetByteSize(allocation_size, false);
+  }
+  cached_bytes_.FetchAndSubRelaxed(allocation_size);
+  return info;
+}
+
+bool FreeListSpace::FlushSizeClasses(Thread* self) {
+  bool flushed = false;
+  for (SizeClass& size_class : size_classes_) {
+    CachedBlocks blocks;
+    {
+      MutexLock mu(self, size_class.lock);
+      blocks.swap(size_class.blocks);
+    }
+    for (AllocationInfo* info : blocks) {
+      DCHECK(info->IsCached());
+      cached_bytes_.FetchAndSubRelaxed(info->ByteSize());
+      FreeLocked(info);
+    }
+    flushed = flushed || !blocks.empty();
+  }
+  return flushed;
+}
+
+void FreeListSpace::FreeLocked(AllocationInfo* info) {
+  const size_t allocation_size = info->ByteSize();
   info->SetByteSize(allocation_size, true);  // Mark as free.
   // Look at the next chunk.
   AllocationInfo* next_info = info->GetNextInfo();
@@ -449,15 +540,6 @@ size_t FreeListSpace::Free(Thread* self, mirror::Object* obj) {
     info->SetByteSize(new_free_size, true);
     DCHECK_EQ(info->GetNextInfo(), new_free_info);
   }
-  --num_objects_allocated_;
-  DCHECK_LE(allocation_size, num_bytes_allocated_);
-  num_bytes_allocated_ -= allocation_size;
-  madvise(obj, allocation_size, MADV_DONTNEED);
-  if (kIsDebugBuild) {
-    // Can't disallow reads since we use them to find next chunks during coalescing.
-    CheckedCall(mprotect, __FUNCTION__, obj, allocation_size, PROT_READ);
-  }
-  return allocation_size;
 }
 
 size_t FreeListSpace::AllocationSize(mirror::Object* obj, size_t* usable_size) {
@@ -473,8 +555,38 @@ size_t FreeListSpace::AllocationSize(mirror::Object* obj, size_t* usable_size) {
 
 mirror::Object* FreeListSpace::Alloc(Thread* self, size_t num_bytes, size_t* bytes_allocated,
                                      size_t* usable_size, size_t* bytes_tl_bulk_allocated) {
-  MutexLock mu(self, lock_);
   const size_t allocation_size = RoundUp(num_bytes, kAlignment);
+  AllocationInfo* new_info = AllocFromSizeClass(self, allocation_size);
+  if (new_info == nullptr) {
+    MutexLock mu(self, lock_);
+    new_info = AllocLocked(allocation_size);
+    if (new_info == nullptr && FlushSizeClasses(self)) {
+      // Retry with the cached blocks coalesced.
+      new_info = AllocLocked(allocation_size);
+    }
+    if (new_info == nullptr) {
+      return nullptr;
+    }
+  }
+  DCHECK(bytes_allocated != nullptr);
+  *bytes_allocated = allocation_size;
+  if (usable_size != nullptr) {
+    *usable_size = allocation_size;
+  }
+  DCHECK(bytes_tl_bulk_allocated != nullptr);
+  *bytes_tl_bulk_allocated = allocation_size;
+  num_objects_allocated_.FetchAndAddRelaxed(1);
+  total_objects_allocated_.FetchAndAddRelaxed(1);
+  num_bytes_allocated_.FetchAndAddRelaxed(allocation_size);
+  total_bytes_allocated_.FetchAndAddRelaxed(allocation_size);
+  mirror::Object* obj = reinterpret_cast<mirror::Object*>(GetAddressForAllocationInfo(new_info));
+  if (kIsDebugBuild) {
+    CheckedCall(mprotect, __FUNCTION__, obj, allocation_size, PROT_READ | PROT_WRITE);
+  }
+  return obj;
+}
+
+AllocationInfo* FreeListSpace::AllocLocked(size_t allocation_size) {
   AllocationInfo temp_info;
   temp_info.SetPrevFreeBytes(allocation_size);
   temp_info.SetByteSize(0, false);
@@ -505,27 +617,11 @@ mirror::Object* FreeListSpace::Alloc(Thread* self, size_t num_bytes, size_t* byt
       return nullptr;
     }
   }
-  DCHECK(bytes_allocated != nullptr);
-  *bytes_allocated = allocation_size;
-  if (usable_size != nullptr) {
-    *usable_size = allocation_size;
-  }
-  DCHECK(bytes_tl_bulk_allocated != nullptr);
-  *bytes_tl_bulk_allocated = allocation_size;
-  // Need to do these inside of the lock.
-  ++num_objects_allocated_;
-  ++total_objects_allocated_;
-  num_bytes_allocated_ += allocation_size;
-  total_bytes_allocated_ += allocation_size;
-  mirror::Object* obj = reinterpret_cast<mirror::Object*>(GetAddressForAllocationInfo(new_info));
   // We always put our object at the start of the free block, there cannot be another free block
   // before it.
-  if (kIsDebugBuild) {
-    CheckedCall(mprotect, __FUNCTION__, obj, allocation_size, PROT_READ | PROT_WRITE);
-  }
   new_info->SetPrevFreeBytes(0);
   new_info->SetByteSize(allocation_size, false);
-  return obj;
+  return new_info;
 }
 
 void FreeListSpace::Dump(std::ostream& os) const {
@@ -543,6 +639,9 @@ void FreeListSpace::Dump(std::ostream& os) const {
     if (cur_info->IsFree()) {
       os << "Free block at address: " << reinterpret_cast<const void*>(address)
          << " of length " << size << " bytes\n";
+    } else if (cur_info->IsCached()) {
+      os << "Cached free block at address: " << reinterpret_cast<const void*>(address)
+         << " of length " << size << " bytes\n";
     } else {
       os << "Large object at address: " << reinterpret_cast<const void*>(address)
          << " of length " << size << " bytes\n";
@@ -567,7 +666,7 @@ void FreeListSpace::SetAllLargeObjectsAsZygoteObjects(Thread* self) {
   for (AllocationInfo* cur_info = GetAllocationInfoForAddress(reinterpret_cast<uintptr_t>(Begin())),
       *end_info = GetAllocationInfoForAddress(free_end_start); cur_info < end_info;
       cur_info = cur_info->GetNextInfo()) {
-    if (!cur_info->IsFree()) {
+    if (!cur_info->IsFree() && !cur_info->IsCached()) {
       cur_info->SetZygoteObject();
     }
   }
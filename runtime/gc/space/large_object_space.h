@@ -18,6 +18,7 @@
 #define ART_RUNTIME_GC_SPACE_LARGE_OBJECT_SPACE_H_
 
 #include "base/allocator.h"
+#include "base/atomic.h"
 #include "base/safe_map.h"
 #include "base/tracking_safe_map.h"
 #include "dlmalloc_space.h"
@@ -50,16 +51,16 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
   virtual ~LargeObjectSpace() {}
 
   uint64_t GetBytesAllocated() OVERRIDE {
-    return num_bytes_allocated_;
+    return num_bytes_allocated_.LoadRelaxed();
   }
   uint64_t GetObjectsAllocated() OVERRIDE {
-    return num_objects_allocated_;
+    return num_objects_allocated_.LoadRelaxed();
   }
   uint64_t GetTotalBytesAllocated() const {
-    return total_bytes_allocated_;
+    return total_bytes_allocated_.LoadRelaxed();
   }
   uint64_t GetTotalObjectsAllocated() const {
-    return total_objects_allocated_;
+    return total_objects_allocated_.LoadRelaxed();
   }
   size_t FreeList(Thread* self, size_t num_ptrs, mirror::Object** ptrs) OVERRIDE;
   // LargeObjectSpaces don't have thread local state.
@@ -113,11 +114,12 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
   explicit LargeObjectSpace(const std::string& name, uint8_t* begin, uint8_t* end);
   static void SweepCallback(size_t num_ptrs, mirror::Object** ptrs, void* arg);
 
-  // Approximate number of bytes which have been allocated into the space.
-  uint64_t num_bytes_allocated_;
-  uint64_t num_objects_allocated_;
-  uint64_t total_bytes_allocated_;
-  uint64_t total_objects_allocated_;
+  // Approximate number of bytes which have been allocated into the space. Atomic, as the
+  // FreeListSpace size classes update them without a common lock.
+  Atomic<uint64_t> num_bytes_allocated_;
+  Atomic<uint64_t> num_objects_allocated_;
+  Atomic<uint64_t> total_bytes_allocated_;
+  Atomic<uint64_t> total_objects_allocated_;
   // Begin and end, may change as more large objects are allocated.
   uint8_t* begin_;
   uint8_t* end_;
@@ -164,9 +166,17 @@ class LargeObjectMapSpace : public LargeObjectSpace {
 };
 
 // A continuous large object space with a free-list to handle holes.
+//
+// Freed blocks of up to kNumSizeClasses pages are first cached in size-segregated free lists,
+// one per page count with a lock of its own, and reused by the allocations of the same size
+// without taking lock_. The cached blocks look allocated to the best fit free list, and are
+// only coalesced with their neighbours when the caches are flushed back into it, when an
+// allocation can't be satisfied otherwise.
 class FreeListSpace FINAL : public LargeObjectSpace {
  public:
   static constexpr size_t kAlignment = kPageSize;
+  // Number of size classes, which cache blocks of 1 to kNumSizeClasses pages.
+  static constexpr size_t kNumSizeClasses = 64;
 
   virtual ~FreeListSpace();
   static FreeListSpace* Create(const std::string& name, uint8_t* requested_begin, size_t capacity);
@@ -198,6 +208,18 @@ class FreeListSpace FINAL : public LargeObjectSpace {
   }
   // Removes header from the free blocks set by finding the corresponding iterator and erasing it.
   void RemoveFreePrev(AllocationInfo* info) REQUIRES(lock_);
+  // Allocates a block of `allocation_size` bytes from the best fit free list or the end of the
+  // space, returns null if there is none.
+  AllocationInfo* AllocLocked(size_t allocation_size) REQUIRES(lock_);
+  // Returns the allocated block `info` to the best fit free list, coalescing it with its free
+  // neighbours.
+  void FreeLocked(AllocationInfo* info) REQUIRES(lock_);
+  // Returns a cached block of `allocation_size` bytes, or null if its size class is empty.
+  AllocationInfo* AllocFromSizeClass(Thread* self, size_t allocation_size);
+  // Caches the allocated block `info`, returns false if it is too large or the caches are full.
+  bool FreeToSizeClass(Thread* self, AllocationInfo* info);
+  // Moves all the cached blocks to the best fit free list. Returns whether there were any.
+  bool FlushSizeClasses(Thread* self) REQUIRES(lock_);
   bool IsZygoteLargeObject(Thread* self, mirror::Object* obj) const OVERRIDE;
   void SetAllLargeObjectsAsZygoteObjects(Thread* self) OVERRIDE REQUIRES(!lock_);
 
@@ -215,10 +237,26 @@ class FreeListSpace FINAL : public LargeObjectSpace {
   std::unique_ptr<MemMap> allocation_info_map_;
   AllocationInfo* allocation_info_;
 
+  typedef std::vector<AllocationInfo*,
+                      TrackingAllocator<AllocationInfo*, kAllocatorTagLOSFreeList>> CachedBlocks;
+  struct SizeClass {
+    SizeClass()
+        : lock("large object free list space size class lock", kLargeObjectSizeClassLock) {}
+    Mutex lock;
+    CachedBlocks blocks GUARDED_BY(lock);
+  };
+
   mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   // Free bytes at the end of the space.
   size_t free_end_ GUARDED_BY(lock_);
   FreeBlocks free_blocks_ GUARDED_BY(lock_);
+
+  // The caches of freed blocks, indexed by the number of pages of the blocks minus one. Their
+  // locks are acquired after lock_.
+  SizeClass size_classes_[kNumSizeClasses];
+  // Bytes in the caches, and the limit above which freed blocks are coalesced instead.
+  Atomic<size_t> cached_bytes_;
+  const size_t max_cached_bytes_;
 };
 
 }  // namespace space
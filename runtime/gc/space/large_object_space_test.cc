@@ -30,6 +30,8 @@ class LargeObjectSpaceTest : public SpaceTest<CommonRuntimeTest> {
   static constexpr size_t kNumThreads = 10;
   static constexpr size_t kNumIterations = 1000;
   void RaceTest();
+
+  void SizeClassTest();
 };
 
 
@@ -174,6 +176,53 @@ void LargeObjectSpaceTest::RaceTest() {
   }
 }
 
+void LargeObjectSpaceTest::SizeClassTest() {
+  Thread* const self = Thread::Current();
+  const size_t capacity = 16 * MB;
+  const size_t block_size = 16 * FreeListSpace::kAlignment;
+  std::unique_ptr<FreeListSpace> los(
+      FreeListSpace::Create("large object space", nullptr, capacity));
+  size_t bytes_allocated, bytes_tl_bulk_allocated;
+
+  // A freed block is reused by the next allocation of its size.
+  mirror::Object* obj = los->Alloc(self, block_size, &bytes_allocated, nullptr,
+                                   &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(obj != nullptr);
+  ASSERT_EQ(block_size, los->Free(self, obj));
+  mirror::Object* obj2 = los->Alloc(self, block_size, &bytes_allocated, nullptr,
+                                    &bytes_tl_bulk_allocated);
+  EXPECT_EQ(obj, obj2);
+  for (size_t i = 0; i < block_size; ++i) {
+    ASSERT_EQ(reinterpret_cast<const uint8_t*>(obj2)[i], 0u);
+  }
+  los->Free(self, obj2);
+
+  // Fill the space, and free everything. Only part of the blocks fit the caches.
+  std::vector<mirror::Object*> objects;
+  while (true) {
+    obj = los->Alloc(self, block_size, &bytes_allocated, nullptr, &bytes_tl_bulk_allocated);
+    if (obj == nullptr) {
+      break;
+    }
+    memset(obj, 0xAB, block_size);
+    objects.push_back(obj);
+  }
+  EXPECT_EQ(capacity / block_size, objects.size());
+  EXPECT_EQ(capacity, los->GetBytesAllocated());
+  for (mirror::Object* o : objects) {
+    los->Free(self, o);
+  }
+  EXPECT_EQ(0u, los->GetBytesAllocated());
+  EXPECT_EQ(0u, los->GetObjectsAllocated());
+
+  // Allocating the whole space needs the cached blocks to be coalesced.
+  obj = los->Alloc(self, capacity, &bytes_allocated, nullptr, &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(obj != nullptr);
+  EXPECT_EQ(capacity, bytes_allocated);
+  los->Free(self, obj);
+  EXPECT_EQ(0u, los->GetBytesAllocated());
+}
+
 TEST_F(LargeObjectSpaceTest, LargeObjectTest) {
   LargeObjectTest();
 }
@@ -182,6 +231,10 @@ TEST_F(LargeObjectSpaceTest, RaceTest) {
   RaceTest();
 }
 
+TEST_F(LargeObjectSpaceTest, SizeClassTest) {
+  SizeClassTest();
+}
+
 }  // namespace space
 }  // namespace gc
 }  // namespace art
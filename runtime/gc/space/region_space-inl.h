@@ -327,13 +327,14 @@ inline void RegionSpace::FreeLarge(mirror::Object* large_obj, size_t bytes_alloc
     } else {
       DCHECK(reg->IsLargeTail());
     }
-    reg->Clear(/*zero_and_release_pages*/true);
+    reg->Clear();
     if (kForEvac) {
       --num_evac_regions_;
     } else {
       --num_non_free_regions_;
     }
   }
+  ZeroAndProtectRegions(begin_addr, end_addr);
   if (end_addr < Limit()) {
     // If we aren't at the end of the space, check that the next region is not a large tail.
     Region* following_reg = RefToRegionLocked(reinterpret_cast<mirror::Object*>(end_addr));
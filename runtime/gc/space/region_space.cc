@@ -14,9 +14,19 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "base/file_utils.h"
 #include "bump_pointer_space-inl.h"
 #include "bump_pointer_space.h"
 #include "gc/accounting/read_barrier_table.h"
+#include "gc/accounting/space_bitmap-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "thread_list.h"
@@ -26,24 +36,34 @@ namespace gc {
 namespace space {
 
 // If a region has live objects whose size is less than this percent
-// value of the region size, evaculate the region.
+// value of the region size, the region is a candidate for evacuation.
 static constexpr uint kEvacuateLivePercentThreshold = 75U;
 
+// The live bytes of the candidate regions evacuated by a collection are at most this percent
+// of the bytes of the non-free regions. The newly allocated regions are not counted.
+static constexpr uint kEvacuateCopyBudgetPercent = 25U;
+
 // If we protect the cleared regions.
 // Only protect for target builds to prevent flaky test failures (b/63131961).
 static constexpr bool kProtectClearedRegions = kIsTargetBuild;
 
-MemMap* RegionSpace::CreateMemMap(const std::string& name, size_t capacity,
-                                  uint8_t* requested_begin) {
+MemMap* RegionSpace::CreateMemMap(const std::string& name,
+                                  size_t capacity,
+                                  uint8_t* requested_begin,
+                                  bool use_huge_pages) {
   CHECK_ALIGNED(capacity, kRegionSize);
   std::string error_msg;
   // Ask for the capacity of an additional kRegionSize so that we can align the map by kRegionSize
   // even if we get unaligned base address. This is necessary for the ReadBarrierTable to work.
+  // With huge pages, align by the huge page size as well so that no huge page straddles the
+  // beginning of the space.
+  const size_t alignment = use_huge_pages ? std::max(kRegionSize, kHugePageSize) : kRegionSize;
+  const size_t map_size = RoundUp(capacity, alignment) + alignment;
   std::unique_ptr<MemMap> mem_map;
   while (true) {
     mem_map.reset(MemMap::MapAnonymous(name.c_str(),
                                        requested_begin,
-                                       capacity + kRegionSize,
+                                       map_size,
                                        PROT_READ | PROT_WRITE,
                                        true,
                                        false,
@@ -60,16 +80,16 @@ MemMap* RegionSpace::CreateMemMap(const std::string& name, size_t capacity,
     MemMap::DumpMaps(LOG_STREAM(ERROR));
     return nullptr;
   }
-  CHECK_EQ(mem_map->Size(), capacity + kRegionSize);
+  CHECK_EQ(mem_map->Size(), map_size);
   CHECK_EQ(mem_map->Begin(), mem_map->BaseBegin());
   CHECK_EQ(mem_map->Size(), mem_map->BaseSize());
-  if (IsAlignedParam(mem_map->Begin(), kRegionSize)) {
-    // Got an aligned map. Since we requested a map that's kRegionSize larger. Shrink by
-    // kRegionSize at the end.
-    mem_map->SetSize(capacity);
-  } else {
+  if (!IsAlignedParam(mem_map->Begin(), alignment)) {
     // Got an unaligned map. Align the both ends.
-    mem_map->AlignBy(kRegionSize);
+    mem_map->AlignBy(alignment);
+  }
+  if (mem_map->Size() != capacity) {
+    // Since we requested a map that's larger, shrink it at the end.
+    mem_map->SetSize(capacity);
   }
   CHECK_ALIGNED(mem_map->Begin(), kRegionSize);
   CHECK_ALIGNED(mem_map->End(), kRegionSize);
@@ -77,11 +97,42 @@ MemMap* RegionSpace::CreateMemMap(const std::string& name, size_t capacity,
   return mem_map.release();
 }
 
-RegionSpace* RegionSpace::Create(const std::string& name, MemMap* mem_map) {
-  return new RegionSpace(name, mem_map);
+// Returns the number of NUMA nodes of the system, 1 if it is not known.
+static size_t GetNumaNodeCount() {
+  // The possible nodes are listed as a range, as in "0-1", or as a single node "0".
+  std::string possible;
+  if (!ReadFileToString("/sys/devices/system/node/possible", &possible)) {
+    return 1u;
+  }
+  size_t last_node_pos = possible.find_last_of("-,");
+  last_node_pos = (last_node_pos == std::string::npos) ? 0u : last_node_pos + 1u;
+  int last_node = atoi(possible.c_str() + last_node_pos);
+  return (last_node > 0) ? static_cast<size_t>(last_node) + 1u : 1u;
+}
+
+// Returns the NUMA node of the CPU running the calling thread, 0 if it is not known.
+static size_t GetCurrentNumaNode() {
+#if defined(__linux__)
+  unsigned cpu;
+  unsigned node;
+  if (syscall(__NR_getcpu, &cpu, &node, nullptr) == 0) {
+    return node;
+  }
+#endif
+  return 0u;
+}
+
+RegionSpace* RegionSpace::Create(const std::string& name,
+                                 MemMap* mem_map,
+                                 bool use_numa,
+                                 bool use_huge_pages) {
+  return new RegionSpace(name, mem_map, use_numa, use_huge_pages);
 }
 
-RegionSpace::RegionSpace(const std::string& name, MemMap* mem_map)
+RegionSpace::RegionSpace(const std::string& name,
+                         MemMap* mem_map,
+                         bool use_numa,
+                         bool use_huge_pages)
     : ContinuousMemMapAllocSpace(name, mem_map, mem_map->Begin(), mem_map->End(), mem_map->End(),
                                  kGcRetentionPolicyAlwaysCollect),
       region_lock_("Region lock", kRegionSpaceRegionLock),
@@ -91,18 +142,26 @@ RegionSpace::RegionSpace(const std::string& name, MemMap* mem_map)
       num_evac_regions_(0U),
       max_peak_num_non_free_regions_(0U),
       non_free_region_index_limit_(0U),
+      num_numa_nodes_(use_numa ? std::min(GetNumaNodeCount(), num_regions_) : 1U),
+      num_numa_node_regions_(RoundUp(num_regions_, num_numa_nodes_) / num_numa_nodes_),
+      use_huge_pages_(use_huge_pages),
       current_region_(&full_region_),
       evac_region_(nullptr) {
   CHECK_ALIGNED(mem_map->Size(), kRegionSize);
   CHECK_ALIGNED(mem_map->Begin(), kRegionSize);
   DCHECK_GT(num_regions_, 0U);
   regions_.reset(new Region[num_regions_]);
+  evac_candidates_.reserve(num_regions_);
   uint8_t* region_addr = mem_map->Begin();
   for (size_t i = 0; i < num_regions_; ++i, region_addr += kRegionSize) {
     regions_[i].Init(i, region_addr, region_addr + kRegionSize);
   }
   mark_bitmap_.reset(
       accounting::ContinuousSpaceBitmap::Create("region space live bitmap", Begin(), Capacity()));
+  if (use_huge_pages_) {
+    mem_map->MadviseHugePages();
+    mark_bitmap_->UseHugePages();
+  }
   if (kIsDebugBuild) {
     CHECK_EQ(regions_[0].Begin(), Begin());
     for (size_t i = 0; i < num_regions_; ++i) {
@@ -118,6 +177,72 @@ RegionSpace::RegionSpace(const std::string& name, MemMap* mem_map)
   DCHECK(full_region_.IsAllocated());
   size_t ignored;
   DCHECK(full_region_.Alloc(kAlignment, &ignored, nullptr, &ignored) == nullptr);
+  if (num_numa_nodes_ > 1) {
+    BindNumaNodeRegions();
+  }
+}
+
+void RegionSpace::BindNumaNodeRegions() {
+#if defined(__linux__)
+  for (size_t node = 0; node < num_numa_nodes_; ++node) {
+    uint8_t* begin = regions_[NumaNodeRegionBegin(node)].Begin();
+    size_t size = (NumaNodeRegionBegin(node + 1) - NumaNodeRegionBegin(node)) * kRegionSize;
+    if (size == 0) {
+      continue;
+    }
+    // Only prefer the node, rather than strictly bind to it, so that the regions of a node with
+    // no free memory left still get pages from the other nodes. The words of the node mask are
+    // unsigned longs, of the size of a pointer.
+    static constexpr size_t kBitsPerNodeMaskWord = sizeof(uintptr_t) * kBitsPerByte;
+    std::vector<uintptr_t> node_mask(RoundUp(num_numa_nodes_, kBitsPerNodeMaskWord) /
+                                     kBitsPerNodeMaskWord);
+    node_mask[node / kBitsPerNodeMaskWord] |=
+        static_cast<uintptr_t>(1) << (node % kBitsPerNodeMaskWord);
+    if (syscall(__NR_mbind,
+                begin,
+                size,
+                MPOL_PREFERRED,
+                node_mask.data(),
+                node_mask.size() * kBitsPerNodeMaskWord,
+                0) != 0) {
+      PLOG(WARNING) << "Failed to bind the regions of " << GetName() << " to NUMA node " << node;
+      num_numa_nodes_ = 1;
+      return;
+    }
+  }
+  VLOG(heap) << GetName() << " split across " << num_numa_nodes_ << " NUMA nodes";
+#else
+  num_numa_nodes_ = 1;
+#endif
+}
+
+bool RegionSpace::PinRegion(mirror::Object* ref) {
+  MutexLock mu(Thread::Current(), region_lock_);
+  Region* r = RefToRegionLocked(ref);
+  if (r->IsLarge()) {
+    return true;
+  }
+  if (r->IsNewlyAllocated()) {
+    return false;
+  }
+  DCHECK(r->IsAllocated());
+  ++r->pin_count_;
+  return true;
+}
+
+bool RegionSpace::UnpinRegion(mirror::Object* ref) {
+  MutexLock mu(Thread::Current(), region_lock_);
+  Region* r = RefToRegionLocked(ref);
+  if (r->IsLarge()) {
+    return true;
+  }
+  if (r->IsNewlyAllocated()) {
+    // Not evacuated while its critical section disabled the thread flips, and still new.
+    return false;
+  }
+  DCHECK(r->IsPinned());
+  --r->pin_count_;
+  return true;
 }
 
 size_t RegionSpace::FromSpaceSize() {
@@ -156,42 +281,85 @@ size_t RegionSpace::ToSpaceSize() {
   return num_regions * kRegionSize;
 }
 
-inline bool RegionSpace::Region::ShouldBeEvacuated() {
+inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
   DCHECK((IsAllocated() || IsLarge()) && IsInToSpace());
   // The region should be evacuated if:
+  // - the evacuation is forced (`evac_mode == EvacMode::kEvacModeForceAll`); or
   // - the region was allocated after the start of the previous GC (newly allocated region); or
-  // - the live ratio is below threshold (`kEvacuateLivePercentThreshold`).
+  // - the region was selected by SelectEvacuatedRegions for its live bytes, unless only the
+  //   newly allocated regions are evacuated (`evac_mode == EvacMode::kEvacModeNewlyAllocated`).
   bool result;
-  if (is_newly_allocated_) {
+  if (evac_mode == EvacMode::kEvacModeForceAll || is_newly_allocated_) {
     result = true;
+  } else if (evac_mode == EvacMode::kEvacModeNewlyAllocated) {
+    result = false;
+  } else if (IsLarge()) {
+    result = (live_bytes_ == 0U);
   } else {
-    bool is_live_percent_valid = (live_bytes_ != static_cast<size_t>(-1));
-    if (is_live_percent_valid) {
-      DCHECK(IsInToSpace());
-      DCHECK(!IsLargeTail());
-      DCHECK_NE(live_bytes_, static_cast<size_t>(-1));
-      DCHECK_LE(live_bytes_, BytesAllocated());
-      const size_t bytes_allocated = RoundUp(BytesAllocated(), kRegionSize);
-      DCHECK_LE(live_bytes_, bytes_allocated);
-      if (IsAllocated()) {
-        // Side node: live_percent == 0 does not necessarily mean
-        // there's no live objects due to rounding (there may be a
-        // few).
-        result = (live_bytes_ * 100U < kEvacuateLivePercentThreshold * bytes_allocated);
-      } else {
-        DCHECK(IsLarge());
-        result = (live_bytes_ == 0U);
-      }
-    } else {
-      result = false;
-    }
+    result = is_selected_for_evacuation_;
   }
+  is_selected_for_evacuation_ = false;
   return result;
 }
 
+bool RegionSpace::Region::IsEvacuationCandidate() const {
+  DCHECK(!IsFree() && IsInToSpace());
+  if (!IsAllocated() ||
+      is_newly_allocated_ ||
+      IsPinned() ||
+      live_bytes_ == static_cast<size_t>(-1)) {
+    return false;
+  }
+  DCHECK_LE(live_bytes_, BytesAllocated());
+  const size_t bytes_allocated = RoundUp(BytesAllocated(), kRegionSize);
+  DCHECK_LE(live_bytes_, bytes_allocated);
+  // Side node: live_percent == 0 does not necessarily mean
+  // there's no live objects due to rounding (there may be a
+  // few).
+  return live_bytes_ * 100U < kEvacuateLivePercentThreshold * bytes_allocated;
+}
+
+double RegionSpace::Region::EvacuationScore(uint32_t time) const {
+  DCHECK(IsEvacuationCandidate());
+  // The live bytes come from the marking of the previous cycle. The older the region, the
+  // more likely they are still live now and the more the holes are worth reclaiming, as the
+  // cost-benefit policy of log-structured file systems weighs its segments.
+  const size_t bytes_allocated = BytesAllocated();
+  const uint32_t age = std::max(time - alloc_time_, 1U);
+  return static_cast<double>(bytes_allocated - live_bytes_) * age /
+      static_cast<double>(bytes_allocated + live_bytes_);
+}
+
+void RegionSpace::SelectEvacuatedRegions(size_t iter_limit) {
+  DCHECK(evac_candidates_.empty());
+  for (size_t i = 0; i < iter_limit; ++i) {
+    Region* r = &regions_[i];
+    if (!r->IsFree() && r->IsEvacuationCandidate()) {
+      evac_candidates_.push_back(r);
+    }
+  }
+  const uint32_t time = time_;
+  std::sort(evac_candidates_.begin(),
+            evac_candidates_.end(),
+            [time](const Region* a, const Region* b) {
+              return a->EvacuationScore(time) > b->EvacuationScore(time);
+            });
+  size_t copy_budget = num_non_free_regions_ * kRegionSize / 100U * kEvacuateCopyBudgetPercent;
+  for (Region* r : evac_candidates_) {
+    // Skip the candidates which do not fit, a later one with fewer live bytes may.
+    if (r->LiveBytes() <= copy_budget) {
+      copy_budget -= r->LiveBytes();
+      r->is_selected_for_evacuation_ = true;
+    }
+  }
+  evac_candidates_.clear();
+}
+
 // Determine which regions to evacuate and mark them as
 // from-space. Mark the rest as unevacuated from-space.
-void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all) {
+void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
+                               EvacMode evac_mode,
+                               bool clear_live_bytes) {
   ++time_;
   if (kUseTableLookupReadBarrier) {
     DCHECK(rb_table->IsAllCleared());
@@ -207,6 +375,9 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool forc
   const size_t iter_limit = kUseTableLookupReadBarrier
       ? num_regions_
       : std::min(num_regions_, non_free_region_index_limit_);
+  if (evac_mode == EvacMode::kEvacModeLivePercentNewlyAllocated) {
+    SelectEvacuatedRegions(iter_limit);
+  }
   for (size_t i = 0; i < iter_limit; ++i) {
     Region* r = &regions_[i];
     RegionState state = r->State();
@@ -223,12 +394,13 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool forc
         //The logic in ClearFromSpace checks for live_bytes_ == 0,
         // to clear out any unevacFromSpaces with no live objects.
         //We expect the large objects to be cleared out that way during force_evacuate_all as well
-        bool should_evacuate = (force_evacuate_all || r->ShouldBeEvacuated()) && !r->IsLarge();
+        // The pinned regions are not evacuated either, their objects are used by native code.
+        bool should_evacuate = r->ShouldBeEvacuated(evac_mode) && !r->IsLarge() && !r->IsPinned();
         if (should_evacuate) {
           r->SetAsFromSpace();
           DCHECK(r->IsInFromSpace());
         } else {
-          r->SetAsUnevacFromSpace();
+          r->SetAsUnevacFromSpace(clear_live_bytes);
           DCHECK(r->IsInUnevacFromSpace());
         }
         if (UNLIKELY(state == RegionState::kRegionStateLarge &&
@@ -244,7 +416,7 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool forc
           r->SetAsFromSpace();
           DCHECK(r->IsInFromSpace());
         } else {
-          r->SetAsUnevacFromSpace();
+          r->SetAsUnevacFromSpace(clear_live_bytes);
           DCHECK(r->IsInUnevacFromSpace());
         }
         --num_expected_large_tails;
@@ -262,15 +434,24 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool forc
   evac_region_ = &full_region_;
 }
 
-static void ZeroAndProtectRegion(uint8_t* begin, uint8_t* end) {
-  ZeroAndReleasePages(begin, end - begin);
-  if (kProtectClearedRegions) {
+bool RegionSpace::ProtectClearedRegions() const {
+  return kProtectClearedRegions && !use_huge_pages_;
+}
+
+void RegionSpace::ZeroAndProtectRegions(uint8_t* begin, uint8_t* end) {
+  if (use_huge_pages_) {
+    ZeroAndReleaseHugePages(begin, end - begin);
+  } else {
+    ZeroAndReleasePages(begin, end - begin);
+  }
+  if (ProtectClearedRegions()) {
     CheckedCall(mprotect, __FUNCTION__, begin, end - begin, PROT_NONE);
   }
 }
 
 void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
-                                 /* out */ uint64_t* cleared_objects) {
+                                 /* out */ uint64_t* cleared_objects,
+                                 bool clear_bitmap) {
   DCHECK(cleared_bytes != nullptr);
   DCHECK(cleared_objects != nullptr);
   *cleared_bytes = 0;
@@ -298,13 +479,13 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
   // (see b/62194020).
   uint8_t* clear_block_begin = nullptr;
   uint8_t* clear_block_end = nullptr;
-  auto clear_region = [&clear_block_begin, &clear_block_end](Region* r) {
-    r->Clear(/*zero_and_release_pages*/false);
+  auto clear_region = [this, &clear_block_begin, &clear_block_end](Region* r) {
+    r->Clear();
     if (clear_block_end != r->Begin()) {
       // Region `r` is not adjacent to the current clear block; zero and release
       // pages within the current block and restart a new clear block at the
       // beginning of region `r`.
-      ZeroAndProtectRegion(clear_block_begin, clear_block_end);
+      ZeroAndProtectRegions(clear_block_begin, clear_block_end);
       clear_block_begin = r->Begin();
     }
     // Add region `r` to the clear block.
@@ -318,7 +499,14 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
       --num_non_free_regions_;
       clear_region(r);
     } else if (r->IsInUnevacFromSpace()) {
-      if (r->LiveBytes() == 0) {
+      // A young collection does not count the live bytes of the regions it does not evacuate,
+      // but it marks the large objects allocated since the previous collection it reaches; the
+      // older large objects were marked by earlier collections.
+      bool is_dead_large_object =
+          r->IsLarge() &&
+          r->LiveBytes() == static_cast<size_t>(-1) &&
+          !GetLiveBitmap()->Test(reinterpret_cast<mirror::Object*>(r->Begin()));
+      if (r->LiveBytes() == 0 || is_dead_large_object) {
         DCHECK(!r->IsLargeTail());
         // Special case for 0 live bytes, this means all of the objects in the region are dead and
         // we can clear it. This is important for large objects since we must not visit dead ones in
@@ -343,7 +531,7 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
         continue;
       }
       r->SetUnevacFromSpaceAsToSpace();
-      if (r->AllAllocatedBytesAreLive()) {
+      if (clear_bitmap && r->AllAllocatedBytesAreLive()) {
         // Try to optimize the number of ClearRange calls by checking whether the next regions
         // can also be cleared.
         size_t regions_to_clear_bitmap = 1;
@@ -385,7 +573,11 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
     }
   }
   // Clear pages for the last block since clearing happens when a new block opens.
-  ZeroAndReleasePages(clear_block_begin, clear_block_end - clear_block_begin);
+  if (use_huge_pages_) {
+    ZeroAndReleaseHugePages(clear_block_begin, clear_block_end - clear_block_begin);
+  } else {
+    ZeroAndReleasePages(clear_block_begin, clear_block_end - clear_block_begin);
+  }
   // Update non_free_region_index_limit_.
   SetNonFreeRegionLimit(new_non_free_region_index_limit);
   evac_region_ = nullptr;
@@ -440,8 +632,12 @@ void RegionSpace::Clear() {
     if (!r->IsFree()) {
       --num_non_free_regions_;
     }
-    r->Clear(/*zero_and_release_pages*/true);
+    r->Clear();
   }
+  ZeroAndProtectRegions(Begin(), Limit());
+  // The generational mode of the concurrent copying collector keeps the marks across
+  // collections; none of them is valid anymore.
+  GetLiveBitmap()->Clear();
   SetNonFreeRegionLimit(0);
   current_region_ = &full_region_;
   evac_region_ = &full_region_;
@@ -594,16 +790,14 @@ size_t RegionSpace::AllocationSizeNonvirtual(mirror::Object* obj, size_t* usable
   return num_bytes;
 }
 
-void RegionSpace::Region::Clear(bool zero_and_release_pages) {
+void RegionSpace::Region::Clear() {
+  DCHECK(!IsPinned());
   top_.StoreRelaxed(begin_);
   state_ = RegionState::kRegionStateFree;
   type_ = RegionType::kRegionTypeNone;
   objects_allocated_.StoreRelaxed(0);
   alloc_time_ = 0;
   live_bytes_ = static_cast<size_t>(-1);
-  if (zero_and_release_pages) {
-    ZeroAndProtectRegion(begin_, end_);
-  }
   is_newly_allocated_ = false;
   is_a_tlab_ = false;
   thread_ = nullptr;
@@ -613,7 +807,22 @@ RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
   if (!for_evac && (num_non_free_regions_ + 1) * 2 > num_regions_) {
     return nullptr;
   }
-  for (size_t i = 0; i < num_regions_; ++i) {
+  if (num_numa_nodes_ > 1) {
+    // Prefer a region of the NUMA node of the allocating thread: the owner of the new TLAB, or the
+    // GC thread copying objects.
+    size_t node = std::min(GetCurrentNumaNode(), num_numa_nodes_ - 1);
+    Region* r = AllocateRegionInRange(for_evac,
+                                      NumaNodeRegionBegin(node),
+                                      NumaNodeRegionBegin(node + 1));
+    if (r != nullptr) {
+      return r;
+    }
+  }
+  return AllocateRegionInRange(for_evac, 0, num_regions_);
+}
+
+RegionSpace::Region* RegionSpace::AllocateRegionInRange(bool for_evac, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
     Region* r = &regions_[i];
     if (r->IsFree()) {
       r->Unfree(this, time_);
@@ -635,7 +844,7 @@ void RegionSpace::Region::MarkAsAllocated(RegionSpace* region_space, uint32_t al
   alloc_time_ = alloc_time;
   region_space->AdjustNonFreeRegionLimit(idx_);
   type_ = RegionType::kRegionTypeToSpace;
-  if (kProtectClearedRegions) {
+  if (region_space->ProtectClearedRegions()) {
     CheckedCall(mprotect, __FUNCTION__, Begin(), kRegionSize, PROT_READ | PROT_WRITE);
   }
 }
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_GC_SPACE_REGION_SPACE_H_
 #define ART_RUNTIME_GC_SPACE_REGION_SPACE_H_
 
+#include <vector>
+
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "space.h"
@@ -42,9 +44,20 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
 
   // Create a region space mem map with the requested sizes. The requested base address is not
   // guaranteed to be granted, if it is required, the caller should call Begin on the returned
-  // space to confirm the request was granted.
-  static MemMap* CreateMemMap(const std::string& name, size_t capacity, uint8_t* requested_begin);
-  static RegionSpace* Create(const std::string& name, MemMap* mem_map);
+  // space to confirm the request was granted. With `use_huge_pages`, the map is aligned by the
+  // huge page size.
+  static MemMap* CreateMemMap(const std::string& name,
+                              size_t capacity,
+                              uint8_t* requested_begin,
+                              bool use_huge_pages = false);
+  // With `use_numa`, the regions are split in one contiguous range per NUMA node, bound to the
+  // node, and the regions of a thread (TLABs, evacuation) come from the range of its node first.
+  // With `use_huge_pages`, the space and its mark bitmap are backed with transparent huge pages,
+  // and clearing regions only releases whole huge pages, zeroing the rest in place.
+  static RegionSpace* Create(const std::string& name,
+                             MemMap* mem_map,
+                             bool use_numa = false,
+                             bool use_huge_pages = false);
 
   // Allocate `num_bytes`, returns null if the space is full.
   mirror::Object* Alloc(Thread* self,
@@ -137,6 +150,13 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     kRegionStateLargeTail,       // Large tail (non-first regions of a large allocation).
   };
 
+  // Which regions RegionSpace::SetFromSpace evacuates.
+  enum class EvacMode : uint8_t {
+    kEvacModeNewlyAllocated,             // Newly allocated regions (young collections).
+    kEvacModeLivePercentNewlyAllocated,  // Newly allocated regions and sparse regions.
+    kEvacModeForceAll,                   // All the regions but the large ones.
+  };
+
   template<RegionType kRegionType> uint64_t GetBytesAllocatedInternal() REQUIRES(!region_lock_);
   template<RegionType kRegionType> uint64_t GetObjectsAllocatedInternal() REQUIRES(!region_lock_);
   uint64_t GetBytesAllocated() REQUIRES(!region_lock_) {
@@ -249,14 +269,33 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
   }
 
   // Determine which regions to evacuate and tag them as
-  // from-space. Tag the rest as unevacuated from-space.
-  void SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all)
+  // from-space. Tag the rest as unevacuated from-space. If
+  // `clear_live_bytes` is false, the live bytes of the unevacuated
+  // regions are kept from the previous collection, which does not
+  // recompute them (young collections).
+  void SetFromSpace(accounting::ReadBarrierTable* rb_table,
+                    EvacMode evac_mode,
+                    bool clear_live_bytes)
       REQUIRES(!region_lock_);
 
+  // Pin the region of `ref` for a JNI critical section, so that the collections do not evacuate
+  // it. Returns false if the region cannot be pinned: it was allocated since the previous
+  // collection, and the young collections always evacuate these. The large objects are never
+  // evacuated, pinning them does nothing.
+  bool PinRegion(mirror::Object* ref) REQUIRES(!region_lock_);
+  // Unpin the region pinned by PinRegion. Returns false if PinRegion would not pin it, because
+  // the region could not be pinned.
+  bool UnpinRegion(mirror::Object* ref) REQUIRES(!region_lock_);
+
   size_t FromSpaceSize() REQUIRES(!region_lock_);
   size_t UnevacFromSpaceSize() REQUIRES(!region_lock_);
   size_t ToSpaceSize() REQUIRES(!region_lock_);
-  void ClearFromSpace(/* out */ uint64_t* cleared_bytes, /* out */ uint64_t* cleared_objects)
+  // Free the evacuated regions and the unevacuated regions without live objects. If
+  // `clear_bitmap` is false, the live bits of the remaining regions are kept, even where
+  // all the objects of a region are live (the generational mode relies on them).
+  void ClearFromSpace(/* out */ uint64_t* cleared_bytes,
+                      /* out */ uint64_t* cleared_objects,
+                      bool clear_bitmap)
       REQUIRES(!region_lock_);
 
   void AddLiveBytes(mirror::Object* ref, size_t alloc_size) {
@@ -264,6 +303,12 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     reg->AddLiveBytes(alloc_size);
   }
 
+  // Same as AddLiveBytes(), for the parallel marking threads of the concurrent copying collector.
+  void AtomicAddLiveBytes(mirror::Object* ref, size_t alloc_size) {
+    Region* reg = RefToRegionUnlocked(ref);
+    reg->AtomicAddLiveBytes(alloc_size);
+  }
+
   void AssertAllRegionLiveBytesZeroOrCleared() REQUIRES(!region_lock_) {
     if (kIsDebugBuild) {
       MutexLock mu(Thread::Current(), region_lock_);
@@ -283,7 +328,7 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
   }
 
  private:
-  RegionSpace(const std::string& name, MemMap* mem_map);
+  RegionSpace(const std::string& name, MemMap* mem_map, bool use_numa, bool use_huge_pages);
 
   template<bool kToSpaceOnly, typename Visitor>
   ALWAYS_INLINE void WalkInternal(Visitor&& visitor) NO_THREAD_SAFETY_ANALYSIS;
@@ -295,7 +340,8 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
           begin_(nullptr), top_(nullptr), end_(nullptr),
           state_(RegionState::kRegionStateAllocated), type_(RegionType::kRegionTypeToSpace),
           objects_allocated_(0), alloc_time_(0), live_bytes_(static_cast<size_t>(-1)),
-          is_newly_allocated_(false), is_a_tlab_(false), thread_(nullptr) {}
+          is_newly_allocated_(false), is_selected_for_evacuation_(false), is_a_tlab_(false),
+          thread_(nullptr), pin_count_(0u) {}
 
     void Init(size_t idx, uint8_t* begin, uint8_t* end) {
       idx_ = idx;
@@ -308,8 +354,10 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
       alloc_time_ = 0;
       live_bytes_ = static_cast<size_t>(-1);
       is_newly_allocated_ = false;
+      is_selected_for_evacuation_ = false;
       is_a_tlab_ = false;
       thread_ = nullptr;
+      pin_count_ = 0u;
       DCHECK_LT(begin, end);
       DCHECK_EQ(static_cast<size_t>(end - begin), kRegionSize);
     }
@@ -322,7 +370,8 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
       return type_;
     }
 
-    void Clear(bool zero_and_release_pages);
+    // Reset the region to free. The owning space zeroes and releases its pages.
+    void Clear();
 
     ALWAYS_INLINE mirror::Object* Alloc(size_t num_bytes,
                                         /* out */ size_t* bytes_allocated,
@@ -389,6 +438,11 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
       return is_newly_allocated_;
     }
 
+    // Whether the region is pinned by a JNI critical section, see RegionSpace::PinRegion.
+    bool IsPinned() const {
+      return pin_count_ != 0u;
+    }
+
     bool IsInFromSpace() const {
       return type_ == RegionType::kRegionTypeFromSpace;
     }
@@ -418,10 +472,12 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     // collection, RegionSpace::ClearFromSpace will preserve the space
     // used by this region, and tag it as to-space (see
     // Region::SetUnevacFromSpaceAsToSpace below).
-    void SetAsUnevacFromSpace() {
+    void SetAsUnevacFromSpace(bool clear_live_bytes) {
       DCHECK(!IsFree() && IsInToSpace());
       type_ = RegionType::kRegionTypeUnevacFromSpace;
-      live_bytes_ = 0U;
+      if (clear_live_bytes) {
+        live_bytes_ = 0U;
+      }
     }
 
     // Set this region as to-space. Used by RegionSpace::ClearFromSpace.
@@ -432,7 +488,15 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     }
 
     // Return whether this region should be evacuated. Used by RegionSpace::SetFromSpace.
-    ALWAYS_INLINE bool ShouldBeEvacuated();
+    ALWAYS_INLINE bool ShouldBeEvacuated(EvacMode evac_mode);
+
+    // Return whether this region may be evacuated for its live bytes, which are then
+    // weighed against those of the other candidates by RegionSpace::SelectEvacuatedRegions.
+    bool IsEvacuationCandidate() const;
+
+    // The benefit of evacuating this candidate region per byte copied: the bytes reclaimed,
+    // scaled by the age of the region, over the bytes read and copied.
+    double EvacuationScore(uint32_t time) const;
 
     void AddLiveBytes(size_t live_bytes) {
       DCHECK(IsInUnevacFromSpace());
@@ -444,6 +508,14 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
       DCHECK_LE(live_bytes_, BytesAllocated());
     }
 
+    void AtomicAddLiveBytes(size_t live_bytes) {
+      DCHECK(IsInUnevacFromSpace());
+      DCHECK(!IsLargeTail());
+      DCHECK_NE(live_bytes_, static_cast<size_t>(-1));
+      reinterpret_cast<Atomic<size_t>*>(&live_bytes_)->FetchAndAddSequentiallyConsistent(
+          IsLarge() ? Top() - begin_ : live_bytes);
+    }
+
     bool AllAllocatedBytesAreLive() const {
       return LiveBytes() == static_cast<size_t>(Top() - Begin());
     }
@@ -503,8 +575,10 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     // special value for `live_bytes_`.
     size_t live_bytes_;                 // The live bytes. Used to compute the live percent.
     bool is_newly_allocated_;           // True if it's allocated after the last collection.
+    bool is_selected_for_evacuation_;   // True if selected by SelectEvacuatedRegions.
     bool is_a_tlab_;                    // True if it's a tlab.
     Thread* thread_;                    // The owning thread if it's a tlab.
+    size_t pin_count_;                  // The number of JNI critical sections pinning it.
 
     friend class RegionSpace;
   };
@@ -569,7 +643,25 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     }
   }
 
+  // Select, among the evacuation candidates of the regions [0, iter_limit), those with the
+  // best evacuation score until their live bytes fill the copy budget of the collection.
+  void SelectEvacuatedRegions(size_t iter_limit) REQUIRES(region_lock_);
+
   Region* AllocateRegion(bool for_evac) REQUIRES(region_lock_);
+  // Allocate a free region of the indices [begin, end).
+  Region* AllocateRegionInRange(bool for_evac, size_t begin, size_t end) REQUIRES(region_lock_);
+
+  // Bind the region range of each NUMA node to the node.
+  void BindNumaNodeRegions();
+
+  // Whether cleared regions are protected. Not with huge pages, which mprotect would split.
+  bool ProtectClearedRegions() const;
+  // Zero and release the pages of the cleared regions [begin, end), then protect them.
+  void ZeroAndProtectRegions(uint8_t* begin, uint8_t* end);
+  // The index of the first region of the range of NUMA node `node`.
+  size_t NumaNodeRegionBegin(size_t node) const {
+    return std::min(node * num_numa_node_regions_, num_regions_);
+  }
 
   Mutex region_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
@@ -589,6 +681,10 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
   // The pointer to the region array.
   std::unique_ptr<Region[]> regions_ GUARDED_BY(region_lock_);
 
+  // The evacuation candidates sorted by SelectEvacuatedRegions, reserved up front so that
+  // the pause does not allocate.
+  std::vector<Region*> evac_candidates_ GUARDED_BY(region_lock_);
+
   // The upper-bound index of the non-free regions. Used to avoid scanning all regions in
   // RegionSpace::SetFromSpace and RegionSpace::ClearFromSpace.
   //
@@ -596,6 +692,14 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
   //   for all `i >= non_free_region_index_limit_`, `regions_[i].IsFree()` is true.
   size_t non_free_region_index_limit_ GUARDED_BY(region_lock_);
 
+  // The number of NUMA nodes the regions are split across, 1 without the NUMA mode, and the
+  // number of regions per node.
+  size_t num_numa_nodes_;
+  size_t num_numa_node_regions_;
+
+  // Whether the space is backed with transparent huge pages.
+  const bool use_huge_pages_;
+
   Region* current_region_;         // The region currently used for allocation.
   Region* evac_region_;            // The region currently used for evacuation.
   Region full_region_;             // The dummy/sentinel region that looks full.
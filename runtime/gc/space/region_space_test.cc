@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "region_space-inl.h"
+
+#include <memory>
+#include <vector>
+
+#include "common_runtime_test.h"
+#include "gc/heap.h"
+#include "thread-current-inl.h"
+#include "thread_pool.h"
+
+namespace art {
+namespace gc {
+namespace space {
+
+class RegionSpaceTest : public CommonRuntimeTest {
+ public:
+  static constexpr size_t kCapacity = 128 * RegionSpace::kRegionSize;
+  static constexpr size_t kNumRegions = kCapacity / RegionSpace::kRegionSize;
+
+  static RegionSpace* CreateRegionSpace(bool use_numa) {
+    MemMap* mem_map = RegionSpace::CreateMemMap("region space", kCapacity, nullptr);
+    CHECK(mem_map != nullptr);
+    return RegionSpace::Create("region space", mem_map, use_numa);
+  }
+
+  // Allocates objects of a whole region until the space refuses, and returns their count.
+  static size_t AllocateRegions(RegionSpace* space) {
+    size_t count = 0;
+    size_t bytes_allocated;
+    size_t usable_size;
+    size_t bytes_tl_bulk_allocated;
+    while (space->AllocNonvirtual<false>(RegionSpace::kRegionSize,
+                                         &bytes_allocated,
+                                         &usable_size,
+                                         &bytes_tl_bulk_allocated) != nullptr) {
+      EXPECT_EQ(RegionSpace::kRegionSize, bytes_allocated);
+      ++count;
+    }
+    return count;
+  }
+};
+
+// Allocates small objects and a TLAB from a thread pool worker, filling them with the id of the
+// task so that RegionSpaceTest can check that no two threads were handed the same memory.
+class RegionAllocTask : public Task {
+ public:
+  static constexpr size_t kNumObjects = 64;
+  static constexpr size_t kObjectSize = 16 * KB;
+
+  RegionAllocTask(uint8_t id, RegionSpace* space, std::vector<uint8_t*>* objects)
+      : id_(id), space_(space), objects_(objects) {}
+
+  void Run(Thread* self) OVERRIDE {
+    for (size_t i = 0; i < kNumObjects; ++i) {
+      size_t bytes_allocated;
+      size_t usable_size;
+      size_t bytes_tl_bulk_allocated;
+      uint8_t* obj = reinterpret_cast<uint8_t*>(space_->Alloc(self,
+                                                              kObjectSize,
+                                                              &bytes_allocated,
+                                                              &usable_size,
+                                                              &bytes_tl_bulk_allocated));
+      CHECK(obj != nullptr);
+      memset(obj, id_, kObjectSize);
+      objects_->push_back(obj);
+    }
+    CHECK(space_->AllocNewTlab(self, kObjectSize));
+    CHECK(space_->HasAddress(reinterpret_cast<mirror::Object*>(self->GetTlabStart())));
+    // The TLAB is a whole region.
+    CHECK_ALIGNED(self->GetTlabStart(), RegionSpace::kRegionSize);
+    memset(self->GetTlabStart(), id_, RegionSpace::kRegionSize);
+    objects_->push_back(self->GetTlabStart());
+    space_->RevokeThreadLocalBuffers(self);
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  const uint8_t id_;
+  RegionSpace* const space_;
+  std::vector<uint8_t*>* const objects_;
+};
+
+// The NUMA mode only changes the order in which the free regions are handed out: each NUMA node
+// range comes first for its threads, and all the regions are still available to every thread.
+TEST_F(RegionSpaceTest, NumaModeAllocatesAllRegions) {
+  for (bool use_numa : { false, true }) {
+    std::unique_ptr<RegionSpace> space(CreateRegionSpace(use_numa));
+    // The space keeps half of its regions for the evacuation.
+    EXPECT_EQ(kNumRegions / 2, AllocateRegions(space.get())) << "use_numa=" << use_numa;
+  }
+}
+
+TEST_F(RegionSpaceTest, NumaModeConcurrentAllocations) {
+  static constexpr size_t kNumThreads = 4;
+  std::unique_ptr<RegionSpace> space(CreateRegionSpace(/* use_numa */ true));
+  std::vector<uint8_t*> objects[kNumThreads];
+  Thread* self = Thread::Current();
+  ThreadPool thread_pool("Region space test thread pool", kNumThreads);
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    thread_pool.AddTask(self, new RegionAllocTask(static_cast<uint8_t>(i + 1u),
+                                                  space.get(),
+                                                  &objects[i]));
+  }
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, /* do_work */ true, /* may_hold_locks */ false);
+
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    ASSERT_EQ(RegionAllocTask::kNumObjects + 1u, objects[i].size());
+    for (size_t j = 0; j < objects[i].size(); ++j) {
+      uint8_t* obj = objects[i][j];
+      EXPECT_TRUE(space->HasAddress(reinterpret_cast<mirror::Object*>(obj)));
+      size_t size = (j == RegionAllocTask::kNumObjects)
+          ? RegionSpace::kRegionSize
+          : RegionAllocTask::kObjectSize;
+      for (size_t k = 0; k < size; ++k) {
+        ASSERT_EQ(static_cast<uint8_t>(i + 1u), obj[k]) << "thread " << i << " object " << j;
+      }
+    }
+  }
+}
+
+// A pinned region stays in place through the collections, as unevacuated from-space, while the
+// regions allocated since the previous collection cannot be pinned.
+TEST_F(RegionSpaceTest, PinnedRegionIsNotEvacuated) {
+  std::unique_ptr<RegionSpace> space(CreateRegionSpace(/* use_numa */ false));
+  accounting::ReadBarrierTable* rb_table = Runtime::Current()->GetHeap()->GetReadBarrierTable();
+  size_t bytes_allocated;
+  size_t usable_size;
+  size_t bytes_tl_bulk_allocated;
+  uint64_t cleared_bytes;
+  uint64_t cleared_objects;
+  // Copy two objects, in two regions, during a collection so that their regions are older than
+  // the next one.
+  space->SetFromSpace(rb_table, RegionSpace::EvacMode::kEvacModeForceAll, true);
+  mirror::Object* pinned = space->AllocNonvirtual<true>(RegionSpace::kAlignment,
+                                                        &bytes_allocated,
+                                                        &usable_size,
+                                                        &bytes_tl_bulk_allocated);
+  mirror::Object* unpinned = space->AllocNonvirtual<true>(RegionSpace::kRegionSize,
+                                                          &bytes_allocated,
+                                                          &usable_size,
+                                                          &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(pinned != nullptr);
+  ASSERT_TRUE(unpinned != nullptr);
+  space->ClearFromSpace(&cleared_bytes, &cleared_objects, /* clear_bitmap */ true);
+  EXPECT_EQ(0u, cleared_objects);
+
+  mirror::Object* young = space->AllocNonvirtual<false>(RegionSpace::kAlignment,
+                                                        &bytes_allocated,
+                                                        &usable_size,
+                                                        &bytes_tl_bulk_allocated);
+  mirror::Object* large = space->AllocNonvirtual<false>(2 * RegionSpace::kRegionSize,
+                                                        &bytes_allocated,
+                                                        &usable_size,
+                                                        &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(young != nullptr);
+  ASSERT_TRUE(large != nullptr);
+  EXPECT_TRUE(space->PinRegion(pinned));
+  EXPECT_FALSE(space->PinRegion(young));
+  // The large objects are never evacuated, there is nothing to pin.
+  EXPECT_TRUE(space->PinRegion(large));
+
+  space->SetFromSpace(rb_table, RegionSpace::EvacMode::kEvacModeForceAll, true);
+  EXPECT_TRUE(space->IsInUnevacFromSpace(pinned));
+  EXPECT_TRUE(space->IsInFromSpace(unpinned));
+  EXPECT_TRUE(space->IsInFromSpace(young));
+  EXPECT_TRUE(space->IsInUnevacFromSpace(large));
+
+  EXPECT_TRUE(space->UnpinRegion(pinned));
+  EXPECT_FALSE(space->UnpinRegion(young));
+  EXPECT_TRUE(space->UnpinRegion(large));
+}
+
+}  // namespace space
+}  // namespace gc
+}  // namespace art
@@ -70,6 +70,16 @@ inline mirror::Object* RosAllocSpace::AllocThreadLocal(Thread* self, size_t num_
       rosalloc_->AllocFromThreadLocalRun(self, num_bytes, bytes_allocated));
 }
 
+inline size_t RosAllocSpace::AllocThreadLocal(Thread* self,
+                                              size_t num_bytes,
+                                              size_t count,
+                                              mirror::Object** objects,
+                                              size_t* bytes_allocated) {
+  DCHECK(bytes_allocated != nullptr);
+  return rosalloc_->AllocFromThreadLocalRun(
+      self, num_bytes, count, reinterpret_cast<void**>(objects), bytes_allocated);
+}
+
 inline bool RosAllocSpace::FreeThreadLocal(Thread* self, size_t num_bytes,
                                                       mirror::Object* obj) {
   DCHECK_GT(num_bytes, 0u);
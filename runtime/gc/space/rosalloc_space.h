@@ -94,6 +94,13 @@ class RosAllocSpace : public MallocSpace {
   // run without allocating a new run.
   ALWAYS_INLINE mirror::Object* AllocThreadLocal(Thread* self, size_t num_bytes,
                                                  size_t* bytes_allocated);
+  // Allocate up to `count` objects of the given size in an existing thread local run, without
+  // allocating a new run. Returns the number of objects stored in `objects`.
+  ALWAYS_INLINE size_t AllocThreadLocal(Thread* self,
+                                        size_t num_bytes,
+                                        size_t count,
+                                        /*out*/ mirror::Object** objects,
+                                        /*out*/ size_t* bytes_allocated);
   // Free one object slot in an existing thread local run.
   // Used for Parallel Copy in GSS
   ALWAYS_INLINE bool FreeThreadLocal(Thread* self, size_t num_bytes,
@@ -204,9 +204,6 @@ Action GetMemberActionImpl(T* member,
                            AccessMethod access_method) {
   DCHECK_NE(action, kAllow);
 
-  // Get the signature, we need it later.
-  MemberSignature member_signature(member);
-
   Runtime* runtime = Runtime::Current();
 
   // Check for an exemption first. Exempted APIs are treated as white list.
@@ -216,29 +213,42 @@ Action GetMemberActionImpl(T* member,
   // - we want to avoid the overhead of checking for exemptions for light greylisted APIs whenever
   //   possible.
   const bool shouldWarn = kLogAllAccesses || runtime->IsJavaDebuggable();
-  if (shouldWarn || action == kDeny) {
-    if (member_signature.IsExempted(runtime->GetHiddenApiExemptions())) {
-      action = kAllow;
-      // Avoid re-examining the exemption list next time.
-      // Note this results in no warning for the member, which seems like what one would expect.
-      // Exemptions effectively adds new members to the whitelist.
-      MaybeWhitelistMember(runtime, member);
-      return kAllow;
-    }
-
-    if (access_method != kNone) {
-      // Print a log message with information about this class member access.
-      // We do this if we're about to block access, or the app is debuggable.
-      member_signature.WarnAboutAccess(access_method, api_list);
-    }
-  }
+  const bool shouldCheckExemptions = shouldWarn || action == kDeny;
 
-  if (kIsTargetBuild) {
+  // The event log ignores linking and internal queries, see LogAccessToEventLog.
+  bool shouldLogToEventLog = false;
+  if (kIsTargetBuild && access_method != kLinking && access_method != kNone) {
     uint32_t eventLogSampleRate = runtime->GetHiddenApiEventLogSampleRate();
     // Assert that RAND_MAX is big enough, to ensure sampling below works as expected.
     static_assert(RAND_MAX >= 0xffff, "RAND_MAX too small");
-    if (eventLogSampleRate != 0 &&
-        (static_cast<uint32_t>(std::rand()) & 0xffff) < eventLogSampleRate) {
+    shouldLogToEventLog = eventLogSampleRate != 0 &&
+        (static_cast<uint32_t>(std::rand()) & 0xffff) < eventLogSampleRate;
+  }
+
+  if (shouldCheckExemptions || shouldLogToEventLog) {
+    // Building the signature allocates, so only do it when something reads it. This matters for
+    // discoverability queries of light greylisted members by non-debuggable apps, e.g. from
+    // Class.getDeclaredMethods(), which never whitelist the member and are repeated on every call.
+    MemberSignature member_signature(member);
+
+    if (shouldCheckExemptions) {
+      if (member_signature.IsExempted(runtime->GetHiddenApiExemptions())) {
+        action = kAllow;
+        // Avoid re-examining the exemption list next time.
+        // Note this results in no warning for the member, which seems like what one would expect.
+        // Exemptions effectively adds new members to the whitelist.
+        MaybeWhitelistMember(runtime, member);
+        return kAllow;
+      }
+
+      if (access_method != kNone) {
+        // Print a log message with information about this class member access.
+        // We do this if we're about to block access, or the app is debuggable.
+        member_signature.WarnAboutAccess(access_method, api_list);
+      }
+    }
+
+    if (shouldLogToEventLog) {
       member_signature.LogAccessToEventLog(access_method, action);
     }
   }
@@ -210,7 +210,7 @@ inline Action GetMemberAction(T* member,
   // results, e.g. print whitelist warnings (b/78327881).
   HiddenApiAccessFlags::ApiList api_list = member->GetHiddenApiAccessFlags();
 
-  Action action = GetActionFromAccessFlags(member->GetHiddenApiAccessFlags());
+  Action action = GetActionFromAccessFlags(api_list);
   if (action == kAllow) {
     // Nothing to do.
     return action;
@@ -31,13 +31,16 @@
 #include <string.h>
 #include <sys/time.h>
 #include <sys/uio.h>
+#include <sys/wait.h>
 #include <time.h>
 #include <unistd.h>
+#include <zlib.h>
 
 #include <set>
 
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
+#include <android-base/strings.h>
 
 #include "art_field-inl.h"
 #include "art_method-inl.h"
@@ -78,6 +81,9 @@ static constexpr uint32_t kHprofTime = 0;
 static constexpr uint32_t kHprofNullThread = 0;
 
 static constexpr size_t kMaxObjectsPerSegment = 128;
+
+// The size of the writes of the records to a file, after compression if any.
+static constexpr size_t kFileWriteSize = 1 * MB;
 static constexpr size_t kMaxBytesPerSegment = 4096;
 
 // The static field-name for the synthetic object generated to account for class static overhead.
@@ -388,13 +394,42 @@ class EndianOutputBuffered : public EndianOutput {
   std::vector<uint8_t> buffer_;
 };
 
+// Streams the records to a file, in writes of kFileWriteSize bytes, optionally through gzip.
 class FileEndianOutput FINAL : public EndianOutputBuffered {
  public:
-  FileEndianOutput(File* fp, size_t reserved_size)
-      : EndianOutputBuffered(reserved_size), fp_(fp), errors_(false) {
+  FileEndianOutput(File* fp, size_t reserved_size, bool compress)
+      : EndianOutputBuffered(reserved_size),
+        fp_(fp),
+        compress_(compress),
+        errors_(false),
+        write_buffer_(new uint8_t[kFileWriteSize]),
+        write_buffer_size_(0u) {
     DCHECK(fp != nullptr);
+    if (compress_) {
+      memset(&zstream_, 0, sizeof(zstream_));
+      // Ask for a gzip wrapper with 16 + MAX_WBITS. The fastest level is enough for the heap
+      // dumps, which are dominated by object ids and zeroed out fields.
+      errors_ = deflateInit2(&zstream_,
+                             Z_BEST_SPEED,
+                             Z_DEFLATED,
+                             16 + MAX_WBITS,
+                             /* memLevel */ 8,
+                             Z_DEFAULT_STRATEGY) != Z_OK;
+    }
   }
   ~FileEndianOutput() {
+    if (compress_) {
+      deflateEnd(&zstream_);
+    }
+  }
+
+  // Writes out the buffered data. Returns whether all the writes succeeded.
+  bool Finish() {
+    if (compress_) {
+      Deflate(nullptr, 0u, Z_FINISH);
+    }
+    WriteBuffer();
+    return !errors_;
   }
 
   bool Errors() {
@@ -403,14 +438,59 @@ class FileEndianOutput FINAL : public EndianOutputBuffered {
 
  protected:
   void HandleFlush(const uint8_t* buffer, size_t length) OVERRIDE {
+    if (compress_) {
+      Deflate(buffer, length, Z_NO_FLUSH);
+    } else if (length >= kFileWriteSize) {
+      WriteBuffer();
+      Write(buffer, length);
+    } else {
+      if (write_buffer_size_ + length > kFileWriteSize) {
+        WriteBuffer();
+      }
+      memcpy(write_buffer_.get() + write_buffer_size_, buffer, length);
+      write_buffer_size_ += length;
+    }
+  }
+
+ private:
+  void Write(const uint8_t* buffer, size_t length) {
     if (!errors_) {
       errors_ = !fp_->WriteFully(buffer, length);
     }
   }
 
- private:
+  void WriteBuffer() {
+    Write(write_buffer_.get(), write_buffer_size_);
+    write_buffer_size_ = 0u;
+  }
+
+  // Compresses the data into the write buffer, writing out the buffer whenever it is full.
+  void Deflate(const uint8_t* buffer, size_t length, int flush) {
+    zstream_.next_in = const_cast<Bytef*>(buffer);
+    zstream_.avail_in = length;
+    int result;
+    do {
+      if (errors_) {
+        return;
+      }
+      if (write_buffer_size_ == kFileWriteSize) {
+        WriteBuffer();
+      }
+      zstream_.next_out = write_buffer_.get() + write_buffer_size_;
+      zstream_.avail_out = kFileWriteSize - write_buffer_size_;
+      result = deflate(&zstream_, flush);
+      write_buffer_size_ = kFileWriteSize - zstream_.avail_out;
+      errors_ = (result == Z_STREAM_ERROR);
+    } while ((flush == Z_FINISH) ? (result != Z_STREAM_END)
+                                 : (zstream_.avail_in != 0u || zstream_.avail_out == 0u));
+  }
+
   File* fp_;
+  const bool compress_;
   bool errors_;
+  std::unique_ptr<uint8_t[]> write_buffer_;
+  size_t write_buffer_size_;
+  z_stream zstream_;
 };
 
 class VectorEndianOuputput FINAL : public EndianOutputBuffered {
@@ -434,14 +514,16 @@ class VectorEndianOuputput FINAL : public EndianOutputBuffered {
 
 class Hprof : public SingleRootVisitor {
  public:
-  Hprof(const char* output_filename, int fd, bool direct_to_ddms)
+  Hprof(const char* output_filename, int fd, bool direct_to_ddms, bool compress)
       : filename_(output_filename),
         fd_(fd),
-        direct_to_ddms_(direct_to_ddms) {
+        direct_to_ddms_(direct_to_ddms),
+        compress_(compress) {
     LOG(INFO) << "hprof: heap dump \"" << filename_ << "\" starting...";
   }
 
-  void Dump()
+  // Returns whether the dump was written.
+  bool Dump()
     REQUIRES(Locks::mutator_lock_)
     REQUIRES(!Locks::heap_bitmap_lock_, !Locks::alloc_tracker_lock_) {
     {
@@ -482,6 +564,7 @@ class Hprof : public SingleRootVisitor {
                 << " objects " << total_objects_
                 << " objects with stack traces " << total_objects_with_stack_trace_;
     }
+    return okay;
   }
 
  private:
@@ -778,10 +861,10 @@ class Hprof : public SingleRootVisitor {
     std::unique_ptr<File> file(new File(out_fd, filename_, true));
     bool okay;
     {
-      FileEndianOutput file_output(file.get(), max_length);
+      FileEndianOutput file_output(file.get(), max_length, compress_);
       output_ = &file_output;
       ProcessHeap(true);
-      okay = !file_output.Errors();
+      okay = file_output.Finish();
 
       if (okay) {
         // Check for expected size. Output is expected to be less-or-equal than first phase, see
@@ -811,7 +894,10 @@ class Hprof : public SingleRootVisitor {
       REQUIRES(Locks::mutator_lock_) {
     CHECK(direct_to_ddms_);
 
+    // The counting pass gave an upper bound of the size, see DumpToFile. Reserve it so that the
+    // dump is not copied as the vector grows.
     std::vector<uint8_t> out_data;
+    out_data.reserve(overall_size);
 
     // TODO It would be really good to have some streaming thing again. b/73084059
     VectorEndianOuputput output(out_data, max_length);
@@ -876,6 +962,8 @@ class Hprof : public SingleRootVisitor {
   std::string filename_;
   int fd_;
   bool direct_to_ddms_;
+  // Whether the file output is compressed with gzip.
+  bool compress_;
 
   uint64_t start_ns_ = NanoTime();
 
@@ -1598,17 +1686,47 @@ void Hprof::VisitRoot(mirror::Object* obj, const RootInfo& info) {
 // sent directly to DDMS.
 // If "fd" is >= 0, the output will be written to that file descriptor.
 // Otherwise, "filename" is used to create an output file.
+// The file output is compressed with gzip if "filename" ends with ".gz". With
+// -XX:HprofForkDump:true, it is written by a forked child process from its
+// copy of the heap, so that the other threads resume as soon as it is forked.
 void DumpHeap(const char* filename, int fd, bool direct_to_ddms) {
   CHECK(filename != nullptr);
   Thread* self = Thread::Current();
-  // Need to take a heap dump while GC isn't running. See the comment in Heap::VisitObjects().
-  // Also we need the critical section to avoid visiting the same object twice. See b/34967844
-  gc::ScopedGCCriticalSection gcs(self,
-                                  gc::kGcCauseHprof,
-                                  gc::kCollectorTypeHprof);
-  ScopedSuspendAll ssa(__FUNCTION__, true /* long suspend */);
-  Hprof hprof(filename, fd, direct_to_ddms);
-  hprof.Dump();
+  const bool compress = !direct_to_ddms && android::base::EndsWith(filename, ".gz");
+  const bool fork_dump = !direct_to_ddms && Runtime::Current()->GetHprofForkDump();
+  pid_t pid = -1;
+  {
+    // Need to take a heap dump while GC isn't running. See the comment in Heap::VisitObjects().
+    // Also we need the critical section to avoid visiting the same object twice. See b/34967844
+    gc::ScopedGCCriticalSection gcs(self,
+                                    gc::kGcCauseHprof,
+                                    gc::kCollectorTypeHprof);
+    ScopedSuspendAll ssa(__FUNCTION__, true /* long suspend */);
+    if (fork_dump) {
+      // The child only has this thread, and finds the heap as the suspended threads left it.
+      pid = fork();
+      if (pid < 0) {
+        PLOG(WARNING) << "hprof: fork failed, dumping the heap in process";
+      }
+    }
+    if (pid <= 0) {
+      Hprof hprof(filename, fd, direct_to_ddms, compress);
+      bool okay = hprof.Dump();
+      if (pid == 0) {
+        _exit(okay ? 0 : 1);
+      }
+    }
+  }
+  if (pid > 0) {
+    // The other threads run again, only this one waits for the dump to be written.
+    int status;
+    if (TEMP_FAILURE_RETRY(waitpid(pid, &status, 0)) != pid ||
+        !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0) {
+      ScopedObjectAccess soa(self);
+      ThrowRuntimeException("Couldn't dump heap; the dump process %d failed", pid);
+    }
+  }
 }
 
 }  // namespace hprof
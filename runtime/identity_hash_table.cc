@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "identity_hash_table.h"
+
+#include "gc_root-inl.h"
+#include "mirror/object-inl.h"
+#include "monitor.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+IdentityHashTable::IdentityHashTable()
+    : gc::SystemWeakHolder(kIdentityHashTableLock),
+      size_(0u),
+      updated_since_last_sweep_(false),
+      filter_sequence_(0u) {
+  for (std::atomic<uint64_t>& word : filter_) {
+    word.store(0u, std::memory_order_relaxed);
+  }
+}
+
+bool IdentityHashTable::FilterMayHave(Thread* self, ObjPtr<mirror::Object> obj) const {
+  if (kUseReadBarrier && self != nullptr && self->GetIsGcMarking()) {
+    return true;
+  }
+  uint32_t sequence = filter_sequence_.load(std::memory_order_acquire);
+  if ((sequence & 1u) != 0u) {
+    return true;
+  }
+  size_t bit = FilterBit(obj.Ptr());
+  uint64_t word = filter_[bit / 64].load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (filter_sequence_.load(std::memory_order_relaxed) != sequence) {
+    return true;
+  }
+  return (word & (UINT64_C(1) << (bit % 64))) != 0u;
+}
+
+int32_t IdentityHashTable::GetOrAddForThinLocked(Thread* self, ObjPtr<mirror::Object> obj) {
+  MutexLock mu(self, allow_disallow_lock_);
+  Wait(self);
+  auto it = Find(self, obj);
+  if (it != table_.end()) {
+    return it->second;
+  }
+  int32_t hash_code = static_cast<int32_t>(mirror::Object::GenerateIdentityHashCode());
+  AddToFilter(obj.Ptr());
+  it = table_.emplace(GcRoot<mirror::Object>(obj), hash_code).first;
+  size_.StoreSequentiallyConsistent(table_.size());
+  // Check the lock word after publishing the size, see MayHaveEntryFor. If the object is still thin
+  // locked, it has no hash code elsewhere, and the threads that see it unlocked or inflated later
+  // will see the entry.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (obj->GetLockWord(false).GetState() == LockWord::kThinLocked) {
+    return hash_code;
+  }
+  // The object was unlocked or inflated, and may have been hashed since.
+  Erase(it);
+  return 0;
+}
+
+bool IdentityHashTable::PublishToLockWord(Thread* self,
+                                          ObjPtr<mirror::Object> obj,
+                                          LockWord lock_word,
+                                          /* out */ int32_t* hash_code) {
+  MutexLock mu(self, allow_disallow_lock_);
+  Wait(self);
+  auto it = Find(self, obj);
+  int32_t new_hash_code = (it != table_.end())
+      ? it->second
+      : static_cast<int32_t>(mirror::Object::GenerateIdentityHashCode());
+  LockWord hash_word = LockWord::FromHashCode(new_hash_code, lock_word.GCState());
+  DCHECK_EQ(hash_word.GetState(), LockWord::kHashCode);
+  if (!obj->CasLockWordWeakRelaxed(lock_word, hash_word)) {
+    return false;
+  }
+  if (it != table_.end()) {
+    Erase(it);
+  }
+  *hash_code = new_hash_code;
+  return true;
+}
+
+void IdentityHashTable::PublishToMonitor(Thread* self, Monitor* monitor) {
+  MutexLock mu(self, allow_disallow_lock_);
+  Wait(self);
+  if (monitor->HasHashCode()) {
+    return;
+  }
+  auto it = Find(self, monitor->GetObject());
+  int32_t hash_code = (it != table_.end())
+      ? it->second
+      : static_cast<int32_t>(mirror::Object::GenerateIdentityHashCode());
+  if (monitor->hash_code_.CompareAndSetStrongRelaxed(0, hash_code) && it != table_.end()) {
+    Erase(it);
+  }
+}
+
+int32_t IdentityHashTable::Lookup(Thread* self, ObjPtr<mirror::Object> obj) {
+  MutexLock mu(self, allow_disallow_lock_);
+  Wait(self);
+  auto it = Find(self, obj);
+  return (it != table_.end()) ? it->second : 0;
+}
+
+size_t IdentityHashTable::Size() {
+  MutexLock mu(Thread::Current(), allow_disallow_lock_);
+  return table_.size();
+}
+
+void IdentityHashTable::Sweep(IsMarkedVisitor* visitor) {
+  MutexLock mu(Thread::Current(), allow_disallow_lock_);
+  // The keys change, rebuild the filter. The lock-free readers take the lock meanwhile.
+  filter_sequence_.fetch_add(1u, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (std::atomic<uint64_t>& word : filter_) {
+    word.store(0u, std::memory_order_relaxed);
+  }
+  Table swept;
+  for (const auto& entry : table_) {
+    mirror::Object* new_obj = visitor->IsMarked(entry.first.Read<kWithoutReadBarrier>());
+    if (new_obj == nullptr) {
+      continue;
+    }
+    // Move the hash codes of the objects that are not thin locked anymore to their lock words or
+    // monitors, so that the table does not outgrow the objects that are still thin locked.
+    LockWord lock_word = new_obj->GetLockWord(false);
+    if (lock_word.GetState() == LockWord::kUnlocked) {
+      LockWord hash_word = LockWord::FromHashCode(entry.second, lock_word.GCState());
+      if (new_obj->CasLockWordWeakRelaxed(lock_word, hash_word)) {
+        continue;
+      }
+    } else if (lock_word.GetState() == LockWord::kFatLocked) {
+      Monitor* monitor = lock_word.FatLockMonitor();
+      if (monitor->hash_code_.CompareAndSetStrongRelaxed(0, entry.second)) {
+        continue;
+      }
+    }
+    // Still thin locked, or the lock word changed meanwhile. Keep it for the next sweep.
+    AddToFilter(new_obj);
+    swept.emplace(GcRoot<mirror::Object>(new_obj), entry.second);
+  }
+  table_.swap(swept);
+  size_.StoreSequentiallyConsistent(table_.size());
+  updated_since_last_sweep_ = false;
+  filter_sequence_.fetch_add(1u, std::memory_order_release);
+}
+
+IdentityHashTable::Table::iterator IdentityHashTable::Find(Thread* self,
+                                                           ObjPtr<mirror::Object> obj) {
+  auto it = table_.find(GcRoot<mirror::Object>(obj));
+  if (kUseReadBarrier &&
+      it == table_.end() &&
+      self->GetIsGcMarking() &&
+      !updated_since_last_sweep_) {
+    // Between the flip and the sweep, the table may still hold the from-space reference of `obj`.
+    // Update all the references once. This keeps all the objects of the table live until the next
+    // GC, but should be rare.
+    updated_since_last_sweep_ = true;
+    Table updated;
+    for (const auto& entry : table_) {
+      mirror::Object* to_ref = entry.first.Read();
+      AddToFilter(to_ref);
+      updated.emplace(GcRoot<mirror::Object>(to_ref), entry.second);
+    }
+    table_.swap(updated);
+    it = table_.find(GcRoot<mirror::Object>(obj));
+  }
+  return it;
+}
+
+void IdentityHashTable::Erase(Table::iterator it) {
+  table_.erase(it);
+  size_.StoreSequentiallyConsistent(table_.size());
+}
+
+}  // namespace art
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_IDENTITY_HASH_TABLE_H_
+#define ART_RUNTIME_IDENTITY_HASH_TABLE_H_
+
+#include <atomic>
+#include <unordered_map>
+
+#include "base/atomic.h"
+#include "base/globals.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "gc/system_weak.h"
+#include "gc_root.h"
+#include "lock_word.h"
+#include "obj_ptr.h"
+
+namespace art {
+
+class Monitor;
+
+namespace mirror {
+class Object;
+}  // namespace mirror
+
+// Identity hash codes of the objects hashed while thin locked. The lock word of a thin locked
+// object has no room for the hash code, and inflating the lock to store it in a monitor suspends
+// the owner when it is another thread. The hash code stays here until the object is hashed again
+// after it was unlocked or inflated, or until the sweep finds it unlocked or inflated, then moves
+// to the lock word or the monitor. A hash code is published in an object at most once, so the
+// entries are only added while the lock word is thin locked, and only removed under the lock of the
+// table when they are published.
+class IdentityHashTable : public gc::SystemWeakHolder {
+ public:
+  IdentityHashTable();
+
+  // Whether the table may have an entry for `obj`, whose lock word was read before. Along with
+  // the fence after the insertions in GetOrAddForThinLocked, this guarantees that a thread seeing
+  // the lock word of an object hashed while thin locked also sees its entry. The other objects
+  // mostly get false without taking the lock.
+  bool MayHaveEntryFor(Thread* self, ObjPtr<mirror::Object> obj) const
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return size_.LoadSequentiallyConsistent() != 0u && FilterMayHave(self, obj);
+  }
+
+  // Return the hash code of the thin locked `obj`, adding one if it has none. Return 0 if the
+  // lock word is no longer thin locked, the caller should then retry with the new lock word.
+  int32_t GetOrAddForThinLocked(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
+  // Store the hash code of `obj` in its table entry, or a new hash code, in its lock word if it is
+  // still `lock_word`. Return whether it was stored, in `hash_code`.
+  bool PublishToLockWord(Thread* self,
+                         ObjPtr<mirror::Object> obj,
+                         LockWord lock_word,
+                         /* out */ int32_t* hash_code)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
+  // Store the hash code of the object of `monitor` in its table entry, or a new hash code, in the
+  // monitor if it has no hash code yet.
+  void PublishToMonitor(Thread* self, Monitor* monitor)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
+  // Return the hash code of `obj` in the table, or 0 if it has no entry.
+  int32_t Lookup(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
+  size_t Size() REQUIRES(!allow_disallow_lock_);
+
+  void Sweep(IsMarkedVisitor* visitor) OVERRIDE
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
+ private:
+  struct HashGcRoot {
+    size_t operator()(const GcRoot<mirror::Object>& root) const NO_THREAD_SAFETY_ANALYSIS {
+      return reinterpret_cast<uintptr_t>(root.Read<kWithoutReadBarrier>());
+    }
+  };
+
+  struct EqGcRoot {
+    bool operator()(const GcRoot<mirror::Object>& lhs, const GcRoot<mirror::Object>& rhs) const
+        NO_THREAD_SAFETY_ANALYSIS {
+      return lhs.Read<kWithoutReadBarrier>() == rhs.Read<kWithoutReadBarrier>();
+    }
+  };
+
+  using Table = std::unordered_map<GcRoot<mirror::Object>, int32_t, HashGcRoot, EqGcRoot>;
+
+  Table::iterator Find(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(allow_disallow_lock_);
+
+  void Erase(Table::iterator it) REQUIRES(allow_disallow_lock_);
+
+  // The filter is a bitmap over the hashes of the addresses of the objects in the table. It may
+  // have bits for objects that are not in the table anymore, but never misses one that is, except
+  // while the sweep rebuilds it, which makes `filter_sequence_` odd.
+  static constexpr size_t kFilterWords = 1024;
+  static constexpr size_t kFilterBits = kFilterWords * 64;
+
+  static size_t FilterBit(mirror::Object* obj) {
+    static_assert((kFilterBits & (kFilterBits - 1)) == 0, "Filter size must be a power of two");
+    uint64_t hash = (reinterpret_cast<uintptr_t>(obj) >> kObjectAlignmentShift) *
+                    UINT64_C(0x9e3779b97f4a7c15);
+    return static_cast<size_t>(hash >> 48);
+  }
+
+  void AddToFilter(mirror::Object* obj) REQUIRES(allow_disallow_lock_) {
+    size_t bit = FilterBit(obj);
+    filter_[bit / 64].fetch_or(UINT64_C(1) << (bit % 64), std::memory_order_relaxed);
+  }
+
+  // Lock-free check of the filter. Returns true if `obj` may have an entry, including whenever the
+  // table may still hold from-space references.
+  bool FilterMayHave(Thread* self, ObjPtr<mirror::Object> obj) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  Table table_ GUARDED_BY(allow_disallow_lock_);
+  // The size of `table_`, read without the lock by MayHaveEntryFor.
+  Atomic<size_t> size_;
+  // Under concurrent copying, the table may hold from-space references between the flip and the
+  // sweep. Whether the references were updated to to-space since the last sweep.
+  bool updated_since_last_sweep_ GUARDED_BY(allow_disallow_lock_);
+
+  std::atomic<uint64_t> filter_[kFilterWords];
+  std::atomic<uint32_t> filter_sequence_;
+
+  DISALLOW_COPY_AND_ASSIGN(IdentityHashTable);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_IDENTITY_HASH_TABLE_H_
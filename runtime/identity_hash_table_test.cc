@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "identity_hash_table.h"
+
+#include <vector>
+
+#include "base/atomic.h"
+#include "class_linker.h"
+#include "common_runtime_test.h"
+#include "handle_scope-inl.h"
+#include "java_vm_ext.h"
+#include "lock_word.h"
+#include "mirror/object-inl.h"
+#include "mirror/object_array-inl.h"
+#include "mirror/string.h"
+#include "monitor.h"
+#include "object_lock.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread_pool.h"
+
+namespace art {
+
+class IdentityHashTableTest : public CommonRuntimeTest {};
+
+// Hashes the objects of an array from a thread pool worker, the even ones while holding their
+// locks, and checks that every thread gets the same hash code for each object.
+class HashTask : public Task {
+ public:
+  static constexpr size_t kNumRounds = 16;
+
+  HashTask(jobject objects, std::vector<AtomicInteger>* hash_codes, AtomicInteger* mismatches)
+      : objects_(objects), hash_codes_(hash_codes), mismatches_(mismatches) {}
+
+  void Run(Thread* self) OVERRIDE {
+    ScopedObjectAccess soa(self);
+    for (size_t round = 0; round < kNumRounds; ++round) {
+      for (size_t i = 0; i < hash_codes_->size(); ++i) {
+        StackHandleScope<1> hs(self);
+        Handle<mirror::Object> obj(
+            hs.NewHandle(soa.Decode<mirror::ObjectArray<mirror::Object>>(objects_)->Get(i)));
+        int32_t hash_code;
+        if (i % 2 == 0) {
+          ObjectLock<mirror::Object> lock(self, obj);
+          hash_code = obj->IdentityHashCode();
+        } else {
+          hash_code = obj->IdentityHashCode();
+        }
+        AtomicInteger& expected = (*hash_codes_)[i];
+        if (!expected.CompareAndSetStrongSequentiallyConsistent(0, hash_code) &&
+            expected.LoadSequentiallyConsistent() != hash_code) {
+          mismatches_->FetchAndAddSequentiallyConsistent(1);
+        }
+      }
+    }
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  const jobject objects_;
+  std::vector<AtomicInteger>* const hash_codes_;
+  AtomicInteger* const mismatches_;
+};
+
+TEST_F(IdentityHashTableTest, HashThinLockedWithoutInflation) {
+  ScopedObjectAccess soa(Thread::Current());
+  IdentityHashTable* table = Runtime::Current()->GetIdentityHashTable();
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::Object> obj(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(soa.Self(), "hash")));
+  ASSERT_TRUE(obj != nullptr);
+  int32_t hash_code;
+  {
+    ObjectLock<mirror::Object> lock(soa.Self(), obj);
+    ASSERT_EQ(LockWord::kThinLocked, obj->GetLockWord(false).GetState());
+    hash_code = obj->IdentityHashCode();
+    EXPECT_NE(0, hash_code);
+    EXPECT_EQ(LockWord::kThinLocked, obj->GetLockWord(false).GetState());
+    EXPECT_EQ(hash_code, table->Lookup(soa.Self(), obj.Get()));
+    EXPECT_EQ(hash_code, obj->IdentityHashCode());
+  }
+  // The hash code moves to the lock word once the object is unlocked.
+  ASSERT_EQ(LockWord::kUnlocked, obj->GetLockWord(false).GetState());
+  EXPECT_EQ(hash_code, obj->IdentityHashCode());
+  EXPECT_EQ(LockWord::kHashCode, obj->GetLockWord(false).GetState());
+  EXPECT_EQ(0, table->Lookup(soa.Self(), obj.Get()));
+}
+
+TEST_F(IdentityHashTableTest, HashMovesToMonitor) {
+  ScopedObjectAccess soa(Thread::Current());
+  IdentityHashTable* table = Runtime::Current()->GetIdentityHashTable();
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::Object> obj(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(soa.Self(), "hash")));
+  ASSERT_TRUE(obj != nullptr);
+  ObjectLock<mirror::Object> lock(soa.Self(), obj);
+  int32_t hash_code = obj->IdentityHashCode();
+  EXPECT_NE(0, hash_code);
+  Monitor::InflateThinLocked(soa.Self(), obj, obj->GetLockWord(false), /* hash_code */ 0u);
+  ASSERT_EQ(LockWord::kFatLocked, obj->GetLockWord(false).GetState());
+  EXPECT_EQ(hash_code, obj->IdentityHashCode());
+  EXPECT_EQ(0, table->Lookup(soa.Self(), obj.Get()));
+}
+
+TEST_F(IdentityHashTableTest, SweepDeadObjects) {
+  IdentityHashTable* table = Runtime::Current()->GetIdentityHashTable();
+  size_t initial_size = table->Size();
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    StackHandleScope<1> hs(soa.Self());
+    Handle<mirror::Object> obj(
+        hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(soa.Self(), "hash")));
+    ASSERT_TRUE(obj != nullptr);
+    ObjectLock<mirror::Object> lock(soa.Self(), obj);
+    EXPECT_NE(0, obj->IdentityHashCode());
+    EXPECT_EQ(initial_size + 1u, table->Size());
+  }
+  Runtime::Current()->GetHeap()->CollectGarbage(/* clear_soft_references */ false);
+  EXPECT_EQ(initial_size, table->Size());
+}
+
+// The unlocked objects that were never hashed while thin locked keep the lock-free path, even when
+// the table has entries for other objects.
+TEST_F(IdentityHashTableTest, UnlockedObjectsSkipTable) {
+  static constexpr size_t kNumObjects = 16;
+  ScopedObjectAccess soa(Thread::Current());
+  IdentityHashTable* table = Runtime::Current()->GetIdentityHashTable();
+  StackHandleScope<kNumObjects + 1> hs(soa.Self());
+  Handle<mirror::Object> locked(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(soa.Self(), "locked")));
+  ASSERT_TRUE(locked != nullptr);
+  ObjectLock<mirror::Object> lock(soa.Self(), locked);
+  EXPECT_NE(0, locked->IdentityHashCode());
+  EXPECT_TRUE(table->MayHaveEntryFor(soa.Self(), locked.Get()));
+  size_t size = table->Size();
+  size_t num_maybe = 0u;
+  for (size_t i = 0; i < kNumObjects; ++i) {
+    Handle<mirror::Object> obj(
+        hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(soa.Self(), "free")));
+    ASSERT_TRUE(obj != nullptr);
+    if (table->MayHaveEntryFor(soa.Self(), obj.Get())) {
+      // A collision in the filter, the slow path then finds no entry.
+      ++num_maybe;
+    }
+    EXPECT_NE(0, obj->IdentityHashCode());
+    EXPECT_EQ(LockWord::kHashCode, obj->GetLockWord(false).GetState());
+  }
+  EXPECT_LT(num_maybe, kNumObjects);
+  EXPECT_EQ(size, table->Size());
+}
+
+TEST_F(IdentityHashTableTest, ConcurrentHashCodesAreStable) {
+  static constexpr size_t kNumObjects = 64;
+  static constexpr size_t kNumThreads = 4;
+  Thread* self = Thread::Current();
+  JavaVMExt* vm = Runtime::Current()->GetJavaVM();
+  IdentityHashTable* table = Runtime::Current()->GetIdentityHashTable();
+  size_t initial_size = table->Size();
+  jobject objects;
+  {
+    ScopedObjectAccess soa(self);
+    StackHandleScope<1> hs(self);
+    Handle<mirror::ObjectArray<mirror::Object>> array(hs.NewHandle(
+        mirror::ObjectArray<mirror::Object>::Alloc(
+            self,
+            class_linker_->FindSystemClass(self, "[Ljava/lang/Object;"),
+            kNumObjects)));
+    ASSERT_TRUE(array != nullptr);
+    for (size_t i = 0; i < kNumObjects; ++i) {
+      ObjPtr<mirror::Object> obj = mirror::String::AllocFromModifiedUtf8(self, "hash");
+      ASSERT_TRUE(obj != nullptr);
+      array->Set<false>(i, obj);
+    }
+    objects = vm->AddGlobalRef(self, array.Get());
+  }
+  std::vector<AtomicInteger> hash_codes(kNumObjects);
+  AtomicInteger mismatches(0);
+  // Hash again after a collection, which may move the objects, and sweeps the table.
+  for (size_t gc = 0; gc != 2; ++gc) {
+    ThreadPool thread_pool("Identity hash table test thread pool", kNumThreads);
+    for (size_t i = 0; i < kNumThreads; ++i) {
+      thread_pool.AddTask(self, new HashTask(objects, &hash_codes, &mismatches));
+    }
+    thread_pool.StartWorkers(self);
+    thread_pool.Wait(self, /* do_work */ true, /* may_hold_locks */ false);
+    Runtime::Current()->GetHeap()->CollectGarbage(/* clear_soft_references */ false);
+  }
+  EXPECT_EQ(0, mismatches.LoadSequentiallyConsistent());
+
+  // The sweep moved the hash codes of the unlocked objects to their lock words.
+  EXPECT_EQ(initial_size, table->Size());
+  {
+    ScopedObjectAccess soa(self);
+    ObjPtr<mirror::ObjectArray<mirror::Object>> array =
+        soa.Decode<mirror::ObjectArray<mirror::Object>>(objects);
+    for (size_t i = 0; i < kNumObjects; ++i) {
+      LockWord lock_word = array->Get(i)->GetLockWord(false);
+      if (lock_word.GetState() == LockWord::kHashCode) {
+        EXPECT_EQ(hash_codes[i].LoadSequentiallyConsistent(),
+                  static_cast<int32_t>(lock_word.GetHashCode())) << i;
+      } else {
+        // Contended locks stay inflated, with the hash code in the monitor.
+        ASSERT_EQ(LockWord::kFatLocked, lock_word.GetState()) << i;
+        EXPECT_EQ(hash_codes[i].LoadSequentiallyConsistent(),
+                  lock_word.FatLockMonitor()->GetHashCode()) << i;
+      }
+    }
+    vm->DeleteGlobalRef(self, objects);
+  }
+}
+
+}  // namespace art
@@ -26,7 +26,7 @@
 namespace art {
 
 const uint8_t ImageHeader::kImageMagic[] = { 'a', 'r', 't', '\n' };
-const uint8_t ImageHeader::kImageVersion[] = { '0', '5', '6', '\0' };  // ReachabilityFence.
+const uint8_t ImageHeader::kImageVersion[] = { '0', '5', '7', '\0' };  // Initialized app classes.
 
 ImageHeader::ImageHeader(uint32_t image_begin,
                          uint32_t image_size,
@@ -44,6 +44,7 @@ ImageHeader::ImageHeader(uint32_t image_begin,
                          uint32_t pointer_size,
                          bool compile_pic,
                          bool is_pic,
+                         bool has_initialized_classes,
                          StorageMode storage_mode,
                          size_t data_size)
   : image_begin_(image_begin),
@@ -62,6 +63,7 @@ ImageHeader::ImageHeader(uint32_t image_begin,
     pointer_size_(pointer_size),
     compile_pic_(compile_pic),
     is_pic_(is_pic),
+    has_initialized_classes_(has_initialized_classes),
     storage_mode_(storage_mode),
     data_size_(data_size) {
   CHECK_EQ(image_begin, RoundUp(image_begin, kPageSize));
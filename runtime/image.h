@@ -110,6 +110,7 @@ class PACKED(4) ImageHeader {
         pointer_size_(0U),
         compile_pic_(0),
         is_pic_(0),
+        has_initialized_classes_(0),
         storage_mode_(kDefaultStorageMode),
         data_size_(0) {}
 
@@ -129,6 +130,7 @@ class PACKED(4) ImageHeader {
               uint32_t pointer_size,
               bool compile_pic,
               bool is_pic,
+              bool has_initialized_classes,
               StorageMode storage_mode,
               size_t data_size);
 
@@ -297,6 +299,10 @@ class PACKED(4) ImageHeader {
     return is_pic_ != 0;
   }
 
+  bool HasInitializedClasses() const {
+    return has_initialized_classes_ != 0;
+  }
+
   uint32_t GetBootImageBegin() const {
     return boot_image_begin_;
   }
@@ -437,6 +443,10 @@ class PACKED(4) ImageHeader {
   // from the app oat code to the app image.
   const uint32_t is_pic_;
 
+  // Boolean (0 or 1) to denote if the app image contains classes initialized at compile time,
+  // whose static fields may reference strings that must be interned at load time.
+  const uint32_t has_initialized_classes_;
+
   // Image section sizes/offsets correspond to the uncompressed form.
   ImageSection sections_[kSectionCount];
 
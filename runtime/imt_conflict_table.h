@@ -19,6 +19,8 @@
 
 #include <cstddef>
 
+#include "arch/instruction_set.h"
+#include "base/bit_utils.h"
 #include "base/casts.h"
 #include "base/enums.h"
 #include "base/macros.h"
@@ -32,6 +34,12 @@ class ArtMethod;
 // The table contains a list of pairs of { interface_method, implementation_method }
 // with the last entry being null to make an assembly implementation of a lookup
 // faster.
+//
+// On x86-64, the tables made by adding entries are hashed once they are large: the
+// entries are then preceded by a marker entry { table, mask } and an open addressing
+// hash index of mask + 1 entries, at most half full, that the conflict trampoline
+// probes instead of iterating over the entries. The indexed accessors and visitors
+// below skip the hash index.
 class ImtConflictTable {
   enum MethodIndex {
     kMethodInterface,
@@ -47,6 +55,12 @@ class ImtConflictTable {
                    ArtMethod* implementation_method,
                    PointerSize pointer_size) {
     const size_t count = other->NumEntries(pointer_size);
+    if (ShouldHash(count + 1, pointer_size)) {
+      InitHashIndex(NumBucketsFor(count + 1), pointer_size);
+    } else {
+      // Clear the marker entry.
+      SetMethod(kMethodInterface, pointer_size, nullptr);
+    }
     for (size_t i = 0; i < count; ++i) {
       SetInterfaceMethod(i, pointer_size, other->GetInterfaceMethod(i, pointer_size));
       SetImplementationMethod(i, pointer_size, other->GetImplementationMethod(i, pointer_size));
@@ -56,37 +70,49 @@ class ImtConflictTable {
     // Add the null marker.
     SetInterfaceMethod(count + 1, pointer_size, nullptr);
     SetImplementationMethod(count + 1, pointer_size, nullptr);
+    if (IsHashed(pointer_size)) {
+      BuildHashIndex(pointer_size);
+    }
   }
 
   // num_entries excludes the header.
   ImtConflictTable(size_t num_entries, PointerSize pointer_size) {
+    // Clear the marker entry first, the entries are not hashed.
+    SetMethod(kMethodInterface, pointer_size, nullptr);
     SetInterfaceMethod(num_entries, pointer_size, nullptr);
     SetImplementationMethod(num_entries, pointer_size, nullptr);
   }
 
-  // Set an entry at an index.
+  // Set an entry at an index. Setting the entries of a hashed table does not update its
+  // hash index.
   void SetInterfaceMethod(size_t index, PointerSize pointer_size, ArtMethod* method) {
-    SetMethod(index * kMethodCount + kMethodInterface, pointer_size, method);
+    SetMethod(EntryOffset(index, pointer_size) + kMethodInterface, pointer_size, method);
   }
 
   void SetImplementationMethod(size_t index, PointerSize pointer_size, ArtMethod* method) {
-    SetMethod(index * kMethodCount + kMethodImplementation, pointer_size, method);
+    SetMethod(EntryOffset(index, pointer_size) + kMethodImplementation, pointer_size, method);
   }
 
   ArtMethod* GetInterfaceMethod(size_t index, PointerSize pointer_size) const {
-    return GetMethod(index * kMethodCount + kMethodInterface, pointer_size);
+    return GetMethod(EntryOffset(index, pointer_size) + kMethodInterface, pointer_size);
   }
 
   ArtMethod* GetImplementationMethod(size_t index, PointerSize pointer_size) const {
-    return GetMethod(index * kMethodCount + kMethodImplementation, pointer_size);
+    return GetMethod(EntryOffset(index, pointer_size) + kMethodImplementation, pointer_size);
   }
 
   void** AddressOfInterfaceMethod(size_t index, PointerSize pointer_size) {
-    return AddressOfMethod(index * kMethodCount + kMethodInterface, pointer_size);
+    return AddressOfMethod(EntryOffset(index, pointer_size) + kMethodInterface, pointer_size);
   }
 
   void** AddressOfImplementationMethod(size_t index, PointerSize pointer_size) {
-    return AddressOfMethod(index * kMethodCount + kMethodImplementation, pointer_size);
+    return AddressOfMethod(EntryOffset(index, pointer_size) + kMethodImplementation,
+                           pointer_size);
+  }
+
+  // Whether the entries are preceded by a hash index.
+  bool IsHashed(PointerSize pointer_size) const {
+    return GetMethod(kMethodInterface, pointer_size) == reinterpret_cast<const ArtMethod*>(this);
   }
 
   // Return true if two conflict tables are the same.
@@ -111,6 +137,7 @@ class ImtConflictTable {
   template<typename Visitor>
   void Visit(const Visitor& visitor, PointerSize pointer_size) NO_THREAD_SAFETY_ANALYSIS {
     uint32_t table_index = 0;
+    bool any_updated = false;
     for (;;) {
       ArtMethod* interface_method = GetInterfaceMethod(table_index, pointer_size);
       if (interface_method == nullptr) {
@@ -121,17 +148,36 @@ class ImtConflictTable {
       std::pair<ArtMethod*, ArtMethod*> updated = visitor(input);
       if (input.first != updated.first) {
         SetInterfaceMethod(table_index, pointer_size, updated.first);
+        any_updated = true;
       }
       if (input.second != updated.second) {
         SetImplementationMethod(table_index, pointer_size, updated.second);
+        any_updated = true;
       }
       ++table_index;
     }
+    if (any_updated && IsHashed(pointer_size)) {
+      BuildHashIndex(pointer_size);
+    }
   }
 
   // Lookup the implementation ArtMethod associated to `interface_method`. Return null
   // if not found.
   ArtMethod* Lookup(ArtMethod* interface_method, PointerSize pointer_size) const {
+    if (IsHashed(pointer_size)) {
+      // The hash index is at most half full, the probing always reaches an empty bucket.
+      const size_t mask = HashMask(pointer_size);
+      for (size_t bucket = HashOf(interface_method) & mask; ; bucket = (bucket + 1u) & mask) {
+        ArtMethod* current_interface_method =
+            GetMethod(BucketOffset(bucket) + kMethodInterface, pointer_size);
+        if (current_interface_method == interface_method) {
+          return GetMethod(BucketOffset(bucket) + kMethodImplementation, pointer_size);
+        }
+        if (current_interface_method == nullptr) {
+          return nullptr;
+        }
+      }
+    }
     uint32_t table_index = 0;
     for (;;) {
       ArtMethod* current_interface_method = GetInterfaceMethod(table_index, pointer_size);
@@ -157,14 +203,21 @@ class ImtConflictTable {
 
   // Compute the size in bytes taken by this table.
   size_t ComputeSize(PointerSize pointer_size) const {
-    // Add the end marker.
-    return ComputeSize(NumEntries(pointer_size), pointer_size);
+    // Add the end marker, and the hash index.
+    return ComputeSize(NumEntries(pointer_size), pointer_size) +
+        EntryOffset(0u, pointer_size) / kMethodCount * EntrySize(pointer_size);
   }
 
   // Compute the size in bytes needed for copying the given `table` and add
   // one more entry.
   static size_t ComputeSizeWithOneMoreEntry(ImtConflictTable* table, PointerSize pointer_size) {
-    return table->ComputeSize(pointer_size) + EntrySize(pointer_size);
+    const size_t num_entries = table->NumEntries(pointer_size) + 1u;
+    size_t size = ComputeSize(num_entries, pointer_size);
+    if (ShouldHash(num_entries, pointer_size)) {
+      // Add the marker entry and the buckets.
+      size += (1u + NumBucketsFor(num_entries)) * EntrySize(pointer_size);
+    }
+    return size;
   }
 
   // Compute size with a fixed number of entries.
@@ -177,6 +230,88 @@ class ImtConflictTable {
   }
 
  private:
+  // Tables built with at least this many entries are hashed.
+  static constexpr size_t kMinHashedEntries = 8;
+  // Low bits of ArtMethod addresses ignored by the hash. Keep in sync with
+  // art_quick_imt_conflict_trampoline on x86-64.
+  static constexpr size_t kHashShift = 4;
+
+  // Only the x86-64 conflict trampoline uses the hash index, the other ones would stop
+  // iterating over the entries at its first empty bucket.
+  static bool ShouldHash(size_t num_entries, PointerSize pointer_size) {
+    return kRuntimeISA == InstructionSet::kX86_64 &&
+        pointer_size == PointerSize::k64 &&
+        num_entries >= kMinHashedEntries;
+  }
+
+  // Keep the hash index at most half full.
+  static size_t NumBucketsFor(size_t num_entries) {
+    return RoundUpToPowerOfTwo(2u * num_entries);
+  }
+
+  static size_t HashOf(ArtMethod* interface_method) {
+    return reinterpret_cast<uintptr_t>(interface_method) >> kHashShift;
+  }
+
+  size_t HashMask(PointerSize pointer_size) const {
+    return reinterpret_cast<uintptr_t>(GetMethod(kMethodImplementation, pointer_size));
+  }
+
+  // The index of the first method of the bucket at `bucket`, after the marker entry.
+  static size_t BucketOffset(size_t bucket) {
+    return (1u + bucket) * kMethodCount;
+  }
+
+  // The index of the first method of the entry at `index`, after the hash index if any.
+  size_t EntryOffset(size_t index, PointerSize pointer_size) const {
+    size_t offset = index * kMethodCount;
+    if (IsHashed(pointer_size)) {
+      offset += BucketOffset(HashMask(pointer_size) + 1u);
+    }
+    return offset;
+  }
+
+  // Write the marker entry and empty buckets.
+  void InitHashIndex(size_t num_buckets, PointerSize pointer_size) {
+    DCHECK(IsPowerOfTwo(num_buckets));
+    SetMethod(kMethodInterface, pointer_size, reinterpret_cast<ArtMethod*>(this));
+    SetMethod(kMethodImplementation, pointer_size, reinterpret_cast<ArtMethod*>(num_buckets - 1u));
+    for (size_t bucket = 0; bucket < num_buckets; ++bucket) {
+      SetMethod(BucketOffset(bucket) + kMethodInterface, pointer_size, nullptr);
+      SetMethod(BucketOffset(bucket) + kMethodImplementation, pointer_size, nullptr);
+    }
+  }
+
+  // Fill the buckets from the entries.
+  void BuildHashIndex(PointerSize pointer_size) {
+    const size_t mask = HashMask(pointer_size);
+    for (size_t bucket = 0; bucket <= mask; ++bucket) {
+      SetMethod(BucketOffset(bucket) + kMethodInterface, pointer_size, nullptr);
+      SetMethod(BucketOffset(bucket) + kMethodImplementation, pointer_size, nullptr);
+    }
+    for (size_t i = 0; ; ++i) {
+      ArtMethod* interface_method = GetInterfaceMethod(i, pointer_size);
+      if (interface_method == nullptr) {
+        break;
+      }
+      size_t bucket = HashOf(interface_method) & mask;
+      for (;;) {
+        ArtMethod* current = GetMethod(BucketOffset(bucket) + kMethodInterface, pointer_size);
+        // Keep the first entry for a method, the one the linear lookup would find.
+        if (current == nullptr || current == interface_method) {
+          break;
+        }
+        bucket = (bucket + 1u) & mask;
+      }
+      if (GetMethod(BucketOffset(bucket) + kMethodInterface, pointer_size) == nullptr) {
+        SetMethod(BucketOffset(bucket) + kMethodInterface, pointer_size, interface_method);
+        SetMethod(BucketOffset(bucket) + kMethodImplementation,
+                  pointer_size,
+                  GetImplementationMethod(i, pointer_size));
+      }
+    }
+  }
+
   void** AddressOfMethod(size_t index, PointerSize pointer_size) {
     if (pointer_size == PointerSize::k64) {
       return reinterpret_cast<void**>(&data64_[index]);
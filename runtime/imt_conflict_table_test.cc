@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "imt_conflict_table.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+// Build a table of `count` entries { methods[2 * i], methods[2 * i + 1] } by adding them one
+// at a time, as ClassLinker::AddMethodToConflictTable does.
+static ImtConflictTable* BuildTable(uint64_t* methods,
+                                    size_t count,
+                                    std::vector<std::unique_ptr<uint8_t[]>>* storage) {
+  storage->emplace_back(new uint8_t[ImtConflictTable::ComputeSize(0u, kRuntimePointerSize)]);
+  ImtConflictTable* table =
+      new (storage->back().get()) ImtConflictTable(0u, kRuntimePointerSize);
+  for (size_t i = 0; i < count; ++i) {
+    storage->emplace_back(
+        new uint8_t[ImtConflictTable::ComputeSizeWithOneMoreEntry(table, kRuntimePointerSize)]);
+    table = new (storage->back().get()) ImtConflictTable(
+        table,
+        reinterpret_cast<ArtMethod*>(&methods[2 * i]),
+        reinterpret_cast<ArtMethod*>(&methods[2 * i + 1]),
+        kRuntimePointerSize);
+  }
+  return table;
+}
+
+TEST(ImtConflictTable, Lookup) {
+  static constexpr size_t kCount = 100;
+  uint64_t methods[2 * kCount + 1];
+  std::vector<std::unique_ptr<uint8_t[]>> storage;
+  ImtConflictTable* table = BuildTable(methods, kCount, &storage);
+  ASSERT_EQ(kCount, table->NumEntries(kRuntimePointerSize));
+  EXPECT_EQ(kRuntimeISA == InstructionSet::kX86_64, table->IsHashed(kRuntimePointerSize));
+  for (size_t i = 0; i < kCount; ++i) {
+    ArtMethod* interface_method = reinterpret_cast<ArtMethod*>(&methods[2 * i]);
+    ArtMethod* implementation_method = reinterpret_cast<ArtMethod*>(&methods[2 * i + 1]);
+    EXPECT_EQ(interface_method, table->GetInterfaceMethod(i, kRuntimePointerSize));
+    EXPECT_EQ(implementation_method, table->GetImplementationMethod(i, kRuntimePointerSize));
+    EXPECT_EQ(implementation_method, table->Lookup(interface_method, kRuntimePointerSize));
+  }
+  EXPECT_EQ(nullptr,
+            table->Lookup(reinterpret_cast<ArtMethod*>(&methods[2 * kCount]), kRuntimePointerSize));
+}
+
+TEST(ImtConflictTable, Visit) {
+  static constexpr size_t kCount = 20;
+  uint64_t methods[2 * kCount];
+  uint64_t other_methods[kCount];
+  std::vector<std::unique_ptr<uint8_t[]>> storage;
+  ImtConflictTable* table = BuildTable(methods, kCount, &storage);
+  // Move the interface methods, the lookups follow.
+  table->Visit([&](const std::pair<ArtMethod*, ArtMethod*>& entry) {
+    size_t index = (reinterpret_cast<uint64_t*>(entry.first) - methods) / 2;
+    return std::make_pair(reinterpret_cast<ArtMethod*>(&other_methods[index]), entry.second);
+  }, kRuntimePointerSize);
+  for (size_t i = 0; i < kCount; ++i) {
+    EXPECT_EQ(reinterpret_cast<ArtMethod*>(&methods[2 * i + 1]),
+              table->Lookup(reinterpret_cast<ArtMethod*>(&other_methods[i]), kRuntimePointerSize));
+    EXPECT_EQ(nullptr,
+              table->Lookup(reinterpret_cast<ArtMethod*>(&methods[2 * i]), kRuntimePointerSize));
+  }
+}
+
+TEST(ImtConflictTable, Equals) {
+  static constexpr size_t kCount = 10;
+  uint64_t methods[2 * kCount];
+  std::vector<std::unique_ptr<uint8_t[]>> storage;
+  ImtConflictTable* table = BuildTable(methods, kCount, &storage);
+  // A table filled by index is never hashed, but has the same entries.
+  storage.emplace_back(new uint8_t[ImtConflictTable::ComputeSize(kCount, kRuntimePointerSize)]);
+  ImtConflictTable* filled =
+      new (storage.back().get()) ImtConflictTable(kCount, kRuntimePointerSize);
+  for (size_t i = 0; i < kCount; ++i) {
+    filled->SetInterfaceMethod(i, kRuntimePointerSize,
+                               reinterpret_cast<ArtMethod*>(&methods[2 * i]));
+    filled->SetImplementationMethod(i, kRuntimePointerSize,
+                                    reinterpret_cast<ArtMethod*>(&methods[2 * i + 1]));
+  }
+  EXPECT_FALSE(filled->IsHashed(kRuntimePointerSize));
+  EXPECT_TRUE(table->Equals(filled, kRuntimePointerSize));
+  EXPECT_TRUE(filled->Equals(table, kRuntimePointerSize));
+}
+
+}  // namespace art
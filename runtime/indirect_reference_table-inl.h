@@ -97,6 +97,29 @@ inline ObjPtr<mirror::Object> IndirectReferenceTable::Get(IndirectRef iref) cons
   return obj;
 }
 
+inline IndirectRef IndirectReferenceTable::AddAtTop(IRTSegmentState previous_state,
+                                                   ObjPtr<mirror::Object> obj) {
+  const uint32_t top_index = segment_state_.top_index;
+  if (UNLIKELY(top_index == max_entries_)) {
+    return nullptr;
+  }
+  if (top_index == previous_state.top_index) {
+    // The segment is empty, so there is no hole. Same as what RecoverHoles would find.
+    last_known_previous_state_ = previous_state;
+    current_num_holes_ = 0;
+  } else if (current_num_holes_ != 0 ||
+             last_known_previous_state_.top_index >= top_index ||
+             last_known_previous_state_.top_index < previous_state.top_index) {
+    // There may be a hole to fill.
+    return nullptr;
+  }
+  DCHECK(obj != nullptr);
+  VerifyObject(obj);
+  table_[top_index].Add(obj);
+  segment_state_.top_index = top_index + 1;
+  return ToIndirectRef(top_index);
+}
+
 inline void IndirectReferenceTable::Update(IndirectRef iref, ObjPtr<mirror::Object> obj) {
   if (!GetChecked(iref)) {
     LOG(WARNING) << "IndirectReferenceTable Update failed to find reference " << iref;
@@ -295,16 +295,24 @@ IndirectRef IndirectReferenceTable::Add(IRTSegmentState previous_state,
   size_t index;
   if (current_num_holes_ > 0) {
     DCHECK_GT(top_index, 1U);
-    // Find the first hole; likely to be near the end of the list.
-    IrtEntry* p_scan = &table_[top_index - 1];
-    DCHECK(!p_scan->GetReference()->IsNull());
-    --p_scan;
-    while (!p_scan->GetReference()->IsNull()) {
-      DCHECK_GE(p_scan, table_ + previous_state.top_index);
+    if (HasFreeList()) {
+      DCHECK_EQ(previous_state.top_index, 0u);
+      index = TakeFreeIndex();
+    } else {
+      // Find the first hole; likely to be near the end of the list.
+      IrtEntry* p_scan = &table_[top_index - 1];
+      DCHECK(!p_scan->GetReference()->IsNull());
       --p_scan;
+      while (!p_scan->GetReference()->IsNull()) {
+        DCHECK_GE(p_scan, table_ + previous_state.top_index);
+        --p_scan;
+      }
+      index = p_scan - table_;
     }
-    index = p_scan - table_;
     current_num_holes_--;
+    if (current_num_holes_ == 0) {
+      free_indices_.clear();
+    }
   } else {
     // Add to the end.
     index = top_index++;
@@ -321,6 +329,19 @@ IndirectRef IndirectReferenceTable::Add(IRTSegmentState previous_state,
   return result;
 }
 
+uint32_t IndirectReferenceTable::TakeFreeIndex() {
+  while (true) {
+    DCHECK(!free_indices_.empty());
+    uint32_t index = free_indices_.back();
+    free_indices_.pop_back();
+    // Skip the holes eaten by the removal of the top entry, and the duplicates of holes that
+    // were eaten, then reused at the top and removed again.
+    if (index < segment_state_.top_index && table_[index].GetReference()->IsNull()) {
+      return index;
+    }
+  }
+}
+
 void IndirectReferenceTable::AssertEmpty() {
   for (size_t i = 0; i < Capacity(); ++i) {
     if (!table_[i].GetReference()->IsNull()) {
@@ -410,6 +431,9 @@ bool IndirectReferenceTable::Remove(IRTSegmentState previous_state, IndirectRef
         current_num_holes_--;
       }
       segment_state_.top_index = collapse_top_index;
+      if (current_num_holes_ == 0) {
+        free_indices_.clear();
+      }
 
       CheckHoleCount(table_, current_num_holes_, previous_state, segment_state_);
     } else {
@@ -431,6 +455,18 @@ bool IndirectReferenceTable::Remove(IRTSegmentState previous_state, IndirectRef
 
     *table_[idx].GetReference() = GcRoot<mirror::Object>(nullptr);
     current_num_holes_++;
+    if (HasFreeList()) {
+      if (free_indices_.size() >= segment_state_.top_index) {
+        // Drop the stale indices, so that the list does not outgrow the table.
+        free_indices_.clear();
+        for (uint32_t i = 0; i != segment_state_.top_index; ++i) {
+          if (i != idx && table_[i].GetReference()->IsNull()) {
+            free_indices_.push_back(i);
+          }
+        }
+      }
+      free_indices_.push_back(idx);
+    }
     CheckHoleCount(table_, current_num_holes_, previous_state, segment_state_);
     if (kDebugIRT) {
       LOG(INFO) << "+++ left hole at " << idx << ", holes=" << current_num_holes_;
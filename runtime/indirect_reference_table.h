@@ -22,6 +22,7 @@
 #include <iosfwd>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include <android-base/logging.h>
 
@@ -254,6 +255,11 @@ class IndirectReferenceTable {
                   std::string* error_msg)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Add a new entry at the top of the segment, if there is room and no hole to fill or to recover,
+  // which is the common case of the local references. Returns null if Add must be used instead.
+  ALWAYS_INLINE IndirectRef AddAtTop(IRTSegmentState previous_state, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Given an IndirectRef in the table, return the Object it refers to.
   //
   // This function may abort under error conditions.
@@ -308,6 +314,13 @@ class IndirectReferenceTable {
     return IrtIterator(table_, Capacity(), Capacity());
   }
 
+  // The iterator at `index`, to visit the table in several parts. The iterators of a part are
+  // invalidated by a resize, and must be recreated if the lock of the table was released.
+  IrtIterator IteratorAt(size_t index) {
+    DCHECK_LE(index, Capacity());
+    return IrtIterator(table_, index, Capacity());
+  }
+
   void VisitRoots(RootVisitor* visitor, const RootInfo& root_info)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -387,6 +400,16 @@ class IndirectReferenceTable {
 
   void RecoverHoles(IRTSegmentState from);
 
+  // The global tables have a single segment and keep their holes in `free_indices_`, so that
+  // filling one does not scan the table. The local tables scan, as their holes are only known
+  // for the current segment.
+  bool HasFreeList() const {
+    return kind_ != kLocal;
+  }
+
+  // Return the index of a hole of a table with a free list, which must have one.
+  uint32_t TakeFreeIndex();
+
   // Abort if check_jni is not enabled. Otherwise, just log as an error.
   static void AbortIfNoCheckJNI(const std::string& msg);
 
@@ -410,10 +433,13 @@ class IndirectReferenceTable {
 
   // Some values to retain old behavior with holes. Description of the algorithm is in the .cc
   // file.
-  // TODO: Consider other data structures for compact tables, e.g., free lists.
   size_t current_num_holes_;
   IRTSegmentState last_known_previous_state_;
 
+  // The indices of the holes of a table with a free list, most recent last. The holes eaten when
+  // the top entry is removed stay in the list until they are taken, or until there are no holes.
+  std::vector<uint32_t> free_indices_;
+
   // Whether the table's capacity may be resized. As there are no locks used, it is the caller's
   // responsibility to ensure thread-safety.
   ResizableCapacity resizable_;
@@ -510,4 +510,96 @@ TEST_F(IndirectReferenceTableTest, Resize) {
   EXPECT_EQ(irt.Capacity(), kTableMax + 1);
 }
 
+TEST_F(IndirectReferenceTableTest, AddAtTop) {
+  ScopedObjectAccess soa(Thread::Current());
+  static const size_t kTableMax = 4;
+
+  mirror::Class* c = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
+  StackHandleScope<3> hs(soa.Self());
+  ASSERT_TRUE(c != nullptr);
+  Handle<mirror::Object> obj0 = hs.NewHandle(c->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj0 != nullptr);
+  Handle<mirror::Object> obj1 = hs.NewHandle(c->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj1 != nullptr);
+  Handle<mirror::Object> obj2 = hs.NewHandle(c->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj2 != nullptr);
+
+  std::string error_msg;
+  IndirectReferenceTable irt(kTableMax,
+                             kLocal,
+                             IndirectReferenceTable::ResizableCapacity::kNo,
+                             &error_msg);
+  ASSERT_TRUE(irt.IsValid()) << error_msg;
+  const IRTSegmentState cookie0 = kIRTFirstSegment;
+
+  IndirectRef iref0 = irt.AddAtTop(cookie0, obj0.Get());
+  ASSERT_TRUE(iref0 != nullptr);
+  IndirectRef iref1 = irt.AddAtTop(cookie0, obj1.Get());
+  ASSERT_TRUE(iref1 != nullptr);
+  EXPECT_OBJ_PTR_EQ(obj0.Get(), irt.Get(iref0));
+  EXPECT_OBJ_PTR_EQ(obj1.Get(), irt.Get(iref1));
+
+  // With a hole, the slow path fills it.
+  ASSERT_TRUE(irt.Remove(cookie0, iref0));
+  EXPECT_TRUE(irt.AddAtTop(cookie0, obj2.Get()) == nullptr);
+  IndirectRef iref2 = irt.Add(cookie0, obj2.Get(), &error_msg);
+  ASSERT_TRUE(iref2 != nullptr) << error_msg;
+  EXPECT_EQ(2u, irt.Capacity());
+  EXPECT_OBJ_PTR_EQ(obj2.Get(), irt.Get(iref2));
+
+  // A new segment is empty, so it has no hole.
+  const IRTSegmentState cookie1 = irt.GetSegmentState();
+  IndirectRef iref3 = irt.AddAtTop(cookie1, obj0.Get());
+  ASSERT_TRUE(iref3 != nullptr);
+  IndirectRef iref4 = irt.AddAtTop(cookie1, obj1.Get());
+  ASSERT_TRUE(iref4 != nullptr);
+  EXPECT_EQ(4u, irt.Capacity());
+
+  // The table is full, and not resizable.
+  EXPECT_TRUE(irt.AddAtTop(cookie1, obj2.Get()) == nullptr);
+}
+
+TEST_F(IndirectReferenceTableTest, GlobalFreeList) {
+  ScopedObjectAccess soa(Thread::Current());
+  static const size_t kTableMax = 8;
+
+  mirror::Class* c = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
+  StackHandleScope<1> hs(soa.Self());
+  ASSERT_TRUE(c != nullptr);
+  Handle<mirror::Object> obj0 = hs.NewHandle(c->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj0 != nullptr);
+
+  std::string error_msg;
+  IndirectReferenceTable irt(kTableMax,
+                             kGlobal,
+                             IndirectReferenceTable::ResizableCapacity::kNo,
+                             &error_msg);
+  ASSERT_TRUE(irt.IsValid()) << error_msg;
+  const IRTSegmentState cookie = kIRTFirstSegment;
+
+  IndirectRef irefs[5];
+  for (IndirectRef& iref : irefs) {
+    iref = irt.Add(cookie, obj0.Get(), &error_msg);
+    ASSERT_TRUE(iref != nullptr) << error_msg;
+  }
+
+  // Leave holes at 1 and 3, then remove the top entry, which eats the hole at 3.
+  ASSERT_TRUE(irt.Remove(cookie, irefs[1]));
+  ASSERT_TRUE(irt.Remove(cookie, irefs[3]));
+  ASSERT_TRUE(irt.Remove(cookie, irefs[4]));
+  EXPECT_EQ(3u, irt.Capacity());
+
+  // The stale hole at 3 is skipped, and the hole at 1 is filled.
+  IndirectRef iref5 = irt.Add(cookie, obj0.Get(), &error_msg);
+  ASSERT_TRUE(iref5 != nullptr) << error_msg;
+  EXPECT_EQ(3u, irt.Capacity());
+  EXPECT_OBJ_PTR_EQ(obj0.Get(), irt.Get(iref5));
+
+  // Without holes, the entries are added at the top.
+  IndirectRef iref6 = irt.Add(cookie, obj0.Get(), &error_msg);
+  ASSERT_TRUE(iref6 != nullptr) << error_msg;
+  EXPECT_EQ(4u, irt.Capacity());
+  EXPECT_OBJ_PTR_EQ(obj0.Get(), irt.Get(iref6));
+}
+
 }  // namespace art
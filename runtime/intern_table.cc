@@ -18,6 +18,7 @@
 
 #include <memory>
 
+#include "base/casts.h"
 #include "dex/utf.h"
 #include "gc/collector/garbage_collector.h"
 #include "gc/space/image_space.h"
@@ -63,6 +64,7 @@ void InternTable::VisitRoots(RootVisitor* visitor, VisitRootFlags flags) {
   MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
   if ((flags & kVisitRootFlagAllRoots) != 0) {
     strong_interns_.VisitRoots(visitor);
+    VisitStrongCacheRoots(visitor);
   } else if ((flags & kVisitRootFlagNewRoots) != 0) {
     for (auto& root : new_strong_intern_roots_) {
       ObjPtr<mirror::String> old_ref = root.Read<kWithoutReadBarrier>();
@@ -74,6 +76,7 @@ void InternTable::VisitRoots(RootVisitor* visitor, VisitRootFlags flags) {
         // concurrent moving GC.
         strong_interns_.Remove(old_ref);
         strong_interns_.Insert(new_ref);
+        ClearStrongCache(new_ref);
       }
     }
   }
@@ -94,6 +97,10 @@ ObjPtr<mirror::String> InternTable::LookupWeak(Thread* self, ObjPtr<mirror::Stri
 }
 
 ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self, ObjPtr<mirror::String> s) {
+  ObjPtr<mirror::String> strong = LookupStrongCache(s);
+  if (strong != nullptr) {
+    return strong;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
   return LookupStrongLocked(s);
 }
@@ -105,8 +112,16 @@ ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self,
   Utf8String string(utf16_length,
                     utf8_data,
                     ComputeUtf16HashFromModifiedUtf8(utf8_data, utf16_length));
+  ObjPtr<mirror::String> strong = LookupStrongCache(string);
+  if (strong != nullptr) {
+    return strong;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(string);
+  strong = strong_interns_.Find(string);
+  if (strong != nullptr) {
+    PublishStrongCache(strong);
+  }
+  return strong;
 }
 
 ObjPtr<mirror::String> InternTable::LookupWeakLocked(ObjPtr<mirror::String> s) {
@@ -114,7 +129,58 @@ ObjPtr<mirror::String> InternTable::LookupWeakLocked(ObjPtr<mirror::String> s) {
 }
 
 ObjPtr<mirror::String> InternTable::LookupStrongLocked(ObjPtr<mirror::String> s) {
-  return strong_interns_.Find(s);
+  ObjPtr<mirror::String> strong = strong_interns_.Find(s);
+  if (strong != nullptr) {
+    PublishStrongCache(strong);
+  }
+  return strong;
+}
+
+ObjPtr<mirror::String> InternTable::LookupStrongCache(ObjPtr<mirror::String> s) {
+  const int32_t hash = s->GetHashCode();
+  const uint32_t data = StrongCacheSlot(hash).LoadAcquire();
+  if (data == 0u) {
+    return nullptr;
+  }
+  GcRoot<mirror::String> root(reinterpret_cast<mirror::String*>(data));
+  ObjPtr<mirror::String> cached = root.Read();
+  return (cached->GetHashCode() == hash && cached->Equals(s)) ? cached : nullptr;
+}
+
+ObjPtr<mirror::String> InternTable::LookupStrongCache(const Utf8String& string) {
+  const uint32_t data = StrongCacheSlot(string.GetHash()).LoadAcquire();
+  if (data == 0u) {
+    return nullptr;
+  }
+  GcRoot<mirror::String> root(reinterpret_cast<mirror::String*>(data));
+  ObjPtr<mirror::String> cached = root.Read();
+  if (cached->GetHashCode() != string.GetHash() ||
+      !StringHashEquals()(GcRoot<mirror::String>(cached), string)) {
+    return nullptr;
+  }
+  return cached;
+}
+
+void InternTable::PublishStrongCache(ObjPtr<mirror::String> s) {
+  // `s` was read through the read barrier, so the root visits never miss the to-space reference.
+  StrongCacheSlot(s->GetHashCode()).StoreRelease(
+      dchecked_integral_cast<uint32_t>(reinterpret_cast<uintptr_t>(s.Ptr())));
+}
+
+void InternTable::ClearStrongCache(ObjPtr<mirror::String> s) {
+  StrongCacheSlot(s->GetHashCode()).StoreRelease(0u);
+}
+
+void InternTable::VisitStrongCacheRoots(RootVisitor* visitor) {
+  for (Atomic<uint32_t>& slot : strong_intern_cache_) {
+    const uint32_t data = slot.LoadRelaxed();
+    if (data != 0u) {
+      GcRoot<mirror::String> root(reinterpret_cast<mirror::String*>(data));
+      root.VisitRoot(visitor, RootInfo(kRootInternedString));
+      slot.StoreRelease(dchecked_integral_cast<uint32_t>(
+          reinterpret_cast<uintptr_t>(root.Read<kWithoutReadBarrier>())));
+    }
+  }
 }
 
 void InternTable::AddNewTable() {
@@ -132,6 +198,7 @@ ObjPtr<mirror::String> InternTable::InsertStrong(ObjPtr<mirror::String> s) {
     new_strong_intern_roots_.push_back(GcRoot<mirror::String>(s));
   }
   strong_interns_.Insert(s);
+  PublishStrongCache(s);
   return s;
 }
 
@@ -145,6 +212,7 @@ ObjPtr<mirror::String> InternTable::InsertWeak(ObjPtr<mirror::String> s) {
 }
 
 void InternTable::RemoveStrong(ObjPtr<mirror::String> s) {
+  ClearStrongCache(s);
   strong_interns_.Remove(s);
 }
 
@@ -214,6 +282,11 @@ ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
   if (s == nullptr) {
     return nullptr;
   }
+  // Most strings interned again are found in the strong intern cache, without the lock.
+  ObjPtr<mirror::String> cached = LookupStrongCache(s);
+  if (cached != nullptr) {
+    return cached;
+  }
   Thread* const self = Thread::Current();
   MutexLock mu(self, *Locks::intern_table_lock_);
   if (kDebugLocking && !holding_locks) {
@@ -462,7 +535,18 @@ void InternTable::Table::SweepWeaks(IsMarkedVisitor* visitor) {
 }
 
 void InternTable::Table::SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor) {
+  Thread* const self = Thread::Current();
+  size_t swept = 0u;
   for (auto it = set->begin(), end = set->end(); it != end;) {
+    if (++swept % kSweepChunkSize == 0u) {
+      // Let the strong lookups and interns through between the chunks. Nothing modifies the weak
+      // table meanwhile: the weak interns are not accessible until the sweeping is done, so the
+      // iterator stays valid.
+      const size_t size = set->Size();
+      Locks::intern_table_lock_->ExclusiveUnlock(self);
+      Locks::intern_table_lock_->ExclusiveLock(self);
+      DCHECK_EQ(size, set->Size());
+    }
     // This does not need a read barrier because this is called by GC.
     mirror::Object* object = it->Read<kWithoutReadBarrier>();
     mirror::Object* new_object = visitor->IsMarked(object);
@@ -223,6 +223,9 @@ class InternTable {
     void SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
 
+    // Number of weak interns swept between two releases of the intern table lock.
+    static constexpr size_t kSweepChunkSize = 1024;
+
     // We call AddNewTable when we create the zygote to reduce private dirty pages caused by
     // modifying the zygote intern table. The back of table is modified when strings are interned.
     std::vector<UnorderedSet> tables_;
@@ -271,6 +274,25 @@ class InternTable {
   void WaitUntilAccessible(Thread* self)
       REQUIRES(Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Lookup a strong intern in the strong intern cache, without the lock. Returns null if it is not
+  // cached, it may still be in the strong table.
+  ObjPtr<mirror::String> LookupStrongCache(ObjPtr<mirror::String> s)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  ObjPtr<mirror::String> LookupStrongCache(const Utf8String& string)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  void PublishStrongCache(ObjPtr<mirror::String> s)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+  void ClearStrongCache(ObjPtr<mirror::String> s)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+  void VisitStrongCacheRoots(RootVisitor* visitor)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+
+  Atomic<uint32_t>& StrongCacheSlot(int32_t hash) {
+    return strong_intern_cache_[static_cast<uint32_t>(hash) % kStrongInternCacheSize];
+  }
+
+  static constexpr size_t kStrongInternCacheSize = 1024;
+
   bool log_new_roots_ GUARDED_BY(Locks::intern_table_lock_);
   ConditionVariable weak_intern_condition_ GUARDED_BY(Locks::intern_table_lock_);
   // Since this contains (strong) roots, they need a read barrier to
@@ -286,6 +308,11 @@ class InternTable {
   Table weak_interns_ GUARDED_BY(Locks::intern_table_lock_);
   // Weak root state, used for concurrent system weak processing and more.
   gc::WeakRootState weak_root_state_ GUARDED_BY(Locks::intern_table_lock_);
+  // Direct-mapped cache of the strong interns, indexed by hash code, so that the lookups of string
+  // literals and re-interned strings do not take the intern table lock. The slots hold compressed
+  // string references, published while holding the lock and cleared with it when the string is
+  // removed or moved. Visited with the strong roots, and always a subset of `strong_interns_`.
+  Atomic<uint32_t> strong_intern_cache_[kStrongInternCacheSize];
 
   friend class linker::OatWriter;  // for boot image string table slot address lookup.
   friend class Transaction;
@@ -22,7 +22,7 @@
 #include "gc_root-inl.h"
 #include "handle_scope-inl.h"
 #include "mirror/object.h"
-#include "mirror/string.h"
+#include "mirror/string-inl.h"
 #include "scoped_thread_state_change-inl.h"
 
 namespace art {
@@ -144,6 +144,41 @@ TEST_F(InternTableTest, SweepInternTableWeaks) {
   EXPECT_EQ(3U, t.Size());
 }
 
+// Keeps the strings whose first character is even.
+class KeepEvenPredicate : public IsMarkedVisitor {
+ public:
+  mirror::Object* IsMarked(mirror::Object* s) OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_) {
+    return (s->AsString()->CharAt(0) % 2 == 0) ? s : nullptr;
+  }
+};
+
+TEST_F(InternTableTest, SweepInternTableWeaksInChunks) {
+  ScopedObjectAccess soa(Thread::Current());
+  InternTable t;
+  t.InternStrong(3, "foo");
+  // More weak interns than swept between two releases of the lock.
+  static constexpr size_t kCount = 3000;
+  VariableSizedHandleScope hs(soa.Self());
+  for (size_t i = 0; i != kCount; ++i) {
+    std::string value = static_cast<char>('a' + i % 2) + std::to_string(i);
+    Handle<mirror::String> s(
+        hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), value.c_str())));
+    EXPECT_OBJ_PTR_EQ(t.InternWeak(s.Get()), s.Get());
+  }
+  EXPECT_EQ(kCount + 1u, t.Size());
+
+  KeepEvenPredicate p;
+  {
+    ReaderMutexLock mu(soa.Self(), *Locks::heap_bitmap_lock_);
+    t.SweepInternTableWeaks(&p);
+  }
+
+  // 'a' is odd and 'b' is even.
+  EXPECT_EQ(kCount / 2 + 1u, t.Size());
+  EXPECT_EQ(kCount / 2, t.WeakSize());
+  EXPECT_TRUE(t.LookupStrong(soa.Self(), 3, "foo") != nullptr);
+}
+
 TEST_F(InternTableTest, ContainsWeak) {
   ScopedObjectAccess soa(Thread::Current());
   {
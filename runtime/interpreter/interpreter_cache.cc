@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interpreter_cache.h"
+
+namespace art {
+namespace interpreter {
+
+Atomic<uint32_t> InterpreterCache::global_epoch_(0u);
+
+InterpreterCache::InterpreterCache() {
+  Clear();
+}
+
+void InterpreterCache::Clear() {
+  epoch_ = global_epoch_.LoadAcquire();
+  entries_.fill(Entry(nullptr, 0u));
+}
+
+void InterpreterCache::InvalidateAll() {
+  global_epoch_.FetchAndAddSequentiallyConsistent(1u);
+}
+
+}  // namespace interpreter
+}  // namespace art
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
+#define ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
+
+#include <array>
+#include <utility>
+
+#include "base/atomic.h"
+#include "base/bit_utils.h"
+#include "base/macros.h"
+
+namespace art {
+
+class Instruction;
+
+namespace interpreter {
+
+// A small direct-mapped cache of the fields and methods resolved by the instructions executed by
+// the switch interpreter, keyed by the address of the instruction. Each thread has its own cache,
+// so it needs no synchronization. The values are native ArtField and ArtMethod pointers, which are
+// only freed when their class loader is unloaded, and an instruction of a dex file freed then may
+// have the address of an instruction of a dex file opened later. The class linker calls
+// InvalidateAll on unloading, and the caches are then cleared on their next use.
+class InterpreterCache {
+ public:
+  // Power of two, so that computing the index is cheap.
+  static constexpr size_t kSize = 256;
+
+  InterpreterCache();
+
+  // Return the value cached for `inst` in `value`, or false if there is none.
+  template <typename T>
+  ALWAYS_INLINE bool Get(const Instruction* inst, /* out */ T** value) {
+    if (UNLIKELY(epoch_ != global_epoch_.LoadAcquire())) {
+      Clear();
+      return false;
+    }
+    const Entry& entry = entries_[IndexOf(inst)];
+    if (entry.first != inst) {
+      return false;
+    }
+    *value = reinterpret_cast<T*>(entry.second);
+    return true;
+  }
+
+  template <typename T>
+  ALWAYS_INLINE void Set(const Instruction* inst, T* value) {
+    entries_[IndexOf(inst)] = Entry(inst, reinterpret_cast<uintptr_t>(value));
+  }
+
+  void Clear();
+
+  // Invalidate the caches of all the threads, before the fields and methods of a class loader
+  // are freed.
+  static void InvalidateAll();
+
+ private:
+  using Entry = std::pair<const Instruction*, uintptr_t>;
+
+  static size_t IndexOf(const Instruction* inst) {
+    static_assert(IsPowerOfTwo(kSize), "Size must be a power of two");
+    // The instructions are at least two bytes apart.
+    return (reinterpret_cast<uintptr_t>(inst) >> 1) & (kSize - 1);
+  }
+
+  static Atomic<uint32_t> global_epoch_;
+
+  // The value of `global_epoch_` when the cache was last cleared. The cache is stale when they
+  // differ.
+  uint32_t epoch_;
+  std::array<Entry, kSize> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(InterpreterCache);
+};
+
+}  // namespace interpreter
+}  // namespace art
+
+#endif  // ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
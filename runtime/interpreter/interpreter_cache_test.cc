@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interpreter_cache.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace art {
+namespace interpreter {
+
+TEST(InterpreterCache, GetSet) {
+  std::unique_ptr<InterpreterCache> cache(new InterpreterCache());
+  uint16_t code[2 * InterpreterCache::kSize];
+  const Instruction* inst = reinterpret_cast<const Instruction*>(&code[0]);
+  const Instruction* next_inst = reinterpret_cast<const Instruction*>(&code[1]);
+  const Instruction* conflicting_inst =
+      reinterpret_cast<const Instruction*>(&code[InterpreterCache::kSize]);
+  int values[2];
+
+  int* value = nullptr;
+  EXPECT_FALSE(cache->Get(inst, &value));
+  cache->Set(inst, &values[0]);
+  ASSERT_TRUE(cache->Get(inst, &value));
+  EXPECT_EQ(&values[0], value);
+  EXPECT_FALSE(cache->Get(next_inst, &value));
+
+  // Instructions with the same index replace each other.
+  cache->Set(conflicting_inst, &values[1]);
+  EXPECT_FALSE(cache->Get(inst, &value));
+  ASSERT_TRUE(cache->Get(conflicting_inst, &value));
+  EXPECT_EQ(&values[1], value);
+
+  cache->Clear();
+  EXPECT_FALSE(cache->Get(conflicting_inst, &value));
+}
+
+TEST(InterpreterCache, InvalidateAll) {
+  std::unique_ptr<InterpreterCache> cache(new InterpreterCache());
+  uint16_t code[1];
+  const Instruction* inst = reinterpret_cast<const Instruction*>(&code[0]);
+  int values[1];
+  int* value = nullptr;
+  cache->Set(inst, &values[0]);
+  ASSERT_TRUE(cache->Get(inst, &value));
+  InterpreterCache::InvalidateAll();
+  EXPECT_FALSE(cache->Get(inst, &value));
+  // The cache can be used again after it was cleared.
+  cache->Set(inst, &values[0]);
+  EXPECT_TRUE(cache->Get(inst, &value));
+}
+
+}  // namespace interpreter
+}  // namespace art
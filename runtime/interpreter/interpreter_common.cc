@@ -22,6 +22,7 @@
 #include "debugger.h"
 #include "dex/dex_file_types.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
+#include "interpreter_cache.h"
 #include "intrinsics_enum.h"
 #include "jit/jit.h"
 #include "jvalue.h"
@@ -46,6 +47,31 @@ void ThrowNullPointerExceptionFromInterpreter() {
   ThrowNullPointerExceptionFromDexPC();
 }
 
+// Return the field accessed by `inst`, from the interpreter cache of `self` if the instruction
+// resolved it before. Only the fields of verified code are cached, since the access checks depend
+// on the method, and the static fields once their class is initialized, since FindFieldFromCode
+// initializes it. Transactions may roll the initialization back, so they do not use the cache.
+template<FindFieldType find_type, Primitive::Type field_type, bool do_access_check,
+         bool transaction_active>
+ALWAYS_INLINE static ArtField* FindFieldForInstruction(Thread* self,
+                                                       const ShadowFrame& shadow_frame,
+                                                       const Instruction* inst,
+                                                       uint32_t field_idx)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  constexpr bool use_cache = !do_access_check && !transaction_active;
+  InterpreterCache* cache = self->GetInterpreterCache();
+  ArtField* f;
+  if (use_cache && cache->Get(inst, &f)) {
+    return f;
+  }
+  f = FindFieldFromCode<find_type, do_access_check>(field_idx, shadow_frame.GetMethod(), self,
+                                                    Primitive::ComponentSize(field_type));
+  if (use_cache && f != nullptr && (!f->IsStatic() || f->GetDeclaringClass()->IsInitialized())) {
+    cache->Set(inst, f);
+  }
+  return f;
+}
+
 template<FindFieldType find_type, Primitive::Type field_type, bool do_access_check,
          bool transaction_active>
 bool DoFieldGet(Thread* self, ShadowFrame& shadow_frame, const Instruction* inst,
@@ -53,8 +79,8 @@ bool DoFieldGet(Thread* self, ShadowFrame& shadow_frame, const Instruction* inst
   const bool is_static = (find_type == StaticObjectRead) || (find_type == StaticPrimitiveRead);
   const uint32_t field_idx = is_static ? inst->VRegB_21c() : inst->VRegC_22c();
   ArtField* f =
-      FindFieldFromCode<find_type, do_access_check>(field_idx, shadow_frame.GetMethod(), self,
-                                                    Primitive::ComponentSize(field_type));
+      FindFieldForInstruction<find_type, field_type, do_access_check, transaction_active>(
+          self, shadow_frame, inst, field_idx);
   if (UNLIKELY(f == nullptr)) {
     CHECK(self->IsExceptionPending());
     return false;
@@ -266,8 +292,8 @@ bool DoFieldPut(Thread* self, const ShadowFrame& shadow_frame, const Instruction
   bool is_static = (find_type == StaticObjectWrite) || (find_type == StaticPrimitiveWrite);
   uint32_t field_idx = is_static ? inst->VRegB_21c() : inst->VRegC_22c();
   ArtField* f =
-      FindFieldFromCode<find_type, do_access_check>(field_idx, shadow_frame.GetMethod(), self,
-                                                    Primitive::ComponentSize(field_type));
+      FindFieldForInstruction<find_type, field_type, do_access_check, transaction_active>(
+          self, shadow_frame, inst, field_idx);
   if (UNLIKELY(f == nullptr)) {
     CHECK(self->IsExceptionPending());
     return false;
@@ -875,10 +901,21 @@ bool DoInvokePolymorphic(Thread* self,
                          uint16_t inst_data,
                          JValue* result) {
   const int invoke_method_idx = inst->VRegB();
-  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-  ArtMethod* invoke_method =
-      class_linker->ResolveMethod<ClassLinker::ResolveMode::kCheckICCEAndIAE>(
-          self, invoke_method_idx, shadow_frame.GetMethod(), kVirtual);
+  // The signature polymorphic methods are public methods of public classes, so the result of the
+  // access checks does not depend on the caller, and the method can be cached for the instruction.
+  InterpreterCache* cache = self->GetInterpreterCache();
+  ArtMethod* invoke_method;
+  if (!cache->Get(inst, &invoke_method)) {
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    invoke_method = class_linker->ResolveMethod<ClassLinker::ResolveMode::kCheckICCEAndIAE>(
+        self, invoke_method_idx, shadow_frame.GetMethod(), kVirtual);
+    if (UNLIKELY(invoke_method == nullptr)) {
+      DCHECK(self->IsExceptionPending());
+      result->SetJ(0);
+      return false;
+    }
+    cache->Set(inst, invoke_method);
+  }
 
   // Ensure intrinsic identifiers are initialized.
   DCHECK(invoke_method->IsIntrinsic());
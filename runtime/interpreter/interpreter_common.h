@@ -41,6 +41,7 @@
 #include "dex/dex_instruction-inl.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "handle_scope-inl.h"
+#include "interpreter_cache.h"
 #include "jit/jit.h"
 #include "mirror/call_site.h"
 #include "mirror/class-inl.h"
@@ -162,6 +163,38 @@ static inline bool DoFastInvoke(Thread* self,
   }
 }
 
+// Returns the method called by `inst`. The method `method_idx` resolves to comes from the
+// interpreter cache of `self` if the instruction resolved it before. The resolution only depends
+// on the dex file and the class loader of the code, but the access checks depend on the method, so
+// only verified code uses the cache.
+template<InvokeType type, bool do_access_check>
+ALWAYS_INLINE static ArtMethod* FindMethodForInstruction(Thread* self,
+                                                         const Instruction* inst,
+                                                         uint32_t method_idx,
+                                                         ObjPtr<mirror::Object>* receiver,
+                                                         ArtMethod* referrer)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (do_access_check) {
+    return FindMethodFromCode<type, do_access_check>(method_idx, receiver, referrer, self);
+  }
+  InterpreterCache* cache = self->GetInterpreterCache();
+  ArtMethod* resolved_method;
+  if (!cache->Get(inst, &resolved_method)) {
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    StackHandleScope<1> hs(self);
+    HandleWrapperObjPtr<mirror::Object> h_receiver(hs.NewHandleWrapper(receiver));
+    resolved_method = class_linker->ResolveMethod<ClassLinker::ResolveMode::kNoChecks>(
+        self, method_idx, referrer, type);
+    if (UNLIKELY(resolved_method == nullptr)) {
+      DCHECK(self->IsExceptionPending());
+      return nullptr;
+    }
+    cache->Set(inst, resolved_method);
+  }
+  return FindMethodToCall<type, do_access_check>(
+      method_idx, resolved_method, receiver, referrer, self);
+}
+
 // Handles all invoke-XXX/range instructions except for invoke-polymorphic[/range].
 // Returns true on success, otherwise throws an exception and returns false.
 template<InvokeType type, bool is_range, bool do_access_check>
@@ -179,8 +212,8 @@ static inline bool DoInvoke(Thread* self,
   ObjPtr<mirror::Object> receiver =
       (type == kStatic) ? nullptr : shadow_frame.GetVRegReference(vregC);
   ArtMethod* sf_method = shadow_frame.GetMethod();
-  ArtMethod* const called_method = FindMethodFromCode<type, do_access_check>(
-      method_idx, &receiver, sf_method, self);
+  ArtMethod* const called_method = FindMethodForInstruction<type, do_access_check>(
+      self, inst, method_idx, &receiver, sf_method);
   // The shadow frame should already be pushed, so we don't need to update it.
   if (UNLIKELY(called_method == nullptr)) {
     CHECK(self->IsExceptionPending());
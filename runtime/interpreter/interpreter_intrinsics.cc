@@ -498,6 +498,13 @@ bool MterpHandleIntrinsic(ShadowFrame* shadow_frame,
     UNIMPLEMENTED_CASE(MathRint /* (D)D */)
     UNIMPLEMENTED_CASE(MathRoundDouble /* (D)J */)
     UNIMPLEMENTED_CASE(MathRoundFloat /* (F)I */)
+    UNIMPLEMENTED_CASE(Adler32UpdateBytes /* (I[BII)I */)
+    UNIMPLEMENTED_CASE(Adler32UpdateByteBuffer /* (IJII)I */)
+    UNIMPLEMENTED_CASE(ArraysEqualsByte /* ([B[B)Z */)
+    UNIMPLEMENTED_CASE(ArraysFillByte /* ([BB)V */)
+    UNIMPLEMENTED_CASE(ArraysFillInt /* ([II)V */)
+    UNIMPLEMENTED_CASE(CRC32UpdateBytes /* (I[BII)I */)
+    UNIMPLEMENTED_CASE(CRC32UpdateByteBuffer /* (IJII)I */)
     UNIMPLEMENTED_CASE(SystemArrayCopyChar /* ([CI[CII)V */)
     UNIMPLEMENTED_CASE(SystemArrayCopy /* (Ljava/lang/Object;ILjava/lang/Object;II)V */)
     UNIMPLEMENTED_CASE(ThreadCurrentThread /* ()Ljava/lang/Thread; */)
@@ -837,7 +837,7 @@ void UnstartedRuntime::UnstartedSystemArraycopy(
     // Check that the second type is not primitive.
     mirror::Class* trg_type = shadow_frame->GetVRegReference(arg_offset + 2)->GetClass()->
         GetComponentType();
-    if (trg_type->IsPrimitiveInt()) {
+    if (trg_type->IsPrimitive()) {
       AbortTransactionOrFail(self, "Type mismatch in arraycopy: %s vs %s",
                              mirror::Class::PrettyDescriptor(
                                  src_array->GetClass()->GetComponentType()).c_str(),
@@ -879,6 +879,16 @@ void UnstartedRuntime::UnstartedSystemArraycopy(
     PrimitiveArrayCopy<uint16_t>(self, src_array, src_pos, dst_array, dst_pos, length);
   } else if (src_type->IsPrimitiveInt()) {
     PrimitiveArrayCopy<int32_t>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveBoolean()) {
+    PrimitiveArrayCopy<uint8_t>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveShort()) {
+    PrimitiveArrayCopy<int16_t>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveLong()) {
+    PrimitiveArrayCopy<int64_t>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveFloat()) {
+    PrimitiveArrayCopy<float>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveDouble()) {
+    PrimitiveArrayCopy<double>(self, src_array, src_pos, dst_array, dst_pos, length);
   } else {
     AbortTransactionOrFail(self, "Unimplemented System.arraycopy for type '%s'",
                            src_type->PrettyDescriptor().c_str());
@@ -903,6 +913,36 @@ void UnstartedRuntime::UnstartedSystemArraycopyInt(
   UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
 }
 
+void UnstartedRuntime::UnstartedSystemArraycopyBoolean(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
+void UnstartedRuntime::UnstartedSystemArraycopyShort(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
+void UnstartedRuntime::UnstartedSystemArraycopyLong(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
+void UnstartedRuntime::UnstartedSystemArraycopyFloat(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
+void UnstartedRuntime::UnstartedSystemArraycopyDouble(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
 void UnstartedRuntime::UnstartedSystemGetSecurityManager(
     Thread* self ATTRIBUTE_UNUSED, ShadowFrame* shadow_frame ATTRIBUTE_UNUSED,
     JValue* result, size_t arg_offset ATTRIBUTE_UNUSED) {
@@ -1789,10 +1829,33 @@ void UnstartedRuntime::UnstartedJNIStringCompareTo(
   mirror::String* rhs = reinterpret_cast<mirror::Object*>(args[0])->AsString();
   if (rhs == nullptr) {
     AbortTransactionOrFail(self, "String.compareTo with null object");
+    return;
   }
   result->SetI(receiver->AsString()->CompareTo(rhs));
 }
 
+void UnstartedRuntime::UnstartedJNIStringConcat(
+    Thread* self, ArtMethod* method ATTRIBUTE_UNUSED, mirror::Object* receiver, uint32_t* args,
+    JValue* result) {
+  mirror::Object* arg = reinterpret_cast<mirror::Object*>(args[0]);
+  if (arg == nullptr) {
+    AbortTransactionOrFail(self, "String.concat with null object");
+    return;
+  }
+  StackHandleScope<2> hs(self);
+  Handle<mirror::String> h_this(hs.NewHandle(receiver->AsString()));
+  Handle<mirror::String> h_arg(hs.NewHandle(arg->AsString()));
+  // Like the native implementation, return one of the strings if the other one is empty.
+  if (h_this->GetLength() == 0) {
+    result->SetL(h_arg.Get());
+  } else if (h_arg->GetLength() == 0) {
+    result->SetL(h_this.Get());
+  } else {
+    // Allocating is transaction safe, the new string is only reachable from the transaction.
+    result->SetL(mirror::String::AllocFromStrings(self, h_this, h_arg));
+  }
+}
+
 void UnstartedRuntime::UnstartedJNIStringIntern(
     Thread* self ATTRIBUTE_UNUSED, ArtMethod* method ATTRIBUTE_UNUSED, mirror::Object* receiver,
     uint32_t* args ATTRIBUTE_UNUSED, JValue* result) {
@@ -1913,6 +1976,39 @@ typedef void (*InvokeHandler)(Thread* self, ShadowFrame* shadow_frame, JValue* r
 typedef void (*JNIHandler)(Thread* self, ArtMethod* method, mirror::Object* receiver,
     uint32_t* args, JValue* result);
 
+static double GetDoubleArg(const uint32_t* args, size_t index) {
+  JValue value;
+  value.SetJ((static_cast<uint64_t>(args[index + 1]) << 32) | args[index]);
+  return value.GetD();
+}
+
+// The handlers of the pure natives, which have no side effects and can thus run in transactions.
+#define UNSTARTED_PURE_UNARY(ShortName, SigIgnored, Function)                         \
+  static void UnstartedJNIPure ## ShortName(Thread* self ATTRIBUTE_UNUSED,            \
+                                            ArtMethod* method ATTRIBUTE_UNUSED,       \
+                                            mirror::Object* receiver ATTRIBUTE_UNUSED, \
+                                            uint32_t* args,                            \
+                                            JValue* result) {                          \
+    result->SetD(Function(GetDoubleArg(args, 0)));                                     \
+  }
+#define UNSTARTED_PURE_BINARY(ShortName, SigIgnored, Function)                        \
+  static void UnstartedJNIPure ## ShortName(Thread* self ATTRIBUTE_UNUSED,            \
+                                            ArtMethod* method ATTRIBUTE_UNUSED,       \
+                                            mirror::Object* receiver ATTRIBUTE_UNUSED, \
+                                            uint32_t* args,                            \
+                                            JValue* result) {                          \
+    result->SetD(Function(GetDoubleArg(args, 0), GetDoubleArg(args, 2)));              \
+  }
+#include "unstarted_runtime_list.h"
+UNSTARTED_RUNTIME_PURE_UNARY_JNI_LIST(UNSTARTED_PURE_UNARY)
+UNSTARTED_RUNTIME_PURE_BINARY_JNI_LIST(UNSTARTED_PURE_BINARY)
+#undef UNSTARTED_RUNTIME_DIRECT_LIST
+#undef UNSTARTED_RUNTIME_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_UNARY_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_BINARY_JNI_LIST
+#undef UNSTARTED_PURE_BINARY
+#undef UNSTARTED_PURE_UNARY
+
 static bool tables_initialized_ = false;
 static std::unordered_map<std::string, InvokeHandler> invoke_handlers_;
 static std::unordered_map<std::string, JNIHandler> jni_handlers_;
@@ -1924,6 +2020,8 @@ void UnstartedRuntime::InitializeInvokeHandlers() {
   UNSTARTED_RUNTIME_DIRECT_LIST(UNSTARTED_DIRECT)
 #undef UNSTARTED_RUNTIME_DIRECT_LIST
 #undef UNSTARTED_RUNTIME_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_UNARY_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_BINARY_JNI_LIST
 #undef UNSTARTED_DIRECT
 }
 
@@ -1934,7 +2032,20 @@ void UnstartedRuntime::InitializeJNIHandlers() {
   UNSTARTED_RUNTIME_JNI_LIST(UNSTARTED_JNI)
 #undef UNSTARTED_RUNTIME_DIRECT_LIST
 #undef UNSTARTED_RUNTIME_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_UNARY_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_BINARY_JNI_LIST
 #undef UNSTARTED_JNI
+
+#define UNSTARTED_PURE(ShortName, Sig, FunctionIgnored) \
+  jni_handlers_.insert(std::make_pair(Sig, & UnstartedJNIPure ## ShortName));
+#include "unstarted_runtime_list.h"
+  UNSTARTED_RUNTIME_PURE_UNARY_JNI_LIST(UNSTARTED_PURE)
+  UNSTARTED_RUNTIME_PURE_BINARY_JNI_LIST(UNSTARTED_PURE)
+#undef UNSTARTED_RUNTIME_DIRECT_LIST
+#undef UNSTARTED_RUNTIME_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_UNARY_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_BINARY_JNI_LIST
+#undef UNSTARTED_PURE
 }
 
 void UnstartedRuntime::Initialize() {
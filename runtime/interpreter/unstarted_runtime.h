@@ -74,6 +74,8 @@ class UnstartedRuntime {
   UNSTARTED_RUNTIME_DIRECT_LIST(UNSTARTED_DIRECT)
 #undef UNSTARTED_RUNTIME_DIRECT_LIST
 #undef UNSTARTED_RUNTIME_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_UNARY_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_BINARY_JNI_LIST
 #undef UNSTARTED_DIRECT
 
   // Methods that are native.
@@ -88,6 +90,8 @@ class UnstartedRuntime {
   UNSTARTED_RUNTIME_JNI_LIST(UNSTARTED_JNI)
 #undef UNSTARTED_RUNTIME_DIRECT_LIST
 #undef UNSTARTED_RUNTIME_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_UNARY_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_BINARY_JNI_LIST
 #undef UNSTARTED_JNI
 
   static void UnstartedClassForNameCommon(Thread* self,
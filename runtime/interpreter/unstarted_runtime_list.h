@@ -41,6 +41,11 @@
   V(SystemArraycopyByte, "void java.lang.System.arraycopy(byte[], int, byte[], int, int)") \
   V(SystemArraycopyChar, "void java.lang.System.arraycopy(char[], int, char[], int, int)") \
   V(SystemArraycopyInt, "void java.lang.System.arraycopy(int[], int, int[], int, int)") \
+  V(SystemArraycopyBoolean, "void java.lang.System.arraycopy(boolean[], int, boolean[], int, int)") \
+  V(SystemArraycopyShort, "void java.lang.System.arraycopy(short[], int, short[], int, int)") \
+  V(SystemArraycopyLong, "void java.lang.System.arraycopy(long[], int, long[], int, int)") \
+  V(SystemArraycopyFloat, "void java.lang.System.arraycopy(float[], int, float[], int, int)") \
+  V(SystemArraycopyDouble, "void java.lang.System.arraycopy(double[], int, double[], int, int)") \
   V(SystemGetSecurityManager, "java.lang.SecurityManager java.lang.System.getSecurityManager()") \
   V(SystemGetProperty, "java.lang.String java.lang.System.getProperty(java.lang.String)") \
   V(SystemGetPropertyWithDefault, "java.lang.String java.lang.System.getProperty(java.lang.String, java.lang.String)") \
@@ -94,6 +99,7 @@
   V(ObjectInternalClone, "java.lang.Object java.lang.Object.internalClone()") \
   V(ObjectNotifyAll, "void java.lang.Object.notifyAll()") \
   V(StringCompareTo, "int java.lang.String.compareTo(java.lang.String)") \
+  V(StringConcat, "java.lang.String java.lang.String.concat(java.lang.String)") \
   V(StringIntern, "java.lang.String java.lang.String.intern()") \
   V(ArrayCreateMultiArray, "java.lang.Object java.lang.reflect.Array.createMultiArray(java.lang.Class, int[])") \
   V(ArrayCreateObjectArray, "java.lang.Object java.lang.reflect.Array.createObjectArray(java.lang.Class, int)") \
@@ -105,6 +111,28 @@
   V(UnsafeGetArrayBaseOffsetForComponentType, "int sun.misc.Unsafe.getArrayBaseOffsetForComponentType(java.lang.Class)") \
   V(UnsafeGetArrayIndexScaleForComponentType, "int sun.misc.Unsafe.getArrayIndexScaleForComponentType(java.lang.Class)")
 
+// Native methods that are pure functions of their double arguments, with the libm function
+// computing them. Adding a native here is enough to support it.
+#define UNSTARTED_RUNTIME_PURE_UNARY_JNI_LIST(V) \
+  V(MathAcos, "double java.lang.Math.acos(double)", acos) \
+  V(MathAsin, "double java.lang.Math.asin(double)", asin) \
+  V(MathAtan, "double java.lang.Math.atan(double)", atan) \
+  V(MathCbrt, "double java.lang.Math.cbrt(double)", cbrt) \
+  V(MathCosh, "double java.lang.Math.cosh(double)", cosh) \
+  V(MathExpm1, "double java.lang.Math.expm1(double)", expm1) \
+  V(MathLog10, "double java.lang.Math.log10(double)", log10) \
+  V(MathLog1p, "double java.lang.Math.log1p(double)", log1p) \
+  V(MathRint, "double java.lang.Math.rint(double)", rint) \
+  V(MathSinh, "double java.lang.Math.sinh(double)", sinh) \
+  V(MathSqrt, "double java.lang.Math.sqrt(double)", sqrt) \
+  V(MathTan, "double java.lang.Math.tan(double)", tan) \
+  V(MathTanh, "double java.lang.Math.tanh(double)", tanh)
+
+#define UNSTARTED_RUNTIME_PURE_BINARY_JNI_LIST(V) \
+  V(MathAtan2, "double java.lang.Math.atan2(double, double)", atan2) \
+  V(MathHypot, "double java.lang.Math.hypot(double, double)", hypot) \
+  V(MathIEEEremainder, "double java.lang.Math.IEEEremainder(double, double)", remainder)
+
 #endif  // ART_RUNTIME_INTERPRETER_UNSTARTED_RUNTIME_LIST_H_
 // the guard in this file is just for cpplint
 #undef ART_RUNTIME_INTERPRETER_UNSTARTED_RUNTIME_LIST_H_
@@ -29,6 +29,7 @@
 #include "handle.h"
 #include "handle_scope-inl.h"
 #include "interpreter/interpreter_common.h"
+#include "mirror/array-inl.h"
 #include "mirror/class_loader.h"
 #include "mirror/object-inl.h"
 #include "mirror/object_array-inl.h"
@@ -59,6 +60,8 @@ class UnstartedRuntimeTest : public CommonRuntimeTest {
   UNSTARTED_RUNTIME_DIRECT_LIST(UNSTARTED_DIRECT)
 #undef UNSTARTED_RUNTIME_DIRECT_LIST
 #undef UNSTARTED_RUNTIME_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_UNARY_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_BINARY_JNI_LIST
 #undef UNSTARTED_DIRECT
 
   // Methods that are native.
@@ -75,6 +78,8 @@ class UnstartedRuntimeTest : public CommonRuntimeTest {
   UNSTARTED_RUNTIME_JNI_LIST(UNSTARTED_JNI)
 #undef UNSTARTED_RUNTIME_DIRECT_LIST
 #undef UNSTARTED_RUNTIME_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_UNARY_JNI_LIST
+#undef UNSTARTED_RUNTIME_PURE_BINARY_JNI_LIST
 #undef UNSTARTED_JNI
 
   // Helpers for ArrayCopy.
@@ -1402,5 +1407,86 @@ TEST_F(UnstartedRuntimeTest, IdentityHashCode) {
   ShadowFrame::DeleteDeoptimizedFrame(tmp);
 }
 
+TEST_F(UnstartedRuntimeTest, SystemArrayCopyLongArray) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  JValue result;
+  ShadowFrame* tmp = ShadowFrame::CreateDeoptimizedFrame(10, nullptr, nullptr, 0);
+
+  StackHandleScope<1> hs(self);
+  Handle<mirror::LongArray> array(hs.NewHandle(mirror::LongArray::Alloc(self, 4)));
+  ASSERT_TRUE(array != nullptr);
+  for (int32_t i = 0; i != 4; ++i) {
+    array->Set(i, INT64_C(0x100000000) + i);
+  }
+
+  // Overlapping copy: [0,1,2,3]{0 @ 3} into itself at 1 = [0,0,1,2].
+  tmp->SetVRegReference(0, array.Get());
+  tmp->SetVReg(1, 0);
+  tmp->SetVRegReference(2, array.Get());
+  tmp->SetVReg(3, 1);
+  tmp->SetVReg(4, 3);
+  UnstartedSystemArraycopyLong(self, tmp, &result, 0);
+  ASSERT_FALSE(self->IsExceptionPending());
+  EXPECT_EQ(INT64_C(0x100000000), array->Get(0));
+  EXPECT_EQ(INT64_C(0x100000000), array->Get(1));
+  EXPECT_EQ(INT64_C(0x100000001), array->Get(2));
+  EXPECT_EQ(INT64_C(0x100000002), array->Get(3));
+
+  ShadowFrame::DeleteDeoptimizedFrame(tmp);
+}
+
+TEST_F(UnstartedRuntimeTest, StringConcat) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+
+  StackHandleScope<3> hs(self);
+  Handle<mirror::String> lhs(hs.NewHandle(mirror::String::AllocFromModifiedUtf8(self, "ab")));
+  Handle<mirror::String> rhs(hs.NewHandle(mirror::String::AllocFromModifiedUtf8(self, "cd")));
+  Handle<mirror::String> empty(hs.NewHandle(mirror::String::AllocFromModifiedUtf8(self, "")));
+
+  JValue result;
+  uint32_t args[1] = { static_cast<uint32_t>(reinterpret_cast<uintptr_t>(rhs.Get())) };
+  UnstartedJNIStringConcat(self, nullptr, lhs.Get(), args, &result);
+  ASSERT_TRUE(result.GetL() != nullptr);
+  EXPECT_EQ("abcd", result.GetL()->AsString()->ToModifiedUtf8());
+
+  // The other string is returned when one of them is empty.
+  UnstartedJNIStringConcat(self, nullptr, empty.Get(), args, &result);
+  EXPECT_EQ(rhs.Get(), result.GetL());
+
+  ASSERT_FALSE(self->IsExceptionPending());
+}
+
+TEST_F(UnstartedRuntimeTest, PureNatives) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  ObjPtr<mirror::Class> math_class =
+      class_linker->FindClass(self, "Ljava/lang/Math;", ScopedNullHandle<mirror::ClassLoader>());
+  ASSERT_TRUE(math_class != nullptr);
+
+  auto invoke = [&](const char* name, const char* signature, double arg1, double arg2)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    ArtMethod* method =
+        math_class->FindClassMethod(name, signature, class_linker->GetImagePointerSize());
+    CHECK(method != nullptr) << name;
+    uint32_t args[4];
+    memcpy(&args[0], &arg1, sizeof(double));
+    memcpy(&args[2], &arg2, sizeof(double));
+    JValue result;
+    UnstartedRuntime::Jni(self, method, nullptr, args, &result);
+    return result.GetD();
+  };
+
+  EXPECT_EQ(3.0, invoke("sqrt", "(D)D", 9.0, 0.0));
+  EXPECT_EQ(2.0, invoke("log10", "(D)D", 100.0, 0.0));
+  EXPECT_EQ(4.0, invoke("rint", "(D)D", 4.4, 0.0));
+  EXPECT_EQ(5.0, invoke("hypot", "(DD)D", 3.0, 4.0));
+  EXPECT_EQ(-1.0, invoke("IEEEremainder", "(DD)D", 5.0, 3.0));
+  ASSERT_FALSE(self->IsExceptionPending());
+}
+
 }  // namespace interpreter
 }  // namespace art
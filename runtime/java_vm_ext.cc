@@ -18,6 +18,8 @@
 
 #include <dlfcn.h>
 
+#include <algorithm>
+
 #include "android-base/stringprintf.h"
 
 #include "art_method-inl.h"
@@ -44,6 +46,7 @@
 #include "runtime-inl.h"
 #include "runtime_options.h"
 #include "scoped_thread_state_change-inl.h"
+#include "startup_timings.h"
 #include "sigchain.h"
 #include "thread-inl.h"
 #include "thread_list.h"
@@ -59,6 +62,9 @@ static constexpr size_t kGlobalsMax = 51200;  // Arbitrary sanity check. (Must f
 
 static constexpr size_t kWeakGlobalsMax = 51200;  // Arbitrary sanity check. (Must fit in 16 bits.)
 
+// The number of weak global entries swept per critical section of SweepJniWeakGlobals.
+static constexpr size_t kWeakGlobalsSweepBatchSize = 1024;
+
 bool JavaVMExt::IsBadJniVersion(int version) {
   // We don't support JNI_VERSION_1_1. These are the only other valid versions.
   return version != JNI_VERSION_1_2 && version != JNI_VERSION_1_4 && version != JNI_VERSION_1_6;
@@ -855,6 +861,7 @@ bool JavaVMExt::LoadNativeLibrary(JNIEnv* env,
                                   const std::string& path,
                                   jobject class_loader,
                                   std::string* error_msg) {
+  ScopedStartupTiming timing(StartupTimings::kNativeLibraryLoading, path.c_str());
   error_msg->clear();
 
   // See if we've already loaded this library.  If we have, and the class loader
@@ -1094,19 +1101,34 @@ void* JavaVMExt::FindCodeForNativeMethod(ArtMethod* m) {
 }
 
 void JavaVMExt::SweepJniWeakGlobals(IsMarkedVisitor* visitor) {
-  MutexLock mu(Thread::Current(), *Locks::jni_weak_globals_lock_);
+  Thread* self = Thread::Current();
   Runtime* const runtime = Runtime::Current();
-  for (auto* entry : weak_globals_) {
-    // Need to skip null here to distinguish between null entries and cleared weak ref entries.
-    if (!entry->IsNull()) {
-      // Since this is called by the GC, we don't need a read barrier.
-      mirror::Object* obj = entry->Read<kWithoutReadBarrier>();
-      mirror::Object* new_obj = visitor->IsMarked(obj);
-      if (new_obj == nullptr) {
-        new_obj = runtime->GetClearedJniWeakGlobal();
+  // Release the lock between batches of entries, so that the mutators adding and deleting weak
+  // globals are not blocked for the whole sweep. Without read barriers, adding and decoding
+  // wait for the sweep anyway. With read barriers, any object added meanwhile is marked.
+  size_t start = 0u;
+  while (true) {
+    MutexLock mu(self, *Locks::jni_weak_globals_lock_);
+    size_t capacity = weak_globals_.Capacity();
+    if (start >= capacity) {
+      break;
+    }
+    size_t batch_end = std::min(capacity, start + kWeakGlobalsSweepBatchSize);
+    IrtIterator end = weak_globals_.IteratorAt(batch_end);
+    for (IrtIterator it = weak_globals_.IteratorAt(start); it != end; ++it) {
+      GcRoot<mirror::Object>* entry = *it;
+      // Need to skip null here to distinguish between null entries and cleared weak ref entries.
+      if (!entry->IsNull()) {
+        // Since this is called by the GC, we don't need a read barrier.
+        mirror::Object* obj = entry->Read<kWithoutReadBarrier>();
+        mirror::Object* new_obj = visitor->IsMarked(obj);
+        if (new_obj == nullptr) {
+          new_obj = runtime->GetClearedJniWeakGlobal();
+        }
+        *entry = GcRoot<mirror::Object>(new_obj);
       }
-      *entry = GcRoot<mirror::Object>(new_obj);
     }
+    start = batch_end;
   }
 }
 
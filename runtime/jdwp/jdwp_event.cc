@@ -31,6 +31,7 @@
 #include "jdwp/jdwp_expand_buf.h"
 #include "jdwp/jdwp_priv.h"
 #include "jdwp/object_registry.h"
+#include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
 
@@ -147,6 +148,11 @@ static bool NeedsFullDeoptimization(JdwpEventKind eventKind) {
       case EK_METHOD_ENTRY:
       case EK_METHOD_EXIT:
       case EK_METHOD_EXIT_WITH_RETURN_VALUE:
+        // Java debuggable code is compiled without inlining and calls other methods through their
+        // entrypoints, so the instrumentation entry and exit stubs that the debugger installs
+        // along with the listener see every call. Otherwise inlined calls are only reported by
+        // the interpreter.
+        return !Runtime::Current()->IsJavaDebuggable();
       case EK_FIELD_ACCESS:
       case EK_FIELD_MODIFICATION:
         return true;
@@ -251,16 +251,37 @@ void RemoveNativeDebugInfoForDex(Thread* current_thread, ArrayRef<const uint8_t>
   }
 }
 
+// Repack once that many methods have an ELF file of their own. Smaller ELF files are a waste of
+// memory, larger ones leave more methods with an ELF file of their own.
+static constexpr size_t kJitRepackThreshold = 32;
+
 static size_t __jit_debug_mem_usage
     GUARDED_BY(Locks::native_debug_interface_lock_) = 0;
 
-// Mapping from handle to entry. Used to manage life-time of the entries.
+// Mapping from handle to entry. Used to manage life-time of the entries. The entry is null for
+// live code whose shared ELF file was dropped, until that code is repacked.
 static std::unordered_map<const void*, JITCodeEntry*> __jit_debug_entries
     GUARDED_BY(Locks::native_debug_interface_lock_);
 
-void AddNativeDebugInfoForJit(const void* handle, const std::vector<uint8_t>& symfile) {
-  DCHECK_NE(symfile.size(), 0u);
+// The number of methods described by each entry with a handle, and how many of them have
+// not been removed yet.
+struct JITCodeEntryMethods {
+  size_t num_methods;
+  size_t num_live_methods;
+};
+static std::unordered_map<JITCodeEntry*, JITCodeEntryMethods> __jit_debug_entry_methods
+    GUARDED_BY(Locks::native_debug_interface_lock_);
+
+// The number of entries describing a single method.
+static size_t __jit_debug_num_unpacked_entries
+    GUARDED_BY(Locks::native_debug_interface_lock_) = 0;
+
+// The number of handles without an entry, which must be repacked.
+static size_t __jit_debug_num_dropped_handles
+    GUARDED_BY(Locks::native_debug_interface_lock_) = 0;
 
+static JITCodeEntry* CreateJITCodeEntryForSymfile(const std::vector<uint8_t>& symfile)
+    REQUIRES(Locks::native_debug_interface_lock_) {
   // Make a copy of the buffer to shrink it and to pass ownership to JITCodeEntry.
   uint8_t* copy = new uint8_t[symfile.size()];
   CHECK(copy != nullptr);
@@ -271,12 +292,57 @@ void AddNativeDebugInfoForJit(const void* handle, const std::vector<uint8_t>& sy
       __jit_debug_register_code_ptr,
       ArrayRef<const uint8_t>(copy, symfile.size()));
   __jit_debug_mem_usage += sizeof(JITCodeEntry) + entry->symfile_size_;
+  return entry;
+}
+
+// Remove one method of `entry`, and the entry itself with its last method.
+static void RemoveMethodFromJITCodeEntry(JITCodeEntry* entry, bool code_freed)
+    REQUIRES(Locks::native_debug_interface_lock_) {
+  auto it = __jit_debug_entry_methods.find(entry);
+  DCHECK(it != __jit_debug_entry_methods.end());
+  DCHECK_NE(it->second.num_live_methods, 0u);
+  if (--it->second.num_live_methods != 0u) {
+    if (!code_freed) {
+      // Being repacked, the entry goes away with its last method.
+      return;
+    }
+    // The symbols and the CFI of the freed code must not describe the code which may be
+    // allocated at the same address next, so drop the entry. Its other methods are left
+    // without an entry until the next repacking.
+    for (auto& handle_and_entry : __jit_debug_entries) {
+      if (handle_and_entry.second == entry) {
+        handle_and_entry.second = nullptr;
+        ++__jit_debug_num_dropped_handles;
+      }
+    }
+  }
+  if (it->second.num_methods == 1u) {
+    --__jit_debug_num_unpacked_entries;
+  }
+  __jit_debug_entry_methods.erase(it);
+  const uint8_t* symfile_addr = entry->symfile_addr_;
+  uint64_t symfile_size = entry->symfile_size_;
+  DeleteJITCodeEntryInternal(__jit_debug_descriptor,
+                             __jit_debug_register_code_ptr,
+                             entry);
+  __jit_debug_mem_usage -= sizeof(JITCodeEntry) + symfile_size;
+  delete[] symfile_addr;
+}
+
+void AddNativeDebugInfoForJit(const void* handle, const std::vector<uint8_t>& symfile) {
+  DCHECK_NE(symfile.size(), 0u);
+
+  JITCodeEntry* entry = CreateJITCodeEntryForSymfile(symfile);
 
   // We don't provide handle for type debug info, which means we cannot free it later.
   // (this only happens when --generate-debug-info flag is enabled for the purpose
   // of being debugged with gdb; it does not happen for debuggable apps by default).
-  bool ok = handle == nullptr || __jit_debug_entries.emplace(handle, entry).second;
-  DCHECK(ok) << "Native debug entry already exists for " << std::hex << handle;
+  if (handle != nullptr) {
+    bool ok = __jit_debug_entries.emplace(handle, entry).second;
+    DCHECK(ok) << "Native debug entry already exists for " << std::hex << handle;
+    __jit_debug_entry_methods.emplace(entry, JITCodeEntryMethods{1u, 1u});
+    ++__jit_debug_num_unpacked_entries;
+  }
 }
 
 void RemoveNativeDebugInfoForJit(const void* handle) {
@@ -285,19 +351,66 @@ void RemoveNativeDebugInfoForJit(const void* handle) {
   // but we try to remove it unconditionally whenever code is freed from JIT cache.
   if (it != __jit_debug_entries.end()) {
     JITCodeEntry* entry = it->second;
-    const uint8_t* symfile_addr = entry->symfile_addr_;
-    uint64_t symfile_size = entry->symfile_size_;
-    DeleteJITCodeEntryInternal(__jit_debug_descriptor,
-                               __jit_debug_register_code_ptr,
-                               entry);
     __jit_debug_entries.erase(it);
-    __jit_debug_mem_usage -= sizeof(JITCodeEntry) + symfile_size;
-    delete[] symfile_addr;
+    if (entry == nullptr) {
+      --__jit_debug_num_dropped_handles;
+    } else {
+      RemoveMethodFromJITCodeEntry(entry, /* code_freed */ true);
+    }
+  }
+}
+
+bool HasNativeDebugInfoForJit(const void* handle) {
+  return __jit_debug_entries.find(handle) != __jit_debug_entries.end();
+}
+
+std::vector<const void*> GetNativeDebugInfoForJitToRepack() {
+  std::vector<const void*> handles;
+  if (__jit_debug_num_unpacked_entries < kJitRepackThreshold &&
+      __jit_debug_num_dropped_handles == 0u) {
+    return handles;
+  }
+  for (const auto& it : __jit_debug_entries) {
+    if (it.second == nullptr) {
+      // Code left without an entry is always repacked.
+      handles.push_back(it.first);
+      continue;
+    }
+    if (__jit_debug_entry_methods.find(it.second)->second.num_methods == 1u) {
+      handles.push_back(it.first);
+    }
+  }
+  return handles;
+}
+
+void RepackNativeDebugInfoForJit(ArrayRef<const void* const> handles,
+                                 const std::vector<uint8_t>& symfile) {
+  DCHECK_NE(symfile.size(), 0u);
+  DCHECK(!handles.empty());
+
+  // Register the new entry before deleting the old ones, so that the code is always described.
+  JITCodeEntry* entry = CreateJITCodeEntryForSymfile(symfile);
+  for (const void* handle : handles) {
+    auto it = __jit_debug_entries.find(handle);
+    DCHECK(it != __jit_debug_entries.end()) << "No native debug entry for " << std::hex << handle;
+    JITCodeEntry* old_entry = it->second;
+    it->second = entry;
+    if (old_entry == nullptr) {
+      --__jit_debug_num_dropped_handles;
+    } else {
+      RemoveMethodFromJITCodeEntry(old_entry, /* code_freed */ false);
+    }
+  }
+  __jit_debug_entry_methods.emplace(entry, JITCodeEntryMethods{handles.size(), handles.size()});
+  if (handles.size() == 1u) {
+    ++__jit_debug_num_unpacked_entries;
   }
 }
 
 size_t GetJitNativeDebugInfoMemUsage() {
-  return __jit_debug_mem_usage + __jit_debug_entries.size() * 2 * sizeof(void*);
+  return __jit_debug_mem_usage +
+      __jit_debug_entries.size() * 2 * sizeof(void*) +
+      __jit_debug_entry_methods.size() * (sizeof(JITCodeEntryMethods) + 2 * sizeof(void*));
 }
 
 }  // namespace art
@@ -41,9 +41,27 @@ void AddNativeDebugInfoForJit(const void* handle, const std::vector<uint8_t>& sy
     REQUIRES(Locks::native_debug_interface_lock_);
 
 // Notify native debugger that JITed code has been removed and free the debug info.
+// A repacked ELF file describing the code together with other code is freed too: the other
+// code is left without debug info until it is repacked, see GetNativeDebugInfoForJitToRepack().
 void RemoveNativeDebugInfoForJit(const void* handle)
     REQUIRES(Locks::native_debug_interface_lock_);
 
+// Returns whether there is debug info for the JITed code of `handle`.
+bool HasNativeDebugInfoForJit(const void* handle)
+    REQUIRES(Locks::native_debug_interface_lock_);
+
+// Returns the handles of the JITed code whose debug info should be repacked into a single ELF
+// file, or an empty vector if it is not yet worth it. These are the code added since the last
+// repacking, along with the code left without debug info when other code was removed.
+std::vector<const void*> GetNativeDebugInfoForJitToRepack()
+    REQUIRES(Locks::native_debug_interface_lock_);
+
+// Replace the debug info of the JITed code of `handles` by the in-memory ELF `symfile`, which
+// describes all of them. The method will make copy of the passed ELF file.
+void RepackNativeDebugInfoForJit(ArrayRef<const void* const> handles,
+                                 const std::vector<uint8_t>& symfile)
+    REQUIRES(Locks::native_debug_interface_lock_);
+
 // Returns approximate memory used by all JITCodeEntries.
 size_t GetJitNativeDebugInfoMemUsage()
     REQUIRES(Locks::native_debug_interface_lock_);
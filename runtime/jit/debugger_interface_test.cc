@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "debugger_interface.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/array_ref.h"
+#include "base/mutex.h"
+#include "common_runtime_test.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+class DebuggerInterfaceTest : public CommonRuntimeTest {};
+
+// Freeing code described by a repacked ELF file drops that file, and the code left without
+// debug info is repacked next, however little of it there is.
+TEST_F(DebuggerInterfaceTest, FreeRepackedCode) {
+  MutexLock mu(Thread::Current(), *Locks::native_debug_interface_lock_);
+  // The debugger only reads the symfiles, which the registration does not parse.
+  const std::vector<uint8_t> symfile(64u, 0u);
+  const std::vector<uint8_t> repacked_symfile(128u, 0u);
+  const uint8_t code[2] = { 0u, 0u };
+  const void* const handles[] = { &code[0], &code[1] };
+
+  size_t initial_mem_usage = GetJitNativeDebugInfoMemUsage();
+  AddNativeDebugInfoForJit(handles[0], symfile);
+  AddNativeDebugInfoForJit(handles[1], symfile);
+  RepackNativeDebugInfoForJit(ArrayRef<const void* const>(handles), repacked_symfile);
+  EXPECT_TRUE(HasNativeDebugInfoForJit(handles[0]));
+  EXPECT_TRUE(HasNativeDebugInfoForJit(handles[1]));
+  std::vector<const void*> to_repack = GetNativeDebugInfoForJitToRepack();
+  EXPECT_TRUE(std::find(to_repack.begin(), to_repack.end(), handles[1]) == to_repack.end());
+  size_t repacked_mem_usage = GetJitNativeDebugInfoMemUsage();
+  EXPECT_GE(repacked_mem_usage, initial_mem_usage + repacked_symfile.size());
+
+  // The symbols of the freed code must not outlive it.
+  RemoveNativeDebugInfoForJit(handles[0]);
+  EXPECT_FALSE(HasNativeDebugInfoForJit(handles[0]));
+  EXPECT_TRUE(HasNativeDebugInfoForJit(handles[1]));
+  EXPECT_LE(GetJitNativeDebugInfoMemUsage() + repacked_symfile.size(), repacked_mem_usage);
+  to_repack = GetNativeDebugInfoForJitToRepack();
+  EXPECT_TRUE(std::find(to_repack.begin(), to_repack.end(), handles[1]) != to_repack.end());
+  EXPECT_TRUE(std::find(to_repack.begin(), to_repack.end(), handles[0]) == to_repack.end());
+
+  const void* const live_handles[] = { handles[1] };
+  RepackNativeDebugInfoForJit(ArrayRef<const void* const>(live_handles), symfile);
+  EXPECT_TRUE(HasNativeDebugInfoForJit(handles[1]));
+  to_repack = GetNativeDebugInfoForJitToRepack();
+  EXPECT_TRUE(std::find(to_repack.begin(), to_repack.end(), handles[1]) == to_repack.end());
+
+  RemoveNativeDebugInfoForJit(handles[1]);
+  EXPECT_FALSE(HasNativeDebugInfoForJit(handles[1]));
+  EXPECT_EQ(initial_mem_usage, GetJitNativeDebugInfoMemUsage());
+}
+
+}  // namespace art
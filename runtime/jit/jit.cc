@@ -18,11 +18,15 @@
 
 #include <dlfcn.h>
 
+#include <algorithm>
+
 #include "art_method-inl.h"
 #include "base/enums.h"
+#include "base/file_utils.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/memory_tool.h"
 #include "base/runtime_debug.h"
+#include "base/time_utils.h"
 #include "base/utils.h"
 #include "debugger.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
@@ -30,6 +34,7 @@
 #include "java_vm_ext.h"
 #include "jit_code_cache.h"
 #include "oat_file_manager.h"
+#include "object_callbacks.h"
 #include "oat_quick_method_header.h"
 #include "profile_compilation_info.h"
 #include "profile_saver.h"
@@ -37,9 +42,14 @@
 #include "runtime_options.h"
 #include "stack.h"
 #include "stack_map.h"
+#include "stats_region.h"
 #include "thread-inl.h"
 #include "thread_list.h"
 
+#ifdef VTUNE_ART
+#include "vtune_tasks.h"
+#endif
+
 namespace art {
 namespace jit {
 
@@ -47,6 +57,14 @@ static constexpr bool kEnableOnStackReplacement = true;
 // At what priority to schedule jit threads. 9 is the lowest foreground priority on device.
 static constexpr int kJitPoolThreadPthreadPriority = 9;
 
+// Default number of JIT threads, and the maximum when adapting to the load.
+static constexpr size_t kJitDefaultThreadCount = 1;
+static constexpr size_t kJitMaxAdaptiveThreadCount = 8;
+// In adaptive mode, another thread starts compiling for every that many queued compilations,
+// and the idle cores are sampled at most that often.
+static constexpr size_t kJitAdaptiveQueueDepthPerThread = 4;
+static constexpr uint64_t kJitAdaptiveIdleCoresUpdateNs = MsToNs(100);
+
 // Different compilation threshold constants. These can be overridden on the command line.
 static constexpr size_t kJitDefaultCompileThreshold           = 10000;  // Non-debug default.
 static constexpr size_t kJitStressDefaultCompileThreshold     = 100;    // Fast-debug build.
@@ -57,7 +75,7 @@ void* Jit::jit_library_handle_ = nullptr;
 void* Jit::jit_compiler_handle_ = nullptr;
 void* (*Jit::jit_load_)(bool*) = nullptr;
 void (*Jit::jit_unload_)(void*) = nullptr;
-bool (*Jit::jit_compile_method_)(void*, ArtMethod*, Thread*, bool) = nullptr;
+bool (*Jit::jit_compile_method_)(void*, ArtMethod*, Thread*, bool, bool) = nullptr;
 void (*Jit::jit_types_loaded_)(void*, mirror::Class**, size_t count) = nullptr;
 bool Jit::generate_debug_info_ = false;
 
@@ -76,6 +94,7 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::JITCodeCacheMaxCapacity);
   jit_options->dump_info_on_shutdown_ =
       options.Exists(RuntimeArgumentMap::DumpJITInfoOnShutdown);
+  jit_options->warm_start_ = options.Exists(RuntimeArgumentMap::JITWarmStart);
   jit_options->profile_saver_options_ =
       options.GetOrDefault(RuntimeArgumentMap::ProfileSaverOpts);
 
@@ -93,11 +112,21 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
     LOG(FATAL) << "Method compilation threshold is above its internal limit.";
   }
 
+  if (options.Exists(RuntimeArgumentMap::JITBaselineThreshold)) {
+    jit_options->baseline_threshold_ = *options.Get(RuntimeArgumentMap::JITBaselineThreshold);
+    if (jit_options->baseline_threshold_ > std::numeric_limits<uint16_t>::max()) {
+      LOG(FATAL) << "Method baseline compilation threshold is above its internal limit.";
+    }
+  }
+
   if (options.Exists(RuntimeArgumentMap::JITWarmupThreshold)) {
     jit_options->warmup_threshold_ = *options.Get(RuntimeArgumentMap::JITWarmupThreshold);
     if (jit_options->warmup_threshold_ > std::numeric_limits<uint16_t>::max()) {
       LOG(FATAL) << "Method warmup threshold is above its internal limit.";
     }
+  } else if (jit_options->baseline_threshold_ != 0) {
+    // Methods need a ProfilingInfo before their baseline compilation.
+    jit_options->warmup_threshold_ = jit_options->baseline_threshold_ / 2;
   } else {
     jit_options->warmup_threshold_ = jit_options->compile_threshold_ / 2;
   }
@@ -114,6 +143,13 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
     }
   }
 
+  if (jit_options->baseline_threshold_ != 0 &&
+      (jit_options->baseline_threshold_ <= jit_options->warmup_threshold_ ||
+       jit_options->baseline_threshold_ >= jit_options->osr_threshold_)) {
+    LOG(FATAL) << "Method baseline compilation threshold is not between the warmup and "
+               << "the on stack replacement thresholds.";
+  }
+
   if (options.Exists(RuntimeArgumentMap::JITPriorityThreadWeight)) {
     jit_options->priority_thread_weight_ =
         *options.Get(RuntimeArgumentMap::JITPriorityThreadWeight);
@@ -142,6 +178,12 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
         static_cast<size_t>(1));
   }
 
+  if (options.Exists(RuntimeArgumentMap::JITThreads)) {
+    jit_options->thread_count_ = *options.Get(RuntimeArgumentMap::JITThreads);
+  } else {
+    jit_options->thread_count_ = kJitDefaultThreadCount;
+  }
+
   return jit_options;
 }
 
@@ -174,7 +216,22 @@ Jit::Jit() : dump_info_on_shutdown_(false),
              warm_method_threshold_(0),
              osr_method_threshold_(0),
              priority_thread_weight_(0),
-             invoke_transition_weight_(0) {}
+             invoke_transition_weight_(0),
+             use_baseline_compilation_(false),
+             optimize_method_threshold_(0),
+             thread_count_(kJitDefaultThreadCount),
+             adaptive_thread_count_(false),
+             active_thread_count_(1u),
+             idle_cores_(0u),
+             idle_cores_update_ns_(0u),
+             has_optimized_requests_(false),
+             compile_queue_lock_("JIT compile queue lock"),
+             warm_start_(false),
+             warm_start_lock_("JIT warm start lock") {
+  for (std::atomic<ArtMethod*>& request : optimized_requests_) {
+    request.store(nullptr, std::memory_order_relaxed);
+  }
+}
 
 Jit* Jit::Create(JitOptions* options, std::string* error_msg) {
   DCHECK(options->UseJitCompilation() || options->GetProfileSaverOptions().IsEnabled());
@@ -195,6 +252,9 @@ Jit* Jit::Create(JitOptions* options, std::string* error_msg) {
   }
   jit->use_jit_compilation_ = options->UseJitCompilation();
   jit->profile_saver_options_ = options->GetProfileSaverOptions();
+  jit->warm_start_ = options->GetWarmStart() &&
+                     options->UseJitCompilation() &&
+                     options->GetCompileThreshold() != 0u;
   VLOG(jit) << "JIT created with initial_capacity="
       << PrettySize(options->GetCodeCacheInitialCapacity())
       << ", max_capacity=" << PrettySize(options->GetCodeCacheMaxCapacity())
@@ -202,11 +262,40 @@ Jit* Jit::Create(JitOptions* options, std::string* error_msg) {
       << ", profile_saver_options=" << options->GetProfileSaverOptions();
 
 
-  jit->hot_method_threshold_ = options->GetCompileThreshold();
+  jit->use_baseline_compilation_ = options->GetBaselineThreshold() != 0u &&
+                                   options->GetCompileThreshold() != 0u;
+  if (jit->use_baseline_compilation_ &&
+      kRuntimeISA != InstructionSet::kArm64 &&
+      kRuntimeISA != InstructionSet::kX86 &&
+      kRuntimeISA != InstructionSet::kX86_64) {
+    LOG(WARNING) << "Baseline JIT compilation is not supported on " << kRuntimeISA;
+    jit->use_baseline_compilation_ = false;
+  }
+  if (jit->use_baseline_compilation_) {
+    // The hotness count of the interpreter picks the methods to baseline compile, then the
+    // baseline code counts its invocations from there until the optimized compilation.
+    jit->hot_method_threshold_ = options->GetBaselineThreshold();
+    jit->optimize_method_threshold_ = options->GetCompileThreshold();
+  } else {
+    jit->hot_method_threshold_ = options->GetCompileThreshold();
+  }
   jit->warm_method_threshold_ = options->GetWarmupThreshold();
   jit->osr_method_threshold_ = options->GetOsrThreshold();
   jit->priority_thread_weight_ = options->GetPriorityThreadWeight();
   jit->invoke_transition_weight_ = options->GetInvokeTransitionWeight();
+  jit->thread_count_ = options->GetThreadCount();
+  jit->adaptive_thread_count_ = (jit->thread_count_ == 0u);
+  if (jit->adaptive_thread_count_) {
+    // Leave a core to the mutators.
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);  // NOLINT(runtime/int)
+    jit->thread_count_ = std::min(static_cast<size_t>(std::max(cores - 1, 1L)),
+                                  kJitMaxAdaptiveThreadCount);
+  }
+  if (jit->generate_debug_info_ && jit->thread_count_ != 1u) {
+    LOG(WARNING) << "Generating JIT debug info only works with one JIT thread";
+    jit->thread_count_ = 1u;
+    jit->adaptive_thread_count_ = false;
+  }
 
   jit->CreateThreadPool();
 
@@ -237,7 +326,7 @@ bool Jit::LoadCompilerLibrary(std::string* error_msg) {
     *error_msg = "JIT couldn't find jit_unload entry point";
     return false;
   }
-  jit_compile_method_ = reinterpret_cast<bool (*)(void*, ArtMethod*, Thread*, bool)>(
+  jit_compile_method_ = reinterpret_cast<bool (*)(void*, ArtMethod*, Thread*, bool, bool)>(
       dlsym(jit_library_handle_, "jit_compile_method"));
   if (jit_compile_method_ == nullptr) {
     dlclose(jit_library_handle_);
@@ -271,7 +360,7 @@ bool Jit::LoadCompiler(std::string* error_msg) {
   return true;
 }
 
-bool Jit::CompileMethod(ArtMethod* method, Thread* self, bool osr) {
+bool Jit::CompileMethod(ArtMethod* method, Thread* self, bool osr, bool baseline) {
   DCHECK(Runtime::Current()->UseJitCompilation());
   DCHECK(!method->IsRuntimeMethod());
 
@@ -294,15 +383,29 @@ bool Jit::CompileMethod(ArtMethod* method, Thread* self, bool osr) {
   // If we get a request to compile a proxy method, we pass the actual Java method
   // of that proxy method, as the compiler does not expect a proxy method.
   ArtMethod* method_to_compile = method->GetInterfaceMethodIfProxy(kRuntimePointerSize);
-  if (!code_cache_->NotifyCompilationOf(method_to_compile, self, osr)) {
+  if (!code_cache_->NotifyCompilationOf(method_to_compile, self, osr, baseline)) {
     return false;
   }
 
+#ifdef VTUNE_ART
+  ScopedVTuneTask vtune_task(VTuneTask::kJitCompileMethod);
+#endif
   VLOG(jit) << "Compiling method "
             << ArtMethod::PrettyMethod(method_to_compile)
-            << " osr=" << std::boolalpha << osr;
-  bool success = jit_compile_method_(jit_compiler_handle_, method_to_compile, self, osr);
+            << " osr=" << std::boolalpha << osr
+            << " baseline=" << baseline;
+  bool success =
+      jit_compile_method_(jit_compiler_handle_, method_to_compile, self, osr, baseline);
+  if (success && baseline) {
+    // The baseline code asks for the optimized code when the 16-bit counter wraps around.
+    method_to_compile->SetCounter(static_cast<int16_t>(
+        std::numeric_limits<uint16_t>::max() + 1 - optimize_method_threshold_));
+  }
   code_cache_->DoneCompiling(method_to_compile, self, osr);
+  StatsRegion* stats_region = Runtime::Current()->GetStatsRegion();
+  if (stats_region != nullptr) {
+    stats_region->PublishJitCompiled(success);
+  }
   if (!success) {
     VLOG(jit) << "Failed to compile method "
               << ArtMethod::PrettyMethod(method_to_compile)
@@ -326,9 +429,13 @@ void Jit::CreateThreadPool() {
 
   // We need peers as we may report the JIT thread, e.g., in the debugger.
   constexpr bool kJitPoolNeedsPeers = true;
-  thread_pool_.reset(new ThreadPool("Jit thread pool", 1, kJitPoolNeedsPeers));
+  thread_pool_.reset(new ThreadPool("Jit thread pool", thread_count_, kJitPoolNeedsPeers));
 
   thread_pool_->SetPthreadPriority(kJitPoolThreadPthreadPriority);
+  if (adaptive_thread_count_) {
+    // Start with a single compiling thread, UpdateActiveThreadCount adds more as needed.
+    thread_pool_->SetMaxActiveWorkers(1u);
+  }
   Start();
 }
 
@@ -353,11 +460,40 @@ void Jit::DeleteThreadPool() {
     // will finish in a short period, so it's not worth adding a suspend logic
     // here. Besides, this is only done for shutdown.
     pool->Wait(self, false, false);
+    // Like the tasks removed from the pool, the compilations they would have run are leaked.
+    MutexLock mu(self, compile_queue_lock_);
+    compile_queue_.clear();
+  }
+}
+
+void Jit::LoadWarmStartProfile(const std::string& filename) {
+  std::unique_ptr<ProfileCompilationInfo> profile(new ProfileCompilationInfo());
+  if (!profile->Load(filename, /* clear_if_invalid */ false)) {
+    VLOG(jit) << "No warm start profile in " << filename;
+    return;
   }
+  VLOG(jit) << "Warm start with the " << profile->GetNumberOfMethods()
+            << " methods of " << filename;
+  MutexLock mu(Thread::Current(), warm_start_lock_);
+  warm_start_profile_ = std::move(profile);
+}
+
+bool Jit::IsWarmStartMethod(Thread* self, ArtMethod* method) {
+  ArtMethod* dex_method = method->GetInterfaceMethodIfProxy(kRuntimePointerSize);
+  MutexLock mu(self, warm_start_lock_);
+  if (warm_start_profile_ == nullptr) {
+    return false;
+  }
+  MethodReference ref(dex_method->GetDexFile(), dex_method->GetDexMethodIndex());
+  return warm_start_profile_->GetMethodHotness(ref).IsHot();
 }
 
 void Jit::StartProfileSaver(const std::string& filename,
                             const std::vector<std::string>& code_paths) {
+  if (warm_start_) {
+    // Read the profile before the saver gets a chance to write it.
+    LoadWarmStartProfile(filename);
+  }
   if (profile_saver_options_.IsEnabled()) {
     ProfileSaver::Start(profile_saver_options_,
                         filename,
@@ -527,9 +663,10 @@ bool Jit::MaybeDoOnStackReplacement(Thread* thread,
       // If we don't have a dex register map, then there are no live dex registers at
       // this dex pc.
     } else {
+      std::vector<DexRegisterLocation> vreg_locations;
+      vreg_map.GetDexRegisterLocations(number_of_vregs, code_info, encoding, &vreg_locations);
       for (uint16_t vreg = 0; vreg < number_of_vregs; ++vreg) {
-        DexRegisterLocation::Kind location =
-            vreg_map.GetLocationKind(vreg, number_of_vregs, code_info, encoding);
+        DexRegisterLocation::Kind location = vreg_locations[vreg].GetKind();
         if (location == DexRegisterLocation::Kind::kNone) {
           // Dex register is dead or uninitialized.
           continue;
@@ -543,10 +680,7 @@ bool Jit::MaybeDoOnStackReplacement(Thread* thread,
         DCHECK_EQ(location, DexRegisterLocation::Kind::kInStack);
 
         int32_t vreg_value = shadow_frame->GetVReg(vreg);
-        int32_t slot_offset = vreg_map.GetStackOffsetInBytes(vreg,
-                                                             number_of_vregs,
-                                                             code_info,
-                                                             encoding);
+        int32_t slot_offset = vreg_locations[vreg].GetValue();
         DCHECK_LT(slot_offset, static_cast<int32_t>(frame_size));
         DCHECK_GT(slot_offset, 0);
         (reinterpret_cast<int32_t*>(memory))[slot_offset / sizeof(int32_t)] = vreg_value;
@@ -598,6 +732,7 @@ class JitCompileTask FINAL : public Task {
   enum TaskKind {
     kAllocateProfile,
     kCompile,
+    kCompileBaseline,
     kCompileOsr
   };
 
@@ -616,9 +751,14 @@ class JitCompileTask FINAL : public Task {
   void Run(Thread* self) OVERRIDE {
     ScopedObjectAccess soa(self);
     if (kind_ == kCompile) {
-      Runtime::Current()->GetJit()->CompileMethod(method_, self, /* osr */ false);
+      Runtime::Current()->GetJit()->CompileMethod(
+          method_, self, /* osr */ false, /* baseline */ false);
+    } else if (kind_ == kCompileBaseline) {
+      Runtime::Current()->GetJit()->CompileMethod(
+          method_, self, /* osr */ false, /* baseline */ true);
     } else if (kind_ == kCompileOsr) {
-      Runtime::Current()->GetJit()->CompileMethod(method_, self, /* osr */ true);
+      Runtime::Current()->GetJit()->CompileMethod(
+          method_, self, /* osr */ true, /* baseline */ false);
     } else {
       DCHECK(kind_ == kAllocateProfile);
       if (ProfilingInfo::Create(self, method_, /* retry_allocation */ true)) {
@@ -632,6 +772,14 @@ class JitCompileTask FINAL : public Task {
     delete this;
   }
 
+  ArtMethod* GetMethod() const {
+    return method_;
+  }
+
+  TaskKind GetKind() const {
+    return kind_;
+  }
+
  private:
   ArtMethod* const method_;
   const TaskKind kind_;
@@ -640,12 +788,188 @@ class JitCompileTask FINAL : public Task {
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
 };
 
+// Placeholder in the thread pool for one queued compilation. It runs the most urgent
+// compilation at the time it is picked up, so the FIFO order of the pool does not matter.
+class JitCompileQueueTask FINAL : public SelfDeletingTask {
+ public:
+  JitCompileQueueTask() {}
+
+  void Run(Thread* self) OVERRIDE {
+    jit::Jit* jit = Runtime::Current()->GetJit();
+    {
+      ScopedObjectAccess soa(self);
+      jit->DrainOptimizedCompilationRequests(self);
+    }
+    JitCompileTask* task = jit->PopCompileTask(self);
+    if (task != nullptr) {
+      task->Run(self);
+      task->Finalize();
+    }
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(JitCompileQueueTask);
+};
+
+// Whether queued compilation `lhs` should run before `rhs`.
+static bool IsMoreUrgent(JitCompileTask* lhs, JitCompileTask* rhs) {
+  bool lhs_osr = lhs->GetKind() == JitCompileTask::kCompileOsr;
+  bool rhs_osr = rhs->GetKind() == JitCompileTask::kCompileOsr;
+  if (lhs_osr != rhs_osr) {
+    // The method is already looping in the interpreter.
+    return lhs_osr;
+  }
+  return lhs->GetMethod()->GetCounter() > rhs->GetMethod()->GetCounter();
+}
+
+void Jit::AddCompileTask(Thread* self, ArtMethod* method, bool osr, bool baseline) {
+  DCHECK(!osr || !baseline);
+  JitCompileTask* task = new JitCompileTask(
+      method,
+      osr ? JitCompileTask::kCompileOsr
+          : (baseline ? JitCompileTask::kCompileBaseline : JitCompileTask::kCompile));
+  bool queued = false;
+  size_t queue_size = 0u;
+  {
+    MutexLock mu(self, compile_queue_lock_);
+    queued = std::any_of(compile_queue_.begin(),
+                         compile_queue_.end(),
+                         [task](JitCompileTask* other) {
+                           return other->GetMethod() == task->GetMethod() &&
+                                  other->GetKind() == task->GetKind();
+                         });
+    if (!queued) {
+      compile_queue_.push_back(task);
+    }
+    queue_size = compile_queue_.size();
+  }
+  if (queued) {
+    // Another thread crossed the threshold at the same time.
+    delete task;
+    return;
+  }
+  StatsRegion* stats_region = Runtime::Current()->GetStatsRegion();
+  if (stats_region != nullptr) {
+    stats_region->PublishJitEnqueued(queue_size);
+  }
+  UpdateActiveThreadCount(queue_size);
+  thread_pool_->AddTask(self, new JitCompileQueueTask());
+}
+
+void Jit::RequestOptimizedCompilation(ArtMethod* method) {
+  std::atomic<ArtMethod*>* free_slot = nullptr;
+  for (std::atomic<ArtMethod*>& request : optimized_requests_) {
+    ArtMethod* requested = request.load(std::memory_order_relaxed);
+    if (requested == method) {
+      return;
+    }
+    if (requested == nullptr && free_slot == nullptr) {
+      free_slot = &request;
+    }
+  }
+  ArtMethod* expected = nullptr;
+  if (free_slot != nullptr &&
+      free_slot->compare_exchange_strong(expected, method, std::memory_order_release)) {
+    has_optimized_requests_.store(true, std::memory_order_release);
+  }
+}
+
+void Jit::DrainOptimizedCompilationRequests(Thread* self) {
+  if (!has_optimized_requests_.load(std::memory_order_acquire) || thread_pool_ == nullptr) {
+    return;
+  }
+  if (kUseReadBarrier && !self->GetWeakRefAccessEnabled()) {
+    // The GC may find that the class of a requested method is unreachable. Taking a reference
+    // to the class must wait until SweepOptimizedCompilationRequests() dropped such requests.
+    return;
+  }
+  has_optimized_requests_.store(false, std::memory_order_relaxed);
+  for (std::atomic<ArtMethod*>& request : optimized_requests_) {
+    ArtMethod* method = request.exchange(nullptr, std::memory_order_acquire);
+    if (method != nullptr) {
+      AddCompileTask(self, method, /* osr */ false, /* baseline */ false);
+    }
+  }
+}
+
+void Jit::SweepOptimizedCompilationRequests(IsMarkedVisitor* visitor) {
+  for (std::atomic<ArtMethod*>& request : optimized_requests_) {
+    ArtMethod* method = request.load(std::memory_order_relaxed);
+    if (method != nullptr &&
+        visitor->IsMarked(method->GetDeclaringClassUnchecked<kWithoutReadBarrier>()) == nullptr) {
+      request.compare_exchange_strong(method, nullptr, std::memory_order_relaxed);
+    }
+  }
+}
+
+JitCompileTask* Jit::PopCompileTask(Thread* self) {
+  MutexLock mu(self, compile_queue_lock_);
+  if (compile_queue_.empty()) {
+    return nullptr;
+  }
+  // The queue is short, and the counts change while queued, so just scan it. Equally urgent
+  // compilations keep their queuing order.
+  auto most_urgent = compile_queue_.begin();
+  for (auto it = most_urgent + 1; it != compile_queue_.end(); ++it) {
+    if (IsMoreUrgent(*it, *most_urgent)) {
+      most_urgent = it;
+    }
+  }
+  JitCompileTask* task = *most_urgent;
+  compile_queue_.erase(most_urgent);
+  StatsRegion* stats_region = Runtime::Current()->GetStatsRegion();
+  if (stats_region != nullptr) {
+    stats_region->PublishJitDequeued(compile_queue_.size());
+  }
+  return task;
+}
+
+// Estimate the number of idle cores from the number of runnable threads in /proc/loadavg.
+static size_t CountIdleCores() {
+  std::string loadavg;
+  if (!ReadFileToString("/proc/loadavg", &loadavg)) {
+    return 0u;
+  }
+  // The fourth field is "<runnable threads>/<total threads>".
+  std::vector<std::string> fields;
+  Split(loadavg, ' ', &fields);
+  if (fields.size() < 4u) {
+    return 0u;
+  }
+  long runnable = strtol(fields[3].c_str(), nullptr, 10);  // NOLINT(runtime/int)
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);  // NOLINT(runtime/int)
+  return (runnable < cores) ? static_cast<size_t>(cores - runnable) : 0u;
+}
+
+void Jit::UpdateActiveThreadCount(size_t queue_size) {
+  if (!adaptive_thread_count_) {
+    return;
+  }
+  uint64_t now = NanoTime();
+  uint64_t last_update = idle_cores_update_ns_.load(std::memory_order_relaxed);
+  if (now - last_update >= kJitAdaptiveIdleCoresUpdateNs &&
+      idle_cores_update_ns_.compare_exchange_strong(last_update, now,
+                                                     std::memory_order_relaxed)) {
+    idle_cores_.store(CountIdleCores(), std::memory_order_relaxed);
+  }
+  DCHECK_NE(queue_size, 0u);
+  size_t wanted = 1u + (queue_size - 1u) / kJitAdaptiveQueueDepthPerThread;
+  // The threads already compiling are not idle, so only grow by the idle cores.
+  size_t allowed = active_thread_count_.load(std::memory_order_relaxed) +
+                   idle_cores_.load(std::memory_order_relaxed);
+  size_t active = std::max(std::min({ wanted, allowed, thread_count_ }), static_cast<size_t>(1u));
+  // Concurrent updates may race, the next one corrects a stale limit.
+  active_thread_count_.store(active, std::memory_order_relaxed);
+  thread_pool_->SetMaxActiveWorkers(active);
+}
+
 void Jit::AddSamples(Thread* self, ArtMethod* method, uint16_t count, bool with_backedges) {
   if (thread_pool_ == nullptr) {
     // Should only see this when shutting down.
     DCHECK(Runtime::Current()->IsShuttingDown(self));
     return;
   }
+  DrainOptimizedCompilationRequests(self);
 
   if (method->IsClassInitializer() || !method->IsCompilable()) {
     // We do not want to compile such methods.
@@ -667,6 +991,14 @@ void Jit::AddSamples(Thread* self, ArtMethod* method, uint16_t count, bool with_
     count *= priority_thread_weight_;
   }
   int32_t new_count = starting_count + count;   // int32 here to avoid wrap-around;
+  if (UNLIKELY(warm_start_) &&
+      starting_count == 0 &&
+      method->GetProfilingInfo(kRuntimePointerSize) == nullptr &&
+      IsWarmStartMethod(self, method)) {
+    // Hot in the previous runs: skip the warm up, the next sample queues the compilation.
+    VLOG(jit) << "Warm start of " << method->PrettyMethod();
+    new_count = hot_method_threshold_;
+  }
   // Note: Native method have no "warm" state or profiling info.
   if (LIKELY(!method->IsNative()) && starting_count < warm_method_threshold_) {
     if ((new_count >= warm_method_threshold_) &&
@@ -696,7 +1028,11 @@ void Jit::AddSamples(Thread* self, ArtMethod* method, uint16_t count, bool with_
       if ((new_count >= hot_method_threshold_) &&
           !code_cache_->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
         DCHECK(thread_pool_ != nullptr);
-        thread_pool_->AddTask(self, new JitCompileTask(method, JitCompileTask::kCompile));
+        // Native methods only have a JNI stub, which baseline code would not make faster.
+        AddCompileTask(self,
+                       method,
+                       /* osr */ false,
+                       /* baseline */ use_baseline_compilation_ && !method->IsNative());
       }
       // Avoid jumping more than one state at a time.
       new_count = std::min(new_count, osr_method_threshold_ - 1);
@@ -708,7 +1044,7 @@ void Jit::AddSamples(Thread* self, ArtMethod* method, uint16_t count, bool with_
       DCHECK(!method->IsNative());  // No back edges reported for native methods.
       if ((new_count >= osr_method_threshold_) &&  !code_cache_->IsOsrCompiled(method)) {
         DCHECK(thread_pool_ != nullptr);
-        thread_pool_->AddTask(self, new JitCompileTask(method, JitCompileTask::kCompileOsr));
+        AddCompileTask(self, method, /* osr */ true, /* baseline */ false);
       }
     }
   }
@@ -739,14 +1075,6 @@ void Jit::MethodEntered(Thread* thread, ArtMethod* method) {
   }
 }
 
-bool Jit::AddJniTask(Thread* self, JniTask* task) {
-  if (thread_pool_ == nullptr) {
-    return false;
-  }
-  thread_pool_->AddTask(self, task);
-  return true;
-}
-
 void Jit::InvokeVirtualOrInterface(ObjPtr<mirror::Object> this_object,
                                    ArtMethod* caller,
                                    uint32_t dex_pc,
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_JIT_JIT_H_
 #define ART_RUNTIME_JIT_JIT_H_
 
+#include <atomic>
+
 #include "base/histogram-inl.h"
 #include "base/macros.h"
 #include "base/mutex.h"
@@ -29,6 +31,8 @@ namespace art {
 
 class ArtMethod;
 class ClassLinker;
+class IsMarkedVisitor;
+class ProfileCompilationInfo;
 struct RuntimeArgumentMap;
 union JValue;
 
@@ -40,8 +44,8 @@ class Class;
 namespace jit {
 
 class JitCodeCache;
+class JitCompileTask;
 class JitOptions;
-class JniTask : public Task { };
 
 static constexpr int16_t kJitCheckForOSR = -1;
 static constexpr int16_t kJitHotnessDisabled = -2;
@@ -55,7 +59,7 @@ class Jit {
 
   virtual ~Jit();
   static Jit* Create(JitOptions* options, std::string* error_msg);
-  bool CompileMethod(ArtMethod* method, Thread* self, bool osr)
+  bool CompileMethod(ArtMethod* method, Thread* self, bool osr, bool baseline)
       REQUIRES_SHARED(Locks::mutator_lock_);
   void CreateThreadPool();
 
@@ -99,6 +103,16 @@ class Jit {
     return use_jit_compilation_;
   }
 
+  // Whether hot methods first get baseline code, which asks for the optimized code
+  // once it ran OptimizeMethodThreshold() times.
+  bool UseBaselineCompilation() const {
+    return use_baseline_compilation_;
+  }
+
+  size_t OptimizeMethodThreshold() const {
+    return optimize_method_threshold_;
+  }
+
   bool GetSaveProfilingInfo() const {
     return profile_saver_options_.IsEnabled();
   }
@@ -171,24 +185,62 @@ class Jit {
     return thread_pool_.get();
   }
 
+  // Queue a compilation of `method` for the thread pool. The queued compilations are run
+  // in priority order rather than in the order they were queued, see PopCompileTask.
+  void AddCompileTask(Thread* self, ArtMethod* method, bool osr, bool baseline)
+      REQUIRES(!compile_queue_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Called by baseline code once it is hot: post a request for the optimized compilation of
+  // `method`. This must not suspend, allocate or take locks, the caller has no stack map for
+  // its frame entry. The request is queued by the next DrainOptimizedCompilationRequests().
+  void RequestOptimizedCompilation(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Queue the compilations posted by RequestOptimizedCompilation(). Called by the JIT threads
+  // before picking a compilation, and by AddSamples().
+  void DrainOptimizedCompilationRequests(Thread* self)
+      REQUIRES(!compile_queue_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Drop the posted requests for methods of unloaded classes. The requests do not keep the
+  // classes alive.
+  void SweepOptimizedCompilationRequests(IsMarkedVisitor* visitor)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Remove and return the most urgent queued compilation, or null if there is none: OSR
+  // compilations first, then the method with the highest hotness count. The counts are
+  // read when the compilation is picked, so a queued method moves up as its samples grow.
+  JitCompileTask* PopCompileTask(Thread* self) REQUIRES(!compile_queue_lock_);
+
   // Stop the JIT by waiting for all current compilations and enqueued compilations to finish.
   void Stop();
 
   // Start JIT threads.
   void Start();
-  bool AddJniTask(Thread* self, JniTask* task);
  
  private:
   Jit();
 
   static bool LoadCompiler(std::string* error_msg);
 
+  // In adaptive mode, let as many threads compile as `queue_size` queued compilations justify
+  // and the idle cores allow.
+  void UpdateActiveThreadCount(size_t queue_size);
+
+  // Warm start: read the profile saved by the previous runs from `filename`.
+  void LoadWarmStartProfile(const std::string& filename) REQUIRES(!warm_start_lock_);
+
+  // Whether `method` was hot in the warm start profile, and can skip the warm up.
+  bool IsWarmStartMethod(Thread* self, ArtMethod* method)
+      REQUIRES(!warm_start_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // JIT compiler
   static void* jit_library_handle_;
   static void* jit_compiler_handle_;
   static void* (*jit_load_)(bool*);
   static void (*jit_unload_)(void*);
-  static bool (*jit_compile_method_)(void*, ArtMethod*, Thread*, bool);
+  static bool (*jit_compile_method_)(void*, ArtMethod*, Thread*, bool, bool);
   static void (*jit_types_loaded_)(void*, mirror::Class**, size_t count);
 
   // Performance monitoring.
@@ -207,7 +259,36 @@ class Jit {
   uint16_t osr_method_threshold_;
   uint16_t priority_thread_weight_;
   uint16_t invoke_transition_weight_;
+  bool use_baseline_compilation_;
+  uint16_t optimize_method_threshold_;
   std::unique_ptr<ThreadPool> thread_pool_;
+  // Number of threads in the pool, and whether the number of active ones follows the load.
+  size_t thread_count_;
+  bool adaptive_thread_count_;
+  // Adaptive mode: the limit of active threads, the estimate of the idle cores and when it
+  // was last updated.
+  std::atomic<size_t> active_thread_count_;
+  std::atomic<size_t> idle_cores_;
+  std::atomic<uint64_t> idle_cores_update_ns_;
+
+  // Optimized compilations posted by baseline code, see RequestOptimizedCompilation(). A
+  // request is dropped when all slots are used, the baseline code asks again after its
+  // counter wraps around.
+  static constexpr size_t kMaxOptimizedCompilationRequests = 16u;
+  std::atomic<ArtMethod*> optimized_requests_[kMaxOptimizedCompilationRequests];
+  std::atomic<bool> has_optimized_requests_;
+
+  // Compilations waiting for the thread pool. Each one has a matching task in the pool,
+  // which runs whichever compilation is the most urgent when it is picked up.
+  Mutex compile_queue_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::vector<JitCompileTask*> compile_queue_ GUARDED_BY(compile_queue_lock_);
+
+  // Warm start: the profile of the previous runs, loaded when the profile saver is started.
+  // Its methods are looked up with the checksums of the dex files, so the entries of an
+  // updated app are ignored.
+  bool warm_start_;
+  Mutex warm_start_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::unique_ptr<ProfileCompilationInfo> warm_start_profile_ GUARDED_BY(warm_start_lock_);
 
   DISALLOW_COPY_AND_ASSIGN(Jit);
 };
@@ -230,6 +311,18 @@ class JitOptions {
   size_t GetInvokeTransitionWeight() const {
     return invoke_transition_weight_;
   }
+  // Number of JIT threads, or 0 to adapt the number of active ones to the load.
+  size_t GetThreadCount() const {
+    return thread_count_;
+  }
+  // Count at which methods get baseline code, or 0 to directly compile optimized code.
+  size_t GetBaselineThreshold() const {
+    return baseline_threshold_;
+  }
+  // Whether the methods hot in the profile of the previous runs are compiled on first use.
+  bool GetWarmStart() const {
+    return warm_start_;
+  }
   size_t GetCodeCacheInitialCapacity() const {
     return code_cache_initial_capacity_;
   }
@@ -275,6 +368,9 @@ class JitOptions {
   size_t osr_threshold_;
   uint16_t priority_thread_weight_;
   size_t invoke_transition_weight_;
+  size_t thread_count_;
+  size_t baseline_threshold_;
+  bool warm_start_;
   bool dump_info_on_shutdown_;
   ProfileSaverOptions profile_saver_options_;
 
@@ -287,6 +383,9 @@ class JitOptions {
         osr_threshold_(0),
         priority_thread_weight_(0),
         invoke_transition_weight_(0),
+        thread_count_(0),
+        baseline_threshold_(0),
+        warm_start_(false),
         dump_info_on_shutdown_(false) {}
 
   DISALLOW_COPY_AND_ASSIGN(JitOptions);
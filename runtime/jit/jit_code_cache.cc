@@ -16,6 +16,8 @@
 
 #include "jit_code_cache.h"
 
+#include <sched.h>
+
 #include <sstream>
 
 #include "arch/context.h"
@@ -30,7 +32,10 @@
 #include "debugger_interface.h"
 #include "dex/dex_file_loader.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
+#include "fault_handler.h"
+#include "frame_info_cache.h"
 #include "gc/accounting/bitmap-inl.h"
+#include "gc/allocator/dlmalloc.h"
 #include "gc/scoped_gc_critical_section.h"
 #include "handle.h"
 #include "intern_table.h"
@@ -44,9 +49,14 @@
 #include "profile_compilation_info.h"
 #include "scoped_thread_state_change-inl.h"
 #include "stack.h"
+#include "stack_map.h"
 #include "thread-current-inl.h"
 #include "thread_list.h"
 
+#ifdef VTUNE_ART
+#include "vtune_support.h"
+#endif
+
 namespace art {
 namespace jit {
 
@@ -56,6 +66,37 @@ static constexpr int kProtCode = PROT_READ | PROT_EXEC;
 static constexpr size_t kCodeSizeLogThreshold = 50 * KB;
 static constexpr size_t kStackMapSizeLogThreshold = 50 * KB;
 
+// Free chunks of an mspace, to tell how fragmented it is.
+struct MspaceFreeStats {
+  size_t free_bytes = 0u;
+  size_t free_chunks = 0u;
+  size_t largest_free_chunk = 0u;
+};
+
+// Callback for mspace_inspect_all.
+static void CountFreeChunk(void* start, void* end, size_t used_bytes, void* arg) {
+  if (used_bytes != 0u) {
+    return;
+  }
+  MspaceFreeStats* stats = reinterpret_cast<MspaceFreeStats*>(arg);
+  size_t size = reinterpret_cast<uintptr_t>(end) - reinterpret_cast<uintptr_t>(start);
+  stats->free_bytes += size;
+  stats->free_chunks++;
+  stats->largest_free_chunk = std::max(stats->largest_free_chunk, size);
+}
+
+static void DumpFragmentation(std::ostream& os, const char* name, void* mspace) {
+  MspaceFreeStats stats;
+  mspace_inspect_all(mspace, CountFreeChunk, &stats);
+  // The share of the free memory that the largest allocation possible cannot use.
+  size_t fragmentation = (stats.free_bytes == 0u)
+      ? 0u
+      : 100u - (stats.largest_free_chunk * 100u) / stats.free_bytes;
+  os << "Current JIT " << name << " cache free: " << PrettySize(stats.free_bytes)
+     << " in " << stats.free_chunks << " chunks, largest " << PrettySize(stats.largest_free_chunk)
+     << ", fragmentation " << fragmentation << "%\n";
+}
+
 class JitCodeCache::JniStubKey {
  public:
   explicit JniStubKey(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_)
@@ -280,6 +321,11 @@ JitCodeCache::JitCodeCache(MemMap* code_map,
       is_weak_access_enabled_(true),
       inline_cache_cond_("Jit inline cache condition variable", lock_),
       memmap_flags_prot_code_(memmap_flags_prot_code) {
+  pc_index_.StoreRelaxed(new PcIndex());
+  pc_index_is_stale_ = false;
+  pc_index_epoch_.StoreRelaxed(0u);
+  pc_lookups_in_flight_[0].StoreRelaxed(0u);
+  pc_lookups_in_flight_[1].StoreRelaxed(0u);
 
   DCHECK_GE(max_capacity, initial_code_capacity + initial_data_capacity);
   code_mspace_ = create_mspace_with_base(code_map_->Begin(), code_end_, false /*locked*/);
@@ -301,6 +347,7 @@ JitCodeCache::JitCodeCache(MemMap* code_map,
               data_map_->Begin(),
               data_map_->Size(),
               kProtData);
+  fault_manager.AddGeneratedCodeRange(code_map_->Begin(), code_map_->Size());
 
   VLOG(jit) << "Created jit code cache: initial data size="
             << PrettySize(initial_data_capacity)
@@ -308,7 +355,10 @@ JitCodeCache::JitCodeCache(MemMap* code_map,
             << PrettySize(initial_code_capacity);
 }
 
-JitCodeCache::~JitCodeCache() {}
+JitCodeCache::~JitCodeCache() {
+  fault_manager.RemoveGeneratedCodeRange(code_map_->Begin(), code_map_->Size());
+  delete pc_index_.LoadRelaxed();
+}
 
 bool JitCodeCache::ContainsPc(const void* ptr) const {
   return code_map_->Begin() <= ptr && ptr < code_map_->End();
@@ -394,7 +444,9 @@ uint8_t* JitCodeCache::CommitCode(Thread* self,
                                   size_t code_size,
                                   size_t data_size,
                                   bool osr,
+                                  bool baseline,
                                   Handle<mirror::ObjectArray<mirror::Object>> roots,
+                                  const std::vector<JitBssEntry>& bss_entries,
                                   bool has_should_deoptimize_flag,
                                   const ArenaSet<ArtMethod*>& cha_single_implementation_list) {
   uint8_t* result = CommitCodeInternal(self,
@@ -409,7 +461,9 @@ uint8_t* JitCodeCache::CommitCode(Thread* self,
                                        code_size,
                                        data_size,
                                        osr,
+                                       baseline,
                                        roots,
+                                       bss_entries,
                                        has_should_deoptimize_flag,
                                        cha_single_implementation_list);
   if (result == nullptr) {
@@ -427,7 +481,9 @@ uint8_t* JitCodeCache::CommitCode(Thread* self,
                                 code_size,
                                 data_size,
                                 osr,
+                                baseline,
                                 roots,
+                                bss_entries,
                                 has_should_deoptimize_flag,
                                 cha_single_implementation_list);
   }
@@ -475,7 +531,8 @@ static void FillRootTable(uint8_t* roots_data, Handle<mirror::ObjectArray<mirror
   // Put all roots in `roots_data`.
   for (uint32_t i = 0; i < length; ++i) {
     ObjPtr<mirror::Object> object = roots->Get(i);
-    if (kIsDebugBuild) {
+    // The JIT .bss entries are null.
+    if (kIsDebugBuild && object != nullptr) {
       // Ensure the string is strongly interned. b/32995596
       if (object->IsString()) {
         ObjPtr<mirror::String> str = reinterpret_cast<mirror::String*>(object.Ptr());
@@ -571,13 +628,21 @@ void JitCodeCache::SweepRootTables(IsMarkedVisitor* visitor) {
 }
 
 void JitCodeCache::FreeCode(const void* code_ptr) {
+  // The stack walks may have cached the method header and the stack maps of the code.
+  FrameInfoCache::InvalidateAll();
+  CodeInfo::InvalidateStackMapIndexCache();
   uintptr_t allocation = FromCodeToAllocation(code_ptr);
   // Notify native debugger that we are about to remove the code.
   // It does nothing if we are not using native debugger.
   MutexLock mu(Thread::Current(), *Locks::native_debug_interface_lock_);
   RemoveNativeDebugInfoForJit(code_ptr);
+#ifdef VTUNE_ART
+  SendMethodUnloadToVTune(code_ptr);
+#endif
   if (OatQuickMethodHeader::FromCodePointer(code_ptr)->IsOptimized()) {
     FreeData(GetRootTable(code_ptr));
+    baseline_code_.erase(code_ptr);
+    jit_bss_entries_.erase(code_ptr);
   }  // else this is a JNI stub without any data.
   FreeCode(reinterpret_cast<uint8_t*>(allocation));
 }
@@ -633,6 +698,7 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
           ++it;
         }
       }
+      UpdatePcIndex();
     }
     for (auto it = osr_code_map_.begin(); it != osr_code_map_.end();) {
       if (alloc.ContainsUnsafe(it->first)) {
@@ -692,16 +758,31 @@ void JitCodeCache::DisallowInlineCacheAccess() {
 }
 
 void JitCodeCache::CopyInlineCacheInto(const InlineCache& ic,
-                                       Handle<mirror::ObjectArray<mirror::Class>> array) {
+                                       Handle<mirror::ObjectArray<mirror::Class>> array,
+                                       /*out*/ uint16_t* counts) {
   WaitUntilInlineCacheAccessible(Thread::Current());
   // Note that we don't need to lock `lock_` here, the compiler calling
   // this method has already ensured the inline cache will not be deleted.
-  for (size_t in_cache = 0, in_array = 0;
-       in_cache < InlineCache::kIndividualCacheSize;
-       ++in_cache) {
+  std::pair<uint16_t, mirror::Class*> entries[InlineCache::kIndividualCacheSize];
+  size_t number_of_entries = 0;
+  for (size_t in_cache = 0; in_cache < InlineCache::kIndividualCacheSize; ++in_cache) {
     mirror::Class* object = ic.classes_[in_cache].Read();
     if (object != nullptr) {
-      array->Set(in_array++, object);
+      entries[number_of_entries++] = std::make_pair(ic.counts_[in_cache], object);
+    }
+  }
+  std::stable_sort(entries,
+                   entries + number_of_entries,
+                   [](const std::pair<uint16_t, mirror::Class*>& lhs,
+                      const std::pair<uint16_t, mirror::Class*>& rhs) {
+                     return lhs.first > rhs.first;
+                   });
+  for (size_t in_array = 0; in_array < InlineCache::kIndividualCacheSize; ++in_array) {
+    if (in_array < number_of_entries) {
+      array->Set(in_array, entries[in_array].second);
+      counts[in_array] = entries[in_array].first;
+    } else {
+      counts[in_array] = 0u;
     }
   }
 }
@@ -734,7 +815,9 @@ uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
                                           size_t code_size,
                                           size_t data_size,
                                           bool osr,
+                                          bool baseline,
                                           Handle<mirror::ObjectArray<mirror::Object>> roots,
+                                          const std::vector<JitBssEntry>& bss_entries,
                                           bool has_should_deoptimize_flag,
                                           const ArenaSet<ArtMethod*>&
                                               cha_single_implementation_list) {
@@ -846,6 +929,15 @@ uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
                        reinterpret_cast<char*>(roots_data + data_size));
       }
       method_code_map_.Put(code_ptr, method);
+      // Lookups missing the new code publish the index, so a batch of commits copies
+      // method_code_map_ once.
+      pc_index_is_stale_ = true;
+      if (baseline) {
+        baseline_code_.insert(code_ptr);
+      }
+      if (!bss_entries.empty()) {
+        jit_bss_entries_.Put(code_ptr, bss_entries);
+      }
       if (osr) {
         number_of_osr_compilations_++;
         osr_code_map_.Put(method, code_ptr);
@@ -945,6 +1037,7 @@ bool JitCodeCache::RemoveMethodLocked(ArtMethod* method, bool release_memory) {
         ++it;
       }
     }
+    UpdatePcIndex();
 
     auto osr_it = osr_code_map_.find(method);
     if (osr_it != osr_code_map_.end()) {
@@ -996,6 +1089,7 @@ void JitCodeCache::MoveObsoleteMethod(ArtMethod* old_method, ArtMethod* new_meth
       it.second = new_method;
     }
   }
+  UpdatePcIndex();
   // Update osr_code_map_ to point to the new method.
   auto code_map = osr_code_map_.find(old_method);
   if (code_map != osr_code_map_.end()) {
@@ -1335,6 +1429,7 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
         it = method_code_map_.erase(it);
       }
     }
+    UpdatePcIndex();
   }
   FreeAllMethodHeaders(method_headers);
 }
@@ -1450,6 +1545,95 @@ bool JitCodeCache::CheckLiveCompiledCodeHasProfilingInfo() {
   return true;
 }
 
+void JitCodeCache::UpdatePcIndex() {
+  PcIndex* index = new PcIndex();
+  index->reserve(method_code_map_.size());
+  for (const auto& it : method_code_map_) {
+    index->push_back({ reinterpret_cast<uintptr_t>(it.first),
+                       OatQuickMethodHeader::FromCodePointer(it.first)->GetCodeSize(),
+                       it.second });
+  }
+  const PcIndex* old_index = pc_index_.ExchangeSequentiallyConsistent(index);
+  pc_index_is_stale_ = false;
+  // A lookup loads the index after announcing itself in the counter of the current epoch, so
+  // once the epoch has changed, only the lookups counted in the previous one can use
+  // `old_index`. They are short and never block, so wait for them and free it.
+  uint32_t epoch = pc_index_epoch_.LoadRelaxed();
+  pc_index_epoch_.StoreSequentiallyConsistent(epoch ^ 1u);
+  while (pc_lookups_in_flight_[epoch].LoadSequentiallyConsistent() != 0u) {
+    sched_yield();
+  }
+  delete old_index;
+}
+
+const void* JitCodeCache::LookupCodeInPcIndex(uintptr_t pc, /*out*/ ArtMethod** method) {
+  uint32_t epoch;
+  while (true) {
+    epoch = pc_index_epoch_.LoadSequentiallyConsistent();
+    pc_lookups_in_flight_[epoch].FetchAndAddSequentiallyConsistent(1u);
+    if (LIKELY(pc_index_epoch_.LoadSequentiallyConsistent() == epoch)) {
+      break;
+    }
+    // UpdatePcIndex() may not wait for this lookup, retry in the new epoch.
+    pc_lookups_in_flight_[epoch].FetchAndSubSequentiallyConsistent(1u);
+  }
+  const PcIndex* index = pc_index_.LoadSequentiallyConsistent();
+  const void* code_ptr = nullptr;
+  // Same search as in method_code_map_: the last code starting before `pc`.
+  auto it = std::lower_bound(index->begin(),
+                             index->end(),
+                             pc,
+                             [](const PcIndexEntry& entry, uintptr_t value) {
+                               return entry.code_begin < value;
+                             });
+  if (it != index->begin()) {
+    --it;
+    // Same check as OatQuickMethodHeader::Contains(), without reading the header of code
+    // that may have been freed since the index was published.
+    uintptr_t code_start = it->code_begin;
+    if (kRuntimeISA == InstructionSet::kArm) {
+      code_start++;
+    }
+    if (code_start <= pc && pc <= code_start + it->code_size) {
+      code_ptr = reinterpret_cast<const void*>(it->code_begin);
+      *method = it->method;
+    }
+  }
+  pc_lookups_in_flight_[epoch].FetchAndSubSequentiallyConsistent(1u);
+  return code_ptr;
+}
+
+void JitCodeCache::StoreJitBssEntry(ArtMethod* method,
+                                    uintptr_t pc,
+                                    const DexFile* dex_file,
+                                    uint32_t index,
+                                    bool is_string,
+                                    ObjPtr<mirror::Object> object) {
+  DCHECK(object != nullptr);
+  OatQuickMethodHeader* method_header = LookupMethodHeader(pc, method);
+  if (method_header == nullptr || !method_header->IsOptimized()) {
+    return;
+  }
+  const void* code_ptr = method_header->GetCode();
+  MutexLock mu(Thread::Current(), lock_);
+  auto it = jit_bss_entries_.find(code_ptr);
+  if (it == jit_bss_entries_.end()) {
+    return;
+  }
+  for (const JitBssEntry& entry : it->second) {
+    if (entry.dex_file == dex_file && entry.index == index && entry.is_string == is_string) {
+      GcRoot<mirror::Object>* roots =
+          reinterpret_cast<GcRoot<mirror::Object>*>(GetRootTable(code_ptr));
+      // The sweeping of the root tables holds lock_, so the entry cannot be cleared concurrently.
+      // Another thread may already have stored the very same object.
+      if (roots[entry.root_index].IsNull()) {
+        roots[entry.root_index] = GcRoot<mirror::Object>(object);
+      }
+      return;
+    }
+  }
+}
+
 OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod* method) {
   static_assert(kRuntimeISA != InstructionSet::kThumb2, "kThumb2 cannot be a runtime ISA");
   if (kRuntimeISA == InstructionSet::kArm) {
@@ -1465,10 +1649,43 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
     CHECK(method != nullptr);
   }
 
+  if (method == nullptr || LIKELY(!method->IsNative())) {
+    // The code of a frame being walked cannot be freed, so its entry in the index is valid.
+    ArtMethod* found_method = nullptr;
+    const void* code_ptr = LookupCodeInPcIndex(pc, &found_method);
+    if (code_ptr == nullptr) {
+      // The code may have been committed since the index was last published.
+      MutexLock mu(Thread::Current(), lock_);
+      if (pc_index_is_stale_) {
+        UpdatePcIndex();
+        code_ptr = LookupCodeInPcIndex(pc, &found_method);
+      }
+    }
+    if (code_ptr != nullptr) {
+      if (kIsDebugBuild && method != nullptr) {
+        // When we are walking the stack to redefine classes and creating obsolete methods it
+        // is possible that we might have updated the method_code_map by making this method
+        // obsolete in a previous frame. Therefore we should just check that the non-obsolete
+        // version of this method is the one we expect. We change to the non-obsolete versions
+        // in the error message since the obsolete version of the method might not be fully
+        // initialized yet. This situation can only occur when we are in the process of
+        // allocating and setting up obsolete methods. Otherwise method and found_method should
+        // be identical. (See openjdkjvmti/ti_redefine.cc for more information.)
+        DCHECK_EQ(found_method->GetNonObsoleteMethod(), method->GetNonObsoleteMethod())
+            << ArtMethod::PrettyMethod(method->GetNonObsoleteMethod()) << " "
+            << ArtMethod::PrettyMethod(found_method->GetNonObsoleteMethod()) << " "
+            << std::hex << pc;
+      }
+      return OatQuickMethodHeader::FromCodePointer(code_ptr);
+    }
+    if (method != nullptr) {
+      return nullptr;
+    }
+  }
+
   MutexLock mu(Thread::Current(), lock_);
   OatQuickMethodHeader* method_header = nullptr;
-  ArtMethod* found_method = nullptr;  // Only for DCHECK(), not for JNI stubs.
-  if (method != nullptr && UNLIKELY(method->IsNative())) {
+  if (method != nullptr) {
     auto it = jni_stubs_map_.find(JniStubKey(method));
     if (it == jni_stubs_map_.end() || !ContainsElement(it->second.GetMethods(), method)) {
       return nullptr;
@@ -1479,44 +1696,15 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
       return nullptr;
     }
   } else {
-    auto it = method_code_map_.lower_bound(reinterpret_cast<const void*>(pc));
-    if (it != method_code_map_.begin()) {
-      --it;
-      const void* code_ptr = it->first;
-      if (OatQuickMethodHeader::FromCodePointer(code_ptr)->Contains(pc)) {
-        method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
-        found_method = it->second;
-      }
-    }
-    if (method_header == nullptr && method == nullptr) {
-      // Scan all compiled JNI stubs as well. This slow search is used only
-      // for checks in debug build, for release builds the `method` is not null.
-      for (auto&& entry : jni_stubs_map_) {
-        const JniStubData& data = entry.second;
-        if (data.IsCompiled() &&
-            OatQuickMethodHeader::FromCodePointer(data.GetCode())->Contains(pc)) {
-          method_header = OatQuickMethodHeader::FromCodePointer(data.GetCode());
-        }
+    // Scan all compiled JNI stubs as well. This slow search is used only
+    // for checks in debug build, for release builds the `method` is not null.
+    for (auto&& entry : jni_stubs_map_) {
+      const JniStubData& data = entry.second;
+      if (data.IsCompiled() &&
+          OatQuickMethodHeader::FromCodePointer(data.GetCode())->Contains(pc)) {
+        method_header = OatQuickMethodHeader::FromCodePointer(data.GetCode());
       }
     }
-    if (method_header == nullptr) {
-      return nullptr;
-    }
-  }
-
-  if (kIsDebugBuild && method != nullptr && !method->IsNative()) {
-    // When we are walking the stack to redefine classes and creating obsolete methods it is
-    // possible that we might have updated the method_code_map by making this method obsolete in a
-    // previous frame. Therefore we should just check that the non-obsolete version of this method
-    // is the one we expect. We change to the non-obsolete versions in the error message since the
-    // obsolete version of the method might not be fully initialized yet. This situation can only
-    // occur when we are in the process of allocating and setting up obsolete methods. Otherwise
-    // method and it->second should be identical. (See openjdkjvmti/ti_redefine.cc for more
-    // information.)
-    DCHECK_EQ(found_method->GetNonObsoleteMethod(), method->GetNonObsoleteMethod())
-        << ArtMethod::PrettyMethod(method->GetNonObsoleteMethod()) << " "
-        << ArtMethod::PrettyMethod(found_method->GetNonObsoleteMethod()) << " "
-        << std::hex << pc;
   }
   return method_header;
 }
@@ -1694,12 +1882,30 @@ bool JitCodeCache::IsOsrCompiled(ArtMethod* method) {
   return osr_code_map_.find(method) != osr_code_map_.end();
 }
 
-bool JitCodeCache::NotifyCompilationOf(ArtMethod* method, Thread* self, bool osr) {
-  if (!osr && ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+bool JitCodeCache::IsBaselineCompiled(ArtMethod* method) {
+  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+  if (!ContainsPc(entry_point)) {
+    return false;
+  }
+  MutexLock mu(Thread::Current(), lock_);
+  return baseline_code_.find(OatQuickMethodHeader::FromEntryPoint(entry_point)->GetCode()) !=
+      baseline_code_.end();
+}
+
+bool JitCodeCache::NotifyCompilationOf(ArtMethod* method, Thread* self, bool osr, bool baseline) {
+  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+  bool has_jit_code = !osr && ContainsPc(entry_point);
+  if (has_jit_code && baseline) {
     return false;
   }
 
   MutexLock mu(self, lock_);
+  if (has_jit_code &&
+      baseline_code_.find(OatQuickMethodHeader::FromEntryPoint(entry_point)->GetCode()) ==
+          baseline_code_.end()) {
+    // Already optimized.
+    return false;
+  }
   if (osr && (osr_code_map_.find(method) != osr_code_map_.end())) {
     return false;
   }
@@ -1855,8 +2061,10 @@ void JitCodeCache::Dump(std::ostream& os) {
   os << "Current JIT code cache size: " << PrettySize(used_memory_for_code_) << "\n"
      << "Current JIT data cache size: " << PrettySize(used_memory_for_data_) << "\n"
      << "Current JIT mini-debug-info size: " << PrettySize(GetJitNativeDebugInfoMemUsage()) << "\n"
-     << "Current JIT capacity: " << PrettySize(current_capacity_) << "\n"
-     << "Current number of JIT JNI stub entries: " << jni_stubs_map_.size() << "\n"
+     << "Current JIT capacity: " << PrettySize(current_capacity_) << "\n";
+  DumpFragmentation(os, "code", code_mspace_);
+  DumpFragmentation(os, "data", data_mspace_);
+  os << "Current number of JIT JNI stub entries: " << jni_stubs_map_.size() << "\n"
      << "Current number of JIT code cache entries: " << method_code_map_.size() << "\n"
      << "Total number of JIT compilations: " << number_of_compilations_ << "\n"
      << "Total number of JIT compilations for on stack replacement: "
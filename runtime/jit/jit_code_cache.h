@@ -31,6 +31,7 @@
 namespace art {
 
 class ArtMethod;
+class DexFile;
 template<class T> class Handle;
 class LinearAlloc;
 class InlineCache;
@@ -74,6 +75,18 @@ class ScopedCodeCacheWrite;
 static constexpr int kJitCodeAlignment = 16;
 using CodeCacheBitmap = gc::accounting::MemoryRangeBitmap<kJitCodeAlignment>;
 
+// An entry of the root table of JIT code for a class or string that was not resolved yet
+// when the code was compiled. The entry is null until the slow path of the code resolves
+// the class or string and stores it there, like for the .bss entries of AOT code.
+struct JitBssEntry {
+  const DexFile* dex_file;
+  // The dex::TypeIndex or dex::StringIndex of the entry.
+  uint32_t index;
+  bool is_string;
+  // The index of the entry in the root table.
+  uint32_t root_index;
+};
+
 class JitCodeCache {
  public:
   static constexpr size_t kMaxCapacity = 64 * MB;
@@ -99,7 +112,10 @@ class JitCodeCache {
   // Number of bytes allocated in the data cache.
   size_t DataCacheSize() REQUIRES(!lock_);
 
-  bool NotifyCompilationOf(ArtMethod* method, Thread* self, bool osr)
+  // Mark `method` as being compiled. Returns false if there is nothing to compile, including
+  // when another JIT thread is already compiling it, so concurrent JIT threads never compile
+  // the same method. JIT code is only recompiled to replace baseline code by optimized code.
+  bool NotifyCompilationOf(ArtMethod* method, Thread* self, bool osr, bool baseline)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!lock_);
 
@@ -141,7 +157,9 @@ class JitCodeCache {
                       size_t code_size,
                       size_t data_size,
                       bool osr,
+                      bool baseline,
                       Handle<mirror::ObjectArray<mirror::Object>> roots,
+                      const std::vector<JitBssEntry>& bss_entries,
                       bool has_should_deoptimize_flag,
                       const ArenaSet<ArtMethod*>& cha_single_implementation_list)
       REQUIRES_SHARED(Locks::mutator_lock_)
@@ -191,6 +209,17 @@ class JitCodeCache {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Store the class or string `object` resolved by the slow path of the JIT code
+  // containing `pc` in the JIT .bss entry for `index` of `dex_file`, if the code has one.
+  void StoreJitBssEntry(ArtMethod* method,
+                        uintptr_t pc,
+                        const DexFile* dex_file,
+                        uint32_t index,
+                        bool is_string,
+                        ObjPtr<mirror::Object> object)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   OatQuickMethodHeader* LookupOsrMethodHeader(ArtMethod* method)
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -207,7 +236,11 @@ class JitCodeCache {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  void CopyInlineCacheInto(const InlineCache& ic, Handle<mirror::ObjectArray<mirror::Class>> array)
+  // Copy the classes of `ic` into `array`, most hit first, and their hits into `counts`,
+  // an array of InlineCache::kIndividualCacheSize elements.
+  void CopyInlineCacheInto(const InlineCache& ic,
+                           Handle<mirror::ObjectArray<mirror::Class>> array,
+                           /*out*/ uint16_t* counts)
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -244,6 +277,11 @@ class JitCodeCache {
 
   bool IsOsrCompiled(ArtMethod* method) REQUIRES(!lock_);
 
+  // Return true if the entrypoint of `method` is baseline code of the code cache.
+  bool IsBaselineCompiled(ArtMethod* method)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void SweepRootTables(IsMarkedVisitor* visitor)
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -289,7 +327,9 @@ class JitCodeCache {
                               size_t code_size,
                               size_t data_size,
                               bool osr,
+                              bool baseline,
                               Handle<mirror::ObjectArray<mirror::Object>> roots,
+                              const std::vector<JitBssEntry>& bss_entries,
                               bool has_should_deoptimize_flag,
                               const ArenaSet<ArtMethod*>& cha_single_implementation_list)
       REQUIRES(!lock_)
@@ -320,6 +360,14 @@ class JitCodeCache {
   // Free in the mspace allocations for `code_ptr`.
   void FreeCode(const void* code_ptr) REQUIRES(lock_);
 
+  // Publish a new PC index for the current method_code_map_, and free the previous one. Must be
+  // called after each removal from method_code_map_, and before the removed code is freed.
+  // Additions only mark the index stale.
+  void UpdatePcIndex() REQUIRES(lock_);
+
+  // Find the code of method_code_map_ containing `pc` without taking lock_.
+  const void* LookupCodeInPcIndex(uintptr_t pc, /*out*/ ArtMethod** method);
+
   // Number of bytes allocated in the code cache.
   size_t CodeCacheSizeLocked() REQUIRES(lock_);
 
@@ -392,6 +440,24 @@ class JitCodeCache {
   SafeMap<const void*, ArtMethod*> method_code_map_ GUARDED_BY(lock_);
   // Holds osr compiled code associated to the ArtMethod.
   SafeMap<ArtMethod*, const void*> osr_code_map_ GUARDED_BY(lock_);
+  // Code pointers of the baseline compiled code, which optimized code may replace.
+  std::set<const void*> baseline_code_ GUARDED_BY(lock_);
+  // The JIT .bss entries of the code, for the code that has some.
+  SafeMap<const void*, std::vector<JitBssEntry>> jit_bss_entries_ GUARDED_BY(lock_);
+
+  // Copy of method_code_map_ for the lookups of stack walks, which read it without lock_.
+  // Each removal publishes a new copy. Additions are published by the first lookup that misses
+  // them. The previous copy is freed once the lookups of the previous epoch are done.
+  struct PcIndexEntry {
+    uintptr_t code_begin;
+    uint32_t code_size;
+    ArtMethod* method;
+  };
+  using PcIndex = std::vector<PcIndexEntry>;
+  Atomic<const PcIndex*> pc_index_;
+  bool pc_index_is_stale_ GUARDED_BY(lock_);
+  Atomic<uint32_t> pc_index_epoch_;
+  Atomic<size_t> pc_lookups_in_flight_[2];
   // ProfilingInfo objects we have allocated.
   std::vector<ProfilingInfo*> profiling_infos_ GUARDED_BY(lock_);
 
@@ -463,6 +463,28 @@ TEST_F(ProfileCompilationInfoTest, MergeFdFail) {
   ASSERT_FALSE(info2.Load(profile.GetFd()));
 }
 
+TEST_F(ProfileCompilationInfoTest, LoadMergesWithExistingData) {
+  ScratchFile profile;
+
+  ProfileCompilationInfo info1;
+  ProfileCompilationInfo info2;
+  for (uint16_t i = 0; i < 10; i++) {
+    ASSERT_TRUE(AddMethod("dex_location1", /* checksum */ 1, /* method_idx */ i, &info1));
+    ASSERT_TRUE(AddMethod("dex_location2", /* checksum */ 2, /* method_idx */ i, &info2));
+    ASSERT_TRUE(AddMethod("dex_location1", /* checksum */ 1, /* method_idx */ i + 5, &info2));
+  }
+  ASSERT_TRUE(info2.Save(GetFd(profile)));
+  ASSERT_EQ(0, profile.GetFile()->Flush());
+  ASSERT_TRUE(profile.GetFile()->ResetOffset());
+
+  // Loading the profile into existing data is the same as merging them.
+  ProfileCompilationInfo merged_info;
+  ASSERT_TRUE(merged_info.MergeWith(info1));
+  ASSERT_TRUE(merged_info.MergeWith(info2));
+  ASSERT_TRUE(info1.Load(GetFd(profile)));
+  ASSERT_TRUE(info1.Equals(merged_info));
+}
+
 TEST_F(ProfileCompilationInfoTest, SaveMaxMethods) {
   ScratchFile profile;
 
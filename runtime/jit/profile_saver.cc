@@ -476,6 +476,57 @@ void ProfileSaver::FetchAndCacheResolvedClassesAndMethods(bool startup) {
                  << PrettyDuration(NanoTime() - start_time);
 }
 
+// Returns the modification time of `filename` in nanoseconds, or -1 if it cannot be read.
+static int64_t GetFileStamp(const std::string& filename) {
+  struct stat st;
+  if (stat(filename.c_str(), &st) != 0) {
+    return -1;
+  }
+  return static_cast<int64_t>(st.st_mtim.tv_sec) * INT64_C(1000000000) + st.st_mtim.tv_nsec;
+}
+
+bool ProfileSaver::MaySaveSinceLastSave(const std::string& filename,
+                                        const std::vector<ProfileMethodInfo>& profile_methods) {
+  auto last_saved_it = last_saved_profiles_.find(filename);
+  if (last_saved_it == last_saved_profiles_.end()) {
+    return true;
+  }
+  const LastSavedProfile& last_saved = last_saved_it->second;
+  int64_t file_stamp = GetFileStamp(filename);
+  if (file_stamp == -1 || file_stamp != last_saved.file_stamp) {
+    // Another process may have written the file, or cleared it.
+    return true;
+  }
+  ProfileCompilationInfo info(Runtime::Current()->GetArenaPool());
+  if (!info.MergeWith(*last_saved.info) ||
+      !info.AddMethods(profile_methods, ProfileCompilationInfo::MethodHotness::kFlagPostStartup)) {
+    return true;
+  }
+  auto profile_cache_it = profile_cache_.find(filename);
+  if (profile_cache_it != profile_cache_.end() && !info.MergeWith(*profile_cache_it->second)) {
+    return true;
+  }
+  int64_t delta_number_of_methods =
+      info.GetNumberOfMethods() - last_saved.info->GetNumberOfMethods();
+  int64_t delta_number_of_classes =
+      info.GetNumberOfResolvedClasses() - last_saved.info->GetNumberOfResolvedClasses();
+  return delta_number_of_methods >= options_.GetMinMethodsToSave() ||
+      delta_number_of_classes >= options_.GetMinClassesToSave();
+}
+
+void ProfileSaver::SetLastSavedProfile(const std::string& filename,
+                                       const ProfileCompilationInfo& info,
+                                       int64_t file_stamp) {
+  std::unique_ptr<ProfileCompilationInfo> copy(
+      new ProfileCompilationInfo(Runtime::Current()->GetArenaPool()));
+  if (file_stamp == -1 || !copy->MergeWith(info)) {
+    last_saved_profiles_.erase(filename);
+    return;
+  }
+  last_saved_profiles_.erase(filename);
+  last_saved_profiles_.Put(filename, LastSavedProfile{std::move(copy), file_stamp});
+}
+
 bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number_of_new_methods) {
   ScopedTrace trace(__PRETTY_FUNCTION__);
 
@@ -514,12 +565,21 @@ bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number
       jit_code_cache_->GetProfiledMethods(locations, profile_methods);
       total_number_of_code_cache_queries_++;
     }
+    if (!force_save && !MaySaveSinceLastSave(filename, profile_methods)) {
+      VLOG(profiler) << "Not enough new information to load and save: " << filename;
+      total_number_of_skipped_writes_++;
+      continue;
+    }
     {
       ProfileCompilationInfo info(Runtime::Current()->GetArenaPool());
+      // Read the modification time first, a write after it is then seen by the next check.
+      int64_t loaded_file_stamp = GetFileStamp(filename);
       if (!info.Load(filename, /*clear_if_invalid*/ true)) {
         LOG(WARNING) << "Could not forcefully load profile " << filename;
+        last_saved_profiles_.erase(filename);
         continue;
       }
+      SetLastSavedProfile(filename, info, loaded_file_stamp);
       uint64_t last_save_number_of_methods = info.GetNumberOfMethods();
       uint64_t last_save_number_of_classes = info.GetNumberOfResolvedClasses();
 
@@ -573,6 +633,7 @@ bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number
           profile_cache_.erase(profile_cache_it);
           delete cached_info;
         }
+        SetLastSavedProfile(filename, info, GetFileStamp(filename));
         if (bytes_written > 0) {
           total_number_of_writes_++;
           total_bytes_written_ += bytes_written;
@@ -586,6 +647,7 @@ bool ProfileSaver::ProcessProfilingInfo(bool force_save, /*out*/uint16_t* number
         }
       } else {
         LOG(WARNING) << "Could not save profiling info to " << filename;
+        last_saved_profiles_.erase(filename);
         total_number_of_failed_writes_++;
       }
     }
@@ -98,6 +98,17 @@ class ProfileSaver {
   // profile_cache_ for later save.
   void FetchAndCacheResolvedClassesAndMethods(bool startup);
 
+  // Returns whether `filename` may need to be saved, either because it changed since it was last
+  // loaded or saved, or because the new methods and classes for it are enough for a save. Unlike
+  // the check done after loading the file, this does not read the file.
+  bool MaySaveSinceLastSave(const std::string& filename,
+                            const std::vector<ProfileMethodInfo>& profile_methods);
+
+  // Record the data on disk of `filename`, after loading or saving it.
+  void SetLastSavedProfile(const std::string& filename,
+                           const ProfileCompilationInfo& info,
+                           int64_t file_stamp);
+
   void DumpInfo(std::ostream& os);
 
   // Resolve the realpath of the locations stored in tracked_dex_base_locations_to_be_resolved_
@@ -133,6 +144,15 @@ class ProfileSaver {
   // to just a few hundreds entries in the ProfileCompilationInfo objects.
   SafeMap<std::string, ProfileCompilationInfo*> profile_cache_;
 
+  // The profile information of each tracked file when it was last loaded or saved by the saver,
+  // along with the modification time of the file then. Used to skip loading files that did not
+  // change and would not get enough new information to be saved.
+  struct LastSavedProfile {
+    std::unique_ptr<ProfileCompilationInfo> info;
+    int64_t file_stamp;
+  };
+  SafeMap<std::string, LastSavedProfile> last_saved_profiles_;
+
   // Save period condition support.
   Mutex wait_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ConditionVariable period_condition_ GUARDED_BY(wait_lock_);
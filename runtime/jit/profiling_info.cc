@@ -81,11 +81,13 @@ InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
 
 void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
   InlineCache* cache = GetInlineCache(dex_pc);
+  size_t least_hit = 0;
   for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
     mirror::Class* existing = cache->classes_[i].Read<kWithoutReadBarrier>();
     mirror::Class* marked = ReadBarrier::IsMarked(existing);
     if (marked == cls) {
-      // Receiver type is already in the cache, nothing else to do.
+      // Receiver type is already in the cache, just count the hit.
+      cache->IncrementCount(i);
       return;
     } else if (marked == nullptr) {
       // Cache entry is empty, try to put `cls` in it.
@@ -101,12 +103,24 @@ void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
         --i;
       } else {
         // We successfully set `cls`, just return.
+        cache->counts_[i] = 1u;
         return;
       }
+    } else if (cache->counts_[i] < cache->counts_[least_hit]) {
+      least_hit = i;
     }
   }
   // Unsuccessfull - cache is full, making it megamorphic. We do not DCHECK it though,
   // as the garbage collector might clear the entries concurrently.
+  // Replace the least hit class, `cls` takes over its count. A class with more than a
+  // fifth of the hits can not be replaced this way, so the frequent receivers stay.
+  mirror::Class* existing = cache->classes_[least_hit].Read<kWithoutReadBarrier>();
+  GcRoot<mirror::Class> expected_root(existing);
+  GcRoot<mirror::Class> desired_root(cls);
+  auto atomic_root = reinterpret_cast<Atomic<GcRoot<mirror::Class>>*>(&cache->classes_[least_hit]);
+  if (atomic_root->CompareAndSetStrongSequentiallyConsistent(expected_root, desired_root)) {
+    cache->IncrementCount(least_hit);
+  }
 }
 
 }  // namespace art
@@ -37,13 +37,38 @@ class Class;
 
 // Structure to store the classes seen at runtime for a specific instruction.
 // Once the classes_ array is full, we consider the INVOKE to be megamorphic.
+// Each class has a hit count. A megamorphic INVOKE seeing a class not in the cache
+// replaces the least hit one, which keeps the most frequent receivers in the cache.
 class InlineCache {
  public:
   static constexpr uint8_t kIndividualCacheSize = 5;
 
+  // Returns the approximate number of hits of the INVOKE, which the compiler uses
+  // to estimate the hotness of the call site.
+  uint32_t GetTotalCount() const {
+    uint32_t total_count = 0u;
+    for (size_t i = 0; i < kIndividualCacheSize; ++i) {
+      total_count += counts_[i];
+    }
+    return total_count;
+  }
+
  private:
+  void IncrementCount(size_t index) {
+    if (UNLIKELY(counts_[index] == std::numeric_limits<uint16_t>::max())) {
+      // Halve all counts, which keeps their ratios.
+      for (size_t i = 0; i < kIndividualCacheSize; ++i) {
+        counts_[i] /= 2u;
+      }
+    }
+    counts_[index]++;
+  }
+
   uint32_t dex_pc_;
   GcRoot<mirror::Class> classes_[kIndividualCacheSize];
+  // Approximate hits of each entry of `classes_`. Updated without synchronization, as
+  // the compiler only needs the shares of the receivers.
+  uint16_t counts_[kIndividualCacheSize];
 
   friend class jit::JitCodeCache;
   friend class ProfilingInfo;
@@ -19,18 +19,23 @@
 
 #include "jni_env_ext.h"
 
+#include "indirect_reference_table-inl.h"
 #include "mirror/object.h"
 
 namespace art {
 
 template<typename T>
 inline T JNIEnvExt::AddLocalReference(ObjPtr<mirror::Object> obj) {
-  std::string error_msg;
-  IndirectRef ref = locals_.Add(local_ref_cookie_, obj, &error_msg);
+  IndirectRef ref = locals_.AddAtTop(local_ref_cookie_, obj);
   if (UNLIKELY(ref == nullptr)) {
-    // This is really unexpected if we allow resizing local IRTs...
-    LOG(FATAL) << error_msg;
-    UNREACHABLE();
+    // Fill a hole or grow the table.
+    std::string error_msg;
+    ref = locals_.Add(local_ref_cookie_, obj, &error_msg);
+    if (UNLIKELY(ref == nullptr)) {
+      // This is really unexpected if we allow resizing local IRTs...
+      LOG(FATAL) << error_msg;
+      UNREACHABLE();
+    }
   }
 
   // TODO: fix this to understand PushLocalFrame, so we can turn it on.
@@ -2088,6 +2088,12 @@ class JNI {
     if (heap->IsMovableObject(array)) {
         if (!kUseReadBarrier) {
           heap->IncrementDisableMovingGC(soa.Self());
+        } else if (heap->PinRegionSpaceObject(array)) {
+          // The CC collector does not evacuate the pinned region, nothing else to wait for.
+          if (is_copy != nullptr) {
+            *is_copy = JNI_FALSE;
+          }
+          return array->GetRawData(array->GetClass()->GetComponentSize(), 0);
         } else {
           // For the CC collector, we only need to wait for the thread flip rather than the whole GC
           // to occur thanks to the to-space invariant.
@@ -2506,13 +2512,32 @@ class JNI {
   }
 
   static void* GetDirectBufferAddress(JNIEnv* env, jobject java_buffer) {
-    return reinterpret_cast<void*>(env->GetLongField(
-        java_buffer, WellKnownClasses::java_nio_DirectByteBuffer_effectiveDirectAddress));
+    // Native code usually calls this for each access of the buffer, so read the field directly
+    // rather than through GetLongField, which decodes and checks the arguments again.
+    if (java_buffer == nullptr) {
+      return nullptr;
+    }
+    ScopedObjectAccess soa(env);
+    ObjPtr<mirror::Object> buffer = DecodeDirectBuffer(soa, java_buffer);
+    if (buffer == nullptr) {
+      return nullptr;
+    }
+    ArtField* f =
+        jni::DecodeArtField(WellKnownClasses::java_nio_DirectByteBuffer_effectiveDirectAddress);
+    return reinterpret_cast<void*>(f->GetLong(buffer));
   }
 
   static jlong GetDirectBufferCapacity(JNIEnv* env, jobject java_buffer) {
-    return static_cast<jlong>(env->GetIntField(
-        java_buffer, WellKnownClasses::java_nio_DirectByteBuffer_capacity));
+    if (java_buffer == nullptr) {
+      return -1;
+    }
+    ScopedObjectAccess soa(env);
+    ObjPtr<mirror::Object> buffer = DecodeDirectBuffer(soa, java_buffer);
+    if (buffer == nullptr) {
+      return -1;
+    }
+    ArtField* f = jni::DecodeArtField(WellKnownClasses::java_nio_DirectByteBuffer_capacity);
+    return static_cast<jlong>(f->GetInt(buffer));
   }
 
   static jobjectRefType GetObjectRefType(JNIEnv* env ATTRIBUTE_UNUSED, jobject java_object) {
@@ -2539,6 +2564,15 @@ class JNI {
   }
 
  private:
+  // Return the buffer, or null if it is not a direct buffer, as the JNI spec allows.
+  static ObjPtr<mirror::Object> DecodeDirectBuffer(ScopedObjectAccess& soa, jobject java_buffer)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    ObjPtr<mirror::Object> buffer = soa.Decode<mirror::Object>(java_buffer);
+    ObjPtr<mirror::Class> direct_buffer_class =
+        soa.Decode<mirror::Class>(WellKnownClasses::java_nio_DirectByteBuffer);
+    return buffer->InstanceOf(direct_buffer_class) ? buffer : nullptr;
+  }
+
   static jint EnsureLocalCapacityInternal(ScopedObjectAccess& soa, jint desired_capacity,
                                           const char* caller)
       REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -2655,10 +2689,10 @@ class JNI {
       if (is_copy) {
         delete[] reinterpret_cast<uint64_t*>(elements);
       } else if (heap->IsMovableObject(array)) {
-        // Non copy to a movable object must means that we had disabled the moving GC.
+        // Non copy to a movable object must means that we had pinned it or disabled the moving GC.
         if (!kUseReadBarrier) {
           heap->DecrementDisableMovingGC(soa.Self());
-        } else {
+        } else if (!heap->UnpinRegionSpaceObject(array)) {
           heap->DecrementDisableThreadFlip(soa.Self());
         }
       }
@@ -2288,6 +2288,12 @@ TEST_F(JniInternalTest, NewDirectBuffer_GetDirectBufferAddress_GetDirectBufferCa
   ASSERT_EQ(env_->GetDirectBufferAddress(buffer), bytes);
   ASSERT_EQ(env_->GetDirectBufferCapacity(buffer), static_cast<jlong>(sizeof(bytes)));
 
+  // Objects that are not direct buffers have no address.
+  jobject not_a_buffer = env_->NewStringUTF("not a buffer");
+  ASSERT_NE(not_a_buffer, nullptr);
+  EXPECT_EQ(env_->GetDirectBufferAddress(not_a_buffer), nullptr);
+  EXPECT_EQ(env_->GetDirectBufferCapacity(not_a_buffer), -1);
+
   {
     CheckJniAbortCatcher check_jni_abort_catcher;
     env_->NewDirectByteBuffer(bytes, static_cast<jlong>(INT_MAX) + 1);
@@ -16,33 +16,102 @@
 
 #include "linear_alloc.h"
 
+#include <ostream>
+
+#include "base/memory_tool.h"
 #include "thread-current-inl.h"
 
 namespace art {
 
-LinearAlloc::LinearAlloc(ArenaPool* pool) : lock_("linear alloc"), allocator_(pool) {
+// The size of the chunks of the threads. The allocations larger than a quarter of it are done
+// under the lock, so that at most that much of a chunk is wasted when taking a new one.
+static constexpr size_t kThreadLocalChunkSize = 4 * KB;
+static constexpr size_t kMaxThreadLocalAllocSize = kThreadLocalChunkSize / 4;
+
+static const char* const kLinearAllocKindNames[] = {
+  "Misc         ",
+  "ArtFields    ",
+  "ArtMethods   ",
+  "DexCache     ",
+  "ImTable      ",
+  "ImtConflicts ",
+};
+static_assert(arraysize(kLinearAllocKindNames) == kNumLinearAllocKinds,
+              "Update kLinearAllocKindNames");
+
+std::ostream& operator<<(std::ostream& os, LinearAllocKind kind) {
+  DCHECK_LT(kind, kNumLinearAllocKinds);
+  return os << kLinearAllocKindNames[kind];
+}
+
+LinearAlloc::LinearAlloc(ArenaPool* pool, bool use_thread_local_chunks)
+    : lock_("linear alloc"),
+      allocator_(pool),
+      // The chunks would hide the red zones of the allocations from the memory tool.
+      use_thread_local_chunks_(use_thread_local_chunks && !kMemoryToolIsAvailable) {
 }
 
-void* LinearAlloc::Realloc(Thread* self, void* ptr, size_t old_size, size_t new_size) {
+void* LinearAlloc::Realloc(Thread* self,
+                           void* ptr,
+                           size_t old_size,
+                           size_t new_size,
+                           LinearAllocKind kind) {
+  RecordAlloc(new_size, kind);
+  // The arena allocator extends `ptr` in place only when it ends at the top of the arena. If `ptr`
+  // is in a chunk, that means it ends the chunk, which has then no room left for its thread.
   MutexLock mu(self, lock_);
   return allocator_.Realloc(ptr, old_size, new_size);
 }
 
-void* LinearAlloc::Alloc(Thread* self, size_t size) {
+void* LinearAlloc::Alloc(Thread* self, size_t size, LinearAllocKind kind) {
+  RecordAlloc(size, kind);
+  if (use_thread_local_chunks_ && self != nullptr && size <= kMaxThreadLocalAllocSize) {
+    return AllocThreadLocal(self, size, ArenaAllocator::kAlignment);
+  }
   MutexLock mu(self, lock_);
   return allocator_.Alloc(size);
 }
 
-void* LinearAlloc::AllocAlign16(Thread* self, size_t size) {
+void* LinearAlloc::AllocAlign16(Thread* self, size_t size, LinearAllocKind kind) {
+  RecordAlloc(size, kind);
+  if (use_thread_local_chunks_ && self != nullptr && size <= kMaxThreadLocalAllocSize) {
+    return AllocThreadLocal(self, size, 16u);
+  }
   MutexLock mu(self, lock_);
   return allocator_.AllocAlign16(size);
 }
 
+void* LinearAlloc::AllocThreadLocal(Thread* self, size_t size, size_t alignment) {
+  DCHECK_EQ(self, Thread::Current());
+  DCHECK_LE(size, kMaxThreadLocalAllocSize);
+  Thread::LinearAllocChunk* chunk = self->GetLinearAllocChunk();
+  uint8_t* pos = AlignUp(chunk->pos, alignment);
+  if (chunk->owner != this || size > static_cast<size_t>(chunk->end - pos)) {
+    // The rest of the old chunk is wasted.
+    MutexLock mu(self, lock_);
+    pos = reinterpret_cast<uint8_t*>(allocator_.AllocAlign16(kThreadLocalChunkSize));
+    chunk->owner = this;
+    chunk->end = pos + kThreadLocalChunkSize;
+  }
+  DCHECK_ALIGNED_PARAM(reinterpret_cast<uintptr_t>(pos), alignment);
+  chunk->pos = pos + RoundUp(size, ArenaAllocator::kAlignment);
+  // The arena memory is zeroed, like the memory the arena allocator returns.
+  return pos;
+}
+
 size_t LinearAlloc::GetUsedMemory() const {
   MutexLock mu(Thread::Current(), lock_);
   return allocator_.BytesUsed();
 }
 
+void LinearAlloc::DumpMemoryStats(std::ostream& os) const {
+  for (size_t i = 0; i != kNumLinearAllocKinds; ++i) {
+    LinearAllocKind kind = static_cast<LinearAllocKind>(i);
+    os << " " << kind << " " << GetBytesAllocated(kind) << "\n";
+  }
+  os << " Used         " << GetUsedMemory() << "\n";
+}
+
 ArenaPool* LinearAlloc::GetArenaPool() {
   MutexLock mu(Thread::Current(), lock_);
   return allocator_.GetArenaPool();
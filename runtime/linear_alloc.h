@@ -17,32 +17,68 @@
 #ifndef ART_RUNTIME_LINEAR_ALLOC_H_
 #define ART_RUNTIME_LINEAR_ALLOC_H_
 
+#include <array>
+#include <iosfwd>
+
 #include "base/arena_allocator.h"
+#include "base/atomic.h"
 
 namespace art {
 
 class ArenaPool;
 
+// What the memory of a LinearAlloc is used for, for the statistics.
+enum LinearAllocKind {
+  kLinearAllocMisc,
+  kLinearAllocArtFieldArray,
+  kLinearAllocArtMethodArray,
+  kLinearAllocDexCacheArrays,
+  kLinearAllocImTable,
+  kLinearAllocImtConflictTable,
+  kNumLinearAllocKinds
+};
+
+std::ostream& operator<<(std::ostream& os, LinearAllocKind kind);
+
 // TODO: Support freeing if we add poor man's class unloading.
 class LinearAlloc {
  public:
-  explicit LinearAlloc(ArenaPool* pool);
+  // With `use_thread_local_chunks`, the small allocations are bumped from a chunk owned by the
+  // allocating thread and only taking a new chunk needs the lock. The chunks are remembered by
+  // the threads, so only an allocator outliving all the threads, like the one of the runtime, may
+  // use them.
+  explicit LinearAlloc(ArenaPool* pool, bool use_thread_local_chunks = false);
 
-  void* Alloc(Thread* self, size_t size) REQUIRES(!lock_);
-  void* AllocAlign16(Thread* self, size_t size) REQUIRES(!lock_);
+  void* Alloc(Thread* self, size_t size, LinearAllocKind kind = kLinearAllocMisc)
+      REQUIRES(!lock_);
+  void* AllocAlign16(Thread* self, size_t size, LinearAllocKind kind = kLinearAllocMisc)
+      REQUIRES(!lock_);
 
   // Realloc never frees the input pointer, it is the caller's job to do this if necessary.
-  void* Realloc(Thread* self, void* ptr, size_t old_size, size_t new_size) REQUIRES(!lock_);
+  void* Realloc(Thread* self,
+                void* ptr,
+                size_t old_size,
+                size_t new_size,
+                LinearAllocKind kind = kLinearAllocMisc) REQUIRES(!lock_);
 
   // Allocate an array of structs of type T.
   template<class T>
-  T* AllocArray(Thread* self, size_t elements) REQUIRES(!lock_) {
-    return reinterpret_cast<T*>(Alloc(self, elements * sizeof(T)));
+  T* AllocArray(Thread* self, size_t elements, LinearAllocKind kind = kLinearAllocMisc)
+      REQUIRES(!lock_) {
+    return reinterpret_cast<T*>(Alloc(self, elements * sizeof(T), kind));
   }
 
   // Return the number of bytes used in the allocator.
   size_t GetUsedMemory() const REQUIRES(!lock_);
 
+  // Return the number of bytes requested for `kind`. Realloc counts the new size.
+  size_t GetBytesAllocated(LinearAllocKind kind) const {
+    return bytes_allocated_[kind].LoadRelaxed();
+  }
+
+  // Dump the bytes requested for each kind and the bytes used.
+  void DumpMemoryStats(std::ostream& os) const REQUIRES(!lock_);
+
   ArenaPool* GetArenaPool() REQUIRES(!lock_);
 
   // Return true if the linear alloc contrains an address.
@@ -53,8 +89,17 @@ class LinearAlloc {
   bool ContainsUnsafe(void* ptr) const NO_THREAD_SAFETY_ANALYSIS;
 
  private:
+  // Allocate `size` bytes aligned to `alignment` from the chunk of `self`.
+  void* AllocThreadLocal(Thread* self, size_t size, size_t alignment) REQUIRES(!lock_);
+
+  void RecordAlloc(size_t size, LinearAllocKind kind) {
+    bytes_allocated_[kind].FetchAndAddRelaxed(size);
+  }
+
   mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ArenaAllocator allocator_ GUARDED_BY(lock_);
+  const bool use_thread_local_chunks_;
+  std::array<Atomic<size_t>, kNumLinearAllocKinds> bytes_allocated_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(LinearAlloc);
 };
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "linear_alloc.h"
+
+#include <string.h>
+
+#include "base/bit_utils.h"
+#include "base/memory_tool.h"
+#include "common_runtime_test.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+class LinearAllocTest : public CommonRuntimeTest {
+ protected:
+  void TestAllocations(bool use_thread_local_chunks) {
+    Thread* self = Thread::Current();
+    LinearAlloc linear_alloc(Runtime::Current()->GetArenaPool(), use_thread_local_chunks);
+    static constexpr size_t kSizes[] = { 1u, 8u, 24u, 100u, 512u, 2000u, 64 * KB };
+    std::vector<std::pair<uint8_t*, size_t>> allocations;
+    for (size_t i = 0; i != 200u; ++i) {
+      size_t size = kSizes[i % arraysize(kSizes)];
+      bool align16 = (i % 3u == 0u);
+      uint8_t* ptr = align16
+          ? reinterpret_cast<uint8_t*>(linear_alloc.AllocAlign16(
+                self, RoundUp(size, 16u), kLinearAllocArtMethodArray))
+          : reinterpret_cast<uint8_t*>(linear_alloc.Alloc(self, size, kLinearAllocArtFieldArray));
+      ASSERT_TRUE(ptr != nullptr);
+      EXPECT_TRUE(IsAlignedParam(ptr, align16 ? 16u : ArenaAllocator::kAlignment));
+      EXPECT_TRUE(linear_alloc.Contains(ptr));
+      // The memory is zeroed and not shared with the other allocations.
+      for (size_t j = 0; j != size; ++j) {
+        ASSERT_EQ(0u, ptr[j]);
+      }
+      memset(ptr, 0xff, size);
+      allocations.push_back(std::make_pair(ptr, size));
+    }
+    for (const std::pair<uint8_t*, size_t>& allocation : allocations) {
+      for (size_t j = 0; j != allocation.second; ++j) {
+        ASSERT_EQ(0xffu, allocation.first[j]);
+      }
+    }
+    EXPECT_NE(0u, linear_alloc.GetBytesAllocated(kLinearAllocArtMethodArray));
+    EXPECT_NE(0u, linear_alloc.GetBytesAllocated(kLinearAllocArtFieldArray));
+    EXPECT_EQ(0u, linear_alloc.GetBytesAllocated(kLinearAllocDexCacheArrays));
+    EXPECT_GE(linear_alloc.GetUsedMemory(),
+              linear_alloc.GetBytesAllocated(kLinearAllocArtMethodArray) +
+                  linear_alloc.GetBytesAllocated(kLinearAllocArtFieldArray));
+    // Do not leave the thread with a chunk of the deleted `linear_alloc`.
+    *self->GetLinearAllocChunk() = Thread::LinearAllocChunk();
+  }
+};
+
+TEST_F(LinearAllocTest, Alloc) {
+  TestAllocations(/* use_thread_local_chunks */ false);
+}
+
+TEST_F(LinearAllocTest, AllocThreadLocal) {
+  TestAllocations(/* use_thread_local_chunks */ true);
+}
+
+TEST_F(LinearAllocTest, Realloc) {
+  Thread* self = Thread::Current();
+  LinearAlloc linear_alloc(Runtime::Current()->GetArenaPool(), /* use_thread_local_chunks */ true);
+  uint8_t* ptr = reinterpret_cast<uint8_t*>(linear_alloc.Alloc(self, 16u));
+  memset(ptr, 0x5a, 16u);
+  // Allocations after `ptr` must not be overwritten when it grows.
+  uint8_t* next = reinterpret_cast<uint8_t*>(linear_alloc.Alloc(self, 16u));
+  memset(next, 0xa5, 16u);
+  uint8_t* grown = reinterpret_cast<uint8_t*>(linear_alloc.Realloc(self, ptr, 16u, 256u));
+  for (size_t i = 0; i != 16u; ++i) {
+    EXPECT_EQ(0x5au, grown[i]);
+    EXPECT_EQ(0xa5u, next[i]);
+  }
+  EXPECT_EQ(256u + 32u, linear_alloc.GetBytesAllocated(kLinearAllocMisc));
+  *self->GetLinearAllocChunk() = Thread::LinearAllocChunk();
+}
+
+}  // namespace art
@@ -288,6 +288,46 @@ static inline void* TryMemMapLow4GB(void* ptr,
   }
   return actual;
 }
+
+// Returns the end of the run of mapped pages starting at the mapped page `begin`, not going beyond
+// `limit`. msync() fails with ENOMEM when any page of the range is not mapped, so the run is found
+// with an exponential then a binary search, in a logarithmic number of calls rather than one call
+// per page.
+static uintptr_t FindEndOfMappedPages(uintptr_t begin, uintptr_t limit) {
+  DCHECK_ALIGNED(begin, kPageSize);
+  DCHECK_ALIGNED(limit, kPageSize);
+  DCHECK_LT(begin, limit);
+  auto is_mapped = [begin](size_t size) {
+    return msync(reinterpret_cast<void*>(begin), size, 0) == 0;
+  };
+  size_t max_size = limit - begin;
+  // Invariant: [begin, begin + low) is mapped and, unless high == max_size + kPageSize,
+  // [begin, begin + high) is not.
+  size_t low = kPageSize;
+  size_t high = max_size + kPageSize;
+  for (size_t size = 2 * kPageSize; size <= max_size; size *= 2) {
+    if (!is_mapped(size)) {
+      high = size;
+      break;
+    }
+    low = size;
+  }
+  if (high > max_size) {
+    if (low == max_size || is_mapped(max_size)) {
+      return limit;
+    }
+    high = max_size;
+  }
+  while (high - low > kPageSize) {
+    size_t mid = RoundDown(low + (high - low) / 2, kPageSize);
+    if (is_mapped(mid)) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+  return begin + low;
+}
 #endif
 
 MemMap* MemMap::MapAnonymous(const char* name,
@@ -710,6 +750,16 @@ void MemMap::MadviseDontNeedAndZero() {
   }
 }
 
+void MemMap::MadviseHugePages() {
+#ifdef MADV_HUGEPAGE
+  uint8_t* const huge_begin = AlignUp(begin_, kHugePageSize);
+  uint8_t* const huge_end = AlignDown(End(), kHugePageSize);
+  if (huge_begin < huge_end && madvise(huge_begin, huge_end - huge_begin, MADV_HUGEPAGE) == -1) {
+    PLOG(WARNING) << "madvise(MADV_HUGEPAGE) failed for " << name_;
+  }
+#endif
+}
+
 bool MemMap::Sync() {
   bool result;
   if (redzone_size_ != 0) {
@@ -975,8 +1025,9 @@ void* MemMap::MapInternalArtLow4GBAllocator(size_t length,
         return actual;
       }
     } else {
-      // Skip over last page.
-      ptr = tail_ptr;
+      // Skip over the mapping that is not known to gMaps, up to its last page.
+      ptr = FindEndOfMappedPages(tail_ptr, 4 * GB) - kPageSize;
+      next_mem_pos_ = ptr + kPageSize;
     }
   }
 
@@ -1085,14 +1136,14 @@ void MemMap::TryReadable() {
   }
 }
 
-void ZeroAndReleasePages(void* address, size_t length) {
+static void ZeroAndReleaseAlignedPages(void* address, size_t length, size_t page_size) {
   if (length == 0) {
     return;
   }
   uint8_t* const mem_begin = reinterpret_cast<uint8_t*>(address);
   uint8_t* const mem_end = mem_begin + length;
-  uint8_t* const page_begin = AlignUp(mem_begin, kPageSize);
-  uint8_t* const page_end = AlignDown(mem_end, kPageSize);
+  uint8_t* const page_begin = AlignUp(mem_begin, page_size);
+  uint8_t* const page_end = AlignDown(mem_end, page_size);
   if (!kMadviseZeroes || page_begin >= page_end) {
     // No possible area to madvise.
     std::fill(mem_begin, mem_end, 0);
@@ -1107,6 +1158,14 @@ void ZeroAndReleasePages(void* address, size_t length) {
   }
 }
 
+void ZeroAndReleasePages(void* address, size_t length) {
+  ZeroAndReleaseAlignedPages(address, length, kPageSize);
+}
+
+void ZeroAndReleaseHugePages(void* address, size_t length) {
+  ZeroAndReleaseAlignedPages(address, length, kHugePageSize);
+}
+
 void MemMap::AlignBy(size_t size) {
   CHECK_EQ(begin_, base_begin_) << "Unsupported";
   CHECK_EQ(size_, base_size_) << "Unsupported";
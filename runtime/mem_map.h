@@ -162,6 +162,9 @@ class MemMap {
 
   void MadviseDontNeedAndZero();
 
+  // Ask the kernel to back the whole aligned huge pages of the map with transparent huge pages.
+  void MadviseHugePages();
+
   int GetProtect() const {
     return prot_;
   }
@@ -295,6 +298,13 @@ std::ostream& operator<<(std::ostream& os, const MemMap& mem_map);
 // Zero and release pages if possible, no requirements on alignments.
 void ZeroAndReleasePages(void* address, size_t length);
 
+// Transparent huge page size, on all the supported architectures with 4 KB base pages.
+static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+// Like ZeroAndReleasePages but only release whole aligned huge pages, and zero the rest in
+// place, so that the huge pages backing the memory around the range are not split.
+void ZeroAndReleaseHugePages(void* address, size_t length);
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_MEM_MAP_H_
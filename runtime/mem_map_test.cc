@@ -737,4 +737,32 @@ TEST_F(MemMapTest, AlignBy) {
   }
 }
 
+TEST_F(MemMapTest, ZeroAndReleaseHugePages) {
+  CommonInit();
+  std::string error_msg;
+  std::unique_ptr<MemMap> map(MemMap::MapAnonymous("MemMapTest_ZeroAndReleaseHugePagesTest",
+                                                   nullptr,
+                                                   4 * kHugePageSize,
+                                                   PROT_READ | PROT_WRITE,
+                                                   false,
+                                                   false,
+                                                   &error_msg));
+  ASSERT_TRUE(map != nullptr) << error_msg;
+  map->MadviseHugePages();
+  // Zero a range that starts and ends in the middle of huge pages.
+  uint8_t* const huge_begin = AlignUp(map->Begin(), kHugePageSize);
+  uint8_t* const begin = huge_begin + kPageSize;
+  uint8_t* const end = AlignUp(begin, kHugePageSize) + kHugePageSize + 3 * kPageSize;
+  ASSERT_LE(end + kPageSize, map->End());
+  memset(map->Begin(), 1, map->Size());
+  ZeroAndReleaseHugePages(begin, end - begin);
+  for (uint8_t* ptr = map->Begin(); ptr < map->End(); ptr += kPageSize / 2) {
+    EXPECT_EQ(*ptr, (ptr >= begin && ptr < end) ? 0 : 1) << static_cast<void*>(ptr);
+  }
+  EXPECT_EQ(*(begin - 1), 1);
+  EXPECT_EQ(*begin, 0);
+  EXPECT_EQ(*(end - 1), 0);
+  EXPECT_EQ(*end, 1);
+}
+
 }  // namespace art
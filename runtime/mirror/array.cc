@@ -56,7 +56,19 @@ static Array* RecursiveCreateMultiArray(Thread* self,
     CHECK(self->IsExceptionPending());
     return nullptr;
   }
-  if (current_dimension + 1 < dimensions->GetLength()) {
+  if (current_dimension + 2 == dimensions->GetLength()) {
+    // The sub-arrays are the innermost ones, all of the same size, allocate them in bulk.
+    StackHandleScope<2> hs2(self);
+    Handle<mirror::Class> h_component_type(hs2.NewHandle(array_class->GetComponentType()));
+    Handle<ObjectArray<Array>> h_sub_arrays(hs2.NewHandle(new_array->AsObjectArray<Array>()));
+    if (UNLIKELY(!Array::AllocArrays(self,
+                                     h_component_type,
+                                     dimensions->Get(current_dimension + 1),
+                                     h_sub_arrays))) {
+      CHECK(self->IsExceptionPending());
+      return nullptr;
+    }
+  } else if (current_dimension + 1 < dimensions->GetLength()) {
     // Create a new sub-array in every element of the array.
     for (int32_t i = 0; i < array_length; i++) {
       StackHandleScope<1> hs2(self);
@@ -74,6 +86,56 @@ static Array* RecursiveCreateMultiArray(Thread* self,
   return new_array.Get();
 }
 
+// The number of arrays that AllocArrays allocates at once.
+static constexpr size_t kAllocArraysBatchSize = 64;
+
+bool Array::AllocArrays(Thread* self,
+                        Handle<Class> array_class,
+                        int32_t component_count,
+                        Handle<ObjectArray<Array>> arrays) {
+  DCHECK(array_class->IsArrayClass());
+  DCHECK_GE(component_count, 0);
+  size_t component_size_shift = array_class->GetComponentSizeShift();
+  size_t size = ComputeArraySize(component_count, component_size_shift);
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  SetLengthVisitor visitor(component_count);
+  Object* batch[kAllocArraysBatchSize];
+  int32_t length = arrays->GetLength();
+  for (int32_t i = 0; i < length; ) {
+    size_t count = std::min(kAllocArraysBatchSize, static_cast<size_t>(length - i));
+    // On 32-bit, a size of 0 means overflow, which the slow path below reports.
+    size_t allocated = (size == 0u)
+        ? 0u
+        : heap->AllocObjectsThreadLocal(self,
+                                        array_class.Get(),
+                                        size,
+                                        count,
+                                        heap->GetCurrentAllocator(),
+                                        batch,
+                                        visitor);
+    // Nothing can suspend until the arrays are stored. Use non-transactional mode without check.
+    for (size_t j = 0; j != allocated; ++j) {
+      arrays->Set<false, false>(i + j, down_cast<Array*>(batch[j]));
+    }
+    i += allocated;
+    if (allocated < count) {
+      // Out of thread local buffer: allocate one array on the slow path, which refills it.
+      ObjPtr<Array> array = Alloc<true>(self,
+                                        array_class.Get(),
+                                        component_count,
+                                        component_size_shift,
+                                        heap->GetCurrentAllocator());
+      if (UNLIKELY(array == nullptr)) {
+        CHECK(self->IsExceptionPending());
+        return false;
+      }
+      arrays->Set<false, false>(i, array);
+      ++i;
+    }
+  }
+  return true;
+}
+
 Array* Array::CreateMultiArray(Thread* self, Handle<Class> element_class,
                                Handle<IntArray> dimensions) {
   // Verify dimensions.
@@ -46,6 +46,16 @@ class MANAGED Array : public Object {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Roles::uninterruptible_);
 
+  // Allocates an array of `component_count` elements of `array_class` for each element of
+  // `arrays`. The arrays are allocated in batches from the thread local buffer when possible.
+  // Returns false, with a pending exception, if an allocation failed.
+  static bool AllocArrays(Thread* self,
+                          Handle<Class> array_class,
+                          int32_t component_count,
+                          Handle<ObjectArray<Array>> arrays)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Roles::uninterruptible_);
+
   static Array* CreateMultiArray(Thread* self,
                                  Handle<Class> element_class,
                                  Handle<IntArray> dimensions)
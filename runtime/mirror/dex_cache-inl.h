@@ -54,13 +54,26 @@ inline uint32_t DexCache::ClassSize(PointerSize pointer_size) {
   return Class::ComputeClassSize(true, vtable_entries, 0, 0, 0, 0, 0, pointer_size);
 }
 
+// The number of slots of the string and type caches is either at least the number of ids, or a
+// power of 2, see NumCacheSlots.
+static inline uint32_t CacheSlotIndex(uint32_t idx, uint32_t num_slots) {
+  DCHECK_NE(num_slots, 0u);
+  return LIKELY(idx < num_slots) ? idx : (idx & (num_slots - 1u));
+}
+
 inline uint32_t DexCache::StringSlotIndex(dex::StringIndex string_idx) {
   DCHECK_LT(string_idx.index_, GetDexFile()->NumStringIds());
-  const uint32_t slot_idx = string_idx.index_ % kDexCacheStringCacheSize;
+  const uint32_t slot_idx = CacheSlotIndex(string_idx.index_, NumStrings());
   DCHECK_LT(slot_idx, NumStrings());
   return slot_idx;
 }
 
+inline bool DexCache::IsStringSlotTaken(dex::StringIndex string_idx) {
+  StringDexCachePair pair =
+      GetStrings()[StringSlotIndex(string_idx)].load(std::memory_order_relaxed);
+  return !pair.object.IsNull() && pair.index != string_idx.index_;
+}
+
 inline String* DexCache::GetResolvedString(dex::StringIndex string_idx) {
   return GetStrings()[StringSlotIndex(string_idx)].load(
       std::memory_order_relaxed).GetObjectForIndex(string_idx.index_);
@@ -92,11 +105,17 @@ inline void DexCache::ClearString(dex::StringIndex string_idx) {
 
 inline uint32_t DexCache::TypeSlotIndex(dex::TypeIndex type_idx) {
   DCHECK_LT(type_idx.index_, GetDexFile()->NumTypeIds());
-  const uint32_t slot_idx = type_idx.index_ % kDexCacheTypeCacheSize;
+  const uint32_t slot_idx = CacheSlotIndex(type_idx.index_, NumResolvedTypes());
   DCHECK_LT(slot_idx, NumResolvedTypes());
   return slot_idx;
 }
 
+inline bool DexCache::IsTypeSlotTaken(dex::TypeIndex type_idx) {
+  TypeDexCachePair pair =
+      GetResolvedTypes()[TypeSlotIndex(type_idx)].load(std::memory_order_relaxed);
+  return !pair.object.IsNull() && pair.index != type_idx.index_;
+}
+
 inline Class* DexCache::GetResolvedType(dex::TypeIndex type_idx) {
   // It is theorized that a load acquire is not required since obtaining the resolved class will
   // always have an address dependency or a lock.
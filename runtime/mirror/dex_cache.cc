@@ -39,10 +39,12 @@ void DexCache::InitializeDexCache(Thread* self,
                                   ObjPtr<mirror::String> location,
                                   const DexFile* dex_file,
                                   LinearAlloc* linear_alloc,
-                                  PointerSize image_pointer_size) {
+                                  PointerSize image_pointer_size,
+                                  bool large_caches) {
   DCHECK(dex_file != nullptr);
+  DCHECK(!large_caches || !Runtime::Current()->IsAotCompiler());
   ScopedAssertNoThreadSuspension sants(__FUNCTION__);
-  DexCacheArraysLayout layout(image_pointer_size, dex_file);
+  DexCacheArraysLayout layout(image_pointer_size, dex_file, large_caches);
   uint8_t* raw_arrays = nullptr;
 
   if (dex_file->NumStringIds() != 0u ||
@@ -53,8 +55,10 @@ void DexCache::InitializeDexCache(Thread* self,
     DCHECK(layout.Alignment() == 8u || layout.Alignment() == 16u);
     // Zero-initialized.
     raw_arrays = (layout.Alignment() == 16u)
-        ? reinterpret_cast<uint8_t*>(linear_alloc->AllocAlign16(self, layout.Size()))
-        : reinterpret_cast<uint8_t*>(linear_alloc->Alloc(self, layout.Size()));
+        ? reinterpret_cast<uint8_t*>(
+              linear_alloc->AllocAlign16(self, layout.Size(), kLinearAllocDexCacheArrays))
+        : reinterpret_cast<uint8_t*>(
+              linear_alloc->Alloc(self, layout.Size(), kLinearAllocDexCacheArrays));
   }
 
   StringDexCacheType* strings = (dex_file->NumStringIds() == 0u) ? nullptr :
@@ -66,14 +70,9 @@ void DexCache::InitializeDexCache(Thread* self,
   FieldDexCacheType* fields = (dex_file->NumFieldIds() == 0u) ? nullptr :
       reinterpret_cast<FieldDexCacheType*>(raw_arrays + layout.FieldsOffset());
 
-  size_t num_strings = kDexCacheStringCacheSize;
-  if (dex_file->NumStringIds() < num_strings) {
-    num_strings = dex_file->NumStringIds();
-  }
-  size_t num_types = kDexCacheTypeCacheSize;
-  if (dex_file->NumTypeIds() < num_types) {
-    num_types = dex_file->NumTypeIds();
-  }
+  size_t num_strings =
+      NumCacheSlots(dex_file->NumStringIds(), kDexCacheStringCacheSize, large_caches);
+  size_t num_types = NumCacheSlots(dex_file->NumTypeIds(), kDexCacheTypeCacheSize, large_caches);
   size_t num_fields = kDexCacheFieldCacheSize;
   if (dex_file->NumFieldIds() < num_fields) {
     num_fields = dex_file->NumFieldIds();
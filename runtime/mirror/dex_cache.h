@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_MIRROR_DEX_CACHE_H_
 #define ART_RUNTIME_MIRROR_DEX_CACHE_H_
 
+#include <algorithm>
+
 #include "array.h"
 #include "base/bit_utils.h"
 #include "base/mutex.h"
@@ -152,6 +154,12 @@ class MANAGED DexCache FINAL : public Object {
   static_assert(IsPowerOfTwo(kDexCacheStringCacheSize),
                 "String dex cache size is not a power of 2.");
 
+  // Size of the string and type dex caches of the dex files given large caches, see
+  // InitializeDexCache. A power of 2, like the default sizes.
+  static constexpr size_t kDexCacheLargeCacheSize = 16 * 1024;
+  static_assert(IsPowerOfTwo(kDexCacheLargeCacheSize),
+                "Large dex cache size is not a power of 2.");
+
   // Size of field dex cache. Needs to be a power of 2 for entrypoint assumptions to hold.
   static constexpr size_t kDexCacheFieldCacheSize = 1024;
   static_assert(IsPowerOfTwo(kDexCacheFieldCacheSize),
@@ -193,12 +201,23 @@ class MANAGED DexCache FINAL : public Object {
     return sizeof(DexCache);
   }
 
+  // Returns the number of slots of a string or type cache of `cache_size` entries, or of
+  // kDexCacheLargeCacheSize entries with `large_caches`, for `num_ids` ids. Each id has its own
+  // slot when there are enough of them, otherwise the number of slots is a power of 2.
+  static constexpr size_t NumCacheSlots(size_t num_ids, size_t cache_size, bool large_caches) {
+    return std::min(num_ids, large_caches ? kDexCacheLargeCacheSize : cache_size);
+  }
+
+  // With `large_caches`, the string and type caches have up to kDexCacheLargeCacheSize slots
+  // instead of the default sizes, for the hot dex files whose ids collide in the default caches.
+  // The dex caches of the images and of the AOT compiler always have the default sizes.
   static void InitializeDexCache(Thread* self,
                                  ObjPtr<mirror::DexCache> dex_cache,
                                  ObjPtr<mirror::String> location,
                                  const DexFile* dex_file,
                                  LinearAlloc* linear_alloc,
-                                 PointerSize image_pointer_size)
+                                 PointerSize image_pointer_size,
+                                 bool large_caches = false)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::dex_lock_);
 
@@ -430,6 +449,11 @@ class MANAGED DexCache FINAL : public Object {
 
   uint32_t StringSlotIndex(dex::StringIndex string_idx) REQUIRES_SHARED(Locks::mutator_lock_);
   uint32_t TypeSlotIndex(dex::TypeIndex type_idx) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Return true if the slot of `string_idx` or `type_idx` holds the entry of another index, for
+  // the collision statistics.
+  bool IsStringSlotTaken(dex::StringIndex string_idx) REQUIRES_SHARED(Locks::mutator_lock_);
+  bool IsTypeSlotTaken(dex::TypeIndex type_idx) REQUIRES_SHARED(Locks::mutator_lock_);
   uint32_t FieldSlotIndex(uint32_t field_idx) REQUIRES_SHARED(Locks::mutator_lock_);
   uint32_t MethodSlotIndex(uint32_t method_idx) REQUIRES_SHARED(Locks::mutator_lock_);
   uint32_t MethodTypeSlotIndex(uint32_t proto_idx) REQUIRES_SHARED(Locks::mutator_lock_);
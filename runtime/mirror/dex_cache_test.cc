@@ -62,6 +62,33 @@ TEST_F(DexCacheTest, Open) {
       || java_lang_dex_file_->NumProtoIds() == dex_cache->NumResolvedMethodTypes());
 }
 
+TEST_F(DexCacheTest, NumCacheSlots) {
+  static constexpr size_t kSize = DexCache::kDexCacheStringCacheSize;
+  static constexpr size_t kLargeSize = DexCache::kDexCacheLargeCacheSize;
+  // Few ids get a slot each, with or without large caches.
+  EXPECT_EQ(10u, DexCache::NumCacheSlots(10u, kSize, /* large_caches */ false));
+  EXPECT_EQ(10u, DexCache::NumCacheSlots(10u, kSize, /* large_caches */ true));
+  EXPECT_EQ(kSize, DexCache::NumCacheSlots(kSize + 1u, kSize, /* large_caches */ false));
+  EXPECT_EQ(kSize + 1u, DexCache::NumCacheSlots(kSize + 1u, kSize, /* large_caches */ true));
+  EXPECT_EQ(kLargeSize, DexCache::NumCacheSlots(kLargeSize * 2u, kSize, /* large_caches */ true));
+
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<1> hs(soa.Self());
+  Handle<DexCache> dex_cache(
+      hs.NewHandle(class_linker_->AllocAndInitializeDexCache(
+          soa.Self(),
+          *java_lang_dex_file_,
+          Runtime::Current()->GetLinearAlloc())));
+  ASSERT_TRUE(dex_cache != nullptr);
+  // The default caches are indexed by the id modulo their size.
+  for (size_t i = 0; i != java_lang_dex_file_->NumStringIds(); ++i) {
+    ASSERT_EQ(i % kSize, dex_cache->StringSlotIndex(dex::StringIndex(i)));
+  }
+  for (size_t i = 0; i != java_lang_dex_file_->NumTypeIds(); ++i) {
+    ASSERT_EQ(i % DexCache::kDexCacheTypeCacheSize, dex_cache->TypeSlotIndex(dex::TypeIndex(i)));
+  }
+}
+
 TEST_F(DexCacheMethodHandlesTest, Open) {
   ScopedObjectAccess soa(Thread::Current());
   StackHandleScope<1> hs(soa.Self());
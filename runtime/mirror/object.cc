@@ -29,6 +29,7 @@
 #include "gc/accounting/card_table-inl.h"
 #include "gc/heap.h"
 #include "handle_scope-inl.h"
+#include "identity_hash_table.h"
 #include "iftable-inl.h"
 #include "monitor.h"
 #include "object-inl.h"
@@ -42,6 +43,7 @@ namespace art {
 namespace mirror {
 
 Atomic<uint32_t> Object::hash_code_seed(987654321U + std::time(nullptr));
+Atomic<bool> Object::deterministic_hash_codes(false);
 
 class CopyReferenceFieldsWithReadBarrierVisitor {
  public:
@@ -170,7 +172,7 @@ Object* Object::Clone(Thread* self) {
   return copy.Ptr();
 }
 
-uint32_t Object::GenerateIdentityHashCode() {
+uint32_t Object::GenerateSharedIdentityHashCode() {
   uint32_t expected_value, new_value;
   do {
     expected_value = hash_code_seed.LoadRelaxed();
@@ -180,8 +182,40 @@ uint32_t Object::GenerateIdentityHashCode() {
   return expected_value & LockWord::kHashMask;
 }
 
+uint32_t Object::GenerateIdentityHashCode() {
+  Thread* self = Thread::Current();
+  if (self == nullptr || deterministic_hash_codes.LoadRelaxed()) {
+    return GenerateSharedIdentityHashCode();
+  }
+  // Each thread takes a seed from the shared sequence once, then generates its hash codes with
+  // its own xorshift generator, so that hashing does not contend on the shared seed.
+  uint32_t* seed = self->GetIdentityHashSeed();
+  uint32_t state = *seed;
+  if (UNLIKELY(state == 0u)) {
+    state = (GenerateSharedIdentityHashCode() ^ self->GetThreadId()) * 0x9e3779b9u;
+    state = (state != 0u) ? state : 1u;
+  }
+  uint32_t hash_code;
+  do {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    hash_code = state & LockWord::kHashMask;
+  } while (hash_code == 0u);
+  *seed = state;
+  return hash_code;
+}
+
 void Object::SetHashCodeSeed(uint32_t new_seed) {
   hash_code_seed.StoreRelaxed(new_seed);
+  // A known seed is for a known sequence of hash codes, which the per-thread generators of the
+  // threads would interleave in an unknown order.
+  deterministic_hash_codes.StoreRelaxed(true);
+}
+
+static IdentityHashTable* GetIdentityHashTable() {
+  Runtime* runtime = Runtime::Current();
+  return (runtime != nullptr) ? runtime->GetIdentityHashTable() : nullptr;
 }
 
 int32_t Object::IdentityHashCode() {
@@ -190,6 +224,16 @@ int32_t Object::IdentityHashCode() {
     LockWord lw = current_this->GetLockWord(false);
     switch (lw.GetState()) {
       case LockWord::kUnlocked: {
+        IdentityHashTable* table = GetIdentityHashTable();
+        Thread* self = Thread::Current();
+        if (table != nullptr && table->MayHaveEntryFor(self, current_this)) {
+          // The object may have been hashed while thin locked, move its hash code to the lock word.
+          int32_t hash_code;
+          if (table->PublishToLockWord(self, current_this, lw, &hash_code)) {
+            return hash_code;
+          }
+          break;
+        }
         // Try to compare and swap in a new hash, if we succeed we will return the hash on the next
         // loop iteration.
         LockWord hash_word = LockWord::FromHashCode(GenerateIdentityHashCode(), lw.GCState());
@@ -200,9 +244,19 @@ int32_t Object::IdentityHashCode() {
         break;
       }
       case LockWord::kThinLocked: {
+        Thread* self = Thread::Current();
+        IdentityHashTable* table = GetIdentityHashTable();
+        if (table != nullptr) {
+          // Keep the hash code in the side table rather than inflate the lock, which suspends the
+          // owner if it is another thread. Returns 0 if the lock word changed.
+          int32_t hash_code = table->GetOrAddForThinLocked(self, current_this);
+          if (hash_code != 0) {
+            return hash_code;
+          }
+          break;
+        }
         // Inflate the thin lock to a monitor and stick the hash code inside of the monitor. May
         // fail spuriously.
-        Thread* self = Thread::Current();
         StackHandleScope<1> hs(self);
         Handle<mirror::Object> h_this(hs.NewHandle(current_this));
         Monitor::InflateThinLocked(self, h_this, lw, GenerateIdentityHashCode());
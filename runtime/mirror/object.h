@@ -668,7 +668,8 @@ class MANAGED LOCKABLE Object {
 
   ArtField* FindFieldByOffset(MemberOffset offset) REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Used by object_test.
+  // Used by object_test, and by dex2oat for deterministic hash codes: after this, all the threads
+  // generate their hash codes from the shared seed.
   static void SetHashCodeSeed(uint32_t new_seed);
   // Generate an identity hash code. Public for object test.
   static uint32_t GenerateIdentityHashCode();
@@ -775,7 +776,12 @@ class MANAGED LOCKABLE Object {
                             size_t num_bytes)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Generate an identity hash code from the shared seed.
+  static uint32_t GenerateSharedIdentityHashCode();
+
   static Atomic<uint32_t> hash_code_seed;
+  // Whether SetHashCodeSeed was called.
+  static Atomic<bool> deterministic_hash_codes;
 
   // The Class representing the type of the object.
   HeapReference<Class> klass_;
@@ -19,6 +19,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <memory>
+#include <set>
 
 #include "array-inl.h"
 #include "art_field-inl.h"
@@ -173,6 +174,28 @@ TEST_F(ObjectTest, AllocArray) {
   EXPECT_EQ(1, a->GetLength());
 }
 
+TEST_F(ObjectTest, AllocArrays) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<2> hs(soa.Self());
+  Handle<Class> c(hs.NewHandle(class_linker_->FindSystemClass(soa.Self(), "[B")));
+  Class* outer_class = class_linker_->FindSystemClass(soa.Self(), "[[B");
+  Handle<ObjectArray<Array>> arrays(
+      hs.NewHandle(ObjectArray<Array>::Alloc(soa.Self(), outer_class, 1000)));
+  ASSERT_TRUE(arrays != nullptr);
+  ASSERT_TRUE(Array::AllocArrays(soa.Self(), c, 16, arrays));
+  std::set<Array*> seen;
+  for (int32_t i = 0; i < arrays->GetLength(); ++i) {
+    Array* a = arrays->Get(i);
+    ASSERT_TRUE(a != nullptr);
+    EXPECT_TRUE(c.Get() == a->GetClass());
+    EXPECT_EQ(16, a->GetLength());
+    EXPECT_TRUE(seen.insert(a).second);
+    for (int32_t j = 0; j < 16; ++j) {
+      EXPECT_EQ(0, a->AsByteArray()->Get(j));
+    }
+  }
+}
+
 TEST_F(ObjectTest, AllocArray_FillUsable) {
   ScopedObjectAccess soa(Thread::Current());
   Class* c = class_linker_->FindSystemClass(soa.Self(), "[B");
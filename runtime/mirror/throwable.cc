@@ -16,6 +16,9 @@
 
 #include "throwable.h"
 
+#include <utility>
+#include <vector>
+
 #include "android-base/stringprintf.h"
 
 #include "art_method-inl.h"
@@ -29,6 +32,7 @@
 #include "object_array.h"
 #include "stack_trace_element.h"
 #include "string.h"
+#include "thread.h"
 #include "well_known_classes.h"
 
 namespace art {
@@ -81,10 +85,13 @@ int32_t Throwable::GetStackDepth() {
     return -1;
   }
   ObjPtr<mirror::ObjectArray<Object>> const trace = stack_state->AsObjectArray<Object>();
-  const int32_t array_len = trace->GetLength();
-  DCHECK_GT(array_len, 0);
-  // See method BuildInternalStackTraceVisitor::Init for the format.
-  return array_len - 1;
+  DCHECK_GT(trace->GetLength(), 0);
+  // See method BuildInternalStackTraceVisitor::Init for the format. The frames recorded by their
+  // return PC may decode to several frames.
+  std::vector<std::pair<ArtMethod*, uint32_t>> frames;
+  Thread::DecodeInternalStackTrace(ObjPtr<PointerArray>::DownCast(MakeObjPtr(trace->Get(0))),
+                                   &frames);
+  return static_cast<int32_t>(frames.size());
 }
 
 std::string Throwable::Dump() {
@@ -105,16 +112,15 @@ std::string Throwable::Dump() {
     ObjPtr<Object> methods_and_dex_pcs = object_array->Get(0);
     DCHECK(methods_and_dex_pcs->IsIntArray() || methods_and_dex_pcs->IsLongArray());
     ObjPtr<PointerArray> method_trace = ObjPtr<PointerArray>::DownCast(methods_and_dex_pcs);
-    const int32_t array_len = method_trace->GetLength();
-    CHECK_EQ(array_len % 2, 0);
-    const auto depth = array_len / 2;
-    if (depth == 0) {
+    CHECK_EQ(method_trace->GetLength() % 2, 0);
+    std::vector<std::pair<ArtMethod*, uint32_t>> frames;
+    Thread::DecodeInternalStackTrace(method_trace, &frames);
+    if (frames.empty()) {
       result += "(Throwable with empty stack trace)\n";
     } else {
-      const PointerSize ptr_size = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
-      for (int32_t i = 0; i < depth; ++i) {
-        ArtMethod* method = method_trace->GetElementPtrSize<ArtMethod*>(i, ptr_size);
-        uintptr_t dex_pc = method_trace->GetElementPtrSize<uintptr_t>(i + depth, ptr_size);
+      for (const std::pair<ArtMethod*, uint32_t>& frame : frames) {
+        ArtMethod* method = frame.first;
+        uint32_t dex_pc = frame.second;
         int32_t line_number = method->GetLineNumFromDexPC(dex_pc);
         const char* source_file = method->GetDeclaringClassSourceFile();
         result += StringPrintf("  at %s (%s:%d)\n", method->PrettyMethod(true).c_str(),
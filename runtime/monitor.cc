@@ -16,6 +16,9 @@
 
 #include "monitor.h"
 
+#include <unistd.h>
+
+#include <algorithm>
 #include <vector>
 
 #include "android-base/stringprintf.h"
@@ -31,6 +34,7 @@
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_types.h"
 #include "dex/dex_instruction-inl.h"
+#include "identity_hash_table.h"
 #include "lock_word-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
@@ -48,6 +52,12 @@ using android::base::StringPrintf;
 
 static constexpr uint64_t kDebugThresholdFudgeFactor = kIsDebugBuild ? 10 : 1;
 static constexpr uint64_t kLongWaitMs = 100 * kDebugThresholdFudgeFactor;
+// Parks shorter than this would mostly have been avoided by spinning longer.
+static constexpr uint64_t kShortParkNs = UsToNs(100);
+// Contentions on a thin lock handled with a busy spin, before they yield the processor.
+static constexpr size_t kThinLockBusySpins = 8;
+// Pauses of each busy spin on a thin lock.
+static constexpr size_t kThinLockSpinPauses = 64;
 
 /*
  * Every Object has a monitor associated with it, but not every Object is actually locked.  Even
@@ -95,6 +105,8 @@ Monitor::Monitor(Thread* self, Thread* owner, mirror::Object* obj, int32_t hash_
       num_waiters_(0),
       owner_(owner),
       lock_count_(0),
+      spin_limit_(kInitialSpinLimit),
+      contended_since_deflation_(false),
       obj_(GcRoot<mirror::Object>(obj)),
       wait_set_(nullptr),
       hash_code_(hash_code),
@@ -118,6 +130,8 @@ Monitor::Monitor(Thread* self, Thread* owner, mirror::Object* obj, int32_t hash_
       num_waiters_(0),
       owner_(owner),
       lock_count_(0),
+      spin_limit_(kInitialSpinLimit),
+      contended_since_deflation_(false),
       obj_(GcRoot<mirror::Object>(obj)),
       wait_set_(nullptr),
       hash_code_(hash_code),
@@ -134,8 +148,14 @@ Monitor::Monitor(Thread* self, Thread* owner, mirror::Object* obj, int32_t hash_
 }
 
 int32_t Monitor::GetHashCode() {
+  IdentityHashTable* table = Runtime::Current()->GetIdentityHashTable();
+  Thread* self = Thread::Current();
   while (!HasHashCode()) {
-    if (hash_code_.CompareAndSetWeakRelaxed(0, mirror::Object::GenerateIdentityHashCode())) {
+    if (table != nullptr && table->MayHaveEntryFor(self, GetObject())) {
+      // The object may have been hashed while it was thin locked.
+      table->PublishToMonitor(self, this);
+    } else if (hash_code_.CompareAndSetWeakRelaxed(0,
+                                                   mirror::Object::GenerateIdentityHashCode())) {
       break;
     }
   }
@@ -175,7 +195,7 @@ bool Monitor::Install(Thread* self) {
   // Publish the updated lock word, which may race with other threads.
   bool success = GetObject()->CasLockWordWeakRelease(lw, fat);
   // Lock profiling.
-  if (success && owner_ != nullptr && lock_profiling_threshold_ != 0) {
+  if (success && owner_ != nullptr && ShouldRecordLockingMethod()) {
     // Do not abort on dex pc errors. This can easily happen when we want to dump a stack trace on
     // abort.
     locking_method_ = owner_->GetCurrentMethod(&locking_dex_pc_, false);
@@ -373,7 +393,7 @@ bool Monitor::TryLockLocked(Thread* self) {
     CHECK_EQ(lock_count_, 0);
     // When debugging, save the current monitor holder for future
     // acquisition failures to use in sampled logging.
-    if (lock_profiling_threshold_ != 0) {
+    if (ShouldRecordLockingMethod()) {
       locking_method_ = self->GetCurrentMethod(&locking_dex_pc_);
       // We don't expect a proxy method here.
       DCHECK(locking_method_ == nullptr || !locking_method_->IsProxyMethod());
@@ -392,6 +412,56 @@ bool Monitor::TryLock(Thread* self) {
   return TryLockLocked(self);
 }
 
+// Hint to the CPU that we are spinning on a lock.
+static inline void SpinPause() {
+#if defined(__i386__) || defined(__x86_64__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  __asm__ __volatile__("yield" ::: "memory");
+#else
+  __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+static bool IsMultiProcessor() {
+  static const bool is_multi_processor = sysconf(_SC_NPROCESSORS_CONF) > 1;
+  return is_multi_processor;
+}
+
+void Monitor::GrowSpinLimit() {
+  spin_limit_ = std::min(spin_limit_ * 2u, kMaxSpinLimit);
+}
+
+void Monitor::ShrinkSpinLimit() {
+  spin_limit_ = std::max(spin_limit_ / 2u, kMinSpinLimit);
+}
+
+bool Monitor::TrySpinLocked(Thread* self) {
+  // The owner cannot release the lock before it runs again, so spinning on an owner that is
+  // suspended, blocked or waiting in native code is only wasted time. The owner cannot exit
+  // while we hold the monitor lock, so it is safe to look at its state.
+  Thread* const owner = owner_;
+  if (!IsMultiProcessor() || owner == nullptr || owner->GetState() != kRunnable) {
+    return false;
+  }
+  const size_t spin_limit = spin_limit_;
+  monitor_lock_.Unlock(self);
+  // Read owner_ racily, without the monitor lock, so that the owner can unlock. We keep the
+  // mutator lock, so stop early if a thread suspension is pending.
+  for (size_t i = 0; i != spin_limit && owner_ == owner; ++i) {
+    if (UNLIKELY(self->ReadFlag(kSuspendRequest) || self->ReadFlag(kCheckpointRequest))) {
+      break;
+    }
+    SpinPause();
+  }
+  monitor_lock_.Lock(self);
+  if (!TryLockLocked(self)) {
+    return false;
+  }
+  GrowSpinLimit();
+  return true;
+}
+
 // Asserts that a mutex isn't held when the class comes into and out of scope.
 class ScopedAssertNotHeld {
  public:
@@ -413,12 +483,38 @@ template <LockReason reason>
 void Monitor::Lock(Thread* self) {
   ScopedAssertNotHeld sanh(self, monitor_lock_);
   bool called_monitors_callback = false;
+  uint64_t park_start_ns = 0u;
+  // The contention, for the contention profile.
+  uint64_t contention_start_ns = 0u;
+  ArtMethod* contention_owner_method = nullptr;
+  uint32_t contention_owner_dex_pc = 0u;
+  size_t contention_max_waiters = 0u;
   monitor_lock_.Lock(self);
   while (true) {
     if (TryLockLocked(self)) {
+      if (park_start_ns != 0u) {
+        // Spin longer next time if a short spin past the limit would have avoided the park.
+        if (NanoTime() - park_start_ns < kShortParkNs) {
+          GrowSpinLimit();
+        } else {
+          ShrinkSpinLimit();
+        }
+      }
       break;
     }
     // Contended.
+    contended_since_deflation_ = true;
+    if (MonitorContentionProfile::IsEnabled()) {
+      if (contention_start_ns == 0u) {
+        contention_start_ns = NanoTime();
+        contention_owner_method = locking_method_;
+        contention_owner_dex_pc = locking_dex_pc_;
+      }
+      contention_max_waiters = std::max(contention_max_waiters, num_waiters_ + 1u);
+    }
+    if (TrySpinLocked(self)) {
+      break;
+    }
     const bool log_contention = (lock_profiling_threshold_ != 0);
     uint64_t wait_start_ms = log_contention ? MilliTime() : 0;
     ArtMethod* owners_method = locking_method_;
@@ -470,6 +566,7 @@ void Monitor::Lock(Thread* self) {
         MutexLock mu2(self, monitor_lock_);
         if (owner_ != nullptr) {  // Did the owner_ give the lock up?
           original_owner_thread_id = owner_->GetThreadId();
+          park_start_ns = NanoTime();
           monitor_contenders_.Wait(self);  // Still contended so wait.
         }
       }
@@ -587,6 +684,13 @@ void Monitor::Lock(Thread* self) {
     --num_waiters_;
   }
   monitor_lock_.Unlock(self);
+  if (contention_start_ns != 0u) {
+    Runtime::Current()->GetMonitorContentionProfile()->RecordContention(
+        contention_owner_method,
+        contention_owner_dex_pc,
+        NanoTime() - contention_start_ns,
+        contention_max_waiters);
+  }
   // We need to pair this with a single contended locking call. NB we match the RI behavior and call
   // this even if MonitorEnter failed.
   if (called_monitors_callback) {
@@ -904,7 +1008,7 @@ void Monitor::NotifyAll(Thread* self) {
   }
 }
 
-bool Monitor::Deflate(Thread* self, mirror::Object* obj) {
+bool Monitor::Deflate(Thread* self, mirror::Object* obj, bool keep_contended) {
   DCHECK(obj != nullptr);
   // Don't need volatile since we only deflate with mutators suspended.
   LockWord lw(obj->GetLockWord(false));
@@ -917,6 +1021,11 @@ bool Monitor::Deflate(Thread* self, mirror::Object* obj) {
     if (monitor->num_waiters_ > 0) {
       return false;
     }
+    if (keep_contended && monitor->contended_since_deflation_) {
+      // Give the monitor until the next deflation to stop being contended.
+      monitor->contended_since_deflation_ = false;
+      return false;
+    }
     Thread* owner = monitor->owner_;
     if (owner != nullptr) {
       // Can't deflate if we are locked and have a hash code.
@@ -1080,15 +1189,22 @@ mirror::Object* Monitor::MonitorEnter(Thread* self, mirror::Object* obj, bool tr
           // Contention.
           contention_count++;
           Runtime* runtime = Runtime::Current();
-          if (contention_count <= runtime->GetMaxSpinsBeforeThinLockInflation()) {
+          if (contention_count <= kThinLockBusySpins && IsMultiProcessor()) {
+            // Spin first, without sched_yield. Sched_yield either does nothing (at significant
+            // expense), or guarantees that we wait at least microseconds. If the owner is
+            // running, the median lock hold time is hundreds of nanoseconds or less.
+            for (size_t i = 0; i != kThinLockSpinPauses; ++i) {
+              if (!LockWord::Equal<false>(h_obj->GetLockWord(false), lock_word)) {
+                break;
+              }
+              SpinPause();
+            }
+          } else if (contention_count <=
+                         kThinLockBusySpins + runtime->GetMaxSpinsBeforeThinLockInflation()) {
             // TODO: Consider switching the thread state to kWaitingForLockInflation when we are
             // yielding.  Use sched_yield instead of NanoSleep since NanoSleep can wait much longer
             // than the parameter you pass in. This can cause thread suspension to take excessively
             // long and make long pauses. See b/16307460.
-            // TODO: We should literally spin first, without sched_yield. Sched_yield either does
-            // nothing (at significant expense), or guarantees that we wait at least microseconds.
-            // If the owner is running, I would expect the median lock hold time to be hundreds
-            // of nanoseconds or less.
             sched_yield();
           } else {
             contention_count = 0;
@@ -1571,7 +1687,7 @@ class MonitorDeflateVisitor : public IsMarkedVisitor {
 
   virtual mirror::Object* IsMarked(mirror::Object* object) OVERRIDE
       REQUIRES_SHARED(Locks::mutator_lock_) {
-    if (Monitor::Deflate(self_, object)) {
+    if (Monitor::Deflate(self_, object, /* keep_contended */ true)) {
       DCHECK_NE(object->GetLockWord(true).GetState(), LockWord::kFatLocked);
       ++deflate_count_;
       // If we deflated, return null so that the monitor gets removed from the array.
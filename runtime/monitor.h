@@ -30,6 +30,7 @@
 #include "base/mutex.h"
 #include "gc_root.h"
 #include "lock_word.h"
+#include "monitor_contention_profile.h"
 #include "read_barrier_option.h"
 #include "runtime_callbacks.h"
 #include "thread_state.h"
@@ -59,6 +60,12 @@ class Monitor {
   // a lock word. See Runtime::max_spins_before_thin_lock_inflation_.
   constexpr static size_t kDefaultMaxSpinsBeforeThinLockInflation = 50;
 
+  // Bounds of the spins of a contender on an inflated lock before it parks, in pauses. The
+  // limit of each monitor adapts to how often spinning acquired it. See Monitor::TrySpinLocked.
+  constexpr static size_t kMinSpinLimit = 16;
+  constexpr static size_t kInitialSpinLimit = 128;
+  constexpr static size_t kMaxSpinLimit = 4096;
+
   ~Monitor();
 
   static void Init(uint32_t lock_profiling_threshold, uint32_t stack_dump_lock_profiling_threshold);
@@ -125,7 +132,7 @@ class Monitor {
     return owner_;
   }
 
-  int32_t GetHashCode();
+  int32_t GetHashCode() REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool IsLocked() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!monitor_lock_);
 
@@ -144,7 +151,9 @@ class Monitor {
   // Not exclusive because ImageWriter calls this during a Heap::VisitObjects() that
   // does not allow a thread suspension in the middle. TODO: maybe make this exclusive.
   // NO_THREAD_SAFETY_ANALYSIS for monitor->monitor_lock_.
-  static bool Deflate(Thread* self, mirror::Object* obj)
+  // If `keep_contended`, monitors contended since the last deflation are kept inflated, as
+  // they would likely be inflated again soon.
+  static bool Deflate(Thread* self, mirror::Object* obj, bool keep_contended = false)
       REQUIRES_SHARED(Locks::mutator_lock_) NO_THREAD_SAFETY_ANALYSIS;
 
 #ifndef __LP64__
@@ -213,6 +222,23 @@ class Monitor {
       REQUIRES(monitor_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Whether the owners record where they acquired the lock, for the lock profiling or the
+  // contention profile.
+  static bool ShouldRecordLockingMethod() {
+    return lock_profiling_threshold_ != 0 || MonitorContentionProfile::IsEnabled();
+  }
+
+  // Spin, without the monitor lock, while the lock is held by a running owner, then try to lock.
+  // Returns with the monitor lock held, and whether the lock was acquired.
+  // NO_THREAD_SAFETY_ANALYSIS for the racy reads of owner_ while spinning.
+  bool TrySpinLocked(Thread* self)
+      REQUIRES(monitor_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_) NO_THREAD_SAFETY_ANALYSIS;
+
+  // Adapt the spin limit to the outcome of the last contended acquisition.
+  void GrowSpinLimit() REQUIRES(monitor_lock_);
+  void ShrinkSpinLimit() REQUIRES(monitor_lock_);
+
   template<LockReason reason = LockReason::kForLock>
   void Lock(Thread* self)
       REQUIRES(!monitor_lock_)
@@ -298,6 +324,12 @@ class Monitor {
   // Owner's recursive lock depth.
   int lock_count_ GUARDED_BY(monitor_lock_);
 
+  // How long a contender spins before it parks, see TrySpinLocked.
+  size_t spin_limit_ GUARDED_BY(monitor_lock_);
+
+  // Whether the lock was contended since the last deflation of the monitors.
+  bool contended_since_deflation_ GUARDED_BY(monitor_lock_);
+
   // What object are we part of. This is a weak root. Do not access
   // this directly, use GetObject() to read it so it will be guarded
   // by a read barrier.
@@ -323,6 +355,7 @@ class Monitor {
   Monitor* next_free_ GUARDED_BY(Locks::allocated_monitor_ids_lock_);
 #endif
 
+  friend class IdentityHashTable;
   friend class MonitorInfo;
   friend class MonitorList;
   friend class MonitorPool;
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "monitor_contention_profile.h"
+
+#include <algorithm>
+
+#include "art_method-inl.h"
+#include "base/systrace.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+std::atomic<bool> MonitorContentionProfile::enabled_(false);
+
+MonitorContentionProfile::MonitorContentionProfile()
+    : lock_("monitor contention profile lock", kDefaultMutexLevel),
+      total_wait_ns_(0u) {}
+
+void MonitorContentionProfile::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void MonitorContentionProfile::RecordContention(ArtMethod* owner_method,
+                                                uint32_t owner_dex_pc,
+                                                uint64_t wait_ns,
+                                                size_t waiters) {
+  Thread* self = Thread::Current();
+  uint64_t site_wait_ns;
+  uint64_t total_wait_ns;
+  {
+    MutexLock mu(self, lock_);
+    auto key = std::make_pair(owner_method, owner_dex_pc);
+    auto it = sites_.find(key);
+    if (it == sites_.end()) {
+      if (sites_.size() >= kMaxSites) {
+        owner_method = nullptr;
+        owner_dex_pc = 0u;
+        key = std::make_pair(owner_method, owner_dex_pc);
+      }
+      it = sites_.FindOrAdd(key, Site { owner_method, owner_dex_pc, 0u, 0u, 0u, 0u });
+    }
+    Site& site = it->second;
+    ++site.contentions;
+    site.total_wait_ns += wait_ns;
+    site.max_wait_ns = std::max(site.max_wait_ns, wait_ns);
+    site.max_waiters = std::max(site.max_waiters, waiters);
+    site_wait_ns = site.total_wait_ns;
+    total_wait_ns_ += wait_ns;
+    total_wait_ns = total_wait_ns_;
+  }
+  if (ATRACE_ENABLED()) {
+    ATRACE_INT64("Monitor contention wait (ns)", total_wait_ns);
+    std::string name = "Monitor contention wait (ns) at " +
+        (owner_method != nullptr ? owner_method->PrettyMethod() : std::string("<unknown>"));
+    ATRACE_INT64(name.c_str(), site_wait_ns);
+  }
+}
+
+std::vector<MonitorContentionProfile::Site> MonitorContentionProfile::GetSites(bool reset) {
+  std::vector<Site> sites;
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    sites.reserve(sites_.size());
+    for (const auto& entry : sites_) {
+      sites.push_back(entry.second);
+    }
+    if (reset) {
+      sites_.clear();
+      total_wait_ns_ = 0u;
+    }
+  }
+  std::sort(sites.begin(), sites.end(), [](const Site& lhs, const Site& rhs) {
+    return lhs.total_wait_ns > rhs.total_wait_ns;
+  });
+  return sites;
+}
+
+}  // namespace art
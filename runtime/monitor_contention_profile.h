@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_MONITOR_CONTENTION_PROFILE_H_
+#define ART_RUNTIME_MONITOR_CONTENTION_PROFILE_H_
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "base/safe_map.h"
+
+namespace art {
+
+class ArtMethod;
+
+// Contention statistics of the inflated monitors, aggregated by the place where the owner
+// acquired the lock, that is the critical section the contenders waited for. Enabled with
+// -XX:MonitorContentionProfiling:true or through the JVMTI extension
+// com.android.art.monitor.set_contention_profiling. When ATrace is enabled, the wait times are
+// also exported as counters.
+class MonitorContentionProfile {
+ public:
+  struct Site {
+    // Where the owner acquired the lock. The method is null if the owner had no Java frame.
+    ArtMethod* owner_method;
+    uint32_t owner_dex_pc;
+    // Number of contended acquisitions, and the time the contenders waited for them.
+    uint64_t contentions;
+    uint64_t total_wait_ns;
+    uint64_t max_wait_ns;
+    // Highest number of threads waiting for the lock at once.
+    size_t max_waiters;
+  };
+
+  MonitorContentionProfile();
+
+  static bool IsEnabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  // The locking methods are only recorded while the profile is enabled, so that the sites of
+  // the locks acquired before are unknown.
+  void SetEnabled(bool enabled);
+
+  // Record a contended acquisition of a lock acquired by its owner at `owner_method` and
+  // `owner_dex_pc`, after a wait of `wait_ns` with `waiters` threads waiting.
+  void RecordContention(ArtMethod* owner_method,
+                        uint32_t owner_dex_pc,
+                        uint64_t wait_ns,
+                        size_t waiters)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Return the sites, in decreasing order of total wait time. Clear them if `reset`.
+  std::vector<Site> GetSites(bool reset) REQUIRES(!lock_);
+
+ private:
+  // Contentions of new sites past this many are aggregated in the site without a method.
+  static constexpr size_t kMaxSites = 4096;
+
+  static std::atomic<bool> enabled_;
+
+  Mutex lock_;
+  SafeMap<std::pair<ArtMethod*, uint32_t>, Site> sites_ GUARDED_BY(lock_);
+  // Total wait time of all the sites, the counter exported to ATrace.
+  uint64_t total_wait_ns_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(MonitorContentionProfile);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_MONITOR_CONTENTION_PROFILE_H_
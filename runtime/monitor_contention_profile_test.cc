@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "monitor_contention_profile.h"
+
+#include "common_runtime_test.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+
+class MonitorContentionProfileTest : public CommonRuntimeTest {};
+
+TEST_F(MonitorContentionProfileTest, AggregatesBySite) {
+  MonitorContentionProfile profile;
+  ArtMethod* method_a = reinterpret_cast<ArtMethod*>(0x1000);
+  ArtMethod* method_b = reinterpret_cast<ArtMethod*>(0x2000);
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    profile.RecordContention(method_a, 4u, /* wait_ns */ 100u, /* waiters */ 1u);
+    profile.RecordContention(method_a, 4u, /* wait_ns */ 300u, /* waiters */ 3u);
+    profile.RecordContention(method_a, 8u, /* wait_ns */ 50u, /* waiters */ 1u);
+    profile.RecordContention(method_b, 4u, /* wait_ns */ 1000u, /* waiters */ 2u);
+  }
+
+  std::vector<MonitorContentionProfile::Site> sites = profile.GetSites(/* reset */ true);
+  ASSERT_EQ(3u, sites.size());
+  // Sorted by decreasing total wait time.
+  EXPECT_EQ(method_b, sites[0].owner_method);
+  EXPECT_EQ(1u, sites[0].contentions);
+  EXPECT_EQ(method_a, sites[1].owner_method);
+  EXPECT_EQ(4u, sites[1].owner_dex_pc);
+  EXPECT_EQ(2u, sites[1].contentions);
+  EXPECT_EQ(400u, sites[1].total_wait_ns);
+  EXPECT_EQ(300u, sites[1].max_wait_ns);
+  EXPECT_EQ(3u, sites[1].max_waiters);
+  EXPECT_EQ(8u, sites[2].owner_dex_pc);
+
+  EXPECT_TRUE(profile.GetSites(/* reset */ false).empty());
+}
+
+}  // namespace art
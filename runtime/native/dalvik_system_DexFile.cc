@@ -436,6 +436,13 @@ static jobjectArray DexFile_getClassNameList(JNIEnv* env, jclass, jobject cookie
   // retrieve all in the end.
   std::set<const char*, CharPointerComparator> descriptors;
   for (auto& dex_file : dex_files) {
+    std::string error_msg;
+    if (!dex_file->VerifyIfDeferred(&error_msg)) {
+      if (!error_msg.empty()) {
+        LOG(WARNING) << error_msg;
+      }
+      continue;
+    }
     for (size_t i = 0; i < dex_file->NumClassDefs(); ++i) {
       const DexFile::ClassDef& class_def = dex_file->GetClassDef(i);
       const char* descriptor = dex_file->GetClassDescriptor(class_def);
@@ -20,6 +20,7 @@
 
 #include "jni_internal.h"
 #include "native_util.h"
+#include "runtime.h"
 #include "scoped_fast_native_object_access-inl.h"
 #include "thread.h"
 
@@ -27,6 +28,11 @@ namespace art {
 
 static jobject Throwable_nativeFillInStackTrace(JNIEnv* env, jclass) {
   ScopedFastNativeObjectAccess soa(env);
+  Runtime* runtime = Runtime::Current();
+  if (runtime->UseLazyStackTraces()) {
+    // Many exceptions are caught and dropped, only decode the frames on getStackTrace().
+    return soa.Self()->CreateRawInternalStackTrace(soa, runtime->GetMaxStackTraceDepth());
+  }
   return soa.Self()->CreateInternalStackTrace<false>(soa);
 }
 
@@ -32,6 +32,7 @@
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "native_util.h"
+#include "runtime.h"
 #include "scoped_fast_native_object_access-inl.h"
 
 namespace art {
@@ -308,6 +309,7 @@ static void Unsafe_copyMemory(JNIEnv *env, jobject unsafe ATTRIBUTE_UNUSED, jlon
   if (size < 0 || size != (jlong)(size_t) size) {
     ScopedFastNativeObjectAccess soa(env);
     ThrowIllegalAccessException("wrong number of bytes");
+    return;
   }
   size_t sz = (size_t)size;
   memcpy(reinterpret_cast<void *>(dst), reinterpret_cast<void *>(src), sz);
@@ -322,6 +324,11 @@ static void copyToArray(jlong srcAddr,
   const T* src = reinterpret_cast<T*>(srcAddr);
   size_t sz = size / sizeof(T);
   size_t of = array_offset / sizeof(T);
+  if (!Runtime::Current()->IsActiveTransaction()) {
+    // No transaction needs to record the writes, so copy the elements at once.
+    memcpy(array->GetData() + of, src, sz * sizeof(T));
+    return;
+  }
   for (size_t i = 0; i < sz; ++i) {
     array->Set(i + of, *(src + i));
   }
@@ -336,9 +343,7 @@ static void copyFromArray(jlong dstAddr,
   T* dst = reinterpret_cast<T*>(dstAddr);
   size_t sz = size / sizeof(T);
   size_t of = array_offset / sizeof(T);
-  for (size_t i = 0; i < sz; ++i) {
-    *(dst + i) = array->Get(i + of);
-  }
+  memcpy(dst, array->GetData() + of, sz * sizeof(T));
 }
 
 static void Unsafe_copyMemoryToPrimitiveArray(JNIEnv *env,
@@ -347,13 +352,14 @@ static void Unsafe_copyMemoryToPrimitiveArray(JNIEnv *env,
                                               jobject dstObj,
                                               jlong dstOffset,
                                               jlong size) {
-  ScopedObjectAccess soa(env);
+  ScopedFastNativeObjectAccess soa(env);
   if (size == 0) {
     return;
   }
   // size is nonnegative and fits into size_t
   if (size < 0 || size != (jlong)(size_t) size) {
     ThrowIllegalAccessException("wrong number of bytes");
+    return;
   }
   size_t sz = (size_t)size;
   size_t dst_offset = (size_t)dstOffset;
@@ -378,13 +384,14 @@ static void Unsafe_copyMemoryFromPrimitiveArray(JNIEnv *env,
                                                 jlong srcOffset,
                                                 jlong dstAddr,
                                                 jlong size) {
-  ScopedObjectAccess soa(env);
+  ScopedFastNativeObjectAccess soa(env);
   if (size == 0) {
     return;
   }
   // size is nonnegative and fits into size_t
   if (size < 0 || size != (jlong)(size_t) size) {
     ThrowIllegalAccessException("wrong number of bytes");
+    return;
   }
   size_t sz = (size_t)size;
   size_t src_offset = (size_t)srcOffset;
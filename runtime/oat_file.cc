@@ -1706,8 +1706,14 @@ OatFile::OatDexFile::OatDexFile(const OatFile* oat_file,
       type_bss_mapping_(type_bss_mapping_data),
       string_bss_mapping_(string_bss_mapping_data),
       oat_class_offsets_pointer_(oat_class_offsets_pointer),
-      dex_layout_sections_(dex_layout_sections) {
-  // Initialize TypeLookupTable.
+      dex_layout_sections_(dex_layout_sections) {}
+
+TypeLookupTable* OatFile::OatDexFile::GetTypeLookupTable() const {
+  std::call_once(lookup_table_once_, [this]() { InitializeTypeLookupTable(); });
+  return lookup_table_.get();
+}
+
+void OatFile::OatDexFile::InitializeTypeLookupTable() const {
   if (lookup_table_data_ != nullptr) {
     // Peek the number of classes from the DexFile.
     const DexFile::Header* dex_header = reinterpret_cast<const DexFile::Header*>(dex_file_pointer_);
@@ -1821,6 +1827,14 @@ OatFile::OatClass OatFile::OatDexFile::GetOatClass(uint16_t class_def_index) con
 const DexFile::ClassDef* OatFile::OatDexFile::FindClassDef(const DexFile& dex_file,
                                                            const char* descriptor,
                                                            size_t hash) {
+  std::string error_msg;
+  if (UNLIKELY(!dex_file.VerifyIfDeferred(&error_msg))) {
+    // A dex file that fails its deferred verification defines no class.
+    if (!error_msg.empty()) {
+      LOG(WARNING) << error_msg;
+    }
+    return nullptr;
+  }
   const OatFile::OatDexFile* oat_dex_file = dex_file.GetOatDexFile();
   DCHECK_EQ(ComputeModifiedUtf8Hash(descriptor), hash);
   bool used_lookup_table = false;
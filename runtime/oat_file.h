@@ -18,6 +18,7 @@
 #define ART_RUNTIME_OAT_FILE_H_
 
 #include <list>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -517,9 +518,10 @@ class OatDexFile FINAL {
   // Madvise the dex file based on the state we are moving to.
   static void MadviseDexFile(const DexFile& dex_file, MadviseState state);
 
-  TypeLookupTable* GetTypeLookupTable() const {
-    return lookup_table_.get();
-  }
+  // Returns the type lookup table, creating it on the first call. Creating it reads the header of
+  // the dex file, which is deferred so that opening an oat file does not touch the pages of all its
+  // dex files.
+  TypeLookupTable* GetTypeLookupTable() const;
 
   ~OatDexFile();
 
@@ -546,6 +548,8 @@ class OatDexFile FINAL {
 
   static void AssertAotCompiler();
 
+  void InitializeTypeLookupTable() const;
+
   const OatFile* const oat_file_ = nullptr;
   const std::string dex_file_location_;
   const std::string canonical_dex_file_location_;
@@ -556,6 +560,7 @@ class OatDexFile FINAL {
   const IndexBssMapping* const type_bss_mapping_ = nullptr;
   const IndexBssMapping* const string_bss_mapping_ = nullptr;
   const uint32_t* const oat_class_offsets_pointer_ = 0u;
+  mutable std::once_flag lookup_table_once_;
   mutable std::unique_ptr<TypeLookupTable> lookup_table_;
   const DexLayoutSections* const dex_layout_sections_ = nullptr;
 
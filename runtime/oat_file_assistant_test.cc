@@ -1274,6 +1274,44 @@ TEST_F(OatFileAssistantNoDex2OatTest, LoadMultiDexOdexNoOat) {
   EXPECT_EQ(2u, dex_files.size());
 }
 
+// Case: We have a DEX file and an up-to-date VDEX file, no ODEX or OAT file,
+// and dex2oat is disabled.
+// Expect: The original dex file is opened, and checksummed and verified on
+// its first class lookup rather than at open.
+TEST_F(OatFileAssistantNoDex2OatTest, LoadDexVdexNoOdex) {
+  std::string dex_location = GetScratchDir() + "/LoadDexVdexNoOdex.jar";
+  std::string odex_location = GetOdexDir() + "/LoadDexVdexNoOdex.odex";
+
+  // Generating and deleting the odex file leaves an up-to-date vdex file.
+  Copy(GetDexSrc1(), dex_location);
+  GenerateOdexForTest(dex_location, odex_location, CompilerFilter::kSpeed);
+  ASSERT_EQ(0, unlink(odex_location.c_str()));
+
+  // Start the runtime to initialize the system's class loader.
+  Thread::Current()->TransitionFromSuspendedToRunnable();
+  runtime_->Start();
+
+  std::vector<std::unique_ptr<const DexFile>> dex_files;
+  std::vector<std::string> error_msgs;
+  const OatFile* oat_file = nullptr;
+  dex_files = Runtime::Current()->GetOatFileManager().OpenDexFilesFromOat(
+      dex_location.c_str(),
+      Runtime::Current()->GetSystemClassLoader(),
+      /*dex_elements*/nullptr,
+      &oat_file,
+      &error_msgs);
+  ASSERT_EQ(1u, dex_files.size()) << android::base::Join(error_msgs, '\n');
+  EXPECT_TRUE(oat_file == nullptr);
+  EXPECT_TRUE(dex_files[0]->GetOatDexFile() == nullptr);
+  EXPECT_EQ(dex_location, dex_files[0]->GetLocation());
+
+  const char* descriptor = "LMain;";
+  EXPECT_TRUE(OatDexFile::FindClassDef(
+      *dex_files[0], descriptor, ComputeModifiedUtf8Hash(descriptor)) != nullptr);
+  std::string error_msg;
+  EXPECT_TRUE(dex_files[0]->VerifyIfDeferred(&error_msg)) << error_msg;
+}
+
 TEST_F(OatFileAssistantTest, RuntimeCompilerFilterOptionUsed) {
   std::string dex_location = GetScratchDir() + "/RuntimeCompilerFilterOptionUsed.jar";
   Copy(GetDexSrc1(), dex_location);
@@ -35,6 +35,7 @@
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_loader.h"
 #include "dex/dex_file_tracking_registrar.h"
+#include "fault_handler.h"
 #include "gc/scoped_gc_critical_section.h"
 #include "gc/space/image_space.h"
 #include "handle_scope-inl.h"
@@ -45,10 +46,15 @@
 #include "oat_file_assistant.h"
 #include "obj_ptr-inl.h"
 #include "scoped_thread_state_change-inl.h"
+#include "startup_timings.h"
 #include "thread-current-inl.h"
 #include "thread_list.h"
 #include "well_known_classes.h"
 
+#ifdef VTUNE_ART
+#include "vtune_support.h"
+#endif
+
 namespace art {
 
 using android::base::StringPrintf;
@@ -57,24 +63,35 @@ using android::base::StringPrintf;
 static constexpr bool kEnableAppImage = true;
 
 const OatFile* OatFileManager::RegisterOatFile(std::unique_ptr<const OatFile> oat_file) {
-  WriterMutexLock mu(Thread::Current(), *Locks::oat_file_manager_lock_);
-  CHECK(!only_use_system_oat_files_ ||
-        LocationIsOnSystem(oat_file->GetLocation().c_str()) ||
-        !oat_file->IsExecutable())
-      << "Registering a non /system oat file: " << oat_file->GetLocation();
-  DCHECK(oat_file != nullptr);
-  if (kIsDebugBuild) {
-    CHECK(oat_files_.find(oat_file) == oat_files_.end());
-    for (const std::unique_ptr<const OatFile>& existing : oat_files_) {
-      CHECK_NE(oat_file.get(), existing.get()) << oat_file->GetLocation();
-      // Check that we don't have an oat file with the same address. Copies of the same oat file
-      // should be loaded at different addresses.
-      CHECK_NE(oat_file->Begin(), existing->Begin()) << "Oat file already mapped at that location";
+  const OatFile* ret = nullptr;
+  {
+    WriterMutexLock mu(Thread::Current(), *Locks::oat_file_manager_lock_);
+    CHECK(!only_use_system_oat_files_ ||
+          LocationIsOnSystem(oat_file->GetLocation().c_str()) ||
+          !oat_file->IsExecutable())
+        << "Registering a non /system oat file: " << oat_file->GetLocation();
+    DCHECK(oat_file != nullptr);
+    if (kIsDebugBuild) {
+      CHECK(oat_files_.find(oat_file) == oat_files_.end());
+      for (const std::unique_ptr<const OatFile>& existing : oat_files_) {
+        CHECK_NE(oat_file.get(), existing.get()) << oat_file->GetLocation();
+        // Check that we don't have an oat file with the same address. Copies of the same oat file
+        // should be loaded at different addresses.
+        CHECK_NE(oat_file->Begin(), existing->Begin())
+            << "Oat file already mapped at that location";
+      }
     }
+    have_non_pic_oat_file_ = have_non_pic_oat_file_ || !oat_file->IsPic();
+    if (oat_file->IsExecutable()) {
+      fault_manager.AddGeneratedCodeRange(oat_file->Begin(), oat_file->Size());
+    }
+    ret = oat_file.get();
+    oat_files_.insert(std::move(oat_file));
   }
-  have_non_pic_oat_file_ = have_non_pic_oat_file_ || !oat_file->IsPic();
-  const OatFile* ret = oat_file.get();
-  oat_files_.insert(std::move(oat_file));
+#ifdef VTUNE_ART
+  // Outside of the lock, this opens the dex files of the oat file and reads all its methods.
+  SendOatFileToVTune(*ret);
+#endif
   return ret;
 }
 
@@ -84,6 +101,9 @@ void OatFileManager::UnRegisterAndDeleteOatFile(const OatFile* oat_file) {
   std::unique_ptr<const OatFile> compare(oat_file);
   auto it = oat_files_.find(compare);
   CHECK(it != oat_files_.end());
+  if (oat_file->IsExecutable()) {
+    fault_manager.RemoveGeneratedCodeRange(oat_file->Begin(), oat_file->Size());
+  }
   oat_files_.erase(it);
   compare.release();
 }
@@ -399,6 +419,7 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
     std::vector<std::string>* error_msgs) {
   ScopedTrace trace(__FUNCTION__);
   CHECK(dex_location != nullptr);
+  ScopedStartupTiming timing(StartupTimings::kOatFileLoading, dex_location);
   CHECK(error_msgs != nullptr);
 
   // Verify we aren't holding the mutator lock, which could starve GC if we
@@ -610,17 +631,22 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
   if (dex_files.empty()) {
     if (oat_file_assistant.HasOriginalDexFiles()) {
       if (Runtime::Current()->IsDexFileFallbackEnabled()) {
-        static constexpr bool kVerifyChecksum = true;
+        // Verify the dex files, checksum included, on their first lookup rather than here, so
+        // that opening them does not read all their pages.
         const ArtDexFileLoader dex_file_loader;
         if (!dex_file_loader.Open(dex_location,
                                   dex_location,
-                                  Runtime::Current()->IsVerificationEnabled(),
-                                  kVerifyChecksum,
+                                  /* verify */ false,
+                                  /* verify_checksum */ false,
                                   /*out*/ &error_msg,
                                   &dex_files)) {
           LOG(WARNING) << error_msg;
           error_msgs->push_back("Failed to open dex files from " + std::string(dex_location)
                                 + " because: " + error_msg);
+        } else if (Runtime::Current()->IsVerificationEnabled()) {
+          for (const std::unique_ptr<const DexFile>& dex_file : dex_files) {
+            dex_file->DeferVerification();
+          }
         }
       } else {
         error_msgs->push_back("Fallback mode disabled, skipping dex files.");
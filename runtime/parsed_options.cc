@@ -159,6 +159,12 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:LongGCLogThreshold=_")  // in ms
           .WithType<MillisecondsToNanoseconds>()  // store as ns
           .IntoKey(M::LongGCLogThreshold)
+      .Define("-XX:GcPauseTarget=_")  // in ms
+          .WithType<MillisecondsToNanoseconds>()  // store as ns
+          .IntoKey(M::GcPauseTarget)
+      .Define("-XX:GcCpuBudget=_")
+          .WithType<double>().WithRange(0.01, 0.9)
+          .IntoKey(M::GcCpuBudget)
       .Define("-XX:DumpGCPerformanceOnShutdown")
           .IntoKey(M::DumpGCPerformanceOnShutdown)
       .Define("-XX:DumpJITInfoOnShutdown")
@@ -177,6 +183,29 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(M::DumpNativeStackOnSigQuit)
+      .Define("-XX:EntrypointCounters:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::EntrypointCounters)
+      .Define("-XX:HprofForkDump:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::HprofForkDump)
+      .Define("-XX:LazyStackTraces:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::LazyStackTraces)
+      .Define("-XX:MaxStackTraceDepth=_")
+          .WithType<unsigned int>()
+          .IntoKey(M::MaxStackTraceDepth)
+      .Define("-XX:MonitorContentionProfiling:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::MonitorContentionProfiling)
+      .Define("-XX:PreloadStartupClasses:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::PreloadStartupClasses)
       .Define("-XX:MadviseRandomAccess:_")
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
@@ -206,6 +235,14 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjittransitionweight:_")
           .WithType<unsigned int>()
           .IntoKey(M::JITInvokeTransitionWeight)
+      .Define("-Xjitthreads:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITThreads)
+      .Define("-Xjitbaselinethreshold:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITBaselineThreshold)
+      .Define("-Xjitwarmstart")
+          .IntoKey(M::JITWarmStart)
       .Define("-Xjitsaveprofilinginfo")
           .WithType<ProfileSaverOptions>()
           .AppendValues()
@@ -217,6 +254,15 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:HspaceCompactForOOMMinIntervalMs=_")  // in ms
           .WithType<MillisecondsToNanoseconds>()  // store as ns
           .IntoKey(M::HSpaceCompactForOOMMinIntervalsMs)
+      .Define("-XX:HspaceCompactForFragmentationThreshold=_")
+          .WithType<double>().WithRange(0.0, 1.0)
+          .IntoKey(M::HSpaceCompactForFragmentationThreshold)
+      .Define("-XX:HspaceCompactForFragmentationMinIntervalMs=_")  // in ms
+          .WithType<MillisecondsToNanoseconds>()  // store as ns
+          .IntoKey(M::HSpaceCompactForFragmentationMinIntervalsMs)
+      .Define("-XX:CardRefinementIntervalMs=_")  // in ms
+          .WithType<MillisecondsToNanoseconds>()  // store as ns
+          .IntoKey(M::CardRefinementIntervalMs)
       .Define("-D_")
           .WithType<std::vector<std::string>>().AppendValues()
           .IntoKey(M::PropertiesList)
@@ -272,6 +318,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xstacktracefile:_")
           .WithType<std::string>()
           .IntoKey(M::StackTraceFile)
+      .Define("-XX:StatsRegionFile=_")
+          .WithType<std::string>()
+          .IntoKey(M::StatsRegionFile)
       .Define("-Xmethod-trace")
           .IntoKey(M::MethodTrace)
       .Define("-Xmethod-trace-file:_")
@@ -735,6 +784,9 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -XX:HeapTargetUtilization=doublevalue\n");
   UsageMessage(stream, "  -XX:ForegroundHeapGrowthMultiplier=doublevalue\n");
   UsageMessage(stream, "  -XX:LowMemoryMode\n");
+  UsageMessage(stream, "  -XX:HspaceCompactForFragmentationThreshold=doublevalue\n");
+  UsageMessage(stream, "  -XX:HspaceCompactForFragmentationMinIntervalMs=integervalue\n");
+  UsageMessage(stream, "  -XX:CardRefinementIntervalMs=integervalue\n");
   UsageMessage(stream, "  -Xprofile:{threadcpuclock,wallclock,dualclock}\n");
   UsageMessage(stream, "  -Xjitthreshold:integervalue\n");
   UsageMessage(stream, "\n");
@@ -744,6 +796,9 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -Xgc:[no]postsweepingverify_rosalloc\n");
   UsageMessage(stream, "  -Xgc:[no]postverify_rosalloc\n");
   UsageMessage(stream, "  -Xgc:[no]presweepingverify\n");
+  UsageMessage(stream, "  -Xgc:[no]numa\n");
+  UsageMessage(stream, "  -Xgc:[no]hugepages\n");
+  UsageMessage(stream, "  -Xgc:[no]generational_cc\n");
   UsageMessage(stream, "  -Ximage:filename\n");
   UsageMessage(stream, "  -Xbootclasspath-locations:bootclasspath\n"
                        "     (override the dex locations of the -Xbootclasspath files)\n");
@@ -754,6 +809,8 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -XX:MaxSpinsBeforeThinLockInflation=integervalue\n");
   UsageMessage(stream, "  -XX:LongPauseLogThreshold=integervalue\n");
   UsageMessage(stream, "  -XX:LongGCLogThreshold=integervalue\n");
+  UsageMessage(stream, "  -XX:GcPauseTarget=integervalue\n");
+  UsageMessage(stream, "  -XX:GcCpuBudget=doublevalue\n");
   UsageMessage(stream, "  -XX:ThreadSuspendTimeout=integervalue\n");
   UsageMessage(stream, "  -XX:DumpGCPerformanceOnShutdown\n");
   UsageMessage(stream, "  -XX:DumpJITInfoOnShutdown\n");
@@ -763,6 +820,13 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -XX:LargeObjectSpace={disabled,map,freelist}\n");
   UsageMessage(stream, "  -XX:LargeObjectThreshold=N\n");
   UsageMessage(stream, "  -XX:DumpNativeStackOnSigQuit=booleanvalue\n");
+  UsageMessage(stream, "  -XX:EntrypointCounters:booleanvalue\n");
+  UsageMessage(stream, "  -XX:HprofForkDump:booleanvalue\n");
+  UsageMessage(stream, "  -XX:LazyStackTraces:booleanvalue\n");
+  UsageMessage(stream, "  -XX:MaxStackTraceDepth=integervalue\n");
+  UsageMessage(stream, "  -XX:MonitorContentionProfiling:booleanvalue\n");
+  UsageMessage(stream, "  -XX:PreloadStartupClasses:booleanvalue\n");
+  UsageMessage(stream, "  -XX:StatsRegionFile=<filename>\n");
   UsageMessage(stream, "  -XX:MadviseRandomAccess:booleanvalue\n");
   UsageMessage(stream, "  -XX:SlowDebug={false,true}\n");
   UsageMessage(stream, "  -Xmethod-trace\n");
@@ -786,6 +850,9 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -Xjitwarmupthreshold:integervalue\n");
   UsageMessage(stream, "  -Xjitosrthreshold:integervalue\n");
   UsageMessage(stream, "  -Xjitprithreadweight:integervalue\n");
+  UsageMessage(stream, "  -Xjitthreads:integervalue (0 to follow the load)\n");
+  UsageMessage(stream, "  -Xjitbaselinethreshold:integervalue\n");
+  UsageMessage(stream, "  -Xjitwarmstart (Compile the hot methods of the profile on first use)\n");
   UsageMessage(stream, "  -X[no]relocate\n");
   UsageMessage(stream, "  -X[no]dex2oat (Whether to invoke dex2oat on the application)\n");
   UsageMessage(stream, "  -X[no]image-dex2oat (Whether to create and use a boot image)\n");
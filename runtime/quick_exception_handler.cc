@@ -20,6 +20,7 @@
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "base/logging.h"  // For VLOG_IS_ON.
+#include "catch_block_cache.h"
 #include "dex/dex_file_types.h"
 #include "dex/dex_instruction.h"
 #include "entrypoints/entrypoint_utils.h"
@@ -109,7 +110,12 @@ class CatchBlockStackVisitor FINAL : public StackVisitor {
       bool clear_exception = false;
       StackHandleScope<1> hs(GetThread());
       Handle<mirror::Class> to_find(hs.NewHandle((*exception_)->GetClass()));
-      uint32_t found_dex_pc = method->FindCatchBlock(to_find, dex_pc, &clear_exception);
+      uint32_t found_dex_pc = dex::kDexNoIndex;
+      if (!CatchBlockCache::Lookup(
+              method, dex_pc, to_find.Get(), &found_dex_pc, &clear_exception)) {
+        found_dex_pc = method->FindCatchBlock(to_find, dex_pc, &clear_exception);
+        CatchBlockCache::Insert(method, dex_pc, to_find.Get(), found_dex_pc, clear_exception);
+      }
       exception_handler_->SetClearException(clear_exception);
       if (found_dex_pc != dex::kDexNoIndex) {
         exception_handler_->SetHandlerMethod(method);
@@ -246,9 +252,12 @@ void QuickExceptionHandler::SetCatchEnvironmentForOptimizedHandler(StackVisitor*
   DCHECK(throw_vreg_map.IsValid());
 
   // Copy values between them.
+  std::vector<DexRegisterLocation> catch_locations;
+  catch_vreg_map.GetDexRegisterLocations(number_of_vregs, code_info, encoding, &catch_locations);
+  std::vector<DexRegisterLocation> throw_locations;
+  throw_vreg_map.GetDexRegisterLocations(number_of_vregs, code_info, encoding, &throw_locations);
   for (uint16_t vreg = 0; vreg < number_of_vregs; ++vreg) {
-    DexRegisterLocation::Kind catch_location =
-        catch_vreg_map.GetLocationKind(vreg, number_of_vregs, code_info, encoding);
+    DexRegisterLocation::Kind catch_location = catch_locations[vreg].GetKind();
     if (catch_location == DexRegisterLocation::Kind::kNone) {
       continue;
     }
@@ -256,10 +265,7 @@ void QuickExceptionHandler::SetCatchEnvironmentForOptimizedHandler(StackVisitor*
 
     // Get vreg value from its current location.
     uint32_t vreg_value;
-    VRegKind vreg_kind = ToVRegKind(throw_vreg_map.GetLocationKind(vreg,
-                                                                   number_of_vregs,
-                                                                   code_info,
-                                                                   encoding));
+    VRegKind vreg_kind = ToVRegKind(throw_locations[vreg].GetKind());
     bool get_vreg_success = stack_visitor->GetVReg(stack_visitor->GetMethod(),
                                                    vreg,
                                                    vreg_kind,
@@ -270,10 +276,7 @@ void QuickExceptionHandler::SetCatchEnvironmentForOptimizedHandler(StackVisitor*
                             << "native_pc_offset=" << stack_visitor->GetNativePcOffset() << ")";
 
     // Copy value to the catch phi's stack slot.
-    int32_t slot_offset = catch_vreg_map.GetStackOffsetInBytes(vreg,
-                                                               number_of_vregs,
-                                                               code_info,
-                                                               encoding);
+    int32_t slot_offset = catch_locations[vreg].GetValue();
     ArtMethod** frame_top = stack_visitor->GetCurrentQuickFrame();
     uint8_t* slot_address = reinterpret_cast<uint8_t*>(frame_top) + slot_offset;
     uint32_t* slot_ptr = reinterpret_cast<uint32_t*>(slot_address);
@@ -446,24 +449,22 @@ class DeoptimizeStackVisitor FINAL : public StackVisitor {
       }
     }
 
+    vreg_map.GetDexRegisterLocations(number_of_vregs, code_info, encoding, &vreg_locations_);
     for (uint16_t vreg = 0; vreg < number_of_vregs; ++vreg) {
       if (updated_vregs != nullptr && updated_vregs[vreg]) {
         // Keep the value set by debugger.
         continue;
       }
 
-      DexRegisterLocation::Kind location =
-          vreg_map.GetLocationKind(vreg, number_of_vregs, code_info, encoding);
+      const DexRegisterLocation& vreg_location = vreg_locations_[vreg];
+      DexRegisterLocation::Kind location = vreg_location.GetKind();
       static constexpr uint32_t kDeadValue = 0xEBADDE09;
       uint32_t value = kDeadValue;
       bool is_reference = false;
 
       switch (location) {
         case DexRegisterLocation::Kind::kInStack: {
-          const int32_t offset = vreg_map.GetStackOffsetInBytes(vreg,
-                                                                number_of_vregs,
-                                                                code_info,
-                                                                encoding);
+          const int32_t offset = vreg_location.GetValue();
           const uint8_t* addr = reinterpret_cast<const uint8_t*>(GetCurrentQuickFrame()) + offset;
           value = *reinterpret_cast<const uint32_t*>(addr);
           uint32_t bit = (offset >> 2);
@@ -476,7 +477,7 @@ class DeoptimizeStackVisitor FINAL : public StackVisitor {
         case DexRegisterLocation::Kind::kInRegisterHigh:
         case DexRegisterLocation::Kind::kInFpuRegister:
         case DexRegisterLocation::Kind::kInFpuRegisterHigh: {
-          uint32_t reg = vreg_map.GetMachineRegister(vreg, number_of_vregs, code_info, encoding);
+          uint32_t reg = vreg_location.GetValue();
           bool result = GetRegisterIfAccessible(reg, ToVRegKind(location), &value);
           CHECK(result);
           if (location == DexRegisterLocation::Kind::kInRegister) {
@@ -487,7 +488,7 @@ class DeoptimizeStackVisitor FINAL : public StackVisitor {
           break;
         }
         case DexRegisterLocation::Kind::kConstant: {
-          value = vreg_map.GetConstant(vreg, number_of_vregs, code_info, encoding);
+          value = vreg_location.GetValue();
           if (value == 0) {
             // Make it a reference for extra safety.
             is_reference = true;
@@ -498,12 +499,7 @@ class DeoptimizeStackVisitor FINAL : public StackVisitor {
           break;
         }
         default: {
-          LOG(FATAL)
-              << "Unexpected location kind "
-              << vreg_map.GetLocationInternalKind(vreg,
-                                                  number_of_vregs,
-                                                  code_info,
-                                                  encoding);
+          LOG(FATAL) << "Unexpected location kind " << vreg_location.GetInternalKind();
           UNREACHABLE();
         }
       }
@@ -527,6 +523,9 @@ class DeoptimizeStackVisitor FINAL : public StackVisitor {
   ArtMethod* single_frame_deopt_method_;
   const OatQuickMethodHeader* single_frame_deopt_quick_method_header_;
   ArtMethod* callee_method_;
+  // The decoded locations of the dex registers of the frame being deoptimized. Kept across
+  // frames so the storage is allocated once for the whole stack.
+  std::vector<DexRegisterLocation> vreg_locations_;
 
   DISALLOW_COPY_AND_ASSIGN(DeoptimizeStackVisitor);
 };
@@ -90,6 +90,15 @@ static constexpr bool kForceReadBarrier = false;
 // and replace it with kUseReadBarrier.
 static constexpr bool kEmitCompilerReadBarrier = kForceReadBarrier || kUseReadBarrier;
 
+// Whether the concurrent copying collector runs young collections of the regions allocated since
+// the previous collection between its full collections, unless -Xgc:[no]generational_cc is
+// passed. The generational mode is only used with the Baker read barrier.
+#ifdef ART_USE_GENERATIONAL_CC
+static constexpr bool kEnableGenerationalCCByDefault = true;
+#else
+static constexpr bool kEnableGenerationalCCByDefault = false;
+#endif
+
 }  // namespace art
 
 #endif  // __cplusplus
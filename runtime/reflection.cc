@@ -30,6 +30,7 @@
 #include "mirror/object_array-inl.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "nth_caller_visitor.h"
+#include "reflective_access_cache.h"
 #include "scoped_thread_state_change-inl.h"
 #include "stack_reference.h"
 #include "well_known_classes.h"
@@ -585,6 +586,44 @@ JValue InvokeVirtualOrInterfaceWithVarArgs(const ScopedObjectAccessAlreadyRunnab
   return result;
 }
 
+// VerifyAccess for the reflective invocation of `method` through `declared_method`. The checks
+// passed are cached by calling method, since reflection-heavy code tends to invoke the same
+// methods from the same places.
+static bool VerifyInvokeAccess(Thread* self,
+                               ObjPtr<mirror::Object> obj,
+                               ObjPtr<mirror::Class> declaring_class,
+                               ArtMethod* declared_method,
+                               ArtMethod* method,
+                               ObjPtr<mirror::Class>* calling_class,
+                               size_t num_frames)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  uint32_t access_flags = method->GetAccessFlags();
+  if ((access_flags & kAccPublic) != 0) {
+    return true;
+  }
+  NthCallerVisitor visitor(self, num_frames);
+  visitor.WalkStack();
+  ArtMethod* caller = visitor.caller;
+  if (UNLIKELY(caller == nullptr)) {
+    // The caller is an attached native thread.
+    return false;
+  }
+  ReflectiveAccessCache* cache = self->GetReflectiveAccessCache();
+  if (cache->Contains(caller, declared_method, method)) {
+    return true;
+  }
+  ObjPtr<mirror::Class> klass = caller->GetDeclaringClass();
+  *calling_class = klass;
+  if (!VerifyAccess(obj, declaring_class, access_flags, klass)) {
+    return false;
+  }
+  // The access to a protected method of another package depends on the class of the receiver.
+  if ((access_flags & kAccProtected) == 0 || declaring_class->IsInSamePackage(klass)) {
+    cache->Add(caller, declared_method, method);
+  }
+  return true;
+}
+
 jobject InvokeMethod(const ScopedObjectAccessAlreadyRunnable& soa, jobject javaMethod,
                      jobject javaReceiver, jobject javaArgs, size_t num_frames) {
   // We want to make sure that the stack is not within a small distance from the
@@ -598,7 +637,8 @@ jobject InvokeMethod(const ScopedObjectAccessAlreadyRunnable& soa, jobject javaM
 
   ObjPtr<mirror::Executable> executable = soa.Decode<mirror::Executable>(javaMethod);
   const bool accessible = executable->IsAccessible();
-  ArtMethod* m = executable->GetArtMethod();
+  ArtMethod* const declared_method = executable->GetArtMethod();
+  ArtMethod* m = declared_method;
 
   ObjPtr<mirror::Class> declaring_class = m->GetDeclaringClass();
   if (UNLIKELY(!declaring_class->IsInitialized())) {
@@ -642,12 +682,13 @@ jobject InvokeMethod(const ScopedObjectAccessAlreadyRunnable& soa, jobject javaM
 
   // If method is not set to be accessible, verify it can be accessed by the caller.
   ObjPtr<mirror::Class> calling_class;
-  if (!accessible && !VerifyAccess(soa.Self(),
-                                   receiver,
-                                   declaring_class,
-                                   m->GetAccessFlags(),
-                                   &calling_class,
-                                   num_frames)) {
+  if (!accessible && !VerifyInvokeAccess(soa.Self(),
+                                         receiver,
+                                         declaring_class,
+                                         declared_method,
+                                         m,
+                                         &calling_class,
+                                         num_frames)) {
     ThrowIllegalAccessException(
         StringPrintf("Class %s cannot access %s method %s of class %s",
             calling_class == nullptr ? "null" : calling_class->PrettyClass().c_str(),
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ART_RUNTIME_REFLECTIVE_ACCESS_CACHE_H_
+#define ART_RUNTIME_REFLECTIVE_ACCESS_CACHE_H_
+
+#include <array>
+
+#include "base/atomic.h"
+#include "base/bit_utils.h"
+#include "base/macros.h"
+
+namespace art {
+
+class ArtMethod;
+
+// A small direct-mapped cache of the access checks passed by the reflective calls of a thread. An
+// entry records that the `caller` method may invoke `method` through the `declared` method of a
+// java.lang.reflect.Method, which is `method` unless that is virtual and overridden by the class
+// of the receiver. Only results that do not depend on the receiver are cached. The methods are
+// only freed when their class loader is unloaded, the class linker then calls InvalidateAll, and
+// each cache is cleared on its next use.
+class ReflectiveAccessCache {
+ public:
+  // Power of two, so that computing the index is cheap.
+  static constexpr size_t kSize = 64;
+
+  ReflectiveAccessCache();
+
+  // Return whether `caller` was recorded to have access to `method` through `declared`.
+  ALWAYS_INLINE bool Contains(ArtMethod* caller, ArtMethod* declared, ArtMethod* method) {
+    if (UNLIKELY(epoch_ != global_epoch_.LoadAcquire())) {
+      Clear();
+      return false;
+    }
+    const Entry& entry = entries_[IndexOf(caller, method)];
+    return entry.caller == caller && entry.declared == declared && entry.method == method;
+  }
+
+  ALWAYS_INLINE void Add(ArtMethod* caller, ArtMethod* declared, ArtMethod* method) {
+    Entry& entry = entries_[IndexOf(caller, method)];
+    entry.caller = caller;
+    entry.declared = declared;
+    entry.method = method;
+  }
+
+  void Clear();
+
+  // Invalidate the caches of all the threads, before the methods of a class loader are freed.
+  static void InvalidateAll();
+
+ private:
+  struct Entry {
+    ArtMethod* caller;
+    ArtMethod* declared;
+    ArtMethod* method;
+  };
+
+  static size_t IndexOf(ArtMethod* caller, ArtMethod* method) {
+    static_assert(IsPowerOfTwo(kSize), "Size must be a power of two");
+    uintptr_t key = (reinterpret_cast<uintptr_t>(caller) >> 3) ^
+                    (reinterpret_cast<uintptr_t>(method) >> 5);
+    return (key ^ (key >> 8)) & (kSize - 1);
+  }
+
+  static Atomic<uint32_t> global_epoch_;
+
+  // The value of `global_epoch_` when the cache was last cleared. The cache is stale when they
+  // differ.
+  uint32_t epoch_;
+  std::array<Entry, kSize> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReflectiveAccessCache);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_REFLECTIVE_ACCESS_CACHE_H_
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "reflective_access_cache.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+TEST(ReflectiveAccessCache, ContainsAdd) {
+  std::unique_ptr<ReflectiveAccessCache> cache(new ReflectiveAccessCache());
+  uint64_t methods[3];
+  ArtMethod* caller = reinterpret_cast<ArtMethod*>(&methods[0]);
+  ArtMethod* declared = reinterpret_cast<ArtMethod*>(&methods[1]);
+  ArtMethod* method = reinterpret_cast<ArtMethod*>(&methods[2]);
+
+  EXPECT_FALSE(cache->Contains(caller, method, method));
+  cache->Add(caller, method, method);
+  EXPECT_TRUE(cache->Contains(caller, method, method));
+  // The entries are specific to the caller and to the declared method.
+  EXPECT_FALSE(cache->Contains(declared, method, method));
+  EXPECT_FALSE(cache->Contains(caller, declared, method));
+
+  cache->Add(caller, declared, method);
+  EXPECT_TRUE(cache->Contains(caller, declared, method));
+
+  cache->Clear();
+  EXPECT_FALSE(cache->Contains(caller, declared, method));
+}
+
+TEST(ReflectiveAccessCache, InvalidateAll) {
+  std::unique_ptr<ReflectiveAccessCache> cache(new ReflectiveAccessCache());
+  uint64_t methods[2];
+  ArtMethod* caller = reinterpret_cast<ArtMethod*>(&methods[0]);
+  ArtMethod* method = reinterpret_cast<ArtMethod*>(&methods[1]);
+  cache->Add(caller, method, method);
+  ASSERT_TRUE(cache->Contains(caller, method, method));
+  ReflectiveAccessCache::InvalidateAll();
+  EXPECT_FALSE(cache->Contains(caller, method, method));
+  // The cache can be used again after it was cleared.
+  cache->Add(caller, method, method);
+  EXPECT_TRUE(cache->Contains(caller, method, method));
+}
+
+}  // namespace art
@@ -79,6 +79,7 @@
 #include "dex/art_dex_file_loader.h"
 #include "dex/dex_file_loader.h"
 #include "elf_file.h"
+#include "entrypoints/quick/quick_entrypoint_counters.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
 #include "experimental_flags.h"
 #include "fault_handler.h"
@@ -90,6 +91,7 @@
 #include "gc/system_weak.h"
 #include "handle_scope-inl.h"
 #include "hidden_api.h"
+#include "identity_hash_table.h"
 #include "image-inl.h"
 #include "instrumentation.h"
 #include "intern_table.h"
@@ -115,6 +117,7 @@
 #include "mirror/throwable.h"
 #include "mirror/var_handle.h"
 #include "monitor.h"
+#include "monitor_contention_profile.h"
 #include "native/dalvik_system_DexFile.h"
 #include "native/dalvik_system_VMDebug.h"
 #include "native/dalvik_system_VMRuntime.h"
@@ -159,8 +162,12 @@
 #include "sigchain.h"
 #include "signal_catcher.h"
 #include "signal_set.h"
+#include "startup_class_preloader.h"
+#include "startup_timings.h"
+#include "stats_region.h"
 #include "thread.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "ti/agent.h"
 #include "trace.h"
 #include "transaction.h"
@@ -173,6 +180,10 @@
 #include "cutils/properties.h"
 #endif
 
+#ifdef VTUNE_ART
+#include "vtune_support.h"
+#endif
+
 namespace art {
 
 // If a signal isn't handled properly, enable a handler that attempts to dump the Java stack.
@@ -188,6 +199,11 @@ const char* Runtime::art_extension_version = STRINGIFY(ART_EXTENSION_VERSION);
 // barrier config.
 static constexpr double kExtraDefaultHeapGrowthMultiplier = kUseReadBarrier ? 1.0 : 0.0;
 
+#ifdef CAPSTONE
+// The Auto Fast JNI detection is not latency critical, run it with the priority of the JIT.
+static constexpr int kAutoFastPoolThreadPthreadPriority = 9;
+#endif
+
 Runtime* Runtime::instance_ = nullptr;
 
 struct TraceConfig {
@@ -279,6 +295,9 @@ Runtime::Runtime()
       always_set_hidden_api_warning_flag_(false),
       hidden_api_access_event_log_rate_(0),
       dump_native_stack_on_sig_quit_(true),
+      hprof_fork_dump_(false),
+      lazy_stack_traces_(false),
+      max_stack_trace_depth_(0u),
       pruned_dalvik_cache_(false),
       // Initially assume we perceive jank in case the process state is never updated.
       process_state_(kProcessStateJankPerceptible),
@@ -375,6 +394,9 @@ Runtime::~Runtime() {
   // Make sure to let the GC complete if it is running.
   heap_->WaitForGcToComplete(gc::kGcCauseBackground, self);
   heap_->DeleteThreadPool();
+  if (startup_class_preloader_ != nullptr) {
+    startup_class_preloader_->Stop(self);
+  }
   if (jit_ != nullptr) {
     ScopedTrace trace2("Delete jit");
     VLOG(jit) << "Deleting jit thread pool";
@@ -382,6 +404,24 @@ Runtime::~Runtime() {
     // JIT compiler threads.
     jit_->DeleteThreadPool();
   }
+#ifdef CAPSTONE
+  if (auto_fast_thread_pool_ != nullptr) {
+    std::unique_ptr<ThreadPool> pool;
+    {
+      ScopedSuspendAll ssa(__FUNCTION__);
+      // Clear auto_fast_thread_pool_ while the threads are suspended, so that a thread
+      // registering native methods does not use it anymore.
+      pool = std::move(auto_fast_thread_pool_);
+    }
+    pool->StopWorkers(self);
+    pool->RemoveAllTasks(self);
+    pool->Wait(self, false, false);
+  }
+#endif
+#ifdef VTUNE_ART
+  // The JIT threads do not queue VTune events anymore.
+  StopVTuneFlushThread();
+#endif
 
   // Make sure our internal threads are dead before we start tearing down things they're using.
   GetRuntimeCallbacks()->StopDebugger();
@@ -614,6 +654,7 @@ void Runtime::CallExitHook(jint status) {
 void Runtime::SweepSystemWeaks(IsMarkedVisitor* visitor) {
   GetInternTable()->SweepInternTableWeaks(visitor);
   GetMonitorList()->SweepMonitorList(visitor);
+  identity_hash_table_->Sweep(visitor);
   GetJavaVM()->SweepJniWeakGlobals(visitor);
   GetHeap()->SweepAllocationRecords(visitor);
   if (GetJit() != nullptr) {
@@ -623,6 +664,7 @@ void Runtime::SweepSystemWeaks(IsMarkedVisitor* visitor) {
     // TODO: Move this closer to CleanupClassLoaders, to avoid blocking weak accesses
     // from mutators. See b/32167580.
     GetJit()->GetCodeCache()->SweepRootTables(visitor);
+    GetJit()->SweepOptimizedCompilationRequests(visitor);
   }
 
   // All other generic system-weak holders.
@@ -897,12 +939,26 @@ size_t Runtime::ReadMemProperty(char* str) {
   return ret;
 }
 
+#ifdef CAPSTONE
+bool Runtime::AddAutoFastTask(Thread* self, Task* task) {
+  if (auto_fast_thread_pool_ == nullptr) {
+    return false;
+  }
+  auto_fast_thread_pool_->AddTask(self, task);
+  return true;
+}
+#endif
+
 void Runtime::InitNonZygoteOrPostFork(
     JNIEnv* env,
     bool is_system_server,
     NativeBridgeAction action,
     const char* isa,
     bool profile_system_server) {
+  if (is_zygote_) {
+    // The startup of the app starts with the fork.
+    startup_timings_->Start();
+  }
   is_zygote_ = false;
 #ifdef CAPSTONE
 #ifdef __ANDROID__
@@ -911,6 +967,8 @@ void Runtime::InitNonZygoteOrPostFork(
   SetAutoFastDetect(strcmp(property_value, "true") != 0);
   property_get("persist.dalvik.autofast.debug", property_value, "false");
   gLogVerbosity.autofast_jni = (strcmp(property_value, "true") == 0);
+  property_get("persist.dalvik.autofast.persist", property_value, "true");
+  SetAutoFastPersist(strcmp(property_value, "false") != 0);
 #else
   const char* autofast_disable = getenv("ART_AUTOFAST_DISABLE");
   if (autofast_disable != nullptr) {
@@ -924,6 +982,8 @@ void Runtime::InitNonZygoteOrPostFork(
   } else {
     gLogVerbosity.autofast_jni = false;
   }
+  const char* autofast_persist = getenv("ART_AUTOFAST_PERSIST");
+  SetAutoFastPersist(autofast_persist != nullptr && strcmp(autofast_persist, "true") == 0);
 #endif
 #endif
 
@@ -953,6 +1013,15 @@ void Runtime::InitNonZygoteOrPostFork(
 
   // Create the thread pools.
   heap_->CreateThreadPool();
+#ifdef CAPSTONE
+  if (IsAutoFastDetect() && auto_fast_thread_pool_ == nullptr) {
+    // We need peers as we may report the thread, e.g., in the debugger.
+    constexpr bool kAutoFastPoolNeedsPeers = true;
+    auto_fast_thread_pool_.reset(
+        new ThreadPool("Autofast JNI thread pool", 1, kAutoFastPoolNeedsPeers));
+    auto_fast_thread_pool_->SetPthreadPriority(kAutoFastPoolThreadPthreadPriority);
+  }
+#endif
   // Reset the gc performance data at zygote fork so that the GCs
   // before fork aren't attributed to an app.
   heap_->ResetGcPerformanceInfo();
@@ -1214,6 +1283,14 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   Thread::SetSensitiveThreadHook(runtime_options.GetOrDefault(Opt::HookIsSensitiveThread));
   Monitor::Init(runtime_options.GetOrDefault(Opt::LockProfThreshold),
                 runtime_options.GetOrDefault(Opt::StackDumpLockProfThreshold));
+  monitor_contention_profile_.reset(new MonitorContentionProfile());
+  monitor_contention_profile_->SetEnabled(
+      runtime_options.GetOrDefault(Opt::MonitorContentionProfiling));
+  quick_entrypoint_counters_.reset(new QuickEntrypointCounters());
+  quick_entrypoint_counters_->SetEnabled(runtime_options.GetOrDefault(Opt::EntrypointCounters));
+  if (runtime_options.GetOrDefault(Opt::PreloadStartupClasses)) {
+    startup_class_preloader_.reset(new StartupClassPreloader());
+  }
 
   boot_class_path_string_ = runtime_options.ReleaseOrDefault(Opt::BootClassPath);
   class_path_string_ = runtime_options.ReleaseOrDefault(Opt::ClassPath);
@@ -1226,12 +1303,19 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   is_explicit_gc_disabled_ = runtime_options.Exists(Opt::DisableExplicitGC);
   dex2oat_enabled_ = runtime_options.GetOrDefault(Opt::Dex2Oat);
   image_dex2oat_enabled_ = runtime_options.GetOrDefault(Opt::ImageDex2Oat);
+  startup_timings_.reset(new StartupTimings());
+  if (!IsAotCompiler()) {
+    startup_timings_->Start();
+  }
   is_using_epsilon_gc_ = runtime_options.Exists(Opt::UseEpsilonGC);
   if (is_using_epsilon_gc_) {
     LOG(INFO) << "ART Runtime() Using Epsilon GC as options passed.";
   }
  
   dump_native_stack_on_sig_quit_ = runtime_options.GetOrDefault(Opt::DumpNativeStackOnSigQuit);
+  hprof_fork_dump_ = runtime_options.GetOrDefault(Opt::HprofForkDump);
+  lazy_stack_traces_ = runtime_options.GetOrDefault(Opt::LazyStackTraces);
+  max_stack_trace_depth_ = runtime_options.GetOrDefault(Opt::MaxStackTraceDepth);
 
   vfprintf_ = runtime_options.GetOrDefault(Opt::HookVfprintf);
   exit_ = runtime_options.GetOrDefault(Opt::HookExit);
@@ -1244,6 +1328,14 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
       << "-Xusetombstonedtraces is only supported in an Android environment";
 #endif
   stack_trace_file_ = runtime_options.ReleaseOrDefault(Opt::StackTraceFile);
+  if (runtime_options.Exists(Opt::StatsRegionFile)) {
+    std::string error_msg;
+    stats_region_ = StatsRegion::Create(runtime_options.GetOrDefault(Opt::StatsRegionFile),
+                                        &error_msg);
+    if (stats_region_ == nullptr) {
+      LOG(WARNING) << error_msg;
+    }
+  }
 
   compiler_executable_ = runtime_options.ReleaseOrDefault(Opt::Compiler);
   compiler_options_ = runtime_options.ReleaseOrDefault(Opt::CompilerOptions);
@@ -1261,6 +1353,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   monitor_list_ = new MonitorList;
   monitor_pool_ = MonitorPool::Create();
+  identity_hash_table_.reset(new IdentityHashTable());
   thread_list_ = new ThreadList(runtime_options.GetOrDefault(Opt::ThreadSuspendTimeout));
   intern_table_ = new InternTable;
 
@@ -1379,6 +1472,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        runtime_options.Exists(Opt::LowMemoryMode),
                        runtime_options.GetOrDefault(Opt::LongPauseLogThreshold),
                        runtime_options.GetOrDefault(Opt::LongGCLogThreshold),
+                       runtime_options.GetOrDefault(Opt::GcPauseTarget),
+                       runtime_options.GetOrDefault(Opt::GcCpuBudget),
                        ignore_max_footprint,
                        runtime_options.GetOrDefault(Opt::UseTLAB),
                        xgc_option.verify_pre_gc_heap_,
@@ -1393,8 +1488,15 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        runtime_options.GetOrDefault(Opt::TenureThreshold),
                        runtime_options.GetOrDefault(Opt::BumpSpaceCapacity),
                        xgc_option.measure_,
+                       xgc_option.numa_,
+                       xgc_option.huge_pages_,
+                       xgc_option.generational_cc_,
                        runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
-                       runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs));
+                       runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs),
+                       runtime_options.GetOrDefault(Opt::HSpaceCompactForFragmentationThreshold),
+                       runtime_options.GetOrDefault(
+                           Opt::HSpaceCompactForFragmentationMinIntervalsMs),
+                       runtime_options.GetOrDefault(Opt::CardRefinementIntervalMs));
 
   if (!heap_->HasBootImageSpace() && !allow_dex_file_fallback_) {
     LOG(ERROR) << "Dex file fallback disabled, cannot continue without image.";
@@ -1464,7 +1566,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
     // 4gb, no malloc. Explanation in header.
     low_4gb_arena_pool_.reset(new ArenaPool(/* use_malloc */ false, /* low_4gb */ true));
   }
-  linear_alloc_.reset(CreateLinearAlloc());
+  linear_alloc_.reset(CreateLinearAlloc(/* use_thread_local_chunks */ true));
 
   BlockSignals();
   InitPlatformSignalHandlers();
@@ -1929,6 +2031,11 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
     os << "Running non JIT\n";
   }
   DumpDeoptimizations(os);
+  startup_timings_->Dump(os);
+  if (QuickEntrypointCounters::IsEnabled()) {
+    ScopedObjectAccess soa(Thread::Current());
+    quick_entrypoint_counters_->Dump(os);
+  }
   TrackedAllocators::Dump(os);
   os << "\n";
 
@@ -2232,6 +2339,7 @@ ArtMethod* Runtime::CreateCalleeSaveMethod() {
 void Runtime::DisallowNewSystemWeaks() {
   CHECK(!kUseReadBarrier);
   monitor_list_->DisallowNewMonitors();
+  identity_hash_table_->Disallow();
   intern_table_->ChangeWeakRootState(gc::kWeakRootStateNoReadsOrWrites);
   java_vm_->DisallowNewWeakGlobals();
   heap_->DisallowNewAllocationRecords();
@@ -2248,6 +2356,7 @@ void Runtime::DisallowNewSystemWeaks() {
 void Runtime::AllowNewSystemWeaks() {
   CHECK(!kUseReadBarrier);
   monitor_list_->AllowNewMonitors();
+  identity_hash_table_->Allow();
   intern_table_->ChangeWeakRootState(gc::kWeakRootStateNormal);  // TODO: Do this in the sweeping.
   java_vm_->AllowNewWeakGlobals();
   heap_->AllowNewAllocationRecords();
@@ -2266,6 +2375,7 @@ void Runtime::BroadcastForNewSystemWeaks(bool broadcast_for_checkpoint) {
   // Thread::GetWeakRefAccessEnabled() flag and the checkpoint while weak ref access is disabled
   // (see ThreadList::RunCheckpoint).
   monitor_list_->BroadcastForNewMonitors();
+  identity_hash_table_->Broadcast(broadcast_for_checkpoint);
   intern_table_->BroadcastForNewInterns();
   java_vm_->BroadcastForNewWeakGlobals();
   heap_->BroadcastForNewAllocationRecords();
@@ -2334,6 +2444,11 @@ void Runtime::ClearCalleeSaveMethods() {
 
 void Runtime::RegisterAppInfo(const std::vector<std::string>& code_paths,
                               const std::string& profile_output_filename) {
+  if (startup_class_preloader_ != nullptr && !profile_output_filename.empty()) {
+    // Does not need the JIT, the classes are loaded and verified by the class linker.
+    startup_class_preloader_->Start(Thread::Current(), profile_output_filename);
+  }
+
   if (jit_.get() == nullptr) {
     // We are not JITing. Nothing to do.
     return;
@@ -2619,13 +2734,13 @@ bool Runtime::IsAsyncDeoptimizeable(uintptr_t code) const {
       GetJit()->GetCodeCache()->ContainsPc(reinterpret_cast<const void*>(code));
 }
 
-LinearAlloc* Runtime::CreateLinearAlloc() {
+LinearAlloc* Runtime::CreateLinearAlloc(bool use_thread_local_chunks) {
   // For 64 bit compilers, it needs to be in low 4GB in the case where we are cross compiling for a
   // 32 bit target. In this case, we have 32 bit pointers in the dex cache arrays which can't hold
   // when we have 64 bit ArtMethod pointers.
   return (IsAotCompiler() && Is64BitInstructionSet(kRuntimeISA))
-      ? new LinearAlloc(low_4gb_arena_pool_.get())
-      : new LinearAlloc(arena_pool_.get());
+      ? new LinearAlloc(low_4gb_arena_pool_.get(), use_thread_local_chunks)
+      : new LinearAlloc(arena_pool_.get(), use_thread_local_chunks);
 }
 
 double Runtime::GetHashTableMinLoadFactor() const {
@@ -2640,6 +2755,9 @@ void Runtime::UpdateProcessState(ProcessState process_state) {
   ProcessState old_process_state = process_state_;
   process_state_ = process_state;
   GetHeap()->UpdateProcessState(old_process_state, process_state);
+  if (process_state == kProcessStateJankPerceptible) {
+    startup_timings_->Finish();
+  }
 }
 
 void Runtime::RegisterSensitiveThread() const {
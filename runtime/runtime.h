@@ -82,22 +82,30 @@ enum class CalleeSaveType: uint32_t;
 class ClassLinker;
 class CompilerCallbacks;
 class DexFile;
+class IdentityHashTable;
 class InternTable;
 class IsMarkedVisitor;
 class JavaVMExt;
 class LinearAlloc;
 class MemMap;
+class MonitorContentionProfile;
 class MonitorList;
 class MonitorPool;
 class NullPointerHandler;
 class OatFileManager;
 class Plugin;
+class QuickEntrypointCounters;
 struct RuntimeArgumentMap;
 class RuntimeCallbacks;
 class SignalCatcher;
 class StackOverflowHandler;
+class StartupClassPreloader;
+class StartupTimings;
+class StatsRegion;
 class SuspensionHandler;
 class ThreadList;
+class Task;
+class ThreadPool;
 class Trace;
 struct TraceConfig;
 class Transaction;
@@ -286,6 +294,10 @@ class Runtime {
     return monitor_pool_;
   }
 
+  IdentityHashTable* GetIdentityHashTable() const {
+    return identity_hash_table_.get();
+  }
+
   // Is the given object the special object used to mark a cleared JNI weak global?
   bool IsClearedJniWeakGlobal(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -676,8 +688,9 @@ class Runtime {
   // Called from class linker.
   void SetSentinel(mirror::Object* sentinel) REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Create a normal LinearAlloc or low 4gb version if we are 64 bit AOT compiler.
-  LinearAlloc* CreateLinearAlloc();
+  // Create a normal LinearAlloc or low 4gb version if we are 64 bit AOT compiler. Only the
+  // allocator of the runtime may use thread-local chunks, see LinearAlloc.
+  LinearAlloc* CreateLinearAlloc(bool use_thread_local_chunks = false);
 
   OatFileManager& GetOatFileManager() const {
     DCHECK(oat_file_manager_ != nullptr);
@@ -695,6 +708,39 @@ class Runtime {
     return dump_native_stack_on_sig_quit_;
   }
 
+  bool GetHprofForkDump() const {
+    return hprof_fork_dump_;
+  }
+
+  // Whether Throwable records its stack trace with Thread::CreateRawInternalStackTrace. Not when
+  // the runtime is debuggable, since debuggers compare the depths of the stack traces and the
+  // stack, and redefined classes would not decode the recorded return PCs.
+  bool UseLazyStackTraces() const {
+    return lazy_stack_traces_ && !IsJavaDebuggable();
+  }
+
+  // The maximum depth of the lazy stack traces, 0 if unlimited.
+  size_t GetMaxStackTraceDepth() const {
+    return max_stack_trace_depth_;
+  }
+
+  MonitorContentionProfile* GetMonitorContentionProfile() const {
+    return monitor_contention_profile_.get();
+  }
+
+  StartupTimings* GetStartupTimings() const {
+    return startup_timings_.get();
+  }
+
+  QuickEntrypointCounters* GetQuickEntrypointCounters() const {
+    return quick_entrypoint_counters_.get();
+  }
+
+  // The region the GC and JIT counters are published in, null unless -XX:StatsRegionFile.
+  StatsRegion* GetStatsRegion() const {
+    return stats_region_.get();
+  }
+
   bool GetPrunedDalvikCache() const {
     return pruned_dalvik_cache_;
   }
@@ -740,6 +786,20 @@ class Runtime {
   void SetAutoFastDetect(bool value) {
     auto_fast_detect_ = value;
   }
+
+  // Should Auto fast Detection verdicts be persisted next to the oat files.
+  bool IsAutoFastPersist() const {
+    return auto_fast_persist_;
+  }
+
+  // Set Auto Fast Detection persistence.
+  void SetAutoFastPersist(bool value) {
+    auto_fast_persist_ = value;
+  }
+
+  // Queue an Auto Fast Detection task. Returns false, and does not take ownership of the task,
+  // if the Auto Fast Detection thread pool does not exist (before fork or during shutdown).
+  bool AddAutoFastTask(Thread* self, Task* task);
 #endif
 
 
@@ -891,6 +951,8 @@ class Runtime {
   size_t max_spins_before_thin_lock_inflation_;
   MonitorList* monitor_list_;
   MonitorPool* monitor_pool_;
+  // Identity hash codes of the objects hashed while thin locked.
+  std::unique_ptr<IdentityHashTable> identity_hash_table_;
 
   ThreadList* thread_list_;
 
@@ -1070,6 +1132,30 @@ class Runtime {
   // Whether threads should dump their native stack on SIGQUIT.
   bool dump_native_stack_on_sig_quit_;
 
+  // Whether hprof writes the heap dumps to files from a forked child process, so that the
+  // threads of this process resume as soon as the child is forked.
+  bool hprof_fork_dump_;
+
+  // -XX:LazyStackTraces and -XX:MaxStackTraceDepth.
+  bool lazy_stack_traces_;
+  size_t max_stack_trace_depth_;
+
+  // Shared counters of the GC and the JIT, polled by external agents.
+  std::unique_ptr<StatsRegion> stats_region_;
+
+  // Contention statistics of the inflated monitors.
+  std::unique_ptr<MonitorContentionProfile> monitor_contention_profile_;
+
+  // Calls of the compiled code to the slow paths of the entrypoints.
+  std::unique_ptr<QuickEntrypointCounters> quick_entrypoint_counters_;
+
+  // Loads and verifies the classes of the app profile in the background, null unless
+  // -XX:PreloadStartupClasses.
+  std::unique_ptr<StartupClassPreloader> startup_class_preloader_;
+
+  // Timings of the class, oat file and native library loading of the startup.
+  std::unique_ptr<StartupTimings> startup_timings_;
+
   // Whether the dalvik cache was pruned when initializing the runtime.
   bool pruned_dalvik_cache_;
   
@@ -1114,6 +1200,10 @@ class Runtime {
 #ifdef CAPSTONE
   // Auto Fast JNI detection gate.
   bool auto_fast_detect_;
+  // Whether Auto Fast JNI detection verdicts are persisted.
+  bool auto_fast_persist_;
+  // Runs the Auto Fast JNI detection off the threads registering the native methods.
+  std::unique_ptr<ThreadPool> auto_fast_thread_pool_;
 #endif
 
 
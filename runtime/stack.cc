@@ -762,6 +762,30 @@ QuickMethodFrameInfo StackVisitor::GetCurrentQuickFrameInfo() const {
   return QuickMethodFrameInfo(frame_size, callee_info.CoreSpillMask(), callee_info.FpSpillMask());
 }
 
+// Return the method header of the quick frame of `method` at `pc`, and set `entry` to the entry of
+// the frame in `cache`, if any.
+static const OatQuickMethodHeader* GetCachedOatQuickMethodHeader(
+    ArtMethod* method,
+    uintptr_t pc,
+    FrameInfoCache* cache,
+    /* out */ FrameInfoCache::Entry** entry) REQUIRES_SHARED(Locks::mutator_lock_) {
+  // The PC of the top frame of a fragment is not known, see ArtMethod::GetOatQuickMethodHeader.
+  if (cache == nullptr || pc == 0u) {
+    *entry = nullptr;
+    return method->GetOatQuickMethodHeader(pc, /* safe */ true);
+  }
+  *entry = cache->Find(method, pc);
+  if (*entry != nullptr) {
+    return (*entry)->header;
+  }
+  const OatQuickMethodHeader* header = method->GetOatQuickMethodHeader(pc, /* safe */ true);
+  // Unit tests may run methods without compiled code, their header does not contain the PC.
+  if (header == nullptr || header->Contains(pc)) {
+    *entry = cache->Add(method, pc, header);
+  }
+  return header;
+}
+
 template <StackVisitor::CountTransitions kCount>
 void StackVisitor::WalkStack(bool include_transitions) {
   if (check_suspended_) {
@@ -771,6 +795,9 @@ void StackVisitor::WalkStack(bool include_transitions) {
   bool exit_stubs_installed = Runtime::Current()->GetInstrumentation()->AreExitStubsInstalled();
   uint32_t instrumentation_stack_depth = 0;
   size_t inlined_frames_count = 0;
+  // The cache of the walking thread, which may not be the thread whose stack is walked.
+  Thread* self = Thread::Current();
+  FrameInfoCache* frame_info_cache = (self != nullptr) ? self->GetFrameInfoCache() : nullptr;
 
   for (const ManagedStack* current_fragment = thread_->GetManagedStack();
        current_fragment != nullptr; current_fragment = current_fragment->GetLink()) {
@@ -821,8 +848,10 @@ void StackVisitor::WalkStack(bool include_transitions) {
         header_retrieved = true;
       }
       while (method != nullptr) {
+        FrameInfoCache::Entry* cache_entry = nullptr;
         if (!header_retrieved) {
-          cur_oat_quick_method_header_ = method->GetOatQuickMethodHeader(cur_quick_frame_pc_, true);
+          cur_oat_quick_method_header_ = GetCachedOatQuickMethodHeader(
+              method, cur_quick_frame_pc_, frame_info_cache, &cache_entry);
         }
         header_retrieved = false;  // Force header retrieval in next iteration.
 
@@ -831,24 +860,37 @@ void StackVisitor::WalkStack(bool include_transitions) {
         if ((walk_kind_ == StackWalkKind::kIncludeInlinedFrames)
             && (cur_oat_quick_method_header_ != nullptr)
             && cur_oat_quick_method_header_->IsOptimized()) {
-          CodeInfo code_info = cur_oat_quick_method_header_->GetOptimizedCodeInfo();
-          CodeInfoEncoding encoding = code_info.ExtractEncoding();
-          uint32_t native_pc_offset =
-              cur_oat_quick_method_header_->NativeQuickPcOffset(cur_quick_frame_pc_);
-          StackMap stack_map = code_info.GetStackMapForNativePcOffset(native_pc_offset, encoding);
-          if (stack_map.IsValid() && stack_map.HasInlineInfo(encoding.stack_map.encoding)) {
-            InlineInfo inline_info = code_info.GetInlineInfoOf(stack_map, encoding);
-            DCHECK_EQ(current_inlining_depth_, 0u);
-            for (current_inlining_depth_ = inline_info.GetDepth(encoding.inline_info.encoding);
-                 current_inlining_depth_ != 0;
-                 --current_inlining_depth_) {
-              bool should_continue = VisitFrame();
-              if (UNLIKELY(!should_continue)) {
-                return;
-              }
-              cur_depth_++;
-              inlined_frames_count++;
+          // Only decode the stack map the first time the frame is seen, most frames have no
+          // inlined frames.
+          uint32_t inline_depth = (cache_entry != nullptr)
+              ? cache_entry->inline_depth
+              : FrameInfoCache::kUnknownInlineDepth;
+          if (inline_depth == FrameInfoCache::kUnknownInlineDepth) {
+            inline_depth = 0u;
+            CodeInfo code_info = cur_oat_quick_method_header_->GetOptimizedCodeInfo();
+            CodeInfoEncoding encoding = code_info.ExtractEncoding();
+            uint32_t native_pc_offset =
+                cur_oat_quick_method_header_->NativeQuickPcOffset(cur_quick_frame_pc_);
+            StackMap stack_map =
+                code_info.GetStackMapForNativePcOffset(native_pc_offset, encoding);
+            if (stack_map.IsValid() && stack_map.HasInlineInfo(encoding.stack_map.encoding)) {
+              InlineInfo inline_info = code_info.GetInlineInfoOf(stack_map, encoding);
+              inline_depth = inline_info.GetDepth(encoding.inline_info.encoding);
+            }
+            if (cache_entry != nullptr) {
+              cache_entry->inline_depth = inline_depth;
+            }
+          }
+          DCHECK_EQ(current_inlining_depth_, 0u);
+          for (current_inlining_depth_ = inline_depth;
+               current_inlining_depth_ != 0;
+               --current_inlining_depth_) {
+            bool should_continue = VisitFrame();
+            if (UNLIKELY(!should_continue)) {
+              return;
             }
+            cur_depth_++;
+            inlined_frames_count++;
           }
         }
 
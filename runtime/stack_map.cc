@@ -18,7 +18,10 @@
 
 #include <stdint.h>
 
+#include <atomic>
+
 #include "art_method.h"
+#include "base/atomic.h"
 #include "indenter.h"
 #include "scoped_thread_state_change-inl.h"
 
@@ -27,6 +30,74 @@ namespace art {
 constexpr size_t DexRegisterLocationCatalog::kNoLocationEntryIndex;
 constexpr uint32_t StackMap::kNoDexRegisterMap;
 constexpr uint32_t StackMap::kNoInlineInfo;
+constexpr size_t CodeInfo::kMaxStackMapsForUncachedSearch;
+
+// The index of the first stack map found at a native PC offset of a CodeInfo. The first one
+// must be returned, as the catch stack maps at the end of the table may share the native PC
+// of a safepoint, with a different stack mask. An entry is thus tagged with its CodeInfo and
+// native PC, and written under a sequence lock: `sequence` is odd while a writer updates the
+// other fields, which readers check by reading `sequence` before and after them.
+struct StackMapIndexCacheEntry {
+  Atomic<uint32_t> sequence;
+  Atomic<uint32_t> epoch;
+  Atomic<uintptr_t> code_info;
+  Atomic<uint32_t> native_pc_offset;
+  Atomic<uint32_t> index;
+};
+
+static constexpr size_t kStackMapIndexCacheSize = 1024;
+static StackMapIndexCacheEntry gStackMapIndexCache[kStackMapIndexCacheSize];
+
+// Bumped when compiled code is freed, since the memory of its CodeInfo may be reused for
+// another one. Entries of older epochs are stale.
+static Atomic<uint32_t> gStackMapIndexCacheEpoch(0u);
+
+StackMap CodeInfo::GetStackMapForNativePcOffsetCached(uint32_t native_pc_offset,
+                                                      const CodeInfoEncoding& encoding) const {
+  static_assert(IsPowerOfTwo(kStackMapIndexCacheSize), "Cache size must be a power of two");
+  const StackMapEncoding& stack_map_encoding = encoding.stack_map.encoding;
+  uintptr_t code_info = reinterpret_cast<uintptr_t>(region_.pointer());
+  uintptr_t key = code_info ^ (static_cast<uintptr_t>(native_pc_offset) * 0x9e3779b1u);
+  StackMapIndexCacheEntry* entry =
+      &gStackMapIndexCache[(key ^ (key >> 16)) & (kStackMapIndexCacheSize - 1)];
+  size_t number_of_stack_maps = GetNumberOfStackMaps(encoding);
+  uint32_t epoch = gStackMapIndexCacheEpoch.LoadAcquire();
+  uint32_t sequence = entry->sequence.LoadAcquire();
+  if ((sequence & 1u) == 0u) {
+    bool hit = entry->epoch.LoadRelaxed() == epoch &&
+               entry->code_info.LoadRelaxed() == code_info &&
+               entry->native_pc_offset.LoadRelaxed() == native_pc_offset;
+    uint32_t index = entry->index.LoadRelaxed();
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (hit && entry->sequence.LoadRelaxed() == sequence && index < number_of_stack_maps) {
+      StackMap stack_map = GetStackMapAt(index, encoding);
+      DCHECK_EQ(stack_map.GetNativePcOffset(stack_map_encoding, kRuntimeISA), native_pc_offset);
+      return stack_map;
+    }
+  }
+  for (size_t i = 0; i < number_of_stack_maps; ++i) {
+    StackMap stack_map = GetStackMapAt(i, encoding);
+    if (stack_map.GetNativePcOffset(stack_map_encoding, kRuntimeISA) == native_pc_offset) {
+      // Leave the entry alone if another thread is updating it.
+      sequence = entry->sequence.LoadRelaxed();
+      if ((sequence & 1u) == 0u &&
+          entry->sequence.CompareAndExchangeStrongAcquire(&sequence, sequence + 1u)) {
+        std::atomic_thread_fence(std::memory_order_release);
+        entry->epoch.StoreRelaxed(epoch);
+        entry->code_info.StoreRelaxed(code_info);
+        entry->native_pc_offset.StoreRelaxed(native_pc_offset);
+        entry->index.StoreRelaxed(static_cast<uint32_t>(i));
+        entry->sequence.StoreRelease(sequence + 2u);
+      }
+      return stack_map;
+    }
+  }
+  return StackMap();
+}
+
+void CodeInfo::InvalidateStackMapIndexCache() {
+  gStackMapIndexCacheEpoch.FetchAndAddSequentiallyConsistent(1u);
+}
 
 std::ostream& operator<<(std::ostream& stream, const DexRegisterLocation::Kind& kind) {
   using Kind = DexRegisterLocation::Kind;
@@ -80,6 +151,45 @@ DexRegisterLocation DexRegisterMap::GetDexRegisterLocation(uint16_t dex_register
   return dex_register_location_catalog.GetDexRegisterLocation(location_catalog_entry_index);
 }
 
+void DexRegisterMap::GetDexRegisterLocations(
+    uint16_t number_of_dex_registers,
+    const CodeInfo& code_info,
+    const CodeInfoEncoding& enc,
+    /* out */ std::vector<DexRegisterLocation>* locations) const {
+  DexRegisterLocationCatalog catalog = code_info.GetDexRegisterLocationCatalog(enc);
+  size_t number_of_location_catalog_entries = code_info.GetNumberOfLocationCatalogEntries(enc);
+  // Decode the catalog once. Its entries have variable sizes, so finding one is a linear search.
+  std::vector<DexRegisterLocation> catalog_locations;
+  catalog_locations.reserve(number_of_location_catalog_entries);
+  size_t offset = catalog.FindLocationOffset(0u);
+  for (size_t i = 0; i != number_of_location_catalog_entries; ++i) {
+    catalog_locations.push_back(catalog.GetDexRegisterLocationAtOffset(offset));
+    offset = catalog.NextLocationOffset(offset);
+  }
+  // Walk the live registers in order, the entries of the map are those of the live registers.
+  size_t map_locations_offset_in_bits =
+      GetLocationMappingDataOffset(number_of_dex_registers) * kBitsPerByte;
+  size_t map_entry_size_in_bits = SingleEntrySizeInBits(number_of_location_catalog_entries);
+  size_t index_in_dex_register_map = 0u;
+  locations->clear();
+  locations->reserve(number_of_dex_registers);
+  for (uint16_t i = 0; i != number_of_dex_registers; ++i) {
+    if (!IsDexRegisterLive(i)) {
+      locations->push_back(DexRegisterLocation::None());
+      continue;
+    }
+    // A single-entry catalog has no map, see GetLocationCatalogEntryIndex.
+    size_t location_catalog_entry_index = (number_of_location_catalog_entries == 1u)
+        ? 0u
+        : region_.LoadBits(
+              map_locations_offset_in_bits + index_in_dex_register_map * map_entry_size_in_bits,
+              map_entry_size_in_bits);
+    ++index_in_dex_register_map;
+    DCHECK_LT(location_catalog_entry_index, number_of_location_catalog_entries);
+    locations->push_back(catalog_locations[location_catalog_entry_index]);
+  }
+}
+
 static void DumpRegisterMapping(std::ostream& os,
                                 size_t dex_register_num,
                                 DexRegisterLocation location,
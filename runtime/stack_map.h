@@ -18,6 +18,7 @@
 #define ART_RUNTIME_STACK_MAP_H_
 
 #include <limits>
+#include <vector>
 
 #include "arch/code_offset.h"
 #include "base/bit_utils.h"
@@ -246,20 +247,25 @@ class DexRegisterLocationCatalog {
     size_t offset = kFixedSize;
     // Skip the first `location_catalog_entry_index - 1` entries.
     for (uint16_t i = 0; i < location_catalog_entry_index; ++i) {
-      // Read the first next byte and inspect its first 3 bits to decide
-      // whether it is a short or a large location.
-      DexRegisterLocation::Kind kind = ExtractKindAtOffset(offset);
-      if (DexRegisterLocation::IsShortLocationKind(kind)) {
-        // Short location.  Skip the current byte.
-        offset += SingleShortEntrySize();
-      } else {
-        // Large location.  Skip the 5 next bytes.
-        offset += SingleLargeEntrySize();
-      }
+      offset = NextLocationOffset(offset);
     }
     return offset;
   }
 
+  // Return the offset of the location catalog entry following the one at `offset`.
+  size_t NextLocationOffset(size_t offset) const {
+    // Read the first next byte and inspect its first 3 bits to decide
+    // whether it is a short or a large location.
+    DexRegisterLocation::Kind kind = ExtractKindAtOffset(offset);
+    if (DexRegisterLocation::IsShortLocationKind(kind)) {
+      // Short location.  Skip the current byte.
+      return offset + SingleShortEntrySize();
+    } else {
+      // Large location.  Skip the 5 next bytes.
+      return offset + SingleLargeEntrySize();
+    }
+  }
+
   // Get the internal kind of entry at `location_catalog_entry_index`.
   DexRegisterLocation::Kind GetLocationInternalKind(size_t location_catalog_entry_index) const {
     if (location_catalog_entry_index == kNoLocationEntryIndex) {
@@ -273,7 +279,11 @@ class DexRegisterLocationCatalog {
     if (location_catalog_entry_index == kNoLocationEntryIndex) {
       return DexRegisterLocation::None();
     }
-    size_t offset = FindLocationOffset(location_catalog_entry_index);
+    return GetDexRegisterLocationAtOffset(FindLocationOffset(location_catalog_entry_index));
+  }
+
+  // Get the (surface) kind and value of the entry at `offset`.
+  DexRegisterLocation GetDexRegisterLocationAtOffset(size_t offset) const {
     // Read the first byte and inspect its first 3 bits to get the location.
     ShortLocation first_byte = region_.LoadUnaligned<ShortLocation>(offset);
     DexRegisterLocation::Kind kind = ExtractKindFromShortLocation(first_byte);
@@ -475,6 +485,14 @@ class DexRegisterMap {
                                              const CodeInfo& code_info,
                                              const CodeInfoEncoding& enc) const;
 
+  // Get the locations of all the `number_of_dex_registers` Dex registers in `locations`. This
+  // decodes the map and the location catalog once, where calling GetDexRegisterLocation for each
+  // register takes time quadratic in the number of registers.
+  void GetDexRegisterLocations(uint16_t number_of_dex_registers,
+                               const CodeInfo& code_info,
+                               const CodeInfoEncoding& enc,
+                               /* out */ std::vector<DexRegisterLocation>* locations) const;
+
   int32_t GetStackOffsetInBytes(uint16_t dex_register_number,
                                 uint16_t number_of_dex_registers,
                                 const CodeInfo& code_info,
@@ -1545,7 +1563,11 @@ class CodeInfo {
     // TODO: Safepoint stack maps are sorted by native_pc_offset but catch stack
     //       maps are not. If we knew that the method does not have try/catch,
     //       we could do binary search.
-    for (size_t i = 0, e = GetNumberOfStackMaps(encoding); i < e; ++i) {
+    size_t number_of_stack_maps = GetNumberOfStackMaps(encoding);
+    if (number_of_stack_maps > kMaxStackMapsForUncachedSearch) {
+      return GetStackMapForNativePcOffsetCached(native_pc_offset, encoding);
+    }
+    for (size_t i = 0; i < number_of_stack_maps; ++i) {
       StackMap stack_map = GetStackMapAt(i, encoding);
       if (stack_map.GetNativePcOffset(encoding.stack_map.encoding, kRuntimeISA) ==
           native_pc_offset) {
@@ -1578,6 +1600,10 @@ class CodeInfo {
             InstructionSet instruction_set,
             const MethodInfo& method_info) const;
 
+  // Invalidate the stack map indices cached by GetStackMapForNativePcOffset, before compiled
+  // code is freed.
+  static void InvalidateStackMapIndexCache();
+
   // Check that the code info has valid stack map and abort if it does not.
   void AssertValidStackMap(const CodeInfoEncoding& encoding) const {
     if (region_.size() != 0 && region_.size_in_bits() < GetStackMapsSizeInBits(encoding)) {
@@ -1591,6 +1617,16 @@ class CodeInfo {
   }
 
  private:
+  // Methods with more stack maps than this look them up by native PC through a cache
+  // (see GetStackMapForNativePcOffsetCached) instead of a plain linear search.
+  static constexpr size_t kMaxStackMapsForUncachedSearch = 8;
+
+  // Same as GetStackMapForNativePcOffset, but first tries the stack map last found for
+  // `native_pc_offset` in this CodeInfo, as recorded in a global cache. This speeds up
+  // the stack walks of the GC and of exception delivery, which see the same PCs often.
+  StackMap GetStackMapForNativePcOffsetCached(uint32_t native_pc_offset,
+                                              const CodeInfoEncoding& encoding) const;
+
   // Compute the size of the Dex register map associated to the stack map at
   // `dex_register_map_offset_in_code_info`.
   size_t ComputeDexRegisterMapSizeOf(const CodeInfoEncoding& encoding,
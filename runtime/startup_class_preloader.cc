@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "startup_class_preloader.h"
+
+#include <unordered_set>
+
+#include "base/systrace.h"
+#include "class_linker.h"
+#include "class_loader_utils.h"
+#include "handle_scope-inl.h"
+#include "java_vm_ext.h"
+#include "jit/profile_compilation_info.h"
+#include "mirror/class-inl.h"
+#include "mirror/class_loader.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-current-inl.h"
+#include "thread_pool.h"
+
+namespace art {
+
+// Takes handles of the class loaders registered with the class linker.
+class GetAppClassLoadersVisitor : public ClassLoaderVisitor {
+ public:
+  GetAppClassLoadersVisitor(VariableSizedHandleScope* hs,
+                            std::vector<Handle<mirror::ClassLoader>>* class_loaders)
+      : hs_(hs),
+        class_loaders_(class_loaders) {}
+
+  void Visit(ObjPtr<mirror::ClassLoader> class_loader)
+      REQUIRES_SHARED(Locks::classlinker_classes_lock_, Locks::mutator_lock_) OVERRIDE {
+    class_loaders_->push_back(hs_->NewHandle(class_loader));
+  }
+
+ private:
+  VariableSizedHandleScope* const hs_;
+  std::vector<Handle<mirror::ClassLoader>>* const class_loaders_;
+};
+
+// Loads and verifies a batch of classes of one class loader.
+class StartupClassPreloader::PreloadTask FINAL : public Task {
+ public:
+  PreloadTask(jobject class_loader, std::vector<std::string>&& descriptors)
+      : class_loader_(class_loader),
+        descriptors_(std::move(descriptors)) {}
+
+  void Run(Thread* self) OVERRIDE {
+    ScopedTrace trace("Preload startup classes");
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    ScopedObjectAccess soa(self);
+    StackHandleScope<2> hs(self);
+    Handle<mirror::ClassLoader> class_loader(
+        hs.NewHandle(soa.Decode<mirror::ClassLoader>(class_loader_)));
+    MutableHandle<mirror::Class> klass(hs.NewHandle<mirror::Class>(nullptr));
+    for (const std::string& descriptor : descriptors_) {
+      klass.Assign(class_linker->FindClass(self, descriptor.c_str(), class_loader));
+      if (klass == nullptr) {
+        // The profile may be stale. The app thread will throw when it needs the class.
+        self->ClearException();
+        continue;
+      }
+      if (!klass->IsVerified() && !klass->IsErroneous()) {
+        // A verification failure is recorded in the class, and rethrown by the initialization.
+        class_linker->VerifyClass(self, klass);
+        if (self->IsExceptionPending()) {
+          self->ClearException();
+        }
+      }
+    }
+  }
+
+  void Finalize() OVERRIDE {
+    Runtime::Current()->GetJavaVM()->DeleteGlobalRef(Thread::Current(), class_loader_);
+    delete this;
+  }
+
+ private:
+  const jobject class_loader_;
+  const std::vector<std::string> descriptors_;
+
+  DISALLOW_COPY_AND_ASSIGN(PreloadTask);
+};
+
+// Reads the profile, and splits its classes into preload tasks.
+class StartupClassPreloader::LoadProfileTask FINAL : public SelfDeletingTask {
+ public:
+  LoadProfileTask(ThreadPool* thread_pool, const std::string& profile_filename)
+      : thread_pool_(thread_pool),
+        profile_filename_(profile_filename) {}
+
+  void Run(Thread* self) OVERRIDE {
+    ScopedTrace trace("Load startup profile");
+    ProfileCompilationInfo info;
+    if (!info.Load(profile_filename_, /* clear_if_invalid */ false)) {
+      LOG(WARNING) << "Startup classes will not be preloaded: could not load profile "
+                   << profile_filename_;
+      return;
+    }
+    if (info.IsEmpty()) {
+      return;
+    }
+
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    ScopedObjectAccess soa(self);
+    VariableSizedHandleScope hs(self);
+    std::vector<Handle<mirror::ClassLoader>> class_loaders;
+    {
+      ReaderMutexLock mu(self, *Locks::classlinker_classes_lock_);
+      GetAppClassLoadersVisitor visitor(&hs, &class_loaders);
+      class_linker->VisitClassLoaders(&visitor);
+    }
+    JavaVMExt* vm = soa.Vm();
+    size_t num_classes = 0u;
+    for (Handle<mirror::ClassLoader> class_loader : class_loaders) {
+      // Only the class loaders whose dex files are known without running Java code.
+      if (!IsPathOrDexClassLoader(soa, class_loader) &&
+          !IsDelegateLastClassLoader(soa, class_loader)) {
+        continue;
+      }
+      std::vector<const DexFile*> dex_files;
+      VisitClassLoaderDexFiles(soa,
+                               class_loader,
+                               [&dex_files](const DexFile* dex_file) {
+                                 dex_files.push_back(dex_file);
+                                 return true;  // Continue with other dex files.
+                               });
+      std::unordered_set<std::string> descriptors = info.GetClassDescriptors(dex_files);
+      std::vector<std::string> batch;
+      for (auto it = descriptors.begin(); it != descriptors.end(); ) {
+        batch.push_back(*it);
+        ++it;
+        if (batch.size() == kClassesPerTask || it == descriptors.end()) {
+          num_classes += batch.size();
+          thread_pool_->AddTask(
+              self, new PreloadTask(vm->AddGlobalRef(self, class_loader.Get()), std::move(batch)));
+          batch.clear();
+        }
+      }
+    }
+    VLOG(class_linker) << "Preloading " << num_classes << " startup classes of "
+                       << profile_filename_;
+  }
+
+ private:
+  ThreadPool* const thread_pool_;
+  const std::string profile_filename_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoadProfileTask);
+};
+
+StartupClassPreloader::StartupClassPreloader()
+    : lock_("startup class preloader lock", kDefaultMutexLevel) {}
+
+StartupClassPreloader::~StartupClassPreloader() {}
+
+void StartupClassPreloader::Start(Thread* self, const std::string& profile_filename) {
+  MutexLock mu(self, lock_);
+  if (thread_pool_ != nullptr) {
+    return;
+  }
+  // The workers need peers, the app class loaders may run Java code to find their classes.
+  thread_pool_.reset(
+      new ThreadPool("Startup class preloader", kThreadCount, /* create_peers */ true));
+  thread_pool_->AddTask(self, new LoadProfileTask(thread_pool_.get(), profile_filename));
+  thread_pool_->StartWorkers(self);
+}
+
+void StartupClassPreloader::Stop(Thread* self) {
+  std::unique_ptr<ThreadPool> pool;
+  {
+    MutexLock mu(self, lock_);
+    pool = std::move(thread_pool_);
+  }
+  if (pool != nullptr) {
+    pool->StopWorkers(self);
+    // Let the running tasks finish. The load task may still add tasks, drop them afterwards.
+    pool->Wait(self, /* do_work */ false, /* may_hold_locks */ false);
+    pool->RemoveAllTasks(self);
+  }
+}
+
+}  // namespace art
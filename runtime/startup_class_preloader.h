@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_STARTUP_CLASS_PRELOADER_H_
+#define ART_RUNTIME_STARTUP_CLASS_PRELOADER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art {
+
+class Thread;
+class ThreadPool;
+
+// Loads, links and verifies the classes of the app profile on background threads while the
+// main thread starts the app, so that the main thread finds them resolved and verified when it
+// first uses them. Enabled with -XX:PreloadStartupClasses:true. The classes are never
+// initialized: the <clinit> still runs on the thread that first uses the class, in the order
+// the program uses them.
+class StartupClassPreloader {
+ public:
+  // Number of background threads loading the classes.
+  static constexpr size_t kThreadCount = 2;
+  // Number of classes loaded by a single task.
+  static constexpr size_t kClassesPerTask = 64;
+
+  StartupClassPreloader();
+  ~StartupClassPreloader();
+
+  // Start loading the classes of `profile_filename` that belong to the dex files of the app
+  // class loaders. Only the first call does anything.
+  void Start(Thread* self, const std::string& profile_filename);
+
+  // Stop the background threads, dropping the classes not loaded yet. Called at shutdown.
+  void Stop(Thread* self);
+
+ private:
+  class LoadProfileTask;
+  class PreloadTask;
+
+  Mutex lock_;
+  std::unique_ptr<ThreadPool> thread_pool_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(StartupClassPreloader);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_STARTUP_CLASS_PRELOADER_H_
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "startup_timings.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "base/logging.h"
+#include "base/systrace.h"
+#include "base/time_utils.h"
+#include "base/utils.h"
+#include "runtime.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+std::atomic<bool> StartupTimings::recording_(false);
+
+StartupTimings::StartupTimings()
+    : lock_("startup timings lock", kStartupTimingsLock),
+      main_tid_(0),
+      start_ns_(0u),
+      end_ns_(0u),
+      counts_(),
+      total_ns_(),
+      main_thread_ns_() {}
+
+StartupTimings::~StartupTimings() {
+  recording_.store(false, std::memory_order_relaxed);
+}
+
+void StartupTimings::Start() {
+  MutexLock mu(Thread::Current(), lock_);
+  main_tid_ = GetTid();
+  start_ns_ = NanoTime();
+  end_ns_ = 0u;
+  std::fill_n(counts_, kNumKinds, 0u);
+  std::fill_n(total_ns_, kNumKinds, 0u);
+  std::fill_n(main_thread_ns_, kNumKinds, 0u);
+  critical_events_.clear();
+  recording_.store(true, std::memory_order_relaxed);
+}
+
+void StartupTimings::Finish() {
+  if (!recording_.exchange(false, std::memory_order_relaxed)) {
+    return;
+  }
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    end_ns_ = NanoTime();
+  }
+  std::ostringstream oss;
+  Dump(oss);
+  LOG(INFO) << oss.str();
+}
+
+void StartupTimings::Record(Kind kind, const char* name, uint64_t duration_ns) {
+  DCHECK_LT(kind, kNumKinds);
+  MutexLock mu(Thread::Current(), lock_);
+  ++counts_[kind];
+  total_ns_[kind] += duration_ns;
+  if (GetTid() != main_tid_) {
+    return;
+  }
+  main_thread_ns_[kind] += duration_ns;
+  if (critical_events_.size() == kMaxCriticalEvents) {
+    if (duration_ns <= critical_events_.back().duration_ns) {
+      return;
+    }
+    critical_events_.pop_back();
+  }
+  auto it = std::upper_bound(critical_events_.begin(),
+                             critical_events_.end(),
+                             duration_ns,
+                             [](uint64_t duration, const Event& event) {
+                               return duration > event.duration_ns;
+                             });
+  critical_events_.insert(it, Event { kind, name, duration_ns });
+}
+
+std::vector<StartupTimings::Event> StartupTimings::GetCriticalEvents() {
+  MutexLock mu(Thread::Current(), lock_);
+  return critical_events_;
+}
+
+void StartupTimings::Dump(std::ostream& os) {
+  MutexLock mu(Thread::Current(), lock_);
+  if (start_ns_ == 0u) {
+    return;
+  }
+  uint64_t end_ns = (end_ns_ != 0u) ? end_ns_ : NanoTime();
+  os << "Startup timings" << ((end_ns_ != 0u) ? "" : " (in progress)") << ": "
+     << NsToUs(end_ns - start_ns_) << "us\n";
+  for (size_t kind = 0; kind != kNumKinds; ++kind) {
+    os << "  " << static_cast<Kind>(kind) << ": " << counts_[kind] << " events, "
+       << NsToUs(total_ns_[kind]) << "us, "
+       << NsToUs(main_thread_ns_[kind]) << "us on the main thread\n";
+  }
+  os << "Startup critical path (slowest events of the main thread):\n";
+  for (const Event& event : critical_events_) {
+    os << "  " << NsToUs(event.duration_ns) << "us " << event.kind << " " << event.name << "\n";
+  }
+}
+
+std::ostream& operator<<(std::ostream& os, const StartupTimings::Kind& kind) {
+  switch (kind) {
+    case StartupTimings::kClassLoading:
+      return os << "class loading";
+    case StartupTimings::kClassVerification:
+      return os << "class verification";
+    case StartupTimings::kClassInitialization:
+      return os << "class initialization";
+    case StartupTimings::kOatFileLoading:
+      return os << "oat file loading";
+    case StartupTimings::kNativeLibraryLoading:
+      return os << "native library loading";
+    case StartupTimings::kNumKinds:
+      break;
+  }
+  return os << "unknown";
+}
+
+ScopedStartupTiming::ScopedStartupTiming(StartupTimings::Kind kind, const char* name)
+    : kind_(kind),
+      name_(name),
+      start_ns_(StartupTimings::IsRecording() ? NanoTime() : 0u) {
+  ATRACE_BEGIN(name);
+}
+
+ScopedStartupTiming::~ScopedStartupTiming() {
+  ATRACE_END();
+  if (start_ns_ != 0u && StartupTimings::IsRecording()) {
+    Runtime::Current()->GetStartupTimings()->Record(kind_, name_, NanoTime() - start_ns_);
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_STARTUP_TIMINGS_H_
+#define ART_RUNTIME_STARTUP_TIMINGS_H_
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art {
+
+// Times the class loading, verification and initialization, and the oat file and JNI library
+// loading done by the process until its startup ends, when it first becomes jank perceptible.
+// The report has the totals of each kind of event, and the slowest events of the main thread,
+// that is those on the critical path to the first frame. The times of an event include the
+// times of the events nested in it, e.g. the verification of a class is part of its
+// initialization. The report is logged at the end of the startup and part of the SIGQUIT dump.
+class StartupTimings {
+ public:
+  enum Kind {
+    kClassLoading,
+    kClassVerification,
+    kClassInitialization,
+    kOatFileLoading,
+    kNativeLibraryLoading,
+    kNumKinds,
+  };
+
+  struct Event {
+    Kind kind;
+    std::string name;
+    uint64_t duration_ns;
+  };
+
+  StartupTimings();
+  ~StartupTimings();
+
+  static bool IsRecording() {
+    return recording_.load(std::memory_order_relaxed);
+  }
+
+  // Clear the timings and record the events until Finish(). The calling thread is the main
+  // thread of the report.
+  void Start() REQUIRES(!lock_);
+
+  // Stop recording and log the report, unless not recording.
+  void Finish() REQUIRES(!lock_);
+
+  void Record(Kind kind, const char* name, uint64_t duration_ns) REQUIRES(!lock_);
+
+  // Return the slowest events of the main thread, in decreasing order of duration.
+  std::vector<Event> GetCriticalEvents() REQUIRES(!lock_);
+
+  void Dump(std::ostream& os) REQUIRES(!lock_);
+
+ private:
+  // The number of slowest events of the main thread kept.
+  static constexpr size_t kMaxCriticalEvents = 32;
+
+  static std::atomic<bool> recording_;
+
+  Mutex lock_;
+  pid_t main_tid_ GUARDED_BY(lock_);
+  uint64_t start_ns_ GUARDED_BY(lock_);
+  uint64_t end_ns_ GUARDED_BY(lock_);
+  uint64_t counts_[kNumKinds] GUARDED_BY(lock_);
+  uint64_t total_ns_[kNumKinds] GUARDED_BY(lock_);
+  uint64_t main_thread_ns_[kNumKinds] GUARDED_BY(lock_);
+  std::vector<Event> critical_events_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(StartupTimings);
+};
+
+std::ostream& operator<<(std::ostream& os, const StartupTimings::Kind& kind);
+
+// Records an event of the startup, and marks it for ATrace. `name` must outlive the object.
+class ScopedStartupTiming {
+ public:
+  ScopedStartupTiming(StartupTimings::Kind kind, const char* name);
+  ~ScopedStartupTiming();
+
+ private:
+  const StartupTimings::Kind kind_;
+  const char* const name_;
+  // 0 when not recording.
+  const uint64_t start_ns_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedStartupTiming);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_STARTUP_TIMINGS_H_
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "startup_timings.h"
+
+#include <pthread.h>
+
+#include <sstream>
+
+#include "common_runtime_test.h"
+
+namespace art {
+
+class StartupTimingsTest : public CommonRuntimeTest {};
+
+TEST_F(StartupTimingsTest, KeepsSlowestEventsOfMainThread) {
+  StartupTimings timings;
+  timings.Start();
+  EXPECT_TRUE(StartupTimings::IsRecording());
+  timings.Record(StartupTimings::kClassLoading, "LA;", /* duration_ns */ 2000u);
+  timings.Record(StartupTimings::kOatFileLoading, "base.apk", /* duration_ns */ 9000u);
+  timings.Record(StartupTimings::kClassInitialization, "LB;", /* duration_ns */ 5000u);
+
+  // The events of other threads are only part of the totals.
+  pthread_t thread;
+  auto record = [](void* arg) -> void* {
+    reinterpret_cast<StartupTimings*>(arg)->Record(
+        StartupTimings::kNativeLibraryLoading, "libfoo.so", /* duration_ns */ 100000u);
+    return nullptr;
+  };
+  ASSERT_EQ(0, pthread_create(&thread, nullptr, record, &timings));
+  ASSERT_EQ(0, pthread_join(thread, nullptr));
+
+  std::vector<StartupTimings::Event> events = timings.GetCriticalEvents();
+  ASSERT_EQ(3u, events.size());
+  EXPECT_EQ("base.apk", events[0].name);
+  EXPECT_EQ(StartupTimings::kOatFileLoading, events[0].kind);
+  EXPECT_EQ("LB;", events[1].name);
+  EXPECT_EQ("LA;", events[2].name);
+
+  timings.Finish();
+  EXPECT_FALSE(StartupTimings::IsRecording());
+  std::ostringstream oss;
+  timings.Dump(oss);
+  EXPECT_NE(std::string::npos, oss.str().find("native library loading: 1 events, 100us, 0us"))
+      << oss.str();
+}
+
+TEST_F(StartupTimingsTest, BoundsCriticalEvents) {
+  StartupTimings timings;
+  timings.Start();
+  for (uint64_t i = 1; i <= 1000u; ++i) {
+    timings.Record(StartupTimings::kClassLoading, "LA;", /* duration_ns */ i);
+  }
+  std::vector<StartupTimings::Event> events = timings.GetCriticalEvents();
+  ASSERT_FALSE(events.empty());
+  EXPECT_LT(events.size(), 1000u);
+  EXPECT_EQ(1000u, events.front().duration_ns);
+  for (size_t i = 1; i < events.size(); ++i) {
+    EXPECT_EQ(events[i - 1].duration_ns - 1u, events[i].duration_ns);
+  }
+  timings.Finish();
+}
+
+}  // namespace art
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stats_region.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include "android-base/stringprintf.h"
+#include "android-base/unique_fd.h"
+
+#include "base/bit_utils.h"
+#include "base/logging.h"
+#include "base/time_utils.h"
+#include "globals.h"
+#include "mem_map.h"
+
+namespace art {
+
+using android::base::StringPrintf;
+
+static_assert(sizeof(Atomic<uint64_t>) == sizeof(uint64_t), "Unexpected Atomic<uint64_t> size");
+
+std::unique_ptr<StatsRegion> StatsRegion::Create(const std::string& filename,
+                                                 std::string* error_msg) {
+  android::base::unique_fd fd(
+      open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+  if (fd.get() == -1) {
+    *error_msg = StringPrintf("Failed to open stats region file '%s': %s",
+                              filename.c_str(),
+                              strerror(errno));
+    return nullptr;
+  }
+  const size_t size = RoundUp(sizeof(Data), kPageSize);
+  if (ftruncate(fd.get(), size) != 0) {
+    *error_msg = StringPrintf("Failed to size stats region file '%s': %s",
+                              filename.c_str(),
+                              strerror(errno));
+    return nullptr;
+  }
+  MemMap* map = MemMap::MapFile(size,
+                                PROT_READ | PROT_WRITE,
+                                MAP_SHARED,
+                                fd.get(),
+                                /* start */ 0,
+                                /* low_4gb */ false,
+                                filename.c_str(),
+                                error_msg);
+  if (map == nullptr) {
+    return nullptr;
+  }
+  // The mapping stays valid once the file descriptor is closed.
+  return std::unique_ptr<StatsRegion>(new StatsRegion(map));
+}
+
+StatsRegion::StatsRegion(MemMap* map)
+    : map_(map),
+      data_(new (map->Begin()) Data()) {
+  data_->version = kVersion;
+  data_->size = sizeof(Data);
+  data_->pid = static_cast<uint32_t>(getpid());
+  // Write the magic last, so that an agent seeing it sees the rest of the header.
+  std::atomic_thread_fence(std::memory_order_release);
+  data_->magic = kMagic;
+}
+
+StatsRegion::~StatsRegion() {}
+
+size_t StatsRegion::PauseHistogramBucket(uint64_t pause_ns) {
+  const uint64_t pause_us = pause_ns / 1000u;
+  if (pause_us == 0u) {
+    return 0u;
+  }
+  return std::min<size_t>(MinimumBitsToStore(pause_us), kPauseHistogramBuckets - 1u);
+}
+
+void StatsRegion::PublishGc(gc::GcCause cause,
+                            gc::collector::GcType type,
+                            uint64_t duration_ns,
+                            const std::vector<uint64_t>& pause_times,
+                            uint64_t freed_bytes,
+                            uint64_t bytes_allocated,
+                            uint64_t total_memory,
+                            uint64_t max_memory,
+                            uint64_t bytes_allocated_ever,
+                            uint64_t bytes_freed_ever) {
+  DCHECK_LT(static_cast<size_t>(type), static_cast<size_t>(gc::collector::kGcTypeMax));
+  // There is a single writer, so relaxed read-modify-writes are enough. The fences order
+  // the field writes between the two odd and even values of the sequence.
+  const uint64_t sequence = data_->gc_sequence.LoadRelaxed();
+  data_->gc_sequence.StoreRelaxed(sequence + 1u);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  data_->gc_count.FetchAndAddRelaxed(1u);
+  data_->gc_time_ns.FetchAndAddRelaxed(duration_ns);
+  data_->gc_count_by_type[type].FetchAndAddRelaxed(1u);
+  data_->gc_time_ns_by_type[type].FetchAndAddRelaxed(duration_ns);
+  data_->last_gc_cause.StoreRelaxed(static_cast<uint64_t>(cause));
+  data_->last_gc_type.StoreRelaxed(static_cast<uint64_t>(type));
+  data_->last_gc_end_ns.StoreRelaxed(NanoTime());
+  data_->last_gc_freed_bytes.StoreRelaxed(freed_bytes);
+  uint64_t max_pause_ns = data_->max_pause_ns.LoadRelaxed();
+  for (uint64_t pause_ns : pause_times) {
+    data_->pause_count.FetchAndAddRelaxed(1u);
+    data_->pause_time_ns.FetchAndAddRelaxed(pause_ns);
+    data_->pause_histogram[PauseHistogramBucket(pause_ns)].FetchAndAddRelaxed(1u);
+    data_->last_pause_ns.StoreRelaxed(pause_ns);
+    max_pause_ns = std::max(max_pause_ns, pause_ns);
+  }
+  data_->max_pause_ns.StoreRelaxed(max_pause_ns);
+  data_->bytes_allocated.StoreRelaxed(bytes_allocated);
+  data_->total_memory.StoreRelaxed(total_memory);
+  data_->max_memory.StoreRelaxed(max_memory);
+  data_->bytes_allocated_ever.StoreRelaxed(bytes_allocated_ever);
+  data_->bytes_freed_ever.StoreRelaxed(bytes_freed_ever);
+
+  data_->gc_sequence.StoreRelease(sequence + 2u);
+}
+
+void StatsRegion::PublishJitEnqueued(size_t queue_length) {
+  data_->jit_enqueued_count.FetchAndAddRelaxed(1u);
+  data_->jit_queue_length.StoreRelaxed(queue_length);
+}
+
+void StatsRegion::PublishJitDequeued(size_t queue_length) {
+  data_->jit_queue_length.StoreRelaxed(queue_length);
+}
+
+void StatsRegion::PublishJitCompiled(bool success) {
+  if (success) {
+    data_->jit_compiled_count.FetchAndAddRelaxed(1u);
+  } else {
+    data_->jit_failed_count.FetchAndAddRelaxed(1u);
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_STATS_REGION_H_
+#define ART_RUNTIME_STATS_REGION_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/atomic.h"
+#include "base/macros.h"
+#include "gc/collector/gc_type.h"
+#include "gc/gc_cause.h"
+
+namespace art {
+
+class MemMap;
+
+// Counters of the GC and the JIT published in a file mapped shared, enabled with
+// -XX:StatsRegionFile=<filename>. An external agent maps the file read-only and polls it,
+// without signals or a debugger connection. See `Data` for the layout.
+class StatsRegion {
+ public:
+  static constexpr uint32_t kMagic = 0x73747261;  // "arts" in a little-endian dump.
+  static constexpr uint32_t kVersion = 1u;
+  // Bucket i > 0 of the pause histogram counts the pauses of [2^(i-1), 2^i) microseconds,
+  // bucket 0 the pauses under a microsecond. The last bucket has no upper bound.
+  static constexpr size_t kPauseHistogramBuckets = 24u;
+
+  // The layout of the file. New fields go at the end, and bump kVersion. All the counters
+  // are 64-bit, so that an agent of another bitness reads the same layout.
+  //
+  // The GC fields are only written at the end of a GC, by the thread that ran it, and an
+  // agent takes a consistent snapshot of them with `gc_sequence`: it reads the sequence,
+  // the fields, then the sequence again, and retries if it changed or is odd. The JIT
+  // fields are independent counters, written by the compiling threads at any time.
+  struct Data {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;  // sizeof(Data) of the version that wrote the file.
+    uint32_t pid;
+
+    Atomic<uint64_t> gc_sequence;
+    Atomic<uint64_t> gc_count;
+    Atomic<uint64_t> gc_time_ns;
+    // Per gc::collector::GcType, the GCs and their time: sticky, young, partial, full.
+    Atomic<uint64_t> gc_count_by_type[gc::collector::kGcTypeMax];
+    Atomic<uint64_t> gc_time_ns_by_type[gc::collector::kGcTypeMax];
+    Atomic<uint64_t> last_gc_cause;  // gc::GcCause
+    Atomic<uint64_t> last_gc_type;  // gc::collector::GcType
+    Atomic<uint64_t> last_gc_end_ns;  // CLOCK_MONOTONIC.
+    Atomic<uint64_t> last_gc_freed_bytes;
+    Atomic<uint64_t> pause_count;
+    Atomic<uint64_t> pause_time_ns;
+    Atomic<uint64_t> max_pause_ns;
+    Atomic<uint64_t> last_pause_ns;
+    Atomic<uint64_t> pause_histogram[kPauseHistogramBuckets];
+    // Heap occupancy after the last GC. The allocation rate is the difference of
+    // `bytes_allocated_ever` between two GCs, over the difference of `last_gc_end_ns`.
+    Atomic<uint64_t> bytes_allocated;
+    Atomic<uint64_t> total_memory;
+    Atomic<uint64_t> max_memory;
+    Atomic<uint64_t> bytes_allocated_ever;
+    Atomic<uint64_t> bytes_freed_ever;
+
+    Atomic<uint64_t> jit_queue_length;
+    Atomic<uint64_t> jit_enqueued_count;
+    Atomic<uint64_t> jit_compiled_count;
+    Atomic<uint64_t> jit_failed_count;
+  };
+
+  // Create the file, or truncate it, and map it. Returns null on failure.
+  static std::unique_ptr<StatsRegion> Create(const std::string& filename, std::string* error_msg);
+
+  ~StatsRegion();
+
+  // Publish a finished GC and the heap occupancy after it. Called by one thread at a time.
+  void PublishGc(gc::GcCause cause,
+                 gc::collector::GcType type,
+                 uint64_t duration_ns,
+                 const std::vector<uint64_t>& pause_times,
+                 uint64_t freed_bytes,
+                 uint64_t bytes_allocated,
+                 uint64_t total_memory,
+                 uint64_t max_memory,
+                 uint64_t bytes_allocated_ever,
+                 uint64_t bytes_freed_ever);
+
+  // Publish the queuing of a JIT compilation, and the length of the queue after it.
+  void PublishJitEnqueued(size_t queue_length);
+  // Publish the start of a queued JIT compilation, and the length of the queue after it.
+  void PublishJitDequeued(size_t queue_length);
+  // Publish the result of a JIT compilation.
+  void PublishJitCompiled(bool success);
+
+  const Data* GetData() const {
+    return data_;
+  }
+
+  static size_t PauseHistogramBucket(uint64_t pause_ns);
+
+ private:
+  explicit StatsRegion(MemMap* map);
+
+  std::unique_ptr<MemMap> map_;
+  Data* const data_;
+
+  DISALLOW_COPY_AND_ASSIGN(StatsRegion);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_STATS_REGION_H_
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stats_region.h"
+
+#include <string.h>
+
+#include "android-base/file.h"
+
+#include "common_runtime_test.h"
+
+namespace art {
+
+class StatsRegionTest : public CommonRuntimeTest {};
+
+TEST_F(StatsRegionTest, PauseHistogramBucket) {
+  EXPECT_EQ(0u, StatsRegion::PauseHistogramBucket(999u));
+  EXPECT_EQ(1u, StatsRegion::PauseHistogramBucket(1000u));
+  EXPECT_EQ(2u, StatsRegion::PauseHistogramBucket(2000u));
+  EXPECT_EQ(2u, StatsRegion::PauseHistogramBucket(3999u));
+  EXPECT_EQ(3u, StatsRegion::PauseHistogramBucket(4000u));
+  EXPECT_EQ(StatsRegion::kPauseHistogramBuckets - 1u,
+            StatsRegion::PauseHistogramBucket(UINT64_C(1) << 62));
+}
+
+TEST_F(StatsRegionTest, PublishGc) {
+  ScratchFile file;
+  std::string error_msg;
+  std::unique_ptr<StatsRegion> region = StatsRegion::Create(file.GetFilename(), &error_msg);
+  ASSERT_TRUE(region != nullptr) << error_msg;
+  const StatsRegion::Data* data = region->GetData();
+  EXPECT_EQ(StatsRegion::kMagic, data->magic);
+  EXPECT_EQ(StatsRegion::kVersion, data->version);
+  EXPECT_EQ(sizeof(StatsRegion::Data), data->size);
+
+  region->PublishGc(gc::kGcCauseForAlloc,
+                    gc::collector::kGcTypeSticky,
+                    /* duration_ns */ 5000000u,
+                    /* pause_times */ {1500u, 30000u},
+                    /* freed_bytes */ 1024u,
+                    /* bytes_allocated */ 4096u,
+                    /* total_memory */ 8192u,
+                    /* max_memory */ 65536u,
+                    /* bytes_allocated_ever */ 5120u,
+                    /* bytes_freed_ever */ 1024u);
+  region->PublishGc(gc::kGcCauseBackground,
+                    gc::collector::kGcTypeFull,
+                    /* duration_ns */ 7000000u,
+                    /* pause_times */ {500u},
+                    /* freed_bytes */ 2048u,
+                    /* bytes_allocated */ 2048u,
+                    /* total_memory */ 8192u,
+                    /* max_memory */ 65536u,
+                    /* bytes_allocated_ever */ 5120u,
+                    /* bytes_freed_ever */ 3072u);
+  EXPECT_EQ(4u, data->gc_sequence.LoadRelaxed());
+  EXPECT_EQ(2u, data->gc_count.LoadRelaxed());
+  EXPECT_EQ(12000000u, data->gc_time_ns.LoadRelaxed());
+  EXPECT_EQ(1u, data->gc_count_by_type[gc::collector::kGcTypeSticky].LoadRelaxed());
+  EXPECT_EQ(7000000u, data->gc_time_ns_by_type[gc::collector::kGcTypeFull].LoadRelaxed());
+  EXPECT_EQ(static_cast<uint64_t>(gc::kGcCauseBackground), data->last_gc_cause.LoadRelaxed());
+  EXPECT_EQ(3u, data->pause_count.LoadRelaxed());
+  EXPECT_EQ(32000u, data->pause_time_ns.LoadRelaxed());
+  EXPECT_EQ(30000u, data->max_pause_ns.LoadRelaxed());
+  EXPECT_EQ(500u, data->last_pause_ns.LoadRelaxed());
+  EXPECT_EQ(1u, data->pause_histogram[0].LoadRelaxed());
+  EXPECT_EQ(1u, data->pause_histogram[1].LoadRelaxed());
+  EXPECT_EQ(1u, data->pause_histogram[5].LoadRelaxed());
+  EXPECT_EQ(2048u, data->bytes_allocated.LoadRelaxed());
+  EXPECT_EQ(3072u, data->bytes_freed_ever.LoadRelaxed());
+
+  region->PublishJitEnqueued(1u);
+  region->PublishJitEnqueued(2u);
+  region->PublishJitDequeued(1u);
+  region->PublishJitCompiled(/* success */ true);
+  EXPECT_EQ(1u, data->jit_queue_length.LoadRelaxed());
+  EXPECT_EQ(2u, data->jit_enqueued_count.LoadRelaxed());
+  EXPECT_EQ(1u, data->jit_compiled_count.LoadRelaxed());
+  EXPECT_EQ(0u, data->jit_failed_count.LoadRelaxed());
+
+  // The counters are visible to other readers of the file.
+  std::string contents;
+  ASSERT_TRUE(android::base::ReadFileToString(file.GetFilename(), &contents));
+  ASSERT_GE(contents.size(), sizeof(StatsRegion::Data));
+  uint32_t magic;
+  memcpy(&magic, contents.data(), sizeof(magic));
+  EXPECT_EQ(StatsRegion::kMagic, magic);
+  uint64_t gc_count;
+  memcpy(&gc_count, contents.data() + offsetof(StatsRegion::Data, gc_count), sizeof(gc_count));
+  EXPECT_EQ(2u, gc_count);
+}
+
+}  // namespace art
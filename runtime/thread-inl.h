@@ -308,6 +308,14 @@ inline mirror::Object* Thread::AllocTlab(size_t bytes) {
   return ret;
 }
 
+inline mirror::Object* Thread::AllocTlabObjects(size_t bytes, size_t count) {
+  DCHECK_GE(TlabSize() / bytes, count);
+  tlsPtr_.thread_local_objects += count;
+  mirror::Object* ret = reinterpret_cast<mirror::Object*>(tlsPtr_.thread_local_pos);
+  tlsPtr_.thread_local_pos += bytes * count;
+  return ret;
+}
+
 inline void Thread::RollBackTlab(size_t bytes) {
   --tlsPtr_.thread_local_objects;
   tlsPtr_.thread_local_pos -= bytes;
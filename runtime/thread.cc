@@ -29,6 +29,7 @@
 #include <bitset>
 #include <cerrno>
 #include <iostream>
+#include <limits>
 #include <list>
 #include <sstream>
 
@@ -43,6 +44,7 @@
 #include "base/memory_tool.h"
 #include "base/mutex.h"
 #include "base/systrace.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "base/to_str.h"
 #include "base/utils.h"
@@ -52,6 +54,7 @@
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_annotations.h"
 #include "dex/dex_file_types.h"
+#include "entrypoints/entrypoint_utils-inl.h"
 #include "entrypoints/entrypoint_utils.h"
 #include "entrypoints/quick/quick_alloc_entrypoints.h"
 #include "gc/accounting/card_table-inl.h"
@@ -66,6 +69,8 @@
 #include "interpreter/shadow_frame.h"
 #include "java_frame_root_info.h"
 #include "java_vm_ext.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
 #include "jni_internal.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
@@ -1286,6 +1291,10 @@ bool Thread::ModifySuspendCountInternal(Thread* self,
   return true;
 }
 
+size_t Thread::SafepointStats::BucketOf(uint64_t time_ns) {
+  return std::min(MinimumBitsToStore(time_ns / 1000u), kNumBuckets - 1u);
+}
+
 bool Thread::PassActiveSuspendBarriers(Thread* self) {
   // Grab the suspend_count lock and copy the current set of
   // barriers. Then clear the list and the flag. The ModifySuspendCount
@@ -1310,6 +1319,12 @@ bool Thread::PassActiveSuspendBarriers(Thread* self) {
       tlsPtr_.active_suspend_barriers[i] = nullptr;
     }
     AtomicClearFlag(kActiveSuspendBarrier);
+    if (safepoint_stats_.request_time_ns != 0u) {
+      uint64_t time_ns = NanoTime() - safepoint_stats_.request_time_ns;
+      safepoint_stats_.request_time_ns = 0u;
+      safepoint_stats_.max_time_ns = std::max(safepoint_stats_.max_time_ns, time_ns);
+      ++safepoint_stats_.buckets[SafepointStats::BucketOf(time_ns)];
+    }
   }
 
   uint32_t barrier_count = 0;
@@ -2495,6 +2510,112 @@ class FetchStackTraceVisitor : public StackVisitor {
   DISALLOW_COPY_AND_ASSIGN(FetchStackTraceVisitor);
 };
 
+// The methods of the frames recorded by their return PC are tagged in internal stack traces.
+static constexpr uintptr_t kRawStackTraceFrameTag = 1u;
+
+// Visit the methods and dex PCs of the frame of the optimized code `method_header` of `method` at
+// `pc`. The inlined methods come first, as in a stack walk.
+template <typename Visitor>
+static void VisitOptimizedFrameDexPcs(ArtMethod* method,
+                                      const OatQuickMethodHeader* method_header,
+                                      uintptr_t pc,
+                                      const Visitor& visitor)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  DCHECK(method_header->IsOptimized());
+  CodeInfo code_info = method_header->GetOptimizedCodeInfo();
+  CodeInfoEncoding encoding = code_info.ExtractEncoding();
+  StackMap stack_map =
+      code_info.GetStackMapForNativePcOffset(method_header->NativeQuickPcOffset(pc), encoding);
+  if (!stack_map.IsValid()) {
+    visitor(method, dex::kDexNoIndex);
+    return;
+  }
+  if (stack_map.HasInlineInfo(encoding.stack_map.encoding)) {
+    InlineInfo inline_info = code_info.GetInlineInfoOf(stack_map, encoding);
+    MethodInfo method_info = method_header->GetOptimizedMethodInfo();
+    for (uint32_t depth = inline_info.GetDepth(encoding.inline_info.encoding);
+         depth != 0u;
+         --depth) {
+      ArtMethod* inlined_method = GetResolvedMethod(method,
+                                                    method_info,
+                                                    inline_info,
+                                                    encoding.inline_info.encoding,
+                                                    depth - 1u);
+      visitor(inlined_method,
+              inline_info.GetDexPcAtDepth(encoding.inline_info.encoding, depth - 1u));
+    }
+  }
+  visitor(method, stack_map.GetDexPc(encoding.stack_map.encoding));
+}
+
+// Collects the frames of a stack trace for CreateRawInternalStackTrace. The frames of
+// AOT-compiled code are recorded by their outer method and return PC. The frames of the
+// interpreter, of JIT-compiled code, which may be collected before the stack trace is converted,
+// and the frames up to the exception's constructor are decoded now.
+class FetchRawStackTraceVisitor : public StackVisitor {
+ public:
+  struct Frame {
+    ArtMethod* method;
+    // The dex PC, or the return PC of a raw frame.
+    uintptr_t pc;
+    bool raw;
+  };
+
+  FetchRawStackTraceVisitor(Thread* thread, size_t max_depth)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      : StackVisitor(thread, nullptr, StackVisitor::StackWalkKind::kSkipInlinedFrames),
+        max_depth_(max_depth != 0u ? max_depth : std::numeric_limits<size_t>::max()),
+        jit_(Runtime::Current()->GetJit()) {}
+
+  bool VisitFrame() REQUIRES_SHARED(Locks::mutator_lock_) {
+    ArtMethod* m = GetMethod();
+    if (m->IsRuntimeMethod()) {
+      return true;  // Ignore runtime frames (in particular callee save).
+    }
+    const OatQuickMethodHeader* method_header =
+        IsShadowFrame() ? nullptr : GetCurrentOatQuickMethodHeader();
+    if (method_header == nullptr || !method_header->IsOptimized()) {
+      AddFrame(m, m->IsProxyMethod() ? dex::kDexNoIndex : GetDexPc());
+    } else if (!skipping_ &&
+               (jit_ == nullptr || !jit_->GetCodeCache()->ContainsPc(method_header->GetCode()))) {
+      frames_.push_back(Frame { m, GetCurrentQuickFramePc(), /* raw */ true });
+    } else {
+      VisitOptimizedFrameDexPcs(m,
+                                method_header,
+                                GetCurrentQuickFramePc(),
+                                [&](ArtMethod* method, uint32_t dex_pc)
+                                    REQUIRES_SHARED(Locks::mutator_lock_) {
+        AddFrame(method, dex_pc);
+      });
+    }
+    return frames_.size() < max_depth_;
+  }
+
+  const std::vector<Frame>& GetFrames() const {
+    return frames_;
+  }
+
+ private:
+  void AddFrame(ArtMethod* method, uint32_t dex_pc) REQUIRES_SHARED(Locks::mutator_lock_) {
+    // We want to skip frames up to and including the exception's constructor.
+    if (skipping_ &&
+        mirror::Throwable::GetJavaLangThrowable()->IsAssignableFrom(method->GetDeclaringClass())) {
+      return;
+    }
+    skipping_ = false;
+    if (frames_.size() < max_depth_) {
+      frames_.push_back(Frame { method, dex_pc, /* raw */ false });
+    }
+  }
+
+  const size_t max_depth_;
+  jit::Jit* const jit_;
+  bool skipping_ = true;
+  std::vector<Frame> frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(FetchRawStackTraceVisitor);
+};
+
 template<bool kTransactionActive>
 class BuildInternalStackTraceVisitor : public StackVisitor {
  public:
@@ -2570,6 +2691,22 @@ class BuildInternalStackTraceVisitor : public StackVisitor {
     ++count_;
   }
 
+  // Add a frame of AOT-compiled code recorded by its return PC, see CreateRawInternalStackTrace.
+  void AddRawFrame(ArtMethod* method, uintptr_t return_pc) REQUIRES_SHARED(Locks::mutator_lock_) {
+    ObjPtr<mirror::PointerArray> trace_methods_and_pcs = GetTraceMethodsAndPCs();
+    DCHECK_EQ(reinterpret_cast<uintptr_t>(method) & kRawStackTraceFrameTag, 0u);
+    trace_methods_and_pcs->SetElementPtrSize<kTransactionActive>(
+        count_,
+        reinterpret_cast<uintptr_t>(method) | kRawStackTraceFrameTag,
+        pointer_size_);
+    trace_methods_and_pcs->SetElementPtrSize<kTransactionActive>(
+        trace_methods_and_pcs->GetLength() / 2 + count_,
+        return_pc,
+        pointer_size_);
+    trace_->Set(count_ + 1, method->GetDeclaringClass());
+    ++count_;
+  }
+
   ObjPtr<mirror::PointerArray> GetTraceMethodsAndPCs() const REQUIRES_SHARED(Locks::mutator_lock_) {
     return ObjPtr<mirror::PointerArray>::DownCast(MakeObjPtr(trace_->Get(0)));
   }
@@ -2641,6 +2778,60 @@ template jobject Thread::CreateInternalStackTrace<false>(
 template jobject Thread::CreateInternalStackTrace<true>(
     const ScopedObjectAccessAlreadyRunnable& soa) const;
 
+jobject Thread::CreateRawInternalStackTrace(const ScopedObjectAccessAlreadyRunnable& soa,
+                                            size_t max_depth) const {
+  FetchRawStackTraceVisitor fetch_visitor(const_cast<Thread*>(this), max_depth);
+  fetch_visitor.WalkStack();
+  const std::vector<FetchRawStackTraceVisitor::Frame>& frames = fetch_visitor.GetFrames();
+
+  // The frames are those of this thread, so that their classes stay loaded until they are added
+  // to the trace.
+  BuildInternalStackTraceVisitor<false> build_trace_visitor(soa.Self(),
+                                                            const_cast<Thread*>(this),
+                                                            /* skip_depth */ 0);
+  if (!build_trace_visitor.Init(frames.size())) {
+    return nullptr;  // Allocation failed.
+  }
+  for (const FetchRawStackTraceVisitor::Frame& frame : frames) {
+    if (frame.raw) {
+      build_trace_visitor.AddRawFrame(frame.method, frame.pc);
+    } else {
+      build_trace_visitor.AddFrame(frame.method, static_cast<uint32_t>(frame.pc));
+    }
+  }
+  return soa.AddLocalReference<jobject>(build_trace_visitor.GetInternalStackTrace());
+}
+
+void Thread::DecodeInternalStackTrace(ObjPtr<mirror::PointerArray> methods_and_pcs,
+                                      std::vector<std::pair<ArtMethod*, uint32_t>>* frames) {
+  // The same pointer size as BuildInternalStackTraceVisitor, for cross compilation.
+  const PointerSize pointer_size = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
+  const int32_t depth = methods_and_pcs->GetLength() / 2;
+  frames->reserve(frames->size() + depth);
+  for (int32_t i = 0; i < depth; ++i) {
+    uintptr_t method_bits = methods_and_pcs->GetElementPtrSize<uintptr_t>(i, pointer_size);
+    uintptr_t pc = methods_and_pcs->GetElementPtrSize<uintptr_t>(i + depth, pointer_size);
+    ArtMethod* method = reinterpret_cast<ArtMethod*>(method_bits & ~kRawStackTraceFrameTag);
+    if ((method_bits & kRawStackTraceFrameTag) == 0u) {
+      frames->emplace_back(method, static_cast<uint32_t>(pc));
+      continue;
+    }
+    // The AOT code of the method stays loaded with its class, which the trace keeps alive.
+    const OatQuickMethodHeader* method_header = method->GetOatQuickMethodHeader(pc, true);
+    if (method_header == nullptr || !method_header->IsOptimized() || !method_header->Contains(pc)) {
+      frames->emplace_back(method, dex::kDexNoIndex);
+      continue;
+    }
+    VisitOptimizedFrameDexPcs(method,
+                              method_header,
+                              pc,
+                              [&](ArtMethod* frame_method, uint32_t dex_pc)
+                                  REQUIRES_SHARED(Locks::mutator_lock_) {
+      frames->emplace_back(frame_method, dex_pc);
+    });
+  }
+}
+
 bool Thread::IsExceptionThrownByCurrentMethod(ObjPtr<mirror::Throwable> exception) const {
   // Only count the depth since we do not pass a stack frame array as an argument.
   FetchStackTraceVisitor count_visitor(const_cast<Thread*>(this));
@@ -2708,10 +2899,18 @@ jobjectArray Thread::InternalStackTraceToStackTraceElementArray(
     jobject internal,
     jobjectArray output_array,
     int* stack_depth) {
-  // Decode the internal stack trace into the depth, method trace and PC trace.
-  // Subtract one for the methods and PC trace.
-  int32_t depth = soa.Decode<mirror::Array>(internal)->GetLength() - 1;
-  DCHECK_GE(depth, 0);
+  // Decode the internal stack trace into the methods and dex PCs of its frames. The methods do
+  // not move, and the trace keeps their classes loaded.
+  std::vector<ArtMethodDexPcPair> frames;
+  {
+    ObjPtr<mirror::ObjectArray<mirror::Object>> decoded_traces =
+        soa.Decode<mirror::Object>(internal)->AsObjectArray<mirror::Object>();
+    // Methods and dex PC trace is element 0.
+    DCHECK(decoded_traces->Get(0)->IsIntArray() || decoded_traces->Get(0)->IsLongArray());
+    DecodeInternalStackTrace(
+        ObjPtr<mirror::PointerArray>::DownCast(MakeObjPtr(decoded_traces->Get(0))), &frames);
+  }
+  int32_t depth = static_cast<int32_t>(frames.size());
 
   ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
 
@@ -2739,16 +2938,9 @@ jobjectArray Thread::InternalStackTraceToStackTraceElementArray(
   }
 
   for (int32_t i = 0; i < depth; ++i) {
-    ObjPtr<mirror::ObjectArray<mirror::Object>> decoded_traces =
-        soa.Decode<mirror::Object>(internal)->AsObjectArray<mirror::Object>();
-    // Methods and dex PC trace is element 0.
-    DCHECK(decoded_traces->Get(0)->IsIntArray() || decoded_traces->Get(0)->IsLongArray());
-    ObjPtr<mirror::PointerArray> const method_trace =
-        ObjPtr<mirror::PointerArray>::DownCast(MakeObjPtr(decoded_traces->Get(0)));
     // Prepare parameters for StackTraceElement(String cls, String method, String file, int line)
-    ArtMethod* method = method_trace->GetElementPtrSize<ArtMethod*>(i, kRuntimePointerSize);
-    uint32_t dex_pc = method_trace->GetElementPtrSize<uint32_t>(
-        i + method_trace->GetLength() / 2, kRuntimePointerSize);
+    ArtMethod* method = frames[i].first;
+    uint32_t dex_pc = frames[i].second;
     ObjPtr<mirror::StackTraceElement> obj = CreateStackTraceElement(soa, method, dex_pc);
     if (obj == nullptr) {
       return nullptr;
@@ -3143,6 +3335,7 @@ void Thread::DumpThreadOffset(std::ostream& os, uint32_t offset) {
   DO_THREAD_OFFSET(StackEndOffset<ptr_size>(), "stack_end")
   DO_THREAD_OFFSET(ThinLockIdOffset<ptr_size>(), "thin_lock_thread_id")
   DO_THREAD_OFFSET(IsGcMarkingOffset<ptr_size>(), "is_gc_marking")
+  DO_THREAD_OFFSET(WeakRefAccessEnabledOffset<ptr_size>(), "weak_ref_access_enabled")
   DO_THREAD_OFFSET(TopOfManagedStackOffset<ptr_size>(), "top_quick_frame_method")
   DO_THREAD_OFFSET(TopShadowFrameOffset<ptr_size>(), "top_shadow_frame")
   DO_THREAD_OFFSET(TopHandleScopeOffset<ptr_size>(), "top_handle_scope")
@@ -3319,6 +3512,7 @@ void Thread::DumpThreadOffset(std::ostream& os, uint32_t offset) {
   QUICK_ENTRY_POINT_INFO(pReadBarrierMarkReg29)
   QUICK_ENTRY_POINT_INFO(pReadBarrierSlow)
   QUICK_ENTRY_POINT_INFO(pReadBarrierForRootSlow)
+  QUICK_ENTRY_POINT_INFO(pCompileOptimized)
 
   QUICK_ENTRY_POINT_INFO(pJniMethodFastStart)
   QUICK_ENTRY_POINT_INFO(pJniMethodFastEnd)
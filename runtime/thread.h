@@ -25,6 +25,8 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "arch/context.h"
 #include "arch/instruction_set.h"
@@ -37,10 +39,13 @@
 #include "globals.h"
 #include "handle_scope.h"
 #include "instrumentation.h"
+#include "frame_info_cache.h"
+#include "interpreter/interpreter_cache.h"
 #include "jvalue.h"
 #include "managed_stack.h"
 #include "offsets.h"
 #include "read_barrier_config.h"
+#include "reflective_access_cache.h"
 #include "runtime_stats.h"
 #include "suspend_reason.h"
 #include "thread_state.h"
@@ -64,6 +69,7 @@ class Class;
 class ClassLoader;
 class Object;
 template<class T> class ObjectArray;
+class PointerArray;
 template<class T> class PrimitiveArray;
 typedef PrimitiveArray<int32_t> IntArray;
 class StackTraceElement;
@@ -87,6 +93,7 @@ class DexFile;
 class FrameIdToShadowFrame;
 class JavaVMExt;
 class JNIEnvExt;
+class LinearAlloc;
 class Monitor;
 class RootVisitor;
 class ScopedObjectAccessAlreadyRunnable;
@@ -611,6 +618,21 @@ class Thread {
   jobject CreateInternalStackTrace(const ScopedObjectAccessAlreadyRunnable& soa) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Create the internal representation of a stack trace like CreateInternalStackTrace, but only
+  // record the return PCs of the frames of AOT-compiled code, which are decoded to their inlined
+  // methods and dex PCs when the stack trace is converted. Record at most `max_depth` frames if
+  // it is not 0.
+  jobject CreateRawInternalStackTrace(const ScopedObjectAccessAlreadyRunnable& soa,
+                                      size_t max_depth) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Decode the methods and dex PCs of the first element of an internal stack trace, decoding the
+  // frames recorded by CreateRawInternalStackTrace.
+  static void DecodeInternalStackTrace(
+      ObjPtr<mirror::PointerArray> methods_and_pcs,
+      /* out */ std::vector<std::pair<ArtMethod*, uint32_t>>* frames)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Convert an internal stack trace representation (returned by CreateInternalStackTrace) to a
   // StackTraceElement[]. If output_array is null, a new array is created, otherwise as many
   // frames as will fit are written into the given array. If stack_depth is non-null, it's updated
@@ -668,6 +690,13 @@ class Thread {
         OFFSETOF_MEMBER(tls_32bit_sized_values, is_gc_marking));
   }
 
+  template<PointerSize pointer_size>
+  static ThreadOffset<pointer_size> WeakRefAccessEnabledOffset() {
+    return ThreadOffset<pointer_size>(
+        OFFSETOF_MEMBER(Thread, tls32_) +
+        OFFSETOF_MEMBER(tls_32bit_sized_values, weak_ref_access_enabled));
+  }
+
   static constexpr size_t IsGcMarkingSize() {
     return sizeof(tls32_.is_gc_marking);
   }
@@ -1137,6 +1166,9 @@ class Thread {
 
   // Doesn't check that there is room.
   mirror::Object* AllocTlab(size_t bytes);
+  // Allocate `count` consecutive objects of `bytes` each, returns the first one. Doesn't check
+  // that there is room.
+  mirror::Object* AllocTlabObjects(size_t bytes, size_t count);
   void RollBackTlab(size_t bytes);
   void SetTlab(uint8_t* start, uint8_t* end, uint8_t* limit);
   bool HasTlab() const;
@@ -1150,6 +1182,86 @@ class Thread {
     return tlsPtr_.thread_local_pos;
   }
 
+  // State of the adaptive TLAB sizing of the thread, see Heap::GetTlabRefillSize. Only used by
+  // the thread itself, on the TLAB refills.
+  struct TlabSizing {
+    // The size of the next TLAB refills, 0 until the first refill.
+    size_t refill_size = 0;
+    // The bytes of TLAB refills since the GC count `gc_count`.
+    size_t refill_bytes = 0;
+    uint32_t gc_count = 0;
+  };
+  TlabSizing* GetTlabSizing() {
+    return &tlab_sizing_;
+  }
+
+  // State of the identity hash code generator of the thread, see
+  // mirror::Object::GenerateIdentityHashCode. 0 until the thread generates its first hash code.
+  uint32_t* GetIdentityHashSeed() {
+    return &identity_hash_seed_;
+  }
+
+  // The chunk of the LinearAlloc `owner` that the thread bumps its small allocations from, see
+  // LinearAlloc::AllocThreadLocal. Only the thread itself uses it.
+  struct LinearAllocChunk {
+    const LinearAlloc* owner = nullptr;
+    uint8_t* pos = nullptr;
+    uint8_t* end = nullptr;
+  };
+  LinearAllocChunk* GetLinearAllocChunk() {
+    return &linear_alloc_chunk_;
+  }
+
+  // Fields and methods resolved by the instructions run in the switch interpreter by the thread.
+  interpreter::InterpreterCache* GetInterpreterCache() {
+    return &interpreter_cache_;
+  }
+
+  // Method headers and inline depths of the quick frames seen by the stack walks of the thread.
+  FrameInfoCache* GetFrameInfoCache() {
+    return &frame_info_cache_;
+  }
+
+  // Access checks passed by the reflective calls of the thread.
+  ReflectiveAccessCache* GetReflectiveAccessCache() {
+    return &reflective_access_cache_;
+  }
+
+  // Streaming method trace packets of the thread not written to the trace yet, see Trace.
+  std::vector<uint8_t>* GetMethodTraceBuffer() {
+    return &method_trace_buffer_;
+  }
+
+  // State of the allocation sampling of the thread, see Heap::IsAllocationSampled. Only used by
+  // the thread itself, on its instrumented allocations.
+  struct AllocSampling {
+    // The bytes left to allocate before the next sampled allocation.
+    size_t bytes_until_sample = 0;
+    // The state of the random generator of the sampling intervals, 0 until it is seeded.
+    uint64_t random_state = 0;
+  };
+  AllocSampling* GetAllocSampling() {
+    return &alloc_sampling_;
+  }
+
+  // Time taken by the thread to pass the barriers of the suspend-all requests made while it was
+  // runnable, reported by ThreadList::DumpForSigQuit.
+  struct SafepointStats {
+    // Bucket 0 counts the times under 1us, bucket i > 0 those in [2^(i-1)us, 2^i us), and the
+    // last bucket also the longer ones.
+    static constexpr size_t kNumBuckets = 16;
+
+    static size_t BucketOf(uint64_t time_ns);
+
+    // When the pending suspend-all request was made, 0 if there is none.
+    uint64_t request_time_ns = 0;
+    uint64_t max_time_ns = 0;
+    uint32_t buckets[kNumBuckets] = {};
+  };
+  SafepointStats* GetSafepointStats() REQUIRES(Locks::thread_suspend_count_lock_) {
+    return &safepoint_stats_;
+  }
+
   // Remove the suspend trigger for this thread by making the suspend_trigger_ TLS value
   // equal to a valid pointer.
   // TODO: does this need to atomic?  I don't think so.
@@ -1169,6 +1281,12 @@ class Thread {
   bool PushOnThreadLocalAllocationStack(mirror::Object* obj)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Returns how many objects can be pushed onto the thread local allocation stack before it
+  // needs a refill.
+  size_t GetThreadLocalAllocationStackRoom() const {
+    return tlsPtr_.thread_local_alloc_stack_end - tlsPtr_.thread_local_alloc_stack_top;
+  }
+
   // Set the thread local allocation pointers to the given pointers.
   void SetThreadLocalAllocationStack(StackReference<mirror::Object>* start,
                                      StackReference<mirror::Object>* end);
@@ -1751,6 +1869,33 @@ class Thread {
   // Note that it is not in the packed struct, may not be accessed for cross compilation.
   uintptr_t poison_object_cookie_ = 0;
 
+  // Adaptive TLAB sizing, not in the packed struct either.
+  TlabSizing tlab_sizing_;
+
+  // Identity hash code generator, not in the packed struct either.
+  uint32_t identity_hash_seed_ = 0;
+
+  // LinearAlloc chunk, not in the packed struct either.
+  LinearAllocChunk linear_alloc_chunk_;
+
+  // Switch interpreter cache, not in the packed struct either.
+  interpreter::InterpreterCache interpreter_cache_;
+
+  // Stack walk cache, not in the packed struct either.
+  FrameInfoCache frame_info_cache_;
+
+  // Reflective access check cache, not in the packed struct either.
+  ReflectiveAccessCache reflective_access_cache_;
+
+  // Buffered method trace packets, not in the packed struct either.
+  std::vector<uint8_t> method_trace_buffer_;
+
+  // Allocation sampling, not in the packed struct either.
+  AllocSampling alloc_sampling_;
+
+  // Time to safepoint statistics, not in the packed struct either.
+  SafepointStats safepoint_stats_ GUARDED_BY(Locks::thread_suspend_count_lock_);
+
   // Pending extra checkpoints if checkpoint_function_ is already used.
   std::list<Closure*> checkpoint_overflow_ GUARDED_BY(Locks::thread_suspend_count_lock_);
 
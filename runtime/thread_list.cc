@@ -20,6 +20,9 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <functional>
+#include <memory>
 #include <sstream>
 #include <vector>
 
@@ -29,6 +32,7 @@
 #include "nativehelper/scoped_utf_chars.h"
 
 #include "base/aborting.h"
+#include "base/bit_utils.h"
 #include "base/histogram-inl.h"
 #include "base/mutex-inl.h"
 #include "base/systrace.h"
@@ -47,6 +51,7 @@
 #include "native_stack_dump.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread.h"
+#include "thread_pool.h"
 #include "trace.h"
 #include "well_known_classes.h"
 
@@ -58,6 +63,10 @@
 #endif
 #endif  // ART_USE_FUTEXES
 
+#ifdef VTUNE_ART
+#include "vtune_tasks.h"
+#endif
+
 namespace art {
 
 using android::base::StringPrintf;
@@ -153,6 +162,7 @@ void ThreadList::DumpForSigQuit(std::ostream& os) {
       suspend_all_historam_.PrintConfidenceIntervals(os, 0.99, data);  // Dump time to suspend.
     }
   }
+  DumpTimeToSafepoint(os);
   bool dump_native_stack = Runtime::Current()->GetDumpNativeStackOnSigQuit();
   // TODO: (Lin & Lei) Workaround as a temporary fix for ThreadStressLight test fail.
   // Need deep investigation why GenCopy can not work without blocking GC here.
@@ -164,6 +174,59 @@ void ThreadList::DumpForSigQuit(std::ostream& os) {
   DumpUnattachedThreads(os, dump_native_stack && kDumpUnattachedThreadNativeStackForSigQuit);
 }
 
+void ThreadList::DumpTimeToSafepoint(std::ostream& os) {
+  static constexpr size_t kNumBuckets = Thread::SafepointStats::kNumBuckets;
+  static constexpr size_t kMaxSlowestThreads = 5;
+  uint64_t buckets[kNumBuckets] = {};
+  uint64_t num_samples = 0u;
+  // The slowest threads, by their maximal time to safepoint.
+  std::vector<std::pair<uint64_t, std::string>> slowest;
+  {
+    Thread* self = Thread::Current();
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
+    for (Thread* thread : list_) {
+      const Thread::SafepointStats* stats = thread->GetSafepointStats();
+      for (size_t i = 0; i < kNumBuckets; ++i) {
+        buckets[i] += stats->buckets[i];
+        num_samples += stats->buckets[i];
+      }
+      if (stats->max_time_ns != 0u) {
+        std::string name;
+        thread->GetThreadName(name);
+        slowest.emplace_back(stats->max_time_ns,
+                             StringPrintf("\"%s\" tid=%d", name.c_str(), thread->GetTid()));
+      }
+    }
+  }
+  if (num_samples == 0u) {
+    return;
+  }
+  os << "Time to safepoint histogram:";
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    if (buckets[i] == 0u) {
+      continue;
+    }
+    if (i == 0u) {
+      os << " <1us:";
+    } else {
+      os << ((i == kNumBuckets - 1u) ? " >=" : " ") << (UINT64_C(1) << (i - 1u)) << "us:";
+    }
+    os << buckets[i];
+  }
+  os << "\n";
+  size_t num_slowest = std::min(slowest.size(), kMaxSlowestThreads);
+  std::partial_sort(slowest.begin(),
+                    slowest.begin() + num_slowest,
+                    slowest.end(),
+                    std::greater<std::pair<uint64_t, std::string>>());
+  os << "Slowest threads to safepoint:";
+  for (size_t i = 0; i < num_slowest; ++i) {
+    os << " " << slowest[i].second << " max=" << PrettyDuration(slowest[i].first);
+  }
+  os << "\n";
+}
+
 static void DumpUnattachedThread(std::ostream& os, pid_t tid, bool dump_native_stack)
     NO_THREAD_SAFETY_ANALYSIS {
   // TODO: No thread safety analysis as DumpState with a null thread won't access fields, should
@@ -542,6 +605,69 @@ size_t ThreadList::RunCheckpointOnRunnableThreads(Closure* checkpoint_function)
   return count;
 }
 
+// Runs a closure for a slice of the suspended threads, on behalf of the thread that holds the
+// mutator lock until all the slices are done.
+class RunClosureTask FINAL : public Task {
+ public:
+  RunClosureTask(Closure* closure, Thread* const* begin, Thread* const* end)
+      : closure_(closure), begin_(begin), end_(end) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) OVERRIDE NO_THREAD_SAFETY_ANALYSIS {
+    for (Thread* const* it = begin_; it != end_; ++it) {
+      closure_->Run(*it);
+    }
+  }
+
+ private:
+  Closure* const closure_;
+  Thread* const* const begin_;
+  Thread* const* const end_;
+};
+
+// Runs the closure for each of the threads, dividing them among up to `num_workers` workers of
+// `thread_pool` and the calling thread, which takes the first slice.
+static void RunClosureParallel(Closure* closure,
+                               const std::vector<Thread*>& threads,
+                               ThreadPool* thread_pool,
+                               size_t num_workers) {
+  // Only hand threads to the workers in slices large enough to pay for their wake up.
+  static constexpr size_t kMinThreadsPerTask = 16;
+  Thread* self = Thread::Current();
+  num_workers = (thread_pool == nullptr) ? 0u : std::min(num_workers,
+                                                         threads.size() / kMinThreadsPerTask);
+  const size_t num_tasks = num_workers + 1;
+  const size_t task_size = RoundUp(threads.size(), num_tasks) / num_tasks;
+  std::vector<std::unique_ptr<RunClosureTask>> tasks;
+  for (size_t i = 0; i < num_tasks; ++i) {
+    const size_t begin = std::min(i * task_size, threads.size());
+    const size_t end = std::min(begin + task_size, threads.size());
+    tasks.emplace_back(new RunClosureTask(closure, threads.data() + begin, threads.data() + end));
+    if (i != 0) {
+      thread_pool->AddTask(self, tasks.back().get());
+    }
+  }
+  if (num_workers != 0) {
+    thread_pool->SetMaxActiveWorkers(num_workers);
+    thread_pool->StartWorkers(self);
+  }
+  tasks[0]->Run(self);
+  if (num_workers != 0) {
+    thread_pool->Wait(self, /* do_work */ true, /* may_hold_locks */ true);
+    thread_pool->StopWorkers(self);
+  }
+}
+
+// Runs the flip function of a suspended thread, unless it was already run for the thread.
+class RunFlipFunctionClosure FINAL : public Closure {
+ public:
+  void Run(Thread* thread) OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_) {
+    Closure* flip_func = thread->GetFlipFunction();
+    if (flip_func != nullptr) {
+      flip_func->Run(thread);
+    }
+  }
+};
+
 // A checkpoint/suspend-all hybrid to switch thread roots from
 // from-space to to-space refs. Used to synchronize threads at a point
 // to mark the initiation of marking while maintaining the to-space
@@ -617,12 +743,14 @@ size_t ThreadList::FlipThreadRoots(Closure* thread_flip_visitor,
   {
     TimingLogger::ScopedTiming split3("FlipOtherThreads", collector->GetTimings());
     ReaderMutexLock mu(self, *Locks::mutator_lock_);
-    for (const auto& thread : other_threads) {
-      Closure* flip_func = thread->GetFlipFunction();
-      if (flip_func != nullptr) {
-        flip_func->Run(thread);
-      }
-    }
+    // The flip functions of different threads visit disjoint roots, so that the GC workers can
+    // share the stack scanning of a large number of threads.
+    gc::Heap* heap = collector->GetHeap();
+    ThreadPool* thread_pool = heap->GetThreadPool();
+    const size_t num_workers = (thread_pool == nullptr) ? 0u : std::min(
+        heap->GetParallelGCThreadCount(), thread_pool->GetThreadCount());
+    RunFlipFunctionClosure run_flip_function;
+    RunClosureParallel(&run_flip_function, other_threads, thread_pool, num_workers);
     // Run it for self.
     Closure* flip_func = self->GetFlipFunction();
     if (flip_func != nullptr) {
@@ -654,6 +782,9 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
   }
   {
     ScopedTrace trace("Suspending mutator threads");
+#ifdef VTUNE_ART
+    ScopedVTuneTask vtune_task(VTuneTask::kSuspendAll);
+#endif
     const uint64_t start_time = NanoTime();
 
     SuspendAllInternal(self, self);
@@ -740,12 +871,15 @@ void ThreadList::SuspendAllInternal(Thread* self,
       ++debug_suspend_all_count_;
     }
     pending_threads.StoreRelaxed(list_.size() - num_ignored);
+    // Time the threads passing the barrier.
+    const uint64_t request_time = NanoTime();
     // Increment everybody's suspend count (except those that should be ignored).
     for (const auto& thread : list_) {
       if (thread == ignore1 || thread == ignore2) {
         continue;
       }
       VLOG(threads) << "requesting thread suspend: " << *thread;
+      thread->GetSafepointStats()->request_time_ns = request_time;
       bool updated = thread->ModifySuspendCount(self, +1, &pending_threads, reason);
       DCHECK(updated);
 
@@ -755,6 +889,7 @@ void ThreadList::SuspendAllInternal(Thread* self,
       if (thread->IsSuspended()) {
         // Only clear the counter for the current thread.
         thread->ClearSuspendBarrier(&pending_threads);
+        thread->GetSafepointStats()->request_time_ns = 0u;
         pending_threads.FetchAndSubSequentiallyConsistent(1);
       }
     }
@@ -1554,6 +1689,24 @@ void ThreadList::VisitRoots(RootVisitor* visitor, VisitRootFlags flags) const {
   }
 }
 
+void ThreadList::RunClosureOnSuspendedThreads(Closure* closure,
+                                              ThreadPool* thread_pool,
+                                              size_t num_workers) {
+  Thread* self = Thread::Current();
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  MutexLock mu(self, *Locks::thread_list_lock_);
+  // Put self first, so that the calling thread runs the closure for itself.
+  std::vector<Thread*> threads;
+  threads.reserve(list_.size());
+  threads.push_back(self);
+  for (Thread* thread : list_) {
+    if (thread != self) {
+      threads.push_back(thread);
+    }
+  }
+  RunClosureParallel(closure, threads, thread_pool, num_workers);
+}
+
 uint32_t ThreadList::AllocThreadId(Thread* self) {
   MutexLock mu(self, *Locks::allocated_thread_ids_lock_);
   for (size_t i = 0; i < allocated_ids_.size(); ++i) {
@@ -39,6 +39,7 @@ class GcPauseListener;
 class Closure;
 class RootVisitor;
 class Thread;
+class ThreadPool;
 class TimingLogger;
 enum VisitRootFlags : uint8_t;
 
@@ -169,6 +170,13 @@ class ThreadList {
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Run the closure for all the threads while they are suspended, dividing them among up to
+  // `num_workers` workers of `thread_pool` and the calling thread, which runs it for itself.
+  // Used by collectors to visit the thread roots in parallel during a pause.
+  void RunClosureOnSuspendedThreads(Closure* closure, ThreadPool* thread_pool, size_t num_workers)
+      REQUIRES(!Locks::thread_list_lock_)
+      REQUIRES(Locks::mutator_lock_);
+
   // Return a copy of the thread list.
   std::list<Thread*> GetList() REQUIRES(Locks::thread_list_lock_) {
     return list_;
@@ -193,6 +201,10 @@ class ThreadList {
   void DumpUnattachedThreads(std::ostream& os, bool dump_native_stack)
       REQUIRES(!Locks::thread_list_lock_);
 
+  // Dump the times taken by the threads to reach the safepoints of suspend-all requests.
+  void DumpTimeToSafepoint(std::ostream& os)
+      REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
+
   void SuspendAllDaemonThreadsForShutdown()
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
   void WaitForOtherNonDaemonThreadsToExit()
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thread_list.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/atomic.h"
+#include "common_runtime_test.h"
+#include "thread-current-inl.h"
+#include "thread_pool.h"
+
+namespace art {
+
+// Counts the runs for each of a known list of threads, and the runs that did not happen on the
+// requesting thread.
+class CountingClosure FINAL : public Closure {
+ public:
+  CountingClosure(Thread* requester, const std::vector<Thread*>& threads)
+      : requester_(requester), threads_(threads), run_counts_(threads.size()) {}
+
+  void Run(Thread* thread) OVERRIDE {
+    auto it = std::find(threads_.begin(), threads_.end(), thread);
+    CHECK(it != threads_.end());
+    run_counts_[it - threads_.begin()].FetchAndAddSequentiallyConsistent(1);
+    if (Thread::Current() != requester_) {
+      worker_run_count_.FetchAndAddSequentiallyConsistent(1);
+    }
+  }
+
+  int32_t GetRunCount(size_t i) const {
+    return run_counts_[i].LoadSequentiallyConsistent();
+  }
+
+  int32_t GetWorkerRunCount() const {
+    return worker_run_count_.LoadSequentiallyConsistent();
+  }
+
+ private:
+  Thread* const requester_;
+  const std::vector<Thread*>& threads_;
+  std::vector<AtomicInteger> run_counts_;
+  AtomicInteger worker_run_count_{0};
+};
+
+class ThreadListTest : public CommonRuntimeTest {};
+
+// The closure runs exactly once for each suspended thread, and the workers share the threads
+// when there are enough of them.
+TEST_F(ThreadListTest, RunClosureOnSuspendedThreads) {
+  static constexpr size_t kNumIdleThreads = 48;
+  static constexpr size_t kNumWorkers = 2;
+  Thread* self = Thread::Current();
+  ThreadList* thread_list = Runtime::Current()->GetThreadList();
+  // Idle pool workers, only there to be suspended.
+  ThreadPool idle_thread_pool("Thread list test idle thread pool", kNumIdleThreads);
+  ThreadPool thread_pool("Thread list test thread pool", kNumWorkers);
+  std::vector<Thread*> threads;
+  {
+    ScopedSuspendAll ssa(__FUNCTION__);
+    {
+      MutexLock mu(self, *Locks::thread_list_lock_);
+      for (Thread* thread : thread_list->GetList()) {
+        threads.push_back(thread);
+      }
+    }
+    ASSERT_GE(threads.size(), kNumIdleThreads + kNumWorkers + 1u);
+    CountingClosure closure(self, threads);
+    thread_list->RunClosureOnSuspendedThreads(&closure, &thread_pool, kNumWorkers);
+    for (size_t i = 0; i < threads.size(); ++i) {
+      EXPECT_EQ(1, closure.GetRunCount(i)) << *threads[i];
+    }
+    EXPECT_NE(0, closure.GetWorkerRunCount());
+  }
+}
+
+// Without workers, the calling thread runs the closure for all the threads.
+TEST_F(ThreadListTest, RunClosureOnSuspendedThreadsWithoutWorkers) {
+  Thread* self = Thread::Current();
+  ThreadList* thread_list = Runtime::Current()->GetThreadList();
+  std::vector<Thread*> threads;
+  ScopedSuspendAll ssa(__FUNCTION__);
+  {
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    for (Thread* thread : thread_list->GetList()) {
+      threads.push_back(thread);
+    }
+  }
+  CountingClosure closure(self, threads);
+  thread_list->RunClosureOnSuspendedThreads(&closure, /* thread_pool */ nullptr, 4u);
+  for (size_t i = 0; i < threads.size(); ++i) {
+    EXPECT_EQ(1, closure.GetRunCount(i)) << *threads[i];
+  }
+  EXPECT_EQ(0, closure.GetWorkerRunCount());
+}
+
+}  // namespace art
@@ -83,7 +83,6 @@ void ThreadPoolWorker::SetPthreadPriority(int priority) {
 void ThreadPoolWorker::Run() {
   Thread* self = Thread::Current();
   Task* task = nullptr;
-  thread_pool_->creation_barier_.Wait(self);
   while ((task = thread_pool_->GetTask(self)) != nullptr) {
     task->Run(self);
     task->Finalize();
@@ -100,6 +99,9 @@ void* ThreadPoolWorker::Callback(void* arg) {
   worker->thread_ = Thread::Current();
   // Thread pool workers cannot call into java.
   worker->thread_->SetCanCallIntoJava(false);
+  // Wait for the pool to create all its workers. Run is virtual, and the constructor of a subclass
+  // of ThreadPoolWorker may not have finished before.
+  worker->thread_pool_->creation_barier_.Wait(worker->thread_);
   // Do work until its time to shut down.
   worker->Run();
   runtime->DetachCurrentThread();
@@ -121,6 +123,12 @@ void ThreadPool::RemoveAllTasks(Thread* self) {
 }
 
 ThreadPool::ThreadPool(const char* name, size_t num_threads, bool create_peers)
+    : ThreadPool(name, num_threads, create_peers, /* create_workers */ true) {}
+
+ThreadPool::ThreadPool(const char* name,
+                       size_t num_threads,
+                       bool create_peers,
+                       bool create_workers)
   : name_(name),
     task_queue_lock_("task queue lock"),
     task_queue_condition_("task queue condition", task_queue_lock_),
@@ -134,6 +142,9 @@ ThreadPool::ThreadPool(const char* name, size_t num_threads, bool create_peers)
     creation_barier_(num_threads + 1),
     max_active_workers_(num_threads),
     create_peers_(create_peers) {
+  if (!create_workers) {
+    return;
+  }
   Thread* self = Thread::Current();
   while (GetThreadCount() < num_threads) {
     const std::string worker_name = StringPrintf("%s worker thread %zu", name_.c_str(),
@@ -152,8 +163,11 @@ void ThreadPool::SetMaxActiveWorkers(size_t threads) {
 }
 
 ThreadPool::~ThreadPool() {
+  DeleteWorkers(Thread::Current());
+}
+
+void ThreadPool::DeleteWorkers(Thread* self) {
   {
-    Thread* self = Thread::Current();
     MutexLock mu(self, task_queue_lock_);
     // Tell any remaining workers to shut down.
     shutting_down_ = true;
@@ -255,4 +269,235 @@ void ThreadPool::SetPthreadPriority(int priority) {
   }
 }
 
+WorkStealingWorker::WorkStealingWorker(WorkStealingThreadPool* thread_pool,
+                                       const std::string& name,
+                                       size_t stack_size,
+                                       size_t index)
+    : ThreadPoolWorker(thread_pool, name, stack_size),
+      index_(index),
+      queue_lock_("work stealing queue lock") {}
+
+void WorkStealingWorker::Run() {
+  Thread* self = Thread::Current();
+  WorkStealingThreadPool* thread_pool = down_cast<WorkStealingThreadPool*>(thread_pool_);
+  Task* task = nullptr;
+  while ((task = thread_pool->GetTask(self, this)) != nullptr) {
+    task->Run(self);
+    task->Finalize();
+  }
+}
+
+// The count of queued tasks is updated under the lock of the queue, so that it never exceeds the
+// number of tasks in the queues once a thread could have taken them.
+void WorkStealingWorker::PushTask(Thread* self, Task* task) {
+  MutexLock mu(self, queue_lock_);
+  tasks_.push_back(task);
+  down_cast<WorkStealingThreadPool*>(thread_pool_)->queued_tasks_.FetchAndAddSequentiallyConsistent(
+      1u);
+}
+
+Task* WorkStealingWorker::PopTask(Thread* self) {
+  MutexLock mu(self, queue_lock_);
+  if (tasks_.empty()) {
+    return nullptr;
+  }
+  Task* task = tasks_.back();
+  tasks_.pop_back();
+  down_cast<WorkStealingThreadPool*>(thread_pool_)->queued_tasks_.FetchAndSubSequentiallyConsistent(
+      1u);
+  return task;
+}
+
+Task* WorkStealingWorker::StealTask(Thread* self) {
+  MutexLock mu(self, queue_lock_);
+  if (tasks_.empty()) {
+    return nullptr;
+  }
+  Task* task = tasks_.front();
+  tasks_.pop_front();
+  down_cast<WorkStealingThreadPool*>(thread_pool_)->queued_tasks_.FetchAndSubSequentiallyConsistent(
+      1u);
+  return task;
+}
+
+size_t WorkStealingWorker::RemoveAllTasks(Thread* self) {
+  MutexLock mu(self, queue_lock_);
+  size_t removed = tasks_.size();
+  tasks_.clear();
+  down_cast<WorkStealingThreadPool*>(thread_pool_)->queued_tasks_.FetchAndSubSequentiallyConsistent(
+      removed);
+  return removed;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(const char* name,
+                                               size_t num_threads,
+                                               bool create_peers)
+    : ThreadPool(name, num_threads, create_peers, /* create_workers */ false),
+      queued_tasks_(0u),
+      runnable_workers_(0u),
+      next_queue_(0u) {
+  // The tasks are only queued to the workers.
+  CHECK_NE(num_threads, 0u);
+  Thread* self = Thread::Current();
+  while (GetThreadCount() < num_threads) {
+    const size_t index = GetThreadCount();
+    const std::string worker_name = StringPrintf("%s worker thread %zu", name_.c_str(), index);
+    threads_.push_back(
+        new WorkStealingWorker(this, worker_name, ThreadPoolWorker::kDefaultStackSize, index));
+  }
+  // Wait for all of the threads to attach.
+  creation_barier_.Wait(self);
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  // The workers use the members of this class, join them before they are destroyed.
+  DeleteWorkers(Thread::Current());
+}
+
+void WorkStealingThreadPool::StartWorkers(Thread* self) {
+  MutexLock mu(self, task_queue_lock_);
+  started_ = true;
+  UpdateRunnableWorkers();
+  task_queue_condition_.Broadcast(self);
+  start_time_ = NanoTime();
+  total_wait_time_ = 0;
+}
+
+void WorkStealingThreadPool::StopWorkers(Thread* self) {
+  MutexLock mu(self, task_queue_lock_);
+  started_ = false;
+  UpdateRunnableWorkers();
+}
+
+void WorkStealingThreadPool::SetMaxActiveWorkers(size_t threads) {
+  MutexLock mu(Thread::Current(), task_queue_lock_);
+  CHECK_LE(threads, GetThreadCount());
+  max_active_workers_ = threads;
+  UpdateRunnableWorkers();
+}
+
+void WorkStealingThreadPool::AddTask(Thread* self, Task* task) {
+  WorkStealingWorker* worker = FindWorker(self);
+  if (worker == nullptr) {
+    worker = GetWorker(next_queue_.FetchAndAddRelaxed(1u) % GetThreadCount());
+  }
+  worker->PushTask(self, task);
+  MutexLock mu(self, task_queue_lock_);
+  // If we have any waiters, signal one. The signaled worker may not be allowed to take tasks when
+  // the active workers are bounded, wake them all up then.
+  if (started_ && waiting_count_ != 0) {
+    if (max_active_workers_ < GetThreadCount()) {
+      task_queue_condition_.Broadcast(self);
+    } else {
+      task_queue_condition_.Signal(self);
+    }
+  }
+}
+
+void WorkStealingThreadPool::RemoveAllTasks(Thread* self) {
+  for (size_t i = 0, count = GetThreadCount(); i != count; ++i) {
+    GetWorker(i)->RemoveAllTasks(self);
+  }
+}
+
+Task* WorkStealingThreadPool::GetTask(Thread* self) {
+  WorkStealingWorker* worker = FindWorker(self);
+  CHECK(worker != nullptr);
+  return GetTask(self, worker);
+}
+
+Task* WorkStealingThreadPool::GetTask(Thread* self, WorkStealingWorker* worker) {
+  DCHECK(worker != nullptr);
+  while (true) {
+    Task* task = TryPopOrStealTask(self, worker);
+    if (task != nullptr) {
+      return task;
+    }
+    MutexLock mu(self, task_queue_lock_);
+    if (IsShuttingDown()) {
+      // We are shutting down, return null to tell the worker thread to stop looping.
+      return nullptr;
+    }
+    if (HasQueuedTasks() && worker->GetIndex() < max_active_workers_) {
+      // A task was added since we looked at the queues.
+      continue;
+    }
+    ++waiting_count_;
+    if (waiting_count_ == GetThreadCount() && !HasQueuedTasks()) {
+      // We may be done, lets broadcast to the completion condition.
+      completion_condition_.Broadcast(self);
+    }
+    const uint64_t wait_start = kMeasureWaitTime ? NanoTime() : 0;
+    task_queue_condition_.Wait(self);
+    if (kMeasureWaitTime) {
+      const uint64_t wait_end = NanoTime();
+      total_wait_time_ += wait_end - std::max(wait_start, start_time_);
+    }
+    --waiting_count_;
+  }
+}
+
+Task* WorkStealingThreadPool::TryPopOrStealTask(Thread* self, WorkStealingWorker* worker) {
+  const size_t runnable_workers = runnable_workers_.LoadRelaxed();
+  if (worker != nullptr ? worker->GetIndex() >= runnable_workers : runnable_workers == 0u) {
+    return nullptr;
+  }
+  // A task missed here is found under `task_queue_lock_` before waiting.
+  if (queued_tasks_.LoadRelaxed() == 0u) {
+    return nullptr;
+  }
+  size_t first_victim = 0u;
+  if (worker != nullptr) {
+    Task* task = worker->PopTask(self);
+    if (task != nullptr) {
+      return task;
+    }
+    first_victim = worker->GetIndex() + 1u;
+  }
+  const size_t thread_count = GetThreadCount();
+  for (size_t i = 0; i != thread_count; ++i) {
+    WorkStealingWorker* victim = GetWorker((first_victim + i) % thread_count);
+    if (victim != worker) {
+      Task* task = victim->StealTask(self);
+      if (task != nullptr) {
+        return task;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void WorkStealingThreadPool::Wait(Thread* self, bool do_work, bool may_hold_locks) {
+  if (do_work) {
+    CHECK(!create_peers_);
+    Task* task = nullptr;
+    while ((task = TryPopOrStealTask(self, /* worker */ nullptr)) != nullptr) {
+      task->Run(self);
+      task->Finalize();
+    }
+  }
+  // Wait until each thread is waiting and the task queues are empty.
+  MutexLock mu(self, task_queue_lock_);
+  while (!shutting_down_ && (waiting_count_ != GetThreadCount() || HasQueuedTasks())) {
+    if (!may_hold_locks) {
+      completion_condition_.Wait(self);
+    } else {
+      completion_condition_.WaitHoldingLocks(self);
+    }
+  }
+}
+
+size_t WorkStealingThreadPool::GetTaskCount(Thread* self ATTRIBUTE_UNUSED) {
+  return queued_tasks_.LoadSequentiallyConsistent();
+}
+
+WorkStealingWorker* WorkStealingThreadPool::FindWorker(Thread* self) const {
+  for (ThreadPoolWorker* worker : threads_) {
+    if (worker->GetThread() == self) {
+      return down_cast<WorkStealingWorker*>(worker);
+    }
+  }
+  return nullptr;
+}
+
 }  // namespace art
@@ -21,6 +21,8 @@
 #include <vector>
 
 #include "barrier.h"
+#include "base/atomic.h"
+#include "base/casts.h"
 #include "base/mutex.h"
 #include "mem_map.h"
 
@@ -93,17 +95,17 @@ class ThreadPool {
   }
 
   // Broadcast to the workers and tell them to empty out the work queue.
-  void StartWorkers(Thread* self) REQUIRES(!task_queue_lock_);
+  virtual void StartWorkers(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Do not allow workers to grab any new tasks.
-  void StopWorkers(Thread* self) REQUIRES(!task_queue_lock_);
+  virtual void StopWorkers(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Add a new task, the first available started worker will process it. Does not delete the task
   // after running it, it is the caller's responsibility.
-  void AddTask(Thread* self, Task* task) REQUIRES(!task_queue_lock_);
+  virtual void AddTask(Thread* self, Task* task) REQUIRES(!task_queue_lock_);
 
   // Remove all tasks in the queue.
-  void RemoveAllTasks(Thread* self) REQUIRES(!task_queue_lock_);
+  virtual void RemoveAllTasks(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Create a named thread pool with the given number of threads.
   //
@@ -116,9 +118,9 @@ class ThreadPool {
   // Wait for all tasks currently on queue to get completed. If the pool has been stopped, only
   // wait till all already running tasks are done.
   // When the pool was created with peers for workers, do_work must not be true (see ThreadPool()).
-  void Wait(Thread* self, bool do_work, bool may_hold_locks) REQUIRES(!task_queue_lock_);
+  virtual void Wait(Thread* self, bool do_work, bool may_hold_locks) REQUIRES(!task_queue_lock_);
 
-  size_t GetTaskCount(Thread* self) REQUIRES(!task_queue_lock_);
+  virtual size_t GetTaskCount(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Returns the total amount of workers waited for tasks.
   uint64_t GetWaitTime() const {
@@ -127,12 +129,20 @@ class ThreadPool {
 
   // Provides a way to bound the maximum number of worker threads, threads must be less the the
   // thread count of the thread pool.
-  void SetMaxActiveWorkers(size_t threads) REQUIRES(!task_queue_lock_);
+  virtual void SetMaxActiveWorkers(size_t threads) REQUIRES(!task_queue_lock_);
 
   // Set the "nice" priorty for threads in the pool.
   void SetPthreadPriority(int priority);
 
  protected:
+  // Create a thread pool without its workers, for the subclasses creating their own. The subclass
+  // constructor must add `num_threads` workers to `threads_`, then wait on `creation_barier_`.
+  ThreadPool(const char* name, size_t num_threads, bool create_peers, bool create_workers);
+
+  // Stop and join the workers, for the destructors of the subclasses whose workers use their
+  // members.
+  void DeleteWorkers(Thread* self) REQUIRES(!task_queue_lock_);
+
   // get a task to run, blocks if there are no tasks left
   virtual Task* GetTask(Thread* self) REQUIRES(!task_queue_lock_);
 
@@ -173,6 +183,102 @@ class ThreadPool {
   DISALLOW_COPY_AND_ASSIGN(ThreadPool);
 };
 
+class WorkStealingThreadPool;
+
+// A worker with its own task queue. It runs the tasks of its queue last in first out, and steals
+// the oldest tasks of the queues of the other workers when its queue is empty.
+class WorkStealingWorker : public ThreadPoolWorker {
+ public:
+  size_t GetIndex() const {
+    return index_;
+  }
+
+ protected:
+  WorkStealingWorker(WorkStealingThreadPool* thread_pool,
+                     const std::string& name,
+                     size_t stack_size,
+                     size_t index);
+  void Run() OVERRIDE;
+
+ private:
+  // Push a task at the back of the queue.
+  void PushTask(Thread* self, Task* task) REQUIRES(!queue_lock_);
+
+  // Pop the newest task, from the back of the queue. Used by the owner of the queue.
+  Task* PopTask(Thread* self) REQUIRES(!queue_lock_);
+
+  // Pop the oldest task, from the front of the queue. Used by the other threads.
+  Task* StealTask(Thread* self) REQUIRES(!queue_lock_);
+
+  // Remove all the tasks of the queue, returning how many there were.
+  size_t RemoveAllTasks(Thread* self) REQUIRES(!queue_lock_);
+
+  const size_t index_;
+  Mutex queue_lock_;
+  std::deque<Task*> tasks_ GUARDED_BY(queue_lock_);
+
+  friend class WorkStealingThreadPool;
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingWorker);
+};
+
+// A thread pool with a task queue per worker, so that the workers do not contend on
+// `task_queue_lock_` to get their tasks. The tasks added by a worker go to its own queue, the other
+// tasks are distributed round robin. The shared lock is only taken by AddTask, to wake up the
+// waiting workers, and by the workers running out of tasks.
+class WorkStealingThreadPool : public ThreadPool {
+ public:
+  WorkStealingThreadPool(const char* name, size_t num_threads, bool create_peers = false);
+  virtual ~WorkStealingThreadPool();
+
+  void StartWorkers(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+  void StopWorkers(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+  void AddTask(Thread* self, Task* task) OVERRIDE REQUIRES(!task_queue_lock_);
+  void RemoveAllTasks(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+  void Wait(Thread* self, bool do_work, bool may_hold_locks) OVERRIDE
+      REQUIRES(!task_queue_lock_);
+  size_t GetTaskCount(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+  void SetMaxActiveWorkers(size_t threads) OVERRIDE REQUIRES(!task_queue_lock_);
+
+ protected:
+  Task* GetTask(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+
+ private:
+  // Get a task for `worker`, blocks if there are no tasks left.
+  Task* GetTask(Thread* self, WorkStealingWorker* worker) REQUIRES(!task_queue_lock_);
+
+  // Pop a task from the queue of `worker`, or steal one from the other queues. `worker` is null
+  // for the thread calling Wait, which only steals.
+  Task* TryPopOrStealTask(Thread* self, WorkStealingWorker* worker) REQUIRES(!task_queue_lock_);
+
+  // Return the worker running on `self`, or null if `self` is not a worker of this pool.
+  WorkStealingWorker* FindWorker(Thread* self) const;
+
+  WorkStealingWorker* GetWorker(size_t index) const {
+    return down_cast<WorkStealingWorker*>(threads_[index]);
+  }
+
+  bool HasQueuedTasks() const REQUIRES(task_queue_lock_) {
+    return started_ && queued_tasks_.LoadSequentiallyConsistent() != 0u;
+  }
+
+  void UpdateRunnableWorkers() REQUIRES(task_queue_lock_) {
+    runnable_workers_.StoreRelaxed(started_ ? max_active_workers_ : 0u);
+  }
+
+  // The number of tasks in the queues of the workers. It is incremented before AddTask takes
+  // `task_queue_lock_` to wake up the workers, and the workers check it under the lock before
+  // waiting, so that no wake up is lost.
+  Atomic<size_t> queued_tasks_;
+  // The workers with an index below this may take tasks, zero when the pool is stopped. A copy of
+  // `started_` and `max_active_workers_` read without the lock.
+  Atomic<size_t> runnable_workers_;
+  // The queue of the next task added by a thread that is not a worker.
+  Atomic<size_t> next_queue_;
+
+  friend class WorkStealingWorker;
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingThreadPool);
+};
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_THREAD_POOL_H_
@@ -160,6 +160,73 @@ TEST_F(ThreadPoolTest, RecursiveTest) {
   EXPECT_EQ((1 << depth) - 1, count.LoadSequentiallyConsistent());
 }
 
+// Check that the work stealing thread pool runs the tasks added to the queues of its workers.
+TEST_F(ThreadPoolTest, WorkStealingCheckRun) {
+  Thread* self = Thread::Current();
+  WorkStealingThreadPool thread_pool("Work stealing thread pool test thread pool", num_threads);
+  AtomicInteger count(0);
+  static const int32_t num_tasks = num_threads * 4;
+  for (int32_t i = 0; i < num_tasks; ++i) {
+    thread_pool.AddTask(self, new CountTask(&count));
+  }
+  EXPECT_EQ(static_cast<size_t>(num_tasks), thread_pool.GetTaskCount(self));
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, true, false);
+  EXPECT_EQ(num_tasks, count.LoadSequentiallyConsistent());
+  EXPECT_EQ(0u, thread_pool.GetTaskCount(self));
+}
+
+TEST_F(ThreadPoolTest, WorkStealingStopStart) {
+  Thread* self = Thread::Current();
+  WorkStealingThreadPool thread_pool("Work stealing thread pool test thread pool", num_threads);
+  AtomicInteger count(0);
+  static const int32_t num_tasks = num_threads * 4;
+  for (int32_t i = 0; i < num_tasks; ++i) {
+    thread_pool.AddTask(self, new CountTask(&count));
+  }
+  usleep(200);
+  // Check that no threads started prematurely.
+  EXPECT_EQ(0, count.LoadSequentiallyConsistent());
+  thread_pool.StartWorkers(self);
+  usleep(200);
+  thread_pool.StopWorkers(self);
+  AtomicInteger bad_count(0);
+  thread_pool.AddTask(self, new CountTask(&bad_count));
+  usleep(200);
+  // Ensure that the task added after the workers were stopped doesn't get run.
+  EXPECT_EQ(0, bad_count.LoadSequentiallyConsistent());
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, false, false);
+  EXPECT_EQ(num_tasks, count.LoadSequentiallyConsistent());
+  EXPECT_EQ(1, bad_count.LoadSequentiallyConsistent());
+}
+
+// The tasks added by a task go to the queue of its worker, and are stolen by the other workers.
+TEST_F(ThreadPoolTest, WorkStealingRecursiveTest) {
+  Thread* self = Thread::Current();
+  WorkStealingThreadPool thread_pool("Work stealing thread pool test thread pool", num_threads);
+  AtomicInteger count(0);
+  static const int depth = 12;
+  thread_pool.AddTask(self, new TreeTask(&thread_pool, &count, depth));
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, true, false);
+  EXPECT_EQ((1 << depth) - 1, count.LoadSequentiallyConsistent());
+}
+
+TEST_F(ThreadPoolTest, WorkStealingMaxActiveWorkers) {
+  Thread* self = Thread::Current();
+  WorkStealingThreadPool thread_pool("Work stealing thread pool test thread pool", num_threads);
+  thread_pool.SetMaxActiveWorkers(1);
+  AtomicInteger count(0);
+  static const int32_t num_tasks = num_threads * 4;
+  for (int32_t i = 0; i < num_tasks; ++i) {
+    thread_pool.AddTask(self, new CountTask(&count));
+  }
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, false, false);
+  EXPECT_EQ(num_tasks, count.LoadSequentiallyConsistent());
+}
+
 class PeerTask : public Task {
  public:
   PeerTask() {}
@@ -22,6 +22,7 @@
 #include "android-base/stringprintf.h"
 
 #include "art_method-inl.h"
+#include "barrier.h"
 #include "base/casts.h"
 #include "base/enums.h"
 #include "base/os.h"
@@ -57,12 +58,16 @@ static constexpr size_t TraceActionBits = MinimumBitsToStore(
 static constexpr uint8_t kOpNewMethod = 1U;
 static constexpr uint8_t kOpNewThread = 2U;
 static constexpr uint8_t kOpTraceSummary = 3U;
+// The size of the packets in streaming mode, the maximum size of data in a packet.
+static constexpr size_t kStreamingPacketSize = 14U;
+// The size of the per-thread buffers of packets in streaming mode.
+static constexpr size_t kThreadBufSize = 4 * KB;
 
 class BuildStackTraceVisitor : public StackVisitor {
  public:
   explicit BuildStackTraceVisitor(Thread* thread)
       : StackVisitor(thread, nullptr, StackVisitor::StackWalkKind::kIncludeInlinedFrames),
-        method_trace_(Trace::AllocStackTrace()) {}
+        method_trace_(new std::vector<ArtMethod*>()) {}
 
   bool VisitFrame() REQUIRES_SHARED(Locks::mutator_lock_) {
     ArtMethod* m = GetMethod();
@@ -96,7 +101,6 @@ TraceClockSource Trace::default_clock_source_ = kDefaultTraceClockSource;
 
 Trace* volatile Trace::the_trace_ = nullptr;
 pthread_t Trace::sampling_pthread_ = 0U;
-std::unique_ptr<std::vector<ArtMethod*>> Trace::temp_stack_trace_;
 
 // The key identifying the tracer to update instrumentation.
 static constexpr const char* kTracerInstrumentationKey = "Tracer";
@@ -132,16 +136,6 @@ uint32_t Trace::EncodeTraceMethodAndAction(ArtMethod* method, TraceAction action
   return tmid;
 }
 
-std::vector<ArtMethod*>* Trace::AllocStackTrace() {
-  return (temp_stack_trace_.get() != nullptr)  ? temp_stack_trace_.release() :
-      new std::vector<ArtMethod*>();
-}
-
-void Trace::FreeStackTrace(std::vector<ArtMethod*>* stack_trace) {
-  stack_trace->clear();
-  temp_stack_trace_.reset(stack_trace);
-}
-
 void Trace::SetDefaultClockSource(TraceClockSource clock_source) {
 #if defined(__linux__)
   default_clock_source_ = clock_source;
@@ -227,13 +221,73 @@ static void Append8LE(uint8_t* buf, uint64_t val) {
   *buf++ = static_cast<uint8_t>(val >> 56);
 }
 
-static void GetSample(Thread* thread, void* arg) REQUIRES_SHARED(Locks::mutator_lock_) {
-  BuildStackTraceVisitor build_trace_visitor(thread);
-  build_trace_visitor.WalkStack();
-  std::vector<ArtMethod*>* stack_trace = build_trace_visitor.GetStackTrace();
-  Trace* the_trace = reinterpret_cast<Trace*>(arg);
-  the_trace->CompareAndUpdateStackTrace(thread, stack_trace);
-}
+// Samples the stack of each thread at its next suspend point, or on the sampling thread for the
+// threads that are suspended, so that the other threads keep running meanwhile. The samples are
+// then diffed and logged by the sampling thread, which owns the previous samples of the threads.
+class GetSampleClosure FINAL : public Closure {
+ public:
+  GetSampleClosure(Trace* trace, Barrier* barrier)
+      : trace_(trace), barrier_(barrier), lock_("Trace samples lock", kGenericBottomLock) {}
+
+  ~GetSampleClosure() {
+    for (const Sample& sample : samples_) {
+      delete sample.stack_trace;
+    }
+    for (const Sample& sample : collected_samples_) {
+      delete sample.stack_trace;
+    }
+  }
+
+  void Run(Thread* thread) OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_) {
+    Thread* self = Thread::Current();
+    BuildStackTraceVisitor build_trace_visitor(thread);
+    build_trace_visitor.WalkStack();
+    {
+      MutexLock mu(self, lock_);
+      samples_.push_back({thread, thread->GetTid(), build_trace_visitor.GetStackTrace()});
+    }
+    barrier_->Pass(self);
+  }
+
+  // Log the samples of the threads that are still alive. Called by the sampling thread once all
+  // the threads have run the closure.
+  void UpdateStackTraces() REQUIRES_SHARED(Locks::mutator_lock_) {
+    Thread* self = Thread::Current();
+    {
+      MutexLock mu(self, lock_);
+      collected_samples_.swap(samples_);
+    }
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    Runtime::Current()->GetThreadList()->ForEach(UpdateStackTraceCallback, this);
+  }
+
+ private:
+  struct Sample {
+    Thread* thread;
+    pid_t tid;
+    std::vector<ArtMethod*>* stack_trace;
+  };
+
+  static void UpdateStackTraceCallback(Thread* thread, void* arg)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    GetSampleClosure* closure = reinterpret_cast<GetSampleClosure*>(arg);
+    for (Sample& sample : closure->collected_samples_) {
+      // A thread that exited after it was sampled may have its address reused by a new thread.
+      if (sample.thread == thread && sample.tid == thread->GetTid()) {
+        closure->trace_->CompareAndUpdateStackTrace(thread, sample.stack_trace);
+        sample.stack_trace = nullptr;
+        break;
+      }
+    }
+  }
+
+  Trace* const trace_;
+  Barrier* const barrier_;
+  Mutex lock_;
+  std::vector<Sample> samples_ GUARDED_BY(lock_);
+  // The samples taken, only used by the sampling thread once all threads have run the closure.
+  std::vector<Sample> collected_samples_;
+};
 
 static void ClearThreadStackTraceAndClockBase(Thread* thread, void* arg ATTRIBUTE_UNUSED) {
   thread->SetTraceClockBase(0);
@@ -242,6 +296,15 @@ static void ClearThreadStackTraceAndClockBase(Thread* thread, void* arg ATTRIBUT
   delete stack_trace;
 }
 
+static void FlushThreadBufferCallback(Thread* thread, void* arg)
+    REQUIRES(Locks::mutator_lock_) {
+  reinterpret_cast<Trace*>(arg)->FlushThreadBuffer(thread);
+}
+
+static void ClearThreadBufferCallback(Thread* thread, void* arg ATTRIBUTE_UNUSED) {
+  std::vector<uint8_t>().swap(*thread->GetMethodTraceBuffer());
+}
+
 void Trace::CompareAndUpdateStackTrace(Thread* thread,
                                        std::vector<ArtMethod*>* stack_trace) {
   CHECK_EQ(pthread_self(), sampling_pthread_);
@@ -279,7 +342,7 @@ void Trace::CompareAndUpdateStackTrace(Thread* thread,
       LogMethodTraceEvent(thread, *rit, instrumentation::Instrumentation::kMethodEntered,
                           thread_clock_diff, wall_clock_diff);
     }
-    FreeStackTrace(old_stack_trace);
+    delete old_stack_trace;
   }
 }
 
@@ -303,15 +366,19 @@ void* Trace::RunSamplingThread(void* arg) {
       }
     }
     {
-      // Avoid a deadlock between a thread doing garbage collection
-      // and the profile sampling thread, by blocking GC when sampling
-      // thread stacks (see b/73624630).
-      gc::ScopedGCCriticalSection gcs(self,
-                                      art::gc::kGcCauseInstrumentation,
-                                      art::gc::kCollectorTypeInstrumentation);
-      ScopedSuspendAll ssa(__FUNCTION__);
-      MutexLock mu(self, *Locks::thread_list_lock_);
-      runtime->GetThreadList()->ForEach(GetSample, the_trace);
+      Barrier barrier(0);
+      GetSampleClosure closure(the_trace, &barrier);
+      size_t threads_running_checkpoint;
+      {
+        ScopedObjectAccess soa(self);
+        threads_running_checkpoint = runtime->GetThreadList()->RunCheckpoint(&closure);
+      }
+      if (threads_running_checkpoint != 0) {
+        ScopedThreadStateChange tsc(self, kWaitingForCheckPointsToRun);
+        barrier.Increment(self, threads_running_checkpoint);
+      }
+      ScopedObjectAccess soa(self);
+      closure.UpdateStackTraces();
     }
   }
 
@@ -403,10 +470,21 @@ void Trace::StopTracing(bool finish_tracing, bool flush_file) {
   Thread* const self = Thread::Current();
   pthread_t sampling_pthread = 0U;
   {
+    // Unpublish the trace with the threads suspended, so that none of them can exit between the
+    // flush of the packets they buffered and the unpublishing, and lose its packets.
+    gc::ScopedGCCriticalSection gcs(self,
+                                    gc::kGcCauseInstrumentation,
+                                    gc::kCollectorTypeInstrumentation);
+    ScopedSuspendAll ssa(__FUNCTION__);
     MutexLock mu(self, *Locks::trace_lock_);
     if (the_trace_ == nullptr) {
       LOG(ERROR) << "Trace stop requested, but no trace currently running";
     } else {
+      if (finish_tracing && the_trace_->trace_output_mode_ == TraceOutputMode::kStreaming) {
+        // Write the packets buffered by the threads before the summary.
+        MutexLock mu2(self, *Locks::thread_list_lock_);
+        runtime->GetThreadList()->ForEach(FlushThreadBufferCallback, the_trace_);
+      }
       the_trace = the_trace_;
       the_trace_ = nullptr;
       sampling_pthread = sampling_pthread_;
@@ -429,6 +507,11 @@ void Trace::StopTracing(bool finish_tracing, bool flush_file) {
                                     gc::kGcCauseInstrumentation,
                                     gc::kCollectorTypeInstrumentation);
     ScopedSuspendAll ssa(__FUNCTION__);
+    {
+      // Drop the packets logged since.
+      MutexLock mu(self, *Locks::thread_list_lock_);
+      runtime->GetThreadList()->ForEach(ClearThreadBufferCallback, nullptr);
+    }
 
     if (the_trace->trace_mode_ == TraceMode::kSampling) {
       MutexLock mu(self, *Locks::thread_list_lock_);
@@ -891,6 +974,42 @@ std::string Trace::GetMethodLine(ArtMethod* method) {
       method->GetSignature().ToString().c_str(), method->GetDeclaringClassSourceFile());
 }
 
+void Trace::FlushThreadBuffer(Thread* thread) {
+  std::vector<uint8_t>* buffer = thread->GetMethodTraceBuffer();
+  if (buffer->empty()) {
+    return;
+  }
+  MutexLock mu(Thread::Current(), *streaming_lock_);  // To serialize writing.
+  if (RegisterThread(thread)) {
+    std::string thread_name;
+    thread->GetThreadName(thread_name);
+    uint8_t buf2[7];
+    Append2LE(buf2, 0);
+    buf2[2] = kOpNewThread;
+    Append2LE(buf2 + 3, static_cast<uint16_t>(thread->GetTid()));
+    Append2LE(buf2 + 5, static_cast<uint16_t>(thread_name.length()));
+    WriteToBuf(buf2, sizeof(buf2));
+    WriteToBuf(reinterpret_cast<const uint8_t*>(thread_name.c_str()), thread_name.length());
+  }
+  // The methods must be named before the packets that use them.
+  for (size_t offset = 0; offset < buffer->size(); offset += kStreamingPacketSize) {
+    uint32_t tmid = ReadBytes(buffer->data() + offset + 2, sizeof(tmid));
+    ArtMethod* method = DecodeTraceMethod(tmid);
+    if (RegisterMethod(method)) {
+      // Write a special block with the name.
+      std::string method_line(GetMethodLine(method));
+      uint8_t buf2[5];
+      Append2LE(buf2, 0);
+      buf2[2] = kOpNewMethod;
+      Append2LE(buf2 + 3, static_cast<uint16_t>(method_line.length()));
+      WriteToBuf(buf2, sizeof(buf2));
+      WriteToBuf(reinterpret_cast<const uint8_t*>(method_line.c_str()), method_line.length());
+    }
+  }
+  WriteToBuf(buffer->data(), buffer->size());
+  buffer->clear();
+}
+
 void Trace::WriteToBuf(const uint8_t* src, size_t src_size) {
   int32_t old_offset = cur_offset_.LoadRelaxed();
   int32_t new_offset = old_offset + static_cast<int32_t>(src_size);
@@ -966,8 +1085,7 @@ void Trace::LogMethodTraceEvent(Thread* thread, ArtMethod* method,
 
   // Write data
   uint8_t* ptr;
-  static constexpr size_t kPacketSize = 14U;  // The maximum size of data in a packet.
-  uint8_t stack_buf[kPacketSize];             // Space to store a packet when in streaming mode.
+  uint8_t stack_buf[kStreamingPacketSize];    // Space to store a packet when in streaming mode.
   if (trace_output_mode_ == TraceOutputMode::kStreaming) {
     ptr = stack_buf;
   } else {
@@ -985,33 +1103,18 @@ void Trace::LogMethodTraceEvent(Thread* thread, ArtMethod* method,
   if (UseWallClock()) {
     Append4LE(ptr, wall_clock_diff);
   }
-  static_assert(kPacketSize == 2 + 4 + 4 + 4, "Packet size incorrect.");
+  static_assert(kStreamingPacketSize == 2 + 4 + 4 + 4, "Packet size incorrect.");
 
   if (trace_output_mode_ == TraceOutputMode::kStreaming) {
-    MutexLock mu(Thread::Current(), *streaming_lock_);  // To serialize writing.
-    if (RegisterMethod(method)) {
-      // Write a special block with the name.
-      std::string method_line(GetMethodLine(method));
-      uint8_t buf2[5];
-      Append2LE(buf2, 0);
-      buf2[2] = kOpNewMethod;
-      Append2LE(buf2 + 3, static_cast<uint16_t>(method_line.length()));
-      WriteToBuf(buf2, sizeof(buf2));
-      WriteToBuf(reinterpret_cast<const uint8_t*>(method_line.c_str()), method_line.length());
+    // Only take the lock to write many packets of the thread at once.
+    std::vector<uint8_t>* buffer = thread->GetMethodTraceBuffer();
+    if (buffer->capacity() == 0u) {
+      buffer->reserve(kThreadBufSize);
     }
-    if (RegisterThread(thread)) {
-      // It might be better to postpone this. Threads might not have received names...
-      std::string thread_name;
-      thread->GetThreadName(thread_name);
-      uint8_t buf2[7];
-      Append2LE(buf2, 0);
-      buf2[2] = kOpNewThread;
-      Append2LE(buf2 + 3, static_cast<uint16_t>(thread->GetTid()));
-      Append2LE(buf2 + 5, static_cast<uint16_t>(thread_name.length()));
-      WriteToBuf(buf2, sizeof(buf2));
-      WriteToBuf(reinterpret_cast<const uint8_t*>(thread_name.c_str()), thread_name.length());
+    buffer->insert(buffer->end(), stack_buf, stack_buf + sizeof(stack_buf));
+    if (buffer->size() + sizeof(stack_buf) > kThreadBufSize) {
+      FlushThreadBuffer(thread);
     }
-    WriteToBuf(stack_buf, sizeof(stack_buf));
   }
 }
 
@@ -1052,6 +1155,14 @@ void Trace::DumpThreadList(std::ostream& os) {
 }
 
 void Trace::StoreExitingThreadInfo(Thread* thread) {
+  if (!thread->GetMethodTraceBuffer()->empty()) {
+    // Describing the methods of the buffered packets needs the mutator lock.
+    ScopedObjectAccess soa(thread);
+    MutexLock mu(thread, *Locks::trace_lock_);
+    if (the_trace_ != nullptr) {
+      the_trace_->FlushThreadBuffer(thread);
+    }
+  }
   MutexLock mu(thread, *Locks::trace_lock_);
   if (the_trace_ != nullptr) {
     std::string name;
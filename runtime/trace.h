@@ -140,6 +140,11 @@ class Trace FINAL : public instrumentation::InstrumentationListener {
   void CompareAndUpdateStackTrace(Thread* thread, std::vector<ArtMethod*>* stack_trace)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*unique_methods_lock_, !*streaming_lock_);
 
+  // Write the packets buffered by the thread, with the methods and the thread they name if they
+  // are new. Used for streaming.
+  void FlushThreadBuffer(Thread* thread)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*unique_methods_lock_, !*streaming_lock_);
+
   // InstrumentationListener implementation.
   void MethodEntered(Thread* thread,
                      Handle<mirror::Object> this_object,
@@ -197,10 +202,6 @@ class Trace FINAL : public instrumentation::InstrumentationListener {
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*unique_methods_lock_) OVERRIDE;
   void WatchedFramePop(Thread* thread, const ShadowFrame& frame)
       REQUIRES_SHARED(Locks::mutator_lock_) OVERRIDE;
-  // Reuse an old stack trace if it exists, otherwise allocate a new one.
-  static std::vector<ArtMethod*>* AllocStackTrace();
-  // Clear and store an old stack trace for later use.
-  static void FreeStackTrace(std::vector<ArtMethod*>* stack_trace);
   // Save id and name of a thread before it exits.
   static void StoreExitingThreadInfo(Thread* thread);
 
@@ -276,9 +277,6 @@ class Trace FINAL : public instrumentation::InstrumentationListener {
   // Sampling thread, non-zero when sampling.
   static pthread_t sampling_pthread_;
 
-  // Used to remember an unused stack trace to avoid re-allocation during sampling.
-  static std::unique_ptr<std::vector<ArtMethod*>> temp_stack_trace_;
-
   // File to write trace data out to, null if direct to ddms.
   std::unique_ptr<File> trace_file_;
 
@@ -16,7 +16,9 @@
 
 #include "type_lookup_table.h"
 
+#include <algorithm>
 #include <cstring>
+#include <limits>
 #include <memory>
 
 #include "base/bit_utils.h"
@@ -26,24 +28,22 @@
 
 namespace art {
 
-static uint16_t MakeData(uint16_t class_def_idx, uint32_t hash, uint32_t mask) {
-  uint16_t hash_mask = static_cast<uint16_t>(~mask);
-  return (static_cast<uint16_t>(hash) & hash_mask) | class_def_idx;
-}
-
-TypeLookupTable::~TypeLookupTable() {
-  if (!owns_entries_) {
-    // We don't actually own the entries, don't let the unique_ptr release them.
-    entries_.release();
-  }
-}
+TypeLookupTable::~TypeLookupTable() {}
 
 uint32_t TypeLookupTable::RawDataLength(uint32_t num_class_defs) {
-  return SupportedSize(num_class_defs) ? RoundUpToPowerOfTwo(num_class_defs) * sizeof(Entry) : 0u;
+  return SupportedSize(num_class_defs)
+      ? (CalculateGroupMask(num_class_defs) + 1u) * kGroupSize * (sizeof(Entry) + 1u)
+      : 0u;
 }
 
-uint32_t TypeLookupTable::CalculateMask(uint32_t num_class_defs) {
-  return SupportedSize(num_class_defs) ? RoundUpToPowerOfTwo(num_class_defs) - 1u : 0u;
+uint32_t TypeLookupTable::CalculateGroupMask(uint32_t num_class_defs) {
+  if (!SupportedSize(num_class_defs)) {
+    return 0u;
+  }
+  // Keep at least one slot in nine empty so that the probing stops quickly.
+  uint32_t num_slots =
+      std::max(kGroupSize, RoundUpToPowerOfTwo(num_class_defs + num_class_defs / 8u + 1u));
+  return num_slots / kGroupSize - 1u;
 }
 
 bool TypeLookupTable::SupportedSize(uint32_t num_class_defs) {
@@ -68,15 +68,13 @@ std::unique_ptr<TypeLookupTable> TypeLookupTable::Open(const uint8_t* dex_file_p
 TypeLookupTable::TypeLookupTable(const DexFile& dex_file, uint8_t* storage)
     : dex_data_begin_(dex_file.DataBegin()),
       raw_data_length_(RawDataLength(dex_file.NumClassDefs())),
-      mask_(CalculateMask(dex_file.NumClassDefs())),
-      entries_(storage != nullptr ? reinterpret_cast<Entry*>(storage) : new Entry[mask_ + 1]),
-      owns_entries_(storage == nullptr) {
+      group_mask_(CalculateGroupMask(dex_file.NumClassDefs())),
+      owned_storage_(storage != nullptr ? nullptr : new uint8_t[raw_data_length_]),
+      raw_data_(storage != nullptr ? storage : owned_storage_.get()) {
   static_assert(alignof(Entry) == 4u, "Expecting Entry to be 4-byte aligned.");
   DCHECK_ALIGNED(storage, alignof(Entry));
-  std::vector<uint16_t> conflict_class_defs;
-  // The first stage. Put elements on their initial positions. If an initial position is already
-  // occupied then delay the insertion of the element to the second stage to reduce probing
-  // distance.
+  memset(raw_data_, 0, Size() * sizeof(Entry));
+  memset(raw_data_ + Size() * sizeof(Entry), kEmpty, Size());
   for (size_t i = 0; i < dex_file.NumClassDefs(); ++i) {
     const DexFile::ClassDef& class_def = dex_file.GetClassDef(i);
     const DexFile::TypeId& type_id = dex_file.GetTypeId(class_def.class_idx_);
@@ -84,21 +82,7 @@ TypeLookupTable::TypeLookupTable(const DexFile& dex_file, uint8_t* storage)
     const uint32_t hash = ComputeModifiedUtf8Hash(dex_file.GetStringData(str_id));
     Entry entry;
     entry.str_offset = str_id.string_data_off_;
-    entry.data = MakeData(i, hash, GetSizeMask());
-    if (!SetOnInitialPos(entry, hash)) {
-      conflict_class_defs.push_back(i);
-    }
-  }
-  // The second stage. The initial position of these elements had a collision. Put these elements
-  // into the nearest free cells and link them together by updating next_pos_delta.
-  for (uint16_t class_def_idx : conflict_class_defs) {
-    const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_idx);
-    const DexFile::TypeId& type_id = dex_file.GetTypeId(class_def.class_idx_);
-    const DexFile::StringId& str_id = dex_file.GetStringId(type_id.descriptor_idx_);
-    const uint32_t hash = ComputeModifiedUtf8Hash(dex_file.GetStringData(str_id));
-    Entry entry;
-    entry.str_offset = str_id.string_data_off_;
-    entry.data = MakeData(class_def_idx, hash, GetSizeMask());
+    entry.data = (hash & Entry::kHashMask) | static_cast<uint32_t>(i);
     Insert(entry, hash);
   }
 }
@@ -108,39 +92,24 @@ TypeLookupTable::TypeLookupTable(const uint8_t* dex_file_pointer,
                                  uint32_t num_class_defs)
     : dex_data_begin_(dex_file_pointer),
       raw_data_length_(RawDataLength(num_class_defs)),
-      mask_(CalculateMask(num_class_defs)),
-      entries_(reinterpret_cast<Entry*>(const_cast<uint8_t*>(raw_data))),
-      owns_entries_(false) {}
-
-bool TypeLookupTable::SetOnInitialPos(const Entry& entry, uint32_t hash) {
-  const uint32_t pos = hash & GetSizeMask();
-  if (!entries_[pos].IsEmpty()) {
-    return false;
-  }
-  entries_[pos] = entry;
-  entries_[pos].next_pos_delta = 0;
-  return true;
-}
+      group_mask_(CalculateGroupMask(num_class_defs)),
+      owned_storage_(nullptr),
+      raw_data_(const_cast<uint8_t*>(raw_data)) {}
 
 void TypeLookupTable::Insert(const Entry& entry, uint32_t hash) {
-  uint32_t pos = FindLastEntryInBucket(hash & GetSizeMask());
-  uint32_t next_pos = (pos + 1) & GetSizeMask();
-  while (!entries_[next_pos].IsEmpty()) {
-    next_pos = (next_pos + 1) & GetSizeMask();
-  }
-  const uint32_t delta = (next_pos >= pos) ? (next_pos - pos) : (next_pos + Size() - pos);
-  entries_[pos].next_pos_delta = delta;
-  entries_[next_pos] = entry;
-  entries_[next_pos].next_pos_delta = 0;
-}
-
-uint32_t TypeLookupTable::FindLastEntryInBucket(uint32_t pos) const {
-  const Entry* entry = &entries_[pos];
-  while (!entry->IsLast()) {
-    pos = (pos + entry->next_pos_delta) & GetSizeMask();
-    entry = &entries_[pos];
+  uint32_t group = hash & group_mask_;
+  for (uint32_t step = 1u; ; ++step) {
+    DCHECK_LE(step, group_mask_ + 1u);
+    uint8_t* control = raw_data_ + Size() * sizeof(Entry) + group * kGroupSize;
+    uint32_t empty = MatchGroup(control, kEmpty);
+    if (empty != 0u) {
+      uint32_t index = CTZ(empty);
+      control[index] = GetTag(hash);
+      reinterpret_cast<Entry*>(raw_data_)[group * kGroupSize + index] = entry;
+      return;
+    }
+    group = (group + step) & group_mask_;
   }
-  return pos;
 }
 
 }  // namespace art
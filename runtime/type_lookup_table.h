@@ -17,6 +17,14 @@
 #ifndef ART_RUNTIME_TYPE_LOOKUP_TABLE_H_
 #define ART_RUNTIME_TYPE_LOOKUP_TABLE_H_
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <cstring>
+#include <memory>
+
+#include "base/bit_utils.h"
 #include "base/leb128.h"
 #include "dex/dex_file_types.h"
 #include "dex/utf.h"
@@ -31,32 +39,41 @@ class DexFile;
  * This class instantiated at compile time by calling Create() method and written into OAT file.
  * At runtime, the raw data is read from memory-mapped file by calling Open() method. The table
  * memory remains clean.
+ *
+ * The table is laid out like a Swiss table. The slots are split into groups of 16, with one
+ * control byte per slot stored after all the entries. A control byte holds 7 bits of the hash of
+ * the descriptor in its slot, or kEmpty. A lookup compares the 16 control bytes of a group with
+ * the hash at once, and only compares the descriptors of the matching slots. The groups are probed
+ * starting from the one selected by the low bits of the hash until a group with an empty slot.
  */
 class TypeLookupTable {
  public:
   ~TypeLookupTable();
 
-  // Return the number of buckets in the lookup table.
+  // Return the number of slots in the lookup table.
   uint32_t Size() const {
-    return mask_ + 1;
+    return (group_mask_ + 1u) * kGroupSize;
   }
 
   // Method search class_def_idx by class descriptor and it's hash.
   // If no data found then the method returns dex::kDexNoIndex.
   uint32_t Lookup(const char* str, uint32_t hash) const {
-    uint32_t pos = hash & GetSizeMask();
-    // Thanks to special insertion algorithm, the element at position pos can be empty or start of
-    // bucket.
-    const Entry* entry = &entries_[pos];
-    while (!entry->IsEmpty()) {
-      if (CmpHashBits(entry->data, hash) && IsStringsEquals(str, entry->str_offset)) {
-        return GetClassDefIdx(entry->data);
+    const uint8_t tag = GetTag(hash);
+    uint32_t group = hash & group_mask_;
+    // The groups are probed with triangular steps, which visit all of them as their number is a
+    // power of two.
+    for (uint32_t step = 1u; step <= group_mask_ + 1u; ++step) {
+      const uint8_t* control = GetControlBytes() + group * kGroupSize;
+      for (uint32_t match = MatchGroup(control, tag); match != 0u; match &= match - 1u) {
+        const Entry& entry = GetEntries()[group * kGroupSize + CTZ(match)];
+        if (entry.HashBitsMatch(hash) && IsStringsEquals(str, entry.str_offset)) {
+          return entry.GetClassDefIdx();
+        }
       }
-      if (entry->IsLast()) {
+      if (MatchGroup(control, kEmpty) != 0u) {
         return dex::kDexNoIndex;
       }
-      pos = (pos + entry->next_pos_delta) & GetSizeMask();
-      entry = &entries_[pos];
+      group = (group + step) & group_mask_;
     }
     return dex::kDexNoIndex;
   }
@@ -73,7 +90,7 @@ class TypeLookupTable {
 
   // Method returns pointer to binary data of lookup table. Used by the oat writer.
   const uint8_t* RawData() const {
-    return reinterpret_cast<const uint8_t*>(entries_.get());
+    return raw_data_;
   }
 
   // Method returns length of binary data. Used by the oat writer.
@@ -83,39 +100,57 @@ class TypeLookupTable {
   static uint32_t RawDataLength(uint32_t num_class_defs);
 
  private:
-   /**
-    * To find element we need to compare strings.
-    * It is faster to compare first hashes and then strings itself.
-    * But we have no full hash of element of table. But we can use 2 ideas.
-    * 1. All minor bits of hash inside one bucket are equals.
-    * 2. If dex file contains N classes and size of hash table is 2^n (where N <= 2^n)
-    *    then 16-n bits are free. So we can encode part of element's hash into these bits.
-    * So hash of element can be divided on three parts:
-    * XXXX XXXX XXXX YYYY YZZZ ZZZZ ZZZZZ
-    * Z - a part of hash encoded in bucket (these bits of has are same for all elements in bucket) -
-    * n bits
-    * Y - a part of hash that we can write into free 16-n bits (because only n bits used to store
-    * class_def_idx)
-    * X - a part of has that we can't use without increasing increase
-    * So the data element of Entry used to store class_def_idx and part of hash of the entry.
-    */
+  static constexpr uint32_t kGroupSize = 16u;
+  static constexpr uint8_t kEmpty = 0x80u;
+
+  /**
+   * The upper 16 bits of the hash are kept beside the class_def_idx, which has at most 16 bits,
+   * so that a match of the 7 bits of the control byte rarely needs to compare the strings.
+   */
   struct Entry {
-    uint32_t str_offset;
-    uint16_t data;
-    uint16_t next_pos_delta;
+    static constexpr uint32_t kHashMask = 0xffff0000u;
 
-    Entry() : str_offset(0), data(0), next_pos_delta(0) {}
+    uint32_t str_offset;
+    uint32_t data;
 
-    bool IsEmpty() const {
-      return str_offset == 0;
+    uint32_t GetClassDefIdx() const {
+      return data & ~kHashMask;
     }
 
-    bool IsLast() const {
-      return next_pos_delta == 0;
+    bool HashBitsMatch(uint32_t hash) const {
+      return ((data ^ hash) & kHashMask) == 0u;
     }
   };
 
-  static uint32_t CalculateMask(uint32_t num_class_defs);
+  static uint8_t GetTag(uint32_t hash) {
+    // The low bits select the group, use the high ones.
+    return static_cast<uint8_t>(hash >> 25);
+  }
+
+  // Return a mask with the bit `i` set if the control byte `i` of the group is `value`.
+  static uint32_t MatchGroup(const uint8_t* control, uint8_t value) {
+#if defined(__SSE2__)
+    __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+    __m128i match = _mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(value)));
+    return static_cast<uint32_t>(_mm_movemask_epi8(match));
+#else
+    return MatchWord(control, value) | (MatchWord(control + sizeof(uint64_t), value) << 8);
+#endif
+  }
+
+  // Return a mask with the bit `i` set if the byte `i` of the 8 bytes at `control` is `value`.
+  static uint32_t MatchWord(const uint8_t* control, uint8_t value) {
+    static constexpr uint64_t kLowBits = UINT64_C(0x7f7f7f7f7f7f7f7f);
+    uint64_t word;
+    memcpy(&word, control, sizeof(word));
+    uint64_t x = word ^ (UINT64_C(0x0101010101010101) * value);
+    // Set the high bit of the bytes of `x` that are zero, and only of those.
+    uint64_t zero = ~(((x & kLowBits) + kLowBits) | x | kLowBits);
+    // Gather the high bits into the top byte.
+    return static_cast<uint32_t>(((zero >> 7) * UINT64_C(0x0102040810204080)) >> 56);
+  }
+
+  static uint32_t CalculateGroupMask(uint32_t num_class_defs);
   static bool SupportedSize(uint32_t num_class_defs);
 
   // Construct from a dex file.
@@ -135,37 +170,24 @@ class TypeLookupTable {
         str, reinterpret_cast<const char*>(ptr)) == 0;
   }
 
-  // Method extracts hash bits from element's data and compare them with
-  // the corresponding bits of the specified hash
-  bool CmpHashBits(uint32_t data, uint32_t hash) const {
-    uint32_t mask = static_cast<uint16_t>(~GetSizeMask());
-    return (hash & mask) == (data & mask);
+  const Entry* GetEntries() const {
+    return reinterpret_cast<const Entry*>(raw_data_);
   }
 
-  uint32_t GetClassDefIdx(uint32_t data) const {
-    return data & mask_;
+  const uint8_t* GetControlBytes() const {
+    return raw_data_ + Size() * sizeof(Entry);
   }
 
-  uint32_t GetSizeMask() const {
-    return mask_;
-  }
-
-  // Attempt to set an entry on its hash's slot. If there is already something there, return false.
-  // Otherwise return true.
-  bool SetOnInitialPos(const Entry& entry, uint32_t hash);
-
-  // Insert an entry, probes until there is an empty slot.
+  // Insert an entry in the first empty slot of its probe sequence.
   void Insert(const Entry& entry, uint32_t hash);
 
-  // Find the last entry in a chain.
-  uint32_t FindLastEntryInBucket(uint32_t cur_pos) const;
-
   const uint8_t* dex_data_begin_;
   const uint32_t raw_data_length_;
-  const uint32_t mask_;
-  std::unique_ptr<Entry[]> entries_;
-  // owns_entries_ specifies if the lookup table owns the entries_ array.
-  const bool owns_entries_;
+  const uint32_t group_mask_;
+  // The storage allocated by the table when created without one.
+  std::unique_ptr<uint8_t[]> owned_storage_;
+  // The entries, followed by the control bytes.
+  uint8_t* const raw_data_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(TypeLookupTable);
 };
@@ -34,7 +34,18 @@ TEST_F(TypeLookupTableTest, CreateLookupTable) {
   std::unique_ptr<TypeLookupTable> table(TypeLookupTable::Create(*dex_file));
   ASSERT_NE(nullptr, table.get());
   ASSERT_NE(nullptr, table->RawData());
-  ASSERT_EQ(32U, table->RawDataLength());
+  ASSERT_EQ(144U, table->RawDataLength());
+}
+
+TEST_F(TypeLookupTableTest, FindAllClassDefs) {
+  ScopedObjectAccess soa(Thread::Current());
+  std::unique_ptr<const DexFile> dex_file(OpenTestDexFile("Interfaces"));
+  std::unique_ptr<TypeLookupTable> table(TypeLookupTable::Create(*dex_file));
+  ASSERT_NE(nullptr, table.get());
+  for (uint32_t i = 0; i < dex_file->NumClassDefs(); ++i) {
+    const char* descriptor = dex_file->GetClassDescriptor(dex_file->GetClassDef(i));
+    EXPECT_EQ(i, table->Lookup(descriptor, ComputeModifiedUtf8Hash(descriptor))) << descriptor;
+  }
 }
 
 TEST_P(TypeLookupTableTest, Find) {
@@ -31,8 +31,10 @@ namespace art {
 
 inline DexCacheArraysLayout::DexCacheArraysLayout(PointerSize pointer_size,
                                                   const DexFile::Header& header,
-                                                  uint32_t num_call_sites)
+                                                  uint32_t num_call_sites,
+                                                  bool large_caches)
     : pointer_size_(pointer_size),
+      large_caches_(large_caches),
       /* types_offset_ is always 0u, so it's constexpr */
       methods_offset_(
           RoundUp(types_offset_ + TypesSize(header.type_ids_size_), MethodsAlignment())),
@@ -48,8 +50,11 @@ inline DexCacheArraysLayout::DexCacheArraysLayout(PointerSize pointer_size,
       size_(RoundUp(call_sites_offset_ + CallSitesSize(num_call_sites), Alignment())) {
 }
 
-inline DexCacheArraysLayout::DexCacheArraysLayout(PointerSize pointer_size, const DexFile* dex_file)
-    : DexCacheArraysLayout(pointer_size, dex_file->GetHeader(), dex_file->NumCallSiteIds()) {
+inline DexCacheArraysLayout::DexCacheArraysLayout(PointerSize pointer_size,
+                                                  const DexFile* dex_file,
+                                                  bool large_caches)
+    : DexCacheArraysLayout(
+          pointer_size, dex_file->GetHeader(), dex_file->NumCallSiteIds(), large_caches) {
 }
 
 inline size_t DexCacheArraysLayout::Alignment() const {
@@ -76,15 +81,14 @@ constexpr PointerSize GcRootAsPointerSize() {
 }
 
 inline size_t DexCacheArraysLayout::TypeOffset(dex::TypeIndex type_idx) const {
+  DCHECK(!large_caches_);
   return types_offset_ + ElementOffset(PointerSize::k64,
                                        type_idx.index_ % mirror::DexCache::kDexCacheTypeCacheSize);
 }
 
 inline size_t DexCacheArraysLayout::TypesSize(size_t num_elements) const {
-  size_t cache_size = mirror::DexCache::kDexCacheTypeCacheSize;
-  if (num_elements < cache_size) {
-    cache_size = num_elements;
-  }
+  size_t cache_size = mirror::DexCache::NumCacheSlots(
+      num_elements, mirror::DexCache::kDexCacheTypeCacheSize, large_caches_);
   return PairArraySize(GcRootAsPointerSize<mirror::Class>(), cache_size);
 }
 
@@ -109,15 +113,14 @@ inline size_t DexCacheArraysLayout::MethodsAlignment() const {
 }
 
 inline size_t DexCacheArraysLayout::StringOffset(uint32_t string_idx) const {
+  DCHECK(!large_caches_);
   uint32_t string_hash = string_idx % mirror::DexCache::kDexCacheStringCacheSize;
   return strings_offset_ + ElementOffset(PointerSize::k64, string_hash);
 }
 
 inline size_t DexCacheArraysLayout::StringsSize(size_t num_elements) const {
-  size_t cache_size = mirror::DexCache::kDexCacheStringCacheSize;
-  if (num_elements < cache_size) {
-    cache_size = num_elements;
-  }
+  size_t cache_size = mirror::DexCache::NumCacheSlots(
+      num_elements, mirror::DexCache::kDexCacheStringCacheSize, large_caches_);
   return PairArraySize(GcRootAsPointerSize<mirror::String>(), cache_size);
 }
 
@@ -102,11 +102,6 @@ class InstructionFlags FINAL {
     return (flags_ & (1 << kReturn)) != 0;
   }
 
-  void SetCompileTimeInfoPointAndReturn() {
-    SetCompileTimeInfoPoint();
-    SetReturn();
-  }
-
   std::string ToString() const;
 
  private:
@@ -122,7 +117,7 @@ class InstructionFlags FINAL {
     kInTry = 3,
     // Instruction is the target of a branch (ie the start of a basic block).
     kBranchTarget = 4,
-    // Location of interest to the compiler for GC maps and verifier based method sharpening.
+    // Location of interest to the compiler after verification, the register line is kept there.
     kCompileTimeInfoPoint = 5,
     // A return instruction.
     kReturn = 6,
@@ -1080,31 +1080,23 @@ bool MethodVerifier::ScanTryCatchBlocks() {
 
 template <bool kAllowRuntimeOnlyInstructions>
 bool MethodVerifier::VerifyInstructions() {
-  /* Flag the start of the method as a branch target, and a GC point due to stack overflow errors */
+  /* Flag the start of the method as a branch target */
   GetInstructionFlags(0).SetBranchTarget();
-  GetInstructionFlags(0).SetCompileTimeInfoPoint();
   for (const DexInstructionPcPair& inst : code_item_accessor_) {
     const uint32_t dex_pc = inst.DexPc();
     if (!VerifyInstruction<kAllowRuntimeOnlyInstructions>(&inst.Inst(), dex_pc)) {
       DCHECK_NE(failures_.size(), 0U);
       return false;
     }
-    /* Flag instructions that are garbage collection points */
-    // All invoke points are marked as "Throw" points already.
-    // We are relying on this to also count all the invokes as interesting.
-    if (inst->IsBranch()) {
-      GetInstructionFlags(dex_pc).SetCompileTimeInfoPoint();
-      // The compiler also needs safepoints for fall-through to loop heads.
-      // Such a loop head must be a target of a branch.
-      int32_t offset = 0;
-      bool cond, self_ok;
-      bool target_ok = GetBranchOffset(dex_pc, &offset, &cond, &self_ok);
-      DCHECK(target_ok);
-      GetInstructionFlags(dex_pc + offset).SetCompileTimeInfoPoint();
-    } else if (inst->IsSwitch() || inst->IsThrow()) {
+    // The register lines are only kept at branch targets, which the flow analysis merges into,
+    // and at the few instructions the compiler looks at after verification. The compiler builds
+    // its own GC and deoptimization information, so branches, throwing instructions and returns
+    // do not need a line: the work line is carried over from the previous instruction.
+    if (inst->Opcode() == Instruction::CHECK_CAST) {
+      // Needed by VerifiedMethod::GenerateSafeCastSet.
       GetInstructionFlags(dex_pc).SetCompileTimeInfoPoint();
     } else if (inst->IsReturn()) {
-      GetInstructionFlags(dex_pc).SetCompileTimeInfoPointAndReturn();
+      GetInstructionFlags(dex_pc).SetReturn();
     }
   }
   return true;
@@ -57,8 +57,9 @@ using RegisterLineArenaUniquePtr = std::unique_ptr<RegisterLine, RegisterLineAre
 class RegType;
 
 // We don't need to store the register data for many instructions, because we either only need
-// it at branch points (for verification) or GC points and branches (for verification +
-// type-precise register analysis).
+// it at branch points (for verification) or at branch points and the few instructions the
+// compiler queries once verification is done, such as check-casts (for verification + cast
+// elision).
 enum RegisterTrackingMode {
   kTrackRegsBranches,
   kTrackCompilerInterestPoints,
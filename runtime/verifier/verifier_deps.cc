@@ -17,6 +17,7 @@
 #include "verifier_deps.h"
 
 #include <cstring>
+#include <unordered_map>
 
 #include "art_field-inl.h"
 #include "art_method-inl.h"
@@ -24,6 +25,7 @@
 #include "base/stl_util.h"
 #include "compiler_callbacks.h"
 #include "dex/dex_file-inl.h"
+#include "handle_scope-inl.h"
 #include "indenter.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
@@ -856,6 +858,20 @@ bool VerifierDeps::ValidateDependencies(Handle<mirror::ClassLoader> class_loader
   return true;
 }
 
+bool VerifierDeps::ValidateDependencies(Handle<mirror::ClassLoader> class_loader,
+                                        const DexFile& dex_file,
+                                        Thread* self) const {
+  const DexFileDeps* deps = GetDexFileDeps(dex_file);
+  return deps != nullptr && VerifyDexFile(class_loader, dex_file, *deps, self);
+}
+
+void VerifierDeps::ClearDependencies(const DexFile& dex_file) {
+  auto it = dex_deps_.find(&dex_file);
+  if (it != dex_deps_.end()) {
+    it->second.reset(new DexFileDeps());
+  }
+}
+
 // TODO: share that helper with other parts of the compiler that have
 // the same lookup pattern.
 static mirror::Class* FindClassAndClearException(ClassLinker* class_linker,
@@ -871,23 +887,48 @@ static mirror::Class* FindClassAndClearException(ClassLinker* class_linker,
   return result;
 }
 
-bool VerifierDeps::VerifyAssignability(Handle<mirror::ClassLoader> class_loader,
+class VerifierDeps::ClassCache {
+ public:
+  ClassCache(Handle<mirror::ClassLoader> class_loader, Thread* self)
+      : class_linker_(Runtime::Current()->GetClassLinker()),
+        class_loader_(class_loader),
+        self_(self),
+        handles_(self) {}
+
+  // Return the class `descriptor` resolves to, or null if it does not resolve.
+  Handle<mirror::Class> Find(const std::string& descriptor)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    auto it = classes_.find(descriptor);
+    if (it == classes_.end()) {
+      // The handles keep the classes alive and updated across the suspend points of FindClass.
+      Handle<mirror::Class> klass = handles_.NewHandle(FindClassAndClearException(
+          class_linker_, self_, descriptor.c_str(), class_loader_));
+      it = classes_.emplace(descriptor, klass).first;
+    }
+    return it->second;
+  }
+
+  Thread* Self() const {
+    return self_;
+  }
+
+ private:
+  ClassLinker* const class_linker_;
+  const Handle<mirror::ClassLoader> class_loader_;
+  Thread* const self_;
+  VariableSizedHandleScope handles_;
+  std::unordered_map<std::string, Handle<mirror::Class>> classes_;
+};
+
+bool VerifierDeps::VerifyAssignability(ClassCache* class_cache,
                                        const DexFile& dex_file,
                                        const std::set<TypeAssignability>& assignables,
-                                       bool expected_assignability,
-                                       Thread* self) const {
-  StackHandleScope<2> hs(self);
-  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-  MutableHandle<mirror::Class> source(hs.NewHandle<mirror::Class>(nullptr));
-  MutableHandle<mirror::Class> destination(hs.NewHandle<mirror::Class>(nullptr));
-
+                                       bool expected_assignability) const {
   for (const auto& entry : assignables) {
     const std::string& destination_desc = GetStringFromId(dex_file, entry.GetDestination());
-    destination.Assign(
-        FindClassAndClearException(class_linker, self, destination_desc.c_str(), class_loader));
+    Handle<mirror::Class> destination = class_cache->Find(destination_desc);
     const std::string& source_desc = GetStringFromId(dex_file, entry.GetSource());
-    source.Assign(
-        FindClassAndClearException(class_linker, self, source_desc.c_str(), class_loader));
+    Handle<mirror::Class> source = class_cache->Find(source_desc);
 
     if (destination == nullptr) {
       LOG(INFO) << "VerifiersDeps: Could not resolve class " << destination_desc;
@@ -912,16 +953,12 @@ bool VerifierDeps::VerifyAssignability(Handle<mirror::ClassLoader> class_loader,
   return true;
 }
 
-bool VerifierDeps::VerifyClasses(Handle<mirror::ClassLoader> class_loader,
+bool VerifierDeps::VerifyClasses(ClassCache* class_cache,
                                  const DexFile& dex_file,
-                                 const std::set<ClassResolution>& classes,
-                                 Thread* self) const {
-  StackHandleScope<1> hs(self);
-  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-  MutableHandle<mirror::Class> cls(hs.NewHandle<mirror::Class>(nullptr));
+                                 const std::set<ClassResolution>& classes) const {
   for (const auto& entry : classes) {
     const char* descriptor = dex_file.StringByTypeIdx(entry.GetDexTypeIndex());
-    cls.Assign(FindClassAndClearException(class_linker, self, descriptor, class_loader));
+    Handle<mirror::Class> cls = class_cache->Find(descriptor);
 
     if (entry.IsResolved()) {
       if (cls == nullptr) {
@@ -955,13 +992,12 @@ static std::string GetFieldDescription(const DexFile& dex_file, uint32_t index)
       + dex_file.GetFieldTypeDescriptor(field_id);
 }
 
-bool VerifierDeps::VerifyFields(Handle<mirror::ClassLoader> class_loader,
+bool VerifierDeps::VerifyFields(ClassCache* class_cache,
                                 const DexFile& dex_file,
-                                const std::set<FieldResolution>& fields,
-                                Thread* self) const {
+                                const std::set<FieldResolution>& fields) const {
   // Check recorded fields are resolved the same way, have the same recorded class,
   // and have the same recorded flags.
-  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  Thread* self = class_cache->Self();
   for (const auto& entry : fields) {
     const DexFile::FieldId& field_id = dex_file.GetFieldId(entry.GetDexFieldIndex());
     StringPiece name(dex_file.StringDataByIdx(field_id.name_idx_));
@@ -971,15 +1007,14 @@ bool VerifierDeps::VerifyFields(Handle<mirror::ClassLoader> class_loader,
     std::string expected_decl_klass = entry.IsResolved()
         ? GetStringFromId(dex_file, entry.GetDeclaringClassIndex())
         : dex_file.StringByTypeIdx(field_id.class_idx_);
-    mirror::Class* cls = FindClassAndClearException(
-        class_linker, self, expected_decl_klass.c_str(), class_loader);
+    Handle<mirror::Class> cls = class_cache->Find(expected_decl_klass);
     if (cls == nullptr) {
       LOG(INFO) << "VerifierDeps: Could not resolve class " << expected_decl_klass;
       return false;
     }
     DCHECK(cls->IsResolved());
 
-    ArtField* field = mirror::Class::FindField(self, cls, name, type);
+    ArtField* field = mirror::Class::FindField(self, cls.Get(), name, type);
     if (entry.IsResolved()) {
       std::string temp;
       if (field == nullptr) {
@@ -1016,12 +1051,10 @@ static std::string GetMethodDescription(const DexFile& dex_file, uint32_t index)
       + dex_file.GetMethodSignature(method_id).ToString();
 }
 
-bool VerifierDeps::VerifyMethods(Handle<mirror::ClassLoader> class_loader,
+bool VerifierDeps::VerifyMethods(ClassCache* class_cache,
                                  const DexFile& dex_file,
-                                 const std::set<MethodResolution>& methods,
-                                 Thread* self) const {
-  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-  PointerSize pointer_size = class_linker->GetImagePointerSize();
+                                 const std::set<MethodResolution>& methods) const {
+  PointerSize pointer_size = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
 
   for (const auto& entry : methods) {
     const DexFile::MethodId& method_id = dex_file.GetMethodId(entry.GetDexMethodIndex());
@@ -1034,8 +1067,7 @@ bool VerifierDeps::VerifyMethods(Handle<mirror::ClassLoader> class_loader,
         ? GetStringFromId(dex_file, entry.GetDeclaringClassIndex())
         : dex_file.StringByTypeIdx(method_id.class_idx_);
 
-    mirror::Class* cls = FindClassAndClearException(
-        class_linker, self, expected_decl_klass.c_str(), class_loader);
+    Handle<mirror::Class> cls = class_cache->Find(expected_decl_klass);
     if (cls == nullptr) {
       LOG(INFO) << "VerifierDeps: Could not resolve class " << expected_decl_klass;
       return false;
@@ -1087,15 +1119,16 @@ bool VerifierDeps::VerifyDexFile(Handle<mirror::ClassLoader> class_loader,
                                  const DexFile& dex_file,
                                  const DexFileDeps& deps,
                                  Thread* self) const {
+  ClassCache class_cache(class_loader, self);
   bool result = VerifyAssignability(
-      class_loader, dex_file, deps.assignable_types_, /* expected_assignability */ true, self);
+      &class_cache, dex_file, deps.assignable_types_, /* expected_assignability */ true);
   result = result && VerifyAssignability(
-      class_loader, dex_file, deps.unassignable_types_, /* expected_assignability */ false, self);
+      &class_cache, dex_file, deps.unassignable_types_, /* expected_assignability */ false);
 
-  result = result && VerifyClasses(class_loader, dex_file, deps.classes_, self);
-  result = result && VerifyFields(class_loader, dex_file, deps.fields_, self);
+  result = result && VerifyClasses(&class_cache, dex_file, deps.classes_);
+  result = result && VerifyFields(&class_cache, dex_file, deps.fields_);
 
-  result = result && VerifyMethods(class_loader, dex_file, deps.methods_, self);
+  result = result && VerifyMethods(&class_cache, dex_file, deps.methods_);
 
   return result;
 }
@@ -117,6 +117,16 @@ class VerifierDeps {
   bool ValidateDependencies(Handle<mirror::ClassLoader> class_loader, Thread* self) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Verify the encoded dependencies of `dex_file` are still valid. Return false if there are no
+  // dependencies for `dex_file`.
+  bool ValidateDependencies(Handle<mirror::ClassLoader> class_loader,
+                            const DexFile& dex_file,
+                            Thread* self) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Drop the dependencies recorded for `dex_file`, before verifying it again.
+  void ClearDependencies(const DexFile& dex_file);
+
   const std::set<dex::TypeIndex>& GetUnverifiedClasses(const DexFile& dex_file) const {
     return GetDexFileDeps(dex_file)->unverified_classes_;
   }
@@ -281,6 +291,10 @@ class VerifierDeps {
 
   bool Equals(const VerifierDeps& rhs) const;
 
+  // Cache of the classes looked up by descriptor while validating the dependencies. The same
+  // classes are referenced by many entries, and each `FindClass` walks the class loader chain.
+  class ClassCache;
+
   // Verify `dex_file` according to the `deps`, that is going over each
   // `DexFileDeps` field, and checking that the recorded information still
   // holds.
@@ -290,38 +304,34 @@ class VerifierDeps {
                      Thread* self) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  bool VerifyAssignability(Handle<mirror::ClassLoader> class_loader,
+  bool VerifyAssignability(ClassCache* class_cache,
                            const DexFile& dex_file,
                            const std::set<TypeAssignability>& assignables,
-                           bool expected_assignability,
-                           Thread* self) const
+                           bool expected_assignability) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Verify that the set of resolved classes at the point of creation
   // of this `VerifierDeps` is still the same.
-  bool VerifyClasses(Handle<mirror::ClassLoader> class_loader,
+  bool VerifyClasses(ClassCache* class_cache,
                      const DexFile& dex_file,
-                     const std::set<ClassResolution>& classes,
-                     Thread* self) const
+                     const std::set<ClassResolution>& classes) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Verify that the set of resolved fields at the point of creation
   // of this `VerifierDeps` is still the same, and each field resolves to the
   // same field holder and access flags.
-  bool VerifyFields(Handle<mirror::ClassLoader> class_loader,
+  bool VerifyFields(ClassCache* class_cache,
                     const DexFile& dex_file,
-                    const std::set<FieldResolution>& classes,
-                    Thread* self) const
+                    const std::set<FieldResolution>& classes) const
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::verifier_deps_lock_);
 
   // Verify that the set of resolved methods at the point of creation
   // of this `VerifierDeps` is still the same, and each method resolves to the
   // same method holder, access flags, and invocation kind.
-  bool VerifyMethods(Handle<mirror::ClassLoader> class_loader,
+  bool VerifyMethods(ClassCache* class_cache,
                      const DexFile& dex_file,
-                     const std::set<MethodResolution>& methods,
-                     Thread* self) const
+                     const std::set<MethodResolution>& methods) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Map from DexFiles into dependencies collected from verification of their methods.
@@ -14,12 +14,21 @@
  * limitations under the License.
  */
 
+#include <pthread.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <unordered_map>
 #include <vector>
 #include <algorithm>
 
 #include "vtune_support.h"
-#include "mapping_table.h"
+#include "base/logging.h"
 #include "oat_file-inl.h"
+#include "oat_quick_method_header.h"
+#include "stack_map.h"
+#include "dex/descriptors_names.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_instruction.h"
 #include "vtune/jitprofiling.h"
@@ -156,78 +165,151 @@ static void getLineInfoForDex(const CodeItemDataAccessor& accessor, LineInfoTabl
 // 5. set any other environment vars for the profiler lib (output path, ...)
 static const char * ART_VTUNE_JIT_API_SRC = getenv("ART_VTUNE_JIT_API_SRC");
 
-void SendMethodToVTune(const char* method_name,
-                       const void* code,
-                       size_t code_size,
-                       const char* class_file_name,
-                       const char* source_file_name,
-                       const DexFile* dex_file,
-		       const uint32_t method_idx,
-                       const DexFile::CodeItem* code_item) {
-  if (code == nullptr) {
-    return;
+// A method load or unload event waiting to be sent to VTune. Unload events only use `code`.
+// The event owns all its data: the code is only used as an address and may be freed before the
+// event is sent, and so may the stack maps and the dex file the line number table is built from.
+struct VTuneMethodLoad {
+  bool is_unload;
+  std::string method_name;
+  std::string class_file_name;
+  std::string source_file_name;
+  const void* code;
+  size_t code_size;
+  LineInfoTable line_number_table;
+  VTuneMethodLoad* next;  // Link of the VTuneEventQueue.
+};
+
+// Unbounded lock-free queue of method load events, with multiple producers (the JIT threads,
+// and the threads freeing code while holding the JIT code cache lock) and a single consumer
+// (the VTune flush thread). Producers push onto a list which the consumer takes as a whole,
+// so that queuing an event never waits for the consumer.
+class VTuneEventQueue {
+ public:
+  VTuneEventQueue() : head_(nullptr) {}
+
+  void Push(VTuneMethodLoad* event) {
+    VTuneMethodLoad* head = head_.load(std::memory_order_relaxed);
+    do {
+      event->next = head;
+    } while (!head_.compare_exchange_weak(head, event, std::memory_order_release));
   }
 
-  // Older versions of VTune treated IDs < 1000 as reserved.
-  static unsigned next_method_id = 1000;
-  next_method_id++;
+  // Returns the queued events in queuing order, or null if there are none. Must only be
+  // called by the consumer.
+  VTuneMethodLoad* PopAll() {
+    VTuneMethodLoad* head = head_.exchange(nullptr, std::memory_order_acquire);
+    VTuneMethodLoad* reversed = nullptr;
+    while (head != nullptr) {
+      VTuneMethodLoad* next = head->next;
+      head->next = reversed;
+      reversed = head;
+      head = next;
+    }
+    return reversed;
+  }
+
+ private:
+  std::atomic<VTuneMethodLoad*> head_;
+};
 
-  const char *method_name_c = strchr(method_name, ' '); // skip return type
+// The flush thread sends the queued events in batches, at the lowest priority.
+static constexpr useconds_t kVTuneFlushPeriodUs = 20 * 1000;
+static constexpr int kVTuneFlushThreadPriority = 19;
 
+static VTuneEventQueue* vtune_event_queue = nullptr;
+static pthread_once_t vtune_flush_thread_once = PTHREAD_ONCE_INIT;
+static pthread_t vtune_flush_pthread;
+static std::atomic<bool> vtune_flush_thread_started(false);
+static std::atomic<bool> vtune_flush_thread_stopping(false);
+
+// VTune ids of the loaded methods, by code address. Only used by the flush thread.
+static std::unordered_map<const void*, unsigned>* vtune_method_ids = nullptr;
+
+// Send a method unload event to VTune, for a method previously sent by NotifyMethodLoad().
+static void NotifyMethodUnload(VTuneMethodLoad* event) {
+  auto it = vtune_method_ids->find(event->code);
+  if (it == vtune_method_ids->end()) {
+    return;
+  }
   iJIT_Method_Load jit_method;
   memset(&jit_method, 0, sizeof(jit_method));
-  jit_method.class_file_name = const_cast<char*>(class_file_name);
-  jit_method.source_file_name = const_cast<char*>(source_file_name);
-  jit_method.method_name = const_cast<char*>(method_name_c == nullptr ?
-      method_name : (method_name_c + 1));
-  jit_method.method_id = next_method_id;
-  jit_method.method_load_address = const_cast<void*>(code);
-  jit_method.method_size = code_size;
-
-  // dump positions
-  // TODO: Get the table from StackMaps
-  MappingTable table(nullptr);
+  jit_method.method_id = it->second;
+  vtune_method_ids->erase(it);
+  if (!iJIT_NotifyEvent(iJVM_EVENT_TYPE_METHOD_UNLOAD_START, (void*)&jit_method)) {
+    LOG(WARNING) << "JIT API: failed to unload method id=" << jit_method.method_id
+                 << ", address=" << event->code;
+  }
+}
 
-  // prepare pc2src to point to either pc2java or pc2dex
-  LineInfoTable *pc2src = nullptr;
+// Build the line number table of a compiled method from its stack maps at `code_info`.
+static void BuildLineNumberTable(size_t code_size,
+                                 const DexFile* dex_file,
+                                 uint32_t method_idx,
+                                 const DexFile::CodeItem* code_item,
+                                 const void* code_info_ptr,
+                                 /*out*/ LineInfoTable* table) {
+  DCHECK(table->empty());
+  if (dex_file == nullptr || code_item == nullptr || code_info_ptr == nullptr ||
+      (ART_VTUNE_JIT_API_SRC != nullptr && strcmp(ART_VTUNE_JIT_API_SRC, "none") == 0)) {
+    return;
+  }
   LineInfoTable pc2dex;
-  LineInfoTable pc2java;
+  CodeInfo code_info(code_info_ptr);
+  CodeInfoEncoding encoding = code_info.ExtractEncoding();
+  for (size_t i = 0, e = code_info.GetNumberOfStackMaps(encoding); i != e; ++i) {
+    StackMap stack_map = code_info.GetStackMapAt(i, encoding);
+    pc2dex.push_back({stack_map.GetNativePcOffset(encoding.stack_map.encoding, kRuntimeISA),
+                      stack_map.GetDexPc(encoding.stack_map.encoding)});
+  }
+  if (pc2dex.empty()) {
+    // No stack maps, no line numbers.
+    return;
+  }
+
   CodeItemDebugInfoAccessor accessor(*dex_file, code_item, method_idx);
-  if (dex_file != nullptr && code_item != nullptr &&
-      (ART_VTUNE_JIT_API_SRC == nullptr || strcmp(ART_VTUNE_JIT_API_SRC, "none") != 0) &&
-      table.TotalSize() != 0 && table.PcToDexSize() != 0) {
-    for (MappingTable::PcToDexIterator cur = table.PcToDexBegin(),
-                                       end = table.PcToDexEnd(); cur != end; ++cur) {
-      pc2dex.push_back({cur.NativePcOffset(), cur.DexPc()});
+  if (ART_VTUNE_JIT_API_SRC != nullptr && strcmp(ART_VTUNE_JIT_API_SRC, "dex") == 0) {
+    getLineInfoForDex(accessor, pc2dex);
+    table->swap(pc2dex);
+    // TODO: set dexdump file name for this method
+  } else { // default is pc -> java
+    const uint8_t* dbgstream = dex_file->GetDebugInfoStream(accessor.DebugInfoOffset());
+    if (dbgstream != nullptr) {
+      getLineInfoForJava(dbgstream, *table, pc2dex);
     }
+  }
+  if (table->empty()) {
+    return;
+  }
 
-    if (ART_VTUNE_JIT_API_SRC != nullptr && strcmp(ART_VTUNE_JIT_API_SRC, "dex") == 0) {
-      pc2src = &pc2dex;
-      getLineInfoForDex(accessor, pc2dex);
-      // TODO: set dexdump file name for this method
-    } else { // default is pc -> java
-      pc2src = &pc2java;
-
-      //CodeItemDebugInfoAccessor accessor(dex_file, code_item, method_idx);
-      const uint8_t* dbgstream = dex_file->GetDebugInfoStream(accessor.DebugInfoOffset());
-      getLineInfoForJava(dbgstream, pc2java, pc2dex);
-    }
+  // shift offsets
+  SortLineNumberInfoByOffset::sort(*table);
+  for (unsigned i = 1; i < table->size(); ++i) {
+    (*table)[i - 1].Offset = (*table)[i].Offset;
   }
+  (*table)[table->size() - 1].Offset = code_size;
+}
 
-  if (pc2src == nullptr || pc2src->size() == 0) {
-    jit_method.line_number_size = 0;
-    jit_method.line_number_table = nullptr;
-  } else {
-    // shift offsets
-    SortLineNumberInfoByOffset::sort(*pc2src);
-    for (unsigned i = 1; i < pc2src->size(); ++i) {
-      (*pc2src)[i - 1].Offset = (*pc2src)[i].Offset;
-    }
-    (*pc2src)[pc2src->size() - 1].Offset = code_size;
+// Send a method load event to VTune.
+static void NotifyMethodLoad(VTuneMethodLoad* event) {
+  // Older versions of VTune treated IDs < 1000 as reserved.
+  static unsigned next_method_id = 1000;
+  unsigned method_id = ++next_method_id;
+  (*vtune_method_ids)[event->code] = method_id;
 
-    jit_method.line_number_size = pc2src->size();
-    jit_method.line_number_table = pc2src->size() == 0 ? nullptr : &((*pc2src)[0]);
-  }
+  const char *method_name_c = strchr(event->method_name.c_str(), ' '); // skip return type
+
+  iJIT_Method_Load jit_method;
+  memset(&jit_method, 0, sizeof(jit_method));
+  jit_method.class_file_name = const_cast<char*>(event->class_file_name.c_str());
+  jit_method.source_file_name = const_cast<char*>(event->source_file_name.c_str());
+  jit_method.method_name = const_cast<char*>(method_name_c == nullptr ?
+      event->method_name.c_str() : (method_name_c + 1));
+  jit_method.method_id = method_id;
+  jit_method.method_load_address = const_cast<void*>(event->code);
+  jit_method.method_size = event->code_size;
+  jit_method.line_number_size = event->line_number_table.size();
+  jit_method.line_number_table =
+      event->line_number_table.empty() ? nullptr : event->line_number_table.data();
 
   int is_notified = iJIT_NotifyEvent(iJVM_EVENT_TYPE_METHOD_LOAD_FINISHED, (void*)&jit_method);
   if (is_notified) {
@@ -235,7 +317,7 @@ void SendMethodToVTune(const char* method_name,
                << "' is written successfully: id=" << jit_method.method_id
                << ", address=" << jit_method.method_load_address
                << ", size=" << jit_method.method_size;
-  } else if (true) {
+  } else {
     LOG(WARNING) << "JIT API: failed to write method '" << jit_method.method_name
                  << "': id=" << jit_method.method_id
                  << ", address=" << jit_method.method_load_address
@@ -243,4 +325,140 @@ void SendMethodToVTune(const char* method_name,
   }
 }
 
+static void FlushVTuneEvents() {
+  VTuneMethodLoad* event = vtune_event_queue->PopAll();
+  while (event != nullptr) {
+    if (event->is_unload) {
+      NotifyMethodUnload(event);
+    } else {
+      NotifyMethodLoad(event);
+    }
+    VTuneMethodLoad* next = event->next;
+    delete event;
+    event = next;
+  }
+}
+
+static void* VTuneFlushThread(void* arg ATTRIBUTE_UNUSED) {
+  if (setpriority(PRIO_PROCESS, 0, kVTuneFlushThreadPriority) != 0) {
+    PLOG(WARNING) << "Failed to setpriority of the VTune flush thread";
+  }
+  while (!vtune_flush_thread_stopping.load(std::memory_order_acquire)) {
+    // Drain the queue, then give the JIT threads some time to queue the next batch.
+    FlushVTuneEvents();
+    usleep(kVTuneFlushPeriodUs);
+  }
+  // Send the events queued before the stop request.
+  FlushVTuneEvents();
+  return nullptr;
+}
+
+static void StartVTuneFlushThread() {
+  vtune_event_queue = new VTuneEventQueue();
+  vtune_method_ids = new std::unordered_map<const void*, unsigned>();
+  const char* reason = "VTune flush thread";
+  CHECK_PTHREAD_CALL(pthread_create, (&vtune_flush_pthread, nullptr, &VTuneFlushThread, nullptr),
+                     reason);
+  vtune_flush_thread_started.store(true, std::memory_order_release);
+}
+
+void StopVTuneFlushThread() {
+  if (!vtune_flush_thread_started.load(std::memory_order_acquire)) {
+    return;
+  }
+  vtune_flush_thread_stopping.store(true, std::memory_order_release);
+  CHECK_PTHREAD_CALL(pthread_join, (vtune_flush_pthread, nullptr), "VTune flush thread shutdown");
+}
+
+// Queue an event for the flush thread. Events are never dropped and stay in order. This does
+// not block, as it is called with the JIT code cache lock held when freeing code.
+static void QueueVTuneEvent(VTuneMethodLoad* event) {
+  pthread_once(&vtune_flush_thread_once, StartVTuneFlushThread);
+  vtune_event_queue->Push(event);
+}
+
+void SendMethodToVTune(const char* method_name,
+                       const void* code,
+                       size_t code_size,
+                       const char* class_file_name,
+                       const char* source_file_name,
+                       const DexFile* dex_file,
+                       const uint32_t method_idx,
+                       const DexFile::CodeItem* code_item,
+                       const void* code_info) {
+  if (code == nullptr) {
+    return;
+  }
+  VTuneMethodLoad* event = new VTuneMethodLoad();
+  event->is_unload = false;
+  event->method_name = method_name;
+  event->class_file_name = (class_file_name != nullptr) ? class_file_name : "";
+  event->source_file_name = (source_file_name != nullptr) ? source_file_name : "";
+  event->code = code;
+  event->code_size = code_size;
+  BuildLineNumberTable(
+      code_size, dex_file, method_idx, code_item, code_info, &event->line_number_table);
+  QueueVTuneEvent(event);
+}
+
+void SendMethodUnloadToVTune(const void* code) {
+  VTuneMethodLoad* event = new VTuneMethodLoad();
+  event->is_unload = true;
+  event->code = code;
+  event->code_size = 0u;
+  QueueVTuneEvent(event);
+}
+
+// Set ART_VTUNE_OAT=true to also report the methods of the executable oat files.
+static const char * ART_VTUNE_OAT = getenv("ART_VTUNE_OAT");
+
+void SendOatFileToVTune(const OatFile& oat_file) {
+  if (ART_VTUNE_OAT == nullptr || strcmp(ART_VTUNE_OAT, "true") != 0 || !oat_file.IsExecutable()) {
+    return;
+  }
+  for (const OatDexFile* oat_dex_file : oat_file.GetOatDexFiles()) {
+    std::string error_msg;
+    std::unique_ptr<const DexFile> owned_dex_file = oat_dex_file->OpenDexFile(&error_msg);
+    if (owned_dex_file == nullptr) {
+      LOG(WARNING) << "JIT API: cannot open " << oat_dex_file->GetDexFileLocation()
+                   << ": " << error_msg;
+      continue;
+    }
+    // The events do not refer to the dex file, it is released once its methods are queued.
+    const DexFile* dex_file = owned_dex_file.get();
+    for (uint32_t class_def_index = 0; class_def_index != dex_file->NumClassDefs();
+         ++class_def_index) {
+      const DexFile::ClassDef& class_def = dex_file->GetClassDef(class_def_index);
+      const uint8_t* class_data = dex_file->GetClassData(class_def);
+      if (class_data == nullptr) {
+        continue;
+      }
+      OatFile::OatClass oat_class = oat_dex_file->GetOatClass(class_def_index);
+      std::string class_name = PrettyDescriptor(dex_file->GetClassDescriptor(class_def));
+      const char* source_file_name = dex_file->GetSourceFile(class_def);
+      ClassDataItemIterator it(*dex_file, class_data);
+      it.SkipAllFields();
+      for (uint32_t class_def_method_index = 0; it.HasNextMethod();
+           ++class_def_method_index, it.Next()) {
+        const OatFile::OatMethod oat_method = oat_class.GetOatMethod(class_def_method_index);
+        const OatQuickMethodHeader* method_header = oat_method.GetOatQuickMethodHeader();
+        if (method_header == nullptr) {
+          continue;
+        }
+        SendMethodToVTune(dex_file->PrettyMethod(it.GetMemberIndex()).c_str(),
+                          method_header->GetCode(),
+                          method_header->GetCodeSize(),
+                          class_name.c_str(),
+                          source_file_name,
+                          dex_file,
+                          it.GetMemberIndex(),
+                          it.GetMethodCodeItem(),
+                          method_header->IsOptimized()
+                              ? method_header->GetOptimizedCodeInfoPtr()
+                              : nullptr);
+      }
+    }
+  }
+}
+
 }  // namespace art
@@ -22,7 +22,9 @@
 namespace art {
 
 /*
- * @brief Send compiled method's code to VTune.
+ * @brief Send compiled method's code to VTune. The line number table is built from the stack
+ * maps at `code_info` before returning, and the method load event is queued and sent by a low
+ * priority background thread. Only the address of the code is kept.
  */
 void SendMethodToVTune(const char* method_name,
                        const void* code,
@@ -30,8 +32,25 @@ void SendMethodToVTune(const char* method_name,
                        const char* class_file_name = nullptr,
                        const char* source_file_name = nullptr,
                        const DexFile* dex_file = nullptr,
-		       const uint32_t method_idx = 0,
-                       const DexFile::CodeItem* code_item = nullptr);
+                       const uint32_t method_idx = 0,
+                       const DexFile::CodeItem* code_item = nullptr,
+                       const void* code_info = nullptr);
+
+/*
+ * @brief Tell VTune that the code sent by SendMethodToVTune is being freed.
+ */
+void SendMethodUnloadToVTune(const void* code);
+
+/*
+ * @brief Send the compiled methods of an executable oat file to VTune. Opt-in, this only
+ * does something if the ART_VTUNE_OAT environment variable is set to "true".
+ */
+void SendOatFileToVTune(const OatFile& oat_file);
+
+/*
+ * @brief Send the queued events and stop the background thread. Called at runtime shutdown.
+ */
+void StopVTuneFlushThread();
 
 }  // namespace art
 
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vtune_tasks.h"
+
+#include <dlfcn.h>
+#include <pthread.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "base/logging.h"
+
+// The interlocked helpers of the config are only needed by the static part of libittnotify.
+#define ITT_SIMPLE_INIT 1
+#include "vtune/ittnotify_config.h"
+
+// Layouts of the ittnotify.h types used by the task API, which is not vendored.
+#pragma pack(push, 8)
+
+typedef struct ___itt_domain {
+  volatile int flags;  // Zero if the collector disabled the domain.
+  const char* nameA;
+  void* nameW;
+  int extra1;
+  void* extra2;
+  struct ___itt_domain* next;
+} __itt_domain;
+
+typedef struct ___itt_id {
+  unsigned long long d1, d2, d3;  // NOLINT(runtime/int)
+} __itt_id;
+
+#pragma pack(pop)
+
+namespace art {
+
+#if ITT_ARCH == ITT_ARCH_IA32 || ITT_ARCH == ITT_ARCH_ARM
+static constexpr const char* kIttCollectorEnvironmentVar = "INTEL_LIBITTNOTIFY32";
+#else
+static constexpr const char* kIttCollectorEnvironmentVar = "INTEL_LIBITTNOTIFY64";
+#endif
+// Same default location as the JIT profiling agent.
+static constexpr const char* kAndroidIttCollectorPath = "/data/intel/libittnotify.so";
+
+typedef __itt_domain* (ITTAPI* IttDomainCreate)(const char* name);
+typedef ___itt_string_handle* (ITTAPI* IttStringHandleCreate)(const char* name);
+typedef void (ITTAPI* IttTaskBegin)(const __itt_domain* domain,
+                                    __itt_id task_id,
+                                    __itt_id parent_id,
+                                    ___itt_string_handle* name);
+typedef void (ITTAPI* IttTaskEnd)(const __itt_domain* domain);
+typedef void (ITTAPI* IttApiInit)(__itt_global* global, __itt_group_id init_groups);
+
+static IttDomainCreate itt_domain_create = nullptr;
+static IttStringHandleCreate itt_string_handle_create = nullptr;
+static IttTaskBegin itt_task_begin = nullptr;
+static IttTaskEnd itt_task_end = nullptr;
+
+// The API table handed to the collector, which fills in the functions it implements.
+static __itt_api_info itt_api_list[] = {
+  { "__itt_domain_create", reinterpret_cast<void**>(&itt_domain_create),
+    nullptr, nullptr, __itt_group_structure },
+  { "__itt_string_handle_create", reinterpret_cast<void**>(&itt_string_handle_create),
+    nullptr, nullptr, __itt_group_structure },
+  { "__itt_task_begin", reinterpret_cast<void**>(&itt_task_begin),
+    nullptr, nullptr, __itt_group_structure },
+  { "__itt_task_end", reinterpret_cast<void**>(&itt_task_end),
+    nullptr, nullptr, __itt_group_structure },
+  { nullptr, nullptr, nullptr, nullptr, __itt_group_none },
+};
+
+static constexpr const char* kVTuneTaskNames[] = {
+  "GC",
+  "GC pause",
+  "GC marking phase",
+  "GC reclaim phase",
+  "JIT compile method",
+  "Class initialization",
+  "Suspend all threads",
+};
+static_assert(arraysize(kVTuneTaskNames) == static_cast<size_t>(VTuneTask::kLast) + 1u,
+              "Missing VTune task names");
+
+static const __itt_id kIttNullId = { 0u, 0u, 0u };
+
+// Set ART_VTUNE_ITT=true to annotate the runtime tasks.
+static const char * ART_VTUNE_ITT = getenv("ART_VTUNE_ITT");
+
+static pthread_once_t itt_init_once = PTHREAD_ONCE_INIT;
+static __itt_global itt_global;
+static const char* itt_collector_path = nullptr;
+static const __itt_domain* itt_domain = nullptr;
+static ___itt_string_handle* itt_task_names[arraysize(kVTuneTaskNames)];
+
+static void InitItt() {
+  if (ART_VTUNE_ITT == nullptr || strcmp(ART_VTUNE_ITT, "true") != 0) {
+    return;
+  }
+  itt_collector_path = getenv(kIttCollectorEnvironmentVar);
+  if (itt_collector_path == nullptr) {
+    itt_collector_path = kAndroidIttCollectorPath;
+  }
+  void* lib = dlopen(itt_collector_path, RTLD_LAZY);
+  if (lib == nullptr) {
+    LOG(WARNING) << "ITT API: cannot load " << itt_collector_path << ": " << dlerror();
+    return;
+  }
+  IttApiInit api_init = reinterpret_cast<IttApiInit>(dlsym(lib, "__itt_api_init"));
+  if (api_init != nullptr) {
+    // Same handshake as the static part of libittnotify.
+    static const unsigned char kMagic[] = ITT_MAGIC;
+    memcpy(itt_global.magic, kMagic, sizeof(kMagic));
+    itt_global.version_major = 3;
+    itt_global.version_minor = 0;
+    itt_global.version_build = API_VERSION_BUILD;
+    pthread_mutex_init(&itt_global.mutex, nullptr);
+    itt_global.mutex_initialized = 1;
+    itt_global.lib = lib;
+    itt_global.dll_path_ptr = &itt_collector_path;
+    itt_global.api_list_ptr = itt_api_list;
+    itt_global.state = __itt_collection_normal;
+    api_init(&itt_global, __itt_group_structure);
+    itt_global.api_initialized = 1;
+  } else {
+    // Older collectors export the API functions directly.
+    for (__itt_api_info* api = itt_api_list; api->name != nullptr; ++api) {
+      *api->func_ptr = dlsym(lib, api->name);
+    }
+  }
+  if (itt_domain_create == nullptr ||
+      itt_string_handle_create == nullptr ||
+      itt_task_begin == nullptr ||
+      itt_task_end == nullptr) {
+    LOG(WARNING) << "ITT API: " << itt_collector_path << " does not support tasks";
+    return;
+  }
+  for (size_t i = 0; i != arraysize(kVTuneTaskNames); ++i) {
+    itt_task_names[i] = itt_string_handle_create(kVTuneTaskNames[i]);
+  }
+  itt_domain = itt_domain_create("ART");
+}
+
+static bool BeginVTuneTask(VTuneTask task) {
+  pthread_once(&itt_init_once, InitItt);
+  if (itt_domain == nullptr || itt_domain->flags == 0) {
+    return false;
+  }
+  itt_task_begin(itt_domain, kIttNullId, kIttNullId, itt_task_names[static_cast<size_t>(task)]);
+  return true;
+}
+
+ScopedVTuneTask::ScopedVTuneTask(VTuneTask task) : begun_(BeginVTuneTask(task)) {}
+
+ScopedVTuneTask::~ScopedVTuneTask() {
+  if (begun_) {
+    itt_task_end(itt_domain);
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_VTUNE_TASKS_H_
+#define ART_RUNTIME_VTUNE_TASKS_H_
+
+#include "base/macros.h"
+
+namespace art {
+
+// Runtime work shown as ITT tasks on the VTune timeline.
+enum class VTuneTask {
+  kGcRun,
+  kGcPause,
+  kGcMarkingPhase,
+  kGcReclaimPhase,
+  kJitCompileMethod,
+  kClassInitialization,
+  kSuspendAll,
+  kLast = kSuspendAll,
+};
+
+/*
+ * @brief Mark the lifetime of a scope as a task of the calling thread on the VTune timeline.
+ * Opt-in, this only does something if the ART_VTUNE_ITT environment variable is set to
+ * "true" and the ITT collector library can be loaded. Tasks of a thread must nest.
+ */
+class ScopedVTuneTask {
+ public:
+  explicit ScopedVTuneTask(VTuneTask task);
+  ~ScopedVTuneTask();
+
+ private:
+  // Whether the task was begun, so that it is ended even if the collector changed its mind.
+  const bool begun_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedVTuneTask);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_VTUNE_TASKS_H_
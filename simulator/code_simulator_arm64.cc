@@ -49,6 +49,49 @@ CodeSimulatorArm64::~CodeSimulatorArm64() {
   delete decoder_;
 }
 
+uint64_t InstructionCounter::GetInstructionCount() const {
+  uint64_t count = 0u;
+  for (uint64_t form_count : counts_) {
+    count += form_count;
+  }
+  return count;
+}
+
+uint64_t InstructionCounter::GetEstimatedCycles() const {
+  uint64_t cycles = 0u;
+  for (size_t i = 0; i != counts_.size(); ++i) {
+    cycles += counts_[i] * CostOf(static_cast<Form>(i));
+  }
+  return cycles;
+}
+
+uint64_t InstructionCounter::CostOf(Form form) {
+  // Typical latencies of a small in-order core, assuming that the next instruction uses the
+  // result. The loads hit in the L1 cache, and the stores and branches do not stall.
+  switch (form) {
+    case Form::kLoadLiteral:
+    case Form::kLoadStorePairOffset:
+    case Form::kLoadStorePairPostIndex:
+    case Form::kLoadStorePairPreIndex:
+    case Form::kLoadStorePostIndex:
+    case Form::kLoadStorePreIndex:
+    case Form::kLoadStoreRegisterOffset:
+    case Form::kLoadStoreUnscaledOffset:
+    case Form::kLoadStoreUnsignedOffset:
+    case Form::kLoadStoreExclusive:
+    case Form::kDataProcessing3Source:  // The multiplies.
+      return 3u;
+    case Form::kFPDataProcessing1Source:
+    case Form::kFPDataProcessing2Source:
+    case Form::kFPDataProcessing3Source:
+    case Form::kFPIntegerConvert:
+    case Form::kFPFixedPointConvert:
+      return 4u;
+    default:
+      return 1u;
+  }
+}
+
 void CodeSimulatorArm64::RunFrom(intptr_t code_buffer) {
   DCHECK(kCanSimulate);
   simulator_->RunFrom(reinterpret_cast<const Instruction*>(code_buffer));
@@ -69,5 +112,23 @@ int64_t CodeSimulatorArm64::GetCReturnInt64() const {
   return simulator_->ReadXRegister(0);
 }
 
+void CodeSimulatorArm64::EnableInstructionCounting() {
+  DCHECK(kCanSimulate);
+  if (counter_ == nullptr) {
+    counter_.reset(new InstructionCounter());
+    decoder_->AppendVisitor(counter_.get());
+  }
+}
+
+uint64_t CodeSimulatorArm64::GetInstructionCount() const {
+  DCHECK(kCanSimulate);
+  return (counter_ != nullptr) ? counter_->GetInstructionCount() : 0u;
+}
+
+uint64_t CodeSimulatorArm64::GetEstimatedCycles() const {
+  DCHECK(kCanSimulate);
+  return (counter_ != nullptr) ? counter_->GetEstimatedCycles() : 0u;
+}
+
 }  // namespace arm64
 }  // namespace art
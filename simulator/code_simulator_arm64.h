@@ -17,7 +17,8 @@
 #ifndef ART_SIMULATOR_CODE_SIMULATOR_ARM64_H_
 #define ART_SIMULATOR_CODE_SIMULATOR_ARM64_H_
 
-#include "memory"
+#include <array>
+#include <memory>
 
 // TODO(VIXL): Make VIXL compile with -Wshadow.
 #pragma GCC diagnostic push
@@ -31,6 +32,41 @@
 namespace art {
 namespace arm64 {
 
+// Counts the simulated instructions by form. It is appended to the visitors of the decoder after
+// the simulator, and only observes the instructions.
+//
+// The simulator itself is not sped up: there is no translation mode nor decode cache, as VIXL
+// decodes each instruction inside Simulator::ExecuteInstruction, out of reach of this wrapper.
+class InstructionCounter : public vixl::aarch64::DecoderVisitor {
+ public:
+  InstructionCounter() : counts_() {}
+
+#define DECLARE(A)                                                                     \
+  void Visit##A(const vixl::aarch64::Instruction* instr ATTRIBUTE_UNUSED) OVERRIDE {   \
+    ++counts_[static_cast<size_t>(Form::k##A)];                                        \
+  }
+  VISITOR_LIST(DECLARE)
+#undef DECLARE
+
+  uint64_t GetInstructionCount() const;
+  uint64_t GetEstimatedCycles() const;
+
+ private:
+  enum class Form : size_t {
+#define DECLARE(A) k##A,
+    VISITOR_LIST(DECLARE)
+#undef DECLARE
+    kLast
+  };
+
+  // The estimated cycles of an instruction of `form`, including its result latency.
+  static uint64_t CostOf(Form form);
+
+  std::array<uint64_t, static_cast<size_t>(Form::kLast)> counts_;
+
+  DISALLOW_COPY_AND_ASSIGN(InstructionCounter);
+};
+
 class CodeSimulatorArm64 : public CodeSimulator {
  public:
   static CodeSimulatorArm64* CreateCodeSimulatorArm64();
@@ -42,11 +78,17 @@ class CodeSimulatorArm64 : public CodeSimulator {
   int32_t GetCReturnInt32() const OVERRIDE;
   int64_t GetCReturnInt64() const OVERRIDE;
 
+  void EnableInstructionCounting() OVERRIDE;
+  uint64_t GetInstructionCount() const OVERRIDE;
+  uint64_t GetEstimatedCycles() const OVERRIDE;
+
  private:
   CodeSimulatorArm64();
 
   vixl::aarch64::Decoder* decoder_;
   vixl::aarch64::Simulator* simulator_;
+  // Null until counting is enabled.
+  std::unique_ptr<InstructionCounter> counter_;
 
   // TODO: Enable CodeSimulatorArm64 for more host ISAs once Simulator supports them.
   static constexpr bool kCanSimulate = (kRuntimeISA == InstructionSet::kX86_64);
@@ -35,6 +35,17 @@ class CodeSimulator {
   virtual int32_t GetCReturnInt32() const = 0;
   virtual int64_t GetCReturnInt64() const = 0;
 
+  // Count the simulated instructions from now on, across runs. Counting slows down the
+  // simulation, so it is off by default.
+  virtual void EnableInstructionCounting() = 0;
+
+  // The number of instructions simulated since counting was enabled.
+  virtual uint64_t GetInstructionCount() const = 0;
+
+  // A coarse estimate of the cycles taken by the counted instructions on an in-order core. It is
+  // meant to compare the code generated for the same methods, not to predict real timings.
+  virtual uint64_t GetEstimatedCycles() const = 0;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(CodeSimulator);
 };
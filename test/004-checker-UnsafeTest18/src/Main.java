@@ -50,6 +50,10 @@ public class Main {
   /// CHECK-START: int Main.set32(java.lang.Object, long, int) intrinsics_recognition (after)
   /// CHECK-DAG: <<Result:i\d+>> InvokeVirtual intrinsic:UnsafeGetAndSetInt
   /// CHECK-DAG:                 Return [<<Result>>]
+  /// CHECK-START-X86_64: int Main.set32(java.lang.Object, long, int) disassembly (after)
+  /// CHECK:     InvokeVirtual intrinsic:UnsafeGetAndSetInt
+  /// CHECK-NOT: call
+  /// CHECK:     xchg
   private static int set32(Object o, long offset, int newValue) {
     return unsafe.getAndSetInt(o, offset, newValue);
   }
@@ -64,6 +68,9 @@ public class Main {
   /// CHECK-START: java.lang.Object Main.setObj(java.lang.Object, long, java.lang.Object) intrinsics_recognition (after)
   /// CHECK-DAG: <<Result:l\d+>> InvokeVirtual intrinsic:UnsafeGetAndSetObject
   /// CHECK-DAG:                 Return [<<Result>>]
+  /// CHECK-START-X86_64: java.lang.Object Main.setObj(java.lang.Object, long, java.lang.Object) disassembly (after)
+  /// CHECK:     InvokeVirtual intrinsic:UnsafeGetAndSetObject
+  /// CHECK:     xchg
   private static Object setObj(Object o, long offset, Object newValue) {
     return unsafe.getAndSetObject(o, offset, newValue);
   }
@@ -75,6 +82,10 @@ public class Main {
   /// CHECK-START: int Main.add32(java.lang.Object, long, int) intrinsics_recognition (after)
   /// CHECK-DAG: <<Result:i\d+>> InvokeVirtual intrinsic:UnsafeGetAndAddInt
   /// CHECK-DAG:                 Return [<<Result>>]
+  /// CHECK-START-X86_64: int Main.add32(java.lang.Object, long, int) disassembly (after)
+  /// CHECK:     InvokeVirtual intrinsic:UnsafeGetAndAddInt
+  /// CHECK-NOT: call
+  /// CHECK:     lock xadd
   private static int add32(Object o, long offset, int delta) {
     return unsafe.getAndAddInt(o, offset, delta);
   }
@@ -82,6 +93,10 @@ public class Main {
   /// CHECK-START: long Main.add64(java.lang.Object, long, long) intrinsics_recognition (after)
   /// CHECK-DAG: <<Result:j\d+>> InvokeVirtual intrinsic:UnsafeGetAndAddLong
   /// CHECK-DAG:                 Return [<<Result>>]
+  /// CHECK-START-X86_64: long Main.add64(java.lang.Object, long, long) disassembly (after)
+  /// CHECK:     InvokeVirtual intrinsic:UnsafeGetAndAddLong
+  /// CHECK-NOT: call
+  /// CHECK:     lock xadd
   private static long add64(Object o, long offset, long delta) {
     return unsafe.getAndAddLong(o, offset, delta);
   }
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <vector>
+
+#include "jvmti.h"
+
+// Test infrastructure
+#include "jvmti_helper.h"
+#include "scoped_local_ref.h"
+#include "test_env.h"
+
+namespace art {
+namespace Test1951MethodEventFilter {
+
+typedef jvmtiError (*SetMethodEventFilter)(jvmtiEnv* env, jint count, const jmethodID* methods);
+
+template <typename T>
+static void Dealloc(T* t) {
+  jvmti_env->Deallocate(reinterpret_cast<unsigned char*>(t));
+}
+
+template <typename T, typename ...Rest>
+static void Dealloc(T* t, Rest... rs) {
+  Dealloc(t);
+  Dealloc(rs...);
+}
+
+static SetMethodEventFilter FindSetMethodEventFilter(JNIEnv* env) {
+  jint n_ext = 0;
+  jvmtiExtensionFunctionInfo* infos = nullptr;
+  if (JvmtiErrorToException(env, jvmti_env, jvmti_env->GetExtensionFunctions(&n_ext, &infos))) {
+    return nullptr;
+  }
+  SetMethodEventFilter set_method_event_filter = nullptr;
+  for (jint i = 0; i < n_ext; i++) {
+    jvmtiExtensionFunctionInfo* cur_info = &infos[i];
+    if (strcmp("com.android.art.method.set_method_event_filter", cur_info->id) == 0) {
+      set_method_event_filter = reinterpret_cast<SetMethodEventFilter>(cur_info->func);
+    }
+    for (jint j = 0; j < cur_info->param_count; j++) {
+      Dealloc(cur_info->params[j].name);
+    }
+    Dealloc(cur_info->id, cur_info->short_description, cur_info->params, cur_info->errors);
+  }
+  Dealloc(infos);
+  if (set_method_event_filter == nullptr) {
+    ScopedLocalRef<jclass> rt_exception(env, env->FindClass("java/lang/RuntimeException"));
+    env->ThrowNew(rt_exception.get(), "Unable to find the method event filter extension.");
+  }
+  return set_method_event_filter;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_Main_setMethodEventFilter(
+    JNIEnv* env, jclass, jobjectArray methods) {
+  SetMethodEventFilter set_method_event_filter = FindSetMethodEventFilter(env);
+  if (set_method_event_filter == nullptr) {
+    return;
+  }
+  std::vector<jmethodID> method_ids;
+  for (jsize i = 0; i < env->GetArrayLength(methods); i++) {
+    ScopedLocalRef<jobject> method(env, env->GetObjectArrayElement(methods, i));
+    method_ids.push_back(env->FromReflectedMethod(method.get()));
+  }
+  JvmtiErrorToException(env,
+                        jvmti_env,
+                        set_method_event_filter(jvmti_env,
+                                                static_cast<jint>(method_ids.size()),
+                                                method_ids.data()));
+}
+
+}  // namespace Test1951MethodEventFilter
+}  // namespace art
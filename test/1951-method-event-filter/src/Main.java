@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.ref.WeakReference;
+import java.lang.reflect.Constructor;
+import java.lang.reflect.Executable;
+import java.lang.reflect.Method;
+import java.util.Base64;
+import art.Redefinition;
+import art.Trace;
+
+public class Main {
+  static final String DEX_FILE =
+      System.getenv("DEX_LOCATION") + "/1951-method-event-filter-ex.jar";
+
+  static class Transform {
+    public void sayHi() {
+      System.out.println("Hello");
+    }
+  }
+
+  /**
+   * base64 encoded class/dex file for
+   * class Transform {
+   *   public void sayHi() {
+   *    System.out.println("Goodbye");
+   *   }
+   * }
+   */
+  private static final byte[] DEX_BYTES = Base64.getDecoder().decode(
+    "ZGV4CjAzNQA7jFommHUzfbuvjq/I2cDcwdjqQk6KPfqYAwAAcAAAAHhWNBIAAAAAAAAAANQCAAAU" +
+    "AAAAcAAAAAkAAADAAAAAAgAAAOQAAAABAAAA/AAAAAQAAAAEAQAAAQAAACQBAABUAgAARAEAAJ4B" +
+    "AACmAQAArwEAAMEBAADJAQAA7QEAAA0CAAAkAgAAOAIAAEwCAABgAgAAawIAAHYCAAB5AgAAfQIA" +
+    "AIoCAACQAgAAlQIAAJ4CAAClAgAAAgAAAAMAAAAEAAAABQAAAAYAAAAHAAAACAAAAAkAAAAMAAAA" +
+    "DAAAAAgAAAAAAAAADQAAAAgAAACYAQAABwAEABAAAAAAAAAAAAAAAAAAAAASAAAABAABABEAAAAF" +
+    "AAAAAAAAAAAAAAAAAAAABQAAAAAAAAAKAAAAiAEAAMYCAAAAAAAAAgAAALcCAAC9AgAAAQABAAEA" +
+    "AACsAgAABAAAAHAQAwAAAA4AAwABAAIAAACxAgAACAAAAGIAAAAaAQEAbiACABAADgBEAQAAAAAA" +
+    "AAAAAAAAAAAAAQAAAAYABjxpbml0PgAHR29vZGJ5ZQAQTE1haW4kVHJhbnNmb3JtOwAGTE1haW47" +
+    "ACJMZGFsdmlrL2Fubm90YXRpb24vRW5jbG9zaW5nQ2xhc3M7AB5MZGFsdmlrL2Fubm90YXRpb24v" +
+    "SW5uZXJDbGFzczsAFUxqYXZhL2lvL1ByaW50U3RyZWFtOwASTGphdmEvbGFuZy9PYmplY3Q7ABJM" +
+    "amF2YS9sYW5nL1N0cmluZzsAEkxqYXZhL2xhbmcvU3lzdGVtOwAJTWFpbi5qYXZhAAlUcmFuc2Zv" +
+    "cm0AAVYAAlZMAAthY2Nlc3NGbGFncwAEbmFtZQADb3V0AAdwcmludGxuAAVzYXlIaQAFdmFsdWUA" +
+    "EgAHDgAUAAcOeAACAgETGAECAwIOBAgPFwsAAAEBAICABNACAQHoAhAAAAAAAAAAAQAAAAAAAAAB" +
+    "AAAAFAAAAHAAAAACAAAACQAAAMAAAAADAAAAAgAAAOQAAAAEAAAAAQAAAPwAAAAFAAAABAAAAAQB" +
+    "AAAGAAAAAQAAACQBAAADEAAAAQAAAEQBAAABIAAAAgAAAFABAAAGIAAAAQAAAIgBAAABEAAAAQAA" +
+    "AJgBAAACIAAAFAAAAJ4BAAADIAAAAgAAAKwCAAAEIAAAAgAAALcCAAAAIAAAAQAAAMYCAAAAEAAA" +
+    "AQAAANQCAAA=");
+
+  public static void notifyMethodEntry(Executable e) {
+    System.out.println("\tEntering " + e);
+  }
+
+  public static void notFiltered() {
+    System.out.println("Not filtered");
+  }
+
+  public static void enableTracing() throws Exception {
+    Trace.enableMethodTracing(
+        Main.class,
+        Main.class.getDeclaredMethod("notifyMethodEntry", Executable.class),
+        null,
+        Thread.currentThread());
+  }
+
+  public static void main(String[] args) throws Exception {
+    Trace.disableTracing(Thread.currentThread());
+    Transform t = new Transform();
+    Method sayHi = Transform.class.getDeclaredMethod("sayHi");
+
+    System.out.println("Filtering sayHi");
+    setMethodEventFilter(new Executable[] { sayHi });
+    enableTracing();
+    t.sayHi();
+    notFiltered();
+
+    // The redefined method is no longer filtered, and nothing else is.
+    System.out.println("Redefining Transform");
+    Redefinition.doCommonClassRedefinition(Transform.class, new byte[0], DEX_BYTES);
+    t.sayHi();
+    notFiltered();
+    Trace.disableTracing(Thread.currentThread());
+
+    System.out.println("Filtering sayHi and a method of another class loader");
+    WeakReference<ClassLoader> loader = filterTargetMethod(sayHi);
+    System.out.println("Unloading the other class loader");
+    for (int i = 0; i != 5 && loader.get() != null; ++i) {
+      Runtime.getRuntime().gc();
+      System.runFinalization();
+    }
+    // Whether or not the class loader is gone, the events of the filter still work.
+    enableTracing();
+    t.sayHi();
+    notFiltered();
+    Trace.disableTracing(Thread.currentThread());
+    setMethodEventFilter(new Executable[0]);
+  }
+
+  private static WeakReference<ClassLoader> filterTargetMethod(Method sayHi) throws Exception {
+    Class<?> pathClassLoader = Class.forName("dalvik.system.PathClassLoader");
+    Constructor<?> constructor =
+        pathClassLoader.getDeclaredConstructor(String.class, ClassLoader.class);
+    ClassLoader loader =
+        (ClassLoader) constructor.newInstance(DEX_FILE, ClassLoader.getSystemClassLoader());
+    Method run = loader.loadClass("Target").getDeclaredMethod("run");
+    setMethodEventFilter(new Executable[] { sayHi, run });
+    enableTracing();
+    run.invoke(null);
+    Trace.disableTracing(Thread.currentThread());
+    return new WeakReference<ClassLoader>(loader);
+  }
+
+  private static native void setMethodEventFilter(Executable[] methods);
+}
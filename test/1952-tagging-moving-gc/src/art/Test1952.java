@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package art;
+
+public class Test1952 {
+  private static final int NUM_OBJECTS = 4096;
+
+  public static void run() {
+    Object[] objects = new Object[NUM_OBJECTS];
+    long[] tags = new long[NUM_OBJECTS];
+    for (int i = 0; i != NUM_OBJECTS; ++i) {
+      // Mix a few sizes so that the objects do not all move by the same offset.
+      objects[i] = (i % 3 == 0) ? new Object() : new int[i % 7];
+    }
+
+    // Tag every other object.
+    for (int i = 0; i != NUM_OBJECTS; i += 2) {
+      setTag(objects, tags, i, i + 1);
+    }
+    collect();
+    checkTags("tag", objects, tags);
+
+    // Untag half of the tagged objects and tag half of the untagged ones.
+    for (int i = 0; i != NUM_OBJECTS; i += 4) {
+      setTag(objects, tags, i, 0);
+      setTag(objects, tags, i + 1, i + 2);
+    }
+    collect();
+    checkTags("untag", objects, tags);
+
+    // Re-tag the untagged objects with new tags, before and after another collection.
+    for (int i = 0; i != NUM_OBJECTS; i += 4) {
+      setTag(objects, tags, i, NUM_OBJECTS + i);
+    }
+    checkTags("re-tag", objects, tags);
+    collect();
+    checkTags("re-tag after gc", objects, tags);
+
+    // Drop all the tags. Lookups must miss even though the filter may still report them.
+    for (int i = 0; i != NUM_OBJECTS; ++i) {
+      setTag(objects, tags, i, 0);
+    }
+    checkTags("clear", objects, tags);
+    collect();
+    checkTags("clear after gc", objects, tags);
+
+    System.out.println("passed");
+  }
+
+  private static void setTag(Object[] objects, long[] tags, int i, long tag) {
+    Main.setTag(objects[i], tag);
+    tags[i] = tag;
+  }
+
+  private static void collect() {
+    // Two collections, so that objects surviving the first one are moved again.
+    Runtime.getRuntime().gc();
+    Runtime.getRuntime().gc();
+  }
+
+  private static void checkTags(String step, Object[] objects, long[] tags) {
+    for (int i = 0; i != objects.length; ++i) {
+      long tag = Main.getTag(objects[i]);
+      if (tag != tags[i]) {
+        throw new RuntimeException(
+            step + ": object " + i + " has tag " + tag + ", expected " + tags[i]);
+      }
+    }
+  }
+}
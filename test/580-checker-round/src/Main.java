@@ -141,6 +141,16 @@ public class Main {
     expectEquals64(9223372036854775807L,
         round64(Math.nextAfter(9223372036854775808.0, Double.POSITIVE_INFINITY)));
 
+    // Near minint and maxint, where the result stops fitting an int.
+    expectEquals64(-2147483649L, round64(-2147483648.51d));
+    expectEquals64(-2147483648L, round64(-2147483648.5d));
+    expectEquals64(-2147483648L, round64(-2147483648.0d));
+    expectEquals64(-2147483647L, round64(-2147483647.5d));
+    expectEquals64(2147483647L, round64(2147483646.5d));
+    expectEquals64(2147483647L, round64(2147483647.0d));
+    expectEquals64(2147483648L, round64(2147483647.5d));
+    expectEquals64(4294967296L, round64(4294967296.0d));
+
     // Some others.
     for (long l = -100; l <= 100; ++l) {
       expectEquals64(l - 1, round64((double) l - 0.51d));
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  public static void main(String[] args) {
+    // Periodic text, so that substrings have many partial matches.
+    StringBuilder ascii = new StringBuilder();
+    StringBuilder wide = new StringBuilder();
+    for (int i = 0; i < 70; ++i) {
+      ascii.append((char) ('a' + (i % 3 == 0 ? 0 : i % 7)));
+      wide.append((char) ('\u0100' + (i % 3 == 0 ? 0 : i % 7)));
+    }
+    for (int length = 0; length <= ascii.length(); length += 7) {
+      testString(ascii.substring(0, length));
+      testString(wide.substring(0, length));
+      testString(ascii.substring(0, length / 2) + wide.substring(0, length - length / 2));
+    }
+
+    assertEquals(-1, $noinline$indexOf("abc", "\u0100"));
+    assertEquals(-1, $noinline$indexOf("abc", "a\u0100"));
+    assertEquals(1, $noinline$indexOf("\u0100abc", "ab"));
+    assertEquals(0, $noinline$indexOf("abc", ""));
+    assertEquals(3, $noinline$indexOf("abc", "", 5));
+    assertEquals(-1, $noinline$indexOf("abc", "abcd"));
+    assertEquals(16, $noinline$indexOf("0123456789abcdefg", "g"));
+    assertEquals(9, $noinline$indexOf("\u010001234567\u0101", "\u0101"));
+    try {
+      $noinline$indexOf("abc", null);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    try {
+      $noinline$indexOf("abc", null, 1);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    System.out.println("passed");
+  }
+
+  static void testString(String s) {
+    for (int begin = 0; begin < s.length(); ++begin) {
+      for (int end = begin + 1; end <= s.length() && end - begin <= 20; ++end) {
+        String sub = s.substring(begin, end);
+        assertEquals(referenceIndexOf(s, sub, 0), $noinline$indexOf(s, sub));
+        for (int start = -2; start <= s.length() + 2; start += 3) {
+          assertEquals(referenceIndexOf(s, sub, start), $noinline$indexOf(s, sub, start));
+        }
+      }
+    }
+    // Substrings that do not occur, differing in the last char.
+    for (int length = 1; length <= 20 && length <= s.length(); ++length) {
+      String sub = s.substring(0, length - 1) + 'z';
+      assertEquals(referenceIndexOf(s, sub, 0), $noinline$indexOf(s, sub));
+    }
+  }
+
+  static int referenceIndexOf(String s, String sub, int start) {
+    start = Math.max(start, 0);
+    for (int i = start; i + sub.length() <= s.length(); ++i) {
+      int j = 0;
+      while (j < sub.length() && s.charAt(i + j) == sub.charAt(j)) {
+        ++j;
+      }
+      if (j == sub.length()) {
+        return i;
+      }
+    }
+    return (sub.length() == 0) ? Math.min(start, s.length()) : -1;
+  }
+
+  static int $noinline$indexOf(String s, String sub) {
+    return s.indexOf(sub);
+  }
+
+  static int $noinline$indexOf(String s, String sub, int start) {
+    return s.indexOf(sub, start);
+  }
+
+  static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected: " + expected + ", found: " + actual);
+    }
+  }
+}
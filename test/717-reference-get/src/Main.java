@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.ref.PhantomReference;
+import java.lang.ref.ReferenceQueue;
+import java.lang.ref.SoftReference;
+import java.lang.ref.WeakReference;
+
+public class Main {
+  static final int ITERATIONS = 100000;
+
+  static volatile boolean done = false;
+
+  public static void main(String[] args) throws Exception {
+    Object strong = new Object();
+    WeakReference<Object> weak = new WeakReference<>(strong);
+    SoftReference<Object> soft = new SoftReference<>(strong);
+    PhantomReference<Object> phantom = new PhantomReference<>(strong, new ReferenceQueue<>());
+
+    // Keep the collector busy, so that some reads hit the slow path.
+    Thread gc = new Thread() {
+      public void run() {
+        while (!done) {
+          Runtime.getRuntime().gc();
+        }
+      }
+    };
+    gc.start();
+    for (int i = 0; i < ITERATIONS; ++i) {
+      assertIs(strong, getWeak(weak));
+      assertIs(strong, getSoft(soft));
+      assertIs(null, phantom.get());
+    }
+
+    WeakReference<Object> cleared = new WeakReference<>(new Object());
+    cleared.clear();
+    for (int i = 0; i < ITERATIONS; ++i) {
+      assertIs(null, getWeak(cleared));
+    }
+    done = true;
+    gc.join();
+
+    try {
+      getWeak(null);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+
+    // Keep `strong` reachable until all reads are done.
+    assertIs(strong, getWeak(weak));
+    System.out.println("passed");
+  }
+
+  static Object getWeak(WeakReference<Object> ref) {
+    return ref.get();
+  }
+
+  static Object getSoft(SoftReference<Object> ref) {
+    return ref.get();
+  }
+
+  static void assertIs(Object expected, Object actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Tests for vectorization of conditional loop-bodies and widening sum reductions.
+ */
+public class Main {
+
+  static final int N = 1027;  // odd, so the cleanup loop is exercised too
+
+  /// CHECK-START: int Main.condSumInt(int[], int) loop_optimization (before)
+  /// CHECK-DAG: <<Get:i\d+>>    ArrayGet                          loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Cond:z\d+>>   {{GreaterThan|LessThanOrEqual}} [<<Get>>,{{i\d+}}] loop:<<Loop>> outer_loop:none
+  /// CHECK-DAG:                 If [<<Cond>>]                     loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-START: int Main.condSumInt(int[], int) loop_optimization (after)
+  /// CHECK-DAG: <<Phi:i\d+>>    Phi                               loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Get:i\d+>>    ArrayGet                          loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: <<Cond:z\d+>>   {{GreaterThan|LessThanOrEqual}} [<<Get>>,{{i\d+}}] loop:<<Loop>> outer_loop:none
+  /// CHECK-DAG: <<Sel:i\d+>>    Select [{{i\d+}},{{i\d+}},<<Cond>>] loop:<<Loop>>  outer_loop:none
+  /// CHECK-DAG:                 Add [<<Phi>>,<<Sel>>]             loop:<<Loop>>      outer_loop:none
+  private static int condSumInt(int[] a, int t) {
+    int sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      if (a[i] > t) {
+        sum += a[i];
+      }
+    }
+    return sum;
+  }
+
+  private static int condSumByte(byte[] b) {
+    int sum = 0;
+    for (int i = 0; i < b.length; i++) {
+      if (b[i] < 0) {
+        sum += b[i];
+      }
+    }
+    return sum;
+  }
+
+  private static int sumByte(byte[] b) {
+    int sum = 0;
+    for (int i = 0; i < b.length; i++) {
+      sum += b[i];
+    }
+    return sum;
+  }
+
+  private static int sumByteUnsigned(byte[] b) {
+    int sum = 0;
+    for (int i = 0; i < b.length; i++) {
+      sum += b[i] & 0xff;
+    }
+    return sum;
+  }
+
+  private static int sumChar(char[] c) {
+    int sum = 0;
+    for (int i = 0; i < c.length; i++) {
+      sum += c[i];
+    }
+    return sum;
+  }
+
+  private static int sumShort(short[] s) {
+    int sum = 0;
+    for (int i = 0; i < s.length; i++) {
+      sum += s[i];
+    }
+    return sum;
+  }
+
+  private static void clampInt(int[] a, int t) {
+    for (int i = 0; i < a.length; i++) {
+      int x = a[i];
+      a[i] = x > t ? t : x;
+    }
+  }
+
+  //
+  // Reference versions, with a non-unit stride that keeps them sequential.
+  //
+
+  private static int condSumIntRef(int[] a, int t) {
+    int sum = 0;
+    for (int i = a.length - 1; i >= 0; i--) {
+      if (a[i] > t) {
+        sum += a[i];
+      }
+    }
+    return sum;
+  }
+
+  private static int condSumByteRef(byte[] b) {
+    int sum = 0;
+    for (int i = b.length - 1; i >= 0; i--) {
+      if (b[i] < 0) {
+        sum += b[i];
+      }
+    }
+    return sum;
+  }
+
+  private static int sumByteRef(byte[] b, int mask) {
+    int sum = 0;
+    for (int i = b.length - 1; i >= 0; i--) {
+      sum += b[i] & mask;
+    }
+    return sum;
+  }
+
+  public static void main(String[] args) {
+    int[] xi = new int[N];
+    byte[] xb = new byte[N];
+    char[] xc = new char[N];
+    short[] xs = new short[N];
+    int char_sum = 0;
+    int short_sum = 0;
+    for (int i = 0; i < N; i++) {
+      xi[i] = (i * 1103515245) >> 7;
+      xb[i] = (byte) (i * 37);
+      xc[i] = (char) (i * 997 + 40000);
+      xs[i] = (short) (i * -997 + 12345);
+      char_sum += xc[i];
+      short_sum += xs[i];
+    }
+
+    expectEquals(condSumIntRef(xi, 0), condSumInt(xi, 0));
+    expectEquals(condSumIntRef(xi, 1000), condSumInt(xi, 1000));
+    expectEquals(condSumIntRef(xi, Integer.MIN_VALUE), condSumInt(xi, Integer.MIN_VALUE));
+    expectEquals(condSumByteRef(xb), condSumByte(xb));
+    expectEquals(sumByteRef(xb, -1), sumByte(xb));
+    expectEquals(sumByteRef(xb, 0xff), sumByteUnsigned(xb));
+    expectEquals(char_sum, sumChar(xc));
+    expectEquals(short_sum, sumShort(xs));
+
+    // Small arrays only take the sequential loops.
+    expectEquals(0, sumByte(new byte[0]));
+    expectEquals(-3, sumByte(new byte[] { -1, -1, -1 }));
+    expectEquals(765, sumByteUnsigned(new byte[] { -1, -1, -1 }));
+
+    int[] copy = xi.clone();
+    clampInt(xi, 12345);
+    for (int i = 0; i < N; i++) {
+      expectEquals(copy[i] > 12345 ? 12345 : copy[i], xi[i]);
+    }
+
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
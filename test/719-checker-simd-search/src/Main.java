@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Tests for vectorization of early-exit search loops.
+ */
+public class Main {
+
+  static final int N = 1027;  // odd, so the scalar loop finds the tail elements too
+
+  /// CHECK-START-X86_64: int Main.indexOfInt(int[], int) loop_optimization (after)
+  /// CHECK-DAG: <<Rep:d\d+>>    VecReplicateScalar                loop:none
+  /// CHECK-DAG: <<Load:d\d+>>   VecLoad                           loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Cond:d\d+>>   VecCondition [<<Load>>,<<Rep>>]   loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: <<Any:z\d+>>    VecAnyTrue [<<Cond>>]             loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                 Select [{{i\d+}},{{i\d+}},<<Any>>] loop:<<Loop>>     outer_loop:none
+  /// CHECK-DAG: <<Get:i\d+>>    ArrayGet                          loop:<<Scalar:B\d+>> outer_loop:none
+  /// CHECK-DAG:                 {{Equal|NotEqual}} [<<Get>>,{{i\d+}}] loop:<<Scalar>> outer_loop:none
+  private static int indexOfInt(int[] a, int v) {
+    for (int i = 0; i < a.length; i++) {
+      if (a[i] == v) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  private static int indexOfChar(char[] a, char v) {
+    for (int i = 0; i < a.length; i++) {
+      if (a[i] == v) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  private static int indexOfByteFrom(byte[] a, byte v, int from) {
+    for (int i = from; i < a.length; i++) {
+      if (a[i] == v) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  private static int skipInt(int[] a, int v) {
+    int i = 0;
+    for (; i < a.length; i++) {
+      if (a[i] != v) {
+        break;
+      }
+    }
+    return i;
+  }
+
+  private static int mismatchShort(short[] a, short[] b) {
+    if (a.length != b.length) {
+      return -2;
+    }
+    for (int i = 0; i < a.length; i++) {
+      if (a[i] != b[i]) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  // The elements are compared once extended to int, so the same bits of a short and a char
+  // may differ: the comparison cannot be vectorized.
+
+  /// CHECK-START-X86_64: int Main.mismatchShortChar(short[], char[]) loop_optimization (after)
+  /// CHECK-NOT: VecLoad
+  /// CHECK-NOT: VecCondition
+  private static int mismatchShortChar(short[] a, char[] b) {
+    int n = Math.min(a.length, b.length);
+    for (int i = 0; i < n; i++) {
+      if (a[i] != b[i]) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  private static int mismatchShiftedInt(int[] a) {
+    for (int i = 0; i < a.length - 1; i++) {
+      if (a[i] != a[i + 1]) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  // Reference versions, which search backwards.
+
+  private static int lastIndexOf(int[] a, int v, int from) {
+    int r = -1;
+    for (int i = a.length - 1; i >= from; i--) {
+      if (a[i] == v) {
+        r = i;
+      }
+    }
+    return r;
+  }
+
+  public static void main(String[] args) {
+    int[] ia = new int[N];
+    char[] ca = new char[N];
+    byte[] ba = new byte[N];
+    short[] sa = new short[N];
+    short[] sb = new short[N];
+    short[] sc = new short[N];
+    char[] cb = new char[N];
+    for (int i = 0; i < N; i++) {
+      ia[i] = 7;
+      ca[i] = 'a';
+      ba[i] = (byte) 1;
+      sa[i] = sb[i] = (short) 0x8001;
+      sc[i] = (short) 0x0071;
+      cb[i] = (char) 0x0071;
+    }
+
+    // Nothing is found.
+    expectEquals(-1, indexOfInt(ia, 8));
+    expectEquals(-1, indexOfChar(ca, 'b'));
+    expectEquals(-1, indexOfByteFrom(ba, (byte) 2, 0));
+    expectEquals(N, skipInt(ia, 7));
+    expectEquals(-1, mismatchShort(sa, sb));
+    expectEquals(-1, mismatchShiftedInt(ia));
+    expectEquals(-1, indexOfInt(new int[0], 7));
+    expectEquals(-2, mismatchShort(sa, new short[1]));
+    expectEquals(-1, mismatchShortChar(sc, cb));
+    // Same bits, different values.
+    expectEquals(0, mismatchShortChar(sa, new char[] { (char) 0x8001 }));
+
+    // The search ends at every position, including the ones in the tail.
+    for (int k = 0; k < N; k++) {
+      ia[k] = 8;
+      ca[k] = 'b';
+      ba[k] = (byte) 2;
+      sb[k] = (short) 0x8000;
+      expectEquals(k, indexOfInt(ia, 8));
+      expectEquals(lastIndexOf(ia, 8, 0), indexOfInt(ia, 8));
+      expectEquals(k, indexOfChar(ca, 'b'));
+      expectEquals(k, indexOfByteFrom(ba, (byte) 2, 0));
+      expectEquals(k, indexOfByteFrom(ba, (byte) 2, k));
+      expectEquals(k < 3 ? k : -1, indexOfByteFrom(ba, (byte) 2, 3));
+      expectEquals(k, skipInt(ia, 7));
+      expectEquals(k, mismatchShort(sa, sb));
+      expectEquals(k == 0 ? 0 : k - 1, mismatchShiftedInt(ia));
+      cb[k] = (char) 0x8071;
+      sc[k] = (short) 0x8071;
+      expectEquals(k, mismatchShortChar(sc, cb));
+      cb[k] = (char) 0x0071;
+      sc[k] = (short) 0x0071;
+      ia[k] = 7;
+      ca[k] = 'a';
+      ba[k] = (byte) 1;
+      sb[k] = (short) 0x8001;
+    }
+
+    // Searches that start at the end.
+    expectEquals(-1, indexOfByteFrom(ba, (byte) 1, N));
+    expectEquals(N - 1, indexOfByteFrom(ba, (byte) 1, N - 1));
+
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Functional tests on interchange of loop nests walking two-dimensional arrays by column.
+ * Rows that are null or too short must still raise the exception of the original order.
+ */
+public class Main {
+
+  /// CHECK-START: int Main.sumColumns(int[][], int) loop_nest_optimization (before)
+  /// CHECK-NOT: Deoptimize
+  //
+  /// CHECK-START: int Main.sumColumns(int[][], int) loop_nest_optimization (after)
+  /// CHECK:     Deoptimize
+  private static int sumColumns(int[][] a, int m) {
+    int n = a.length;
+    int sum = 0;
+    for (int j = 0; j < m; j++) {
+      for (int i = 0; i < n; i++) {
+        sum += a[i][j];
+      }
+    }
+    return sum;
+  }
+
+  /// CHECK-START: void Main.incrementColumns(int[][], int) loop_nest_optimization (after)
+  /// CHECK:     Deoptimize
+  private static void incrementColumns(int[][] a, int m) {
+    int n = a.length;
+    for (int j = 0; j < m; j++) {
+      for (int i = 0; i < n; i++) {
+        a[i][j] += 1;
+      }
+    }
+  }
+
+  private static int[][] makeArray(int n, int m) {
+    int[][] a = new int[n][m];
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < m; j++) {
+        a[i][j] = i * 31 + j * 7;
+      }
+    }
+    return a;
+  }
+
+  private static void testSum(int n, int m) {
+    int[][] a = makeArray(n, m);
+    int expected = 0;
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < m; j++) {
+        expected += a[i][j];
+      }
+    }
+    expectEquals(expected, sumColumns(a, m));
+    // Summing fewer columns than the rows have is fine.
+    expectEquals(expected - sumColumn(a, m - 1), sumColumns(a, m - 1));
+  }
+
+  private static int sumColumn(int[][] a, int j) {
+    int sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      sum += a[i][j];
+    }
+    return sum;
+  }
+
+  private static void testIncrement(int n, int m) {
+    int[][] a = makeArray(n, m);
+    incrementColumns(a, m);
+    int[][] b = makeArray(n, m);
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < m; j++) {
+        expectEquals(b[i][j] + 1, a[i][j]);
+      }
+    }
+  }
+
+  private static void testBadRows(int n, int m) {
+    int[][] a = makeArray(n, m);
+    a[n / 2] = null;
+    try {
+      sumColumns(a, m);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    a[n / 2] = new int[m - 1];
+    try {
+      sumColumns(a, m);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    // The increment stops at the short row in the last column, after all other columns.
+    int[][] b = makeArray(n, m);
+    try {
+      incrementColumns(a, m);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    for (int i = 0; i < n; i++) {
+      if (i == n / 2) {
+        continue;
+      }
+      for (int j = 0; j < m - 1; j++) {
+        expectEquals(b[i][j] + 1, a[i][j]);
+      }
+      expectEquals(b[i][m - 1] + (i < n / 2 ? 1 : 0), a[i][m - 1]);
+    }
+  }
+
+  public static void main(String[] args) {
+    for (int n = 1; n <= 1024; n *= 4) {
+      for (int m = 1; m <= 64; m *= 2) {
+        testSum(n, m);
+        testIncrement(n, m);
+      }
+    }
+    testBadRows(1000, 3);
+    testBadRows(2048, 17);
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  // Too big for the regular code item limit, but hot in the profile.
+  public static int hotCallee(int x) {
+    x = x * 3 + 1;
+    x = x * 5 + 2;
+    x = x * 7 + 3;
+    x = x * 11 + 4;
+    x = x * 13 + 5;
+    x = x * 17 + 6;
+    x = x * 19 + 7;
+    x = x * 23 + 8;
+    x = x * 29 + 9;
+    x = x * 31 + 10;
+    return x;
+  }
+
+  // Small enough for the regular code item limit, but only run during startup.
+  public static int startupOnlyCallee(int x) {
+    x = x * 3 + 1;
+    x = x * 5 + 2;
+    return x;
+  }
+
+  /// CHECK-START: int Main.callHot(int) inliner (before)
+  /// CHECK:       InvokeStaticOrDirect method_name:Main.hotCallee
+  //
+  /// CHECK-START: int Main.callHot(int) inliner (after)
+  /// CHECK-NOT:   InvokeStaticOrDirect method_name:Main.hotCallee
+  public static int callHot(int x) {
+    return hotCallee(x);
+  }
+
+  /// CHECK-START: int Main.callStartupOnly(int) inliner (after)
+  /// CHECK:       InvokeStaticOrDirect method_name:Main.startupOnlyCallee
+  public static int callStartupOnly(int x) {
+    return startupOnlyCallee(x);
+  }
+
+  public static void main(String[] args) {
+    expectEquals(hotCalleeReference(42), callHot(42));
+    expectEquals(startupOnlyCalleeReference(42), callStartupOnly(42));
+    System.out.println("passed");
+  }
+
+  private static int hotCalleeReference(int x) {
+    int[] factors = { 3, 5, 7, 11, 13, 17, 19, 23, 29, 31 };
+    for (int i = 0; i < factors.length; i++) {
+      x = x * factors[i] + i + 1;
+    }
+    return x;
+  }
+
+  private static int startupOnlyCalleeReference(int x) {
+    return (x * 3 + 1) * 5 + 2;
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Other {
+  static int sField;
+  static {
+    sField = 42;
+  }
+}
+
+class Point {
+  int x;
+}
+
+public class Main {
+
+  /// CHECK-START: int Main.staticOnOneSide(boolean) partial_redundancy_elimination (before)
+  /// CHECK:         LoadClass
+  /// CHECK:         LoadClass
+  //
+  /// CHECK-START: int Main.staticOnOneSide(boolean) partial_redundancy_elimination (after)
+  /// CHECK-DAG:     Add [<<P1:i\d+>>,<<P2:i\d+>>]
+  /// CHECK-DAG:     <<P1>> Phi
+  /// CHECK-DAG:     <<P2>> Phi
+  //
+  /// CHECK-START: int Main.staticOnOneSide(boolean) partial_redundancy_elimination (after)
+  /// CHECK:         StaticFieldGet
+  /// CHECK:         StaticFieldGet
+  /// CHECK-NOT:     StaticFieldGet
+  public static int staticOnOneSide(boolean b) {
+    int x = 0;
+    if (b) {
+      x = Other.sField;
+    }
+    return x + Other.sField;
+  }
+
+  /// CHECK-START: int Main.fieldOnOneSide(Point, boolean) partial_redundancy_elimination (after)
+  /// CHECK-DAG:     Add [<<P1:i\d+>>,<<P2:i\d+>>]
+  /// CHECK-DAG:     <<P1>> Phi
+  /// CHECK-DAG:     <<P2>> Phi
+  public static int fieldOnOneSide(Point p, boolean b) {
+    int x = 1;
+    if (b) {
+      x = p.x * 3;
+    }
+    return x + p.x;
+  }
+
+  /// CHECK-START: int Main.fieldKilled(Point, boolean) partial_redundancy_elimination (after)
+  /// CHECK:         InstanceFieldGet
+  /// CHECK:         InstanceFieldSet
+  /// CHECK:         InstanceFieldGet
+  /// CHECK-NOT:     InstanceFieldGet
+  public static int fieldKilled(Point p, boolean b) {
+    if (b) {
+      int x = p.x;
+      p.x = x + 1;
+    }
+    return p.x;
+  }
+
+  public static void main(String[] args) {
+    expectEquals(84, staticOnOneSide(true));
+    expectEquals(42, staticOnOneSide(false));
+    Point p = new Point();
+    p.x = 5;
+    expectEquals(20, fieldOnOneSide(p, true));
+    expectEquals(6, fieldOnOneSide(p, false));
+    try {
+      fieldOnOneSide(null, false);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    try {
+      fieldOnOneSide(null, true);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    expectEquals(6, fieldKilled(p, true));
+    expectEquals(6, fieldKilled(p, false));
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  int[] data;
+  int count;
+
+  /// CHECK-START: int Main.sumRepeated(int[], int) BCE (before)
+  /// CHECK-DAG: BoundsCheck loop:<<InnerLoop:B\d+>>
+  /// CHECK-DAG: If          loop:<<OuterLoop:B\d+>>
+  /// CHECK-EVAL: "<<InnerLoop>>" != "<<OuterLoop>>"
+  //
+  /// CHECK-START: int Main.sumRepeated(int[], int) BCE (after)
+  /// CHECK-DAG: ArrayGet   loop:<<InnerLoop:B\d+>>
+  /// CHECK-DAG: Deoptimize loop:none
+  //
+  /// CHECK-START: int Main.sumRepeated(int[], int) BCE (after)
+  /// CHECK-NOT: BoundsCheck
+  /// CHECK-NOT: Deoptimize loop:{{B\d+}}
+  static int sumRepeated(int[] a, int m) {
+    if (a.length == 0) {
+      return -1;
+    }
+    int result = 0;
+    for (int j = 0; j < m; j++) {
+      // The tests on the inner loop do not depend on j, and guard the whole nest.
+      for (int i = 0; i < 10; i++) {
+        result += a[i];
+      }
+    }
+    return result;
+  }
+
+  /// CHECK-START: int Main.sumRepeatedTwice(int[], int) BCE (after)
+  /// CHECK-DAG: ArrayGet   loop:<<InnerLoop:B\d+>>
+  /// CHECK-DAG: Deoptimize loop:none
+  //
+  /// CHECK-START: int Main.sumRepeatedTwice(int[], int) BCE (after)
+  /// CHECK-NOT: BoundsCheck
+  /// CHECK-NOT: Deoptimize loop:{{B\d+}}
+  static int sumRepeatedTwice(int[] a, int m) {
+    int result = 0;
+    for (int j = 0; j < m; j++) {
+      // The middle loop always takes its first iteration, so the tests guard the whole nest.
+      for (int k = 0; k < 2; k++) {
+        for (int i = 0; i < 10; i++) {
+          result += a[i];
+        }
+      }
+    }
+    return result;
+  }
+
+  /// CHECK-START: int Main.sumRepeatedMaybe(int[], int, int) BCE (after)
+  /// CHECK-DAG: ArrayGet   loop:<<InnerLoop:B\d+>>
+  /// CHECK-DAG: Deoptimize loop:<<OuterLoop:B\d+>>
+  /// CHECK-EVAL: "<<InnerLoop>>" != "<<OuterLoop>>"
+  //
+  /// CHECK-START: int Main.sumRepeatedMaybe(int[], int, int) BCE (after)
+  /// CHECK-NOT: BoundsCheck
+  /// CHECK-NOT: Deoptimize loop:none
+  static int sumRepeatedMaybe(int[] a, int m, int n) {
+    int result = 0;
+    for (int j = 0; j < m; j++) {
+      // The middle loop may take no iteration, in which case the array is not accessed,
+      // so the tests stay in front of the middle loop.
+      for (int k = 0; k < n; k++) {
+        for (int i = 0; i < 10; i++) {
+          result += a[i];
+        }
+      }
+    }
+    return result;
+  }
+
+  /// CHECK-START: int Main.sumField(int) BCE (before)
+  /// CHECK-DAG: InstanceFieldGet field_name:Main.data loop:<<Loop:B\d+>>
+  /// CHECK-DAG: BoundsCheck                           loop:<<Loop>>
+  //
+  /// CHECK-START: int Main.sumField(int) BCE (after)
+  /// CHECK-DAG: InstanceFieldGet field_name:Main.data loop:none
+  /// CHECK-DAG: Deoptimize                            loop:none
+  //
+  /// CHECK-START: int Main.sumField(int) BCE (after)
+  /// CHECK-NOT: NullCheck
+  /// CHECK-NOT: BoundsCheck
+  int sumField(int n) {
+    int result = 0;
+    for (int i = 0; i < n; i++) {
+      // The store does not alias the array field, which is loaded only once.
+      count++;
+      result += data[i];
+    }
+    return result;
+  }
+
+  /// CHECK-START: int Main.sumFieldReassigned(int, int[]) BCE (after)
+  /// CHECK-DAG: InstanceFieldGet field_name:Main.data loop:<<Loop:B\d+>>
+  /// CHECK-DAG: BoundsCheck                           loop:<<Loop>>
+  int sumFieldReassigned(int n, int[] other) {
+    int result = 0;
+    for (int i = 0; i < n; i++) {
+      result += data[i];
+      if (result > 100) {
+        data = other;
+      }
+    }
+    return result;
+  }
+
+  public static void main(String[] args) {
+    int[] a = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+    expectEquals(0, sumRepeated(a, 0));
+    expectEquals(55, sumRepeated(a, 1));
+    expectEquals(550, sumRepeated(a, 10));
+    expectEquals(-1, sumRepeated(new int[0], 10));
+    expectEquals(0, sumRepeated(new int[5], 0));
+    try {
+      sumRepeated(new int[5], 1);
+      throw new Error("Expected exception");
+    } catch (ArrayIndexOutOfBoundsException e) {
+      // Expected.
+    }
+
+    expectEquals(0, sumRepeatedTwice(a, 0));
+    expectEquals(330, sumRepeatedTwice(a, 3));
+    expectEquals(0, sumRepeatedTwice(new int[5], 0));
+    try {
+      sumRepeatedTwice(new int[5], 1);
+      throw new Error("Expected exception");
+    } catch (ArrayIndexOutOfBoundsException e) {
+      // Expected.
+    }
+
+    expectEquals(0, sumRepeatedMaybe(a, 0, 3));
+    expectEquals(0, sumRepeatedMaybe(a, 3, 0));
+    expectEquals(330, sumRepeatedMaybe(a, 3, 2));
+    expectEquals(0, sumRepeatedMaybe(new int[5], 3, 0));
+    try {
+      sumRepeatedMaybe(new int[5], 3, 1);
+      throw new Error("Expected exception");
+    } catch (ArrayIndexOutOfBoundsException e) {
+      // Expected.
+    }
+
+    Main main = new Main();
+    main.data = a;
+    expectEquals(0, main.sumField(0));
+    expectEquals(66, main.sumField(11));
+    expectEquals(11, main.count);
+    try {
+      main.sumField(12);
+      throw new Error("Expected exception");
+    } catch (ArrayIndexOutOfBoundsException e) {
+      expectEquals(23, main.count);
+    }
+    main.data = null;
+    expectEquals(0, main.sumField(0));
+    try {
+      main.sumField(1);
+      throw new Error("Expected exception");
+    } catch (NullPointerException e) {
+      expectEquals(24, main.count);
+    }
+
+    int[] b = { 100, 100, 100 };
+    main.data = a;
+    expectEquals(1 + 2 + 3 + 4 + 5 + 6 + 7 + 8 + 9 + 10 + 11, main.sumFieldReassigned(11, b));
+    main.data = b;
+    expectEquals(100 + 100 + 3, main.sumFieldReassigned(3, a));
+    expectEquals(a, main.data);
+
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(Object expected, Object result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  // Too big to inline as is, but only a few instructions once `mode` is 0.
+  public static int compute(int x, int mode) {
+    if (mode == 0) {
+      return x + 1;
+    }
+    int r = x;
+    r = r * 3 + 7;
+    r = r * 5 - 11;
+    r = r ^ (r >>> 3);
+    r = r * 7 + 13;
+    r = r * 11 - 17;
+    r = r ^ (r >>> 5);
+    r = r * 13 + 19;
+    r = r * 17 - 23;
+    r = r ^ (r >>> 7);
+    r = r * 19 + 29;
+    r = r * 23 - 31;
+    r = r ^ (r >>> 11);
+    if (mode == 2) {
+      r = r * 29 + 37;
+      r = r * 31 - 41;
+      r = r ^ (r >>> 3);
+      r = r * 37 + 43;
+      r = r * 41 - 47;
+      r = r ^ (r >>> 5);
+      r = r * 43 + 53;
+      r = r * 47 - 59;
+      r = r ^ (r >>> 7);
+      r = r * 53 + 61;
+      r = r * 59 - 67;
+      r = r ^ (r >>> 11);
+      r = r * 61 + 71;
+      r = r * 67 - 73;
+      r = r ^ (r >>> 13);
+      r = r * 71 + 79;
+      r = r * 73 - 83;
+      r = r ^ (r >>> 17);
+      r = r * 79 + 89;
+      r = r * 83 - 97;
+      r = r ^ (r >>> 19);
+      r = r * 89 + 101;
+      r = r * 97 - 103;
+      r = r ^ (r >>> 23);
+    }
+    return r;
+  }
+
+  // Not hot in the profile, otherwise like `compute()`.
+  public static int computeNotHot(int x, int mode) {
+    if (mode == 0) {
+      return x + 1;
+    }
+    int r = x;
+    r = r * 3 + 7;
+    r = r * 5 - 11;
+    r = r ^ (r >>> 3);
+    r = r * 7 + 13;
+    r = r * 11 - 17;
+    r = r ^ (r >>> 5);
+    r = r * 13 + 19;
+    r = r * 17 - 23;
+    r = r ^ (r >>> 7);
+    r = r * 19 + 29;
+    r = r * 23 - 31;
+    r = r ^ (r >>> 11);
+    return r;
+  }
+
+  /// CHECK-START: int Main.fastPath(int) inliner (before)
+  /// CHECK:     InvokeStaticOrDirect method_name:Main.compute
+  //
+  /// CHECK-START: int Main.fastPath(int) inliner (after)
+  /// CHECK-NOT: InvokeStaticOrDirect method_name:Main.compute
+  public static int fastPath(int x) {
+    return compute(x, 0);
+  }
+
+  // Still too big once specialized.
+  /// CHECK-START: int Main.slowPath(int) inliner (after)
+  /// CHECK:     InvokeStaticOrDirect method_name:Main.compute
+  public static int slowPath(int x) {
+    return compute(x, 2);
+  }
+
+  /// CHECK-START: int Main.anyPath(int, int) inliner (after)
+  /// CHECK:     InvokeStaticOrDirect method_name:Main.compute
+  public static int anyPath(int x, int mode) {
+    return compute(x, mode);
+  }
+
+  // Only the hot call sites are worth specializing the callee, and this one's hotness is
+  // unknown.
+  /// CHECK-START: int Main.notHotPath(int) inliner (after)
+  /// CHECK:     InvokeStaticOrDirect method_name:Main.computeNotHot
+  public static int notHotPath(int x) {
+    return computeNotHot(x, 0);
+  }
+
+  public static void main(String[] args) {
+    for (int x = -10; x <= 10; x++) {
+      expectEquals(x + 1, fastPath(x));
+      expectEquals(compute(x, 2), slowPath(x));
+      expectEquals(compute(x, 0), anyPath(x, 0));
+      expectEquals(compute(x, 1), anyPath(x, 1));
+      expectEquals(x + 1, notHotPath(x));
+    }
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
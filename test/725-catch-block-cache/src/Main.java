@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  static class ParseException extends Exception {}
+  static class EndOfInputException extends ParseException {}
+  static class BadTokenException extends ParseException {}
+
+  static void $noinline$throw(int kind) throws Exception {
+    switch (kind) {
+      case 0: throw new EndOfInputException();
+      case 1: throw new BadTokenException();
+      case 2: throw new ParseException();
+      case 3: throw new IllegalStateException();
+      default: break;
+    }
+  }
+
+  // The same throwing call is caught by different handlers depending on the exception.
+  static int classify(int kind) {
+    try {
+      try {
+        $noinline$throw(kind);
+        return 0;
+      } catch (EndOfInputException e) {
+        return 1;
+      } catch (BadTokenException e) {
+        return 2;
+      } catch (ParseException e) {
+        return 3;
+      }
+    } catch (Exception e) {
+      return 4;
+    }
+  }
+
+  // The handler of an outer frame, after unwinding this one.
+  static int unwind(int kind) throws Exception {
+    try {
+      $noinline$throw(kind);
+    } catch (BadTokenException e) {
+      return 2;
+    }
+    return 0;
+  }
+
+  static int classifyUnwound(int kind) {
+    try {
+      return unwind(kind);
+    } catch (ParseException e) {
+      return 3;
+    } catch (Exception e) {
+      return 4;
+    }
+  }
+
+  public static void main(String[] args) {
+    for (int i = 0; i < 10000; i++) {
+      int kind = i % 5;
+      expectEquals(kind == 4 ? 0 : kind + 1, classify(kind));
+      int expected = (kind == 1) ? 2 : (kind == 3) ? 4 : (kind == 4) ? 0 : 3;
+      expectEquals(expected, classifyUnwound(kind));
+    }
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
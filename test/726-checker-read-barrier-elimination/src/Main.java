@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  /// CHECK-START-X86_64: java.lang.Object Main.$noinline$loadFromNewArray(java.lang.Object, int, int) read_barrier_elimination (after)
+  /// CHECK:     NewArray
+  /// CHECK-NOT: SuspendCheck
+  /// CHECK:     ArrayGet read_barrier_free:true
+  private static Object $noinline$loadFromNewArray(Object o, int i, int j) {
+    Object[] array = new Object[4];
+    array[i] = o;
+    return array[j];
+  }
+
+  /// CHECK-START-X86_64: java.lang.Object Main.$noinline$loadAfterCall(java.lang.Object, int, int) read_barrier_elimination (after)
+  /// CHECK:     NewArray
+  /// CHECK:     InvokeStaticOrDirect
+  /// CHECK:     ArrayGet
+  /// CHECK-NOT: read_barrier_free
+  private static Object $noinline$loadAfterCall(Object o, int i, int j) {
+    Object[] array = new Object[4];
+    array[i] = o;
+    $noinline$call();
+    return array[j];
+  }
+
+  private static void $noinline$call() {
+    if (doThrow) {
+      throw new Error();
+    }
+  }
+
+  public static void main(String[] args) {
+    Object o = new Object();
+    expectEquals(o, $noinline$loadFromNewArray(o, 1, 1));
+    expectEquals(null, $noinline$loadFromNewArray(o, 1, 2));
+    expectEquals(o, $noinline$loadAfterCall(o, 3, 3));
+    expectEquals(null, $noinline$loadAfterCall(o, 3, 0));
+    try {
+      $noinline$loadFromNewArray(o, 0, 4);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+      // Expected.
+    }
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(Object expected, Object result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  static boolean doThrow = false;
+}
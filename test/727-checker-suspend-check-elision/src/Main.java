@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  static int sSum;
+  static int[] sArray = new int[1000];
+
+  /// CHECK-START: void Main.$noinline$shortLoop() loop_optimization (before)
+  /// CHECK:     SuspendCheck loop:B{{\d+}}
+  /// CHECK-NOT: poll_elided
+  //
+  /// CHECK-START: void Main.$noinline$shortLoop() loop_optimization (after)
+  /// CHECK:     SuspendCheck poll_elided:true loop:B{{\d+}}
+  private static void $noinline$shortLoop() {
+    for (int i = 0; i < 100; i++) {
+      sSum += sArray[i];
+    }
+  }
+
+  /// CHECK-START: void Main.$noinline$longLoop() loop_optimization (after)
+  /// CHECK:     SuspendCheck loop:B{{\d+}}
+  /// CHECK-NOT: poll_elided
+  private static void $noinline$longLoop() {
+    for (int i = 0; i < 1000; i++) {
+      sSum += sArray[i];
+    }
+  }
+
+  // The inner loop fits the budget, but not together with the outer loop.
+  //
+  /// CHECK-START: void Main.$noinline$nestedLoops() loop_optimization (after)
+  /// CHECK:     SuspendCheck loop:<<Outer:B\d+>> outer_loop:none
+  /// CHECK-NOT: poll_elided
+  /// CHECK:     SuspendCheck poll_elided:true loop:{{B\d+}} outer_loop:<<Outer>>
+  private static void $noinline$nestedLoops() {
+    for (int j = 0; j < 10; j++) {
+      for (int i = 0; i < 100; i++) {
+        sSum += sArray[i + j];
+      }
+    }
+  }
+
+  /// CHECK-START: void Main.$noinline$unknownTripCount(int) loop_optimization (after)
+  /// CHECK:     SuspendCheck loop:B{{\d+}}
+  /// CHECK-NOT: poll_elided
+  private static void $noinline$unknownTripCount(int n) {
+    for (int i = 0; i < n; i++) {
+      sSum += sArray[i];
+    }
+  }
+
+  public static void main(String[] args) {
+    for (int i = 0; i < sArray.length; i++) {
+      sArray[i] = i;
+    }
+    $noinline$shortLoop();
+    expectEquals(4950, sSum);
+    sSum = 0;
+    $noinline$longLoop();
+    expectEquals(499500, sSum);
+    sSum = 0;
+    $noinline$nestedLoops();
+    expectEquals(54000, sSum);
+    sSum = 0;
+    $noinline$unknownTripCount(10);
+    expectEquals(45, sSum);
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
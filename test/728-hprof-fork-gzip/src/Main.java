@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.io.DataInputStream;
+import java.io.File;
+import java.io.FileInputStream;
+import java.lang.reflect.Method;
+import java.util.zip.GZIPInputStream;
+
+public class Main {
+  private static final String HPROF_HEADER = "JAVA PROFILE 1.0.3";
+
+  public static void main(String[] args) throws Exception {
+    File dumpFile = File.createTempFile("test-728-hprof", ".hprof.gz");
+    try {
+      Class<?> vmDebug = Class.forName("dalvik.system.VMDebug");
+      Method dumpHprofData = vmDebug.getMethod("dumpHprofData", String.class);
+      dumpHprofData.invoke(null, dumpFile.getAbsolutePath());
+
+      // The dump is complete when dumpHprofData returns, even though a child process wrote it.
+      try (DataInputStream in =
+               new DataInputStream(new GZIPInputStream(new FileInputStream(dumpFile)))) {
+        byte[] header = new byte[HPROF_HEADER.length() + 1];
+        in.readFully(header);
+        expectEquals(HPROF_HEADER, new String(header, 0, HPROF_HEADER.length(), "US-ASCII"));
+        expectEquals(0, header[HPROF_HEADER.length()]);
+        // The identifier size, then the dump contains at least the string and the class tables.
+        expectEquals(4, in.readInt());
+        in.readLong();
+        long records = 0;
+        while (in.read() != -1) {
+          in.readInt();
+          in.readFully(new byte[in.readInt()]);
+          ++records;
+        }
+        if (records < 3) {
+          throw new Error("Expected more records, found: " + records);
+        }
+      }
+    } finally {
+      dumpFile.delete();
+    }
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(String expected, String result) {
+    if (!expected.equals(result)) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
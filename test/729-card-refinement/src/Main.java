@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.HashMap;
+
+public class Main {
+  static class Node {
+    Node next;
+    Object value;
+  }
+
+  static final int kNodes = 10000;
+
+  public static void main(String[] args) throws Exception {
+    Node[] nodes = new Node[kNodes];
+    for (int i = 0; i < kNodes; ++i) {
+      nodes[i] = new Node();
+    }
+    // Age the nodes, so that the next GCs only find the new values through the dirty cards.
+    Runtime.getRuntime().gc();
+
+    // Long-lived containers, written with young objects.
+    HashMap<String, Object> properties = new HashMap<>();
+    for (int round = 0; round < 20; ++round) {
+      for (int i = 0; i < kNodes; ++i) {
+        nodes[i].next = nodes[(i + round + 1) % kNodes];
+        nodes[i].value = new Integer(i * round);
+      }
+      System.setProperty("729-card-refinement", Integer.toString(round));
+      properties.put(Integer.toString(round), new int[] { round });
+      // Let the refinements drain the cards before the GC.
+      Thread.sleep(5);
+      Runtime.getRuntime().gc();
+      for (int i = 0; i < kNodes; ++i) {
+        if (nodes[i].next != nodes[(i + round + 1) % kNodes] ||
+            ((Integer) nodes[i].value).intValue() != i * round) {
+          throw new Error("Corrupted node " + i + " in round " + round);
+        }
+      }
+      if (!System.getProperty("729-card-refinement").equals(Integer.toString(round))) {
+        throw new Error("Corrupted property in round " + round);
+      }
+    }
+    for (int round = 0; round < 20; ++round) {
+      if (((int[]) properties.get(Integer.toString(round)))[0] != round) {
+        throw new Error("Corrupted map entry " + round);
+      }
+    }
+    System.out.println("passed");
+  }
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static final int kThreads = 4;
+  static final int kIterations = 20000;
+
+  static final Object lock = new Object();
+  static int counter = 0;
+
+  public static void main(String[] args) throws Exception {
+    // Short critical sections, mostly acquired by spinning.
+    runContenders(/* sleepEvery */ 0);
+    // Critical sections that sometimes block, so that the contenders park.
+    runContenders(/* sleepEvery */ 1000);
+    // Waits take the same path to reacquire the lock.
+    final int[] turn = new int[1];
+    Thread waiter = new Thread() {
+      public void run() {
+        synchronized (lock) {
+          for (int i = 0; i < 100; ++i) {
+            while (turn[0] != 1) {
+              try {
+                lock.wait();
+              } catch (InterruptedException e) {
+                throw new Error(e);
+              }
+            }
+            turn[0] = 0;
+            lock.notifyAll();
+          }
+        }
+      }
+    };
+    waiter.start();
+    for (int i = 0; i < 100; ++i) {
+      synchronized (lock) {
+        turn[0] = 1;
+        lock.notifyAll();
+        while (turn[0] != 0) {
+          lock.wait();
+        }
+      }
+    }
+    waiter.join();
+    System.out.println("passed");
+  }
+
+  static void runContenders(final int sleepEvery) throws Exception {
+    counter = 0;
+    Thread[] threads = new Thread[kThreads];
+    for (int t = 0; t < kThreads; ++t) {
+      threads[t] = new Thread() {
+        public void run() {
+          for (int i = 0; i < kIterations; ++i) {
+            synchronized (lock) {
+              counter++;
+              if (sleepEvery != 0 && i % sleepEvery == 0) {
+                try {
+                  Thread.sleep(1);
+                } catch (InterruptedException e) {
+                  throw new Error(e);
+                }
+              }
+            }
+          }
+        }
+      };
+      threads[t].start();
+    }
+    for (Thread thread : threads) {
+      thread.join();
+    }
+    if (counter != kThreads * kIterations) {
+      throw new Error("Expected " + (kThreads * kIterations) + ", got " + counter);
+    }
+  }
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.io.File;
+import java.io.IOException;
+import java.lang.reflect.Method;
+
+public class Main {
+  static StringBuilder initOrder = new StringBuilder();
+
+  static class A {
+    static { initOrder.append('A'); }
+    static int value = B.value + 1;
+  }
+
+  static class B {
+    static { initOrder.append('B'); }
+    static int value = 1;
+  }
+
+  static class C {
+    static { initOrder.append('C'); }
+    static int value = A.value + 1;
+  }
+
+  public static void main(String[] args) throws Exception {
+    File file = null;
+    try {
+      file = createTempFile();
+      String codePath = System.getenv("DEX_LOCATION") + "/731-preload-startup-classes.jar";
+      VMRuntime.registerAppInfo(file.getPath(), new String[] {codePath});
+
+      // The preloader never runs the initializers, they run in the order the program needs them.
+      if (C.value != 3) {
+        throw new Error("Unexpected value " + C.value);
+      }
+      if (!initOrder.toString().equals("CAB")) {
+        throw new Error("Unexpected initialization order " + initOrder);
+      }
+    } finally {
+      if (file != null) {
+        file.delete();
+      }
+    }
+    System.out.println("passed");
+  }
+
+  private static File createTempFile() throws Exception {
+    try {
+      return File.createTempFile("dummy", "-profile");
+    } catch (IOException e) {
+      System.setProperty("java.io.tmpdir", "/data/local/tmp");
+      try {
+        return File.createTempFile("dummy", "-profile");
+      } catch (IOException e2) {
+        System.setProperty("java.io.tmpdir", "/sdcard");
+        return File.createTempFile("dummy", "-profile");
+      }
+    }
+  }
+
+  private static class VMRuntime {
+    private static final Method registerAppInfoMethod;
+    static {
+      try {
+        Class<? extends Object> c = Class.forName("dalvik.system.VMRuntime");
+        registerAppInfoMethod = c.getDeclaredMethod("registerAppInfo",
+            String.class, String[].class);
+      } catch (Exception e) {
+        throw new RuntimeException(e);
+      }
+    }
+
+    public static void registerAppInfo(String profile, String[] codePaths)
+        throws Exception {
+      registerAppInfoMethod.invoke(null, profile, codePaths);
+    }
+  }
+}
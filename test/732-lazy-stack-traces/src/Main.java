@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static class MyException extends Exception {
+    MyException() {
+      this("default");
+    }
+
+    MyException(String message) {
+      super(message);
+    }
+  }
+
+  public static void main(String[] args) throws Exception {
+    // The frames of the constructors are skipped.
+    for (int i = 0; i < 10000; ++i) {
+      try {
+        outer();
+        throw new Error("Expected MyException");
+      } catch (MyException e) {
+        StackTraceElement[] trace = e.getStackTrace();
+        expectMethod(trace, 0, "thrower");
+        expectMethod(trace, 1, "outer");
+        expectMethod(trace, 2, "main");
+        if (trace.length != 3) {
+          throw new Error("Expected 3 frames, got " + trace.length);
+        }
+        if (trace[0].getLineNumber() <= 0) {
+          throw new Error("Missing line number: " + trace[0]);
+        }
+      }
+    }
+
+    // Deep stacks are cut at the maximum depth.
+    try {
+      recurse(1000);
+      throw new Error("Expected MyException");
+    } catch (MyException e) {
+      StackTraceElement[] trace = e.getStackTrace();
+      expectMethod(trace, 0, "thrower");
+      expectMethod(trace, 1, "recurse");
+      if (trace.length < 64 || trace.length >= 1000) {
+        throw new Error("Unexpected depth " + trace.length);
+      }
+    }
+    System.out.println("passed");
+  }
+
+  static void outer() throws MyException {
+    thrower();
+  }
+
+  static void recurse(int depth) throws MyException {
+    if (depth == 0) {
+      thrower();
+    } else {
+      recurse(depth - 1);
+    }
+  }
+
+  static void thrower() throws MyException {
+    throw new MyException();
+  }
+
+  static void expectMethod(StackTraceElement[] trace, int index, String method) {
+    if (trace.length <= index || !trace[index].getMethodName().equals(method)) {
+      throw new Error("Expected " + method + " at " + index + " in " +
+          java.util.Arrays.toString(trace));
+    }
+  }
+}
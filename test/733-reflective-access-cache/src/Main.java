@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.InvocationTargetException;
+import java.lang.reflect.Method;
+
+import other.Other;
+
+public class Main {
+  static int packagePrivate(int value) {
+    return value + 1;
+  }
+
+  public static void main(String[] args) throws Exception {
+    Method local = Main.class.getDeclaredMethod("packagePrivate", int.class);
+    Method hidden = Other.class.getDeclaredMethod("packagePrivate", int.class);
+    Method inherited = Other.class.getDeclaredMethod("inherited");
+    for (int i = 0; i < 10000; ++i) {
+      // Allowed from the same package.
+      int result = (Integer) local.invoke(null, i);
+      if (result != i + 1) {
+        throw new Error("Expected " + (i + 1) + ", got " + result);
+      }
+      // Denied from another package, on every call.
+      try {
+        hidden.invoke(null, i);
+        throw new Error("Expected IllegalAccessException");
+      } catch (IllegalAccessException expected) {
+      }
+      // Protected methods of other packages depend on the receiver.
+      try {
+        inherited.invoke(new Other());
+        throw new Error("Expected IllegalAccessException");
+      } catch (IllegalAccessException expected) {
+      }
+      if ((Integer) Sub.callInherited(inherited, new Sub()) != 42) {
+        throw new Error("Unexpected result of inherited");
+      }
+      try {
+        Sub.callInherited(inherited, new Other());
+        throw new Error("Expected IllegalAccessException");
+      } catch (IllegalAccessException expected) {
+      }
+    }
+    System.out.println("passed");
+  }
+
+  static class Sub extends Other {
+    static Object callInherited(Method method, Object receiver)
+        throws IllegalAccessException, InvocationTargetException {
+      return method.invoke(receiver);
+    }
+  }
+}
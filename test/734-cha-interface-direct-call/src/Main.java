@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+interface Service {
+  int $noinline$compute(int i);
+}
+
+class ServiceImpl implements Service {
+  // Too large to be inlined, so the devirtualized call is a direct call.
+  public int $noinline$compute(int i) {
+    System.out.print("");
+    System.out.print("");
+    System.out.print("");
+    System.out.print("");
+    System.out.print("");
+    System.out.print("");
+    System.out.print("");
+    System.out.print("");
+    return i + 1;
+  }
+}
+
+class OtherServiceImpl implements Service {
+  public int $noinline$compute(int i) {
+    System.out.print("");
+    System.out.print("");
+    System.out.print("");
+    System.out.print("");
+    System.out.print("");
+    System.out.print("");
+    System.out.print("");
+    System.out.print("");
+    return i + 2;
+  }
+}
+
+public class Main {
+  static Service sService = new ServiceImpl();
+
+  static int call(Service service, int i) {
+    return service.$noinline$compute(i);
+  }
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    if (call(sService, 1) != 2) {
+      throw new Error("Unexpected result before JIT");
+    }
+    ensureJitCompiled(Main.class, "call");
+    if (call(sService, 1) != 2) {
+      throw new Error("Unexpected result of ServiceImpl");
+    }
+    // Loading a second implementor deoptimizes `call`, which must dispatch again.
+    Service other = (Service) Class.forName("OtherServiceImpl").newInstance();
+    if (call(other, 1) != 3) {
+      throw new Error("Unexpected result of OtherServiceImpl");
+    }
+    if (call(sService, 1) != 2) {
+      throw new Error("Unexpected result of ServiceImpl after OtherServiceImpl");
+    }
+    System.out.println("passed");
+  }
+
+  private static native void ensureJitCompiled(Class<?> itf, String method_name);
+}
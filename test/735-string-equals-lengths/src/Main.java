@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  public static void main(String[] args) {
+    for (int length = 0; length <= 40; ++length) {
+      // Compressed and uncompressed strings.
+      check(makeString(length, 'a'), length, 'b');
+      check(makeString(length, '\u0101'), length, '\u0102');
+    }
+    // Strings of the same length but different compression are never equal.
+    for (int length = 1; length <= 40; ++length) {
+      String compressed = makeString(length, 'a');
+      String uncompressed = makeString(length - 1, 'a') + '\u0101';
+      expectEquals(false, compressed.equals(uncompressed));
+      expectEquals(false, uncompressed.equals(compressed));
+    }
+    System.out.println("passed");
+  }
+
+  static String makeString(int length, char c) {
+    StringBuilder sb = new StringBuilder();
+    for (int i = 0; i < length; ++i) {
+      sb.append(c);
+    }
+    return sb.toString();
+  }
+
+  static void check(String s, int length, char other) {
+    String copy = new String(s.toCharArray());
+    expectEquals(true, s.equals(copy));
+    expectEquals(true, copy.equals(s));
+    for (int i = 0; i < length; ++i) {
+      char[] chars = s.toCharArray();
+      chars[i] = other;
+      String changed = new String(chars);
+      expectEquals(false, s.equals(changed));
+      expectEquals(false, changed.equals(s));
+    }
+    expectEquals(false, s.equals(s + other));
+    expectEquals(false, (s + other).equals(s));
+  }
+
+  static void expectEquals(boolean expected, boolean actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static class Helper {
+    static int value = 42;
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    // Compile the methods before the class and the string they load are resolved.
+    ensureJitCompiled(Main.class, "loadClass");
+    ensureJitCompiled(Main.class, "loadString");
+
+    Class<?> first = null;
+    String string = null;
+    for (int i = 0; i < 10000; ++i) {
+      Class<?> klass = loadClass(i != 0);
+      if (i == 1) {
+        first = klass;
+        System.out.println(klass.getSimpleName());
+      } else if (i != 0 && klass != first) {
+        throw new Error("Unexpected class " + klass);
+      }
+      if (i != 0 && Helper.value != 42) {
+        throw new Error("Unexpected value " + Helper.value);
+      }
+      String s = loadString(i != 0);
+      if (i == 1) {
+        string = s;
+        System.out.println(s);
+      } else if (i != 0 && s != string) {
+        throw new Error("Unexpected string " + s);
+      }
+    }
+    System.out.println("passed");
+  }
+
+  static Class<?> loadClass(boolean load) {
+    return load ? Helper.class : null;
+  }
+
+  static String loadString(boolean load) {
+    return load ? "Unresolved string" : null;
+  }
+
+  private static native void ensureJitCompiled(Class<?> klass, String method_name);
+}
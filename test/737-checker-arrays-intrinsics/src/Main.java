@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.Arrays;
+
+public class Main {
+
+  /// CHECK-START: void Main.fillBytes(byte[], byte) intrinsics_recognition (after)
+  /// CHECK-DAG:                          InvokeStaticOrDirect intrinsic:ArraysFillByte
+
+  private static void fillBytes(byte[] array, byte value) {
+    Arrays.fill(array, value);
+  }
+
+  /// CHECK-START: void Main.fillInts(int[], int) intrinsics_recognition (after)
+  /// CHECK-DAG:                          InvokeStaticOrDirect intrinsic:ArraysFillInt
+
+  private static void fillInts(int[] array, int value) {
+    Arrays.fill(array, value);
+  }
+
+  /// CHECK-START: boolean Main.equalBytes(byte[], byte[]) intrinsics_recognition (after)
+  /// CHECK-DAG:     <<Result:z\d+>>      InvokeStaticOrDirect intrinsic:ArraysEqualsByte
+  /// CHECK-DAG:                          Return [<<Result>>]
+
+  private static boolean equalBytes(byte[] a, byte[] b) {
+    return Arrays.equals(a, b);
+  }
+
+  public static void main(String[] args) {
+    // Cover the short arrays, the vector loops with their overlapping last store, and the
+    // non-temporal stores of the arrays of a few megabytes.
+    int[] lengths = { 0, 1, 3, 4, 7, 8, 15, 16, 31, 32, 33, 63, 64, 65, 100, 1000,
+                      512 * 1024 - 1, 512 * 1024, 3 * 1024 * 1024 + 17 };
+    for (int length : lengths) {
+      testFillBytes(length);
+      testFillInts(length);
+      testEqualBytes(length);
+    }
+    testNulls();
+    System.out.println("passed");
+  }
+
+  private static void testFillBytes(int length) {
+    byte[] array = new byte[length];
+    fillBytes(array, (byte) 0x81);
+    for (int i = 0; i < length; ++i) {
+      expectEquals((byte) 0x81, array[i], "fillBytes", length, i);
+    }
+    fillBytes(array, (byte) 0);
+    for (int i = 0; i < length; ++i) {
+      expectEquals(0, array[i], "fillBytes", length, i);
+    }
+  }
+
+  private static void testFillInts(int length) {
+    int[] array = new int[length];
+    fillInts(array, 0x12345678);
+    for (int i = 0; i < length; ++i) {
+      expectEquals(0x12345678, array[i], "fillInts", length, i);
+    }
+    fillInts(array, -1);
+    for (int i = 0; i < length; ++i) {
+      expectEquals(-1, array[i], "fillInts", length, i);
+    }
+  }
+
+  private static void testEqualBytes(int length) {
+    if (length > 100000) {
+      return;
+    }
+    byte[] a = new byte[length];
+    for (int i = 0; i < length; ++i) {
+      a[i] = (byte) (i * 31);
+    }
+    byte[] b = a.clone();
+    if (!equalBytes(a, b) || !equalBytes(a, a)) {
+      throw new Error("Expected equal arrays of length " + length);
+    }
+    // A difference at any position is found.
+    for (int i = 0; i < length; ++i) {
+      b[i] ^= 1;
+      if (equalBytes(a, b)) {
+        throw new Error("Expected a difference at " + i + " of " + length);
+      }
+      b[i] ^= 1;
+    }
+    if (equalBytes(a, Arrays.copyOf(a, length + 1))) {
+      throw new Error("Expected different lengths " + length);
+    }
+  }
+
+  private static void testNulls() {
+    if (!equalBytes(null, null) ||
+        equalBytes(null, new byte[0]) ||
+        equalBytes(new byte[0], null)) {
+      throw new Error("Unexpected result for null arrays");
+    }
+    try {
+      fillBytes(null, (byte) 1);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    try {
+      fillInts(null, 1);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+  }
+
+  private static void expectEquals(int expected, int actual, String what, int length, int i) {
+    if (expected != actual) {
+      throw new Error(what + " of length " + length + " at " + i + ": expected " + expected +
+          ", got " + actual);
+    }
+  }
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.nio.ByteBuffer;
+import java.util.Random;
+import java.util.zip.Adler32;
+import java.util.zip.CRC32;
+import java.util.zip.Checksum;
+
+public class Main {
+
+  public static void main(String[] args) {
+    Random random = new Random(42);
+    byte[] data = new byte[100000];
+    random.nextBytes(data);
+    ByteBuffer direct = ByteBuffer.allocateDirect(data.length);
+    direct.put(data);
+
+    // Cover the short tails, the folding of one and four blocks of 16 bytes, and the chunks
+    // of the Adler-32 sums, at unaligned offsets.
+    int[] lengths = { 0, 1, 2, 3, 4, 5, 7, 15, 16, 17, 31, 47, 48, 63, 64, 65, 79, 80, 127, 128,
+                      129, 1000, 5551, 5552, 5553, 5568, 5569, 65536, 99000 };
+    for (int length : lengths) {
+      for (int offset : new int[] { 0, 1, 3, 13 }) {
+        long crc = referenceCrc32(data, offset, length);
+        expectEquals(crc, checksumBytes(new CRC32(), data, offset, length), "CRC32", length);
+        expectEquals(crc,
+                     checksumBuffer(new CRC32(), direct, offset, length),
+                     "CRC32 direct",
+                     length);
+        long adler = referenceAdler32(data, offset, length);
+        expectEquals(adler, checksumBytes(new Adler32(), data, offset, length), "Adler32", length);
+        expectEquals(adler,
+                     checksumBuffer(new Adler32(), direct, offset, length),
+                     "Adler32 direct",
+                     length);
+      }
+    }
+
+    // Updates continue from the checksum so far.
+    CRC32 crc = new CRC32();
+    Adler32 adler = new Adler32();
+    for (int i = 0; i < 100; ++i) {
+      crc.update(data, i * 37, 37);
+      adler.update(data, i * 37, 37);
+    }
+    expectEquals(referenceCrc32(data, 0, 3700), crc.getValue(), "CRC32 updates", 3700);
+    expectEquals(referenceAdler32(data, 0, 3700), adler.getValue(), "Adler32 updates", 3700);
+
+    // The largest bytes stress the Adler-32 sums.
+    byte[] ones = new byte[20000];
+    java.util.Arrays.fill(ones, (byte) 0xff);
+    expectEquals(referenceAdler32(ones, 0, ones.length),
+                 checksumBytes(new Adler32(), ones, 0, ones.length),
+                 "Adler32 0xff",
+                 ones.length);
+    System.out.println("passed");
+  }
+
+  private static long checksumBytes(Checksum checksum, byte[] data, int offset, int length) {
+    checksum.update(data, offset, length);
+    return checksum.getValue();
+  }
+
+  private static long checksumBuffer(Checksum checksum, ByteBuffer data, int offset, int length) {
+    ByteBuffer slice = data.duplicate();
+    slice.position(offset);
+    slice.limit(offset + length);
+    if (checksum instanceof CRC32) {
+      ((CRC32) checksum).update(slice);
+    } else {
+      ((Adler32) checksum).update(slice);
+    }
+    return checksum.getValue();
+  }
+
+  private static long referenceCrc32(byte[] data, int offset, int length) {
+    int crc = ~0;
+    for (int i = offset; i < offset + length; ++i) {
+      crc ^= data[i] & 0xff;
+      for (int bit = 0; bit < 8; ++bit) {
+        crc = (crc >>> 1) ^ (0xedb88320 & -(crc & 1));
+      }
+    }
+    return ~crc & 0xffffffffL;
+  }
+
+  private static long referenceAdler32(byte[] data, int offset, int length) {
+    long s1 = 1;
+    long s2 = 0;
+    for (int i = offset; i < offset + length; ++i) {
+      s1 = (s1 + (data[i] & 0xff)) % 65521;
+      s2 = (s2 + s1) % 65521;
+    }
+    return (s2 << 16) | s1;
+  }
+
+  private static void expectEquals(long expected, long actual, String what, int length) {
+    if (expected != actual) {
+      throw new Error(what + " of length " + length + ": expected " + Long.toHexString(expected) +
+          ", got " + Long.toHexString(actual));
+    }
+  }
+}
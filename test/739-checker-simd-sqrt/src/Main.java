@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Tests for vectorization of square root and absolute value loops.
+ */
+public class Main {
+
+  static final int N = 1029;  // odd, so the scalar loop computes the tail elements too
+
+  /// CHECK-START: void Main.sqrt(double[], double[]) loop_optimization (before)
+  /// CHECK-DAG: InvokeStaticOrDirect intrinsic:MathSqrt loop:<<Loop:B\d+>> outer_loop:none
+  //
+  /// CHECK-START-X86_64: void Main.sqrt(double[], double[]) loop_optimization (after)
+  /// CHECK-DAG: <<Load:d\d+>> VecLoad               loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Sqrt:d\d+>> VecSqrt [<<Load>>]    loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:               VecStore [{{l\d+}},{{i\d+}},<<Sqrt>>] loop:<<Loop>> outer_loop:none
+  //
+  /// CHECK-START-ARM64: void Main.sqrt(double[], double[]) loop_optimization (after)
+  /// CHECK-NOT: VecSqrt
+  private static void sqrt(double[] a, double[] b) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] = Math.sqrt(b[i]);
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.hypot(double[], double[], double[]) loop_optimization (after)
+  /// CHECK-DAG: <<Add:d\d+>>  VecAdd                loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Sqrt:d\d+>> VecSqrt [<<Add>>]     loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:               VecStore [{{l\d+}},{{i\d+}},<<Sqrt>>] loop:<<Loop>> outer_loop:none
+  private static void hypot(double[] a, double[] b, double[] c) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] = Math.sqrt(b[i] * b[i] + c[i] * c[i]);
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.absFloat(float[]) loop_optimization (after)
+  /// CHECK-DAG: <<Load:d\d+>> VecLoad               loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Abs:d\d+>>  VecAbs [<<Load>>]     loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:               VecStore [{{l\d+}},{{i\d+}},<<Abs>>] loop:<<Loop>> outer_loop:none
+  private static void absFloat(float[] a) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] = Math.abs(a[i]);
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.absDouble(double[]) loop_optimization (after)
+  /// CHECK-DAG: <<Load:d\d+>> VecLoad               loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Abs:d\d+>>  VecAbs [<<Load>>]     loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:               VecStore [{{l\d+}},{{i\d+}},<<Abs>>] loop:<<Loop>> outer_loop:none
+  private static void absDouble(double[] a) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] = Math.abs(a[i]);
+    }
+  }
+
+  private static final double[] SPECIAL_VALUES = {
+    0.0, -0.0, 1.0, -1.0, 2.0, Double.MIN_VALUE, Double.MAX_VALUE, Double.NaN,
+    Double.POSITIVE_INFINITY, Double.NEGATIVE_INFINITY, 0x1.fffffffffffffp-1
+  };
+
+  public static void main(String[] args) {
+    double[] a = new double[N];
+    double[] b = new double[N];
+    double[] c = new double[N];
+    for (int i = 0; i < N; i++) {
+      b[i] = (i < SPECIAL_VALUES.length) ? SPECIAL_VALUES[i] : (i - 500) * 0.37;
+      c[i] = i * 1.75;
+    }
+
+    sqrt(a, b);
+    for (int i = 0; i < N; i++) {
+      expectEquals(StrictMath.sqrt(b[i]), a[i], i);
+    }
+
+    hypot(a, b, c);
+    for (int i = 0; i < N; i++) {
+      expectEquals(StrictMath.sqrt(b[i] * b[i] + c[i] * c[i]), a[i], i);
+    }
+
+    double[] d = b.clone();
+    absDouble(d);
+    for (int i = 0; i < N; i++) {
+      expectEquals(StrictMath.abs(b[i]), d[i], i);
+    }
+
+    float[] f = new float[N];
+    for (int i = 0; i < N; i++) {
+      f[i] = (float) b[i];
+    }
+    float[] g = f.clone();
+    absFloat(g);
+    for (int i = 0; i < N; i++) {
+      expectEquals(StrictMath.abs(f[i]), g[i], i);
+    }
+
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(double expected, double result, int index) {
+    if (Double.doubleToLongBits(expected) != Double.doubleToLongBits(result)) {
+      throw new Error("Expected: " + expected + ", found: " + result + " at " + index);
+    }
+  }
+
+  private static void expectEquals(float expected, float result, int index) {
+    if (Float.floatToIntBits(expected) != Float.floatToIntBits(result)) {
+      throw new Error("Expected: " + expected + ", found: " + result + " at " + index);
+    }
+  }
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.invoke.MethodHandles;
+import java.lang.invoke.VarHandle;
+
+public class Main {
+    static class Node {
+        int value;
+        long count;
+        volatile Object next;
+        String name;
+        final int id = 42;
+    }
+
+    static final VarHandle VALUE;
+    static final VarHandle COUNT;
+    static final VarHandle NEXT;
+    static final VarHandle NAME;
+    static final VarHandle ID;
+
+    static {
+        try {
+            MethodHandles.Lookup lookup = MethodHandles.lookup();
+            VALUE = lookup.findVarHandle(Node.class, "value", int.class);
+            COUNT = lookup.findVarHandle(Node.class, "count", long.class);
+            NEXT = lookup.findVarHandle(Node.class, "next", Object.class);
+            NAME = lookup.findVarHandle(Node.class, "name", String.class);
+            ID = lookup.findVarHandle(Node.class, "id", int.class);
+        } catch (ReflectiveOperationException e) {
+            throw new Error(e);
+        }
+    }
+
+    // The accesses below have the exact types of the fields, except the `setRelease` of
+    // `next`, which passes a `Node` for an `Object` and is converted.
+
+    /// CHECK-START: void Main.$noinline$increment(Main$Node, Main$Node) inliner (before)
+    /// CHECK-DAG:     InvokePolymorphic
+    /// CHECK-DAG:     InvokePolymorphic
+    /// CHECK-DAG:     InvokePolymorphic
+    /// CHECK-DAG:     InvokePolymorphic
+    /// CHECK-DAG:     InvokePolymorphic
+    /// CHECK-DAG:     InvokePolymorphic
+    /// CHECK-DAG:     InvokePolymorphic
+    /// CHECK-DAG:     InvokePolymorphic
+
+    /// CHECK-START: void Main.$noinline$increment(Main$Node, Main$Node) inliner (after)
+    /// CHECK-DAG:     InstanceFieldGet field_name:Main$Node.value
+    /// CHECK-DAG:     InstanceFieldSet field_name:Main$Node.value
+    /// CHECK-DAG:     InstanceFieldGet field_name:Main$Node.count
+    /// CHECK-DAG:     InstanceFieldSet field_name:Main$Node.count
+    /// CHECK-DAG:     InstanceFieldSet field_name:Main$Node.next
+    /// CHECK-DAG:     InstanceFieldGet field_name:Main$Node.name
+    /// CHECK-DAG:     InstanceFieldSet field_name:Main$Node.name
+
+    /// CHECK-START: void Main.$noinline$increment(Main$Node, Main$Node) inliner (after)
+    /// CHECK:         InvokePolymorphic
+    /// CHECK-NOT:     InvokePolymorphic
+    static void $noinline$increment(Node node, Node next) {
+        VALUE.set(node, (int) VALUE.get(node) + 1);
+        COUNT.setVolatile(node, (long) COUNT.getVolatile(node) + 2L);
+        NEXT.setRelease(node, next);
+        NEXT.setOpaque(node, (Object) next);
+        NAME.set(node, (String) NAME.getAcquire(node));
+    }
+
+    /// CHECK-START: int Main.$noinline$getValue(Main$Node) inliner (after)
+    /// CHECK:         NullCheck
+    /// CHECK:         InstanceFieldGet field_name:Main$Node.value
+    /// CHECK-NOT:     InvokePolymorphic
+    static int $noinline$getValue(Node node) {
+        return (int) VALUE.get(node);
+    }
+
+    static void $noinline$setId(Node node, int id) {
+        ID.set(node, id);
+    }
+
+    /// CHECK-START: boolean Main.$noinline$compareAndSet(Main$Node, int, int) inliner (before)
+    /// CHECK:         InvokePolymorphic
+
+    /// CHECK-START: boolean Main.$noinline$compareAndSet(Main$Node, int, int) inliner (after)
+    /// CHECK:         NullCheck
+    /// CHECK:         InvokeVirtual method_name:sun.misc.Unsafe.compareAndSwapInt intrinsic:UnsafeCASInt
+    /// CHECK-NOT:     InvokePolymorphic
+    static boolean $noinline$compareAndSet(Node node, int expected, int value) {
+        return (boolean) VALUE.compareAndSet(node, expected, value);
+    }
+
+    /// CHECK-START: boolean Main.$noinline$weakCompareAndSet(Main$Node, java.lang.String, java.lang.String) inliner (after)
+    /// CHECK:         InvokeVirtual method_name:sun.misc.Unsafe.compareAndSwapObject intrinsic:UnsafeCASObject
+    /// CHECK-NOT:     InvokePolymorphic
+    static boolean $noinline$weakCompareAndSet(Node node, String expected, String value) {
+        return (boolean) NAME.weakCompareAndSetAcquire(node, expected, value);
+    }
+
+    /// CHECK-START: long Main.$noinline$getAndAdd(Main$Node, long) inliner (after)
+    /// CHECK:         InvokeVirtual method_name:sun.misc.Unsafe.getAndAddLong intrinsic:UnsafeGetAndAddLong
+    /// CHECK-NOT:     InvokePolymorphic
+    static long $noinline$getAndAdd(Node node, long delta) {
+        return (long) COUNT.getAndAdd(node, delta);
+    }
+
+    /// CHECK-START: java.lang.Object Main.$noinline$getAndSet(Main$Node, java.lang.Object) inliner (after)
+    /// CHECK:         InvokeVirtual method_name:sun.misc.Unsafe.getAndSetObject intrinsic:UnsafeGetAndSetObject
+    /// CHECK-NOT:     InvokePolymorphic
+    static Object $noinline$getAndSet(Node node, Object next) {
+        return (Object) NEXT.getAndSetRelease(node, next);
+    }
+
+    // sun.misc.Unsafe has no compare-and-exchange, so the VarHandle is called.
+
+    /// CHECK-START: int Main.$noinline$compareAndExchange(Main$Node, int, int) inliner (after)
+    /// CHECK:         InvokePolymorphic
+    /// CHECK-NOT:     InvokeVirtual
+    static int $noinline$compareAndExchange(Node node, int expected, int value) {
+        return (int) VALUE.compareAndExchange(node, expected, value);
+    }
+
+    public static void main(String[] args) {
+        System.loadLibrary(args[0]);
+        Node node = new Node();
+        Node next = new Node();
+        node.name = "node";
+        for (int i = 0; i != 100000; ++i) {
+            $noinline$increment(node, next);
+        }
+        ensureJitCompiled(Main.class, "$noinline$increment");
+        $noinline$increment(node, next);
+        System.out.println("value: " + $noinline$getValue(node));
+        System.out.println("count: " + node.count);
+        System.out.println("next: " + (node.next == next));
+        System.out.println("name: " + node.name);
+
+        ensureJitCompiled(Main.class, "$noinline$getValue");
+        try {
+            $noinline$getValue(null);
+            System.out.println("no NullPointerException");
+        } catch (NullPointerException e) {
+            System.out.println("caught NullPointerException");
+        }
+
+        try {
+            $noinline$setId(node, 1);
+            System.out.println("no UnsupportedOperationException");
+        } catch (UnsupportedOperationException e) {
+            System.out.println("caught UnsupportedOperationException");
+        }
+        System.out.println("id: " + (int) ID.get(node));
+
+        ensureJitCompiled(Main.class, "$noinline$compareAndSet");
+        ensureJitCompiled(Main.class, "$noinline$weakCompareAndSet");
+        ensureJitCompiled(Main.class, "$noinline$getAndAdd");
+        ensureJitCompiled(Main.class, "$noinline$getAndSet");
+        ensureJitCompiled(Main.class, "$noinline$compareAndExchange");
+        System.out.println("compareAndSet: " + $noinline$compareAndSet(node, 0, 1) + " " +
+                           $noinline$compareAndSet(node, 100001, 1) + " " + node.value);
+        // A weak compare-and-set may fail spuriously.
+        while (!$noinline$weakCompareAndSet(node, "node", "next")) {}
+        System.out.println("weakCompareAndSet: " + node.name);
+        System.out.println("getAndAdd: " + $noinline$getAndAdd(node, 3L) + " " + node.count);
+        System.out.println("getAndSet: " + ($noinline$getAndSet(node, node) == next) + " " +
+                           (node.next == node));
+        System.out.println("compareAndExchange: " + $noinline$compareAndExchange(node, 1, 2) +
+                           " " + node.value);
+
+        try {
+            $noinline$compareAndSet(null, 0, 1);
+            System.out.println("no NullPointerException");
+        } catch (NullPointerException e) {
+            System.out.println("caught NullPointerException");
+        }
+    }
+
+    private static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
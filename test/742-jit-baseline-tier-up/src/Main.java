@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  private static final int MAX_ROUNDS = 6000;
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    if (!hasJit()) {
+      // Nothing to tier up.
+      System.out.println("passed");
+      return;
+    }
+    int sum = 0;
+    boolean optimized = false;
+    // The loop stays in the interpreter, whose samples take the tier-up requests of the
+    // baseline code to the JIT.
+    for (int round = 0; round < MAX_ROUNDS && !optimized; ++round) {
+      sum += callHot(100);
+      optimized = hasJitCompiledEntrypoint(Main.class, "$noinline$hot") &&
+                  !hasJitCompiledBaselineEntrypoint(Main.class, "$noinline$hot");
+      if (!optimized) {
+        Thread.sleep(10);
+      }
+    }
+    if (!optimized) {
+      throw new Error("$noinline$hot was not compiled with the optimizing tier");
+    }
+    if (sum <= 0) {
+      throw new Error("Unexpected sum " + sum);
+    }
+    System.out.println("passed");
+  }
+
+  private static int callHot(int count) {
+    int sum = 0;
+    for (int i = 0; i < count; ++i) {
+      sum += $noinline$hot(i);
+    }
+    return sum;
+  }
+
+  private static int $noinline$hot(int value) {
+    return (value & 1) + 1;
+  }
+
+  private static native boolean hasJit();
+  private static native boolean hasJitCompiledEntrypoint(Class<?> klass, String methodName);
+  private static native boolean hasJitCompiledBaselineEntrypoint(Class<?> klass,
+                                                                 String methodName);
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * With --large-graph-max=1, every graph is large and only gets the passes the code
+ * generator relies on.
+ */
+public class Main {
+
+  /// CHECK-START-{ARM,ARM64,MIPS,MIPS64,X86,X86_64}: int Main.testCall(int) sharpening (after)
+  /// CHECK:                InvokeStaticOrDirect method_load_kind:BssEntry
+
+  /// CHECK-START-X86: int Main.testCall(int) pc_relative_fixups_x86 (after)
+  /// CHECK:                X86ComputeBaseMethodAddress
+  /// CHECK:                InvokeStaticOrDirect
+
+  /// CHECK-START-MIPS: int Main.testCall(int) pc_relative_fixups_mips (after)
+  /// CHECK:                InvokeStaticOrDirect
+
+  public static int testCall(int x) {
+    // This call uses a PC-relative .bss entry load, whose base X86 and MIPS32R2 compute
+    // in the method.
+    return $noinline$foo(x) + 1;
+  }
+
+  /// CHECK-START-X86: java.lang.String Main.testString() pc_relative_fixups_x86 (after)
+  /// CHECK:                X86ComputeBaseMethodAddress
+  /// CHECK:                LoadString
+
+  /// CHECK-START-MIPS: java.lang.String Main.testString() pc_relative_fixups_mips (after)
+  /// CHECK:                LoadString
+
+  public static String testString() {
+    return "large";
+  }
+
+  public static int $noinline$foo(int x) {
+    if (doThrow) { throw new Error(); }
+    return x;
+  }
+
+  public static void main(String[] args) {
+    expectEquals(43, testCall(42));
+    if (!testString().equals("large")) {
+      throw new Error("Unexpected string " + testString());
+    }
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  static boolean doThrow = false;
+}
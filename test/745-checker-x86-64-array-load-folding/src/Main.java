@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  /// CHECK-START-X86_64: int Main.$noinline$add(int[], int, int) x86_memory_operand_generation (before)
+  /// CHECK-NOT:     ArrayGet emitted_at_use:true
+
+  /// CHECK-START-X86_64: int Main.$noinline$add(int[], int, int) x86_memory_operand_generation (after)
+  /// CHECK-DAG:     <<Value:i\d+>>         ParameterValue
+  /// CHECK-DAG:     <<Get:i\d+>>           ArrayGet is_string_char_at:false emitted_at_use:true
+  /// CHECK-DAG:                            Add [<<Value>>,<<Get>>]
+
+  /// CHECK-START-X86_64: int Main.$noinline$add(int[], int, int) disassembly (after)
+  /// CHECK:                                add {{\w+}}, [{{\w+}} + {{\w+}} * 4 + 12]
+  static int $noinline$add(int[] array, int index, int value) {
+    return value + array[index];
+  }
+
+  // The load is moved to the right hand side of the commutative add.
+
+  /// CHECK-START-X86_64: int Main.$noinline$addCommuted(int[], int, int) x86_memory_operand_generation (after)
+  /// CHECK-DAG:     <<Value:i\d+>>         ParameterValue
+  /// CHECK-DAG:     <<Get:i\d+>>           ArrayGet is_string_char_at:false emitted_at_use:true
+  /// CHECK-DAG:                            Add [<<Value>>,<<Get>>]
+
+  /// CHECK-START-X86_64: int Main.$noinline$addCommuted(int[], int, int) disassembly (after)
+  /// CHECK:                                add {{\w+}}, [{{\w+}} + {{\w+}} * 4 + 12]
+  static int $noinline$addCommuted(int[] array, int index, int value) {
+    return array[index] + value;
+  }
+
+  /// CHECK-START-X86_64: long Main.$noinline$sub(long[], int, long) x86_memory_operand_generation (after)
+  /// CHECK-DAG:     <<Get:j\d+>>           ArrayGet is_string_char_at:false emitted_at_use:true
+  /// CHECK-DAG:                            Sub [{{j\d+}},<<Get>>]
+
+  /// CHECK-START-X86_64: long Main.$noinline$sub(long[], int, long) disassembly (after)
+  /// CHECK:                                sub {{\w+}}, [{{\w+}} + {{\w+}} * 8 + 16]
+  static long $noinline$sub(long[] array, int index, long value) {
+    return value - array[index];
+  }
+
+  /// CHECK-START-X86_64: int Main.$noinline$xor(int[], int, int) disassembly (after)
+  /// CHECK:                                ArrayGet is_string_char_at:false emitted_at_use:true
+  /// CHECK:                                xor {{\w+}}, [{{\w+}} + {{\w+}} * 4 + 12]
+  static int $noinline$xor(int[] array, int index, int value) {
+    return value ^ array[index];
+  }
+
+  /// CHECK-START-X86_64: boolean Main.$noinline$lessThan(int[], int, int) disassembly (after)
+  /// CHECK:                                ArrayGet is_string_char_at:false emitted_at_use:true
+  /// CHECK:                                cmp {{\w+}}, [{{\w+}} + {{\w+}} * 4 + 12]
+  static boolean $noinline$lessThan(int[] array, int index, int value) {
+    return value < array[index];
+  }
+
+  // The load has two users, so it is not folded.
+
+  /// CHECK-START-X86_64: int Main.$noinline$twoUses(int[], int, int) x86_memory_operand_generation (after)
+  /// CHECK-NOT:                            ArrayGet emitted_at_use:true
+  static int $noinline$twoUses(int[] array, int index, int value) {
+    int element = array[index];
+    return (value + element) * element;
+  }
+
+  public static void main(String[] args) {
+    int[] ints = { 1, 10, 100 };
+    long[] longs = { 2L, 20L, 200L };
+    System.out.println("add: " + $noinline$add(ints, 1, 3));
+    System.out.println("addCommuted: " + $noinline$addCommuted(ints, 1, 3));
+    System.out.println("sub: " + $noinline$sub(longs, 1, 3L));
+    System.out.println("xor: " + $noinline$xor(ints, 0, 7));
+    System.out.println("lessThan: " + $noinline$lessThan(ints, 2, 3) + " " +
+                       $noinline$lessThan(ints, 0, 3));
+    System.out.println("twoUses: " + $noinline$twoUses(ints, 1, 2));
+
+    try {
+      $noinline$add(null, 0, 3);
+      System.out.println("no NullPointerException");
+    } catch (NullPointerException e) {
+      System.out.println("caught NullPointerException");
+    }
+    try {
+      $noinline$sub(longs, 3, 3L);
+      System.out.println("no ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException e) {
+      System.out.println("caught ArrayIndexOutOfBoundsException");
+    }
+    try {
+      $noinline$lessThan(null, 0, 3);
+      System.out.println("no NullPointerException");
+    } catch (NullPointerException e) {
+      System.out.println("caught NullPointerException");
+    }
+  }
+}
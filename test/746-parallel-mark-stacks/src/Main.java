@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.Random;
+
+public class Main {
+  static final int TREE_DEPTH = 14;
+  static final int LIST_LENGTH = 100000;
+  static final int ARRAY_LENGTH = 50000;
+  static final int THREADS = 4;
+  static final int ROUNDS = 10;
+  static final int MUTATIONS = 20000;
+
+  static class Value {
+    final int v;
+    Value(int v) {
+      this.v = v;
+    }
+  }
+
+  static class Node {
+    Node left;
+    Node right;
+    Node next;
+    Value value;
+    Node(int v) {
+      value = new Value(v);
+    }
+  }
+
+  // A complete binary tree, whose nodes the mark stacks hold many at a time.
+  static Node makeTree(int depth, int v) {
+    Node node = new Node(v);
+    if (depth > 0) {
+      node.left = makeTree(depth - 1, 2 * v);
+      node.right = makeTree(depth - 1, 2 * v + 1);
+    }
+    return node;
+  }
+
+  static long sumTree(Node node) {
+    if (node == null) {
+      return 0;
+    }
+    return node.value.v + sumTree(node.left) + sumTree(node.right);
+  }
+
+  // A list, which only one thread can mark at a time.
+  static Node makeList(int length) {
+    Node head = null;
+    for (int i = 0; i < length; i++) {
+      Node node = new Node(i);
+      node.next = head;
+      head = node;
+    }
+    return head;
+  }
+
+  static long sumList(Node node) {
+    long sum = 0;
+    for (; node != null; node = node.next) {
+      sum += node.value.v;
+    }
+    return sum;
+  }
+
+  static long sumArray(Value[] array) {
+    long sum = 0;
+    for (Value value : array) {
+      sum += value.v;
+    }
+    return sum;
+  }
+
+  // Swaps children and replaces payloads in the subtree of one thread, so that the collector
+  // sees both new objects and references moved behind its marking.
+  static void mutate(Node root, Value[] array, int seed) {
+    Random random = new Random(seed);
+    for (int i = 0; i < MUTATIONS; i++) {
+      Node node = root;
+      for (int depth = random.nextInt(TREE_DEPTH); depth > 0 && node.left != null; depth--) {
+        node = random.nextBoolean() ? node.left : node.right;
+      }
+      Node left = node.left;
+      node.left = node.right;
+      node.right = left;
+      node.value = new Value(node.value.v);
+      int index = random.nextInt(array.length / THREADS) * THREADS + seed;
+      array[index] = new Value(array[index].v);
+      if ((i & 0xff) == 0) {
+        // Garbage for the collections to find the live objects among.
+        Object[] garbage = new Object[256];
+        for (int j = 0; j < garbage.length; j++) {
+          garbage[j] = new Node(j);
+        }
+      }
+    }
+  }
+
+  public static void main(String[] args) throws Exception {
+    final Node[] trees = new Node[THREADS];
+    long[] treeSums = new long[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+      trees[i] = makeTree(TREE_DEPTH, 1);
+      treeSums[i] = sumTree(trees[i]);
+    }
+    Node list = makeList(LIST_LENGTH);
+    long listSum = sumList(list);
+    final Value[] array = new Value[ARRAY_LENGTH];
+    for (int i = 0; i < array.length; i++) {
+      array[i] = new Value(i);
+    }
+    long arraySum = sumArray(array);
+
+    for (int round = 0; round < ROUNDS; round++) {
+      Thread[] threads = new Thread[THREADS];
+      for (int i = 0; i < THREADS; i++) {
+        final int seed = i;
+        threads[i] = new Thread() {
+          public void run() {
+            mutate(trees[seed], array, seed);
+          }
+        };
+        threads[i].start();
+      }
+      Runtime.getRuntime().gc();
+      for (Thread thread : threads) {
+        thread.join();
+      }
+      Runtime.getRuntime().gc();
+      for (int i = 0; i < THREADS; i++) {
+        expectEquals(treeSums[i], sumTree(trees[i]));
+      }
+      expectEquals(listSum, sumList(list));
+      expectEquals(arraySum, sumArray(array));
+    }
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Point {
+  int x;
+  int y;
+
+  Point(int x, int y) {
+    this.x = x;
+    this.y = y;
+  }
+}
+
+class EscapeError extends Error {
+  final Point point;
+
+  EscapeError(Point point) {
+    this.point = point;
+  }
+}
+
+public class Main {
+  static Point escaped;
+
+  /// CHECK-START: int Main.$noinline$escapeOnThrow(int, int) partial_escape_materialization (before)
+  /// CHECK:     NewInstance klass:Point
+  /// CHECK-NOT: NewInstance klass:Point
+  //
+  /// CHECK-START: int Main.$noinline$escapeOnThrow(int, int) partial_escape_materialization (after)
+  /// CHECK:     NewInstance klass:Point
+  /// CHECK:     NewInstance klass:Point
+  /// CHECK-NOT: NewInstance klass:Point
+  //
+  /// CHECK-START: int Main.$noinline$escapeOnThrow(int, int) load_store_elimination (after)
+  /// CHECK-DAG: <<X:i\d+>>     ParameterValue
+  /// CHECK-DAG: <<Y:i\d+>>     ParameterValue
+  /// CHECK-DAG: <<Add:i\d+>>   Add [<<X>>,<<Y>>]
+  /// CHECK-DAG:                Return [<<Add>>]
+  /// CHECK-DAG: <<Point:l\d+>> NewInstance klass:Point
+  /// CHECK-DAG:                InstanceFieldSet [<<Point>>,<<X>>]
+  /// CHECK-DAG:                InstanceFieldSet [<<Point>>,<<Y>>]
+  /// CHECK-DAG:                Throw
+  //
+  /// CHECK-START: int Main.$noinline$escapeOnThrow(int, int) load_store_elimination (after)
+  /// CHECK:     NewInstance klass:Point
+  /// CHECK-NOT: NewInstance klass:Point
+  //
+  /// CHECK-START: int Main.$noinline$escapeOnThrow(int, int) load_store_elimination (after)
+  /// CHECK-NOT: InstanceFieldGet field_name:Point.{{[xy]}}
+  static int $noinline$escapeOnThrow(int x, int y) {
+    Point point = new Point(x, y);
+    if (x < 0) {
+      // Only allocated to be thrown.
+      throw new EscapeError(point);
+    }
+    return point.x + point.y;
+  }
+
+  /// CHECK-START: int Main.$noinline$escapeOnCommonPath(int, int) partial_escape_materialization (after)
+  /// CHECK:     NewInstance klass:Point
+  /// CHECK-NOT: NewInstance klass:Point
+  //
+  /// CHECK-START: int Main.$noinline$escapeOnCommonPath(int, int) load_store_elimination (after)
+  /// CHECK:     NewInstance klass:Point
+  static int $noinline$escapeOnCommonPath(int x, int y) {
+    Point point = new Point(x, y);
+    if (x < 0) {
+      throw new EscapeError(point);
+    }
+    // The allocation also escapes without a throw, so it stays where it is.
+    escaped = point;
+    return point.x + point.y;
+  }
+
+  /// CHECK-START: int Main.$noinline$escapeOnReturnPath(int, int) partial_escape_materialization (after)
+  /// CHECK:     NewInstance klass:Point
+  /// CHECK-NOT: NewInstance klass:Point
+  static int $noinline$escapeOnReturnPath(int x, int y) {
+    Point point = new Point(x, y);
+    if (x < 0) {
+      // This branch does not throw, so it is not uncommon.
+      escaped = point;
+      return 0;
+    }
+    return point.x + point.y;
+  }
+
+  public static void main(String[] args) {
+    expectEquals(3, $noinline$escapeOnThrow(1, 2));
+    try {
+      $noinline$escapeOnThrow(-1, 2);
+      throw new Error("Expected EscapeError");
+    } catch (EscapeError e) {
+      expectEquals(-1, e.point.x);
+      expectEquals(2, e.point.y);
+    }
+
+    expectEquals(7, $noinline$escapeOnCommonPath(3, 4));
+    expectEquals(3, escaped.x);
+    try {
+      $noinline$escapeOnCommonPath(-3, 4);
+      throw new Error("Expected EscapeError");
+    } catch (EscapeError e) {
+      expectEquals(-3, e.point.x);
+      expectEquals(4, e.point.y);
+    }
+
+    expectEquals(11, $noinline$escapeOnReturnPath(5, 6));
+    expectEquals(0, $noinline$escapeOnReturnPath(-5, 6));
+    expectEquals(-5, escaped.x);
+    expectEquals(6, escaped.y);
+
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
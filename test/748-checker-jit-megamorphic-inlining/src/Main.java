@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+abstract class Super {
+  abstract int getValue();
+}
+
+class SubA extends Super {
+  int getValue() { return 11; }
+}
+
+class SubB extends Super {
+  int getValue() { return 22; }
+}
+
+class SubC extends Super {
+  int getValue() { return 33; }
+}
+
+class SubD extends Super {
+  int getValue() { return 44; }
+}
+
+class SubE extends Super {
+  int getValue() { return 55; }
+}
+
+class SubF extends Super {
+  int getValue() { return 66; }
+}
+
+public class Main {
+  static final int CALLS = 5000;
+
+  // SubA and SubB have 70% and 25% of the hits, the other four receivers share 5%.
+
+  /// CHECK-START: int Main.$noinline$megamorphic(Super) inliner (before)
+  /// CHECK:       InvokeVirtual method_name:Super.getValue
+  //
+  /// CHECK-START: int Main.$noinline$megamorphic(Super) inliner (after)
+  /// CHECK-DAG:  <<SubARet:i\d+>>          IntConstant 11
+  /// CHECK-DAG:  <<SubBRet:i\d+>>          IntConstant 22
+  /// CHECK-DAG:  <<InlineClassSubA:l\d+>>  LoadClass class_name:SubA
+  /// CHECK-DAG:  <<TestSubA:z\d+>>         NotEqual [<<InlineClassSubA>>,{{l\d+}}]
+  /// CHECK-DAG:                            If [<<TestSubA>>]
+  /// CHECK-DAG:  <<InlineClassSubB:l\d+>>  LoadClass class_name:SubB
+  /// CHECK-DAG:  <<TestSubB:z\d+>>         NotEqual [<<InlineClassSubB>>,{{l\d+}}]
+  /// CHECK-DAG:                            If [<<TestSubB>>]
+  /// CHECK-DAG:  <<DefaultRet:i\d+>>       InvokeVirtual method_name:Super.getValue
+  /// CHECK-DAG:  <<FirstMerge:i\d+>>       Phi [<<SubBRet>>,<<DefaultRet>>]
+  /// CHECK-DAG:  <<Ret:i\d+>>              Phi [<<SubARet>>,<<FirstMerge>>]
+  /// CHECK-DAG:                            Return [<<Ret>>]
+  //
+  /// CHECK-START: int Main.$noinline$megamorphic(Super) inliner (after)
+  /// CHECK-NOT:                            LoadClass class_name:SubC
+  /// CHECK-NOT:                            LoadClass class_name:SubD
+  /// CHECK-NOT:                            LoadClass class_name:SubE
+  /// CHECK-NOT:                            LoadClass class_name:SubF
+  /// CHECK-NOT:                            Deoptimize
+  static int $noinline$megamorphic(Super s) {
+    return s.getValue();
+  }
+
+  // SubB is seen first, but SubA has most of the hits, so it is tested first.
+
+  /// CHECK-START: int Main.$noinline$polymorphic(Super) inliner (after)
+  /// CHECK-DAG:  <<SubARet:i\d+>>          IntConstant 11
+  /// CHECK-DAG:  <<SubBRet:i\d+>>          IntConstant 22
+  /// CHECK-DAG:  <<FirstMerge:i\d+>>       Phi [<<SubBRet>>,{{i\d+}}]
+  /// CHECK-DAG:  <<Ret:i\d+>>              Phi [<<SubARet>>,<<FirstMerge>>]
+  /// CHECK-DAG:                            Return [<<Ret>>]
+  static int $noinline$polymorphic(Super s) {
+    return s.getValue();
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    Super a = new SubA();
+    Super b = new SubB();
+    Super[] rare = { new SubC(), new SubD(), new SubE(), new SubF() };
+
+    int expected = 0;
+    int sum = 0;
+    for (int i = 0; i < CALLS; i++) {
+      Super s;
+      if (i % 20 < 14) {
+        s = a;
+      } else if (i % 20 < 19) {
+        s = b;
+      } else {
+        s = rare[(i / 20) % rare.length];
+      }
+      expected += s.getValue();
+      sum += $noinline$megamorphic(s);
+    }
+    expectEquals(expected, sum);
+    ensureJitCompiled(Main.class, "$noinline$megamorphic");
+    for (Super s : rare) {
+      expectEquals(s.getValue(), $noinline$megamorphic(s));
+    }
+    expectEquals(11, $noinline$megamorphic(a));
+    expectEquals(22, $noinline$megamorphic(b));
+
+    for (int i = 0; i < CALLS / 10; i++) {
+      expectEquals(22, $noinline$polymorphic(b));
+    }
+    for (int i = 0; i < CALLS; i++) {
+      expectEquals(11, $noinline$polymorphic(a));
+    }
+    ensureJitCompiled(Main.class, "$noinline$polymorphic");
+    expectEquals(11, $noinline$polymorphic(a));
+    expectEquals(22, $noinline$polymorphic(b));
+
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
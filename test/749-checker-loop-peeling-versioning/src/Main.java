@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  //
+  // Peeling of loop-invariant exits.
+  //
+
+  /// CHECK-START: int Main.$noinline$peelInvariantExit(int[], boolean) loop_optimization (before)
+  /// CHECK-DAG: <<Stop:z\d+>> ParameterValue                    loop:none
+  /// CHECK-DAG:               If [<<Stop>>]                     loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG:               ArrayGet                          loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-START: int Main.$noinline$peelInvariantExit(int[], boolean) loop_optimization (after)
+  /// CHECK-DAG: <<Stop:z\d+>> ParameterValue                    loop:none
+  /// CHECK-DAG: <<Const:i\d+>> IntConstant {{[01]}}             loop:none
+  /// CHECK-DAG:               If [<<Stop>>]                     loop:none
+  /// CHECK-DAG:               ArrayGet                          loop:none
+  /// CHECK-DAG:               If [<<Const>>]                    loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG:               ArrayGet                          loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-START: int Main.$noinline$peelInvariantExit(int[], boolean) dead_code_elimination$final (after)
+  /// CHECK:     <<Stop:z\d+>> ParameterValue
+  /// CHECK:                   If [<<Stop>>]                     loop:none
+  /// CHECK-NOT:               If [<<Stop>>]
+  //
+  /// CHECK-START: int Main.$noinline$peelInvariantExit(int[], boolean) dead_code_elimination$final (after)
+  /// CHECK-NOT:               If [{{i\d+}}]
+  static int $noinline$peelInvariantExit(int[] a, boolean stop) {
+    int sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      if (stop) {
+        break;
+      }
+      sum += a[i];
+    }
+    return sum;
+  }
+
+  /// CHECK-START: int Main.$noinline$noPeelingForVariantExit(int[], int) loop_optimization (after)
+  /// CHECK-NOT:               ArrayGet                          loop:none
+  static int $noinline$noPeelingForVariantExit(int[] a, int stop) {
+    int sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      // The exit depends on the iteration.
+      if (a[i] == stop) {
+        break;
+      }
+      sum += a[i];
+    }
+    return sum;
+  }
+
+  //
+  // Vector loops versioned on aliasing tests.
+  //
+
+  /// CHECK-START: void Main.$noinline$add3(int[], int[], int[], int[]) loop_optimization (before)
+  /// CHECK-DAG:               ArrayGet                          loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG:               ArraySet                          loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-START-{ARM,ARM64,MIPS64}: void Main.$noinline$add3(int[], int[], int[], int[]) loop_optimization (after)
+  /// CHECK-DAG: <<Test1:z\d+>> NotEqual [{{l\d+}},{{l\d+}}]     loop:none
+  /// CHECK-DAG: <<Test2:z\d+>> NotEqual [{{l\d+}},{{l\d+}}]     loop:none
+  /// CHECK-DAG: <<Test3:z\d+>> NotEqual [{{l\d+}},{{l\d+}}]     loop:none
+  /// CHECK-DAG:               Select [{{i\d+}},{{i\d+}},<<Test1>>] loop:none
+  /// CHECK-DAG:               Select [{{i\d+}},{{i\d+}},<<Test2>>] loop:none
+  /// CHECK-DAG:               Select [{{i\d+}},{{i\d+}},<<Test3>>] loop:none
+  /// CHECK-DAG:               VecLoad                           loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG:               VecAdd                            loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:               VecStore                          loop:<<Loop>>      outer_loop:none
+  static void $noinline$add3(int[] a, int[] b, int[] c, int[] d) {
+    int n = Math.min(Math.min(a.length, b.length), Math.min(c.length, d.length));
+    for (int i = 0; i < n; i++) {
+      a[i] = b[i] + c[i] + d[i];
+    }
+  }
+
+  /// CHECK-START: void Main.$noinline$add4(int[], int[], int[], int[], int[]) loop_optimization (after)
+  /// CHECK-NOT:               VecStore
+  static void $noinline$add4(int[] a, int[] b, int[] c, int[] d, int[] e) {
+    int n = Math.min(Math.min(a.length, b.length), Math.min(c.length, d.length));
+    n = Math.min(n, e.length);
+    // Four aliasing tests would be needed.
+    for (int i = 0; i < n; i++) {
+      a[i] = b[i] + c[i] + d[i] + e[i];
+    }
+  }
+
+  static int[] iota(int n) {
+    int[] a = new int[n];
+    for (int i = 0; i < n; i++) {
+      a[i] = i;
+    }
+    return a;
+  }
+
+  public static void main(String[] args) {
+    int[] a = iota(100);
+    expectEquals(99 * 100 / 2, $noinline$peelInvariantExit(a, false));
+    expectEquals(0, $noinline$peelInvariantExit(a, true));
+    expectEquals(0, $noinline$peelInvariantExit(new int[0], false));
+    expectEquals(45, $noinline$noPeelingForVariantExit(a, 10));
+    expectEquals(99 * 100 / 2, $noinline$noPeelingForVariantExit(a, -1));
+
+    int[] b = iota(100);
+    int[] c = iota(100);
+    int[] d = iota(100);
+    $noinline$add3(a, b, c, d);
+    for (int i = 0; i < 100; i++) {
+      expectEquals(3 * i, a[i]);
+    }
+    // Aliased arrays run the scalar loop, which sees the values it wrote.
+    a = iota(100);
+    $noinline$add3(a, a, a, a);
+    for (int i = 0; i < 100; i++) {
+      expectEquals(3 * i, a[i]);
+    }
+    a = iota(100);
+    $noinline$add3(b, a, b, c);
+    for (int i = 0; i < 100; i++) {
+      expectEquals(3 * i, b[i]);
+    }
+
+    int[] e = iota(100);
+    a = iota(100);
+    $noinline$add4(a, b, c, d, e);
+    for (int i = 0; i < 100; i++) {
+      expectEquals(6 * i, a[i]);
+    }
+
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
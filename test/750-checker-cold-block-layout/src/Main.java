@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  // The liveness positions follow the linear order, in which the code is emitted.
+
+  /// CHECK-START: int Main.$noinline$checkedDouble(int) liveness (after)
+  /// CHECK-DAG:               If                 liveness:<<IfLiv:\d+>>
+  /// CHECK-DAG:               Return             liveness:<<RetLiv:\d+>>
+  /// CHECK-DAG:               Throw              liveness:<<ThrowLiv:\d+>>
+  /// CHECK-EVAL:    <<IfLiv>> < <<RetLiv>>
+  /// CHECK-EVAL:    <<RetLiv>> < <<ThrowLiv>>
+  static int $noinline$checkedDouble(int x) {
+    if (x < 0) {
+      throw new IllegalArgumentException("negative");
+    }
+    return x * 2;
+  }
+
+  /// CHECK-START: int Main.$noinline$checkedSum(int[], int) liveness (after)
+  /// CHECK-DAG:               Add                liveness:<<AddLiv:\d+>> loop:<<Loop:B\d+>>
+  /// CHECK-DAG:               Goto               liveness:<<BackLiv:\d+>> loop:<<Loop>>
+  /// CHECK-DAG:               Return             liveness:<<RetLiv:\d+>>
+  /// CHECK-DAG:               Throw              liveness:<<ThrowLiv:\d+>> loop:none
+  /// CHECK-EVAL:    <<AddLiv>> < <<RetLiv>>
+  /// CHECK-EVAL:    <<BackLiv>> < <<RetLiv>>
+  /// CHECK-EVAL:    <<RetLiv>> < <<ThrowLiv>>
+  static int $noinline$checkedSum(int[] a, int limit) {
+    int sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      if (a[i] > limit) {
+        // The loop stays contiguous, the throw is moved after it.
+        throw new IllegalArgumentException("too large");
+      }
+      sum += a[i];
+    }
+    return sum;
+  }
+
+  public static void main(String[] args) {
+    expectEquals(8, $noinline$checkedDouble(4));
+    try {
+      $noinline$checkedDouble(-4);
+      throw new Error("Expected IllegalArgumentException");
+    } catch (IllegalArgumentException e) {
+      expectEquals("negative", e.getMessage());
+    }
+
+    int[] a = { 1, 2, 3, 4 };
+    expectEquals(10, $noinline$checkedSum(a, 4));
+    try {
+      $noinline$checkedSum(a, 3);
+      throw new Error("Expected IllegalArgumentException");
+    } catch (IllegalArgumentException e) {
+      expectEquals("too large", e.getMessage());
+    }
+
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(String expected, String result) {
+    if (!expected.equals(result)) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
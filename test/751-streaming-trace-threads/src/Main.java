@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.io.File;
+import java.io.FileDescriptor;
+import java.io.FileOutputStream;
+import java.io.IOException;
+import java.lang.reflect.Method;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.file.Files;
+import java.util.ArrayList;
+import java.util.HashSet;
+import java.util.List;
+import java.util.Set;
+import java.util.concurrent.CountDownLatch;
+
+public class Main {
+    private static final String TEMP_FILE_NAME_PREFIX = "test";
+    private static final String TEMP_FILE_NAME_SUFFIX = ".trace";
+    private static final int NUMBER_OF_THREADS = 8;
+    // More calls than fit in the buffer of a thread, so that the buffers fill and have a tail.
+    private static final int NUMBER_OF_CALLS = 1000;
+    private static final int BUFFER_SIZE = 8 * 1024 * 1024;
+
+    // The layout of the streaming trace, from runtime/trace.cc.
+    private static final int TRACE_HEADER_LENGTH = 32;
+    private static final int STREAMING_PACKET_SIZE = 14;
+    private static final int OP_NEW_METHOD = 1;
+    private static final int OP_NEW_THREAD = 2;
+    private static final int OP_TRACE_SUMMARY = 3;
+    private static final int TRACE_ACTION_MASK = 0x03;
+    private static final int TRACE_METHOD_ENTER = 0x00;
+
+    public static void main(String[] args) throws Exception {
+        String name = System.getProperty("java.vm.name");
+        if (!"Dalvik".equals(name)) {
+            System.out.println("This test is not supported on " + name);
+            return;
+        }
+        File tempFile = createTempFile();
+        try {
+            testStreamingWithThreads(tempFile);
+        } finally {
+            tempFile.delete();
+        }
+    }
+
+    private static File createTempFile() throws Exception {
+        try {
+            return  File.createTempFile(TEMP_FILE_NAME_PREFIX, TEMP_FILE_NAME_SUFFIX);
+        } catch (IOException e) {
+            System.setProperty("java.io.tmpdir", "/data/local/tmp");
+            try {
+                return File.createTempFile(TEMP_FILE_NAME_PREFIX, TEMP_FILE_NAME_SUFFIX);
+            } catch (IOException e2) {
+                System.setProperty("java.io.tmpdir", "/sdcard");
+                return File.createTempFile(TEMP_FILE_NAME_PREFIX, TEMP_FILE_NAME_SUFFIX);
+            }
+        }
+    }
+
+    private static void testStreamingWithThreads(File tempFile) throws Exception {
+        try (FileOutputStream out = new FileOutputStream(tempFile)) {
+            VMDebug.startMethodTracing(
+                    tempFile.getPath(), out.getFD(), BUFFER_SIZE, 0, false, 0, true);
+            System.out.println("status=" + VMDebug.getMethodTracingMode());
+            // These threads exit while tracing.
+            List<Thread> threads = new ArrayList<>();
+            for (int i = 0; i != NUMBER_OF_THREADS; ++i) {
+                threads.add(new Thread(Main::callTraced));
+            }
+            for (Thread thread : threads) {
+                thread.start();
+            }
+            for (Thread thread : threads) {
+                thread.join();
+            }
+            // This thread and the main thread are still running when the tracing stops.
+            CountDownLatch called = new CountDownLatch(1);
+            CountDownLatch stopped = new CountDownLatch(1);
+            Thread lingering = new Thread(() -> {
+                callTraced();
+                called.countDown();
+                awaitUninterruptibly(stopped);
+            });
+            lingering.start();
+            callTraced();
+            called.await();
+            VMDebug.stopMethodTracing();
+            stopped.countDown();
+            lingering.join();
+            System.out.println("status=" + VMDebug.getMethodTracingMode());
+        }
+        int expected = (NUMBER_OF_THREADS + 2) * NUMBER_OF_CALLS;
+        int found = countTracedEntries(Files.readAllBytes(tempFile.toPath()));
+        if (found != expected) {
+            System.out.println("ERROR: found " + found + " traced calls, expected " + expected);
+        } else {
+            System.out.println("All traced calls found");
+        }
+    }
+
+    private static void callTraced() {
+        for (int i = 0; i != NUMBER_OF_CALLS; ++i) {
+            if (traced(i) != i + 1) {
+                throw new Error("Unexpected result");
+            }
+        }
+    }
+
+    private static int traced(int i) {
+        return i + 1;
+    }
+
+    private static void awaitUninterruptibly(CountDownLatch latch) {
+        while (true) {
+            try {
+                latch.await();
+                return;
+            } catch (InterruptedException e) {
+                // Keep waiting.
+            }
+        }
+    }
+
+    // Returns the number of the entries of Main.traced in the packets of the streaming trace.
+    private static int countTracedEntries(byte[] data) {
+        ByteBuffer buffer = ByteBuffer.wrap(data).order(ByteOrder.LITTLE_ENDIAN);
+        buffer.position(TRACE_HEADER_LENGTH);
+        Set<Integer> tracedMethods = new HashSet<>();
+        int count = 0;
+        while (buffer.remaining() >= 2) {
+            int tid = buffer.getShort() & 0xffff;
+            if (tid != 0) {
+                int methodValue = buffer.getInt();
+                if ((methodValue & TRACE_ACTION_MASK) == TRACE_METHOD_ENTER &&
+                        tracedMethods.contains(methodValue & ~TRACE_ACTION_MASK)) {
+                    ++count;
+                }
+                buffer.position(buffer.position() + STREAMING_PACKET_SIZE - 6);
+                continue;
+            }
+            int op = buffer.get();
+            if (op == OP_NEW_METHOD) {
+                String line = readString(buffer, buffer.getShort() & 0xffff);
+                String[] fields = line.split("\t");
+                if (fields[1].equals("Main") && fields[2].equals("traced")) {
+                    tracedMethods.add(Integer.parseUnsignedInt(fields[0].substring(2), 16));
+                }
+            } else if (op == OP_NEW_THREAD) {
+                buffer.getShort();  // The thread id.
+                readString(buffer, buffer.getShort() & 0xffff);
+            } else if (op == OP_TRACE_SUMMARY) {
+                break;
+            } else {
+                throw new Error("Unexpected op " + op);
+            }
+        }
+        return count;
+    }
+
+    private static String readString(ByteBuffer buffer, int length) {
+        byte[] bytes = new byte[length];
+        buffer.get(bytes);
+        return new String(bytes);
+    }
+
+    private static class VMDebug {
+        private static final Method startMethodTracingMethod;
+        private static final Method stopMethodTracingMethod;
+        private static final Method getMethodTracingModeMethod;
+        static {
+            try {
+                Class<?> c = Class.forName("dalvik.system.VMDebug");
+                startMethodTracingMethod = c.getDeclaredMethod("startMethodTracing", String.class,
+                        FileDescriptor.class, Integer.TYPE, Integer.TYPE, Boolean.TYPE,
+                        Integer.TYPE, Boolean.TYPE);
+                stopMethodTracingMethod = c.getDeclaredMethod("stopMethodTracing");
+                getMethodTracingModeMethod = c.getDeclaredMethod("getMethodTracingMode");
+            } catch (Exception e) {
+                throw new RuntimeException(e);
+            }
+        }
+
+        public static void startMethodTracing(String filename, FileDescriptor fd, int bufferSize,
+                int flags, boolean samplingEnabled, int intervalUs, boolean streamingOutput)
+                throws Exception {
+            startMethodTracingMethod.invoke(null, filename, fd, bufferSize, flags, samplingEnabled,
+                    intervalUs, streamingOutput);
+        }
+        public static void stopMethodTracing() throws Exception {
+            stopMethodTracingMethod.invoke(null);
+        }
+        public static int getMethodTracingMode() throws Exception {
+            return (int) getMethodTracingModeMethod.invoke(null);
+        }
+    }
+}
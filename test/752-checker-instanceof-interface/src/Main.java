@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+interface Itf1 {
+}
+
+interface Itf2 {
+}
+
+interface Itf3 {
+}
+
+// Its iftable holds Itf1, then SubItf1.
+interface SubItf1 extends Itf1 {
+}
+
+class ImplementsItf1 implements Itf1 {
+}
+
+class ImplementsSubItf1AndItf2 implements SubItf1, Itf2 {
+}
+
+// Inherits the iftable of its superclass.
+class ExtendsImplementsItf1 extends ImplementsItf1 {
+}
+
+public class Main {
+
+  /// CHECK-START: boolean Main.$noinline$instanceOfItf1(java.lang.Object) builder (after)
+  /// CHECK:          InstanceOf check_kind:interface_check
+  public static boolean $noinline$instanceOfItf1(Object o) {
+    return o instanceof Itf1;
+  }
+
+  /// CHECK-START: boolean Main.$noinline$instanceOfItf2(java.lang.Object) builder (after)
+  /// CHECK:          InstanceOf check_kind:interface_check
+  public static boolean $noinline$instanceOfItf2(Object o) {
+    return o instanceof Itf2;
+  }
+
+  /// CHECK-START: boolean Main.$noinline$instanceOfItf3(java.lang.Object) builder (after)
+  /// CHECK:          InstanceOf check_kind:interface_check
+  public static boolean $noinline$instanceOfItf3(Object o) {
+    return o instanceof Itf3;
+  }
+
+  /// CHECK-START: boolean Main.$noinline$instanceOfSubItf1(java.lang.Object) builder (after)
+  /// CHECK:          InstanceOf check_kind:interface_check
+  public static boolean $noinline$instanceOfSubItf1(Object o) {
+    return o instanceof SubItf1;
+  }
+
+  /// CHECK-START: boolean Main.$noinline$instanceOfRunnable(java.lang.Object) builder (after)
+  /// CHECK:          InstanceOf check_kind:interface_check
+  public static boolean $noinline$instanceOfRunnable(Object o) {
+    return o instanceof Runnable;
+  }
+
+  public static void assertEquals(boolean expected, boolean actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  public static void test() {
+    Object itf1 = new ImplementsItf1();
+    Object subItf1AndItf2 = new ImplementsSubItf1AndItf2();
+    Object extendsItf1 = new ExtendsImplementsItf1();
+    // Object has an empty iftable.
+    Object empty = new Object();
+    Object array = new Object[0];
+    Object runnable = new Thread();
+
+    // Matches, at the start and at the end of the iftable.
+    assertEquals(true, $noinline$instanceOfItf1(itf1));
+    assertEquals(true, $noinline$instanceOfItf1(subItf1AndItf2));
+    assertEquals(true, $noinline$instanceOfItf1(extendsItf1));
+    assertEquals(true, $noinline$instanceOfItf2(subItf1AndItf2));
+    assertEquals(true, $noinline$instanceOfSubItf1(subItf1AndItf2));
+    assertEquals(true, $noinline$instanceOfRunnable(runnable));
+
+    // Misses, with a non-empty iftable.
+    assertEquals(false, $noinline$instanceOfItf2(itf1));
+    assertEquals(false, $noinline$instanceOfItf2(extendsItf1));
+    assertEquals(false, $noinline$instanceOfItf3(subItf1AndItf2));
+    assertEquals(false, $noinline$instanceOfSubItf1(itf1));
+    assertEquals(false, $noinline$instanceOfItf1(array));
+    assertEquals(false, $noinline$instanceOfRunnable(itf1));
+
+    // Misses, with an empty iftable.
+    assertEquals(false, $noinline$instanceOfItf1(empty));
+    assertEquals(false, $noinline$instanceOfItf3(empty));
+    assertEquals(false, $noinline$instanceOfRunnable(empty));
+
+    // Null receivers.
+    assertEquals(false, $noinline$instanceOfItf1(null));
+    assertEquals(false, $noinline$instanceOfItf3(null));
+    assertEquals(false, $noinline$instanceOfRunnable(null));
+  }
+
+  public static void main(String[] args) {
+    test();
+    // The classes and their iftables may have moved, which the read barrier configurations
+    // handle on the slow path of the misses.
+    Runtime.getRuntime().gc();
+    test();
+    System.out.println("passed");
+  }
+}
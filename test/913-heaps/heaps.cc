@@ -16,6 +16,7 @@
 
 #include <inttypes.h>
 
+#include <atomic>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
@@ -867,6 +868,14 @@ using IterateThroughHeapExt = jvmtiError(*)(jvmtiEnv*,
                                             const void*);
 static IterateThroughHeapExt gIterateThroughHeapExt = nullptr;
 
+using IterateThroughHeapParallel = jvmtiError(*)(jvmtiEnv*,
+                                                 jint,
+                                                 jclass,
+                                                 const jvmtiHeapCallbacks*,
+                                                 const void*,
+                                                 jint);
+static IterateThroughHeapParallel gIterateThroughHeapParallel = nullptr;
+
 
 static void FreeExtensionFunctionInfo(jvmtiExtensionFunctionInfo* extensions, jint count) {
   for (size_t i = 0; i != static_cast<size_t>(count); ++i) {
@@ -1115,6 +1124,42 @@ extern "C" JNIEXPORT void JNICALL Java_art_Test913_iterateThroughHeapExt(
   CHECK(gFoundExt);
 }
 
+static std::atomic<bool> gFoundParallel(false);
+
+static jint JNICALL HeapIterationParallelCallback(jlong class_tag ATTRIBUTE_UNUSED,
+                                                  jlong size ATTRIBUTE_UNUSED,
+                                                  jlong* tag_ptr,
+                                                  jint length ATTRIBUTE_UNUSED,
+                                                  void* user_data ATTRIBUTE_UNUSED,
+                                                  jint heap_id) {
+  // Same expectations as HeapIterationExtCallback, but called from several threads.
+  constexpr jlong kThreshold = 30000000;
+  jlong tag = *tag_ptr;
+  if (tag >= kThreshold) {
+    jint expected_heap_id = static_cast<jint>(tag - kThreshold);
+    CHECK_EQ(expected_heap_id, heap_id);
+    gFoundParallel = true;
+  }
+  return 0;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_art_Test913_iterateThroughHeapParallel(
+    JNIEnv* env, jclass klass ATTRIBUTE_UNUSED) {
+  CHECK(gIterateThroughHeapParallel != nullptr);
+
+  jvmtiHeapCallbacks callbacks;
+  memset(&callbacks, 0, sizeof(jvmtiHeapCallbacks));
+  callbacks.heap_iteration_callback =
+      reinterpret_cast<decltype(callbacks.heap_iteration_callback)>(HeapIterationParallelCallback);
+
+  jvmtiError ret = gIterateThroughHeapParallel(jvmti_env, 0, nullptr, &callbacks, nullptr, 0);
+  CHECK_EQ(ret, JVMTI_ERROR_ILLEGAL_ARGUMENT);
+
+  ret = gIterateThroughHeapParallel(jvmti_env, 0, nullptr, &callbacks, nullptr, 4);
+  JvmtiErrorToException(env, jvmti_env, ret);
+  CHECK(gFoundParallel);
+}
+
 extern "C" JNIEXPORT jboolean JNICALL Java_art_Test913_checkInitialized(JNIEnv* env, jclass, jclass c) {
   jint status;
   jvmtiError error = jvmti_env->GetClassStatus(c, &status);
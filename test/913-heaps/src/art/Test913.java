@@ -289,6 +289,7 @@ public class Test913 {
     setTag(o, baseTag + 3);
 
     iterateThroughHeapExt();
+    iterateThroughHeapParallel();
 
     extensionTestHolder = null;
   }
@@ -756,6 +757,7 @@ public class Test913 {
   public static native String followReferencesPrimitiveFields(Object initialObject);
 
   private static native void iterateThroughHeapExt();
+  private static native void iterateThroughHeapParallel();
 
   private static native void registerClass(long tag, Object obj);
 }
@@ -117,6 +117,24 @@ target_config = {
             'ART_HEAP_POISONING' : 'true'
         }
     },
+    'art-read-barrier-generational-cc' : {
+        'run-test' : ['--interpreter',
+                      '--optimizing',
+                      '--jit'],
+        'env' : {
+            'ART_USE_READ_BARRIER' : 'true',
+            'ART_USE_GENERATIONAL_CC' : 'true'
+        }
+    },
+    'art-read-barrier-gcstress-generational-cc' : {
+        'run-test' : ['--interpreter',
+                      '--optimizing',
+                      '--gcstress'],
+        'env' : {
+            'ART_USE_READ_BARRIER' : 'true',
+            'ART_USE_GENERATIONAL_CC' : 'true'
+        }
+    },
     'art-read-barrier-table-lookup' : {
         'run-test' : ['--interpreter',
                       '--optimizing'],
@@ -262,6 +280,13 @@ target_config = {
             'ART_HEAP_POISONING' : 'true'
         }
     },
+    'art-gtest-read-barrier-generational-cc': {
+        'make' :  'test-art-host-gtest',
+        'env' : {
+            'ART_USE_READ_BARRIER' : 'true',
+            'ART_USE_GENERATIONAL_CC' : 'true'
+        }
+    },
     'art-gtest-read-barrier-table-lookup': {
         'make' :  'test-art-host-gtest',
         'env': {
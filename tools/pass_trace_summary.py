@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2018 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Summarize the optimizing pass traces written by dex2oat --dump-pass-trace.
+
+Prints, for each pass, the total and per-method wall time, the total change of the
+instruction count and the arena bytes allocated, sorted by total time. With --methods,
+also prints the methods that took the longest to compile. Several traces, e.g. of all
+the dex2oat invocations of a system image build, can be given at once."""
+
+import argparse
+import collections
+import struct
+import sys
+
+MAGIC = b'ARTPTRC1'
+PASS_NAME_RECORD = 1
+METHOD_RECORD = 2
+
+PASS_ENTRY = struct.Struct('<HQiI')
+
+
+class PassStats(object):
+  def __init__(self):
+    self.runs = 0
+    self.time_ns = 0
+    self.max_time_ns = 0
+    self.instruction_delta = 0
+    self.arena_bytes = 0
+
+  def Add(self, time_ns, instruction_delta, arena_bytes):
+    self.runs += 1
+    self.time_ns += time_ns
+    self.max_time_ns = max(self.max_time_ns, time_ns)
+    self.instruction_delta += instruction_delta
+    self.arena_bytes += arena_bytes
+
+
+class TraceReader(object):
+  def __init__(self, data, file_name):
+    self.data = data
+    self.file_name = file_name
+    self.offset = 0
+
+  def Read(self, fmt):
+    values = struct.unpack_from(fmt, self.data, self.offset)
+    self.offset += struct.calcsize(fmt)
+    return values
+
+  def ReadString(self):
+    length, = self.Read('<H')
+    value = self.data[self.offset:self.offset + length].decode('utf-8', 'replace')
+    self.offset += length
+    return value
+
+  def Done(self):
+    return self.offset >= len(self.data)
+
+
+def ReadTrace(file_name, pass_stats, method_times):
+  with open(file_name, 'rb') as f:
+    data = f.read()
+  if not data.startswith(MAGIC):
+    sys.exit('%s: not a pass trace' % file_name)
+  reader = TraceReader(data, file_name)
+  reader.offset = len(MAGIC)
+  pass_names = {}
+  try:
+    while not reader.Done():
+      tag, = reader.Read('<B')
+      if tag == PASS_NAME_RECORD:
+        pass_id, = reader.Read('<H')
+        pass_names[pass_id] = reader.ReadString()
+      elif tag == METHOD_RECORD:
+        method_name = reader.ReadString()
+        num_passes, = reader.Read('<H')
+        method_time_ns = 0
+        for _ in range(num_passes):
+          pass_id, time_ns, instruction_delta, arena_bytes = reader.Read(PASS_ENTRY.format)
+          pass_stats[pass_names[pass_id]].Add(time_ns, instruction_delta, arena_bytes)
+          method_time_ns += time_ns
+        method_times.append((method_time_ns, method_name))
+      else:
+        sys.exit('%s: unknown record %d at offset %d' % (file_name, tag, reader.offset - 1))
+  except struct.error:
+    # The trace of a crashed or killed dex2oat ends with a partial record.
+    sys.stderr.write('%s: ignoring truncated record\n' % file_name)
+
+
+def Main():
+  parser = argparse.ArgumentParser(description=__doc__,
+                                   formatter_class=argparse.RawDescriptionHelpFormatter)
+  parser.add_argument('traces', nargs='+', help='pass trace files')
+  parser.add_argument('--methods', type=int, default=0,
+                      help='also print the N methods taking the longest to compile')
+  args = parser.parse_args()
+
+  pass_stats = collections.defaultdict(PassStats)
+  method_times = []
+  for trace in args.traces:
+    ReadTrace(trace, pass_stats, method_times)
+
+  # Code generation and the optimizations of inlined graphs are not separate passes, so
+  # the percentages are relative to the traced time rather than to the dex2oat run.
+  total_ns = sum(time_ns for time_ns, _ in method_times) or 1
+  print('%-40s %8s %10s %6s %10s %10s %12s %12s' %
+        ('pass', 'runs', 'total ms', '%', 'mean us', 'max ms', 'insn delta', 'arena KiB'))
+  for name, stats in sorted(pass_stats.items(), key=lambda item: -item[1].time_ns):
+    print('%-40s %8d %10.1f %6.2f %10.1f %10.1f %12d %12d' %
+          (name, stats.runs, stats.time_ns / 1e6, 100.0 * stats.time_ns / total_ns,
+           stats.time_ns / 1e3 / stats.runs, stats.max_time_ns / 1e6,
+           stats.instruction_delta, stats.arena_bytes // 1024))
+  print('%d methods, %.1f ms' % (len(method_times), total_ns / 1e6))
+
+  if args.methods > 0:
+    print('')
+    for time_ns, name in sorted(method_times, reverse=True)[:args.methods]:
+      print('%10.1f ms  %s' % (time_ns / 1e6, name))
+
+
+if __name__ == '__main__':
+  Main()
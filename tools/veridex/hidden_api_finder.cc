@@ -185,9 +185,33 @@ void HiddenApiFinder::CollectAccesses(VeridexResolver* resolver) {
   }
 }
 
-void HiddenApiFinder::Run(const std::vector<std::unique_ptr<VeridexResolver>>& resolvers) {
-  for (const std::unique_ptr<VeridexResolver>& resolver : resolvers) {
-    CollectAccesses(resolver.get());
+static void MergeLocations(const std::map<std::string, std::vector<MethodReference>>& from,
+                           std::map<std::string, std::vector<MethodReference>>* to) {
+  for (const std::pair<std::string, std::vector<MethodReference>>& pair : from) {
+    std::vector<MethodReference>& locations = (*to)[pair.first];
+    locations.insert(locations.end(), pair.second.begin(), pair.second.end());
+  }
+}
+
+void HiddenApiFinder::Merge(const HiddenApiFinder& other) {
+  classes_.insert(other.classes_.begin(), other.classes_.end());
+  strings_.insert(other.strings_.begin(), other.strings_.end());
+  MergeLocations(other.reflection_locations_, &reflection_locations_);
+  MergeLocations(other.method_locations_, &method_locations_);
+  MergeLocations(other.field_locations_, &field_locations_);
+}
+
+void HiddenApiFinder::Run(const std::vector<std::unique_ptr<VeridexResolver>>& resolvers,
+                          size_t num_threads) {
+  // Collect the accesses of each dex file separately, and merge them in the order of the dex
+  // files, so that the order of the reported locations does not depend on the threads.
+  std::vector<std::unique_ptr<HiddenApiFinder>> finders(resolvers.size());
+  ParallelFor(resolvers.size(), num_threads, [&](size_t i) {
+    finders[i].reset(new HiddenApiFinder(hidden_api_));
+    finders[i]->CollectAccesses(resolvers[i].get());
+  });
+  for (const std::unique_ptr<HiddenApiFinder>& finder : finders) {
+    Merge(*finder);
   }
 }
 
@@ -38,8 +38,9 @@ class HiddenApiFinder {
   explicit HiddenApiFinder(const HiddenApi& hidden_api) : hidden_api_(hidden_api) {}
 
   // Iterate over the dex files associated with the passed resolvers to report
-  // hidden API uses.
-  void Run(const std::vector<std::unique_ptr<VeridexResolver>>& app_resolvers);
+  // hidden API uses. The dex files are scanned in parallel on `num_threads` threads.
+  void Run(const std::vector<std::unique_ptr<VeridexResolver>>& app_resolvers,
+           size_t num_threads);
 
   void Dump(std::ostream& os, HiddenApiStats* stats, bool dump_reflection);
 
@@ -48,6 +49,9 @@ class HiddenApiFinder {
   void CheckMethod(uint32_t method_idx, VeridexResolver* resolver, MethodReference ref);
   void CheckField(uint32_t field_idx, VeridexResolver* resolver, MethodReference ref);
 
+  // Add the accesses found by `other` after the ones found by this finder.
+  void Merge(const HiddenApiFinder& other);
+
   const HiddenApi& hidden_api_;
   std::set<std::string> classes_;
   std::set<std::string> strings_;
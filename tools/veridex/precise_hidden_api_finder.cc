@@ -31,32 +31,74 @@ namespace art {
 
 void PreciseHiddenApiFinder::RunInternal(
     const std::vector<std::unique_ptr<VeridexResolver>>& resolvers,
+    size_t num_threads,
     const std::function<void(VeridexResolver*, const ClassDataItemIterator&)>& action) {
+  std::vector<std::pair<VeridexResolver*, size_t>> classes;
   for (const std::unique_ptr<VeridexResolver>& resolver : resolvers) {
-    const DexFile& dex_file = resolver->GetDexFile();
-    size_t class_def_count = dex_file.NumClassDefs();
+    size_t class_def_count = resolver->GetDexFile().NumClassDefs();
     for (size_t class_def_index = 0; class_def_index < class_def_count; ++class_def_index) {
-      const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
-      const uint8_t* class_data = dex_file.GetClassData(class_def);
-      if (class_data == nullptr) {
-        // Empty class.
+      classes.emplace_back(resolver.get(), class_def_index);
+    }
+  }
+  ParallelFor(classes.size(), num_threads, [&](size_t i) {
+    VeridexResolver* resolver = classes[i].first;
+    const DexFile& dex_file = resolver->GetDexFile();
+    const DexFile::ClassDef& class_def = dex_file.GetClassDef(classes[i].second);
+    const uint8_t* class_data = dex_file.GetClassData(class_def);
+    if (class_data == nullptr) {
+      // Empty class.
+      return;
+    }
+    ClassDataItemIterator it(dex_file, class_data);
+    it.SkipAllFields();
+    for (; it.HasNextMethod(); it.Next()) {
+      const DexFile::CodeItem* code_item = it.GetMethodCodeItem();
+      if (code_item == nullptr) {
         continue;
       }
-      ClassDataItemIterator it(dex_file, class_data);
-      it.SkipAllFields();
-      for (; it.HasNextMethod(); it.Next()) {
-        const DexFile::CodeItem* code_item = it.GetMethodCodeItem();
-        if (code_item == nullptr) {
-          continue;
-        }
-        action(resolver.get(), it);
-      }
+      action(resolver, it);
+    }
+  });
+}
+
+// Whether the method at `it` invokes one of the methods in `uses`. Only those methods can
+// get uses from a substitution.
+static bool InvokesAnyOf(const DexFile& dex_file,
+                         const ClassDataItemIterator& it,
+                         const std::map<MethodReference, std::vector<ReflectAccessInfo>>& uses) {
+  CodeItemInstructionAccessor accessor(dex_file, it.GetMethodCodeItem());
+  for (const DexInstructionPcPair& inst : accessor) {
+    uint32_t method_index;
+    switch (inst->Opcode()) {
+      case Instruction::INVOKE_DIRECT:
+      case Instruction::INVOKE_INTERFACE:
+      case Instruction::INVOKE_STATIC:
+      case Instruction::INVOKE_SUPER:
+      case Instruction::INVOKE_VIRTUAL:
+        method_index = inst->VRegB_35c();
+        break;
+      case Instruction::INVOKE_DIRECT_RANGE:
+      case Instruction::INVOKE_INTERFACE_RANGE:
+      case Instruction::INVOKE_STATIC_RANGE:
+      case Instruction::INVOKE_SUPER_RANGE:
+      case Instruction::INVOKE_VIRTUAL_RANGE:
+        method_index = inst->VRegB_3rc();
+        break;
+      default:
+        continue;
+    }
+    if (uses.find(MethodReference(&dex_file, method_index)) != uses.end()) {
+      return true;
     }
   }
+  return false;
 }
 
 void PreciseHiddenApiFinder::AddUsesAt(const std::vector<ReflectAccessInfo>& accesses,
                                        MethodReference ref) {
+  // A method is analyzed by a single thread, so the order of its uses does not depend on the
+  // threads.
+  std::lock_guard<std::mutex> lock(uses_lock_);
   for (const ReflectAccessInfo& info : accesses) {
     if (info.IsConcrete()) {
       concrete_uses_[ref].push_back(info);
@@ -66,9 +108,12 @@ void PreciseHiddenApiFinder::AddUsesAt(const std::vector<ReflectAccessInfo>& acc
   }
 }
 
-void PreciseHiddenApiFinder::Run(const std::vector<std::unique_ptr<VeridexResolver>>& resolvers) {
+void PreciseHiddenApiFinder::Run(const std::vector<std::unique_ptr<VeridexResolver>>& resolvers,
+                                 size_t num_threads) {
   // Collect reflection uses.
-  RunInternal(resolvers, [this] (VeridexResolver* resolver, const ClassDataItemIterator& it) {
+  RunInternal(resolvers,
+              num_threads,
+              [this] (VeridexResolver* resolver, const ClassDataItemIterator& it) {
     FlowAnalysisCollector collector(resolver, it);
     collector.Run();
     AddUsesAt(collector.GetUses(), MethodReference(&resolver->GetDexFile(), it.GetMemberIndex()));
@@ -84,7 +129,12 @@ void PreciseHiddenApiFinder::Run(const std::vector<std::unique_ptr<VeridexResolv
     std::map<MethodReference, std::vector<ReflectAccessInfo>> current_uses
         = std::move(abstract_uses_);
     RunInternal(resolvers,
-                [this, current_uses] (VeridexResolver* resolver, const ClassDataItemIterator& it) {
+                num_threads,
+                [this, &current_uses] (VeridexResolver* resolver, const ClassDataItemIterator& it) {
+      if (!InvokesAnyOf(resolver->GetDexFile(), it, current_uses)) {
+        // Skip the flow analysis, it would not find any use.
+        return;
+      }
       FlowAnalysisSubstitutor substitutor(resolver, it, current_uses);
       substitutor.Run();
       AddUsesAt(substitutor.GetUses(),
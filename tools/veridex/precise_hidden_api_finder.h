@@ -22,6 +22,7 @@
 
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
 
@@ -39,15 +40,18 @@ class PreciseHiddenApiFinder {
   explicit PreciseHiddenApiFinder(const HiddenApi& hidden_api) : hidden_api_(hidden_api) {}
 
   // Iterate over the dex files associated with the passed resolvers to report
-  // hidden API uses.
-  void Run(const std::vector<std::unique_ptr<VeridexResolver>>& app_resolvers);
+  // hidden API uses. The methods are analyzed in parallel on `num_threads` threads.
+  void Run(const std::vector<std::unique_ptr<VeridexResolver>>& app_resolvers,
+           size_t num_threads);
 
   void Dump(std::ostream& os, HiddenApiStats* stats);
 
  private:
-  // Run over all methods of all dex files, and call `action` on each.
+  // Run over all methods of all dex files, and call `action` on each. The classes are
+  // dispatched to `num_threads` threads, so `action` is called concurrently.
   void RunInternal(
       const std::vector<std::unique_ptr<VeridexResolver>>& resolvers,
+      size_t num_threads,
       const std::function<void(VeridexResolver*, const ClassDataItemIterator&)>& action);
 
   // Add uses found in method `ref`.
@@ -55,6 +59,9 @@ class PreciseHiddenApiFinder {
 
   const HiddenApi& hidden_api_;
 
+  // Guards the uses below while RunInternal analyzes methods.
+  std::mutex uses_lock_;
+
   std::map<MethodReference, std::vector<ReflectAccessInfo>> concrete_uses_;
   std::map<MethodReference, std::vector<ReflectAccessInfo>> abstract_uses_;
 };
@@ -290,7 +290,10 @@ VeriMethod VeridexResolver::GetMethod(uint32_t method_index) {
     method_info = LookupMethodIn(*kls,
                                  dex_file_.GetMethodName(method_id),
                                  dex_file_.GetMethodSignature(method_id));
-    method_infos_[method_index] = method_info;
+    // Do not store a failed lookup, so that repeating it after ResolveAll has no side effect.
+    if (method_info != nullptr) {
+      method_infos_[method_index] = method_info;
+    }
   }
   return method_info;
 }
@@ -308,26 +311,29 @@ VeriField VeridexResolver::GetField(uint32_t field_index) {
     field_info = LookupFieldIn(*kls,
                                dex_file_.GetFieldName(field_id),
                                dex_file_.GetFieldTypeDescriptor(field_id));
-    field_infos_[field_index] = field_info;
+    // Do not store a failed lookup, so that repeating it after ResolveAll has no side effect.
+    if (field_info != nullptr) {
+      field_infos_[field_index] = field_info;
+    }
   }
   return field_info;
 }
 
-void VeridexResolver::ResolveAll() {
+void VeridexResolver::ResolveAll(bool log_unresolved) {
   for (uint32_t i = 0; i < dex_file_.NumTypeIds(); ++i) {
-    if (GetVeriClass(dex::TypeIndex(i)) == nullptr) {
+    if (GetVeriClass(dex::TypeIndex(i)) == nullptr && log_unresolved) {
       LOG(WARNING) << "Unresolved " << dex_file_.PrettyType(dex::TypeIndex(i));
     }
   }
 
   for (uint32_t i = 0; i < dex_file_.NumMethodIds(); ++i) {
-    if (GetMethod(i) == nullptr) {
+    if (GetMethod(i) == nullptr && log_unresolved) {
       LOG(WARNING) << "Unresolved: " << dex_file_.PrettyMethod(i);
     }
   }
 
   for (uint32_t i = 0; i < dex_file_.NumFieldIds(); ++i) {
-    if (GetField(i) == nullptr) {
+    if (GetField(i) == nullptr && log_unresolved) {
       LOG(WARNING) << "Unresolved: " << dex_file_.PrettyField(i);
     }
   }
@@ -25,8 +25,12 @@
 #include "precise_hidden_api_finder.h"
 #include "resolver.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
+#include <iterator>
 #include <sstream>
+#include <thread>
 
 namespace art {
 
@@ -65,6 +69,26 @@ VeriMethod VeriClass::getClass_ = nullptr;
 VeriMethod VeriClass::loadClass_ = nullptr;
 VeriField VeriClass::sdkInt_ = nullptr;
 
+void ParallelFor(size_t count, size_t num_threads, const std::function<void(size_t)>& work) {
+  num_threads = std::max<size_t>(std::min(num_threads, count), 1u);
+  std::atomic<size_t> next_index(0u);
+  auto run = [&]() {
+    for (size_t i = next_index.fetch_add(1u, std::memory_order_relaxed);
+         i < count;
+         i = next_index.fetch_add(1u, std::memory_order_relaxed)) {
+      work(i);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i != num_threads; ++i) {
+    threads.emplace_back(run);
+  }
+  run();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
 struct VeridexOptions {
   const char* dex_file = nullptr;
   const char* core_stubs = nullptr;
@@ -73,6 +97,7 @@ struct VeridexOptions {
   const char* dark_greylist = nullptr;
   bool precise = true;
   int target_sdk_version = 28; /* P */
+  size_t num_threads = 1u;
 };
 
 static const char* Substr(const char* str, int index) {
@@ -95,6 +120,7 @@ static void ParseArgs(VeridexOptions* options, int argc, char** argv) {
   static const char* kLightGreylistOption = "--light-greylist=";
   static const char* kImprecise = "--imprecise";
   static const char* kTargetSdkVersion = "--target-sdk-version=";
+  static const char* kThreads = "--threads=";
 
   for (int i = 0; i < argc; ++i) {
     if (StartsWith(argv[i], kDexFileOption)) {
@@ -111,6 +137,8 @@ static void ParseArgs(VeridexOptions* options, int argc, char** argv) {
       options->precise = false;
     } else if (StartsWith(argv[i], kTargetSdkVersion)) {
       options->target_sdk_version = atoi(Substr(argv[i], strlen(kTargetSdkVersion)));
+    } else if (StartsWith(argv[i], kThreads)) {
+      options->num_threads = std::max(atoi(Substr(argv[i], strlen(kThreads))), 1);
     }
   }
 }
@@ -140,24 +168,16 @@ class Veridex {
 
     // Read the boot classpath.
     std::vector<std::string> boot_classpath = Split(options.core_stubs, ':');
-    boot_content.resize(boot_classpath.size());
-    uint32_t i = 0;
-    for (const std::string& str : boot_classpath) {
-      if (!Load(str, boot_content[i++], &boot_dex_files, &error_msg)) {
-        LOG(ERROR) << error_msg;
-        return 1;
-      }
+    if (!LoadAll(boot_classpath, options.num_threads, &boot_content, &boot_dex_files, &error_msg)) {
+      LOG(ERROR) << error_msg;
+      return 1;
     }
 
     // Read the apps dex files.
     std::vector<std::string> app_files = Split(options.dex_file, ':');
-    app_content.resize(app_files.size());
-    i = 0;
-    for (const std::string& str : app_files) {
-      if (!Load(str, app_content[i++], &app_dex_files, &error_msg)) {
-        LOG(ERROR) << error_msg;
-        return 1;
-      }
+    if (!LoadAll(app_files, options.num_threads, &app_content, &app_dex_files, &error_msg)) {
+      LOG(ERROR) << error_msg;
+      return 1;
     }
 
     // Resolve classes/methods/fields defined in each dex file.
@@ -215,17 +235,23 @@ class Veridex {
     std::vector<std::unique_ptr<VeridexResolver>> app_resolvers;
     Resolve(app_dex_files, resolver_map, type_map, &app_resolvers);
 
+    // Resolve everything the apps reference now, so that the finders below only read the
+    // resolvers and can analyze the apps from multiple threads.
+    for (const std::unique_ptr<VeridexResolver>& resolver : app_resolvers) {
+      resolver->ResolveAll(/* log_unresolved */ false);
+    }
+
     // Find and log uses of hidden APIs.
     HiddenApi hidden_api(options.blacklist, options.dark_greylist, options.light_greylist);
     HiddenApiStats stats;
 
     HiddenApiFinder api_finder(hidden_api);
-    api_finder.Run(app_resolvers);
+    api_finder.Run(app_resolvers, options.num_threads);
     api_finder.Dump(std::cout, &stats, !options.precise);
 
     if (options.precise) {
       PreciseHiddenApiFinder precise_api_finder(hidden_api);
-      precise_api_finder.Run(app_resolvers);
+      precise_api_finder.Run(app_resolvers, options.num_threads);
       precise_api_finder.Dump(std::cout, &stats);
     }
 
@@ -284,6 +310,30 @@ class Veridex {
     return true;
   }
 
+  // Load the files in parallel, and add their dex files in the order of `filenames`, which is
+  // the order their classes are resolved in.
+  static bool LoadAll(const std::vector<std::string>& filenames,
+                      size_t num_threads,
+                      std::vector<std::string>* contents,
+                      std::vector<std::unique_ptr<const DexFile>>* dex_files,
+                      std::string* error_msg) {
+    contents->resize(filenames.size());
+    std::vector<std::vector<std::unique_ptr<const DexFile>>> file_dex_files(filenames.size());
+    std::vector<std::string> error_msgs(filenames.size());
+    std::unique_ptr<bool[]> loaded(new bool[filenames.size()]);
+    ParallelFor(filenames.size(), num_threads, [&](size_t i) {
+      loaded[i] = Load(filenames[i], (*contents)[i], &file_dex_files[i], &error_msgs[i]);
+    });
+    for (size_t i = 0; i != filenames.size(); ++i) {
+      if (!loaded[i]) {
+        *error_msg = error_msgs[i];
+        return false;
+      }
+      std::move(file_dex_files[i].begin(), file_dex_files[i].end(), std::back_inserter(*dex_files));
+    }
+    return true;
+  }
+
   static void Resolve(const std::vector<std::unique_ptr<const DexFile>>& dex_files,
                       DexResolverMap& resolver_map,
                       TypeMap& type_map,
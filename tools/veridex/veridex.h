@@ -17,6 +17,7 @@
 #ifndef ART_TOOLS_VERIDEX_VERIDEX_H_
 #define ART_TOOLS_VERIDEX_VERIDEX_H_
 
+#include <functional>
 #include <map>
 
 #include "dex/dex_file.h"
@@ -109,6 +110,12 @@ inline bool IsGetField(VeriMethod method) {
  */
 using TypeMap = std::map<std::string, VeriClass*>;
 
+/**
+ * Call `work` on each index in [0, count), from up to `num_threads` threads, the
+ * calling one included.
+ */
+void ParallelFor(size_t count, size_t num_threads, const std::function<void(size_t)>& work);
+
 }  // namespace art
 
 #endif  // ART_TOOLS_VERIDEX_VERIDEX_H_